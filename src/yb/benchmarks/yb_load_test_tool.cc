@@ -34,6 +34,8 @@
 #include "yb/util/atomic.h"
 #include "yb/util/env.h"
 #include "yb/util/flags.h"
+#include "yb/util/hdr_histogram.h"
+#include "yb/util/jsonwriter.h"
 #include "yb/util/logging.h"
 #include "yb/util/stopwatch.h"
 #include "yb/util/subprocess.h"
@@ -102,6 +104,30 @@ DEFINE_bool(
     stop_on_empty_read, true,
     "Stop reading if we get an empty set of rows on a read operation");
 
+DEFINE_string(read_key_distribution, "default",
+              "Distribution of the keys read: 'default' (mix of latest and random keys), "
+              "'uniform', 'zipfian' or 'hotspot'.");
+
+DEFINE_double(zipfian_theta, 0.99, "Skew of the zipfian read key distribution.");
+
+DEFINE_double(hotspot_keys_fraction, 0.01,
+              "Fraction of the keys that are hot for the hotspot read key distribution.");
+
+DEFINE_double(hotspot_ops_fraction, 0.9,
+              "Fraction of the reads that go to the hot keys for the hotspot read key distribution.");
+
+DEFINE_double(target_write_ops_per_sec, 0,
+              "If positive, writes are issued open loop at this total rate, and their latency is "
+              "measured from the scheduled start time.");
+
+DEFINE_double(target_read_ops_per_sec, 0,
+              "If positive, reads are issued open loop at this total rate, and their latency is "
+              "measured from the scheduled start time.");
+
+DEFINE_string(latency_report_file, "",
+              "If specified, per operation latency histograms are written to this file as JSON. "
+              "Use '-' for stdout.");
+
 using strings::Substitute;
 using std::atomic_long;
 using std::atomic_bool;
@@ -130,6 +156,11 @@ using yb::TableType;
 
 using strings::Substitute;
 
+using yb::HdrHistogram;
+using yb::JsonWriter;
+
+using yb::load_generator::KeyDistribution;
+using yb::load_generator::KeyDistributionOptions;
 using yb::load_generator::KeyIndexSet;
 using yb::load_generator::SessionFactory;
 using yb::load_generator::NoopSessionFactory;
@@ -352,6 +383,66 @@ bool DropTableIfNecessary(const shared_ptr<YBClient> &client, const YBTableName
   return false;
 }
 
+KeyDistributionOptions GetKeyDistributionOptions() {
+  KeyDistributionOptions options;
+  if (FLAGS_read_key_distribution == "default") {
+    options.distribution = KeyDistribution::kDefault;
+  } else if (FLAGS_read_key_distribution == "uniform") {
+    options.distribution = KeyDistribution::kUniform;
+  } else if (FLAGS_read_key_distribution == "zipfian") {
+    options.distribution = KeyDistribution::kZipfian;
+  } else if (FLAGS_read_key_distribution == "hotspot") {
+    options.distribution = KeyDistribution::kHotspot;
+  } else {
+    LOG(FATAL) << "Unknown read key distribution: " << FLAGS_read_key_distribution;
+  }
+  options.zipfian_theta = FLAGS_zipfian_theta;
+  options.hotspot_keys_fraction = FLAGS_hotspot_keys_fraction;
+  options.hotspot_ops_fraction = FLAGS_hotspot_ops_fraction;
+  return options;
+}
+
+void WriteLatencyHistogram(const string& name, const HdrHistogram& histogram, JsonWriter* jw) {
+  jw->String(name);
+  jw->StartObject();
+  jw->String("count");
+  jw->Uint64(histogram.TotalCount());
+  if (histogram.TotalCount() != 0) {
+    jw->String("min_us");
+    jw->Uint64(histogram.MinValue());
+    jw->String("mean_us");
+    jw->Double(histogram.MeanValue());
+    for (double percentile : {50.0, 90.0, 99.0, 99.9, 99.99}) {
+      jw->String(Substitute("p$0_us", percentile));
+      jw->Uint64(histogram.ValueAtPercentile(percentile));
+    }
+    jw->String("max_us");
+    jw->Uint64(histogram.MaxValue());
+  }
+  jw->EndObject();
+}
+
+void ReportLatencies(const MultiThreadedWriter& writer, const MultiThreadedReader* reader) {
+  if (FLAGS_latency_report_file.empty()) {
+    return;
+  }
+  std::stringstream out;
+  {
+    JsonWriter jw(&out, JsonWriter::PRETTY);
+    jw.StartObject();
+    WriteLatencyHistogram("write", writer.latency_histogram(), &jw);
+    if (reader) {
+      WriteLatencyHistogram("read", reader->latency_histogram(), &jw);
+    }
+    jw.EndObject();
+  }
+  if (FLAGS_latency_report_file == "-") {
+    std::cout << out.str() << std::endl;
+  } else {
+    CHECK_OK(yb::WriteStringToFile(yb::Env::Default(), out.str(), FLAGS_latency_report_file));
+  }
+}
+
 void LaunchYBLoadTest(SessionFactory *session_factory) {
   LOG(INFO) << "Starting load test";
   atomic_bool stop_flag(false);
@@ -360,19 +451,24 @@ void LaunchYBLoadTest(SessionFactory *session_factory) {
     MultiThreadedWriter writer(
         FLAGS_num_rows, 0, FLAGS_num_writer_threads, session_factory, &stop_flag,
         FLAGS_value_size_bytes, FLAGS_max_num_write_errors);
+    writer.set_target_ops_per_sec(FLAGS_target_write_ops_per_sec);
 
     writer.Start();
     writer.WaitForCompletion();
+    ReportLatencies(writer, nullptr);
   } else {
     MultiThreadedWriter writer(
         FLAGS_num_rows, 0, FLAGS_num_writer_threads, session_factory, &stop_flag,
         FLAGS_value_size_bytes, FLAGS_max_num_write_errors);
+    writer.set_target_ops_per_sec(FLAGS_target_write_ops_per_sec);
 
     writer.Start();
     MultiThreadedReader reader(FLAGS_num_rows, FLAGS_num_reader_threads, session_factory,
                                writer.InsertionPoint(), writer.InsertedKeys(), writer.FailedKeys(),
                                &stop_flag, FLAGS_value_size_bytes, FLAGS_max_num_read_errors,
                                FLAGS_stop_on_empty_read);
+    reader.set_key_distribution(GetKeyDistributionOptions());
+    reader.set_target_ops_per_sec(FLAGS_target_read_ops_per_sec);
 
     reader.Start();
 
@@ -381,5 +477,6 @@ void LaunchYBLoadTest(SessionFactory *session_factory) {
     // The reader will not stop on its own, so we stop it as soon as the writer stops.
     reader.Stop();
     reader.WaitForCompletion();
+    ReportLatencies(writer, &reader);
   }
 }
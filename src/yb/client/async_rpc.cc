@@ -17,13 +17,17 @@
 #include "yb/client/client-internal.h"
 #include "yb/client/in_flight_op.h"
 #include "yb/client/meta_cache.h"
+#include "yb/client/tablet_rpc_coalescer.h"
 #include "yb/client/yb_op.h"
 
 #include "yb/common/wire_protocol.h"
 #include "yb/common/transaction.h"
 
+#include "yb/rpc/messenger.h"
+
 #include "yb/util/cast.h"
 #include "yb/util/debug-util.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
 
 // TODO: do we need word Redis in following two metrics? ReadRpc and WriteRpc objects emitting
@@ -44,6 +48,33 @@ METRIC_DEFINE_histogram(
     server, handler_latency_yb_client_time_to_send,
     "Time taken for a Write/Read rpc to be sent to the server", yb::MetricUnit::kMicroseconds,
     "Microseconds spent before sending the request to the server", 60000000LU, 2);
+METRIC_DEFINE_counter(
+    server, yb_client_hedged_reads, "Hedged consistent prefix reads",
+    yb::MetricUnit::kRequests,
+    "Number of consistent prefix reads that were also sent to another replica, because the first "
+    "replica did not answer in time");
+METRIC_DEFINE_counter(
+    server, yb_client_hedged_read_wins, "Hedged consistent prefix read wins",
+    yb::MetricUnit::kRequests,
+    "Number of hedged consistent prefix reads, that were answered by the other replica first");
+
+DEFINE_bool(enable_hedged_consistent_prefix_reads, false,
+            "Send a consistent prefix read also to another replica, when the first replica does "
+            "not answer within the latency that is observed for the tablet at "
+            "--hedged_read_latency_percentile.");
+TAG_FLAG(enable_hedged_consistent_prefix_reads, advanced);
+TAG_FLAG(enable_hedged_consistent_prefix_reads, runtime);
+
+DEFINE_int32(hedged_read_latency_percentile, 95,
+             "Percentile of recent read latencies of a tablet, after which a hedged read is sent.");
+TAG_FLAG(hedged_read_latency_percentile, advanced);
+TAG_FLAG(hedged_read_latency_percentile, runtime);
+
+DEFINE_int32(hedged_read_min_delay_us, 1000,
+             "Minimal time to wait for the response before sending a hedged read.");
+TAG_FLAG(hedged_read_min_delay_us, advanced);
+TAG_FLAG(hedged_read_min_delay_us, runtime);
+
 DECLARE_bool(rpc_dump_all_traces);
 DECLARE_bool(collect_end_to_end_traces);
 
@@ -74,7 +105,9 @@ AsyncRpcMetrics::AsyncRpcMetrics(const scoped_refptr<yb::MetricEntity>& entity)
       remote_read_rpc_time(METRIC_handler_latency_yb_client_read_remote.Instantiate(entity)),
       local_write_rpc_time(METRIC_handler_latency_yb_client_write_local.Instantiate(entity)),
       local_read_rpc_time(METRIC_handler_latency_yb_client_read_local.Instantiate(entity)),
-      time_to_send(METRIC_handler_latency_yb_client_time_to_send.Instantiate(entity)) {
+      time_to_send(METRIC_handler_latency_yb_client_time_to_send.Instantiate(entity)),
+      hedged_reads(METRIC_yb_client_hedged_reads.Instantiate(entity)),
+      hedged_read_wins(METRIC_yb_client_hedged_read_wins.Instantiate(entity)) {
 }
 
 AsyncRpc::AsyncRpc(
@@ -128,7 +161,15 @@ const YBTable* AsyncRpc::table() const {
   return ops_[0]->yb_op->table();
 }
 
+void AsyncRpc::AttemptFinished() {
+  if (rpc_ts_) {
+    rpc_ts_->RpcFinished(MonoTime::Now().GetDeltaSince(rpc_start_));
+    rpc_ts_ = nullptr;
+  }
+}
+
 void AsyncRpc::Finished(const Status& status) {
+  AttemptFinished();
   Status new_status = status;
   if (tablet_invoker_.Done(&new_status)) {
     ProcessResponseFromTserver(new_status);
@@ -175,6 +216,36 @@ void AsyncRpc::Failed(const Status& status) {
   }
 }
 
+void AsyncRpc::FinishedWithController(const Status& status,
+                                      const std::shared_ptr<rpc::RpcController>& controller) {
+  AttemptFinished();
+  response_controller_ = controller;
+  // Retrier checks for TOO_BUSY only in its own controller, so do it here for this one.
+  if (status.IsRemoteError()) {
+    const auto* error = controller->error_response();
+    if (error && error->code() == ErrorStatusPB::ERROR_SERVER_TOO_BUSY) {
+      auto retry_status = mutable_retrier()->DelayedRetry(this, status);
+      LOG_IF(DFATAL, !retry_status.ok()) << "Retry failed: " << retry_status;
+      return;
+    }
+  }
+  Finished(status);
+}
+
+const rpc::RpcController& AsyncRpc::PrepareExternalController() {
+  // Controller of the previous attempt should not affect handling of the response.
+  mutable_retrier()->mutable_controller()->Reset();
+  return *PrepareController();
+}
+
+const rpc::RpcController& AsyncRpc::controller() const {
+  return response_controller_ ? *response_controller_ : retrier().controller();
+}
+
+TabletRpcCoalescer* AsyncRpc::coalescer() const {
+  return batcher_->client_->data_->rpc_coalescer_.get();
+}
+
 bool AsyncRpc::IsLocalCall() const {
   return tablet_invoker_.IsLocalCall();
 }
@@ -195,6 +266,11 @@ void AsyncRpc::SendRpcToTserver() {
   MonoTime end_time = MonoTime::Now();
   if (async_rpc_metrics_)
     async_rpc_metrics_->time_to_send->Increment(end_time.GetDeltaSince(start_).ToMicroseconds());
+  rpc_ts_ = tablet_invoker_.current_ts();
+  if (rpc_ts_) {
+    rpc_ts_->RpcStarted();
+    rpc_start_ = end_time;
+  }
   CallRemoteMethod();
 }
 
@@ -341,9 +417,16 @@ void WriteRpc::CallRemoteMethod() {
   TRACE_TO(trace, "SendRpcToTserver");
   ADOPT_TRACE(trace.get());
 
-  tablet_invoker_.proxy()->WriteAsync(
-      req_, &resp_, PrepareController(),
-      std::bind(&WriteRpc::Finished, this, Status::OK()));
+  response_controller_.reset();
+  if (coalescer() && TabletRpcCoalescer::CanCoalesce(req_)) {
+    coalescer()->Write(
+        tablet_invoker_.proxy(), PrepareExternalController(), &req_, &resp_,
+        std::bind(&WriteRpc::FinishedWithController, this, _1, _2));
+  } else {
+    tablet_invoker_.proxy()->WriteAsync(
+        req_, &resp_, PrepareController(),
+        std::bind(&WriteRpc::Finished, this, Status::OK()));
+  }
   TRACE_TO(trace, "RpcDispatched Asynchronously");
 }
 
@@ -387,10 +470,10 @@ void WriteRpc::ProcessResponseFromTserver(const Status& status) {
         const auto& ql_response = ql_op->response();
         if (ql_response.has_rows_data_sidecar()) {
           Slice rows_data;
-          CHECK_OK(retrier().controller().GetSidecar(
+          CHECK_OK(controller().GetSidecar(
               ql_response.rows_data_sidecar(), &rows_data));
-          down_cast<YBqlWriteOp*>(yb_op)->mutable_rows_data()->assign(
-              util::to_char_ptr(rows_data.data()), rows_data.size());
+          *down_cast<YBqlWriteOp*>(yb_op)->mutable_rows_data() =
+              RefCntBuffer(rows_data.data(), rows_data.size());
         }
         ql_idx++;
         break;
@@ -442,6 +525,15 @@ ReadRpc::ReadRpc(
         if (ql_op->read_time()) {
           ql_op->read_time().AddToPB(&req_);
         }
+        // Batch is served by single replica, so it should satisfy the strictest bound.
+        const auto& max_staleness = ql_op->max_staleness();
+        if (yb_consistency_level == YBConsistencyLevel::CONSISTENT_PREFIX &&
+            max_staleness.Initialized()) {
+          const uint64_t max_staleness_ms = max_staleness.ToMilliseconds();
+          if (!req_.has_max_staleness_ms() || max_staleness_ms < req_.max_staleness_ms()) {
+            req_.set_max_staleness_ms(max_staleness_ms);
+          }
+        }
         break;
       }
       case YBOperation::Type::REDIS_WRITE: FALLTHROUGH_INTENDED;
@@ -479,12 +571,163 @@ void ReadRpc::CallRemoteMethod() {
                        // Detailed explanation in WriteRpc::SendRpcToTserver.
   TRACE_TO(trace, "SendRpcToTserver");
   ADOPT_TRACE(trace.get());
-  tablet_invoker_.proxy()->ReadAsync(
-      req_, &resp_, PrepareController(),
-      std::bind(&ReadRpc::Finished, this, Status::OK()));
+  response_controller_.reset();
+  if (FLAGS_enable_hedged_consistent_prefix_reads &&
+      req_.consistency_level() == YBConsistencyLevel::CONSISTENT_PREFIX) {
+    auto hedge_delay =
+        tablet_invoker_.tablet()->ReadLatencyPercentile(FLAGS_hedged_read_latency_percentile);
+    if (hedge_delay.Initialized()) {
+      hedge_delay = std::max(hedge_delay,
+                             MonoDelta::FromMicroseconds(FLAGS_hedged_read_min_delay_us));
+    }
+    SendHedgeableRead(hedge_delay);
+  } else if (coalescer() && TabletRpcCoalescer::CanCoalesce(req_)) {
+    coalescer()->Read(
+        tablet_invoker_.proxy(), PrepareExternalController(), &req_, &resp_,
+        std::bind(&ReadRpc::FinishedWithController, this, _1, _2));
+  } else {
+    tablet_invoker_.proxy()->ReadAsync(
+        req_, &resp_, PrepareController(),
+        std::bind(&ReadRpc::Finished, this, Status::OK()));
+  }
   TRACE_TO(trace, "RpcDispatched Asynchronously");
 }
 
+struct ReadRpc::HedgedRead {
+  struct Attempt {
+    tserver::ReadResponsePB resp;
+    std::shared_ptr<rpc::RpcController> controller = std::make_shared<rpc::RpcController>();
+    RemoteTabletServer* ts = nullptr;
+    MonoTime start;
+  };
+
+  std::mutex mutex;
+  // The first attempt is sent to the replica selected by the tablet invoker, the second one is the
+  // hedge.
+  Attempt attempts[2];
+  tserver::ReadRequestPB hedge_req;
+  size_t outstanding = 1;
+  bool finished = false;
+  int64_t hedge_task_id = -1;
+};
+
+void ReadRpc::SendHedgeableRead(const MonoDelta& hedge_delay) {
+  auto hedged = std::make_shared<HedgedRead>();
+  const auto& retrier_controller = PrepareExternalController();
+  for (auto& attempt : hedged->attempts) {
+    attempt.controller->set_timeout(retrier_controller.timeout());
+    attempt.controller->set_allow_local_calls_in_curr_thread(
+        retrier_controller.allow_local_calls_in_curr_thread());
+  }
+
+  auto self = shared_from_this();
+  const auto& messenger = batcher_->messenger();
+  if (hedge_delay.Initialized()) {
+    auto task_id = messenger->ScheduleOnReactor(
+        [this, self, hedged](const Status& status) {
+          if (status.ok()) {
+            SendHedge(hedged);
+          }
+        },
+        hedge_delay, messenger);
+    std::lock_guard<std::mutex> lock(hedged->mutex);
+    if (!hedged->finished) {
+      hedged->hedge_task_id = task_id;
+    }
+  }
+
+  // Both attempts report their own latency to their servers.
+  auto& attempt = hedged->attempts[0];
+  attempt.ts = rpc_ts_;
+  rpc_ts_ = nullptr;
+  attempt.start = MonoTime::Now();
+  tablet_invoker_.proxy()->ReadAsync(
+      req_, &attempt.resp, attempt.controller.get(),
+      [this, self, hedged] { HedgedAttemptDone(hedged, 0); });
+}
+
+void ReadRpc::SendHedge(const std::shared_ptr<HedgedRead>& hedged) {
+  RemoteTabletServer* ts;
+  std::shared_ptr<tserver::TabletServerServiceProxy> proxy;
+  {
+    // The read could not be finished, and so retried, while the lock is held. So the tablet invoker
+    // and req_ could be accessed under it.
+    std::lock_guard<std::mutex> lock(hedged->mutex);
+    hedged->hedge_task_id = -1;
+    if (hedged->finished) {
+      return;
+    }
+    ts = tablet_invoker_.SelectHedgeTabletServer();
+    if (!ts) {
+      return;
+    }
+    proxy = ts->proxy();
+    if (proxy) {
+      hedged->hedge_req = req_;
+      ++hedged->outstanding;
+    }
+  }
+  if (!proxy) {
+    // Do not wait for DNS resolution, just make the replica ready for the next hedge.
+    ts->InitProxy(&tablet_invoker_.client(), Bind(&DoNothingStatusCB));
+    return;
+  }
+  auto& attempt = hedged->attempts[1];
+  VLOG(2) << ToString() << ": Sending hedged read to " << ts->ToString();
+  if (async_rpc_metrics_) {
+    async_rpc_metrics_->hedged_reads->Increment();
+  }
+  attempt.ts = ts;
+  attempt.start = MonoTime::Now();
+  ts->RpcStarted();
+  proxy->ReadAsync(
+      hedged->hedge_req, &attempt.resp, attempt.controller.get(),
+      [this, self = shared_from_this(), hedged] { HedgedAttemptDone(hedged, 1); });
+}
+
+void ReadRpc::HedgedAttemptDone(const std::shared_ptr<HedgedRead>& hedged, size_t attempt_idx) {
+  auto& attempt = hedged->attempts[attempt_idx];
+  const bool ok = attempt.controller->status().ok() && !attempt.resp.has_error();
+  const auto latency = MonoTime::Now().GetDeltaSince(attempt.start);
+  if (attempt.ts) {
+    attempt.ts->RpcFinished(latency);
+  }
+  if (ok) {
+    tablet_invoker_.tablet()->RecordReadLatency(latency);
+  }
+
+  size_t winner_idx;
+  int64_t hedge_task_id;
+  {
+    std::lock_guard<std::mutex> lock(hedged->mutex);
+    --hedged->outstanding;
+    if (hedged->finished) {
+      return;
+    }
+    if (ok) {
+      winner_idx = attempt_idx;
+    } else if (hedged->outstanding == 0) {
+      // Both attempts failed, so handle the failure of the first one, since the tablet invoker
+      // picked its replica.
+      winner_idx = 0;
+    } else {
+      return;
+    }
+    hedged->finished = true;
+    hedge_task_id = hedged->hedge_task_id;
+  }
+
+  if (hedge_task_id != -1) {
+    batcher_->messenger()->AbortOnReactor(hedge_task_id);
+  }
+  if (winner_idx == 1 && async_rpc_metrics_) {
+    async_rpc_metrics_->hedged_read_wins->Increment();
+  }
+  auto& winner = hedged->attempts[winner_idx];
+  resp_.Swap(&winner.resp);
+  FinishedWithController(winner.controller->status(), winner.controller);
+}
+
 void ReadRpc::ProcessResponseFromTserver(const Status& status) {
   TRACE_TO(trace_, "ProcessResponseFromTserver($0)", status.ToString(false));
   if (resp_.has_trace_buffer()) {
@@ -525,10 +768,10 @@ void ReadRpc::ProcessResponseFromTserver(const Status& status) {
         const auto& ql_response = ql_op->response();
         if (ql_response.has_rows_data_sidecar()) {
           Slice rows_data;
-          CHECK_OK(retrier().controller().GetSidecar(
+          CHECK_OK(controller().GetSidecar(
               ql_response.rows_data_sidecar(), &rows_data));
-          down_cast<YBqlReadOp*>(yb_op)->mutable_rows_data()->assign(
-              util::to_char_ptr(rows_data.data()), rows_data.size());
+          *down_cast<YBqlReadOp*>(yb_op)->mutable_rows_data() =
+              RefCntBuffer(rows_data.data(), rows_data.size());
         }
         ql_idx++;
         break;
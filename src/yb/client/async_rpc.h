@@ -43,6 +43,8 @@ struct AsyncRpcMetrics {
   scoped_refptr<Histogram> local_write_rpc_time;
   scoped_refptr<Histogram> local_read_rpc_time;
   scoped_refptr<Histogram> time_to_send;
+  scoped_refptr<Counter> hedged_reads;
+  scoped_refptr<Counter> hedged_read_wins;
 };
 
 typedef std::shared_ptr<AsyncRpcMetrics> AsyncRpcMetricsPtr;
@@ -86,6 +88,23 @@ class AsyncRpc : public rpc::Rpc, public TabletRpc {
 
   void Failed(const Status& status) override;
 
+  // Reports latency of the completed attempt to the server it was sent to.
+  void AttemptFinished();
+
+  // Invoked instead of Finished() when the request was sent with a controller other than the one
+  // of the retrier, i.e. by TabletRpcCoalescer or as a hedged read.
+  void FinishedWithController(const Status& status,
+                              const std::shared_ptr<rpc::RpcController>& controller);
+
+  // Prepares the retrier controller for the next attempt, that is sent with another controller.
+  // The returned controller provides the timeout for that attempt.
+  const rpc::RpcController& PrepareExternalController();
+
+  // Controller of the last call, it should be used to access sidecars of the response.
+  const rpc::RpcController& controller() const;
+
+  TabletRpcCoalescer* coalescer() const;
+
   // Is this a local call?
   bool IsLocalCall() const;
 
@@ -102,6 +121,13 @@ class AsyncRpc : public rpc::Rpc, public TabletRpc {
   // These operations are in kRequestSent state.
   InFlightOps ops_;
 
+  // Controller of the RPC that carried the last attempt, if it is not the retrier controller.
+  std::shared_ptr<rpc::RpcController> response_controller_;
+
+  // Server the current attempt was sent to, and when, to report its latency on completion.
+  RemoteTabletServer* rpc_ts_ = nullptr;
+  MonoTime rpc_start_;
+
   MonoTime start_;
   std::shared_ptr<AsyncRpcMetrics> async_rpc_metrics_;
   rpc::RpcCommandPtr retained_self_;
@@ -157,8 +183,17 @@ class ReadRpc : public AsyncRpcBase<tserver::ReadRequestPB, tserver::ReadRespons
   virtual ~ReadRpc();
 
  private:
+  struct HedgedRead;
+
   void CallRemoteMethod() override;
   void ProcessResponseFromTserver(const Status& status) override;
+
+  // Sends the consistent prefix read to the selected replica. If it does not answer within
+  // 'hedge_delay', the same read is also sent to another replica, and the first successful response
+  // is used. Hedging is not done when 'hedge_delay' is not initialized.
+  void SendHedgeableRead(const MonoDelta& hedge_delay);
+  void SendHedge(const std::shared_ptr<HedgedRead>& hedged);
+  void HedgedAttemptDone(const std::shared_ptr<HedgedRead>& hedged, size_t attempt_idx);
 };
 
 }  // namespace internal
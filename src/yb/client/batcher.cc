@@ -110,6 +110,7 @@ Batcher::Batcher(YBClient* client,
 
 void Batcher::Abort(const Status& status) {
   std::unique_lock<simple_spinlock> l(lock_);
+  const bool was_flushing = state_ == kFlushing;
   state_ = kAborted;
 
   InFlightOps to_abort;
@@ -128,6 +129,10 @@ void Batcher::Abort(const Status& status) {
   if (flush_callback_) {
     l.unlock();
 
+    auto transaction = this->transaction();
+    if (was_flushing && transaction) {
+      transaction->BatchFinished(status);
+    }
     flush_callback_(status);
   }
 }
@@ -189,6 +194,11 @@ void Batcher::CheckForFinishedFlush() {
     s = STATUS(IOError, "Some errors occurred");
   }
 
+  auto transaction = this->transaction();
+  if (transaction) {
+    transaction->BatchFinished(s);
+  }
+
   flush_callback_(s);
 }
 
@@ -205,6 +215,11 @@ MonoTime Batcher::ComputeDeadlineUnlocked() const {
 }
 
 void Batcher::FlushAsync(boost::function<void(const Status&)> callback) {
+  auto transaction = this->transaction();
+  if (transaction) {
+    transaction->BatchStarted();
+  }
+
   {
     std::lock_guard<simple_spinlock> l(lock_);
     CHECK_EQ(state_, kGatheringOps);
@@ -257,11 +272,22 @@ Status Batcher::Add(shared_ptr<YBOperation> yb_op) {
   if (yb_op->tablet()) {
     in_flight_op->tablet = yb_op->tablet();
     TabletLookupFinished(std::move(in_flight_op), Status::OK());
+    return Status::OK();
+  }
+
+  // Large batches, e.g. unlogged CQL batches spread over many partitions, usually hit the cache
+  // for all operations. So resolve the tablet inline without starting a lookup rpc for each of
+  // them.
+  auto& meta_cache = client_->data_->meta_cache_;
+  in_flight_op->tablet = meta_cache->LookupTabletByKeyIfCached(
+      in_flight_op->yb_op->table(), in_flight_op->partition_key);
+  if (in_flight_op->tablet) {
+    TabletLookupFinished(std::move(in_flight_op), Status::OK());
   } else {
     // deadline_ is set in FlushAsync(), after all Add() calls are done, so
     // here we're forced to create a new deadline.
     MonoTime deadline = ComputeDeadlineUnlocked();
-    client_->data_->meta_cache_->LookupTabletByKey(
+    meta_cache->LookupTabletByKey(
         in_flight_op->yb_op->table(), in_flight_op->partition_key, deadline, &in_flight_op->tablet,
         Bind(&Batcher::TabletLookupFinished, this, in_flight_op));
   }
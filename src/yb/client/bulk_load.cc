@@ -0,0 +1,216 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#include "yb/client/bulk_load.h"
+
+#include <memory>
+#include <vector>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "yb/client/client.h"
+#include "yb/common/wire_protocol.h"
+#include "yb/gutil/strings/util.h"
+#include "yb/master/master.pb.h"
+#include "yb/rpc/messenger.h"
+#include "yb/rpc/rpc_controller.h"
+#include "yb/tserver/tserver_service.proxy.h"
+#include "yb/util/countdown_latch.h"
+#include "yb/util/env.h"
+#include "yb/util/flag_tags.h"
+#include "yb/util/net/net_util.h"
+#include "yb/util/path_util.h"
+
+DEFINE_int32(bulk_load_upload_chunk_size_bytes, 1024 * 1024,
+             "Size of chunks that bulk load files are uploaded to tablet replicas with.");
+TAG_FLAG(bulk_load_upload_chunk_size_bytes, advanced);
+
+namespace yb {
+namespace client {
+
+using tserver::TabletServerErrorPB;
+using tserver::TabletServerServiceProxy;
+
+namespace {
+
+struct Replica {
+  std::string uuid;
+  bool is_leader = false;
+  std::unique_ptr<TabletServerServiceProxy> proxy;
+};
+
+Result<std::vector<Replica>> GetReplicas(YBClient* client, const TabletId& tablet_id) {
+  master::TabletLocationsPB locations;
+  RETURN_NOT_OK(client->GetTabletLocation(tablet_id, &locations));
+  std::vector<Replica> result;
+  for (const auto& replica_pb : locations.replicas()) {
+    const auto& ts_info = replica_pb.ts_info();
+    if (ts_info.rpc_addresses().empty()) {
+      return STATUS_FORMAT(IllegalState, "No RPC address for $0", ts_info.permanent_uuid());
+    }
+    HostPort host_port;
+    RETURN_NOT_OK(HostPortFromPB(ts_info.rpc_addresses(0), &host_port));
+    std::vector<Endpoint> endpoints;
+    RETURN_NOT_OK(host_port.ResolveAddresses(&endpoints));
+    if (endpoints.empty()) {
+      return STATUS_FORMAT(NetworkError, "Could not resolve $0", host_port);
+    }
+    Replica replica;
+    replica.uuid = ts_info.permanent_uuid();
+    replica.is_leader = replica_pb.role() == consensus::RaftPeerPB::LEADER;
+    replica.proxy = std::make_unique<TabletServerServiceProxy>(client->messenger(), endpoints[0]);
+    result.push_back(std::move(replica));
+  }
+  if (result.empty()) {
+    return STATUS_FORMAT(NotFound, "No replicas for tablet $0", tablet_id);
+  }
+  return result;
+}
+
+template <class Resp>
+Status ResponseStatus(const rpc::RpcController& controller, const Resp& resp) {
+  RETURN_NOT_OK(controller.status());
+  if (resp.has_error()) {
+    return StatusFromPB(resp.error().status());
+  }
+  return Status::OK();
+}
+
+// Uploads the file to all replicas, chunk by chunk. Each chunk is sent to replicas in parallel.
+Status UploadFile(const std::vector<Replica>& replicas,
+                  const TabletId& tablet_id,
+                  const std::string& load_id,
+                  const std::string& source_dir,
+                  const std::string& file_name,
+                  const MonoTime& deadline) {
+  gscoped_ptr<SequentialFile> file;
+  RETURN_NOT_OK(Env::Default()->NewSequentialFile(JoinPathSegments(source_dir, file_name), &file));
+
+  tserver::UploadBulkLoadFileRequestPB req;
+  req.set_tablet_id(tablet_id);
+  req.set_load_id(load_id);
+  req.set_file_name(file_name);
+  std::vector<uint8_t> buffer(FLAGS_bulk_load_upload_chunk_size_bytes);
+  std::vector<tserver::UploadBulkLoadFileResponsePB> resps(replicas.size());
+  std::vector<rpc::RpcController> controllers(replicas.size());
+  uint64_t offset = 0;
+  for (;;) {
+    Slice chunk;
+    RETURN_NOT_OK(file->Read(buffer.size(), &chunk, buffer.data()));
+    // Empty files are uploaded too, so they exist on replicas.
+    if (chunk.empty() && offset != 0) {
+      return Status::OK();
+    }
+    req.set_offset(offset);
+    req.set_data(chunk.data(), chunk.size());
+
+    CountDownLatch latch(replicas.size());
+    for (size_t i = 0; i != replicas.size(); ++i) {
+      resps[i].Clear();
+      controllers[i].Reset();
+      controllers[i].set_deadline(deadline);
+      replicas[i].proxy->UploadBulkLoadFileAsync(
+          req, &resps[i], &controllers[i], [&latch] { latch.CountDown(); });
+    }
+    latch.Wait();
+    for (size_t i = 0; i != replicas.size(); ++i) {
+      auto status = ResponseStatus(controllers[i], resps[i]);
+      if (!status.ok()) {
+        return status.CloneAndPrepend(Format(
+            "Failed to upload $0 at offset $1 to $2", file_name, offset, replicas[i].uuid));
+      }
+    }
+    if (chunk.empty()) {
+      return Status::OK();
+    }
+    offset += chunk.size();
+  }
+}
+
+} // namespace
+
+Status BulkLoadTablet(YBClient* client,
+                      const TabletId& tablet_id,
+                      const std::string& load_id,
+                      const std::string& source_dir,
+                      HybridTime load_hybrid_time,
+                      const MonoDelta& timeout) {
+  const auto deadline = MonoTime::Now() + timeout;
+  auto replicas = VERIFY_RESULT(GetReplicas(client, tablet_id));
+
+  std::vector<std::string> files;
+  RETURN_NOT_OK(Env::Default()->GetChildren(source_dir, ExcludeDots::kTrue, &files));
+  for (const auto& file_name : files) {
+    // Lock and info log are not part of the data.
+    if (file_name == "LOCK" || HasPrefixString(file_name, "LOG")) {
+      continue;
+    }
+    RETURN_NOT_OK(UploadFile(replicas, tablet_id, load_id, source_dir, file_name, deadline));
+  }
+  LOG(INFO) << "Uploaded " << source_dir << " to " << replicas.size() << " replicas of tablet "
+            << tablet_id << " as bulk load " << load_id;
+
+  tserver::IngestBulkLoadRequestPB req;
+  req.set_tablet_id(tablet_id);
+  req.set_load_id(load_id);
+  req.set_load_hybrid_time(load_hybrid_time.ToUint64());
+  bool retried = false;
+  for (;;) {
+    Status status;
+    const Replica* leader = nullptr;
+    for (const auto& replica : replicas) {
+      if (replica.is_leader) {
+        leader = &replica;
+      }
+    }
+    if (leader) {
+      tserver::IngestBulkLoadResponsePB resp;
+      rpc::RpcController controller;
+      controller.set_deadline(deadline);
+      status = leader->proxy->IngestBulkLoad(req, &resp, &controller);
+      if (status.ok() && resp.has_error()) {
+        status = StatusFromPB(resp.error().status());
+        if (resp.error().code() != TabletServerErrorPB::NOT_THE_LEADER &&
+            resp.error().code() != TabletServerErrorPB::LEADER_NOT_READY_TO_SERVE) {
+          // Uploaded files are removed on ingestion, so after an attempt with unknown outcome
+          // missing files mean that the load was ingested.
+          if (retried && status.IsNotFound()) {
+            return Status::OK();
+          }
+          return status;
+        }
+      }
+      if (status.ok()) {
+        return Status::OK();
+      }
+    } else {
+      status = STATUS_FORMAT(NotFound, "No leader for tablet $0", tablet_id);
+    }
+    if (MonoTime::Now() >= deadline) {
+      return status.CloneAndPrepend("Failed to ingest bulk load");
+    }
+    VLOG(1) << "Retrying ingestion of bulk load " << load_id << ": " << status;
+    retried = true;
+    SleepFor(MonoDelta::FromMilliseconds(100));
+    // Replicas are the same, since they all have the uploaded files, only the leader could change.
+    auto new_replicas = GetReplicas(client, tablet_id);
+    if (new_replicas.ok()) {
+      replicas = std::move(*new_replicas);
+    }
+  }
+}
+
+}  // namespace client
+}  // namespace yb
@@ -0,0 +1,50 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#ifndef YB_CLIENT_BULK_LOAD_H
+#define YB_CLIENT_BULK_LOAD_H
+
+#include <string>
+
+#include "yb/common/entity_ids.h"
+#include "yb/common/hybrid_time.h"
+
+#include "yb/util/monotime.h"
+#include "yb/util/status.h"
+
+namespace yb {
+namespace client {
+
+class YBClient;
+
+// Ingests the RocksDB directory 'source_dir', built for the tablet outside of the cluster, e.g. by
+// yb-bulk_load or by a Spark task using BulkLoadDocDBUtil, into the running tablet:
+// 1) Files of the directory are uploaded to every replica of the tablet.
+// 2) The tablet leader replicates a bulk load operation, that contains only 'load_id', and each
+//    replica adds the uploaded files to its RocksDB when it applies the operation.
+// So the load does not go through the write path, and becomes visible atomically at the hybrid time
+// of the operation. All records of the directory should be written at 'load_hybrid_time', that
+// should be in the past. 'load_id' identifies the uploaded files on replicas, so it should be
+// unique for the tablet.
+CHECKED_STATUS BulkLoadTablet(YBClient* client,
+                              const TabletId& tablet_id,
+                              const std::string& load_id,
+                              const std::string& source_dir,
+                              HybridTime load_hybrid_time,
+                              const MonoDelta& timeout);
+
+}  // namespace client
+}  // namespace yb
+
+#endif  // YB_CLIENT_BULK_LOAD_H
@@ -65,6 +65,7 @@
 #include "yb/util/curl_util.h"
 #include "yb/util/flags.h"
 #include "yb/util/net/net_util.h"
+#include "yb/util/random_util.h"
 #include "yb/util/thread_restrictions.h"
 
 DECLARE_string(flagfile);
@@ -420,34 +421,20 @@ RemoteTabletServer* YBClient::Data::SelectTServer(RemoteTablet* rt,
           ret = filtered[0];
         }
       } else if (selection == CLOSEST_REPLICA) {
-        // Choose the closest replica.
-        bool local_zone_ts = false;
+        // Choose among the closest replicas, i.e. node local, zone local, region local or any.
+        vector<RemoteTabletServer*> closest;
+        int closest_distance = std::numeric_limits<int>::max();
         for (RemoteTabletServer* rts : filtered) {
-          if (IsTabletServerLocal(*rts)) {
-            ret = rts;
-            // If the tserver is local, we are done here.
-            break;
-          } else if (cloud_info_pb_.has_placement_zone() && rts->cloud_info().has_placement_zone()
-              && cloud_info_pb_.placement_zone() == rts->cloud_info().placement_zone()) {
-            // Note down that we have found a zone local tserver and continue looking for node
-            // local tserver.
-            ret = rts;
-            local_zone_ts = true;
-          } else if (cloud_info_pb_.has_placement_region() &&
-              rts->cloud_info().has_placement_region() &&
-              cloud_info_pb_.placement_region() == rts->cloud_info().placement_region() &&
-              !local_zone_ts) {
-            // Look for a region local tserver only if we haven't found a zone local tserver yet.
-            ret = rts;
+          const int distance = Distance(*rts);
+          if (distance < closest_distance) {
+            closest_distance = distance;
+            closest.clear();
+          }
+          if (distance == closest_distance) {
+            closest.push_back(rts);
           }
         }
-
-        // If ret is not null here, it should point to the closest replica from the client.
-
-        // Fallback to a random replica if none are local.
-        if (ret == nullptr && !filtered.empty()) {
-          ret = filtered[rand() % filtered.size()];
-        }
+        ret = PickLessLoaded(closest);
       }
       break;
     }
@@ -839,6 +826,41 @@ bool YBClient::Data::IsLocalHostPort(const HostPort& hp) const {
   return ContainsKey(local_host_names_, hp.host());
 }
 
+int YBClient::Data::Distance(const RemoteTabletServer& rts) const {
+  if (IsTabletServerLocal(rts)) {
+    return 0;
+  }
+  const auto& cloud_info = rts.cloud_info();
+  if (cloud_info_pb_.has_placement_zone() && cloud_info.has_placement_zone() &&
+      cloud_info_pb_.placement_zone() == cloud_info.placement_zone()) {
+    return 1;
+  }
+  if (cloud_info_pb_.has_placement_region() && cloud_info.has_placement_region() &&
+      cloud_info_pb_.placement_region() == cloud_info.placement_region()) {
+    return 2;
+  }
+  return 3;
+}
+
+RemoteTabletServer* YBClient::Data::PickLessLoaded(
+    const vector<RemoteTabletServer*>& candidates) {
+  // Power of two choices: compare two random candidates, so the load is spread by latency and
+  // in-flight RPCs, while all clients do not herd to the same least loaded server.
+  switch (candidates.size()) {
+    case 0:
+      return nullptr;
+    case 1:
+      return candidates[0];
+  }
+  const size_t first = RandomUniformInt<size_t>(0, candidates.size() - 1);
+  size_t second = RandomUniformInt<size_t>(0, candidates.size() - 2);
+  if (second >= first) {
+    ++second;
+  }
+  return candidates[first]->LoadScore() <= candidates[second]->LoadScore()
+      ? candidates[first] : candidates[second];
+}
+
 bool YBClient::Data::IsTabletServerLocal(const RemoteTabletServer& rts) const {
   // If the uuid's are same, we are sure the tablet server is local, since if this client is used
   // via the CQL proxy, the tablet server's uuid is set in the client.
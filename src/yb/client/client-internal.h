@@ -169,6 +169,14 @@ class YBClient::Data {
       const std::set<std::string>& blacklist,
       std::vector<internal::RemoteTabletServer*>* candidates);
 
+  // Returns how far is the tablet server from this client: 0 - the same node, 1 - the same zone,
+  // 2 - the same region, 3 - other.
+  int Distance(const internal::RemoteTabletServer& rts) const;
+
+  // Picks the less loaded of two random candidates, see RemoteTabletServer::LoadScore.
+  static internal::RemoteTabletServer* PickLessLoaded(
+      const std::vector<internal::RemoteTabletServer*>& candidates);
+
   // Sets 'master_proxy_' from the address specified by
   // 'leader_master_hostport_'.  Called by
   // GetLeaderMasterRpc::Finished() upon successful completion.
@@ -246,9 +254,13 @@ class YBClient::Data {
           master::MasterServiceProxy*, const ReqClass&, RespClass*, rpc::RpcController*)>& func);
 
   std::shared_ptr<rpc::Messenger> messenger_;
+  scoped_refptr<MetricEntity> metric_entity_;
   gscoped_ptr<DnsResolver> dns_resolver_;
   scoped_refptr<internal::MetaCache> meta_cache_;
 
+  // Merges requests of different batchers to the same tablet, see TabletRpcCoalescer.
+  std::shared_ptr<internal::TabletRpcCoalescer> rpc_coalescer_;
+
   // Set of hostnames and IPs on the local host.
   // This is initialized at client startup.
   std::unordered_set<std::string> local_host_names_;
@@ -79,6 +79,9 @@
 #include "yb/util/tostring.h"
 
 DECLARE_bool(enable_data_block_fsync);
+DECLARE_int32(client_background_flush_max_ops);
+DECLARE_int32(client_background_flush_max_batches_in_flight);
+DECLARE_int32(client_prefetch_table_locations_page_size);
 DECLARE_bool(log_inject_latency);
 DECLARE_int32(heartbeat_interval_ms);
 DECLARE_int32(log_inject_latency_ms_mean);
@@ -969,6 +972,53 @@ TEST_F(ClientTest, TestMultipleMultiRowManualBatches) {
   ASSERT_EQ("{ int32:0, int32:0, string:\"hello world\", null }", rows[0]);
 }
 
+TEST_F(ClientTest, TestFlushFuture) {
+  const int kNumSessions = 10;
+  const int kRowsPerSession = 5;
+  std::vector<YBSessionPtr> sessions;
+  std::vector<std::future<Status>> futures;
+  for (int s = 0; s < kNumSessions; s++) {
+    sessions.push_back(CreateSession());
+    for (int i = 0; i < kRowsPerSession; i++) {
+      const int key = s * kRowsPerSession + i;
+      ASSERT_OK(ApplyInsertToSession(sessions.back().get(), client_table_, key, key, "future"));
+    }
+    futures.push_back(sessions.back()->FlushFuture());
+  }
+  for (auto& future : futures) {
+    ASSERT_OK(future.get());
+  }
+  ASSERT_EQ(kNumSessions * kRowsPerSession, CountRowsFromClient(client_table_));
+}
+
+TEST_F(ClientTest, TestAutoFlushBackground) {
+  FLAGS_client_background_flush_max_ops = 7;
+  FLAGS_client_background_flush_max_batches_in_flight = 2;
+  auto session = CreateSession();
+  ASSERT_OK(session->SetFlushMode(YBSession::AUTO_FLUSH_BACKGROUND));
+  std::atomic<int> failed_flushes{0};
+  session->SetBackgroundFlushErrorCallback([&failed_flushes](const Status& status) {
+    ++failed_flushes;
+  });
+
+  const int kNumRows = 100;
+  for (int i = 0; i < kNumRows; i++) {
+    ASSERT_OK(ApplyInsertToSession(
+        session.get(), (i % 2 == 0) ? client_table_ : client_table2_, i, i * 10, "hello world"));
+  }
+  ASSERT_OK(session->Flush());
+  ASSERT_FALSE(session->HasPendingOperations());
+  ASSERT_EQ(0, failed_flushes.load());
+  ASSERT_EQ(kNumRows / 2, CountRowsFromClient(client_table_));
+  ASSERT_EQ(kNumRows / 2, CountRowsFromClient(client_table2_));
+
+  // Operations below the size threshold are flushed once their linger time expires.
+  ASSERT_OK(ApplyInsertToSession(session.get(), client_table_, kNumRows, 0, "linger"));
+  ASSERT_OK(WaitFor([this] { return CountRowsFromClient(client_table_) == kNumRows / 2 + 1; },
+                    10s, "Linger time flush"));
+  ASSERT_OK(session->Flush());
+}
+
 // Test a batch where one of the inserted rows succeeds and duplicates succeed too.
 TEST_F(ClientTest, TestBatchWithDuplicates) {
   auto session = CreateSession();
@@ -1650,6 +1700,42 @@ TEST_F(ClientTest, TestMasterLookupPermits) {
             client_->data_->meta_cache_->master_lookup_sem_.GetValue());
 }
 
+// Checks that locations of all tablets are fetched in pages after table is opened.
+TEST_F(ClientTest, TestPrefetchTableLocations) {
+  constexpr int kTablets = 8;
+  FLAGS_client_prefetch_table_locations_page_size = 3;
+
+  TableHandle table;
+  ASSERT_NO_FATALS(CreateTable(YBTableName("prefetch"), 1, kTablets, &table));
+
+  auto meta_cache = client_->data_->meta_cache_;
+  ASSERT_OK(WaitFor([meta_cache, &table]() -> bool {
+    shared_lock<rw_spinlock> lock(meta_cache->lock_);
+    auto it = meta_cache->tablets_by_table_and_key_.find(table->id());
+    return it != meta_cache->tablets_by_table_and_key_.end() && it->second.size() == kTablets;
+  }, 30s, "Prefetch table locations"));
+
+  // All tablets should be found without going to the master.
+  auto snapshot = meta_cache->tablets_snapshot_.get();
+  auto it = snapshot->find(table->id());
+  ASSERT_NE(it, snapshot->end());
+  const auto& tablets = it->second->tablets;
+  ASSERT_EQ(kTablets, tablets.size());
+  for (const auto& tablet : tablets) {
+    ASSERT_EQ(tablet.get(), meta_cache->LookupTabletByKeyFastPath(
+        table.get(), tablet->partition().partition_key_start()).get());
+  }
+
+  // Hash codes are routed through the lookup table once all tablets are known.
+  ASSERT_EQ(PartitionSchema::kMaxPartitionKey + 1, it->second->tablet_by_hash_code.size());
+  for (int hash_code = 0; hash_code <= PartitionSchema::kMaxPartitionKey; ++hash_code) {
+    const auto partition_key = PartitionSchema::EncodeMultiColumnHashValue(hash_code);
+    const auto tablet = meta_cache->LookupTabletByKeyFastPath(table.get(), partition_key);
+    ASSERT_TRUE(tablet != nullptr) << hash_code;
+    ASSERT_TRUE(tablet->partition().ContainsKey(partition_key)) << hash_code;
+  }
+}
+
 // Define callback for deadlock simulation, as well as various helper methods.
 namespace {
 
@@ -1811,6 +1897,37 @@ TEST_F(ClientTest, CreateTableWithoutTservers) {
   ASSERT_STR_CONTAINS(s.ToString(), "num_tablets should be greater than 0.");
 }
 
+TEST_F(ClientTest, TestSharedMessenger) {
+  const auto master_addr = ToString(cluster_->mini_master()->bound_rpc_addr());
+  shared_ptr<YBClient> client1;
+  ASSERT_OK(YBClientBuilder()
+                .add_master_server_addr(master_addr)
+                .use_shared_messenger()
+                .Build(&client1));
+  shared_ptr<YBClient> client2;
+  ASSERT_OK(YBClientBuilder()
+                .add_master_server_addr(master_addr)
+                .use_shared_messenger()
+                .default_rpc_timeout(MonoDelta::FromSeconds(10))
+                .Build(&client2));
+  ASSERT_EQ(client1->messenger(), client2->messenger());
+  ASSERT_NE(client_->messenger(), client1->messenger());
+  ASSERT_TRUE(client2->default_rpc_timeout().Equals(MonoDelta::FromSeconds(10)));
+
+  {
+    TableHandle table1;
+    ASSERT_OK(table1.Open(kTableName, client1.get()));
+    InsertTestRows(client1.get(), table1, 10);
+  }
+
+  // The messenger is still used by the other client, after the first one is destroyed.
+  client1.reset();
+  TableHandle table2;
+  ASSERT_OK(table2.Open(kTableName, client2.get()));
+  InsertTestRows(client2.get(), table2, 10, 10);
+  ASSERT_EQ(20, CountRowsFromClient(table2));
+}
+
 TEST_F(ClientTest, TestCreateTableWithTooManyTablets) {
   FLAGS_max_create_tablets_per_ts = 1;
 
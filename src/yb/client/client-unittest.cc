@@ -39,6 +39,7 @@
 
 #include "yb/client/client.h"
 #include "yb/client/client-internal.h"
+#include "yb/client/meta_cache.h"
 
 namespace yb {
 namespace client {
@@ -160,6 +161,45 @@ Status TestFunc(const MonoTime& deadline, bool* retry, int* counter) {
 }
 } // anonymous namespace
 
+TEST(ClientUnitTest, TestReadLatencyPercentile) {
+  scoped_refptr<internal::RemoteTablet> tablet(
+      new internal::RemoteTablet("tablet", Partition()));
+  for (int i = 1; i <= 10; ++i) {
+    tablet->RecordReadLatency(MonoDelta::FromMicroseconds(i));
+  }
+  // Not enough samples yet.
+  ASSERT_FALSE(tablet->ReadLatencyPercentile(95).Initialized());
+
+  for (int i = 11; i <= 100; ++i) {
+    tablet->RecordReadLatency(MonoDelta::FromMicroseconds(i));
+  }
+  // Only the last 64 samples, i.e. 37..100, are taken into account.
+  ASSERT_EQ(37, tablet->ReadLatencyPercentile(0).ToMicroseconds());
+  ASSERT_EQ(97, tablet->ReadLatencyPercentile(95).ToMicroseconds());
+  ASSERT_EQ(100, tablet->ReadLatencyPercentile(100).ToMicroseconds());
+}
+
+TEST(ClientUnitTest, TestTabletServerLoadScore) {
+  internal::RemoteTabletServer ts("ts", nullptr);
+  // Server without completed RPCs is preferred, so it gets probed.
+  ASSERT_EQ(0, ts.LoadScore());
+
+  ts.RpcStarted();
+  ts.RpcFinished(MonoDelta::FromMicroseconds(800));
+  ASSERT_EQ(800, ts.LoadScore());
+
+  ts.RpcStarted();
+  ts.RpcFinished(MonoDelta::FromMicroseconds(1600));
+  // 800 + (1600 - 800) / 8.
+  ASSERT_EQ(900, ts.LoadScore());
+
+  ts.RpcStarted();
+  ts.RpcStarted();
+  ASSERT_EQ(2700, ts.LoadScore());
+  ts.RpcFinished(MonoDelta::FromMicroseconds(900));
+  ASSERT_EQ(1800, ts.LoadScore());
+}
+
 TEST(ClientUnitTest, TestRetryFunc) {
   MonoTime deadline = MonoTime::Now();
   deadline.AddDelta(MonoDelta::FromMilliseconds(100));
@@ -51,6 +51,7 @@
 #include "yb/client/table-internal.h"
 #include "yb/client/table_alterer-internal.h"
 #include "yb/client/table_creator-internal.h"
+#include "yb/client/tablet_rpc_coalescer.h"
 #include "yb/client/tablet_server-internal.h"
 #include "yb/client/yb_op.h"
 #include "yb/common/common.pb.h"
@@ -65,6 +66,7 @@
 #include "yb/yql/redis/redisserver/redis_constants.h"
 #include "yb/yql/redis/redisserver/redis_parser.h"
 #include "yb/rpc/messenger.h"
+#include "yb/util/async_util.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/init.h"
 #include "yb/util/logging.h"
@@ -142,6 +144,7 @@ using internal::Batcher;
 using internal::ErrorCollector;
 using internal::MetaCache;
 using internal::RemoteTabletServer;
+using internal::TabletRpcCoalescer;
 using std::shared_ptr;
 
 // Adapts between the internal LogSeverity and the client's YBLogSeverity.
@@ -206,6 +209,23 @@ Status SetInternalSignalNumber(int signum) {
   return SetStackTraceSignal(signum);
 }
 
+// Returns the process-wide messenger of clients built with use_shared_messenger(), creating it if
+// all of them were destroyed, so the messenger does not outlive its last client.
+static Result<std::shared_ptr<rpc::Messenger>> SharedMessenger(int32_t num_reactors) {
+  static std::mutex mutex;
+  static std::weak_ptr<rpc::Messenger> shared_messenger;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto result = shared_messenger.lock();
+  if (!result) {
+    MessengerBuilder builder("yb_shared_client");
+    builder.set_num_reactors(num_reactors);
+    result = VERIFY_RESULT(builder.Build());
+    shared_messenger = result;
+  }
+  return result;
+}
+
 YBClientBuilder::YBClientBuilder()
   : data_(new YBClientBuilder::Data()) {
 }
@@ -267,6 +287,16 @@ YBClientBuilder& YBClientBuilder::set_client_name(const std::string& name) {
   return *this;
 }
 
+YBClientBuilder& YBClientBuilder::use_messenger(const std::shared_ptr<rpc::Messenger>& messenger) {
+  data_->messenger_ = messenger;
+  return *this;
+}
+
+YBClientBuilder& YBClientBuilder::use_shared_messenger() {
+  data_->use_shared_messenger_ = true;
+  return *this;
+}
+
 YBClientBuilder& YBClientBuilder::set_tserver_uuid(const TabletServerId& uuid) {
   data_->uuid_ = uuid;
   return *this;
@@ -283,10 +313,17 @@ Status YBClientBuilder::Build(shared_ptr<YBClient>* client) {
   shared_ptr<YBClient> c(new YBClient());
 
   // Init messenger.
-  MessengerBuilder builder(data_->client_name_);
-  builder.set_num_reactors(data_->num_reactors_);
-  builder.set_metric_entity(data_->metric_entity_);
-  RETURN_NOT_OK(builder.Build().MoveTo(&c->data_->messenger_));
+  if (data_->messenger_) {
+    c->data_->messenger_ = data_->messenger_;
+  } else if (data_->use_shared_messenger_) {
+    c->data_->messenger_ = VERIFY_RESULT(SharedMessenger(data_->num_reactors_));
+  } else {
+    MessengerBuilder builder(data_->client_name_);
+    builder.set_num_reactors(data_->num_reactors_);
+    builder.set_metric_entity(data_->metric_entity_);
+    RETURN_NOT_OK(builder.Build().MoveTo(&c->data_->messenger_));
+  }
+  c->data_->metric_entity_ = data_->metric_entity_;
 
   c->data_->master_server_endpoint_ = data_->master_server_endpoint_;
   c->data_->master_server_addrs_ = data_->master_server_addrs_;
@@ -302,6 +339,7 @@ Status YBClientBuilder::Build(shared_ptr<YBClient>* client) {
       "Could not locate the leader master");
 
   c->data_->meta_cache_.reset(new MetaCache(c.get()));
+  c->data_->rpc_coalescer_ = std::make_shared<TabletRpcCoalescer>(c->data_->messenger_);
   c->data_->dns_resolver_.reset(new DnsResolver());
 
   // Init local host names used for locality decisions.
@@ -796,6 +834,14 @@ const std::shared_ptr<rpc::Messenger>& YBClient::messenger() const {
   return data_->messenger_;
 }
 
+const scoped_refptr<MetricEntity>& YBClient::metric_entity() const {
+  return data_->metric_entity_;
+}
+
+const CloudInfoPB& YBClient::cloud_info() const {
+  return data_->cloud_info_pb_;
+}
+
 void YBClient::LookupTabletByKey(const YBTable* table,
                                  const std::string& partition_key,
                                  const MonoTime& deadline,
@@ -944,9 +990,9 @@ Status YBMetaDataCache::GetTable(const YBTableName& table_name,
                                  shared_ptr<YBTable>* table,
                                  bool* cache_used) {
   {
-    std::lock_guard<std::mutex> lock(cached_tables_mutex_);
-    auto itr = cached_tables_by_name_.find(table_name);
-    if (itr != cached_tables_by_name_.end()) {
+    auto snapshot = cached_tables_snapshot_.get();
+    auto itr = snapshot->by_name.find(table_name);
+    if (itr != snapshot->by_name.end()) {
       *table = itr->second;
       *cache_used = true;
       return Status::OK();
@@ -958,6 +1004,7 @@ Status YBMetaDataCache::GetTable(const YBTableName& table_name,
     std::lock_guard<std::mutex> lock(cached_tables_mutex_);
     cached_tables_by_name_[(*table)->name()] = *table;
     cached_tables_by_id_[(*table)->id()] = *table;
+    UpdateTablesSnapshotUnlocked();
   }
   *cache_used = false;
   return Status::OK();
@@ -967,9 +1014,9 @@ Status YBMetaDataCache::GetTable(const TableId& table_id,
                                  shared_ptr<YBTable>* table,
                                  bool* cache_used) {
   {
-    std::lock_guard<std::mutex> lock(cached_tables_mutex_);
-    auto itr = cached_tables_by_id_.find(table_id);
-    if (itr != cached_tables_by_id_.end()) {
+    auto snapshot = cached_tables_snapshot_.get();
+    auto itr = snapshot->by_id.find(table_id);
+    if (itr != snapshot->by_id.end()) {
       *table = itr->second;
       *cache_used = true;
       return Status::OK();
@@ -981,6 +1028,7 @@ Status YBMetaDataCache::GetTable(const TableId& table_id,
     std::lock_guard<std::mutex> lock(cached_tables_mutex_);
     cached_tables_by_name_[(*table)->name()] = *table;
     cached_tables_by_id_[table_id] = *table;
+    UpdateTablesSnapshotUnlocked();
   }
   *cache_used = false;
   return Status::OK();
@@ -993,6 +1041,7 @@ void YBMetaDataCache::RemoveCachedTable(const YBTableName& table_name) {
     const auto table_id = itr->second->id();
     cached_tables_by_name_.erase(itr);
     cached_tables_by_id_.erase(table_id);
+    UpdateTablesSnapshotUnlocked();
   }
 }
 
@@ -1003,9 +1052,15 @@ void YBMetaDataCache::RemoveCachedTable(const TableId& table_id) {
     const auto table_name = itr->second->name();
     cached_tables_by_name_.erase(table_name);
     cached_tables_by_id_.erase(itr);
+    UpdateTablesSnapshotUnlocked();
   }
 }
 
+void YBMetaDataCache::UpdateTablesSnapshotUnlocked() {
+  // Readers of the snapshot never lock cached_tables_mutex_, so waiting for them here is safe.
+  cached_tables_snapshot_.Set(TablesSnapshot{cached_tables_by_name_, cached_tables_by_id_});
+}
+
 Status YBMetaDataCache::GetUDType(const string &keyspace_name,
                                   const string &type_name,
                                   shared_ptr<QLType> *type,
@@ -1443,6 +1498,10 @@ void YBSession::SetTimeout(MonoDelta timeout) {
   data_->SetTimeout(timeout);
 }
 
+void YBSession::SetBackgroundFlushErrorCallback(boost::function<void(const Status&)> callback) {
+  data_->SetBackgroundFlushErrorCallback(std::move(callback));
+}
+
 Status YBSession::Flush() {
   return data_->Flush();
 }
@@ -1451,6 +1510,10 @@ void YBSession::FlushAsync(boost::function<void(const Status&)> callback) {
   data_->FlushAsync(std::move(callback));
 }
 
+std::future<Status> YBSession::FlushFuture() {
+  return MakeFuture<Status>([this](auto callback) { this->FlushAsync(std::move(callback)); });
+}
+
 bool YBSession::HasPendingOperations() const {
   return data_->HasPendingOperations();
 }
@@ -1468,6 +1531,12 @@ void YBSession::ReadAsync(std::shared_ptr<YBOperation> yb_op,
   FlushAsync(std::move(callback));
 }
 
+std::future<Status> YBSession::ReadFuture(std::shared_ptr<YBOperation> yb_op) {
+  return MakeFuture<Status>([this, &yb_op](auto callback) {
+    this->ReadAsync(std::move(yb_op), std::move(callback));
+  });
+}
+
 Status YBSession::Apply(std::shared_ptr<YBOperation> yb_op) {
   return data_->Apply(std::move(yb_op));
 }
@@ -34,6 +34,7 @@
 
 #include <stdint.h>
 
+#include <future>
 #include <memory>
 #include <string>
 #include <vector>
@@ -62,6 +63,7 @@
 
 #include "yb/rpc/rpc_fwd.h"
 
+#include "yb/util/concurrent_value.h"
 #include "yb/util/monotime.h"
 #include "yb/util/result.h"
 #include "yb/util/status.h"
@@ -202,6 +204,16 @@ class YBClientBuilder {
   // Sets client name to be used for naming the client's messenger/reactors.
   YBClientBuilder& set_client_name(const std::string& name);
 
+  // Sets the messenger used by the client, instead of creating a messenger of its own. Clients
+  // that use the same messenger share its reactor threads and connections to the servers, while
+  // timeouts and metrics of each client are still set by its own builder. The number of reactors
+  // and the client name are ignored for the messenger in this case.
+  YBClientBuilder& use_messenger(const std::shared_ptr<rpc::Messenger>& messenger);
+
+  // Uses the process-wide messenger shared by all clients built with this option. The messenger
+  // is created by the first of them, and shut down when the last of them is destroyed.
+  YBClientBuilder& use_shared_messenger();
+
   // Sets skip master leader resolution.
   // Used in tests, when we do not have real master.
   YBClientBuilder& set_skip_master_leader_resolution(bool value);
@@ -227,9 +239,9 @@ class YBClientBuilder {
 // The YBClient represents a connection to a cluster. From the user
 // perspective, they should only need to create one of these in their
 // application, likely a singleton -- but it's not a singleton in YB in any
-// way. Different Client objects do not interact with each other -- no
-// connection pooling, etc. Each YBClient instance is sandboxed with no
-// global cross-client state.
+// way. Different Client objects do not interact with each other, unless they
+// were built to share a messenger, see YBClientBuilder::use_messenger. Otherwise
+// each YBClient instance is sandboxed with no global cross-client state.
 //
 // In the implementation, the client holds various pieces of common
 // infrastructure which is not table-specific:
@@ -460,6 +472,12 @@ class YBClient : public std::enable_shared_from_this<YBClient> {
 
   const std::shared_ptr<rpc::Messenger>& messenger() const;
 
+  // Metric entity of this client, could differ from the metric entity of a shared messenger.
+  const scoped_refptr<MetricEntity>& metric_entity() const;
+
+  // Placement of this client, as specified by YBClientBuilder::set_cloud_info_pb.
+  const CloudInfoPB& cloud_info() const;
+
  private:
   class Data;
 
@@ -481,6 +499,7 @@ class YBClient : public std::enable_shared_from_this<YBClient> {
   FRIEND_TEST(ClientTest, TestGetTabletServerBlacklist);
   FRIEND_TEST(ClientTest, TestMasterDown);
   FRIEND_TEST(ClientTest, TestMasterLookupPermits);
+  FRIEND_TEST(ClientTest, TestPrefetchTableLocations);
   FRIEND_TEST(ClientTest, TestReplicatedMultiTabletTableFailover);
   FRIEND_TEST(ClientTest, TestReplicatedTabletWritesWithLeaderElection);
   FRIEND_TEST(ClientTest, TestScanFaultTolerance);
@@ -547,6 +566,18 @@ class YBMetaDataCache {
 
   std::mutex cached_tables_mutex_;
 
+  struct TablesSnapshot {
+    YBTableByNameMap by_name;
+    YBTableByIdMap by_id;
+  };
+
+  // Read-only copy of the cached tables, so lookups of already opened tables do not lock
+  // cached_tables_mutex_. Published after every change of the cached tables.
+  ConcurrentValue<TablesSnapshot> cached_tables_snapshot_;
+
+  // Publishes cached_tables_snapshot_, requires cached_tables_mutex_ to be held.
+  void UpdateTablesSnapshotUnlocked();
+
   // Map from type-name to QLType instances.
   typedef std::unordered_map<std::pair<string, string>,
                              std::shared_ptr<QLType>,
@@ -884,21 +915,19 @@ class YBSession : public std::enable_shared_from_this<YBSession> {
     AUTO_FLUSH_SYNC,
 
     // Apply() calls will return immediately, but the writes will be sent in
-    // the background, potentially batched together with other writes from
-    // the same session. If there is not sufficient buffer space, then Apply()
-    // may block for buffer space to be available.
+    // the background, batched together with other writes from the same session.
+    // A batch is sent once it has --client_background_flush_max_ops operations,
+    // or --client_background_flush_interval_ms after its first operation. If
+    // --client_background_flush_max_batches_in_flight batches are already in
+    // flight, Apply() blocks until one of them finishes.
     //
     // Because writes are applied in the background, any errors will be stored
     // in a session-local buffer. Call CountPendingErrors() or GetPendingErrors()
-    // to retrieve them.
-    // TODO: provide an API for the user to specify a callback to do their own
-    // error reporting.
-    // TODO: specify which threads the background activity runs on (probably the
-    // messenger IO threads?)
-    //
-    // NOTE: This is not implemented yet, see KUDU-456.
+    // to retrieve them, or use SetBackgroundFlushErrorCallback() to be notified.
+    // Linger time flushes are started from the messenger reactor threads.
     //
-    // The Flush() call can be used to block until the buffer is empty.
+    // The Flush() call can be used to block until the buffer is empty and all
+    // background batches have finished.
     AUTO_FLUSH_BACKGROUND,
 
     // Apply() calls will return immediately, and the writes will not be
@@ -929,10 +958,19 @@ class YBSession : public std::enable_shared_from_this<YBSession> {
   // Set the timeout for writes made in this session.
   void SetTimeout(MonoDelta timeout);
 
+  // Set the callback invoked with the status of each failed batch flushed in
+  // AUTO_FLUSH_BACKGROUND mode. The failed operations are available through
+  // GetPendingErrors(). The callback may be called from an IO thread and should not block.
+  void SetBackgroundFlushErrorCallback(boost::function<void(const Status&)> callback);
+
   CHECKED_STATUS ReadSync(std::shared_ptr<YBOperation> yb_op) WARN_UNUSED_RESULT;
 
   void ReadAsync(std::shared_ptr<YBOperation> yb_op, boost::function<void(const Status&)> callback);
 
+  // Same as ReadAsync, but returns a future that becomes ready when the read completes.
+  // Issuing several reads and then waiting for their futures does not require any callbacks.
+  std::future<Status> ReadFuture(std::shared_ptr<YBOperation> yb_op);
+
   // TODO: add "doAs" ability here for proxy servers to be able to act on behalf of
   // other users, assuming access rights.
 
@@ -987,6 +1025,11 @@ class YBSession : public std::enable_shared_from_this<YBSession> {
   CHECKED_STATUS Flush() WARN_UNUSED_RESULT;
   void FlushAsync(boost::function<void(const Status&)> callback);
 
+  // Same as FlushAsync, but returns a future that is fulfilled with the flush status. The future
+  // is fulfilled from the thread that completes the flush, usually a reactor thread, without any
+  // additional thread hop.
+  std::future<Status> FlushFuture();
+
   // Abort the unflushed or in-flight operations in the session.
   void Abort();
 
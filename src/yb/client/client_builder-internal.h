@@ -32,6 +32,7 @@
 #ifndef YB_CLIENT_CLIENT_BUILDER_INTERNAL_H_
 #define YB_CLIENT_CLIENT_BUILDER_INTERNAL_H_
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -76,6 +77,12 @@ class YBClientBuilder::Data {
   TabletServerId uuid_;
 
   bool skip_master_leader_resolution_ = false;
+
+  // Messenger shared with other clients, if set.
+  std::shared_ptr<rpc::Messenger> messenger_;
+
+  // Whether to use the process-wide shared messenger, when messenger_ is not set.
+  bool use_shared_messenger_ = false;
  private:
   DISALLOW_COPY_AND_ASSIGN(Data);
 };
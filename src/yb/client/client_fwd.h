@@ -73,6 +73,8 @@ class RemoteTabletServer;
 class Batcher;
 typedef scoped_refptr<Batcher> BatcherPtr;
 
+class TabletRpcCoalescer;
+
 } // namespace internal
 
 } // namespace client
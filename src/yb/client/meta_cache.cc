@@ -30,6 +30,7 @@
 // under the License.
 //
 
+#include <algorithm>
 #include <mutex>
 
 #include <boost/bind.hpp>
@@ -49,6 +50,7 @@
 #include "yb/rpc/messenger.h"
 #include "yb/rpc/rpc.h"
 #include "yb/tserver/tserver_service.proxy.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/net/dns_resolver.h"
 #include "yb/util/net/net_util.h"
 
@@ -57,6 +59,15 @@ using std::map;
 using std::shared_ptr;
 using strings::Substitute;
 
+DEFINE_bool(client_prefetch_table_locations, true,
+            "Fetch locations of all tablets of a table in pages when the table is opened, or on "
+            "the first lookup that misses the cache, instead of looking them up one by one");
+TAG_FLAG(client_prefetch_table_locations, advanced);
+TAG_FLAG(client_prefetch_table_locations, runtime);
+DEFINE_int32(client_prefetch_table_locations_page_size, 100,
+             "Max number of tablet locations requested from the master by one prefetch request");
+TAG_FLAG(client_prefetch_table_locations_page_size, advanced);
+
 namespace yb {
 
 using consensus::RaftPeerPB;
@@ -170,6 +181,28 @@ const CloudInfoPB& RemoteTabletServer::cloud_info() const {
   return cloud_info_pb_;
 }
 
+void RemoteTabletServer::RpcStarted() {
+  rpcs_in_flight_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void RemoteTabletServer::RpcFinished(const MonoDelta& latency) {
+  // The same weight as used for smoothed RTT by TCP.
+  constexpr double kWeight = 0.125;
+  rpcs_in_flight_.fetch_sub(1, std::memory_order_relaxed);
+  const double latency_us = latency.ToMicroseconds();
+  double old_value = ewma_latency_us_.load(std::memory_order_relaxed);
+  double new_value;
+  do {
+    new_value = old_value == 0 ? latency_us : old_value + (latency_us - old_value) * kWeight;
+  } while (!ewma_latency_us_.compare_exchange_weak(old_value, new_value,
+                                                   std::memory_order_relaxed));
+}
+
+double RemoteTabletServer::LoadScore() const {
+  return ewma_latency_us_.load(std::memory_order_relaxed) *
+         (rpcs_in_flight_.load(std::memory_order_relaxed) + 1);
+}
+
 shared_ptr<TabletServerServiceProxy> RemoteTabletServer::proxy() const {
   std::lock_guard<simple_spinlock> l(lock_);
   return proxy_;
@@ -375,6 +408,32 @@ std::string RemoteTablet::ReplicasAsString() const {
   return ReplicasAsStringUnlocked();
 }
 
+constexpr size_t RemoteTablet::kMaxReadLatencySamples;
+
+void RemoteTablet::RecordReadLatency(const MonoDelta& latency) {
+  std::lock_guard<simple_spinlock> l(lock_);
+  read_latencies_us_[num_read_latencies_ % kMaxReadLatencySamples] = latency.ToMicroseconds();
+  ++num_read_latencies_;
+}
+
+MonoDelta RemoteTablet::ReadLatencyPercentile(int percentile) const {
+  // Percentile of just a few samples is too noisy.
+  constexpr size_t kMinSamples = 16;
+  std::array<int64_t, kMaxReadLatencySamples> samples;
+  size_t num_samples;
+  {
+    std::lock_guard<simple_spinlock> l(lock_);
+    num_samples = std::min(num_read_latencies_, kMaxReadLatencySamples);
+    if (num_samples < kMinSamples) {
+      return MonoDelta();
+    }
+    std::copy_n(read_latencies_us_.begin(), num_samples, samples.begin());
+  }
+  const size_t index = std::min(num_samples - 1, num_samples * percentile / 100);
+  std::nth_element(samples.begin(), samples.begin() + index, samples.begin() + num_samples);
+  return MonoDelta::FromMicroseconds(samples[index]);
+}
+
 std::string RemoteTablet::ReplicasAsStringUnlocked() const {
   DCHECK(lock_.is_locked());
   string replicas_str;
@@ -465,6 +524,11 @@ class LookupRpc : public Rpc {
   virtual RemoteTabletPtr FastLookup() = 0;
   virtual void DoSendRpc() = 0;
 
+  // Returns true if this lookup waits for another in-flight request to the master, that could
+  // bring the required location. In this case SendRpc is invoked again when this request
+  // completes.
+  virtual bool WaitForInFlightRequest() { return false; }
+
   void NewLeaderMasterDeterminedCb(const Status& status);
 
   // Pointer back to the tablet cache. Populated with location information
@@ -523,6 +587,12 @@ void LookupRpc::SendRpc() {
 
   meta_cache_->rpcs_.Register(shared_from_this(), &retained_self_);
 
+  if (WaitForInFlightRequest()) {
+    VLOG(3) << "Fast lookup: no known tablet for " << ToString()
+            << ": waiting for table locations prefetch";
+    return;
+  }
+
   // Slow path: must lookup the tablet in the master.
   VLOG(3) << "Fast lookup: no known tablet for " << ToString()
           << ": refreshing our metadata from the Master";
@@ -642,44 +712,110 @@ RemoteTabletPtr MetaCache::ProcessTabletLocations(
 
   RemoteTabletPtr result;
   bool first = true;
+  std::vector<const std::string*> updated_tables;
 
-  std::lock_guard<rw_spinlock> l(lock_);
-  for (const TabletLocationsPB& loc : locations) {
-    TabletMap& tablets_by_key = tablets_by_table_and_key_[loc.table_id()];
-    // First, update the tserver cache, needed for the Refresh calls below.
-    for (const TabletLocationsPB_ReplicaPB& r : loc.replicas()) {
-      UpdateTabletServer(r.ts_info());
-    }
+  {
+    std::lock_guard<rw_spinlock> l(lock_);
+    for (const TabletLocationsPB& loc : locations) {
+      TabletMap& tablets_by_key = tablets_by_table_and_key_[loc.table_id()];
+      // First, update the tserver cache, needed for the Refresh calls below.
+      for (const TabletLocationsPB_ReplicaPB& r : loc.replicas()) {
+        UpdateTabletServer(r.ts_info());
+      }
 
-    // Next, update the tablet caches.
-    const std::string& tablet_id = loc.tablet_id();
-    RemoteTabletPtr remote = FindPtrOrNull(tablets_by_id_, tablet_id);
-    if (remote) {
-      // Partition should not have changed.
-      DCHECK_EQ(loc.partition().partition_key_start(), remote->partition().partition_key_start());
-      DCHECK_EQ(loc.partition().partition_key_end(), remote->partition().partition_key_end());
+      // Next, update the tablet caches.
+      const std::string& tablet_id = loc.tablet_id();
+      RemoteTabletPtr remote = FindPtrOrNull(tablets_by_id_, tablet_id);
+      if (remote) {
+        // Partition should not have changed.
+        DCHECK_EQ(loc.partition().partition_key_start(), remote->partition().partition_key_start());
+        DCHECK_EQ(loc.partition().partition_key_end(), remote->partition().partition_key_end());
+
+        VLOG(3) << "Refreshing tablet " << tablet_id << ": " << loc.ShortDebugString();
+      } else {
+        VLOG(3) << "Caching tablet " << tablet_id << ": " << loc.ShortDebugString();
+
+        Partition partition;
+        Partition::FromPB(loc.partition(), &partition);
+        remote = new RemoteTablet(tablet_id, partition);
+
+        CHECK(tablets_by_id_.emplace(tablet_id, remote).second);
+        CHECK(tablets_by_key.emplace(partition.partition_key_start(), remote).second);
+        if (updated_tables.empty() || *updated_tables.back() != loc.table_id()) {
+          updated_tables.push_back(&loc.table_id());
+        }
+      }
+      remote->Refresh(ts_cache_, loc.replicas());
 
-      VLOG(3) << "Refreshing tablet " << tablet_id << ": " << loc.ShortDebugString();
-    } else {
-      VLOG(3) << "Caching tablet " << tablet_id << ": " << loc.ShortDebugString();
+      if (first) {
+        result = remote;
+        first = false;
+      }
+    }
+  }
 
-      Partition partition;
-      Partition::FromPB(loc.partition(), &partition);
-      remote = new RemoteTablet(tablet_id, partition);
+  if (!updated_tables.empty()) {
+    UpdateTabletsSnapshot(updated_tables);
+  }
 
-      CHECK(tablets_by_id_.emplace(tablet_id, remote).second);
-      CHECK(tablets_by_key.emplace(partition.partition_key_start(), remote).second);
+  CHECK_NOTNULL(result.get());
+  return result;
+}
+
+void MetaCache::UpdateTabletsSnapshot(const std::vector<const std::string*>& table_ids) {
+  // Snapshots are built and published in the same order, so the last published snapshot always
+  // contains changes of all writers.
+  std::lock_guard<std::mutex> publish_lock(tablets_snapshot_mutex_);
+  TabletsSnapshotMap new_snapshot(*tablets_snapshot_.get());
+  {
+    shared_lock<rw_spinlock> l(lock_);
+    for (const auto* table_id : table_ids) {
+      const TabletMap* tablets_by_key = FindOrNull(tablets_by_table_and_key_, *table_id);
+      if (!tablets_by_key) {
+        continue;
+      }
+      auto tablets = std::make_shared<TabletsSnapshot>();
+      tablets->tablets.reserve(tablets_by_key->size());
+      for (const auto& entry : *tablets_by_key) {
+        tablets->tablets.push_back(entry.second);
+      }
+      tablets->FillTabletByHashCode();
+      new_snapshot[*table_id] = std::move(tablets);
     }
-    remote->Refresh(ts_cache_, loc.replicas());
+  }
+  // Publishing waits for readers of the old snapshot, so it is done without holding lock_.
+  tablets_snapshot_.Set(std::move(new_snapshot));
+}
 
-    if (first) {
-      result = remote;
-      first = false;
+void MetaCache::TabletsSnapshot::FillTabletByHashCode() {
+  constexpr size_t kNumHashCodes = PartitionSchema::kMaxPartitionKey + 1;
+  if (tablets.empty() || tablets.size() > kNumHashCodes) {
+    return;
+  }
+  // Tablets must be contiguous hash partitions, starting at the beginning of the hash space and
+  // ending at its end. Otherwise lookups fall back to the binary search.
+  std::string expected_start;
+  for (const auto& tablet : tablets) {
+    const auto& partition = tablet->partition();
+    if (partition.partition_key_start() != expected_start ||
+        (!partition.partition_key_end().empty() &&
+         partition.partition_key_end().size() != PartitionSchema::kPartitionKeySize)) {
+      return;
     }
+    expected_start = partition.partition_key_end();
+  }
+  if (!expected_start.empty()) {
+    return;
   }
 
-  CHECK_NOTNULL(result.get());
-  return result;
+  tablet_by_hash_code.reserve(kNumHashCodes);
+  for (size_t i = 0; i != tablets.size(); ++i) {
+    const auto& end = tablets[i]->partition().partition_key_end();
+    const size_t end_hash_code =
+        end.empty() ? kNumHashCodes : PartitionSchema::DecodeMultiColumnHashValue(end);
+    tablet_by_hash_code.resize(end_hash_code, i);
+  }
+  DCHECK_EQ(tablet_by_hash_code.size(), kNumHashCodes);
 }
 
 class LookupByIdRpc : public LookupRpc {
@@ -755,6 +891,20 @@ class LookupByKeyRpc : public LookupRpc {
     return meta_cache()->LookupTabletByKeyFastPath(table_, partition_key_);
   }
 
+  bool WaitForInFlightRequest() override {
+    // Wait at most once, so lookup of a key that is far from the prefetched range is not delayed
+    // for the whole prefetch.
+    if (waited_for_prefetch_) {
+      return false;
+    }
+    // Set before waiting, since callback could be invoked before WaitForPrefetch returns.
+    waited_for_prefetch_ = true;
+    auto self = shared_from_this();
+    return meta_cache()->WaitForPrefetch(table_->id(), partition_key_, [this, self] {
+      SendRpc();
+    });
+  }
+
   void DoSendRpc() override {
     // Fill out the request.
     req_.mutable_table()->set_table_id(table_->id());
@@ -780,6 +930,9 @@ class LookupByKeyRpc : public LookupRpc {
   // Encoded partition key to lookup.
   std::string partition_key_;
 
+  // Whether this lookup already waited for table locations prefetch.
+  bool waited_for_prefetch_ = false;
+
   // Request body.
   GetTableLocationsRequestPB req_;
 
@@ -787,20 +940,86 @@ class LookupByKeyRpc : public LookupRpc {
   GetTableLocationsResponsePB resp_;
 };
 
+// Fetches one page of table locations for MetaCache::PrefetchTableLocations.
+class PrefetchLocationsRpc : public LookupRpc {
+ public:
+  PrefetchLocationsRpc(const scoped_refptr<MetaCache>& meta_cache,
+                       StatusCallback user_cb,
+                       std::string table_id,
+                       std::string partition_key_start,
+                       const MonoTime& deadline,
+                       const shared_ptr<Messenger>& messenger)
+      : LookupRpc(meta_cache, std::move(user_cb), nullptr /* remote_tablet */, deadline,
+                  messenger),
+        table_id_(std::move(table_id)),
+        partition_key_start_(std::move(partition_key_start)) {}
+
+  std::string ToString() const override {
+    return Format("PrefetchLocations($0, $1, $2)",
+                  table_id_, Slice(partition_key_start_).ToDebugHexString(), num_attempts());
+  }
+
+  RemoteTabletPtr FastLookup() override {
+    // Prefetch always goes to the master.
+    return nullptr;
+  }
+
+  void DoSendRpc() override {
+    req_.mutable_table()->set_table_id(table_id_);
+    req_.set_partition_key_start(partition_key_start_);
+    req_.set_max_returned_locations(FLAGS_client_prefetch_table_locations_page_size);
+
+    master_proxy()->GetTableLocationsAsync(
+        req_, &resp_, mutable_retrier()->mutable_controller(),
+        std::bind(&PrefetchLocationsRpc::Finished, this, Status::OK()));
+  }
+
+ private:
+  void Finished(const Status& status) override {
+    DoFinished(status, resp_, [this] {
+      auto result = meta_cache()->ProcessTabletLocations(resp_.tablet_locations());
+      meta_cache()->PrefetchPageDone(table_id_, &resp_);
+      return result;
+    });
+  }
+
+  const std::string table_id_;
+  const std::string partition_key_start_;
+
+  GetTableLocationsRequestPB req_;
+  GetTableLocationsResponsePB resp_;
+};
+
 RemoteTabletPtr MetaCache::LookupTabletByKeyFastPath(const YBTable* table,
                                                      const string& partition_key) {
-  shared_lock<rw_spinlock> l(lock_);
-  const TabletMap* tablets = FindOrNull(tablets_by_table_and_key_, table->id());
-  if (PREDICT_FALSE(!tablets)) {
+  // Snapshot is immutable, so we don't need lock_ here.
+  auto snapshot = tablets_snapshot_.get();
+  auto table_it = snapshot->find(table->id());
+  if (PREDICT_FALSE(table_it == snapshot->end())) {
     // No cache available for this table.
     return nullptr;
   }
 
-  const scoped_refptr<RemoteTablet>* r = FindFloorOrNull(*tablets, partition_key);
-  if (PREDICT_FALSE(!r)) {
+  const auto& tablets = table_it->second->tablets;
+  const auto& tablet_by_hash_code = table_it->second->tablet_by_hash_code;
+  if (!tablet_by_hash_code.empty() &&
+      partition_key.size() == PartitionSchema::kPartitionKeySize) {
+    const auto& tablet = tablets[tablet_by_hash_code[
+        PartitionSchema::DecodeMultiColumnHashValue(partition_key)]];
+    return tablet->stale() ? nullptr : tablet;
+  }
+
+  // Find the first tablet that starts after 'partition_key', so the previous one is the floor.
+  auto it = std::upper_bound(
+      tablets.begin(), tablets.end(), partition_key,
+      [](const string& key, const RemoteTabletPtr& tablet) {
+        return key < tablet->partition().partition_key_start();
+      });
+  if (PREDICT_FALSE(it == tablets.begin())) {
     // No tablets with a start partition key lower than 'partition_key'.
     return nullptr;
   }
+  const RemoteTabletPtr* r = &*--it;
 
   // Stale entries must be re-fetched.
   if ((*r)->stale()) {
@@ -839,6 +1058,12 @@ void MetaCache::LookupTabletByKey(const YBTable* table,
                                 client_->data_->messenger_);
 }
 
+RemoteTabletPtr MetaCache::LookupTabletByKeyIfCached(const YBTable* table,
+                                                     const string& partition_key) {
+  auto result = LookupTabletByKeyFastPath(table, partition_key);
+  return result && result->HasLeader() ? result : nullptr;
+}
+
 void MetaCache::LookupTabletById(const string& tablet_id,
                                  const MonoTime& deadline,
                                  RemoteTabletPtr* remote_tablet,
@@ -866,6 +1091,96 @@ void MetaCache::MarkTSFailed(RemoteTabletServer* ts,
   }
 }
 
+void MetaCache::PrefetchTableLocations(const std::string& table_id) {
+  if (!FLAGS_client_prefetch_table_locations) {
+    return;
+  }
+  {
+    std::lock_guard<simple_spinlock> lock(prefetch_lock_);
+    if (!table_prefetches_.emplace(table_id, TablePrefetch()).second) {
+      return;
+    }
+  }
+  StartPrefetchPage(table_id, std::string());
+}
+
+bool MetaCache::WaitForPrefetch(const std::string& table_id,
+                                const std::string& partition_key,
+                                std::function<void()> callback) {
+  if (!FLAGS_client_prefetch_table_locations) {
+    return false;
+  }
+  bool start = false;
+  bool wait = false;
+  {
+    std::lock_guard<simple_spinlock> lock(prefetch_lock_);
+    auto it = table_prefetches_.find(table_id);
+    if (it == table_prefetches_.end()) {
+      it = table_prefetches_.emplace(table_id, TablePrefetch()).first;
+      start = true;
+    }
+    // Tablets before page_start were already received, so there is no reason to wait for them.
+    if (it->second.in_progress && partition_key >= it->second.page_start) {
+      it->second.waiters.push_back(std::move(callback));
+      wait = true;
+    }
+  }
+  if (start) {
+    StartPrefetchPage(table_id, std::string());
+  }
+  return wait;
+}
+
+void MetaCache::StartPrefetchPage(const std::string& table_id,
+                                  const std::string& partition_key_start) {
+  VLOG(2) << "Prefetch locations of " << table_id << " from "
+          << Slice(partition_key_start).ToDebugHexString();
+  auto deadline = MonoTime::Now();
+  deadline.AddDelta(client_->default_admin_operation_timeout());
+  rpc::StartRpc<PrefetchLocationsRpc>(this,
+                                      Bind(&MetaCache::PrefetchRpcDone, this, table_id),
+                                      table_id,
+                                      partition_key_start,
+                                      deadline,
+                                      client_->data_->messenger_);
+}
+
+void MetaCache::PrefetchRpcDone(const std::string& table_id, const Status& status) {
+  // Successfully received pages are handled by PrefetchPageDone.
+  if (!status.ok()) {
+    LOG(INFO) << "Prefetch locations of " << table_id << " failed: " << status;
+    PrefetchPageDone(table_id, nullptr);
+  }
+}
+
+void MetaCache::PrefetchPageDone(const std::string& table_id,
+                                 const master::GetTableLocationsResponsePB* resp) {
+  std::string next_page_start;
+  if (resp && resp->tablet_locations_size() != 0) {
+    // Next page starts at the end of the last received tablet, empty end means that it was the
+    // last tablet of the table.
+    const auto& last_tablet = *resp->tablet_locations().rbegin();
+    next_page_start = last_tablet.partition().partition_key_end();
+  }
+  std::vector<std::function<void()>> waiters;
+  {
+    std::lock_guard<simple_spinlock> lock(prefetch_lock_);
+    auto& prefetch = table_prefetches_[table_id];
+    waiters.swap(prefetch.waiters);
+    if (next_page_start.empty()) {
+      prefetch.in_progress = false;
+    } else {
+      prefetch.page_start = next_page_start;
+    }
+  }
+  if (!next_page_start.empty()) {
+    StartPrefetchPage(table_id, next_page_start);
+  }
+  for (const auto& waiter : waiters) {
+    waiter();
+  }
+}
+
 bool MetaCache::AcquireMasterLookupPermit() {
   return master_lookup_sem_.TryAcquire();
 }
@@ -33,9 +33,12 @@
 #ifndef YB_CLIENT_META_CACHE_H
 #define YB_CLIENT_META_CACHE_H
 
+#include <array>
+#include <atomic>
 #include <map>
 #include <string>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 
@@ -54,6 +57,7 @@
 #include "yb/tablet/metadata.pb.h"
 
 #include "yb/util/async_util.h"
+#include "yb/util/concurrent_value.h"
 #include "yb/util/locks.h"
 #include "yb/util/monotime.h"
 #include "yb/util/semaphore.h"
@@ -70,6 +74,7 @@ class TabletServerServiceProxy;
 } // namespace tserver
 
 namespace master {
+class GetTableLocationsResponsePB;
 class MasterServiceProxy;
 class TabletLocationsPB_ReplicaPB;
 class TabletLocationsPB;
@@ -79,6 +84,7 @@ class TSInfoPB;
 namespace client {
 
 class ClientTest_TestMasterLookupPermits_Test;
+class ClientTest_TestPrefetchTableLocations_Test;
 class YBClient;
 class YBTable;
 
@@ -124,6 +130,17 @@ class RemoteTabletServer {
 
   const CloudInfoPB& cloud_info() const;
 
+  // Should be invoked when an RPC is sent to this server, and when it completes, to track the load
+  // and responsiveness of the server.
+  void RpcStarted();
+  void RpcFinished(const MonoDelta& latency);
+
+  // Returns the score used to choose between replicas, lower is better. It is the moving average
+  // of RPC latency multiplied by the number of RPCs in flight, so a server that got slow or
+  // overloaded is avoided until its RPCs complete. Servers without completed RPCs score 0, so they
+  // get probed.
+  double LoadScore() const;
+
  private:
   // Internal callback for DNS resolution.
   void DnsResolutionFinished(const HostPort& hp,
@@ -139,6 +156,10 @@ class RemoteTabletServer {
   yb::CloudInfoPB cloud_info_pb_;
   std::shared_ptr<tserver::TabletServerServiceProxy> proxy_;
 
+  std::atomic<int64_t> rpcs_in_flight_{0};
+  // Exponentially weighted moving average of RPC latency in microseconds.
+  std::atomic<double> ewma_latency_us_{0};
+
   DISALLOW_COPY_AND_ASSIGN(RemoteTabletServer);
 };
 
@@ -225,6 +246,13 @@ class RemoteTablet : public RefCountedThreadSafe<RemoteTablet> {
   // Return stringified representation of the list of replicas for this tablet.
   std::string ReplicasAsString() const;
 
+  // Records the time it took a replica to serve a read of this tablet.
+  void RecordReadLatency(const MonoDelta& latency);
+
+  // Returns the latency that is not exceeded by the specified percent of recent reads of this
+  // tablet, or an uninitialized MonoDelta when not enough reads were recorded yet.
+  MonoDelta ReadLatencyPercentile(int percentile) const;
+
  private:
   // Same as ReplicasAsString(), except that the caller must hold lock_.
   std::string ReplicasAsStringUnlocked() const;
@@ -240,6 +268,11 @@ class RemoteTablet : public RefCountedThreadSafe<RemoteTablet> {
   // The state of this tablet at each specific replica. Only updated after calling GetTabletStatus.
   std::unordered_map<std::string, tablet::TabletStatePB> replica_tablet_state_map_;
 
+  // Ring buffer of recent read latencies in microseconds.
+  static constexpr size_t kMaxReadLatencySamples = 64;
+  std::array<int64_t, kMaxReadLatencySamples> read_latencies_us_;
+  size_t num_read_latencies_ = 0;
+
   DISALLOW_COPY_AND_ASSIGN(RemoteTablet);
 };
 
@@ -280,6 +313,12 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
                         RemoteTabletPtr* remote_tablet,
                         const StatusCallback& callback);
 
+  // Returns the tablet that hosts the given partition key for a table if it is already cached and
+  // has a known leader, i.e. when LookupTabletByKey() would complete inline. Returns nullptr
+  // otherwise, in this case LookupTabletByKey() should be used.
+  RemoteTabletPtr LookupTabletByKeyIfCached(const YBTable* table,
+                                            const std::string& partition_key);
+
   // Mark any replicas of any tablets hosted by 'ts' as failed. They will
   // not be returned in future cache lookups.
   void MarkTSFailed(RemoteTabletServer* ts, const Status& status);
@@ -291,12 +330,19 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
   bool AcquireMasterLookupPermit();
   void ReleaseMasterLookupPermit();
 
+  // Starts fetching locations of all tablets of the table from the master, page by page.
+  // So subsequent lookups don't have to go to the master for each tablet separately.
+  // Does nothing if locations of this table were already prefetched, or prefetch is in progress.
+  void PrefetchTableLocations(const std::string& table_id);
+
  private:
   friend class LookupRpc;
   friend class LookupByKeyRpc;
   friend class LookupByIdRpc;
+  friend class PrefetchLocationsRpc;
 
   FRIEND_TEST(client::ClientTest, TestMasterLookupPermits);
+  FRIEND_TEST(client::ClientTest, TestPrefetchTableLocations);
 
   // Called on the slow LookupTablet path when the master responds. Populates
   // the tablet caches and returns a reference to the first one.
@@ -310,6 +356,23 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
 
   RemoteTabletPtr LookupTabletByIdFastPath(const std::string& tablet_id);
 
+  // Starts prefetch of table locations if it was not started yet. If prefetch is in progress and
+  // the page being fetched could contain the specified key, registers callback that is invoked
+  // when this page is received, and returns true.
+  bool WaitForPrefetch(const std::string& table_id, const std::string& partition_key,
+                       std::function<void()> callback);
+
+  // Sends request for the page of table locations that starts at the specified key.
+  void StartPrefetchPage(const std::string& table_id, const std::string& partition_key_start);
+
+  // Invoked when prefetch page is received and processed. resp is nullptr when the page could
+  // not be fetched.
+  void PrefetchPageDone(const std::string& table_id,
+                        const master::GetTableLocationsResponsePB* resp);
+
+  // Invoked when prefetch rpc completes.
+  void PrefetchRpcDone(const std::string& table_id, const Status& status);
+
   // Update our information about the given tablet server.
   //
   // This is called when we get some response from the master which contains
@@ -318,6 +381,11 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
   // NOTE: Must be called with lock_ held.
   void UpdateTabletServer(const master::TSInfoPB& pb);
 
+  // Publishes new snapshots of tablets of the specified tables.
+  //
+  // NOTE: Must be called without lock_ held.
+  void UpdateTabletsSnapshot(const std::vector<const std::string*>& table_ids);
+
   YBClient* client_;
 
   rw_spinlock lock_;
@@ -340,11 +408,49 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
   typedef std::map<std::string, RemoteTabletPtr> TabletMap;
   std::unordered_map<std::string, TabletMap> tablets_by_table_and_key_;
 
+  // Immutable copy of tablets_by_table_and_key_, used by lookups by key, so they don't have to
+  // acquire lock_. Tablets of each table are sorted by start partition key.
+  //
+  // Updated under tablets_snapshot_mutex_.
+  struct TabletsSnapshot {
+    std::vector<RemoteTabletPtr> tablets;
+
+    // Index in tablets of the tablet hosting each hash code. Only filled when the cached tablets
+    // are hash partitions covering the whole hash space, so hash partition keys are routed by
+    // an array lookup instead of a binary search over partition key strings.
+    std::vector<uint16_t> tablet_by_hash_code;
+
+    void FillTabletByHashCode();
+  };
+  typedef std::unordered_map<std::string, std::shared_ptr<const TabletsSnapshot>>
+      TabletsSnapshotMap;
+  std::mutex tablets_snapshot_mutex_;
+  ConcurrentValue<TabletsSnapshotMap> tablets_snapshot_;
+
   // Cache of tablets, keyed by tablet ID.
   //
   // Protected by lock_
   std::unordered_map<std::string, RemoteTabletPtr> tablets_by_id_;
 
+  struct TablePrefetch {
+    // Whether there is an outstanding page request.
+    bool in_progress = true;
+
+    // Start partition key of the page that is being fetched. Locations of tablets that start
+    // before it were already received.
+    std::string page_start;
+
+    // Lookups waiting for the page that is being fetched.
+    std::vector<std::function<void()>> waiters;
+  };
+
+  simple_spinlock prefetch_lock_;
+
+  // Tables whose locations were prefetched or are being prefetched.
+  //
+  // Protected by prefetch_lock_.
+  std::unordered_map<std::string, TablePrefetch> table_prefetches_;
+
   // Prevents master lookup "storms" by delaying master lookups when all
   // permits have been acquired.
   Semaphore master_lookup_sem_;
@@ -32,6 +32,7 @@
 #include "yb/yql/cql/ql/util/statement_result.h"
 
 DECLARE_bool(mini_cluster_reuse_data);
+DECLARE_int32(client_rpc_coalescing_window_us);
 DECLARE_bool(rocksdb_disable_compactions);
 DECLARE_int32(yb_num_shards_per_tserver);
 DECLARE_int64(db_block_cache_size_bytes);
@@ -1059,5 +1060,30 @@ TEST_F(QLDmlTest, TestSimultaneousReadAndWrite) {
   }
 }
 
+// Writes and reads rows from many sessions concurrently, so requests to the same tablet are
+// coalesced, and checks that each operation got its own response.
+TEST_F(QLDmlTest, CoalescedRpcs) {
+  constexpr int kNumThreads = 16;
+  constexpr int kRowsPerThread = RegularBuildVsSanitizers(100, 20);
+  FLAGS_client_rpc_coalescing_window_us = 1000;
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t != kNumThreads; ++t) {
+    threads.emplace_back([this, t] {
+      auto session = NewSession();
+      for (int i = 0; i != kRowsPerThread; ++i) {
+        auto op = InsertRow(session, t, "a", i, "b", t * kRowsPerThread + i, "c");
+        ASSERT_EQ(QLResponsePB::YQL_STATUS_OK, op->response().status());
+      }
+      for (int i = 0; i != kRowsPerThread; ++i) {
+        ASSERT_TRUE(VerifyRow(session, t, "a", i, "b", t * kRowsPerThread + i, "c"));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
 }  // namespace client
 }  // namespace yb
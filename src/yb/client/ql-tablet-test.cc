@@ -366,6 +366,37 @@ TEST_F(QLTabletTest, ImportToNonEmptyAndRestart) {
   VerifyTable(0, 2 * kTotalKeys, &table2_);
 }
 
+TEST_F(QLTabletTest, ImportWithDifferentPartitions) {
+  CreateTable(kTable1Name, &table1_, 1);
+  CreateTable(kTable2Name, &table2_, 3);
+  FillTable(0, kTotalKeys, &table1_);
+  std::this_thread::sleep_for(1s); // Wait until all tablets a synced and flushed.
+  ASSERT_OK(cluster_->FlushTablets());
+
+  // The only source tablet covers all destination tablets, so each of them has to take its own
+  // part of the keys.
+  auto source_infos = GetTabletInfos(kTable1Name);
+  ASSERT_EQ(1, source_infos.size());
+  auto dest_infos = GetTabletInfos(kTable2Name);
+  for (int i = 0; i != cluster_->num_tablet_servers(); ++i) {
+    auto* tablet_manager = cluster_->mini_tablet_server(i)->server()->tablet_manager();
+    tablet::TabletPeerPtr source_peer;
+    tablet_manager->LookupTablet(source_infos[0]->id(), &source_peer);
+    ASSERT_NE(nullptr, source_peer);
+    auto source_dir = source_peer->tablet()->metadata()->rocksdb_dir();
+    for (const auto& dest_info : dest_infos) {
+      tablet::TabletPeerPtr dest_peer;
+      tablet_manager->LookupTablet(dest_info->id(), &dest_peer);
+      ASSERT_NE(nullptr, dest_peer);
+      ASSERT_OK(dest_peer->tablet()->ImportData(source_dir));
+    }
+  }
+
+  VerifyTable(0, kTotalKeys, &table2_);
+  // Every key should be imported only to the tablet that owns it.
+  ASSERT_OK(WaitSync(0, kTotalKeys, &table2_));
+}
+
 TEST_F(QLTabletTest, LateImport) {
   CreateTables(kBigSeqNo, 0);
 
@@ -654,5 +685,27 @@ TEST_F(QLTabletTest, SkewedClocks) {
   cluster_.reset();
 }
 
+// Bounded staleness read should return up to date values, falling back to the leader when
+// followers are too stale.
+TEST_F(QLTabletTest, BoundedStalenessRead) {
+  TableHandle table;
+  CreateTable(kTable1Name, &table);
+  FillTable(0, kTotalKeys, &table);
+
+  auto session = CreateSession();
+  for (auto max_staleness : {0ms, 10ms, 60000ms}) {
+    for (int i = 0; i != kTotalKeys; ++i) {
+      auto op = CreateReadOp(i, &table);
+      op->set_yb_consistency_level(YBConsistencyLevel::CONSISTENT_PREFIX);
+      op->set_max_staleness(MonoDelta(max_staleness));
+      ASSERT_OK(session->Apply(op));
+      ASSERT_EQ(QLResponsePB::YQL_STATUS_OK, op->response().status());
+      auto rowblock = RowsResult(op.get()).GetRowBlock();
+      ASSERT_EQ(1, rowblock->row_count());
+      ASSERT_EQ(ValueForKey(i), rowblock->row(0).column(0).int32_value());
+    }
+  }
+}
+
 } // namespace client
 } // namespace yb
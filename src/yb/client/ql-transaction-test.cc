@@ -24,6 +24,10 @@
 #include "yb/client/transaction_rpc.h"
 #include "yb/client/transaction_manager.h"
 
+#include "yb/docdb/value_type.h"
+
+#include "yb/rocksdb/db.h"
+
 #include "yb/yql/cql/ql/util/errcodes.h"
 #include "yb/yql/cql/ql/util/statement_result.h"
 
@@ -52,6 +56,7 @@ DECLARE_uint64(max_clock_skew_usec);
 DECLARE_bool(transaction_allow_rerequest_status_in_tests);
 DECLARE_bool(use_test_clock);
 DECLARE_uint64(transaction_delay_status_reply_usec_in_tests);
+DECLARE_bool(wait_on_conflict);
 
 namespace yb {
 namespace client {
@@ -296,11 +301,39 @@ class QLTransactionTest : public QLDmlTestBase {
     return result;
   }
 
+  // Returns number of intent records, including reverse index and transaction metadata, in all
+  // tablet peers. If regular_db is true, then intent records in regular RocksDB are counted.
+  size_t CountIntents(bool regular_db = false) {
+    size_t result = 0;
+    for (int i = 0; i != cluster_->num_tablet_servers(); ++i) {
+      auto* tablet_manager = cluster_->mini_tablet_server(i)->server()->tablet_manager();
+      std::vector<tablet::TabletPeerPtr> peers;
+      tablet_manager->GetTabletPeers(&peers);
+      for (const auto& peer : peers) {
+        auto* db = regular_db ? peer->tablet()->TEST_db() : peer->tablet()->TEST_intents_db();
+        if (!db) {
+          continue;
+        }
+        std::unique_ptr<rocksdb::Iterator> iter(db->NewIterator(rocksdb::ReadOptions()));
+        const char prefix = static_cast<char>(docdb::ValueType::kIntentPrefix);
+        for (iter->Seek(Slice(&prefix, 1));
+             iter->Valid() && iter->key().starts_with(Slice(&prefix, 1)); iter->Next()) {
+          ++result;
+        }
+      }
+    }
+    return result;
+  }
+
   // We write data with first transaction then try to read it another one.
   // If commit is true, then first transaction is committed and second should be restarted.
   // Otherwise second transaction would see pending intents from first one and should not restart.
   void TestReadRestart(bool commit = true);
 
+  // Several transactions write the same rows and then commit concurrently. At least one of them
+  // should succeed and all rows should contain values of the same transaction.
+  void TestConflictResolution();
+
   TableHandle table_;
   boost::optional<TransactionManager> transaction_manager_;
   server::TestClock* clock_;
@@ -351,6 +384,45 @@ void QLTransactionTest::TestReadRestart(bool commit) {
   ASSERT_OK(cluster_->RestartSync());
 }
 
+// Last batch of transaction that writes to single tablet should not use status tablet.
+TEST_F(QLTransactionTest, SingleTablet) {
+  auto txn = CreateTransaction();
+  txn->MarkLastBatch();
+  auto session = CreateSession(txn);
+  ASSERT_OK(WriteRow(session, 1, 2));
+  ASSERT_EQ(0, CountTransactions());
+  // Transaction could not write after its last batch.
+  ASSERT_NOK(WriteRow(session, 2, 3));
+  ASSERT_OK(txn->CommitFuture().get());
+  ASSERT_EQ(0, CountTransactions());
+
+  VERIFY_ROW(CreateSession(), 1, 2);
+}
+
+// Pipelined transaction does not wait for previous batches before flushing the next one,
+// commit waits for all of them.
+TEST_F(QLTransactionTest, Pipelined) {
+  auto txn = CreateTransaction();
+  txn->SetPipelined();
+  auto session = CreateSession(txn);
+  ASSERT_OK(session->SetFlushMode(YBSession::MANUAL_FLUSH));
+  std::vector<std::future<Status>> flushes;
+  for (size_t r = 0; r != kNumRows; ++r) {
+    auto op = table_.NewWriteOp(QLWriteRequestPB::QL_STMT_INSERT);
+    auto* const req = op->mutable_request();
+    QLAddInt32HashValue(req, KeyForTransactionAndIndex(0, r));
+    table_.AddInt32ColumnValue(req, kValueColumn, ValueForTransactionAndIndex(0, r, WriteOpType::INSERT));
+    ASSERT_OK(session->Apply(op));
+    flushes.push_back(session->FlushFuture());
+  }
+  ASSERT_OK(txn->CommitFuture().get());
+  for (auto& flush : flushes) {
+    ASSERT_OK(flush.get());
+  }
+
+  ASSERT_NO_FATALS(VerifyRows(CreateSession()));
+}
+
 TEST_F(QLTransactionTest, ReadRestart) {
   TestReadRestart();
 }
@@ -531,10 +603,27 @@ TEST_F(QLTransactionTest, Cleanup) {
   // Wait transaction apply. Otherwise count could be non zero.
   ASSERT_OK(WaitFor(
       [this] { return CountTransactions() == 0; }, kTransactionApplyTime, "Transactions cleaned"));
+  // Intents are deleted in background after apply.
+  ASSERT_OK(WaitFor(
+      [this] { return CountIntents() == 0; }, kTransactionApplyTime, "Intents cleaned"));
   VerifyData();
   ASSERT_OK(cluster_->RestartSync());
 }
 
+TEST_F(QLTransactionTest, IntentsDB) {
+  auto txn = CreateTransaction();
+  WriteRows(CreateSession(txn));
+  ASSERT_GT(CountIntents(), 0);
+  ASSERT_EQ(0, CountIntents(true /* regular_db */));
+
+  ASSERT_OK(txn->CommitFuture().get());
+  VerifyData();
+  ASSERT_OK(WaitFor(
+      [this] { return CountIntents() == 0; }, kTransactionApplyTime, "Intents cleaned"));
+  ASSERT_EQ(0, CountIntents(true /* regular_db */));
+  VerifyData();
+}
+
 TEST_F(QLTransactionTest, Heartbeat) {
   auto txn = CreateTransaction();
   auto session = CreateSession(txn);
@@ -610,9 +699,7 @@ TEST_F(QLTransactionTest, ResendApplying) {
   ASSERT_OK(cluster_->RestartSync());
 }
 
-TEST_F(QLTransactionTest, ConflictResolution) {
-  google::FlagSaver flag_saver;
-
+void QLTransactionTest::TestConflictResolution() {
   constexpr size_t kTotalTransactions = 5;
   constexpr size_t kNumRows = 10;
   std::vector<YBTransactionPtr> transactions;
@@ -663,6 +750,20 @@ TEST_F(QLTransactionTest, ConflictResolution) {
   }
 }
 
+TEST_F(QLTransactionTest, ConflictResolution) {
+  google::FlagSaver flag_saver;
+
+  ASSERT_NO_FATALS(TestConflictResolution());
+}
+
+TEST_F(QLTransactionTest, ConflictResolutionWithWait) {
+  google::FlagSaver flag_saver;
+
+  // Transactions of lower priority wait for the conflicting ones instead of failing right away.
+  FLAGS_wait_on_conflict = true;
+  ASSERT_NO_FATALS(TestConflictResolution());
+}
+
 TEST_F(QLTransactionTest, SimpleWriteConflict) {
   google::FlagSaver flag_saver;
 
@@ -940,29 +1041,31 @@ struct TransactionState {
     ASSERT_EQ(status_future.wait_for(NonTsanVsTsan(1s, 5s)), std::future_status::ready);
     auto resp = status_future.get();
     ASSERT_OK(resp);
+    ASSERT_EQ(1, resp->status_size());
+    ASSERT_EQ(1, resp->status_hybrid_time_size());
 
-    if (resp->status() == TransactionStatus::ABORTED) {
+    if (resp->status(0) == TransactionStatus::ABORTED) {
       ASSERT_TRUE(commit_future.valid());
       transaction = nullptr;
       return;
     }
 
-    auto new_time = HybridTime(resp->status_hybrid_time());
+    auto new_time = HybridTime(resp->status_hybrid_time(0));
     if (last_status == TransactionStatus::PENDING) {
-      if (resp->status() == TransactionStatus::PENDING) {
+      if (resp->status(0) == TransactionStatus::PENDING) {
         ASSERT_GE(new_time, status_time);
       } else {
-        ASSERT_EQ(TransactionStatus::COMMITTED, resp->status());
+        ASSERT_EQ(TransactionStatus::COMMITTED, resp->status(0));
         ASSERT_GT(new_time, status_time);
       }
     } else {
       ASSERT_EQ(last_status, TransactionStatus::COMMITTED);
-      ASSERT_EQ(resp->status(), TransactionStatus::COMMITTED)
-          << "Bad transaction status: " << TransactionStatus_Name(resp->status());
+      ASSERT_EQ(resp->status(0), TransactionStatus::COMMITTED)
+          << "Bad transaction status: " << TransactionStatus_Name(resp->status(0));
       ASSERT_EQ(status_time, new_time);
     }
     status_time = new_time;
-    last_status = resp->status();
+    last_status = resp->status(0);
   }
 };
 
@@ -1024,7 +1127,7 @@ TEST_F(QLTransactionTest, StatusEvolution) {
       }
       tserver::GetTransactionStatusRequestPB req;
       req.set_tablet_id(state.metadata.status_tablet);
-      req.set_transaction_id(state.metadata.transaction_id.data,
+      req.add_transaction_id(state.metadata.transaction_id.data,
                              state.metadata.transaction_id.size());
       state.status_future = rpc::WrapRpcFuture<tserver::GetTransactionStatusResponsePB>(
           GetTransactionStatus, &rpcs)(
@@ -40,6 +40,28 @@
 #include "yb/client/error_collector.h"
 #include "yb/client/yb_op.h"
 
+#include "yb/rpc/messenger.h"
+
+#include "yb/util/flag_tags.h"
+
+DEFINE_int32(client_background_flush_max_ops, 1000,
+             "Number of buffered operations that triggers a flush of a session in "
+             "AUTO_FLUSH_BACKGROUND mode.");
+TAG_FLAG(client_background_flush_max_ops, advanced);
+TAG_FLAG(client_background_flush_max_ops, runtime);
+
+DEFINE_int32(client_background_flush_interval_ms, 10,
+             "Maximum time an operation stays buffered by a session in AUTO_FLUSH_BACKGROUND mode "
+             "before it is flushed.");
+TAG_FLAG(client_background_flush_interval_ms, advanced);
+TAG_FLAG(client_background_flush_interval_ms, runtime);
+
+DEFINE_int32(client_background_flush_max_batches_in_flight, 8,
+             "Maximum number of batches a session in AUTO_FLUSH_BACKGROUND mode keeps in flight. "
+             "Apply blocks while this many batches are outstanding and the buffer is full.");
+TAG_FLAG(client_background_flush_max_batches_in_flight, advanced);
+TAG_FLAG(client_background_flush_max_batches_in_flight, runtime);
+
 MAKE_ENUM_LIMITS(yb::client::YBSession::FlushMode,
                  yb::client::YBSession::AUTO_FLUSH_SYNC,
                  yb::client::YBSession::MANUAL_FLUSH);
@@ -59,7 +81,7 @@ YBSessionData::YBSessionData(shared_ptr<YBClient> client,
     : client_(std::move(client)),
       transaction_(transaction),
       error_collector_(new ErrorCollector()) {
-  const auto metric_entity = client_->messenger()->metric_entity();
+  const auto& metric_entity = client_->metric_entity();
   async_rpc_metrics_ = metric_entity ? std::make_shared<AsyncRpcMetrics>(metric_entity) : nullptr;
 }
 
@@ -82,25 +104,40 @@ void YBSessionData::FlushFinished(internal::BatcherPtr batcher) {
 }
 
 void YBSessionData::Abort() {
-  if (batcher_ && batcher_->HasPendingOperations()) {
-    batcher_->Abort(STATUS(Aborted, "Batch aborted"));
-    batcher_.reset();
+  internal::BatcherPtr batcher;
+  {
+    std::lock_guard<std::mutex> lock(background_mutex_);
+    if (batcher_ && batcher_->HasPendingOperations()) {
+      batcher.swap(batcher_);
+    }
+  }
+  if (batcher) {
+    batcher->Abort(STATUS(Aborted, "Batch aborted"));
   }
 }
 
 Status YBSessionData::Close(bool force) {
-  if (batcher_) {
-    if (batcher_->HasPendingOperations() && !force) {
-      return STATUS(IllegalState, "Could not close. There are pending operations.");
+  internal::BatcherPtr batcher;
+  {
+    std::lock_guard<std::mutex> lock(background_mutex_);
+    if (batcher_) {
+      if (batcher_->HasPendingOperations() && !force) {
+        return STATUS(IllegalState, "Could not close. There are pending operations.");
+      }
+      batcher.swap(batcher_);
     }
-    batcher_->Abort(STATUS(Aborted, "Batch aborted"));
-    batcher_.reset();
+  }
+  if (batcher) {
+    batcher->Abort(STATUS(Aborted, "Batch aborted"));
   }
   return Status::OK();
 }
 
 void YBSessionData::FlushAsync(boost::function<void(const Status&)> callback) {
-  CHECK_NE(flush_mode_, YBSession::AUTO_FLUSH_BACKGROUND) << "TODO: handle flush background mode";
+  if (flush_mode_ == YBSession::AUTO_FLUSH_BACKGROUND) {
+    FlushBackgroundAsync(std::move(callback));
+    return;
+  }
 
   // Swap in a new batcher to start building the next batch.
   // Save off the old batcher.
@@ -131,13 +168,21 @@ void YBSessionData::set_allow_local_calls_in_curr_thread(bool flag) {
   allow_local_calls_in_curr_thread_ = flag;
 }
 
+internal::BatcherPtr YBSessionData::NewBatcher() {
+  internal::BatcherPtr result(
+      new Batcher(client_.get(), error_collector_.get(), shared_from_this(), transaction_));
+  if (timeout_.Initialized()) {
+    result->SetTimeout(timeout_);
+  }
+  return result;
+}
+
 Status YBSessionData::Apply(std::shared_ptr<YBOperation> yb_op) {
+  if (flush_mode_ == YBSession::AUTO_FLUSH_BACKGROUND) {
+    return ApplyBackground(std::move(yb_op));
+  }
   if (!batcher_) {
-    batcher_.reset(new Batcher(client_.get(), error_collector_.get(), shared_from_this(),
-                               transaction_));
-    if (timeout_.Initialized()) {
-      batcher_->SetTimeout(timeout_);
-    }
+    batcher_ = NewBatcher();
   }
   Status s = batcher_->Add(yb_op);
   if (!PREDICT_FALSE(s.ok())) {
@@ -152,17 +197,149 @@ Status YBSessionData::Apply(std::shared_ptr<YBOperation> yb_op) {
   return Status::OK();
 }
 
+Status YBSessionData::ApplyBackground(std::shared_ptr<YBOperation> yb_op) {
+  internal::BatcherPtr batcher_to_flush;
+  bool schedule_flush = false;
+  {
+    std::unique_lock<std::mutex> lock(background_mutex_);
+    if (!batcher_) {
+      batcher_ = NewBatcher();
+      schedule_flush = true;
+    }
+    Status s = batcher_->Add(yb_op);
+    if (!PREDICT_FALSE(s.ok())) {
+      error_collector_->AddError(yb_op, s);
+      return s;
+    }
+    if (batcher_->CountBufferedOperations() >= FLAGS_client_background_flush_max_ops) {
+      // Backpressure: don't let the writer get more than the allowed number of batches ahead.
+      background_cond_.wait(lock, [this] {
+        return background_batches_in_flight_ < FLAGS_client_background_flush_max_batches_in_flight;
+      });
+      // The linger timer could have flushed the batcher while we were waiting.
+      if (batcher_) {
+        batcher_to_flush.swap(batcher_);
+        ++background_batches_in_flight_;
+      }
+    }
+  }
+
+  if (batcher_to_flush) {
+    StartBackgroundFlush(std::move(batcher_to_flush), boost::function<void(const Status&)>());
+  } else if (schedule_flush) {
+    auto batcher = batcher_;
+    std::weak_ptr<YBSessionData> weak_self = shared_from_this();
+    client_->messenger()->ScheduleOnReactor(
+        [weak_self, batcher](const Status& status) {
+          auto self = weak_self.lock();
+          if (self) {
+            self->BackgroundFlushTimerExpired(batcher, status);
+          }
+        },
+        MonoDelta::FromMilliseconds(FLAGS_client_background_flush_interval_ms),
+        client_->messenger());
+  }
+  return Status::OK();
+}
+
+void YBSessionData::BackgroundFlushTimerExpired(
+    const internal::BatcherPtr& batcher, const Status& status) {
+  if (!status.ok()) {
+    // The messenger is shutting down, the user is expected to flush the session explicitly.
+    return;
+  }
+  internal::BatcherPtr batcher_to_flush;
+  {
+    std::lock_guard<std::mutex> lock(background_mutex_);
+    if (batcher_.get() != batcher.get()) {
+      // Already flushed because of the buffer size or an explicit flush.
+      return;
+    }
+    // Never block the reactor thread, the batch is just allowed to run over the in flight limit.
+    batcher_to_flush.swap(batcher_);
+    ++background_batches_in_flight_;
+  }
+  StartBackgroundFlush(std::move(batcher_to_flush), boost::function<void(const Status&)>());
+}
+
+void YBSessionData::StartBackgroundFlush(internal::BatcherPtr batcher,
+                                         boost::function<void(const Status&)> callback) {
+  {
+    std::lock_guard<simple_spinlock> l(lock_);
+    flushed_batchers_.insert(batcher);
+  }
+  std::weak_ptr<YBSessionData> weak_self = shared_from_this();
+  batcher->set_allow_local_calls_in_curr_thread(allow_local_calls_in_curr_thread_);
+  batcher->FlushAsync([weak_self, callback](const Status& status) {
+    auto self = weak_self.lock();
+    if (self) {
+      boost::function<void(const Status&)> error_callback;
+      {
+        std::lock_guard<std::mutex> lock(self->background_mutex_);
+        --self->background_batches_in_flight_;
+        if (!status.ok()) {
+          error_callback = self->background_flush_error_callback_;
+        }
+      }
+      self->background_cond_.notify_all();
+      if (error_callback) {
+        error_callback(status);
+      }
+    }
+    if (callback) {
+      callback(status);
+    }
+  });
+}
+
+void YBSessionData::FlushBackgroundAsync(boost::function<void(const Status&)> callback) {
+  internal::BatcherPtr batcher_to_flush;
+  {
+    std::lock_guard<std::mutex> lock(background_mutex_);
+    batcher_to_flush.swap(batcher_);
+    if (batcher_to_flush) {
+      ++background_batches_in_flight_;
+    }
+  }
+  if (batcher_to_flush) {
+    StartBackgroundFlush(std::move(batcher_to_flush), std::move(callback));
+  } else {
+    callback(Status::OK());
+  }
+}
+
+Status YBSessionData::FlushBackground() {
+  Synchronizer s;
+  FlushBackgroundAsync(s.AsStatusFunctor());
+  Status status = s.Wait();
+  // Also wait for the batches flushed in background before, so that nothing is buffered or in
+  // flight when Flush returns.
+  {
+    std::unique_lock<std::mutex> lock(background_mutex_);
+    background_cond_.wait(lock, [this] { return background_batches_in_flight_ == 0; });
+  }
+  if (status.ok() && error_collector_->CountErrors() != 0) {
+    status = STATUS(IOError, "Some errors occurred");
+  }
+  return status;
+}
+
+void YBSessionData::SetBackgroundFlushErrorCallback(
+    boost::function<void(const Status&)> callback) {
+  std::lock_guard<std::mutex> lock(background_mutex_);
+  background_flush_error_callback_ = std::move(callback);
+}
+
 Status YBSessionData::Flush() {
+  if (flush_mode_ == YBSession::AUTO_FLUSH_BACKGROUND) {
+    return FlushBackground();
+  }
   Synchronizer s;
   FlushAsync(s.AsStatusFunctor());
   return s.Wait();
 }
 
 Status YBSessionData::SetFlushMode(YBSession::FlushMode mode) {
-  if (mode == YBSession::AUTO_FLUSH_BACKGROUND) {
-    return STATUS(NotSupported, "AUTO_FLUSH_BACKGROUND has not been implemented in the"
-        " c++ client (see KUDU-456).");
-  }
   if (batcher_ && batcher_->HasPendingOperations()) {
     // TODO: there may be a more reasonable behavior here.
     return STATUS(IllegalState, "Cannot change flush mode when writes are buffered");
@@ -32,6 +32,8 @@
 #ifndef YB_CLIENT_SESSION_INTERNAL_H_
 #define YB_CLIENT_SESSION_INTERNAL_H_
 
+#include <condition_variable>
+#include <mutex>
 #include <unordered_set>
 
 #include "yb/client/async_rpc.h"
@@ -98,7 +100,23 @@ class YBSessionData : public std::enable_shared_from_this<YBSessionData> {
   void set_allow_local_calls_in_curr_thread(bool flag);
   bool allow_local_calls_in_curr_thread() const;
 
+  void SetBackgroundFlushErrorCallback(boost::function<void(const Status&)> callback);
+
  private:
+  // Implementation of Apply and Flush for AUTO_FLUSH_BACKGROUND mode.
+  CHECKED_STATUS ApplyBackground(std::shared_ptr<YBOperation> yb_op);
+  void FlushBackgroundAsync(boost::function<void(const Status&)> callback);
+  CHECKED_STATUS FlushBackground();
+
+  // Sends the given batcher in background mode. Invoked without background_mutex_ held.
+  void StartBackgroundFlush(internal::BatcherPtr batcher,
+                            boost::function<void(const Status&)> callback);
+
+  // Called when the linger time of the given batcher expired.
+  void BackgroundFlushTimerExpired(const internal::BatcherPtr& batcher, const Status& status);
+
+  internal::BatcherPtr NewBatcher();
+
   // The client that this session is associated with.
   const std::shared_ptr<YBClient> client_;
 
@@ -130,6 +148,17 @@ class YBSessionData : public std::enable_shared_from_this<YBSessionData> {
   MonoDelta timeout_;
 
   internal::AsyncRpcMetricsPtr async_rpc_metrics_;
+
+  // Protects batcher_ and the fields below in AUTO_FLUSH_BACKGROUND mode, where batcher_ is also
+  // flushed from the reactor thread when its linger time expires.
+  std::mutex background_mutex_;
+  std::condition_variable background_cond_;
+
+  // Number of batches sent by background flushes and not finished yet.
+  int background_batches_in_flight_ = 0;
+
+  // Invoked with the status of each failed background flush.
+  boost::function<void(const Status&)> background_flush_error_callback_;
 };
 
 }  // namespace client
@@ -35,6 +35,7 @@
 #include <string>
 
 #include "yb/client/client-internal.h"
+#include "yb/client/meta_cache.h"
 #include "yb/common/wire_protocol.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/gutil/sysinfo.h"
@@ -177,6 +178,9 @@ Status YBTable::Data::Open() {
 
   VLOG(1) << "Open Table " << info_.table_name.ToString() << ", found "
           << resp.tablet_locations_size() << " tablets";
+
+  // Application usually starts using table right after opening it, so warm up the meta cache.
+  client_->data_->meta_cache_->PrefetchTableLocations(info_.table_id);
   return Status::OK();
 }
 
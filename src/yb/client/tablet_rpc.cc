@@ -45,11 +45,30 @@ TabletInvoker::TabletInvoker(bool consistent_prefix,
 void TabletInvoker::SelectTabletServerWithConsistentPrefix() {
   std::vector<RemoteTabletServer*> candidates;
   current_ts_ = client_->data_->SelectTServer(tablet_.get(),
-                                              YBClient::ReplicaSelection::CLOSEST_REPLICA, {},
-                                              &candidates);
+                                              YBClient::ReplicaSelection::CLOSEST_REPLICA,
+                                              stale_replicas_, &candidates);
+  if (!current_ts_ && !stale_replicas_.empty()) {
+    // All replicas are too stale for bounded staleness read, so fall back to the leader, whose
+    // safe time is always recent.
+    VLOG(1) << "Tablet " << tablet_id_ << ": All replicas are stale, reading from leader";
+    SelectTabletServer();
+    return;
+  }
   VLOG(1) << "Using tserver: " << yb::ToString(current_ts_);
 }
 
+RemoteTabletServer* TabletInvoker::SelectHedgeTabletServer() {
+  if (!current_ts_ || !tablet_) {
+    return nullptr;
+  }
+  auto blacklist = stale_replicas_;
+  blacklist.insert(current_ts_->permanent_uuid());
+  std::vector<RemoteTabletServer*> candidates;
+  return client_->data_->SelectTServer(tablet_.get(),
+                                       YBClient::ReplicaSelection::CLOSEST_REPLICA,
+                                       blacklist, &candidates);
+}
+
 void TabletInvoker::SelectTabletServer()  {
   // Choose a destination TS according to the following algorithm:
   // 1. Select the leader, provided:
@@ -208,6 +227,16 @@ bool TabletInvoker::Done(Status* status) {
     *status = resp_error_status;
   }
 
+  // Replica is too stale for bounded staleness read, try the next closest one.
+  if (ErrorCode(rpc_->response_error()) == tserver::TabletServerErrorPB::REPLICA_TOO_STALE) {
+    VLOG(1) << "Tablet " << tablet_id_ << ": Replica " << current_ts_->ToString()
+            << " is too stale: " << *status;
+    stale_replicas_.insert(current_ts_->permanent_uuid());
+    auto retry_status = retrier_->DelayedRetry(command_, *status);
+    LOG_IF(DFATAL, !retry_status.ok()) << "Retry failed: " << retry_status;
+    return false;
+  }
+
   // Oops, we failed over to a replica that wasn't a LEADER. Unlikely as
   // we're using consensus configuration information from the master, but still possible
   // (e.g. leader restarted and became a FOLLOWER). Try again.
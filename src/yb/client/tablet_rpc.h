@@ -16,6 +16,7 @@
 #ifndef YB_CLIENT_TABLET_RPC_H
 #define YB_CLIENT_TABLET_RPC_H
 
+#include <set>
 #include <unordered_set>
 
 #include "yb/client/client-internal.h"
@@ -69,7 +70,11 @@ class TabletInvoker {
   const RemoteTabletPtr& tablet() const { return tablet_; }
   std::shared_ptr<tserver::TabletServerServiceProxy> proxy() const;
   YBClient& client() const { return *client_; }
-  const RemoteTabletServer& current_ts() { return *current_ts_; }
+  RemoteTabletServer* current_ts() const { return current_ts_; }
+
+  // Selects the closest replica, other than the current one, to send a hedged consistent prefix
+  // read to. Returns nullptr if there is no such replica.
+  RemoteTabletServer* SelectHedgeTabletServer();
 
  private:
   void SelectTabletServer();
@@ -125,6 +130,9 @@ class TabletInvoker {
 
   bool consistent_prefix_;
 
+  // Tablet servers that refused bounded staleness read, because their safe time was too old.
+  std::set<std::string> stale_replicas_;
+
   // The TS receiving the write. May change if the write is retried.
   // RemoteTabletServer is taken from YBClient cache, so it is guaranteed that those objects are
   // alive while YBClient is alive. Because we don't delete them, but only add and update.
@@ -0,0 +1,436 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/client/tablet_rpc_coalescer.h"
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "yb/rpc/messenger.h"
+#include "yb/rpc/rpc_controller.h"
+
+#include "yb/tserver/tserver_service.proxy.h"
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/monotime.h"
+
+DEFINE_int32(client_rpc_coalescing_window_us, 0,
+             "Write and read requests of different sessions to the same tablet, that are issued "
+             "while another RPC to this tablet is in flight, are collected for this time and sent "
+             "with a single RPC. 0 disables coalescing.");
+TAG_FLAG(client_rpc_coalescing_window_us, advanced);
+TAG_FLAG(client_rpc_coalescing_window_us, runtime);
+
+DEFINE_int32(client_rpc_coalescing_max_ops, 1024,
+             "Max number of operations sent with a single coalesced RPC.");
+TAG_FLAG(client_rpc_coalescing_max_ops, advanced);
+TAG_FLAG(client_rpc_coalescing_max_ops, runtime);
+
+namespace yb {
+namespace client {
+namespace internal {
+
+using tserver::ReadRequestPB;
+using tserver::ReadResponsePB;
+using tserver::TabletServerServiceProxy;
+using tserver::WriteRequestPB;
+using tserver::WriteResponsePB;
+
+namespace {
+
+// Position of the operations of a request in the merged request.
+struct OpsOffset {
+  int redis = 0;
+  int ql = 0;
+
+  int total() const { return redis + ql; }
+};
+
+template <class Req, class Resp>
+struct CoalescingTraits;
+
+template <>
+struct CoalescingTraits<WriteRequestPB, WriteResponsePB> {
+  static void Send(TabletServerServiceProxy* proxy, const WriteRequestPB& req,
+                   WriteResponsePB* resp, rpc::RpcController* controller,
+                   std::function<void()> callback) {
+    proxy->WriteAsync(req, resp, controller, std::move(callback));
+  }
+
+  static int NumOps(const WriteRequestPB& req) {
+    return req.redis_write_batch_size() + req.ql_write_batch_size();
+  }
+
+  static void MoveOps(WriteRequestPB* req, WriteRequestPB* merged) {
+    for (auto& op : *req->mutable_redis_write_batch()) {
+      merged->add_redis_write_batch()->Swap(&op);
+    }
+    for (auto& op : *req->mutable_ql_write_batch()) {
+      merged->add_ql_write_batch()->Swap(&op);
+    }
+  }
+
+  static void RestoreOps(const OpsOffset& offset, WriteRequestPB* merged, WriteRequestPB* req) {
+    for (int i = 0; i != req->redis_write_batch_size(); ++i) {
+      req->mutable_redis_write_batch(i)->Swap(
+          merged->mutable_redis_write_batch(offset.redis + i));
+    }
+    for (int i = 0; i != req->ql_write_batch_size(); ++i) {
+      req->mutable_ql_write_batch(i)->Swap(merged->mutable_ql_write_batch(offset.ql + i));
+    }
+  }
+
+  static void OffsetAfter(const WriteRequestPB& req, OpsOffset* offset) {
+    offset->redis += req.redis_write_batch_size();
+    offset->ql += req.ql_write_batch_size();
+  }
+
+  static void SplitResponse(const OpsOffset& offset, const WriteRequestPB& req,
+                            WriteResponsePB* merged, WriteResponsePB* resp) {
+    if (merged->has_error()) {
+      *resp->mutable_error() = merged->error();
+    }
+    if (merged->has_propagated_hybrid_time()) {
+      resp->set_propagated_hybrid_time(merged->propagated_hybrid_time());
+    }
+    const int redis_end = std::min(offset.redis + req.redis_write_batch_size(),
+                                   merged->redis_response_batch_size());
+    for (int i = offset.redis; i < redis_end; ++i) {
+      resp->add_redis_response_batch()->Swap(merged->mutable_redis_response_batch(i));
+    }
+    const int ql_end = std::min(offset.ql + req.ql_write_batch_size(),
+                                merged->ql_response_batch_size());
+    for (int i = offset.ql; i < ql_end; ++i) {
+      resp->add_ql_response_batch()->Swap(merged->mutable_ql_response_batch(i));
+    }
+    // Row index is the index of the operation in the request.
+    const int begin = offset.total();
+    const int end = begin + NumOps(req);
+    for (const auto& error : merged->per_row_errors()) {
+      if (error.row_index() >= begin && error.row_index() < end) {
+        auto* row_error = resp->add_per_row_errors();
+        *row_error = error;
+        row_error->set_row_index(error.row_index() - begin);
+      }
+    }
+  }
+};
+
+template <>
+struct CoalescingTraits<ReadRequestPB, ReadResponsePB> {
+  static void Send(TabletServerServiceProxy* proxy, const ReadRequestPB& req,
+                   ReadResponsePB* resp, rpc::RpcController* controller,
+                   std::function<void()> callback) {
+    proxy->ReadAsync(req, resp, controller, std::move(callback));
+  }
+
+  static int NumOps(const ReadRequestPB& req) {
+    return req.redis_batch_size() + req.ql_batch_size();
+  }
+
+  static void MoveOps(ReadRequestPB* req, ReadRequestPB* merged) {
+    for (auto& op : *req->mutable_redis_batch()) {
+      merged->add_redis_batch()->Swap(&op);
+    }
+    for (auto& op : *req->mutable_ql_batch()) {
+      merged->add_ql_batch()->Swap(&op);
+    }
+  }
+
+  static void RestoreOps(const OpsOffset& offset, ReadRequestPB* merged, ReadRequestPB* req) {
+    for (int i = 0; i != req->redis_batch_size(); ++i) {
+      req->mutable_redis_batch(i)->Swap(merged->mutable_redis_batch(offset.redis + i));
+    }
+    for (int i = 0; i != req->ql_batch_size(); ++i) {
+      req->mutable_ql_batch(i)->Swap(merged->mutable_ql_batch(offset.ql + i));
+    }
+  }
+
+  static void OffsetAfter(const ReadRequestPB& req, OpsOffset* offset) {
+    offset->redis += req.redis_batch_size();
+    offset->ql += req.ql_batch_size();
+  }
+
+  static void SplitResponse(const OpsOffset& offset, const ReadRequestPB& req,
+                            ReadResponsePB* merged, ReadResponsePB* resp) {
+    if (merged->has_error()) {
+      *resp->mutable_error() = merged->error();
+    }
+    if (merged->has_propagated_hybrid_time()) {
+      resp->set_propagated_hybrid_time(merged->propagated_hybrid_time());
+    }
+    if (merged->has_hybrid_time()) {
+      resp->set_hybrid_time(merged->hybrid_time());
+    }
+    if (merged->has_restart_read_time()) {
+      *resp->mutable_restart_read_time() = merged->restart_read_time();
+    }
+    const int redis_end = std::min(offset.redis + req.redis_batch_size(),
+                                   merged->redis_batch_size());
+    for (int i = offset.redis; i < redis_end; ++i) {
+      resp->add_redis_batch()->Swap(merged->mutable_redis_batch(i));
+    }
+    const int ql_end = std::min(offset.ql + req.ql_batch_size(), merged->ql_batch_size());
+    for (int i = offset.ql; i < ql_end; ++i) {
+      resp->add_ql_batch()->Swap(merged->mutable_ql_batch(i));
+    }
+  }
+};
+
+} // namespace
+
+template <class Req, class Resp>
+class TabletRpcCoalescer::Queue {
+ public:
+  explicit Queue(TabletRpcCoalescer* coalescer) : coalescer_(coalescer) {}
+
+  ~Queue() {
+    // Scheduled flushes and RPCs hold a reference to the coalescer.
+    DCHECK(tablets_.empty());
+  }
+
+  void Add(const std::shared_ptr<TabletServerServiceProxy>& proxy,
+           const rpc::RpcController& controller,
+           Req* req,
+           Resp* resp,
+           CoalescedRpcCallback callback) {
+    const Key key(proxy.get(), req->tablet_id());
+    std::shared_ptr<Batch> batch_to_send;
+    bool schedule_flush = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto& tablet = tablets_[key];
+      // Pending batch always has a scheduled flush, since a new batch that should not wait is sent
+      // right away.
+      bool wait = true;
+      const bool new_batch = !tablet.pending_batch;
+      if (new_batch) {
+        tablet.pending_batch = std::make_shared<Batch>(proxy);
+        // Nothing to wait for when there is no RPC in flight, since the request would be sent by
+        // itself anyway.
+        wait = tablet.in_flight != 0 && FLAGS_client_rpc_coalescing_window_us > 0;
+      }
+      tablet.pending_batch->Add(controller, req, resp, std::move(callback));
+      if (!wait || tablet.pending_batch->num_ops >= FLAGS_client_rpc_coalescing_max_ops) {
+        batch_to_send = std::move(tablet.pending_batch);
+        ++tablet.in_flight;
+      } else if (new_batch) {
+        schedule_flush = true;
+        ++tablet.scheduled_flushes;
+      }
+    }
+
+    if (schedule_flush) {
+      auto self = coalescer_->shared_from_this();
+      coalescer_->messenger_->ScheduleOnReactor(
+          [this, self, key](const Status& status) { FlushScheduled(key, status); },
+          MonoDelta::FromMicroseconds(FLAGS_client_rpc_coalescing_window_us),
+          coalescer_->messenger_);
+    }
+    if (batch_to_send) {
+      Send(key, std::move(batch_to_send));
+    }
+  }
+
+ private:
+  typedef std::pair<const TabletServerServiceProxy*, std::string> Key;
+
+  struct Part {
+    Req* req;
+    Resp* resp;
+    CoalescedRpcCallback callback;
+    OpsOffset offset;
+  };
+
+  struct Batch {
+    explicit Batch(std::shared_ptr<TabletServerServiceProxy> proxy_ptr)
+        : proxy(std::move(proxy_ptr)), controller(std::make_shared<rpc::RpcController>()) {}
+
+    void Add(const rpc::RpcController& part_controller, Req* req, Resp* resp,
+             CoalescedRpcCallback callback) {
+      const auto part_deadline = MonoTime::Now() + part_controller.timeout();
+      if (parts.empty() || part_deadline < deadline) {
+        deadline = part_deadline;
+      }
+      allow_local_calls_in_curr_thread =
+          (parts.empty() || allow_local_calls_in_curr_thread) &&
+          part_controller.allow_local_calls_in_curr_thread();
+      parts.push_back(Part{req, resp, std::move(callback), next_offset});
+      CoalescingTraits<Req, Resp>::OffsetAfter(*req, &next_offset);
+      num_ops += CoalescingTraits<Req, Resp>::NumOps(*req);
+    }
+
+    std::shared_ptr<TabletServerServiceProxy> proxy;
+    std::vector<Part> parts;
+    OpsOffset next_offset;
+    int num_ops = 0;
+    MonoTime deadline;
+    bool allow_local_calls_in_curr_thread = false;
+    Req request;
+    Resp response;
+    std::shared_ptr<rpc::RpcController> controller;
+  };
+
+  struct TabletState {
+    std::shared_ptr<Batch> pending_batch;
+    size_t scheduled_flushes = 0;
+    size_t in_flight = 0;
+  };
+
+  void FlushScheduled(const Key& key, const Status& status) {
+    std::shared_ptr<Batch> batch;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = tablets_.find(key);
+      DCHECK(it != tablets_.end());
+      --it->second.scheduled_flushes;
+      batch = std::move(it->second.pending_batch);
+      if (batch && status.ok()) {
+        ++it->second.in_flight;
+      } else {
+        EraseIfIdle(it);
+      }
+    }
+    if (!batch) {
+      // Batch was filled up and sent before the window has passed.
+      return;
+    }
+    if (!status.ok()) {
+      // Reactor is shutting down, so the batch could not be sent anyway.
+      for (auto& part : batch->parts) {
+        part.callback(status, batch->controller);
+      }
+      return;
+    }
+    Send(key, std::move(batch));
+  }
+
+  void Send(const Key& key, std::shared_ptr<Batch> batch) {
+    auto* batch_ptr = batch.get();
+    batch_ptr->controller->set_deadline(batch_ptr->deadline);
+    batch_ptr->controller->set_allow_local_calls_in_curr_thread(
+        batch_ptr->allow_local_calls_in_curr_thread);
+    const Req* req = batch_ptr->parts.front().req;
+    Resp* resp = batch_ptr->parts.front().resp;
+    if (batch_ptr->parts.size() > 1) {
+      req = &batch_ptr->request;
+      resp = &batch_ptr->response;
+      Merge(batch_ptr);
+    }
+    CoalescingTraits<Req, Resp>::Send(
+        batch_ptr->proxy.get(), *req, resp, batch_ptr->controller.get(),
+        [this, self = coalescer_->shared_from_this(), key, batch = std::move(batch)] {
+      BatchDone(key, batch);
+    });
+  }
+
+  void Merge(Batch* batch) {
+    auto& request = batch->request;
+    const auto& first = *batch->parts.front().req;
+    request.set_tablet_id(first.tablet_id());
+    for (auto& part : batch->parts) {
+      if (part.req->has_propagated_hybrid_time() &&
+          (!request.has_propagated_hybrid_time() ||
+           request.propagated_hybrid_time() < part.req->propagated_hybrid_time())) {
+        request.set_propagated_hybrid_time(part.req->propagated_hybrid_time());
+      }
+      CoalescingTraits<Req, Resp>::MoveOps(part.req, &request);
+    }
+  }
+
+  void BatchDone(const Key& key, const std::shared_ptr<Batch>& batch) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = tablets_.find(key);
+      DCHECK(it != tablets_.end());
+      --it->second.in_flight;
+      EraseIfIdle(it);
+    }
+
+    const Status status = batch->controller->status();
+    if (batch->parts.size() > 1) {
+      for (auto& part : batch->parts) {
+        CoalescingTraits<Req, Resp>::RestoreOps(part.offset, &batch->request, part.req);
+        part.resp->Clear();
+        if (status.ok()) {
+          CoalescingTraits<Req, Resp>::SplitResponse(
+              part.offset, *part.req, &batch->response, part.resp);
+        }
+      }
+    }
+    for (auto& part : batch->parts) {
+      part.callback(status, batch->controller);
+    }
+  }
+
+  template <class It>
+  void EraseIfIdle(const It& it) {
+    auto& tablet = it->second;
+    if (tablet.in_flight == 0 && !tablet.pending_batch && tablet.scheduled_flushes == 0) {
+      tablets_.erase(it);
+    }
+  }
+
+  TabletRpcCoalescer* const coalescer_;
+
+  std::mutex mutex_;
+  std::map<Key, TabletState> tablets_;
+};
+
+TabletRpcCoalescer::TabletRpcCoalescer(const std::shared_ptr<rpc::Messenger>& messenger)
+    : messenger_(messenger),
+      write_queue_(new Queue<WriteRequestPB, WriteResponsePB>(this)),
+      read_queue_(new Queue<ReadRequestPB, ReadResponsePB>(this)) {
+}
+
+TabletRpcCoalescer::~TabletRpcCoalescer() {
+}
+
+bool TabletRpcCoalescer::CanCoalesce(const WriteRequestPB& req) {
+  return FLAGS_client_rpc_coalescing_window_us > 0 &&
+         !req.has_write_batch() && !req.has_transaction_meta() && !req.has_read_time() &&
+         !req.include_trace() && req.cache_blocks();
+}
+
+bool TabletRpcCoalescer::CanCoalesce(const ReadRequestPB& req) {
+  return FLAGS_client_rpc_coalescing_window_us > 0 &&
+         !req.has_transaction() && !req.has_read_time() && !req.has_max_staleness_ms() &&
+         !req.include_trace() && req.cache_blocks() &&
+         req.consistency_level() == YBConsistencyLevel::STRONG;
+}
+
+void TabletRpcCoalescer::Write(const std::shared_ptr<TabletServerServiceProxy>& proxy,
+                               const rpc::RpcController& controller,
+                               WriteRequestPB* req,
+                               WriteResponsePB* resp,
+                               CoalescedRpcCallback callback) {
+  write_queue_->Add(proxy, controller, req, resp, std::move(callback));
+}
+
+void TabletRpcCoalescer::Read(const std::shared_ptr<TabletServerServiceProxy>& proxy,
+                              const rpc::RpcController& controller,
+                              ReadRequestPB* req,
+                              ReadResponsePB* resp,
+                              CoalescedRpcCallback callback) {
+  read_queue_->Add(proxy, controller, req, resp, std::move(callback));
+}
+
+}  // namespace internal
+}  // namespace client
+}  // namespace yb
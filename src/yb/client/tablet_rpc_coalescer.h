@@ -0,0 +1,92 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_CLIENT_TABLET_RPC_COALESCER_H
+#define YB_CLIENT_TABLET_RPC_COALESCER_H
+
+#include <functional>
+#include <memory>
+
+#include "yb/rpc/rpc_fwd.h"
+
+#include "yb/tserver/tserver.pb.h"
+
+#include "yb/util/status.h"
+
+namespace yb {
+
+namespace tserver {
+class TabletServerServiceProxy;
+}
+
+namespace client {
+namespace internal {
+
+// Invoked when the RPC that carried the request completes. 'controller' is the controller of this
+// RPC, so it should be used to access sidecars of the response.
+typedef std::function<void(const Status& status,
+                           const std::shared_ptr<rpc::RpcController>& controller)>
+    CoalescedRpcCallback;
+
+// Merges Write and Read requests, that are issued by different batchers of the same client to the
+// same tablet server and tablet, into a single RPC, and routes parts of its response back to each
+// request.
+//
+// Coalescing is adaptive: when there is no RPC to the tablet in flight, the request is sent right
+// away. Otherwise it waits for up to --client_rpc_coalescing_window_us for other requests, or until
+// --client_rpc_coalescing_max_ops operations are pending. So requests of a lightly loaded client
+// are never delayed, while under high concurrency the number of RPCs drops.
+//
+// Only requests that do not depend on per-request state on the server are coalesced, i.e. requests
+// without transaction, read time, bounded staleness or trace.
+class TabletRpcCoalescer : public std::enable_shared_from_this<TabletRpcCoalescer> {
+ public:
+  explicit TabletRpcCoalescer(const std::shared_ptr<rpc::Messenger>& messenger);
+  ~TabletRpcCoalescer();
+
+  TabletRpcCoalescer(const TabletRpcCoalescer&) = delete;
+  void operator=(const TabletRpcCoalescer&) = delete;
+
+  // Whether the request could be passed to this coalescer.
+  static bool CanCoalesce(const tserver::WriteRequestPB& req);
+  static bool CanCoalesce(const tserver::ReadRequestPB& req);
+
+  // Sends the request, possibly together with other requests. 'controller' provides the timeout of
+  // the call. 'req' and 'resp' should stay alive until 'callback' is invoked. Operations of 'req'
+  // are moved to the merged request while the RPC is in flight and restored before 'callback'.
+  void Write(const std::shared_ptr<tserver::TabletServerServiceProxy>& proxy,
+             const rpc::RpcController& controller,
+             tserver::WriteRequestPB* req,
+             tserver::WriteResponsePB* resp,
+             CoalescedRpcCallback callback);
+
+  void Read(const std::shared_ptr<tserver::TabletServerServiceProxy>& proxy,
+            const rpc::RpcController& controller,
+            tserver::ReadRequestPB* req,
+            tserver::ReadResponsePB* resp,
+            CoalescedRpcCallback callback);
+
+  template <class Req, class Resp>
+  class Queue;
+
+ private:
+  std::shared_ptr<rpc::Messenger> messenger_;
+  std::unique_ptr<Queue<tserver::WriteRequestPB, tserver::WriteResponsePB>> write_queue_;
+  std::unique_ptr<Queue<tserver::ReadRequestPB, tserver::ReadResponsePB>> read_queue_;
+};
+
+}  // namespace internal
+}  // namespace client
+}  // namespace yb
+
+#endif  // YB_CLIENT_TABLET_RPC_COALESCER_H
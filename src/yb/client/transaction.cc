@@ -40,6 +40,10 @@ using namespace std::placeholders;
 
 DEFINE_uint64(transaction_heartbeat_usec, 500000, "Interval of transaction heartbeat in usec.");
 DEFINE_bool(transaction_disable_heartbeat_in_tests, false, "Disable heartbeat during test.");
+DEFINE_bool(transaction_single_tablet_fast_path, true,
+            "Write the last batch of transaction as a plain non transactional write batch, when "
+            "transaction did not write before and all writes of this batch go to a single tablet. "
+            "Such transaction does not use status tablet, intents and apply phase.");
 DEFINE_uint64(max_clock_skew_usec, 50000,
               "Transaction read clock skew in usec. Is maximum allowed time delta between servers "
               "of a single cluster.");
@@ -126,7 +130,23 @@ class YBTransaction::Impl final {
 
     bool has_tablets_without_parameters = false;
     {
-      std::lock_guard<std::mutex> lock(mutex_);
+      std::unique_lock<std::mutex> lock(mutex_);
+      if (single_tablet_) {
+        lock.unlock();
+        waiter(STATUS(IllegalState, "Flush after the last batch of transaction"));
+        return false;
+      }
+      if (flushed_waiter_) {
+        lock.unlock();
+        waiter(STATUS(IllegalState, "Flush after commit of transaction"));
+        return false;
+      }
+      if (last_batch_ && TryUseSingleTabletFastPath(ops)) {
+        VLOG_WITH_PREFIX(1) << "Prepare, single tablet: " << tablets_.begin()->first;
+        prepare_data->propagated_ht = manager_->Now();
+        prepare_data->metadata = TransactionMetadata();
+        return true;
+      }
       if (!ready_) {
         RequestStatusTablet();
         waiters_.push_back(std::move(waiter));
@@ -178,6 +198,9 @@ class YBTransaction::Impl final {
           }
         }
       }
+      if (pipelined_ && pipelined_error_.ok()) {
+        pipelined_error_ = PipelinedWritesError(ops);
+      }
     } else if (status.IsTryAgain()) {
       SetError(status);
     }
@@ -185,6 +208,28 @@ class YBTransaction::Impl final {
     // And they are handled during processing of that batch.
   }
 
+  void BatchStarted() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++running_batches_;
+  }
+
+  void BatchFinished(const Status& status) {
+    std::function<void()> flushed_waiter;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (pipelined_ && pipelined_error_.ok() && !status.ok()) {
+        pipelined_error_ = status.CloneAndPrepend("Pipelined write failed");
+      }
+      DCHECK_GT(running_batches_, 0);
+      if (--running_batches_ == 0) {
+        flushed_waiter.swap(flushed_waiter_);
+      }
+    }
+    if (flushed_waiter) {
+      flushed_waiter();
+    }
+  }
+
   void Commit(CommitCallback callback) {
     auto transaction = transaction_->shared_from_this();
     {
@@ -203,7 +248,29 @@ class YBTransaction::Impl final {
             IllegalState, "Commit of transaction that requires restart is not allowed"));
         return;
       }
+      if (running_batches_ != 0) {
+        // Commit should not be sent before all writes of this transaction are done, so it is
+        // retried when the last flushed batch completes.
+        VLOG_WITH_PREFIX(1) << "Commit, waiting for " << running_batches_ << " batches";
+        flushed_waiter_ = [this, transaction, callback] { Commit(callback); };
+        return;
+      }
+      if (!pipelined_error_.ok()) {
+        status = pipelined_error_;
+        lock.unlock();
+        VLOG_WITH_PREFIX(1) << "Pipelined write failed, aborting: " << status;
+        Abort();
+        callback(status);
+        return;
+      }
       complete_.store(true, std::memory_order_release);
+      if (single_tablet_) {
+        // Writes were already applied atomically by the single tablet.
+        lock.unlock();
+        VLOG_WITH_PREFIX(1) << "Committed single tablet transaction";
+        callback(Status::OK());
+        return;
+      }
       commit_callback_ = std::move(callback);
       if (!ready_) {
         RequestStatusTablet();
@@ -227,6 +294,11 @@ class YBTransaction::Impl final {
         return;
       }
       complete_.store(true, std::memory_order_release);
+      if (single_tablet_) {
+        // Nothing is registered at status tablet, and writes could not be undone.
+        LOG_WITH_PREFIX(WARNING) << "Abort of single tablet transaction after its writes";
+        return;
+      }
       if (!ready_) {
         RequestStatusTablet();
         waiters_.emplace_back(std::bind(&Impl::DoAbort, this, _1, transaction));
@@ -356,7 +428,50 @@ class YBTransaction::Impl final {
     return metadata_.transaction_id;
   }
 
+  void MarkLastBatch() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    last_batch_ = true;
+  }
+
+  void SetPipelined() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pipelined_ = true;
+  }
+
  private:
+  // Returns error of the pipelined writes from specified successfully flushed ops, if any.
+  static Status PipelinedWritesError(const internal::InFlightOps& ops) {
+    for (const auto& op : ops) {
+      if (op->yb_op->type() == YBOperation::QL_WRITE && !op->yb_op->succeeded()) {
+        return STATUS_FORMAT(
+            Aborted, "Pipelined write failed: $0",
+            static_cast<YBqlWriteOp*>(op->yb_op.get())->response().error_message());
+      }
+    }
+    return Status::OK();
+  }
+
+  // Checks whether ops of the last batch could be written without distributed transaction and
+  // remembers their tablet, if so. That is the case when this transaction did not write before,
+  // and all ops of the batch are writes to the same tablet, because write batch is applied to
+  // a tablet atomically at single hybrid time.
+  bool TryUseSingleTabletFastPath(const std::unordered_set<internal::InFlightOpPtr>& ops) {
+    if (!FLAGS_transaction_single_tablet_fast_path || child_ || !tablets_.empty() ||
+        !restarts_.empty() || ops.empty()) {
+      return false;
+    }
+    const internal::RemoteTablet* tablet = nullptr;
+    for (const auto& op : ops) {
+      if (op->yb_op->read_only() || (tablet != nullptr && op->tablet.get() != tablet)) {
+        return false;
+      }
+      tablet = op->tablet.get();
+    }
+    tablets_.emplace(tablet->tablet_id(), TabletState());
+    single_tablet_ = true;
+    return true;
+  }
+
   Impl(TransactionManager* manager, YBTransaction* transaction, TransactionMetadata metadata,
        Child child)
       : manager_(manager),
@@ -621,6 +736,18 @@ class YBTransaction::Impl final {
   // Transaction is successfully initialized and ready to process intents.
   const bool child_;
   bool ready_ = false;
+  // Next flushed batch is the last one before commit, see MarkLastBatch.
+  bool last_batch_ = false;
+  // The last batch was written to single tablet without distributed transaction.
+  bool single_tablet_ = false;
+  // Batches are flushed without waiting for previous ones, see SetPipelined.
+  bool pipelined_ = false;
+  // The first error of pipelined writes, reported by commit.
+  Status pipelined_error_;
+  // Number of batches of this transaction that were started flushing, but not finished yet.
+  size_t running_batches_ = 0;
+  // Invoked when running_batches_ drops to zero, a commit waiting for flushed writes.
+  std::function<void()> flushed_waiter_;
   CommitCallback commit_callback_;
   Status error_;
   rpc::Rpcs::Handle heartbeat_handle_;
@@ -683,6 +810,14 @@ void YBTransaction::Flushed(
   impl_->Flushed(ops, status, propagated_hybrid_time);
 }
 
+void YBTransaction::BatchStarted() {
+  impl_->BatchStarted();
+}
+
+void YBTransaction::BatchFinished(const Status& status) {
+  impl_->BatchFinished(status);
+}
+
 void YBTransaction::Commit(CommitCallback callback) {
   impl_->Commit(std::move(callback));
 }
@@ -699,6 +834,14 @@ void YBTransaction::Abort() {
   impl_->Abort();
 }
 
+void YBTransaction::MarkLastBatch() {
+  impl_->MarkLastBatch();
+}
+
+void YBTransaction::SetPipelined() {
+  impl_->SetPipelined();
+}
+
 void YBTransaction::RestartRequired(const TabletId& tablet, const ReadHybridTime& restart_time) {
   impl_->RestartRequired(tablet, restart_time);
 }
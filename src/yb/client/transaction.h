@@ -92,6 +92,11 @@ class YBTransaction : public std::enable_shared_from_this<YBTransaction> {
   void Flushed(
       const internal::InFlightOps& ops, const Status& status, HybridTime propagated_hybrid_time);
 
+  // Notifies transaction that batch with its ops started flushing, and that flushing of such
+  // batch finished with specified status. Commit is not sent while there are running batches.
+  void BatchStarted();
+  void BatchFinished(const Status& status);
+
   // Commits this transaction.
   void Commit(CommitCallback callback);
 
@@ -101,6 +106,16 @@ class YBTransaction : public std::enable_shared_from_this<YBTransaction> {
   // Aborts this transaction.
   void Abort();
 
+  // Notifies transaction that the next flushed batch is its last one before Commit.
+  // If it did not write before and all ops of this batch are writes to the same tablet, then they
+  // are written as a plain write batch, without status tablet, intents and apply phase.
+  void MarkLastBatch();
+
+  // Enables pipelined writes, i.e. application could flush the next batch of this transaction
+  // without waiting for previous ones, for instance using YBSession::FlushAsync.
+  // Commit waits for all flushed batches and aborts this transaction if any write of them failed.
+  void SetPipelined();
+
   // Returns transaction ID.
   const TransactionId& id() const;
 
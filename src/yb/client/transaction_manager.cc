@@ -15,6 +15,11 @@
 
 #include "yb/client/transaction_manager.h"
 
+#include <limits>
+#include <mutex>
+
+#include "yb/master/master.pb.h"
+
 #include "yb/rpc/rpc.h"
 #include "yb/rpc/thread_pool.h"
 #include "yb/rpc/tasks_pool.h"
@@ -27,9 +32,21 @@ DEFINE_uint64(transaction_table_num_tablets, 24,
               "Automatically create transaction table with specified number of tablets if missing. "
               "0 to disable.");
 
+DEFINE_uint64(transaction_table_num_tablets_per_tserver, 8,
+              "Automatically created transaction table gets this number of tablets per live tablet "
+              "server, but not less than transaction_table_num_tablets.");
+
 DEFINE_uint64(transaction_table_num_replicas, 3,
               "Number of replicas in automatically created transaction table.");
 
+DEFINE_bool(transaction_prefer_local_status_tablets, true,
+            "Pick status tablet for a new transaction among tablets whose leader is closest to "
+            "the client: in the same zone, then in the same region.");
+
+DEFINE_uint64(transaction_status_tablets_refresh_usec, 10000000,
+              "Interval of reloading status tablets and their leaders, used to pick status tablet "
+              "for a new transaction.");
+
 namespace yb {
 namespace client {
 
@@ -37,13 +54,96 @@ namespace {
 
 const YBTableName kTransactionTableName("system", "transactions");
 
+// Distance from client to tablet server, the lower is the closer.
+int Distance(const CloudInfoPB& client_cloud_info, const master::TSInfoPB& ts_info) {
+  const auto& ts_cloud_info = ts_info.cloud_info();
+  if (client_cloud_info.placement_cloud() != ts_cloud_info.placement_cloud() ||
+      client_cloud_info.placement_region() != ts_cloud_info.placement_region()) {
+    return 3;
+  }
+  if (client_cloud_info.placement_zone() != ts_cloud_info.placement_zone()) {
+    return 2;
+  }
+  return 1;
+}
+
+// Status tablets cached for picking, i.e. tablets of transaction table whose leader is closest
+// to the client. Reloaded from master every transaction_status_tablets_refresh_usec, so picking
+// status tablet does not result in master RPC for every transaction.
+class StatusTablets {
+ public:
+  Result<std::string> Pick(YBClient* client) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto now = MonoTime::Now();
+    if (tablets_.empty() || now >= refresh_time_) {
+      auto status = Reload(client);
+      if (!status.ok()) {
+        if (tablets_.empty()) {
+          return status;
+        }
+        LOG(WARNING) << "Failed to reload status tablets, using cached ones: " << status;
+      }
+      refresh_time_ = now + MonoDelta::FromMicroseconds(
+          FLAGS_transaction_status_tablets_refresh_usec);
+    }
+    return RandomElement(tablets_);
+  }
+
+ private:
+  CHECKED_STATUS Reload(YBClient* client) {
+    std::vector<std::string> tablets;
+    std::vector<master::TabletLocationsPB> locations;
+    RETURN_NOT_OK(client->GetTablets(
+        kTransactionTableName, 0, &tablets, /* ranges */ nullptr, &locations));
+    if (tablets.empty()) {
+      return STATUS_FORMAT(IllegalState, "No tablets in table $0", kTransactionTableName);
+    }
+    if (!FLAGS_transaction_prefer_local_status_tablets) {
+      tablets_ = std::move(tablets);
+      return Status::OK();
+    }
+
+    // Tablet without known leader is picked only when there is no other choice.
+    constexpr int kUnknownLeaderDistance = 4;
+    const auto& cloud_info = client->cloud_info();
+    int best_distance = std::numeric_limits<int>::max();
+    std::vector<std::string> closest;
+    for (const auto& tablet : locations) {
+      int distance = kUnknownLeaderDistance;
+      for (const auto& replica : tablet.replicas()) {
+        if (replica.role() == consensus::RaftPeerPB::LEADER) {
+          distance = Distance(cloud_info, replica.ts_info());
+          break;
+        }
+      }
+      if (distance < best_distance) {
+        best_distance = distance;
+        closest.clear();
+      }
+      if (distance == best_distance) {
+        closest.push_back(tablet.tablet_id());
+      }
+    }
+    VLOG(1) << "Picked " << closest.size() << " of " << tablets.size()
+            << " status tablets with leader distance " << best_distance;
+    tablets_ = std::move(closest);
+    return Status::OK();
+  }
+
+  std::mutex mutex_;
+  std::vector<std::string> tablets_;
+  MonoTime refresh_time_;
+};
+
 // Picks status tablet for transaction.
 class PickStatusTabletTask {
  public:
   PickStatusTabletTask(const YBClientPtr& client,
                        std::atomic<bool>* status_table_exists,
+                       StatusTablets* status_tablets,
                        PickStatusTabletCallback callback)
-      : client_(client), status_table_exists_(status_table_exists), callback_(std::move(callback)) {
+      : client_(client), status_table_exists_(status_table_exists),
+        status_tablets_(status_tablets), callback_(std::move(callback)) {
   }
 
   void Run() {
@@ -54,19 +154,8 @@ class PickStatusTabletTask {
     }
 
     // TODO(dtxn) async
-    // TODO(dtxn) prefer tablets with leader on the local node
     // TODO(dtxn) prevent deletion of picked tablet
-    std::vector<std::string> tablets;
-    status = client_->GetTablets(kTransactionTableName, 0, &tablets, /* ranges */ nullptr);
-    if (!status.ok()) {
-      callback_(status);
-      return;
-    }
-    if (tablets.empty()) {
-      callback_(STATUS_FORMAT(IllegalState, "No tablets in table $0", kTransactionTableName));
-      return;
-    }
-    callback_(RandomElement(tablets));
+    callback_(status_tablets_->Pick(client_.get()));
   }
 
   void Done(const Status& status) {
@@ -93,6 +182,12 @@ class PickStatusTabletTask {
       LOG(WARNING) << "Failed to open transaction table: " << status.ToString();
       auto tablets = FLAGS_transaction_table_num_tablets;
       if (tablets > 0 && status.IsNotFound()) {
+        int tserver_count = 0;
+        if (FLAGS_transaction_table_num_tablets_per_tserver > 0 &&
+            client_->TabletServerCount(&tserver_count).ok()) {
+          tablets = std::max<uint64_t>(
+              tablets, FLAGS_transaction_table_num_tablets_per_tserver * tserver_count);
+        }
         status = client_->CreateNamespaceIfNotExists(kTransactionTableName.namespace_name());
         if (status.ok()) {
           std::unique_ptr<client::YBTableCreator> table_creator(client_->NewTableCreator());
@@ -116,6 +211,7 @@ class PickStatusTabletTask {
 
   YBClientPtr client_;
   std::atomic<bool>* status_table_exists_;
+  StatusTablets* status_tablets_;
   PickStatusTabletCallback callback_;
 };
 
@@ -133,7 +229,8 @@ class TransactionManager::Impl {
         tasks_pool_(kQueueLimit) {}
 
   void PickStatusTablet(PickStatusTabletCallback callback) {
-    if (!tasks_pool_.Enqueue(&thread_pool_, client_, &status_table_exists_, std::move(callback))) {
+    if (!tasks_pool_.Enqueue(
+            &thread_pool_, client_, &status_table_exists_, &status_tablets_, std::move(callback))) {
       callback(STATUS_FORMAT(ServiceUnavailable, "Tasks overflow, exists: $0", tasks_pool_.size()));
     }
   }
@@ -158,6 +255,7 @@ class TransactionManager::Impl {
   YBClientPtr client_;
   scoped_refptr<ClockBase> clock_;
   std::atomic<bool> status_table_exists_{false};
+  StatusTablets status_tablets_;
   std::atomic<bool> closed_{false};
   yb::rpc::ThreadPool thread_pool_; // TODO async operations instead of pool
   yb::rpc::TasksPool<PickStatusTabletTask> tasks_pool_;
@@ -37,6 +37,7 @@
 #include "yb/common/wire_protocol.pb.h"
 #include "yb/common/wire_protocol.h"
 #include "yb/common/redis_protocol.pb.h"
+#include "yb/common/ql_columnar_rows.h"
 #include "yb/common/ql_protocol.pb.h"
 #include "yb/common/ql_rowblock.h"
 #include "yb/yql/redis/redisserver/redis_constants.h"
@@ -350,5 +351,16 @@ Result<QLRowBlock> YBqlReadOp::MakeRowBlock() const {
   return result;
 }
 
+Result<QLColumnarRowsView> YBqlReadOp::MakeColumnarRowsView() const {
+  if (response().rows_data_format() != YQL_ROWS_DATA_COLUMNAR) {
+    return STATUS(IllegalState, "Rows data is not columnar");
+  }
+  std::vector<std::shared_ptr<QLType>> types;
+  for (const auto& rscol_desc : request().rsrow_desc().rscol_descs()) {
+    types.push_back(QLType::FromQLTypePB(rscol_desc.ql_type()));
+  }
+  return QLColumnarRowsView::Decode(types, rows_data_);
+}
+
 }  // namespace client
 }  // namespace yb
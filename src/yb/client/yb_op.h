@@ -41,6 +41,8 @@
 
 #include "yb/client/meta_cache.h"
 
+#include "yb/util/ref_cnt_buffer.h"
+
 namespace yb {
 
 class RedisWriteRequestPB;
@@ -51,6 +53,7 @@ class QLWriteRequestPB;
 class QLReadRequestPB;
 class QLResponsePB;
 class QLRowBlock;
+class QLColumnarRowsView;
 
 namespace client {
 
@@ -208,9 +211,11 @@ class YBqlOp : public YBOperation {
 
   QLResponsePB* mutable_response() { return ql_response_.get(); }
 
-  std::string&& rows_data() { return std::move(rows_data_); }
+  // Rows returned by the tablet server in the wire format of the client, shared without copying
+  // with results built from this operation.
+  const RefCntBuffer& rows_data() const { return rows_data_; }
 
-  std::string* mutable_rows_data() { return &rows_data_; }
+  RefCntBuffer* mutable_rows_data() { return &rows_data_; }
 
   // Set the hash key in the partial row of this QL operation.
   virtual void SetHashCode(uint16_t hash_code) override = 0;
@@ -220,7 +225,7 @@ class YBqlOp : public YBOperation {
  protected:
   explicit YBqlOp(const std::shared_ptr<YBTable>& table);
   std::unique_ptr<QLResponsePB> ql_response_;
-  std::string rows_data_;
+  RefCntBuffer rows_data_;
 };
 
 class YBqlWriteOp : public YBqlOp {
@@ -298,9 +303,18 @@ class YBqlReadOp : public YBqlOp {
     yb_consistency_level_ = yb_consistency_level;
   }
 
+  // Max staleness of CONSISTENT_PREFIX read, i.e. the read is served by the closest replica whose
+  // safe time lags the current time by at most this value. Uninitialized means unbounded.
+  const MonoDelta& max_staleness() const { return max_staleness_; }
+  void set_max_staleness(const MonoDelta& value) { max_staleness_ = value; }
+
   std::vector<ColumnSchema> MakeColumnSchemasFromRequest() const;
   Result<QLRowBlock> MakeRowBlock() const;
 
+  // Columnar view of the returned rows, when the request asked for YQL_ROWS_DATA_COLUMNAR. The
+  // view refers to rows_data(), so this operation should outlive it.
+  Result<QLColumnarRowsView> MakeColumnarRowsView() const;
+
   const ReadHybridTime& read_time() const { return read_time_; }
   void SetReadTime(const ReadHybridTime& value) { read_time_ = value; }
 
@@ -312,6 +326,7 @@ class YBqlReadOp : public YBqlOp {
   explicit YBqlReadOp(const std::shared_ptr<YBTable>& table);
   std::unique_ptr<QLReadRequestPB> ql_read_request_;
   YBConsistencyLevel yb_consistency_level_;
+  MonoDelta max_staleness_;
   ReadHybridTime read_time_;
 };
 
@@ -16,6 +16,7 @@
 
 #include "yb/common/index.h"
 #include "yb/common/common.pb.h"
+#include "yb/common/ql_protocol.pb.h"
 
 using std::vector;
 using google::protobuf::RepeatedPtrField;
@@ -50,4 +51,35 @@ IndexInfo::IndexInfo(const IndexInfoPB& pb)
       range_column_count_(pb.range_column_count()) {
 }
 
+bool IndexInfo::IsColumnCovered(const ColumnId column_id) const {
+  for (const auto& column : columns_) {
+    if (column.indexed_column_id == column_id) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool IndexInfo::IsUpdatedBy(const QLWriteRequestPB& request) const {
+  switch (request.type()) {
+    case QLWriteRequestPB::QL_STMT_INSERT:
+      // An insert could create the row, so its index entry has to be written.
+      return true;
+    case QLWriteRequestPB::QL_STMT_DELETE:
+      // A delete without columns deletes the whole row.
+      if (request.column_values().empty()) {
+        return true;
+      }
+      FALLTHROUGH_INTENDED;
+    case QLWriteRequestPB::QL_STMT_UPDATE:
+      for (const auto& column_value : request.column_values()) {
+        if (IsColumnCovered(ColumnId(column_value.column_id()))) {
+          return true;
+        }
+      }
+      return false;
+  }
+  return true;
+}
+
 }  // namespace yb
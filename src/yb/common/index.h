@@ -25,6 +25,8 @@
 
 namespace yb {
 
+class QLWriteRequestPB;
+
 // A class to maintain the information of an index.
 class IndexInfo {
  public:
@@ -50,6 +52,14 @@ class IndexInfo {
   size_t range_column_count() const { return range_column_count_; }
   size_t key_column_count() const { return hash_column_count_ + range_column_count_; }
 
+  // Whether the column of the indexed table is an indexed or covering column of the index.
+  bool IsColumnCovered(ColumnId column_id) const;
+
+  // Whether the write to the indexed table could change the entry of the row in the index. An
+  // update or a column delete that touches none of the covered columns leaves the index entry as
+  // it is, so the index needs neither the read of the existing row nor a write for it.
+  bool IsUpdatedBy(const QLWriteRequestPB& request) const;
+
  private:
   const TableId table_id_;            // Index table id.
   const uint32_t schema_version_ = 0; // Index table's schema version.
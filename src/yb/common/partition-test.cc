@@ -116,4 +116,46 @@ TEST(PartitionTest, TestRedisEncoding) {
   ASSERT_EQ(pk1, pk2);
 }
 
+TEST(PartitionTest, TestSpecializedHashKeyEncoders) {
+  PartitionSchemaPB partition_schema_pb;
+  partition_schema_pb.set_hash_schema(PartitionSchemaPB::MULTI_COLUMN_HASH_SCHEMA);
+  // Partition schema without a specialized encoder, that appends values column by column.
+  const PartitionSchema generic_partition_schema;
+
+  const auto check = [&](const Schema& schema,
+                         const google::protobuf::RepeatedPtrField<QLExpressionPB>& values) {
+    PartitionSchema partition_schema;
+    ASSERT_OK(PartitionSchema::FromPB(partition_schema_pb, schema, &partition_schema));
+    string specialized_key;
+    ASSERT_OK(partition_schema.EncodeKey(values, &specialized_key));
+    string generic_key;
+    ASSERT_OK(generic_partition_schema.EncodeKey(values, &generic_key));
+    ASSERT_EQ(generic_key, specialized_key);
+  };
+
+  Schema int_timestamp_schema({ ColumnSchema("h1", INT32, false, true),
+                                ColumnSchema("h2", TIMESTAMP, false, true),
+                                ColumnSchema("r", INT64) },
+                              { ColumnId(0), ColumnId(1), ColumnId(2) }, 3);
+  ASSERT_NE(nullptr, PartitionSchema::ResolveHashKeyEncoder(int_timestamp_schema));
+  google::protobuf::RepeatedPtrField<QLExpressionPB> values;
+  values.Add()->mutable_value()->set_int32_value(-17);
+  values.Add()->mutable_value()->set_timestamp_value(1234567890123);
+  check(int_timestamp_schema, values);
+  // Values of unexpected types are encoded column by column.
+  values.Mutable(1)->mutable_value()->set_int64_value(1234567890123);
+  check(int_timestamp_schema, values);
+
+  Schema text_schema({ ColumnSchema("h", STRING, false, true) }, { ColumnId(0) }, 1);
+  ASSERT_NE(nullptr, PartitionSchema::ResolveHashKeyEncoder(text_schema));
+  values.Clear();
+  values.Add()->mutable_value()->set_string_value("some key");
+  check(text_schema, values);
+
+  Schema text_pair_schema({ ColumnSchema("h1", STRING, false, true),
+                            ColumnSchema("h2", STRING, false, true) },
+                          { ColumnId(0), ColumnId(1) }, 2);
+  ASSERT_EQ(nullptr, PartitionSchema::ResolveHashKeyEncoder(text_pair_schema));
+}
+
 } // namespace yb
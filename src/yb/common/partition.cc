@@ -58,6 +58,123 @@ using strings::Substitute;
 // The encoded size of a hash bucket in a partition key.
 static const size_t kEncodedBucketSize = sizeof(uint32_t);
 
+namespace {
+
+// Fixed width hash columns, that are appended to the compound value in the same way as
+// AppendToKey does it for QLValuePB.
+struct Int32HashColumn {
+  static constexpr QLValuePB::ValueCase kValueCase = QLValuePB::kInt32Value;
+  static constexpr size_t kSize = sizeof(uint32_t);
+  static void Store(const QLValuePB& value, char* out) {
+    BigEndian::Store32(out, static_cast<uint32_t>(value.int32_value()));
+  }
+};
+
+struct Int64HashColumn {
+  static constexpr QLValuePB::ValueCase kValueCase = QLValuePB::kInt64Value;
+  static constexpr size_t kSize = sizeof(uint64_t);
+  static void Store(const QLValuePB& value, char* out) {
+    BigEndian::Store64(out, static_cast<uint64_t>(value.int64_value()));
+  }
+};
+
+struct TimestampHashColumn {
+  static constexpr QLValuePB::ValueCase kValueCase = QLValuePB::kTimestampValue;
+  static constexpr size_t kSize = sizeof(uint64_t);
+  static void Store(const QLValuePB& value, char* out) {
+    BigEndian::Store64(out, static_cast<uint64_t>(value.timestamp_value()));
+  }
+};
+
+// Stores values of a fixed width composite hash key into a buffer on stack.
+template <class... Columns>
+struct FixedWidthHashKey;
+
+template <>
+struct FixedWidthHashKey<> {
+  static constexpr size_t kSize = 0;
+  static bool Store(const RepeatedPtrField<QLExpressionPB>& values, int idx, char* out) {
+    return true;
+  }
+};
+
+template <class Column, class... Columns>
+struct FixedWidthHashKey<Column, Columns...> {
+  static constexpr size_t kSize = Column::kSize + FixedWidthHashKey<Columns...>::kSize;
+  static bool Store(const RepeatedPtrField<QLExpressionPB>& values, int idx, char* out) {
+    const QLValuePB& value = values.Get(idx).value();
+    if (value.value_case() != Column::kValueCase) {
+      return false;
+    }
+    Column::Store(value, out);
+    return FixedWidthHashKey<Columns...>::Store(values, idx + 1, out + Column::kSize);
+  }
+};
+
+uint16_t HashCompoundValue(const char* data, size_t size) {
+  // Same as PartitionSchema::HashColumnCompoundValue, without copying data into a string.
+  static const int kseed = 97;
+  const uint64_t hash_value = Hash64StringWithSeed(data, static_cast<uint32>(size), kseed);
+  const uint64_t h1 = hash_value >> 48;
+  const uint64_t h2 = 3 * (hash_value >> 32);
+  const uint64_t h3 = 5 * (hash_value >> 16);
+  const uint64_t h4 = 7 * (hash_value & 0xffff);
+  return (h1 ^ h2 ^ h3 ^ h4) & 0xffff;
+}
+
+template <class... Columns>
+bool HashFixedWidthKey(const RepeatedPtrField<QLExpressionPB>& values, uint16_t* hash) {
+  typedef FixedWidthHashKey<Columns...> Key;
+  if (values.size() != sizeof...(Columns)) {
+    return false;
+  }
+  char buffer[Key::kSize];
+  if (!Key::Store(values, 0, buffer)) {
+    return false;
+  }
+  *hash = HashCompoundValue(buffer, Key::kSize);
+  return true;
+}
+
+// A single column of a variable width type is hashed as is.
+template <QLValuePB::ValueCase kValueCase>
+bool HashBytesKey(const RepeatedPtrField<QLExpressionPB>& values, uint16_t* hash) {
+  if (values.size() != 1 || values.Get(0).value().value_case() != kValueCase) {
+    return false;
+  }
+  const auto& value = values.Get(0).value();
+  const string& bytes = kValueCase == QLValuePB::kStringValue ? value.string_value()
+                      : kValueCase == QLValuePB::kUuidValue ? value.uuid_value()
+                      : kValueCase == QLValuePB::kTimeuuidValue ? value.timeuuid_value()
+                      : value.binary_value();
+  *hash = HashCompoundValue(bytes.data(), bytes.size());
+  return true;
+}
+
+// Fixed width hash keys of up to 2 columns are specialized, so the number of instantiations stays
+// small.
+template <class First>
+PartitionSchema::HashKeyEncoder ResolveFixedWidthHashKeyEncoder(const Schema& schema) {
+  if (schema.num_hash_key_columns() == 1) {
+    return &HashFixedWidthKey<First>;
+  }
+  if (schema.num_hash_key_columns() != 2) {
+    return nullptr;
+  }
+  switch (schema.column(1).type_info()->type()) {
+    case DataType::INT32:
+      return &HashFixedWidthKey<First, Int32HashColumn>;
+    case DataType::INT64:
+      return &HashFixedWidthKey<First, Int64HashColumn>;
+    case DataType::TIMESTAMP:
+      return &HashFixedWidthKey<First, TimestampHashColumn>;
+    default:
+      return nullptr;
+  }
+}
+
+} // namespace
+
 Slice Partition::range_key_start() const {
   return range_key(partition_key_start());
 }
@@ -146,6 +263,7 @@ Status PartitionSchema::FromPB(const PartitionSchemaPB& pb,
     case PartitionSchemaPB::MULTI_COLUMN_HASH_SCHEMA:
       VLOG(3) << "Using multi-column hash value for partitioning";
       partition_schema->hash_schema_ = YBHashSchema::kMultiColumnHash;
+      partition_schema->hash_key_encoder_ = ResolveHashKeyEncoder(schema);
       return Status::OK();
 
     case PartitionSchemaPB::REDIS_HASH_SCHEMA:
@@ -246,11 +364,14 @@ Status PartitionSchema::EncodeKey(const RepeatedPtrField<QLExpressionPB>& hash_c
 
   switch (hash_schema_) {
     case YBHashSchema::kMultiColumnHash: {
-      string tmp;
-      for (const auto &col_expr_pb : hash_col_values) {
-        AppendToKey(col_expr_pb.value(), &tmp);
+      uint16_t hash_value = 0;
+      if (hash_key_encoder_ == nullptr || !hash_key_encoder_(hash_col_values, &hash_value)) {
+        string tmp;
+        for (const auto &col_expr_pb : hash_col_values) {
+          AppendToKey(col_expr_pb.value(), &tmp);
+        }
+        hash_value = YBPartition::HashColumnCompoundValue(tmp);
       }
-      const uint16_t hash_value = YBPartition::HashColumnCompoundValue(tmp);
       *buf = EncodeMultiColumnHashValue(hash_value);
       return Status::OK();
     }
@@ -911,6 +1032,31 @@ Status PartitionSchema::EncodeColumns(const YBPartialRow& row,
   return Status::OK();
 }
 
+PartitionSchema::HashKeyEncoder PartitionSchema::ResolveHashKeyEncoder(const Schema& schema) {
+  if (schema.num_hash_key_columns() == 0) {
+    return nullptr;
+  }
+  const bool single_column = schema.num_hash_key_columns() == 1;
+  switch (schema.column(0).type_info()->type()) {
+    case DataType::INT32:
+      return ResolveFixedWidthHashKeyEncoder<Int32HashColumn>(schema);
+    case DataType::INT64:
+      return ResolveFixedWidthHashKeyEncoder<Int64HashColumn>(schema);
+    case DataType::TIMESTAMP:
+      return ResolveFixedWidthHashKeyEncoder<TimestampHashColumn>(schema);
+    case DataType::STRING:
+      return single_column ? &HashBytesKey<QLValuePB::kStringValue> : nullptr;
+    case DataType::BINARY:
+      return single_column ? &HashBytesKey<QLValuePB::kBinaryValue> : nullptr;
+    case DataType::UUID:
+      return single_column ? &HashBytesKey<QLValuePB::kUuidValue> : nullptr;
+    case DataType::TIMEUUID:
+      return single_column ? &HashBytesKey<QLValuePB::kTimeuuidValue> : nullptr;
+    default:
+      return nullptr;
+  }
+}
+
 uint16_t PartitionSchema::HashColumnCompoundValue(const string& compound) {
   // In the future, if you wish to change the hashing behavior, you must introduce a new hashing
   // method for your newly-created tables.  Existing tables must continue to use their hashing
@@ -996,6 +1142,7 @@ void PartitionSchema::Clear() {
   hash_bucket_schemas_.clear();
   range_schema_.column_ids.clear();
   hash_schema_ = YBHashSchema::kMultiColumnHash;
+  hash_key_encoder_ = nullptr;
 }
 
 Status PartitionSchema::Validate(const Schema& schema) const {
@@ -153,6 +153,15 @@ class PartitionSchema {
   static constexpr int32_t kPartitionKeySize = 2;
   static constexpr int32_t kMaxPartitionKey = std::numeric_limits<uint16_t>::max();
 
+  // Hashes hash column values into a 16-bit integer without building the compound string of them
+  // column by column. Returns false if the values do not have the expected types.
+  typedef bool (*HashKeyEncoder)(
+      const google::protobuf::RepeatedPtrField<QLExpressionPB>& hash_values, uint16_t* hash);
+
+  // Returns the encoder specialized for the types of hash columns of schema, or nullptr if there
+  // is none for them.
+  static HashKeyEncoder ResolveHashKeyEncoder(const Schema& schema);
+
   // Deserializes a protobuf message into a partition schema.
   static CHECKED_STATUS FromPB(const PartitionSchemaPB& pb,
                                const Schema& schema,
@@ -322,6 +331,9 @@ class PartitionSchema {
   std::vector<HashBucketSchema> hash_bucket_schemas_;
   RangeSchema range_schema_;
   YBHashSchema hash_schema_ = YBHashSchema::kMultiColumnHash;
+
+  // Resolved once per table, since hash columns could not be altered.
+  HashKeyEncoder hash_key_encoder_ = nullptr;
 };
 
 } // namespace yb
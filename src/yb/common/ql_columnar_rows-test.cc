@@ -0,0 +1,82 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <gtest/gtest.h>
+
+#include "yb/common/ql_columnar_rows.h"
+
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+
+class QLColumnarRowsTest : public YBTest {
+};
+
+TEST_F(QLColumnarRowsTest, EncodeDecode) {
+  const std::vector<std::shared_ptr<QLType>> types = {
+      QLType::Create(INT32), QLType::Create(STRING), QLType::Create(TIMESTAMP),
+      QLType::Create(BOOL), QLType::Create(DOUBLE)};
+  constexpr int kNumRows = 21;
+
+  std::vector<std::vector<QLValue>> rows;
+  QLColumnarRowsEncoder encoder(types);
+  for (int i = 0; i != kNumRows; ++i) {
+    std::vector<QLValue> row(types.size());
+    if (i % 3 != 0) {
+      row[0].set_int32_value(i * 1000 - 7);
+    }
+    if (i % 4 != 0) {
+      row[1].set_string_value(std::string(i, 'a' + i % 26));
+    }
+    if (i % 5 != 0) {
+      row[2].set_timestamp_value(1500000000000000LL + i);
+    }
+    row[3].set_bool_value(i % 2 == 0);
+    if (i % 7 != 0) {
+      row[4].set_double_value(i / 8.0);
+    }
+    encoder.AddRow(row);
+    rows.push_back(std::move(row));
+  }
+  faststring buffer;
+  encoder.Finish(&buffer);
+
+  auto view = ASSERT_RESULT(QLColumnarRowsView::Decode(types, Slice(buffer)));
+  ASSERT_EQ(kNumRows, view.row_count());
+  ASSERT_EQ(types.size(), view.column_count());
+  for (int i = 0; i != kNumRows; ++i) {
+    SCOPED_TRACE(Format("Row: $0", i));
+    for (size_t col = 0; col != types.size(); ++col) {
+      const auto& expected = rows[i][col];
+      ASSERT_EQ(expected.IsNull(), view.column(col).IsNull(i));
+      QLValue value;
+      ASSERT_OK(view.column(col).GetValue(i, &value));
+      ASSERT_EQ(expected.ToString(), value.ToString());
+    }
+    // Typed access without building QLValue.
+    if (!rows[i][0].IsNull()) {
+      ASSERT_EQ(rows[i][0].int32_value(), view.column(0).fixed_value<int32_t>(i));
+    }
+    if (!rows[i][1].IsNull()) {
+      ASSERT_EQ(rows[i][1].string_value(), view.column(1).value_bytes(i).ToBuffer());
+    }
+  }
+
+  // Truncated or extended data is rejected.
+  ASSERT_NOK(QLColumnarRowsView::Decode(types, Slice(buffer.data(), buffer.size() - 1)));
+  buffer.push_back(0);
+  ASSERT_NOK(QLColumnarRowsView::Decode(types, Slice(buffer)));
+}
+
+} // namespace yb
@@ -0,0 +1,222 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/common/ql_columnar_rows.h"
+
+namespace yb {
+
+namespace {
+
+template <class T>
+void AppendFixed(T value, faststring* buffer) {
+  buffer->append(&value, sizeof(value));
+}
+
+void AppendUInt32(uint32_t value, faststring* buffer) {
+  uint8_t buf[sizeof(value)];
+  LittleEndian::Store32(buf, value);
+  buffer->append(buf, sizeof(buf));
+}
+
+CHECKED_STATUS Consume(size_t size, Slice* data, const uint8_t** out) {
+  if (data->size() < size) {
+    return STATUS_FORMAT(Corruption, "Columnar rows data truncated: $0 bytes expected, $1 left",
+                         size, data->size());
+  }
+  *out = data->data();
+  data->remove_prefix(size);
+  return Status::OK();
+}
+
+} // namespace
+
+size_t QLColumnarFixedWidth(DataType type) {
+  switch (type) {
+    case INT8: FALLTHROUGH_INTENDED;
+    case BOOL:
+      return 1;
+    case INT16:
+      return 2;
+    case INT32: FALLTHROUGH_INTENDED;
+    case FLOAT:
+      return 4;
+    case INT64: FALLTHROUGH_INTENDED;
+    case DOUBLE: FALLTHROUGH_INTENDED;
+    case TIMESTAMP:
+      return 8;
+    default:
+      return 0;
+  }
+}
+
+QLColumnarRowsEncoder::QLColumnarRowsEncoder(std::vector<std::shared_ptr<QLType>> types)
+    : types_(std::move(types)), columns_(types_.size()) {
+  for (size_t idx = 0; idx != types_.size(); ++idx) {
+    if (QLColumnarFixedWidth(types_[idx]->main()) == 0) {
+      columns_[idx].offsets.push_back(0);
+    }
+  }
+}
+
+void QLColumnarRowsEncoder::AddRow(const std::vector<QLValue>& values) {
+  DCHECK_EQ(values.size(), columns_.size());
+  for (size_t idx = 0; idx != columns_.size(); ++idx) {
+    const auto& value = values[idx];
+    auto& column = columns_[idx];
+    const auto type = types_[idx]->main();
+    const bool is_null = value.IsNull();
+    column.nulls.push_back(is_null);
+    if (QLColumnarFixedWidth(type) == 0) {
+      if (!is_null) {
+        value.Serialize(types_[idx], YQL_CLIENT_CQL, &column.data);
+      }
+      column.offsets.push_back(column.data.size());
+      continue;
+    }
+    switch (type) {
+      case INT8:
+        AppendFixed<int8_t>(is_null ? 0 : value.int8_value(), &column.data);
+        break;
+      case BOOL:
+        AppendFixed<uint8_t>(!is_null && value.bool_value(), &column.data);
+        break;
+      case INT16:
+        AppendFixed<int16_t>(is_null ? 0 : value.int16_value(), &column.data);
+        break;
+      case INT32:
+        AppendFixed<int32_t>(is_null ? 0 : value.int32_value(), &column.data);
+        break;
+      case FLOAT:
+        AppendFixed<float>(is_null ? 0 : value.float_value(), &column.data);
+        break;
+      case INT64:
+        AppendFixed<int64_t>(is_null ? 0 : value.int64_value(), &column.data);
+        break;
+      case DOUBLE:
+        AppendFixed<double>(is_null ? 0 : value.double_value(), &column.data);
+        break;
+      case TIMESTAMP:
+        AppendFixed<int64_t>(is_null ? 0 : value.timestamp_value_pb(), &column.data);
+        break;
+      default:
+        LOG(FATAL) << "Unexpected fixed-width type: " << types_[idx]->ToString();
+    }
+  }
+  ++row_count_;
+}
+
+void QLColumnarRowsEncoder::Finish(faststring* buffer) const {
+  AppendUInt32(row_count_, buffer);
+  for (const auto& column : columns_) {
+    std::vector<uint8_t> bitmap((row_count_ + 7) / 8);
+    for (size_t row = 0; row != row_count_; ++row) {
+      if (column.nulls[row]) {
+        bitmap[row >> 3] |= 1 << (row & 7);
+      }
+    }
+    buffer->append(bitmap.data(), bitmap.size());
+    for (auto offset : column.offsets) {
+      AppendUInt32(offset, buffer);
+    }
+    buffer->append(column.data.data(), column.data.size());
+  }
+}
+
+Slice QLColumnarColumnView::value_bytes(size_t row) const {
+  DCHECK_EQ(fixed_width_, 0);
+  const uint32_t begin = offset(row);
+  const uint32_t end = offset(row + 1);
+  if (begin == end) {
+    return Slice();
+  }
+  // Skip CQL length prefix.
+  return Slice(values_ + begin + sizeof(int32_t), values_ + end);
+}
+
+Status QLColumnarColumnView::GetValue(size_t row, QLValue* value) const {
+  if (IsNull(row)) {
+    value->SetNull();
+    return Status::OK();
+  }
+  switch (fixed_width_ ? type_->main() : DataType::UNKNOWN_DATA) {
+    case INT8:
+      value->set_int8_value(fixed_value<int8_t>(row));
+      return Status::OK();
+    case BOOL:
+      value->set_bool_value(fixed_value<uint8_t>(row) != 0);
+      return Status::OK();
+    case INT16:
+      value->set_int16_value(fixed_value<int16_t>(row));
+      return Status::OK();
+    case INT32:
+      value->set_int32_value(fixed_value<int32_t>(row));
+      return Status::OK();
+    case FLOAT:
+      value->set_float_value(fixed_value<float>(row));
+      return Status::OK();
+    case INT64:
+      value->set_int64_value(fixed_value<int64_t>(row));
+      return Status::OK();
+    case DOUBLE:
+      value->set_double_value(fixed_value<double>(row));
+      return Status::OK();
+    case TIMESTAMP:
+      value->set_timestamp_value(fixed_value<int64_t>(row));
+      return Status::OK();
+    default: {
+      const uint32_t begin = offset(row);
+      Slice data(values_ + begin, offset(row + 1) - begin);
+      return value->Deserialize(type_, YQL_CLIENT_CQL, &data);
+    }
+  }
+}
+
+Status QLColumnarColumnView::Decode(Slice* data) {
+  fixed_width_ = QLColumnarFixedWidth(type_->main());
+  RETURN_NOT_OK(Consume((row_count_ + 7) / 8, data, &nulls_));
+  if (fixed_width_) {
+    return Consume(row_count_ * fixed_width_, data, &values_);
+  }
+  RETURN_NOT_OK(Consume((row_count_ + 1) * sizeof(uint32_t), data, &offsets_));
+  uint32_t previous = 0;
+  for (size_t row = 0; row <= row_count_; ++row) {
+    const uint32_t current = offset(row);
+    if (current < previous || (row == 0 && current != 0)) {
+      return STATUS_FORMAT(Corruption, "Wrong offset of row $0 in columnar rows data: $1",
+                           row, current);
+    }
+    previous = current;
+  }
+  return Consume(previous, data, &values_);
+}
+
+Result<QLColumnarRowsView> QLColumnarRowsView::Decode(
+    const std::vector<std::shared_ptr<QLType>>& types, const Slice& data) {
+  Slice input = data;
+  const uint8_t* header;
+  RETURN_NOT_OK(Consume(sizeof(uint32_t), &input, &header));
+
+  QLColumnarRowsView result;
+  result.row_count_ = LittleEndian::Load32(header);
+  result.columns_.reserve(types.size());
+  for (const auto& type : types) {
+    result.columns_.emplace_back(type, result.row_count_);
+    RETURN_NOT_OK(result.columns_.back().Decode(&input));
+  }
+  if (!input.empty()) {
+    return STATUS_FORMAT(Corruption, "$0 extra bytes after columnar rows data", input.size());
+  }
+  return result;
+}
+
+} // namespace yb
@@ -0,0 +1,133 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+// This file contains the column-oriented encoding of QL rows data, that is returned instead of the
+// row-oriented CQL encoding when a read request asks for YQL_ROWS_DATA_COLUMNAR.
+//
+// Layout, all numbers are little-endian, so fixed-width values are read without conversion:
+//   uint32 row count, then for each selected column:
+//     null bitmap of (row count + 7) / 8 bytes, bit is set for null values;
+//     for fixed-width types: row count values, null values are zeroed;
+//     for other types: row count + 1 uint32 offsets relative to the data that follows, then the
+//     values in CQL serialized form (including the length prefix), null values are empty.
+
+#ifndef YB_COMMON_QL_COLUMNAR_ROWS_H
+#define YB_COMMON_QL_COLUMNAR_ROWS_H
+
+#include <memory>
+#include <vector>
+
+#include "yb/common/ql_type.h"
+#include "yb/common/ql_value.h"
+
+#include "yb/gutil/endian.h"
+
+#include "yb/util/faststring.h"
+#include "yb/util/result.h"
+#include "yb/util/slice.h"
+
+namespace yb {
+
+// Size of values of the given type in the columnar encoding, or 0 if values of this type are
+// stored with offsets. Timestamps are stored as internal microseconds.
+size_t QLColumnarFixedWidth(DataType type);
+
+// Accumulates rows column by column and produces the columnar rows data.
+class QLColumnarRowsEncoder {
+ public:
+  explicit QLColumnarRowsEncoder(std::vector<std::shared_ptr<QLType>> types);
+
+  void AddRow(const std::vector<QLValue>& values);
+
+  // Appends encoded rows to buffer.
+  void Finish(faststring* buffer) const;
+
+ private:
+  struct Column {
+    std::vector<bool> nulls;
+    std::vector<uint32_t> offsets;
+    faststring data;
+  };
+
+  std::vector<std::shared_ptr<QLType>> types_;
+  std::vector<Column> columns_;
+  size_t row_count_ = 0;
+};
+
+// View of a single column of columnar rows data. Refers to the decoded buffer, that should outlive
+// it, values are only copied when accessed.
+class QLColumnarColumnView {
+ public:
+  QLColumnarColumnView(std::shared_ptr<QLType> type, size_t row_count)
+      : type_(std::move(type)), row_count_(row_count) {}
+
+  const std::shared_ptr<QLType>& type() const { return type_; }
+
+  bool IsNull(size_t row) const {
+    return (nulls_[row >> 3] >> (row & 7)) & 1;
+  }
+
+  // Value of a fixed-width column, T should match QLColumnarFixedWidth of the column type.
+  template <class T>
+  T fixed_value(size_t row) const {
+    DCHECK_EQ(sizeof(T), fixed_width_);
+    T result;
+    memcpy(&result, values_ + row * sizeof(T), sizeof(T));
+    return result;
+  }
+
+  // CQL serialized value of a variable-width column, without the length prefix. For string and
+  // binary columns these are the value bytes.
+  Slice value_bytes(size_t row) const;
+
+  // Fills value with the value of the given row, works for columns of any type.
+  CHECKED_STATUS GetValue(size_t row, QLValue* value) const;
+
+ private:
+  friend class QLColumnarRowsView;
+
+  uint32_t offset(size_t row) const {
+    return LittleEndian::Load32(offsets_ + row * sizeof(uint32_t));
+  }
+
+  // Parses the column from the beginning of data and removes it from data.
+  CHECKED_STATUS Decode(Slice* data);
+
+  std::shared_ptr<QLType> type_;
+  size_t row_count_;
+  size_t fixed_width_ = 0;
+  const uint8_t* nulls_ = nullptr;
+  const uint8_t* values_ = nullptr;
+  const uint8_t* offsets_ = nullptr;
+};
+
+// Decoded columnar rows data.
+class QLColumnarRowsView {
+ public:
+  // Parses data encoded by QLColumnarRowsEncoder for columns of the given types.
+  static Result<QLColumnarRowsView> Decode(
+      const std::vector<std::shared_ptr<QLType>>& types, const Slice& data);
+
+  size_t row_count() const { return row_count_; }
+
+  size_t column_count() const { return columns_.size(); }
+
+  const QLColumnarColumnView& column(size_t idx) const { return columns_[idx]; }
+
+ private:
+  size_t row_count_ = 0;
+  std::vector<QLColumnarColumnView> columns_;
+};
+
+} // namespace yb
+
+#endif // YB_COMMON_QL_COLUMNAR_ROWS_H
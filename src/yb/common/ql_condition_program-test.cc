@@ -0,0 +1,233 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <gtest/gtest.h>
+
+#include "yb/common/ql_condition_program.h"
+
+#include "yb/util/monotime.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+
+namespace {
+
+constexpr ColumnIdRep kIntColumn = 10;
+constexpr ColumnIdRep kBigIntColumn = 11;
+constexpr ColumnIdRep kTextColumn = 12;
+constexpr ColumnIdRep kTimestampColumn = 13;
+constexpr ColumnIdRep kMissingColumn = 14;
+
+void AddColumn(QLConditionPB* condition, ColumnIdRep column_id) {
+  condition->add_operands()->set_column_id(column_id);
+}
+
+QLValuePB* AddValue(QLConditionPB* condition) {
+  return condition->add_operands()->mutable_value();
+}
+
+QLConditionPB* AddCondition(QLConditionPB* condition, QLOperator op) {
+  auto* result = condition->add_operands()->mutable_condition();
+  result->set_op(op);
+  return result;
+}
+
+// Build conditions covering the compiled operators.
+std::vector<QLConditionPB> MakeConditions() {
+  std::vector<QLConditionPB> conditions;
+  for (const auto op : {QL_OP_EQUAL, QL_OP_NOT_EQUAL, QL_OP_LESS_THAN, QL_OP_LESS_THAN_EQUAL,
+                        QL_OP_GREATER_THAN, QL_OP_GREATER_THAN_EQUAL}) {
+    QLConditionPB condition;
+    condition.set_op(op);
+    AddColumn(&condition, kIntColumn);
+    AddValue(&condition)->set_int32_value(5);
+    conditions.push_back(condition);
+
+    // Constant first.
+    condition.Clear();
+    condition.set_op(op);
+    AddValue(&condition)->set_int64_value(7);
+    AddColumn(&condition, kBigIntColumn);
+    conditions.push_back(condition);
+
+    condition.Clear();
+    condition.set_op(op);
+    AddColumn(&condition, kTextColumn);
+    AddValue(&condition)->set_string_value("m");
+    conditions.push_back(condition);
+
+    condition.Clear();
+    condition.set_op(op);
+    AddColumn(&condition, kTimestampColumn);
+    AddValue(&condition)->set_timestamp_value(1000);
+    conditions.push_back(condition);
+
+    // Generic comparison of a missing column.
+    condition.Clear();
+    condition.set_op(op);
+    AddColumn(&condition, kMissingColumn);
+    AddColumn(&condition, kIntColumn);
+    conditions.push_back(condition);
+  }
+
+  for (const auto op : {QL_OP_BETWEEN, QL_OP_NOT_BETWEEN}) {
+    QLConditionPB condition;
+    condition.set_op(op);
+    AddColumn(&condition, kIntColumn);
+    AddValue(&condition)->set_int32_value(3);
+    AddValue(&condition)->set_int32_value(6);
+    conditions.push_back(condition);
+  }
+
+  for (const auto op : {QL_OP_IN, QL_OP_NOT_IN}) {
+    QLConditionPB condition;
+    condition.set_op(op);
+    AddColumn(&condition, kTextColumn);
+    auto* list = AddValue(&condition)->mutable_list_value();
+    list->add_elems()->set_string_value("a");
+    list->add_elems()->set_string_value("z");
+    conditions.push_back(condition);
+  }
+
+  for (const auto op : {QL_OP_IS_NULL, QL_OP_IS_NOT_NULL}) {
+    QLConditionPB condition;
+    condition.set_op(op);
+    AddColumn(&condition, kMissingColumn);
+    conditions.push_back(condition);
+  }
+
+  for (const auto op : {QL_OP_EXISTS, QL_OP_NOT_EXISTS}) {
+    QLConditionPB condition;
+    condition.set_op(op);
+    conditions.push_back(condition);
+  }
+
+  // (int > 2 AND (text = 'a' OR NOT bigint < 7)) OR timestamp >= 1000
+  {
+    QLConditionPB condition;
+    condition.set_op(QL_OP_OR);
+    auto* and_condition = AddCondition(&condition, QL_OP_AND);
+    auto* greater = AddCondition(and_condition, QL_OP_GREATER_THAN);
+    AddColumn(greater, kIntColumn);
+    AddValue(greater)->set_int32_value(2);
+    auto* or_condition = AddCondition(and_condition, QL_OP_OR);
+    auto* equal = AddCondition(or_condition, QL_OP_EQUAL);
+    AddColumn(equal, kTextColumn);
+    AddValue(equal)->set_string_value("a");
+    auto* less = AddCondition(AddCondition(or_condition, QL_OP_NOT), QL_OP_LESS_THAN);
+    AddColumn(less, kBigIntColumn);
+    AddValue(less)->set_int64_value(7);
+    auto* greater_equal = AddCondition(&condition, QL_OP_GREATER_THAN_EQUAL);
+    AddColumn(greater_equal, kTimestampColumn);
+    AddValue(greater_equal)->set_timestamp_value(1000);
+    conditions.push_back(condition);
+  }
+  return conditions;
+}
+
+std::vector<QLTableRow> MakeRows() {
+  std::vector<QLTableRow> rows;
+  for (int i = 0; i != 10; ++i) {
+    QLTableRow row;
+    row.AllocColumn(kIntColumn).value.set_int32_value(i);
+    row.AllocColumn(kBigIntColumn).value.set_int64_value(i * 2);
+    row.AllocColumn(kTextColumn).value.set_string_value(std::string(1, 'a' + i * 3));
+    row.AllocColumn(kTimestampColumn).value.set_timestamp_value(i * 250);
+    rows.push_back(row);
+  }
+  // A row with null columns and an empty row.
+  QLTableRow row;
+  row.AllocColumn(kIntColumn);
+  row.AllocColumn(kTextColumn);
+  rows.push_back(row);
+  rows.emplace_back();
+  return rows;
+}
+
+} // namespace
+
+TEST(QLConditionProgramTest, MatchesExprExecutor) {
+  QLExprExecutor executor;
+  const auto rows = MakeRows();
+  for (const auto& condition : MakeConditions()) {
+    QLConditionProgram program;
+    ASSERT_TRUE(program.Compile(condition)) << condition.ShortDebugString();
+    for (const auto& row : rows) {
+      bool expected = false;
+      const Status expected_status = executor.EvalCondition(condition, row, &expected);
+      bool result = false;
+      const Status status = program.Eval(row, &result);
+      ASSERT_EQ(expected_status.ok(), status.ok()) << condition.ShortDebugString();
+      if (status.ok()) {
+        ASSERT_EQ(expected, result) << condition.ShortDebugString();
+      }
+    }
+  }
+}
+
+TEST(QLConditionProgramTest, NotComparable) {
+  QLConditionPB condition;
+  condition.set_op(QL_OP_EQUAL);
+  AddColumn(&condition, kTextColumn);
+  AddValue(&condition)->set_int32_value(1);
+  QLConditionProgram program;
+  ASSERT_TRUE(program.Compile(condition));
+
+  QLTableRow row;
+  row.AllocColumn(kTextColumn).value.set_string_value("a");
+  bool result = false;
+  ASSERT_FALSE(program.Eval(row, &result).ok());
+}
+
+TEST(QLConditionProgramTest, Unsupported) {
+  // Function calls are left to QLExprExecutor.
+  QLConditionPB condition;
+  condition.set_op(QL_OP_EQUAL);
+  condition.add_operands()->mutable_bfcall()->set_opcode(0);
+  AddValue(&condition)->set_int32_value(1);
+  QLConditionProgram program;
+  ASSERT_FALSE(program.Compile(condition));
+  ASSERT_FALSE(program.compiled());
+}
+
+TEST(QLConditionProgramTest, Benchmark) {
+  const auto conditions = MakeConditions();
+  const auto& condition = conditions.back();
+  const auto rows = MakeRows();
+  constexpr int kIterations = 100000;
+
+  QLExprExecutor executor;
+  bool result = false;
+  auto start = MonoTime::Now();
+  for (int i = 0; i != kIterations; ++i) {
+    for (const auto& row : rows) {
+      ASSERT_OK(executor.EvalCondition(condition, row, &result));
+    }
+  }
+  const auto executor_time = MonoTime::Now().GetDeltaSince(start);
+
+  QLConditionProgram program;
+  ASSERT_TRUE(program.Compile(condition));
+  start = MonoTime::Now();
+  for (int i = 0; i != kIterations; ++i) {
+    for (const auto& row : rows) {
+      ASSERT_OK(program.Eval(row, &result));
+    }
+  }
+  const auto program_time = MonoTime::Now().GetDeltaSince(start);
+  LOG(INFO) << "Evaluated " << kIterations * rows.size() << " rows, executor: " << executor_time
+            << ", compiled program: " << program_time;
+}
+
+} // namespace yb
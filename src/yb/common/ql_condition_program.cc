@@ -0,0 +1,395 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/common/ql_condition_program.h"
+
+namespace yb {
+
+namespace {
+
+// Relational operator to use when the operands of a comparison are swapped.
+template <class Relation>
+Relation Mirror(Relation relation) {
+  switch (relation) {
+    case Relation::kLess: return Relation::kGreater;
+    case Relation::kLessEqual: return Relation::kGreaterEqual;
+    case Relation::kGreater: return Relation::kLess;
+    case Relation::kGreaterEqual: return Relation::kLessEqual;
+    case Relation::kEqual: FALLTHROUGH_INTENDED;
+    case Relation::kNotEqual:
+      return relation;
+  }
+  return relation;
+}
+
+Status NotComparable() {
+  return STATUS(RuntimeError, "values not comparable");
+}
+
+} // namespace
+
+bool QLConditionProgram::Compile(const QLConditionPB& condition) {
+  instructions_.clear();
+  if (!CompileCondition(condition, 0)) {
+    instructions_.clear();
+    return false;
+  }
+  return true;
+}
+
+bool QLConditionProgram::CompileCondition(const QLConditionPB& condition, const size_t depth) {
+  if (depth >= kMaxDepth) {
+    return false;
+  }
+
+  Instruction instruction;
+  const auto& operands = condition.operands();
+  switch (condition.op()) {
+    case QL_OP_NOT:
+      if (operands.size() != 1 ||
+          operands.Get(0).expr_case() != QLExpressionPB::ExprCase::kCondition ||
+          !CompileCondition(operands.Get(0).condition(), depth + 1)) {
+        return false;
+      }
+      instruction.opcode = Opcode::kNot;
+      instructions_.push_back(instruction);
+      return true;
+
+    case QL_OP_IS_NULL:
+      instruction.opcode = Opcode::kIsNull;
+      break;
+    case QL_OP_IS_NOT_NULL:
+      instruction.opcode = Opcode::kIsNotNull;
+      break;
+    case QL_OP_IS_TRUE:
+      instruction.opcode = Opcode::kIsTrue;
+      break;
+    case QL_OP_IS_FALSE:
+      instruction.opcode = Opcode::kIsFalse;
+      break;
+
+    case QL_OP_EQUAL:
+      return CompileComparison(condition, Relation::kEqual);
+    case QL_OP_LESS_THAN:
+      return CompileComparison(condition, Relation::kLess);
+    case QL_OP_LESS_THAN_EQUAL:
+      return CompileComparison(condition, Relation::kLessEqual);
+    case QL_OP_GREATER_THAN:
+      return CompileComparison(condition, Relation::kGreater);
+    case QL_OP_GREATER_THAN_EQUAL:
+      return CompileComparison(condition, Relation::kGreaterEqual);
+    case QL_OP_NOT_EQUAL:
+      return CompileComparison(condition, Relation::kNotEqual);
+
+    case QL_OP_AND: FALLTHROUGH_INTENDED;
+    case QL_OP_OR: {
+      if (operands.size() == 0) {
+        return false;
+      }
+      // Evaluate the operands in turn, jumping to the end of the condition as soon as one of them
+      // decides its result.
+      std::vector<size_t> jumps;
+      for (int i = 0; i != operands.size(); ++i) {
+        const auto& operand = operands.Get(i);
+        if (operand.expr_case() != QLExpressionPB::ExprCase::kCondition ||
+            !CompileCondition(operand.condition(), depth + 1)) {
+          return false;
+        }
+        if (i + 1 != operands.size()) {
+          jumps.push_back(instructions_.size());
+          instruction.opcode = condition.op() == QL_OP_AND ? Opcode::kJumpIfFalse
+                                                           : Opcode::kJumpIfTrue;
+          instructions_.push_back(instruction);
+        }
+      }
+      for (const auto jump : jumps) {
+        instructions_[jump].target = instructions_.size();
+      }
+      return true;
+    }
+
+    case QL_OP_BETWEEN:
+      instruction.opcode = Opcode::kBetween;
+      if (!CompileOperands(condition, 3, &instruction)) {
+        return false;
+      }
+      instructions_.push_back(instruction);
+      return true;
+    case QL_OP_NOT_BETWEEN:
+      instruction.opcode = Opcode::kNotBetween;
+      if (!CompileOperands(condition, 3, &instruction)) {
+        return false;
+      }
+      instructions_.push_back(instruction);
+      return true;
+
+    case QL_OP_EXISTS:
+      instruction.opcode = Opcode::kExists;
+      instructions_.push_back(instruction);
+      return true;
+    case QL_OP_NOT_EXISTS:
+      instruction.opcode = Opcode::kNotExists;
+      instructions_.push_back(instruction);
+      return true;
+
+    case QL_OP_IN:
+      instruction.opcode = Opcode::kIn;
+      if (!CompileOperands(condition, 2, &instruction)) {
+        return false;
+      }
+      instructions_.push_back(instruction);
+      return true;
+    case QL_OP_NOT_IN:
+      instruction.opcode = Opcode::kNotIn;
+      if (!CompileOperands(condition, 2, &instruction)) {
+        return false;
+      }
+      instructions_.push_back(instruction);
+      return true;
+
+    default:
+      // LIKE and unknown operators are left to QLExprExecutor, which reports them.
+      return false;
+  }
+
+  // Null and boolean checks of one operand.
+  if (!CompileOperands(condition, 1, &instruction)) {
+    return false;
+  }
+  instructions_.push_back(instruction);
+  return true;
+}
+
+bool QLConditionProgram::CompileComparison(const QLConditionPB& condition,
+                                           const Relation relation) {
+  Instruction instruction;
+  instruction.opcode = Opcode::kCompare;
+  instruction.relation = relation;
+  if (!CompileOperands(condition, 2, &instruction)) {
+    return false;
+  }
+
+  // Put the column first to compare a column with a constant with a type-specialized instruction.
+  auto& operands = instruction.operands;
+  if (operands[0].value != nullptr && operands[1].value == nullptr) {
+    std::swap(operands[0], operands[1]);
+    instruction.relation = Mirror(relation);
+  }
+  if (operands[0].value == nullptr && operands[1].value != nullptr) {
+    switch (operands[1].value->value_case()) {
+      case QLValuePB::kInt32Value:
+        instruction.opcode = Opcode::kCompareInt32;
+        break;
+      case QLValuePB::kInt64Value:
+        instruction.opcode = Opcode::kCompareInt64;
+        break;
+      case QLValuePB::kStringValue:
+        instruction.opcode = Opcode::kCompareString;
+        break;
+      case QLValuePB::kTimestampValue:
+        instruction.opcode = Opcode::kCompareTimestamp;
+        break;
+      default:
+        break;
+    }
+  }
+  instructions_.push_back(instruction);
+  return true;
+}
+
+bool QLConditionProgram::CompileOperands(const QLConditionPB& condition, const int num_operands,
+                                         Instruction* instruction) {
+  DCHECK_LE(static_cast<size_t>(num_operands), kMaxOperands);
+  if (condition.operands_size() != num_operands) {
+    return false;
+  }
+  for (int i = 0; i != num_operands; ++i) {
+    const auto& expr = condition.operands(i);
+    switch (expr.expr_case()) {
+      case QLExpressionPB::ExprCase::kValue:
+        instruction->operands[i].value = &expr.value();
+        break;
+      case QLExpressionPB::ExprCase::kColumnId:
+        instruction->operands[i].column_id = expr.column_id();
+        break;
+      default:
+        return false;
+    }
+  }
+  return true;
+}
+
+const QLValuePB& QLConditionProgram::OperandValue(const Operand& operand,
+                                                  const QLTableRow& table_row) {
+  if (operand.value != nullptr) {
+    return *operand.value;
+  }
+  // A column missing from the row reads as null.
+  const QLValuePB* value = table_row.GetColumn(operand.column_id);
+  return value != nullptr ? *value : QLValuePB::default_instance();
+}
+
+bool QLConditionProgram::Compare(const QLValuePB& lhs, const QLValuePB& rhs,
+                                 const Relation relation) {
+  switch (relation) {
+    case Relation::kEqual: return lhs == rhs;
+    case Relation::kNotEqual: return lhs != rhs;
+    case Relation::kLess: return lhs < rhs;
+    case Relation::kLessEqual: return lhs <= rhs;
+    case Relation::kGreater: return lhs > rhs;
+    case Relation::kGreaterEqual: return lhs >= rhs;
+  }
+  FATAL_INVALID_ENUM_VALUE(Relation, relation);
+}
+
+template <class T>
+bool QLConditionProgram::Compare(const T& lhs, const T& rhs, const Relation relation) {
+  switch (relation) {
+    case Relation::kEqual: return lhs == rhs;
+    case Relation::kNotEqual: return lhs != rhs;
+    case Relation::kLess: return lhs < rhs;
+    case Relation::kLessEqual: return lhs <= rhs;
+    case Relation::kGreater: return lhs > rhs;
+    case Relation::kGreaterEqual: return lhs >= rhs;
+  }
+  FATAL_INVALID_ENUM_VALUE(Relation, relation);
+}
+
+Status QLConditionProgram::Eval(const QLTableRow& table_row, bool* result) const {
+  // Type-specialized comparison of a column with a constant. Comparisons with null are false as in
+  // the generic comparison.
+#define QL_EVALUATE_TYPED_COMPARISON(expected_case, getter)                                        \
+  do {                                                                                             \
+    const QLValuePB* column = table_row.GetColumn(instruction.operands[0].column_id);              \
+    if (column == nullptr || IsNull(*column)) {                                                    \
+      reg = false;                                                                                 \
+    } else if (PREDICT_FALSE(column->value_case() != QLValuePB::expected_case)) {                  \
+      return NotComparable();                                                                      \
+    } else {                                                                                       \
+      reg = Compare(column->getter(), instruction.operands[1].value->getter(),                    \
+                    instruction.relation);                                                         \
+    }                                                                                              \
+  } while (false)
+
+  bool reg = false;
+  const size_t size = instructions_.size();
+  size_t pc = 0;
+  while (pc != size) {
+    const Instruction& instruction = instructions_[pc];
+    switch (instruction.opcode) {
+      case Opcode::kCompare: {
+        const auto& lhs = OperandValue(instruction.operands[0], table_row);
+        const auto& rhs = OperandValue(instruction.operands[1], table_row);
+        if (!Comparable(lhs, rhs)) {
+          return NotComparable();
+        }
+        reg = Compare(lhs, rhs, instruction.relation);
+        break;
+      }
+
+      case Opcode::kCompareInt32:
+        QL_EVALUATE_TYPED_COMPARISON(kInt32Value, int32_value);
+        break;
+      case Opcode::kCompareInt64:
+        QL_EVALUATE_TYPED_COMPARISON(kInt64Value, int64_value);
+        break;
+      case Opcode::kCompareString:
+        QL_EVALUATE_TYPED_COMPARISON(kStringValue, string_value);
+        break;
+      case Opcode::kCompareTimestamp:
+        QL_EVALUATE_TYPED_COMPARISON(kTimestampValue, timestamp_value);
+        break;
+
+      case Opcode::kBetween: FALLTHROUGH_INTENDED;
+      case Opcode::kNotBetween: {
+        const auto& value = OperandValue(instruction.operands[0], table_row);
+        const auto& lower = OperandValue(instruction.operands[1], table_row);
+        const auto& upper = OperandValue(instruction.operands[2], table_row);
+        if (!Comparable(value, lower) || !Comparable(value, upper)) {
+          return NotComparable();
+        }
+        reg = instruction.opcode == Opcode::kBetween ? value >= lower && value <= upper
+                                                     : value < lower || value > upper;
+        break;
+      }
+
+      case Opcode::kIn: FALLTHROUGH_INTENDED;
+      case Opcode::kNotIn: {
+        const auto& left = OperandValue(instruction.operands[0], table_row);
+        const auto& right = OperandValue(instruction.operands[1], table_row);
+        bool found = false;
+        for (const QLValuePB& elem : right.list_value().elems()) {
+          if (!Comparable(elem, left)) {
+            return NotComparable();
+          }
+          if (elem == left) {
+            found = true;
+            break;
+          }
+        }
+        reg = instruction.opcode == Opcode::kIn ? found : !found;
+        break;
+      }
+
+      case Opcode::kIsNull:
+        reg = IsNull(OperandValue(instruction.operands[0], table_row));
+        break;
+      case Opcode::kIsNotNull:
+        reg = !IsNull(OperandValue(instruction.operands[0], table_row));
+        break;
+
+      case Opcode::kIsTrue: FALLTHROUGH_INTENDED;
+      case Opcode::kIsFalse: {
+        const auto& value = OperandValue(instruction.operands[0], table_row);
+        if (value.value_case() != QLValuePB::kBoolValue) {
+          return STATUS(RuntimeError, "not a bool value");
+        }
+        reg = instruction.opcode == Opcode::kIsTrue ? value.bool_value() : !value.bool_value();
+        break;
+      }
+
+      // When a row exists, the primary key columns are always populated in the row, so the row
+      // exists if and only if it is not empty.
+      case Opcode::kExists:
+        reg = !table_row.IsEmpty();
+        break;
+      case Opcode::kNotExists:
+        reg = table_row.IsEmpty();
+        break;
+
+      case Opcode::kNot:
+        reg = !reg;
+        break;
+
+      case Opcode::kJumpIfFalse:
+        if (!reg) {
+          pc = instruction.target;
+          continue;
+        }
+        break;
+      case Opcode::kJumpIfTrue:
+        if (reg) {
+          pc = instruction.target;
+          continue;
+        }
+        break;
+    }
+    ++pc;
+  }
+  *result = reg;
+  return Status::OK();
+
+#undef QL_EVALUATE_TYPED_COMPARISON
+}
+
+} // namespace yb
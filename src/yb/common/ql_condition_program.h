@@ -0,0 +1,132 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+// A QL condition compiled into a flat program, so that a WHERE or IF condition that is evaluated
+// for many rows is walked as a protobuf tree only once. The program is a sequence of instructions
+// over a single boolean register: comparisons, null checks and IN set it, NOT negates it and AND /
+// OR are short-circuited with conditional jumps on it. Operands are either columns of the row or
+// constants in the condition, which are compared in place without being copied.
+// Comparisons of a column with an int32, int64, string or timestamp constant use type-specialized
+// instructions.
+//
+// Only conditions over columns and constants are compiled. Conditions with function calls,
+// subscripted columns or nested expressions are rejected by Compile() and should be evaluated by
+// QLExprExecutor. The compiled condition refers to the constants of the QLConditionPB, which must
+// outlive the program.
+
+#ifndef YB_COMMON_QL_CONDITION_PROGRAM_H_
+#define YB_COMMON_QL_CONDITION_PROGRAM_H_
+
+#include <vector>
+
+#include "yb/common/ql_expr.h"
+
+namespace yb {
+
+class QLConditionProgram {
+ public:
+  QLConditionProgram() = default;
+
+  QLConditionProgram(const QLConditionProgram&) = delete;
+  void operator=(const QLConditionProgram&) = delete;
+
+  // Compile the condition. Returns false if the condition has expressions that are not supported,
+  // in which case the program is left empty.
+  bool Compile(const QLConditionPB& condition);
+
+  // Whether a condition was compiled.
+  bool compiled() const {
+    return !instructions_.empty();
+  }
+
+  // Evaluate the compiled condition for the given row. Evaluates to the same result as
+  // QLExprExecutor::EvalCondition(), including errors for values that are not comparable.
+  CHECKED_STATUS Eval(const QLTableRow& table_row, bool* result) const;
+
+ private:
+  enum class Opcode : uint8_t {
+    // Generic comparison of two operands with a relational operator.
+    kCompare,
+    // Comparisons of a column with a constant of a specific type.
+    kCompareInt32,
+    kCompareInt64,
+    kCompareString,
+    kCompareTimestamp,
+    kBetween,
+    kNotBetween,
+    kIn,
+    kNotIn,
+    kIsNull,
+    kIsNotNull,
+    kIsTrue,
+    kIsFalse,
+    kExists,
+    kNotExists,
+    kNot,
+    // Jump to the target if the register is false (true).
+    kJumpIfFalse,
+    kJumpIfTrue,
+  };
+
+  // Relational operator of comparisons.
+  enum class Relation : uint8_t {
+    kEqual,
+    kNotEqual,
+    kLess,
+    kLessEqual,
+    kGreater,
+    kGreaterEqual,
+  };
+
+  // Column of the row or constant.
+  struct Operand {
+    // Constant value, nullptr for a column.
+    const QLValuePB* value = nullptr;
+    ColumnIdRep column_id = 0;
+  };
+
+  static constexpr size_t kMaxOperands = 3;
+
+  struct Instruction {
+    Opcode opcode;
+    Relation relation = Relation::kEqual;
+    // Jump target of jumps.
+    size_t target = 0;
+    Operand operands[kMaxOperands];
+  };
+
+  // Max nesting depth of conditions to compile.
+  static constexpr size_t kMaxDepth = 64;
+
+  // Compile the condition at the nesting depth, appending its instructions to the program.
+  bool CompileCondition(const QLConditionPB& condition, size_t depth);
+
+  // Compile the relational operator comparing the operands.
+  bool CompileComparison(const QLConditionPB& condition, Relation relation);
+
+  // Compile the operands of the condition into the instruction. Fails unless the condition has
+  // 'num_operands' operands that are columns or constants.
+  bool CompileOperands(const QLConditionPB& condition, int num_operands, Instruction* instruction);
+
+  static const QLValuePB& OperandValue(const Operand& operand, const QLTableRow& table_row);
+
+  static bool Compare(const QLValuePB& lhs, const QLValuePB& rhs, Relation relation);
+
+  template <class T>
+  static bool Compare(const T& lhs, const T& rhs, Relation relation);
+
+  std::vector<Instruction> instructions_;
+};
+
+} // namespace yb
+
+#endif // YB_COMMON_QL_CONDITION_PROGRAM_H_
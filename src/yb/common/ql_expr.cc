@@ -322,6 +322,14 @@ CHECKED_STATUS QLTableRow::ReadColumn(ColumnIdRep col_id, QLValue *col_value) co
   return Status::OK();
 }
 
+const QLValuePB* QLTableRow::GetColumn(ColumnIdRep col_id) const {
+  const auto& col_iter = col_map_.find(col_id);
+  if (col_iter == col_map_.end()) {
+    return nullptr;
+  }
+  return &col_iter->second.value;
+}
+
 CHECKED_STATUS QLTableRow::ReadSubscriptedColumn(const QLSubscriptedColPB& subcol,
                                                  const QLValue& index_arg,
                                                  QLValue *col_value) const {
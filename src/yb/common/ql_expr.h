@@ -87,6 +87,10 @@ class QLTableRow {
     return GetValue(col.rep(), column);
   }
 
+  // Get a pointer to the cached column value without copying it. Returns nullptr if the column is
+  // not in the row.
+  const QLValuePB* GetColumn(ColumnIdRep col_id) const;
+
   // Get the column value in PB format.
   CHECKED_STATUS ReadColumn(ColumnIdRep col_id, QLValue *col_value) const;
   CHECKED_STATUS ReadSubscriptedColumn(const QLSubscriptedColPB& subcol,
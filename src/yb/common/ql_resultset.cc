@@ -3,6 +3,7 @@
 //--------------------------------------------------------------------------------------------------
 
 #include "yb/common/ql_resultset.h"
+#include "yb/common/ql_columnar_rows.h"
 #include "yb/common/wire_protocol.h"
 
 namespace yb {
@@ -15,7 +16,7 @@ namespace yb {
 QLRSRowDesc::QLRSRowDesc(const QLRSRowDescPB& desc_pb) {
   int count = desc_pb.rscol_descs().size();
   rscol_descs_.reserve(count);
-  for (auto rscol_desc_pb : desc_pb.rscol_descs()) {
+  for (const auto& rscol_desc_pb : desc_pb.rscol_descs()) {
     rscol_descs_.emplace_back(rscol_desc_pb.name(),
                               QLType::FromQLTypePB(rscol_desc_pb.ql_type()));
   }
@@ -39,7 +40,7 @@ CHECKED_STATUS QLRSRow::CQLSerialize(const QLClient& client,
   DCHECK_EQ(count, rscol_count()) << "Wrong count of fields in result set";
 
   int idx = 0;
-  for (auto rscol_desc : rsrow_desc.rscol_descs()) {
+  for (const auto& rscol_desc : rsrow_desc.rscol_descs()) {
     rscols_[idx].Serialize(rscol_desc.ql_type(), client, buffer);
     idx++;
   }
@@ -69,4 +70,17 @@ CHECKED_STATUS QLResultSet::CQLSerialize(const QLClient& client,
   return Status::OK();
 }
 
+void QLResultSet::ColumnarSerialize(const QLRSRowDesc& rsrow_desc, faststring* buffer) const {
+  std::vector<std::shared_ptr<QLType>> types;
+  types.reserve(rsrow_desc.rscol_count());
+  for (const auto& rscol_desc : rsrow_desc.rscol_descs()) {
+    types.push_back(rscol_desc.ql_type());
+  }
+  QLColumnarRowsEncoder encoder(std::move(types));
+  for (const auto& rsrow : rsrows_) {
+    encoder.AddRow(rsrow.rscols());
+  }
+  encoder.Finish(buffer);
+}
+
 } // namespace yb
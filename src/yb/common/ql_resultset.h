@@ -33,10 +33,10 @@ class QLRSRowDesc {
     RSColDesc(const string& name, const QLType::SharedPtr& ql_type)
         : name_(name), ql_type_(ql_type) {
     }
-    const string& name() {
+    const string& name() const {
       return name_;
     }
-    const QLType::SharedPtr& ql_type() {
+    const QLType::SharedPtr& ql_type() const {
       return ql_type_;
     }
    private:
@@ -108,6 +108,9 @@ class QLResultSet {
                               const QLRSRowDesc& rsrow_desc,
                               faststring* buffer) const;
 
+  // Serialization routine with the columnar encoding format, see ql_columnar_rows.h.
+  void ColumnarSerialize(const QLRSRowDesc& rsrow_desc, faststring* buffer) const;
+
  private:
   std::vector<QLRSRow> rsrows_;
 };
@@ -21,6 +21,8 @@
 #include "yb/common/ql_value.h"
 #include "yb/common/schema.h"
 
+#include "yb/util/ref_cnt_buffer.h"
+
 namespace yb {
 
 //------------------------------------------ QL row ----------------------------------------
@@ -114,10 +116,11 @@ class QLRowBlock {
 
   //-------------------------- utility functions for rows data ------------------------------
   // Return row count.
-  static CHECKED_STATUS GetRowCount(QLClient client, const std::string& data, size_t* count);
+  static CHECKED_STATUS GetRowCount(QLClient client, const Slice& data, size_t* count);
 
-  // Append rows data. Caller should ensure the column schemas are the same.
-  static CHECKED_STATUS AppendRowsData(QLClient client, const std::string& src, std::string* dst);
+  // Append rows data. Caller should ensure the column schemas are the same. Buffers could be
+  // shared, so 'dst' is replaced with a new buffer instead of being modified.
+  static CHECKED_STATUS AppendRowsData(QLClient client, const RefCntBuffer& src, RefCntBuffer* dst);
 
  private:
   // Schema of the selected columns. (Note: this schema has no key column definitions)
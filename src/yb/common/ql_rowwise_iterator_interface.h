@@ -61,6 +61,9 @@ class QLRowwiseIteratorIf {
 
   virtual const Schema& schema() const = 0;
 
+  // Adds statistics of the storage reads done by this iterator to stats.
+  virtual void AddReadStats(QLReadStatsPB* stats) const {}
+
  private:
   virtual CHECKED_STATUS DoNextRow(const Schema& projection, QLTableRow* table_row) = 0;
 };
@@ -15,6 +15,16 @@
 
 #include "yb/common/ql_scanspec.h"
 
+#include <gflags/gflags.h>
+
+#include "yb/util/flag_tags.h"
+
+DEFINE_bool(ql_compile_scan_conditions, true,
+            "Compile WHERE conditions of QL scans once per scan instead of walking the condition "
+            "protobuf for every row.");
+TAG_FLAG(ql_compile_scan_conditions, advanced);
+TAG_FLAG(ql_compile_scan_conditions, runtime);
+
 namespace yb {
 namespace common {
 
@@ -298,10 +308,16 @@ QLScanSpec::QLScanSpec(const QLConditionPB* condition,
   if (executor_ == nullptr) {
     executor_ = std::make_shared<QLExprExecutor>();
   }
+  if (condition_ != nullptr && FLAGS_ql_compile_scan_conditions) {
+    condition_program_.Compile(*condition_);
+  }
 }
 
 // Evaluate the WHERE condition for the given row.
 CHECKED_STATUS QLScanSpec::Match(const QLTableRow& table_row, bool* match) const {
+  if (condition_program_.compiled()) {
+    return condition_program_.Eval(table_row, match);
+  }
   if (condition_ != nullptr) {
     return executor_->EvalCondition(*condition_, table_row, match);
   }
@@ -21,6 +21,7 @@
 #include "yb/common/schema.h"
 #include "yb/common/ql_protocol.pb.h"
 #include "yb/common/ql_rowblock.h"
+#include "yb/common/ql_condition_program.h"
 #include "yb/common/ql_expr.h"
 
 namespace yb {
@@ -83,6 +84,9 @@ class QLScanSpec {
   const QLConditionPB* condition_;
   const bool is_forward_scan_;
   QLExprExecutor::SharedPtr executor_;
+
+  // The condition compiled once for the scan, if it could be compiled.
+  QLConditionProgram condition_program_;
 };
 
 } // namespace common
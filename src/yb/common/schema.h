@@ -351,19 +351,22 @@ class TableProperties {
       : default_time_to_live_(kNoDefaultTtl),
         contain_counters_(false),
         is_transactional_(false),
-        copartition_table_id_(kNoCopartitionTableId) {}
+        copartition_table_id_(kNoCopartitionTableId),
+        bloom_filter_range_components_(0) {}
 
   TableProperties(const TableProperties& other) {
     default_time_to_live_ = other.default_time_to_live_;
     contain_counters_ = other.contain_counters_;
     is_transactional_ = other.is_transactional_;
     copartition_table_id_ = other.copartition_table_id_;
+    bloom_filter_range_components_ = other.bloom_filter_range_components_;
   }
 
   // Containing counters is a internal property instead of a user-defined property, so we don't use
   // it when comparing table properties.
   bool operator==(const TableProperties& other) const {
-    return (default_time_to_live_ == other.default_time_to_live_);
+    return default_time_to_live_ == other.default_time_to_live_ &&
+           bloom_filter_range_components_ == other.bloom_filter_range_components_;
   }
 
   bool operator!=(const TableProperties& other) const {
@@ -410,6 +413,16 @@ class TableProperties {
     copartition_table_id_ = copartition_table_id;
   }
 
+  // Number of range components of the key, that are taken into account by the bloom filter in
+  // addition to hashed components.
+  uint32_t bloom_filter_range_components() const {
+    return bloom_filter_range_components_;
+  }
+
+  void SetBloomFilterRangeComponents(uint32_t bloom_filter_range_components) {
+    bloom_filter_range_components_ = bloom_filter_range_components;
+  }
+
   void ToTablePropertiesPB(TablePropertiesPB *pb) const {
     if (HasDefaultTimeToLive()) {
       pb->set_default_time_to_live(default_time_to_live_);
@@ -419,6 +432,9 @@ class TableProperties {
     if (HasCopartitionTableId()) {
       pb->set_copartition_table_id(copartition_table_id_);
     }
+    if (bloom_filter_range_components_ != 0) {
+      pb->set_bloom_filter_range_components(bloom_filter_range_components_);
+    }
   }
 
   static TableProperties FromTablePropertiesPB(const TablePropertiesPB& pb) {
@@ -435,6 +451,9 @@ class TableProperties {
     if (pb.has_copartition_table_id()) {
       table_properties.SetCopartitionTableId(pb.copartition_table_id());
     }
+    if (pb.has_bloom_filter_range_components()) {
+      table_properties.SetBloomFilterRangeComponents(pb.bloom_filter_range_components());
+    }
     return table_properties;
   }
 
@@ -448,6 +467,9 @@ class TableProperties {
     if (pb.has_copartition_table_id()) {
       SetCopartitionTableId(pb.copartition_table_id());
     }
+    if (pb.has_bloom_filter_range_components()) {
+      SetBloomFilterRangeComponents(pb.bloom_filter_range_components());
+    }
   }
 
   void Reset() {
@@ -455,6 +477,7 @@ class TableProperties {
     contain_counters_ = false;
     is_transactional_ = false;
     copartition_table_id_ = kNoCopartitionTableId;
+    bloom_filter_range_components_ = 0;
   }
 
  private:
@@ -463,6 +486,7 @@ class TableProperties {
   bool contain_counters_;
   bool is_transactional_;
   TableId copartition_table_id_;
+  uint32_t bloom_filter_range_components_;
 };
 
 // The schema for a set of rows.
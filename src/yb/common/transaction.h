@@ -107,18 +107,31 @@ class TransactionStatusManager {
   virtual boost::optional<TransactionMetadata> Metadata(const TransactionId& id) = 0;
 
   virtual void Abort(const TransactionId& id, TransactionStatusCallback callback) = 0;
+
+  // Blocks until state of some transaction known to this manager changes, e.g. it is applied or
+  // new status is received, or until deadline passes. Spurious wake ups are allowed.
+  virtual void WaitForTransactionsChange(MonoTime deadline) {
+    auto now = MonoTime::Now();
+    if (deadline > now) {
+      SleepFor(deadline - now);
+    }
+  }
 };
 
 struct TransactionOperationContext {
   TransactionOperationContext(
-      const TransactionId& transaction_id_, TransactionStatusManager* txn_status_manager_)
+      const TransactionId& transaction_id_, TransactionStatusManager* txn_status_manager_,
+      rocksdb::DB* intents_db_ = nullptr)
       : transaction_id(transaction_id_),
-        txn_status_manager(*(DCHECK_NOTNULL(txn_status_manager_))) {}
+        txn_status_manager(*(DCHECK_NOTNULL(txn_status_manager_))),
+        intents_db(intents_db_) {}
 
   bool transactional() const;
 
   TransactionId transaction_id;
   TransactionStatusManager& txn_status_manager;
+  // RocksDB that stores intents, null when intents are stored together with regular records.
+  rocksdb::DB* intents_db;
 };
 
 typedef boost::optional<TransactionOperationContext> TransactionOperationContextOpt;
@@ -36,6 +36,7 @@
 #include <map>
 #include <memory>
 #include <mutex>
+#include <random>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -431,16 +432,61 @@ class TestPeerMapManager {
 };
 
 
+// Network conditions emulated by LocalTestPeerProxy.
+struct SimulatedNetworkOptions {
+  // Round trip time, split evenly between the request and the response.
+  MonoDelta rtt = MonoDelta::kZero;
+
+  // Every one-way delay is extended by a uniformly distributed value up to this.
+  MonoDelta jitter = MonoDelta::kZero;
+
+  // Probability that a request is lost. A lost request fails with a communication error after
+  // a full round trip, so the leader retries it.
+  double loss_probability = 0;
+};
+
+// Network shared by the proxies of a test config. Options may be changed while the config runs.
+class SimulatedNetwork {
+ public:
+  void SetOptions(const SimulatedNetworkOptions& options) {
+    std::lock_guard<simple_spinlock> lock(lock_);
+    options_ = options;
+  }
+
+  MonoDelta OneWayDelay() {
+    std::lock_guard<simple_spinlock> lock(lock_);
+    int64_t delay_us = options_.rtt.ToMicroseconds() / 2;
+    if (options_.jitter.ToMicroseconds() > 0) {
+      delay_us += std::uniform_int_distribution<int64_t>(
+          0, options_.jitter.ToMicroseconds())(random_);
+    }
+    return MonoDelta::FromMicroseconds(delay_us);
+  }
+
+  bool ShouldDrop() {
+    std::lock_guard<simple_spinlock> lock(lock_);
+    return options_.loss_probability > 0 &&
+           std::uniform_real_distribution<double>()(random_) < options_.loss_probability;
+  }
+
+ private:
+  simple_spinlock lock_;
+  SimulatedNetworkOptions options_;
+  std::mt19937_64 random_;
+};
+
 // Allows to test remote peers by emulating an RPC.
 // Both the "remote" peer's RPC call and the caller peer's response are executed
-// asynchronously in a ThreadPool.
+// asynchronously in a ThreadPool. If a network is provided, its delays and losses are applied to
+// every request and response.
 class LocalTestPeerProxy : public TestPeerProxy {
  public:
   LocalTestPeerProxy(std::string peer_uuid, ThreadPool* pool,
-                     TestPeerMapManager* peers)
+                     TestPeerMapManager* peers, SimulatedNetwork* network = nullptr)
       : TestPeerProxy(pool),
         peer_uuid_(std::move(peer_uuid)),
         peers_(peers),
+        network_(network),
         miss_comm_(false) {}
 
   virtual void UpdateAsync(const ConsensusRequestPB* request,
@@ -480,6 +526,9 @@ class LocalTestPeerProxy : public TestPeerProxy {
       miss_comm_copy = miss_comm_;
       miss_comm_ = false;
     }
+    if (network_) {
+      SleepFor(network_->OneWayDelay());
+    }
     if (PREDICT_FALSE(miss_comm_copy)) {
       VLOG(2) << this << ": injecting fault on " << request->ShortDebugString();
       SetResponseError(STATUS(IOError, "Artificial error caused by communication "
@@ -490,8 +539,29 @@ class LocalTestPeerProxy : public TestPeerProxy {
     Respond(method);
   }
 
+  // Delays the request by the network latency. Returns false if the request was lost, in which
+  // case the error response is already sent.
+  template<class Response>
+  bool DeliverOverNetwork(Response* response, Method method) {
+    if (!network_) {
+      return true;
+    }
+    SleepFor(network_->OneWayDelay());
+    if (!network_->ShouldDrop()) {
+      return true;
+    }
+    SleepFor(network_->OneWayDelay());
+    SetResponseError(STATUS(IOError, "Request lost by simulated network"), response);
+    Respond(method);
+    return false;
+  }
+
   void SendUpdateRequest(const ConsensusRequestPB* request,
                          ConsensusResponsePB* response) {
+    if (!DeliverOverNetwork(response, kUpdate)) {
+      return;
+    }
+
     // Copy the request and the response for the other peer so that ownership
     // remains as close to the dist. impl. as possible.
     ConsensusRequestPB other_peer_req;
@@ -524,6 +594,9 @@ class LocalTestPeerProxy : public TestPeerProxy {
 
   void SendVoteRequest(const VoteRequestPB* request,
                        VoteResponsePB* response) {
+    if (!DeliverOverNetwork(response, kRequestVote)) {
+      return;
+    }
 
     // Copy the request and the response for the other peer so that ownership
     // remains as close to the dist. impl. as possible.
@@ -562,13 +635,15 @@ class LocalTestPeerProxy : public TestPeerProxy {
  private:
   const std::string peer_uuid_;
   TestPeerMapManager* const peers_;
+  SimulatedNetwork* const network_;
   bool miss_comm_;
 };
 
 class LocalTestPeerProxyFactory : public PeerProxyFactory {
  public:
-  explicit LocalTestPeerProxyFactory(TestPeerMapManager* peers)
-    : peers_(peers) {
+  explicit LocalTestPeerProxyFactory(TestPeerMapManager* peers,
+                                     SimulatedNetwork* network = nullptr)
+    : peers_(peers), network_(network) {
     CHECK_OK(ThreadPoolBuilder("test-peer-pool").set_max_threads(3).Build(&pool_));
   }
 
@@ -576,7 +651,8 @@ class LocalTestPeerProxyFactory : public PeerProxyFactory {
                           gscoped_ptr<PeerProxy>* proxy) override {
     LocalTestPeerProxy* new_proxy = new LocalTestPeerProxy(peer_pb.permanent_uuid(),
                                                            pool_.get(),
-                                                           peers_);
+                                                           peers_,
+                                                           network_);
     proxy->reset(new_proxy);
     proxies_.push_back(new_proxy);
     return Status::OK();
@@ -589,6 +665,7 @@ class LocalTestPeerProxyFactory : public PeerProxyFactory {
  private:
   gscoped_ptr<ThreadPool> pool_;
   TestPeerMapManager* const peers_;
+  SimulatedNetwork* const network_;
     // NOTE: There is no need to delete this on the dctor because proxies are externally managed
   vector<LocalTestPeerProxy*> proxies_;
 };
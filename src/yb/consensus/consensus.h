@@ -116,6 +116,10 @@ struct ConsensusBootstrapInfo {
   // These are owned by the ConsensusBootstrapInfo instance.
   ReplicateMsgs orphaned_replicates;
 
+  // UUID of the peer that should run the first election of a new tablet. Empty when every peer
+  // could start the first election.
+  std::string initial_leader_uuid;
+
  private:
   DISALLOW_COPY_AND_ASSIGN(ConsensusBootstrapInfo);
 };
@@ -349,6 +353,15 @@ class Consensus : public RefCountedThreadSafe<Consensus> {
     return STATUS(NotFound, "Not implemented.");
   }
 
+  // Reads committed operations following 'after_op_index' for change data capture, limited to
+  // about 'max_size_bytes'. Recent operations are served from the log cache, older ones are read
+  // from the log, so the reader should hold a log anchor for them. 'committed_op_id' is set to the
+  // last operation known to be committed, no operations after it are returned.
+  virtual CHECKED_STATUS ReadCommittedMessages(
+      int64_t after_op_index, int max_size_bytes, ReplicateMsgs* msgs, OpId* committed_op_id) {
+    return STATUS(NotSupported, "Not implemented.");
+  }
+
   // Assuming we are the leader, wait until we have a valid leader lease (i.e. the old leader's
   // lease has expired, and we have replicated a new lease that has not expired yet).
   virtual CHECKED_STATUS WaitForLeaderLeaseImprecise(MonoTime deadline) = 0;
@@ -516,6 +529,15 @@ class ReplicaOperationFactory {
       const ConsensusRoundPtr& context, HybridTime propagated_safe_time) = 0;
   virtual void SetPropagatedSafeTime(HybridTime ht) = 0;
 
+  // Called before and after operations committed by a single advance of the committed index are
+  // notified, on the same thread, so they could be applied as a batch.
+  virtual void StartApplyBatch() {}
+  virtual void FinishApplyBatch() {}
+
+  // Called when the leader sends keys that are frequently accessed on it, so their blocks could be
+  // loaded into the block cache in the background.
+  virtual void WarmCache(const google::protobuf::RepeatedPtrField<std::string>& keys) {}
+
   virtual ~ReplicaOperationFactory() {}
 };
 
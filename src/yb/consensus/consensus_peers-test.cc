@@ -90,6 +90,7 @@ class ConsensusPeersTest : public YBTest {
                        schema_,
                        0, // schema_version
                        NULL,
+                       nullptr /* append_thread_pool */,
                        &log_));
     clock_.reset(new server::HybridClock());
     ASSERT_OK(clock_->Init());
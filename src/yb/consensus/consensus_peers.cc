@@ -47,10 +47,12 @@
 #include "yb/consensus/consensus.proxy.h"
 #include "yb/consensus/consensus_queue.h"
 #include "yb/consensus/log.h"
+#include "yb/consensus/multi_raft_batcher.h"
 #include "yb/gutil/map-util.h"
 #include "yb/gutil/stl_util.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/tserver/tserver.pb.h"
+#include "yb/util/atomic.h"
 #include "yb/util/fault_injection.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
@@ -64,6 +66,25 @@ DEFINE_int32(consensus_rpc_timeout_ms, 2000,
 TAG_FLAG(consensus_rpc_timeout_ms, advanced);
 
 DECLARE_int32(raft_heartbeat_interval_ms);
+DECLARE_int32(raft_quiescent_heartbeat_interval_ms);
+
+DEFINE_bool(consensus_send_serialized_ops, true,
+            "Send ops to followers in the wire format cached by the log cache, instead of "
+            "serializing them into the request for each peer.");
+TAG_FLAG(consensus_send_serialized_ops, advanced);
+TAG_FLAG(consensus_send_serialized_ops, runtime);
+
+DEFINE_bool(consensus_coalesce_heartbeats, true,
+            "Send heartbeats of idle tablets to the same server with a single "
+            "MultiRaftUpdateConsensus RPC, instead of a separate UpdateConsensus RPC per tablet.");
+TAG_FLAG(consensus_coalesce_heartbeats, advanced);
+TAG_FLAG(consensus_coalesce_heartbeats, runtime);
+
+DEFINE_int32(consensus_max_in_flight_requests_per_peer, 1,
+             "Max number of UpdateConsensus requests with new ops that the leader could have "
+             "outstanding to each follower at the same time. Values above 1 let the leader send "
+             "the next batch of ops before the previous one is acknowledged.");
+TAG_FLAG(consensus_max_in_flight_requests_per_peer, advanced);
 
 DEFINE_test_flag(double, fault_crash_on_leader_request_fraction, 0.0,
                  "Fraction of the time when the leader will crash just before sending an "
@@ -116,7 +137,8 @@ Peer::Peer(
       proxy_(proxy.Pass()),
       queue_(queue),
       failed_attempts_(0),
-      sem_(1),
+      max_in_flight_requests_(std::max(FLAGS_consensus_max_in_flight_requests_per_peer, 1)),
+      sem_(max_in_flight_requests_),
       heartbeater_(
           peer_pb.permanent_uuid(), MonoDelta::FromMilliseconds(FLAGS_raft_heartbeat_interval_ms),
           std::bind(&Peer::SignalRequest, this, RequestTriggerMode::ALWAYS_SEND)),
@@ -124,8 +146,19 @@ Peer::Peer(
       state_(kPeerCreated),
       consensus_(consensus) {}
 
+Peer::InFlightRequest::~InFlightRequest() {
+  // We don't own the ops (the queue does).
+  request.mutable_ops()->ExtractSubrange(0, request.ops_size(), nullptr);
+}
+
 void Peer::SetTermForTest(int term) {
-  response_.set_responder_term(term);
+  std::lock_guard<simple_spinlock> lock(free_requests_lock_);
+  if (free_requests_.empty()) {
+    free_requests_.emplace_back(new InFlightRequest);
+  }
+  for (auto& request : free_requests_) {
+    request->response.set_responder_term(term);
+  }
 }
 
 Status Peer::Init() {
@@ -136,8 +169,29 @@ Status Peer::Init() {
   return Status::OK();
 }
 
+std::unique_ptr<Peer::InFlightRequest> Peer::GetFreeRequest() {
+  {
+    std::lock_guard<simple_spinlock> lock(free_requests_lock_);
+    if (!free_requests_.empty()) {
+      auto result = std::move(free_requests_.back());
+      free_requests_.pop_back();
+      return result;
+    }
+  }
+  return std::make_unique<InFlightRequest>();
+}
+
+void Peer::ReleaseRequest(std::unique_ptr<InFlightRequest> request) {
+  std::lock_guard<simple_spinlock> lock(free_requests_lock_);
+  free_requests_.push_back(std::move(request));
+}
+
+bool Peer::HasOtherRequestsInFlight() {
+  return sem_.GetValue() < max_in_flight_requests_ - 1;
+}
+
 Status Peer::SignalRequest(RequestTriggerMode trigger_mode) {
-  // If the peer is currently sending, return Status::OK().
+  // If the peer already has as many requests outstanding as allowed, return Status::OK().
   // If there are new requests in the queue we'll get them on ProcessResponse().
   if (!sem_.TryAcquire()) {
     return Status::OK();
@@ -170,6 +224,14 @@ Status Peer::SignalRequest(RequestTriggerMode trigger_mode) {
       sem_.Release();
       return Status::OK();
     }
+
+    // Only requests with new ops are pipelined. A heartbeat is not needed while other requests
+    // are outstanding, and after an error we wait for the outstanding requests to be responded.
+    if ((trigger_mode == RequestTriggerMode::ALWAYS_SEND || failed_attempts_ > 0) &&
+        HasOtherRequestsInFlight()) {
+      sem_.Release();
+      return Status::OK();
+    }
   }
 
   auto status = raft_pool_token_->SubmitClosure(
@@ -181,28 +243,44 @@ Status Peer::SignalRequest(RequestTriggerMode trigger_mode) {
 }
 
 void Peer::SendNextRequest(RequestTriggerMode trigger_mode) {
-  DCHECK_LE(sem_.GetValue(), 0) << "Cannot send request";
+  DCHECK_LT(sem_.GetValue(), max_in_flight_requests_) << "Cannot send request";
 
-  // The peer has no pending request nor is sending: send the request.
+  // Requests are assembled and sent one at a time, so the follower receives them in the order
+  // their ops were read from the queue.
+  std::unique_lock<std::mutex> send_lock(send_mutex_);
+  auto in_flight = GetFreeRequest();
+  auto& request = in_flight->request;
+
+  // The peer has a free slot for a request: send the request.
   bool needs_remote_bootstrap = false;
   bool last_exchange_successful = false;
   RaftPeerPB::MemberType member_type = RaftPeerPB::UNKNOWN_MEMBER_TYPE;
-  int64_t commit_index_before = request_.has_committed_index() ?
-      request_.committed_index().index() : kMinimumOpIdIndex;
-  Status s = queue_->RequestForPeer(peer_pb_.permanent_uuid(), &request_,
-      &replicate_msg_refs_, &needs_remote_bootstrap, &member_type, &last_exchange_successful);
-  int64_t commit_index_after = request_.has_committed_index() ?
-      request_.committed_index().index() : kMinimumOpIdIndex;
+  int64_t commit_index_before = last_sent_committed_index_;
+  const bool use_serialized_ops =
+      GetAtomicFlag(&FLAGS_consensus_send_serialized_ops) &&
+      proxy_->SupportsSerializedRequestFields();
+  const MonoTime request_time = MonoTime::Now();
+  Status s = queue_->RequestForPeer(peer_pb_.permanent_uuid(), &request,
+      &in_flight->replicate_msg_refs, &needs_remote_bootstrap, &member_type,
+      &last_exchange_successful, use_serialized_ops ? &serialized_ops_ : nullptr);
+  int64_t commit_index_after = request.has_committed_index() ?
+      request.committed_index().index() : kMinimumOpIdIndex;
 
   if (PREDICT_FALSE(!s.ok())) {
     LOG_WITH_PREFIX_UNLOCKED(INFO) << "Could not obtain request from queue for peer: "
         << peer_pb_.permanent_uuid() << ". Status: " << s.ToString();
+    ReleaseRequest(std::move(in_flight));
     sem_.Release();
     return;
   }
+  last_sent_committed_index_ = commit_index_after;
 
   if (PREDICT_FALSE(needs_remote_bootstrap)) {
-    Status s = SendRemoteBootstrapRequest();
+    ReleaseRequest(std::move(in_flight));
+    // Only one remote bootstrap request is sent at a time.
+    Status s = remote_bootstrap_in_flight_.exchange(true)
+        ? STATUS(IllegalState, "Remote bootstrap request is already in flight")
+        : SendRemoteBootstrapRequest();
     if (!s.ok()) {
       LOG_WITH_PREFIX_UNLOCKED(WARNING) << "Unable to generate remote bootstrap request for peer: "
                                         << s.ToString();
@@ -216,6 +294,8 @@ void Peer::SendNextRequest(RequestTriggerMode trigger_mode) {
   if (last_exchange_successful &&
       (member_type == RaftPeerPB::PRE_VOTER || member_type == RaftPeerPB::PRE_OBSERVER)) {
     if (PREDICT_TRUE(consensus_)) {
+      ReleaseRequest(std::move(in_flight));
+      send_lock.unlock();
       sem_.Release();
       consensus::ChangeConfigRequestPB req;
       consensus::ChangeConfigResponsePB resp;
@@ -244,15 +324,31 @@ void Peer::SendNextRequest(RequestTriggerMode trigger_mode) {
     }
   }
 
-  request_.set_tablet_id(tablet_id_);
-  request_.set_caller_uuid(leader_uuid_);
-  request_.set_dest_uuid(peer_pb_.permanent_uuid());
+  request.set_tablet_id(tablet_id_);
+  request.set_caller_uuid(leader_uuid_);
+  request.set_dest_uuid(peer_pb_.permanent_uuid());
+
+  // The queue tells when the follower has everything and the tablet is idle, so heartbeats could
+  // be sent rarely. Any other request wakes the group up, and regular heartbeats resume at once.
+  if (request.quiescent() != quiescent_) {
+    quiescent_ = request.quiescent();
+    VLOG_WITH_PREFIX_UNLOCKED(1) << (quiescent_ ? "Entering" : "Leaving") << " quiescence";
+    heartbeater_.SetPeriod(MonoDelta::FromMilliseconds(
+        quiescent_ ? FLAGS_raft_quiescent_heartbeat_interval_ms
+                   : FLAGS_raft_heartbeat_interval_ms));
+    if (!quiescent_) {
+      heartbeater_.Reset();
+    }
+  }
 
-  const bool req_has_ops = (request_.ops_size() > 0) || (commit_index_after > commit_index_before);
+  const bool req_has_ops = (request.ops_size() > 0) || (commit_index_after > commit_index_before);
 
   // If the queue is empty, check if we were told to send a status-only message (which is what
-  // happens during heartbeats). If not, just return.
-  if (PREDICT_FALSE(!req_has_ops && trigger_mode == RequestTriggerMode::NON_EMPTY_ONLY)) {
+  // happens during heartbeats). If not, just return. Status-only messages are not sent while other
+  // requests are in flight, their responses will tell the same.
+  if (PREDICT_FALSE(!req_has_ops && (trigger_mode == RequestTriggerMode::NON_EMPTY_ONLY ||
+                                     HasOtherRequestsInFlight()))) {
+    ReleaseRequest(std::move(in_flight));
     sem_.Release();
     return;
   }
@@ -263,18 +359,54 @@ void Peer::SendNextRequest(RequestTriggerMode trigger_mode) {
   }
 
   MAYBE_FAULT(FLAGS_fault_crash_on_leader_request_fraction);
-  controller_.Reset();
+  auto& controller = in_flight->controller;
+  controller.Reset();
+
+  if (use_serialized_ops && request.ops_size() > 0) {
+    DCHECK_EQ(serialized_ops_.size(), request.ops_size());
+    // Send ops in the wire format shared with other peers, instead of serializing them again.
+    // replicate_msg_refs still holds the messages, so they are not deleted here.
+    request.mutable_ops()->ExtractSubrange(0, request.ops_size(), nullptr);
+    for (auto& serialized_op : serialized_ops_) {
+      controller.AddSerializedRequestFields(std::move(serialized_op));
+    }
+    serialized_ops_.clear();
+  }
+
+  // The lease duration is counted from the time before the request was assembled, so it does not
+  // outlive the one the follower starts when it receives the request.
+  in_flight->lease_sent.leader_lease_expiration =
+      request_time + MonoDelta::FromMilliseconds(request.leader_lease_duration_ms());
+  in_flight->lease_sent.ht_lease_expiration = request.ht_lease_expiration();
+
+  // Owned by the callbacks until the response is handled.
+  auto* in_flight_ptr = in_flight.release();
+
+  // Requests with ops or with an advanced committed index are sent right away, heartbeats of idle
+  // tablets could wait a little to be sent together with heartbeats of other tablets.
+  if (!req_has_ops && GetAtomicFlag(&FLAGS_consensus_coalesce_heartbeats) &&
+      proxy_->SupportsHeartbeatBatching()) {
+    proxy_->HeartbeatAsync(
+        &in_flight_ptr->request, &in_flight_ptr->response,
+        std::bind(&Peer::ProcessResponseStatus, this, in_flight_ptr, std::placeholders::_1));
+    return;
+  }
+
+  proxy_->UpdateAsync(&in_flight_ptr->request, &in_flight_ptr->response, &controller,
+                      std::bind(&Peer::ProcessResponse, this, in_flight_ptr));
+}
 
-  proxy_->UpdateAsync(&request_, &response_, &controller_, std::bind(&Peer::ProcessResponse, this));
+void Peer::ProcessResponse(InFlightRequest* in_flight) {
+  ProcessResponseStatus(in_flight, in_flight->controller.status());
 }
 
-void Peer::ProcessResponse() {
+void Peer::ProcessResponseStatus(InFlightRequest* in_flight, const Status& status) {
   // Note: This method runs on the reactor thread.
 
-  DCHECK_LE(sem_.GetValue(), 0) << "Got a response when nothing was pending";
+  DCHECK_LT(sem_.GetValue(), max_in_flight_requests_) << "Got a response when nothing was pending";
 
-  if (!controller_.status().ok()) {
-    if (controller_.status().IsRemoteError()) {
+  if (!status.ok()) {
+    if (status.IsRemoteError()) {
       // Most controller errors are caused by network issues or corner cases like shutdown and
       // failure to serialize a protobuf. Therefore, we generally consider these errors to indicate
       // an unreachable peer.  However, a RemoteError wraps some other error propagated from the
@@ -282,51 +414,57 @@ void Peer::ProcessResponse() {
       // remote is responsive.
       queue_->NotifyPeerIsResponsiveDespiteError(peer_pb_.permanent_uuid());
     }
-    ProcessResponseError(controller_.status());
+    ProcessResponseError(in_flight, status);
     return;
   }
 
+  const auto& response = in_flight->response;
+
   // We should try to evict a follower which returns a WRONG UUID error.
-  if (response_.has_error() &&
-      response_.error().code() == tserver::TabletServerErrorPB::WRONG_SERVER_UUID) {
+  if (response.has_error() &&
+      response.error().code() == tserver::TabletServerErrorPB::WRONG_SERVER_UUID) {
     queue_->NotifyObserversOfFailedFollower(
         peer_pb_.permanent_uuid(),
         Substitute("Leader communication with peer $0 received error $1, will try to "
                    "evict peer", peer_pb_.permanent_uuid(),
-                   response_.error().ShortDebugString()));
-    ProcessResponseError(StatusFromPB(response_.error().status()));
+                   response.error().ShortDebugString()));
+    ProcessResponseError(in_flight, StatusFromPB(response.error().status()));
     return;
   }
 
   // Pass through errors we can respond to, like not found, since in that case
   // we will need to remotely bootstrap. TODO: Handle DELETED response once implemented.
-  if ((response_.has_error() &&
-      response_.error().code() != tserver::TabletServerErrorPB::TABLET_NOT_FOUND) ||
-      (response_.status().has_error() &&
-          response_.status().error().code() == consensus::ConsensusErrorPB::CANNOT_PREPARE)) {
+  if ((response.has_error() &&
+      response.error().code() != tserver::TabletServerErrorPB::TABLET_NOT_FOUND) ||
+      (response.status().has_error() &&
+          response.status().error().code() == consensus::ConsensusErrorPB::CANNOT_PREPARE)) {
     // Again, let the queue know that the remote is still responsive, since we will not be sending
     // this error response through to the queue.
     queue_->NotifyPeerIsResponsiveDespiteError(peer_pb_.permanent_uuid());
-    ProcessResponseError(StatusFromPB(response_.error().status()));
+    ProcessResponseError(in_flight, StatusFromPB(response.error().status()));
     return;
   }
 
   // The queue's handling of the peer response may generate IO (reads against the WAL) and
   // SendNextRequest() may do the same thing. So we run the rest of the response handling logic on
   // our thread pool and not on the reactor thread.
-  Status s = raft_pool_token_->SubmitClosure(Bind(&Peer::DoProcessResponse, Unretained(this)));
+  Status s = raft_pool_token_->SubmitFunc(std::bind(&Peer::DoProcessResponse, this, in_flight));
   if (PREDICT_FALSE(!s.ok())) {
     LOG_WITH_PREFIX_UNLOCKED(WARNING) << "Unable to process peer response: " << s.ToString()
-        << ": " << response_.ShortDebugString();
+        << ": " << response.ShortDebugString();
+    ReleaseRequest(std::unique_ptr<InFlightRequest>(in_flight));
     sem_.Release();
   }
 }
 
-void Peer::DoProcessResponse() {
+void Peer::DoProcessResponse(InFlightRequest* in_flight) {
+  std::unique_ptr<InFlightRequest> holder(in_flight);
   failed_attempts_ = 0;
 
   bool more_pending;
-  queue_->ResponseFromPeer(peer_pb_.permanent_uuid(), response_, &more_pending);
+  queue_->ResponseFromPeer(
+      peer_pb_.permanent_uuid(), in_flight->response, &more_pending, &in_flight->lease_sent);
+  ReleaseRequest(std::move(holder));
 
   // We're OK to read the state_ without a lock here -- if we get a race,
   // the worst thing that could happen is that we'll make one more request before
@@ -341,14 +479,19 @@ void Peer::DoProcessResponse() {
 Status Peer::SendRemoteBootstrapRequest() {
   if (!FLAGS_enable_remote_bootstrap) {
     failed_attempts_++;
+    remote_bootstrap_in_flight_.store(false);
     return STATUS(NotSupported, "remote bootstrap is disabled");
   }
 
   LOG_WITH_PREFIX_UNLOCKED(INFO) << "Sending request to remotely bootstrap";
-  RETURN_NOT_OK(queue_->GetRemoteBootstrapRequestForPeer(peer_pb_.permanent_uuid(), &rb_request_));
-  controller_.Reset();
+  Status s = queue_->GetRemoteBootstrapRequestForPeer(peer_pb_.permanent_uuid(), &rb_request_);
+  if (!s.ok()) {
+    remote_bootstrap_in_flight_.store(false);
+    return s;
+  }
+  rb_controller_.Reset();
   proxy_->StartRemoteBootstrap(
-      &rb_request_, &rb_response_, &controller_,
+      &rb_request_, &rb_response_, &rb_controller_,
       std::bind(&Peer::ProcessRemoteBootstrapResponse, this));
   return Status::OK();
 }
@@ -359,10 +502,12 @@ void Peer::ProcessRemoteBootstrapResponse() {
     LOG_WITH_PREFIX_UNLOCKED(WARNING) << "Unable to begin remote bootstrap on peer: "
                                       << rb_response_.ShortDebugString();
   }
+  remote_bootstrap_in_flight_.store(false);
   sem_.Release();
 }
 
-void Peer::ProcessResponseError(const Status& status) {
+void Peer::ProcessResponseError(InFlightRequest* in_flight, const Status& status) {
+  ReleaseRequest(std::unique_ptr<InFlightRequest>(in_flight));
   failed_attempts_++;
   LOG_WITH_PREFIX_UNLOCKED(WARNING) << "Couldn't send request to peer " << peer_pb_.permanent_uuid()
       << " for tablet " << tablet_id_
@@ -389,14 +534,20 @@ void Peer::Close() {
   }
   LOG_WITH_PREFIX_UNLOCKED(INFO) << "Closing peer: " << peer_pb_.permanent_uuid();
 
-  // Acquire the semaphore to wait for any concurrent request to finish.  They will see the state_
-  // == kPeerClosed and not start any new requests, but we can't currently cancel the already-sent
-  // ones. (see KUDU-699)
-  std::lock_guard<Semaphore> l(sem_);
+  // Acquire all units of the semaphore to wait for any concurrent requests to finish.  They will
+  // see the state_ == kPeerClosed and not start any new requests, but we can't currently cancel the
+  // already-sent ones. (see KUDU-699)
+  for (int i = 0; i != max_in_flight_requests_; ++i) {
+    sem_.Acquire();
+  }
   queue_->UntrackPeer(peer_pb_.permanent_uuid());
-  // We don't own the ops (the queue does).
-  request_.mutable_ops()->ExtractSubrange(0, request_.ops_size(), nullptr);
-  replicate_msg_refs_.clear();
+  {
+    std::lock_guard<simple_spinlock> lock(free_requests_lock_);
+    free_requests_.clear();
+  }
+  for (int i = 0; i != max_in_flight_requests_; ++i) {
+    sem_.Release();
+  }
 }
 
 Peer::~Peer() {
@@ -404,9 +555,11 @@ Peer::~Peer() {
 }
 
 RpcPeerProxy::RpcPeerProxy(gscoped_ptr<HostPort> hostport,
-                           gscoped_ptr<ConsensusServiceProxy> consensus_proxy)
+                           gscoped_ptr<ConsensusServiceProxy> consensus_proxy,
+                           std::shared_ptr<MultiRaftHeartbeatBatcher> heartbeat_batcher)
     : hostport_(hostport.Pass()),
-      consensus_proxy_(consensus_proxy.Pass()) {
+      consensus_proxy_(consensus_proxy.Pass()),
+      heartbeat_batcher_(std::move(heartbeat_batcher)) {
 }
 
 void RpcPeerProxy::UpdateAsync(const ConsensusRequestPB* request,
@@ -417,6 +570,12 @@ void RpcPeerProxy::UpdateAsync(const ConsensusRequestPB* request,
   consensus_proxy_->UpdateConsensusAsync(*request, response, controller, callback);
 }
 
+void RpcPeerProxy::HeartbeatAsync(const ConsensusRequestPB* request,
+                                  ConsensusResponsePB* response,
+                                  std::function<void(const Status&)> callback) {
+  heartbeat_batcher_->AddRequest(*request, response, std::move(callback));
+}
+
 void RpcPeerProxy::RequestConsensusVoteAsync(const VoteRequestPB* request,
                                              VoteResponsePB* response,
                                              rpc::RpcController* controller,
@@ -450,9 +609,7 @@ RpcPeerProxy::~RpcPeerProxy() {}
 
 namespace {
 
-Status CreateConsensusServiceProxyForHost(const shared_ptr<Messenger>& messenger,
-                                          const HostPort& hostport,
-                                          gscoped_ptr<ConsensusServiceProxy>* new_proxy) {
+Status ResolvePeerAddress(const HostPort& hostport, Endpoint* endpoint) {
   std::vector<Endpoint> addrs;
   RETURN_NOT_OK(hostport.ResolveAddresses(&addrs));
   if (addrs.size() > 1) {
@@ -460,7 +617,16 @@ Status CreateConsensusServiceProxyForHost(const shared_ptr<Messenger>& messenger
                  << "resolves to " << addrs.size() << " different addresses. Using "
                  << addrs[0];
   }
-  new_proxy->reset(new ConsensusServiceProxy(messenger, addrs[0]));
+  *endpoint = addrs[0];
+  return Status::OK();
+}
+
+Status CreateConsensusServiceProxyForHost(const shared_ptr<Messenger>& messenger,
+                                          const HostPort& hostport,
+                                          gscoped_ptr<ConsensusServiceProxy>* new_proxy) {
+  Endpoint endpoint;
+  RETURN_NOT_OK(ResolvePeerAddress(hostport, &endpoint));
+  new_proxy->reset(new ConsensusServiceProxy(messenger, endpoint));
   return Status::OK();
 }
 
@@ -473,9 +639,11 @@ Status RpcPeerProxyFactory::NewProxy(const RaftPeerPB& peer_pb,
                                      gscoped_ptr<PeerProxy>* proxy) {
   gscoped_ptr<HostPort> hostport(new HostPort);
   RETURN_NOT_OK(HostPortFromPB(peer_pb.last_known_addr(), hostport.get()));
-  gscoped_ptr<ConsensusServiceProxy> new_proxy;
-  RETURN_NOT_OK(CreateConsensusServiceProxyForHost(messenger_, *hostport, &new_proxy));
-  proxy->reset(new RpcPeerProxy(hostport.Pass(), new_proxy.Pass()));
+  Endpoint endpoint;
+  RETURN_NOT_OK(ResolvePeerAddress(*hostport, &endpoint));
+  gscoped_ptr<ConsensusServiceProxy> new_proxy(new ConsensusServiceProxy(messenger_, endpoint));
+  proxy->reset(new RpcPeerProxy(hostport.Pass(), new_proxy.Pass(),
+                                MultiRaftHeartbeatBatcher::Get(messenger_, endpoint)));
   return Status::OK();
 }
 
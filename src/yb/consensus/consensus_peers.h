@@ -33,12 +33,16 @@
 #ifndef YB_CONSENSUS_CONSENSUS_PEERS_H_
 #define YB_CONSENSUS_CONSENSUS_PEERS_H_
 
+#include <atomic>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
 #include "yb/consensus/consensus.h"
 #include "yb/consensus/consensus.pb.h"
+#include "yb/consensus/consensus_queue.h"
 #include "yb/consensus/metadata.pb.h"
 #include "yb/consensus/ref_counted_replicate.h"
 #include "yb/consensus/consensus_util.h"
@@ -60,6 +64,7 @@ class Log;
 
 namespace consensus {
 class ConsensusServiceProxy;
+class MultiRaftHeartbeatBatcher;
 class PeerProxy;
 class PeerProxyFactory;
 class PeerMessageQueue;
@@ -166,15 +171,47 @@ class Peer {
        gscoped_ptr<PeerProxy> proxy, PeerMessageQueue* queue,
        ThreadPoolToken* raft_pool_token, Consensus* consensus);
 
+  // A request sent to the peer, along with everything that should stay alive until it is
+  // responded. Up to --consensus_max_in_flight_requests_per_peer of them could be in flight.
+  struct InFlightRequest {
+    ConsensusRequestPB request;
+    ConsensusResponsePB response;
+    rpc::RpcController controller;
+
+    // Reference-counted pointers to any ReplicateMsgs which are in-flight to the peer. We may have
+    // loaded these messages from the LogCache, in which case we are potentially sharing the same
+    // object as other peers. Since the PB request itself can't hold reference counts, this holds
+    // them.
+    ReplicateMsgs replicate_msg_refs;
+
+    // Leader leases sent with this request, that are established when it is responded.
+    FollowerLeaseSent lease_sent;
+
+    ~InFlightRequest();
+  };
+
   void SendNextRequest(RequestTriggerMode trigger_mode);
 
   // Signals that a response was received from the peer.  This method is called from the reactor
   // thread and calls DoProcessResponse() on raft_pool_token_ to do any work that requires IO or
   // lock-taking.
-  void ProcessResponse();
+  void ProcessResponse(InFlightRequest* in_flight);
+
+  // Handles the response to 'in_flight', 'status' is the status of the RPC that delivered it.
+  // Called on the reactor thread.
+  void ProcessResponseStatus(InFlightRequest* in_flight, const Status& status);
 
   // Run on 'raft_pool_token'. Does response handling that requires IO or may block.
-  void DoProcessResponse();
+  void DoProcessResponse(InFlightRequest* in_flight);
+
+  // Returns a request that is not in flight, to be filled and sent.
+  std::unique_ptr<InFlightRequest> GetFreeRequest();
+
+  // Keeps a request that is not in flight anymore for reuse.
+  void ReleaseRequest(std::unique_ptr<InFlightRequest> request);
+
+  // Whether requests other than the one the caller holds a unit of sem_ for are outstanding.
+  bool HasOtherRequestsInFlight();
 
   // Fetch the desired remote bootstrap request from the queue and send it to the peer. The callback
   // goes to ProcessRemoteBootstrapResponse().
@@ -187,7 +224,7 @@ class Peer {
   void ProcessRemoteBootstrapResponse();
 
   // Signals there was an error sending the request to the peer.
-  void ProcessResponseError(const Status& status);
+  void ProcessResponseError(InFlightRequest* in_flight, const Status& status);
 
   std::string LogPrefixUnlocked() const;
 
@@ -201,26 +238,35 @@ class Peer {
   gscoped_ptr<PeerProxy> proxy_;
 
   PeerMessageQueue* queue_;
-  uint64_t failed_attempts_;
-
-  // The latest consensus update request and response.
-  ConsensusRequestPB request_;
-  ConsensusResponsePB response_;
+  std::atomic<uint64_t> failed_attempts_;
 
   // The latest remote bootstrap request and response.
   StartRemoteBootstrapRequestPB rb_request_;
   StartRemoteBootstrapResponsePB rb_response_;
+  rpc::RpcController rb_controller_;
+  std::atomic<bool> remote_bootstrap_in_flight_{false};
+
+  // Max number of requests that could be in flight to the peer at the same time.
+  const int max_in_flight_requests_;
 
-  // Reference-counted pointers to any ReplicateMsgs which are in-flight to the peer. We may have
-  // loaded these messages from the LogCache, in which case we are potentially sharing the same
-  // object as other peers. Since the PB request_ itself can't hold reference counts, this holds
-  // them.
-  ReplicateMsgs replicate_msg_refs_;
+  // Serializes assembling and sending of requests, so they are sent in the order their ops are read
+  // from the queue.
+  std::mutex send_mutex_;
 
-  rpc::RpcController controller_;
+  // Committed index sent with the latest request. Protected by send_mutex_.
+  int64_t last_sent_committed_index_ = kMinimumOpIdIndex;
 
-  // Held if there is an outstanding request.  This is used in order to ensure that we only have a
-  // single request oustanding at a time, and to wait for the outstanding requests at Close().
+  // Wire format of the ops of the request being assembled, shared with other peers through the
+  // LogCache. Protected by send_mutex_.
+  std::vector<RefCntBuffer> serialized_ops_;
+
+  // Requests that are not in flight, kept for reuse. Responses could be handled on the reactor
+  // thread while send_mutex_ is held, so they are protected by a separate lock.
+  simple_spinlock free_requests_lock_;
+  std::vector<std::unique_ptr<InFlightRequest>> free_requests_;
+
+  // Has a unit held for each outstanding request. This is used in order to bound the number of
+  // requests outstanding at a time, and to wait for the outstanding requests at Close().
   Semaphore sem_;
 
   // Heartbeater for remote peer implementations.  This will send status only requests to the remote
@@ -230,6 +276,10 @@ class Peer {
   // Thread pool used to construct requests to this peer.
   ThreadPoolToken* raft_pool_token_;
 
+  // Whether the latest request told the follower that the Raft group is quiescent, so heartbeats
+  // are sent every --raft_quiescent_heartbeat_interval_ms. Protected by send_mutex_.
+  bool quiescent_ = false;
+
   enum State {
     kPeerCreated,
     kPeerStarted,
@@ -284,6 +334,21 @@ class PeerProxy {
     LOG(DFATAL) << "Not implemented";
   }
 
+  // Whether UpdateAsync() sends the serialized request fields added to the controller, so ops
+  // could be passed in the serialized form instead of the request.
+  virtual bool SupportsSerializedRequestFields() const { return false; }
+
+  // Whether HeartbeatAsync() is implemented.
+  virtual bool SupportsHeartbeatBatching() const { return false; }
+
+  // Sends a request without ops, that could be coalesced with heartbeats of other tablets sent to
+  // the same server. 'callback' is invoked on the reactor thread with the status of the RPC.
+  virtual void HeartbeatAsync(const ConsensusRequestPB* request,
+                              ConsensusResponsePB* response,
+                              std::function<void(const Status&)> callback) {
+    LOG(DFATAL) << "Not implemented";
+  }
+
   virtual ~PeerProxy() {}
 };
 
@@ -302,7 +367,8 @@ class PeerProxyFactory {
 class RpcPeerProxy : public PeerProxy {
  public:
   RpcPeerProxy(gscoped_ptr<HostPort> hostport,
-               gscoped_ptr<ConsensusServiceProxy> consensus_proxy);
+               gscoped_ptr<ConsensusServiceProxy> consensus_proxy,
+               std::shared_ptr<MultiRaftHeartbeatBatcher> heartbeat_batcher = nullptr);
 
   virtual void UpdateAsync(const ConsensusRequestPB* request,
                            ConsensusResponsePB* response,
@@ -329,11 +395,21 @@ class RpcPeerProxy : public PeerProxy {
                                        rpc::RpcController* controller,
                                        const rpc::ResponseCallback& callback) override;
 
+  bool SupportsSerializedRequestFields() const override { return true; }
+
+  bool SupportsHeartbeatBatching() const override { return heartbeat_batcher_ != nullptr; }
+
+  void HeartbeatAsync(const ConsensusRequestPB* request,
+                      ConsensusResponsePB* response,
+                      std::function<void(const Status&)> callback) override;
+
   virtual ~RpcPeerProxy();
 
  private:
   gscoped_ptr<HostPort> hostport_;
   gscoped_ptr<ConsensusServiceProxy> consensus_proxy_;
+  // Shared by proxies of all tablets to the same server.
+  std::shared_ptr<MultiRaftHeartbeatBatcher> heartbeat_batcher_;
 };
 
 // PeerProxyFactory implementation that generates RPCPeerProxies
@@ -54,6 +54,9 @@
 
 DECLARE_bool(enable_data_block_fsync);
 DECLARE_int32(consensus_max_batch_size_bytes);
+DECLARE_int32(raft_quiesce_after_idle_ms);
+DECLARE_int32(consensus_max_in_flight_requests_per_peer);
+DECLARE_int32(cache_hints_interval_ms);
 
 METRIC_DECLARE_entity(tablet);
 
@@ -86,6 +89,7 @@ class ConsensusQueueTest : public YBTest {
                             schema_,
                             0, // schema_version
                             NULL,
+                            nullptr /* append_thread_pool */,
                             &log_));
     clock_.reset(new server::HybridClock());
     ASSERT_OK(clock_->Init());
@@ -262,6 +266,73 @@ TEST_F(ConsensusQueueTest, TestStartTrackingAfterStart) {
   request.mutable_ops()->ExtractSubrange(0, request.ops_size(), nullptr);
 }
 
+// Tests that an idle leader marks requests to a caught up peer as quiescent, until there is activity.
+TEST_F(ConsensusQueueTest, TestQuiescence) {
+  FLAGS_raft_quiesce_after_idle_ms = 10;
+  queue_->Init(MinimumOpId());
+  queue_->SetLeaderMode(MinimumOpId(), MinimumOpId().term(), BuildRaftConfigPBForTests(2));
+  queue_->TrackPeer(kPeerUuid);
+
+  ConsensusRequestPB request;
+  ConsensusResponsePB response;
+  ReplicateMsgs refs;
+  bool needs_remote_bootstrap;
+  bool more_pending = false;
+
+  // Nothing is known about the peer yet.
+  SleepFor(MonoDelta::FromMilliseconds(20));
+  ASSERT_OK(queue_->RequestForPeer(kPeerUuid, &request, &refs, &needs_remote_bootstrap));
+  ASSERT_FALSE(request.quiescent());
+
+  response.set_responder_uuid(kPeerUuid);
+  SetLastReceivedAndLastCommitted(&response, MinimumOpId(), MinimumOpId().index());
+  queue_->ResponseFromPeer(response.responder_uuid(), response, &more_pending);
+  ASSERT_FALSE(more_pending);
+
+  ASSERT_OK(queue_->RequestForPeer(kPeerUuid, &request, &refs, &needs_remote_bootstrap));
+  ASSERT_TRUE(request.quiescent());
+
+  // Activity, e.g. a read that needs a lease, wakes the group up.
+  ASSERT_TRUE(queue_->RecordActivity());
+  ASSERT_OK(queue_->RequestForPeer(kPeerUuid, &request, &refs, &needs_remote_bootstrap));
+  ASSERT_FALSE(request.quiescent());
+  ASSERT_FALSE(queue_->RecordActivity());
+
+  SleepFor(MonoDelta::FromMilliseconds(20));
+  ASSERT_OK(queue_->RequestForPeer(kPeerUuid, &request, &refs, &needs_remote_bootstrap));
+  ASSERT_TRUE(request.quiescent());
+}
+
+// Tests that cache hints are sent to a peer at most once per --cache_hints_interval_ms.
+TEST_F(ConsensusQueueTest, TestCacheHints) {
+  FLAGS_cache_hints_interval_ms = 50;
+  queue_->Init(MinimumOpId());
+  queue_->SetLeaderMode(MinimumOpId(), MinimumOpId().term(), BuildRaftConfigPBForTests(2));
+  queue_->TrackPeer(kPeerUuid);
+  queue_->SetCacheHintsProvider([] {
+    return std::vector<std::string>{"key1", "key2"};
+  });
+
+  ConsensusRequestPB request;
+  ReplicateMsgs refs;
+  bool needs_remote_bootstrap;
+  ASSERT_OK(queue_->RequestForPeer(kPeerUuid, &request, &refs, &needs_remote_bootstrap));
+  ASSERT_EQ(2, request.cache_hint_keys_size());
+  ASSERT_EQ("key2", request.cache_hint_keys(1));
+
+  ASSERT_OK(queue_->RequestForPeer(kPeerUuid, &request, &refs, &needs_remote_bootstrap));
+  ASSERT_EQ(0, request.cache_hint_keys_size());
+
+  SleepFor(MonoDelta::FromMilliseconds(60));
+  ASSERT_OK(queue_->RequestForPeer(kPeerUuid, &request, &refs, &needs_remote_bootstrap));
+  ASSERT_EQ(2, request.cache_hint_keys_size());
+
+  FLAGS_cache_hints_interval_ms = 0;
+  SleepFor(MonoDelta::FromMilliseconds(60));
+  ASSERT_OK(queue_->RequestForPeer(kPeerUuid, &request, &refs, &needs_remote_bootstrap));
+  ASSERT_EQ(0, request.cache_hint_keys_size());
+}
+
 // Tests that the peers gets the messages pages, with the size of a page being
 // 'consensus_max_batch_size_bytes'
 TEST_F(ConsensusQueueTest, TestGetPagedMessages) {
@@ -353,6 +424,70 @@ TEST_F(ConsensusQueueTest, TestGetPagedMessages) {
   ASSERT_FALSE(more_pending);
 }
 
+// Tests that pipelined requests to a peer carry consecutive ops, and that responses arriving out of
+// order do not make the queue resend acknowledged ops, while an LMP mismatch rewinds the peer.
+TEST_F(ConsensusQueueTest, TestPipelinedRequests) {
+  google::FlagSaver saver;
+  FLAGS_consensus_max_in_flight_requests_per_peer = 2;
+  FLAGS_consensus_max_batch_size_bytes = 1024 * 10;
+
+  queue_->Init(MinimumOpId());
+  queue_->SetLeaderMode(MinimumOpId(), MinimumOpId().term(), BuildRaftConfigPBForTests(2));
+
+  ConsensusRequestPB request;
+  ConsensusResponsePB response;
+  response.set_responder_uuid(kPeerUuid);
+  bool more_pending = false;
+  UpdatePeerWatermarkToOp(&request, &response, MinimumOpId(), MinimumOpId(), &more_pending);
+
+  AppendReplicateMessagesToQueue(queue_.get(), clock_, 1, 100, 1024);
+
+  const int kNumRequests = 4;
+  ConsensusRequestPB requests[kNumRequests];
+  ReplicateMsgs refs[kNumRequests];
+  BOOST_SCOPE_EXIT(&requests) {
+    // Extract the ops from the requests to avoid double free.
+    for (auto& sent_request : requests) {
+      sent_request.mutable_ops()->ExtractSubrange(
+          0, sent_request.ops_size(), /* elements */ nullptr);
+    }
+  } BOOST_SCOPE_EXIT_END;
+  bool needs_remote_bootstrap;
+
+  // The second request continues where the first one ends, without waiting for its response.
+  for (int i = 0; i != 2; ++i) {
+    ASSERT_OK(queue_->RequestForPeer(kPeerUuid, &requests[i], &refs[i], &needs_remote_bootstrap));
+    ASSERT_FALSE(needs_remote_bootstrap);
+    ASSERT_GT(requests[i].ops_size(), 0);
+  }
+  const OpId first_last = requests[0].ops(requests[0].ops_size() - 1).id();
+  const OpId second_last = requests[1].ops(requests[1].ops_size() - 1).id();
+  ASSERT_OPID_EQ(first_last, requests[1].preceding_id());
+
+  // The response to the second request arrives before the response to the first one.
+  SetLastReceivedAndLastCommitted(&response, second_last);
+  queue_->ResponseFromPeer(kPeerUuid, response, &more_pending);
+  SetLastReceivedAndLastCommitted(&response, first_last);
+  queue_->ResponseFromPeer(kPeerUuid, response, &more_pending);
+  ASSERT_TRUE(more_pending);
+
+  ASSERT_OK(queue_->RequestForPeer(kPeerUuid, &requests[2], &refs[2], &needs_remote_bootstrap));
+  ASSERT_GT(requests[2].ops_size(), 0);
+  ASSERT_OPID_EQ(second_last, requests[2].preceding_id());
+
+  // The third request did not make it to the peer, so it is sent again.
+  ConsensusResponsePB lmp_response;
+  lmp_response.set_responder_uuid(kPeerUuid);
+  RefuseWithLogPropertyMismatch(&lmp_response, second_last, second_last);
+  lmp_response.mutable_status()->set_last_committed_idx(second_last.index());
+  queue_->ResponseFromPeer(kPeerUuid, lmp_response, &more_pending);
+  ASSERT_TRUE(more_pending);
+
+  ASSERT_OK(queue_->RequestForPeer(kPeerUuid, &requests[3], &refs[3], &needs_remote_bootstrap));
+  ASSERT_EQ(requests[2].ops_size(), requests[3].ops_size());
+  ASSERT_OPID_EQ(second_last, requests[3].preceding_id());
+}
+
 TEST_F(ConsensusQueueTest, TestPeersDontAckBeyondWatermarks) {
   queue_->Init(MinimumOpId());
   queue_->SetLeaderMode(MinimumOpId(), MinimumOpId().term(), BuildRaftConfigPBForTests(3));
@@ -93,9 +93,18 @@ TAG_FLAG(consensus_inject_latency_ms_in_notifications, hidden);
 TAG_FLAG(consensus_inject_latency_ms_in_notifications, unsafe);
 
 DECLARE_int32(rpc_max_message_size);
+DECLARE_int32(raft_quiesce_after_idle_ms);
+DECLARE_int32(consensus_max_in_flight_requests_per_peer);
 
 DEFINE_bool(propagate_safe_time, true, "Propagate safe time to read from leader to followers");
 
+DEFINE_int32(cache_hints_interval_ms, 10000,
+             "How often the leader sends the keys that are frequently accessed on it to each "
+             "follower, so the follower keeps their blocks in its block cache. Zero disables "
+             "cache hints.");
+TAG_FLAG(cache_hints_interval_ms, advanced);
+TAG_FLAG(cache_hints_interval_ms, runtime);
+
 namespace yb {
 namespace consensus {
 
@@ -115,6 +124,28 @@ METRIC_DEFINE_gauge_int64(tablet, in_progress_ops, "Leader Operations in Progres
                           "Number of operations in the leader queue ack'd by a minority of "
                           "peers.");
 
+namespace {
+
+// Whether several requests could be in flight to the same peer.
+bool PipelineRequests() {
+  return FLAGS_consensus_max_in_flight_requests_per_peer > 1;
+}
+
+// Updates the last op received by the peer, and the next index to send it. If 'keep_progress' is
+// true, neither of them is moved back.
+void UpdateLastReceived(
+    const OpId& last_received, bool keep_progress, PeerMessageQueue::TrackedPeer* peer) {
+  if (!keep_progress || OpIdLessThan(peer->last_received, last_received)) {
+    peer->last_received = last_received;
+  }
+  const int64_t next_index = peer->last_received.index() + 1;
+  if (!keep_progress || peer->next_index < next_index) {
+    peer->next_index = next_index;
+  }
+}
+
+} // namespace
+
 std::string PeerMessageQueue::TrackedPeer::ToString() const {
   return Substitute("Peer: $0, Is new: $1, Last received: $2, Next index: $3, "
                     "Last known committed idx: $4, Last exchange result: $5, "
@@ -138,13 +169,14 @@ PeerMessageQueue::PeerMessageQueue(const scoped_refptr<MetricEntity>& metric_ent
                                    const RaftPeerPB& local_peer_pb,
                                    const string& tablet_id,
                                    const server::ClockPtr& clock,
-                                   unique_ptr<ThreadPoolToken> raft_pool_token)
+                                   unique_ptr<ThreadPoolToken> raft_pool_token,
+                                   ThreadPool* log_prefetch_pool)
     : raft_pool_observers_token_(std::move(raft_pool_token)),
       local_peer_pb_(local_peer_pb),
       local_peer_uuid_(local_peer_pb_.has_permanent_uuid() ? local_peer_pb_.permanent_uuid()
                                                            : string()),
       tablet_id_(tablet_id),
-      log_cache_(metric_entity, log, local_peer_pb.permanent_uuid(), tablet_id),
+      log_cache_(metric_entity, log, local_peer_pb.permanent_uuid(), tablet_id, log_prefetch_pool),
       metrics_(metric_entity),
       clock_(clock) {
   DCHECK(local_peer_pb_.has_permanent_uuid());
@@ -182,6 +214,7 @@ void PeerMessageQueue::SetLeaderMode(const OpId& committed_index,
   // Reset last communication time with all peers to reset the clock on the
   // failure timeout.
   MonoTime now(MonoTime::Now());
+  last_activity_time_ = now;
   for (const PeersMap::value_type& entry : peers_map_) {
     entry.second->last_successful_communication_time = now;
   }
@@ -306,6 +339,7 @@ Status PeerMessageQueue::AppendOperations(const ReplicateMsgs& msgs,
                                                  log_append_callback)));
   lock.lock();
   queue_state_.last_appended = last_id;
+  last_activity_time_ = MonoTime::Now();
   UpdateMetrics();
 
   return Status::OK();
@@ -316,10 +350,16 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
                                         ReplicateMsgs* msg_refs,
                                         bool* needs_remote_bootstrap,
                                         RaftPeerPB::MemberType* member_type,
-                                        bool* last_exchange_successful) {
+                                        bool* last_exchange_successful,
+                                        std::vector<RefCntBuffer>* serialized_ops) {
+  if (serialized_ops) {
+    serialized_ops->clear();
+  }
   TrackedPeer* peer = nullptr;
   OpId preceding_id;
   MonoDelta unreachable_time = MonoDelta::kMin;
+  bool quiescent = false;
+  int64_t next_index;
   {
     LockGuard lock(queue_lock_);
     DCHECK_EQ(queue_state_.state, State::kQueueOpen);
@@ -354,6 +394,19 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
 
     request->set_propagated_hybrid_time(now_ht.ToUint64());
 
+    request->clear_cache_hint_keys();
+    const auto cache_hints_interval_ms = GetAtomicFlag(&FLAGS_cache_hints_interval_ms);
+    if (cache_hints_provider_ && cache_hints_interval_ms > 0) {
+      const MonoTime now = MonoTime::Now();
+      if (now.GetDeltaSince(peer->last_cache_hints_time).ToMilliseconds() >=
+              cache_hints_interval_ms) {
+        peer->last_cache_hints_time = now;
+        for (auto& key : cache_hints_provider_()) {
+          *request->add_cache_hint_keys() = std::move(key);
+        }
+      }
+    }
+
     // Clear the requests without deleting the entries, as they may be in use by other peers.
     request->mutable_ops()->ExtractSubrange(0, request->ops_size(), nullptr);
 
@@ -362,8 +415,14 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
     preceding_id = queue_state_.last_appended;
     request->mutable_committed_index()->CopyFrom(queue_state_.committed_index);
     request->set_caller_term(queue_state_.current_term);
-    unreachable_time =
-        MonoTime::Now().GetDeltaSince(peer->last_successful_communication_time);
+    const MonoTime now = MonoTime::Now();
+    unreachable_time = now.GetDeltaSince(peer->last_successful_communication_time);
+    // The follower could stop expecting regular heartbeats only if it does not miss anything.
+    quiescent = !peer->is_new && IsQuiescentUnlocked(now) &&
+                OpIdEquals(peer->last_received, queue_state_.last_appended) &&
+                peer->last_known_committed_idx == queue_state_.committed_index.index();
+    // Responses to other requests in flight could change the next index concurrently.
+    next_index = peer->next_index;
   }
 
   if (unreachable_time.ToSeconds() > FLAGS_follower_unavailable_considered_failed_sec) {
@@ -398,10 +457,11 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
     int max_batch_size = FLAGS_consensus_max_batch_size_bytes - request->ByteSize();
 
     // We try to get the follower's next_index from our log.
-    Status s = log_cache_.ReadOps(peer->next_index - 1,
+    Status s = log_cache_.ReadOps(next_index - 1,
                                   max_batch_size,
                                   &messages,
-                                  &preceding_id);
+                                  &preceding_id,
+                                  serialized_ops);
     if (PREDICT_FALSE(!s.ok())) {
       if (PREDICT_TRUE(s.IsNotFound())) {
         // It's normal to have a NotFound() here if a follower falls behind where
@@ -433,12 +493,25 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
     for (const auto& msg : messages) {
       request->mutable_ops()->AddAllocated(msg.get());
     }
+    if (PipelineRequests() && !messages.empty()) {
+      // The next request could be sent before this one is responded, so it should continue with
+      // the ops after these. An LMP mismatch error rewinds the peer if any of them is lost.
+      LockGuard lock(queue_lock_);
+      if (peer->next_index == next_index) {
+        peer->next_index = messages.back()->id().index() + 1;
+      }
+    }
     msg_refs->swap(messages);
     DCHECK_LE(request->ByteSize(), FLAGS_consensus_max_batch_size_bytes);
   }
 
   DCHECK(preceding_id.IsInitialized());
   request->mutable_preceding_id()->CopyFrom(preceding_id);
+  if (quiescent && request->ops_size() == 0) {
+    request->set_quiescent(true);
+  } else {
+    request->clear_quiescent();
+  }
 
   if (PREDICT_FALSE(VLOG_IS_ON(2))) {
     if (request->ops_size() > 0) {
@@ -455,6 +528,17 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
   return Status::OK();
 }
 
+Status PeerMessageQueue::ReadCommittedOps(
+    int64_t after_op_index, int64_t committed_index, int max_size_bytes, ReplicateMsgs* msgs) {
+  OpId preceding_id;
+  RETURN_NOT_OK(log_cache_.ReadOps(after_op_index, max_size_bytes, msgs, &preceding_id));
+  // The log cache could return operations that are replicated, but not committed yet.
+  while (!msgs->empty() && msgs->back()->id().index() > committed_index) {
+    msgs->pop_back();
+  }
+  return Status::OK();
+}
+
 Status PeerMessageQueue::GetRemoteBootstrapRequestForPeer(const string& uuid,
                                                           StartRemoteBootstrapRequestPB* req) {
   TrackedPeer* peer = nullptr;
@@ -672,6 +756,21 @@ OpId PeerMessageQueue::OpIdWatermark() {
   return GetWatermark<Policy>();
 }
 
+bool PeerMessageQueue::IsQuiescentUnlocked(MonoTime now) const {
+  const auto idle_ms = GetAtomicFlag(&FLAGS_raft_quiesce_after_idle_ms);
+  return idle_ms > 0 && queue_state_.mode == Mode::LEADER &&
+         now.GetDeltaSince(last_activity_time_).ToMilliseconds() >= idle_ms &&
+         OpIdEquals(queue_state_.committed_index, queue_state_.last_appended);
+}
+
+bool PeerMessageQueue::RecordActivity() {
+  LockGuard lock(queue_lock_);
+  const MonoTime now = MonoTime::Now();
+  const bool was_quiescent = IsQuiescentUnlocked(now);
+  last_activity_time_ = now;
+  return was_quiescent;
+}
+
 void PeerMessageQueue::NotifyPeerIsResponsiveDespiteError(const std::string& peer_uuid) {
   LockGuard l(queue_lock_);
   TrackedPeer* peer = FindPtrOrNull(peers_map_, peer_uuid);
@@ -681,7 +780,8 @@ void PeerMessageQueue::NotifyPeerIsResponsiveDespiteError(const std::string& pee
 
 void PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
                                         const ConsensusResponsePB& response,
-                                        bool* more_pending) {
+                                        bool* more_pending,
+                                        const FollowerLeaseSent* lease_sent) {
   DCHECK(response.IsInitialized()) << "Error: Uninitialized: "
       << response.InitializationErrorString() << ". Response: " << response.ShortDebugString();
 
@@ -755,18 +855,19 @@ void PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
     // sent them anything, start after the last-committed op in their log, which
     // is guaranteed by the Raft protocol to be a valid op.
 
+    // When requests are pipelined, a successful response could be older than another one that was
+    // already handled, and ops after the ones it acknowledges could already be in flight.
+    const bool keep_progress = PipelineRequests() && !status.has_error();
     bool peer_has_prefix_of_log = IsOpInLog(status.last_received());
     if (peer_has_prefix_of_log) {
       // If the latest thing in their log is in our log, we are in sync.
-      peer->last_received = status.last_received();
-      peer->next_index = peer->last_received.index() + 1;
+      UpdateLastReceived(status.last_received(), keep_progress, peer);
 
     } else if (!OpIdEquals(status.last_received_current_leader(), MinimumOpId())) {
       // Their log may have diverged from ours, however we are in the process
       // of replicating our ops to them, so continue doing so. Eventually, we
       // will cause the divergent entry in their log to be overwritten.
-      peer->last_received = status.last_received_current_leader();
-      peer->next_index = peer->last_received.index() + 1;
+      UpdateLastReceived(status.last_received_current_leader(), keep_progress, peer);
 
     } else {
       // The peer is divergent and they have not (successfully) received
@@ -844,11 +945,21 @@ void PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
       }
       majority_replicated.op_id = queue_state_.majority_replicated_opid;
 
-      peer->last_leader_lease_expiration_received_by_follower =
-          peer->last_leader_lease_expiration_sent_to_follower;
+      if (lease_sent) {
+        // Responses to pipelined requests could arrive out of order, so the leases never go back.
+        peer->last_leader_lease_expiration_received_by_follower = std::max(
+            peer->last_leader_lease_expiration_received_by_follower,
+            lease_sent->leader_lease_expiration);
+        peer->last_ht_lease_expiration_received_by_follower = std::max(
+            peer->last_ht_lease_expiration_received_by_follower,
+            lease_sent->ht_lease_expiration);
+      } else {
+        peer->last_leader_lease_expiration_received_by_follower =
+            peer->last_leader_lease_expiration_sent_to_follower;
 
-      peer->last_ht_lease_expiration_received_by_follower =
-          peer->last_ht_lease_expiration_sent_to_follower;
+        peer->last_ht_lease_expiration_received_by_follower =
+            peer->last_ht_lease_expiration_sent_to_follower;
+      }
 
       majority_replicated.leader_lease_expiration = LeaderLeaseExpirationWatermark();
 
@@ -1097,6 +1208,22 @@ bool PeerMessageQueue::CanPeerBecomeLeader(const std::string& peer_uuid) const {
   return peer_can_be_leader;
 }
 
+std::string PeerMessageQueue::GetUpToDatePeer(const std::vector<std::string>& candidates) const {
+  std::lock_guard<simple_spinlock> lock(queue_lock_);
+  const TrackedPeer* best = nullptr;
+  for (const auto& uuid : candidates) {
+    const TrackedPeer* peer = FindPtrOrNull(peers_map_, uuid);
+    if (peer == nullptr || !peer->is_last_exchange_successful ||
+        OpIdLessThan(peer->last_received, queue_state_.majority_replicated_opid)) {
+      continue;
+    }
+    if (best == nullptr || OpIdLessThan(best->last_received, peer->last_received)) {
+      best = peer;
+    }
+  }
+  return best != nullptr ? best->uuid : std::string();
+}
+
 PeerMessageQueue::~PeerMessageQueue() {
   Close();
 }
@@ -62,6 +62,7 @@ template<class T>
 class AtomicGauge;
 class MemTracker;
 class MetricEntity;
+class ThreadPool;
 class ThreadPoolToken;
 
 namespace log {
@@ -82,10 +83,20 @@ extern const char kConsensusQueueParentTrackerId[];
 // This also takes care of pushing requests to peers as new operations are added, and notifying
 // RaftConsensus when the commit index advances.
 //
+// Leader leases that were sent to a follower with a particular request. When several requests are
+// in flight to the same follower, the leases are established by the response to the request that
+// carried them, rather than by the latest one sent.
+struct FollowerLeaseSent {
+  MonoTime leader_lease_expiration;
+  MicrosTime ht_lease_expiration = HybridTime::kMin.GetPhysicalValueMicros();
+};
+
 // This class is used only on the LEADER side.
 //
-// TODO Currently this class is able to track one outstanding operation per peer. If we want to have
-// more than one outstanding RPC we need to modify it.
+// Up to --consensus_max_in_flight_requests_per_peer requests could be outstanding to each peer.
+// When more than one is allowed, the next index of the peer is advanced as soon as ops are read for
+// it, and responses that arrive out of order never move the peer back, except for LMP mismatch
+// errors, which rewind it as usual.
 class PeerMessageQueue {
  public:
   struct TrackedPeer {
@@ -148,6 +159,9 @@ class PeerMessageQueue {
     // Whether the follower was detected to need remote bootstrap.
     bool needs_remote_bootstrap = false;
 
+    // The last time cache hints were sent to this peer.
+    MonoTime last_cache_hints_time = MonoTime::Min();
+
     // Member type of this peer in the config.
     RaftPeerPB::MemberType member_type = RaftPeerPB::UNKNOWN_MEMBER_TYPE;
 
@@ -158,12 +172,14 @@ class PeerMessageQueue {
     int64_t last_seen_term_ = 0;
   };
 
+  // log_prefetch_pool, when specified, runs log cache read ahead for lagging peers, see LogCache.
   PeerMessageQueue(const scoped_refptr<MetricEntity>& metric_entity,
                    const scoped_refptr<log::Log>& log,
                    const RaftPeerPB& local_peer_pb,
                    const std::string& tablet_id,
                    const server::ClockPtr& clock,
-                   std::unique_ptr<ThreadPoolToken> raft_pool_observers_token);
+                   std::unique_ptr<ThreadPoolToken> raft_pool_observers_token,
+                   ThreadPool* log_prefetch_pool = nullptr);
 
   // Initialize the queue.
   virtual void Init(const OpId& last_locally_replicated);
@@ -230,13 +246,22 @@ class PeerMessageQueue {
   // not delete the entries. The simplest way is to pass the same instance of ConsensusRequestPB to
   // RequestForPeer(): the buffer will replace the old entries with new ones without de-allocating
   // the old ones if they are still required.
+  //
+  // If 'serialized_ops' is not null, it is filled with the wire format of each of the ops added to
+  // 'request', shared with other peers. See LogCache::ReadOps().
   virtual CHECKED_STATUS RequestForPeer(
       const std::string& uuid,
       ConsensusRequestPB* request,
       ReplicateMsgs* msg_refs,
       bool* needs_remote_bootstrap,
       RaftPeerPB::MemberType* member_type = nullptr,
-      bool* last_exchange_successful = nullptr);
+      bool* last_exchange_successful = nullptr,
+      std::vector<RefCntBuffer>* serialized_ops = nullptr);
+
+  // Reads operations following 'after_op_index' up to 'committed_index' inclusive, limited to
+  // about 'max_size_bytes', for readers other than peers, e.g. change data capture.
+  CHECKED_STATUS ReadCommittedOps(
+      int64_t after_op_index, int64_t committed_index, int max_size_bytes, ReplicateMsgs* msgs);
 
   // Fill in a StartRemoteBootstrapRequest for the specified peer.  If that peer should not remotely
   // bootstrap, returns a non-OK status.  On success, also internally resets
@@ -252,9 +277,17 @@ class PeerMessageQueue {
 
   // Updates the request queue with the latest response of a peer, returns whether this peer has
   // more requests pending.
+  // If 'lease_sent' is not null, it contains the leases that were sent with the request this is the
+  // response to. Otherwise the leases sent with the latest request are considered received.
   virtual void ResponseFromPeer(const std::string& peer_uuid,
                                 const ConsensusResponsePB& response,
-                                bool* more_pending);
+                                bool* more_pending,
+                                const FollowerLeaseSent* lease_sent = nullptr);
+
+  // Records activity that requires regular heartbeats, e.g. a read that needs the leader lease,
+  // so the queue stops being quiescent. See --raft_quiesce_after_idle_ms.
+  // Returns true if the queue was quiescent.
+  bool RecordActivity();
 
   // Closes the queue, peers are still allowed to call UntrackPeer() and ResponseFromPeer() but no
   // additional peers can be tracked or messages queued.
@@ -281,6 +314,10 @@ class PeerMessageQueue {
 
   bool CanPeerBecomeLeader(const std::string& peer_uuid) const;
 
+  // Returns the uuid of the peer among 'candidates' that has received the most operations and
+  // can become leader, or an empty string if there is no such peer.
+  std::string GetUpToDatePeer(const std::vector<std::string>& candidates) const;
+
   struct Metrics {
     // Keeps track of the number of ops. that are completed by a majority but still need
     // to be replicated to a minority (IsDone() is true, IsAllDone() is false).
@@ -300,6 +337,10 @@ class PeerMessageQueue {
     propagated_safe_time_provider_ = std::move(provider);
   }
 
+  void SetCacheHintsProvider(std::function<std::vector<std::string>()> provider) {
+    cache_hints_provider_ = std::move(provider);
+  }
+
  private:
   FRIEND_TEST(ConsensusQueueTest, TestQueueAdvancesCommittedIndex);
 
@@ -413,6 +454,10 @@ class PeerMessageQueue {
   // Updates op id replicated on each node.
   void UpdateAllReplicatedOpId(OpId* result);
 
+  // Whether the leader had no activity for --raft_quiesce_after_idle_ms, and all operations it has
+  // are committed.
+  bool IsQuiescentUnlocked(MonoTime now) const;
+
   // Policy is responsible for tuning of watermark calculation.
   // I.e. simple leader lease or hybrid time leader lease etc.
   // It should provide result type and a function for extracting a value from a peer.
@@ -436,6 +481,9 @@ class PeerMessageQueue {
 
   QueueState queue_state_;
 
+  // The time of the latest append or explicitly recorded activity, used to detect quiescence.
+  MonoTime last_activity_time_ = MonoTime::Now();
+
   // The currently tracked peers.
   PeersMap peers_map_;
   TrackedPeer* local_peer_ = nullptr;
@@ -455,6 +503,7 @@ class PeerMessageQueue {
   server::ClockPtr clock_;
 
   std::function<HybridTime()> propagated_safe_time_provider_;
+  std::function<std::vector<std::string>()> cache_hints_provider_;
 };
 
 inline std::ostream& operator <<(std::ostream& out, PeerMessageQueue::Mode mode) {
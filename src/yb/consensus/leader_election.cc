@@ -380,7 +380,12 @@ void LeaderElection::HandleHigherTermUnlocked(const string& voter_uuid, const Vo
 
 void LeaderElection::HandleVoteGrantedUnlocked(const string& voter_uuid, const VoterState& state) {
   DCHECK(lock_.is_locked());
-  DCHECK_EQ(state.response.responder_term(), election_term());
+  // Pre-election voters do not advance their term.
+  if (request_.preelection()) {
+    DCHECK_LE(state.response.responder_term(), election_term());
+  } else {
+    DCHECK_EQ(state.response.responder_term(), election_term());
+  }
   DCHECK(state.response.vote_granted());
   if (state.response.has_remaining_leader_lease_duration_ms()) {
     old_leader_lease_expiration_.MakeAtLeast(MonoTime::Now() +
@@ -413,10 +418,11 @@ void LeaderElection::HandleVoteDeniedUnlocked(const string& voter_uuid, const Vo
 }
 
 std::string LeaderElection::LogPrefix() const {
-  return Substitute("T $0 P $1 [CANDIDATE]: Term $2 election: ",
+  return Substitute("T $0 P $1 [CANDIDATE]: Term $2 $3: ",
                     request_.tablet_id(),
                     request_.candidate_uuid(),
-                    request_.candidate_term());
+                    request_.candidate_term(),
+                    request_.preelection() ? "pre-election" : "election");
 }
 
 } // namespace consensus
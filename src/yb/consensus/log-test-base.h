@@ -62,6 +62,7 @@
 #include "yb/util/test_macros.h"
 #include "yb/util/test_util.h"
 #include "yb/util/stopwatch.h"
+#include "yb/util/threadpool.h"
 #include "yb/docdb/docdb.pb.h"
 #include "yb/docdb/doc_key.h"
 
@@ -179,6 +180,7 @@ class LogTestBase : public YBTest {
                        schema_with_ids,
                        0, // schema_version
                        metric_entity_.get(),
+                       append_pool_.get(),
                        &log_));
   }
 
@@ -301,6 +303,8 @@ class LogTestBase : public YBTest {
   gscoped_ptr<FsManager> fs_manager_;
   gscoped_ptr<MetricRegistry> metric_registry_;
   scoped_refptr<MetricEntity> metric_entity_;
+  // When set, the log built by BuildLog() appends entries using this pool.
+  std::unique_ptr<ThreadPool> append_pool_;
   scoped_refptr<Log> log_;
   int32_t current_index_;
   LogOptions options_;
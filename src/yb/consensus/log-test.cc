@@ -52,10 +52,13 @@ DEFINE_int32(num_batches, 10000,
              "Number of batches to write to/read from the Log in TestWriteManyBatches");
 
 DECLARE_int32(log_min_segments_to_retain);
+DECLARE_int32(log_group_commit_max_hold_us);
 DECLARE_bool(never_fsync);
 DECLARE_bool(writable_file_use_fsync);
 DECLARE_int32(o_direct_block_alignment_bytes);
 DECLARE_int32(o_direct_block_size_bytes);
+DECLARE_bool(log_compress_entries);
+DECLARE_int32(log_max_recycled_segments);
 
 namespace yb {
 namespace log {
@@ -222,6 +225,45 @@ TEST_F(LogTest, TestFsync) {
   ASSERT_OK(log_->Close());
 }
 
+// Tests that group commits could be held waiting for more entries when every append is fsynced.
+TEST_F(LogTest, TestFsyncWithGroupCommitHold) {
+  FLAGS_never_fsync = false;
+  FLAGS_log_group_commit_max_hold_us = 1000;
+  options_.durable_wal_write = true;
+  BuildLog();
+
+  OpId opid;
+  opid.set_term(0);
+  for (int i = 1; i <= 10; ++i) {
+    opid.set_index(i);
+    ASSERT_OK(AppendNoOp(&opid));
+  }
+  ASSERT_OK(log_->Close());
+}
+
+// Tests that entries are appended when the log uses a shared append thread pool.
+TEST_F(LogTest, TestAppendThreadPool) {
+  ASSERT_OK(ThreadPoolBuilder("log-append").set_max_threads(1).Build(&append_pool_));
+  BuildLog();
+
+  const int kNumEntries = 100;
+  OpId opid;
+  opid.set_term(1);
+  opid.set_index(1);
+  ASSERT_OK(AppendNoOps(&opid, kNumEntries));
+
+  ASSERT_OK(log_->AllocateSegmentAndRollOver());
+
+  LogEntries entries;
+  SegmentSequence segments;
+  ASSERT_OK(log_->GetLogReader()->GetSegmentsSnapshot(&segments));
+  ASSERT_OK(segments[0]->ReadEntries(&entries));
+  ASSERT_EQ(kNumEntries, entries.size());
+
+  ASSERT_OK(log_->Close());
+  append_pool_->Shutdown();
+}
+
 // Tests interval for durable wal write
 TEST_F(LogTest, TestFsyncInterval) {
   options_.interval_durable_wal_write = MonoDelta::FromMilliseconds(1);
@@ -802,6 +844,113 @@ TEST_F(LogTest, TestWriteManyBatches) {
   }
 }
 
+TEST_F(LogTest, TestCompressedEntries) {
+  FLAGS_log_compress_entries = true;
+  const int kNumBatches = 10;
+  BuildLog();
+  AppendReplicateBatchToLog(kNumBatches, kTableType);
+  ASSERT_OK(log_->Close());
+
+  std::unique_ptr<LogReader> reader;
+  ASSERT_OK(LogReader::Open(fs_manager_.get(), nullptr, kTestTablet, tablet_wal_path_, nullptr,
+                            &reader));
+  SegmentSequence segments;
+  ASSERT_OK(reader->GetSegmentsSnapshot(&segments));
+  size_t num_entries = 0;
+  for (const auto& segment : segments) {
+    ASSERT_EQ(LZ4_COMPRESSION, segment->header().compression_codec());
+    entries_.clear();
+    ASSERT_OK(segment->ReadEntries(&entries_));
+    for (const auto& entry : entries_) {
+      ASSERT_TRUE(entry->has_replicate());
+      ASSERT_EQ(num_entries + 1, entry->replicate().id().index());
+      ++num_entries;
+    }
+  }
+  ASSERT_EQ(kNumBatches, num_entries);
+}
+
+TEST_F(LogTest, TestRecycledSegments) {
+  FLAGS_log_max_recycled_segments = 2;
+  BuildLog();
+
+  vector<LogAnchor*> anchors;
+  ElementDeleter deleter(&anchors);
+
+  const int kNumTotalSegments = 4;
+  const int kNumOpsPerSegment = 5;
+  OpId op_id = MakeOpId(1, 1);
+  ASSERT_OK(AppendMultiSegmentSequence(kNumTotalSegments, kNumOpsPerSegment, &op_id, &anchors));
+
+  auto count_recycled_files = [this] {
+    vector<string> files;
+    CHECK_OK(env_->GetChildren(tablet_wal_path_, &files));
+    return std::count_if(files.begin(), files.end(), [](const string& file) {
+      return HasPrefixString(file, ".tmp.recycled-");
+    });
+  };
+
+  // Files of the GCed segments are kept for reuse.
+  ASSERT_OK(log_anchor_registry_->Unregister(anchors[0]));
+  ASSERT_OK(log_anchor_registry_->Unregister(anchors[1]));
+  int64_t anchored_index = -1;
+  ASSERT_OK(log_anchor_registry_->GetEarliestRegisteredLogIndex(&anchored_index));
+  int num_gced_segments = 0;
+  ASSERT_OK(log_->GC(anchored_index, &num_gced_segments));
+  ASSERT_EQ(2, num_gced_segments);
+  ASSERT_EQ(2, count_recycled_files());
+  CheckRightNumberOfSegmentFiles(2);
+
+  // Write fewer entries to the new segment than the previous segment of its file had, so the
+  // file still has entries of the previous segment after them.
+  ASSERT_OK(RollLog());
+  ASSERT_EQ(1, count_recycled_files());
+  const int64_t first_new_index = op_id.index();
+  ASSERT_OK(AppendNoOps(&op_id, 1));
+
+  SegmentSequence segments;
+  ASSERT_OK(log_->GetLogReader()->GetSegmentsSnapshot(&segments));
+  ASSERT_EQ(3, segments.size());
+  ASSERT_NE(0, segments.back()->header().entry_header_crc_salt());
+
+  // As if the server crashed before the segment was closed, only the entries of the new segment
+  // should be read.
+  const string crashed_path = GetTestPath("crashed-segment");
+  ASSERT_OK(env_util::CopyFile(env_.get(), segments.back()->path(), crashed_path,
+                               WritableFileOptions()));
+  segments.clear();
+  scoped_refptr<ReadableLogSegment> crashed_segment;
+  ASSERT_OK(ReadableLogSegment::Open(env_.get(), crashed_path, &crashed_segment));
+  ASSERT_FALSE(crashed_segment->HasFooter());
+  entries_.clear();
+  ASSERT_OK(crashed_segment->ReadEntries(&entries_));
+  ASSERT_EQ(1, entries_.size());
+  ASSERT_EQ(first_new_index, entries_[0]->replicate().id().index());
+
+  ASSERT_OK(log_->Close());
+
+  // All entries after the GCed ones are read from the closed segments, and the remaining recycled
+  // file is picked up by the reopened log.
+  BuildLog();
+  ASSERT_EQ(0, count_recycled_files());
+  ASSERT_OK(log_->GetLogReader()->GetSegmentsSnapshot(&segments));
+  int64_t expected_index = 2 * kNumOpsPerSegment + 1;
+  for (const auto& segment : segments) {
+    entries_.clear();
+    ASSERT_OK(segment->ReadEntries(&entries_));
+    for (const auto& entry : entries_) {
+      ASSERT_EQ(expected_index, entry->replicate().id().index());
+      ++expected_index;
+    }
+  }
+  ASSERT_EQ(op_id.index(), expected_index);
+  ASSERT_OK(log_->Close());
+
+  for (int i = 2; i < kNumTotalSegments; i++) {
+    ASSERT_OK(log_anchor_registry_->Unregister(anchors[i]));
+  }
+}
+
 // This tests that querying LogReader works.
 // This sets up a reader with some segments to query which amount to the
 // following:
@@ -47,6 +47,7 @@
 #include "yb/gutil/ref_counted.h"
 #include "yb/gutil/stl_util.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/gutil/strings/util.h"
 #include "yb/gutil/walltime.h"
 #include "yb/util/coding.h"
 #include "yb/util/countdown_latch.h"
@@ -61,6 +62,7 @@
 #include "yb/util/path_util.h"
 #include "yb/util/pb_util.h"
 #include "yb/util/random.h"
+#include "yb/util/random_util.h"
 #include "yb/util/size_literals.h"
 #include "yb/util/stopwatch.h"
 #include "yb/util/thread.h"
@@ -96,6 +98,26 @@ DEFINE_int32(group_commit_queue_size_bytes, 4_MB,
              "Maximum size of the group commit queue in bytes");
 TAG_FLAG(group_commit_queue_size_bytes, advanced);
 
+DEFINE_int32(log_group_commit_max_hold_us, 0,
+             "When every append is fsynced, hold a group commit for up to this many microseconds, "
+             "but never longer than the average fsync latency, to let more entry batches share "
+             "one fsync. 0 disables holding.");
+TAG_FLAG(log_group_commit_max_hold_us, advanced);
+TAG_FLAG(log_group_commit_max_hold_us, runtime);
+
+DEFINE_bool(log_compress_entries, false,
+            "Whether new log segments store entry batches compressed with LZ4. Segments written "
+            "this way cannot be read by servers that predate log compression.");
+TAG_FLAG(log_compress_entries, advanced);
+TAG_FLAG(log_compress_entries, runtime);
+
+DEFINE_int32(log_max_recycled_segments, 0,
+             "Maximum number of garbage collected segment files of a log kept for reuse by new "
+             "segments, that overwrite them in place instead of allocating new files. Segments "
+             "written to recycled files cannot be read by servers that predate segment recycling.");
+TAG_FLAG(log_max_recycled_segments, advanced);
+TAG_FLAG(log_max_recycled_segments, runtime);
+
 // Fault/latency injection flags.
 // -----------------------------
 DEFINE_bool(log_inject_latency, false,
@@ -128,6 +150,11 @@ static bool dummy = google::RegisterFlagValidator(
     &FLAGS_log_min_segments_to_retain, &ValidateLogsToRetain);
 
 static const char kSegmentPlaceholderFileTemplate[] = ".tmp.newsegmentXXXXXX";
+static const char kRecycledSegmentFilePrefix[] = ".tmp.recycled-";
+
+static size_t MaxRecycledSegments() {
+  return std::max(FLAGS_log_max_recycled_segments, 0);
+}
 
 namespace yb {
 namespace log {
@@ -138,13 +165,20 @@ using std::shared_ptr;
 using strings::Substitute;
 
 // This class is responsible for managing the thread that appends to the log file.
+//
+// If the log was opened with a shared append thread pool, there is no dedicated thread. Instead,
+// a task is submitted to a serial token of this pool when entries are added to an idle queue, and
+// this task processes groups until the queue becomes empty.
 class Log::AppendThread {
  public:
-  explicit AppendThread(Log* log);
+  AppendThread(Log* log, ThreadPool* append_thread_pool);
 
   // Initializes the objects and starts the thread.
   Status Init();
 
+  // Notifies that new entry batches were added to the queue.
+  void Wakeup();
+
   // Waits until the last enqueued elements are processed, sets the Appender thread to closing
   // state. If any entries are added to the queue during the process, invoke their callbacks'
   // 'OnFailure()' method.
@@ -153,32 +187,93 @@ class Log::AppendThread {
  private:
   void RunThread();
 
+  // Task submitted to the append thread pool.
+  void ProcessQueue();
+
+  // Appends and syncs the group of entry batches and invokes their callbacks.
+  void ProcessGroup(std::vector<LogEntryBatch*>* entry_batches);
+
+  // Waits for more entry batches to be enqueued, when the group commit is going to be fsynced and
+  // fsync is slow enough for waiting to pay off. Returns false if the queue was shut down.
+  bool MaybeHoldGroupCommit(std::vector<LogEntryBatch*>* entry_batches);
+
   Log* const log_;
 
+  ThreadPool* const append_thread_pool_;
+
+  // Token used to submit ProcessQueue tasks, when running in the append thread pool.
+  std::unique_ptr<ThreadPoolToken> append_token_;
+
+  // Whether the ProcessQueue task is submitted and did not yet find the queue empty.
+  std::atomic<bool> task_active_{false};
+
   // Lock to protect access to thread_ during shutdown.
   mutable std::mutex lock_;
   scoped_refptr<Thread> thread_;
 };
 
-Log::AppendThread::AppendThread(Log *log)
-  : log_(log) {
+Log::AppendThread::AppendThread(Log *log, ThreadPool* append_thread_pool)
+  : log_(log), append_thread_pool_(append_thread_pool) {
   DCHECK(dummy);
 }
 
 Status Log::AppendThread::Init() {
   DCHECK(!thread_) << "Already initialized";
+  DCHECK(!append_token_) << "Already initialized";
+  // Periodic sync relies on the wait timeout of the dedicated thread, so it is not supported by
+  // the pool mode.
+  if (append_thread_pool_ && !log_->interval_durable_wal_write_) {
+    std::lock_guard<std::mutex> lock_guard(lock_);
+    append_token_ = append_thread_pool_->NewToken(ThreadPool::ExecutionMode::SERIAL);
+    return Status::OK();
+  }
+  // Dedicated thread does not need wakeups, so pretend that task is always active.
+  task_active_.store(true, std::memory_order_release);
   VLOG(1) << "Starting log append thread for tablet " << log_->tablet_id();
   RETURN_NOT_OK(yb::Thread::Create("log", "appender",
       &AppendThread::RunThread, this, &thread_));
   return Status::OK();
 }
 
+void Log::AppendThread::Wakeup() {
+  if (task_active_.exchange(true, std::memory_order_acq_rel)) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock_guard(lock_);
+  auto status = append_token_
+      ? append_token_->SubmitFunc(std::bind(&AppendThread::ProcessQueue, this))
+      : STATUS(ServiceUnavailable, "Log append token is shut down");
+  if (!status.ok()) {
+    // Shutdown processes the entries left in the queue.
+    VLOG(1) << "T " << log_->tablet_id() << ": Failed to submit log append task: " << status;
+    task_active_.store(false, std::memory_order_release);
+  }
+}
+
+void Log::AppendThread::ProcessQueue() {
+  for (;;) {
+    std::vector<LogEntryBatch*> entry_batches;
+    log_->entry_queue()->DrainTo(&entry_batches);
+    if (entry_batches.empty()) {
+      task_active_.store(false, std::memory_order_release);
+      // Entry batch could be added after the drain while the task was still active, so nobody
+      // would submit a task for it. Recheck the queue and continue processing in this case.
+      if (log_->entry_queue()->empty() ||
+          task_active_.exchange(true, std::memory_order_acq_rel)) {
+        return;
+      }
+      continue;
+    }
+    MaybeHoldGroupCommit(&entry_batches);
+    ProcessGroup(&entry_batches);
+  }
+}
+
 void Log::AppendThread::RunThread() {
   bool shutting_down = false;
 
   while (PREDICT_TRUE(!shutting_down)) {
     std::vector<LogEntryBatch*> entry_batches;
-    ElementDeleter d(&entry_batches);
 
     MonoTime wait_timeout_deadline = MonoTime::kMax;
     if ((log_->interval_durable_wal_write_)
@@ -194,72 +289,141 @@ void Log::AppendThread::RunThread() {
     if (PREDICT_FALSE(!log_->entry_queue()->BlockingDrainTo(&entry_batches,
                                                             wait_timeout_deadline))) {
       shutting_down = true;
+    } else if (!entry_batches.empty() && !MaybeHoldGroupCommit(&entry_batches)) {
+      shutting_down = true;
     }
 
-    auto sleep_duration = log_->sleep_duration_.load(std::memory_order_acquire);
-    if (sleep_duration.count() > 0) {
-      std::this_thread::sleep_for(sleep_duration);
-    }
+    ProcessGroup(&entry_batches);
+  }
+  VLOG(1) << "Exiting AppendThread for tablet " << log_->tablet_id();
+}
 
-    if (log_->metrics_) {
-      log_->metrics_->entry_batches_per_group->Increment(entry_batches.size());
-    }
-    TRACE_EVENT1("log", "batch", "batch_size", entry_batches.size());
+void Log::AppendThread::ProcessGroup(std::vector<LogEntryBatch*>* entry_batches_ptr) {
+  auto& entry_batches = *entry_batches_ptr;
+  ElementDeleter d(&entry_batches);
 
-    SCOPED_LATENCY_METRIC(log_->metrics_, group_commit_latency);
+  auto sleep_duration = log_->sleep_duration_.load(std::memory_order_acquire);
+  if (sleep_duration.count() > 0) {
+    std::this_thread::sleep_for(sleep_duration);
+  }
 
-    for (LogEntryBatch* entry_batch : entry_batches) {
-      TRACE_EVENT_FLOW_END0("log", "Batch", entry_batch);
-      Status s = log_->DoAppend(entry_batch);
-
-      if (PREDICT_FALSE(!s.ok())) {
-        LOG(ERROR) << "Error appending to the log: " << s.ToString();
-        DLOG(FATAL) << "Aborting: " << s.ToString();
-        entry_batch->set_failed_to_append();
-        // TODO If a single operation fails to append, should we abort all subsequent operations
-        // in this batch or allow them to be appended? What about operations in future batches?
-        if (!entry_batch->callback().is_null()) {
-          entry_batch->callback().Run(s);
-        }
-      } else if (!log_->sync_disabled_) {
-        if (!log_->periodic_sync_needed_.load()) {
-          log_->periodic_sync_needed_.store(true);
-          log_->periodic_sync_earliest_unsync_entry_time_ = MonoTime::Now();
-        }
-        log_->periodic_sync_unsynced_bytes_ += entry_batch->total_size_bytes();
-      }
+  if (log_->metrics_) {
+    log_->metrics_->entry_batches_per_group->Increment(entry_batches.size());
+    size_t group_bytes = 0;
+    for (const LogEntryBatch* entry_batch : entry_batches) {
+      group_bytes += entry_batch->total_size_bytes();
     }
+    log_->metrics_->bytes_per_group->Increment(group_bytes);
+  }
+  TRACE_EVENT1("log", "batch", "batch_size", entry_batches.size());
+
+  SCOPED_LATENCY_METRIC(log_->metrics_, group_commit_latency);
+
+  for (LogEntryBatch* entry_batch : entry_batches) {
+    TRACE_EVENT_FLOW_END0("log", "Batch", entry_batch);
+    Status s = log_->DoAppend(entry_batch);
 
-    Status s = log_->Sync();
     if (PREDICT_FALSE(!s.ok())) {
-      LOG(ERROR) << "Error syncing log" << s.ToString();
+      LOG(ERROR) << "Error appending to the log: " << s.ToString();
       DLOG(FATAL) << "Aborting: " << s.ToString();
-      for (LogEntryBatch* entry_batch : entry_batches) {
-        if (!entry_batch->callback().is_null()) {
-          entry_batch->callback().Run(s);
-        }
+      entry_batch->set_failed_to_append();
+      // TODO If a single operation fails to append, should we abort all subsequent operations
+      // in this batch or allow them to be appended? What about operations in future batches?
+      if (!entry_batch->callback().is_null()) {
+        entry_batch->callback().Run(s);
       }
-    } else {
-      TRACE_EVENT0("log", "Callbacks");
-      VLOG(2) << "Synchronized " << entry_batches.size() << " entry batches";
-      SCOPED_WATCH_STACK(100);
-      for (LogEntryBatch* entry_batch : entry_batches) {
-        if (PREDICT_TRUE(!entry_batch->failed_to_append() && !entry_batch->callback().is_null())) {
-          entry_batch->callback().Run(Status::OK());
-        }
-        // It's important to delete each batch as we see it, because deleting it may free up memory
-        // from memory trackers, and the callback of a later batch may want to use that memory.
-        delete entry_batch;
+    } else if (!log_->sync_disabled_) {
+      if (!log_->periodic_sync_needed_.load()) {
+        log_->periodic_sync_needed_.store(true);
+        log_->periodic_sync_earliest_unsync_entry_time_ = MonoTime::Now();
       }
-      entry_batches.clear();
+      log_->periodic_sync_unsynced_bytes_ += entry_batch->total_size_bytes();
     }
   }
-  VLOG(1) << "Exiting AppendThread for tablet " << log_->tablet_id();
+
+  Status s = log_->Sync();
+  if (PREDICT_FALSE(!s.ok())) {
+    LOG(ERROR) << "Error syncing log" << s.ToString();
+    DLOG(FATAL) << "Aborting: " << s.ToString();
+    for (LogEntryBatch* entry_batch : entry_batches) {
+      if (!entry_batch->callback().is_null()) {
+        entry_batch->callback().Run(s);
+      }
+    }
+  } else {
+    TRACE_EVENT0("log", "Callbacks");
+    VLOG(2) << "Synchronized " << entry_batches.size() << " entry batches";
+    SCOPED_WATCH_STACK(100);
+    for (LogEntryBatch* entry_batch : entry_batches) {
+      if (PREDICT_TRUE(!entry_batch->failed_to_append() && !entry_batch->callback().is_null())) {
+        entry_batch->callback().Run(Status::OK());
+      }
+      // It's important to delete each batch as we see it, because deleting it may free up memory
+      // from memory trackers, and the callback of a later batch may want to use that memory.
+      delete entry_batch;
+    }
+    entry_batches.clear();
+  }
+}
+
+bool Log::AppendThread::MaybeHoldGroupCommit(std::vector<LogEntryBatch*>* entry_batches) {
+  const int64_t max_hold_us = GetAtomicFlag(&FLAGS_log_group_commit_max_hold_us);
+  if (max_hold_us <= 0 || !log_->durable_wal_write_ || log_->sync_disabled_) {
+    return true;
+  }
+  const int64_t hold_us = std::min(
+      max_hold_us, log_->avg_fsync_latency_us_.load(std::memory_order_relaxed));
+  if (hold_us <= 0) {
+    return true;
+  }
+
+  const MonoTime start = MonoTime::Now();
+  const MonoTime deadline = start + MonoDelta::FromMicroseconds(hold_us);
+  const size_t max_group_bytes = FLAGS_group_commit_queue_size_bytes;
+  size_t group_bytes = 0;
+  for (const LogEntryBatch* entry_batch : *entry_batches) {
+    group_bytes += entry_batch->total_size_bytes();
+  }
+  bool result = true;
+  while (group_bytes < max_group_bytes) {
+    const size_t old_size = entry_batches->size();
+    if (!log_->entry_queue()->BlockingDrainTo(entry_batches, deadline)) {
+      result = false;
+      break;
+    }
+    if (entry_batches->size() == old_size) {
+      // Reached the deadline without new entries.
+      break;
+    }
+    for (size_t i = old_size; i != entry_batches->size(); ++i) {
+      group_bytes += (*entry_batches)[i]->total_size_bytes();
+    }
+  }
+  if (log_->metrics_) {
+    log_->metrics_->group_commit_hold_time->Increment(
+        MonoTime::Now().GetDeltaSince(start).ToMicroseconds());
+  }
+  return result;
 }
 
 void Log::AppendThread::Shutdown() {
   log_->entry_queue()->Shutdown();
-  std::lock_guard<std::mutex> lock_guard(lock_);
+  std::unique_lock<std::mutex> lock(lock_);
+  if (append_token_) {
+    VLOG(1) << "Shutting down log append task for tablet " << log_->tablet_id();
+    // Waits for the running task and rejects new submissions. Queue is already shut down, so
+    // entries left in it could be processed here without a race. Token is destroyed here, because
+    // the log could outlive the append thread pool.
+    append_token_->Shutdown();
+    append_token_.reset();
+    lock.unlock();
+    std::vector<LogEntryBatch*> entry_batches;
+    log_->entry_queue()->DrainTo(&entry_batches);
+    if (!entry_batches.empty()) {
+      ProcessGroup(&entry_batches);
+    }
+    return;
+  }
   if (thread_) {
     VLOG(1) << "Shutting down log append thread for tablet " << log_->tablet_id();
     CHECK_OK(ThreadJoiner(thread_.get()).Join());
@@ -268,7 +432,7 @@ void Log::AppendThread::Shutdown() {
   }
 }
 
-// This task is submitted to allocation_pool_ in order to asynchronously pre-allocate new log
+// This task is submitted to allocation_token_ in order to asynchronously pre-allocate new log
 // segments.
 void Log::SegmentAllocationTask() {
   allocation_status_.Set(PreAllocateNewSegment());
@@ -284,6 +448,7 @@ Status Log::Open(const LogOptions &options,
                  const Schema& schema,
                  uint32_t schema_version,
                  const scoped_refptr<MetricEntity>& metric_entity,
+                 ThreadPool* append_thread_pool,
                  scoped_refptr<Log>* log) {
 
   RETURN_NOT_OK_PREPEND(fs_manager->CreateDirIfMissing(DirName(tablet_wal_path)),
@@ -299,7 +464,8 @@ Status Log::Open(const LogOptions &options,
                                      tablet_wal_path,
                                      schema,
                                      schema_version,
-                                     metric_entity));
+                                     metric_entity,
+                                     append_thread_pool));
   RETURN_NOT_OK(new_log->Init());
   log->swap(new_log);
   return Status::OK();
@@ -307,7 +473,7 @@ Status Log::Open(const LogOptions &options,
 
 Log::Log(LogOptions options, FsManager* fs_manager, string log_path,
          string tablet_id, string tablet_wal_path, const Schema& schema, uint32_t schema_version,
-         const scoped_refptr<MetricEntity>& metric_entity)
+         const scoped_refptr<MetricEntity>& metric_entity, ThreadPool* append_thread_pool)
     : options_(std::move(options)),
       fs_manager_(fs_manager),
       log_dir_(std::move(log_path)),
@@ -319,7 +485,7 @@ Log::Log(LogOptions options, FsManager* fs_manager, string log_path,
       log_state_(kLogInitialized),
       max_segment_size_(options_.segment_size_bytes),
       entry_batch_queue_(FLAGS_group_commit_queue_size_bytes),
-      append_thread_(new AppendThread(this)),
+      append_thread_(new AppendThread(this, append_thread_pool)),
       durable_wal_write_(options_.durable_wal_write),
       interval_durable_wal_write_(options_.interval_durable_wal_write),
       bytes_durable_wal_write_mb_(options_.bytes_durable_wal_write_mb),
@@ -327,7 +493,15 @@ Log::Log(LogOptions options, FsManager* fs_manager, string log_path,
       allocation_state_(kAllocationNotStarted),
       metric_entity_(metric_entity),
       on_disk_size_(0) {
-  CHECK_OK(ThreadPoolBuilder("log-alloc").set_max_threads(1).Build(&allocation_pool_));
+  // Synchronous roll over waits for the allocation from the append task, that could occupy the last
+  // thread of the shared pool, so it requires a dedicated allocation thread.
+  ThreadPool* allocation_pool =
+      options_.async_preallocate_segments ? append_thread_pool : nullptr;
+  if (!allocation_pool) {
+    CHECK_OK(ThreadPoolBuilder("log-alloc").set_max_threads(1).Build(&allocation_pool_));
+    allocation_pool = allocation_pool_.get();
+  }
+  allocation_token_ = allocation_pool->NewToken(ThreadPool::ExecutionMode::SERIAL);
   if (metric_entity_) {
     metrics_.reset(new LogMetrics(metric_entity_));
   }
@@ -356,6 +530,7 @@ Status Log::Init() {
     RETURN_NOT_OK(reader_->GetSegmentsSnapshot(&segments));
     active_segment_sequence_number_ = segments.back()->header().sequence_number();
   }
+  RETURN_NOT_OK(LoadRecycledSegments());
 
   if (durable_wal_write_) {
     YB_LOG_FIRST_N(INFO, 1) << "durable_wal_write is turned on.";
@@ -384,7 +559,7 @@ Status Log::AsyncAllocateSegment() {
   CHECK_EQ(allocation_state_, kAllocationNotStarted);
   allocation_status_.Reset();
   allocation_state_ = kAllocationInProgress;
-  return allocation_pool_->SubmitClosure(Bind(&Log::SegmentAllocationTask, Unretained(this)));
+  return allocation_token_->SubmitClosure(Bind(&Log::SegmentAllocationTask, Unretained(this)));
 }
 
 Status Log::CloseCurrentSegment() {
@@ -460,6 +635,7 @@ Status Log::AsyncAppend(LogEntryBatch* entry_batch, const StatusCallback& callba
     delete entry_batch;
     return kLogShutdownStatus;
   }
+  append_thread_->Wakeup();
 
   return Status::OK();
 }
@@ -600,6 +776,16 @@ FsManager* Log::GetFsManager() {
   return fs_manager_;
 }
 
+void Log::UpdateAverageFsyncLatency(MonoDelta latency) {
+  // Weight of the latest measurement in the moving average.
+  constexpr int64_t kLatestWeightInverse = 8;
+  const int64_t latency_us = latency.ToMicroseconds();
+  const int64_t old_avg = avg_fsync_latency_us_.load(std::memory_order_relaxed);
+  avg_fsync_latency_us_.store(
+      old_avg == 0 ? latency_us : old_avg + (latency_us - old_avg) / kLatestWeightInverse,
+      std::memory_order_relaxed);
+}
+
 Status Log::Sync() {
   TRACE_EVENT0("log", "Sync");
   SCOPED_LATENCY_METRIC(metrics_, sync_latency);
@@ -635,7 +821,12 @@ Status Log::Sync() {
       periodic_sync_needed_.store(false);
       periodic_sync_unsynced_bytes_ = 0;
       LOG_SLOW_EXECUTION(WARNING, 50, "Fsync log took a long time") {
+        const MonoTime fsync_start = MonoTime::Now();
         RETURN_NOT_OK(active_segment_->Sync());
+        UpdateAverageFsyncLatency(MonoTime::Now().GetDeltaSince(fsync_start));
+        if (metrics_) {
+          metrics_->fsyncs->Increment();
+        }
 
         if (log_hooks_) {
           RETURN_NOT_OK_PREPEND(log_hooks_->PostSyncIfFsyncEnabled(),
@@ -784,7 +975,12 @@ Status Log::GC(int64_t min_op_idx, int32_t* num_gced) {
     for (const scoped_refptr<ReadableLogSegment>& segment : segments_to_delete) {
       LOG(INFO) << "Deleting log segment in path: " << segment->path()
                 << " (GCed ops < " << min_op_idx << ")";
-      RETURN_NOT_OK(fs_manager_->env()->DeleteFile(segment->path()));
+      // A segment that is still being read by someone else could not be overwritten.
+      if (segment->HasOneRef()) {
+        RETURN_NOT_OK(RecycleOrDeleteSegmentFile(segment->path()));
+      } else {
+        RETURN_NOT_OK(fs_manager_->env()->DeleteFile(segment->path()));
+      }
       (*num_gced)++;
     }
 
@@ -863,7 +1059,7 @@ void Log::SetSchemaForNextLogSegment(const Schema& schema,
 }
 
 Status Log::Close() {
-  allocation_pool_->Shutdown();
+  allocation_token_->Shutdown();
   append_thread_->Shutdown();
 
   std::lock_guard<percpu_rwlock> l(state_lock_);
@@ -921,14 +1117,21 @@ Status Log::PreAllocateNewSegment() {
   WritableFileOptions opts;
   opts.sync_on_close = durable_wal_write_;
   opts.o_direct = durable_wal_write_;
-  RETURN_NOT_OK(CreatePlaceholderSegment(opts, &next_segment_path_, &next_segment_file_));
+  uint64_t allocated_size = 0;
+  next_segment_recycled_ = ReuseRecycledSegment(opts, &allocated_size);
+  if (!next_segment_recycled_) {
+    RETURN_NOT_OK(CreatePlaceholderSegment(opts, &next_segment_path_, &next_segment_file_));
+  }
 
   if (options_.preallocate_segments) {
     uint64_t next_segment_size = NextSegmentDesiredSize();
-    TRACE("Preallocating $0 byte segment in $1", next_segment_size, next_segment_path_);
-    // TODO (perf) zero the new segments -- this could result in additional performance
-    // improvements.
-    RETURN_NOT_OK(next_segment_file_->PreAllocate(next_segment_size));
+    // A recycled file only has to be extended when segments have grown since it was written.
+    if (next_segment_size > allocated_size) {
+      TRACE("Preallocating $0 byte segment in $1", next_segment_size, next_segment_path_);
+      // TODO (perf) zero the new segments -- this could result in additional performance
+      // improvements.
+      RETURN_NOT_OK(next_segment_file_->PreAllocate(next_segment_size - allocated_size));
+    }
   }
 
   {
@@ -962,6 +1165,15 @@ Status Log::SwitchToAllocatedSegment() {
   header.set_minor_version(kLogMinorVersion);
   header.set_sequence_number(active_segment_sequence_number_);
   header.set_tablet_id(tablet_id_);
+  if (FLAGS_log_compress_entries) {
+    header.set_compression_codec(LZ4_COMPRESSION);
+  }
+  // Entries that are left in a recycled file by the previous segment should not pass the header
+  // CRC check.
+  if (next_segment_recycled_) {
+    header.set_entry_header_crc_salt(
+        RandomUniformInt<uint32_t>(1, std::numeric_limits<uint32_t>::max()));
+  }
 
   // Set up the new footer. This will be maintained as the segment is written.
   footer_builder_.Clear();
@@ -1036,6 +1248,94 @@ Status Log::CreatePlaceholderSegment(const WritableFileOptions& opts,
   return Status::OK();
 }
 
+bool Log::ReuseRecycledSegment(const WritableFileOptions& opts, uint64_t* allocated_size) {
+  std::string path;
+  {
+    std::lock_guard<std::mutex> lock(recycled_segments_mutex_);
+    if (recycled_segment_paths_.empty()) {
+      return false;
+    }
+    path = std::move(recycled_segment_paths_.back());
+    recycled_segment_paths_.pop_back();
+  }
+  Status s = OpenRecycledSegment(opts, path, allocated_size);
+  if (!s.ok()) {
+    LOG(WARNING) << "Failed to reuse recycled log segment " << path << ": " << s;
+    next_segment_file_.reset();
+    WARN_NOT_OK(fs_manager_->env()->DeleteFile(path), "Failed to delete recycled log segment");
+    return false;
+  }
+  VLOG(1) << "Reusing recycled log segment " << path << " of " << *allocated_size << " bytes";
+  return true;
+}
+
+Status Log::OpenRecycledSegment(const WritableFileOptions& opts,
+                                const std::string& path,
+                                uint64_t* allocated_size) {
+  Env* env = fs_manager_->env();
+  // The file is read as a blank segment until the header of the new segment is written, and does
+  // not look closed until the new footer is written.
+  {
+    RWFileOptions rw_opts;
+    rw_opts.mode = Env::OPEN_EXISTING;
+    gscoped_ptr<RWFile> file;
+    RETURN_NOT_OK(env->NewRWFile(rw_opts, path, &file));
+    RETURN_NOT_OK(file->Size(allocated_size));
+    if (*allocated_size <
+            kLogSegmentHeaderMagicAndHeaderLength + kLogSegmentFooterMagicAndFooterLength) {
+      return STATUS_FORMAT(Corruption, "Recycled log segment is too small: $0", *allocated_size);
+    }
+    const std::string zeros(
+        std::max(kLogSegmentHeaderMagicAndHeaderLength, kLogSegmentFooterMagicAndFooterLength),
+        '\0');
+    RETURN_NOT_OK(file->Write(0, Slice(zeros.data(), kLogSegmentHeaderMagicAndHeaderLength)));
+    RETURN_NOT_OK(file->Write(*allocated_size - kLogSegmentFooterMagicAndFooterLength,
+                              Slice(zeros.data(), kLogSegmentFooterMagicAndFooterLength)));
+    RETURN_NOT_OK(file->Sync());
+    RETURN_NOT_OK(file->Close());
+  }
+
+  WritableFileOptions reuse_opts = opts;
+  reuse_opts.mode = Env::REUSE_EXISTING;
+  gscoped_ptr<WritableFile> segment_file;
+  RETURN_NOT_OK(env->NewWritableFile(reuse_opts, path, &segment_file));
+  next_segment_path_ = path;
+  next_segment_file_.reset(segment_file.release());
+  return Status::OK();
+}
+
+Status Log::RecycleOrDeleteSegmentFile(const std::string& path) {
+  {
+    std::lock_guard<std::mutex> lock(recycled_segments_mutex_);
+    if (recycled_segment_paths_.size() < MaxRecycledSegments()) {
+      const auto recycled_path = JoinPathSegments(
+          log_dir_, kRecycledSegmentFilePrefix + BaseName(path));
+      RETURN_NOT_OK(fs_manager_->env()->RenameFile(path, recycled_path));
+      recycled_segment_paths_.push_back(recycled_path);
+      return Status::OK();
+    }
+  }
+  return fs_manager_->env()->DeleteFile(path);
+}
+
+Status Log::LoadRecycledSegments() {
+  std::vector<std::string> children;
+  RETURN_NOT_OK(fs_manager_->env()->GetChildren(log_dir_, ExcludeDots::kTrue, &children));
+  std::lock_guard<std::mutex> lock(recycled_segments_mutex_);
+  for (const auto& child : children) {
+    if (!HasPrefixString(child, kRecycledSegmentFilePrefix)) {
+      continue;
+    }
+    const auto path = JoinPathSegments(log_dir_, child);
+    if (recycled_segment_paths_.size() < MaxRecycledSegments()) {
+      recycled_segment_paths_.push_back(path);
+    } else {
+      RETURN_NOT_OK(fs_manager_->env()->DeleteFile(path));
+    }
+  }
+  return Status::OK();
+}
+
 Log::~Log() {
   WARN_NOT_OK(Close(), "Error closing log");
 }
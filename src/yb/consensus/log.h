@@ -36,6 +36,7 @@
 #include <atomic>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -59,6 +60,7 @@ namespace yb {
 class FsManager;
 class MetricEntity;
 class ThreadPool;
+class ThreadPoolToken;
 
 namespace log {
 
@@ -100,6 +102,10 @@ class Log : public RefCountedThreadSafe<Log> {
 
   // Opens or continues a log and sets 'log' to the newly built Log.
   // After a successful Open() the Log is ready to receive entries.
+  //
+  // If append_thread_pool is not null, entries are appended by tasks submitted to this pool
+  // instead of a dedicated thread, so logs of the same server share a bounded set of threads.
+  // Asynchronous pre-allocation of new segments is also submitted to this pool.
   static CHECKED_STATUS Open(const LogOptions &options,
                              FsManager *fs_manager,
                              const std::string& tablet_id,
@@ -107,6 +113,7 @@ class Log : public RefCountedThreadSafe<Log> {
                              const Schema& schema,
                              uint32_t schema_version,
                              const scoped_refptr<MetricEntity>& metric_entity,
+                             ThreadPool* append_thread_pool,
                              scoped_refptr<Log> *log);
 
   ~Log();
@@ -146,7 +153,7 @@ class Log : public RefCountedThreadSafe<Log> {
   // 'allocation_status_'. To wait for the result of the task, use allocation_status_.Get().
   CHECKED_STATUS AsyncAllocateSegment();
 
-  // The closure submitted to allocation_pool_ to allocate a new segment.
+  // The closure submitted to allocation_token_ to allocate a new segment.
   void SegmentAllocationTask();
 
   // Syncs all state and closes the log.
@@ -273,7 +280,8 @@ class Log : public RefCountedThreadSafe<Log> {
 
   Log(LogOptions options, FsManager* fs_manager, std::string log_path,
       std::string tablet_id, std::string tablet_wal_path, const Schema& schema,
-      uint32_t schema_version, const scoped_refptr<MetricEntity>& metric_entity);
+      uint32_t schema_version, const scoped_refptr<MetricEntity>& metric_entity,
+      ThreadPool* append_thread_pool);
 
   // Initializes a new one or continues an existing log.
   CHECKED_STATUS Init();
@@ -298,6 +306,24 @@ class Log : public RefCountedThreadSafe<Log> {
   // Preallocates the space for a new segment.
   CHECKED_STATUS PreAllocateNewSegment();
 
+  // Makes a recycled segment file the placeholder of the next segment, if there is one. Sets
+  // 'allocated_size' to the size of the file. Returns false when there are no usable recycled
+  // files.
+  bool ReuseRecycledSegment(const WritableFileOptions& opts, uint64_t* allocated_size);
+
+  // Zeroes the header and the footer magic of the previous segment in the recycled file at 'path',
+  // and opens it as the placeholder of the next segment.
+  CHECKED_STATUS OpenRecycledSegment(const WritableFileOptions& opts,
+                                     const std::string& path,
+                                     uint64_t* allocated_size);
+
+  // Keeps the file of a garbage collected segment for reuse by a new segment, when fewer than
+  // --log_max_recycled_segments files are kept, or deletes it otherwise.
+  CHECKED_STATUS RecycleOrDeleteSegmentFile(const std::string& path);
+
+  // Picks up recycled segment files left in the log directory by the previous instance of the log.
+  CHECKED_STATUS LoadRecycledSegments();
+
   // Returns the desired size for the next log segment to be created.
   uint64_t NextSegmentDesiredSize();
 
@@ -322,6 +348,9 @@ class Log : public RefCountedThreadSafe<Log> {
 
   CHECKED_STATUS Sync();
 
+  // Accounts the latency of an fsync in avg_fsync_latency_us_.
+  void UpdateAverageFsyncLatency(MonoDelta latency);
+
   // Helper method to get the segment sequence to GC based on the provided min_op_idx.
   CHECKED_STATUS GetSegmentsToGCUnlocked(int64_t min_op_idx, SegmentSequence* segments_to_gc) const;
 
@@ -365,6 +394,13 @@ class Log : public RefCountedThreadSafe<Log> {
   // The path for the next allocated segment.
   std::string next_segment_path_;
 
+  // Whether the next allocated segment reuses the file of a garbage collected segment.
+  bool next_segment_recycled_ = false;
+
+  // Paths of garbage collected segment files kept for reuse by new segments.
+  std::mutex recycled_segments_mutex_;
+  std::vector<std::string> recycled_segment_paths_;
+
   // Lock to protect mutations to log_state_ and other shared state variables.
   mutable percpu_rwlock state_lock_;
 
@@ -402,9 +438,13 @@ class Log : public RefCountedThreadSafe<Log> {
   // Thread writing to the log.
   gscoped_ptr<AppendThread> append_thread_;
 
-  // A thread pool for asynchronously pre-allocating new log segments.
+  // A thread pool for asynchronously pre-allocating new log segments, null when the shared append
+  // thread pool is used instead.
   gscoped_ptr<ThreadPool> allocation_pool_;
 
+  // Serial token used to submit allocation tasks to allocation_pool_ or the append thread pool.
+  std::unique_ptr<ThreadPoolToken> allocation_token_;
+
   // If true, sync on all appends.
   bool durable_wal_write_;
 
@@ -427,6 +467,10 @@ class Log : public RefCountedThreadSafe<Log> {
   // bootstrap.
   bool sync_disabled_;
 
+  // Exponential moving average of the fsync latency, in microseconds. Used by the append thread to
+  // decide how long a group commit could be held waiting for more entries.
+  std::atomic<int64_t> avg_fsync_latency_us_{0};
+
   // The status of the most recent log-allocation action.
   Promise<Status> allocation_status_;
 
@@ -46,6 +46,7 @@
 #include "yb/util/mem_tracker.h"
 #include "yb/util/metrics.h"
 #include "yb/util/test_util.h"
+#include "yb/util/threadpool.h"
 
 using std::shared_ptr;
 
@@ -80,6 +81,7 @@ class LogCacheTest : public YBTest {
                             schema_,
                             0, // schema_version
                             NULL,
+                            nullptr /* append_thread_pool */,
                             &log_));
 
     CloseAndReopenCache(MinimumOpId());
@@ -98,7 +100,8 @@ class LogCacheTest : public YBTest {
     cache_.reset(new LogCache(metric_entity_,
                               log_.get(),
                               kPeerUuid,
-                              kTestTablet));
+                              kTestTablet,
+                              prefetch_pool_.get()));
     cache_->Init(preceding_id);
   }
 
@@ -121,10 +124,14 @@ class LogCacheTest : public YBTest {
     return Status::OK();
   }
 
+  void TestPrefetch();
+
   const Schema schema_;
   MetricRegistry metric_registry_;
   scoped_refptr<MetricEntity> metric_entity_;
   gscoped_ptr<FsManager> fs_manager_;
+  // Shared pool for prefetch tasks, the cache uses its own pool when null. Should outlive cache_.
+  std::unique_ptr<ThreadPool> prefetch_pool_;
   gscoped_ptr<LogCache> cache_;
   scoped_refptr<log::Log> log_;
   scoped_refptr<server::Clock> clock_;
@@ -171,6 +178,49 @@ TEST_F(LogCacheTest, TestAppendAndGetMessages) {
 }
 
 
+// Test that serialized ops are the wire format of the ops field and are shared between reads.
+TEST_F(LogCacheTest, TestReadSerializedOps) {
+  ASSERT_OK(AppendReplicateMessagesToCache(1, 10));
+  ASSERT_OK(log_->WaitUntilAllFlushed());
+  const int64_t size_before_read = cache_->BytesUsed();
+
+  ReplicateMsgs messages;
+  OpId preceding;
+  std::vector<RefCntBuffer> serialized_ops;
+  ASSERT_OK(cache_->ReadOps(0, 8 * 1024 * 1024, &messages, &preceding, &serialized_ops));
+  ASSERT_EQ(10, messages.size());
+  ASSERT_EQ(10, serialized_ops.size());
+  ASSERT_GT(cache_->BytesUsed(), size_before_read);
+
+  std::string wire;
+  for (const auto& serialized_op : serialized_ops) {
+    wire.append(serialized_op.data(), serialized_op.size());
+  }
+  ConsensusRequestPB request;
+  ASSERT_TRUE(request.ParsePartialFromString(wire));
+  ASSERT_EQ(10, request.ops_size());
+  for (int i = 0; i != request.ops_size(); ++i) {
+    ASSERT_EQ(messages[i]->SerializeAsString(), request.ops(i).SerializeAsString());
+  }
+
+  // The second read should reuse the serialized ops stored in the cache.
+  const int64_t size_after_read = cache_->BytesUsed();
+  ReplicateMsgs messages2;
+  std::vector<RefCntBuffer> serialized_ops2;
+  ASSERT_OK(cache_->ReadOps(5, 8 * 1024 * 1024, &messages2, &preceding, &serialized_ops2));
+  ASSERT_EQ(5, serialized_ops2.size());
+  for (int i = 0; i != 5; ++i) {
+    ASSERT_EQ(serialized_ops[i + 5].data(), serialized_ops2[i].data());
+  }
+  ASSERT_EQ(size_after_read, cache_->BytesUsed());
+
+  // Eviction releases memory used by serialized ops as well.
+  messages.clear();
+  messages2.clear();
+  cache_->EvictThroughOp(10);
+  ASSERT_EQ(0, cache_->BytesUsed());
+}
+
 // Ensure that the cache always yields at least one message,
 // even if that message is larger than the batch size. This ensures
 // that we don't get "stuck" in the case that a large message enters
@@ -240,6 +290,47 @@ TEST_F(LogCacheTest, TestCacheEdgeCases) {
 }
 
 
+// Tests that reading ops evicted from the cache starts read ahead of the following ops, so the
+// next read is served without going to the disk.
+void LogCacheTest::TestPrefetch() {
+  const int kNumOps = 100;
+  ASSERT_OK(AppendReplicateMessagesToCache(1, kNumOps));
+  ASSERT_OK(log_->WaitUntilAllFlushed());
+  cache_->EvictThroughOp(kNumOps);
+  ASSERT_EQ(0, cache_->num_cached_ops());
+
+  // Read a few ops from the disk, that should trigger prefetch of the remaining ones.
+  ReplicateMsgs messages;
+  OpId preceding;
+  ASSERT_OK(cache_->ReadOps(0, 100, &messages, &preceding));
+  const int num_read = messages.size();
+  ASSERT_GE(num_read, 1);
+  ASSERT_LT(num_read, kNumOps);
+
+  ASSERT_OK(WaitFor([this]() -> Result<bool> {
+    std::lock_guard<simple_spinlock> l(cache_->lock_);
+    return !cache_->prefetch_in_progress_;
+  }, MonoDelta::FromSeconds(10), "Prefetch completed"));
+  ASSERT_GT(cache_->prefetch_tracker_->consumption(), 0);
+
+  messages.clear();
+  ASSERT_OK(cache_->ReadOps(num_read, 8 * 1024 * 1024, &messages, &preceding));
+  ASSERT_EQ(kNumOps - num_read, messages.size());
+  ASSERT_EQ(kNumOps - num_read, cache_->metrics_.log_cache_prefetch_hits->value());
+  // Prefetched ops are released once read.
+  ASSERT_EQ(0, cache_->prefetch_tracker_->consumption());
+}
+
+TEST_F(LogCacheTest, TestPrefetch) {
+  TestPrefetch();
+}
+
+TEST_F(LogCacheTest, TestPrefetchSharedPool) {
+  ASSERT_OK(ThreadPoolBuilder("log-prefetch").set_max_threads(1).Build(&prefetch_pool_));
+  CloseAndReopenCache(MinimumOpId());
+  TestPrefetch();
+}
+
 TEST_F(LogCacheTest, TestMemoryLimit) {
   FLAGS_log_cache_size_limit_mb = 1;
   CloseAndReopenCache(MinimumOpId());
@@ -33,6 +33,8 @@
 #include "yb/consensus/log_cache.h"
 
 #include <algorithm>
+#include <functional>
+#include <limits>
 #include <map>
 #include <mutex>
 #include <vector>
@@ -55,6 +57,7 @@
 #include "yb/util/metrics.h"
 #include "yb/util/locks.h"
 #include "yb/util/logging.h"
+#include "yb/util/threadpool.h"
 
 DEFINE_int32(log_cache_size_limit_mb, 128,
              "The total per-tablet size of consensus entries which may be kept in memory. "
@@ -68,6 +71,11 @@ DEFINE_int32(global_log_cache_size_limit_mb, 1024,
              "caching log entries across all tablets is kept under this threshold.");
 TAG_FLAG(global_log_cache_size_limit_mb, advanced);
 
+DEFINE_int32(log_cache_prefetch_size_limit_mb, 32,
+             "The per-tablet size of consensus entries which may be read ahead from the log "
+             "for followers that lag behind the log cache. 0 disables read ahead.");
+TAG_FLAG(log_cache_prefetch_size_limit_mb, advanced);
+
 using strings::Substitute;
 
 namespace yb {
@@ -79,6 +87,10 @@ METRIC_DEFINE_gauge_int64(tablet, log_cache_num_ops, "Log Cache Operation Count"
 METRIC_DEFINE_gauge_int64(tablet, log_cache_size, "Log Cache Memory Usage",
                           MetricUnit::kBytes,
                           "Amount of memory in use for caching the local log.");
+METRIC_DEFINE_counter(tablet, log_cache_prefetch_hits, "Log Cache Prefetch Hits",
+                      MetricUnit::kOperations,
+                      "Number of operations read from the log cache prefetch buffer instead of "
+                      "the disk.");
 
 static const char kParentMemTrackerId[] = "log_cache";
 
@@ -87,7 +99,8 @@ typedef vector<const ReplicateMsg*>::const_iterator MsgIter;
 LogCache::LogCache(const scoped_refptr<MetricEntity>& metric_entity,
                    const scoped_refptr<log::Log>& log,
                    const string& local_uuid,
-                   const string& tablet_id)
+                   const string& tablet_id,
+                   ThreadPool* prefetch_pool)
   : log_(log),
     local_uuid_(local_uuid),
     tablet_id_(tablet_id),
@@ -110,14 +123,33 @@ LogCache::LogCache(const scoped_refptr<MetricEntity>& metric_entity,
                                      local_uuid, tablet_id),
       parent_tracker_);
 
+  const int64_t prefetch_size_bytes = FLAGS_log_cache_prefetch_size_limit_mb * 1024 * 1024;
+  if (prefetch_size_bytes > 0) {
+    prefetch_tracker_ = MemTracker::CreateTracker(
+        prefetch_size_bytes, Substitute("$0:$1:$2:prefetch", kParentMemTrackerId,
+                                        local_uuid, tablet_id),
+        parent_tracker_);
+    if (!prefetch_pool) {
+      CHECK_OK(ThreadPoolBuilder("log-prefetch").set_max_threads(1).Build(&prefetch_pool_));
+      prefetch_pool = prefetch_pool_.get();
+    }
+    prefetch_token_ = prefetch_pool->NewToken(ThreadPool::ExecutionMode::SERIAL);
+  }
+
   // Put a fake message at index 0, since this simplifies a lot of our
   // code paths elsewhere.
   auto zero_op = std::make_shared<ReplicateMsg>();
   *zero_op->mutable_id() = MinimumOpId();
-  InsertOrDie(&cache_, 0, zero_op);
+  InsertOrDie(&cache_, 0, CacheEntry{zero_op, RefCntBuffer()});
 }
 
 LogCache::~LogCache() {
+  if (prefetch_token_) {
+    prefetch_token_->Shutdown();
+    prefetch_tracker_->Release(prefetch_tracker_->consumption());
+    prefetched_.clear();
+    prefetch_tracker_->UnregisterFromParent();
+  }
   tracker_->Release(tracker_->consumption());
   cache_.clear();
 
@@ -152,12 +184,13 @@ Status LogCache::AppendOperations(const ReplicateMsgs& msgs,
     CHECK_LE(first_idx_in_batch, next_sequential_op_index_);
 
     // Now remove the overwritten operations.
+    RemovePrefetchedUnlocked(first_idx_in_batch, std::numeric_limits<int64_t>::max());
+    ++prefetch_generation_;
     for (int64_t i = first_idx_in_batch; i < next_sequential_op_index_; ++i) {
       auto it = cache_.find(i);
       if (it != cache_.end()) {
-        ReplicateMsgPtr msg = it->second;
+        AccountForMessageRemovalUnlocked(it->second);
         cache_.erase(it);
-        AccountForMessageRemovalUnlocked(msg);
       }
     }
   }
@@ -193,7 +226,7 @@ Status LogCache::AppendOperations(const ReplicateMsgs& msgs,
   }
 
   for (const auto& msg : msgs) {
-    InsertOrDie(&cache_,  msg->id().index(), msg);
+    InsertOrDie(&cache_,  msg->id().index(), CacheEntry{msg, RefCntBuffer()});
   }
 
   // We drop the lock during the AsyncAppendReplicates call, since it may block
@@ -266,7 +299,7 @@ Status LogCache::LookupOpId(int64_t op_index, OpId* op_id) const {
     }
     auto iter = cache_.find(op_index);
     if (iter != cache_.end()) {
-      *op_id = iter->second->id();
+      *op_id = iter->second.msg->id();
       return Status::OK();
     }
   }
@@ -285,15 +318,39 @@ int64_t TotalByteSizeForMessage(const ReplicateMsg& msg) {
   msg_size += 1; // for the type tag
   return msg_size;
 }
+
+// Serializes the message as the ops field of ConsensusRequestPB, i.e. tag, length and message
+// bytes. So it could be appended to the serialized request as is.
+RefCntBuffer SerializeOp(const ReplicateMsg& msg) {
+  using google::protobuf::internal::WireFormatLite;
+  using google::protobuf::io::CodedOutputStream;
+
+  const uint32_t tag = WireFormatLite::MakeTag(
+      ConsensusRequestPB::kOpsFieldNumber, WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+  const int msg_size = msg.ByteSize();
+  RefCntBuffer result(CodedOutputStream::VarintSize32(tag) +
+                      CodedOutputStream::VarintSize32(msg_size) + msg_size);
+  uint8_t* dst = CodedOutputStream::WriteVarint32ToArray(tag, result.udata());
+  dst = CodedOutputStream::WriteVarint32ToArray(msg_size, dst);
+  dst = msg.SerializeWithCachedSizesToArray(dst);
+  DCHECK_EQ(dst, result.uend());
+  return result;
+}
 } // anonymous namespace
 
 Status LogCache::ReadOps(int64_t after_op_index,
                          int max_size_bytes,
                          ReplicateMsgs* messages,
-                         OpId* preceding_op) {
+                         OpId* preceding_op,
+                         std::vector<RefCntBuffer>* serialized_ops) {
   DCHECK_GE(after_op_index, 0);
   RETURN_NOT_OK(LookupOpId(after_op_index, preceding_op));
 
+  const size_t first_message = messages->size();
+  if (serialized_ops) {
+    DCHECK_EQ(serialized_ops->size(), first_message);
+  }
+
   std::unique_lock<simple_spinlock> l(lock_);
   int64_t next_index = after_op_index + 1;
 
@@ -314,6 +371,12 @@ Status LogCache::ReadOps(int64_t after_op_index,
         up_to = iter->first - 1;
       }
 
+      ReadPrefetchedUnlocked(up_to, &next_index, &remaining_space, messages, serialized_ops);
+      if (remaining_space <= 0 || next_index > up_to) {
+        MaybeStartPrefetchUnlocked(next_index);
+        continue;
+      }
+
       l.unlock();
 
       ReplicateMsgs raw_replicate_ptrs;
@@ -331,36 +394,193 @@ Status LogCache::ReadOps(int64_t after_op_index,
         remaining_space -= TotalByteSizeForMessage(*msg);
         if (remaining_space > 0 || messages->empty()) {
           messages->push_back(msg);
+          if (serialized_ops) {
+            serialized_ops->emplace_back();
+          }
           next_index++;
         }
       }
+      // The peer is lagging behind the cache, so read ahead the entries it will need next.
+      MaybeStartPrefetchUnlocked(next_index);
 
     } else {
       // Pull contiguous messages from the cache until the size limit is achieved.
       for (; iter != cache_.end(); ++iter) {
-        const ReplicateMsgPtr& msg = iter->second;
+        const ReplicateMsgPtr& msg = iter->second.msg;
         int64_t index = msg->id().index();
         if (index != next_index) {
           continue;
         }
 
-        remaining_space -= TotalByteSizeForMessage(*msg);
+        const RefCntBuffer& serialized_op = iter->second.serialized_op;
+        remaining_space -= serialized_op ? serialized_op.size() : TotalByteSizeForMessage(*msg);
         if (remaining_space < 0 && !messages->empty()) {
           break;
         }
 
         messages->push_back(msg);
+        if (serialized_ops) {
+          serialized_ops->push_back(serialized_op);
+        }
         next_index++;
       }
     }
   }
+
+  if (serialized_ops) {
+    // Serialize the missing ops without holding the lock, and then store them in the cache, so
+    // other peers would reuse them.
+    l.unlock();
+    bool serialized_any = false;
+    for (size_t i = first_message; i != messages->size(); ++i) {
+      auto& serialized_op = (*serialized_ops)[i];
+      if (!serialized_op) {
+        serialized_op = SerializeOp(*(*messages)[i]);
+        serialized_any = true;
+      }
+    }
+    if (serialized_any) {
+      l.lock();
+      StoreSerializedOpsUnlocked(*messages, *serialized_ops, first_message);
+    }
+  }
   return Status::OK();
 }
 
+void LogCache::StoreSerializedOpsUnlocked(const ReplicateMsgs& messages,
+                                          const std::vector<RefCntBuffer>& serialized_ops,
+                                          size_t begin) {
+  DCHECK(lock_.is_locked());
+  int64_t mem_required = 0;
+  for (size_t i = begin; i != messages.size(); ++i) {
+    auto it = cache_.find(messages[i]->id().index());
+    // The entry could be evicted or replaced while the lock was released.
+    if (it == cache_.end() || it->second.msg != messages[i] || it->second.serialized_op) {
+      continue;
+    }
+    it->second.serialized_op = serialized_ops[i];
+    mem_required += serialized_ops[i].size();
+  }
+  if (mem_required != 0) {
+    // Serialized ops are accounted the same way as messages, so eviction releases them.
+    tracker_->Consume(mem_required);
+    metrics_.log_cache_size->IncrementBy(mem_required);
+  }
+}
+
+
+void LogCache::ReadPrefetchedUnlocked(int64_t up_to,
+                                      int64_t* next_index,
+                                      int64_t* remaining_space,
+                                      ReplicateMsgs* messages,
+                                      std::vector<RefCntBuffer>* serialized_ops) {
+  DCHECK(lock_.is_locked());
+  int64_t num_hits = 0;
+  int64_t released_bytes = 0;
+  auto it = prefetched_.find(*next_index);
+  while (it != prefetched_.end() && it->first == *next_index && *next_index <= up_to) {
+    const ReplicateMsgPtr& msg = it->second;
+    *remaining_space -= TotalByteSizeForMessage(*msg);
+    if (*remaining_space < 0 && !messages->empty()) {
+      break;
+    }
+    messages->push_back(msg);
+    if (serialized_ops) {
+      serialized_ops->emplace_back();
+    }
+    ++*next_index;
+    ++num_hits;
+    // Prefetched messages are read by a single lagging peer, so release them once read.
+    released_bytes += msg->SpaceUsed();
+    it = prefetched_.erase(it);
+  }
+  if (num_hits != 0) {
+    prefetch_tracker_->Release(released_bytes);
+    metrics_.log_cache_prefetch_hits->IncrementBy(num_hits);
+  }
+}
+
+void LogCache::MaybeStartPrefetchUnlocked(int64_t from_index) {
+  DCHECK(lock_.is_locked());
+  if (!prefetch_token_ || prefetch_in_progress_) {
+    return;
+  }
+  // Continue after already prefetched messages.
+  auto prefetched_it = prefetched_.lower_bound(from_index);
+  while (prefetched_it != prefetched_.end() && prefetched_it->first == from_index) {
+    ++from_index;
+    ++prefetched_it;
+  }
+  if (from_index >= next_sequential_op_index_ || prefetch_tracker_->SpareCapacity() <= 0) {
+    return;
+  }
+  auto cache_it = cache_.lower_bound(from_index);
+  if (cache_it != cache_.end() && static_cast<int64_t>(cache_it->first) == from_index) {
+    return;
+  }
+  int64_t up_to = cache_it == cache_.end() ? next_sequential_op_index_ - 1 : cache_it->first - 1;
+  if (prefetched_it != prefetched_.end()) {
+    up_to = std::min(up_to, prefetched_it->first - 1);
+  }
+
+  prefetch_in_progress_ = true;
+  auto status = prefetch_token_->SubmitFunc(std::bind(
+      &LogCache::PrefetchTask, this, from_index, up_to, prefetch_generation_));
+  if (!status.ok()) {
+    LOG_WITH_PREFIX_UNLOCKED(WARNING) << "Failed to submit log prefetch task: " << status;
+    prefetch_in_progress_ = false;
+  }
+}
+
+void LogCache::PrefetchTask(int64_t from_index, int64_t up_to, uint64_t generation) {
+  ReplicateMsgs msgs;
+  Status status = log_->GetLogReader()->ReadReplicatesInRange(
+      from_index, up_to, prefetch_tracker_->SpareCapacity(), &msgs);
+
+  std::lock_guard<simple_spinlock> l(lock_);
+  prefetch_in_progress_ = false;
+  if (!status.ok()) {
+    LOG_WITH_PREFIX_UNLOCKED(WARNING) << "Failed to prefetch ops " << from_index << ".." << up_to
+                                      << ": " << status;
+    return;
+  }
+  if (generation != prefetch_generation_) {
+    // Some of the read operations were overwritten.
+    return;
+  }
+  size_t num_prefetched = 0;
+  for (auto& msg : msgs) {
+    int64_t index = msg->id().index();
+    if (index >= next_sequential_op_index_ || !prefetch_tracker_->TryConsume(msg->SpaceUsed())) {
+      break;
+    }
+    if (cache_.count(index) || !prefetched_.emplace(index, msg).second) {
+      prefetch_tracker_->Release(msg->SpaceUsed());
+      continue;
+    }
+    ++num_prefetched;
+  }
+  VLOG_WITH_PREFIX_UNLOCKED(1) << "Prefetched " << num_prefetched << " ops starting from "
+                               << from_index;
+}
+
+void LogCache::RemovePrefetchedUnlocked(int64_t from_index, int64_t to_index) {
+  DCHECK(lock_.is_locked());
+  int64_t released_bytes = 0;
+  auto it = prefetched_.lower_bound(from_index);
+  while (it != prefetched_.end() && it->first <= to_index) {
+    released_bytes += it->second->SpaceUsed();
+    it = prefetched_.erase(it);
+  }
+  if (released_bytes != 0) {
+    prefetch_tracker_->Release(released_bytes);
+  }
+}
 
 void LogCache::EvictThroughOp(int64_t index) {
   std::lock_guard<simple_spinlock> lock(lock_);
 
+  RemovePrefetchedUnlocked(0, index);
   EvictSomeUnlocked(index, MathLimits<int64_t>::kMax);
 }
 
@@ -373,7 +593,7 @@ void LogCache::EvictSomeUnlocked(int64_t stop_after_index, int64_t bytes_to_evic
 
   int64_t bytes_evicted = 0;
   for (auto iter = cache_.begin(); iter != cache_.end();) {
-    const ReplicateMsgPtr& msg = iter->second;
+    const ReplicateMsgPtr& msg = iter->second.msg;
     VLOG_WITH_PREFIX_UNLOCKED(2) << "considering for eviction: " << msg->id();
     int64_t msg_index = msg->id().index();
     if (msg_index == 0) {
@@ -394,8 +614,8 @@ void LogCache::EvictSomeUnlocked(int64_t stop_after_index, int64_t bytes_to_evic
     }
 
     VLOG_WITH_PREFIX_UNLOCKED(2) << "Evicting cache. Removing: " << msg->id();
-    AccountForMessageRemovalUnlocked(msg);
-    bytes_evicted += msg->SpaceUsed();
+    bytes_evicted += iter->second.SpaceUsed();
+    AccountForMessageRemovalUnlocked(iter->second);
     cache_.erase(iter++);
 
     if (bytes_evicted >= bytes_to_evict) {
@@ -405,9 +625,14 @@ void LogCache::EvictSomeUnlocked(int64_t stop_after_index, int64_t bytes_to_evic
   VLOG_WITH_PREFIX_UNLOCKED(1) << "Evicting log cache: after state: " << ToStringUnlocked();
 }
 
-void LogCache::AccountForMessageRemovalUnlocked(const ReplicateMsgPtr& msg) {
-  tracker_->Release(msg->SpaceUsed());
-  metrics_.log_cache_size->DecrementBy(msg->SpaceUsed());
+int64_t LogCache::CacheEntry::SpaceUsed() const {
+  return msg->SpaceUsed() + (serialized_op ? serialized_op.size() : 0);
+}
+
+void LogCache::AccountForMessageRemovalUnlocked(const CacheEntry& entry) {
+  const int64_t space_used = entry.SpaceUsed();
+  tracker_->Release(space_used);
+  metrics_.log_cache_size->DecrementBy(space_used);
   metrics_.log_cache_num_ops->Decrement();
 }
 
@@ -457,7 +682,7 @@ void LogCache::DumpToStrings(vector<string>* lines) const {
   lines->push_back(ToStringUnlocked());
   lines->push_back("Messages:");
   for (const MessageCache::value_type& entry : cache_) {
-    const ReplicateMsg* msg = entry.second.get();
+    const ReplicateMsg* msg = entry.second.msg.get();
     lines->push_back(
       Substitute("Message[$0] $1.$2 : REPLICATE. Type: $3, Size: $4",
                  counter++, msg->id().term(), msg->id().index(),
@@ -476,7 +701,7 @@ void LogCache::DumpToHtml(std::ostream& out) const {
 
   int counter = 0;
   for (const MessageCache::value_type& entry : cache_) {
-    const ReplicateMsg* msg = entry.second.get();
+    const ReplicateMsg* msg = entry.second.msg.get();
     out << Substitute("<tr><th>$0</th><th>$1.$2</th><td>REPLICATE $3</td>"
                       "<td>$4</td><td>$5</td></tr>",
                       counter++, msg->id().term(), msg->id().index(),
@@ -490,7 +715,8 @@ void LogCache::DumpToHtml(std::ostream& out) const {
   x.Instantiate(metric_entity, 0)
 LogCache::Metrics::Metrics(const scoped_refptr<MetricEntity>& metric_entity)
   : log_cache_num_ops(INSTANTIATE_METRIC(METRIC_log_cache_num_ops)),
-    log_cache_size(INSTANTIATE_METRIC(METRIC_log_cache_size)) {
+    log_cache_size(INSTANTIATE_METRIC(METRIC_log_cache_size)),
+    log_cache_prefetch_hits(METRIC_log_cache_prefetch_hits.Instantiate(metric_entity)) {
 }
 #undef INSTANTIATE_METRIC
 
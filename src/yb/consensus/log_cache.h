@@ -45,12 +45,15 @@
 #include "yb/util/async_util.h"
 #include "yb/util/locks.h"
 #include "yb/util/metrics.h"
+#include "yb/util/ref_cnt_buffer.h"
 #include "yb/util/status.h"
 
 namespace yb {
 
 class MetricEntity;
 class MemTracker;
+class ThreadPool;
+class ThreadPoolToken;
 
 namespace log {
 class Log;
@@ -67,12 +70,18 @@ class ReplicateMsg;
 // can be appended to the end as they are written to the log. Readers
 // fetch entries that were explicitly appended, or they can fetch older
 // entries which are asynchronously fetched from the disk.
+//
+// When a reader has to fetch entries from the disk, i.e. a peer is lagging behind the cache, the
+// following range of entries is read ahead in background into a separate bounded prefetch cache,
+// so the next reads of this peer do not block on the disk. Prefetch tasks are submitted to
+// prefetch_pool when it is specified, otherwise to a pool owned by this cache.
 class LogCache {
  public:
   LogCache(const scoped_refptr<MetricEntity>& metric_entity,
            const scoped_refptr<log::Log>& log,
            const std::string& local_uuid,
-           const std::string& tablet_id);
+           const std::string& tablet_id,
+           ThreadPool* prefetch_pool = nullptr);
   ~LogCache();
 
   // Initialize the cache.
@@ -97,10 +106,15 @@ class LogCache {
   // If the ops being requested are not available in the log, this will synchronously
   // read these ops from disk. Therefore, this function may take a substantial amount
   // of time and should not be called with important locks held, etc.
+  //
+  // If 'serialized_ops' is not null, it is filled with the wire format of the ops field of
+  // ConsensusRequestPB for each returned operation. The serialized form of a cached operation is
+  // kept in the cache, so the operation is serialized once for all peers.
   CHECKED_STATUS ReadOps(int64_t after_op_index,
                  int max_size_bytes,
                  ReplicateMsgs* messages,
-                 OpId* preceding_op);
+                 OpId* preceding_op,
+                 std::vector<RefCntBuffer>* serialized_ops = nullptr);
 
   // Append the operations into the log and the cache.
   // When the messages have completed writing into the on-disk log, fires 'callback'.
@@ -152,6 +166,7 @@ class LogCache {
   FRIEND_TEST(LogCacheTest, TestAppendAndGetMessages);
   FRIEND_TEST(LogCacheTest, TestGlobalMemoryLimit);
   FRIEND_TEST(LogCacheTest, TestReplaceMessages);
+  FRIEND_TEST(LogCacheTest, TestPrefetch);
   friend class LogCacheTest;
 
   // Try to evict the oldest operations from the queue, stopping either when
@@ -159,9 +174,24 @@ class LogCache {
   // 'stop_after_index' has been evicted, whichever comes first.
   void EvictSomeUnlocked(int64_t stop_after_index, int64_t bytes_to_evict);
 
+  struct CacheEntry {
+    ReplicateMsgPtr msg;
+    // Wire format of the ops field of ConsensusRequestPB for msg. Filled on the first read with
+    // serialized ops requested.
+    RefCntBuffer serialized_op;
+
+    // Memory accounted for this entry.
+    int64_t SpaceUsed() const;
+  };
+
   // Update metrics and MemTracker to account for the removal of the
-  // given message.
-  void AccountForMessageRemovalUnlocked(const ReplicateMsgPtr& msg);
+  // given entry.
+  void AccountForMessageRemovalUnlocked(const CacheEntry& entry);
+
+  // Stores serialized ops produced by ReadOps into the cache entries of the same messages.
+  void StoreSerializedOpsUnlocked(const ReplicateMsgs& messages,
+                                  const std::vector<RefCntBuffer>& serialized_ops,
+                                  size_t begin);
 
   // Return a string with stats
   std::string StatsStringUnlocked() const;
@@ -170,6 +200,24 @@ class LogCache {
 
   std::string LogPrefixUnlocked() const;
 
+  // Moves contiguous prefetched messages starting at *next_index into 'messages', while they fit
+  // into *remaining_space.
+  void ReadPrefetchedUnlocked(int64_t up_to,
+                              int64_t* next_index,
+                              int64_t* remaining_space,
+                              ReplicateMsgs* messages,
+                              std::vector<RefCntBuffer>* serialized_ops);
+
+  // Starts reading ahead entries that follow from_index, if they are not cached and there is no
+  // prefetch in progress.
+  void MaybeStartPrefetchUnlocked(int64_t from_index);
+
+  // Reads entries from the log into the prefetch cache. Submitted via prefetch_token_.
+  void PrefetchTask(int64_t from_index, int64_t up_to, uint64_t generation);
+
+  // Removes prefetched messages in range [from_index, to_index].
+  void RemovePrefetchedUnlocked(int64_t from_index, int64_t to_index);
+
   void LogCallback(int64_t last_idx_in_batch,
                    bool borrowed_memory,
                    const StatusCallback& user_callback,
@@ -186,8 +234,8 @@ class LogCache {
   mutable simple_spinlock lock_;
 
   // An ordered map that serves as the buffer for the cached messages.
-  // Maps from log index -> ReplicateMsg
-  typedef std::map<uint64_t, ReplicateMsgPtr> MessageCache;
+  // Maps from log index -> CacheEntry
+  typedef std::map<uint64_t, CacheEntry> MessageCache;
   MessageCache cache_;
 
   // The next log index to append. Each append operation must either
@@ -213,6 +261,27 @@ class LogCache {
   // A MemTracker for this instance.
   std::shared_ptr<MemTracker> tracker_;
 
+  // Messages read ahead from the log for lagging peers. Maps from log index -> ReplicateMsg.
+  // Protected by lock_.
+  std::map<int64_t, ReplicateMsgPtr> prefetched_;
+
+  // A separate MemTracker for prefetched messages, so read ahead does not take memory from the
+  // main cache.
+  std::shared_ptr<MemTracker> prefetch_tracker_;
+
+  // Pool used to run PrefetchTask when no shared pool was provided.
+  std::unique_ptr<ThreadPool> prefetch_pool_;
+
+  // Serial token used to submit PrefetchTask, null when prefetch is disabled.
+  std::unique_ptr<ThreadPoolToken> prefetch_token_;
+
+  // Whether PrefetchTask is submitted and not yet completed. Protected by lock_.
+  bool prefetch_in_progress_ = false;
+
+  // Incremented when operations are overwritten, so the running prefetch would discard messages
+  // read before that. Protected by lock_.
+  uint64_t prefetch_generation_ = 0;
+
   struct Metrics {
     explicit Metrics(const scoped_refptr<MetricEntity>& metric_entity);
 
@@ -221,6 +290,9 @@ class LogCache {
 
     // Keeps track of the memory consumed by the cache, in bytes.
     scoped_refptr<AtomicGauge<int64_t> > log_cache_size;
+
+    // Number of operations read from the prefetch cache instead of the disk.
+    scoped_refptr<Counter> log_cache_prefetch_hits;
   };
   Metrics metrics_;
 
@@ -36,6 +36,8 @@
 #include "yb/fs/fs_manager.h"
 #include "yb/util/test_util.h"
 
+DECLARE_int64(log_index_max_mapped_bytes);
+
 namespace yb {
 namespace log {
 
@@ -128,5 +130,26 @@ TEST_F(LogIndexTest, TestMultiSegmentWithGC) {
 }
 #endif
 
+// Reads and writes must keep working when chunks are unmapped to stay under the mapped bytes cap.
+TEST_F(LogIndexTest, TestMappedBytesLimit) {
+  FLAGS_log_index_max_mapped_bytes = 1;
+  constexpr int64_t kIndexStep = 1000000;
+  constexpr int64_t kNumChunks = 4;
+
+  for (int64_t i = 1; i <= kNumChunks; ++i) {
+    ASSERT_OK(AddEntry(MakeOpId(1, i * kIndexStep), i, i * 100));
+  }
+  for (int pass = 0; pass != 2; ++pass) {
+    for (int64_t i = 1; i <= kNumChunks; ++i) {
+      VerifyEntry(MakeOpId(1, i * kIndexStep), i, i * 100);
+    }
+  }
+
+  // Overwrite an entry in a chunk that was unmapped.
+  ASSERT_OK(AddEntry(MakeOpId(2, kIndexStep), 7, 700));
+  VerifyEntry(MakeOpId(2, kIndexStep), 7, 700);
+  VerifyEntry(MakeOpId(1, kNumChunks * kIndexStep), kNumChunks, kNumChunks * 100);
+}
+
 } // namespace log
 } // namespace yb
@@ -40,6 +40,10 @@
 //
 // When the log is GCed, we remove any index chunks which are no longer needed, and
 // unmap them.
+//
+// Chunks are mapped lazily, on the first read or write of an entry, and the total number of
+// mapped bytes in the process is capped by log_index_max_mapped_bytes. When the cap is exceeded,
+// the least recently accessed chunks are unmapped; they are mapped again on their next access.
 
 #include "yb/consensus/log_index.h"
 
@@ -49,15 +53,31 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <atomic>
 #include <mutex>
 #include <string>
 #include <vector>
 
+#include <gflags/gflags.h>
+
 #include "yb/consensus/opid_util.h"
 #include "yb/gutil/map-util.h"
 #include "yb/gutil/stringprintf.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/locks.h"
+#include "yb/util/monotime.h"
+#include "yb/util/size_literals.h"
+
+using namespace yb::size_literals;
+
+DEFINE_int64(log_index_max_mapped_bytes, 4_GB,
+             "Maximum total size of log index chunks mapped into memory by all tablets of the "
+             "process. Least recently accessed chunks are unmapped when it is exceeded. "
+             "0 means no limit.");
+TAG_FLAG(log_index_max_mapped_bytes, advanced);
+TAG_FLAG(log_index_max_mapped_bytes, runtime);
 
 using std::string;
 using strings::Substitute;
@@ -107,23 +127,109 @@ static const int64_t kChunkFileSize = kEntriesPerIndexChunk * sizeof(PhysicalEnt
 ////////////////////////////////////////////////////////////
 
 // A single chunk of the index, representing a fixed number of entries.
-// This class maintains the open file descriptor and mapped memory.
-class LogIndex::IndexChunk : public RefCountedThreadSafe<LogIndex::IndexChunk> {
+// The file is created by Open(), but mapped into memory only on the first access
+// and may be unmapped by MappedChunks afterwards.
+class LogIndex::IndexChunk : public std::enable_shared_from_this<LogIndex::IndexChunk> {
  public:
-  explicit IndexChunk(string path);
+  IndexChunk(string path, int64_t chunk_idx);
   ~IndexChunk();
 
-  // Open and map the memory.
+  int64_t chunk_idx() const { return chunk_idx_; }
+
+  // Create the file and extend it to the chunk size.
   Status Open();
-  void GetEntry(int entry_index, PhysicalEntry* ret);
-  void SetEntry(int entry_index, const PhysicalEntry& entry);
+  Status GetEntry(int entry_index, PhysicalEntry* ret);
+  Status SetEntry(int entry_index, const PhysicalEntry& entry);
+
+  // Unmap the chunk memory. The chunk is mapped again on the next access.
+  void Unmap();
+
+  int64_t last_access() const {
+    return last_access_.load(std::memory_order_relaxed);
+  }
 
  private:
+  // Invokes f with the address of the entry, mapping the chunk first if necessary.
+  template <class F>
+  Status Access(int entry_index, const F& f);
+
+  // Maps the chunk unless it is already mapped. Sets *mapped to true if this call mapped it.
+  Status MapUnlocked(bool* mapped);
+
   const string path_;
-  int fd_;
-  uint8_t* mapping_;
+  const int64_t chunk_idx_;
+  std::mutex mutex_;
+  uint8_t* mapping_ = nullptr;
+  std::atomic<int64_t> last_access_{0};
 };
 
+// Process-wide tracker of mapped index chunks, unmaps the least recently accessed ones when
+// log_index_max_mapped_bytes is exceeded.
+class LogIndex::MappedChunks {
+ public:
+  static MappedChunks& Instance() {
+    static MappedChunks instance;
+    return instance;
+  }
+
+  void Mapped() {
+    mapped_bytes_.fetch_add(kChunkFileSize, std::memory_order_relaxed);
+  }
+
+  void Unmapped() {
+    mapped_bytes_.fetch_sub(kChunkFileSize, std::memory_order_relaxed);
+  }
+
+  // Registers a chunk that was just mapped and evicts other chunks if needed.
+  void Register(const IndexChunkPtr& chunk);
+
+ private:
+  std::mutex mutex_;
+  std::vector<std::weak_ptr<IndexChunk>> chunks_;
+  std::atomic<int64_t> mapped_bytes_{0};
+};
+
+void LogIndex::MappedChunks::Register(const IndexChunkPtr& chunk) {
+  std::vector<IndexChunkPtr> live;
+  std::vector<IndexChunkPtr> victims;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    chunks_.push_back(chunk);
+
+    const int64_t limit = FLAGS_log_index_max_mapped_bytes;
+    int64_t mapped_bytes = mapped_bytes_.load(std::memory_order_relaxed);
+    if (limit <= 0 || mapped_bytes <= limit) {
+      return;
+    }
+
+    live.reserve(chunks_.size());
+    for (const auto& weak_chunk : chunks_) {
+      auto live_chunk = weak_chunk.lock();
+      if (live_chunk) {
+        live.push_back(std::move(live_chunk));
+      }
+    }
+    std::sort(live.begin(), live.end(), [](const IndexChunkPtr& lhs, const IndexChunkPtr& rhs) {
+      return lhs->last_access() < rhs->last_access();
+    });
+
+    chunks_.clear();
+    for (auto& live_chunk : live) {
+      if (mapped_bytes > limit && live_chunk != chunk) {
+        mapped_bytes -= kChunkFileSize;
+        victims.push_back(std::move(live_chunk));
+      } else {
+        chunks_.push_back(live_chunk);
+      }
+    }
+  }
+
+  // Unmap outside of the lock, Unmap takes the chunk lock.
+  for (const auto& victim : victims) {
+    victim->Unmap();
+  }
+}
+
 namespace  {
 Status CheckError(int rc, const char* operation) {
   if (PREDICT_FALSE(rc < 0)) {
@@ -134,49 +240,86 @@ Status CheckError(int rc, const char* operation) {
 }
 } // anonymous namespace
 
-LogIndex::IndexChunk::IndexChunk(std::string path)
-    : path_(std::move(path)), fd_(-1), mapping_(nullptr) {}
+LogIndex::IndexChunk::IndexChunk(std::string path, int64_t chunk_idx)
+    : path_(std::move(path)), chunk_idx_(chunk_idx) {}
 
 LogIndex::IndexChunk::~IndexChunk() {
-  if (mapping_ != nullptr) {
-    munmap(mapping_, kChunkFileSize);
-  }
-
-  if (fd_ >= 0) {
-    close(fd_);
-  }
+  Unmap();
 }
 
 Status LogIndex::IndexChunk::Open() {
-  RETRY_ON_EINTR(fd_, open(path_.c_str(), O_CLOEXEC | O_CREAT | O_RDWR, 0666));
-  RETURN_NOT_OK(CheckError(fd_, "open"));
+  int fd;
+  RETRY_ON_EINTR(fd, open(path_.c_str(), O_CLOEXEC | O_CREAT | O_RDWR, 0666));
+  RETURN_NOT_OK(CheckError(fd, "open"));
 
   int err;
-  RETRY_ON_EINTR(err, ftruncate(fd_, kChunkFileSize));
-  RETURN_NOT_OK(CheckError(fd_, "truncate"));
+  RETRY_ON_EINTR(err, ftruncate(fd, kChunkFileSize));
+  Status s = CheckError(err, "truncate");
+  close(fd);
+  return s;
+}
 
-  mapping_ = static_cast<uint8_t*>(mmap(nullptr, kChunkFileSize, PROT_READ | PROT_WRITE,
-                                        MAP_SHARED, fd_, 0));
-  if (mapping_ == nullptr) {
-    int err = errno;
+Status LogIndex::IndexChunk::MapUnlocked(bool* mapped) {
+  if (mapping_ != nullptr) {
+    return Status::OK();
+  }
+
+  int fd;
+  RETRY_ON_EINTR(fd, open(path_.c_str(), O_CLOEXEC | O_RDWR));
+  RETURN_NOT_OK(CheckError(fd, "open"));
+
+  // The mapping keeps its own reference to the file, so the descriptor is not needed after mmap.
+  void* mapping = mmap(nullptr, kChunkFileSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  int err = errno;
+  close(fd);
+  if (mapping == MAP_FAILED) {
     return STATUS(IOError, "Unable to mmap()", ErrnoToString(err), err);
   }
 
+  mapping_ = static_cast<uint8_t*>(mapping);
+  MappedChunks::Instance().Mapped();
+  *mapped = true;
   return Status::OK();
 }
 
-void LogIndex::IndexChunk::GetEntry(int entry_index, PhysicalEntry* ret) {
-  DCHECK_GE(fd_, 0) << "Must Open() first";
+void LogIndex::IndexChunk::Unmap() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (mapping_ != nullptr) {
+    munmap(mapping_, kChunkFileSize);
+    mapping_ = nullptr;
+    MappedChunks::Instance().Unmapped();
+  }
+}
+
+template <class F>
+Status LogIndex::IndexChunk::Access(int entry_index, const F& f) {
   DCHECK_LT(entry_index, kEntriesPerIndexChunk);
 
-  memcpy(ret, mapping_ + sizeof(PhysicalEntry) * entry_index, sizeof(PhysicalEntry));
+  bool mapped = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    RETURN_NOT_OK(MapUnlocked(&mapped));
+    f(mapping_ + sizeof(PhysicalEntry) * entry_index);
+  }
+  last_access_.store(CoarseMonoClock::Now().time_since_epoch().count(),
+                     std::memory_order_relaxed);
+
+  if (mapped) {
+    MappedChunks::Instance().Register(shared_from_this());
+  }
+  return Status::OK();
 }
 
-void LogIndex::IndexChunk::SetEntry(int entry_index, const PhysicalEntry& phys) {
-  DCHECK_GE(fd_, 0) << "Must Open() first";
-  DCHECK_LT(entry_index, kEntriesPerIndexChunk);
+Status LogIndex::IndexChunk::GetEntry(int entry_index, PhysicalEntry* ret) {
+  return Access(entry_index, [ret](const uint8_t* address) {
+    memcpy(ret, address, sizeof(PhysicalEntry));
+  });
+}
 
-  memcpy(mapping_ + sizeof(PhysicalEntry) * entry_index, &phys, sizeof(PhysicalEntry));
+Status LogIndex::IndexChunk::SetEntry(int entry_index, const PhysicalEntry& phys) {
+  return Access(entry_index, [&phys](uint8_t* address) {
+    memcpy(address, &phys, sizeof(PhysicalEntry));
+  });
 }
 
 ////////////////////////////////////////////////////////////
@@ -192,20 +335,25 @@ string LogIndex::GetChunkPath(int64_t chunk_idx) {
   return StringPrintf("%s/index.%09" PRId64, base_dir_.c_str(), chunk_idx);
 }
 
-Status LogIndex::OpenChunk(int64_t chunk_idx, scoped_refptr<IndexChunk>* chunk) {
+Status LogIndex::OpenChunk(int64_t chunk_idx, IndexChunkPtr* chunk) {
   string path = GetChunkPath(chunk_idx);
 
-  scoped_refptr<IndexChunk> new_chunk(new IndexChunk(path));
+  auto new_chunk = std::make_shared<IndexChunk>(path, chunk_idx);
   RETURN_NOT_OK(new_chunk->Open());
   chunk->swap(new_chunk);
   return Status::OK();
 }
 
-Status LogIndex::GetChunkForIndex(int64_t log_index, bool create,
-                                  scoped_refptr<IndexChunk>* chunk) {
+Status LogIndex::GetChunkForIndex(int64_t log_index, bool create, IndexChunkPtr* chunk) {
   CHECK_GT(log_index, 0);
   int64_t chunk_idx = log_index / kEntriesPerIndexChunk;
 
+  // Fast path: appends and reads of recent entries hit the active chunk.
+  *chunk = std::atomic_load(&active_chunk_);
+  if (*chunk && (**chunk).chunk_idx() == chunk_idx) {
+    return Status::OK();
+  }
+
   {
     std::lock_guard<simple_spinlock> l(open_chunks_lock_);
     if (FindCopy(open_chunks_, chunk_idx, chunk)) {
@@ -229,13 +377,17 @@ Status LogIndex::GetChunkForIndex(int64_t log_index, bool create,
     }
 
     InsertOrDie(&open_chunks_, chunk_idx, *chunk);
+    auto active_chunk = std::atomic_load(&active_chunk_);
+    if (!active_chunk || active_chunk->chunk_idx() < chunk_idx) {
+      std::atomic_store(&active_chunk_, *chunk);
+    }
   }
 
   return Status::OK();
 }
 
 Status LogIndex::AddEntry(const LogIndexEntry& entry) {
-  scoped_refptr<IndexChunk> chunk;
+  IndexChunkPtr chunk;
   RETURN_NOT_OK(GetChunkForIndex(entry.op_id.index(),
                                  true /* create if not found */,
                                  &chunk));
@@ -246,18 +398,18 @@ Status LogIndex::AddEntry(const LogIndexEntry& entry) {
   phys.segment_sequence_number = entry.segment_sequence_number;
   phys.offset_in_segment = entry.offset_in_segment;
 
-  chunk->SetEntry(index_in_chunk, phys);
+  RETURN_NOT_OK(chunk->SetEntry(index_in_chunk, phys));
   VLOG(3) << "Added log index entry " << entry.ToString();
 
   return Status::OK();
 }
 
 Status LogIndex::GetEntry(int64_t index, LogIndexEntry* entry) {
-  scoped_refptr<IndexChunk> chunk;
+  IndexChunkPtr chunk;
   RETURN_NOT_OK(GetChunkForIndex(index, false /* do not create */, &chunk));
   int index_in_chunk = index % kEntriesPerIndexChunk;
   PhysicalEntry phys;
-  chunk->GetEntry(index_in_chunk, &phys);
+  RETURN_NOT_OK(chunk->GetEntry(index_in_chunk, &phys));
 
   // We never write any real entries to offset 0, because there's a header
   // in each log segment. So, this indicates an entry that was never written.
@@ -297,6 +449,10 @@ void LogIndex::GC(int64_t min_index_to_retain) {
     {
       std::lock_guard<simple_spinlock> l(open_chunks_lock_);
       open_chunks_.erase(chunk_idx);
+      auto active_chunk = std::atomic_load(&active_chunk_);
+      if (active_chunk && active_chunk->chunk_idx() == chunk_idx) {
+        std::atomic_store(&active_chunk_, IndexChunkPtr());
+      }
     }
   }
 }
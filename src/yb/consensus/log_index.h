@@ -32,8 +32,9 @@
 #ifndef YB_CONSENSUS_LOG_INDEX_H
 #define YB_CONSENSUS_LOG_INDEX_H
 
-#include <string>
 #include <map>
+#include <memory>
+#include <string>
 
 #include "yb/consensus/consensus.pb.h"
 #include "yb/consensus/opid_util.h"
@@ -68,6 +69,10 @@ struct LogIndexEntry {
 // never sync it to disk. Its only purpose is to allow random-reading earlier entries from
 // the log to serve to Raft followers.
 //
+// Chunks are mapped on first access. The total size of chunks mapped by all indexes in the
+// process is limited by log_index_max_mapped_bytes, least recently used chunks are unmapped
+// when it is exceeded, so indexes of idle tablets do not pin address space.
+//
 // This class is thread-safe, but doesn't provide a memory barrier between writers and
 // readers. In other words, if a reader is expected to see an index entry written by a
 // writer, there should be some other synchronization between them to ensure visibility.
@@ -94,16 +99,18 @@ class LogIndex : public RefCountedThreadSafe<LogIndex> {
   ~LogIndex();
 
   class IndexChunk;
+  class MappedChunks;
+
+  typedef std::shared_ptr<IndexChunk> IndexChunkPtr;
 
   // Open the on-disk chunk with the given index.
   // Note: 'chunk_idx' is the index of the index chunk, not the index of a log _entry_.
-  CHECKED_STATUS OpenChunk(int64_t chunk_idx, scoped_refptr<IndexChunk>* chunk);
+  CHECKED_STATUS OpenChunk(int64_t chunk_idx, IndexChunkPtr* chunk);
 
   // Return the index chunk which contains the given log index.
   // If 'create' is true, creates it on-demand. If 'create' is false, and
   // the index chunk does not exist, returns NotFound.
-  CHECKED_STATUS GetChunkForIndex(int64_t log_index, bool create,
-                          scoped_refptr<IndexChunk>* chunk);
+  CHECKED_STATUS GetChunkForIndex(int64_t log_index, bool create, IndexChunkPtr* chunk);
 
   // Return the path of the given index chunk.
   std::string GetChunkPath(int64_t chunk_idx);
@@ -116,9 +123,14 @@ class LogIndex : public RefCountedThreadSafe<LogIndex> {
   // Map from chunk index to IndexChunk. The chunk index is the log index modulo
   // the number of entries per chunk (see docs in log_index.cc).
   // Protected by open_chunks_lock_
-  typedef std::map<int64_t, scoped_refptr<IndexChunk> > ChunkMap;
+  typedef std::map<int64_t, IndexChunkPtr> ChunkMap;
   ChunkMap open_chunks_;
 
+  // The chunk with the highest index, where entries are appended. It is looked up without taking
+  // open_chunks_lock_, accessed with std::atomic_load/std::atomic_store and modified under
+  // open_chunks_lock_.
+  IndexChunkPtr active_chunk_;
+
   DISALLOW_COPY_AND_ASSIGN(LogIndex);
 };
 
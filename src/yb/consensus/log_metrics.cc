@@ -38,6 +38,10 @@ METRIC_DEFINE_counter(tablet, log_bytes_logged, "Bytes Written to WAL",
                       yb::MetricUnit::kBytes,
                       "Number of bytes logged since service start");
 
+METRIC_DEFINE_counter(tablet, log_fsyncs, "WAL Fsyncs",
+                      yb::MetricUnit::kOperations,
+                      "Number of fsyncs of the log segment file since service start");
+
 METRIC_DEFINE_histogram(tablet, log_sync_latency, "Log Sync Latency",
                         yb::MetricUnit::kMicroseconds,
                         "Microseconds spent on synchronizing the log segment file",
@@ -63,17 +67,30 @@ METRIC_DEFINE_histogram(tablet, log_entry_batches_per_group, "Log Group Commit B
                         "Number of log entry batches in a group commit group",
                         1024, 2);
 
+METRIC_DEFINE_histogram(tablet, log_bytes_per_group, "Log Group Commit Size",
+                        yb::MetricUnit::kBytes,
+                        "Number of bytes in a group commit group",
+                        64LU * 1024 * 1024, 2);
+
+METRIC_DEFINE_histogram(tablet, log_group_commit_hold_time, "Log Group Commit Hold Time",
+                        yb::MetricUnit::kMicroseconds,
+                        "Microseconds a group commit was held waiting for more entries",
+                        1000000LU, 2);
+
 namespace yb {
 namespace log {
 
 #define MINIT(x) x(METRIC_log_##x.Instantiate(metric_entity))
 LogMetrics::LogMetrics(const scoped_refptr<MetricEntity>& metric_entity)
     : MINIT(bytes_logged),
+      MINIT(fsyncs),
       MINIT(sync_latency),
       MINIT(append_latency),
       MINIT(group_commit_latency),
       MINIT(roll_latency),
-      MINIT(entry_batches_per_group) {
+      MINIT(entry_batches_per_group),
+      MINIT(bytes_per_group),
+      MINIT(group_commit_hold_time) {
 }
 #undef MINIT
 
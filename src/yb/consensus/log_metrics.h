@@ -49,6 +49,7 @@ struct LogMetrics {
 
   // Global stats
   scoped_refptr<Counter> bytes_logged;
+  scoped_refptr<Counter> fsyncs;
 
   // Per-group group commit stats
   scoped_refptr<Histogram> sync_latency;
@@ -56,6 +57,8 @@ struct LogMetrics {
   scoped_refptr<Histogram> group_commit_latency;
   scoped_refptr<Histogram> roll_latency;
   scoped_refptr<Histogram> entry_batches_per_group;
+  scoped_refptr<Histogram> bytes_per_group;
+  scoped_refptr<Histogram> group_commit_hold_time;
 };
 
 // TODO extract and generalize this for all histogram metrics
@@ -339,7 +339,7 @@ Status LogReader::ReadReplicatesInRange(
   LogEntryBatchPB batch;
   for (int index = starting_at; index <= up_to && !limit_exceeded; index++) {
     LogIndexEntry index_entry;
-    RETURN_NOT_OK_PREPEND(log_index_->GetEntry(index, &index_entry),
+    RETURN_NOT_OK_PREPEND(GetIndexEntry(index, &index_entry),
                           Substitute("Failed to read log index for op $0", index));
 
     // Since a given LogEntryBatch may contain multiple REPLICATE messages,
@@ -400,12 +400,71 @@ Status LogReader::ReadReplicatesInRange(
 
 Status LogReader::LookupOpId(int64_t op_index, OpId* op_id) const {
   LogIndexEntry index_entry;
-  RETURN_NOT_OK_PREPEND(log_index_->GetEntry(op_index, &index_entry),
+  RETURN_NOT_OK_PREPEND(GetIndexEntry(op_index, &index_entry),
                         strings::Substitute("Failed to read log index for op $0", op_index));
   *op_id = index_entry.op_id;
   return Status::OK();
 }
 
+Status LogReader::GetIndexEntry(int64_t op_index, LogIndexEntry* index_entry) const {
+  Status status = log_index_->GetEntry(op_index, index_entry);
+  if (!status.IsNotFound()) {
+    return status;
+  }
+  RETURN_NOT_OK(IndexSegmentContaining(op_index));
+  return log_index_->GetEntry(op_index, index_entry);
+}
+
+Status LogReader::IndexSegmentContaining(int64_t op_index) const {
+  scoped_refptr<ReadableLogSegment> segment;
+  {
+    std::lock_guard<simple_spinlock> lock(lock_);
+    for (const auto& candidate : segments_) {
+      if (candidate->HasFooter() && candidate->footer().has_min_replicate_index() &&
+          candidate->footer().min_replicate_index() <= op_index &&
+          op_index <= candidate->footer().max_replicate_index()) {
+        segment = candidate;
+        break;
+      }
+    }
+  }
+  if (!segment) {
+    return Status::OK();
+  }
+
+  // The latest replicate with the same index wins, both inside the segment and when the index
+  // already has an entry, since such entry was written after the segment.
+  std::map<int64_t, LogIndexEntry> segment_entries;
+  const int64_t sequence_number = segment->header().sequence_number();
+  RETURN_NOT_OK(segment->ReadEntryBatches(
+      [sequence_number, &segment_entries](int64_t offset, const LogEntryBatchPB& batch) {
+    for (const auto& entry : batch.entry()) {
+      if (!entry.has_replicate()) {
+        continue;
+      }
+      auto& index_entry = segment_entries[entry.replicate().id().index()];
+      index_entry.op_id = entry.replicate().id();
+      index_entry.segment_sequence_number = sequence_number;
+      index_entry.offset_in_segment = offset;
+    }
+  }));
+
+  VLOG(1) << "Indexing " << segment_entries.size() << " replicates of log segment "
+          << segment->path();
+  for (const auto& p : segment_entries) {
+    LogIndexEntry existing_entry;
+    Status status = log_index_->GetEntry(p.first, &existing_entry);
+    if (status.ok()) {
+      continue;
+    }
+    if (!status.IsNotFound()) {
+      return status;
+    }
+    RETURN_NOT_OK(log_index_->AddEntry(p.second));
+  }
+  return Status::OK();
+}
+
 Status LogReader::GetSegmentsSnapshot(SegmentSequence* segments) const {
   std::lock_guard<simple_spinlock> lock(lock_);
   CHECK_EQ(state_, kLogReaderReading);
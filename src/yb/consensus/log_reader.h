@@ -182,6 +182,15 @@ class LogReader {
   // written to.
   void UpdateLastSegmentOffset(int64_t readable_to_offset);
 
+  // Returns index entry for the specified op index. Segments that were linked into the log
+  // directory, instead of being written by the log, are not indexed, so when the entry is missing,
+  // the segment containing the op index is indexed first.
+  CHECKED_STATUS GetIndexEntry(int64_t op_index, LogIndexEntry* index_entry) const;
+
+  // Adds entries for replicates of the closed segment containing the specified op index, that are
+  // missing from the log index.
+  CHECKED_STATUS IndexSegmentContaining(int64_t op_index) const;
+
   // Read the LogEntryBatch pointed to by the provided index entry.
   // 'tmp_buf' is used as scratch space to avoid extra allocation.
   CHECKED_STATUS ReadBatchUsingIndexEntry(const LogIndexEntry& index_entry,
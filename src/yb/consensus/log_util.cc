@@ -39,6 +39,7 @@
 
 #include <gflags/gflags.h>
 #include <glog/logging.h>
+#include <lz4.h>
 
 #include "yb/consensus/opid_util.h"
 #include "yb/consensus/ref_counted_replicate.h"
@@ -114,6 +115,10 @@ const size_t kLogSegmentFooterMagicAndFooterLength  = 12;
 
 const size_t kEntryHeaderSize = 12;
 
+// Upper bound on the uncompressed size of an entry batch in a compressed segment, protects against
+// allocating huge buffers for corrupted sizes.
+const size_t kLogEntryMaxUncompressedSize = 1_GB;
+
 const int kLogMajorVersion = 1;
 const int kLogMinorVersion = 0;
 
@@ -441,6 +446,30 @@ Status ReadableLogSegment::ParseFooterMagicAndFooterLength(const Slice &data,
   return Status::OK();
 }
 
+Status ReadableLogSegment::ReadEntryBatches(
+    const std::function<void(int64_t offset, const LogEntryBatchPB& batch)>& handler) {
+  if (!HasFooter() || footer_was_rebuilt_) {
+    return STATUS_FORMAT(IllegalState, "Log segment $0 was not properly closed", path_);
+  }
+
+  int64_t offset = first_entry_offset();
+  const int64_t read_up_to =
+      file_size() - footer_.ByteSize() - kLogSegmentFooterMagicAndFooterLength;
+  faststring tmp_buf;
+  LogEntryBatchPB batch;
+  while (offset < read_up_to) {
+    const int64_t batch_offset = offset;
+    if (offset + kEntryHeaderSize >= read_up_to) {
+      return STATUS_FORMAT(Corruption, "Truncated log entry at offset $0 of $1", offset, path_);
+    }
+    batch.Clear();
+    RETURN_NOT_OK_PREPEND(ReadEntryHeaderAndBatch(&offset, &tmp_buf, &batch),
+                          Substitute("Error reading from log $0", path_));
+    handler(batch_offset, batch);
+  }
+  return Status::OK();
+}
+
 Status ReadableLogSegment::ReadEntries(LogEntries* entries, int64_t* end_offset) {
   TRACE_EVENT1("log", "ReadableLogSegment::ReadEntries",
                "path", path_);
@@ -655,7 +684,7 @@ bool ReadableLogSegment::DecodeEntryHeader(const Slice& data, EntryHeader* heade
   header->header_crc = DecodeFixed32(&data[8]);
 
   // Verify the header.
-  uint32_t computed_crc = crc::Crc32c(&data[0], 8);
+  uint32_t computed_crc = crc::Crc32c(&data[0], 8) ^ header_.entry_header_crc_salt();
   return computed_crc == header->header_crc;
 }
 
@@ -703,10 +732,17 @@ Status ReadableLogSegment::ReadEntryBatch(int64_t *offset,
   }
 
 
+  Slice batch_data = entry_batch_slice;
+  faststring uncompressed;
+  if (header_.compression_codec() == LZ4_COMPRESSION) {
+    RETURN_NOT_OK_PREPEND(UncompressEntryBatch(entry_batch_slice, &uncompressed),
+                          Substitute("Could not uncompress entry in byte range $0-$1",
+                                     *offset, *offset + header.msg_length));
+    batch_data = Slice(uncompressed);
+  }
+
   LogEntryBatchPB read_entry_batch;
-  s = pb_util::ParseFromArray(&read_entry_batch,
-                              entry_batch_slice.data(),
-                              header.msg_length);
+  s = pb_util::ParseFromArray(&read_entry_batch, batch_data.data(), batch_data.size());
 
   if (!s.ok()) return STATUS(Corruption, Substitute("Could parse PB. Cause: $0",
                                                     s.ToString()));
@@ -716,6 +752,26 @@ Status ReadableLogSegment::ReadEntryBatch(int64_t *offset,
   return Status::OK();
 }
 
+Status ReadableLogSegment::UncompressEntryBatch(const Slice& data, faststring* uncompressed) {
+  if (data.size() < sizeof(uint32_t)) {
+    return STATUS_FORMAT(Corruption, "Compressed entry is too short: $0", data.size());
+  }
+  const uint32_t uncompressed_size = DecodeFixed32(data.data());
+  if (uncompressed_size > kLogEntryMaxUncompressedSize) {
+    return STATUS_FORMAT(Corruption, "Too big uncompressed entry size: $0", uncompressed_size);
+  }
+  uncompressed->resize(uncompressed_size);
+  const int compressed_size = static_cast<int>(data.size() - sizeof(uint32_t));
+  const int result = LZ4_decompress_safe(
+      data.cdata() + sizeof(uint32_t), reinterpret_cast<char*>(uncompressed->data()),
+      compressed_size, uncompressed_size);
+  if (result != static_cast<int>(uncompressed_size)) {
+    return STATUS_FORMAT(Corruption, "LZ4 decompression failed: $0, expected size: $1",
+                         result, uncompressed_size);
+  }
+  return Status::OK();
+}
+
 WritableLogSegment::WritableLogSegment(string path,
                                        shared_ptr<WritableFile> writable_file)
     : path_(std::move(path)),
@@ -777,9 +833,14 @@ Status WritableLogSegment::WriteFooterAndClose(const LogSegmentFooterPB& footer)
 }
 
 
-Status WritableLogSegment::WriteEntryBatch(const Slice& data) {
+Status WritableLogSegment::WriteEntryBatch(const Slice& entry_batch_data) {
   DCHECK(is_header_written_);
   DCHECK(!is_footer_written_);
+  Slice data = entry_batch_data;
+  if (header_.compression_codec() == LZ4_COMPRESSION) {
+    RETURN_NOT_OK(CompressEntryBatch(entry_batch_data));
+    data = Slice(compressed_buf_);
+  }
   uint8_t header_buf[kEntryHeaderSize];
 
   // First encode the length of the message.
@@ -791,7 +852,7 @@ Status WritableLogSegment::WriteEntryBatch(const Slice& data) {
   InlineEncodeFixed32(&header_buf[4], msg_crc);
 
   // Then the CRC of the header
-  uint32_t header_crc = crc::Crc32c(&header_buf, 8);
+  uint32_t header_crc = crc::Crc32c(&header_buf, 8) ^ header_.entry_header_crc_salt();
   InlineEncodeFixed32(&header_buf[8], header_crc);
 
   // Write the header to the file, followed by the batch data itself.
@@ -804,6 +865,23 @@ Status WritableLogSegment::WriteEntryBatch(const Slice& data) {
   return Status::OK();
 }
 
+Status WritableLogSegment::CompressEntryBatch(const Slice& data) {
+  if (data.size() > kLogEntryMaxUncompressedSize) {
+    return STATUS_FORMAT(InvalidArgument, "Entry batch is too big to compress: $0", data.size());
+  }
+  const int max_compressed_size = LZ4_compressBound(static_cast<int>(data.size()));
+  compressed_buf_.resize(sizeof(uint32_t) + max_compressed_size);
+  InlineEncodeFixed32(compressed_buf_.data(), static_cast<uint32_t>(data.size()));
+  const int compressed_size = LZ4_compress_default(
+      data.cdata(), reinterpret_cast<char*>(compressed_buf_.data() + sizeof(uint32_t)),
+      static_cast<int>(data.size()), max_compressed_size);
+  if (compressed_size <= 0) {
+    return STATUS_FORMAT(RuntimeError, "LZ4 compression of $0 bytes failed", data.size());
+  }
+  compressed_buf_.resize(sizeof(uint32_t) + compressed_size);
+  return Status::OK();
+}
+
 
 void CreateBatchFromAllocatedOperations(const ReplicateMsgs& msgs,
                                         LogEntryBatchPB* batch) {
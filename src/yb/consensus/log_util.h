@@ -33,6 +33,7 @@
 #ifndef YB_CONSENSUS_LOG_UTIL_H_
 #define YB_CONSENSUS_LOG_UTIL_H_
 
+#include <functional>
 #include <iosfwd>
 #include <map>
 #include <memory>
@@ -69,6 +70,10 @@ extern const char kTmpSuffix[];
 // and checksum of the other two fields (see EntryHeader struct below).
 extern const size_t kEntryHeaderSize;
 
+// Sizes of the magic and length that prefix the segment header and suffix the segment footer.
+extern const size_t kLogSegmentHeaderMagicAndHeaderLength;
+extern const size_t kLogSegmentFooterMagicAndFooterLength;
+
 extern const int kLogMajorVersion;
 extern const int kLogMinorVersion;
 
@@ -153,6 +158,11 @@ class ReadableLogSegment : public RefCountedThreadSafe<ReadableLogSegment> {
   CHECKED_STATUS ReadEntries(LogEntries* entries,
                              int64_t* end_offset = nullptr);
 
+  // Reads all entry batches of a properly closed segment, calling 'handler' with the offset of
+  // each batch and the batch itself. Unlike ReadEntries(), any corruption is reported as an error.
+  CHECKED_STATUS ReadEntryBatches(
+      const std::function<void(int64_t offset, const LogEntryBatchPB& batch)>& handler);
+
   // Rebuilds this segment's footer by scanning its entries.
   // This is an expensive operation as it reads and parses the whole segment
   // so it should be only used in the case of a crash, where the footer is
@@ -279,6 +289,9 @@ class ReadableLogSegment : public RefCountedThreadSafe<ReadableLogSegment> {
                                 faststring* tmp_buf,
                                 LogEntryBatchPB* entry_batch);
 
+  // Uncompresses an entry batch stored as specified by LZ4_COMPRESSION.
+  static CHECKED_STATUS UncompressEntryBatch(const Slice& data, faststring* uncompressed);
+
   void UpdateReadableToOffset(int64_t readable_to_offset);
 
   const std::string path_;
@@ -339,6 +352,7 @@ class WritableLogSegment {
   // Appends the provided batch of data, including a header
   // and checksum.
   // Makes sure that the log segment has not been closed.
+  // Entry batches are compressed if the segment header asks for it.
   CHECKED_STATUS WriteEntryBatch(const Slice& entry_batch_data);
 
   // Makes sure the I/O buffers in the underlying writable file are flushed.
@@ -384,6 +398,9 @@ class WritableLogSegment {
     return writable_file_;
   }
 
+  // Compresses data into compressed_buf_, as specified by LZ4_COMPRESSION.
+  CHECKED_STATUS CompressEntryBatch(const Slice& data);
+
   // The path to the log file.
   const std::string path_;
 
@@ -404,6 +421,9 @@ class WritableLogSegment {
   // The offset where the last written entry ends.
   int64_t written_offset_;
 
+  // Buffer for compressed entry batches, reused across writes.
+  faststring compressed_buf_;
+
   DISALLOW_COPY_AND_ASSIGN(WritableLogSegment);
 };
 
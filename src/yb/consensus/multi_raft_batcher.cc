@@ -0,0 +1,211 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/consensus/multi_raft_batcher.h"
+
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "yb/consensus/consensus.proxy.h"
+
+#include "yb/rpc/messenger.h"
+#include "yb/rpc/rpc_controller.h"
+#include "yb/rpc/rpc_header.pb.h"
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/monotime.h"
+
+DEFINE_int32(consensus_heartbeat_batch_window_ms, 10,
+             "Heartbeats of different tablets to the same server that are issued within this "
+             "time are sent with a single MultiRaftUpdateConsensus RPC.");
+TAG_FLAG(consensus_heartbeat_batch_window_ms, advanced);
+TAG_FLAG(consensus_heartbeat_batch_window_ms, runtime);
+
+DEFINE_int32(consensus_max_heartbeat_batch_size, 512,
+             "Max number of tablet heartbeats sent with a single MultiRaftUpdateConsensus RPC.");
+TAG_FLAG(consensus_max_heartbeat_batch_size, advanced);
+TAG_FLAG(consensus_max_heartbeat_batch_size, runtime);
+
+DECLARE_int32(consensus_rpc_timeout_ms);
+
+namespace yb {
+namespace consensus {
+
+struct MultiRaftHeartbeatBatcher::Batch {
+  MultiRaftConsensusRequestPB request;
+  MultiRaftConsensusResponsePB response;
+  rpc::RpcController controller;
+  std::vector<std::pair<ConsensusResponsePB*, HeartbeatCallback>> responders;
+};
+
+namespace {
+
+typedef std::pair<const rpc::Messenger*, Endpoint> BatcherKey;
+
+std::mutex batchers_mutex;
+std::map<BatcherKey, std::weak_ptr<MultiRaftHeartbeatBatcher>> batchers;
+
+} // namespace
+
+MultiRaftHeartbeatBatcher::MultiRaftHeartbeatBatcher(
+    const std::shared_ptr<rpc::Messenger>& messenger, const Endpoint& endpoint)
+    : messenger_(messenger),
+      endpoint_(endpoint),
+      proxy_(new ConsensusServiceProxy(messenger, endpoint)) {
+}
+
+MultiRaftHeartbeatBatcher::~MultiRaftHeartbeatBatcher() {
+  // Scheduled flush holds a reference to the batcher, so nothing could be pending here.
+  DCHECK(!current_batch_);
+}
+
+std::shared_ptr<MultiRaftHeartbeatBatcher> MultiRaftHeartbeatBatcher::Get(
+    const std::shared_ptr<rpc::Messenger>& messenger, const Endpoint& endpoint) {
+  std::lock_guard<std::mutex> lock(batchers_mutex);
+  auto& weak_batcher = batchers[BatcherKey(messenger.get(), endpoint)];
+  auto result = weak_batcher.lock();
+  if (result) {
+    return result;
+  }
+  // Batchers are created rarely, i.e. when tablet peers to a new server are created, so it is a
+  // good time to forget batchers of servers that are not used anymore.
+  for (auto it = batchers.begin(); it != batchers.end();) {
+    if (it->second.expired() && &it->second != &weak_batcher) {
+      it = batchers.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  result = std::make_shared<MultiRaftHeartbeatBatcher>(messenger, endpoint);
+  weak_batcher = result;
+  return result;
+}
+
+void MultiRaftHeartbeatBatcher::AddRequest(const ConsensusRequestPB& request,
+                                           ConsensusResponsePB* response,
+                                           HeartbeatCallback callback) {
+  if (multi_raft_unsupported_.load(std::memory_order_acquire)) {
+    SendSingle(request, response, std::move(callback));
+    return;
+  }
+
+  std::shared_ptr<Batch> batch_to_send;
+  bool schedule_flush = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!current_batch_) {
+      current_batch_ = std::make_shared<Batch>();
+    }
+    *current_batch_->request.add_consensus_request() = request;
+    current_batch_->responders.emplace_back(response, std::move(callback));
+    const auto window_ms = FLAGS_consensus_heartbeat_batch_window_ms;
+    if (window_ms <= 0 ||
+        current_batch_->request.consensus_request_size() >=
+            FLAGS_consensus_max_heartbeat_batch_size) {
+      batch_to_send = std::move(current_batch_);
+    } else if (!flush_scheduled_) {
+      flush_scheduled_ = schedule_flush = true;
+    }
+  }
+
+  if (schedule_flush) {
+    messenger_->ScheduleOnReactor(
+        std::bind(&MultiRaftHeartbeatBatcher::FlushScheduled, shared_from_this(),
+                  std::placeholders::_1),
+        MonoDelta::FromMilliseconds(FLAGS_consensus_heartbeat_batch_window_ms), messenger_);
+  }
+  if (batch_to_send) {
+    Send(std::move(batch_to_send));
+  }
+}
+
+void MultiRaftHeartbeatBatcher::FlushScheduled(const Status& status) {
+  std::shared_ptr<Batch> batch;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    flush_scheduled_ = false;
+    batch = std::move(current_batch_);
+  }
+  if (!batch) {
+    // Batch was filled up and sent before the window has passed.
+    return;
+  }
+  if (!status.ok()) {
+    // Reactor is shutting down, so the batch could not be sent anyway.
+    for (auto& responder : batch->responders) {
+      responder.second(status);
+    }
+    return;
+  }
+  Send(std::move(batch));
+}
+
+void MultiRaftHeartbeatBatcher::Send(std::shared_ptr<Batch> batch) {
+  batch->controller.set_timeout(MonoDelta::FromMilliseconds(FLAGS_consensus_rpc_timeout_ms));
+  auto* batch_ptr = batch.get();
+  proxy_->MultiRaftUpdateConsensusAsync(
+      batch_ptr->request, &batch_ptr->response, &batch_ptr->controller,
+      [this, self = shared_from_this(), batch = std::move(batch)] {
+    BatchDone(batch);
+  });
+}
+
+void MultiRaftHeartbeatBatcher::BatchDone(const std::shared_ptr<Batch>& batch) {
+  Status status = batch->controller.status();
+  if (status.IsRemoteError()) {
+    const auto* error = batch->controller.error_response();
+    if (error && error->code() == rpc::ErrorStatusPB::ERROR_NO_SUCH_METHOD) {
+      LOG(INFO) << "Server " << endpoint_
+                << " does not support MultiRaftUpdateConsensus, sending heartbeats one by one";
+      multi_raft_unsupported_.store(true, std::memory_order_release);
+      for (int i = 0; i != batch->request.consensus_request_size(); ++i) {
+        auto& responder = batch->responders[i];
+        SendSingle(batch->request.consensus_request(i), responder.first,
+                   std::move(responder.second));
+      }
+      return;
+    }
+  }
+  if (status.ok() &&
+      batch->response.consensus_response_size() != batch->request.consensus_request_size()) {
+    status = STATUS_FORMAT(IllegalState, "Got $0 responses for $1 heartbeats",
+                           batch->response.consensus_response_size(),
+                           batch->request.consensus_request_size());
+  }
+  for (size_t i = 0; i != batch->responders.size(); ++i) {
+    auto& responder = batch->responders[i];
+    if (status.ok()) {
+      responder.first->Swap(batch->response.mutable_consensus_response(i));
+    }
+    responder.second(status);
+  }
+}
+
+void MultiRaftHeartbeatBatcher::SendSingle(const ConsensusRequestPB& request,
+                                           ConsensusResponsePB* response,
+                                           HeartbeatCallback callback) {
+  auto controller = std::make_shared<rpc::RpcController>();
+  controller->set_timeout(MonoDelta::FromMilliseconds(FLAGS_consensus_rpc_timeout_ms));
+  proxy_->UpdateConsensusAsync(
+      request, response, controller.get(),
+      [controller, callback = std::move(callback)] {
+    callback(controller->status());
+  });
+}
+
+}  // namespace consensus
+}  // namespace yb
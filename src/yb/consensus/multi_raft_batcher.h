@@ -0,0 +1,95 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_CONSENSUS_MULTI_RAFT_BATCHER_H
+#define YB_CONSENSUS_MULTI_RAFT_BATCHER_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "yb/consensus/consensus.pb.h"
+
+#include "yb/util/net/sockaddr.h"
+#include "yb/util/status.h"
+
+namespace yb {
+
+namespace rpc {
+class Messenger;
+}
+
+namespace consensus {
+
+class ConsensusServiceProxy;
+
+// Coalesces heartbeats, i.e. ops-less consensus requests, of all tablets that are sent from this
+// server to the same remote server into a single MultiRaftUpdateConsensus RPC. Heartbeats are
+// collected for --consensus_heartbeat_batch_window_ms after the first one is added, or until
+// --consensus_max_heartbeat_batch_size of them are pending.
+//
+// Requests with ops are never batched, so active tablets are not delayed by the batching window.
+class MultiRaftHeartbeatBatcher : public std::enable_shared_from_this<MultiRaftHeartbeatBatcher> {
+ public:
+  typedef std::function<void(const Status&)> HeartbeatCallback;
+
+  MultiRaftHeartbeatBatcher(const std::shared_ptr<rpc::Messenger>& messenger,
+                            const Endpoint& endpoint);
+  ~MultiRaftHeartbeatBatcher();
+
+  MultiRaftHeartbeatBatcher(const MultiRaftHeartbeatBatcher&) = delete;
+  void operator=(const MultiRaftHeartbeatBatcher&) = delete;
+
+  // Returns the batcher shared by all tablets that send heartbeats to the specified endpoint
+  // through the specified messenger.
+  static std::shared_ptr<MultiRaftHeartbeatBatcher> Get(
+      const std::shared_ptr<rpc::Messenger>& messenger, const Endpoint& endpoint);
+
+  // Adds a heartbeat to the current batch. The request is copied, so it could be reused right after
+  // this call. When the batch RPC completes, 'response' is filled and 'callback' is invoked on the
+  // reactor thread with the status of the RPC.
+  void AddRequest(const ConsensusRequestPB& request,
+                  ConsensusResponsePB* response,
+                  HeartbeatCallback callback);
+
+ private:
+  struct Batch;
+
+  void FlushScheduled(const Status& status);
+  void Send(std::shared_ptr<Batch> batch);
+  void BatchDone(const std::shared_ptr<Batch>& batch);
+
+  // Sends the heartbeat with its own UpdateConsensus RPC, used when the remote server does not
+  // support MultiRaftUpdateConsensus.
+  void SendSingle(const ConsensusRequestPB& request,
+                  ConsensusResponsePB* response,
+                  HeartbeatCallback callback);
+
+  std::shared_ptr<rpc::Messenger> messenger_;
+  const Endpoint endpoint_;
+  std::unique_ptr<ConsensusServiceProxy> proxy_;
+
+  std::mutex mutex_;
+  std::shared_ptr<Batch> current_batch_;
+  bool flush_scheduled_ = false;
+
+  // Set when the remote server responded that it does not know MultiRaftUpdateConsensus, e.g.
+  // during a rolling upgrade.
+  std::atomic<bool> multi_raft_unsupported_{false};
+};
+
+}  // namespace consensus
+}  // namespace yb
+
+#endif  // YB_CONSENSUS_MULTI_RAFT_BATCHER_H
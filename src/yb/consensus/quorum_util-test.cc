@@ -71,5 +71,40 @@ TEST(QuorumUtilTest, TestMemberExtraction) {
   ASSERT_EQ("B", peer_pb.permanent_uuid());
 }
 
+TEST(QuorumUtilTest, TestLogOnlyMembers) {
+  RaftConfigPB config;
+  for (const char* uuid : {"A", "B", "C"}) {
+    auto* peer = config.add_peers();
+    SetPeerInfo(uuid, RaftPeerPB::VOTER, peer);
+    peer->mutable_last_known_addr()->set_host(uuid);
+    peer->mutable_last_known_addr()->set_port(0);
+  }
+  config.mutable_peers(2)->set_log_only(true);
+
+  ASSERT_FALSE(IsRaftConfigLogOnlyMember("A", config));
+  ASSERT_TRUE(IsRaftConfigLogOnlyMember("C", config));
+  ASSERT_FALSE(IsRaftConfigLogOnlyMember("invalid", config));
+  // Log-only members are regular voters for the quorum.
+  ASSERT_EQ(3, CountVoters(config));
+  ASSERT_OK(VerifyRaftConfig(config, UNCOMMITTED_QUORUM));
+
+  ConsensusStatePB cstate;
+  cstate.set_current_term(1);
+  *cstate.mutable_config() = config;
+  cstate.set_leader_uuid("C");
+  ASSERT_NOK(VerifyConsensusState(cstate, UNCOMMITTED_QUORUM));
+
+  // An observer could not be log-only.
+  config.mutable_peers(2)->set_member_type(RaftPeerPB::OBSERVER);
+  ASSERT_NOK(VerifyRaftConfig(config, UNCOMMITTED_QUORUM));
+
+  // At least one voter should be able to become leader.
+  for (auto& peer : *config.mutable_peers()) {
+    peer.set_member_type(RaftPeerPB::VOTER);
+    peer.set_log_only(true);
+  }
+  ASSERT_NOK(VerifyRaftConfig(config, UNCOMMITTED_QUORUM));
+}
+
 } // namespace consensus
 } // namespace yb
@@ -63,6 +63,15 @@ bool IsRaftConfigVoter(const std::string& uuid, const RaftConfigPB& config) {
   return false;
 }
 
+bool IsRaftConfigLogOnlyMember(const std::string& uuid, const RaftConfigPB& config) {
+  for (const RaftPeerPB& peer : config.peers()) {
+    if (peer.permanent_uuid() == uuid) {
+      return peer.log_only();
+    }
+  }
+  return false;
+}
+
 Status GetRaftConfigMember(const RaftConfigPB& config,
                            const std::string& uuid,
                            RaftPeerPB* peer_pb) {
@@ -194,6 +203,7 @@ Status VerifyRaftConfig(const RaftConfigPB& config, RaftConfigState type) {
   }
 
   int num_peers = config.peers_size();
+  int num_full_voters = 0;
   for (const RaftPeerPB& peer : config.peers()) {
     if (!peer.has_permanent_uuid() || peer.permanent_uuid() == "") {
       return STATUS(IllegalState, Substitute("One peer didn't have an uuid or had the empty"
@@ -216,6 +226,22 @@ Status VerifyRaftConfig(const RaftConfigPB& config, RaftConfigState type) {
           Substitute("Peer: $0 has no member type set. RaftConfig: $1", peer.permanent_uuid(),
                      config.ShortDebugString()));
     }
+    if (peer.log_only()) {
+      if (peer.member_type() != RaftPeerPB::VOTER &&
+          peer.member_type() != RaftPeerPB::PRE_VOTER) {
+        return STATUS(IllegalState,
+            Substitute("Log-only peer: $0 is not a voter. RaftConfig: $1", peer.permanent_uuid(),
+                       config.ShortDebugString()));
+      }
+    } else if (peer.member_type() == RaftPeerPB::VOTER) {
+      ++num_full_voters;
+    }
+  }
+
+  if (num_full_voters == 0 && CountVoters(config) > 0) {
+    return STATUS(IllegalState,
+        Substitute("RaftConfig has only log-only voters, so no peer could become leader: $0",
+                   config.ShortDebugString()));
   }
 
   return Status::OK();
@@ -236,6 +262,11 @@ Status VerifyConsensusState(const ConsensusStatePB& cstate, RaftConfigState type
           Substitute("Leader with UUID $0 is not a VOTER in the config! Consensus state: $1",
                      cstate.leader_uuid(), cstate.ShortDebugString()));
     }
+    if (IsRaftConfigLogOnlyMember(cstate.leader_uuid(), cstate.config())) {
+      return STATUS(IllegalState,
+          Substitute("Leader with UUID $0 is a log-only member of the config! Consensus state: $1",
+                     cstate.leader_uuid(), cstate.ShortDebugString()));
+    }
   }
 
   return Status::OK();
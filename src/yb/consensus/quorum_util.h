@@ -51,6 +51,10 @@ enum RaftConfigState {
 bool IsRaftConfigMember(const std::string& uuid, const RaftConfigPB& config);
 bool IsRaftConfigVoter(const std::string& uuid, const RaftConfigPB& config);
 
+// Returns true if the peer with the specified uuid is a log-only member of the config, i.e. it
+// does not apply ops and could not become leader.
+bool IsRaftConfigLogOnlyMember(const std::string& uuid, const RaftConfigPB& config);
+
 // Get the specified member of the config.
 // Returns Status::NotFound if a member with the specified uuid could not be
 // found in the config.
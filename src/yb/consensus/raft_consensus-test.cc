@@ -99,15 +99,17 @@ class MockQueue : public PeerMessageQueue {
                                             const StatusCallback& callback));
   MOCK_METHOD1(TrackPeer, void(const string&));
   MOCK_METHOD1(UntrackPeer, void(const string&));
-  MOCK_METHOD6(RequestForPeer, Status(const std::string& uuid,
+  MOCK_METHOD7(RequestForPeer, Status(const std::string& uuid,
                                       ConsensusRequestPB* request,
                                       ReplicateMsgs* msg_refs,
                                       bool* needs_remote_bootstrap,
                                       RaftPeerPB::MemberType* member_type,
-                                      bool* last_exchange_successful));
-  MOCK_METHOD3(ResponseFromPeer, void(const std::string& peer_uuid,
+                                      bool* last_exchange_successful,
+                                      std::vector<RefCntBuffer>* serialized_ops));
+  MOCK_METHOD4(ResponseFromPeer, void(const std::string& peer_uuid,
                                       const ConsensusResponsePB& response,
-                                      bool* more_pending));
+                                      bool* more_pending,
+                                      const FollowerLeaseSent* lease_sent));
   MOCK_METHOD0(Close, void());
 };
 
@@ -221,6 +223,7 @@ class RaftConsensusTest : public YBTest {
                        schema_,
                        0, // schema_version
                        NULL,
+                       nullptr /* append_thread_pool */,
                        &log_));
 
     log_->TEST_SetAllOpIdsSafe(true);
@@ -94,6 +94,22 @@ DEFINE_double(leader_failure_max_missed_heartbeat_periods, 6.0,
               "The value passed to this flag may be fractional.");
 TAG_FLAG(leader_failure_max_missed_heartbeat_periods, advanced);
 
+DEFINE_int32(raft_quiesce_after_idle_ms, 0,
+             "When a tablet has no writes for this time and all followers have all of its "
+             "operations, the leader makes the Raft group quiescent: heartbeats are sent only "
+             "every raft_quiescent_heartbeat_interval_ms, and the followers wait for them "
+             "accordingly. The next write or read wakes the group up without an election. "
+             "0 disables quiescence.");
+TAG_FLAG(raft_quiesce_after_idle_ms, advanced);
+TAG_FLAG(raft_quiesce_after_idle_ms, runtime);
+
+DEFINE_int32(raft_quiescent_heartbeat_interval_ms, 10000,
+             "The heartbeat interval of quiescent Raft groups, see raft_quiesce_after_idle_ms. "
+             "Followers of a quiescent group consider the leader to have failed if it misses "
+             "leader_failure_max_missed_heartbeat_periods of such heartbeats in a row.");
+TAG_FLAG(raft_quiescent_heartbeat_interval_ms, advanced);
+TAG_FLAG(raft_quiescent_heartbeat_interval_ms, runtime);
+
 DEFINE_int32(leader_failure_exp_backoff_max_delta_ms, 20 * 1000,
              "Maximum time to sleep in between leader election retries, in addition to the "
              "regular timeout. When leader election fails the interval in between retries "
@@ -179,6 +195,19 @@ DEFINE_int32(min_leader_stepdown_retry_interval_ms,
              "to avoid infinite leader stepdown loops when the current leader never has a chance "
              "to update the intended leader with its latest records.");
 
+DEFINE_bool(use_preelection, true,
+            "Run a pre-election before starting a leader election after leader failure. The term "
+            "is only incremented once a majority of voters agrees to vote for this peer, so "
+            "peers that cannot win, e.g. after a network partition, do not disrupt the leader.");
+TAG_FLAG(use_preelection, advanced);
+TAG_FLAG(use_preelection, runtime);
+
+DEFINE_bool(stepdown_to_most_caught_up_follower, true,
+            "When a leader is asked to step down without a nominated new leader, transfer "
+            "leadership to the most caught up voter instead of waiting for an election timeout.");
+TAG_FLAG(stepdown_to_most_caught_up_follower, advanced);
+TAG_FLAG(stepdown_to_most_caught_up_follower, runtime);
+
 namespace {
 
 // Return the mean interval at which to check for failures of the
@@ -240,7 +269,8 @@ scoped_refptr<RaftConsensus> RaftConsensus::Create(
                            local_peer_pb,
                            options.tablet_id,
                            clock,
-                           raft_pool->NewToken(ThreadPool::ExecutionMode::SERIAL)));
+                           raft_pool->NewToken(ThreadPool::ExecutionMode::SERIAL),
+                           raft_pool));
 
   DCHECK(local_peer_pb.has_permanent_uuid());
   const string& peer_uuid = local_peer_pb.permanent_uuid();
@@ -375,7 +405,10 @@ Status RaftConsensus::Start(const ConsensusBootstrapInfo& info) {
 
     // If this is the first term expire the FD immediately so that we have a fast first
     // election, otherwise we just let the timer expire normally.
-    if (state_->GetCurrentTermUnlocked() == 0) {
+    // When the initial leader was picked by the master, other peers just wait for its vote
+    // request, so the first election does not split votes.
+    if (state_->GetCurrentTermUnlocked() == 0 &&
+        (info.initial_leader_uuid.empty() || info.initial_leader_uuid == state_->GetPeerUuid())) {
       // Initialize the failure detector timeout to some time in the past so that
       // the next time the failure detector monitor runs it triggers an election
       // (unless someone else requested a vote from us first, which resets the
@@ -430,6 +463,21 @@ Status RaftConsensus::DoStartElection(
     const OpId& must_be_committed_opid,
     const std::string& originator_uuid,
     TEST_SuppressVoteRequest suppress_vote_request) {
+  // Elections that ignore a live leader are used for leadership hand-off and must not wait for
+  // an extra round trip.
+  const PreElection preelection(mode == NORMAL_ELECTION && FLAGS_use_preelection);
+  return StartElectionOrPreElection(
+      mode, preelection, pending_commit, must_be_committed_opid, originator_uuid,
+      suppress_vote_request);
+}
+
+Status RaftConsensus::StartElectionOrPreElection(
+    ElectionMode mode,
+    PreElection preelection,
+    const bool pending_commit,
+    const OpId& must_be_committed_opid,
+    const std::string& originator_uuid,
+    TEST_SuppressVoteRequest suppress_vote_request) {
   TRACE_EVENT2("consensus", "RaftConsensus::StartElection",
                "peer", peer_uuid(),
                "tablet", tablet_id());
@@ -456,6 +504,13 @@ Status RaftConsensus::DoStartElection(
       return STATUS(IllegalState, "Not starting election: Node is currently "
                                   "a non-participant in the raft config",
                                   state_->GetActiveConfigUnlocked().ShortDebugString());
+    } else if (PREDICT_FALSE(IsRaftConfigLogOnlyMember(state_->GetPeerUuid(),
+                                                       state_->GetActiveConfigUnlocked()))) {
+      // A log-only replica does not apply ops, so it could not serve as leader. It still votes for
+      // the other voters.
+      RETURN_NOT_OK(SnoozeFailureDetectorUnlocked());
+      LOG_WITH_PREFIX_UNLOCKED(INFO) << "Not starting election -- log-only replica";
+      return Status::OK();
     }
 
     // Default is to start the election now. But if we are starting a pending election, see if
@@ -479,17 +534,21 @@ Status RaftConsensus::DoStartElection(
     }
 
     if (start_now) {
+      const char* election_name = preelection ? "pre-election" : "leader election";
       if (state_->HasLeaderUnlocked()) {
         LOG_WITH_PREFIX_UNLOCKED(INFO)
             << "Fail of leader " << state_->GetLeaderUuidUnlocked()
-            << " detected. Triggering leader election, mode=" << mode;
+            << " detected. Triggering " << election_name << ", mode=" << mode;
       } else {
         LOG_WITH_PREFIX_UNLOCKED(INFO)
-            << "Triggering leader election, mode=" << mode;
+            << "Triggering " << election_name << ", mode=" << mode;
       }
 
-      // Increment the term.
-      RETURN_NOT_OK(IncrementTermUnlocked());
+      // Increment the term. A pre-election leaves the term as is and asks for votes in the next
+      // one.
+      if (!preelection) {
+        RETURN_NOT_OK(IncrementTermUnlocked());
+      }
 
       // Snooze to avoid the election timer firing again as much as possible.
       // We do not disable the election timer while running an election.
@@ -509,7 +568,9 @@ Status RaftConsensus::DoStartElection(
 
       // Vote for ourselves.
       // TODO: Consider using a separate Mutex for voting, which must sync to disk.
-      RETURN_NOT_OK(state_->SetVotedForCurrentTermUnlocked(state_->GetPeerUuid()));
+      if (!preelection) {
+        RETURN_NOT_OK(state_->SetVotedForCurrentTermUnlocked(state_->GetPeerUuid()));
+      }
       bool duplicate;
       RETURN_NOT_OK(counter->RegisterVote(state_->GetPeerUuid(), VOTE_GRANTED, &duplicate));
       CHECK(!duplicate) << state_->LogPrefixUnlocked()
@@ -519,10 +580,13 @@ Status RaftConsensus::DoStartElection(
       VoteRequestPB request;
       request.set_ignore_live_leader(mode == ELECT_EVEN_IF_LEADER_IS_ALIVE);
       request.set_candidate_uuid(state_->GetPeerUuid());
-      request.set_candidate_term(state_->GetCurrentTermUnlocked());
+      request.set_candidate_term(state_->GetCurrentTermUnlocked() + (preelection ? 1 : 0));
       request.set_tablet_id(state_->GetOptions().tablet_id);
       *request.mutable_candidate_status()->mutable_last_received() =
         state_->GetLastReceivedOpIdUnlocked();
+      if (preelection) {
+        request.set_preelection(true);
+      }
 
       election.reset(new LeaderElection(
           active_config,
@@ -531,7 +595,8 @@ Status RaftConsensus::DoStartElection(
           std::move(counter),
           timeout,
           suppress_vote_request,
-          Bind(&RaftConsensus::ElectionCallback, this, originator_uuid)));
+          preelection ? Bind(&RaftConsensus::PreElectionCallback, this, originator_uuid)
+                      : Bind(&RaftConsensus::ElectionCallback, this, originator_uuid)));
 
       // Clear the pending election op id so that we won't start the same pending election again.
       state_->ClearPendingElectionOpIdUnlocked();
@@ -624,6 +689,14 @@ Status RaftConsensus::StepDown(const LeaderStepDownRequestPB* req, LeaderStepDow
   // to transfer the leadership.
   if (req->has_new_leader_uuid()) {
     new_leader_uuid = req->new_leader_uuid();
+    if (IsRaftConfigLogOnlyMember(new_leader_uuid, state_->GetActiveConfigUnlocked())) {
+      resp->mutable_error()->set_code(TabletServerErrorPB::LEADER_NOT_READY_TO_STEP_DOWN);
+      StatusToPB(
+          STATUS(InvalidArgument, "Suggested peer is a log-only replica"),
+          resp->mutable_error()->mutable_status());
+      // We return OK so that the tablet service won't overwrite the error code.
+      return Status::OK();
+    }
     if (!queue_->CanPeerBecomeLeader(new_leader_uuid)) {
       resp->mutable_error()->set_code(TabletServerErrorPB::LEADER_NOT_READY_TO_STEP_DOWN);
       StatusToPB(
@@ -632,9 +705,8 @@ Status RaftConsensus::StepDown(const LeaderStepDownRequestPB* req, LeaderStepDow
       // We return OK so that the tablet service won't overwrite the error code.
       return Status::OK();
     }
-    const auto& local_peer_uuid = state_->GetPeerUuid();
     const auto leadership_transfer_description =
-        Format("tablet $0 from $1 to $2", tablet_id, local_peer_uuid, new_leader_uuid);
+        Format("tablet $0 from $1 to $2", tablet_id, state_->GetPeerUuid(), new_leader_uuid);
     if (new_leader_uuid == protege_leader_uuid_ && election_lost_by_protege_at_) {
       const MonoDelta time_since_election_loss_by_protege =
           MonoTime::Now() - election_lost_by_protege_at_;
@@ -654,6 +726,27 @@ Status RaftConsensus::StepDown(const LeaderStepDownRequestPB* req, LeaderStepDow
       }
       election_lost_by_protege_at_ = MonoTime();
     }
+  } else if (FLAGS_stepdown_to_most_caught_up_follower) {
+    // No leader was nominated, hand off to the follower that would win the election anyway, so
+    // the tablet does not wait for an election timeout.
+    std::vector<std::string> candidates;
+    for (const RaftPeerPB& peer : state_->GetActiveConfigUnlocked().peers()) {
+      if (peer.member_type() == RaftPeerPB::VOTER &&
+          peer.permanent_uuid() != state_->GetPeerUuid() &&
+          !IsRaftConfigLogOnlyMember(peer.permanent_uuid(), state_->GetActiveConfigUnlocked())) {
+        candidates.push_back(peer.permanent_uuid());
+      }
+    }
+    new_leader_uuid = queue_->GetUpToDatePeer(candidates);
+    if (new_leader_uuid.empty()) {
+      LOG_WITH_PREFIX_UNLOCKED(INFO) << "No caught up follower to transfer leadership to, "
+                                     << "stepping down without hand-off";
+    }
+  }
+
+  if (!new_leader_uuid.empty()) {
+    const auto leadership_transfer_description =
+        Format("tablet $0 from $1 to $2", tablet_id, state_->GetPeerUuid(), new_leader_uuid);
     bool new_leader_found = false;
     const RaftConfigPB& active_config = state_->GetActiveConfigUnlocked();
     for (const RaftPeerPB& peer : active_config.peers()) {
@@ -661,7 +754,7 @@ Status RaftConsensus::StepDown(const LeaderStepDownRequestPB* req, LeaderStepDow
           peer.permanent_uuid() == new_leader_uuid) {
         auto election_state = std::make_shared<RunLeaderElectionState>();
         RETURN_NOT_OK(peer_proxy_factory_->NewProxy(peer, &election_state->proxy));
-        election_state->req.set_originator_uuid(req->dest_uuid());
+        election_state->req.set_originator_uuid(state_->GetPeerUuid());
         election_state->req.set_dest_uuid(new_leader_uuid);
         election_state->req.set_tablet_id(tablet_id);
         election_state->req.mutable_committed_index()->CopyFrom(
@@ -1503,8 +1596,11 @@ Status RaftConsensus::UpdateReplica(ConsensusRequestPB* request,
 
     // Snooze the failure detector as soon as we decide to accept the message.
     // We are guaranteed to be acting as a FOLLOWER at this point by the above
-    // sanity check.
-    RETURN_NOT_OK(SnoozeFailureDetectorUnlocked());
+    // sanity check. A quiescent leader sends the next heartbeat much later, so we wait for it
+    // accordingly.
+    const MonoDelta quiescent_delay = request->quiescent() ? QuiescentLeaderFailureDelay()
+                                                           : MonoDelta::FromMicroseconds(0);
+    RETURN_NOT_OK(SnoozeFailureDetectorUnlocked(quiescent_delay, DO_NOT_LOG));
 
     // Update the expiration time of the current leader's lease, so that when this follower becomes
     // a leader, it can wait out the time interval while the old leader might still be active.
@@ -1515,7 +1611,7 @@ Status RaftConsensus::UpdateReplica(ConsensusRequestPB* request,
     }
 
     // Also prohibit voting for anyone for the minimum election timeout.
-    withhold_votes_until_ = MonoTime::Now() + MinimumElectionTimeout();
+    withhold_votes_until_ = MonoTime::Now() + MinimumElectionTimeout() + quiescent_delay;
 
     // 1 - Early commit pending (and committed) operations
     RETURN_NOT_OK(EarlyCommitUnlocked(*request, deduped_req));
@@ -1613,6 +1709,10 @@ Result<bool> RaftConsensus::EnqueuePreparesUnlocked(const ConsensusRequestPB& re
     }
   }
 
+  if (request.cache_hint_keys_size() > 0) {
+    state_->GetReplicaOperationFactoryUnlocked()->WarmCache(request.cache_hint_keys());
+  }
+
   HybridTime propagated_safe_time;
   if (request.has_propagated_safe_time()) {
     propagated_safe_time = HybridTime(request.propagated_safe_time());
@@ -1863,6 +1963,16 @@ Status RaftConsensus::RequestVote(const VoteRequestPB* request, VoteResponsePB*
     return RequestVoteRespondAlreadyVotedForOther(request, response);
   }
 
+  // A pre-election vote does not change any state, so only the log is checked.
+  if (request->preelection()) {
+    consensus::OpId local_last_logged_opid;
+    GetLatestOpIdFromLog().ToPB(&local_last_logged_opid);
+    if (OpIdLessThan(request->candidate_status().last_received(), local_last_logged_opid)) {
+      return RequestVoteRespondLastOpIdTooOld(local_last_logged_opid, request, response);
+    }
+    return RequestVoteRespondPreElectionVoteGranted(request, response);
+  }
+
   // The term advanced.
   if (request->candidate_term() > state_->GetCurrentTermUnlocked()) {
     RETURN_NOT_OK_PREPEND(HandleTermAdvanceUnlocked(request->candidate_term()),
@@ -2370,6 +2480,16 @@ Status RaftConsensus::RequestVoteRespondVoteGranted(const VoteRequestPB* request
   return Status::OK();
 }
 
+Status RaftConsensus::RequestVoteRespondPreElectionVoteGranted(const VoteRequestPB* request,
+                                                                VoteResponsePB* response) {
+  FillVoteResponseVoteGranted(response);
+  LOG(INFO) << Substitute("$0: Granting yes pre-election vote for candidate $1 in term $2.",
+                          GetRequestVoteLogPrefixUnlocked(),
+                          request->candidate_uuid(),
+                          request->candidate_term());
+  return Status::OK();
+}
+
 RaftPeerPB::Role RaftConsensus::GetRoleUnlocked() const {
   DCHECK(state_->IsLocked());
   return state_->GetActiveRoleUnlocked();
@@ -2404,6 +2524,12 @@ Consensus::LeaderStatus RaftConsensus::leader_status() const {
       return LeaderStatus::LEADER_BUT_NOT_READY;
 
     case LeaderLeaseStatus::NO_MAJORITY_REPLICATED_LEASE:
+      // A quiescent leader does not extend its lease, so wake the group up to acquire the lease
+      // again by the time the client retries.
+      if (queue_->RecordActivity()) {
+        LOG_WITH_PREFIX_UNLOCKED(INFO) << "Waking up quiescent Raft group to acquire leader lease";
+        peer_manager_->SignalRequest(RequestTriggerMode::ALWAYS_SEND);
+      }
       // Will retry to look up the leader, because it might have changed.
       return LeaderStatus::NOT_LEADER;
 
@@ -2551,6 +2677,48 @@ void RaftConsensus::ElectionCallback(const std::string& originator_uuid,
               state_->LogPrefixThreadSafe() + "Unable to run election callback");
 }
 
+void RaftConsensus::PreElectionCallback(const std::string& originator_uuid,
+                                        const ElectionResult& result) {
+  // Same as ElectionCallback, defer to our threadpool.
+  WARN_NOT_OK(raft_pool_token_->SubmitClosure(
+              Bind(&RaftConsensus::DoPreElectionCallback, this, originator_uuid, result)),
+              state_->LogPrefixThreadSafe() + "Unable to run pre-election callback");
+}
+
+void RaftConsensus::DoPreElectionCallback(const std::string& originator_uuid,
+                                          const ElectionResult& result) {
+  if (result.decision == VOTE_DENIED) {
+    LOG_WITH_PREFIX(INFO) << "Pre-election lost for term " << result.election_term
+                          << ". Reason: "
+                          << (!result.message.empty() ? result.message : "None given");
+    NotifyOriginatorAboutLostElection(originator_uuid);
+    return;
+  }
+
+  {
+    ReplicaState::UniqueLock lock;
+    Status s = state_->LockForRead(&lock);
+    if (PREDICT_FALSE(!s.ok())) {
+      LOG_WITH_PREFIX(INFO) << "Received pre-election callback for term "
+                            << result.election_term << " while not running: " << s.ToString();
+      return;
+    }
+
+    // Somebody else started an election or became leader in the meantime.
+    if (result.election_term != state_->GetCurrentTermUnlocked() + 1) {
+      LOG_WITH_PREFIX_UNLOCKED(INFO) << "Pre-election decision for defunct term "
+                                     << result.election_term;
+      return;
+    }
+  }
+
+  LOG_WITH_PREFIX(INFO) << "Pre-election won for term " << result.election_term;
+  WARN_NOT_OK(StartElectionOrPreElection(NORMAL_ELECTION, PreElection::kFalse,
+                                         false /* pending_commit */, OpId::default_instance(),
+                                         originator_uuid, TEST_SuppressVoteRequest::kFalse),
+              LogPrefix() + "Unable to start election after pre-election");
+}
+
 void RaftConsensus::NotifyOriginatorAboutLostElection(const std::string& originator_uuid) {
   if (originator_uuid.empty()) {
     return;
@@ -2688,6 +2856,15 @@ Status RaftConsensus::GetLastOpId(OpIdType type, OpId* id) {
   return Status::OK();
 }
 
+Status RaftConsensus::ReadCommittedMessages(
+    int64_t after_op_index, int max_size_bytes, ReplicateMsgs* msgs, OpId* committed_op_id) {
+  RETURN_NOT_OK(GetLastOpId(COMMITTED_OPID, committed_op_id));
+  if (after_op_index >= committed_op_id->index()) {
+    return Status::OK();
+  }
+  return queue_->ReadCommittedOps(after_op_index, committed_op_id->index(), max_size_bytes, msgs);
+}
+
 void RaftConsensus::MarkDirty(std::shared_ptr<StateChangeContext> context) {
   LOG(INFO) << "Calling mark dirty synchronously for reason code " << context->reason;
   mark_dirty_clbk_.Run(context);
@@ -2789,6 +2966,12 @@ Status RaftConsensus::SnoozeFailureDetectorUnlocked(const MonoDelta& additional_
   return failure_detector_->MessageFrom(kTimerId, time);
 }
 
+MonoDelta RaftConsensus::QuiescentLeaderFailureDelay() const {
+  return MonoDelta::FromMilliseconds(
+      FLAGS_leader_failure_max_missed_heartbeat_periods *
+      std::max(FLAGS_raft_quiescent_heartbeat_interval_ms - FLAGS_raft_heartbeat_interval_ms, 0));
+}
+
 MonoDelta RaftConsensus::MinimumElectionTimeout() const {
   int32_t failure_timeout = FLAGS_leader_failure_max_missed_heartbeat_periods *
       FLAGS_raft_heartbeat_interval_ms;
@@ -2863,6 +3046,10 @@ void RaftConsensus::SetPropagatedSafeTimeProvider(std::function<HybridTime()> pr
   queue_->SetPropagatedSafeTimeProvider(std::move(provider));
 }
 
+void RaftConsensus::SetCacheHintsProvider(std::function<std::vector<std::string>()> provider) {
+  queue_->SetCacheHintsProvider(std::move(provider));
+}
+
 void RaftConsensus::SetMajorityReplicatedListener(std::function<void()> updater) {
   majority_replicated_listener_ = std::move(updater);
 }
@@ -79,6 +79,8 @@ struct ElectionResult;
 
 typedef std::function<void()> LostLeadershipListener;
 
+YB_STRONGLY_TYPED_BOOL(PreElection);
+
 constexpr int32_t kDefaultLeaderLeaseDurationMs = 2000;
 
 class RaftConsensus : public Consensus,
@@ -212,6 +214,10 @@ class RaftConsensus : public Consensus,
 
   CHECKED_STATUS GetLastOpId(OpIdType type, OpId* id) override;
 
+  CHECKED_STATUS ReadCommittedMessages(
+      int64_t after_op_index, int max_size_bytes, ReplicateMsgs* msgs,
+      OpId* committed_op_id) override;
+
   MicrosTime MajorityReplicatedHtLeaseExpiration(
       MicrosTime min_allowed, MonoTime deadline) const override;
 
@@ -221,6 +227,10 @@ class RaftConsensus : public Consensus,
   // Set a function returning the current safe time, so we can send it from leaders to followers.
   void SetPropagatedSafeTimeProvider(std::function<HybridTime()> provider);
 
+  // Set a function returning keys that are frequently accessed on this peer, so we can send them
+  // from leaders to followers as cache hints.
+  void SetCacheHintsProvider(std::function<std::vector<std::string>()> provider);
+
   void SetMajorityReplicatedListener(std::function<void()> updater);
 
  protected:
@@ -262,6 +272,17 @@ class RaftConsensus : public Consensus,
       const std::string& originator_uuid,
       TEST_SuppressVoteRequest suppress_vote_request) override;
 
+  // Starts either a pre-election or a real election. A pre-election asks voters whether they
+  // would vote for us in the next term without changing the term anywhere, so a candidate that
+  // cannot win, e.g. a node returning from a partition, does not disrupt a healthy leader.
+  CHECKED_STATUS StartElectionOrPreElection(
+      ElectionMode mode,
+      PreElection preelection,
+      const bool pending_commit,
+      const OpId& must_be_committed_opid,
+      const std::string& originator_uuid,
+      TEST_SuppressVoteRequest suppress_vote_request);
+
   friend class ReplicaState;
   friend class RaftConsensusQuorumTest;
 
@@ -423,10 +444,18 @@ class RaftConsensus : public Consensus,
   CHECKED_STATUS RequestVoteRespondVoteGranted(const VoteRequestPB* request,
                                        VoteResponsePB* response);
 
+  // Grant a pre-election vote. Neither the term nor the vote is persisted.
+  CHECKED_STATUS RequestVoteRespondPreElectionVoteGranted(const VoteRequestPB* request,
+                                                  VoteResponsePB* response);
+
   // Callback for leader election driver. ElectionCallback is run on the
   // reactor thread, so it simply defers its work to DoElectionCallback.
   void ElectionCallback(const std::string& originator_uuid, const ElectionResult& result);
   void DoElectionCallback(const std::string& originator_uuid, const ElectionResult& result);
+
+  // Callbacks for the pre-election, a won pre-election starts the real election.
+  void PreElectionCallback(const std::string& originator_uuid, const ElectionResult& result);
+  void DoPreElectionCallback(const std::string& originator_uuid, const ElectionResult& result);
   void NotifyOriginatorAboutLostElection(const std::string& originator_uuid);
 
   // Helper struct that tracks the RunLeaderElection as part of leadership transferral.
@@ -472,6 +501,10 @@ class RaftConsensus : public Consensus,
   // jitter, election timeouts may be longer than this.
   MonoDelta MinimumElectionTimeout() const;
 
+  // Additional time to wait for the next heartbeat of a quiescent leader, compared to a regular
+  // one.
+  MonoDelta QuiescentLeaderFailureDelay() const;
+
   // Calculates an additional snooze delta for leader election.
   // The additional delta increases exponentially with the difference
   // between the current term and the term of the last committed
@@ -47,6 +47,7 @@
 #include "yb/consensus/replica_state.h"
 #include "yb/gutil/stl_util.h"
 #include "yb/gutil/strings/strcat.h"
+#include "yb/gutil/strings/split.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/consensus/log_reader.h"
 #include "yb/rpc/messenger.h"
@@ -54,6 +55,7 @@
 #include "yb/server/metadata.h"
 #include "yb/server/logical_clock.h"
 #include "yb/util/auto_release_pool.h"
+#include "yb/util/hdr_histogram.h"
 #include "yb/util/mem_tracker.h"
 #include "yb/util/metrics.h"
 #include "yb/util/test_macros.h"
@@ -63,7 +65,19 @@
 DECLARE_int32(raft_heartbeat_interval_ms);
 DECLARE_bool(enable_leader_failure_detection);
 
+DEFINE_string(consensus_bench_batch_sizes, "1,16,128",
+              "Comma separated numbers of operations submitted per batch by ReplicationBench.");
+DEFINE_string(consensus_bench_rtts_ms, "0,1,5",
+              "Comma separated simulated network round trip times used by ReplicationBench.");
+DEFINE_int32(consensus_bench_jitter_ms, 0,
+             "Maximum jitter added to every one-way delay of the simulated network.");
+DEFINE_double(consensus_bench_loss_probability, 0,
+              "Probability that the simulated network loses a consensus request.");
+DEFINE_int32(consensus_bench_ops_per_run, 512,
+             "Number of operations replicated for every batch size and round trip time.");
+
 METRIC_DECLARE_entity(tablet);
+METRIC_DECLARE_counter(log_fsyncs);
 
 #define REPLICATE_SEQUENCE_OF_MESSAGES(...) \
   ASSERT_NO_FATALS(ReplicateSequenceOfMessages(__VA_ARGS__))
@@ -89,6 +103,22 @@ const char* kTestTablet = "TestTablet";
 void DoNothing(std::shared_ptr<consensus::StateChangeContext> context) {
 }
 
+void RecordCommitLatency(HdrHistogram* histogram, MonoTime start, CountDownLatch* latch,
+                         const Status& status) {
+  CHECK_OK(status);
+  histogram->Increment(MonoTime::Now().GetDeltaSince(start).ToMicroseconds());
+  latch->CountDown();
+}
+
+std::vector<int> ParseIntList(const std::string& list) {
+  std::vector<int> result;
+  const std::vector<std::string> values = strings::Split(list, ",", strings::SkipEmpty());
+  for (const std::string& value : values) {
+    result.push_back(std::stoi(value));
+  }
+  return result;
+}
+
 // Test suite for tests that focus on multiple peer interaction, but
 // without integrating with other components, such as transactions.
 class RaftConsensusQuorumTest : public YBTest {
@@ -133,7 +163,8 @@ class RaftConsensusQuorumTest : public YBTest {
                               fs_manager->GetFirstTabletWalDirOrDie(kTestTable, kTestTablet),
                               schema_,
                               0, // schema_version
-                              NULL,
+                              metric_entity_,
+                              nullptr /* append_thread_pool */,
                               &log));
       logs_.push_back(log.get());
       fs_managers_.push_back(fs_manager.release());
@@ -144,7 +175,7 @@ class RaftConsensusQuorumTest : public YBTest {
   void BuildPeers() {
     vector<LocalTestPeerProxyFactory*> proxy_factories;
     for (int i = 0; i < config_.peers_size(); i++) {
-      auto proxy_factory = new LocalTestPeerProxyFactory(peers_.get());
+      auto proxy_factory = new LocalTestPeerProxyFactory(peers_.get(), &network_);
       proxy_factories.push_back(proxy_factory);
 
       auto operation_factory = new TestOperationFactory();
@@ -541,6 +572,8 @@ class RaftConsensusQuorumTest : public YBTest {
   vector<FsManager*> fs_managers_;
   vector<scoped_refptr<Log> > logs_;
   unique_ptr<ThreadPool> raft_pool_;
+  // Declared before the peers, so it outlives their proxies.
+  SimulatedNetwork network_;
   gscoped_ptr<TestPeerMapManager> peers_;
   std::vector<std::unique_ptr<TestOperationFactory>> operation_factories_;
   scoped_refptr<server::Clock> clock_;
@@ -1000,5 +1033,113 @@ TEST_F(RaftConsensusQuorumTest, TestRequestVote) {
   LOG(INFO) << "Follower rejected old heartbeat, as expected: " << res.ShortDebugString();
 }
 
+TEST_F(RaftConsensusQuorumTest, TestRequestPreElectionVote) {
+  ASSERT_OK(BuildAndStartConfig(3));
+
+  OpId last_op_id;
+  vector<scoped_refptr<ConsensusRound> > rounds;
+  REPLICATE_SEQUENCE_OF_MESSAGES(10,
+                                 2, // The index of the initial leader.
+                                 WAIT_FOR_ALL_REPLICAS,
+                                 COMMIT_ONE_BY_ONE,
+                                 &last_op_id,
+                                 &rounds);
+  WaitForCommitIfNotAlreadyPresent(last_op_id, 0, 2);
+  WaitForCommitIfNotAlreadyPresent(last_op_id, 1, 2);
+
+  const int kPeerIndex = 1;
+  scoped_refptr<RaftConsensus> peer;
+  CHECK_OK(peers_->GetPeerByIdx(kPeerIndex, &peer));
+
+  VoteRequestPB request;
+  request.set_tablet_id(kTestTablet);
+  request.set_preelection(true);
+  request.set_candidate_uuid("peer-0");
+  request.set_candidate_term(last_op_id.term() + 1);
+  request.mutable_candidate_status()->mutable_last_received()->CopyFrom(last_op_id);
+
+  // The leader is alive, so the pre-election vote is denied.
+  VoteResponsePB response;
+  ASSERT_OK(peer->RequestVote(&request, &response));
+  ASSERT_FALSE(response.vote_granted());
+  ASSERT_EQ(ConsensusErrorPB::LEADER_IS_ALIVE, response.consensus_error().code());
+
+  // Granted pre-election votes leave both the term and the vote untouched.
+  request.set_ignore_live_leader(true);
+  response.Clear();
+  ASSERT_OK(peer->RequestVote(&request, &response));
+  ASSERT_TRUE(response.vote_granted());
+  ASSERT_EQ(last_op_id.term(), response.responder_term());
+  ASSERT_NO_FATALS(AssertDurableTermWithoutVote(kPeerIndex, last_op_id.term()));
+
+  // Another candidate can get a pre-election vote for the same term.
+  request.set_candidate_uuid("peer-2");
+  response.Clear();
+  ASSERT_OK(peer->RequestVote(&request, &response));
+  ASSERT_TRUE(response.vote_granted());
+
+  // A candidate with an older log is denied.
+  request.mutable_candidate_status()->mutable_last_received()->CopyFrom(MinimumOpId());
+  response.Clear();
+  ASSERT_OK(peer->RequestVote(&request, &response));
+  ASSERT_FALSE(response.vote_granted());
+  ASSERT_EQ(ConsensusErrorPB::LAST_OPID_TOO_OLD, response.consensus_error().code());
+  ASSERT_NO_FATALS(AssertDurableTermWithoutVote(kPeerIndex, last_op_id.term()));
+}
+
+// Measures replication throughput and commit latency of a 3 peer config over a simulated network.
+// Batch sizes, round trip times and network faults are configured with consensus_bench_* flags.
+TEST_F(RaftConsensusQuorumTest, ReplicationBench) {
+  const int kLeaderIdx = 2;
+  ASSERT_OK(BuildAndStartConfig(3));
+  scoped_refptr<RaftConsensus> leader;
+  ASSERT_OK(peers_->GetPeerByIdx(kLeaderIdx, &leader));
+  auto fsyncs = METRIC_log_fsyncs.Instantiate(metric_entity_);
+
+  for (int rtt_ms : ParseIntList(FLAGS_consensus_bench_rtts_ms)) {
+    SimulatedNetworkOptions network_options;
+    network_options.rtt = MonoDelta::FromMilliseconds(rtt_ms);
+    network_options.jitter = MonoDelta::FromMilliseconds(FLAGS_consensus_bench_jitter_ms);
+    network_options.loss_probability = FLAGS_consensus_bench_loss_probability;
+    network_.SetOptions(network_options);
+
+    for (int batch_size : ParseIntList(FLAGS_consensus_bench_batch_sizes)) {
+      HdrHistogram latency_us(60 * MonoTime::kMicrosecondsPerSecond, 3);
+      const int64_t start_fsyncs = fsyncs->value();
+      const MonoTime start = MonoTime::Now();
+      int num_ops = 0;
+      while (num_ops < FLAGS_consensus_bench_ops_per_run) {
+        CountDownLatch latch(batch_size);
+        ConsensusRounds rounds;
+        rounds.reserve(batch_size);
+        const MonoTime batch_start = MonoTime::Now();
+        for (int i = 0; i != batch_size; ++i) {
+          auto msg = std::make_shared<ReplicateMsg>();
+          msg->set_op_type(NO_OP);
+          msg->mutable_noop_request();
+          msg->set_hybrid_time(clock_->Now().ToUint64());
+          rounds.push_back(leader->NewRound(
+              std::move(msg),
+              Bind(&RecordCommitLatency, Unretained(&latency_us), batch_start,
+                   Unretained(&latch))));
+        }
+        ASSERT_OK(leader->ReplicateBatch(rounds));
+        latch.Wait();
+        num_ops += batch_size;
+      }
+      const MonoDelta elapsed = MonoTime::Now().GetDeltaSince(start);
+
+      LOG(INFO) << "RTT: " << rtt_ms << "ms, batch size: " << batch_size
+                << ", commits/sec: " << num_ops / elapsed.ToSeconds()
+                << ", p50 commit latency: " << latency_us.ValueAtPercentile(50) << "us"
+                << ", p99 commit latency: " << latency_us.ValueAtPercentile(99) << "us"
+                << ", WAL fsyncs per commit: "
+                << (fsyncs->value() - start_fsyncs) * 1.0 / num_ops;
+    }
+  }
+
+  network_.SetOptions(SimulatedNetworkOptions());
+}
+
 }  // namespace consensus
 }  // namespace yb
@@ -783,6 +783,7 @@ Status ReplicaState::ApplyPendingOperationsUnlocked(IndexToRoundMap::iterator it
     max_allowed_op_id.index = std::numeric_limits<int64_t>::max();
   }
 
+  operation_factory_->StartApplyBatch();
   while (iter != end_iter) {
     scoped_refptr<ConsensusRound> round = (*iter).second; // Make a copy.
     DCHECK(round);
@@ -813,6 +814,7 @@ Status ReplicaState::ApplyPendingOperationsUnlocked(IndexToRoundMap::iterator it
     prev_id.CopyFrom(round->id());
     round->NotifyReplicationFinished(Status::OK());
   }
+  operation_factory_->FinishApplyBatch();
 
   SetLastCommittedIndexUnlocked(committed_index);
 
@@ -0,0 +1,90 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <gtest/gtest.h>
+
+#include "yb/docdb/blob_storage.h"
+#include "yb/docdb/value.h"
+
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+DECLARE_int64(docdb_blob_value_threshold_bytes);
+DECLARE_int64(docdb_blob_file_size_bytes);
+
+namespace yb {
+namespace docdb {
+
+class BlobStorageTest : public YBTest {
+};
+
+TEST_F(BlobStorageTest, MoveAndResolveValues) {
+  FLAGS_docdb_blob_value_threshold_bytes = 100;
+  FLAGS_docdb_blob_file_size_bytes = 1000;
+
+  BlobStorage storage(env_.get(), GetTestPath("blobs"));
+  ASSERT_OK(storage.Open());
+
+  std::string moved;
+  const auto small_value = Value(PrimitiveValue("small")).Encode();
+  auto result = MaybeMoveValueToBlob(small_value, 1, &storage, &moved);
+  ASSERT_OK(result);
+  ASSERT_FALSE(result.get());
+
+  // TTL stays in the record, so compaction filter could expire it without reading the blob.
+  std::vector<std::string> values;
+  std::vector<std::string> refs;
+  for (int i = 0; i != 3; ++i) {
+    values.push_back(
+        Value(PrimitiveValue(std::string(600, 'a' + i)), MonoDelta::FromSeconds(10)).Encode());
+    result = MaybeMoveValueToBlob(values.back(), i + 1, &storage, &moved);
+    ASSERT_OK(result);
+    ASSERT_TRUE(result.get());
+    ASSERT_LT(moved.size(), 100U);
+    MonoDelta ttl;
+    ASSERT_OK(Value::DecodeTTL(moved, &ttl));
+    ASSERT_EQ(10, ttl.ToSeconds());
+    refs.push_back(moved);
+  }
+  // Each file is rotated after it reaches 1000 bytes.
+  ASSERT_EQ(2U, storage.TEST_FileNumbers().size());
+
+  std::string resolved;
+  result = MaybeResolveBlobValue(small_value, &storage, &resolved);
+  ASSERT_OK(result);
+  ASSERT_FALSE(result.get());
+  for (size_t i = 0; i != refs.size(); ++i) {
+    result = MaybeResolveBlobValue(refs[i], &storage, &resolved);
+    ASSERT_OK(result);
+    ASSERT_TRUE(result.get());
+    ASSERT_EQ(values[i], resolved);
+  }
+
+  auto ref = ASSERT_RESULT(storage.Append("payload", 4));
+  ++ref.crc32c;
+  ASSERT_NOK(storage.Read(ref, &resolved));
+
+  // Checkpoint contains all blob files and could be opened on its own.
+  const auto checkpoint_dir = GetTestPath("checkpoint");
+  ASSERT_OK(storage.Checkpoint(checkpoint_dir));
+  BlobStorage checkpoint(env_.get(), checkpoint_dir);
+  ASSERT_OK(checkpoint.Open());
+  ASSERT_EQ(storage.TEST_FileNumbers(), checkpoint.TEST_FileNumbers());
+  result = MaybeResolveBlobValue(refs.back(), &checkpoint, &resolved);
+  ASSERT_OK(result);
+  ASSERT_TRUE(result.get());
+  ASSERT_EQ(values.back(), resolved);
+}
+
+} // namespace docdb
+} // namespace yb
@@ -0,0 +1,442 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/blob_storage.h"
+
+#include <algorithm>
+#include <set>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "yb/common/doc_hybrid_time.h"
+
+#include "yb/docdb/consensus_frontier.h"
+#include "yb/docdb/value.h"
+#include "yb/docdb/value_type.h"
+
+#include "yb/gutil/casts.h"
+#include "yb/gutil/strings/numbers.h"
+#include "yb/gutil/strings/util.h"
+
+#include "yb/rocksdb/db.h"
+#include "yb/rocksdb/util/coding.h"
+
+#include "yb/util/crc.h"
+#include "yb/util/env.h"
+#include "yb/util/env_util.h"
+#include "yb/util/flag_tags.h"
+#include "yb/util/format.h"
+#include "yb/util/path_util.h"
+#include "yb/util/size_literals.h"
+
+using namespace yb::size_literals;
+
+DEFINE_int64(docdb_blob_value_threshold_bytes, 0,
+             "String values of regular DocDB records that are at least this large are stored in "
+             "blob files instead of RocksDB, so compactions do not rewrite them. "
+             "0 disables blob files for new writes.");
+TAG_FLAG(docdb_blob_value_threshold_bytes, advanced);
+TAG_FLAG(docdb_blob_value_threshold_bytes, runtime);
+
+DEFINE_int64(docdb_blob_file_size_bytes, 256_MB,
+             "Size of a blob file after which values are appended to a new blob file.");
+TAG_FLAG(docdb_blob_file_size_bytes, advanced);
+
+namespace yb {
+namespace docdb {
+
+const char* const kBlobsSubdir = "blobs";
+
+namespace {
+
+const char* const kBlobFilePrefix = "blob-";
+const char* const kBlobFilesPropertyName = "yb.blob.files";
+
+std::string BlobFileName(uint64_t file_number) {
+  return kBlobFilePrefix + std::to_string(file_number);
+}
+
+// Skips the parts of an encoded value that precede its primitive value.
+Status SkipValueHeaders(Slice* slice) {
+  if (DecodeValueType(*slice) == ValueType::kHybridTime) {
+    slice->consume_byte();
+    DocHybridTime intent_doc_ht;
+    RETURN_NOT_OK(intent_doc_ht.DecodeFrom(slice));
+  }
+  MonoDelta ttl;
+  RETURN_NOT_OK(Value::DecodeTTL(slice, &ttl));
+  if (DecodeValueType(*slice) == ValueType::kUserTimestamp) {
+    if (slice->size() < 1 + Value::kBytesPerInt64) {
+      return STATUS(Corruption, "Failed to decode user timestamp from value, size too small");
+    }
+    slice->remove_prefix(1 + Value::kBytesPerInt64);
+  }
+  return Status::OK();
+}
+
+// Returns the number of the blob file referenced by the encoded value, or 0 if the value is stored
+// inline.
+uint64_t BlobFileOfValue(Slice value) {
+  if (!SkipValueHeaders(&value).ok() || DecodeValueType(value) != ValueType::kBlobRef) {
+    return 0;
+  }
+  value.consume_byte();
+  auto ref = BlobRef::Decode(&value);
+  return ref.ok() ? ref->file_number : 0;
+}
+
+class BlobRefsTablePropertiesCollector : public rocksdb::TablePropertiesCollector {
+ public:
+  explicit BlobRefsTablePropertiesCollector(BlobStorage* blob_storage)
+      : blob_storage_(blob_storage) {}
+
+  rocksdb::Status AddUserKey(const rocksdb::Slice& key, const rocksdb::Slice& value,
+                             rocksdb::EntryType type, rocksdb::SequenceNumber seq,
+                             uint64_t file_size) override {
+    if (type == rocksdb::kEntryPut) {
+      auto file_number = BlobFileOfValue(value);
+      if (file_number != 0) {
+        file_numbers_.insert(file_number);
+      }
+    }
+    return rocksdb::Status::OK();
+  }
+
+  rocksdb::Status Finish(rocksdb::UserCollectedProperties* properties) override {
+    if (file_numbers_.empty()) {
+      return rocksdb::Status::OK();
+    }
+    // Referenced values should be durable before the SST file is installed, since the Raft log
+    // is not replayed for the records of flushed SST files.
+    RETURN_NOT_OK(blob_storage_->Sync());
+    std::string value;
+    for (auto file_number : file_numbers_) {
+      rocksdb::PutVarint64(&value, file_number);
+    }
+    properties->emplace(kBlobFilesPropertyName, std::move(value));
+    return rocksdb::Status::OK();
+  }
+
+  rocksdb::UserCollectedProperties GetReadableProperties() const override {
+    return {{"kBlobFiles", yb::ToString(file_numbers_)}};
+  }
+
+  const char* Name() const override {
+    return "BlobRefsTablePropertiesCollector";
+  }
+
+ private:
+  BlobStorage* const blob_storage_;
+  std::set<uint64_t> file_numbers_;
+};
+
+} // namespace
+
+void BlobRef::AppendTo(std::string* out) const {
+  rocksdb::PutVarint64(out, file_number);
+  rocksdb::PutVarint64(out, offset);
+  rocksdb::PutVarint64(out, size);
+  rocksdb::PutFixed32(out, crc32c);
+}
+
+Result<BlobRef> BlobRef::Decode(Slice* input) {
+  BlobRef result;
+  if (!rocksdb::GetVarint64(input, &result.file_number) ||
+      !rocksdb::GetVarint64(input, &result.offset) ||
+      !rocksdb::GetVarint64(input, &result.size) ||
+      input->size() < sizeof(uint32_t)) {
+    return STATUS(Corruption, "Bad blob reference");
+  }
+  result.crc32c = rocksdb::DecodeFixed32(input->data());
+  input->remove_prefix(sizeof(uint32_t));
+  return result;
+}
+
+std::string BlobRef::ToString() const {
+  return Format("{ file_number: $0 offset: $1 size: $2 crc32c: $3 }",
+                file_number, offset, size, crc32c);
+}
+
+BlobStorage::BlobStorage(Env* env, std::string dir) : env_(env), dir_(std::move(dir)) {
+}
+
+BlobStorage::~BlobStorage() {
+  if (active_file_) {
+    WARN_NOT_OK(active_file_->Close(), "Failed to close blob file");
+  }
+}
+
+BlobStorage* BlobStorage::FromDB(rocksdb::DB* db) {
+  for (const auto& listener : db->GetDBOptions().listeners) {
+    auto* result = dynamic_cast<BlobStorage*>(listener.get());
+    if (result) {
+      return result;
+    }
+  }
+  return nullptr;
+}
+
+std::string BlobStorage::FileName(uint64_t file_number) const {
+  return JoinPathSegments(dir_, BlobFileName(file_number));
+}
+
+Status BlobStorage::Open() {
+  RETURN_NOT_OK(env_util::CreateDirIfMissing(env_, dir_));
+  std::vector<std::string> children;
+  RETURN_NOT_OK(env_->GetChildren(dir_, ExcludeDots::kTrue, &children));
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& child : children) {
+    uint64_t file_number;
+    if (!HasPrefixString(child, kBlobFilePrefix) ||
+        !safe_strtou64(child.substr(strlen(kBlobFilePrefix)), &file_number)) {
+      continue;
+    }
+    // Memtables are empty after restart, so existing files could be referenced by SST files only.
+    auto& info = files_[file_number];
+    info.size = VERIFY_RESULT(env_->GetFileSize(JoinPathSegments(dir_, child)));
+    next_file_number_ = std::max(next_file_number_, file_number + 1);
+  }
+  LOG(INFO) << "Opened blob storage at " << dir_ << " with " << files_.size() << " files";
+  return Status::OK();
+}
+
+Status BlobStorage::RotateUnlocked() {
+  if (!active_file_) {
+    return Status::OK();
+  }
+  auto file = std::move(active_file_);
+  active_file_synced_ = true;
+  RETURN_NOT_OK(file->Sync());
+  return file->Close();
+}
+
+Result<BlobRef> BlobStorage::Append(const Slice& value, int64_t op_index) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (active_file_ &&
+      files_[active_file_number_].size >= implicit_cast<uint64_t>(
+          FLAGS_docdb_blob_file_size_bytes)) {
+    RETURN_NOT_OK(RotateUnlocked());
+  }
+  if (!active_file_) {
+    const auto file_number = next_file_number_++;
+    WritableFileOptions options;
+    options.mode = Env::CREATE_NON_EXISTING;
+    RETURN_NOT_OK(env_util::OpenFileForWrite(
+        options, env_, FileName(file_number), &active_file_));
+    active_file_number_ = file_number;
+    files_[file_number];
+  }
+
+  auto& info = files_[active_file_number_];
+  BlobRef ref;
+  ref.file_number = active_file_number_;
+  ref.offset = info.size;
+  ref.size = value.size();
+  ref.crc32c = crc::Crc32c(value.data(), value.size());
+  active_file_synced_ = false;
+  auto status = active_file_->Append(value);
+  if (!status.ok()) {
+    // Offsets of following values are unknown after a partial write, so start a new file.
+    WARN_NOT_OK(RotateUnlocked(), "Failed to close blob file after failed append");
+    return status;
+  }
+  info.size += value.size();
+  info.max_op_index = std::max(info.max_op_index, op_index);
+  return ref;
+}
+
+Result<std::shared_ptr<RandomAccessFile>> BlobStorage::GetReader(uint64_t file_number) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = readers_.find(file_number);
+  if (it != readers_.end()) {
+    return it->second;
+  }
+  if (files_.count(file_number) == 0) {
+    return STATUS_FORMAT(NotFound, "Blob file $0 does not exist in $1", file_number, dir_);
+  }
+  std::shared_ptr<RandomAccessFile> reader;
+  RETURN_NOT_OK(env_util::OpenFileForRandom(env_, FileName(file_number), &reader));
+  readers_.emplace(file_number, reader);
+  return reader;
+}
+
+Status BlobStorage::Read(const BlobRef& ref, std::string* out) {
+  const size_t start = out->size();
+  out->resize(start + ref.size);
+  if (ref.size != 0) {
+    auto reader = VERIFY_RESULT(GetReader(ref.file_number));
+    auto* scratch = reinterpret_cast<uint8_t*>(&(*out)[start]);
+    Slice result;
+    RETURN_NOT_OK(env_util::ReadFully(reader.get(), ref.offset, ref.size, &result, scratch));
+    if (result.data() != scratch) {
+      memcpy(scratch, result.data(), result.size());
+    }
+  }
+  const auto crc32c = crc::Crc32c(out->data() + start, ref.size);
+  if (crc32c != ref.crc32c) {
+    return STATUS_FORMAT(Corruption, "Blob checksum mismatch for $0 in $1: $2",
+                         ref, dir_, crc32c);
+  }
+  return Status::OK();
+}
+
+Status BlobStorage::Sync() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!active_file_ || active_file_synced_) {
+    return Status::OK();
+  }
+  RETURN_NOT_OK(active_file_->Sync());
+  active_file_synced_ = true;
+  return Status::OK();
+}
+
+Status BlobStorage::Checkpoint(const std::string& dir) {
+  RETURN_NOT_OK(env_util::CreateDirIfMissing(env_, dir));
+  std::lock_guard<std::mutex> lock(mutex_);
+  // Hard links share contents with the original, so the checkpoint should not contain the file
+  // that is still appended to.
+  RETURN_NOT_OK(RotateUnlocked());
+  for (const auto& file : files_) {
+    RETURN_NOT_OK(env_->LinkFile(
+        FileName(file.first), JoinPathSegments(dir, BlobFileName(file.first))));
+  }
+  return Status::OK();
+}
+
+Status BlobStorage::CollectGarbage(rocksdb::DB* db) {
+  std::unique_lock<std::mutex> gc_lock(gc_mutex_, std::try_to_lock);
+  if (!gc_lock.owns_lock()) {
+    return Status::OK();
+  }
+
+  // Flushed frontier is taken first. Records of operations up to it are in SST files, so if such
+  // records referenced a blob file, it is listed by the properties of those files.
+  int64_t flushed_op_index = 0;
+  auto flushed_frontier = db->GetFlushedFrontier();
+  if (flushed_frontier) {
+    flushed_op_index =
+        down_cast<ConsensusFrontier*>(flushed_frontier.get())->op_id().index;
+  }
+
+  rocksdb::TablePropertiesCollection properties;
+  RETURN_NOT_OK(db->GetPropertiesOfAllTables(&properties));
+  std::set<uint64_t> referenced;
+  for (const auto& table : properties) {
+    const auto& user_properties = table.second->user_collected_properties;
+    auto it = user_properties.find(kBlobFilesPropertyName);
+    if (it == user_properties.end()) {
+      continue;
+    }
+    Slice input(it->second);
+    uint64_t file_number;
+    while (rocksdb::GetVarint64(&input, &file_number)) {
+      referenced.insert(file_number);
+    }
+  }
+
+  std::vector<uint64_t> garbage;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = files_.begin(); it != files_.end();) {
+      if ((active_file_ && it->first == active_file_number_) || referenced.count(it->first) ||
+          it->second.max_op_index > flushed_op_index) {
+        ++it;
+        continue;
+      }
+      garbage.push_back(it->first);
+      readers_.erase(it->first);
+      it = files_.erase(it);
+    }
+  }
+
+  for (auto file_number : garbage) {
+    LOG(INFO) << "Deleting unreferenced blob file " << FileName(file_number);
+    RETURN_NOT_OK(env_->DeleteFile(FileName(file_number)));
+  }
+  return Status::OK();
+}
+
+void BlobStorage::OnFlushCompleted(rocksdb::DB* db, const rocksdb::FlushJobInfo& info) {
+  WARN_NOT_OK(CollectGarbage(db), "Failed to collect blob garbage after flush");
+}
+
+void BlobStorage::OnCompactionCompleted(
+    rocksdb::DB* db, const rocksdb::CompactionJobInfo& info) {
+  WARN_NOT_OK(CollectGarbage(db), "Failed to collect blob garbage after compaction");
+}
+
+std::vector<uint64_t> BlobStorage::TEST_FileNumbers() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<uint64_t> result;
+  for (const auto& file : files_) {
+    result.push_back(file.first);
+  }
+  return result;
+}
+
+rocksdb::TablePropertiesCollector*
+BlobRefsTablePropertiesCollectorFactory::CreateTablePropertiesCollector(
+    rocksdb::TablePropertiesCollectorFactory::Context context) {
+  return new BlobRefsTablePropertiesCollector(blob_storage_.get());
+}
+
+const char* BlobRefsTablePropertiesCollectorFactory::Name() const {
+  return "BlobRefsTablePropertiesCollectorFactory";
+}
+
+bool BlobValuesEnabled() {
+  return FLAGS_docdb_blob_value_threshold_bytes > 0;
+}
+
+Result<bool> MaybeMoveValueToBlob(
+    const Slice& value, int64_t op_index, BlobStorage* blob_storage, std::string* out) {
+  const auto threshold = FLAGS_docdb_blob_value_threshold_bytes;
+  if (blob_storage == nullptr || threshold <= 0 ||
+      value.size() < implicit_cast<size_t>(threshold)) {
+    return false;
+  }
+  Slice primitive_value = value;
+  RETURN_NOT_OK(SkipValueHeaders(&primitive_value));
+  // Only strings (CQL text and blob columns, Redis strings) get that large.
+  if (DecodeValueType(primitive_value) != ValueType::kString) {
+    return false;
+  }
+  auto ref = VERIFY_RESULT(blob_storage->Append(primitive_value, op_index));
+  out->assign(value.cdata(), primitive_value.cdata() - value.cdata());
+  out->push_back(static_cast<char>(ValueType::kBlobRef));
+  ref.AppendTo(out);
+  return true;
+}
+
+Result<bool> MaybeResolveBlobValue(
+    const Slice& value, BlobStorage* blob_storage, std::string* out) {
+  Slice primitive_value = value;
+  RETURN_NOT_OK(SkipValueHeaders(&primitive_value));
+  if (DecodeValueType(primitive_value) != ValueType::kBlobRef) {
+    return false;
+  }
+  if (blob_storage == nullptr) {
+    return STATUS(IllegalState, "Blob reference found without blob storage");
+  }
+  const size_t headers_size = primitive_value.cdata() - value.cdata();
+  primitive_value.consume_byte();
+  auto ref = VERIFY_RESULT(BlobRef::Decode(&primitive_value));
+  out->assign(value.cdata(), headers_size);
+  RETURN_NOT_OK(blob_storage->Read(ref, out));
+  return true;
+}
+
+} // namespace docdb
+} // namespace yb
@@ -0,0 +1,166 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_BLOB_STORAGE_H
+#define YB_DOCDB_BLOB_STORAGE_H
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "yb/rocksdb/listener.h"
+#include "yb/rocksdb/table_properties.h"
+
+#include "yb/util/result.h"
+#include "yb/util/slice.h"
+#include "yb/util/status.h"
+
+namespace rocksdb {
+class DB;
+}
+
+namespace yb {
+
+class Env;
+class RandomAccessFile;
+class WritableFile;
+
+namespace docdb {
+
+// Name of the subdirectory of the regular RocksDB directory that contains blob files.
+extern const char* const kBlobsSubdir;
+
+// Location of a value that was moved out of RocksDB into a blob file. Stored in RocksDB after
+// ValueType::kBlobRef in place of the primitive value.
+struct BlobRef {
+  uint64_t file_number = 0;
+  uint64_t offset = 0;
+  uint64_t size = 0;
+  uint32_t crc32c = 0;
+
+  void AppendTo(std::string* out) const;
+  static Result<BlobRef> Decode(Slice* input);
+
+  std::string ToString() const;
+};
+
+// Append-only files that store large values of regular RocksDB records (key-value separation), so
+// compactions only rewrite small references to them. A blob file is deleted when it is no longer
+// referenced by any SST file and all records that referenced it from memtables are flushed.
+//
+// BlobStorage is registered as a listener of the RocksDB it serves, so it could be found by
+// readers of that RocksDB, see FromDB, and collect garbage after flushes and compactions.
+class BlobStorage : public rocksdb::EventListener {
+ public:
+  BlobStorage(Env* env, std::string dir);
+  ~BlobStorage();
+
+  // Returns the blob storage registered as a listener of db, or nullptr if there is none.
+  static BlobStorage* FromDB(rocksdb::DB* db);
+
+  // Scans existing blob files, should be called before RocksDB is opened.
+  CHECKED_STATUS Open();
+
+  // Appends value to the active blob file. op_index is the Raft index of the operation that writes
+  // the record referencing the value.
+  Result<BlobRef> Append(const Slice& value, int64_t op_index);
+
+  // Appends the value referenced by ref to out. Blob files are read directly, bypassing the block
+  // cache, since a single large value would evict a lot of useful blocks.
+  CHECKED_STATUS Read(const BlobRef& ref, std::string* out);
+
+  // Makes appended values durable. Called before an SST file referencing them is installed.
+  CHECKED_STATUS Sync();
+
+  // Hard links all blob files into dir. Checkpoint of RocksDB should be created first, and garbage
+  // collection paused until both are created, see PauseGarbageCollection.
+  CHECKED_STATUS Checkpoint(const std::string& dir);
+
+  std::unique_lock<std::mutex> PauseGarbageCollection() {
+    return std::unique_lock<std::mutex>(gc_mutex_);
+  }
+
+  // Deletes blob files that are not referenced from db.
+  CHECKED_STATUS CollectGarbage(rocksdb::DB* db);
+
+  void OnFlushCompleted(rocksdb::DB* db, const rocksdb::FlushJobInfo& info) override;
+
+  void OnCompactionCompleted(rocksdb::DB* db, const rocksdb::CompactionJobInfo& info) override;
+
+  const std::string& dir() const { return dir_; }
+
+  std::vector<uint64_t> TEST_FileNumbers() const;
+
+ private:
+  struct FileInfo {
+    uint64_t size = 0;
+    // Max Raft index of operations that appended values to this file.
+    int64_t max_op_index = 0;
+  };
+
+  std::string FileName(uint64_t file_number) const;
+  CHECKED_STATUS RotateUnlocked();
+  Result<std::shared_ptr<RandomAccessFile>> GetReader(uint64_t file_number);
+
+  Env* const env_;
+  const std::string dir_;
+
+  mutable std::mutex mutex_;
+  std::map<uint64_t, FileInfo> files_;
+  uint64_t next_file_number_ = 1;
+  uint64_t active_file_number_ = 0;
+  std::shared_ptr<WritableFile> active_file_;
+  bool active_file_synced_ = true;
+  std::unordered_map<uint64_t, std::shared_ptr<RandomAccessFile>> readers_;
+
+  // Held while garbage is collected, or while a checkpoint is created.
+  std::mutex gc_mutex_;
+};
+
+// Collects numbers of blob files referenced from an SST file and stores them as
+// kBlobFilesPropertyName, so the blob storage knows which blob files are still in use.
+class BlobRefsTablePropertiesCollectorFactory : public rocksdb::TablePropertiesCollectorFactory {
+ public:
+  explicit BlobRefsTablePropertiesCollectorFactory(std::shared_ptr<BlobStorage> blob_storage)
+      : blob_storage_(std::move(blob_storage)) {}
+
+  rocksdb::TablePropertiesCollector* CreateTablePropertiesCollector(
+      rocksdb::TablePropertiesCollectorFactory::Context context) override;
+
+  const char* Name() const override;
+
+ private:
+  std::shared_ptr<BlobStorage> blob_storage_;
+};
+
+// Returns true if records written now should move large values into blob files.
+bool BlobValuesEnabled();
+
+// Stores the primitive value of the encoded DocDB value in blob storage and fills out with the
+// reference to it, when the value is larger than --docdb_blob_value_threshold_bytes. Returns false
+// when the value should be stored inline.
+Result<bool> MaybeMoveValueToBlob(
+    const Slice& value, int64_t op_index, BlobStorage* blob_storage, std::string* out);
+
+// Returns true if the encoded DocDB value is a reference to a blob, and fills out with the value
+// that the reference was created for.
+Result<bool> MaybeResolveBlobValue(
+    const Slice& value, BlobStorage* blob_storage, std::string* out);
+
+} // namespace docdb
+} // namespace yb
+
+#endif // YB_DOCDB_BLOB_STORAGE_H
@@ -22,19 +22,32 @@
 #include "yb/docdb/docdb.pb.h"
 #include "yb/docdb/docdb_rocksdb_util.h"
 #include "yb/docdb/intent.h"
+#include "yb/docdb/intents_index.h"
 #include "yb/docdb/shared_lock_manager.h"
 
 #include "yb/util/countdown_latch.h"
+#include "yb/util/flag_tags.h"
 
 using namespace std::placeholders;
 
+DEFINE_bool(wait_on_conflict, false,
+            "When a transaction conflicts with a running transaction of higher priority, wait for "
+            "it to finish instead of failing right away.");
+DEFINE_int32(max_wait_on_conflict_ms, 1000,
+             "Maximum time a transaction waits for conflicting transactions to finish, when "
+             "--wait_on_conflict is set. The transaction fails with a conflict after it.");
+DEFINE_int32(wait_on_conflict_recheck_ms, 50,
+             "How often a transaction waiting for conflicting transactions rechecks their "
+             "statuses, unless it is woken up earlier by their apply.");
+TAG_FLAG(wait_on_conflict, advanced);
+TAG_FLAG(max_wait_on_conflict_ms, advanced);
+TAG_FLAG(wait_on_conflict_recheck_ms, advanced);
+
 namespace yb {
 namespace docdb {
 
 namespace {
 
-using TransactionIdSet = std::unordered_set<TransactionId, TransactionIdHash>;
-
 struct TransactionData {
   TransactionId id;
   TransactionStatus status;
@@ -82,9 +95,12 @@ class ConflictResolverContext {
 class ConflictResolver {
  public:
   ConflictResolver(rocksdb::DB* db,
+                   rocksdb::DB* intents_db,
+                   IntentsIndex* intents_index,
                    TransactionStatusManager* status_manager,
                    ConflictResolverContext* context)
-    : db_(db), status_manager_(*status_manager), context_(*context) {}
+    : db_(db), intents_db_(intents_db), intents_index_(intents_index),
+      status_manager_(*status_manager), context_(*context) {}
 
   TransactionStatusManager& status_manager() {
     return status_manager_;
@@ -103,12 +119,22 @@ class ConflictResolver {
     return ResolveConflicts();
   }
 
-  // Reads conflicts for specified intent from DB.
+  // Reads conflicts for specified intent from intents index, or from DB when the index is not
+  // available.
   CHECKED_STATUS ReadIntentConflicts(IntentType type, KeyBytes* intent_key_prefix) {
-    EnsureIntentIteratorCreated();
-
     const auto& conflicting_intent_types = kIntentConflicts[static_cast<size_t>(type)];
 
+    if (intents_index_) {
+      Slice doc_path(intent_key_prefix->data());
+      DCHECK_EQ(ValueType::kIntentPrefix, static_cast<ValueType>(doc_path[0]));
+      doc_path.consume_byte();
+      if (intents_index_->FindConflicts(doc_path, conflicting_intent_types, &conflicts_)) {
+        return Status::OK();
+      }
+    }
+
+    EnsureIntentIteratorCreated();
+
     intent_key_prefix->AppendValueType(ValueType::kIntentType);
     BOOST_SCOPE_EXIT(intent_key_prefix) {
       intent_key_prefix->RemoveValueTypeSuffix(ValueType::kIntentType);
@@ -162,7 +188,7 @@ class ConflictResolver {
   void EnsureIntentIteratorCreated() {
     if (!intent_iter_) {
       intent_iter_ = CreateRocksDBIterator(
-          db_,
+          intents_db_,
           BloomFilterMode::DONT_USE_BLOOM_FILTER,
           boost::none /* user_key_for_filter */,
           rocksdb::kDefaultQueryId);
@@ -180,7 +206,13 @@ class ConflictResolver {
         return Status::OK();
       }
 
-      RETURN_NOT_OK(context_.CheckPriority(this, &transactions_));
+      auto priority_status = context_.CheckPriority(this, &transactions_);
+      if (!priority_status.ok()) {
+        if (priority_status.IsTryAgain() && WaitForConflictingTransactions()) {
+          continue;
+        }
+        return priority_status;
+      }
 
       AbortTransactions();
 
@@ -192,6 +224,26 @@ class ConflictResolver {
     }
   }
 
+  // Waits for a change of conflicting transactions that have higher priority than ours, instead of
+  // failing with a conflict. Transactions only wait for transactions of higher priority, so there
+  // are no cycles of waiting transactions and no need for deadlock detection.
+  // Returns false if we should not wait anymore.
+  bool WaitForConflictingTransactions() {
+    if (!FLAGS_wait_on_conflict) {
+      return false;
+    }
+    auto now = MonoTime::Now();
+    if (!wait_deadline_.Initialized()) {
+      wait_deadline_ = now + MonoDelta::FromMilliseconds(FLAGS_max_wait_on_conflict_ms);
+    }
+    if (now >= wait_deadline_) {
+      return false;
+    }
+    status_manager().WaitForTransactionsChange(std::min(
+        wait_deadline_, now + MonoDelta::FromMilliseconds(FLAGS_wait_on_conflict_recheck_ms)));
+    return true;
+  }
+
   CHECKED_STATUS CheckLocalCommits() {
     auto write_iterator = transactions_.begin();
     for (const auto& transaction : transactions_) {
@@ -219,6 +271,11 @@ class ConflictResolver {
         RETURN_NOT_OK(context_.CheckConflictWithCommitted(transaction.id, transaction.commit_time));
         continue;
       } else if (status == TransactionStatus::ABORTED) {
+        // Intents of aborted transaction are never removed from intents DB, so stop tracking them
+        // once we know about the abort.
+        if (intents_index_) {
+          intents_index_->Remove(transaction.id);
+        }
         continue;
       } else {
         DCHECK(TransactionStatus::PENDING == status ||
@@ -279,11 +336,15 @@ class ConflictResolver {
   }
 
   rocksdb::DB* db_;
+  rocksdb::DB* intents_db_;
+  IntentsIndex* intents_index_;
   std::unique_ptr<rocksdb::Iterator> intent_iter_;
   TransactionStatusManager& status_manager_;
   ConflictResolverContext& context_;
   TransactionIdSet conflicts_;
   std::vector<TransactionData> transactions_;
+  // Time when we stop waiting for conflicting transactions, see WaitForConflictingTransactions.
+  MonoTime wait_deadline_;
 };
 
 // Utility class for ResolveTransactionConflicts implementation.
@@ -415,7 +476,7 @@ class OperationConflictResolverContext : public ConflictResolverContext {
 
   // Reads stored intents, that could conflict with our operations.
   CHECKED_STATUS ReadConflicts(ConflictResolver* resolver) override {
-    std::list<DocPath> doc_paths;
+    boost::container::small_vector<DocPath, 4> doc_paths;
     KeyBytes current_intent_prefix;
 
     for (const auto& doc_op : doc_ops_) {
@@ -464,19 +525,23 @@ class OperationConflictResolverContext : public ConflictResolverContext {
 Status ResolveTransactionConflicts(const KeyValueWriteBatchPB& write_batch,
                                    HybridTime hybrid_time,
                                    rocksdb::DB* db,
+                                   rocksdb::DB* intents_db,
+                                   IntentsIndex* intents_index,
                                    TransactionStatusManager* status_manager) {
   DCHECK(hybrid_time.is_valid());
   TransactionConflictResolverContext context(write_batch, hybrid_time);
-  ConflictResolver resolver(db, status_manager, &context);
+  ConflictResolver resolver(db, intents_db, intents_index, status_manager, &context);
   return resolver.Resolve();
 }
 
 Result<HybridTime> ResolveOperationConflicts(const DocOperations& doc_ops,
                                              HybridTime hybrid_time,
                                              rocksdb::DB* db,
+                                             rocksdb::DB* intents_db,
+                                             IntentsIndex* intents_index,
                                              TransactionStatusManager* status_manager) {
   OperationConflictResolverContext context(&doc_ops, hybrid_time);
-  ConflictResolver resolver(db, status_manager, &context);
+  ConflictResolver resolver(db, intents_db, intents_index, status_manager, &context);
   RETURN_NOT_OK(resolver.Resolve());
   return context.GetHybridTime();
 }
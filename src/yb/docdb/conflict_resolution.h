@@ -33,6 +33,7 @@ class TransactionStatusManager;
 
 namespace docdb {
 
+class IntentsIndex;
 class KeyValueWriteBatchPB;
 
 // Resolves conflicts for write batch of transaction.
@@ -44,10 +45,15 @@ class KeyValueWriteBatchPB;
 // write_batch - values that would be written as part of transaction.
 // hybrid_time - current hybrid time.
 // db - db that contains tablet data.
+// intents_db - db that contains intents, could be the same as db.
+// intents_index - optional in-memory index of intents, used instead of intents_db while it is
+//                 ready.
 // status_manager - status manager that should be used during this conflict resolution.
 CHECKED_STATUS ResolveTransactionConflicts(const KeyValueWriteBatchPB& write_batch,
                                            HybridTime hybrid_time,
                                            rocksdb::DB* db,
+                                           rocksdb::DB* intents_db,
+                                           IntentsIndex* intents_index,
                                            TransactionStatusManager* status_manager);
 
 // Resolves conflicts for doc operations.
@@ -61,10 +67,15 @@ CHECKED_STATUS ResolveTransactionConflicts(const KeyValueWriteBatchPB& write_bat
 // doc_ops - doc operations that would be applied as part of operation.
 // hybrid_time - current hybrid time.
 // db - db that contains tablet data.
+// intents_db - db that contains intents, could be the same as db.
+// intents_index - optional in-memory index of intents, used instead of intents_db while it is
+//                 ready.
 // status_manager - status manager that should be used during this conflict resolution.
 Result<HybridTime> ResolveOperationConflicts(const DocOperations& doc_ops,
                                              HybridTime hybrid_time,
                                              rocksdb::DB* db,
+                                             rocksdb::DB* intents_db,
+                                             IntentsIndex* intents_index,
                                              TransactionStatusManager* status_manager);
 
 struct ParsedIntent {
@@ -8,6 +8,8 @@
 
 #include "yb/docdb/subdocument.h"
 
+#include "yb/util/decimal.h"
+
 namespace yb {
 namespace docdb {
 
@@ -157,6 +159,11 @@ CHECKED_STATUS DocExprExecutor::EvalSum(const QLValue& val, QLValue *aggr_sum) {
     case InternalType::kVarintValue:
       aggr_sum->set_varint_value(aggr_sum->varint_value() + val.varint_value());
       break;
+    case InternalType::kDecimalValue:
+      aggr_sum->set_decimal_value((util::DecimalFromComparable(aggr_sum->decimal_value()) +
+                                   util::DecimalFromComparable(val.decimal_value()))
+                                      .EncodeToComparable());
+      break;
     case InternalType::kFloatValue:
       aggr_sum->set_float_value(aggr_sum->float_value() + val.float_value());
       break;
@@ -183,5 +190,228 @@ CHECKED_STATUS DocExprExecutor::EvalMin(const QLValue& val, QLValue *aggr_min) {
   return Status::OK();
 }
 
+//--------------------------------------------------------------------------------------------------
+
+namespace {
+
+bool IsBatchableIntegerType(DataType type) {
+  switch (type) {
+    case DataType::INT8: FALLTHROUGH_INTENDED;
+    case DataType::INT16: FALLTHROUGH_INTENDED;
+    case DataType::INT32: FALLTHROUGH_INTENDED;
+    case DataType::INT64:
+      return true;
+    default:
+      return false;
+  }
+}
+
+void SetIntegerValue(DataType type, int64_t value, QLValue* result) {
+  switch (type) {
+    case DataType::INT8:
+      result->set_int8_value(static_cast<int8_t>(value));
+      return;
+    case DataType::INT16:
+      result->set_int16_value(static_cast<int16_t>(value));
+      return;
+    case DataType::INT32:
+      result->set_int32_value(static_cast<int32_t>(value));
+      return;
+    case DataType::INT64:
+      result->set_int64_value(value);
+      return;
+    default:
+      break;
+  }
+  LOG(FATAL) << "Unexpected integer type " << type;
+}
+
+int64_t GetIntegerValue(const QLValue& value) {
+  switch (value.type()) {
+    case InternalType::kInt8Value: return value.int8_value();
+    case InternalType::kInt16Value: return value.int16_value();
+    case InternalType::kInt32Value: return value.int32_value();
+    case InternalType::kInt64Value: return value.int64_value();
+    default:
+      break;
+  }
+  LOG(FATAL) << "Unexpected integer value " << value.ToString();
+  return 0;
+}
+
+// Floating point values are accumulated in row order, starting from the current aggregate if any,
+// so that the result is identical to the per-row path.
+template <class T>
+T SumInRowOrder(const std::vector<T>& values, bool first_batch, T initial) {
+  size_t i = 0;
+  T sum = first_batch ? values[i++] : initial;
+  for (; i < values.size(); i++) {
+    sum += values[i];
+  }
+  return sum;
+}
+
+} // namespace
+
+bool DocExprExecutor::PrepareAggregateBatch(
+    const google::protobuf::RepeatedPtrField<QLExpressionPB>& exprs, const Schema& schema) {
+  aggr_batch_.clear();
+  aggr_batch_rows_ = 0;
+  std::vector<AggregateBatchColumn> batch;
+  batch.reserve(exprs.size());
+  for (const QLExpressionPB& expr : exprs) {
+    if (!expr.has_tscall() || expr.tscall().operands().size() != 1) {
+      return false;
+    }
+    AggregateBatchColumn column;
+    column.opcode = static_cast<TSOpcode>(expr.tscall().opcode());
+    column.column_id = kInvalidColumnId.rep();
+    column.type = DataType::UNKNOWN_DATA;
+    const QLExpressionPB& operand = expr.tscall().operands(0);
+    if (operand.has_column_id()) {
+      auto column_schema = schema.column_by_id(ColumnId(operand.column_id()));
+      if (!column_schema.ok()) {
+        return false;
+      }
+      column.column_id = operand.column_id();
+      column.type = column_schema->type()->main();
+    }
+    switch (column.opcode) {
+      case TSOpcode::kCount:
+        // COUNT(*) is sent with a constant operand and counts every row.
+        break;
+      case TSOpcode::kSum:
+        if (!IsBatchableIntegerType(column.type) && column.type != DataType::FLOAT &&
+            column.type != DataType::DOUBLE) {
+          return false;
+        }
+        break;
+      case TSOpcode::kMin: FALLTHROUGH_INTENDED;
+      case TSOpcode::kMax:
+        // Floating point MIN/MAX order NaN above all other values, so they stay on the per-row
+        // path.
+        if (!IsBatchableIntegerType(column.type)) {
+          return false;
+        }
+        break;
+      default:
+        return false;
+    }
+    batch.push_back(std::move(column));
+  }
+  if (batch.empty()) {
+    return false;
+  }
+  aggr_batch_ = std::move(batch);
+  return true;
+}
+
+CHECKED_STATUS DocExprExecutor::AddToAggregateBatch(const QLTableRow& table_row) {
+  DCHECK(aggregate_batch_prepared());
+  for (AggregateBatchColumn& column : aggr_batch_) {
+    if (column.column_id == kInvalidColumnId.rep()) {
+      column.count++;
+      continue;
+    }
+    const QLValuePB* value = table_row.GetColumn(column.column_id);
+    if (value == nullptr || IsNull(*value)) {
+      continue;
+    }
+    column.count++;
+    if (column.opcode == TSOpcode::kCount) {
+      continue;
+    }
+    switch (value->value_case()) {
+      case InternalType::kInt8Value: column.int_values.push_back(value->int8_value()); break;
+      case InternalType::kInt16Value: column.int_values.push_back(value->int16_value()); break;
+      case InternalType::kInt32Value: column.int_values.push_back(value->int32_value()); break;
+      case InternalType::kInt64Value: column.int_values.push_back(value->int64_value()); break;
+      case InternalType::kFloatValue: column.float_values.push_back(value->float_value()); break;
+      case InternalType::kDoubleValue: column.double_values.push_back(value->double_value()); break;
+      default:
+        return STATUS_FORMAT(RuntimeError, "Unexpected value type $0 for aggregate on column $1",
+                             value->value_case(), column.column_id);
+    }
+  }
+  if (++aggr_batch_rows_ >= kAggregateBatchSize) {
+    return FlushAggregateBatch();
+  }
+  return Status::OK();
+}
+
+CHECKED_STATUS DocExprExecutor::FlushAggregateBatch() {
+  if (aggr_result_.size() < aggr_batch_.size()) {
+    aggr_result_.resize(aggr_batch_.size());
+  }
+  for (size_t i = 0; i < aggr_batch_.size(); i++) {
+    RETURN_NOT_OK(FlushAggregateBatchColumn(&aggr_batch_[i], &aggr_result_[i]));
+  }
+  aggr_batch_rows_ = 0;
+  return Status::OK();
+}
+
+CHECKED_STATUS DocExprExecutor::FlushAggregateBatchColumn(AggregateBatchColumn* column,
+                                                          QLValue* aggr) {
+  if (column->count == 0) {
+    return Status::OK();
+  }
+
+  switch (column->opcode) {
+    case TSOpcode::kCount:
+      aggr->set_int64_value((aggr->IsNull() ? 0 : aggr->int64_value()) + column->count);
+      break;
+
+    case TSOpcode::kSum:
+      if (column->type == DataType::FLOAT) {
+        aggr->set_float_value(SumInRowOrder(
+            column->float_values, aggr->IsNull(), aggr->IsNull() ? 0 : aggr->float_value()));
+      } else if (column->type == DataType::DOUBLE) {
+        aggr->set_double_value(SumInRowOrder(
+            column->double_values, aggr->IsNull(), aggr->IsNull() ? 0 : aggr->double_value()));
+      } else {
+        // Integer sums wrap around at the width of the column type, which unsigned 64-bit
+        // accumulation followed by truncation reproduces.
+        uint64_t sum = aggr->IsNull() ? 0 : GetIntegerValue(*aggr);
+        for (int64_t value : column->int_values) {
+          sum += value;
+        }
+        SetIntegerValue(column->type, static_cast<int64_t>(sum), aggr);
+      }
+      break;
+
+    case TSOpcode::kMin: FALLTHROUGH_INTENDED;
+    case TSOpcode::kMax: {
+      const auto& values = column->int_values;
+      int64_t result = values.front();
+      if (column->opcode == TSOpcode::kMin) {
+        for (int64_t value : values) {
+          result = std::min(result, value);
+        }
+        if (aggr->IsNull() || GetIntegerValue(*aggr) > result) {
+          SetIntegerValue(column->type, result, aggr);
+        }
+      } else {
+        for (int64_t value : values) {
+          result = std::max(result, value);
+        }
+        if (aggr->IsNull() || GetIntegerValue(*aggr) < result) {
+          SetIntegerValue(column->type, result, aggr);
+        }
+      }
+      break;
+    }
+
+    default:
+      return STATUS_FORMAT(RuntimeError, "Unexpected batched aggregate $0",
+                           static_cast<int>(column->opcode));
+  }
+
+  column->count = 0;
+  column->int_values.clear();
+  column->float_values.clear();
+  column->double_values.clear();
+  return Status::OK();
+}
+
 }  // namespace docdb
 }  // namespace yb
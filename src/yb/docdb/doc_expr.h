@@ -7,6 +7,8 @@
 #ifndef YB_DOCDB_DOC_EXPR_H_
 #define YB_DOCDB_DOC_EXPR_H_
 
+#include <vector>
+
 #include "yb/common/ql_bfunc.h"
 #include "yb/common/ql_value.h"
 #include "yb/common/ql_expr.h"
@@ -37,8 +39,43 @@ class DocExprExecutor : public QLExprExecutor {
   CHECKED_STATUS EvalMax(const QLValue& val, QLValue *aggr_max);
   CHECKED_STATUS EvalMin(const QLValue& val, QLValue *aggr_min);
 
+  // Batched evaluation of aggregate functions. When every selected expression is a COUNT, SUM,
+  // MIN or MAX over a numeric column, the column values are gathered into flat typed arrays and
+  // folded into aggr_result_ a batch at a time instead of being evaluated row by row through
+  // QLValue. PrepareAggregateBatch() returns false if the expressions cannot be batched, in which
+  // case the caller should use the per-row path. FlushAggregateBatch() must be called before
+  // aggr_result_ is read.
+  bool PrepareAggregateBatch(const google::protobuf::RepeatedPtrField<QLExpressionPB>& exprs,
+                             const Schema& schema);
+  CHECKED_STATUS AddToAggregateBatch(const QLTableRow& table_row);
+  CHECKED_STATUS FlushAggregateBatch();
+
+  bool aggregate_batch_prepared() const {
+    return !aggr_batch_.empty();
+  }
+
  protected:
   vector<QLValue> aggr_result_;
+
+ private:
+  static constexpr size_t kAggregateBatchSize = 1024;
+
+  // Pending input of one batched aggregate expression. Only one of the value arrays is used,
+  // depending on the column type.
+  struct AggregateBatchColumn {
+    bfql::TSOpcode opcode;
+    ColumnIdRep column_id;
+    DataType type;
+    int64_t count = 0;
+    std::vector<int64_t> int_values;
+    std::vector<float> float_values;
+    std::vector<double> double_values;
+  };
+
+  CHECKED_STATUS FlushAggregateBatchColumn(AggregateBatchColumn* column, QLValue* aggr);
+
+  std::vector<AggregateBatchColumn> aggr_batch_;
+  size_t aggr_batch_rows_ = 0;
 };
 
 } // namespace docdb
@@ -22,6 +22,7 @@
 #include "yb/gutil/strings/substitute.h"
 #include "yb/rocksutil/yb_rocksdb.h"
 #include "yb/util/bytes_formatter.h"
+#include "yb/util/stopwatch.h"
 #include "yb/util/test_macros.h"
 #include "yb/util/test_util.h"
 
@@ -373,11 +374,171 @@ TEST(DocKeyTest, TestKeyMatching) {
   ASSERT_FALSE(may_match(EncodeSimpleSubDocKey(absent_key))) << "Key: " << absent_key;
 }
 
+TEST(DocKeyTest, TestKeyMatchingWithRangeComponents) {
+  DocDbAwareFilterPolicy policy(
+      rocksdb::FilterPolicy::kDefaultFixedSizeFilterBits, nullptr, 1 /* num_range_components */);
+  ASSERT_NE(
+      std::string(DocDbAwareFilterPolicy(
+          rocksdb::FilterPolicy::kDefaultFixedSizeFilterBits, nullptr).Name()),
+      policy.Name());
+  auto transformer = policy.GetKeyTransformer();
+
+  const std::string key = EncodeSubDocKey("hash", "range", "sub_key", 1000);
+  // Subkeys and hybrid time are not taken into account.
+  ASSERT_EQ(transformer->Transform(key),
+            transformer->Transform(EncodeSubDocKey("hash", "range", "another_sub_key", 2000)));
+  ASSERT_NE(transformer->Transform(key),
+            transformer->Transform(EncodeSubDocKey("hash", "another_range", "sub_key", 1000)));
+  ASSERT_NE(transformer->Transform(key),
+            transformer->Transform(EncodeSubDocKey("another_hash", "range", "sub_key", 1000)));
+  // Only first range component is taken into account.
+  const std::string two_range_components_key = SubDocKey(
+      DocKey(0, PrimitiveValues("hash"), PrimitiveValues("range", "second_range"))).Encode()
+          .AsStringRef();
+  const KeyBytes one_range_component_key =
+      DocKey(0, PrimitiveValues("hash"), PrimitiveValues("range")).Encode();
+  Slice expected_prefix = one_range_component_key.AsSlice();
+  // Range group end is not included.
+  expected_prefix.remove_suffix(1);
+  ASSERT_EQ(expected_prefix, transformer->Transform(two_range_components_key));
+  // Key without range components is filtered by hashed components only.
+  const std::string no_range_components_key = DocKey(
+      0, PrimitiveValues("hash"), PrimitiveValues()).Encode().AsStringRef();
+  ASSERT_EQ(
+      DocDbAwareFilterPolicy(rocksdb::FilterPolicy::kDefaultFixedSizeFilterBits, nullptr)
+          .GetKeyTransformer()->Transform(no_range_components_key),
+      transformer->Transform(no_range_components_key));
+
+  std::unique_ptr<FilterBitsBuilder> builder(policy.GetFilterBitsBuilder());
+  for (const auto& range_key : { "a", "b", "c" }) {
+    builder->AddKey(transformer->Transform(EncodeSubDocKey("hash", range_key, "sub_key", 1000)));
+  }
+  std::unique_ptr<const char[]> buf;
+  rocksdb::Slice filter = builder->Finish(&buf);
+  std::unique_ptr<FilterBitsReader> reader(policy.GetFilterBitsReader(filter));
+  for (const auto& range_key : { "a", "b", "c" }) {
+    ASSERT_TRUE(reader->MayMatch(transformer->Transform(
+        EncodeSubDocKey("hash", range_key, "another_sub_key", 2000)))) << range_key;
+  }
+  ASSERT_FALSE(reader->MayMatch(transformer->Transform(
+      EncodeSubDocKey("hash", "absent", "sub_key", 1000))));
+}
+
+TEST(DocKeyTest, TestHashedAndRangePrefixEqual) {
+  DocKey key(0, PrimitiveValues("hash"), PrimitiveValues("a", "b"));
+  ASSERT_TRUE(key.HashedAndRangePrefixEqual(
+      DocKey(0, PrimitiveValues("hash"), PrimitiveValues("a", "c")), 1));
+  ASSERT_FALSE(key.HashedAndRangePrefixEqual(
+      DocKey(0, PrimitiveValues("hash"), PrimitiveValues("a", "c")), 2));
+  ASSERT_FALSE(key.HashedAndRangePrefixEqual(
+      DocKey(0, PrimitiveValues("another_hash"), PrimitiveValues("a", "b")), 0));
+  // Prefix that does not fix enough range components cannot be filtered.
+  ASSERT_TRUE(key.HashedAndRangePrefixEqual(
+      DocKey(0, PrimitiveValues("hash"), PrimitiveValues()), 0));
+  ASSERT_FALSE(key.HashedAndRangePrefixEqual(
+      DocKey(0, PrimitiveValues("hash"), PrimitiveValues()), 1));
+}
+
 TEST(DocKeyTest, TestWriteId) {
   SubDocKey subdoc_key(DocKey({PrimitiveValue("a"), PrimitiveValue(135)}),
                        DocHybridTime(1000000, 4091, 135));
   TestRoundTripDocOrSubDocKeyEncodingDecoding(subdoc_key);
 }
 
+TEST(DocKeyTest, TestConsumeEncodedViews) {
+  RandomNumberGenerator rng;  // Use the default seed to keep it deterministic.
+  for (const auto& doc_key : GenRandomDocKeys(&rng, UseHash::kFalse, 1000)) {
+    KeyBytes encoded = doc_key.Encode();
+    rocksdb::Slice slice = encoded.AsSlice();
+    std::vector<EncodedPrimitiveValueView> views;
+    ASSERT_OK(ConsumePrimitiveValuesFromKey(&slice, &views));
+    ASSERT_TRUE(slice.empty());
+    ASSERT_EQ(doc_key.range_group().size(), views.size());
+    for (size_t i = 0; i != views.size(); ++i) {
+      auto decoded = views[i].Decode();
+      ASSERT_OK(decoded);
+      ASSERT_EQ(doc_key.range_group()[i], *decoded);
+    }
+  }
+}
+
+// Scans wide keys, detecting row boundaries and extracting column ids, like the row assembly in
+// DocRowwiseIterator does. Compares full decoding of keys with encoded views.
+TEST(DocKeyTest, BenchmarkWideKeyScan) {
+  constexpr int kRows = 1000;
+  constexpr int kColumns = 20;
+  constexpr int kRangeComponents = 8;
+  const int num_runs = AllowSlowTests() ? 100 : 5;
+
+  RandomNumberGenerator rng;  // Use the default seed to keep it deterministic.
+  std::vector<KeyBytes> keys;
+  for (int row = 0; row != kRows; ++row) {
+    std::vector<PrimitiveValue> range_components;
+    for (int i = 0; i != kRangeComponents; ++i) {
+      if (i % 2 == 0) {
+        range_components.emplace_back(Substitute("range_component_$0_$1", i, rng()));
+      } else {
+        range_components.emplace_back(static_cast<int64_t>(rng()));
+      }
+    }
+    DocKey doc_key(static_cast<DocKeyHash>(row), {PrimitiveValue(Substitute("hashed_$0", row))},
+                   range_components);
+    for (int column = 0; column != kColumns; ++column) {
+      keys.push_back(SubDocKey(doc_key, PrimitiveValue(ColumnId(column)),
+                               HybridTime::FromMicros(1000 + column)).Encode());
+    }
+  }
+
+  size_t decoded_rows = 0;
+  int64_t decoded_column_sum = 0;
+  Stopwatch decode_sw;
+  decode_sw.start();
+  for (int run = 0; run != num_runs; ++run) {
+    DocKey prev_doc_key;
+    for (const auto& key : keys) {
+      SubDocKey subdoc_key;
+      ASSERT_OK(subdoc_key.FullyDecodeFrom(key.AsSlice()));
+      if (!(subdoc_key.doc_key() == prev_doc_key)) {
+        ++decoded_rows;
+        prev_doc_key = subdoc_key.doc_key();
+      }
+      decoded_column_sum += subdoc_key.subkeys()[0].GetColumnId().rep();
+    }
+  }
+  decode_sw.stop();
+
+  size_t view_rows = 0;
+  int64_t view_column_sum = 0;
+  Stopwatch view_sw;
+  view_sw.start();
+  for (int run = 0; run != num_runs; ++run) {
+    rocksdb::Slice prev_doc_key;
+    for (const auto& key : keys) {
+      rocksdb::Slice slice = key.AsSlice();
+      auto doc_key_size = DocKey::EncodedSize(slice, DocKeyPart::WHOLE_DOC_KEY);
+      ASSERT_OK(doc_key_size);
+      rocksdb::Slice doc_key(slice.data(), *doc_key_size);
+      if (doc_key != prev_doc_key) {
+        ++view_rows;
+        prev_doc_key = doc_key;
+      }
+      slice.remove_prefix(*doc_key_size);
+      auto column = EncodedPrimitiveValueView::Consume(&slice);
+      ASSERT_OK(column);
+      auto column_value = column->Decode();
+      ASSERT_OK(column_value);
+      view_column_sum += column_value->GetColumnId().rep();
+    }
+  }
+  view_sw.stop();
+
+  ASSERT_EQ(static_cast<size_t>(num_runs) * kRows, decoded_rows);
+  ASSERT_EQ(decoded_rows, view_rows);
+  ASSERT_EQ(decoded_column_sum, view_column_sum);
+  LOG(INFO) << "Scanned " << num_runs * keys.size() << " keys with decoding in "
+            << decode_sw.elapsed().ToString() << ", with encoded views in "
+            << view_sw.elapsed().ToString();
+}
+
 }  // namespace docdb
 }  // namespace yb
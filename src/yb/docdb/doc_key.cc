@@ -13,6 +13,7 @@
 
 #include "yb/docdb/doc_key.h"
 
+#include <algorithm>
 #include <memory>
 #include <sstream>
 
@@ -67,7 +68,7 @@ Status ConsumePrimitiveValuesFromKey(rocksdb::Slice* slice,
                                      boost::container::small_vector_base<Slice>* result) {
   return ConsumePrimitiveValuesFromKey(slice, [slice, result] {
     auto begin = slice->data();
-    RETURN_NOT_OK(PrimitiveValue::DecodeKey(slice, nullptr));
+    RETURN_NOT_OK(PrimitiveValue::SkipKey(slice));
     if (result) {
       result->emplace_back(begin, slice->data());
     }
@@ -92,6 +93,14 @@ Status ConsumePrimitiveValuesFromKey(rocksdb::Slice* slice,
   });
 }
 
+Status ConsumePrimitiveValuesFromKey(rocksdb::Slice* slice,
+                                     std::vector<EncodedPrimitiveValueView>* result) {
+  return ConsumePrimitiveValuesFromKey(slice, [slice, result]() -> Status {
+    result->push_back(VERIFY_RESULT(EncodedPrimitiveValueView::Consume(slice)));
+    return Status::OK();
+  });
+}
+
 // ------------------------------------------------------------------------------------------------
 // DocKey
 // ------------------------------------------------------------------------------------------------
@@ -308,6 +317,14 @@ bool DocKey::HashedComponentsEqual(const DocKey& other) const {
       (!hash_present_ || (hash_ == other.hash_ && hashed_group_ == other.hashed_group_));
 }
 
+bool DocKey::HashedAndRangePrefixEqual(const DocKey& other, size_t num_range_components) const {
+  return HashedComponentsEqual(other) &&
+         range_group_.size() >= num_range_components &&
+         other.range_group_.size() >= num_range_components &&
+         std::equal(range_group_.begin(), range_group_.begin() + num_range_components,
+                    other.range_group_.begin());
+}
+
 void DocKey::AddRangeComponent(const PrimitiveValue& val) {
   range_group_.push_back(val);
 }
@@ -424,7 +441,12 @@ Result<bool> SubDocKey::DecodeSubkey(Slice* slice) {
 template<class Callback>
 Result<bool> SubDocKey::DecodeSubkey(Slice* slice, const Callback& callback) {
   if (!slice->empty() && *slice->data() != static_cast<char>(ValueType::kHybridTime)) {
-    RETURN_NOT_OK(PrimitiveValue::DecodeKey(slice, callback.AddSubkey()));
+    auto* subkey = callback.AddSubkey();
+    if (subkey) {
+      RETURN_NOT_OK(PrimitiveValue::DecodeKey(slice, subkey));
+    } else {
+      RETURN_NOT_OK(PrimitiveValue::SkipKey(slice));
+    }
     return true;
   }
   return false;
@@ -645,28 +667,58 @@ KeyBytes SubDocKey::AdvanceOutOfDocKeyPrefix() const {
 // DocDbAwareFilterPolicy
 // ------------------------------------------------------------------------------------------------
 
-namespace {
-
-class HashedComponentsExtractor : public rocksdb::FilterPolicy::KeyTransformer {
+// Extracts hashed components and up to num_range_components first range components of the key.
+class DocDbAwareFilterPolicy::KeyPrefixExtractor : public rocksdb::FilterPolicy::KeyTransformer {
  public:
-  HashedComponentsExtractor() {}
-  HashedComponentsExtractor(const HashedComponentsExtractor&) = delete;
-  HashedComponentsExtractor& operator=(const HashedComponentsExtractor&) = delete;
-
-  static HashedComponentsExtractor& GetInstance() {
-    static HashedComponentsExtractor instance;
-    return instance;
-  }
+  explicit KeyPrefixExtractor(size_t num_range_components)
+      : num_range_components_(num_range_components) {}
+  KeyPrefixExtractor(const KeyPrefixExtractor&) = delete;
+  KeyPrefixExtractor& operator=(const KeyPrefixExtractor&) = delete;
 
   Slice Transform(Slice key) const override {
     auto size = DocKey::EncodedSize(key, DocKeyPart::HASHED_PART_ONLY);
     CHECK_OK(size);
-    return Slice(key.data(), *size);
+    Slice range_part(key.data() + *size, key.end());
+    for (size_t i = 0; i != num_range_components_; ++i) {
+      if (range_part.empty() ||
+          range_part[0] == static_cast<uint8_t>(ValueType::kGroupEnd)) {
+        break;
+      }
+      CHECK_OK(PrimitiveValue::SkipKey(&range_part));
+    }
+    return Slice(key.data(), range_part.data());
   }
+
+ private:
+  const size_t num_range_components_;
 };
 
+namespace {
+
+std::string FilterPolicyName(size_t num_range_components) {
+  // Name of the policy without range components is kept, so existing filters are still used.
+  if (num_range_components == 0) {
+    return "DocKeyHashedComponentsFilter";
+  }
+  return strings::Substitute("DocKeyHashedAnd$0RangeComponentsFilter", num_range_components);
+}
+
 } // namespace
 
+DocDbAwareFilterPolicy::DocDbAwareFilterPolicy(
+    size_t filter_block_size_bits, rocksdb::Logger* logger, size_t num_range_components,
+    rocksdb::FilterBitsFormat format)
+    : num_range_components_(num_range_components),
+      name_(FilterPolicyName(num_range_components)),
+      builtin_policy_(rocksdb::NewFixedSizeFilterPolicy(
+          filter_block_size_bits, rocksdb::FilterPolicy::kDefaultFixedSizeFilterErrorRate,
+          logger, format)),
+      key_transformer_(new KeyPrefixExtractor(num_range_components)) {
+}
+
+DocDbAwareFilterPolicy::~DocDbAwareFilterPolicy() {
+}
+
 
 void DocDbAwareFilterPolicy::CreateFilter(
     const rocksdb::Slice* keys, int n, std::string* dst) const {
@@ -693,7 +745,7 @@ rocksdb::FilterPolicy::FilterType DocDbAwareFilterPolicy::GetFilterType() const
 }
 
 const rocksdb::FilterPolicy::KeyTransformer* DocDbAwareFilterPolicy::GetKeyTransformer() const {
-  return &HashedComponentsExtractor::GetInstance();
+  return key_transformer_.get();
 }
 
 }  // namespace docdb
@@ -137,6 +137,12 @@ class DocKey {
 
   bool HashedComponentsEqual(const DocKey& other) const;
 
+  // Returns true when both keys have the same hashed components and at least num_range_components
+  // range components, first num_range_components of which are equal. I.e. all keys between such
+  // keys are mapped to the same bloom filter key by DocDbAwareFilterPolicy with
+  // num_range_components range components.
+  bool HashedAndRangePrefixEqual(const DocKey& other, size_t num_range_components) const;
+
   void AddRangeComponent(const PrimitiveValue& val);
 
   int CompareTo(const DocKey& other) const;
@@ -181,6 +187,10 @@ class DocKey {
 Status ConsumePrimitiveValuesFromKey(rocksdb::Slice* slice,
                                      std::vector<PrimitiveValue>* result);
 
+// Same as above, but does not decode components, only appends views of their encoded bytes.
+Status ConsumePrimitiveValuesFromKey(rocksdb::Slice* slice,
+                                     std::vector<EncodedPrimitiveValueView>* result);
+
 inline std::ostream& operator <<(std::ostream& out, const DocKey& doc_key) {
   out << doc_key.ToString();
   return out;
@@ -496,15 +506,25 @@ inline std::ostream& operator <<(std::ostream& out, const SubDocKey& subdoc_key)
 std::string BestEffortDocDBKeyToStr(const KeyBytes &key_bytes);
 std::string BestEffortDocDBKeyToStr(const rocksdb::Slice &slice);
 
-// This filter policy only takes into account hashed components of keys for filtering.
+// This filter policy only takes into account hashed components of keys and first
+// num_range_components range components for filtering. Keys that have fewer range components are
+// filtered by all range components they have.
+//
+// Filter policy name depends on the number of range components, so filters built with a different
+// number of range components are not used for SST files and such files are always read.
+// Format of filter blocks is detected while reading, so bloom and ribbon filter blocks could be
+// mixed in the same DB.
 class DocDbAwareFilterPolicy : public rocksdb::FilterPolicy {
  public:
-  explicit DocDbAwareFilterPolicy(size_t filter_block_size_bits, rocksdb::Logger* logger) {
-    builtin_policy_.reset(rocksdb::NewFixedSizeFilterPolicy(
-        filter_block_size_bits, rocksdb::FilterPolicy::kDefaultFixedSizeFilterErrorRate, logger));
-  }
+  DocDbAwareFilterPolicy(
+      size_t filter_block_size_bits, rocksdb::Logger* logger, size_t num_range_components = 0,
+      rocksdb::FilterBitsFormat format = rocksdb::FilterBitsFormat::kBloom);
+
+  ~DocDbAwareFilterPolicy();
 
-  const char* Name() const override { return "DocKeyHashedComponentsFilter"; }
+  const char* Name() const override { return name_.c_str(); }
+
+  size_t num_range_components() const { return num_range_components_; }
 
   void CreateFilter(const rocksdb::Slice* keys, int n, std::string* dst) const override;
 
@@ -519,7 +539,12 @@ class DocDbAwareFilterPolicy : public rocksdb::FilterPolicy {
   const KeyTransformer* GetKeyTransformer() const override;
 
  private:
+  class KeyPrefixExtractor;
+
+  const size_t num_range_components_;
+  const std::string name_;
   std::unique_ptr<const rocksdb::FilterPolicy> builtin_policy_;
+  std::unique_ptr<const KeyPrefixExtractor> key_transformer_;
 };
 
 }  // namespace docdb
@@ -20,13 +20,16 @@
 #include "yb/common/partial_row.h"
 
 #include "yb/docdb/ql_rocksdb_storage.h"
+#include "yb/docdb/doc_expr.h"
 #include "yb/docdb/docdb_rocksdb_util.h"
 #include "yb/docdb/docdb_test_base.h"
 #include "yb/docdb/doc_rowwise_iterator.h"
 #include "yb/docdb/doc_ql_scanspec.h"
+#include "yb/docdb/ql_row_cache.h"
 
 #include "yb/server/hybrid_clock.h"
 
+#include "yb/util/mem_tracker.h"
 #include "yb/util/random_util.h"
 #include "yb/util/size_literals.h"
 #include "yb/util/tostring.h"
@@ -187,9 +190,14 @@ SubDocKey(DocKey(0x0000, [1], []), [ColumnId(3); HT{ <max> w: 2 }]) -> 4
     WriteQL(&ql_writereq_pb, schema, &ql_writeresp_pb, hybrid_time);
   }
 
-  QLRowBlock ReadQLRow(const Schema& schema, int32_t primary_key, const HybridTime& read_time) {
+  QLRowBlock ReadQLRow(const Schema& schema, int32_t primary_key, const HybridTime& read_time,
+                       QLRowCache* row_cache = nullptr) {
     QLReadRequestPB ql_read_req;
     ql_read_req.add_hashed_column_values()->mutable_value()->set_int32_value(primary_key);
+    // Point reads are identified by the hash code.
+    if (row_cache != nullptr) {
+      ql_read_req.set_hash_code(0);
+    }
 
     QLRowBlock row_block(schema, vector<ColumnId> ({ColumnId(0), ColumnId(1), ColumnId(2),
                                                         ColumnId(3)}));
@@ -206,12 +214,14 @@ SubDocKey(DocKey(0x0000, [1], []), [ColumnId(3); HT{ <max> w: 2 }]) -> 4
       col->type()->ToQLTypePB(rscol_desc->mutable_ql_type());
     }
 
-    QLReadOperation read_op(ql_read_req, kNonTransactionalOperationContext);
+    QLReadOperation read_op(ql_read_req, kNonTransactionalOperationContext, row_cache);
     QLRocksDBStorage ql_storage(rocksdb());
     QLResultSet resultset;
     HybridTime read_restart_ht;
+    QLReadProjections projections;
+    EXPECT_OK(projections.Init(schema, ql_read_req.column_refs()));
     EXPECT_OK(read_op.Execute(
-        ql_storage, ReadHybridTime::SingleTime(read_time), schema, query_schema, &resultset,
+        ql_storage, ReadHybridTime::SingleTime(read_time), schema, projections, &resultset,
         &read_restart_ht));
     EXPECT_FALSE(read_restart_ht.is_valid());
 
@@ -254,6 +264,55 @@ TEST_F(DocOperationTest, TestRedisSetKVWithTTL) {
   EXPECT_EQ(2000, ttl.ToMilliseconds());
 }
 
+TEST_F(DocOperationTest, TestRedisListPushPop) {
+  int64_t micros = 1000;
+  auto apply = [this, &micros](const RedisWriteRequestPB& request, RedisResponsePB* response) {
+    RedisWriteRequestPB request_pb = request;
+    request_pb.mutable_key_value()->set_key("list");
+    request_pb.mutable_key_value()->set_hash_code(123);
+    RedisWriteOperation redis_write_operation(&request_pb);
+    auto doc_write_batch = MakeDocWriteBatch();
+    ASSERT_OK(redis_write_operation.Apply(
+        {&doc_write_batch, ReadHybridTime::SingleTime(HybridTime::FromMicros(micros))}));
+    micros += 1000;
+    ASSERT_OK(WriteToRocksDB(doc_write_batch, HybridTime::FromMicros(micros)));
+    *response = redis_write_operation.response();
+  };
+  auto push = [&apply](RedisSide side, const std::vector<std::string>& values) -> int64_t {
+    RedisWriteRequestPB request;
+    request.mutable_push_request()->set_side(side);
+    for (const auto& value : values) {
+      request.mutable_key_value()->add_value(value);
+    }
+    RedisResponsePB response;
+    apply(request, &response);
+    EXPECT_EQ(RedisResponsePB_RedisStatusCode_OK, response.code());
+    return response.int_response();
+  };
+  auto pop = [&apply](RedisSide side) -> std::string {
+    RedisWriteRequestPB request;
+    request.mutable_pop_request()->set_side(side);
+    RedisResponsePB response;
+    apply(request, &response);
+    return response.code() == RedisResponsePB_RedisStatusCode_NIL ? "<nil>"
+                                                                   : response.string_response();
+  };
+
+  ASSERT_EQ(2, push(REDIS_SIDE_RIGHT, {"a", "b"}));
+  ASSERT_EQ(4, push(REDIS_SIDE_LEFT, {"y", "z"}));
+  // The list is z y a b now.
+  ASSERT_EQ("z", pop(REDIS_SIDE_LEFT));
+  ASSERT_EQ("b", pop(REDIS_SIDE_RIGHT));
+  ASSERT_EQ(3, push(REDIS_SIDE_RIGHT, {"c"}));
+  ASSERT_EQ("y", pop(REDIS_SIDE_LEFT));
+  ASSERT_EQ("c", pop(REDIS_SIDE_RIGHT));
+  ASSERT_EQ("a", pop(REDIS_SIDE_RIGHT));
+  // The list was removed together with its last element.
+  ASSERT_EQ("<nil>", pop(REDIS_SIDE_LEFT));
+  ASSERT_EQ(1, push(REDIS_SIDE_LEFT, {"d"}));
+  ASSERT_EQ("d", pop(REDIS_SIDE_RIGHT));
+}
+
 TEST_F(DocOperationTest, TestQLInsertWithTTL) {
   RunTestQLInsertUpdate(QLWriteRequestPB_QLStmtType_QL_STMT_INSERT, 2000);
 }
@@ -355,6 +414,47 @@ SubDocKey(DocKey(0x0000, [100], []), [ColumnId(3); HT{ physical: 0 logical: 3000
   EXPECT_EQ(4, row_block.row(0).column(3).int32_value());
 }
 
+TEST_F(DocOperationTest, RowCache) {
+  const DocKey doc_key(0, PrimitiveValues(PrimitiveValue::Int32(100)), PrimitiveValues());
+  KeyBytes encoded_doc_key(doc_key.Encode());
+  for (int column = 1; column <= 3; ++column) {
+    ASSERT_OK(SetPrimitive(DocPath(encoded_doc_key, PrimitiveValue(ColumnId(column))),
+                           Value(PrimitiveValue::Int32(column + 1)), HybridTime(1000)));
+  }
+
+  const Schema schema = CreateSchema();
+  QLRowCache row_cache(1_MB, MemTracker::GetRootTracker(), nullptr, nullptr);
+  QLRowBlock row_block = ReadQLRow(schema, 100, HybridTime(4000), &row_cache);
+  ASSERT_EQ(1, row_block.row_count());
+  ASSERT_EQ(2, row_block.row(0).column(1).int32_value());
+  ASSERT_EQ(1, row_cache.TEST_size());
+
+  // A write that bypasses the cache is not visible to reads served from it, but is visible to
+  // reads before the validity start of the cached row.
+  const SubDocKey sub_doc_key(doc_key, PrimitiveValue(ColumnId(1)));
+  ASSERT_OK(SetPrimitive(DocPath(encoded_doc_key, PrimitiveValue(ColumnId(1))),
+                         Value(PrimitiveValue::Int32(10)), HybridTime(3000)));
+  row_block = ReadQLRow(schema, 100, HybridTime(5000), &row_cache);
+  ASSERT_EQ(2, row_block.row(0).column(1).int32_value());
+  row_block = ReadQLRow(schema, 100, HybridTime(3500), &row_cache);
+  ASSERT_EQ(10, row_block.row(0).column(1).int32_value());
+
+  // Applied writes invalidate the row, and rows read before the write are not cached.
+  KeyValueWriteBatchPB put_batch;
+  put_batch.add_kv_pairs()->set_key(sub_doc_key.Encode().AsStringRef());
+  row_cache.Applied(put_batch, HybridTime(4500));
+  ASSERT_EQ(0, row_cache.TEST_size());
+  row_block = ReadQLRow(schema, 100, HybridTime(4000), &row_cache);
+  ASSERT_EQ(10, row_block.row(0).column(1).int32_value());
+  ASSERT_EQ(0, row_cache.TEST_size());
+  row_block = ReadQLRow(schema, 100, HybridTime(5000), &row_cache);
+  ASSERT_EQ(10, row_block.row(0).column(1).int32_value());
+  ASSERT_EQ(1, row_cache.TEST_size());
+
+  row_cache.InvalidateAll(HybridTime(6000));
+  ASSERT_EQ(0, row_cache.TEST_size());
+}
+
 TEST_F(DocOperationTest, TestQLReadWithTombstone) {
   DocKey doc_key(0, PrimitiveValues(PrimitiveValue::Int32(100)), PrimitiveValues());
   KeyBytes encoded_doc_key(doc_key.Encode());
@@ -811,5 +911,99 @@ TEST_F(DocOperationTest, MaxFileSizeWithWritesTrigger) {
   ASSERT_EQ(0, stats->GetCFStats(rocksdb::InternalStats::LEVEL0_SLOWDOWN_TOTAL));
 }
 
+namespace {
+
+class AggregateExecutor : public DocExprExecutor {
+ public:
+  const vector<QLValue>& aggr_result() const { return aggr_result_; }
+};
+
+void AddAggregate(bfql::TSOpcode opcode, ColumnId column_id,
+                  google::protobuf::RepeatedPtrField<QLExpressionPB>* exprs) {
+  auto* tscall = exprs->Add()->mutable_tscall();
+  tscall->set_opcode(static_cast<int32_t>(opcode));
+  tscall->add_operands()->set_column_id(column_id);
+}
+
+} // namespace
+
+TEST_F(DocOperationTest, BatchedAggregates) {
+  using bfql::TSOpcode;
+  ColumnSchema key_schema("k", INT32, false, true);
+  ColumnSchema int8_schema("c1", INT8, true, false);
+  ColumnSchema int64_schema("c2", INT64, true, false);
+  ColumnSchema double_schema("c3", DOUBLE, true, false);
+  const vector<ColumnSchema> columns({key_schema, int8_schema, int64_schema, double_schema});
+  Schema schema(columns, CreateColumnIds(columns.size()), 1);
+
+  google::protobuf::RepeatedPtrField<QLExpressionPB> exprs;
+  AddAggregate(TSOpcode::kCount, ColumnId(1), &exprs);
+  AddAggregate(TSOpcode::kSum, ColumnId(1), &exprs);
+  AddAggregate(TSOpcode::kMin, ColumnId(2), &exprs);
+  AddAggregate(TSOpcode::kMax, ColumnId(2), &exprs);
+  AddAggregate(TSOpcode::kSum, ColumnId(2), &exprs);
+  AddAggregate(TSOpcode::kSum, ColumnId(3), &exprs);
+
+  AggregateExecutor row_executor;
+  AggregateExecutor batch_executor;
+  vector<QLValue> expected(exprs.size());
+  ASSERT_TRUE(batch_executor.PrepareAggregateBatch(exprs, schema));
+
+  // Span several batches and include NULLs and int8 overflow.
+  for (int i = 0; i != 3000; ++i) {
+    QLTableRow row;
+    row.AllocColumn(ColumnId(0)).value.set_int32_value(i);
+    if (i % 7 != 0) {
+      row.AllocColumn(ColumnId(1)).value.set_int8_value(static_cast<int8_t>(i));
+      row.AllocColumn(ColumnId(2)).value.set_int64_value(RandomUniformInt<int64_t>(-1000, 1000));
+      row.AllocColumn(ColumnId(3)).value.set_double_value(RandomUniformReal(-1.0, 1.0));
+    }
+    for (int j = 0; j != exprs.size(); ++j) {
+      ASSERT_OK(row_executor.EvalExpr(exprs.Get(j), row, &expected[j]));
+    }
+    ASSERT_OK(batch_executor.AddToAggregateBatch(row));
+  }
+  ASSERT_OK(batch_executor.FlushAggregateBatch());
+
+  const auto& actual = batch_executor.aggr_result();
+  ASSERT_EQ(expected.size(), actual.size());
+  for (size_t j = 0; j != expected.size(); ++j) {
+    ASSERT_EQ(expected[j].type(), actual[j].type()) << j;
+    ASSERT_EQ(expected[j], actual[j]) << j << ": " << expected[j].ToString() << " vs "
+                                      << actual[j].ToString();
+  }
+
+  // Floating point MIN/MAX and non-column operands other than COUNT use the per-row path.
+  AddAggregate(TSOpcode::kMax, ColumnId(3), &exprs);
+  ASSERT_FALSE(batch_executor.PrepareAggregateBatch(exprs, schema));
+  ASSERT_FALSE(batch_executor.aggregate_batch_prepared());
+}
+
+TEST_F(DocOperationTest, ReadProjectionCache) {
+  const Schema schema = CreateSchema();
+  QLReferencedColumnsPB column_refs;
+  column_refs.add_ids(0);
+  column_refs.add_ids(3);
+  column_refs.add_ids(1);
+
+  QLReadProjectionCache cache;
+  auto projections = ASSERT_RESULT(cache.Get(schema, column_refs));
+  ASSERT_EQ(3, projections->query_schema.num_columns());
+  ASSERT_EQ(0, projections->static_projection.num_columns());
+  // The key column is not scanned, the other ones are scanned in column id order.
+  ASSERT_EQ(2, projections->non_static_projection.num_columns());
+  ASSERT_EQ(ColumnId(1), projections->non_static_projection.column_id(0));
+  ASSERT_EQ(ColumnId(3), projections->non_static_projection.column_id(1));
+
+  // The same columns share the projections, other columns or schemas get their own.
+  ASSERT_EQ(projections, ASSERT_RESULT(cache.Get(schema, column_refs)));
+  QLReferencedColumnsPB other_refs;
+  other_refs.add_ids(1);
+  other_refs.add_ids(3);
+  ASSERT_NE(projections, ASSERT_RESULT(cache.Get(schema, other_refs)));
+  const Schema other_schema = CreateSchema();
+  ASSERT_NE(projections, ASSERT_RESULT(cache.Get(other_schema, column_refs)));
+}
+
 }  // namespace docdb
 }  // namespace yb
@@ -11,6 +11,10 @@
 // under the License.
 //
 
+#include <unordered_set>
+
+#include <boost/functional/hash.hpp>
+
 #include "yb/common/partition.h"
 #include "yb/common/ql_scanspec.h"
 #include "yb/common/ql_storage_interface.h"
@@ -24,9 +28,12 @@
 #include "yb/docdb/doc_ql_scanspec.h"
 #include "yb/docdb/doc_rowwise_iterator.h"
 #include "yb/docdb/intent_aware_iterator.h"
+#include "yb/docdb/ql_row_cache.h"
 #include "yb/docdb/subdocument.h"
 #include "yb/server/hybrid_clock.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/util/bfql/directory.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/stol_utils.h"
 #include "yb/util/trace.h"
 
@@ -42,16 +49,33 @@ DEFINE_bool(emulate_redis_responses,
     "and HDEL. If emulate_redis_responses is true, we read the required records to compute the "
     "response as specified by the official Redis API documentation. https://redis.io/commands");
 
+DEFINE_bool(ql_batch_aggregates, true,
+            "Evaluate COUNT, SUM, MIN and MAX over numeric columns in batches of column values "
+            "instead of row by row.");
+TAG_FLAG(ql_batch_aggregates, advanced);
+TAG_FLAG(ql_batch_aggregates, runtime);
+
+DEFINE_int32(ql_read_projection_cache_size, 256,
+             "Maximum number of column sets per tablet whose read projections are cached. "
+             "0 disables the cache.");
+TAG_FLAG(ql_read_projection_cache_size, advanced);
+TAG_FLAG(ql_read_projection_cache_size, runtime);
+
+DEFINE_bool(ql_blind_counter_updates, true,
+            "Write increments and decrements of counter columns as deltas that are added up on "
+            "read and compaction, instead of reading the counter before the write.");
+TAG_FLAG(ql_blind_counter_updates, advanced);
+TAG_FLAG(ql_blind_counter_updates, runtime);
+
 namespace yb {
 namespace docdb {
 
 using std::set;
-using std::list;
 using std::make_shared;
 using std::unique_ptr;
 using strings::Substitute;
 
-void RedisWriteOperation::GetDocPathsToLock(list<DocPath> *paths, IsolationLevel *level) const {
+void RedisWriteOperation::GetDocPathsToLock(DocPathsToLock *paths, IsolationLevel *level) const {
   paths->push_back(DocPath::DocPathFromRedisKey(request_.key_value().hash_code(),
                                                 request_.key_value().key()));
   *level = IsolationLevel::SNAPSHOT_ISOLATION;
@@ -178,6 +202,8 @@ Result<RedisDataType> GetRedisValueType(
       return REDIS_TYPE_TIMESERIES;
     case ValueType::kRedisSortedSet:
       return REDIS_TYPE_SORTEDSET;
+    case ValueType::kArray:
+      return REDIS_TYPE_LIST;
     case ValueType::kNull: FALLTHROUGH_INTENDED; // This value is a set member.
     case ValueType::kString:
       return REDIS_TYPE_STRING;
@@ -420,6 +446,58 @@ CHECKED_STATUS GetCardinality(IntentAwareIterator* iterator,
   return Status::OK();
 }
 
+// Elements of a redis list are stored at consecutive array indexes in (head, tail]. Both bounds are
+// kept under the kCounter subkey of the list, so pushing or popping an element touches a constant
+// number of keys, and the i-th element of the list is a point lookup of ArrayIndex(head + 1 + i).
+struct RedisListBounds {
+  int64_t head = 0;
+  int64_t tail = 0;
+
+  int64_t size() const { return tail - head; }
+};
+
+PrimitiveValue RedisListBoundSubKey(RedisSide side) {
+  return PrimitiveValue(side == REDIS_SIDE_LEFT ? "head" : "tail");
+}
+
+CHECKED_STATUS GetListBounds(IntentAwareIterator* iterator,
+                             const RedisKeyValuePB& kv,
+                             RedisListBounds* bounds) {
+  SubDocKey key_bounds = SubDocKey(DocKey::FromRedisKey(kv.hash_code(), kv.key()),
+                                   PrimitiveValue(ValueType::kCounter));
+  SubDocument subdoc_bounds;
+
+  bool subdoc_bounds_found = false;
+  GetSubDocumentData data = { &key_bounds, &subdoc_bounds, &subdoc_bounds_found };
+
+  RETURN_NOT_OK(GetSubDocument(iterator, data, /* projection */ nullptr, SeekFwdSuffices::kFalse));
+
+  *bounds = RedisListBounds();
+  if (subdoc_bounds_found) {
+    const SubDocument* head = subdoc_bounds.GetChild(RedisListBoundSubKey(REDIS_SIDE_LEFT));
+    const SubDocument* tail = subdoc_bounds.GetChild(RedisListBoundSubKey(REDIS_SIDE_RIGHT));
+    if (head == nullptr || tail == nullptr || head->GetInt64() > tail->GetInt64()) {
+      return STATUS_FORMAT(Corruption, "Invalid redis list bounds: $0", subdoc_bounds.ToString());
+    }
+    bounds->head = head->GetInt64();
+    bounds->tail = tail->GetInt64();
+  }
+  return Status::OK();
+}
+
+DocPath RedisListPath(const RedisKeyValuePB& kv, const PrimitiveValue& subkey) {
+  DocPath doc_path = DocPath::DocPathFromRedisKey(kv.hash_code(), kv.key());
+  doc_path.AddSubKey(subkey);
+  return doc_path;
+}
+
+CHECKED_STATUS SetListBound(const RedisKeyValuePB& kv, RedisSide side, int64_t value,
+                            rocksdb::QueryId query_id, DocWriteBatch* doc_write_batch) {
+  DocPath doc_path = RedisListPath(kv, PrimitiveValue(ValueType::kCounter));
+  doc_path.AddSubKey(RedisListBoundSubKey(side));
+  return doc_write_batch->SetPrimitive(doc_path, Value(PrimitiveValue(value)), query_id);
+}
+
 template <typename AddResponseValues>
 CHECKED_STATUS GetAndPopulateResponseValues(
     IntentAwareIterator* iterator,
@@ -1010,7 +1088,60 @@ Status RedisWriteOperation::ApplyIncr(const DocOperationApplyData& data) {
 }
 
 Status RedisWriteOperation::ApplyPush(const DocOperationApplyData& data) {
-  return STATUS(NotSupported, "Redis operation has not been implemented");
+  const RedisKeyValuePB& kv = request_.key_value();
+  auto data_type = GetValueType(data);
+  RETURN_NOT_OK(data_type);
+
+  if (*data_type != REDIS_TYPE_LIST && *data_type != REDIS_TYPE_NONE) {
+    response_.set_code(RedisResponsePB_RedisStatusCode_WRONG_TYPE);
+    response_.set_error_message(wrong_type_message);
+    return Status::OK();
+  }
+
+  if (kv.value_size() == 0) {
+    return STATUS(InvalidCommand, "Push request has no values set");
+  }
+
+  RedisListBounds bounds;
+  if (*data_type == REDIS_TYPE_NONE) {
+    if (request_.push_request().assume_exists()) {
+      response_.set_code(RedisResponsePB_RedisStatusCode_OK);
+      response_.set_int_response(0);
+      return Status::OK();
+    }
+    RETURN_NOT_OK(data.doc_write_batch->SetPrimitive(
+        DocPath::DocPathFromRedisKey(kv.hash_code(), kv.key()),
+        Value(PrimitiveValue(ValueType::kArray)), redis_query_id()));
+  } else {
+    RETURN_NOT_OK(GetListBounds(iterator_.get(), kv, &bounds));
+  }
+
+  const RedisSide side = request_.push_request().side();
+  for (const auto& value : kv.value()) {
+    int64_t index;
+    if (side == REDIS_SIDE_LEFT) {
+      index = bounds.head--;
+    } else {
+      index = ++bounds.tail;
+    }
+    RETURN_NOT_OK(data.doc_write_batch->SetPrimitive(
+        RedisListPath(kv, PrimitiveValue::ArrayIndex(index)), Value(PrimitiveValue(value)),
+        redis_query_id()));
+  }
+  RETURN_NOT_OK(SetListBound(
+      kv, side, side == REDIS_SIDE_LEFT ? bounds.head : bounds.tail, redis_query_id(),
+      data.doc_write_batch));
+  if (*data_type == REDIS_TYPE_NONE) {
+    // Both bounds are always present, so the other one is written for a new list as well.
+    RETURN_NOT_OK(SetListBound(
+        kv, side == REDIS_SIDE_LEFT ? REDIS_SIDE_RIGHT : REDIS_SIDE_LEFT,
+        side == REDIS_SIDE_LEFT ? bounds.tail : bounds.head, redis_query_id(),
+        data.doc_write_batch));
+  }
+
+  response_.set_code(RedisResponsePB_RedisStatusCode_OK);
+  response_.set_int_response(bounds.size());
+  return Status::OK();
 }
 
 Status RedisWriteOperation::ApplyInsert(const DocOperationApplyData& data) {
@@ -1018,7 +1149,55 @@ Status RedisWriteOperation::ApplyInsert(const DocOperationApplyData& data) {
 }
 
 Status RedisWriteOperation::ApplyPop(const DocOperationApplyData& data) {
-  return STATUS(NotSupported, "Redis operation has not been implemented");
+  const RedisKeyValuePB& kv = request_.key_value();
+  auto data_type = GetValueType(data);
+  RETURN_NOT_OK(data_type);
+
+  if (*data_type == REDIS_TYPE_NONE) {
+    response_.set_code(RedisResponsePB_RedisStatusCode_NIL);
+    return Status::OK();
+  }
+  if (*data_type != REDIS_TYPE_LIST) {
+    response_.set_code(RedisResponsePB_RedisStatusCode_WRONG_TYPE);
+    response_.set_error_message(wrong_type_message);
+    return Status::OK();
+  }
+
+  RedisListBounds bounds;
+  RETURN_NOT_OK(GetListBounds(iterator_.get(), kv, &bounds));
+  if (bounds.size() == 0) {
+    response_.set_code(RedisResponsePB_RedisStatusCode_NIL);
+    return Status::OK();
+  }
+
+  const RedisSide side = request_.pop_request().side();
+  const int64_t index = side == REDIS_SIDE_LEFT ? ++bounds.head : bounds.tail--;
+  SubDocKey element_key(DocKey::FromRedisKey(kv.hash_code(), kv.key()),
+                        PrimitiveValue::ArrayIndex(index));
+  SubDocument element;
+  bool element_found = false;
+  GetSubDocumentData get_data = { &element_key, &element, &element_found };
+  RETURN_NOT_OK(GetSubDocument(
+      iterator_.get(), get_data, /* projection */ nullptr, SeekFwdSuffices::kFalse));
+  if (!element_found) {
+    return STATUS_FORMAT(Corruption, "Redis list element $0 not found", element_key.ToString());
+  }
+
+  if (bounds.size() == 0) {
+    // The last element was popped, so the list is removed together with its bounds.
+    RETURN_NOT_OK(data.doc_write_batch->DeleteSubDoc(
+        DocPath::DocPathFromRedisKey(kv.hash_code(), kv.key()), redis_query_id()));
+  } else {
+    RETURN_NOT_OK(data.doc_write_batch->DeleteSubDoc(
+        RedisListPath(kv, PrimitiveValue::ArrayIndex(index)), redis_query_id()));
+    RETURN_NOT_OK(SetListBound(
+        kv, side, side == REDIS_SIDE_LEFT ? bounds.head : bounds.tail, redis_query_id(),
+        data.doc_write_batch));
+  }
+
+  response_.set_code(RedisResponsePB_RedisStatusCode_OK);
+  response_.set_string_response(element.GetString());
+  return Status::OK();
 }
 
 Status RedisWriteOperation::ApplyAdd(const DocOperationApplyData& data) {
@@ -1078,14 +1257,18 @@ Status RedisWriteOperation::ApplyRemove(const DocOperationApplyData& data) {
   return STATUS(NotSupported, "Redis operation has not been implemented");
 }
 
-Status RedisReadOperation::Execute() {
-  SubDocKey doc_key(
-      DocKey::FromRedisKey(request_.key_value().hash_code(), request_.key_value().key()));
-  auto iter = yb::docdb::CreateIntentAwareIterator(
-      db_, BloomFilterMode::USE_BLOOM_FILTER,
-      doc_key.Encode().AsSlice(),
-      redis_query_id(), /* txn_op_context */ boost::none, read_time_);
-  iterator_ = std::move(iter);
+Status RedisReadOperation::Execute(IntentAwareIterator* iterator) {
+  if (iterator != nullptr) {
+    iterator_ = iterator;
+  } else {
+    SubDocKey doc_key(
+        DocKey::FromRedisKey(request_.key_value().hash_code(), request_.key_value().key()));
+    own_iterator_ = yb::docdb::CreateIntentAwareIterator(
+        db_, BloomFilterMode::USE_BLOOM_FILTER,
+        doc_key.Encode().AsSlice(),
+        redis_query_id(), /* txn_op_context */ boost::none, read_time_);
+    iterator_ = own_iterator_.get();
+  }
 
   switch (request_.request_case()) {
     case RedisReadRequestPB::RequestCase::kGetRequest:
@@ -1124,7 +1307,7 @@ Status RedisReadOperation::ExecuteHGetAllLikeCommands(ValueType value_type,
   switch (value_type) {
     case ValueType::kRedisSortedSet: {
       if (add_keys || add_values) {
-        RETURN_NOT_OK(GetSubDocument(iterator_.get(), data, /* projection */ nullptr,
+        RETURN_NOT_OK(GetSubDocument(iterator_, data, /* projection */ nullptr,
             SeekFwdSuffices::kFalse));
         response_.set_allocated_array_response(new RedisArrayPB());
         if (!doc_found) {
@@ -1138,21 +1321,37 @@ Status RedisReadOperation::ExecuteHGetAllLikeCommands(ValueType value_type,
       } else {
         int64_t card;
         data.return_type_only = true;
-        RETURN_NOT_OK(GetSubDocument(iterator_.get(), data, /* projection */ nullptr,
+        RETURN_NOT_OK(GetSubDocument(iterator_, data, /* projection */ nullptr,
             SeekFwdSuffices::kFalse));
         if (*data.doc_found && data.result->value_type() != ValueType::kRedisSortedSet) {
           response_.set_code(RedisResponsePB_RedisStatusCode_WRONG_TYPE);
           response_.set_error_message(wrong_type_message);
           return Status::OK();
         }
-        RETURN_NOT_OK(GetCardinality(iterator_.get(), request_.key_value(), &card));
+        RETURN_NOT_OK(GetCardinality(iterator_, request_.key_value(), &card));
         response_.set_int_response(card);
         response_.set_code(RedisResponsePB_RedisStatusCode_OK);
       }
       break;
     }
     default: {
-      RETURN_NOT_OK(GetSubDocument(iterator_.get(), data, /* projection */ nullptr,
+      // A paged read returns at most max_entries elements after the continuation key, so the
+      // memory used by the read is bounded by the page size instead of the collection size.
+      const bool paged = (add_keys || add_values) && request_.has_max_entries();
+      if (paged && request_.max_entries() <= 0) {
+        return STATUS_FORMAT(
+            InvalidArgument, "Invalid max entries for a paged read: $0", request_.max_entries());
+      }
+      SubDocKeyBound low_subkey = (paged && request_.has_continuation_key()) ?
+          SubDocKeyBound(SubDocKey(doc_key.doc_key(), PrimitiveValue(request_.continuation_key())),
+                         /* is_exclusive */ true, /* is_lower_bound */ true) :
+          SubDocKeyBound();
+      IndexBound high_index = paged ? IndexBound(request_.max_entries(), /* is_exclusive */ true,
+                                                 /* is_lower_bound */ false)
+                                    : IndexBound();
+      data.low_subkey = &low_subkey;
+      data.high_index = &high_index;
+      RETURN_NOT_OK(GetSubDocument(iterator_, data, /* projection */ nullptr,
           SeekFwdSuffices::kFalse));
       if (add_keys || add_values) {
         response_.set_allocated_array_response(new RedisArrayPB());
@@ -1163,7 +1362,11 @@ Status RedisReadOperation::ExecuteHGetAllLikeCommands(ValueType value_type,
       }
       if (VerifyTypeAndSetCode(value_type, doc.value_type(), &response_)) {
         if (add_keys || add_values) {
-          RETURN_NOT_OK(PopulateResponseFrom(doc.object_container(), AddResponseValuesGeneric,
+          const auto& elements = doc.object_container();
+          if (paged && static_cast<int64_t>(elements.size()) >= request_.max_entries()) {
+            response_.set_continuation_key(elements.rbegin()->first.GetString());
+          }
+          RETURN_NOT_OK(PopulateResponseFrom(elements, AddResponseValuesGeneric,
                                              &response_, add_keys, add_values));
         } else {
           response_.set_code(RedisResponsePB_RedisStatusCode_OK);
@@ -1235,7 +1438,7 @@ Status RedisReadOperation::ExecuteCollectionGetRange() {
         GetSubDocumentData data = { &doc_key, &doc, &doc_found };
         data.low_subkey = &low_subkey;
         data.high_subkey = &high_subkey;
-        RETURN_NOT_OK(GetAndPopulateResponseValues(iterator_.get(), AddResponseValuesSortedSets,
+        RETURN_NOT_OK(GetAndPopulateResponseValues(iterator_, AddResponseValuesSortedSets,
             data, ValueType::kObject, request_, &response_,
             /* add_keys */ add_keys, /* add_values */ true, /* reverse */ false));
       } else {
@@ -1261,7 +1464,7 @@ Status RedisReadOperation::ExecuteCollectionGetRange() {
         GetSubDocumentData data = { &doc_key, &doc, &doc_found };
         data.low_subkey = &low_subkey;
         data.high_subkey = &high_subkey;
-        RETURN_NOT_OK(GetAndPopulateResponseValues(iterator_.get(), AddResponseValuesGeneric, data,
+        RETURN_NOT_OK(GetAndPopulateResponseValues(iterator_, AddResponseValuesGeneric, data,
             ValueType::kRedisTS, request_, &response_,
             /* add_keys */ true, /* add_values */ true, /* reverse */ true));
       }
@@ -1282,7 +1485,7 @@ Status RedisReadOperation::ExecuteCollectionGetRange() {
       }
 
       int64_t card;
-      RETURN_NOT_OK(GetCardinality(iterator_.get(), request_.key_value(), &card));
+      RETURN_NOT_OK(GetCardinality(iterator_, request_.key_value(), &card));
 
       const RedisIndexBoundPB& low_index_bound = request_.index_range().lower_bound();
       const RedisIndexBoundPB& high_index_bound = request_.index_range().upper_bound();
@@ -1323,7 +1526,7 @@ Status RedisReadOperation::ExecuteCollectionGetRange() {
       data.low_index = &low_bound;
       data.high_index = &high_bound;
 
-      RETURN_NOT_OK(GetAndPopulateResponseValues(iterator_.get(), AddResponseValuesSortedSets, data,
+      RETURN_NOT_OK(GetAndPopulateResponseValues(iterator_, AddResponseValuesSortedSets, data,
       ValueType::kObject, request_, &response_,
       /* add_keys */ add_keys, /* add_values */ true, /* reverse */ true));
       break;
@@ -1335,12 +1538,12 @@ Status RedisReadOperation::ExecuteCollectionGetRange() {
 }
 
 Result<RedisDataType> RedisReadOperation::GetValueType(int subkey_index) {
-  return GetRedisValueType(iterator_.get(), request_.key_value(),
+  return GetRedisValueType(iterator_, request_.key_value(),
                            nullptr /* doc_write_batch */, subkey_index);
 }
 
 Result<RedisValue> RedisReadOperation::GetValue(int subkey_index) {
-  return GetRedisValue(iterator_.get(), request_.key_value(), subkey_index);
+  return GetRedisValue(iterator_, request_.key_value(), subkey_index);
 }
 
 Status RedisReadOperation::ExecuteGet() {
@@ -1528,15 +1731,66 @@ const RedisResponsePB& RedisReadOperation::response() {
 
 namespace {
 
-bool RequireReadForExpressions(const QLWriteRequestPB& request) {
+// Returns true and fills delta if the column value increments or decrements the counter it
+// assigns to by a constant, i.e. "c = c + 5" or "c = c - 5".
+bool IsCounterUpdate(const QLColumnValuePB& column_value, int64_t* delta) {
+  if (!column_value.subscript_args().empty() || !column_value.expr().has_bfcall()) {
+    return false;
+  }
+  const auto& bfcall = column_value.expr().bfcall();
+  if (bfcall.opcode() < 0 ||
+      static_cast<size_t>(bfcall.opcode()) >= bfql::kBFDirectory.size() ||
+      bfcall.operands_size() != 2 ||
+      bfcall.operands(0).column_id() != column_value.column_id() ||
+      !bfcall.operands(1).value().has_int64_value()) {
+    return false;
+  }
+  const char* name = bfql::kBFDirectory[bfcall.opcode()].cpp_name();
+  const int64_t value = bfcall.operands(1).value().int64_value();
+  if (strcmp(name, "IncCounter") == 0) {
+    *delta = value;
+  } else if (strcmp(name, "DecCounter") == 0) {
+    *delta = -value;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// Returns true if the only columns the request reads are counters it updates, so the updates
+// could be written as counter deltas without reading the row.
+bool HasOnlyBlindCounterUpdates(const QLWriteRequestPB& request) {
+  if (!FLAGS_ql_blind_counter_updates || request.type() != QLWriteRequestPB::QL_STMT_UPDATE ||
+      request.has_if_expr() || request.has_ttl() || request.has_user_timestamp_usec() ||
+      !request.column_refs().static_ids().empty() || request.column_values().empty()) {
+    return false;
+  }
+  std::unordered_set<int32_t> counters;
+  int64_t delta = 0;
+  for (const auto& column_value : request.column_values()) {
+    if (!IsCounterUpdate(column_value, &delta)) {
+      return false;
+    }
+    counters.insert(column_value.column_id());
+  }
+  for (const auto id : request.column_refs().ids()) {
+    if (!counters.count(id)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool RequireReadForExpressions(const QLWriteRequestPB& request, bool blind_counter_updates) {
   // A QLWriteOperation requires a read if it contains an IF clause or an UPDATE assignment that
   // involves an expresion with a column reference. If the IF clause contains a condition that
   // involves a column reference, the column will be included in "column_refs". However, we cannot
   // rely on non-empty "column_ref" alone to decide if a read is required because "IF EXISTS" and
-  // "IF NOT EXISTS" do not involve a column reference explicitly.
+  // "IF NOT EXISTS" do not involve a column reference explicitly. Counter updates that are written
+  // as deltas reference the counters without reading them.
   return request.has_if_expr()
-      || request.has_column_refs() && (!request.column_refs().ids().empty() ||
-          !request.column_refs().static_ids().empty());
+      || !blind_counter_updates && request.has_column_refs() &&
+          (!request.column_refs().ids().empty() || !request.column_refs().static_ids().empty());
 }
 
 // If range key portion is missing and there are no targeted columns this is a range operation
@@ -1549,7 +1803,8 @@ bool IsRangeOperation(const QLWriteRequestPB& request, const Schema& schema) {
          request.column_values().empty();
 }
 
-bool RequireRead(const QLWriteRequestPB& request, const Schema& schema) {
+bool RequireRead(
+    const QLWriteRequestPB& request, const Schema& schema, bool blind_counter_updates) {
   // In case of a user supplied timestamp, we need a read (and hence appropriate locks for read
   // modify write) but it is at the docdb level on a per key basis instead of a QL read of the
   // latest row.
@@ -1558,7 +1813,8 @@ bool RequireRead(const QLWriteRequestPB& request, const Schema& schema) {
   // We need to read the rows in the given range to find out which rows to write to.
   bool is_range_operation = IsRangeOperation(request, schema);
 
-  return RequireReadForExpressions(request) || has_user_timestamp || is_range_operation;
+  return RequireReadForExpressions(request, blind_counter_updates) || has_user_timestamp ||
+         is_range_operation;
 }
 
 // Append dummy entries in schema to table_row
@@ -1682,7 +1938,8 @@ bool JoinNonStaticRow(
 
 Status QLWriteOperation::Init(QLWriteRequestPB* request, QLResponsePB* response) {
   response_ = response;
-  require_read_ = RequireRead(*request, schema_);
+  blind_counter_updates_ = HasOnlyBlindCounterUpdates(*request);
+  require_read_ = RequireRead(*request, schema_, blind_counter_updates_);
 
   request_.Swap(request);
   // Determine if static / non-static columns are being written.
@@ -1745,7 +2002,7 @@ Status QLWriteOperation::InitializeKeys(const bool hashed_key, const bool primar
   return Status::OK();
 }
 
-void QLWriteOperation::GetDocPathsToLock(list<DocPath> *paths, IsolationLevel *level) const {
+void QLWriteOperation::GetDocPathsToLock(DocPathsToLock *paths, IsolationLevel *level) const {
   if (hashed_doc_path_ != nullptr)
     paths->push_back(*hashed_doc_path_);
   if (pk_doc_path_ != nullptr)
@@ -1857,7 +2114,7 @@ Status QLWriteOperation::Apply(const DocOperationApplyData& data) {
                                        &should_apply,
                                        &rowblock_,
                                        &table_row));
-  } else if (RequireReadForExpressions(request_)) {
+  } else if (RequireReadForExpressions(request_, blind_counter_updates_)) {
     RETURN_NOT_OK(ReadColumns(data, nullptr, nullptr, &table_row));
   }
 
@@ -1903,6 +2160,13 @@ Status QLWriteOperation::Apply(const DocOperationApplyData& data) {
                                               : pk_doc_path_->encoded_doc_key(),
                            PrimitiveValue(column_id));
 
+          int64_t delta = 0;
+          if (blind_counter_updates_ && IsCounterUpdate(column_value, &delta)) {
+            RETURN_NOT_OK(data.doc_write_batch->SetPrimitive(
+                sub_path, Value::CounterDelta(delta), request_.query_id()));
+            continue;
+          }
+
           QLValue expr_result;
           RETURN_NOT_OK(EvalExpr(column_value.expr(), table_row, &expr_result));
           const TSOpcode write_instr = GetTSWriteInstruction(column_value.expr());
@@ -2104,10 +2368,138 @@ Status QLWriteOperation::DeleteRow(DocWriteBatch* doc_write_batch,
   return Status::OK();
 }
 
+Status QLReadProjections::Init(const Schema& schema, const QLReferencedColumnsPB& column_refs) {
+  vector<ColumnId> column_ids;
+  column_ids.reserve(column_refs.static_ids_size() + column_refs.ids_size());
+  for (int32_t id : column_refs.static_ids()) {
+    column_ids.emplace_back(id);
+  }
+  for (int32_t id : column_refs.ids()) {
+    column_ids.emplace_back(id);
+  }
+  RETURN_NOT_OK(schema.CreateProjectionByIdsIgnoreMissing(column_ids, &query_schema));
+  return CreateProjections(schema, column_refs, &static_projection, &non_static_projection);
+}
+
+namespace {
+
+size_t HashColumnRefs(const Schema& schema, const QLReferencedColumnsPB& column_refs) {
+  size_t result = std::hash<const Schema*>()(&schema);
+  for (int32_t id : column_refs.static_ids()) {
+    boost::hash_combine(result, id);
+  }
+  // Separates the static ids from the regular ones.
+  boost::hash_combine(result, -1);
+  for (int32_t id : column_refs.ids()) {
+    boost::hash_combine(result, id);
+  }
+  return result;
+}
+
+bool SameIds(const google::protobuf::RepeatedField<int32_t>& lhs,
+             const google::protobuf::RepeatedField<int32_t>& rhs) {
+  return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+// Iterates over the single row of a point read that was found in the row cache.
+class CachedRowIterator : public common::QLRowwiseIteratorIf {
+ public:
+  CachedRowIterator(const Schema& schema, QLTableRow row)
+      : schema_(schema), row_(std::move(row)) {}
+
+  CHECKED_STATUS Init() override { return Status::OK(); }
+
+  CHECKED_STATUS Init(const common::QLScanSpec& spec) override { return Status::OK(); }
+
+  bool IsNextStaticColumn() const override { return false; }
+
+  bool HasNext() const override { return !done_; }
+
+  void SkipRow() override { done_ = true; }
+
+  CHECKED_STATUS SetPagingStateIfNecessary(const QLReadRequestPB& request,
+                                           QLResponsePB* response) const override {
+    return Status::OK();
+  }
+
+  HybridTime RestartReadHt() override { return HybridTime::kInvalid; }
+
+  std::string ToString() const override { return "CachedRowIterator"; }
+
+  const Schema& schema() const override { return schema_; }
+
+ private:
+  CHECKED_STATUS DoNextRow(const Schema& projection, QLTableRow* table_row) override {
+    if (done_) {
+      return STATUS(NotFound, "end of iter");
+    }
+    *table_row = std::move(row_);
+    done_ = true;
+    return Status::OK();
+  }
+
+  const Schema& schema_;
+  QLTableRow row_;
+  bool done_ = false;
+};
+
+} // namespace
+
+Result<std::shared_ptr<const QLReadProjections>> QLReadProjectionCache::Get(
+    const Schema& schema, const QLReferencedColumnsPB& column_refs) {
+  const size_t hash = HashColumnRefs(schema, column_refs);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto range = entries_.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      const Entry& entry = it->second;
+      if (entry.schema == &schema &&
+          SameIds(entry.column_refs.static_ids(), column_refs.static_ids()) &&
+          SameIds(entry.column_refs.ids(), column_refs.ids())) {
+        return entry.projections;
+      }
+    }
+  }
+
+  auto projections = std::make_shared<QLReadProjections>();
+  RETURN_NOT_OK(projections->Init(schema, column_refs));
+  const int32_t max_size = FLAGS_ql_read_projection_cache_size;
+  if (max_size <= 0) {
+    return projections;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (entries_.size() >= static_cast<size_t>(max_size)) {
+    // The common column sets are cached again on their next request.
+    entries_.clear();
+  }
+  entries_.emplace(hash, Entry{&schema, column_refs, projections});
+  return projections;
+}
+
+Result<boost::optional<KeyBytes>> QLReadOperation::RowCacheKey(
+    const Schema& schema, const QLReadProjections& projections) const {
+  // Only single rows of tables without range columns are cached, and only for non-transactional
+  // reads, since values of transactions could be only known as intents. Rows of tables with
+  // default TTL could expire.
+  if (row_cache_ == nullptr || txn_op_context_ || schema.num_range_key_columns() != 0 ||
+      schema.table_properties().HasDefaultTimeToLive() ||
+      !projections.static_projection.columns().empty() || request_.distinct() ||
+      request_.has_paging_state() || !request_.has_hash_code() ||
+      (request_.has_max_hash_code() && request_.max_hash_code() != request_.hash_code()) ||
+      request_.hashed_column_values_size() != schema.num_hash_key_columns()) {
+    return boost::none;
+  }
+  vector<PrimitiveValue> hashed_components;
+  RETURN_NOT_OK(QLKeyColumnValuesToPrimitiveValues(
+      request_.hashed_column_values(), schema, 0, schema.num_hash_key_columns(),
+      &hashed_components));
+  return DocKey(request_.hash_code(), hashed_components).Encode();
+}
+
 Status QLReadOperation::Execute(const common::QLStorageIf& ql_storage,
                                 const ReadHybridTime& read_time,
                                 const Schema& schema,
-                                const Schema& query_schema,
+                                const QLReadProjections& projections,
                                 QLResultSet* resultset,
                                 HybridTime* restart_read_ht) {
   size_t row_count_limit = std::numeric_limits<std::size_t>::max();
@@ -2118,13 +2510,13 @@ Status QLReadOperation::Execute(const common::QLStorageIf& ql_storage,
     row_count_limit = request_.limit();
   }
 
-  // Create the projections of the non-key columns selected by the row block plus any referenced in
-  // the WHERE condition. When DocRowwiseIterator::NextRow() populates the value map, it uses this
+  // The projections of the non-key columns selected by the row block plus any referenced in the
+  // WHERE condition. When DocRowwiseIterator::NextRow() populates the value map, it uses this
   // projection only to scan sub-documents. The query schema is used to select only referenced
   // columns and key columns.
-  Schema static_projection, non_static_projection;
-  RETURN_NOT_OK(CreateProjections(schema, request_.column_refs(),
-                                  &static_projection, &non_static_projection));
+  const Schema& query_schema = projections.query_schema;
+  const Schema& static_projection = projections.static_projection;
+  const Schema& non_static_projection = projections.non_static_projection;
   const bool read_static_columns = !static_projection.columns().empty();
   const bool read_distinct_columns = request_.distinct();
 
@@ -2134,11 +2526,22 @@ Status QLReadOperation::Execute(const common::QLStorageIf& ql_storage,
   RETURN_NOT_OK(ql_storage.BuildQLScanSpec(
       request_, read_time, schema, read_static_columns, static_projection, &spec,
       &static_row_spec, &req_read_time));
-  RETURN_NOT_OK(ql_storage.GetIterator(request_, query_schema, schema, txn_op_context_,
-                                       req_read_time, &iter));
-  RETURN_NOT_OK(iter->Init(*spec));
-  if (FLAGS_trace_docdb_calls) {
-    TRACE("Initialized iterator");
+
+  const auto row_cache_key = VERIFY_RESULT(RowCacheKey(schema, projections));
+  QLTableRow cached_row;
+  const bool row_cache_hit =
+      row_cache_key &&
+      row_cache_->Get(row_cache_key->AsSlice(), non_static_projection, req_read_time.read,
+                      &cached_row);
+  if (row_cache_hit) {
+    iter = std::make_unique<CachedRowIterator>(query_schema, std::move(cached_row));
+  } else {
+    RETURN_NOT_OK(ql_storage.GetIterator(request_, query_schema, schema, txn_op_context_,
+                                         req_read_time, &iter));
+    RETURN_NOT_OK(iter->Init(*spec));
+    if (FLAGS_trace_docdb_calls) {
+      TRACE("Initialized iterator");
+    }
   }
 
   QLTableRow static_row;
@@ -2160,9 +2563,14 @@ Status QLReadOperation::Execute(const common::QLStorageIf& ql_storage,
 
   // Begin the normal fetch.
   int match_count = 0;
+  uint64_t rows_scanned = 0;
   bool static_dealt_with = true;
+  if (request_.is_aggregate() && FLAGS_ql_batch_aggregates) {
+    PrepareAggregateBatch(request_.selected_exprs(), schema);
+  }
   while (resultset->rsrow_count() < row_count_limit && iter->HasNext()) {
     const bool last_read_static = iter->IsNextStaticColumn();
+    ++rows_scanned;
 
     // Note that static columns are sorted before non-static columns in DocDB as follows. This is
     // because "<empty_range_components>" is empty and terminated by kGroupEnd which sorts before
@@ -2237,6 +2645,9 @@ Status QLReadOperation::Execute(const common::QLStorageIf& ql_storage,
   }
 
   if (request_.is_aggregate() && match_count > 0) {
+    if (aggregate_batch_prepared()) {
+      RETURN_NOT_OK(FlushAggregateBatch());
+    }
     RETURN_NOT_OK(PopulateAggregate(selected_row, resultset));
   }
 
@@ -2245,6 +2656,17 @@ Status QLReadOperation::Execute(const common::QLStorageIf& ql_storage,
   }
   *restart_read_ht = iter->RestartReadHt();
 
+  // A read that has to be restarted could have missed a newer version of the row.
+  if (row_cache_key && !row_cache_hit && rows_scanned == 1 && !restart_read_ht->is_valid()) {
+    row_cache_->Insert(
+        row_cache_key->AsSlice(), non_static_projection, req_read_time.read, non_static_row);
+  }
+
+  auto* read_stats = response_.mutable_read_stats();
+  read_stats->set_rows_scanned(rows_scanned);
+  read_stats->set_rows_returned(match_count);
+  iter->AddReadStats(read_stats);
+
   if (resultset->rsrow_count() >= row_count_limit && !request_.is_aggregate()) {
     RETURN_NOT_OK(iter->SetPagingStateIfNecessary(request_, &response_));
   }
@@ -2300,7 +2722,9 @@ CHECKED_STATUS QLReadOperation::AddRowToResult(const std::unique_ptr<common::QLS
     RETURN_NOT_OK(spec->Match(row, &match));
     if (match) {
       (*match_count)++;
-      if (request_.is_aggregate()) {
+      if (aggregate_batch_prepared()) {
+        RETURN_NOT_OK(AddToAggregateBatch(row));
+      } else if (request_.is_aggregate()) {
         RETURN_NOT_OK(EvalAggregate(row));
       } else {
         RETURN_NOT_OK(PopulateResultSet(row, resultset));
@@ -14,7 +14,10 @@
 #ifndef YB_DOCDB_DOC_OPERATION_H_
 #define YB_DOCDB_DOC_OPERATION_H_
 
-#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#include <boost/container/small_vector.hpp>
 #include <boost/optional.hpp>
 
 #include "yb/rocksdb/db.h"
@@ -36,6 +39,7 @@ namespace yb {
 namespace docdb {
 
 class DocWriteBatch;
+class QLRowCache;
 
 struct DocOperationApplyData {
   DocWriteBatch* doc_write_batch;
@@ -43,6 +47,10 @@ struct DocOperationApplyData {
   HybridTime* restart_read_ht;
 };
 
+// Paths locked by a single operation. Operations lock one or two paths, so callers usually pass a
+// small_vector with inline storage for them, which avoids heap allocations on the write path.
+typedef boost::container::small_vector_base<DocPath> DocPathsToLock;
+
 // When specifiying the parent key, the constant -1 is used for the subkey index.
 const int kNilSubkeyIndex = -1;
 
@@ -55,7 +63,7 @@ class DocOperation {
   // QLWriteOperation for a DML with a "... IF <condition> ..." clause needs to read the row to
   // evaluate the condition before the write and needs a read snapshot for a consistent read.
   virtual bool RequireReadSnapshot() const = 0;
-  virtual void GetDocPathsToLock(std::list<DocPath> *paths, IsolationLevel *level) const = 0;
+  virtual void GetDocPathsToLock(DocPathsToLock *paths, IsolationLevel *level) const = 0;
   virtual CHECKED_STATUS Apply(const DocOperationApplyData& data) = 0;
 };
 
@@ -79,7 +87,7 @@ class RedisWriteOperation : public DocOperation {
 
   CHECKED_STATUS Apply(const DocOperationApplyData& data) override;
 
-  void GetDocPathsToLock(std::list<DocPath> *paths, IsolationLevel *level) const override;
+  void GetDocPathsToLock(DocPathsToLock *paths, IsolationLevel *level) const override;
 
   RedisResponsePB &response() { return response_; }
 
@@ -117,7 +125,9 @@ class RedisReadOperation {
                               rocksdb::DB* db,
       const ReadHybridTime& read_time) : request_(request), db_(db), read_time_(read_time) {}
 
-  CHECKED_STATUS Execute();
+  // Reads with the given iterator if it is not null, e.g. an iterator shared by a batch of reads
+  // created with CreateIntentAwareIteratorForKeys(). Otherwise creates an iterator for the key.
+  CHECKED_STATUS Execute(IntentAwareIterator* iterator = nullptr);
 
   const RedisResponsePB &response();
 
@@ -148,7 +158,8 @@ class RedisReadOperation {
   // Make these two classes similar in terms of how rocksdb state is passed to them.
   // Currently ReadOperations get the state during construction, but Write operations get them when
   // calling Apply(). Apply() and Execute() should be more similar() in definition.
-  std::unique_ptr<IntentAwareIterator> iterator_;
+  IntentAwareIterator* iterator_ = nullptr;
+  std::unique_ptr<IntentAwareIterator> own_iterator_;
 };
 
 class QLWriteOperation : public DocOperation, public DocExprExecutor {
@@ -164,7 +175,7 @@ class QLWriteOperation : public DocOperation, public DocExprExecutor {
 
   bool RequireReadSnapshot() const override { return require_read_; }
 
-  void GetDocPathsToLock(std::list<DocPath> *paths, IsolationLevel *level) const override;
+  void GetDocPathsToLock(DocPathsToLock *paths, IsolationLevel *level) const override;
 
   CHECKED_STATUS Apply(const DocOperationApplyData& data) override;
 
@@ -216,19 +227,56 @@ class QLWriteOperation : public DocOperation, public DocExprExecutor {
 
   // Does this write operation require a read?
   bool require_read_ = false;
+
+  // Are all updates of this write operation counter updates that are written as deltas?
+  bool blind_counter_updates_ = false;
+};
+
+// Projections of a table schema used to execute a QL read.
+struct QLReadProjections {
+  // The columns referenced by the query, static columns first.
+  Schema query_schema;
+  // The static and the non-static non-key columns to scan in DocDB, in column id order.
+  Schema static_projection;
+  Schema non_static_projection;
+
+  CHECKED_STATUS Init(const Schema& schema, const QLReferencedColumnsPB& column_refs);
+};
+
+// Caches QLReadProjections by schema and referenced columns, so that queries over the same columns
+// share the projections instead of building them, with their column maps, for every request.
+// Schemas are identified by address, so they must outlive the cache. This holds for the tablet
+// schemas, which are kept alive by the tablet metadata.
+class QLReadProjectionCache {
+ public:
+  Result<std::shared_ptr<const QLReadProjections>> Get(
+      const Schema& schema, const QLReferencedColumnsPB& column_refs);
+
+ private:
+  struct Entry {
+    const Schema* schema;
+    QLReferencedColumnsPB column_refs;
+    std::shared_ptr<const QLReadProjections> projections;
+  };
+
+  std::mutex mutex_;
+  std::unordered_multimap<size_t, Entry> entries_;
 };
 
 class QLReadOperation : public DocExprExecutor {
  public:
+  // Point reads of single rows are served from row_cache when it is specified, see
+  // QLRowCache.
   QLReadOperation(
       const QLReadRequestPB& request,
-      const TransactionOperationContextOpt& txn_op_context)
-      : request_(request), txn_op_context_(txn_op_context) {}
+      const TransactionOperationContextOpt& txn_op_context,
+      QLRowCache* row_cache = nullptr)
+      : request_(request), txn_op_context_(txn_op_context), row_cache_(row_cache) {}
 
   CHECKED_STATUS Execute(const common::QLStorageIf& ql_storage,
                          const ReadHybridTime& read_time,
                          const Schema& schema,
-                         const Schema& query_schema,
+                         const QLReadProjections& projections,
                          QLResultSet* result_set,
                          HybridTime* restart_read_ht);
 
@@ -246,8 +294,14 @@ class QLReadOperation : public DocExprExecutor {
   QLResponsePB& response() { return response_; }
 
  private:
+  // Returns the encoded DocKey of the row read by the request, if the row could be served from
+  // row_cache_.
+  Result<boost::optional<KeyBytes>> RowCacheKey(const Schema& schema,
+                                                const QLReadProjections& projections) const;
+
   const QLReadRequestPB& request_;
   const TransactionOperationContextOpt txn_op_context_;
+  QLRowCache* const row_cache_;
   QLResponsePB response_;
 };
 
@@ -31,6 +31,10 @@ using std::string;
 
 using yb::FormatRocksDBSliceAsStr;
 
+DEFINE_bool(docdb_full_scan_low_priority, true,
+            "Whether full table scans are low priority reads for the block cache, so they do not "
+            "evict blocks used by point lookups.");
+
 namespace yb {
 namespace docdb {
 
@@ -61,7 +65,8 @@ DocRowwiseIterator::~DocRowwiseIterator() {
 }
 
 Status DocRowwiseIterator::Init() {
-  auto query_id = rocksdb::kDefaultQueryId;
+  auto query_id = FLAGS_docdb_full_scan_low_priority ? rocksdb::kLowPriorityQueryId
+                                                     : rocksdb::kDefaultQueryId;
 
   db_iter_ = CreateIntentAwareIterator(
       db_, BloomFilterMode::DONT_USE_BLOOM_FILTER, boost::none /* user_key_for_filter */,
@@ -70,11 +75,25 @@ Status DocRowwiseIterator::Init() {
   row_key_ = DocKey();
   db_iter_->Seek(row_key_);
   row_ready_ = false;
+  prev_row_pending_ = false;
   has_bound_key_ = false;
 
   return Status::OK();
 }
 
+Status DocRowwiseIterator::Init(const DocKey& lower_bound, const DocKey& upper_bound) {
+  RETURN_NOT_OK(Init());
+  if (!lower_bound.empty()) {
+    row_key_ = lower_bound;
+    db_iter_->Seek(row_key_);
+  }
+  has_bound_key_ = !upper_bound.empty();
+  if (has_bound_key_) {
+    bound_key_ = upper_bound;
+  }
+  return Status::OK();
+}
+
 Status DocRowwiseIterator::Init(const common::QLScanSpec& spec) {
   const DocQLScanSpec& doc_spec = dynamic_cast<const DocQLScanSpec&>(spec);
   is_forward_scan_ = doc_spec.is_forward_scan();
@@ -88,20 +107,28 @@ Status DocRowwiseIterator::Init(const common::QLScanSpec& spec) {
   VLOG(4) << "DocKey Bounds " << lower_doc_key.ToString() << ", " << upper_doc_key.ToString();
 
   // TOOD(bogdan): decide if this is a good enough heuristic for using blooms for scans.
+  // When bloom filter also covers range components, lower and upper bounds should have the same
+  // filtered range components, so all keys of the scan are mapped to the same filter key.
   const bool is_fixed_point_get = !lower_doc_key.empty() &&
-      upper_doc_key.HashedComponentsEqual(lower_doc_key);
+      upper_doc_key.HashedAndRangePrefixEqual(lower_doc_key, BloomFilterRangeComponents(db_));
   const auto mode = is_fixed_point_get ? BloomFilterMode::USE_BLOOM_FILTER :
       BloomFilterMode::DONT_USE_BLOOM_FILTER;
 
   const KeyBytes row_key_encoded = lower_doc_key.Encode();
   const Slice row_key_encoded_as_slice = row_key_encoded.AsSlice();
 
+  // Scan without bounds reads the whole tablet.
+  const bool is_full_scan = lower_doc_key.empty() && upper_doc_key.empty();
+  const auto query_id = is_full_scan && FLAGS_docdb_full_scan_low_priority
+      ? rocksdb::kLowPriorityQueryId : doc_spec.QueryId();
+
   db_iter_ = CreateIntentAwareIterator(
-      db_, mode, row_key_encoded_as_slice, doc_spec.QueryId(), txn_op_context_, read_time_,
+      db_, mode, row_key_encoded_as_slice, query_id, txn_op_context_, read_time_,
       doc_spec.CreateFileFilter());
 
   db_iter_->SeekWithoutHt(row_key_encoded);
   row_ready_ = false;
+  prev_row_pending_ = false;
 
   if (is_forward_scan_) {
     has_bound_key_ = !upper_doc_key.empty();
@@ -131,7 +158,8 @@ Status DocRowwiseIterator::Init(const common::QLScanSpec& spec) {
 }
 
 Status DocRowwiseIterator::EnsureIteratorPositionCorrect() const {
-  if (!is_forward_scan_) {
+  if (prev_row_pending_) {
+    prev_row_pending_ = false;
     db_iter_->PrevDocKey(row_key_);
   }
   return Status::OK();
@@ -149,6 +177,11 @@ bool DocRowwiseIterator::HasNext() const {
 
   bool doc_found = false;
   while (!doc_found) {
+    status_ = EnsureIteratorPositionCorrect();
+    if (!status_.ok()) {
+      // Defer error reporting to NextRow().
+      return true;
+    }
     if (!db_iter_->valid()) {
       done_ = true;
       return false;
@@ -212,11 +245,7 @@ bool DocRowwiseIterator::HasNext() const {
         return true;
       }
     }
-    status_ = EnsureIteratorPositionCorrect();
-    if (!status_.ok()) {
-      // Defer error reporting to NextRow().
-      return true;
-    }
+    prev_row_pending_ = !is_forward_scan_;
   }
   row_ready_ = true;
   return true;
@@ -267,6 +296,12 @@ HybridTime DocRowwiseIterator::RestartReadHt() {
   return HybridTime::kInvalid;
 }
 
+void DocRowwiseIterator::AddReadStats(QLReadStatsPB* stats) const {
+  if (db_iter_) {
+    stats->set_intents_processed(stats->intents_processed() + db_iter_->num_intents_processed());
+  }
+}
+
 bool DocRowwiseIterator::IsNextStaticColumn() const {
   return schema_.has_statics() && row_key_.range_group().empty();
 }
@@ -299,15 +334,16 @@ Status DocRowwiseIterator::DoNextRow(const Schema& projection, QLTableRow* table
         "range", row_key_.range_group(), table_row));
   }
 
+  // The row is read only once, so the column values are moved out of row_ rather than copied.
   for (size_t i = projection.num_key_columns(); i < projection.num_columns(); i++) {
     const auto& column_id = projection.column_id(i);
-    const auto ql_type = projection.column(i).type();
-    const SubDocument* column_value = row_.GetChild(PrimitiveValue(column_id));
+    const auto& ql_type = projection.column(i).type();
+    SubDocument* column_value = row_.GetChild(PrimitiveValue(column_id));
     if (column_value != nullptr) {
       QLTableColumn& column = table_row->AllocColumn(column_id);
-      SubDocument::ToQLValuePB(*column_value, ql_type, &column.value);
       column.ttl_seconds = column_value->GetTtl();
       column.write_time = column_value->GetWriteTime();
+      SubDocument::ToQLValuePB(std::move(*column_value), ql_type, &column.value);
     }
   }
   row_ready_ = false;
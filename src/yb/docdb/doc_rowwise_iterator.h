@@ -74,6 +74,10 @@ class DocRowwiseIterator : public common::QLRowwiseIteratorIf {
   // Init QL read scan.
   CHECKED_STATUS Init(const common::QLScanSpec& spec) override;
 
+  // Init forward scan of rows with keys in [lower_bound, upper_bound). Empty bound does not limit
+  // the scan from its side. Used by bulk scans that read the whole tablet in several batches.
+  CHECKED_STATUS Init(const DocKey& lower_bound, const DocKey& upper_bound);
+
   // Is the next row to read a row with a static column?
   bool IsNextStaticColumn() const override;
 
@@ -89,6 +93,8 @@ class DocRowwiseIterator : public common::QLRowwiseIteratorIf {
 
   HybridTime RestartReadHt() override;
 
+  void AddReadStats(QLReadStatsPB* stats) const override;
+
  private:
 
   // Retrieves the next key to read after the iterator finishes for the given page.
@@ -125,6 +131,8 @@ class DocRowwiseIterator : public common::QLRowwiseIteratorIf {
   // For reverse scans, moves the iterator to the first kv-pair of the previous row after having
   // constructed the current row. For forward scans nothing is necessary because GetSubDocument
   // ensures that the iterator will be positioned on the first kv-pair of the next row.
+  // It is done lazily before the next row is constructed, so a scan that stops after a LIMIT of
+  // rows does not look for a row that it will not return.
   CHECKED_STATUS EnsureIteratorPositionCorrect() const;
 
   // Read next row into a value map using the specified projection.
@@ -174,6 +182,10 @@ class DocRowwiseIterator : public common::QLRowwiseIteratorIf {
   // It is initialized to false, to make sure first HasNext constructs a new row.
   mutable bool row_ready_;
 
+  // Set by reverse scans after constructing a row, when the iterator is not moved to the previous
+  // row yet, see EnsureIteratorPositionCorrect.
+  mutable bool prev_row_pending_ = false;
+
   mutable std::vector<PrimitiveValue> projection_subkeys_;
 
   // Used for keeping track of errors that happen in HasNext. Returned
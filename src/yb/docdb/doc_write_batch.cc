@@ -27,8 +27,10 @@ namespace docdb {
 
 DocWriteBatch::DocWriteBatch(rocksdb::DB* rocksdb,
                              InitMarkerBehavior init_marker_behavior,
-                             std::atomic<int64_t>* monotonic_counter)
-    : rocksdb_(rocksdb),
+                             std::atomic<int64_t>* monotonic_counter,
+                             RecentWritesCache* recent_writes)
+    : cache_(recent_writes),
+      rocksdb_(rocksdb),
       init_marker_behavior_(init_marker_behavior),
       monotonic_counter_(monotonic_counter),
       num_rocksdb_seeks_(0) {
@@ -70,7 +72,7 @@ CHECKED_STATUS DocWriteBatch::SetPrimitiveInternal(
     const int num_subkeys) {
 
   // The write_id is always incremented by one for each new element of the write batch.
-  if (put_batch_.size() > numeric_limits<IntraTxnWriteId>::max()) {
+  if (entry_ends_.size() > numeric_limits<IntraTxnWriteId>::max()) {
     return STATUS_SUBSTITUTE(
         NotSupported,
         "Trying to add more than $0 key/value pairs in the same single-shard txn.",
@@ -85,7 +87,7 @@ CHECKED_STATUS DocWriteBatch::SetPrimitiveInternal(
   // We need the write_id component of DocHybridTime to disambiguate between writes in the same
   // WriteBatch, as they will have the same HybridTime when committed. E.g. if we insert, delete,
   // and re-insert the same column in one WriteBatch, we need to know the order of these operations.
-  const auto write_id = static_cast<IntraTxnWriteId>(put_batch_.size());
+  const auto write_id = static_cast<IntraTxnWriteId>(entry_ends_.size());
   const DocHybridTime hybrid_time = DocHybridTime(HybridTime::kMax, write_id);
 
   for (int subkey_index = 0; subkey_index < num_subkeys; ++subkey_index) {
@@ -155,13 +157,12 @@ CHECKED_STATUS DocWriteBatch::SetPrimitiveInternal(
       DCHECK(!value.has_user_timestamp());
 
       // The document/subdocument that this subkey is supposed to live in does not exist, create it.
-      KeyBytes parent_key(doc_iter->key_prefix());
-
       // Add the parent key to key/value batch before appending the encoded HybridTime to it.
       // (We replicate key/value pairs without the HybridTime and only add it before writing to
       // RocksDB.)
-      put_batch_.emplace_back(std::move(*parent_key.mutable_data()),
-                              string(1, static_cast<char>(ValueType::kObject)));
+      StartEntry(doc_iter->key_prefix());
+      buffer_.push_back(static_cast<char>(ValueType::kObject));
+      FinishEntry();
 
       // Update our local cache to record the fact that we're adding this subdocument, so that
       // future operations in this DocWriteBatch don't have to add it or look for it in RocksDB.
@@ -177,7 +178,9 @@ CHECKED_STATUS DocWriteBatch::SetPrimitiveInternal(
 
   if (should_apply.get()) {
     // The key in the key/value batch does not have an encoded HybridTime.
-    put_batch_.emplace_back(doc_iter->key_prefix().AsStringRef(), value.Encode());
+    StartEntry(doc_iter->key_prefix());
+    value.EncodeAndAppend(&buffer_);
+    FinishEntry();
 
     // The key we use in the DocWriteBatchCache does not have a final hybrid_time, because that's
     // the key we expect to look up.
@@ -378,25 +381,29 @@ Status DocWriteBatch::ReplaceInList(
 }
 
 void DocWriteBatch::Clear() {
-  put_batch_.clear();
+  // Capacity of the buffer is kept, so a reused batch does not allocate memory for entries.
+  buffer_.clear();
+  entry_ends_.clear();
   cache_.Clear();
 }
 
 void DocWriteBatch::MoveToWriteBatchPB(KeyValueWriteBatchPB *kv_pb) {
-  kv_pb->mutable_kv_pairs()->Reserve(put_batch_.size());
-  for (auto& entry : put_batch_) {
-    KeyValuePairPB* kv_pair = kv_pb->add_kv_pairs();
-    kv_pair->mutable_key()->swap(entry.first);
-    kv_pair->mutable_value()->swap(entry.second);
-  }
+  AppendToWriteBatchPB(kv_pb);
+  buffer_.clear();
+  entry_ends_.clear();
 }
 
 void DocWriteBatch::TEST_CopyToWriteBatchPB(KeyValueWriteBatchPB *kv_pb) const {
-  kv_pb->mutable_kv_pairs()->Reserve(put_batch_.size());
-  for (auto& entry : put_batch_) {
+  AppendToWriteBatchPB(kv_pb);
+}
+
+void DocWriteBatch::AppendToWriteBatchPB(KeyValueWriteBatchPB *kv_pb) const {
+  kv_pb->mutable_kv_pairs()->Reserve(kv_pb->kv_pairs_size() + entry_ends_.size());
+  for (size_t i = 0; i != entry_ends_.size(); ++i) {
+    const auto key_value = key_value_pair(i);
     KeyValuePairPB* kv_pair = kv_pb->add_kv_pairs();
-    kv_pair->mutable_key()->assign(entry.first);
-    kv_pair->mutable_value()->assign(entry.second);
+    kv_pair->set_key(key_value.first.cdata(), key_value.first.size());
+    kv_pair->set_value(key_value.second.cdata(), key_value.second.size());
   }
 }
 
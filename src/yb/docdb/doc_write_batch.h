@@ -20,6 +20,7 @@
 #include "yb/docdb/value.h"
 #include "yb/rocksdb/cache.h"
 #include "yb/util/enums.h"
+#include "yb/util/slice.h"
 
 namespace rocksdb {
 class DB;
@@ -51,9 +52,12 @@ YB_DEFINE_ENUM(ListExtendOrder, (APPEND)(PREPEND))
 // Take ownership of it using std::move if it needs to live longer than this DocWriteBatch.
 class DocWriteBatch {
  public:
+  // recent_writes, when specified, is used to find states of documents written by previous
+  // operations without reading them from RocksDB.
   explicit DocWriteBatch(rocksdb::DB* rocksdb,
                          InitMarkerBehavior init_marker_behavior,
-                         std::atomic<int64_t>* monotonic_counter = nullptr);
+                         std::atomic<int64_t>* monotonic_counter = nullptr,
+                         RecentWritesCache* recent_writes = nullptr);
 
   // Set the primitive at the given path to the given value. Intermediate subdocuments are created
   // if necessary and possible.
@@ -111,18 +115,24 @@ class DocWriteBatch {
       UserTimeMicros user_timestamp = Value::kInvalidUserTimestamp);
 
   void Clear();
-  bool IsEmpty() const { return put_batch_.empty(); }
+  bool IsEmpty() const { return entry_ends_.empty(); }
 
-  size_t size() const { return put_batch_.size(); }
+  size_t size() const { return entry_ends_.size(); }
 
-  const std::vector<std::pair<std::string, std::string>>& key_value_pairs() const {
-    return put_batch_;
+  // Returns key and value of the entry with the specified index. Returned slices point into the
+  // batch buffer and remain valid until the next modification of the batch.
+  std::pair<Slice, Slice> key_value_pair(size_t index) const {
+    const size_t key_begin = index == 0 ? 0 : entry_ends_[index - 1].second;
+    const auto& ends = entry_ends_[index];
+    return std::make_pair(Slice(buffer_.data() + key_begin, ends.first - key_begin),
+                          Slice(buffer_.data() + ends.first, ends.second - ends.first));
   }
 
+  // Appends all entries to kv_pb and clears them from this batch. The batch buffer keeps its
+  // capacity, so it could be reused for further writes.
   void MoveToWriteBatchPB(KeyValueWriteBatchPB *kv_pb);
 
-  // This method has worse performance comparing to MoveToWriteBatchPB and intented to be used in
-  // testing. Consider using MoveToWriteBatchPB in production code.
+  // Same as MoveToWriteBatchPB, but keeps entries in this batch. Intended to be used in testing.
   void TEST_CopyToWriteBatchPB(KeyValueWriteBatchPB *kv_pb) const;
 
   // This is used in tests when measuring the number of seeks that a given update to this batch
@@ -159,13 +169,31 @@ class DocWriteBatch {
     return init_marker_behavior_ == InitMarkerBehavior::kOptional;
   }
 
+  // Starts a new entry with the specified key. Value should be appended to buffer_ by the caller
+  // and the entry finished with FinishEntry.
+  void StartEntry(const KeyBytes& key) {
+    buffer_.append(key.data());
+    entry_ends_.emplace_back(buffer_.size(), 0);
+  }
+
+  void FinishEntry() {
+    entry_ends_.back().second = buffer_.size();
+  }
+
+  void AppendToWriteBatchPB(KeyValueWriteBatchPB *kv_pb) const;
+
   DocWriteBatchCache cache_;
 
   rocksdb::DB* rocksdb_;
 
   const InitMarkerBehavior init_marker_behavior_;
   std::atomic<int64_t>* monotonic_counter_;
-  std::vector<std::pair<std::string, std::string>> put_batch_;
+  // Keys and values of all entries are encoded one after another into this buffer, so adding an
+  // entry does not allocate memory in most cases.
+  std::string buffer_;
+  // For each entry contains the end offsets of its key and value in buffer_. The key of an entry
+  // starts right after the value of the previous entry.
+  std::vector<std::pair<size_t, size_t>> entry_ends_;
 
   int num_rocksdb_seeks_;
 };
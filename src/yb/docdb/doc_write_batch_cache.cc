@@ -19,6 +19,7 @@
 
 #include "yb/docdb/doc_key.h"
 #include "yb/docdb/docdb-internal.h"
+#include "yb/docdb/docdb.pb.h"
 #include "yb/docdb/primitive_value.h"
 #include "yb/util/bytes_formatter.h"
 
@@ -54,6 +55,12 @@ void DocWriteBatchCache::Put(const KeyBytes& key_bytes,
 boost::optional<DocWriteBatchCache::Entry> DocWriteBatchCache::Get(
     const KeyBytes& encoded_key_prefix) {
   auto iter = prefix_to_gen_ht_.find(encoded_key_prefix.AsStringRef());
+  if (iter == prefix_to_gen_ht_.end() && recent_writes_) {
+    auto entry = recent_writes_->Get(encoded_key_prefix.AsSlice());
+    if (entry) {
+      iter = prefix_to_gen_ht_.emplace(encoded_key_prefix.AsStringRef(), *entry).first;
+    }
+  }
 #ifdef DOCDB_DEBUG
   if (iter == prefix_to_gen_ht_.end()) {
     DOCDB_DEBUG_LOG("DocWriteBatchCache contained no entry for $0",
@@ -97,5 +104,69 @@ void DocWriteBatchCache::Clear() {
   prefix_to_gen_ht_.clear();
 }
 
+void RecentWritesCache::Applied(const KeyValueWriteBatchPB& put_batch, HybridTime hybrid_time) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (int write_id = 0; write_id < put_batch.kv_pairs_size(); ++write_id) {
+    const auto& kv_pair = put_batch.kv_pairs(write_id);
+    InvalidateUnlocked(kv_pair.key());
+
+    ValueType value_type;
+    MonoDelta ttl;
+    UserTimeMicros user_timestamp;
+    if (!Value::DecodePrimitiveValueType(kv_pair.value(), &value_type).ok() ||
+        !Value::DecodeTTL(kv_pair.value(), &ttl).ok() || !ttl.Equals(Value::kMaxTtl) ||
+        !Value::DecodeUserTimestamp(kv_pair.value(), &user_timestamp).ok()) {
+      continue;
+    }
+
+    if (entries_.size() >= capacity_) {
+      if (lru_.empty()) {
+        continue;
+      }
+      entries_.erase(entries_.find(*lru_.back()));
+      lru_.pop_back();
+    }
+    auto it = entries_.emplace(kv_pair.key(), CachedEntry()).first;
+    it->second.entry = {DocHybridTime(hybrid_time, write_id), value_type, user_timestamp, true};
+    lru_.push_front(&it->first);
+    it->second.lru_position = lru_.begin();
+  }
+}
+
+void RecentWritesCache::Invalidate(const Slice& encoded_key_prefix) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  InvalidateUnlocked(encoded_key_prefix);
+}
+
+void RecentWritesCache::InvalidateUnlocked(const Slice& encoded_key_prefix) {
+  auto it = entries_.lower_bound(encoded_key_prefix.ToBuffer());
+  while (it != entries_.end() && Slice(it->first).starts_with(encoded_key_prefix)) {
+    lru_.erase(it->second.lru_position);
+    it = entries_.erase(it);
+  }
+}
+
+boost::optional<DocWriteBatchCache::Entry> RecentWritesCache::Get(
+    const Slice& encoded_key_prefix) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(encoded_key_prefix.ToBuffer());
+  if (it == entries_.end()) {
+    return boost::none;
+  }
+  lru_.splice(lru_.begin(), lru_, it->second.lru_position);
+  return it->second.entry;
+}
+
+void RecentWritesCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+  lru_.clear();
+}
+
+size_t RecentWritesCache::TEST_size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
 }  // namespace docdb
 }  // namespace yb
@@ -14,6 +14,9 @@
 #ifndef YB_DOCDB_DOC_WRITE_BATCH_CACHE_H_
 #define YB_DOCDB_DOC_WRITE_BATCH_CACHE_H_
 
+#include <list>
+#include <map>
+#include <mutex>
 #include <unordered_map>
 #include <string>
 
@@ -27,6 +30,9 @@
 namespace yb {
 namespace docdb {
 
+class KeyValueWriteBatchPB;
+class RecentWritesCache;
+
 // A utility used by DocWriteBatch. Caches generation hybrid_times (hybrid_times of full overwrite
 // or deletion) for key prefixes that were read from RocksDB or created by previous operations
 // performed on the DocWriteBatch.
@@ -34,6 +40,10 @@ namespace docdb {
 // This class is not thread-safe.
 class DocWriteBatchCache {
  public:
+  // Entries that are missing in this cache are looked up in recent_writes, when specified.
+  explicit DocWriteBatchCache(RecentWritesCache* recent_writes = nullptr)
+      : recent_writes_(recent_writes) {}
+
   struct Entry {
     DocHybridTime doc_hybrid_time;
     ValueType value_type;
@@ -68,8 +78,52 @@ class DocWriteBatchCache {
 
  private:
   std::unordered_map<std::string, Entry> prefix_to_gen_ht_;
+  RecentWritesCache* recent_writes_;
 };
 
+// Bounded cache of generation hybrid_times and value types of key prefixes written by recently
+// applied operations of one tablet. Shared by all DocWriteBatches of the tablet, so consecutive
+// operations updating the same hot documents don't have to read them from RocksDB each time.
+//
+// Entries are only added for writes applied to the regular RocksDB, and a write to a key prefix
+// invalidates entries of all its descendants, so a cached entry always matches what a seek in
+// RocksDB would find. Values with TTL are not cached, since they could expire.
+//
+// This class is thread-safe.
+class RecentWritesCache {
+ public:
+  explicit RecentWritesCache(size_t capacity) : capacity_(capacity) {}
+
+  // Records key/value pairs of a non-transactional put_batch applied at hybrid_time.
+  void Applied(const KeyValueWriteBatchPB& put_batch, HybridTime hybrid_time);
+
+  // Forgets the entries of encoded_key_prefix and all its descendants. Used for keys written
+  // without a put batch, e.g. when intents of a transaction are applied.
+  void Invalidate(const Slice& encoded_key_prefix);
+
+  boost::optional<DocWriteBatchCache::Entry> Get(const Slice& encoded_key_prefix);
+
+  void Clear();
+
+  size_t TEST_size() const;
+
+ private:
+  struct CachedEntry {
+    DocWriteBatchCache::Entry entry;
+    // Position of the key in lru_.
+    std::list<const std::string*>::iterator lru_position;
+  };
+
+  void InvalidateUnlocked(const Slice& encoded_key_prefix);
+
+  const size_t capacity_;
+  mutable std::mutex mutex_;
+  std::map<std::string, CachedEntry> entries_;
+  // Keys of entries_, the most recently used first.
+  std::list<const std::string*> lru_;
+};
+
+
 
 }  // namespace docdb
 }  // namespace yb
@@ -0,0 +1,298 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+// Microbenchmarks of the DocDB engine primitives, run directly against a RocksDB instance without
+// a tablet server: DocWriteBatch encoding, DocRowwiseIterator scans, IntentAwareIterator point
+// reads and compactions through the DocDB compaction filter. Each benchmark reports ns/op and,
+// when built with tcmalloc, heap allocations/op.
+//
+// Schema shape, history depth and intent density are gflags, e.g.:
+//   docdb-bench --docdb_bench_num_columns=20 --docdb_bench_history_depth=10 \
+//       --docdb_bench_intent_density=0.2
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#ifdef TCMALLOC_ENABLED
+#include <gperftools/malloc_hook.h>
+#endif
+
+#include "yb/common/transaction.h"
+
+#include "yb/docdb/doc_key.h"
+#include "yb/docdb/doc_rowwise_iterator.h"
+#include "yb/docdb/docdb.h"
+#include "yb/docdb/docdb_test_base.h"
+#include "yb/docdb/docdb_test_util.h"
+#include "yb/docdb/intent_aware_iterator.h"
+#include "yb/docdb/value.h"
+
+#include "yb/util/stopwatch.h"
+#include "yb/util/test_macros.h"
+
+DEFINE_int32(docdb_bench_num_rows, 10000, "Number of rows loaded by the DocDB benchmarks.");
+DEFINE_int32(docdb_bench_num_columns, 5, "Number of non-key columns in the benchmark schema.");
+DEFINE_int32(docdb_bench_value_size, 16, "Size in bytes of every column value.");
+DEFINE_int32(docdb_bench_history_depth, 1,
+             "Number of versions written for every column before reading and compacting.");
+DEFINE_double(docdb_bench_intent_density, 0.1,
+              "Fraction of rows that have a provisional write from a pending transaction.");
+DEFINE_int32(docdb_bench_iterations, 5, "Number of passes made by the read benchmarks.");
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+constexpr uint64_t kHistoryStepMicros = 1000;
+
+// Counts heap allocations made by this process while it is running. Only available in tcmalloc
+// builds, other builds report allocations as unknown.
+class AllocationCounter {
+ public:
+  static bool Enabled() {
+#ifdef TCMALLOC_ENABLED
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  static void Install() {
+#ifdef TCMALLOC_ENABLED
+    static bool installed = MallocHook::AddNewHook(&NewHook);
+    CHECK(installed);
+#endif
+  }
+
+  static int64_t Get() {
+    return allocations_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  static void NewHook(const void* ptr, size_t size) {
+    allocations_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  static std::atomic<int64_t> allocations_;
+};
+
+std::atomic<int64_t> AllocationCounter::allocations_{0};
+
+// Measures a run of operations, used as:
+//   BenchmarkRun run("name");
+//   ... do num_ops operations ...
+//   run.Finish(num_ops);
+class BenchmarkRun {
+ public:
+  explicit BenchmarkRun(std::string name)
+      : name_(std::move(name)), start_allocations_(AllocationCounter::Get()) {
+    sw_.start();
+  }
+
+  void Finish(int64_t num_ops) {
+    sw_.stop();
+    const int64_t allocations = AllocationCounter::Get() - start_allocations_;
+    num_ops = std::max<int64_t>(num_ops, 1);
+    LOG(INFO) << name_ << ": " << num_ops << " ops, "
+              << sw_.elapsed().wall * 1.0 / num_ops << " ns/op, "
+              << (AllocationCounter::Enabled()
+                      ? std::to_string(allocations * 1.0 / num_ops) : std::string("unknown"))
+              << " allocations/op";
+  }
+
+ private:
+  const std::string name_;
+  const int64_t start_allocations_;
+  Stopwatch sw_;
+};
+
+// Reports every transaction as pending, so provisional records are read but never applied.
+class PendingTransactionStatusManager : public TransactionStatusManager {
+ public:
+  HybridTime LocalCommitTime(const TransactionId& id) override {
+    return HybridTime::kInvalid;
+  }
+
+  void RequestStatusAt(const StatusRequest& request) override {
+    request.callback(TransactionStatusResult{TransactionStatus::PENDING, HybridTime::kMin});
+  }
+
+  boost::optional<TransactionMetadata> Metadata(const TransactionId& id) override {
+    return boost::none;
+  }
+
+  void Abort(const TransactionId& id, TransactionStatusCallback callback) override {
+  }
+
+  int64_t RegisterRequest() override {
+    return 0;
+  }
+};
+
+} // namespace
+
+class DocDBBench : public DocDBTestBase {
+ protected:
+  void SetUp() override {
+    DocDBTestBase::SetUp();
+    AllocationCounter::Install();
+    schema_ = MakeSchema();
+  }
+
+  static Schema MakeSchema() {
+    std::vector<ColumnSchema> columns;
+    std::vector<ColumnId> column_ids;
+    columns.emplace_back("k", DataType::INT64, /* is_nullable = */ false);
+    column_ids.emplace_back(kFirstColumnId);
+    for (int i = 0; i != FLAGS_docdb_bench_num_columns; ++i) {
+      columns.emplace_back(Format("c$0", i), DataType::STRING, true);
+      column_ids.emplace_back(kFirstColumnId + 1 + i);
+    }
+    return Schema(columns, column_ids, 1 /* key_columns */);
+  }
+
+  static KeyBytes RowKey(int64_t row) {
+    return DocKey(PrimitiveValues(row)).Encode();
+  }
+
+  static std::string ColumnValue(int64_t row, int version, int column) {
+    std::string result = Format("$0-$1-$2-", row, version, column);
+    result.resize(FLAGS_docdb_bench_value_size, 'x');
+    return result;
+  }
+
+  CHECKED_STATUS AddRow(DocWriteBatch* dwb, int64_t row, int version) {
+    const KeyBytes key = RowKey(row);
+    for (int i = 0; i != FLAGS_docdb_bench_num_columns; ++i) {
+      RETURN_NOT_OK(dwb->SetPrimitive(
+          DocPath(key, PrimitiveValue(schema_.column_id(1 + i))),
+          PrimitiveValue(ColumnValue(row, version, i))));
+    }
+    return Status::OK();
+  }
+
+  HybridTime VersionTime(int version) const {
+    return HybridTime::FromMicros(kHistoryStepMicros * (version + 1));
+  }
+
+  // Read time that sees the latest committed version of every row.
+  ReadHybridTime LatestReadTime() const {
+    return ReadHybridTime::SingleTime(VersionTime(FLAGS_docdb_bench_history_depth));
+  }
+
+  // Writes all rows with the configured history depth, plus provisional records for the
+  // configured fraction of rows, and flushes them to an SST file.
+  void LoadData();
+
+  Schema schema_;
+  PendingTransactionStatusManager txn_status_manager_;
+};
+
+void DocDBBench::LoadData() {
+  for (int version = 0; version != FLAGS_docdb_bench_history_depth; ++version) {
+    for (int64_t row = 0; row != FLAGS_docdb_bench_num_rows; ++row) {
+      auto dwb = MakeDocWriteBatch();
+      ASSERT_OK(AddRow(&dwb, row, version));
+      ASSERT_OK(WriteToRocksDBAndClear(&dwb, VersionTime(version)));
+    }
+  }
+
+  const auto intent_time = VersionTime(FLAGS_docdb_bench_history_depth - 1).AddMicroseconds(1);
+  const int64_t intent_step = FLAGS_docdb_bench_intent_density > 0
+      ? std::max<int64_t>(1, static_cast<int64_t>(1 / FLAGS_docdb_bench_intent_density))
+      : 0;
+  SetTransactionIsolationLevel(IsolationLevel::SNAPSHOT_ISOLATION);
+  for (int64_t row = 0; intent_step && row < FLAGS_docdb_bench_num_rows; row += intent_step) {
+    SetCurrentTransactionId(GenerateTransactionId());
+    auto dwb = MakeDocWriteBatch();
+    ASSERT_OK(AddRow(&dwb, row, FLAGS_docdb_bench_history_depth));
+    ASSERT_OK(WriteToRocksDBAndClear(&dwb, intent_time));
+  }
+  ResetCurrentTransactionId();
+
+  ASSERT_OK(FlushRocksDB());
+}
+
+TEST_F(DocDBBench, DocWriteBatch) {
+  const int64_t num_rows = FLAGS_docdb_bench_num_rows * FLAGS_docdb_bench_iterations;
+  const HybridTime hybrid_time = VersionTime(0);
+  auto dwb = MakeDocWriteBatch();
+  rocksdb::WriteBatch rocksdb_write_batch;
+  BenchmarkRun run("DocWriteBatch encode row");
+  for (int64_t row = 0; row != num_rows; ++row) {
+    ASSERT_OK(AddRow(&dwb, row, 0));
+    ASSERT_OK(PopulateRocksDBWriteBatch(
+        dwb, &rocksdb_write_batch, hybrid_time, false /* decode_dockey */));
+    dwb.Clear();
+    rocksdb_write_batch.Clear();
+  }
+  run.Finish(num_rows);
+}
+
+TEST_F(DocDBBench, DocRowwiseIterator) {
+  ASSERT_NO_FATALS(LoadData());
+
+  const TransactionOperationContext txn_context(GenerateTransactionId(), &txn_status_manager_);
+  for (bool transactional : {false, true}) {
+    int64_t num_rows = 0;
+    QLTableRow row;
+    BenchmarkRun run(transactional ? "DocRowwiseIterator row, transactional"
+                                   : "DocRowwiseIterator row, non-transactional");
+    for (int i = 0; i != FLAGS_docdb_bench_iterations; ++i) {
+      DocRowwiseIterator iter(
+          schema_, schema_,
+          transactional ? TransactionOperationContextOpt(txn_context)
+                        : kNonTransactionalOperationContext,
+          rocksdb(), LatestReadTime());
+      ASSERT_OK(iter.Init());
+      while (iter.HasNext()) {
+        ASSERT_OK(iter.NextRow(&row));
+        ++num_rows;
+      }
+    }
+    run.Finish(num_rows);
+    ASSERT_EQ(FLAGS_docdb_bench_num_rows * FLAGS_docdb_bench_iterations, num_rows);
+  }
+}
+
+TEST_F(DocDBBench, IntentAwareIterator) {
+  ASSERT_NO_FATALS(LoadData());
+
+  const TransactionOperationContext txn_context(GenerateTransactionId(), &txn_status_manager_);
+  rocksdb::ReadOptions read_options;
+  IntentAwareIterator iter(rocksdb(), read_options, LatestReadTime(), txn_context);
+  const int64_t num_reads = FLAGS_docdb_bench_num_rows * FLAGS_docdb_bench_iterations;
+  BenchmarkRun run("IntentAwareIterator point read");
+  for (int64_t i = 0; i != num_reads; ++i) {
+    iter.Seek(DocKey(PrimitiveValues(i % FLAGS_docdb_bench_num_rows)));
+    ASSERT_TRUE(iter.valid());
+    ASSERT_OK(iter.FetchKey());
+  }
+  run.Finish(num_reads);
+}
+
+TEST_F(DocDBBench, Compaction) {
+  ASSERT_NO_FATALS(LoadData());
+
+  const int64_t num_entries = static_cast<int64_t>(FLAGS_docdb_bench_num_rows) *
+                              FLAGS_docdb_bench_num_columns * FLAGS_docdb_bench_history_depth;
+  // Everything but the latest version of every column is garbage collected.
+  BenchmarkRun run("DocDBCompactionFilter entry");
+  ASSERT_NO_FATALS(CompactHistoryBefore(LatestReadTime().read));
+  run.Finish(num_entries);
+}
+
+}  // namespace docdb
+}  // namespace yb
@@ -23,6 +23,7 @@
 #include "yb/common/hybrid_time.h"
 #include "yb/docdb/docdb-internal.h"
 #include "yb/docdb/docdb_compaction_filter.h"
+#include "yb/docdb/docdb_rocksdb_util.h"
 #include "yb/docdb/docdb_test_base.h"
 #include "yb/docdb/docdb_test_util.h"
 #include "yb/docdb/in_mem_docdb.h"
@@ -410,6 +411,93 @@ SubDocKey(DocKey([], ["mydockey", 123456]), ["subkey1"; HT{ physical: 3000 }]) -
       )#");
 }
 
+TEST_F(DocDBTest, HistoryCompactionSubkeysWithSharedBytes) {
+  // Subkey "ab" shares encoded bytes with subkey "a", but they are different subdocuments, so
+  // overwrite of "a" should not remove older entries of "ab".
+  const DocKey doc_key(PrimitiveValues("k"));
+  KeyBytes encoded_doc_key(doc_key.Encode());
+  ASSERT_OK(SetPrimitive(
+      DocPath(encoded_doc_key), PrimitiveValue::kTombstone, HybridTime::FromMicros(2000)));
+  ASSERT_OK(SetPrimitive(
+      DocPath(encoded_doc_key, PrimitiveValue("a")), PrimitiveValue("v1"),
+      HybridTime::FromMicros(1000)));
+  ASSERT_OK(SetPrimitive(
+      DocPath(encoded_doc_key, PrimitiveValue("a")), PrimitiveValue("v3"),
+      HybridTime::FromMicros(3000)));
+  ASSERT_OK(SetPrimitive(
+      DocPath(encoded_doc_key, PrimitiveValue("ab")), PrimitiveValue("v2"),
+      HybridTime::FromMicros(1500)));
+  ASSERT_OK(SetPrimitive(
+      DocPath(encoded_doc_key, PrimitiveValue("ab")), PrimitiveValue("v4"),
+      HybridTime::FromMicros(2500)));
+  ASSERT_OK(SetPrimitive(
+      DocPath(encoded_doc_key, PrimitiveValue("ab"), PrimitiveValue("x")), PrimitiveValue("v5"),
+      HybridTime::FromMicros(2200)));
+  ASSERT_OK(SetPrimitive(
+      DocPath(encoded_doc_key, PrimitiveValue("b")), PrimitiveValue("v6"),
+      HybridTime::FromMicros(1000)));
+  AssertDocDbDebugDumpStrEq(R"#(
+      SubDocKey(DocKey([], ["k"]), [HT{ physical: 2000 }]) -> DEL
+      SubDocKey(DocKey([], ["k"]), ["a"; HT{ physical: 3000 }]) -> "v3"
+      SubDocKey(DocKey([], ["k"]), ["a"; HT{ physical: 1000 }]) -> "v1"
+      SubDocKey(DocKey([], ["k"]), ["ab"; HT{ physical: 2500 }]) -> "v4"
+      SubDocKey(DocKey([], ["k"]), ["ab"; HT{ physical: 1500 }]) -> "v2"
+      SubDocKey(DocKey([], ["k"]), ["ab", "x"; HT{ physical: 2200 }]) -> "v5"
+      SubDocKey(DocKey([], ["k"]), ["b"; HT{ physical: 1000 }]) -> "v6"
+      )#");
+  CompactHistoryBefore(HybridTime::FromMicros(3500));
+  AssertDocDbDebugDumpStrEq(
+      R"#(
+SubDocKey(DocKey([], ["k"]), ["a"; HT{ physical: 3000 }]) -> "v3"
+SubDocKey(DocKey([], ["k"]), ["ab"; HT{ physical: 2500 }]) -> "v4"
+      )#");
+}
+
+TEST_F(DocDBTest, HashIndexedMemTable) {
+  ASSERT_OK(DestroyRocksDB());
+  UseHashIndexedMemTable(&rocksdb_options_);
+  ASSERT_OK(OpenRocksDB());
+
+  // Keys "a" and "b" have the same hash code, but memtable is indexed by the whole hashed part of
+  // DocKey, so they are different prefixes.
+  const DocKey doc_key_a = DocKey::FromRedisKey(1, "a");
+  const DocKey doc_key_b = DocKey::FromRedisKey(1, "b");
+  const DocKey doc_key_c = DocKey::FromRedisKey(2, "c");
+  ASSERT_OK(SetPrimitive(
+      DocPath(doc_key_a.Encode(), PrimitiveValue("x")), PrimitiveValue("v1"),
+      HybridTime::FromMicros(1000)));
+  ASSERT_OK(SetPrimitive(
+      DocPath(doc_key_b.Encode()), PrimitiveValue("v2"), HybridTime::FromMicros(1000)));
+  ASSERT_OK(SetPrimitive(
+      DocPath(doc_key_c.Encode()), PrimitiveValue("v3"), HybridTime::FromMicros(1000)));
+  ASSERT_OK(SetPrimitive(
+      DocPath(doc_key_a.Encode(), PrimitiveValue("y")), PrimitiveValue("v4"),
+      HybridTime::FromMicros(2000)));
+
+  for (bool flushed : {false, true}) {
+    SCOPED_TRACE(Format("Flushed: $0", flushed));
+    VerifySubDocument(SubDocKey(doc_key_a), HybridTime::FromMicros(1500),
+        R"#(
+{
+  "x": "v1"
+}
+        )#");
+    VerifySubDocument(SubDocKey(doc_key_a), HybridTime::FromMicros(2500),
+        R"#(
+{
+  "x": "v1",
+  "y": "v4"
+}
+        )#");
+    VerifySubDocument(SubDocKey(doc_key_b), HybridTime::FromMicros(2500), "\"v2\"");
+    VerifySubDocument(SubDocKey(doc_key_c), HybridTime::FromMicros(2500), "\"v3\"");
+    VerifySubDocument(SubDocKey(DocKey::FromRedisKey(1, "ab")), HybridTime::FromMicros(2500), "");
+    if (!flushed) {
+      ASSERT_OK(FlushRocksDB());
+    }
+  }
+}
+
 TEST_F(DocDBTest, SetPrimitiveQL) {
   const DocKey doc_key(PrimitiveValues("mydockey", 123456));
   SetupRocksDBState(doc_key.Encode());
@@ -1309,6 +1397,97 @@ TEST_F(DocDBTest, MultiOperationDocWriteBatch) {
       )#", dwb_str);
 }
 
+TEST_F(DocDBTest, MoveDocWriteBatchToPB) {
+  const auto encoded_doc_key = DocKey(PrimitiveValues("a")).Encode();
+  auto dwb = MakeDocWriteBatch(InitMarkerBehavior::kRequired);
+  ASSERT_OK(dwb.SetPrimitive(DocPath(encoded_doc_key, "b"), PrimitiveValue("v1")));
+  ASSERT_OK(dwb.SetPrimitive(DocPath(encoded_doc_key, "c"), PrimitiveValue(string(100, 'x'))));
+  // Init markers for the document.
+  ASSERT_EQ(3, dwb.size());
+
+  KeyValueWriteBatchPB copied;
+  dwb.TEST_CopyToWriteBatchPB(&copied);
+  ASSERT_EQ(3, dwb.size());
+
+  KeyValueWriteBatchPB moved;
+  dwb.MoveToWriteBatchPB(&moved);
+  ASSERT_TRUE(dwb.IsEmpty());
+  ASSERT_EQ(copied.DebugString(), moved.DebugString());
+  ASSERT_EQ(3, moved.kv_pairs_size());
+  ASSERT_EQ(encoded_doc_key.data(), moved.kv_pairs(0).key());
+  ASSERT_EQ(string(1, static_cast<char>(ValueType::kObject)), moved.kv_pairs(0).value());
+  ASSERT_EQ(Value(PrimitiveValue(string(100, 'x'))).Encode(), moved.kv_pairs(2).value());
+
+  // Batch could be reused after it was moved.
+  ASSERT_OK(dwb.SetPrimitive(DocPath(encoded_doc_key, "d"), PrimitiveValue("v2")));
+  ASSERT_EQ(1, dwb.size());
+  auto key_value = dwb.key_value_pair(0);
+  ASSERT_EQ(SubDocKey(DocKey(PrimitiveValues("a")), PrimitiveValue("d")).Encode(
+                /* include_hybrid_time */ false).data(),
+            key_value.first.ToBuffer());
+  ASSERT_EQ(Value(PrimitiveValue("v2")).Encode(), key_value.second.ToBuffer());
+}
+
+TEST_F(DocDBTest, RecentWritesCache) {
+  constexpr size_t kCapacity = 10;
+  const auto encoded_doc_key = DocKey(PrimitiveValues("a")).Encode();
+  RecentWritesCache recent_writes(kCapacity);
+  {
+    auto dwb = MakeDocWriteBatch(InitMarkerBehavior::kRequired);
+    ASSERT_OK(dwb.SetPrimitive(DocPath(encoded_doc_key, "b"), PrimitiveValue("v1")));
+    KeyValueWriteBatchPB put_batch;
+    dwb.TEST_CopyToWriteBatchPB(&put_batch);
+    ASSERT_OK(WriteToRocksDBAndClear(&dwb, HybridTime::FromMicros(1000)));
+    recent_writes.Applied(put_batch, HybridTime::FromMicros(1000));
+  }
+  // Init marker of the document and the written value.
+  ASSERT_EQ(2U, recent_writes.TEST_size());
+
+  // The document is known to exist, so the next operation does not read it from RocksDB.
+  DocWriteBatch cached_dwb(
+      rocksdb(), InitMarkerBehavior::kRequired, /* monotonic_counter */ nullptr, &recent_writes);
+  ASSERT_OK(cached_dwb.SetPrimitive(DocPath(encoded_doc_key, "c"), PrimitiveValue("v2")));
+  ASSERT_EQ(0, cached_dwb.GetAndResetNumRocksDBSeeks());
+  ASSERT_EQ(1, cached_dwb.size());
+
+  auto uncached_dwb = MakeDocWriteBatch(InitMarkerBehavior::kRequired);
+  ASSERT_OK(uncached_dwb.SetPrimitive(DocPath(encoded_doc_key, "c"), PrimitiveValue("v2")));
+  ASSERT_EQ(1, uncached_dwb.GetAndResetNumRocksDBSeeks());
+  ASSERT_EQ(1, uncached_dwb.size());
+
+  // Deleting the document invalidates its subdocuments.
+  KeyValueWriteBatchPB delete_batch;
+  auto* kv_pair = delete_batch.add_kv_pairs();
+  kv_pair->set_key(encoded_doc_key.data());
+  kv_pair->set_value(Value(PrimitiveValue::kTombstone).Encode());
+  recent_writes.Applied(delete_batch, HybridTime::FromMicros(2000));
+  ASSERT_EQ(1U, recent_writes.TEST_size());
+  auto entry = recent_writes.Get(encoded_doc_key.AsSlice());
+  ASSERT_TRUE(entry.is_initialized());
+  ASSERT_EQ(ValueType::kTombstone, entry->value_type);
+  ASSERT_EQ(DocHybridTime(HybridTime::FromMicros(2000), 0), entry->doc_hybrid_time);
+
+  // Values with TTL could expire, so they are not cached.
+  KeyValueWriteBatchPB ttl_batch;
+  kv_pair = ttl_batch.add_kv_pairs();
+  kv_pair->set_key(encoded_doc_key.data());
+  kv_pair->set_value(Value(PrimitiveValue("v3"), MonoDelta::FromSeconds(10)).Encode());
+  recent_writes.Applied(ttl_batch, HybridTime::FromMicros(3000));
+  ASSERT_EQ(0U, recent_writes.TEST_size());
+
+  // The least recently used entries are evicted.
+  KeyValueWriteBatchPB large_batch;
+  for (size_t i = 0; i != kCapacity + 2; ++i) {
+    kv_pair = large_batch.add_kv_pairs();
+    kv_pair->set_key(DocKey(PrimitiveValues(Format("key$0", i))).Encode().data());
+    kv_pair->set_value(Value(PrimitiveValue("v4")).Encode());
+  }
+  recent_writes.Applied(large_batch, HybridTime::FromMicros(4000));
+  ASSERT_EQ(kCapacity, recent_writes.TEST_size());
+  ASSERT_FALSE(recent_writes.Get(large_batch.kv_pairs(0).key()).is_initialized());
+  ASSERT_TRUE(recent_writes.Get(large_batch.kv_pairs(kCapacity + 1).key()).is_initialized());
+}
+
 class DocDBTestBoundaryValues: public DocDBTest {
  protected:
   void TestBoundaryValues(size_t flush_rate) {
@@ -1524,6 +1703,34 @@ TEST_F(DocDBTest, MergingIterator) {
   VerifySubDocument(SubDocKey(key2), ht, "\"value2\"");
 }
 
+TEST_F(DocDBTest, HybridTimeFileFilter) {
+  DocKey key(0, PrimitiveValues("key"), PrimitiveValues());
+  auto dwb = MakeDocWriteBatch();
+  ASSERT_OK(dwb.SetPrimitive(DocPath(key.Encode()), PrimitiveValue("value1")));
+  ASSERT_OK(WriteToRocksDB(dwb, HybridTime::FromMicros(1000)));
+  ASSERT_OK(FlushRocksDB());
+
+  dwb.Clear();
+  ASSERT_OK(dwb.SetPrimitive(DocPath(key.Encode()), PrimitiveValue("value2")));
+  ASSERT_OK(WriteToRocksDB(dwb, HybridTime::FromMicros(3000)));
+  ASSERT_OK(FlushRocksDB());
+
+  auto table_iterators = [this] {
+    return options().statistics->getTickerCount(rocksdb::NO_TABLE_CACHE_ITERATORS);
+  };
+
+  // Only the first file has records visible at this time.
+  auto iterators_before = table_iterators();
+  VerifySubDocument(SubDocKey(key), HybridTime::FromMicros(2000), "\"value1\"");
+  ASSERT_EQ(1, table_iterators() - iterators_before);
+
+  iterators_before = table_iterators();
+  VerifySubDocument(SubDocKey(key), HybridTime::FromMicros(4000), "\"value2\"");
+  ASSERT_EQ(2, table_iterators() - iterators_before);
+
+  VerifySubDocument(SubDocKey(key), HybridTime::FromMicros(500), "");
+}
+
 TEST_F(DocDBTest, SetPrimitiveWithInitMarker) {
   // Both required and optional init marker should be ok.
   for (auto init_marker_behavior : kInitMarkerBehaviorList) {
@@ -1896,6 +2103,54 @@ void QueryBoundsAndVerify(const DocKey& doc_key, int lower, int upper, int base,
   VerifyBounds(&doc_from_rocksdb, lower, upper, base);
 }
 
+TEST_F(DocDBTest, CounterDeltas) {
+  const DocKey doc_key(PrimitiveValues("k1"));
+  KeyBytes encoded_doc_key(doc_key.Encode());
+  const DocPath counter_path(encoded_doc_key, PrimitiveValue("c"));
+  ASSERT_OK(SetPrimitive(counter_path, Value(PrimitiveValue(int64_t{10})),
+                         HybridTime::FromMicros(1000)));
+  ASSERT_OK(SetPrimitive(counter_path, Value::CounterDelta(5), HybridTime::FromMicros(2000)));
+  ASSERT_OK(SetPrimitive(counter_path, Value::CounterDelta(-3), HybridTime::FromMicros(3000)));
+  ASSERT_OK(SetPrimitive(counter_path, Value::CounterDelta(1), HybridTime::FromMicros(4000)));
+
+  // Deltas are added to the versions written before them.
+  VerifySubDocument(SubDocKey(doc_key), HybridTime::FromMicros(2500), R"#(
+{
+  "c": 15
+}
+      )#");
+  VerifySubDocument(SubDocKey(doc_key), HybridTime::FromMicros(4500), R"#(
+{
+  "c": 13
+}
+      )#");
+
+  // The latest delta below the history cutoff is folded with older versions into the full value.
+  CompactHistoryBefore(HybridTime::FromMicros(3500));
+  AssertDocDbDebugDumpStrEq(R"#(
+      SubDocKey(DocKey([], ["k1"]), ["c"; HT{ physical: 4000 }]) -> 1; counter_delta
+      SubDocKey(DocKey([], ["k1"]), ["c"; HT{ physical: 3000 }]) -> 12
+      )#");
+  VerifySubDocument(SubDocKey(doc_key), HybridTime::FromMicros(4500), R"#(
+{
+  "c": 13
+}
+      )#");
+
+  // Deltas are not added to versions that were deleted.
+  ASSERT_OK(DeleteSubDoc(counter_path, HybridTime::FromMicros(5000)));
+  ASSERT_OK(SetPrimitive(counter_path, Value::CounterDelta(2), HybridTime::FromMicros(6000)));
+  VerifySubDocument(SubDocKey(doc_key), HybridTime::FromMicros(6500), R"#(
+{
+  "c": 2
+}
+      )#");
+  CompactHistoryBefore(HybridTime::FromMicros(7000));
+  AssertDocDbDebugDumpStrEq(R"#(
+      SubDocKey(DocKey([], ["k1"]), ["c"; HT{ physical: 6000 }]) -> 2
+      )#");
+}
+
 TEST_F(DocDBTest, TestBuildSubDocumentBounds) {
   const DocKey doc_key(PrimitiveValues("key"));
   KeyBytes encoded_doc_key(doc_key.Encode());
@@ -1955,6 +2210,52 @@ TEST_F(DocDBTest, TestBuildSubDocumentBounds) {
   EXPECT_FALSE(subdoc_found);
 }
 
+// Checks that a score range of a score-ordered (score, member) index, as used by sorted sets, is
+// read with a bounded seek instead of iterating over the whole collection.
+TEST_F(DocDBTest, TestBuildSubDocumentScoreBounds) {
+  const DocKey doc_key(PrimitiveValues("key"));
+  KeyBytes encoded_doc_key(doc_key.Encode());
+  const int nscores = 1000;
+  for (int i = 0; i < nscores; i++) {
+    ASSERT_OK(SetPrimitive(
+        DocPath(encoded_doc_key, PrimitiveValue::Double(i),
+                PrimitiveValue("member" + std::to_string(i))),
+        Value(PrimitiveValue(ValueType::kNull)), HybridTime::FromMicros(1000)));
+  }
+
+  const SubDocKey subdoc_to_search(doc_key);
+  SubDocKeyBound lower_bound(SubDocKey(doc_key, PrimitiveValue::Double(500)),
+                             /* is_exclusive */ true, /* is_lower_bound */ true);
+  SubDocKeyBound upper_bound(SubDocKey(doc_key, PrimitiveValue::Double(510)),
+                             /* is_exclusive */ false, /* is_lower_bound */ false);
+  SubDocument doc_from_rocksdb;
+  bool subdoc_found = false;
+  GetSubDocumentData data = { &subdoc_to_search, &doc_from_rocksdb, &subdoc_found };
+  data.low_subkey = &lower_bound;
+  data.high_subkey = &upper_bound;
+
+  const auto& statistics = *options().statistics;
+  const auto iterator_steps_before =
+      statistics.getTickerCount(rocksdb::NUMBER_DB_NEXT) +
+      statistics.getTickerCount(rocksdb::NUMBER_DB_SEEK);
+  ASSERT_OK(GetSubDocument(
+      rocksdb(), data, rocksdb::kDefaultQueryId, kNonTransactionalOperationContext,
+      ReadHybridTime::SingleTime(HybridTime::FromMicros(2000))));
+  const auto iterator_steps =
+      statistics.getTickerCount(rocksdb::NUMBER_DB_NEXT) +
+      statistics.getTickerCount(rocksdb::NUMBER_DB_SEEK) - iterator_steps_before;
+
+  ASSERT_TRUE(subdoc_found);
+  ASSERT_EQ(10, doc_from_rocksdb.object_num_keys());
+  for (int i = 501; i <= 510; i++) {
+    SubDocument* score = doc_from_rocksdb.GetChild(PrimitiveValue::Double(i));
+    ASSERT_TRUE(score != nullptr) << "Score not found: " << i;
+    ASSERT_TRUE(score->GetChild(PrimitiveValue("member" + std::to_string(i))) != nullptr);
+  }
+  // Only the keys around the requested range should be visited.
+  ASSERT_LT(iterator_steps, nscores / 10);
+}
+
 TEST_F(DocDBTest, TestCompactionForCollectionsWithTTL) {
   SubDocument subdoc;
   DocKey collection_key(PrimitiveValues("collection"));
@@ -2037,5 +2338,36 @@ TEST_F(DocDBTest, TestCompactionForCollectionsWithTTL) {
   }
 }
 
+TEST_F(DocDBTest, ReadAfterDocumentDelete) {
+  const DocKey doc_key(PrimitiveValues("mydockey"));
+  const KeyBytes encoded_doc_key(doc_key.Encode());
+  const int kNumSubKeys = 100;
+  for (int i = 0; i != kNumSubKeys; ++i) {
+    ASSERT_OK(SetPrimitive(
+        DocPath(encoded_doc_key, PrimitiveValue(Format("k$0", 100 + i))),
+        PrimitiveValue(Format("v$0", i)), HybridTime::FromMicros(1000)));
+  }
+  ASSERT_OK(DeleteSubDoc(DocPath(encoded_doc_key), HybridTime::FromMicros(2000)));
+  // A subkey written after the delete is the only one visible, while all the older versions are
+  // skipped by their hybrid time.
+  ASSERT_OK(SetPrimitive(
+      DocPath(encoded_doc_key, PrimitiveValue("k150")), PrimitiveValue("new"),
+      HybridTime::FromMicros(3000)));
+
+  for (bool flushed : {false, true}) {
+    SCOPED_TRACE(Format("Flushed: $0", flushed));
+    if (flushed) {
+      ASSERT_OK(FlushRocksDB());
+    }
+    VerifySubDocument(SubDocKey(doc_key), HybridTime::FromMicros(2500), "");
+    VerifySubDocument(SubDocKey(doc_key), HybridTime::FromMicros(3500),
+        R"#(
+{
+  "k150": "new"
+}
+        )#");
+  }
+}
+
 }  // namespace docdb
 }  // namespace yb
@@ -22,6 +22,8 @@
 #include "yb/common/redis_protocol.pb.h"
 #include "yb/common/transaction.h"
 
+#include "yb/docdb/blob_storage.h"
+#include "yb/docdb/doc_kv_util.h"
 #include "yb/docdb/docdb-internal.h"
 #include "yb/docdb/docdb.h"
 #include "yb/docdb/docdb.pb.h"
@@ -29,6 +31,7 @@
 #include "yb/docdb/docdb_rocksdb_util.h"
 #include "yb/docdb/docdb_util.h"
 #include "yb/docdb/intent.h"
+#include "yb/docdb/intents_index.h"
 #include "yb/docdb/intent_aware_iterator.h"
 #include "yb/docdb/internal_doc_iterator.h"
 #include "yb/docdb/shared_lock_manager.h"
@@ -48,7 +51,6 @@
 #include "yb/util/metrics.h"
 
 using std::endl;
-using std::list;
 using std::string;
 using std::stringstream;
 using std::unique_ptr;
@@ -121,8 +123,10 @@ void PrepareDocWriteOperation(const vector<unique_ptr<DocOperation>>& doc_write_
                               bool *need_read_snapshot) {
   KeyToIntentTypeMap key_to_lock_type;
   *need_read_snapshot = false;
+  boost::container::small_vector<DocPath, 4> doc_paths;
+  KeyBytes current_prefix;
   for (const unique_ptr<DocOperation>& doc_op : doc_write_ops) {
-    list<DocPath> doc_paths;
+    doc_paths.clear();
     IsolationLevel level;
     doc_op->GetDocPathsToLock(&doc_paths, &level);
     if (isolation_level != IsolationLevel::NON_TRANSACTIONAL) {
@@ -131,7 +135,7 @@ void PrepareDocWriteOperation(const vector<unique_ptr<DocOperation>>& doc_write_
     const IntentTypePair intent_types = GetWriteIntentsForIsolationLevel(level);
 
     for (const auto& doc_path : doc_paths) {
-      KeyBytes current_prefix = doc_path.encoded_doc_key();
+      current_prefix = doc_path.encoded_doc_key();
       for (int i = 0; i < doc_path.num_subkeys(); i++) {
         ApplyIntent(current_prefix.AsStringRef(), intent_types.weak, &key_to_lock_type);
         doc_path.subkey(i).AppendToKey(&current_prefix);
@@ -156,9 +160,10 @@ Status ExecuteDocWriteOperation(const vector<unique_ptr<DocOperation>>& doc_writ
                                 KeyValueWriteBatchPB* write_batch,
                                 InitMarkerBehavior init_marker_behavior,
                                 std::atomic<int64_t>* monotonic_counter,
-                                HybridTime* restart_read_ht) {
+                                HybridTime* restart_read_ht,
+                                RecentWritesCache* recent_writes) {
   DCHECK_ONLY_NOTNULL(restart_read_ht);
-  DocWriteBatch doc_write_batch(rocksdb, init_marker_behavior, monotonic_counter);
+  DocWriteBatch doc_write_batch(rocksdb, init_marker_behavior, monotonic_counter, recent_writes);
   DocOperationApplyData data = {&doc_write_batch, read_time, restart_read_ht};
   for (const unique_ptr<DocOperation>& doc_op : doc_write_ops) {
     RETURN_NOT_OK(doc_op->Apply(data));
@@ -170,8 +175,11 @@ Status ExecuteDocWriteOperation(const vector<unique_ptr<DocOperation>>& doc_writ
 void PrepareNonTransactionWriteBatch(
     const KeyValueWriteBatchPB& put_batch,
     HybridTime hybrid_time,
-    rocksdb::WriteBatch* rocksdb_write_batch) {
+    rocksdb::WriteBatch* rocksdb_write_batch,
+    BlobStorage* blob_storage,
+    int64_t op_index) {
   DocHybridTimeBuffer doc_ht_buffer;
+  std::string blob_ref_value;
   for (int write_id = 0; write_id < put_batch.kv_pairs_size(); ++write_id) {
     const auto& kv_pair = put_batch.kv_pairs(write_id);
     CHECK(kv_pair.has_key());
@@ -205,6 +213,15 @@ void PrepareNonTransactionWriteBatch(
         doc_ht_buffer.EncodeWithValueType(hybrid_time, write_id),
     }};
     Slice key_value = kv_pair.value();
+    if (blob_storage) {
+      auto moved = MaybeMoveValueToBlob(key_value, op_index, blob_storage, &blob_ref_value);
+      if (!moved.ok()) {
+        // The value is still correct when stored inline, so blob storage failures are not fatal.
+        LOG(WARNING) << "Failed to move value to blob storage: " << moved.status();
+      } else if (moved.get()) {
+        key_value = blob_ref_value;
+      }
+    }
     rocksdb_write_batch->Put(key_parts, { &key_value, 1 });
   }
 }
@@ -253,11 +270,13 @@ class PrepareTransactionWriteBatchHelper {
   PrepareTransactionWriteBatchHelper(HybridTime hybrid_time,
                                      rocksdb::WriteBatch* rocksdb_write_batch,
                                      const TransactionId& transaction_id,
-                                     IsolationLevel isolation_level)
+                                     IsolationLevel isolation_level,
+                                     IntentsIndex* intents_index)
       : hybrid_time_(hybrid_time),
         rocksdb_write_batch_(rocksdb_write_batch),
         transaction_id_(transaction_id),
-        intent_types_(GetWriteIntentsForIsolationLevel(isolation_level)) {
+        intent_types_(GetWriteIntentsForIsolationLevel(isolation_level)),
+        intents_index_(intents_index) {
   }
 
   // Using operator() to pass this object conveniently to EnumerateIntents.
@@ -285,6 +304,7 @@ class PrepareTransactionWriteBatchHelper {
         doc_ht_buffer.EncodeWithValueType(hybrid_time_, write_id_++),
     }};
     AddIntent(transaction_id_, key_parts, value, rocksdb_write_batch_);
+    AddToIndex(key->AsSlice(), intent_types_.strong);
 
     return Status::OK();
   }
@@ -309,10 +329,19 @@ class PrepareTransactionWriteBatchHelper {
       }};
 
       AddIntent(transaction_id_, key, value, rocksdb_write_batch_);
+      AddToIndex(intent, intent_types_.weak);
     }
   }
 
  private:
+  void AddToIndex(Slice intent_prefix, IntentType type) {
+    if (intents_index_) {
+      // Intents index is keyed by doc path, without the intent prefix.
+      intent_prefix.consume_byte();
+      intents_index_->Add(transaction_id_, intent_prefix, type);
+    }
+  }
+
   // TODO(dtxn) weak & strong intent in one batch.
   // TODO(dtxn) extract part of code knowning about intents structure to lower level.
   HybridTime hybrid_time_;
@@ -321,6 +350,7 @@ class PrepareTransactionWriteBatchHelper {
   IntentTypePair intent_types_;
   std::unordered_set<std::string> weak_intents_;
   IntraTxnWriteId write_id_ = 0;
+  IntentsIndex* intents_index_;
 };
 
 // We have the following distinct types of data in this "intent store":
@@ -338,9 +368,10 @@ void PrepareTransactionWriteBatch(
     HybridTime hybrid_time,
     rocksdb::WriteBatch* rocksdb_write_batch,
     const TransactionId& transaction_id,
-    IsolationLevel isolation_level) {
+    IsolationLevel isolation_level,
+    IntentsIndex* intents_index) {
   PrepareTransactionWriteBatchHelper helper(
-      hybrid_time, rocksdb_write_batch, transaction_id, isolation_level);
+      hybrid_time, rocksdb_write_batch, transaction_id, isolation_level, intents_index);
 
   // We cannot recover from failures here, because it means that we cannot apply replicated
   // operation.
@@ -363,6 +394,61 @@ void SeekToLowerBound(const SubDocKeyBound& lower_bound, IntentAwareIterator* it
   }
 }
 
+// Returns the latest hybrid time that is older than doc_ht.
+DocHybridTime PreviousDocHybridTime(const DocHybridTime& doc_ht) {
+  if (doc_ht.write_id() != kMinWriteId) {
+    return DocHybridTime(doc_ht.hybrid_time(), doc_ht.write_id() - 1);
+  }
+  return DocHybridTime(doc_ht.hybrid_time().Decremented(), kMaxWriteId);
+}
+
+// Adds older versions of the counter at key to the counter delta in value, until a version that is
+// not a delta is added. Versions older than low_ts, tombstones and expired versions stop the sum.
+// The iterator is left positioned inside key, so the caller should seek out of it.
+CHECKED_STATUS AddOlderCounterVersions(
+    IntentAwareIterator* iter, const SubDocKey& key, const DocHybridTime& low_ts,
+    const MonoDelta& table_ttl, Value* value) {
+  const KeyBytes key_without_ht = key.Encode(false /* include_hybrid_time */);
+  DocHybridTime doc_ht = key.doc_hybrid_time();
+  int64_t sum = value->primitive_value().GetInt64();
+  for (;;) {
+    KeyBytes seek_key = key_without_ht;
+    AppendDocHybridTime(PreviousDocHybridTime(doc_ht), &seek_key);
+    iter->SeekForwardWithoutHt(seek_key);
+    if (!iter->valid()) {
+      break;
+    }
+    const Slice iter_key = VERIFY_RESULT(iter->FetchKey());
+    bool only_lacks_ht = false;
+    RETURN_NOT_OK(key_without_ht.OnlyLacksHybridTimeFrom(iter_key, &only_lacks_ht));
+    if (!only_lacks_ht) {
+      break;
+    }
+    RETURN_NOT_OK(DecodeHybridTimeFromEndOfKey(iter_key, &doc_ht));
+    if (low_ts > doc_ht) {
+      break;
+    }
+
+    Value older;
+    RETURN_NOT_OK(older.Decode(iter->value()));
+    const MonoDelta ttl = ComputeTTL(older.ttl(), table_ttl);
+    if (!ttl.Equals(Value::kMaxTtl) &&
+        iter->read_time().read.CompareTo(server::HybridClock::AddPhysicalTimeToHybridTime(
+            doc_ht.hybrid_time(), ttl)) > 0) {
+      break;
+    }
+    if (!older.primitive_value().IsInt64()) {
+      break;
+    }
+    sum += older.primitive_value().GetInt64();
+    if (!older.is_counter_delta()) {
+      break;
+    }
+  }
+  *value = Value(PrimitiveValue(sum), value->ttl(), value->user_timestamp());
+  return Status::OK();
+}
+
 // This function does not assume that object init_markers are present. If no init marker is present,
 // or if a tombstone is found at some level, it still looks for subkeys inside it if they have
 // larger timestamps.
@@ -398,21 +484,32 @@ CHECKED_STATUS BuildSubDocument(
         << "iter: " << iter_key->ToDebugString()
         << ", key: " << encoded_key.ToString();
 
-    SubDocKey found_key;
-    RETURN_NOT_OK(found_key.FullyDecodeFrom(*iter_key));
-
-    rocksdb::Slice value = iter->value();
+    // Entries older than the latest tombstone or collection init marker found above are skipped
+    // before decoding the whole key. After a big document is deleted, every key of it is such an
+    // entry, so we only decode the hybrid time at the end of the key and seek past the encoded key
+    // as is.
+    int encoded_ht_size = 0;
+    RETURN_NOT_OK(CheckHybridTimeSizeAndValueType(*iter_key, &encoded_ht_size));
+    DocHybridTime found_ht;
+    RETURN_NOT_OK(DecodeHybridTimeFromEndOfKey(*iter_key, &found_ht));
 
     // Checking that intent aware iterator returns entry with correct time.
-    DCHECK_GE(iter->read_time().global_limit, found_key.hybrid_time())
-        << "Found key: " << found_key.ToString();
-
-    if (low_ts > found_key.doc_hybrid_time()) {
-      VLOG(3) << "SeekPastSubKey: $0" << found_key.ToString();
-      iter->SeekPastSubKey(found_key);
+    DCHECK_GE(iter->read_time().global_limit, found_ht.hybrid_time())
+        << "Found key: " << SubDocKey::DebugSliceToString(*iter_key);
+
+    if (low_ts > found_ht) {
+      // Also strip ValueType::kHybridTime preceding the encoded hybrid time.
+      const Slice key_without_ht(iter_key->data(), iter_key->size() - encoded_ht_size - 1);
+      VLOG(3) << "SeekPastSubKey: " << SubDocKey::DebugSliceToString(*iter_key);
+      iter->SeekPastSubKey(key_without_ht);
       continue;
     }
 
+    SubDocKey found_key;
+    RETURN_NOT_OK(found_key.FullyDecodeFrom(*iter_key));
+
+    rocksdb::Slice value = iter->value();
+
     Value doc_value;
     RETURN_NOT_OK(doc_value.Decode(value));
 
@@ -477,6 +574,10 @@ CHECKED_STATUS BuildSubDocument(
           return STATUS_FORMAT(Corruption,
               "Expected primitive value type, got $0", doc_value.value_type());
         }
+        if (doc_value.is_counter_delta()) {
+          RETURN_NOT_OK(AddOlderCounterVersions(iter, found_key, low_ts, data.table_ttl,
+                                                &doc_value));
+        }
 
         DCHECK_GE(iter->read_time().global_limit, write_time.hybrid_time());
         if (ttl.Equals(Value::kMaxTtl)) {
@@ -512,19 +613,7 @@ CHECKED_STATUS BuildSubDocument(
       }
     }
 
-    SubDocument descendant = SubDocument(PrimitiveValue(ValueType::kInvalidValueType));
-    // TODO: what if found_key is the same as before? We'll get into an infinite recursion then.
     found_key.remove_hybrid_time();
-    {
-      auto encoded_found_key = found_key.Encode();
-      IntentAwareIteratorPrefixScope prefix_scope(encoded_found_key, iter);
-      RETURN_NOT_OK(BuildSubDocument(iter, data.Adjusted(&found_key, &descendant),
-                                     low_ts, num_values_observed));
-    }
-    if (descendant.value_type() == ValueType::kInvalidValueType) {
-      // The document was not found in this level (maybe a tombstone was encountered).
-      continue;
-    }
 
     // For the purposes of comparison, we strip the found key until it matches the length of both
     // the low and high subkeys for their respective calculations.
@@ -533,21 +622,45 @@ CHECKED_STATUS BuildSubDocument(
     found_key_prefix_low.KeepPrefix(data.low_subkey->num_subkeys());
     found_key_prefix_high.KeepPrefix(data.high_subkey->num_subkeys());
 
+    // Subkey bounds are checked before building the descendant, so that a range query over a
+    // large collection, e.g. a score range of a sorted set, does not build the subdocuments
+    // outside of the range, but seeks straight to the lower bound and stops at the upper bound.
     if (data.low_subkey->IsValid() && !data.low_subkey->CanInclude(found_key_prefix_low)) {
       // The value provided is lower than what we are looking for, seek to the lower bound.
       SeekToLowerBound(*data.low_subkey, iter);
       continue;
     }
 
+    if (data.high_subkey->IsValid() && !data.high_subkey->CanInclude(found_key_prefix_high)) {
+      // We have encountered a subkey higher than our constraints, we should stop here.
+      return Status::OK();
+    }
+
+    SubDocument descendant = SubDocument(PrimitiveValue(ValueType::kInvalidValueType));
+    // TODO: what if found_key is the same as before? We'll get into an infinite recursion then.
+    {
+      auto encoded_found_key = found_key.Encode();
+      IntentAwareIteratorPrefixScope prefix_scope(encoded_found_key, iter);
+      RETURN_NOT_OK(BuildSubDocument(iter, data.Adjusted(&found_key, &descendant),
+                                     low_ts, num_values_observed));
+    }
+    if (descendant.value_type() == ValueType::kInvalidValueType) {
+      // The document was not found in this level (maybe a tombstone was encountered).
+      if (!data.high_index->CanInclude(*num_values_observed)) {
+        // No more values could be included, so there is no need to look at the rest of them.
+        return Status::OK();
+      }
+      continue;
+    }
+
     // We use num_values_observed as a conservative figure for lower bound and
     // current_values_observed for upper bound so we don't lose any data we should be including.
     if (!data.low_index->CanInclude(*num_values_observed)) {
       continue;
     }
 
-    if ((data.high_subkey->IsValid() && !data.high_subkey->CanInclude(found_key_prefix_high)) ||
-        !data.high_index->CanInclude(current_values_observed)) {
-      // We have encountered a subkey higher than our constraints, we should stop here.
+    if (!data.high_index->CanInclude(current_values_observed)) {
+      // We have encountered an index higher than our constraints, we should stop here.
       return Status::OK();
     }
 
@@ -83,6 +83,9 @@ class Histogram;
 
 namespace docdb {
 
+class BlobStorage;
+class IntentsIndex;
+
 // This function prepares the transaction by taking locks. The set of keys locked are returned to
 // the caller via the keys_locked argument (because they need to be saved and unlocked when the
 // transaction commits). A flag is also returned to indicate if any of the write operations
@@ -124,12 +127,17 @@ CHECKED_STATUS ExecuteDocWriteOperation(
     KeyValueWriteBatchPB* write_batch,
     InitMarkerBehavior init_marker_behavior,
     std::atomic<int64_t>* monotonic_counter,
-    HybridTime* restart_read_ht);
+    HybridTime* restart_read_ht,
+    RecentWritesCache* recent_writes = nullptr);
 
+// When blob_storage is specified, large values are moved to it, see MaybeMoveValueToBlob. op_index
+// is the Raft index of the operation that put_batch belongs to.
 void PrepareNonTransactionWriteBatch(
     const docdb::KeyValueWriteBatchPB& put_batch,
     HybridTime hybrid_time,
-    rocksdb::WriteBatch* rocksdb_write_batch);
+    rocksdb::WriteBatch* rocksdb_write_batch,
+    BlobStorage* blob_storage = nullptr,
+    int64_t op_index = 0);
 
 // Enumerates intents corresponding to provided key value pairs.
 // For each key in generates a strong intent and for each parent of each it generates a weak one.
@@ -149,12 +157,14 @@ CHECKED_STATUS EnumerateIntents(
     const google::protobuf::RepeatedPtrField<yb::docdb::KeyValuePairPB> &kv_pairs,
     boost::function<Status(IntentKind, Slice, KeyBytes*)> functor);
 
+// intents_index - optional, when present written intents are also registered in it.
 void PrepareTransactionWriteBatch(
     const docdb::KeyValueWriteBatchPB& put_batch,
     HybridTime hybrid_time,
     rocksdb::WriteBatch* rocksdb_write_batch,
     const TransactionId& transaction_id,
-    IsolationLevel isolation_level);
+    IsolationLevel isolation_level,
+    IntentsIndex* intents_index = nullptr);
 
 // A visitor class that could be overridden to consume results of scanning SubDocuments.
 // See e.g. SubDocumentBuildingVisitor (used in implementing GetSubDocument) as example usage.
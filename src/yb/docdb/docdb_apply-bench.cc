@@ -0,0 +1,124 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "yb/docdb/consensus_frontier.h"
+#include "yb/docdb/doc_key.h"
+#include "yb/docdb/docdb_test_base.h"
+#include "yb/docdb/value.h"
+
+#include "yb/util/stopwatch.h"
+
+using namespace std::literals; // NOLINT
+
+DECLARE_bool(rocksdb_allow_concurrent_memtable_write);
+DECLARE_bool(rocksdb_enable_write_thread_adaptive_yield);
+
+namespace yb {
+namespace docdb {
+
+// Measures throughput of applying DocDB write batches to a single RocksDB instance, i.e. tablet,
+// from multiple threads.
+class DocDBApplyBench : public DocDBTestBase {
+ protected:
+  void RunBenchmark(bool allow_concurrent_memtable_write);
+};
+
+void DocDBApplyBench::RunBenchmark(bool allow_concurrent_memtable_write) {
+#if defined(THREAD_SANITIZER) || defined(ADDRESS_SANITIZER)
+  constexpr int kNumAppliers = 4;
+#else
+  constexpr int kNumAppliers = 16;
+#endif
+  constexpr int kRowsPerBatch = 10;
+  const auto kRunTime = 10s;
+
+  FLAGS_rocksdb_allow_concurrent_memtable_write = allow_concurrent_memtable_write;
+  FLAGS_rocksdb_enable_write_thread_adaptive_yield = allow_concurrent_memtable_write;
+  ASSERT_OK(DestroyRocksDB());
+  ASSERT_OK(InitRocksDBOptions());
+  ASSERT_OK(OpenRocksDB());
+
+  std::atomic<bool> stop(false);
+  std::atomic<int64_t> op_index(0);
+  std::atomic<int64_t> total_batches(0);
+
+  Stopwatch sw(Stopwatch::ALL_THREADS);
+  sw.start();
+
+  std::vector<std::thread> appliers;
+  for (int i = 0; i != kNumAppliers; ++i) {
+    appliers.emplace_back([this, i, &stop, &op_index, &total_batches] {
+      int64_t row = 0;
+      int64_t num_batches = 0;
+      while (!stop.load(std::memory_order_acquire)) {
+        // Operation index and hybrid time are assigned like they are assigned by Raft.
+        const int64_t index = ++op_index;
+        const HybridTime hybrid_time = HybridTime::FromMicros(index);
+        ConsensusFrontiers frontiers;
+        set_op_id(rocksdb::OpId(1, index), &frontiers);
+        set_hybrid_time(hybrid_time, &frontiers);
+
+        rocksdb::WriteBatch write_batch;
+        write_batch.SetFrontiers(&frontiers);
+        for (int j = 0; j != kRowsPerBatch; ++j, ++row) {
+          const SubDocKey sub_doc_key(
+              DocKey(PrimitiveValues(static_cast<int64_t>(i), row)), PrimitiveValue(ColumnId(1)),
+              hybrid_time);
+          write_batch.Put(sub_doc_key.Encode().AsSlice(), Value(PrimitiveValue(row)).Encode());
+        }
+        ASSERT_OK(rocksdb()->Write(write_options(), &write_batch));
+        ++num_batches;
+      }
+      total_batches += num_batches;
+    });
+  }
+
+  std::this_thread::sleep_for(kRunTime);
+  stop.store(true, std::memory_order_release);
+  for (auto& applier : appliers) {
+    applier.join();
+  }
+  sw.stop();
+
+  const double batches_per_second = total_batches.load() / sw.elapsed().wall_seconds();
+  LOG(INFO) << "Concurrent memtable write: " << allow_concurrent_memtable_write;
+  LOG(INFO) << "Batches/sec:              " << batches_per_second;
+  LOG(INFO) << "Rows/sec:                 " << batches_per_second * kRowsPerBatch;
+  LOG(INFO) << "CPU per batch:            "
+            << (sw.elapsed().user + sw.elapsed().system) / 1000.0 / total_batches.load() << "us";
+
+  // Check that all rows were written.
+  rocksdb::ReadOptions read_options;
+  std::unique_ptr<rocksdb::Iterator> iter(rocksdb()->NewIterator(read_options));
+  int64_t num_rows = 0;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    ++num_rows;
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(total_batches.load() * kRowsPerBatch, num_rows);
+}
+
+TEST_F(DocDBApplyBench, SerialMemTableWrite) {
+  RunBenchmark(false /* allow_concurrent_memtable_write */);
+}
+
+TEST_F(DocDBApplyBench, ConcurrentMemTableWrite) {
+  RunBenchmark(true /* allow_concurrent_memtable_write */);
+}
+
+}  // namespace docdb
+}  // namespace yb
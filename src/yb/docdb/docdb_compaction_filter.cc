@@ -13,13 +13,18 @@
 
 #include "yb/docdb/docdb_compaction_filter.h"
 
+#include <algorithm>
 #include <memory>
 
 #include <glog/logging.h>
 
 #include "yb/rocksdb/compaction_filter.h"
+#include "yb/rocksdb/db.h"
+#include "yb/rocksdb/metadata.h"
+#include "yb/rocksdb/util/coding.h"
 #include "yb/util/string_util.h"
 
+#include "yb/docdb/consensus_frontier.h"
 #include "yb/docdb/doc_key.h"
 #include "yb/docdb/docdb-internal.h"
 #include "yb/docdb/value.h"
@@ -34,18 +39,58 @@ using rocksdb::VectorToString;
 namespace yb {
 namespace docdb {
 
+namespace {
+
+// Appends ends of document key and subkeys of encoded SubDocKey without hybrid time to ends,
+// starting from components following the specified number of already known components.
+Status DecodeComponentEnds(const Slice& key, size_t num_known_components,
+                           std::vector<size_t>* ends) {
+  ends->resize(num_known_components);
+  Slice slice = key;
+  if (num_known_components == 0) {
+    ends->push_back(VERIFY_RESULT(DocKey::EncodedSize(slice, DocKeyPart::WHOLE_DOC_KEY)));
+  }
+  slice.remove_prefix(ends->back());
+  for (;;) {
+    auto decode_result = SubDocKey::DecodeSubkey(&slice);
+    RETURN_NOT_OK(decode_result);
+    if (!decode_result.get()) {
+      break;
+    }
+    ends->push_back(slice.cdata() - key.cdata());
+  }
+  if (!slice.empty()) {
+    return STATUS_FORMAT(Corruption, "Unexpected bytes after SubDocKey: $0",
+                         slice.ToDebugHexString());
+  }
+  return Status::OK();
+}
+
+void CheckKeyDecodeStatus(const Status& status, const Slice& key) {
+  CHECK(status.ok())
+    << "Error decoding a key during compaction: " << status.ToString() << "\n"
+    << "    Key (raw): " << FormatRocksDBSliceAsStr(key) << "\n"
+    << "    Key (best-effort decoded): " << BestEffortDocDBKeyToStr(key);
+}
+
+} // namespace
+
 // ------------------------------------------------------------------------------------------------
 
 DocDBCompactionFilter::DocDBCompactionFilter(HybridTime history_cutoff,
                                              ColumnIdsPtr deleted_cols,
                                              bool is_full_compaction,
-                                             MonoDelta table_ttl)
+                                             bool is_garbage_collection,
+                                             MonoDelta table_ttl,
+                                             rocksdb::DB* db)
     : history_cutoff_(history_cutoff),
       is_full_compaction_(is_full_compaction),
+      is_garbage_collection_(is_garbage_collection),
       is_first_key_value_(true),
       filter_usage_logged_(false),
       table_ttl_(table_ttl),
-      deleted_cols_(deleted_cols) {
+      deleted_cols_(deleted_cols),
+      db_(db) {
 }
 
 DocDBCompactionFilter::~DocDBCompactionFilter() {
@@ -56,11 +101,13 @@ bool DocDBCompactionFilter::Filter(int level,
                                    const rocksdb::Slice& existing_value,
                                    std::string* new_value,
                                    bool* value_changed) const {
-  if (!is_full_compaction_) {
+  if (!is_full_compaction_ && !is_garbage_collection_) {
     // By default, we only perform history garbage collection on full compactions
-    // (or major compactions, in the HBase terminology).
+    // (or major compactions, in the HBase terminology), and on compactions picked to remove
+    // garbage of a file. The latter keep deletion markers and write expired values back as
+    // tombstones, because older files that are not compacted could still have earlier values.
     //
-    // TODO: Enable history garbage collection on minor (non-full) compactions as well.
+    // TODO: Enable history garbage collection on all minor (non-full) compactions as well.
     //       This should be similar to the existing workflow, but should be extensively tested.
     //
     // Here, false means "keep the key/value pair" (don't filter it out).
@@ -73,28 +120,35 @@ bool DocDBCompactionFilter::Filter(int level,
     filter_usage_logged_ = true;
   }
 
-  SubDocKey subdoc_key;
-
+  // Only hybrid time is decoded here, the rest of the key is compared with the previous key in
+  // encoded form and is decoded only when this entry is kept. So runs of entries that were
+  // overwritten at or before the history cutoff are removed without decoding their keys and values.
+  int encoded_ht_size = 0;
+  DocHybridTime ht;
   // TODO: Find a better way for handling of data corruption encountered during compactions.
-  const Status key_decode_status = subdoc_key.FullyDecodeFrom(key);
-  CHECK(key_decode_status.ok())
-    << "Error decoding a key during compaction: " << key_decode_status.ToString() << "\n"
-    << "    Key (raw): " << FormatRocksDBSliceAsStr(key) << "\n"
-    << "    Key (best-effort decoded): " << BestEffortDocDBKeyToStr(key);
+  Status key_decode_status = DocHybridTime::CheckAndGetEncodedSize(key, &encoded_ht_size);
+  if (key_decode_status.ok()) {
+    key_decode_status = ht.DecodeFromEnd(key);
+  }
+  CheckKeyDecodeStatus(key_decode_status, key);
+  // Also strip ValueType::kHybridTime preceding the encoded hybrid time.
+  const Slice key_without_ht(key.data(), key.size() - encoded_ht_size - 1);
 
   if (is_first_key_value_) {
     CHECK_EQ(0, overwrite_ht_.size());
     is_first_key_value_ = false;
   }
 
-  const size_t num_shared_components = prev_subdoc_key_.NumSharedPrefixComponents(subdoc_key);
+  const size_t shared_prefix_size = key_without_ht.difference_offset(prev_key_);
+  // Equivalent of SubDocKey::NumSharedPrefixComponents for decoded keys.
+  const size_t num_shared_components = std::upper_bound(
+      prev_key_component_ends_.begin(), prev_key_component_ends_.end(), shared_prefix_size) -
+      prev_key_component_ends_.begin();
 
   // Remove overwrite hybrid_times for components that are no longer relevant for the current
   // SubDocKey.
   overwrite_ht_.resize(min(overwrite_ht_.size(), num_shared_components));
 
-  const DocHybridTime& ht = subdoc_key.doc_hybrid_time();
-
   // We're comparing the hybrid_time in this key with the _previous_ stack top of overwrite_ht_,
   // after truncating the previous hybrid_time to the number of components in the common prefix
   // of previous and current key.
@@ -131,7 +185,15 @@ bool DocDBCompactionFilter::Filter(int level,
     return true;  // Remove this key/value pair.
   }
 
-  const int new_stack_size = subdoc_key.num_subkeys() + 1;
+  if (num_shared_components < prev_key_component_ends_.size() ||
+      key_without_ht.size() != prev_key_.size()) {
+    key_decode_status = DecodeComponentEnds(
+        key_without_ht, num_shared_components, &prev_key_component_ends_);
+    CheckKeyDecodeStatus(key_decode_status, key);
+    prev_key_.assign(key_without_ht.cdata(), key_without_ht.size());
+  }
+
+  const size_t new_stack_size = prev_key_component_ends_.size();
 
   // Every subdocument was fully overwritten at least at the time any of its parents was fully
   // overwritten.
@@ -156,30 +218,48 @@ bool DocDBCompactionFilter::Filter(int level,
   overwrite_ht_.push_back(ht_at_or_below_cutoff ? max(prev_overwrite_ht, ht) : prev_overwrite_ht);
 
   CHECK_EQ(new_stack_size, overwrite_ht_.size());
-  prev_subdoc_key_ = std::move(subdoc_key);
 
-  if (prev_subdoc_key_.num_subkeys() > 0 &&
-      prev_subdoc_key_.subkeys()[0].value_type() == ValueType::kColumnId) {
+  if (!deleted_cols_->empty() && new_stack_size > 1 &&
+      prev_key_[prev_key_component_ends_[0]] == static_cast<char>(ValueType::kColumnId)) {
     // Column ID is first subkey in QL tables.
-    ColumnId col_id = prev_subdoc_key_.subkeys()[0].GetColumnId();
+    Slice subkey_slice(prev_key_.data() + prev_key_component_ends_[0],
+                       prev_key_component_ends_[1] - prev_key_component_ends_[0]);
+    PrimitiveValue subkey;
+    CHECK_OK(SubDocKey::DecodeSubkey(&subkey_slice, &subkey));
+    ColumnId col_id = subkey.GetColumnId();
 
     if (deleted_cols_->find(col_id) != deleted_cols_->end()) {
       return true;
     }
   }
 
+  // Entries above the history cutoff could neither be expired nor removed as tombstones, so there
+  // is no need to decode their values.
+  if (!ht_at_or_below_cutoff) {
+    return false;
+  }
+
+  // If the value expires by the time of history cutoff, it is treated as deleted and filtered out.
   ValueType value_type;
   CHECK_OK(Value::DecodePrimitiveValueType(existing_value, &value_type));
   MonoDelta ttl;
-
-  // If the value expires by the time of history cutoff, it is treated as deleted and filtered out.
   CHECK_OK(Value::DecodeTTL(existing_value, &ttl));
 
   bool has_expired = false;
 
-  CHECK_OK(HasExpiredTTL(subdoc_key.hybrid_time(), ComputeTTL(ttl, table_ttl_), history_cutoff_,
+  CHECK_OK(HasExpiredTTL(ht.hybrid_time(), ComputeTTL(ttl, table_ttl_), history_cutoff_,
                          &has_expired));
 
+  // A counter delta does not overwrite older versions of the counter, unless it is folded with
+  // them into the full counter value.
+  if (value_type == ValueType::kCounterDelta && !has_expired) {
+    if (FoldCounterDelta(key_without_ht, ht, prev_overwrite_ht, existing_value, new_value)) {
+      *value_changed = true;
+    } else {
+      overwrite_ht_.back() = prev_overwrite_ht;
+    }
+  }
+
   // As of 02/2017, we don't have init markers for top level documents in QL. As a result, we can
   // compact away each column if it has expired, including the liveness system column. The init
   // markers in Redis wouldn't be affected since they don't have any TTL associated with them and
@@ -207,6 +287,72 @@ bool DocDBCompactionFilter::Filter(int level,
   return value_type == ValueType::kTombstone && ht_at_or_below_cutoff && is_full_compaction_;
 }
 
+bool DocDBCompactionFilter::FoldCounterDelta(const Slice& key_without_ht,
+                                             const DocHybridTime& ht,
+                                             const DocHybridTime& prev_overwrite_ht,
+                                             const Slice& value,
+                                             std::string* new_value) const {
+  if (db_ == nullptr) {
+    return false;
+  }
+  Value delta;
+  if (!delta.Decode(value).ok()) {
+    return false;
+  }
+  int64_t sum = delta.primitive_value().GetInt64();
+
+  rocksdb::ReadOptions read_options;
+  read_options.fill_cache = false;
+  unique_ptr<rocksdb::Iterator> iter(db_->NewIterator(read_options));
+  KeyBytes key(key_without_ht);
+  AppendDocHybridTime(ht, &key);
+  // Entries of the same key are ordered by descending hybrid time, so older versions follow the
+  // delta itself.
+  for (iter->Seek(key.AsSlice()); iter->Valid(); iter->Next()) {
+    const Slice older_key = iter->key();
+    if (older_key == key.AsSlice()) {
+      continue;
+    }
+    int encoded_ht_size = 0;
+    DocHybridTime older_ht;
+    if (!DocHybridTime::CheckAndGetEncodedSize(older_key, &encoded_ht_size).ok() ||
+        older_key.size() != key_without_ht.size() + encoded_ht_size + 1 ||
+        !older_key.starts_with(key_without_ht)) {
+      break;
+    }
+    if (!older_ht.DecodeFromEnd(older_key).ok()) {
+      return false;
+    }
+    if (older_ht < prev_overwrite_ht) {
+      break;
+    }
+
+    Value older;
+    if (!older.Decode(iter->value()).ok()) {
+      return false;
+    }
+    bool has_expired = false;
+    if (!HasExpiredTTL(older_ht.hybrid_time(), ComputeTTL(older.ttl(), table_ttl_),
+                       history_cutoff_, &has_expired).ok()) {
+      return false;
+    }
+    if (has_expired || !older.primitive_value().IsInt64()) {
+      break;
+    }
+    sum += older.primitive_value().GetInt64();
+    if (!older.is_counter_delta()) {
+      break;
+    }
+  }
+  if (!iter->status().ok()) {
+    LOG(WARNING) << "Failed to read older versions of counter "
+                 << BestEffortDocDBKeyToStr(key.AsSlice()) << ": " << iter->status();
+    return false;
+  }
+  *new_value = Value(PrimitiveValue(sum), delta.ttl(), delta.user_timestamp()).Encode();
+  return true;
+}
+
 const char* DocDBCompactionFilter::Name() const {
   return "DocDBCompactionFilter";
 }
@@ -227,12 +373,81 @@ unique_ptr<CompactionFilter> DocDBCompactionFilterFactory::CreateCompactionFilte
   return unique_ptr<DocDBCompactionFilter>(
       new DocDBCompactionFilter(retention_policy_->GetHistoryCutoff(),
                                 retention_policy_->GetDeletedColumns(),
-                                context.is_full_compaction, retention_policy_->GetTableTTL()));
+                                context.is_full_compaction, context.is_garbage_collection,
+                                retention_policy_->GetTableTTL(),
+                                db_.load(std::memory_order_acquire)));
+}
+
+rocksdb::Slice DocDBCompactionFilterFactory::SubcompactionBoundary(
+    const rocksdb::Slice& user_key) const {
+  // Key sampled from the index could be a shortened separator, that is not a valid DocDB key.
+  auto doc_key_size = DocKey::EncodedSize(user_key, DocKeyPart::WHOLE_DOC_KEY);
+  if (!doc_key_size.ok()) {
+    return rocksdb::Slice();
+  }
+  return rocksdb::Slice(user_key.data(), *doc_key_size);
+}
+
+bool DocDBCompactionFilterFactory::IsGarbageCollectable(
+    const rocksdb::FileBoundaryValuesBase& largest) const {
+  if (!largest.user_frontier) {
+    return false;
+  }
+  const auto& frontier = down_cast<const ConsensusFrontier&>(*largest.user_frontier);
+  return frontier.hybrid_time().is_valid() &&
+         frontier.hybrid_time() <= retention_policy_->GetHistoryCutoff();
 }
 
 const char* DocDBCompactionFilterFactory::Name() const {
   return "DocDBCompactionFilterFactory";
 }
 
+// ------------------------------------------------------------------------------------------------
+
+rocksdb::Status DocDBTablePropertiesCollector::AddUserKey(
+    const rocksdb::Slice& key, const rocksdb::Slice& value, rocksdb::EntryType type,
+    rocksdb::SequenceNumber seq, uint64_t file_size) {
+  int encoded_ht_size = 0;
+  if (type != rocksdb::kEntryPut ||
+      !DocHybridTime::CheckAndGetEncodedSize(key, &encoded_ht_size).ok()) {
+    prev_key_.clear();
+    return rocksdb::Status::OK();
+  }
+  // Also strip ValueType::kHybridTime preceding the encoded hybrid time.
+  const Slice key_without_ht(key.data(), key.size() - encoded_ht_size - 1);
+  if (!prev_key_.empty() && key_without_ht == Slice(prev_key_)) {
+    ++garbage_entries_;
+  } else {
+    prev_key_.assign(key_without_ht.cdata(), key_without_ht.size());
+  }
+  return rocksdb::Status::OK();
+}
+
+rocksdb::Status DocDBTablePropertiesCollector::Finish(
+    rocksdb::UserCollectedProperties* properties) {
+  std::string value;
+  rocksdb::PutVarint64(&value, garbage_entries_);
+  properties->emplace(rocksdb::kGarbageKeysPropertyName, std::move(value));
+  return rocksdb::Status::OK();
+}
+
+rocksdb::UserCollectedProperties DocDBTablePropertiesCollector::GetReadableProperties() const {
+  return {{"kGarbageKeys", std::to_string(garbage_entries_)}};
+}
+
+const char* DocDBTablePropertiesCollector::Name() const {
+  return "DocDBTablePropertiesCollector";
+}
+
+rocksdb::TablePropertiesCollector*
+DocDBTablePropertiesCollectorFactory::CreateTablePropertiesCollector(
+    rocksdb::TablePropertiesCollectorFactory::Context context) {
+  return new DocDBTablePropertiesCollector();
+}
+
+const char* DocDBTablePropertiesCollectorFactory::Name() const {
+  return "DocDBTablePropertiesCollectorFactory";
+}
+
 }  // namespace docdb
 }  // namespace yb
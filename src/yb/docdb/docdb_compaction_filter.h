@@ -16,9 +16,11 @@
 
 #include <atomic>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "yb/rocksdb/compaction_filter.h"
+#include "yb/rocksdb/table_properties.h"
 
 #include "yb/common/schema.h"
 #include "yb/common/hybrid_time.h"
@@ -29,10 +31,15 @@ namespace docdb {
 
 class DocDBCompactionFilter : public rocksdb::CompactionFilter {
  public:
+  // is_garbage_collection - whether history should be removed even though the compaction is not
+  // full, see rocksdb::CompactionFilter::Context. Deletion markers are removed only by full
+  // compactions in any case.
   DocDBCompactionFilter(HybridTime history_cutoff,
                         ColumnIdsPtr deleted_cols,
                         bool is_full_compaction,
-                        MonoDelta table_ttl);
+                        bool is_garbage_collection,
+                        MonoDelta table_ttl,
+                        rocksdb::DB* db = nullptr);
 
   ~DocDBCompactionFilter() override;
   bool Filter(int level,
@@ -43,6 +50,14 @@ class DocDBCompactionFilter : public rocksdb::CompactionFilter {
   const char* Name() const override;
 
  private:
+  // Adds the older versions of the counter at key_without_ht, read from db_, to the counter delta
+  // in value written at ht, and fills new_value with the sum. Versions older than
+  // prev_overwrite_ht were overwritten by a parent. Returns false if the delta should be kept,
+  // e.g. when there is no db_ to read the older versions from.
+  bool FoldCounterDelta(const Slice& key_without_ht, const DocHybridTime& ht,
+                        const DocHybridTime& prev_overwrite_ht, const Slice& value,
+                        std::string* new_value) const;
+
   // We will not keep history below this hybrid_time. The view of the database at this hybrid_time
   // is preserved, but after the compaction completes, we should not expect to be able to do
   // consistent scans at DocDB hybrid_times lower than this. Those scans will result in missing
@@ -50,9 +65,18 @@ class DocDBCompactionFilter : public rocksdb::CompactionFilter {
   // the lowest "read point" of any pending read operations.
   const HybridTime history_cutoff_;
   const bool is_full_compaction_;
+  const bool is_garbage_collection_;
 
   mutable bool is_first_key_value_;
-  mutable SubDocKey prev_subdoc_key_;
+
+  // Encoded previous SubDocKey that was kept, without hybrid time. Keys are compared in encoded
+  // form, so we don't have to decode keys that are removed.
+  mutable std::string prev_key_;
+
+  // Ends of the document key and each subkey in prev_key_. Components of the encoded key are
+  // self-delimiting, so keys that have the same bytes up to the i-th end share first i + 1
+  // components.
+  mutable std::vector<size_t> prev_key_component_ends_;
 
   // A stack of highest hybrid_times lower than or equal to history_cutoff_ at which parent
   // subdocuments of the key that has just been processed, or the subdocument / primitive value
@@ -100,6 +124,9 @@ class DocDBCompactionFilter : public rocksdb::CompactionFilter {
   MonoDelta table_ttl_;
 
   ColumnIdsPtr deleted_cols_;
+
+  // RocksDB being compacted, used to read older versions of counters that are folded.
+  rocksdb::DB* const db_;
 };
 
 // A strategy for deciding the history cutoff. We may implement this differently in production and
@@ -143,10 +170,55 @@ class DocDBCompactionFilterFactory : public rocksdb::CompactionFilterFactory {
   ~DocDBCompactionFilterFactory() override;
   std::unique_ptr<rocksdb::CompactionFilter> CreateCompactionFilter(
       const rocksdb::CompactionFilter::Context& context) override;
+
+  // Returns the document key of user_key, since compaction filter tracks overwrites of a document
+  // using preceding entries of the same document.
+  rocksdb::Slice SubcompactionBoundary(const rocksdb::Slice& user_key) const override;
+
+  // Garbage counted by DocDBTablePropertiesCollector is collectable when history cutoff has passed
+  // all hybrid times of the file.
+  bool IsGarbageCollectable(const rocksdb::FileBoundaryValuesBase& largest) const override;
+
   const char* Name() const override;
 
+  // Sets the RocksDB this factory creates compaction filters for, after it is opened. Counter
+  // deltas are not folded by compactions until the RocksDB is set.
+  void SetDB(rocksdb::DB* db) { db_.store(db, std::memory_order_release); }
+
  private:
   std::shared_ptr<HistoryRetentionPolicy> retention_policy_;
+  std::atomic<rocksdb::DB*> db_{nullptr};
+};
+
+// Counts entries of a regular DocDB SST file that are older versions of the preceding entry, i.e.
+// the same SubDocKey with a lower hybrid time, and stores the count as
+// rocksdb::kGarbageKeysPropertyName. Such entries are removed by DocDBCompactionFilter once
+// history cutoff passes the hybrid time of the newer version, even when the file is compacted
+// alone.
+class DocDBTablePropertiesCollector : public rocksdb::TablePropertiesCollector {
+ public:
+  rocksdb::Status AddUserKey(const rocksdb::Slice& key, const rocksdb::Slice& value,
+                             rocksdb::EntryType type, rocksdb::SequenceNumber seq,
+                             uint64_t file_size) override;
+
+  rocksdb::Status Finish(rocksdb::UserCollectedProperties* properties) override;
+
+  rocksdb::UserCollectedProperties GetReadableProperties() const override;
+
+  const char* Name() const override;
+
+ private:
+  // Previous key without hybrid time.
+  std::string prev_key_;
+  uint64_t garbage_entries_ = 0;
+};
+
+class DocDBTablePropertiesCollectorFactory : public rocksdb::TablePropertiesCollectorFactory {
+ public:
+  rocksdb::TablePropertiesCollector* CreateTablePropertiesCollector(
+      rocksdb::TablePropertiesCollectorFactory::Context context) override;
+
+  const char* Name() const override;
 };
 
 }  // namespace docdb
@@ -17,13 +17,20 @@
 
 #include "yb/common/transaction.h"
 
+#include "yb/rocksdb/db/compaction.h"
+#include "yb/rocksdb/memtablerep.h"
 #include "yb/rocksdb/rate_limiter.h"
+#include "yb/rocksdb/slice_transform.h"
 #include "yb/rocksdb/table.h"
+#include "yb/rocksdb/table/block_based_table_factory.h"
+#include "yb/rocksdb/util/compression.h"
 
 #include "yb/docdb/intent_aware_iterator.h"
+#include "yb/gutil/walltime.h"
 #include "yb/rocksutil/yb_rocksdb.h"
 #include "yb/rocksutil/yb_rocksdb_logger.h"
 #include "yb/server/hybrid_clock.h"
+#include "yb/util/logging.h"
 #include "yb/util/size_literals.h"
 #include "yb/util/trace.h"
 
@@ -48,12 +55,53 @@ DEFINE_int32(rocksdb_universal_compaction_size_ratio, 20,
              "The percentage upto which files that are larger are include in a compaction.");
 DEFINE_int32(rocksdb_universal_compaction_min_merge_width, 4,
              "The minimum number of files in a single compaction run.");
+DEFINE_double(rocksdb_universal_compaction_garbage_ratio, 0,
+              "If positive, an SST file in which at least this fraction of entries are overwritten "
+              "history is compacted alone once history cutoff passes it, even when size ratios do "
+              "not trigger a compaction.");
+DEFINE_int32(rocksdb_universal_compaction_compression_size_percent, -1,
+             "If non-negative, compaction outputs are compressed only when the files older than "
+             "them take at least this percentage of the total size, so recently written data, "
+             "which is most likely to be compacted again, stays uncompressed. -1 - always "
+             "compress.");
+DEFINE_string(rocksdb_compression_type, "snappy",
+              "Compression of SST data blocks: none, snappy, zlib, lz4, lz4hc or zstd. Falls back "
+              "to snappy when the requested compression is not supported by this build.");
+DEFINE_int32(rocksdb_compression_dict_bytes, 0,
+             "If positive, a dictionary of up to this size is built per SST file from its data "
+             "blocks and shared by all of them, which lets small blocks compress as well as large "
+             "ones. Supported with zlib, lz4, lz4hc and zstd.");
+DEFINE_int32(rocksdb_compression_dict_train_bytes, 0,
+             "Size of data blocks sampled to build the compression dictionary of an SST file. "
+             "0 - 100 times --rocksdb_compression_dict_bytes.");
 DEFINE_int64(rocksdb_compact_flush_rate_limit_bytes_per_sec, 100 * 1024 * 1024,
              "Use to control write rate of flush and compaction.");
+DEFINE_bool(rocksdb_compact_flush_rate_limit_shared, false,
+            "Apply --rocksdb_compact_flush_rate_limit_bytes_per_sec to the flushes and compactions "
+            "of all tablets of a tablet server together instead of to each tablet.");
 DEFINE_uint64(rocksdb_compaction_size_threshold_bytes, 2ULL * 1024 * 1024 * 1024,
              "Threshold beyond which compaction is considered large.");
 DEFINE_uint64(rocksdb_max_file_size_for_compaction, 0,
              "Maximal allowed file size to participate in RocksDB compaction. 0 - unlimited.");
+DEFINE_int32(rocksdb_max_subcompactions, 1,
+             "Maximal number of key ranges a single RocksDB compaction is split into. Each range "
+             "is compacted by its own thread. 1 - compactions are not split.");
+
+DEFINE_bool(rocksdb_allow_concurrent_memtable_write, true,
+            "Allow writers of RocksDB write group to insert into memtable in parallel.");
+DEFINE_bool(rocksdb_enable_pipelined_write, false,
+            "Let the next RocksDB write group form while memtable inserts of the previous one are "
+            "still running. Requires rocksdb_allow_concurrent_memtable_write.");
+DEFINE_uint64(rocksdb_iterator_pool_size, 0,
+              "Number of RocksDB iterators kept by every tablet DB for reuse by reads without bloom "
+              "and file filters, until the next flush or compaction. 0 disables pooling.");
+DEFINE_bool(rocksdb_enable_write_thread_adaptive_yield, false,
+            "Let RocksDB writers spin for a short time waiting for the write group leader, "
+            "before blocking on a mutex.");
+
+DEFINE_int32(hash_indexed_memtable_buckets, 64 * 1024,
+             "Number of hash buckets in hash indexed memtables, used by tables with point reads "
+             "only.");
 
 DEFINE_int64(db_block_size_bytes, 32_KB,
              "Size of RocksDB data block (in bytes).");
@@ -69,9 +117,20 @@ DEFINE_int64(db_min_keys_per_index_block, 100,
 
 DEFINE_int64(db_write_buffer_size, -1,
              "Size of RocksDB write buffer (in bytes). -1 to use default.");
-
+DEFINE_uint64(rocksdb_memtable_huge_page_size, 0,
+              "If positive, memtable arena blocks are allocated from huge pages of this size, for "
+              "instance 2097152. Huge pages should be reserved with vm.nr_hugepages, regular "
+              "pages are used when they are not available.");
+
+DEFINE_bool(use_hybrid_time_file_filter, true,
+            "Whether reads at a hybrid time should skip SST files that only contain records "
+            "written after the read time limit.");
 DEFINE_bool(use_docdb_aware_bloom_filter, true,
             "Whether to use the DocDbAwareFilterPolicy for both bloom storage and seeks.");
+DEFINE_bool(use_docdb_ribbon_filter, false,
+            "Whether to build DocDB filter blocks as ribbon filters instead of bloom filters. "
+            "Ribbon filter fits more keys into the filter block of the same size with lower false "
+            "positive rate, at the cost of slower SST file building.");
 DEFINE_int32(max_nexts_to_avoid_seek, 1,
              "The number of next calls to try before doing resorting to do a rocksdb seek.");
 DEFINE_bool(trace_docdb_calls, false, "Whether we should trace calls into the docdb.");
@@ -80,6 +139,20 @@ DEFINE_bool(trace_docdb_calls, false, "Whether we should trace calls into the do
 // explicitly.
 DEFINE_bool(use_multi_level_index, false, "Whether to use multi-level data index.");
 
+DEFINE_bool(use_docdb_aware_delta_encoding, true,
+            "Whether to encode keys in data blocks of new SST files relative to both prefix and "
+            "suffix of the previous key, so the repeated DocKey, hybrid time and sequence number "
+            "are not stored for every subkey. Existing files are readable regardless of this "
+            "flag, but files written with it enabled could not be read by older versions.");
+
+DEFINE_bool(cache_index_and_filter_blocks_with_high_priority, true,
+            "Whether index and filter blocks are inserted directly into the multi touch part of "
+            "the block cache, so they are not evicted by scans.");
+
+DEFINE_bool(low_priority_reads_fill_block_cache, true,
+            "Whether blocks read by low priority reads, like full table scans, are added to the "
+            "block cache. Such blocks are added with low priority and are evicted first.");
+
 DEFINE_uint64(initial_seqno, 1ULL << 50, "Initial seqno for new RocksDB instances.");
 
 using std::shared_ptr;
@@ -188,7 +261,11 @@ void SeekForward(const KeyBytes& key_bytes, rocksdb::Iterator *iter) {
 }
 
 void SeekPastSubKey(const SubDocKey& sub_doc_key, rocksdb::Iterator* iter) {
-  KeyBytes key_bytes = sub_doc_key.Encode(/* include_hybrid_time */ false);
+  SeekPastSubKey(sub_doc_key.Encode(/* include_hybrid_time */ false).AsSlice(), iter);
+}
+
+void SeekPastSubKey(const rocksdb::Slice& key, rocksdb::Iterator* iter) {
+  KeyBytes key_bytes(key);
   AppendDocHybridTime(DocHybridTime::kMin, &key_bytes);
   SeekForward(key_bytes, iter);
 }
@@ -291,8 +368,45 @@ void PerformRocksDBReverseSeek(
   }
 }
 
+rocksdb::UserBoundaryTag TagForDocHybridTime();
+Status GetDocHybridTime(const rocksdb::UserBoundaryValues& values, DocHybridTime* out);
+
 namespace {
 
+// Excludes SST files whose smallest DocHybridTime is above the read time limit, i.e. files that
+// have no records visible at this read time. Records above the global limit are never looked at by
+// IntentAwareIterator, so such files cannot affect read restarts either. Files that pass are
+// checked by the wrapped filter, if any.
+class HybridTimeFileFilter : public rocksdb::ReadFileFilter {
+ public:
+  HybridTimeFileFilter(HybridTime limit, std::shared_ptr<rocksdb::ReadFileFilter> next)
+      : limit_(limit), next_(std::move(next)) {}
+
+  bool Filter(const rocksdb::FdWithBoundaries& file) const override {
+    const auto* smallest = file.smallest.user_value_with_tag(TagForDocHybridTime());
+    if (smallest) {
+      DocHybridTime smallest_ht;
+      if (smallest_ht.FullyDecodeFrom(*smallest).ok() && smallest_ht.hybrid_time() > limit_) {
+        return false;
+      }
+    }
+    return !next_ || next_->Filter(file);
+  }
+
+ private:
+  HybridTime limit_;
+  std::shared_ptr<rocksdb::ReadFileFilter> next_;
+};
+
+std::shared_ptr<rocksdb::ReadFileFilter> AddHybridTimeFileFilter(
+    const ReadHybridTime& read_time, std::shared_ptr<rocksdb::ReadFileFilter> file_filter) {
+  if (!FLAGS_use_hybrid_time_file_filter || !read_time.global_limit.is_valid() ||
+      read_time.global_limit == HybridTime::kMax) {
+    return file_filter;
+  }
+  return std::make_shared<HybridTimeFileFilter>(read_time.global_limit, std::move(file_filter));
+}
+
 rocksdb::ReadOptions PrepareReadOptions(
     rocksdb::DB* rocksdb,
     BloomFilterMode bloom_filter_mode,
@@ -301,6 +415,12 @@ rocksdb::ReadOptions PrepareReadOptions(
     std::shared_ptr<rocksdb::ReadFileFilter> file_filter) {
   rocksdb::ReadOptions read_opts;
   read_opts.query_id = query_id;
+  if (query_id == rocksdb::kLowPriorityQueryId) {
+    read_opts.fill_cache = FLAGS_low_priority_reads_fill_block_cache;
+  }
+  // Iterator that uses bloom filter does not leave keys with the same hashed components, so it
+  // could use hash index of memtable.
+  read_opts.prefix_same_as_start = bloom_filter_mode == BloomFilterMode::USE_BLOOM_FILTER;
   if (FLAGS_use_docdb_aware_bloom_filter &&
     bloom_filter_mode == BloomFilterMode::USE_BLOOM_FILTER) {
     DCHECK(user_key_for_filter);
@@ -332,15 +452,69 @@ unique_ptr<IntentAwareIterator> CreateIntentAwareIterator(
     const ReadHybridTime& read_time,
     std::shared_ptr<rocksdb::ReadFileFilter> file_filter) {
   rocksdb::ReadOptions read_opts = PrepareReadOptions(rocksdb, bloom_filter_mode,
-      user_key_for_filter, query_id, std::move(file_filter));
+      user_key_for_filter, query_id, AddHybridTimeFileFilter(read_time, std::move(file_filter)));
   return std::make_unique<IntentAwareIterator>(
       rocksdb, read_opts, read_time, txn_op_context);
 }
 
+unique_ptr<IntentAwareIterator> CreateIntentAwareIteratorForKeys(
+    rocksdb::DB* rocksdb,
+    const std::vector<Slice>& user_keys_for_filter,
+    const rocksdb::QueryId query_id,
+    const TransactionOperationContextOpt& txn_op_context,
+    const ReadHybridTime& read_time) {
+  rocksdb::ReadOptions read_opts = PrepareReadOptions(rocksdb,
+      BloomFilterMode::DONT_USE_BLOOM_FILTER, boost::none, query_id,
+      AddHybridTimeFileFilter(read_time, nullptr /* file_filter */));
+  if (FLAGS_use_docdb_aware_bloom_filter) {
+    read_opts.table_aware_file_filter = rocksdb->GetOptions().table_factory->
+        NewTableAwareReadFileFilter(read_opts, user_keys_for_filter);
+  }
+  return std::make_unique<IntentAwareIterator>(
+      rocksdb, read_opts, read_time, txn_op_context);
+}
+
+namespace {
+
+rocksdb::CompressionType CompressionTypeFromFlag() {
+  static const std::pair<const char*, rocksdb::CompressionType> kCompressionTypes[] = {
+      {"none", rocksdb::kNoCompression},
+      {"snappy", rocksdb::kSnappyCompression},
+      {"zlib", rocksdb::kZlibCompression},
+      {"lz4", rocksdb::kLZ4Compression},
+      {"lz4hc", rocksdb::kLZ4HCCompression},
+      {"zstd", rocksdb::kZSTDNotFinalCompression},
+  };
+  for (const auto& entry : kCompressionTypes) {
+    if (FLAGS_rocksdb_compression_type == entry.first) {
+      if (rocksdb::CompressionTypeSupported(entry.second)) {
+        return entry.second;
+      }
+      break;
+    }
+  }
+  YB_LOG_EVERY_N_SECS(WARNING, 60)
+      << "Unsupported --rocksdb_compression_type: " << FLAGS_rocksdb_compression_type
+      << ", using snappy";
+  return rocksdb::kSnappyCompression;
+}
+
+} // namespace
+
+std::shared_ptr<rocksdb::RateLimiter> CreateSharedRocksDBRateLimiter() {
+  if (!FLAGS_rocksdb_compact_flush_rate_limit_shared ||
+      FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec <= 0) {
+    return nullptr;
+  }
+  return std::shared_ptr<rocksdb::RateLimiter>(
+      rocksdb::NewGenericRateLimiter(FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec));
+}
+
 void InitRocksDBOptions(
     rocksdb::Options* options, const string& tablet_id,
     const shared_ptr<rocksdb::Statistics>& statistics,
-    const tablet::TabletOptions& tablet_options) {
+    const tablet::TabletOptions& tablet_options,
+    size_t bloom_filter_range_components) {
   options->create_if_missing = true;
   options->disableDataSync = true;
   options->statistics = statistics;
@@ -352,6 +526,7 @@ void InitRocksDBOptions(
   if (FLAGS_db_write_buffer_size != -1) {
     options->write_buffer_size = FLAGS_db_write_buffer_size;
   }
+  options->memtable_huge_page_size = FLAGS_rocksdb_memtable_huge_page_size;
   options->listeners.insert(
       options->listeners.end(), tablet_options.listeners.begin(),
       tablet_options.listeners.end()); // Append listeners
@@ -360,8 +535,11 @@ void InitRocksDBOptions(
   rocksdb::BlockBasedTableOptions table_options;
   if (tablet_options.block_cache) {
     table_options.block_cache = tablet_options.block_cache;
+    table_options.secondary_block_cache = tablet_options.secondary_block_cache;
     // Cache the bloom filters in the block cache.
     table_options.cache_index_and_filter_blocks = true;
+    table_options.cache_index_and_filter_blocks_with_high_priority =
+        FLAGS_cache_index_and_filter_blocks_with_high_priority;
   } else {
     table_options.no_block_cache = true;
     table_options.cache_index_and_filter_blocks = false;
@@ -374,7 +552,10 @@ void InitRocksDBOptions(
   // Set our custom bloom filter that is docdb aware.
   if (FLAGS_use_docdb_aware_bloom_filter) {
     table_options.filter_policy.reset(new DocDbAwareFilterPolicy(
-        table_options.filter_block_size * 8, options->info_log.get()));
+        table_options.filter_block_size * 8, options->info_log.get(),
+        bloom_filter_range_components,
+        FLAGS_use_docdb_ribbon_filter ? rocksdb::FilterBitsFormat::kRibbon
+                                      : rocksdb::FilterBitsFormat::kBloom));
   }
 
   if (FLAGS_use_multi_level_index) {
@@ -383,8 +564,18 @@ void InitRocksDBOptions(
     table_options.index_type = rocksdb::IndexType::kBinarySearch;
   }
 
+  if (FLAGS_use_docdb_aware_delta_encoding) {
+    table_options.data_block_key_value_encoding_format =
+        rocksdb::KeyValueEncodingFormat::kKeyDeltaEncodingThreeSharedParts;
+  }
+
   options->table_factory.reset(rocksdb::NewBlockBasedTableFactory(table_options));
 
+  options->compression = CompressionTypeFromFlag();
+  options->compression_opts.max_dict_bytes = std::max(FLAGS_rocksdb_compression_dict_bytes, 0);
+  options->compression_opts.max_train_bytes =
+      std::max(FLAGS_rocksdb_compression_dict_train_bytes, 0);
+
   // Compaction related options.
 
   // Enable universal style compactions.
@@ -395,6 +586,13 @@ void InitRocksDBOptions(
   // Set the number of levels to 1.
   options->num_levels = 1;
 
+  // DocDB write batches contain only puts and deletes, so they could be inserted into skiplist
+  // memtable concurrently.
+  options->allow_concurrent_memtable_write = FLAGS_rocksdb_allow_concurrent_memtable_write;
+  options->enable_write_thread_adaptive_yield = FLAGS_rocksdb_enable_write_thread_adaptive_yield;
+  options->enable_pipelined_write = FLAGS_rocksdb_enable_pipelined_write;
+  options->iterator_pool_size = FLAGS_rocksdb_iterator_pool_size;
+
   if (compactions_enabled) {
     options->base_background_compactions = FLAGS_rocksdb_base_background_compactions;
     options->max_background_compactions = FLAGS_rocksdb_max_background_compactions;
@@ -410,8 +608,15 @@ void InitRocksDBOptions(
         FLAGS_rocksdb_universal_compaction_size_ratio;
     options->compaction_options_universal.min_merge_width =
         FLAGS_rocksdb_universal_compaction_min_merge_width;
+    options->compaction_options_universal.garbage_ratio_threshold =
+        FLAGS_rocksdb_universal_compaction_garbage_ratio;
+    options->compaction_options_universal.compression_size_percent =
+        FLAGS_rocksdb_universal_compaction_compression_size_percent;
     options->compaction_size_threshold_bytes = FLAGS_rocksdb_compaction_size_threshold_bytes;
-    if (FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec > 0) {
+    options->max_subcompactions = std::max(FLAGS_rocksdb_max_subcompactions, 1);
+    if (tablet_options.rate_limiter) {
+      options->rate_limiter = tablet_options.rate_limiter;
+    } else if (FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec > 0) {
       options->rate_limiter.reset(
           rocksdb::NewGenericRateLimiter(FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec));
     }
@@ -423,5 +628,57 @@ void InitRocksDBOptions(
   }
 }
 
+namespace {
+
+// Extracts the hashed part of DocKey, keys that are not DocDB keys are hashed as a whole.
+class DocKeyHashedPartExtractor : public rocksdb::SliceTransform {
+ public:
+  const char* Name() const override { return "DocKeyHashedPartExtractor"; }
+
+  Slice Transform(const Slice& key) const override {
+    auto size = DocKey::EncodedSize(key, DocKeyPart::HASHED_PART_ONLY);
+    return size.ok() ? Slice(key.data(), *size) : key;
+  }
+
+  bool InDomain(const Slice& key) const override { return true; }
+
+  bool InRange(const Slice& prefix) const override { return true; }
+};
+
+} // namespace
+
+void UseHashIndexedMemTable(rocksdb::Options* options) {
+  options->memtable_factory.reset(rocksdb::NewHashSkipListRepFactory(
+      std::make_shared<DocKeyHashedPartExtractor>(), FLAGS_hash_indexed_memtable_buckets));
+  // Hash indexed memtable does not support concurrent inserts.
+  options->allow_concurrent_memtable_write = false;
+  options->enable_write_thread_adaptive_yield = false;
+}
+
+void ExcludeHistoryFromCompaction(rocksdb::Options* options, MonoDelta history_age) {
+  const MicrosTime history_age_us = history_age.ToMicroseconds();
+  options->exclude_file_from_compaction =
+      std::make_shared<std::function<bool(const rocksdb::FileMetaData&)>>(
+          [history_age_us](const rocksdb::FileMetaData& file) {
+            DocHybridTime largest;
+            if (!GetDocHybridTime(file.largest.user_values, &largest).ok()) {
+              return false;
+            }
+            return largest.hybrid_time().GetPhysicalValueMicros() + history_age_us <
+                   GetCurrentTimeMicros();
+          });
+}
+
+size_t BloomFilterRangeComponents(rocksdb::DB* rocksdb) {
+  auto table_factory = dynamic_cast<rocksdb::BlockBasedTableFactory*>(
+      rocksdb->GetOptions().table_factory.get());
+  if (!table_factory) {
+    return 0;
+  }
+  auto filter_policy = dynamic_cast<const DocDbAwareFilterPolicy*>(
+      table_factory->table_options().filter_policy.get());
+  return filter_policy ? filter_policy->num_range_components() : 0;
+}
+
 }  // namespace docdb
 }  // namespace yb
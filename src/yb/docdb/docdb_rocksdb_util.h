@@ -60,6 +60,10 @@ void SeekForward(const KeyBytes& key_bytes, rocksdb::Iterator *iter);
 // enough, does not perform a seek.
 void SeekPastSubKey(const SubDocKey& sub_doc_key, rocksdb::Iterator* iter);
 
+// The same as above, but takes an already encoded subdoc key without hybrid time, so the caller
+// does not have to decode and re-encode keys it has just read from the iterator.
+void SeekPastSubKey(const rocksdb::Slice& key, rocksdb::Iterator* iter);
+
 // A wrapper around the RocksDB seek operation that uses Next() up to the configured number of
 // times to avoid invalidating iterator state. In debug mode it also allows printing detailed
 // information about RocksDB seeks.
@@ -99,6 +103,9 @@ enum class BloomFilterMode {
 // Note: bloom_filter_mode should be specified explicitly to avoid using it incorrectly by default.
 // user_key_for_filter is used with BloomFilterMode::USE_BLOOM_FILTER to exclude SST files which
 // have the same hashed components as (Sub)DocKey encoded in user_key_for_filter.
+// query_id == rocksdb::kLowPriorityQueryId marks low priority reads, like full table scans, whose
+// blocks are added to the block cache with low priority, or not added at all depending on
+// --low_priority_reads_fill_block_cache.
 std::unique_ptr<rocksdb::Iterator> CreateRocksDBIterator(
     rocksdb::DB* rocksdb,
     BloomFilterMode bloom_filter_mode,
@@ -117,13 +124,47 @@ std::unique_ptr<IntentAwareIterator> CreateIntentAwareIterator(
     const ReadHybridTime& read_time,
     std::shared_ptr<rocksdb::ReadFileFilter> file_filter = nullptr);
 
+// Creates an iterator shared by a batch of point reads of (Sub)DocKeys with different hashed
+// components, e.g. the keys of a Redis MGET, which should be read in key order. Bloom filters
+// exclude SST files that have none of the hashed components of user_keys_for_filter, and the
+// iterator is not restricted to the hashed components of one key.
+std::unique_ptr<IntentAwareIterator> CreateIntentAwareIteratorForKeys(
+    rocksdb::DB* rocksdb,
+    const std::vector<Slice>& user_keys_for_filter,
+    const rocksdb::QueryId query_id,
+    const TransactionOperationContextOpt& transaction_context,
+    const ReadHybridTime& read_time);
+
+// Returns the rate limiter of flushes and compactions to share between all tablets of a tablet
+// server, or nullptr if each tablet should have its own one.
+std::shared_ptr<rocksdb::RateLimiter> CreateSharedRocksDBRateLimiter();
+
 // Initialize the RocksDB 'options' object for tablet identified by 'tablet_id'. The 'statistics'
 // object provided by the caller will be used by RocksDB to maintain the stats for the tablet
 // specified by 'tablet_id'.
+// 'bloom_filter_range_components' is the number of range components of the key, that are taken
+// into account by the bloom filter in addition to hashed components.
 void InitRocksDBOptions(
     rocksdb::Options* options, const std::string& tablet_id,
     const std::shared_ptr<rocksdb::Statistics>& statistics,
-    const tablet::TabletOptions& tablet_options);
+    const tablet::TabletOptions& tablet_options,
+    size_t bloom_filter_range_components = 0);
+
+// Makes memtables of RocksDB with specified options hash indexed by the hashed part of DocKey.
+// Iterators that use bloom filter seek memtable by hash, while flush and other iterators use the
+// ordered copy of memtable, that is built for each such iterator. So it is suitable only for tables
+// that are accessed by point reads, e.g. Redis tables.
+void UseHashIndexedMemTable(rocksdb::Options* options);
+
+// Leaves SST files whose newest record is older than history_age out of automatic compactions, so
+// immutable history of append-only workloads (e.g. Redis time series) is not rewritten over and
+// over. Such files are still compacted by manual (full) compactions.
+void ExcludeHistoryFromCompaction(rocksdb::Options* options, MonoDelta history_age);
+
+// Returns the number of range components taken into account by the bloom filter of the specified
+// RocksDB instance, i.e. iterator that uses bloom filter should not leave the range of keys that
+// have the same hashed components and this number of first range components.
+size_t BloomFilterRangeComponents(rocksdb::DB* rocksdb);
 
 }  // namespace docdb
 }  // namespace yb
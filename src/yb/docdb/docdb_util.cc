@@ -78,6 +78,11 @@ Status DocDBRocksDBUtil::OpenRocksDB() {
   RETURN_NOT_OK(rocksdb::DB::Open(rocksdb_options_, rocksdb_dir_, &rocksdb));
   LOG(INFO) << "Opened RocksDB at " << rocksdb_dir_;
   rocksdb_.reset(rocksdb);
+  auto* filter_factory = dynamic_cast<DocDBCompactionFilterFactory*>(
+      rocksdb_options_.compaction_filter_factory.get());
+  if (filter_factory != nullptr) {
+    filter_factory->SetDB(rocksdb);
+  }
   return Status::OK();
 }
 
@@ -102,14 +107,13 @@ Status DocDBRocksDBUtil::PopulateRocksDBWriteBatch(
     HybridTime hybrid_time,
     bool decode_dockey,
     bool increment_write_id) const {
-  for (const auto& entry : dwb.key_value_pairs()) {
-    if (decode_dockey) {
-      SubDocKey subdoc_key;
-      // We don't expect any invalid encoded keys in the write batch. However, these encoded keys
-      // don't contain the HybridTime.
-      RETURN_NOT_OK_PREPEND(subdoc_key.FullyDecodeFromKeyWithOptionalHybridTime(entry.first),
-          Substitute("when decoding key: $0", FormatBytesAsStr(entry.first)));
-    }
+  for (size_t i = 0; decode_dockey && i != dwb.size(); ++i) {
+    const Slice key = dwb.key_value_pair(i).first;
+    SubDocKey subdoc_key;
+    // We don't expect any invalid encoded keys in the write batch. However, these encoded keys
+    // don't contain the HybridTime.
+    RETURN_NOT_OK_PREPEND(subdoc_key.FullyDecodeFromKeyWithOptionalHybridTime(key),
+        Substitute("when decoding key: $0", FormatBytesAsStr(key.ToBuffer())));
   }
 
   if (current_txn_id_.is_initialized()) {
@@ -125,19 +129,18 @@ Status DocDBRocksDBUtil::PopulateRocksDBWriteBatch(
     // TODO: this block has common code with docdb::PrepareNonTransactionWriteBatch and probably
     // can be refactored, so common code is reused.
     IntraTxnWriteId write_id = 0;
-    for (const auto& entry : dwb.key_value_pairs()) {
-      string rocksdb_key;
+    for (size_t i = 0; i != dwb.size(); ++i) {
+      const auto entry = dwb.key_value_pair(i);
+      // Key is written directly from the batch buffer, without building an intermediate string.
+      KeyBytes encoded_ht;
       if (hybrid_time.is_valid()) {
         // HybridTime provided. Append a PrimitiveValue with the HybridTime to the key.
-        const KeyBytes encoded_ht =
-            PrimitiveValue(DocHybridTime(hybrid_time, write_id)).ToKeyBytes();
-        rocksdb_key = entry.first + encoded_ht.data();
-      } else {
-        // Useful when printing out a write batch that does not yet know the HybridTime it will be
-        // committed with.
-        rocksdb_key = entry.first;
+        encoded_ht = PrimitiveValue(DocHybridTime(hybrid_time, write_id)).ToKeyBytes();
       }
-      rocksdb_write_batch->Put(rocksdb_key, entry.second);
+      // Without HybridTime the key is written as is. Useful when printing out a write batch that
+      // does not yet know the HybridTime it will be committed with.
+      std::array<Slice, 2> key_parts = {{ entry.first, encoded_ht.AsSlice() }};
+      rocksdb_write_batch->Put(key_parts, { &entry.second, 1 });
       if (increment_write_id) {
         ++write_id;
       }
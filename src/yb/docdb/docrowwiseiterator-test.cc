@@ -14,6 +14,7 @@
 #include <memory>
 #include <string>
 
+#include "yb/docdb/doc_ql_scanspec.h"
 #include "yb/docdb/doc_rowwise_iterator.h"
 #include "yb/docdb/docdb.h"
 #include "yb/docdb/docdb_test_base.h"
@@ -26,6 +27,8 @@
 #include "yb/util/test_macros.h"
 #include "yb/util/test_util.h"
 
+DECLARE_int32(docdb_reverse_scan_max_prev_steps);
+
 namespace yb {
 namespace docdb {
 
@@ -888,5 +891,50 @@ SubDocKey(DocKey([], ["row2", 22222]), [ColumnId(50); HT{ physical: 2000 }]) ->
   }
 }
 
+TEST_F(DocRowwiseIteratorTest, DocRowwiseIteratorReverseScan) {
+  constexpr int kNumRows = 5;
+  for (int i = 1; i <= kNumRows; ++i) {
+    const auto row = Format("row$0", i);
+    const KeyBytes encoded_doc_key = DocKey(PrimitiveValues(row, i)).Encode();
+    ASSERT_OK(SetPrimitive(
+        DocPath(encoded_doc_key, PrimitiveValue(30_ColId)),
+        PrimitiveValue(row + "_c"), HybridTime::FromMicros(1000)));
+    ASSERT_OK(SetPrimitive(
+        DocPath(encoded_doc_key, PrimitiveValue(40_ColId)),
+        PrimitiveValue(i), HybridTime::FromMicros(1000)));
+  }
+  // The first entry of row3 is after the read time, so the scan should not return to row3 after
+  // stepping back from it.
+  ASSERT_OK(SetPrimitive(
+      DocPath(DocKey(PrimitiveValues("row3", 3)).Encode(), PrimitiveValue(30_ColId)),
+      PrimitiveValue("row3_c_prime"), HybridTime::FromMicros(5000)));
+
+  const Schema &schema = kSchemaForIteratorTests;
+  const Schema &projection = kProjectionForIteratorTests;
+  // 0 steps makes every move to the previous row fall back to seek.
+  for (int max_prev_steps : {0, 1, 16}) {
+    FLAGS_docdb_reverse_scan_max_prev_steps = max_prev_steps;
+    DocRowwiseIterator iter(
+        projection, schema, kNonTransactionalOperationContext, rocksdb(),
+        ReadHybridTime::FromMicros(3000));
+    DocQLScanSpec spec(schema, DocKey(), rocksdb::kDefaultQueryId, false /* is_forward_scan */);
+    ASSERT_OK(iter.Init(spec));
+
+    QLTableRow row;
+    QLValue value;
+    for (int i = kNumRows; i >= 1; --i) {
+      ASSERT_TRUE(iter.HasNext());
+      ASSERT_OK(iter.NextRow(&row));
+
+      ASSERT_OK(row.GetValue(projection.column_id(0), &value));
+      ASSERT_EQ(Format("row$0_c", i), value.string_value());
+
+      ASSERT_OK(row.GetValue(projection.column_id(1), &value));
+      ASSERT_EQ(i, value.int64_value());
+    }
+    ASSERT_FALSE(iter.HasNext());
+  }
+}
+
 }  // namespace docdb
 }  // namespace yb
@@ -21,17 +21,30 @@
 #include "yb/common/hybrid_time.h"
 #include "yb/common/transaction.h"
 
+#include "yb/docdb/blob_storage.h"
 #include "yb/docdb/conflict_resolution.h"
 #include "yb/docdb/docdb_rocksdb_util.h"
 #include "yb/docdb/docdb-internal.h"
 #include "yb/docdb/intent.h"
 #include "yb/docdb/value.h"
 
+#include "yb/util/flag_tags.h"
+
 using namespace std::literals;
 
 DEFINE_bool(transaction_allow_rerequest_status_in_tests, true,
             "Allow rerequest transaction status when try again is received.");
 
+DEFINE_int32(transaction_status_prefetch_window, 64,
+             "Max number of intents scanned ahead of the current one, to collect transactions "
+             "whose statuses are requested in the same batch. 0 disables batching.");
+
+DEFINE_int32(docdb_reverse_scan_max_prev_steps, 16,
+             "Max number of entries a reverse scan steps back over to reach the previous row, "
+             "before falling back to seeking to it.");
+TAG_FLAG(docdb_reverse_scan_max_prev_steps, advanced);
+TAG_FLAG(docdb_reverse_scan_max_prev_steps, runtime);
+
 namespace yb {
 namespace docdb {
 
@@ -67,6 +80,19 @@ Result<HybridTime> TransactionStatusCache::GetCommitTime(const TransactionId& tr
     return it->second;
   }
 
+  if (prefetch_candidates_provider_) {
+    std::vector<TransactionId> transaction_ids;
+    prefetch_candidates_provider_(transaction_id, &transaction_ids);
+    if (!transaction_ids.empty()) {
+      transaction_ids.push_back(transaction_id);
+      PrefetchCommitTimes(transaction_ids);
+      it = cache_.find(transaction_id);
+      if (it != cache_.end()) {
+        return it->second;
+      }
+    }
+  }
+
   auto result = DoGetCommitTime(transaction_id);
   if (result.ok()) {
     cache_.emplace(transaction_id, *result);
@@ -107,6 +133,61 @@ Result<HybridTime> TransactionStatusCache::DoGetCommitTime(const TransactionId&
     // Temporary workaround is to sleep for 0.05s and re-request.
     std::this_thread::sleep_for(50ms);
   }
+  return CommitTimeFromStatus(transaction_id, txn_status);
+}
+
+void TransactionStatusCache::PrefetchCommitTimes(
+    const std::vector<TransactionId>& transaction_ids) {
+  struct PendingRequest {
+    const TransactionId* transaction_id;
+    std::promise<Result<TransactionStatusResult>> promise;
+  };
+
+  std::vector<PendingRequest> pending;
+  pending.reserve(transaction_ids.size());
+  for (const auto& transaction_id : transaction_ids) {
+    if (IsCached(transaction_id)) {
+      continue;
+    }
+    HybridTime local_commit_time = GetLocalCommitTime(transaction_id);
+    if (local_commit_time.is_valid()) {
+      cache_.emplace(transaction_id, local_commit_time);
+      continue;
+    }
+    // Set the placeholder, so duplicate ids are requested only once. It is replaced or removed
+    // below, when the response is received.
+    cache_.emplace(transaction_id, HybridTime::kInvalid);
+    pending.push_back(PendingRequest{&transaction_id, {}});
+  }
+
+  // pending is not resized anymore, so it is safe to reference its elements from callbacks.
+  std::vector<std::future<Result<TransactionStatusResult>>> futures;
+  futures.reserve(pending.size());
+  for (auto& request : pending) {
+    futures.push_back(request.promise.get_future());
+    auto* promise = &request.promise;
+    txn_status_manager_->RequestStatusAt(
+        {request.transaction_id, read_time_.read, read_time_.global_limit, read_time_.serial_no,
+         [promise](Result<TransactionStatusResult> result) {
+           promise->set_value(std::move(result));
+         }});
+  }
+
+  for (size_t i = 0; i != pending.size(); ++i) {
+    const auto& transaction_id = *pending[i].transaction_id;
+    auto txn_status_result = futures[i].get();
+    if (txn_status_result.ok()) {
+      cache_[transaction_id] = CommitTimeFromStatus(transaction_id, *txn_status_result);
+    } else {
+      VLOG(4) << "Failed to prefetch transaction " << yb::ToString(transaction_id) << " status: "
+              << txn_status_result.status();
+      cache_.erase(transaction_id);
+    }
+  }
+}
+
+HybridTime TransactionStatusCache::CommitTimeFromStatus(
+    const TransactionId& transaction_id, const TransactionStatusResult& txn_status) {
   VLOG(4) << "Transaction_id " << transaction_id << " at " << read_time_
           << ": status: " << TransactionStatus_Name(txn_status.status)
           << ", status_time: " << txn_status.status_time;
@@ -114,7 +195,7 @@ Result<HybridTime> TransactionStatusCache::DoGetCommitTime(const TransactionId&
   // GetLocalCommitTime, in this case coordinator does not know transaction and will respond
   // with ABORTED status. So we recheck whether it was committed locally.
   if (txn_status.status == TransactionStatus::ABORTED) {
-    local_commit_time = GetLocalCommitTime(transaction_id);
+    HybridTime local_commit_time = GetLocalCommitTime(transaction_id);
     return local_commit_time.is_valid() ? local_commit_time : HybridTime::kMin;
   } else {
     return txn_status.status == TransactionStatus::COMMITTED ? txn_status.status_time
@@ -207,19 +288,27 @@ IntentAwareIterator::IntentAwareIterator(
     const rocksdb::ReadOptions& read_opts,
     const ReadHybridTime& read_time,
     const TransactionOperationContextOpt& txn_op_context)
-    : read_time_(read_time),
+    : intents_db_(txn_op_context && txn_op_context->intents_db ? txn_op_context->intents_db
+                                                               : rocksdb),
+      read_time_(read_time),
       txn_op_context_(txn_op_context),
       transaction_status_cache_(
           txn_op_context ? &txn_op_context->txn_status_manager : nullptr, read_time) {
   VLOG(4) << "IntentAwareIterator, read_time: " << read_time
           << ", txp_op_context: " << txn_op_context_;
   if (txn_op_context.is_initialized()) {
-    intent_iter_ = docdb::CreateRocksDBIterator(rocksdb,
+    intent_iter_ = docdb::CreateRocksDBIterator(intents_db_,
                                                 docdb::BloomFilterMode::DONT_USE_BLOOM_FILTER,
                                                 boost::none,
                                                 rocksdb::kDefaultQueryId);
+    if (FLAGS_transaction_status_prefetch_window > 0) {
+      transaction_status_cache_.SetPrefetchCandidatesProvider(
+          std::bind(&IntentAwareIterator::CollectTransactionsToPrefetch, this,
+                    std::placeholders::_1, std::placeholders::_2));
+    }
   }
   iter_.reset(rocksdb->NewIterator(read_opts));
+  blob_storage_ = BlobStorage::FromDB(rocksdb);
 }
 
 void IntentAwareIterator::Seek(const DocKey &doc_key) {
@@ -267,14 +356,19 @@ void IntentAwareIterator::SeekForwardIgnoreHt(const SubDocKey& subdoc_key) {
 
 void IntentAwareIterator::SeekPastSubKey(const SubDocKey& subdoc_key) {
   VLOG(4) << "SeekPastSubKey(" << subdoc_key.ToString() << ")";
+  SeekPastSubKey(subdoc_key.Encode(false /* include_hybrid_time */).AsSlice());
+}
+
+void IntentAwareIterator::SeekPastSubKey(const Slice& key) {
+  VLOG(4) << "SeekPastSubKey(" << key.ToDebugHexString() << ")";
   if (!status_.ok()) {
     return;
   }
 
-  docdb::SeekPastSubKey(subdoc_key, iter_.get());
+  docdb::SeekPastSubKey(key, iter_.get());
   SkipFutureRecords();
   if (intent_iter_ && status_.ok()) {
-    KeyBytes intent_prefix = GetIntentPrefixForKey(subdoc_key);
+    KeyBytes intent_prefix = GetIntentPrefixForKeyWithoutHt(key);
     // Skip all intents for subdoc_key.
     intent_prefix.mutable_data()->push_back(static_cast<char>(ValueType::kIntentType) + 1);
     SeekForwardToSuitableIntent(intent_prefix);
@@ -319,15 +413,22 @@ void IntentAwareIterator::SeekToLastDocKey() {
 }
 
 void IntentAwareIterator::PrevDocKey(const DocKey& doc_key) {
-  Seek(doc_key);
   if (!status_.ok()) {
     return;
   }
-  if (!iter_->Valid()) {
-    SeekToLastDocKey();
-    return;
+  // Reverse scans call it right after reading doc_key, so the previous DocKey is usually a few
+  // steps back from the current position, that is cheaper than seeking to doc_key and back.
+  // All entries of doc_key are skipped, including the ones after read time, otherwise the scan
+  // would return to doc_key again.
+  const KeyBytes encoded_doc_key = doc_key.Encode();
+  if (!StepBackBefore(encoded_doc_key.AsSlice())) {
+    ROCKSDB_SEEK(iter_.get(), encoded_doc_key.AsSlice());
+    if (!iter_->Valid()) {
+      SeekToLastDocKey();
+      return;
+    }
+    iter_->Prev();
   }
-  iter_->Prev();
   if (!iter_->Valid()) {
     iter_valid_ = false; // TODO(dtxn) support reverse scan with read restart
     return;
@@ -341,6 +442,19 @@ void IntentAwareIterator::PrevDocKey(const DocKey& doc_key) {
   Seek(prev_key);
 }
 
+bool IntentAwareIterator::StepBackBefore(const Slice& key) {
+  if (!iter_->Valid() || iter_->key().compare(key) < 0) {
+    return false;
+  }
+  for (int steps = FLAGS_docdb_reverse_scan_max_prev_steps; steps > 0; --steps) {
+    iter_->Prev();
+    if (!iter_->Valid() || iter_->key().compare(key) < 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
 bool IntentAwareIterator::valid() {
   return !status_.ok() || iter_valid_ || resolved_intent_state_ == ResolvedIntentState::kValid;
 }
@@ -375,19 +489,37 @@ Result<Slice> IntentAwareIterator::FetchKey() {
 
 Slice IntentAwareIterator::value() {
   if (IsEntryRegular()) {
-    return iter_->value();
+    return blob_storage_ ? RegularValueResolvingBlob() : iter_->value();
   } else {
     DCHECK_EQ(ResolvedIntentState::kValid, resolved_intent_state_);
     return resolved_intent_value_;
   }
 }
 
+Slice IntentAwareIterator::RegularValueResolvingBlob() {
+  auto value = iter_->value();
+  if (!resolved_blob_ref_.empty() && value == Slice(resolved_blob_ref_)) {
+    return resolved_blob_value_;
+  }
+  auto resolved = MaybeResolveBlobValue(value, blob_storage_, &resolved_blob_value_);
+  if (!resolved.ok()) {
+    status_ = resolved.status();
+    return Slice();
+  }
+  if (!resolved.get()) {
+    return value;
+  }
+  resolved_blob_ref_.assign(value.cdata(), value.size());
+  return resolved_blob_value_;
+}
+
 void IntentAwareIterator::SeekForwardRegular(const Slice& slice, const Slice& prefix) {
   docdb::SeekForward(slice, iter_.get());
   SkipFutureRecords();
 }
 
 void IntentAwareIterator::ProcessIntent() {
+  ++num_intents_processed_;
   auto decode_result = DecodeStrongWriteIntent(
       txn_op_context_.get(), intent_iter_.get(), &transaction_status_cache_);
   if (!decode_result.ok()) {
@@ -477,6 +609,41 @@ void IntentAwareIterator::SeekForwardToSuitableIntent() {
   }
 }
 
+void IntentAwareIterator::CollectTransactionsToPrefetch(
+    const TransactionId& missed_transaction_id, std::vector<TransactionId>* transaction_ids) {
+  if (!intent_iter_->Valid()) {
+    return;
+  }
+  if (!intent_prefetch_iter_) {
+    intent_prefetch_iter_ = docdb::CreateRocksDBIterator(
+        intents_db_, docdb::BloomFilterMode::DONT_USE_BLOOM_FILTER, boost::none,
+        rocksdb::kDefaultQueryId);
+  }
+  ROCKSDB_SEEK(intent_prefetch_iter_.get(), intent_iter_->key());
+  for (int i = 0; i < FLAGS_transaction_status_prefetch_window && intent_prefetch_iter_->Valid();
+       ++i, intent_prefetch_iter_->Next()) {
+    auto intent_key = intent_prefetch_iter_->key();
+    if (GetKeyType(intent_key) != KeyType::kIntentKey) {
+      break;
+    }
+    Slice intent_prefix;
+    IntentType intent_type;
+    DocHybridTime intent_ht;
+    if (!DecodeIntentKey(intent_key, &intent_prefix, &intent_type, &intent_ht).ok() ||
+        !IsStrongWriteIntent(intent_type)) {
+      continue;
+    }
+    Slice intent_value = intent_prefetch_iter_->value();
+    auto txn_id = DecodeTransactionIdFromIntentValue(&intent_value);
+    if (!txn_id.ok() || *txn_id == missed_transaction_id ||
+        *txn_id == txn_op_context_->transaction_id ||
+        transaction_status_cache_.IsCached(*txn_id)) {
+      continue;
+    }
+    transaction_ids->push_back(*txn_id);
+  }
+}
+
 void IntentAwareIterator::DebugDump() {
   LOG(INFO) << ">> IntentAwareIterator dump";
   LOG(INFO) << "iter_->Valid(): " << iter_->Valid();
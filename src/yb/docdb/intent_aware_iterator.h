@@ -31,6 +31,7 @@ class TransactionStatusManager;
 
 namespace docdb {
 
+class BlobStorage;
 class Value;
 
 YB_DEFINE_ENUM(ResolvedIntentState, (kNoIntent)(kInvalidPrefix)(kValid));
@@ -39,21 +40,43 @@ YB_DEFINE_ENUM(ResolvedIntentState, (kNoIntent)(kInvalidPrefix)(kValid));
 // Thread safety is not required, because IntentAwareIterator is used in a single thread only.
 class TransactionStatusCache {
  public:
+  // Invoked when the status of a transaction is not cached. Should append ids of other transactions
+  // whose statuses are likely to be needed soon, so they are requested in the same batch.
+  typedef std::function<void(const TransactionId&, std::vector<TransactionId>*)>
+      PrefetchCandidatesProvider;
+
   TransactionStatusCache(TransactionStatusManager* txn_status_manager,
                          const ReadHybridTime& read_time)
       : txn_status_manager_(txn_status_manager), read_time_(read_time) {}
 
+  void SetPrefetchCandidatesProvider(PrefetchCandidatesProvider provider) {
+    prefetch_candidates_provider_ = std::move(provider);
+  }
+
   // Returns transaction commit time if already committed by the specified time or HybridTime::kMin
   // otherwise.
   Result<HybridTime> GetCommitTime(const TransactionId& transaction_id);
 
+  // Requests statuses of all specified transactions that are not cached yet at once, and waits
+  // for all responses. Failed requests are not cached, so GetCommitTime would retry them.
+  void PrefetchCommitTimes(const std::vector<TransactionId>& transaction_ids);
+
+  bool IsCached(const TransactionId& transaction_id) const {
+    return cache_.count(transaction_id) != 0;
+  }
+
  private:
   HybridTime GetLocalCommitTime(const TransactionId& transaction_id);
   Result<HybridTime> DoGetCommitTime(const TransactionId& transaction_id);
 
+  // Converts status received from transaction coordinator to commit time.
+  HybridTime CommitTimeFromStatus(
+      const TransactionId& transaction_id, const TransactionStatusResult& txn_status);
+
   TransactionStatusManager* txn_status_manager_;
   ReadHybridTime read_time_;
   std::unordered_map<TransactionId, HybridTime, TransactionIdHash> cache_;
+  PrefetchCandidatesProvider prefetch_candidates_provider_;
 };
 
 // Provides a way to iterate over DocDB (sub)keys with respect to committed intents transparently
@@ -100,6 +123,10 @@ class IntentAwareIterator {
   // Seek past specified subdoc key.
   void SeekPastSubKey(const SubDocKey& subdoc_key);
 
+  // Seek past specified encoded subdoc key (it is responsibility of caller to make sure it doesn't
+  // have hybrid time).
+  void SeekPastSubKey(const Slice& key);
+
   // Seek out of subdoc key.
   void SeekOutOfSubDoc(const SubDocKey& subdoc_key);
 
@@ -127,6 +154,9 @@ class IntentAwareIterator {
   ReadHybridTime read_time() { return read_time_; }
   HybridTime max_seen_ht() { return max_seen_ht_; }
 
+  // Number of intents decoded by this iterator so far.
+  size_t num_intents_processed() const { return num_intents_processed_; }
+
   // If there is a key equal to key_bytes_without_ht + some timestamp, which is later than
   // max_deleted_ts, we update max_deleted_ts and result_value (unless it is nullptr).
   // This should not be used for leaf nodes. - Why? Looks like it is already used for leaf nodes
@@ -141,12 +171,20 @@ class IntentAwareIterator {
       Value* result_value);
 
  private:
+  // Returns value of the current regular record, reading it from blob storage if needed.
+  Slice RegularValueResolvingBlob();
+
   // Seek forward on regular sub-iterator.
   void SeekForwardRegular(const Slice& slice, const Slice& prefix = Slice());
 
   // Skips regular entries with hybrid time after read limit.
   void SkipFutureRecords();
 
+  // Moves the regular iterator back to the last entry before key, when it is reachable from the
+  // current position by at most --docdb_reverse_scan_max_prev_steps steps. Returns false when it
+  // is not, the iterator should be positioned by seek in this case.
+  bool StepBackBefore(const Slice& key);
+
   // Skips intents with hybrid time after read limit.
   void SkipFutureIntents();
 
@@ -182,18 +220,29 @@ class IntentAwareIterator {
   void ProcessIntent();
 
   void UpdateResolvedIntentSubDocKeyEncoded();
+
+  // Scans intents following the current intent_iter_ position and appends ids of transactions,
+  // whose statuses are not cached yet, to transaction_ids.
+  void CollectTransactionsToPrefetch(
+      const TransactionId& missed_transaction_id, std::vector<TransactionId>* transaction_ids);
+
   void DebugDump();
 
   // Whether current entry is regular key-value pair.
   bool IsEntryRegular();
 
+  // RocksDB that stores intents, could be the same as the one storing regular records.
+  rocksdb::DB* const intents_db_;
   const ReadHybridTime read_time_;
   const TransactionOperationContextOpt txn_op_context_;
   std::unique_ptr<rocksdb::Iterator> intent_iter_;
+  // Used to look ahead for transaction ids, created on the first cache miss.
+  std::unique_ptr<rocksdb::Iterator> intent_prefetch_iter_;
   std::unique_ptr<rocksdb::Iterator> iter_;
   bool iter_valid_ = false;
   Status status_;
   HybridTime max_seen_ht_ = HybridTime::kMin;
+  size_t num_intents_processed_ = 0;
 
   // Following fields contain information related to resolved suitable intent.
   ResolvedIntentState resolved_intent_state_ = ResolvedIntentState::kNoIntent;
@@ -205,6 +254,12 @@ class IntentAwareIterator {
   DocHybridTime intent_dht_from_same_txn_ = DocHybridTime::kMin;
   KeyBytes resolved_intent_sub_doc_key_encoded_;
   KeyBytes resolved_intent_value_;
+  // Resolves large values of regular records that are stored in blob files, nullptr if the
+  // RocksDB does not have blob storage.
+  BlobStorage* blob_storage_ = nullptr;
+  // Blob reference that resolved_blob_value_ was read for, so it is not read again by value().
+  std::string resolved_blob_ref_;
+  std::string resolved_blob_value_;
   std::vector<Slice> prefix_stack_;
   TransactionStatusCache transaction_status_cache_;
 };
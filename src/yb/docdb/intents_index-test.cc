@@ -0,0 +1,100 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/intents_index.h"
+
+#include "yb/docdb/doc_key.h"
+#include "yb/docdb/docdb_test_base.h"
+#include "yb/docdb/shared_lock_manager.h"
+
+#include "yb/util/test_macros.h"
+
+DECLARE_int64(intents_index_max_doc_paths);
+
+namespace yb {
+namespace docdb {
+
+class IntentsIndexTest : public DocDBTestBase {
+ protected:
+  static const LockState& Conflicts(IntentType type) {
+    return kIntentConflicts[static_cast<size_t>(type)];
+  }
+};
+
+TEST_F(IntentsIndexTest, RebuildAndFind) {
+  const DocKey doc_key(PrimitiveValues("a"));
+  const SubDocKey column_key(doc_key, PrimitiveValue("c"));
+  const KeyBytes row_path = doc_key.Encode();
+  const KeyBytes column_path = column_key.Encode(false /* include_hybrid_time */);
+
+  const auto txn1 = GenerateTransactionId();
+  SetTransactionIsolationLevel(IsolationLevel::SNAPSHOT_ISOLATION);
+  SetCurrentTransactionId(txn1);
+  ASSERT_OK(SetPrimitive(
+      DocPath(row_path, PrimitiveValue("c")), PrimitiveValue("v"), HybridTime(1000)));
+  ResetCurrentTransactionId();
+
+  IntentsIndex index;
+  TransactionIdSet conflicts;
+  // Not usable before rebuild.
+  ASSERT_FALSE(index.FindConflicts(
+      column_path.AsSlice(), Conflicts(IntentType::kStrongSnapshotWrite), &conflicts));
+
+  ASSERT_OK(index.Rebuild(rocksdb()));
+  ASSERT_TRUE(index.ready());
+  // Weak intent for the row and strong intent for the column.
+  ASSERT_EQ(2, index.TEST_num_doc_paths());
+
+  ASSERT_TRUE(index.FindConflicts(
+      column_path.AsSlice(), Conflicts(IntentType::kStrongSnapshotWrite), &conflicts));
+  ASSERT_EQ(TransactionIdSet{txn1}, conflicts);
+
+  // Weak intents do not conflict with each other.
+  conflicts.clear();
+  ASSERT_TRUE(index.FindConflicts(
+      row_path.AsSlice(), Conflicts(IntentType::kWeakSnapshotWrite), &conflicts));
+  ASSERT_TRUE(conflicts.empty());
+
+  const auto txn2 = GenerateTransactionId();
+  index.Add(txn2, row_path.AsSlice(), IntentType::kStrongSnapshotWrite);
+  ASSERT_TRUE(index.FindConflicts(
+      row_path.AsSlice(), Conflicts(IntentType::kWeakSnapshotWrite), &conflicts));
+  ASSERT_EQ(TransactionIdSet{txn2}, conflicts);
+
+  index.Remove(txn2);
+  index.Remove(txn1);
+  ASSERT_EQ(0, index.TEST_num_doc_paths());
+}
+
+TEST_F(IntentsIndexTest, Overflow) {
+  FLAGS_intents_index_max_doc_paths = 1;
+
+  IntentsIndex index;
+  ASSERT_OK(index.Rebuild(rocksdb()));
+  ASSERT_TRUE(index.ready());
+
+  const auto txn = GenerateTransactionId();
+  index.Add(txn, "a", IntentType::kStrongSnapshotWrite);
+  ASSERT_TRUE(index.ready());
+  index.Add(txn, "b", IntentType::kStrongSnapshotWrite);
+
+  // Index is disabled, so conflicts should be read from RocksDB.
+  TransactionIdSet conflicts;
+  ASSERT_FALSE(index.ready());
+  ASSERT_FALSE(index.FindConflicts(
+      "a", Conflicts(IntentType::kStrongSnapshotWrite), &conflicts));
+  ASSERT_EQ(0, index.TEST_num_doc_paths());
+}
+
+}  // namespace docdb
+}  // namespace yb
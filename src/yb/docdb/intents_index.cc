@@ -0,0 +1,165 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/intents_index.h"
+
+#include <algorithm>
+
+#include "yb/docdb/conflict_resolution.h"
+#include "yb/docdb/docdb_rocksdb_util.h"
+#include "yb/docdb/intent.h"
+
+#include "yb/util/flag_tags.h"
+
+DEFINE_int64(intents_index_max_doc_paths, 100000,
+             "Maximum number of doc paths kept in the in-memory intents index of a tablet. When "
+             "the index grows over it, conflict resolution of the tablet reads intents from "
+             "RocksDB until the tablet is restarted.");
+TAG_FLAG(intents_index_max_doc_paths, advanced);
+
+namespace yb {
+namespace docdb {
+
+void IntentsIndex::Add(const TransactionId& transaction_id, Slice doc_path, IntentType type) {
+  std::lock_guard<rw_spinlock> lock(lock_);
+  if (overflow_) {
+    return;
+  }
+
+  auto it = by_doc_path_.find(doc_path.ToBuffer());
+  if (it == by_doc_path_.end()) {
+    if (static_cast<int64_t>(by_doc_path_.size()) >= FLAGS_intents_index_max_doc_paths) {
+      LOG(WARNING) << "Intents index is over " << FLAGS_intents_index_max_doc_paths
+                   << " doc paths, conflict resolution falls back to reading intents DB";
+      DisableUnlocked();
+      return;
+    }
+    it = by_doc_path_.emplace(doc_path.ToBuffer(), Entries()).first;
+  }
+
+  bool has_transaction = false;
+  for (const auto& entry : it->second) {
+    if (entry.transaction_id == transaction_id) {
+      if (entry.type == type) {
+        return;
+      }
+      has_transaction = true;
+    }
+  }
+  it->second.push_back({transaction_id, type});
+  if (!has_transaction) {
+    doc_paths_by_transaction_[transaction_id].push_back(it->first);
+  }
+}
+
+void IntentsIndex::Remove(const TransactionId& transaction_id) {
+  std::lock_guard<rw_spinlock> lock(lock_);
+  auto it = doc_paths_by_transaction_.find(transaction_id);
+  if (it == doc_paths_by_transaction_.end()) {
+    return;
+  }
+
+  for (const auto& doc_path : it->second) {
+    auto doc_path_it = by_doc_path_.find(doc_path);
+    if (doc_path_it == by_doc_path_.end()) {
+      continue;
+    }
+    auto& entries = doc_path_it->second;
+    entries.erase(
+        std::remove_if(entries.begin(), entries.end(), [&transaction_id](const Entry& entry) {
+          return entry.transaction_id == transaction_id;
+        }),
+        entries.end());
+    if (entries.empty()) {
+      by_doc_path_.erase(doc_path_it);
+    }
+  }
+  doc_paths_by_transaction_.erase(it);
+}
+
+bool IntentsIndex::FindConflicts(Slice doc_path, const LockState& conflicting_types,
+                                 TransactionIdSet* conflicts) const {
+  shared_lock<rw_spinlock> lock(lock_);
+  if (!ready_) {
+    return false;
+  }
+
+  auto it = by_doc_path_.find(doc_path.ToBuffer());
+  if (it != by_doc_path_.end()) {
+    for (const auto& entry : it->second) {
+      if (conflicting_types.test(static_cast<size_t>(entry.type))) {
+        conflicts->insert(entry.transaction_id);
+      }
+    }
+  }
+  return true;
+}
+
+Status IntentsIndex::Rebuild(rocksdb::DB* intents_db) {
+  {
+    std::lock_guard<rw_spinlock> lock(lock_);
+    ready_ = false;
+    overflow_ = false;
+    by_doc_path_.clear();
+    doc_paths_by_transaction_.clear();
+  }
+
+  auto iter = CreateRocksDBIterator(
+      intents_db,
+      BloomFilterMode::DONT_USE_BLOOM_FILTER,
+      boost::none /* user_key_for_filter */,
+      rocksdb::kDefaultQueryId);
+
+  const char intent_prefix = static_cast<char>(ValueType::kIntentPrefix);
+  size_t num_intents = 0;
+  for (iter->Seek(Slice(&intent_prefix, 1)); iter->Valid(); iter->Next()) {
+    auto key = iter->key();
+    if (key.empty() || key[0] != static_cast<uint8_t>(ValueType::kIntentPrefix)) {
+      break;
+    }
+    Slice value = iter->value();
+    auto transaction_id = DecodeTransactionIdFromIntentValue(&value);
+    RETURN_NOT_OK(transaction_id);
+    auto intent = ParseIntentKey(key, iter->value());
+    RETURN_NOT_OK(intent);
+    Add(*transaction_id, intent->doc_path, intent->type);
+    ++num_intents;
+  }
+
+  std::lock_guard<rw_spinlock> lock(lock_);
+  if (!overflow_) {
+    ready_ = true;
+  }
+  LOG(INFO) << "Intents index rebuilt from " << num_intents << " intents, ready: " << ready_;
+  return Status::OK();
+}
+
+bool IntentsIndex::ready() const {
+  shared_lock<rw_spinlock> lock(lock_);
+  return ready_;
+}
+
+size_t IntentsIndex::TEST_num_doc_paths() const {
+  shared_lock<rw_spinlock> lock(lock_);
+  return by_doc_path_.size();
+}
+
+void IntentsIndex::DisableUnlocked() {
+  ready_ = false;
+  overflow_ = true;
+  by_doc_path_.clear();
+  doc_paths_by_transaction_.clear();
+}
+
+}  // namespace docdb
+}  // namespace yb
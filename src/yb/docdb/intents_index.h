@@ -0,0 +1,101 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_INTENTS_INDEX_H
+#define YB_DOCDB_INTENTS_INDEX_H
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <boost/container/small_vector.hpp>
+
+#include "yb/common/transaction.h"
+
+#include "yb/docdb/shared_lock_manager_fwd.h"
+#include "yb/docdb/value_type.h"
+
+#include "yb/util/locks.h"
+#include "yb/util/slice.h"
+
+namespace rocksdb {
+
+class DB;
+
+}
+
+namespace yb {
+namespace docdb {
+
+typedef std::unordered_set<TransactionId, TransactionIdHash> TransactionIdSet;
+
+// In-memory copy of the intents stored in the intents DB of a tablet, keyed by the intent doc path
+// (SubDocKey without hybrid time, without the intent prefix). Lets conflict resolution find the
+// transactions that hold conflicting intents without seeking a RocksDB iterator for every key.
+//
+// The index is not usable until Rebuild() has loaded the intents that were already stored in the
+// intents DB, e.g. before a restart. It is also disabled when it grows over
+// --intents_index_max_doc_paths. While the index is not usable, conflict resolution falls back to
+// reading the intents DB.
+class IntentsIndex {
+ public:
+  IntentsIndex() {}
+
+  IntentsIndex(const IntentsIndex&) = delete;
+  void operator=(const IntentsIndex&) = delete;
+
+  // Registers intent of the specified type written by transaction for doc_path.
+  void Add(const TransactionId& transaction_id, Slice doc_path, IntentType type);
+
+  // Removes all intents of the specified transaction, i.e. after they were removed from the
+  // intents DB or the transaction is known to be aborted.
+  void Remove(const TransactionId& transaction_id);
+
+  // Adds to conflicts the transactions that hold an intent for doc_path whose type is set in
+  // conflicting_types. Returns false, without touching conflicts, if the index is not usable.
+  bool FindConflicts(Slice doc_path, const LockState& conflicting_types,
+                     TransactionIdSet* conflicts) const;
+
+  // Replaces content of the index with all intents stored in intents_db and makes the index
+  // usable. Should be invoked before the tablet starts applying operations, e.g. when intents_db
+  // is opened.
+  CHECKED_STATUS Rebuild(rocksdb::DB* intents_db);
+
+  bool ready() const;
+
+  size_t TEST_num_doc_paths() const;
+
+ private:
+  struct Entry {
+    TransactionId transaction_id;
+    IntentType type;
+  };
+
+  typedef boost::container::small_vector<Entry, 1> Entries;
+
+  // Disables the index and drops its content. Requires that lock_ is held exclusively.
+  void DisableUnlocked();
+
+  mutable rw_spinlock lock_;
+  bool ready_ = false;
+  bool overflow_ = false;
+  std::unordered_map<std::string, Entries> by_doc_path_;
+  std::unordered_map<TransactionId, std::vector<std::string>, TransactionIdHash>
+      doc_paths_by_transaction_;
+};
+
+}  // namespace docdb
+}  // namespace yb
+
+#endif // YB_DOCDB_INTENTS_INDEX_H
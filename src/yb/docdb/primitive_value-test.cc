@@ -377,6 +377,35 @@ TEST(PrimitiveValueTest, TestMove) {
   TestMove(PrimitiveValue(HybridTime(1000)), 1000, 1000);
 }
 
+// Ensures that encoded views of primitive values are consumed, decoded and compared the same way as
+// primitive values.
+void CheckEncodedViews(const PrimitiveValue& v1, const PrimitiveValue& v2) {
+  KeyBytes key_bytes;
+  v1.AppendToKey(&key_bytes);
+  const size_t v1_size = key_bytes.size();
+  v2.AppendToKey(&key_bytes);
+  rocksdb::Slice slice = key_bytes.AsSlice();
+
+  auto view1 = EncodedPrimitiveValueView::Consume(&slice);
+  ASSERT_OK(view1);
+  auto view2 = EncodedPrimitiveValueView::Consume(&slice);
+  ASSERT_OK(view2);
+  ASSERT_TRUE(slice.empty());
+  ASSERT_EQ(v1_size, view1->encoded().size());
+  ASSERT_EQ(key_bytes.size() - v1_size, view2->encoded().size());
+  ASSERT_EQ(v1.value_type(), view1->value_type());
+
+  auto decoded1 = view1->Decode();
+  ASSERT_OK(decoded1);
+  ASSERT_EQ(v1.ToString(), decoded1->ToString());
+  ASSERT_EQ(v1.ToString(), view1->ToString());
+
+  ASSERT_EQ(v1 < v2, *view1 < *view2);
+  ASSERT_EQ(v1 == v2, *view1 == *view2);
+  ASSERT_EQ(*view1, EncodedPrimitiveValueView(view1->encoded()));
+  ASSERT_EQ(view1->hash(), EncodedPrimitiveValueView(view1->encoded()).hash());
+}
+
 // Ensures that the serialized version of a primitive value compares the same way as the primitive
 // value.
 void ComparePrimitiveValues(const PrimitiveValue& v1, const PrimitiveValue& v2) {
@@ -386,6 +415,7 @@ void ComparePrimitiveValues(const PrimitiveValue& v1, const PrimitiveValue& v2)
   v1.AppendToKey(&k1);
   v2.AppendToKey(&k2);
   ASSERT_EQ(v1 < v2, k1 < k2);
+  CheckEncodedViews(v1, v2);
 }
 
 TEST(PrimitiveValueTest, TestAllTypesComparisons) {
@@ -439,5 +469,56 @@ TEST(PrimitiveValueTest, TestAllTypesComparisons) {
       PrimitiveValue::Int32(r.Next32()));
 }
 
+TEST(PrimitiveValueTest, TestSkipKey) {
+  // Strings with embedded zeros and descending values use escaping in the key encoding.
+  const std::vector<PrimitiveValue> values = {
+      PrimitiveValue(string("a\0b\0\0c", 6)),
+      PrimitiveValue(string("a\0b\0\0c", 6), SortOrder::kDescending),
+      PrimitiveValue(string("\xff\xff", 2), SortOrder::kDescending),
+      PrimitiveValue(ValueType::kNull),
+      PrimitiveValue(ValueType::kTrue),
+      PrimitiveValue(12345L, SortOrder::kDescending),
+      PrimitiveValue::Int32(-7, SortOrder::kDescending),
+      PrimitiveValue::UInt16Hash(0xabcd),
+      PrimitiveValue::ArrayIndex(42),
+      PrimitiveValue::Double(-1.5, SortOrder::kDescending),
+      PrimitiveValue::Float(2.5),
+      PrimitiveValue::Decimal("-3.25", SortOrder::kDescending),
+      PrimitiveValue::VarInt("123456789012345678901234567890", SortOrder::kAscending),
+      PrimitiveValue(Timestamp(1000)),
+      PrimitiveValue(Uuid(Uuid::Generate())),
+      PrimitiveValue::TransactionId(Uuid(Uuid::Generate())),
+      PrimitiveValue(ColumnId(1000)),
+      PrimitiveValue::SystemColumnId(SystemColumnIds::kLivenessColumn),
+      PrimitiveValue(DocHybridTime(HybridTime::FromMicros(1000), 2)),
+  };
+  KeyBytes key_bytes;
+  for (const auto& value : values) {
+    value.AppendToKey(&key_bytes);
+  }
+  rocksdb::Slice slice = key_bytes.AsSlice();
+  std::vector<EncodedPrimitiveValueView> views;
+  while (!slice.empty()) {
+    auto view = EncodedPrimitiveValueView::Consume(&slice);
+    ASSERT_OK(view);
+    views.push_back(*view);
+  }
+  ASSERT_EQ(values.size(), views.size());
+  for (size_t i = 0; i != values.size(); ++i) {
+    ASSERT_EQ(values[i].ToKeyBytes().AsSlice(), views[i].encoded());
+  }
+
+  // Truncated values should be reported as corruption. Only check values that are skipped without
+  // DecodeKey, i.e. the ones before the decimal.
+  for (size_t i = 0; values[i].value_type() != ValueType::kDecimalDescending; ++i) {
+    const auto& value = values[i];
+    KeyBytes encoded = value.ToKeyBytes();
+    for (size_t size = 1; size < encoded.size(); ++size) {
+      rocksdb::Slice truncated(encoded.data().data(), size);
+      ASSERT_NOK(PrimitiveValue::SkipKey(&truncated)) << value << ", size: " << size;
+    }
+  }
+}
+
 }  // namespace docdb
 }  // namespace yb
@@ -44,6 +44,7 @@ using yb::util::FastDecodeSignedVarInt;
 // at compile time.
 #define IGNORE_NON_PRIMITIVE_VALUE_TYPES_IN_SWITCH \
     case ValueType::kArray: FALLTHROUGH_INTENDED; \
+    case ValueType::kBlobRef: FALLTHROUGH_INTENDED; \
     case ValueType::kGroupEnd: FALLTHROUGH_INTENDED; \
     case ValueType::kGroupEndDescending: FALLTHROUGH_INTENDED; \
     case ValueType::kIntentPrefix: FALLTHROUGH_INTENDED; \
@@ -54,6 +55,7 @@ using yb::util::FastDecodeSignedVarInt;
     case ValueType::kRedisSortedSet: FALLTHROUGH_INTENDED; \
     case ValueType::kTtl: FALLTHROUGH_INTENDED; \
     case ValueType::kUserTimestamp: FALLTHROUGH_INTENDED; \
+    case ValueType::kCounterDelta: FALLTHROUGH_INTENDED; \
     case ValueType::kTombstone: \
       break
 
@@ -77,6 +79,30 @@ string RealToString(T val) {
   return s;
 }
 
+// Returns size of the string encoded by ZeroEncodeStr (or ComplementZeroEncodeStr) at the start of
+// the slice, including the terminator.
+template <char END_OF_STRING>
+Result<size_t> EncodedStrSize(const Slice& slice) {
+  constexpr char END_OF_STRING_ESCAPE = END_OF_STRING ^ 1;
+  const char* p = slice.cdata();
+  const char* end = slice.cend();
+  for (;;) {
+    p = static_cast<const char*>(memchr(p, END_OF_STRING, end - p));
+    if (p == nullptr || p + 1 == end) {
+      return STATUS_FORMAT(Corruption, "Encoded string is not terminated: $0",
+                           ToShortDebugStr(slice));
+    }
+    if (p[1] == END_OF_STRING) {
+      return p + 2 - slice.cdata();
+    }
+    if (p[1] != END_OF_STRING_ESCAPE) {
+      return STATUS_FORMAT(Corruption, "Invalid sequence in encoded string: $0",
+                           ToShortDebugStr(slice));
+    }
+    p += 2;
+  }
+}
+
 } // anonymous namespace
 
 const PrimitiveValue PrimitiveValue::kInvalidPrimitiveValue =
@@ -181,6 +207,8 @@ string PrimitiveValue::ToString() const {
       return "(->)";
     case ValueType::kTombstone:
       return "DEL";
+    case ValueType::kBlobRef:
+      return "BlobRef";
     case ValueType::kArray:
       return "[]";
     case ValueType::kTransactionId:
@@ -191,6 +219,7 @@ string PrimitiveValue::ToString() const {
     case ValueType::kGroupEndDescending: FALLTHROUGH_INTENDED;
     case ValueType::kTtl: FALLTHROUGH_INTENDED;
     case ValueType::kUserTimestamp: FALLTHROUGH_INTENDED;
+    case ValueType::kCounterDelta: FALLTHROUGH_INTENDED;
     case ValueType::kIntentPrefix:
       break;
     case ValueType::kLowest:
@@ -456,11 +485,13 @@ string PrimitiveValue::ToValue() const {
       break;
 
     case ValueType::kIntentType: FALLTHROUGH_INTENDED;
+    case ValueType::kBlobRef: FALLTHROUGH_INTENDED;
     case ValueType::kGroupEnd: FALLTHROUGH_INTENDED;
     case ValueType::kGroupEndDescending: FALLTHROUGH_INTENDED;
     case ValueType::kIntentPrefix: FALLTHROUGH_INTENDED;
     case ValueType::kTtl: FALLTHROUGH_INTENDED;
     case ValueType::kUserTimestamp: FALLTHROUGH_INTENDED;
+    case ValueType::kCounterDelta: FALLTHROUGH_INTENDED;
     case ValueType::kColumnId: FALLTHROUGH_INTENDED;
     case ValueType::kSystemColumnId: FALLTHROUGH_INTENDED;
     case ValueType::kHybridTime: FALLTHROUGH_INTENDED;
@@ -815,6 +846,99 @@ Status PrimitiveValue::DecodeKey(rocksdb::Slice* slice, PrimitiveValue* out) {
       ToShortDebugStr(input_slice));
 }
 
+Status PrimitiveValue::SkipKey(rocksdb::Slice* slice) {
+  if (slice->empty()) {
+    return STATUS(Corruption,
+                  "Cannot skip a primitive value in the key encoding format in an empty slice");
+  }
+  const Slice payload(slice->data() + 1, slice->end());
+  size_t payload_size;
+  switch (static_cast<ValueType>(*slice->data())) {
+    case ValueType::kNullDescending: FALLTHROUGH_INTENDED;
+    case ValueType::kNull: FALLTHROUGH_INTENDED;
+    case ValueType::kCounter: FALLTHROUGH_INTENDED;
+    case ValueType::kSSForward: FALLTHROUGH_INTENDED;
+    case ValueType::kSSReverse: FALLTHROUGH_INTENDED;
+    case ValueType::kFalse: FALLTHROUGH_INTENDED;
+    case ValueType::kTrue: FALLTHROUGH_INTENDED;
+    case ValueType::kHighest: FALLTHROUGH_INTENDED;
+    case ValueType::kLowest:
+      payload_size = 0;
+      break;
+
+    case ValueType::kString: FALLTHROUGH_INTENDED;
+    case ValueType::kInetaddress: FALLTHROUGH_INTENDED;
+    case ValueType::kTransactionId: FALLTHROUGH_INTENDED;
+    case ValueType::kUuid:
+      payload_size = VERIFY_RESULT(EncodedStrSize<'\0'>(payload));
+      break;
+
+    case ValueType::kStringDescending: FALLTHROUGH_INTENDED;
+    case ValueType::kInetaddressDescending: FALLTHROUGH_INTENDED;
+    case ValueType::kUuidDescending:
+      payload_size = VERIFY_RESULT(EncodedStrSize<'\xff'>(payload));
+      break;
+
+    case ValueType::kIntentType:
+      payload_size = 1;
+      break;
+
+    case ValueType::kUInt16Hash:
+      payload_size = sizeof(uint16_t);
+      break;
+
+    case ValueType::kInt32Descending: FALLTHROUGH_INTENDED;
+    case ValueType::kInt32: FALLTHROUGH_INTENDED;
+    case ValueType::kFloatDescending: FALLTHROUGH_INTENDED;
+    case ValueType::kFloat:
+      payload_size = sizeof(int32_t);
+      break;
+
+    case ValueType::kInt64Descending: FALLTHROUGH_INTENDED;
+    case ValueType::kInt64: FALLTHROUGH_INTENDED;
+    case ValueType::kArrayIndex: FALLTHROUGH_INTENDED;
+    case ValueType::kTimestampDescending: FALLTHROUGH_INTENDED;
+    case ValueType::kTimestamp: FALLTHROUGH_INTENDED;
+    case ValueType::kDoubleDescending: FALLTHROUGH_INTENDED;
+    case ValueType::kDouble:
+      payload_size = sizeof(int64_t);
+      break;
+
+    default:
+      // Frozen values, decimals, varints, column ids and hybrid times have variable length
+      // encodings that are validated by DecodeKey.
+      return DecodeKey(slice, nullptr);
+  }
+  if (payload.size() < payload_size) {
+    return STATUS_FORMAT(Corruption, "Not enough bytes to skip $0: $1, need $2",
+                         static_cast<ValueType>(*slice->data()), payload.size(), payload_size);
+  }
+  slice->remove_prefix(1 + payload_size);
+  return Status::OK();
+}
+
+Result<EncodedPrimitiveValueView> EncodedPrimitiveValueView::Consume(rocksdb::Slice* slice) {
+  const auto begin = slice->data();
+  RETURN_NOT_OK(PrimitiveValue::SkipKey(slice));
+  return EncodedPrimitiveValueView(Slice(begin, slice->data()));
+}
+
+Result<PrimitiveValue> EncodedPrimitiveValueView::Decode() const {
+  PrimitiveValue result;
+  Slice slice(encoded_);
+  RETURN_NOT_OK(result.DecodeFromKey(&slice));
+  if (!slice.empty()) {
+    return STATUS_FORMAT(Corruption, "Extra bytes after encoded primitive value: $0",
+                         ToShortDebugStr(encoded_));
+  }
+  return result;
+}
+
+std::string EncodedPrimitiveValueView::ToString() const {
+  auto decoded = Decode();
+  return decoded.ok() ? decoded->ToString() : encoded_.ToDebugHexString();
+}
+
 Status PrimitiveValue::DecodeFromValue(const rocksdb::Slice& rocksdb_slice) {
   if (rocksdb_slice.empty()) {
     return STATUS(Corruption, "Cannot decode a value from an empty slice");
@@ -960,9 +1084,12 @@ Status PrimitiveValue::DecodeFromValue(const rocksdb::Slice& rocksdb_slice) {
     case ValueType::kGroupEndDescending: FALLTHROUGH_INTENDED;
     case ValueType::kIntentPrefix: FALLTHROUGH_INTENDED;
     case ValueType::kUInt16Hash: FALLTHROUGH_INTENDED;
+    // Blob references are resolved by IntentAwareIterator before values are decoded.
+    case ValueType::kBlobRef: FALLTHROUGH_INTENDED;
     case ValueType::kInvalidValueType: FALLTHROUGH_INTENDED;
     case ValueType::kTtl: FALLTHROUGH_INTENDED;
     case ValueType::kUserTimestamp: FALLTHROUGH_INTENDED;
+    case ValueType::kCounterDelta: FALLTHROUGH_INTENDED;
     case ValueType::kColumnId: FALLTHROUGH_INTENDED;
     case ValueType::kSystemColumnId: FALLTHROUGH_INTENDED;
     case ValueType::kHybridTime: FALLTHROUGH_INTENDED;
@@ -1385,19 +1512,19 @@ void PrimitiveValue::ToQLValuePB(const PrimitiveValue& primitive_value,
     case INET: {
       QLValue temp_value;
       temp_value.set_inetaddress_value(*primitive_value.GetInetaddress());
-      ql_value->CopyFrom(temp_value.value());
+      ql_value->Swap(temp_value.mutable_value());
       return;
     }
     case UUID: {
       QLValue temp_value;
       temp_value.set_uuid_value(primitive_value.GetUuid());
-      ql_value->CopyFrom(temp_value.value());
+      ql_value->Swap(temp_value.mutable_value());
       return;
     }
     case TIMEUUID: {
       QLValue temp_value;
       temp_value.set_timeuuid_value(primitive_value.GetUuid());
-      ql_value->CopyFrom(temp_value.value());
+      ql_value->Swap(temp_value.mutable_value());
       return;
     }
     case STRING:
@@ -1471,5 +1598,41 @@ void PrimitiveValue::ToQLValuePB(const PrimitiveValue& primitive_value,
   LOG(FATAL) << "Unsupported datatype " << ql_type->ToString();
 }
 
+void PrimitiveValue::ToQLValuePB(PrimitiveValue&& primitive_value,
+                                 const std::shared_ptr<QLType>& ql_type,
+                                 QLValuePB* ql_value) {
+  const ValueType type = primitive_value.value_type();
+  switch (ql_type->main()) {
+    case STRING:
+      if (type == ValueType::kString || type == ValueType::kStringDescending) {
+        ql_value->set_string_value(std::move(primitive_value.str_val_));
+        return;
+      }
+      break;
+    case BINARY:
+      if (type == ValueType::kString || type == ValueType::kStringDescending) {
+        ql_value->set_binary_value(std::move(primitive_value.str_val_));
+        return;
+      }
+      break;
+    case DECIMAL:
+      if (type == ValueType::kDecimal || type == ValueType::kDecimalDescending) {
+        ql_value->set_decimal_value(std::move(primitive_value.decimal_val_));
+        return;
+      }
+      break;
+    case VARINT:
+      if (type == ValueType::kVarInt || type == ValueType::kVarIntDescending) {
+        ql_value->set_varint_value(std::move(primitive_value.varint_val_));
+        return;
+      }
+      break;
+    default:
+      break;
+  }
+  const PrimitiveValue& const_value = primitive_value;
+  ToQLValuePB(const_value, ql_type, ql_value);
+}
+
 }  // namespace docdb
 }  // namespace yb
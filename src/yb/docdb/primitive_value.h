@@ -31,6 +31,7 @@
 #include "yb/docdb/key_bytes.h"
 #include "yb/docdb/value_type.h"
 #include "yb/util/decimal.h"
+#include "yb/util/result.h"
 #include "yb/util/timestamp.h"
 
 namespace yb {
@@ -189,6 +190,12 @@ class PrimitiveValue {
                           const std::shared_ptr<QLType>& ql_type,
                           QLValuePB* ql_val);
 
+  // The same, but moves string, binary, decimal and varint payloads into the QLValuePB instead of
+  // copying them. pv is left in a valid but unspecified state.
+  static void ToQLValuePB(PrimitiveValue&& pv,
+                          const std::shared_ptr<QLType>& ql_type,
+                          QLValuePB* ql_val);
+
   ValueType value_type() const { return type_; }
 
   void AppendToKey(KeyBytes* key_bytes) const;
@@ -219,6 +226,10 @@ class PrimitiveValue {
   static CHECKED_STATUS DecodeKey(rocksdb::Slice* slice, PrimitiveValue* out);
   CHECKED_STATUS DecodeFromKey(rocksdb::Slice* slice);
 
+  // Consumes a primitive value in the key encoding format from the given slice, without decoding
+  // it. Unlike DecodeKey(slice, nullptr), does not build temporary values for most types.
+  static CHECKED_STATUS SkipKey(rocksdb::Slice* slice);
+
   // Decodes a primitive value from the given slice representing a RocksDB value in our value
   // encoding format. Expects the entire slice to be consumed and returns an error otherwise.
   CHECKED_STATUS DecodeFromValue(const rocksdb::Slice& rocksdb_slice);
@@ -456,6 +467,72 @@ inline std::ostream& operator<<(std::ostream& out, const PrimitiveValue& primiti
   return out;
 }
 
+// View of a primitive value encoded in the key format, i.e. a single component of an encoded key.
+// The key encoding is memcomparable, so comparing encoded bytes gives the same order as comparing
+// decoded values, which is also the order of keys in RocksDB. So views could be compared, checked
+// for equality and hashed without building PrimitiveValue objects or copying strings.
+// View does not own the encoded bytes, they should outlive the view.
+class EncodedPrimitiveValueView {
+ public:
+  EncodedPrimitiveValueView() = default;
+
+  // encoded should contain exactly one primitive value in the key encoding format.
+  explicit EncodedPrimitiveValueView(const Slice& encoded) : encoded_(encoded) {
+    DCHECK(!encoded_.empty());
+  }
+
+  // Consumes a primitive value in the key encoding format from the given slice.
+  static Result<EncodedPrimitiveValueView> Consume(rocksdb::Slice* slice);
+
+  ValueType value_type() const {
+    return static_cast<ValueType>(encoded_[0]);
+  }
+
+  // Encoded bytes, including the value type.
+  const Slice& encoded() const {
+    return encoded_;
+  }
+
+  bool empty() const {
+    return encoded_.empty();
+  }
+
+  int CompareTo(const EncodedPrimitiveValueView& other) const {
+    return encoded_.compare(other.encoded_);
+  }
+
+  size_t hash() const {
+    return encoded_.hash();
+  }
+
+  Result<PrimitiveValue> Decode() const;
+
+  std::string ToString() const;
+
+ private:
+  Slice encoded_;
+};
+
+inline bool operator==(const EncodedPrimitiveValueView& lhs, const EncodedPrimitiveValueView& rhs) {
+  return lhs.encoded() == rhs.encoded();
+}
+
+inline bool operator!=(const EncodedPrimitiveValueView& lhs, const EncodedPrimitiveValueView& rhs) {
+  return !(lhs == rhs);
+}
+
+inline bool operator<(const EncodedPrimitiveValueView& lhs, const EncodedPrimitiveValueView& rhs) {
+  return lhs.CompareTo(rhs) < 0;
+}
+
+inline size_t hash_value(const EncodedPrimitiveValueView& view) {
+  return view.hash();
+}
+
+inline std::ostream& operator<<(std::ostream& out, const EncodedPrimitiveValueView& view) {
+  return out << view.ToString();
+}
+
 inline std::ostream& operator<<(std::ostream& out, const SortOrder sort_order) {
   string sort_order_name = sort_order == SortOrder::kAscending ? "kAscending" : "kDescending";
   out << sort_order_name;
@@ -0,0 +1,211 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/ql_row_cache.h"
+
+#include <algorithm>
+
+#include "yb/docdb/doc_key.h"
+
+#include "yb/util/mem_tracker.h"
+#include "yb/util/metrics.h"
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+const std::string kRowCacheMemTrackerId = "QLRowCache";
+
+// Values of these columns could be partially expired, even when the column has no TTL.
+bool CouldExpire(const ColumnSchema& column) {
+  return column.type()->IsCollection() || column.type()->IsUserDefined();
+}
+
+} // namespace
+
+QLRowCache::QLRowCache(size_t capacity_bytes,
+                       const std::shared_ptr<MemTracker>& parent_mem_tracker,
+                       scoped_refptr<Counter> hits,
+                       scoped_refptr<Counter> misses)
+    : capacity_bytes_(capacity_bytes),
+      mem_tracker_(MemTracker::CreateTracker(-1, kRowCacheMemTrackerId, parent_mem_tracker)),
+      hits_(std::move(hits)),
+      misses_(std::move(misses)) {
+  last_write_ht_.fill(HybridTime::kMin);
+}
+
+QLRowCache::~QLRowCache() {
+  mem_tracker_->Release(size_bytes_);
+  mem_tracker_->UnregisterFromParent();
+}
+
+bool QLRowCache::Get(const Slice& encoded_doc_key, const Schema& projection,
+                     HybridTime read_time, QLTableRow* row) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = rows_.find(encoded_doc_key.ToBuffer());
+    if (it != rows_.end() && read_time >= it->second.valid_from) {
+      const auto& cached = it->second;
+      bool has_value = false;
+      bool covered = true;
+      for (size_t i = projection.num_key_columns(); i < projection.num_columns(); ++i) {
+        const auto column_id = projection.column_id(i);
+        if (!std::binary_search(cached.column_ids.begin(), cached.column_ids.end(), column_id)) {
+          covered = false;
+          break;
+        }
+        has_value = has_value || cached.row.GetColumn(column_id) != nullptr;
+      }
+      // The row is known to exist only when it has a value, see Insert.
+      if (covered && has_value) {
+        *row = cached.row;
+        lru_.splice(lru_.begin(), lru_, it->second.lru_position);
+        if (hits_) {
+          hits_->Increment();
+        }
+        return true;
+      }
+    }
+  }
+  if (misses_) {
+    misses_->Increment();
+  }
+  return false;
+}
+
+void QLRowCache::Insert(const Slice& encoded_doc_key, const Schema& projection,
+                        HybridTime read_time, const QLTableRow& row) {
+  CachedRow cached;
+  // The key columns of the row are charged as the key, since they have the same values.
+  cached.charge = 2 * encoded_doc_key.size() + sizeof(CachedRow);
+  cached.column_ids.reserve(projection.num_columns() - projection.num_key_columns());
+  bool has_value = false;
+  for (size_t i = projection.num_key_columns(); i < projection.num_columns(); ++i) {
+    if (CouldExpire(projection.column(i))) {
+      return;
+    }
+    const auto column_id = projection.column_id(i);
+    cached.column_ids.push_back(column_id);
+    const QLValuePB* value = row.GetColumn(column_id);
+    if (value == nullptr) {
+      continue;
+    }
+    int64_t ttl_seconds = -1;
+    if (!row.GetTTL(column_id, &ttl_seconds).ok() || ttl_seconds != -1) {
+      return;
+    }
+    has_value = true;
+    cached.charge += sizeof(ColumnId) + sizeof(QLTableColumn) + value->ByteSize();
+  }
+  // Without a value the row could exist only because of its liveness column, that could expire.
+  if (!has_value || cached.charge > capacity_bytes_) {
+    return;
+  }
+  std::sort(cached.column_ids.begin(), cached.column_ids.end());
+  cached.row = row;
+  cached.valid_from = read_time;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  // A write to the document could have been applied after the row was read.
+  if (read_time < last_write_ht_[WriteBucket(encoded_doc_key)]) {
+    return;
+  }
+  auto it = rows_.find(encoded_doc_key.ToBuffer());
+  if (it != rows_.end()) {
+    if (it->second.valid_from >= read_time) {
+      return;
+    }
+    EraseUnlocked(it);
+  }
+  while (size_bytes_ + cached.charge > capacity_bytes_ && !lru_.empty()) {
+    EraseUnlocked(rows_.find(*lru_.back()));
+  }
+  size_bytes_ += cached.charge;
+  mem_tracker_->Consume(cached.charge);
+  it = rows_.emplace(encoded_doc_key.ToBuffer(), std::move(cached)).first;
+  lru_.push_front(&it->first);
+  it->second.lru_position = lru_.begin();
+}
+
+void QLRowCache::Applied(const KeyValueWriteBatchPB& put_batch, HybridTime hybrid_time) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Slice last_doc_key;
+  for (const auto& kv_pair : put_batch.kv_pairs()) {
+    const Slice key(kv_pair.key());
+    // Values of the same document are usually written one after another.
+    if (!last_doc_key.empty() && key.starts_with(last_doc_key)) {
+      continue;
+    }
+    auto doc_key_size = DocKey::EncodedSize(key, DocKeyPart::WHOLE_DOC_KEY);
+    if (!doc_key_size.ok()) {
+      LOG(DFATAL) << "Failed to decode written key " << key.ToDebugHexString() << ": "
+                  << doc_key_size.status();
+      InvalidateAllUnlocked(hybrid_time);
+      return;
+    }
+    last_doc_key = Slice(key.data(), *doc_key_size);
+    InvalidateDocUnlocked(last_doc_key, hybrid_time);
+  }
+}
+
+void QLRowCache::Invalidate(const Slice& encoded_key, HybridTime hybrid_time) {
+  auto doc_key_size = DocKey::EncodedSize(encoded_key, DocKeyPart::WHOLE_DOC_KEY);
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!doc_key_size.ok()) {
+    LOG(DFATAL) << "Failed to decode written key " << encoded_key.ToDebugHexString() << ": "
+                << doc_key_size.status();
+    InvalidateAllUnlocked(hybrid_time);
+    return;
+  }
+  InvalidateDocUnlocked(Slice(encoded_key.data(), *doc_key_size), hybrid_time);
+}
+
+void QLRowCache::InvalidateDocUnlocked(const Slice& encoded_doc_key, HybridTime hybrid_time) {
+  auto& last_write_ht = last_write_ht_[WriteBucket(encoded_doc_key)];
+  last_write_ht = std::max(last_write_ht, hybrid_time);
+  auto it = rows_.find(encoded_doc_key.ToBuffer());
+  if (it != rows_.end()) {
+    EraseUnlocked(it);
+  }
+}
+
+void QLRowCache::EraseUnlocked(std::unordered_map<std::string, CachedRow>::iterator it) {
+  size_bytes_ -= it->second.charge;
+  mem_tracker_->Release(it->second.charge);
+  lru_.erase(it->second.lru_position);
+  rows_.erase(it);
+}
+
+void QLRowCache::InvalidateAll(HybridTime hybrid_time) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  InvalidateAllUnlocked(hybrid_time);
+}
+
+void QLRowCache::InvalidateAllUnlocked(HybridTime hybrid_time) {
+  for (auto& last_write_ht : last_write_ht_) {
+    last_write_ht = std::max(last_write_ht, hybrid_time);
+  }
+  mem_tracker_->Release(size_bytes_);
+  size_bytes_ = 0;
+  rows_.clear();
+  lru_.clear();
+}
+
+size_t QLRowCache::TEST_size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return rows_.size();
+}
+
+}  // namespace docdb
+}  // namespace yb
@@ -0,0 +1,119 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_QL_ROW_CACHE_H_
+#define YB_DOCDB_QL_ROW_CACHE_H_
+
+#include <array>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "yb/common/common.pb.h"
+#include "yb/common/hybrid_time.h"
+#include "yb/common/ql_expr.h"
+
+#include "yb/docdb/docdb.pb.h"
+
+#include "yb/gutil/ref_counted.h"
+
+#include "yb/util/slice.h"
+
+namespace yb {
+
+class Counter;
+class MemTracker;
+
+namespace docdb {
+
+// Bounded cache of rows recently read by point reads of one tablet, keyed by the encoded DocKey
+// of the row. Used by QLReadOperation so reads of hot rows don't have to go through RocksDB.
+//
+// A cached row is valid from the read time it was read at until a write to its document is
+// applied, so it is only served to reads at or after that time. Applied writes invalidate the
+// entries of their documents, and remember their hybrid time in a bucket of documents, so rows
+// read before a write that was applied concurrently with the read are not cached.
+//
+// Rows with values that could expire, i.e. with TTL or with collection columns, are not cached.
+//
+// This class is thread-safe.
+class QLRowCache {
+ public:
+  QLRowCache(size_t capacity_bytes, const std::shared_ptr<MemTracker>& parent_mem_tracker,
+             scoped_refptr<Counter> hits, scoped_refptr<Counter> misses);
+  ~QLRowCache();
+
+  // Fills row with the cached row of the document, if it is valid at read_time and has all
+  // columns of projection.
+  bool Get(const Slice& encoded_doc_key, const Schema& projection, HybridTime read_time,
+           QLTableRow* row);
+
+  // Caches row of the document, that was read at read_time with projection of its non-key
+  // columns.
+  void Insert(const Slice& encoded_doc_key, const Schema& projection, HybridTime read_time,
+              const QLTableRow& row);
+
+  // Invalidates documents written by key/value pairs of put_batch applied at hybrid_time.
+  void Applied(const KeyValueWriteBatchPB& put_batch, HybridTime hybrid_time);
+
+  // Invalidates the document of encoded_key, written at hybrid_time. Used for keys written
+  // without a put batch, e.g. when intents of a transaction are applied.
+  void Invalidate(const Slice& encoded_key, HybridTime hybrid_time);
+
+  // Invalidates all documents, used when data of the tablet is replaced at hybrid_time.
+  void InvalidateAll(HybridTime hybrid_time);
+
+  size_t TEST_size() const;
+
+ private:
+  static constexpr size_t kNumWriteBuckets = 256;
+
+  struct CachedRow {
+    QLTableRow row;
+    // Sorted ids of the non-key columns read into row.
+    std::vector<ColumnId> column_ids;
+    HybridTime valid_from;
+    size_t charge;
+    // Position of the key in lru_.
+    std::list<const std::string*>::iterator lru_position;
+  };
+
+  void InvalidateDocUnlocked(const Slice& encoded_doc_key, HybridTime hybrid_time);
+  void InvalidateAllUnlocked(HybridTime hybrid_time);
+  void EraseUnlocked(std::unordered_map<std::string, CachedRow>::iterator it);
+
+  static size_t WriteBucket(const Slice& encoded_doc_key) {
+    return encoded_doc_key.hash() % kNumWriteBuckets;
+  }
+
+  const size_t capacity_bytes_;
+  std::shared_ptr<MemTracker> mem_tracker_;
+  scoped_refptr<Counter> hits_;
+  scoped_refptr<Counter> misses_;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, CachedRow> rows_;
+  // Keys of rows_, the most recently used first.
+  std::list<const std::string*> lru_;
+  size_t size_bytes_ = 0;
+  // The latest hybrid time of applied writes to documents of each bucket.
+  std::array<HybridTime, kNumWriteBuckets> last_write_ht_;
+};
+
+}  // namespace docdb
+}  // namespace yb
+
+#endif  // YB_DOCDB_QL_ROW_CACHE_H_
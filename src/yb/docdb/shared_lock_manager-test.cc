@@ -19,6 +19,7 @@
 
 #include "yb/docdb/shared_lock_manager.h"
 
+#include "yb/util/format.h"
 #include "yb/util/test_macros.h"
 #include "yb/util/test_util.h"
 
@@ -373,6 +374,48 @@ TEST_F(SharedLockManagerTest, LockBatchMoveAssignment) {
   EXPECT_TRUE(lb.empty());
 }
 
+namespace {
+
+// Locks and unlocks batches of keys from several threads, each thread using its own keys, and
+// returns the number of batches per second.
+double LockUnlockThroughput(SharedLockManager* lock_manager, int num_threads, int num_iterations) {
+  constexpr int kKeysPerBatch = 4;
+  auto begin = std::chrono::steady_clock::now();
+  vector<thread> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.emplace_back([lock_manager, i, num_iterations]() {
+      for (int j = 0; j < num_iterations; ++j) {
+        KeyToIntentTypeMap batch;
+        for (int k = 0; k < kKeysPerBatch; ++k) {
+          batch.emplace(Format("key_$0_$1", i, (j + k) % 64), IntentType::kStrongSnapshotWrite);
+        }
+        lock_manager->Lock(batch);
+        lock_manager->Unlock(batch);
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+  return num_threads * num_iterations / elapsed.count();
+}
+
+} // namespace
+
+TEST_F(SharedLockManagerTest, ShardedLockManagerThroughput) {
+  constexpr int kNumThreads = 16;
+  const int num_iterations = AllowSlowTests() ? 200000 : 20000;
+
+  // A lock manager with a single shard behaves like a lock manager with one global mutex.
+  SharedLockManager single_shard(1);
+  const double single_shard_rate = LockUnlockThroughput(&single_shard, kNumThreads, num_iterations);
+  const double sharded_rate = LockUnlockThroughput(&lm_, kNumThreads, num_iterations);
+  LOG(INFO) << Format("Lock/unlock batches per second with $0 threads: 1 shard: $1, $2 shards: $3",
+                      kNumThreads, single_shard_rate, SharedLockManager::kDefaultNumShards,
+                      sharded_rate);
+}
+
 TEST_F(SharedLockManagerTest, LockBatchReset) {
   LockBatch lb(&lm_, {
       {"foo", IntentType::kStrongSnapshotWrite},
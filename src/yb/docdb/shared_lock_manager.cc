@@ -19,6 +19,7 @@
 #include <glog/logging.h>
 
 #include "yb/util/bytes_formatter.h"
+#include "yb/util/continuous_profiler.h"
 #include "yb/util/enums.h"
 #include "yb/util/logging.h"
 #include "yb/util/trace.h"
@@ -33,6 +34,9 @@ using util::to_underlying;
 
 namespace {
 
+// Maximum number of unused lock entries kept around by each shard.
+constexpr size_t kMaxFreeEntriesPerShard = 128;
+
 LockState Combine(std::initializer_list<IntentType> lock_types) {
   LockState state;
   for (auto type : lock_types) {
@@ -197,13 +201,17 @@ IntentType SharedLockManager::CombineIntents(const IntentType i1, const IntentTy
 }
 
 void SharedLockManager::LockEntry::Lock(IntentType lock_type) {
-  // TODO(bojanserafimov): Implement CAS fast path. Only wait when CAS fails.
   int type_idx = static_cast<size_t>(lock_type);
   std::unique_lock<std::mutex> lock(mutex);
-  auto& state = this->state;
-  cond_var.wait(lock, [&state, type_idx]() {
-    return (state & kIntentConflicts[type_idx]).none();
-  });
+  // Fast path: no conflicting lock is held, so there is no need to touch the condition variable.
+  if ((state & kIntentConflicts[type_idx]).any()) {
+    ++num_waiting;
+    LockWaitRecorder wait_recorder;
+    cond_var.wait(lock, [this, type_idx]() {
+      return (state & kIntentConflicts[type_idx]).none();
+    });
+    --num_waiting;
+  }
   ++num_holding[type_idx];
   state.set(type_idx);
 }
@@ -216,7 +224,7 @@ void SharedLockManager::LockEntry::Unlock(IntentType lock_type) {
     num_holding[type_idx]--;
     if (num_holding[type_idx] == 0) {
       state.reset(type_idx);
-      should_notify = (state == Combine({})
+      should_notify = num_waiting != 0 && (state == Combine({})
         || state == Combine({IntentType::kWeakSerializableRead})
         || state == Combine({IntentType::kWeakSerializableWrite}));
     }
@@ -228,6 +236,21 @@ void SharedLockManager::LockEntry::Unlock(IntentType lock_type) {
   }
 }
 
+SharedLockManager::SharedLockManager(size_t num_shards)
+    : num_shards_(num_shards), shards_(new LockShard[num_shards]) {
+  CHECK_GT(num_shards_, 0);
+}
+
+SharedLockManager::~SharedLockManager() {
+  for (size_t i = 0; i != num_shards_; ++i) {
+    DCHECK(shards_[i].locks.empty()) << "Lock manager destroyed while locks are held";
+  }
+}
+
+SharedLockManager::LockShard& SharedLockManager::ShardForKey(const std::string& key) {
+  return shards_[std::hash<std::string>()(key) % num_shards_];
+}
+
 void SharedLockManager::Lock(const KeyToIntentTypeMap& key_to_intent_type) {
   TRACE("Locking a batch of $0 keys", key_to_intent_type.size());
   std::vector<SharedLockManager::LockEntry*> reserved = Reserve(key_to_intent_type);
@@ -245,26 +268,36 @@ std::vector<SharedLockManager::LockEntry*> SharedLockManager::Reserve(
     const KeyToIntentTypeMap& key_to_intent_type) {
   std::vector<SharedLockManager::LockEntry*> reserved;
   reserved.reserve(key_to_intent_type.size());
-  {
-    std::lock_guard<std::mutex> lock(global_mutex_);
-    for (const auto& key_and_intent_type : key_to_intent_type) {
-      auto it = locks_.emplace(key_and_intent_type.first, std::make_unique<LockEntry>()).first;
-      it->second->num_using++;
-      reserved.push_back(&*it->second);
+  for (const auto& key_and_intent_type : key_to_intent_type) {
+    auto& shard = ShardForKey(key_and_intent_type.first);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto& entry = shard.locks[key_and_intent_type.first];
+    if (!entry) {
+      if (shard.free_entries.empty()) {
+        entry = std::make_unique<LockEntry>();
+      } else {
+        entry = std::move(shard.free_entries.back());
+        shard.free_entries.pop_back();
+      }
     }
+    entry->num_using++;
+    reserved.push_back(entry.get());
   }
   return reserved;
 }
 
 void SharedLockManager::Unlock(const KeyToIntentTypeMap& key_to_intent_type) {
   TRACE("Unlocking a batch of $0 keys", key_to_intent_type.size());
-  std::lock_guard<std::mutex> lock(global_mutex_);
   for (const auto& key_and_intent_type : boost::adaptors::reverse(key_to_intent_type)) {
     VLOG(4) << "Unlocking " << docdb::ToString(key_and_intent_type.second) << ": "
             << util::FormatBytesAsStr(key_and_intent_type.first);
-    locks_[key_and_intent_type.first]->Unlock(key_and_intent_type.second);
+    auto& shard = ShardForKey(key_and_intent_type.first);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.locks.find(key_and_intent_type.first);
+    DCHECK(it != shard.locks.end());
+    it->second->Unlock(key_and_intent_type.second);
+    Cleanup(&shard, it);
   }
-  Cleanup(key_to_intent_type);
 }
 
 void SharedLockManager::LockInTest(const string& key, IntentType intent_type) {
@@ -275,13 +308,14 @@ void SharedLockManager::UnlockInTest(const string& key, IntentType intent_type)
   Unlock({{key, intent_type}});
 }
 
-void SharedLockManager::Cleanup(const KeyToIntentTypeMap& key_to_intent_type) {
-  for (const auto& item : key_to_intent_type) {
-    auto it = locks_.find(item.first);
-    it->second->num_using--;
-    if (it->second->num_using == 0) {
-      locks_.erase(it);
+void SharedLockManager::Cleanup(LockShard* shard, LockEntryMap::iterator it) {
+  it->second->num_using--;
+  if (it->second->num_using == 0) {
+    DCHECK(it->second->state.none());
+    if (shard->free_entries.size() < kMaxFreeEntriesPerShard) {
+      shard->free_entries.push_back(std::move(it->second));
     }
+    shard->locks.erase(it);
   }
 }
 
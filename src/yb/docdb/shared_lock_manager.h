@@ -34,8 +34,16 @@ namespace docdb {
 // - Multiple kStrongSerializableRead and kWeakSerializableRead
 // - Multiple kStrongSerializableWrite and kWeakSerializableWrite
 // - Multiple kWeakSnapshotWrite, kWeakSerializableRead, and kWeakSerializableWrite
+//
+// Lock entries are kept in a fixed number of shards, selected by the hash of the key. Each shard has
+// its own mutex and its own pool of unused entries, so batches that touch different keys rarely
+// contend with each other, and a steady write load does not allocate a new entry per key per batch.
 class SharedLockManager {
  public:
+  static constexpr size_t kDefaultNumShards = 32;
+
+  explicit SharedLockManager(size_t num_shards = kDefaultNumShards);
+  ~SharedLockManager();
 
   // Attempt to lock a batch of keys. The call may be blocked waiting for other locks to be
   // released. If the entries don't exist, they are created. The lock batch gets associated with
@@ -63,9 +71,13 @@ class SharedLockManager {
 
     std::condition_variable cond_var;
 
-    // Refcounting for garbage collection. Can only be used while the global lock is held.
+    // Refcounting for garbage collection. Can only be used while the shard lock is held.
     size_t num_using = 0;
 
+    // Number of threads blocked on cond_var. Protected by mutex. Lets Unlock skip the notification
+    // in the common case when nobody is waiting.
+    size_t num_waiting = 0;
+
     // Number of holders for each type
     std::array<size_t, kIntentTypeMapSize> num_holding;
     LockState state;
@@ -81,19 +93,30 @@ class SharedLockManager {
 
   typedef std::unordered_map<std::string, std::unique_ptr<LockEntry>> LockEntryMap;
 
-  // Make sure the entries exist in the locks_ map and return pointers so we can access
-  // them without holding the global lock. Returns a vector with pointers in the same order
+  struct LockShard {
+    // The shard mutex should be taken only for very short duration, with no blocking wait.
+    std::mutex mutex;
+
+    // Can only be modified if the shard mutex is held.
+    LockEntryMap locks;
+
+    // Released entries kept for reuse. Protected by mutex.
+    std::vector<std::unique_ptr<LockEntry>> free_entries;
+  };
+
+  LockShard& ShardForKey(const std::string& key);
+
+  // Make sure the entries exist in the shard maps and return pointers so we can access
+  // them without holding the shard locks. Returns a vector with pointers in the same order
   // as the keys in the batch.
   std::vector<LockEntry*> Reserve(const KeyToIntentTypeMap& batch);
 
-  // Update refcounts and maybe collect garbage.
-  void Cleanup(const KeyToIntentTypeMap& key_to_intent_type);
-
-  // The global mutex should be taken only for very short duration, with no blocking wait.
-  std::mutex global_mutex_;
+  // Update the refcount of the entry for the given key and return it to the pool of its shard when
+  // it is no longer used. Requires that the shard lock is held.
+  void Cleanup(LockShard* shard, LockEntryMap::iterator it);
 
-  // Can only be modified if the global mutex is held.
-  LockEntryMap locks_;
+  const size_t num_shards_;
+  std::unique_ptr<LockShard[]> shards_;
 };
 
 extern const std::array<LockState, kIntentTypeMapSize> kIntentConflicts;
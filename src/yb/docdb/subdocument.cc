@@ -453,5 +453,15 @@ void SubDocument::ToQLValuePB(const SubDocument& doc,
   LOG(FATAL) << "Unsupported datatype in SubDocument: " << ql_type->ToString();
 }
 
+void SubDocument::ToQLValuePB(SubDocument&& doc,
+                              const shared_ptr<QLType>& ql_type,
+                              QLValuePB* ql_value) {
+  if (ql_type->HasComplexValues() || ql_type->main() == TUPLE) {
+    const SubDocument& const_doc = doc;
+    return ToQLValuePB(const_doc, ql_type, ql_value);
+  }
+  PrimitiveValue::ToQLValuePB(std::move(static_cast<PrimitiveValue&>(doc)), ql_type, ql_value);
+}
+
 }  // namespace docdb
 }  // namespace yb
@@ -168,6 +168,12 @@ class SubDocument : public PrimitiveValue {
                           const std::shared_ptr<QLType>& ql_type,
                           QLValuePB* v);
 
+  // The same, but moves the payload of a primitive doc into v instead of copying it. Collections
+  // are still copied.
+  static void ToQLValuePB(SubDocument&& doc,
+                          const std::shared_ptr<QLType>& ql_type,
+                          QLValuePB* v);
+
  private:
 
   CHECKED_STATUS ConvertToCollection(ValueType value_type);
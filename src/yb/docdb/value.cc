@@ -99,6 +99,10 @@ Status Value::Decode(const rocksdb::Slice& rocksdb_value) {
   RETURN_NOT_OK_PREPEND(
       DecodeUserTimestamp(&slice, &user_timestamp_),
       Format("Failed to decode user timestamp in $0", rocksdb_value.ToDebugHexString()));
+  counter_delta_ = DecodeValueType(slice) == ValueType::kCounterDelta;
+  if (counter_delta_) {
+    slice.consume_byte();
+  }
   RETURN_NOT_OK_PREPEND(
       primitive_value_.DecodeFromValue(slice),
       Format("Failed to decode value in $0", rocksdb_value.ToDebugHexString()));
@@ -113,6 +117,9 @@ string Value::ToString() const {
   if (user_timestamp_ != kInvalidUserTimestamp) {
     to_string += "; user_timestamp: " + std::to_string(user_timestamp_);
   }
+  if (counter_delta_) {
+    to_string += "; counter_delta";
+  }
   return to_string;
 }
 
@@ -131,6 +138,9 @@ void Value::EncodeAndAppend(std::string *value_bytes) const {
     value_bytes->push_back(static_cast<char>(ValueType::kUserTimestamp));
     AppendBigEndianUInt64(user_timestamp_, value_bytes);
   }
+  if (counter_delta_) {
+    value_bytes->push_back(static_cast<char>(ValueType::kCounterDelta));
+  }
   value_bytes->append(primitive_value_.ToValue());
 }
 
@@ -25,6 +25,7 @@ namespace docdb {
 // This class represents the data stored in the value portion of rocksdb. It consists of the TTL
 // for the given key, the user specified timestamp and finally the value. These items are encoded
 // into a RocksDB Slice in the order mentioned above. The TTL and user timestamp are optional.
+// A counter delta is marked with ValueType::kCounterDelta right before the value.
 class Value {
  public:
   Value() : primitive_value_(),
@@ -40,6 +41,14 @@ class Value {
         user_timestamp_(user_timestamp) {
   }
 
+  // Value that is added to the previous version of the same key when it is read, so counter
+  // increments could be written without reading the counter.
+  static Value CounterDelta(int64_t delta) {
+    Value result{PrimitiveValue(delta)};
+    result.counter_delta_ = true;
+    return result;
+  }
+
   static const MonoDelta kMaxTtl;
   static const int64_t kInvalidUserTimestamp;
   static constexpr int kBytesPerInt64 = sizeof(int64_t);
@@ -52,6 +61,8 @@ class Value {
 
   bool has_user_timestamp() const { return user_timestamp_ != kInvalidUserTimestamp; }
 
+  bool is_counter_delta() const { return counter_delta_; }
+
   ValueType value_type() const { return primitive_value_.value_type(); }
 
   PrimitiveValue* mutable_primitive_value() { return &primitive_value_; }
@@ -77,6 +88,7 @@ class Value {
   void EncodeAndAppend(std::string* value_bytes) const;
 
   // Decodes the ValueType of the primitive value stored in the given rocksdb_value.
+  // ValueType::kCounterDelta is returned for counter deltas.
   static CHECKED_STATUS DecodePrimitiveValueType(const rocksdb::Slice& rocksdb_value,
                                                  ValueType* value_type);
 
@@ -99,6 +111,8 @@ class Value {
   // The timestamp provided by the user as part of a 'USING TIMESTAMP' clause in CQL.
   UserTimeMicros user_timestamp_;
 
+  bool counter_delta_ = false;
+
   // If this value was written using a transaction,
   // this field stores the original intent doc hybrid time.
   DocHybridTime intent_doc_ht_;
@@ -64,8 +64,10 @@ string ToString(ValueType value_type) {
     case ValueType::kArray: return "Array";
     case ValueType::kArrayIndex: return "ArrayIndex";
     case ValueType::kTombstone: return "Tombstone";
+    case ValueType::kBlobRef: return "BlobRef";
     case ValueType::kTtl: return "Ttl";
     case ValueType::kUserTimestamp: return "UserTimestamp";
+    case ValueType::kCounterDelta: return "CounterDelta";
     case ValueType::kTransactionId: return "TransactionId";
     case ValueType::kIntentType: return "IntentType";
     case ValueType::kColumnId: return "ColumnId";
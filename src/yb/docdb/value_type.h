@@ -90,6 +90,8 @@ enum class ValueType : char {
   kString = 'S',  // ASCII code 83
   kTrue = 'T',  // ASCII code 84
   kTombstone = 'X',  // ASCII code 88
+  // Reference to a value stored in a blob file, see BlobStorage.
+  kBlobRef = 'Z',  // ASCII code 90
   kArrayIndex = '[',  // ASCII code 91.
 
   // We allow putting a 32-bit hash in front of the document key. This hash is computed based on
@@ -109,6 +111,9 @@ enum class ValueType : char {
   // TTL value in milliseconds, optionally present at the start of a value.
   kTtl = 't',  // ASCII code 116
   kUserTimestamp = 'u',  // ASCII code 117
+  // Marks a value that is added to the previous version of the same key instead of overwriting
+  // it, optionally present right before the primitive value. Used by counter increments.
+  kCounterDelta = 'v',  // ASCII code 118
   kTransactionId = 'x', // ASCII code 120
 
   kObject = '{',  // ASCII code 123
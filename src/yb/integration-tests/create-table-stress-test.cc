@@ -296,6 +296,27 @@ TEST_F(CreateTableStressTest, TestGetTableLocationsOptions) {
     ASSERT_EQ(FLAGS_num_test_tablets, resp.tablet_locations_size());
   }
 
+  // Ask with the version of the previous response, only changed tablets should be returned, so
+  // no tablets are returned once leaders are settled.
+  LOG(INFO) << CURRENT_TEST_NAME() << ": Step 7. Asking for changed tablets...";
+  LOG_TIMING(INFO, "asking for changed tablets") {
+    ASSERT_OK(WaitFor([this, &table_name, &req, &resp]() -> Result<bool> {
+      const auto known_version = resp.locations_version();
+      req.Clear();
+      resp.Clear();
+      table_name.SetIntoTableIdentifierPB(req.mutable_table());
+      req.set_max_returned_locations(FLAGS_num_test_tablets);
+      req.set_known_locations_version(known_version);
+      RETURN_NOT_OK(
+          cluster_->mini_master()->master()->catalog_manager()->GetTableLocations(&req, &resp));
+      if (resp.locations_version() < known_version) {
+        return STATUS_FORMAT(IllegalState, "Locations version decreased: $0 => $1",
+                             known_version, resp.locations_version());
+      }
+      return resp.tablet_locations_size() == 0;
+    }, MonoDelta::FromSeconds(30), "Unchanged tablet locations"));
+  }
+
   LOG(INFO) << "========================================================";
   LOG(INFO) << "Tables and tablets:";
   LOG(INFO) << "========================================================";
@@ -13,6 +13,7 @@
 
 #include "yb/integration-tests/load_generator.h"
 
+#include <cmath>
 #include <memory>
 #include <queue>
 #include <random>
@@ -30,6 +31,7 @@
 #include "yb/gutil/strings/split.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/util/atomic.h"
+#include "yb/util/enums.h"
 #include "yb/util/env.h"
 #include "yb/util/flags.h"
 #include "yb/util/logging.h"
@@ -214,7 +216,8 @@ MultiThreadedAction::MultiThreadedAction(
       client_id_(client_id),
       running_threads_latch_(num_action_threads),
       stop_requested_(stop_requested_flag),
-      value_size_(value_size) {
+      value_size_(value_size),
+      latency_histogram_(MonoDelta::FromSeconds(60).ToMicroseconds(), 3) {
   CHECK_OK(
       ThreadPoolBuilder(description)
           .set_max_threads(num_action_threads_ + num_extra_threads)
@@ -257,6 +260,37 @@ void MultiThreadedAction::WaitForCompletion() {
   thread_pool_->Wait();
 }
 
+namespace {
+
+// Paces the operations of one action thread, see MultiThreadedAction::set_target_ops_per_sec.
+class OpPacer {
+ public:
+  explicit OpPacer(double ops_per_sec)
+      : interval_usec_(ops_per_sec > 0 ? 1000000.0 / ops_per_sec : 0),
+        start_usec_(GetMonoTimeMicros()) {}
+
+  // Waits until the next operation is due and returns the time it was scheduled to start.
+  // In closed loop mode returns the current time.
+  MicrosecondsInt64 WaitForNextOp() {
+    const MicrosecondsInt64 now = GetMonoTimeMicros();
+    if (interval_usec_ <= 0) {
+      return now;
+    }
+    const MicrosecondsInt64 scheduled = start_usec_ + interval_usec_ * num_ops_++;
+    if (scheduled > now) {
+      SleepFor(MonoDelta::FromMicroseconds(scheduled - now));
+    }
+    return scheduled;
+  }
+
+ private:
+  const double interval_usec_;
+  const MicrosecondsInt64 start_usec_;
+  int64_t num_ops_ = 0;
+};
+
+} // namespace
+
 // ------------------------------------------------------------------------------------------------
 // MultiThreadedWriter
 // ------------------------------------------------------------------------------------------------
@@ -295,6 +329,7 @@ void MultiThreadedWriter::RunActionThread(int writer_index) {
 void SingleThreadedWriter::Run() {
   LOG(INFO) << "Writer thread " << writer_index_ << " started";
   ConfigureSession();
+  OpPacer pacer(multi_threaded_writer_->ThreadTargetOpsPerSec());
   while (!multi_threaded_writer_->IsStopRequested()) {
     if (pause_flag_ && pause_flag_->load(std::memory_order_acquire)) {
       std::this_thread::sleep_for(10ms);
@@ -308,7 +343,10 @@ void SingleThreadedWriter::Run() {
     string key_str(multi_threaded_writer_->GetKeyByIndex(key_index));
     string value_str(multi_threaded_writer_->GetValueByIndex(key_index));
 
-    if (Write(key_index, key_str, value_str)) {
+    const MicrosecondsInt64 start_usec = pacer.WaitForNextOp();
+    const bool success = Write(key_index, key_str, value_str);
+    multi_threaded_writer_->latency_histogram_.Increment(GetMonoTimeMicros() - start_usec);
+    if (success) {
       multi_threaded_writer_->inserted_keys_.Insert(key_index);
     } else {
       multi_threaded_writer_->failed_keys_.Insert(key_index);
@@ -673,13 +711,16 @@ void SingleThreadedReader::Run() {
     SleepFor(MonoDelta::FromMilliseconds(10));
   }
 
+  OpPacer pacer(multi_threaded_reader_->ThreadTargetOpsPerSec());
   while (!multi_threaded_reader_->IsStopRequested()) {
     const int64_t key_index = NextKeyIndexToRead(&random_number_generator);
 
     ++multi_threaded_reader_->num_reads_;
     const string key_str(multi_threaded_reader_->GetKeyByIndex(key_index));
     const string expected_value_str(multi_threaded_reader_->GetValueByIndex(key_index));
+    const MicrosecondsInt64 start_usec = pacer.WaitForNextOp();
     const ReadStatus read_status = PerformRead(key_index, key_str, expected_value_str);
+    multi_threaded_reader_->latency_histogram_.Increment(GetMonoTimeMicros() - start_usec);
 
     // Read operation returning zero rows is treated as a read error.
     // See: https://yugabyte.atlassian.net/browse/ENG-1272
@@ -691,10 +732,56 @@ void SingleThreadedReader::Run() {
   CloseSession();
 }
 
-int64_t SingleThreadedReader::NextKeyIndexToRead(std::mt19937_64* random_number_generator) const {
+int64_t SingleThreadedReader::PickKeyIndex(
+    int64_t num_keys, std::mt19937_64* random_number_generator) {
+  const auto& options = multi_threaded_reader_->key_distribution_;
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+  switch (options.distribution) {
+    case KeyDistribution::kDefault: FALLTHROUGH_INTENDED;
+    case KeyDistribution::kUniform:
+      return (*random_number_generator)() % num_keys;
+    case KeyDistribution::kHotspot: {
+      const int64_t num_hot_keys = std::max<int64_t>(1, num_keys * options.hotspot_keys_fraction);
+      if (uniform(*random_number_generator) < options.hotspot_ops_fraction) {
+        return (*random_number_generator)() % num_hot_keys;
+      }
+      return (*random_number_generator)() % num_keys;
+    }
+    case KeyDistribution::kZipfian: {
+      // "Quickly generating billion-record synthetic databases", Gray et al, SIGMOD 1994.
+      const double theta = options.zipfian_theta;
+      for (; zipfian_num_keys_ < num_keys; ++zipfian_num_keys_) {
+        zipfian_zeta_ += 1.0 / std::pow(zipfian_num_keys_ + 1, theta);
+      }
+      const double zeta2 = 1.0 + 1.0 / std::pow(2.0, theta);
+      const double alpha = 1.0 / (1.0 - theta);
+      const double eta = (1.0 - std::pow(2.0 / num_keys, 1.0 - theta)) /
+                         (1.0 - zeta2 / zipfian_zeta_);
+      const double u = uniform(*random_number_generator);
+      const double uz = u * zipfian_zeta_;
+      if (uz < 1.0) {
+        return 0;
+      }
+      if (uz < zeta2) {
+        return std::min<int64_t>(1, num_keys - 1);
+      }
+      return std::min<int64_t>(num_keys * std::pow(eta * u - eta + 1.0, alpha), num_keys - 1);
+    }
+  }
+  FATAL_INVALID_ENUM_VALUE(KeyDistribution, options.distribution);
+}
+
+int64_t SingleThreadedReader::NextKeyIndexToRead(std::mt19937_64* random_number_generator) {
   int64_t key_index = 0;
   VLOG(3) << "Reader thread " << reader_index_ << " waiting to load insertion point";
   int64_t written_up_to = multi_threaded_reader_->insertion_point_->load();
+  if (multi_threaded_reader_->key_distribution_.distribution != KeyDistribution::kDefault) {
+    do {
+      key_index = PickKeyIndex(written_up_to + 1, random_number_generator);
+    } while (multi_threaded_reader_->failed_keys_->Contains(key_index) &&
+             !multi_threaded_reader_->IsStopRequested());
+    return key_index;
+  }
   do {
     VLOG(3) << "Reader thread " << reader_index_ << " coin toss";
     switch ((*random_number_generator)() % 3) {
@@ -28,6 +28,7 @@
 #include "yb/gutil/stl_util.h"
 #include "yb/util/threadpool.h"
 #include "yb/util/countdown_latch.h"
+#include "yb/util/hdr_histogram.h"
 #include "yb/util/test_util.h"
 
 using std::shared_ptr;
@@ -126,10 +127,24 @@ class MultiThreadedAction {
   void set_client_id(const std::string& client_id) { client_id_ = client_id; }
   bool IsRunning() { return running_threads_latch_.count() > 0; }
 
+  // Runs the action open loop at the given total rate: operations are issued on a fixed schedule
+  // and their latency is measured from the scheduled start time, so that a slow server is not
+  // hidden by the load generator backing off ("coordinated omission"). Zero means closed loop.
+  // Should be set before Start().
+  void set_target_ops_per_sec(double target_ops_per_sec) {
+    target_ops_per_sec_ = target_ops_per_sec;
+  }
+
+  // Latencies of the operations performed by this action, in microseconds.
+  const HdrHistogram& latency_histogram() const { return latency_histogram_; }
+
  protected:
   friend class SingleThreadedReader;
   friend class SingleThreadedWriter;
 
+  // Rate of operations of a single action thread, see set_target_ops_per_sec.
+  double ThreadTargetOpsPerSec() const { return target_ops_per_sec_ / num_action_threads_; }
+
   std::string GetKeyByIndex(int64_t key_index);
 
   // The value returned is compared as a string on read, so having a '\0' will use incorrect size.
@@ -152,6 +167,9 @@ class MultiThreadedAction {
   std::atomic<bool> paused_ { false };
 
   const int value_size_;
+
+  double target_ops_per_sec_ = 0;
+  HdrHistogram latency_histogram_;
 };
 
 // ------------------------------------------------------------------------------------------------
@@ -299,6 +317,24 @@ class SingleThreadedScanner {
 
 enum class ReadStatus { OK, NO_ROWS, OTHER_ERROR };
 
+// Distribution of the keys read by MultiThreadedReader, among the keys written so far.
+enum class KeyDistribution {
+  // Mix of the latest written keys and uniformly distributed older keys.
+  kDefault,
+  kUniform,
+  // Zipfian distribution, with the oldest keys being the most popular ones.
+  kZipfian,
+  // A fixed fraction of reads goes to a fixed fraction of the oldest keys.
+  kHotspot,
+};
+
+struct KeyDistributionOptions {
+  KeyDistribution distribution = KeyDistribution::kDefault;
+  double zipfian_theta = 0.99;
+  double hotspot_keys_fraction = 0.01;
+  double hotspot_ops_fraction = 0.9;
+};
+
 class MultiThreadedReader : public MultiThreadedAction {
  public:
   MultiThreadedReader(int64_t num_keys, int num_reader_threads,
@@ -311,6 +347,10 @@ class MultiThreadedReader : public MultiThreadedAction {
 
   void IncrementReadErrorCount(ReadStatus read_status);
 
+  void set_key_distribution(const KeyDistributionOptions& options) {
+    key_distribution_ = options;
+  }
+
   int64_t num_reads() { return num_reads_; }
   int64_t num_read_errors() { return num_read_errors_.load(); }
   void AssertSucceeded() { ASSERT_EQ(num_read_errors(), 0); }
@@ -332,6 +372,7 @@ class MultiThreadedReader : public MultiThreadedAction {
   std::atomic<int64_t> num_read_errors_;
   const int max_num_read_errors_;
   const bool stop_on_empty_read_;
+  KeyDistributionOptions key_distribution_;
 };
 
 class SingleThreadedReader {
@@ -352,7 +393,14 @@ class SingleThreadedReader {
   virtual void ConfigureSession() = 0;
   virtual void CloseSession() = 0;
 
-  int64_t NextKeyIndexToRead(std::mt19937_64* random_number_generator) const;
+  int64_t NextKeyIndexToRead(std::mt19937_64* random_number_generator);
+
+  // Picks a key index in [0, num_keys) according to the configured key distribution.
+  int64_t PickKeyIndex(int64_t num_keys, std::mt19937_64* random_number_generator);
+
+  // Incrementally maintained zeta(zipfian_num_keys_, theta) for the zipfian distribution.
+  int64_t zipfian_num_keys_ = 0;
+  double zipfian_zeta_ = 0;
 };
 
 class YBSingleThreadedReader : public SingleThreadedReader {
@@ -727,6 +727,22 @@ TEST_F(RaftConsensusITest, TestCatchupAfterOpsEvicted) {
   ASSERT_ALL_REPLICAS_AGREE(kNumWrites);
 }
 
+// A follower that was paused receives many committed writes with a single update, and applies them
+// in batches.
+TEST_F(RaftConsensusITest, TestCatchupWithBatchedApply) {
+  ASSERT_NO_FATALS(BuildAndStart({"--follower_apply_batch_max_ops=16"}));
+  TServerDetails* replica = (*tablet_replicas_.begin()).second;
+  ASSERT_TRUE(replica != nullptr);
+  ExternalTabletServer* replica_ets = cluster_->tablet_server_by_uuid(replica->uuid());
+
+  ASSERT_OK(replica_ets->Pause());
+  const int kNumRows = 1000;
+  InsertTestRowsRemoteThread(0, kNumRows, kNumRows / 2, vector<CountDownLatch*>());
+  ASSERT_OK(replica_ets->Resume());
+
+  ASSERT_ALL_REPLICAS_AGREE(kNumRows);
+}
+
 void RaftConsensusITest::CauseFollowerToFallBehindLogGC(string* leader_uuid,
                                                         int64_t* orig_term,
                                                         string* fell_behind_uuid) {
@@ -23,6 +23,7 @@
 #include "yb/integration-tests/load_generator.h"
 #include "yb/integration-tests/test_workload.h"
 #include "yb/integration-tests/yb_table_test_base.h"
+#include "yb/master/master.proxy.h"
 #include "yb/util/metrics.h"
 #include "yb/util/test_util.h"
 
@@ -153,5 +154,43 @@ TEST_F(StepDownUnderLoadTest, TestStepDownUnderLoad) {
       writer.num_writes()));
 }
 
+class DrainLeadersTest : public YBTableTestBase {
+ public:
+  bool use_external_mini_cluster() override { return true; }
+  int num_tablets() override { return 6; }
+};
+
+TEST_F(DrainLeadersTest, TestDrainLeaders) {
+  auto* const emc = external_mini_cluster();
+  TabletServerMap ts_map;
+  ASSERT_OK(itest::CreateTabletServerMap(emc->master_proxy().get(), emc->messenger(), &ts_map));
+
+  const auto drained_uuid = ts_map.begin()->first;
+  vector<TabletId> tablet_ids;
+  ASSERT_OK(ListRunningTabletIds(ts_map[drained_uuid].get(), kDefaultTimeout, &tablet_ids));
+  ASSERT_EQ(num_tablets(), tablet_ids.size());
+
+  // The master could have a stale view of the leaders, so drain until none is left.
+  ASSERT_OK(WaitFor([&]() -> Result<bool> {
+    master::DrainLeadersRequestPB req;
+    master::DrainLeadersResponsePB resp;
+    req.set_ts_uuid(drained_uuid);
+    rpc::RpcController rpc;
+    rpc.set_timeout(kDefaultTimeout);
+    RETURN_NOT_OK(emc->master_proxy()->DrainLeaders(req, &resp, &rpc));
+    if (resp.has_error()) {
+      return StatusFromPB(resp.error().status());
+    }
+    for (const auto& tablet_id : tablet_ids) {
+      TServerDetails* leader = nullptr;
+      RETURN_NOT_OK(FindTabletLeader(ts_map, tablet_id, kDefaultTimeout, &leader));
+      if (leader->uuid() == drained_uuid) {
+        return false;
+      }
+    }
+    return true;
+  }, kDefaultTimeout, "Drain leaders"));
+}
+
 }  // namespace itest
 }  // namespace yb
@@ -326,27 +326,41 @@ Status RetryingTSRpcTask::ResetTSProxy() {
 // ============================================================================
 //  Class AsyncCreateReplica.
 // ============================================================================
+namespace {
+
+void FillCreateTabletRequest(const scoped_refptr<TabletInfo>& tablet,
+                             const TabletServerId& initial_leader_uuid,
+                             tserver::CreateTabletRequestPB* req) {
+  auto table_lock = tablet->table()->LockForRead();
+  const SysTabletsEntryPB& tablet_pb = tablet->metadata().dirty().pb;
+
+  req->set_table_id(tablet->table()->id());
+  req->set_tablet_id(tablet->tablet_id());
+  req->set_table_type(tablet->table()->metadata().state().pb.table_type());
+  req->mutable_partition()->CopyFrom(tablet_pb.partition());
+  req->set_table_name(table_lock->data().pb.name());
+  req->mutable_schema()->CopyFrom(table_lock->data().pb.schema());
+  req->mutable_partition_schema()->CopyFrom(table_lock->data().pb.partition_schema());
+  req->mutable_config()->CopyFrom(tablet_pb.committed_consensus_state().config());
+  if (!initial_leader_uuid.empty()) {
+    req->set_initial_leader_uuid(initial_leader_uuid);
+  }
+}
+
+} // namespace
+
 AsyncCreateReplica::AsyncCreateReplica(Master *master,
                                        ThreadPool *callback_pool,
                                        const string& permanent_uuid,
-                                       const scoped_refptr<TabletInfo>& tablet)
+                                       const scoped_refptr<TabletInfo>& tablet,
+                                       const TabletServerId& initial_leader_uuid)
   : RetrySpecificTSRpcTask(master, callback_pool, permanent_uuid, tablet->table().get()),
     tablet_id_(tablet->tablet_id()) {
   deadline_ = start_ts_;
   deadline_.AddDelta(MonoDelta::FromMilliseconds(FLAGS_tablet_creation_timeout_ms));
 
-  auto table_lock = tablet->table()->LockForRead();
-  const SysTabletsEntryPB& tablet_pb = tablet->metadata().dirty().pb;
-
   req_.set_dest_uuid(permanent_uuid);
-  req_.set_table_id(tablet->table()->id());
-  req_.set_tablet_id(tablet->tablet_id());
-  req_.set_table_type(tablet->table()->metadata().state().pb.table_type());
-  req_.mutable_partition()->CopyFrom(tablet_pb.partition());
-  req_.set_table_name(table_lock->data().pb.name());
-  req_.mutable_schema()->CopyFrom(table_lock->data().pb.schema());
-  req_.mutable_partition_schema()->CopyFrom(table_lock->data().pb.partition_schema());
-  req_.mutable_config()->CopyFrom(tablet_pb.committed_consensus_state().config());
+  FillCreateTabletRequest(tablet, initial_leader_uuid, &req_);
 }
 
 void AsyncCreateReplica::HandleResponse(int attempt) {
@@ -374,9 +388,92 @@ bool AsyncCreateReplica::SendRequest(int attempt) {
   return true;
 }
 
+// ============================================================================
+//  Class AsyncCreateReplicas.
+// ============================================================================
+AsyncCreateReplicas::AsyncCreateReplicas(Master *master,
+                                         ThreadPool *callback_pool,
+                                         const string& permanent_uuid,
+                                         const std::vector<TabletToCreate>& tablets)
+  : RetrySpecificTSRpcTask(master, callback_pool, permanent_uuid,
+                           tablets.front().tablet->table().get()) {
+  deadline_ = start_ts_;
+  deadline_.AddDelta(MonoDelta::FromMilliseconds(FLAGS_tablet_creation_timeout_ms));
+
+  req_.set_dest_uuid(permanent_uuid);
+  for (const auto& tablet : tablets) {
+    DCHECK_EQ(tablet.tablet->table().get(), tablets.front().tablet->table().get());
+    FillCreateTabletRequest(tablet.tablet, tablet.initial_leader_uuid, req_.add_tablets());
+  }
+}
+
+std::string AsyncCreateReplicas::description() const {
+  return Format("CreateTablets RPC for $0 tablets, starting from $1, on TS $2",
+                req_.tablets_size(), tablet_id(), permanent_uuid_);
+}
+
+TabletId AsyncCreateReplicas::tablet_id() const {
+  return req_.tablets().empty() ? TabletId() : req_.tablets(0).tablet_id();
+}
+
+void AsyncCreateReplicas::HandleResponse(int attempt) {
+  if (resp_.has_error()) {
+    LOG(WARNING) << "CreateTablets RPC for " << req_.tablets_size() << " tablets on TS "
+                 << permanent_uuid_ << " failed: " << StatusFromPB(resp_.error().status());
+    return;
+  }
+
+  std::unordered_set<TabletId> failed_tablets;
+  for (const auto& tablet_error : resp_.tablet_errors()) {
+    Status s = StatusFromPB(tablet_error.error().status());
+    if (s.IsAlreadyPresent()) {
+      LOG(INFO) << "CreateTablet for tablet " << tablet_error.tablet_id()
+                << " on TS " << permanent_uuid_ << " returned already present: " << s;
+    } else {
+      LOG(WARNING) << "CreateTablet for tablet " << tablet_error.tablet_id()
+                   << " on TS " << permanent_uuid_ << " failed: " << s;
+      failed_tablets.insert(tablet_error.tablet_id());
+    }
+  }
+
+  if (failed_tablets.empty()) {
+    PerformStateTransition(kStateRunning, kStateComplete);
+    return;
+  }
+
+  // Only tablets that failed are sent on retry.
+  google::protobuf::RepeatedPtrField<tserver::CreateTabletRequestPB> remaining;
+  for (auto& tablet_req : *req_.mutable_tablets()) {
+    if (failed_tablets.count(tablet_req.tablet_id())) {
+      remaining.Add()->Swap(&tablet_req);
+    }
+  }
+  req_.mutable_tablets()->Swap(&remaining);
+}
+
+bool AsyncCreateReplicas::SendRequest(int attempt) {
+  ts_admin_proxy_->CreateTabletsAsync(req_, &resp_, &rpc_, BindRpcCallback());
+  VLOG(1) << "Send create tablets request to " << permanent_uuid_
+          << " (attempt " << attempt << ") for " << req_.tablets_size() << " tablets";
+  return true;
+}
+
 // ============================================================================
 //  Class AsyncDeleteReplica.
 // ============================================================================
+namespace {
+
+void NotifyTabletDeleteDone(Master* master, const TabletServerId& permanent_uuid,
+                            const TabletId& tablet_id) {
+  master->catalog_manager()->NotifyTabletDeleteFinished(permanent_uuid, tablet_id);
+  shared_ptr<TSDescriptor> ts_desc;
+  if (master->ts_manager()->LookupTSByUUID(permanent_uuid, &ts_desc)) {
+    ts_desc->ClearPendingTabletDelete(tablet_id);
+  }
+}
+
+} // namespace
+
 void AsyncDeleteReplica::HandleResponse(int attempt) {
   bool delete_done = false;
   if (resp_.has_error()) {
@@ -423,11 +520,7 @@ void AsyncDeleteReplica::HandleResponse(int attempt) {
     VLOG(1) << "TS " << permanent_uuid_ << ": delete complete on tablet " << tablet_id_;
   }
   if (delete_done) {
-    master_->catalog_manager()->NotifyTabletDeleteFinished(permanent_uuid_, tablet_id_);
-    shared_ptr<TSDescriptor> ts_desc;
-    if (master_->ts_manager()->LookupTSByUUID(permanent_uuid_, &ts_desc)) {
-      ts_desc->ClearPendingTabletDelete(tablet_id_);
-    }
+    NotifyTabletDeleteDone(master_, permanent_uuid_, tablet_id_);
   }
 }
 
@@ -448,6 +541,98 @@ bool AsyncDeleteReplica::SendRequest(int attempt) {
   return true;
 }
 
+// ============================================================================
+//  Class AsyncDeleteReplicas.
+// ============================================================================
+AsyncDeleteReplicas::AsyncDeleteReplicas(
+    Master* master, ThreadPool* callback_pool, const string& permanent_uuid,
+    const scoped_refptr<TableInfo>& table, const std::vector<TabletId>& tablet_ids,
+    tablet::TabletDataState delete_type, const string& reason)
+    : RetrySpecificTSRpcTask(master, callback_pool, permanent_uuid, table) {
+  req_.set_dest_uuid(permanent_uuid);
+  for (const auto& tablet_id : tablet_ids) {
+    auto* tablet_req = req_.add_tablets();
+    tablet_req->set_tablet_id(tablet_id);
+    tablet_req->set_reason(reason);
+    tablet_req->set_delete_type(delete_type);
+  }
+}
+
+std::string AsyncDeleteReplicas::description() const {
+  return Format("DeleteTablets RPC for $0 tablets, starting from $1, on TS $2",
+                req_.tablets_size(), tablet_id(), permanent_uuid_);
+}
+
+TabletId AsyncDeleteReplicas::tablet_id() const {
+  return req_.tablets().empty() ? TabletId() : req_.tablets(0).tablet_id();
+}
+
+void AsyncDeleteReplicas::HandleResponse(int attempt) {
+  if (resp_.has_error()) {
+    Status status = StatusFromPB(resp_.error().status());
+    TabletServerErrorPB::Code code = resp_.error().code();
+    if (code == TabletServerErrorPB::WRONG_SERVER_UUID) {
+      LOG(WARNING) << "TS " << permanent_uuid_ << ": delete failed for " << req_.tablets_size()
+                   << " tablets due to a incorrect UUID. No further retry: " << status;
+      for (const auto& tablet_req : req_.tablets()) {
+        NotifyTabletDeleteDone(master_, permanent_uuid_, tablet_req.tablet_id());
+      }
+      PerformStateTransition(kStateRunning, kStateComplete);
+    } else {
+      LOG(WARNING) << "TS " << permanent_uuid_ << ": delete failed for " << req_.tablets_size()
+                   << " tablets with error code " << TabletServerErrorPB::Code_Name(code)
+                   << ": " << status;
+    }
+    return;
+  }
+
+  std::unordered_set<TabletId> failed_tablets;
+  for (const auto& tablet_error : resp_.tablet_errors()) {
+    Status status = StatusFromPB(tablet_error.error().status());
+    TabletServerErrorPB::Code code = tablet_error.error().code();
+    switch (code) {
+      case TabletServerErrorPB::TABLET_NOT_FOUND:
+      case TabletServerErrorPB::CAS_FAILED:
+        LOG(WARNING) << "TS " << permanent_uuid_ << ": delete failed for tablet "
+                     << tablet_error.tablet_id() << " with error code "
+                     << TabletServerErrorPB::Code_Name(code) << ". No further retry: " << status;
+        break;
+      default:
+        LOG(WARNING) << "TS " << permanent_uuid_ << ": delete failed for tablet "
+                     << tablet_error.tablet_id() << " with error code "
+                     << TabletServerErrorPB::Code_Name(code) << ": " << status;
+        failed_tablets.insert(tablet_error.tablet_id());
+        break;
+    }
+  }
+
+  LOG(INFO) << "TS " << permanent_uuid_ << ": "
+            << req_.tablets_size() - failed_tablets.size() << " tablets of table "
+            << (table_ ? table_->ToString() : "<unknown>") << " deleted";
+
+  // Only tablets that failed are sent on retry.
+  google::protobuf::RepeatedPtrField<tserver::DeleteTabletRequestPB> remaining;
+  for (auto& tablet_req : *req_.mutable_tablets()) {
+    if (failed_tablets.count(tablet_req.tablet_id())) {
+      remaining.Add()->Swap(&tablet_req);
+    } else {
+      NotifyTabletDeleteDone(master_, permanent_uuid_, tablet_req.tablet_id());
+    }
+  }
+  req_.mutable_tablets()->Swap(&remaining);
+
+  if (failed_tablets.empty()) {
+    PerformStateTransition(kStateRunning, kStateComplete);
+  }
+}
+
+bool AsyncDeleteReplicas::SendRequest(int attempt) {
+  ts_admin_proxy_->DeleteTabletsAsync(req_, &resp_, &rpc_, BindRpcCallback());
+  VLOG(1) << "Send delete tablets request to " << permanent_uuid_
+          << " (attempt " << attempt << ") for " << req_.tablets_size() << " tablets";
+  return true;
+}
+
 // ============================================================================
 //  Class AsyncAlterTable.
 // ============================================================================
@@ -529,6 +714,105 @@ bool AsyncAlterTable::SendRequest(int attempt) {
   return true;
 }
 
+// ============================================================================
+//  Class AsyncAlterTablets.
+// ============================================================================
+AsyncAlterTablets::AsyncAlterTablets(Master *master,
+                                     ThreadPool* callback_pool,
+                                     const TabletServerId& leader_uuid,
+                                     const std::vector<scoped_refptr<TabletInfo>>& tablets)
+  : RetrySpecificTSRpcTask(master, callback_pool, leader_uuid, tablets.front()->table().get()),
+    tablets_(tablets) {
+}
+
+string AsyncAlterTablets::description() const {
+  return Format("AlterSchemas RPC for $0 tablets, starting from $1, on TS $2",
+                tablets_.size(), tablet_id(), permanent_uuid_);
+}
+
+TabletId AsyncAlterTablets::tablet_id() const {
+  return tablets_.empty() ? TabletId() : tablets_.front()->tablet_id();
+}
+
+void AsyncAlterTablets::HandleResponse(int attempt) {
+  server::UpdateClock(resp_, master_->clock());
+
+  if (resp_.has_error()) {
+    LOG(WARNING) << "TS " << permanent_uuid_ << ": alter failed for " << tablets_.size()
+                 << " tablets: " << StatusFromPB(resp_.error().status());
+    return;
+  }
+
+  std::unordered_set<TabletId> failed_tablets;
+  std::unordered_set<TabletId> moved_tablets;
+  for (const auto& tablet_error : resp_.tablet_errors()) {
+    Status status = StatusFromPB(tablet_error.error().status());
+    switch (tablet_error.error().code()) {
+      case TabletServerErrorPB::TABLET_NOT_FOUND:
+      case TabletServerErrorPB::MISMATCHED_SCHEMA:
+      case TabletServerErrorPB::TABLET_HAS_A_NEWER_SCHEMA:
+        LOG(WARNING) << "TS " << permanent_uuid_ << ": alter failed for tablet "
+                     << tablet_error.tablet_id() << " no further retry: " << status;
+        break;
+      case TabletServerErrorPB::NOT_THE_LEADER:
+        VLOG(1) << "TS " << permanent_uuid_ << " is not the leader of tablet "
+                << tablet_error.tablet_id() << " anymore";
+        moved_tablets.insert(tablet_error.tablet_id());
+        break;
+      default:
+        LOG(WARNING) << "TS " << permanent_uuid_ << ": alter failed for tablet "
+                     << tablet_error.tablet_id() << ": " << status;
+        failed_tablets.insert(tablet_error.tablet_id());
+        break;
+    }
+  }
+
+  // Only tablets that failed are sent on retry.
+  std::vector<scoped_refptr<TabletInfo>> remaining;
+  for (const auto& tablet : tablets_) {
+    if (failed_tablets.count(tablet->tablet_id())) {
+      remaining.push_back(tablet);
+    } else if (moved_tablets.count(tablet->tablet_id())) {
+      master_->catalog_manager()->SendAlterTabletRequest(tablet);
+    } else {
+      // TODO: proper error handling here.
+      CHECK_OK(master_->catalog_manager()->HandleTabletSchemaVersionReport(
+          tablet.get(), schema_version_));
+    }
+  }
+  tablets_.swap(remaining);
+
+  if (tablets_.empty()) {
+    PerformStateTransition(kStateRunning, kStateComplete);
+  } else {
+    VLOG(1) << "Task is not completed";
+  }
+}
+
+bool AsyncAlterTablets::SendRequest(int attempt) {
+  auto l = table_->LockForRead();
+
+  tserver::AlterSchemasRequestPB req;
+  req.set_dest_uuid(permanent_uuid_);
+  for (const auto& tablet : tablets_) {
+    auto* tablet_req = req.add_tablets();
+    tablet_req->set_tablet_id(tablet->tablet_id());
+    tablet_req->set_new_table_name(l->data().pb.name());
+    tablet_req->set_schema_version(l->data().pb.version());
+    tablet_req->mutable_schema()->CopyFrom(l->data().pb.schema());
+    tablet_req->mutable_indexes()->CopyFrom(l->data().pb.indexes());
+  }
+  req.set_propagated_hybrid_time(master_->clock()->Now().ToUint64());
+  schema_version_ = l->data().pb.version();
+
+  l->Unlock();
+
+  ts_admin_proxy_->AlterSchemasAsync(req, &resp_, &rpc_, BindRpcCallback());
+  VLOG(1) << "Send alter schemas request to " << permanent_uuid_
+          << " (attempt " << attempt << ") for " << tablets_.size() << " tablets";
+  return true;
+}
+
 // ============================================================================
 //  Class AsyncCopartitionTable.
 // ============================================================================
@@ -747,8 +1031,8 @@ bool AsyncAddServerTask::PrepareRequest(int attempt) {
   req_.set_cas_config_opid_index(cstate_.config().opid_index());
   RaftPeerPB* peer = req_.mutable_server();
   peer->set_permanent_uuid(replacement_replica->permanent_uuid());
-  // Remove this check once support for async replicas is complete.
-  DCHECK_EQ(member_type_, RaftPeerPB::PRE_VOTER);
+  DCHECK(member_type_ == RaftPeerPB::PRE_VOTER || member_type_ == RaftPeerPB::PRE_OBSERVER)
+      << RaftPeerPB::MemberType_Name(member_type_);
   peer->set_member_type(member_type_);
   TSRegistrationPB peer_reg;
   replacement_replica->GetRegistration(&peer_reg);
@@ -15,6 +15,7 @@
 
 #include <atomic>
 #include <string>
+#include <vector>
 
 #include <boost/optional/optional.hpp>
 
@@ -237,7 +238,8 @@ class AsyncCreateReplica : public RetrySpecificTSRpcTask {
   AsyncCreateReplica(Master *master,
                      ThreadPool *callback_pool,
                      const std::string& permanent_uuid,
-                     const scoped_refptr<TabletInfo>& tablet);
+                     const scoped_refptr<TabletInfo>& tablet,
+                     const TabletServerId& initial_leader_uuid);
 
   Type type() const override { return ASYNC_CREATE_REPLICA; }
 
@@ -259,6 +261,39 @@ class AsyncCreateReplica : public RetrySpecificTSRpcTask {
   tserver::CreateTabletResponsePB resp_;
 };
 
+// Tablet that should be created, along with the peer picked to be its initial leader.
+struct TabletToCreate {
+  scoped_refptr<TabletInfo> tablet;
+  TabletServerId initial_leader_uuid;
+};
+
+// Fire off the async create of multiple tablets on the same TS with a single CreateTablets RPC.
+// Tablets should belong to the same table. Tablets that failed to be created are retried.
+// Has the same requirements on tablet info as AsyncCreateReplica.
+class AsyncCreateReplicas : public RetrySpecificTSRpcTask {
+ public:
+  AsyncCreateReplicas(Master *master,
+                      ThreadPool *callback_pool,
+                      const std::string& permanent_uuid,
+                      const std::vector<TabletToCreate>& tablets);
+
+  Type type() const override { return ASYNC_CREATE_REPLICA; }
+
+  std::string type_name() const override { return "Create Tablets"; }
+
+  std::string description() const override;
+
+ protected:
+  TabletId tablet_id() const override;
+
+  void HandleResponse(int attempt) override;
+  bool SendRequest(int attempt) override;
+
+ private:
+  tserver::CreateTabletsRequestPB req_;
+  tserver::CreateTabletsResponsePB resp_;
+};
+
 // Send a DeleteTablet() RPC request.
 class AsyncDeleteReplica : public RetrySpecificTSRpcTask {
  public:
@@ -296,6 +331,32 @@ class AsyncDeleteReplica : public RetrySpecificTSRpcTask {
   tserver::DeleteTabletResponsePB resp_;
 };
 
+// Send a DeleteTablets() RPC request, to delete multiple replicas of the same table on the same TS.
+// Tablets that failed to be deleted are retried, with the same backoff.
+class AsyncDeleteReplicas : public RetrySpecificTSRpcTask {
+ public:
+  AsyncDeleteReplicas(
+      Master* master, ThreadPool* callback_pool, const std::string& permanent_uuid,
+      const scoped_refptr<TableInfo>& table, const std::vector<TabletId>& tablet_ids,
+      tablet::TabletDataState delete_type, const std::string& reason);
+
+  Type type() const override { return ASYNC_DELETE_REPLICA; }
+
+  std::string type_name() const override { return "Delete Tablets"; }
+
+  std::string description() const override;
+
+ protected:
+  TabletId tablet_id() const override;
+
+  void HandleResponse(int attempt) override;
+  bool SendRequest(int attempt) override;
+
+ private:
+  tserver::DeleteTabletsRequestPB req_;
+  tserver::DeleteTabletsResponsePB resp_;
+};
+
 // Send the "Alter Table" with the latest table schema to the leader replica
 // for the tablet.
 // Keeps retrying until we get an "ok" response.
@@ -328,6 +389,34 @@ class AsyncAlterTable : public RetryingTSRpcTask {
   tserver::AlterSchemaResponsePB resp_;
 };
 
+// Send the "Alter Table" with the latest table schema to the leader replica of multiple tablets
+// of the same table, with a single AlterSchemas() RPC.
+// Tablets that failed to be altered are retried, with the same backoff. Tablets whose leader
+// changed are altered by separate AsyncAlterTable tasks, that look up the new leader.
+class AsyncAlterTablets : public RetrySpecificTSRpcTask {
+ public:
+  AsyncAlterTablets(Master *master,
+                    ThreadPool* callback_pool,
+                    const TabletServerId& leader_uuid,
+                    const std::vector<scoped_refptr<TabletInfo>>& tablets);
+
+  Type type() const override { return ASYNC_ALTER_TABLE; }
+
+  std::string type_name() const override { return "Alter Tablets"; }
+
+  std::string description() const override;
+
+ private:
+  TabletId tablet_id() const override;
+
+  void HandleResponse(int attempt) override;
+  bool SendRequest(int attempt) override;
+
+  uint32_t schema_version_;
+  std::vector<scoped_refptr<TabletInfo>> tablets_;
+  tserver::AlterSchemasResponsePB resp_;
+};
+
 class AsyncCopartitionTable : public RetryingTSRpcTask {
  public:
   AsyncCopartitionTable(Master *master,
@@ -100,6 +100,24 @@ TEST(TableInfoTest, TestAssignmentRanges) {
   }
 }
 
+TEST(CatalogManagerTest, TestHashMidpointSplitKey) {
+  PartitionPB partition;
+  ASSERT_EQ(PartitionSchema::EncodeMultiColumnHashValue(0x8000),
+            CatalogManager::HashMidpointSplitKey(partition));
+
+  partition.set_partition_key_start(PartitionSchema::EncodeMultiColumnHashValue(0x8000));
+  ASSERT_EQ(PartitionSchema::EncodeMultiColumnHashValue(0xc000),
+            CatalogManager::HashMidpointSplitKey(partition));
+
+  partition.set_partition_key_end(PartitionSchema::EncodeMultiColumnHashValue(0x8003));
+  ASSERT_EQ(PartitionSchema::EncodeMultiColumnHashValue(0x8001),
+            CatalogManager::HashMidpointSplitKey(partition));
+
+  // A single hash value could not be split.
+  partition.set_partition_key_end(PartitionSchema::EncodeMultiColumnHashValue(0x8001));
+  ASSERT_EQ("", CatalogManager::HashMidpointSplitKey(partition));
+}
+
 TEST(TestTSDescriptor, TestReplicaCreationsDecay) {
   TSDescriptor ts("test");
   ASSERT_EQ(0, ts.RecentReplicaCreations());
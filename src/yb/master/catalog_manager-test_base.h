@@ -78,6 +78,7 @@ class TestLoadBalancerBase {
         tablet_map_(cb->tablet_map_),
         table_map_(cb->table_map_),
         cluster_placement_(cb->cluster_placement_),
+        read_replica_placement_(cb->read_replica_placement_),
         pending_add_replica_tasks_(cb->pending_add_replica_tasks_),
         pending_remove_replica_tasks_(cb->pending_remove_replica_tasks_),
         pending_stepdown_leader_tasks_(cb->pending_stepdown_leader_tasks_) {
@@ -132,6 +133,15 @@ class TestLoadBalancerBase {
     PrepareTestState(ts_descs);
     TestBalancingLeaders();
 
+    PrepareTestState(ts_descs);
+    TestBalancingWeightedLeaders();
+
+    PrepareTestState(ts_descs);
+    TestBalancingLeadersWithAffinitizedZones();
+
+    PrepareTestState(ts_descs);
+    TestAddingReadReplicas();
+
     gflags::SetCommandLineOption("leader_balance_threshold", "2");
     PrepareTestState(ts_descs);
     TestBalancingLeadersWithThreshold();
@@ -704,11 +714,144 @@ class TestLoadBalancerBase {
     ASSERT_FALSE(HandleLeaderMoves(&placeholder, &placeholder, &placeholder));
   }
 
+  void TestBalancingWeightedLeaders() {
+    LOG(INFO) << "Testing moving leaders by weighted load";
+    // Initial leader distribution is 2 1 1, and both leaders on ts0 serve all requests.
+    for (int i = 0; i < tablets_.size(); ++i) {
+      TabletMetricsPB metrics;
+      metrics.set_tablet_id(tablets_[i]->tablet_id());
+      metrics.set_write_ops_per_sec(i % ts_descs_.size() == 0 ? 1000 : 0);
+      tablets_[i]->set_leader_metrics(metrics);
+    }
+
+    // Leader count is balanced, so nothing is moved without weights.
+    AnalyzeTablets();
+    string placeholder;
+    ASSERT_FALSE(HandleLeaderMoves(&placeholder, &placeholder, &placeholder));
+
+    // Leader weights are 1.5 on ts0 and 0.5 elsewhere, so loads are 3 0.5 0.5. But other servers
+    // are too busy to take more leaders.
+    gflags::SetCommandLineOption("load_balancer_weighted_load", "true");
+    ts_descs_[1]->set_cpu_utilization(0.95);
+    ts_descs_[2]->set_cpu_utilization(0.95);
+    ResetState();
+    AnalyzeTablets();
+    ASSERT_FALSE(HandleLeaderMoves(&placeholder, &placeholder, &placeholder));
+
+    // Exactly one hot leader should be moved off from ts0, leaving loads 1.5 2 0.5.
+    ts_descs_[1]->set_cpu_utilization(0);
+    ts_descs_[2]->set_cpu_utilization(0);
+    ResetState();
+    AnalyzeTablets();
+    string tablet_id;
+    TestMoveLeader(&tablet_id, ts_descs_[0]->permanent_uuid(), "");
+    ASSERT_TRUE(tablet_id == tablets_[0]->tablet_id() || tablet_id == tablets_[3]->tablet_id());
+    ASSERT_FALSE(HandleLeaderMoves(&placeholder, &placeholder, &placeholder));
+
+    gflags::SetCommandLineOption("load_balancer_weighted_load", "false");
+    for (const auto& tablet : tablets_) {
+      tablet->set_leader_metrics(TabletMetricsPB());
+    }
+  }
+
+  void TestBalancingLeadersWithAffinitizedZones() {
+    LOG(INFO) << "Testing moving leaders into affinitized zones";
+    // Initial leader distribution is 2 1 1, leaders should only be placed in AZs "a" and "b".
+    affinitized_zones_.insert(MakeCloudInfo("a"));
+    affinitized_zones_.insert(MakeCloudInfo("b"));
+    AnalyzeTablets();
+
+    // The leader on ts2 goes to the least loaded affinitized server, and then the leaders are
+    // balanced within the affinitized zones.
+    string placeholder, tablet_id;
+    TestMoveLeader(&tablet_id, ts_descs_[2]->permanent_uuid(), ts_descs_[1]->permanent_uuid());
+    ASSERT_EQ(tablets_[2]->tablet_id(), tablet_id);
+    ASSERT_FALSE(HandleLeaderMoves(&placeholder, &placeholder, &placeholder));
+
+    // A removed leader is handed over to an affinitized server.
+    ASSERT_EQ(ts_descs_[1]->permanent_uuid(), cb_->state_->GetAffinitizedLeaderCandidate(
+        tablets_[0]->tablet_id(), ts_descs_[0]->permanent_uuid()));
+
+    // Leaders are balanced as usual, when there are no tablet servers in affinitized zones.
+    affinitized_zones_.clear();
+    affinitized_zones_.insert(MakeCloudInfo("WRONG"));
+    ResetState();
+    AnalyzeTablets();
+    ASSERT_FALSE(HandleLeaderMoves(&placeholder, &placeholder, &placeholder));
+
+    // The table setting takes precedence over the cluster one, so all leaders go to AZ "c".
+    auto table = table_map_[cur_table_uuid_];
+    {
+      auto l = table->LockForWrite();
+      *l->mutable_data()->pb.mutable_replication_info()->add_affinitized_leaders() =
+          MakeCloudInfo("c");
+      l->Commit();
+    }
+    ResetState();
+    AnalyzeTablets();
+    for (int i = 0; i != 3; ++i) {
+      TestMoveLeader(&placeholder, "", ts_descs_[2]->permanent_uuid());
+    }
+    ASSERT_FALSE(HandleLeaderMoves(&placeholder, &placeholder, &placeholder));
+
+    auto l = table->LockForWrite();
+    l->mutable_data()->pb.mutable_replication_info()->clear_affinitized_leaders();
+    l->Commit();
+  }
+
+  void TestAddingReadReplicas() {
+    LOG(INFO) << "Testing adding read replicas";
+    cluster_placement_.set_num_replicas(kNumReplicas);
+    // Two tablet servers in the read replica zone, that should have one read replica per tablet.
+    ts_descs_.push_back(SetupTS("3333", "r"));
+    ts_descs_.push_back(SetupTS("4444", "r"));
+    auto* pb = read_replica_placement_.add_placement_blocks();
+    *pb->mutable_cloud_info() = MakeCloudInfo("r");
+    pb->set_min_num_replicas(1);
+    AnalyzeTablets();
+    ASSERT_EQ(0, cb_->get_total_over_replication());
+
+    // Read replicas are spread across the read replica servers, and these servers do not take
+    // live replicas, even though they are empty.
+    std::map<TabletServerId, size_t> num_read_replicas;
+    for (size_t i = 0; i != tablets_.size(); ++i) {
+      string tablet_id, from_ts, to_ts;
+      ASSERT_TRUE(cb_->HandleAddReplicas(&tablet_id, &from_ts, &to_ts));
+      ++num_read_replicas[to_ts];
+    }
+    ASSERT_EQ(tablets_.size() / 2, num_read_replicas[ts_descs_[3]->permanent_uuid()]);
+    ASSERT_EQ(tablets_.size() / 2, num_read_replicas[ts_descs_[4]->permanent_uuid()]);
+    string placeholder;
+    ASSERT_FALSE(cb_->HandleAddReplicas(&placeholder, &placeholder, &placeholder));
+
+    // An observer in the config is not counted as a live replica, and does not get leaders.
+    AddRunningReplica(tablets_[0].get(), ts_descs_[3]);
+    {
+      auto l = tablets_[0]->LockForWrite();
+      auto* peer = l->mutable_data()->pb.mutable_committed_consensus_state()->mutable_config()
+          ->add_peers();
+      peer->set_permanent_uuid(ts_descs_[3]->permanent_uuid());
+      peer->set_member_type(consensus::RaftPeerPB::OBSERVER);
+      l->Commit();
+    }
+    ResetState();
+    AnalyzeTablets();
+    ASSERT_EQ(0, cb_->get_total_over_replication());
+    ASSERT_EQ(total_num_tablets_, cb_->get_total_running_tablets());
+    ASSERT_FALSE(HandleLeaderMoves(&placeholder, &placeholder, &placeholder));
+    TestAddLoad("", "", ts_descs_[4]->permanent_uuid());
+
+    auto l = tablets_[0]->LockForWrite();
+    l->mutable_data()->pb.clear_committed_consensus_state();
+    l->Commit();
+  }
+
   // Methods to prepare the state of the current test.
   void PrepareTestState(const TSDescriptorVector& ts_descs) {
     // Clear old state.
     ResetState();
     cluster_placement_.Clear();
+    read_replica_placement_.Clear();
     blacklist_.Clear();
     tablet_map_.clear();
     ts_descs_.clear();
@@ -757,6 +900,14 @@ class TestLoadBalancerBase {
     return ts;
   }
 
+  CloudInfoPB MakeCloudInfo(const string& az) {
+    CloudInfoPB ci;
+    ci.set_placement_cloud("aws");
+    ci.set_placement_region("us-west-1");
+    ci.set_placement_zone(az);
+    return ci;
+  }
+
   void SetupClusterConfig(bool multi_az) {
     cluster_placement_.set_num_replicas(kNumReplicas);
     auto pb = cluster_placement_.add_placement_blocks();
@@ -866,6 +1017,7 @@ class TestLoadBalancerBase {
   TabletInfoMap& tablet_map_;
   TableInfoMap& table_map_;
   PlacementInfoPB& cluster_placement_;
+  PlacementInfoPB& read_replica_placement_;
   vector<TabletId>& pending_add_replica_tasks_;
   vector<TabletId>& pending_remove_replica_tasks_;
   vector<TabletId>& pending_stepdown_leader_tasks_;
@@ -153,6 +153,33 @@ DEFINE_int32(max_create_tablets_per_ts, 20,
              "The number of tablets per TS that can be requested for a new table.");
 TAG_FLAG(max_create_tablets_per_ts, advanced);
 
+DEFINE_int32(create_tablets_batch_size, 64,
+             "Maximum number of tablets of the same table that are sent to a tablet server in "
+             "a single CreateTablets RPC. 1 means that each tablet replica is created by a "
+             "separate CreateTablet RPC, e.g. while upgrading from a version without "
+             "CreateTablets.");
+TAG_FLAG(create_tablets_batch_size, advanced);
+
+DEFINE_int32(alter_tablets_batch_size, 64,
+             "Maximum number of tablets of the same table that are sent to their leader in a "
+             "single AlterSchemas RPC when the table is altered. 1 means that each tablet is "
+             "altered by a separate AlterSchema RPC, e.g. while upgrading from a version without "
+             "AlterSchemas.");
+TAG_FLAG(alter_tablets_batch_size, advanced);
+
+DEFINE_int32(delete_tablets_batch_size, 64,
+             "Maximum number of tablets of the same table that are sent to a tablet server in a "
+             "single DeleteTablets RPC when the table is deleted. 1 means that each tablet replica "
+             "is deleted by a separate DeleteTablet RPC, e.g. while upgrading from a version "
+             "without DeleteTablets.");
+TAG_FLAG(delete_tablets_batch_size, advanced);
+
+DEFINE_bool(pick_initial_tablet_leaders, true,
+            "Whether the master should pick the initial leader for new tablets, so only this "
+            "replica starts the first election instead of all replicas at once. Leaders are "
+            "spread evenly across tablet servers.");
+TAG_FLAG(pick_initial_tablet_leaders, advanced);
+
 DEFINE_int32(master_failover_catchup_timeout_ms, 30 * 1000,  // 30 sec
              "Amount of time to give a newly-elected leader master to load"
              " the previous master's metadata and become active. If this time"
@@ -188,6 +215,35 @@ DEFINE_test_flag(bool, catalog_manager_simulate_system_table_create_failure, fal
 DEFINE_string(cluster_uuid, "", "Cluster UUID to be used by this cluster");
 TAG_FLAG(cluster_uuid, hidden);
 
+DEFINE_int32(tablet_report_max_batch_size, 256,
+             "Maximum number of tablets of a tablet report, whose updates are written to sys "
+             "catalog in one batch.");
+TAG_FLAG(tablet_report_max_batch_size, advanced);
+
+DEFINE_bool(enable_automatic_tablet_splitting, false,
+            "Whether the master should look for tablets to split, based on the SST size and "
+            "write rate reported by tablet leaders.");
+TAG_FLAG(enable_automatic_tablet_splitting, experimental);
+
+DEFINE_int64(tablet_split_size_threshold_bytes, 10LL * 1024 * 1024 * 1024,
+             "Tablets with SST files larger than this are split candidates. "
+             "0 disables splitting by size.");
+TAG_FLAG(tablet_split_size_threshold_bytes, experimental);
+
+DEFINE_double(tablet_split_write_ops_per_sec_threshold, 0,
+              "Tablets with higher write rate are split candidates. "
+              "0 disables splitting by load.");
+TAG_FLAG(tablet_split_write_ops_per_sec_threshold, experimental);
+
+DEFINE_int32(tablet_split_check_interval_ms, 60000,
+             "Interval between looking for tablets to split.");
+TAG_FLAG(tablet_split_check_interval_ms, experimental);
+
+DEFINE_double(tablet_split_max_hottest_key_share, 0.5,
+              "Tablets that are split candidates by load are not split when a single key receives "
+              "more than this fraction of their accesses, since the load would stay in one child.");
+TAG_FLAG(tablet_split_max_hottest_key_share, experimental);
+
 DECLARE_int32(yb_num_shards_per_tserver);
 
 namespace yb {
@@ -256,10 +312,11 @@ constexpr const char* const kDefaultCassandraPassword = "cassandra";
 
 class TableLoader : public Visitor<PersistentTableInfo> {
  public:
-  explicit TableLoader(CatalogManager* catalog_manager) : catalog_manager_(catalog_manager) {}
+  TableLoader(CatalogManager* catalog_manager, TableInfoMap* table_ids_map)
+      : catalog_manager_(catalog_manager), table_ids_map_(table_ids_map) {}
 
   Status Visit(const TableId& table_id, const SysTablesEntryPB& metadata) override {
-    CHECK(!ContainsKey(catalog_manager_->table_ids_map_, table_id))
+    CHECK(!ContainsKey(*table_ids_map_, table_id))
           << "Table already exists: " << table_id;
 
     // Setup the table info
@@ -268,7 +325,7 @@ class TableLoader : public Visitor<PersistentTableInfo> {
     l->mutable_data()->pb.CopyFrom(metadata);
 
     // Add the table to the IDs map and to the name map (if the table is not deleted)
-    catalog_manager_->table_ids_map_[table->id()] = table;
+    (*table_ids_map_)[table->id()] = table;
     if (!l->data().started_deleting()) {
       catalog_manager_->table_names_map_[{l->data().namespace_id(), l->data().name()}] = table;
     }
@@ -281,6 +338,7 @@ class TableLoader : public Visitor<PersistentTableInfo> {
 
  private:
   CatalogManager *catalog_manager_;
+  TableInfoMap* table_ids_map_;
 
   DISALLOW_COPY_AND_ASSIGN(TableLoader);
 };
@@ -291,13 +349,15 @@ class TableLoader : public Visitor<PersistentTableInfo> {
 
 class TabletLoader : public Visitor<PersistentTabletInfo> {
  public:
-  explicit TabletLoader(CatalogManager* catalog_manager) : catalog_manager_(catalog_manager) {}
+  TabletLoader(CatalogManager* catalog_manager,
+               const TableInfoMap* table_ids_map,
+               TabletInfoMap* tablet_map)
+      : catalog_manager_(catalog_manager), table_ids_map_(table_ids_map), tablet_map_(tablet_map) {}
 
   Status Visit(const TabletId& tablet_id, const SysTabletsEntryPB& metadata) override {
 
     // Lookup the table
-    scoped_refptr<TableInfo> first_table(FindPtrOrNull(
-                                     catalog_manager_->table_ids_map_, metadata.table_id()));
+    scoped_refptr<TableInfo> first_table(FindPtrOrNull(*table_ids_map_, metadata.table_id()));
 
     // Setup the tablet info
     TabletInfo* tablet = new TabletInfo(first_table, tablet_id);
@@ -305,7 +365,7 @@ class TabletLoader : public Visitor<PersistentTabletInfo> {
     l->mutable_data()->pb.CopyFrom(metadata);
 
     // Add the tablet to the tablet manager
-    auto inserted = catalog_manager_->tablet_map_.emplace(tablet->tablet_id(), tablet).second;
+    auto inserted = tablet_map_->emplace(tablet->tablet_id(), tablet).second;
     if (!inserted) {
       return STATUS_FORMAT(
           IllegalState, "Loaded tablet that already in map: $0", tablet->tablet_id());
@@ -330,7 +390,7 @@ class TabletLoader : public Visitor<PersistentTabletInfo> {
     }
 
     for (auto table_id : table_ids) {
-      scoped_refptr<TableInfo> table(FindPtrOrNull(catalog_manager_->table_ids_map_, table_id));
+      scoped_refptr<TableInfo> table(FindPtrOrNull(*table_ids_map_, table_id));
 
       if (table == nullptr) {
         // if the table is missing and the tablet is in "preparing" state
@@ -368,6 +428,8 @@ class TabletLoader : public Visitor<PersistentTabletInfo> {
 
  private:
   CatalogManager *catalog_manager_;
+  const TableInfoMap* table_ids_map_;
+  TabletInfoMap* tablet_map_;
 
   DISALLOW_COPY_AND_ASSIGN(TabletLoader);
 };
@@ -611,6 +673,10 @@ void CatalogManagerBgTasks::Run() {
       // Report metrics.
       catalog_manager_->ReportMetrics();
 
+      if (FLAGS_enable_automatic_tablet_splitting) {
+        catalog_manager_->FindTabletSplitCandidates();
+      }
+
       TabletInfos to_delete;
       TabletInfos to_process;
 
@@ -806,7 +872,7 @@ Status CatalogManager::VisitSysCatalog() {
   // it's important to end their tasks now; otherwise Shutdown() will
   // destroy master state used by these tasks.
   std::vector<scoped_refptr<TableInfo>> tables;
-  AppendValuesFromMap(table_ids_map_, &tables);
+  AppendValuesFromMap(*table_ids_map_, &tables);
   AbortAndWaitForAllTasks(tables);
 
   // Clear internal maps and run data loaders.
@@ -831,8 +897,15 @@ Status CatalogManager::VisitSysCatalog() {
 Status CatalogManager::RunLoaders() {
   // Clear the table and tablet state.
   table_names_map_.clear();
-  table_ids_map_.clear();
-  tablet_map_.clear();
+  // Locations versions returned by the previous leader are based on its own counter, that
+  // started from its wall clock time at load, so start from the current time to keep versions
+  // of reloaded tablets greater than versions that clients could already have.
+  TabletInfo::AdvanceLocationsVersion(GetCurrentTimeMicros());
+  // Loaded tables and tablets become visible to lock-free readers when loading is complete.
+  auto table_ids_map = table_ids_map_.Mutate();
+  table_ids_map->clear();
+  auto tablet_map = tablet_map_.Mutate();
+  tablet_map->clear();
 
   // Clear the namespace mappings.
   namespace_ids_map_.clear();
@@ -854,39 +927,21 @@ Status CatalogManager::RunLoaders() {
     ts_desc->set_has_tablet_report(false);
   }
 
-  // Visit tables and tablets, load them into memory.
-  LOG(INFO) << __func__ << ": Loading tables into memory.";
-  unique_ptr<TableLoader> table_loader(new TableLoader(this));
-  RETURN_NOT_OK_PREPEND(
-      sys_catalog_->Visit(table_loader.get()), "Failed while visiting tables in sys catalog");
-
-  LOG(INFO) << __func__ << ": Loading tablets into memory.";
-  unique_ptr<TabletLoader> tablet_loader(new TabletLoader(this));
-  RETURN_NOT_OK_PREPEND(
-      sys_catalog_->Visit(tablet_loader.get()), "Failed while visiting tablets in sys catalog");
-
-  LOG(INFO) << __func__ << ": Loading namespaces into memory.";
-  unique_ptr<NamespaceLoader> namespace_loader(new NamespaceLoader(this));
-  RETURN_NOT_OK_PREPEND(
-      sys_catalog_->Visit(namespace_loader.get()),
-      "Failed while visiting namespaces in sys catalog");
-
-  LOG(INFO) << __func__ << ": Loading user-defined types into memory.";
-  unique_ptr<UDTypeLoader> udtype_loader(new UDTypeLoader(this));
-  RETURN_NOT_OK_PREPEND(
-      sys_catalog_->Visit(udtype_loader.get()),
-      "Failed while visiting namespaces in sys catalog");
-
-  LOG(INFO) << __func__ << ": Loading cluster configuration into memory.";
-  unique_ptr<ClusterConfigLoader> config_loader(new ClusterConfigLoader(this));
+  // Visit all entries in one scan of the sys catalog, and load them into memory. Entries are
+  // visited in the order of their types, so tables are loaded before their tablets.
+  LOG(INFO) << __func__ << ": Loading tables, tablets, namespaces, user-defined types, "
+            << "cluster configuration and roles into memory.";
+  TableLoader table_loader(this, &*table_ids_map);
+  TabletLoader tablet_loader(this, &*table_ids_map, &*tablet_map);
+  NamespaceLoader namespace_loader(this);
+  UDTypeLoader udtype_loader(this);
+  ClusterConfigLoader config_loader(this);
+  RoleLoader role_loader(this);
+  static_assert(SysRowEntry::TABLE < SysRowEntry::TABLET, "Tables should be loaded first");
   RETURN_NOT_OK_PREPEND(
-      sys_catalog_->Visit(config_loader.get()), "Failed while visiting config in sys catalog");
-
-  LOG(INFO) << __func__ << ": Loading roles into memory.";
-  unique_ptr<RoleLoader> role_loader(new RoleLoader(this));
-  RETURN_NOT_OK_PREPEND(
-      sys_catalog_->Visit(role_loader.get()),
-      "Failed while visiting roles in sys catalog");
+      sys_catalog_->Visit({&table_loader, &tablet_loader, &namespace_loader, &udtype_loader,
+                           &config_loader, &role_loader}),
+      "Failed while visiting sys catalog");
 
   return Status::OK();
 }
@@ -1238,7 +1293,7 @@ void CatalogManager::Shutdown() {
   vector<scoped_refptr<TableInfo>> copy;
   {
     shared_lock<LockType> l(lock_);
-    AppendValuesFromMap(table_ids_map_, &copy);
+    AppendValuesFromMap(*table_ids_map_, &copy);
   }
   AbortAndWaitForAllTasks(copy);
 
@@ -1286,14 +1341,17 @@ Status CatalogManager::AbortTableCreation(TableInfo* table,
     tablet->mutable_metadata()->AbortMutation();
   }
   table->mutable_metadata()->AbortMutation();
-  for (const TabletId& tablet_id_to_erase : tablet_ids_to_erase) {
-    CHECK_EQ(tablet_map_.erase(tablet_id_to_erase), 1)
-        << "Unable to erase tablet " << tablet_id_to_erase << " from tablet map.";
+  {
+    auto tablet_map = tablet_map_.Mutate();
+    for (const TabletId& tablet_id_to_erase : tablet_ids_to_erase) {
+      CHECK_EQ(tablet_map->erase(tablet_id_to_erase), 1)
+          << "Unable to erase tablet " << tablet_id_to_erase << " from tablet map.";
+    }
   }
 
   CHECK_EQ(table_names_map_.erase({table_namespace_id, table_name}), 1)
       << "Unable to erase table named " << table_name << " from table names map.";
-  CHECK_EQ(table_ids_map_.erase(table_id), 1)
+  CHECK_EQ(table_ids_map_.Mutate()->erase(table_id), 1)
       << "Unable to erase tablet with id " << table_id << " from tablet ids map.";
 
   return CheckIfNoLongerLeaderAndSetupError(s, resp);
@@ -1398,7 +1456,7 @@ Status CatalogManager::CreateCopartitionedTable(const CreateTableRequestPB req,
 
   std::lock_guard<LockType> l(lock_);
   TRACE("Acquired catalog manager lock");
-  parent_table_info = FindPtrOrNull(table_ids_map_,
+  parent_table_info = FindPtrOrNull(*table_ids_map_,
                                     schema.table_properties().CopartitionTableId());
   if (parent_table_info == nullptr) {
     s = STATUS(NotFound, "The table does not exist",
@@ -1726,8 +1784,9 @@ Status CatalogManager::CreateTabletsFromTable(const vector<Partition>& partition
 
   // Add the table/tablets to the in-memory map for the assignment.
   table->AddTablets(*tablets);
+  auto tablet_map = tablet_map_.Mutate();
   for (TabletInfo* tablet : *tablets) {
-    InsertOrDie(&tablet_map_, tablet->tablet_id(), tablet);
+    InsertOrDie(&*tablet_map, tablet->tablet_id(), tablet);
   }
   return Status::OK();
 }
@@ -1748,7 +1807,7 @@ Status CatalogManager::CreateTableInMemory(const CreateTableRequestPB& req,
 
   // Add the new table in "preparing" state.
   table->reset(CreateTableInfo(req, schema, partition_schema, namespace_id));
-  table_ids_map_[(*table)->id()] = *table;
+  (*table_ids_map_.Mutate())[(*table)->id()] = *table;
   table_names_map_[{namespace_id, req.name()}] = *table;
 
   if (!is_copartitioned) {
@@ -1851,11 +1910,15 @@ TabletInfo* CatalogManager::CreateTabletInfo(TableInfo* table,
 
 Status CatalogManager::FindTable(const TableIdentifierPB& table_identifier,
                                  scoped_refptr<TableInfo> *table_info) {
+  if (table_identifier.has_table_id()) {
+    // Lookup by id is the common path of clients, so it does not wait for lock_.
+    *table_info = FindPtrOrNull(*table_ids_map_.Snapshot(), table_identifier.table_id());
+    return Status::OK();
+  }
+
   boost::shared_lock<LockType> l(lock_);
 
-  if (table_identifier.has_table_id()) {
-    *table_info = FindPtrOrNull(table_ids_map_, table_identifier.table_id());
-  } else if (table_identifier.has_table_name()) {
+  if (table_identifier.has_table_name()) {
     NamespaceId namespace_id;
 
     if (table_identifier.has_namespace_()) {
@@ -1920,7 +1983,7 @@ Status CatalogManager::TruncateTable(const TruncateTableRequestPB* req,
 
   // Lookup the table and verify if it exists
   TRACE("Looking up table");
-  scoped_refptr<TableInfo> table = FindPtrOrNull(table_ids_map_, req->table_id());
+  scoped_refptr<TableInfo> table = FindPtrOrNull(*table_ids_map_.Snapshot(), req->table_id());
   if (table == nullptr) {
     Status s = STATUS(NotFound, "The table does not exist");
     return SetupError(resp->mutable_error(), MasterErrorPB::TABLE_NOT_FOUND, s);
@@ -1966,7 +2029,7 @@ Status CatalogManager::IsTruncateTableDone(const IsTruncateTableDoneRequestPB* r
   // Lookup the truncated table.
   TRACE("Looking up table $0", req->table_id());
   std::lock_guard<LockType> l_map(lock_);
-  scoped_refptr<TableInfo> table = FindPtrOrNull(table_ids_map_, req->table_id());
+  scoped_refptr<TableInfo> table = FindPtrOrNull(*table_ids_map_, req->table_id());
 
   if (table == nullptr) {
     Status s = STATUS(NotFound, "The table does not exist");
@@ -2187,7 +2250,7 @@ void CatalogManager::MarkTableDeletedIfNoTablets(scoped_refptr<DeletedTableInfo>
   scoped_refptr<TableInfo> table(table_info);
 
   if (table == nullptr) {
-    table = FindPtrOrNull(table_ids_map_, deleted_table->id());
+    table = FindPtrOrNull(*table_ids_map_, deleted_table->id());
   }
 
   if (table != nullptr) {
@@ -2210,7 +2273,8 @@ void CatalogManager::CleanUpDeletedTables() {
   std::lock_guard<LockType> l_map(lock_);
   // Garbage collecting.
   // Going through all tables under the global lock.
-  for (TableInfoMap::iterator it = table_ids_map_.begin(); it != table_ids_map_.end();) {
+  auto table_ids_map = table_ids_map_.Mutate();
+  for (TableInfoMap::iterator it = table_ids_map->begin(); it != table_ids_map->end();) {
     scoped_refptr<TableInfo> table(it->second);
 
     if (!table->HasTasks()) {
@@ -2219,7 +2283,7 @@ void CatalogManager::CleanUpDeletedTables() {
 
       if (l->data().is_deleted()) {
         LOG(INFO) << "Removing from by-ids map table " << table->ToString();
-        it = table_ids_map_.erase(it);
+        it = table_ids_map->erase(it);
         // TODO: Check if we want to delete the totally deleted table from the sys_catalog here.
         continue;
       }
@@ -2236,7 +2300,7 @@ Status CatalogManager::IsDeleteTableDone(const IsDeleteTableDoneRequestPB* req,
   // Lookup the deleted table.
   TRACE("Looking up table $0", req->table_id());
   std::lock_guard<LockType> l_map(lock_);
-  scoped_refptr<TableInfo> table = FindPtrOrNull(table_ids_map_, req->table_id());
+  scoped_refptr<TableInfo> table = FindPtrOrNull(*table_ids_map_, req->table_id());
 
   if (table == nullptr) {
     LOG(INFO) << "Servicing IsDeleteTableDone request for table id "
@@ -2641,8 +2705,7 @@ Status CatalogManager::ListTables(const ListTablesRequestPB* req,
 }
 
 scoped_refptr<TableInfo> CatalogManager::GetTableInfo(const TableId& table_id) {
-  boost::shared_lock<LockType> l(lock_);
-  return FindPtrOrNull(table_ids_map_, table_id);
+  return FindPtrOrNull(*table_ids_map_.Snapshot(), table_id);
 }
 scoped_refptr<TableInfo> CatalogManager::GetTableInfoFromNamespaceNameAndTableName(
     const NamespaceName& namespace_name, const TableName& table_name) {
@@ -2656,14 +2719,14 @@ scoped_refptr<TableInfo> CatalogManager::GetTableInfoFromNamespaceNameAndTableNa
 }
 
 scoped_refptr<TableInfo> CatalogManager::GetTableInfoUnlocked(const TableId& table_id) {
-  return FindPtrOrNull(table_ids_map_, table_id);
+  return FindPtrOrNull(*table_ids_map_, table_id);
 }
 
 void CatalogManager::GetAllTables(std::vector<scoped_refptr<TableInfo>> *tables,
                                   bool includeOnlyRunningTables) {
   tables->clear();
   boost::shared_lock<LockType> l(lock_);
-  for (const TableInfoMap::value_type& e : table_ids_map_) {
+  for (const TableInfoMap::value_type& e : *table_ids_map_) {
     if (includeOnlyRunningTables && !e.second->is_running()) {
       continue;
     }
@@ -2766,12 +2829,30 @@ Status CatalogManager::ProcessTabletReport(TSDescriptor* ts_desc,
   // the server should have, compare vs the ones being reported, and somehow mark
   // any that have been "lost" (eg somehow the tablet metadata got corrupted or something).
 
-  for (const ReportedTabletPB& reported : report.updated_tablets()) {
-    ReportedTabletUpdatesPB *tablet_report = report_update->add_tablets();
-    tablet_report->set_tablet_id(reported.tablet_id());
-    RETURN_NOT_OK_PREPEND(HandleReportedTablet(ts_desc, reported, tablet_report),
-                          Substitute("Error handling $0", reported.ShortDebugString()));
+  // Write locks of modified tablets are held until their batch is written, so tablets are
+  // handled in the id order, that is also used by the background tasks for pending assignments.
+  std::vector<int> order(report.updated_tablets_size());
+  for (int i = 0; i != order.size(); ++i) {
+    report_update->add_tablets()->set_tablet_id(report.updated_tablets(i).tablet_id());
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [&report](int lhs, int rhs) {
+    return report.updated_tablets(lhs).tablet_id() < report.updated_tablets(rhs).tablet_id();
+  });
+
+  std::vector<ReportedTabletUpdate> updates;
+  for (int i : order) {
+    const ReportedTabletPB& reported = report.updated_tablets(i);
+    Status s = HandleReportedTablet(
+        ts_desc, reported, report_update->mutable_tablets(i), &updates);
+    if (s.ok() && updates.size() < FLAGS_tablet_report_max_batch_size) {
+      continue;
+    }
+    // Tablets handled before the failed one are still updated.
+    RETURN_NOT_OK(ApplyReportedTabletUpdates(&updates));
+    RETURN_NOT_OK_PREPEND(s, Substitute("Error handling $0", reported.ShortDebugString()));
   }
+  RETURN_NOT_OK(ApplyReportedTabletUpdates(&updates));
 
   if (!ts_desc->has_tablet_report()) {
     LOG(INFO) << ts_desc->permanent_uuid() << " now has full report for "
@@ -2813,14 +2894,12 @@ bool ShouldTransitionTabletToRunning(const ReportedTabletPB& report) {
 
 Status CatalogManager::HandleReportedTablet(TSDescriptor* ts_desc,
                                             const ReportedTabletPB& report,
-                                            ReportedTabletUpdatesPB *report_updates) {
+                                            ReportedTabletUpdatesPB *report_updates,
+                                            std::vector<ReportedTabletUpdate>* updates) {
   TRACE_EVENT1("master", "HandleReportedTablet",
                "tablet_id", report.tablet_id());
   scoped_refptr<TabletInfo> tablet;
-  {
-    boost::shared_lock<LockType> l(lock_);
-    tablet = FindPtrOrNull(tablet_map_, report.tablet_id());
-  }
+  tablet = FindPtrOrNull(*tablet_map_.Snapshot(), report.tablet_id());
   RETURN_NOT_OK_PREPEND(CheckIsLeaderAndReady(),
       Substitute("This master is no longer the leader, unable to handle report for tablet $0",
                  report.tablet_id()));
@@ -3025,26 +3104,70 @@ Status CatalogManager::HandleReportedTablet(TSDescriptor* ts_desc,
   }
 
   table_lock->Unlock();
-  // We update the tablets each time that someone reports it.
-  // This shouldn't be very frequent and should only happen when something in fact changed.
-  Status s = sys_catalog_->UpdateItem(tablet.get());
-  if (!s.ok()) {
-    LOG(WARNING) << "Error updating tablets: " << s.ToString() << ". Tablet report was: "
-                 << report.ShortDebugString();
-    return s;
+
+  ReportedTabletUpdate update;
+  update.tablet = tablet;
+  update.needs_alter = tablet_needs_alter;
+  if (report.has_schema_version()) {
+    update.schema_version = report.schema_version();
+  }
+  // Full reports mostly repeat what we already know, so only tablets whose persistent state was
+  // changed by the report are written to sys catalog.
+  if (tablet_lock->data().pb.SerializeAsString() !=
+          tablet->metadata().state().pb.SerializeAsString()) {
+    update.tablet_lock = std::move(tablet_lock);
+  } else {
+    tablet_lock->Unlock();
+  }
+  updates->push_back(std::move(update));
+
+  return Status::OK();
+}
+
+Status CatalogManager::ApplyReportedTabletUpdates(std::vector<ReportedTabletUpdate>* updates) {
+  if (updates->empty()) {
+    return Status::OK();
+  }
+
+  vector<TabletInfo*> modified_tablets;
+  for (const auto& update : *updates) {
+    if (update.tablet_lock) {
+      modified_tablets.push_back(update.tablet.get());
+    }
+  }
+  if (!modified_tablets.empty()) {
+    Status s = sys_catalog_->UpdateItems(modified_tablets);
+    if (!s.ok()) {
+      LOG(WARNING) << "Error updating " << modified_tablets.size() << " reported tablets: " << s;
+      // Mutations are aborted when the locks are destroyed.
+      updates->clear();
+      return s;
+    }
+    for (auto& update : *updates) {
+      if (update.tablet_lock) {
+        update.tablet_lock->Commit();
+        // Committed state, e.g. RUNNING or consensus state, affects tablet locations.
+        update.tablet->InvalidateLocations();
+      }
+    }
   }
-  tablet_lock->Commit();
 
   // Need to defer the AlterTable command to after we've committed the new tablet data,
   // since the tablet report may also be updating the raft config, and the Alter Table
   // request needs to know who the most recent leader is.
-  if (tablet_needs_alter) {
-    SendAlterTabletRequest(tablet);
-  } else if (report.has_schema_version()) {
-    RETURN_NOT_OK(HandleTabletSchemaVersionReport(tablet.get(), report.schema_version()));
+  Status result;
+  for (const auto& update : *updates) {
+    if (update.needs_alter) {
+      SendAlterTabletRequest(update.tablet);
+    } else if (update.schema_version) {
+      Status s = HandleTabletSchemaVersionReport(update.tablet.get(), *update.schema_version);
+      if (!s.ok() && result.ok()) {
+        result = s;
+      }
+    }
   }
-
-  return Status::OK();
+  updates->clear();
+  return result;
 }
 
 
@@ -3254,7 +3377,7 @@ Status CatalogManager::DeleteNamespace(const DeleteNamespaceRequestPB* req,
   {
     boost::shared_lock<LockType> catalog_lock(lock_);
 
-    for (const TableInfoMap::value_type& entry : table_ids_map_) {
+    for (const TableInfoMap::value_type& entry : *table_ids_map_) {
       auto ltm = entry.second->LockForRead();
 
       if (!ltm->data().started_deleting() && ltm->data().namespace_id() == ns->id()) {
@@ -3616,7 +3739,7 @@ Status CatalogManager::DeleteUDType(const DeleteUDTypeRequestPB* req,
 
     // Checking if any table uses this type
     // TODO this could be more efficient
-    for (const TableInfoMap::value_type& entry : table_ids_map_) {
+    for (const TableInfoMap::value_type& entry : *table_ids_map_) {
       auto ltm = entry.second->LockForRead();
       if (!ltm->data().started_deleting()) {
         for (const auto &col : ltm->data().schema().columns()) {
@@ -4030,8 +4153,30 @@ void CatalogManager::SendAlterTableRequest(const scoped_refptr<TableInfo>& table
   vector<scoped_refptr<TabletInfo>> tablets;
   table->GetAllTablets(&tablets);
 
+  // Tablets to alter, grouped by their leader.
+  std::map<TabletServerId, vector<scoped_refptr<TabletInfo>>> tablets_by_leader;
   for (const scoped_refptr<TabletInfo>& tablet : tablets) {
-    SendAlterTabletRequest(tablet);
+    TabletServerId leader_uuid;
+    if (FLAGS_alter_tablets_batch_size <= 1 || !getLeaderUUID(tablet, &leader_uuid)) {
+      SendAlterTabletRequest(tablet);
+      continue;
+    }
+    tablets_by_leader[leader_uuid].push_back(tablet);
+  }
+
+  for (const auto& entry : tablets_by_leader) {
+    const auto& leader_tablets = entry.second;
+    for (size_t begin = 0; begin < leader_tablets.size();
+         begin += FLAGS_alter_tablets_batch_size) {
+      const size_t end = std::min<size_t>(
+          leader_tablets.size(), begin + FLAGS_alter_tablets_batch_size);
+      vector<scoped_refptr<TabletInfo>> batch(
+          leader_tablets.begin() + begin, leader_tablets.begin() + end);
+      auto call = std::make_shared<AsyncAlterTablets>(
+          master_, worker_pool_.get(), entry.first, batch);
+      table->AddTask(call);
+      WARN_NOT_OK(call->Run(), "Failed to send alter tablets request");
+    }
   }
 }
 
@@ -4067,14 +4212,58 @@ void CatalogManager::DeleteTabletsAndSendRequests(const scoped_refptr<TableInfo>
 
   string deletion_msg = "Table deleted at " + LocalTimeAsString();
 
+  // Replicas to delete, grouped by tablet server.
+  std::map<TSDescriptor*, vector<TabletId>> replicas_to_delete;
   for (const scoped_refptr<TabletInfo>& tablet : tablets) {
-    DeleteTabletReplicas(tablet.get(), deletion_msg);
+    if (FLAGS_delete_tablets_batch_size <= 1) {
+      DeleteTabletReplicas(tablet.get(), deletion_msg);
+    } else {
+      TabletInfo::ReplicaMap locations;
+      tablet->GetReplicaLocations(&locations);
+      for (const TabletInfo::ReplicaMap::value_type& r : locations) {
+        replicas_to_delete[r.second.ts_desc].push_back(tablet->tablet_id());
+      }
+    }
 
     auto tablet_lock = tablet->LockForWrite();
     tablet_lock->mutable_data()->set_state(SysTabletsEntryPB::DELETED, deletion_msg);
     CHECK_OK(sys_catalog_->UpdateItem(tablet.get()));
     tablet_lock->Commit();
   }
+
+  for (const auto& entry : replicas_to_delete) {
+    const auto& ts_tablets = entry.second;
+    for (size_t begin = 0; begin < ts_tablets.size();
+         begin += FLAGS_delete_tablets_batch_size) {
+      const size_t end = std::min<size_t>(
+          ts_tablets.size(), begin + FLAGS_delete_tablets_batch_size);
+      SendDeleteTabletsRequest(
+          vector<TabletId>(ts_tablets.begin() + begin, ts_tablets.begin() + end),
+          table, entry.first, deletion_msg);
+    }
+  }
+}
+
+void CatalogManager::SendDeleteTabletsRequest(
+    const vector<TabletId>& tablet_ids,
+    const scoped_refptr<TableInfo>& table,
+    TSDescriptor* ts_desc,
+    const string& reason) {
+  LOG_WITH_PREFIX(INFO) << Substitute("Deleting $0 tablets of table $1 on peer $2 ($3)",
+                                      tablet_ids.size(), table->ToString(),
+                                      ts_desc->permanent_uuid(), reason);
+  auto call = std::make_shared<AsyncDeleteReplicas>(master_, worker_pool_.get(),
+      ts_desc->permanent_uuid(), table, tablet_ids, TABLET_DATA_DELETED, reason);
+  table->AddTask(call);
+
+  auto status = call->Run();
+  WARN_NOT_OK(status, Substitute("Failed to send delete request for $0 tablets",
+                                 tablet_ids.size()));
+  if (status.ok()) {
+    for (const auto& tablet_id : tablet_ids) {
+      ts_desc->AddPendingTabletDelete(tablet_id);
+    }
+  }
 }
 
 void CatalogManager::SendDeleteTabletRequest(
@@ -4189,7 +4378,7 @@ void CatalogManager::ExtractTabletsToProcess(
   //       or just a counter to avoid to take the lock and loop through the tablets
   //       if everything is "stable".
 
-  for (const TabletInfoMap::value_type& entry : tablet_map_) {
+  for (const TabletInfoMap::value_type& entry : *tablet_map_) {
     scoped_refptr<TabletInfo> tablet = entry.second;
     auto tablet_lock = tablet->LockForRead();
 
@@ -4215,6 +4404,13 @@ void CatalogManager::ExtractTabletsToProcess(
     // Tablets not yet assigned or with a report just received
     tablets_to_process->push_back(tablet);
   }
+
+  // ProcessPendingAssignments write locks all these tablets, so lock them in the same order as
+  // ProcessTabletReport does.
+  std::sort(tablets_to_process->begin(), tablets_to_process->end(),
+            [](const scoped_refptr<TabletInfo>& lhs, const scoped_refptr<TabletInfo>& rhs) {
+    return lhs->tablet_id() < rhs->tablet_id();
+  });
 }
 
 struct DeferredAssignmentActions {
@@ -4262,7 +4458,7 @@ void CatalogManager::HandleAssignCreatingTablet(TabletInfo* tablet,
   tablet->table()->AddTablet(replacement);
   {
     std::lock_guard<LockType> l_maps(lock_);
-    tablet_map_[replacement->tablet_id()] = replacement;
+    (*tablet_map_.Mutate())[replacement->tablet_id()] = replacement;
   }
 
   // Mark old tablet as replaced.
@@ -4294,6 +4490,13 @@ Status CatalogManager::HandleTabletSchemaVersionReport(TabletInfo *tablet, uint3
 
   // Verify if it's the last tablet report, and the alter completed.
   TableInfo *table = tablet->table().get();
+  {
+    // Avoid copying the table for a write lock in the common case when it is not being altered.
+    auto read_lock = table->LockForRead();
+    if (read_lock->data().pb.state() != SysTablesEntryPB::ALTERING) {
+      return Status::OK();
+    }
+  }
   auto l = table->LockForWrite();
   if (l->data().pb.state() != SysTablesEntryPB::ALTERING) {
     return Status::OK();
@@ -4448,8 +4651,9 @@ Status CatalogManager::ProcessPendingAssignments(const TabletInfos& tablets) {
     std::lock_guard<LockType> l(lock_);
     unlocker_out.Abort();
     unlocker_in.Abort();
+    auto tablet_map = tablet_map_.Mutate();
     for (const TabletId& tablet_id_to_remove : tablet_ids_to_remove) {
-      CHECK_EQ(tablet_map_.erase(tablet_id_to_remove), 1)
+      CHECK_EQ(tablet_map->erase(tablet_id_to_remove), 1)
           << "Unable to erase " << tablet_id_to_remove << " from tablet map.";
     }
     return s;
@@ -4510,8 +4714,28 @@ Status CatalogManager::SelectReplicasForTablet(const TSDescriptorVector& ts_desc
   set<shared_ptr<TSDescriptor>> already_selected_ts;
   if (placement_info.placement_blocks().empty()) {
     // If we don't have placement info, just place the replicas as before, distributed across the
-    // whole cluster.
-    SelectReplicas(ts_descs, nreplicas, config, &already_selected_ts);
+    // whole cluster, except for the servers that only host read replicas.
+    TSDescriptorVector live_ts_descs;
+    for (const auto& ts_desc : ts_descs) {
+      bool is_read_replica_server = false;
+      for (const auto& pb : replication_info.async_replicas().placement_blocks()) {
+        if (ts_desc->MatchesCloudInfo(pb.cloud_info())) {
+          is_read_replica_server = true;
+          break;
+        }
+      }
+      if (!is_read_replica_server) {
+        live_ts_descs.push_back(ts_desc);
+      }
+    }
+    if (live_ts_descs.size() < nreplicas) {
+      return STATUS(InvalidArgument,
+          Substitute("Not enough tablet servers are online for table '$0' outside of the read "
+                     "replica placement. Need at least $1 replicas, but only $2 tablet servers "
+                     "are available", table_guard->data().name(), nreplicas,
+                     live_ts_descs.size()));
+    }
+    SelectReplicas(live_ts_descs, nreplicas, config, &already_selected_ts);
   } else {
     // TODO(bogdan): move to separate function
     //
@@ -4585,15 +4809,52 @@ Status CatalogManager::SelectReplicasForTablet(const TSDescriptorVector& ts_desc
 }
 
 void CatalogManager::SendCreateTabletRequests(const vector<TabletInfo*>& tablets) {
+  // Number of initial leaders picked on each tablet server, leaders are spread evenly.
+  std::unordered_map<TabletServerId, int> num_initial_leaders;
+  // Tablets to create, grouped by tablet server and table.
+  std::map<std::pair<TabletServerId, TableId>, std::vector<TabletToCreate>> tablets_to_create;
   for (TabletInfo *tablet : tablets) {
     const consensus::RaftConfigPB& config =
         tablet->metadata().dirty().pb.committed_consensus_state().config();
     tablet->set_last_update_time(MonoTime::Now());
+
+    TabletServerId initial_leader_uuid;
+    if (FLAGS_pick_initial_tablet_leaders && config.peers_size() > 1) {
+      int min_leaders = std::numeric_limits<int>::max();
+      for (const RaftPeerPB& peer : config.peers()) {
+        int leaders = num_initial_leaders[peer.permanent_uuid()];
+        if (leaders < min_leaders) {
+          min_leaders = leaders;
+          initial_leader_uuid = peer.permanent_uuid();
+        }
+      }
+      ++num_initial_leaders[initial_leader_uuid];
+    }
+
     for (const RaftPeerPB& peer : config.peers()) {
-      auto task = std::make_shared<AsyncCreateReplica>(master_, worker_pool_.get(),
-          peer.permanent_uuid(), tablet);
-      tablet->table()->AddTask(task);
-      WARN_NOT_OK(task->Run(), "Failed to send new tablet request");
+      if (FLAGS_create_tablets_batch_size <= 1) {
+        auto task = std::make_shared<AsyncCreateReplica>(master_, worker_pool_.get(),
+            peer.permanent_uuid(), tablet, initial_leader_uuid);
+        tablet->table()->AddTask(task);
+        WARN_NOT_OK(task->Run(), "Failed to send new tablet request");
+        continue;
+      }
+      tablets_to_create[{peer.permanent_uuid(), tablet->table()->id()}].push_back(
+          TabletToCreate{tablet, initial_leader_uuid});
+    }
+  }
+
+  for (const auto& entry : tablets_to_create) {
+    const auto& ts_tablets = entry.second;
+    for (size_t begin = 0; begin < ts_tablets.size();
+         begin += FLAGS_create_tablets_batch_size) {
+      const size_t end = std::min<size_t>(
+          ts_tablets.size(), begin + FLAGS_create_tablets_batch_size);
+      std::vector<TabletToCreate> batch(ts_tablets.begin() + begin, ts_tablets.begin() + end);
+      auto task = std::make_shared<AsyncCreateReplicas>(
+          master_, worker_pool_.get(), entry.first.first, batch);
+      batch.front().tablet->table()->AddTask(task);
+      WARN_NOT_OK(task->Run(), "Failed to send new tablets request");
     }
   }
 }
@@ -4744,6 +5005,7 @@ Status CatalogManager::BuildLocationsForTablet(const scoped_refptr<TabletInfo>&
 
   TabletInfo::ReplicaMap locs;
   consensus::ConsensusStatePB cstate;
+  uint64_t locations_version;
   {
     auto l_tablet = tablet->LockForRead();
     if (PREDICT_FALSE(l_tablet->data().is_deleted())) {
@@ -4754,6 +5016,15 @@ Status CatalogManager::BuildLocationsForTablet(const scoped_refptr<TabletInfo>&
       return STATUS(ServiceUnavailable, "Tablet not running");
     }
 
+    auto cached_locations = tablet->cached_locations();
+    if (cached_locations) {
+      *locs_pb = *cached_locations;
+      return Status::OK();
+    }
+
+    // Version should be picked before replica locations, so locations that are changed
+    // concurrently are not cached with an old version.
+    locations_version = tablet->locations_version();
     tablet->GetReplicaLocations(&locs);
     if (locs.empty() && l_tablet->data().pb.has_committed_consensus_state()) {
       cstate = l_tablet->data().pb.committed_consensus_state();
@@ -4785,6 +5056,7 @@ Status CatalogManager::BuildLocationsForTablet(const scoped_refptr<TabletInfo>&
       replica_pb->mutable_ts_info()->mutable_cloud_info()->Swap(
           tsinfo_pb.mutable_registration()->mutable_common()->mutable_cloud_info());
     }
+    tablet->SetCachedLocations(locations_version, std::make_shared<TabletLocationsPB>(*locs_pb));
     return Status::OK();
   }
 
@@ -4801,11 +5073,8 @@ Status CatalogManager::RetrieveSystemTablet(const TabletId& tablet_id,
                                             std::shared_ptr<tablet::AbstractTablet>* tablet) {
   RETURN_NOT_OK(CheckOnline());
   scoped_refptr<TabletInfo> tablet_info;
-  {
-    boost::shared_lock<LockType> l(lock_);
-    if (!FindCopy(tablet_map_, tablet_id, &tablet_info)) {
-      return STATUS(NotFound, Substitute("Unknown tablet $0", tablet_id));
-    }
+  if (!FindCopy(*tablet_map_.Snapshot(), tablet_id, &tablet_info)) {
+    return STATUS(NotFound, Substitute("Unknown tablet $0", tablet_id));
   }
 
   if (!tablet_info->IsSupportedSystemTable(sys_tables_handler_.supported_system_tables())) {
@@ -4823,11 +5092,8 @@ Status CatalogManager::GetTabletLocations(const TabletId& tablet_id,
 
   locs_pb->mutable_replicas()->Clear();
   scoped_refptr<TabletInfo> tablet_info;
-  {
-    boost::shared_lock<LockType> l(lock_);
-    if (!FindCopy(tablet_map_, tablet_id, &tablet_info)) {
-      return STATUS(NotFound, Substitute("Unknown tablet $0", tablet_id));
-    }
+  if (!FindCopy(*tablet_map_.Snapshot(), tablet_id, &tablet_info)) {
+    return STATUS(NotFound, Substitute("Unknown tablet $0", tablet_id));
   }
 
   Status s = BuildLocationsForTablet(tablet_info, locs_pb);
@@ -4877,10 +5143,20 @@ Status CatalogManager::GetTableLocations(const GetTableLocationsRequestPB* req,
     return SetupError(resp->mutable_error(), MasterErrorPB::TABLE_NOT_FOUND, s);
   }
 
+  // Picked before looking at tablets, so changes that happen while the response is built have
+  // greater versions and are returned by the next request.
+  resp->set_locations_version(TabletInfo::CurrentLocationsVersion());
+
   vector<scoped_refptr<TabletInfo>> tablets_in_range;
   table->GetTabletsInRange(req, &tablets_in_range);
 
   for (const scoped_refptr<TabletInfo>& tablet : tablets_in_range) {
+    // Locations of system tablets are built from the master config, so they are always returned.
+    if (req->has_known_locations_version() &&
+        !tablet->IsSupportedSystemTable(sys_tables_handler_.supported_system_tables()) &&
+        tablet->locations_version() <= req->known_locations_version()) {
+      continue;
+    }
     if (!BuildLocationsForTablet(tablet, resp->add_tablet_locations()).ok()) {
       // Not running.
       resp->mutable_tablet_locations()->RemoveLast();
@@ -4916,9 +5192,9 @@ void CatalogManager::DumpState(std::ostream* out, bool on_disk_dump) const {
   {
     boost::shared_lock<LockType> l(lock_);
     namespace_ids_copy = namespace_ids_map_;
-    ids_copy = table_ids_map_;
+    ids_copy = *table_ids_map_;
     names_copy = table_names_map_;
-    tablets_copy = tablet_map_;
+    tablets_copy = *tablet_map_;
   }
 
   *out << "Dumping Current state of master.\nNamespaces:\n";
@@ -5039,6 +5315,101 @@ void CatalogManager::ReportMetrics() {
   metric_num_tablet_servers_live_->set_value(ts_descs.size());
 }
 
+void CatalogManager::ProcessTabletMetrics(const TServerMetricsPB& metrics) {
+  if (metrics.tablet_metrics().empty()) {
+    return;
+  }
+  auto tablet_map = tablet_map_.Snapshot();
+  for (const auto& tablet_metrics : metrics.tablet_metrics()) {
+    scoped_refptr<TabletInfo> tablet;
+    if (FindCopy(*tablet_map, tablet_metrics.tablet_id(), &tablet)) {
+      tablet->set_leader_metrics(tablet_metrics);
+    }
+  }
+}
+
+void CatalogManager::InvalidateTabletLocations(const TabletServerId& ts_uuid) {
+  auto tablet_map = tablet_map_.Snapshot();
+  for (const auto& entry : *tablet_map) {
+    TabletInfo::ReplicaMap locs;
+    entry.second->GetReplicaLocations(&locs);
+    if (ContainsKey(locs, ts_uuid)) {
+      entry.second->InvalidateLocations();
+    }
+  }
+}
+
+void CatalogManager::FindTabletSplitCandidates() {
+  const auto now = MonoTime::Now();
+  if (last_split_candidates_check_.Initialized() &&
+      now < last_split_candidates_check_ +
+                MonoDelta::FromMilliseconds(FLAGS_tablet_split_check_interval_ms)) {
+    return;
+  }
+  last_split_candidates_check_ = now;
+
+  auto tablet_map = tablet_map_.Snapshot();
+  for (const auto& entry : *tablet_map) {
+    const auto& tablet = entry.second;
+    if (!tablet->table() || IsSystemTable(*tablet->table())) {
+      continue;
+    }
+    const auto metrics = tablet->leader_metrics();
+    const bool too_large = FLAGS_tablet_split_size_threshold_bytes > 0 &&
+                           metrics.sst_file_size() > FLAGS_tablet_split_size_threshold_bytes;
+    const bool too_hot = FLAGS_tablet_split_write_ops_per_sec_threshold > 0 &&
+                         metrics.write_ops_per_sec() >
+                             FLAGS_tablet_split_write_ops_per_sec_threshold;
+    if (!too_large && !too_hot) {
+      continue;
+    }
+    if (!too_large && metrics.hottest_key_share() > FLAGS_tablet_split_max_hottest_key_share) {
+      LOG(INFO) << LogPrefix() << "Tablet " << tablet->ToString() << " is not split, its "
+                << "hottest key " << Slice(metrics.hottest_key()).ToDebugHexString()
+                << " receives " << metrics.hottest_key_share() * 100 << "% of accesses";
+      continue;
+    }
+
+    PartitionPB partition;
+    {
+      auto l = tablet->LockForRead();
+      if (!l->data().is_running()) {
+        continue;
+      }
+      partition = l->data().pb.partition();
+    }
+    {
+      auto l = tablet->table()->LockForRead();
+      if (!l->data().pb.partition_schema().has_hash_schema()) {
+        continue;
+      }
+    }
+
+    const auto split_key = HashMidpointSplitKey(partition);
+    if (split_key.empty()) {
+      continue;
+    }
+    // TODO: split the tablet online. Child tablets should initially share parent SST files
+    // restricted to their key ranges, and clients should refresh their meta cache.
+    LOG(INFO) << LogPrefix() << "Tablet " << tablet->ToString() << " is a split candidate, "
+              << "SST size: " << metrics.sst_file_size()
+              << ", write ops/sec: " << metrics.write_ops_per_sec()
+              << ", split key: " << Slice(split_key).ToDebugHexString();
+  }
+}
+
+std::string CatalogManager::HashMidpointSplitKey(const PartitionPB& partition) {
+  const uint32_t start = partition.partition_key_start().empty()
+      ? 0 : PartitionSchema::DecodeMultiColumnHashValue(partition.partition_key_start());
+  const uint32_t end = partition.partition_key_end().empty()
+      ? PartitionSchema::kMaxPartitionKey + 1
+      : PartitionSchema::DecodeMultiColumnHashValue(partition.partition_key_end());
+  if (end - start < 2) {
+    return std::string();
+  }
+  return PartitionSchema::EncodeMultiColumnHashValue(start + (end - start) / 2);
+}
+
 std::string CatalogManager::LogPrefix() const {
   if (tablet_peer()) {
     return Substitute("T $0 P $1: ", tablet_peer()->tablet_id(), tablet_peer()->permanent_uuid());
@@ -5095,7 +5466,7 @@ Status CatalogManager::SetBlackList(const BlacklistPB& blacklist) {
   }
 
   LOG(INFO) << "Set blacklist size = " << blacklist.hosts_size() << " with load "
-            << blacklist.initial_replica_load() << " for num_tablets = " << tablet_map_.size();
+            << blacklist.initial_replica_load() << " for num_tablets = " << tablet_map_.Snapshot()->size();
 
   for (const auto& pb : blacklist.hosts()) {
     HostPort hp;
@@ -5185,6 +5556,87 @@ Status CatalogManager::IsLoadBalanced(const IsLoadBalancedRequestPB* req,
   return Status::OK();
 }
 
+Status CatalogManager::DrainLeaders(const DrainLeadersRequestPB* req,
+                                    DrainLeadersResponsePB* resp) {
+  const TabletServerId& drained_uuid = req->ts_uuid();
+  if (drained_uuid.empty()) {
+    Status s = STATUS(InvalidArgument, "Tablet server uuid is required");
+    return SetupError(resp->mutable_error(), MasterErrorPB::INVALID_REQUEST, s);
+  }
+
+  // Live, non-blacklisted tablet servers that can take over leaderships.
+  TSDescriptorVector ts_descs;
+  master_->ts_manager()->GetAllLiveDescriptors(&ts_descs);
+  std::unordered_set<TabletServerId> eligible_targets;
+  for (const auto& ts_desc : ts_descs) {
+    TSRegistrationPB reg;
+    ts_desc->GetRegistration(&reg);
+    HostPort hp;
+    HostPortFromPB(reg.common().rpc_addresses(0), &hp);
+    if (ts_desc->permanent_uuid() != drained_uuid && blacklistState.tservers_.count(hp) == 0) {
+      eligible_targets.insert(ts_desc->permanent_uuid());
+    }
+  }
+
+  // Count the leaders of every server and collect the tablets led by the drained one, so new
+  // leaders can be spread by load.
+  std::unordered_map<TabletServerId, int> leader_counts;
+  std::vector<scoped_refptr<TabletInfo>> drained_tablets;
+  {
+    std::lock_guard<LockType> tablet_map_lock(lock_);
+    for (const auto& entry : *tablet_map_) {
+      const scoped_refptr<TabletInfo>& tablet = entry.second;
+      auto l = tablet->LockForRead();
+      if (!tablet->table() || l->data().is_deleted()) {
+        continue;
+      }
+      const auto& leader_uuid = l->data().pb.committed_consensus_state().leader_uuid();
+      ++leader_counts[leader_uuid];
+      if (leader_uuid == drained_uuid) {
+        drained_tablets.push_back(tablet);
+      }
+    }
+  }
+
+  int num_transfers = 0;
+  for (const auto& tablet : drained_tablets) {
+    TabletInfo::ReplicaMap locs;
+    tablet->GetReplicaLocations(&locs);
+    auto l = tablet->LockForRead();
+    const ConsensusStatePB& cstate = l->data().pb.committed_consensus_state();
+
+    TabletServerId target;
+    for (const auto& peer : cstate.config().peers()) {
+      const auto& uuid = peer.permanent_uuid();
+      if (peer.member_type() != RaftPeerPB::VOTER || eligible_targets.count(uuid) == 0) {
+        continue;
+      }
+      auto it = locs.find(uuid);
+      if (it == locs.end() || it->second.state != tablet::RUNNING) {
+        continue;
+      }
+      if (target.empty() || leader_counts[uuid] < leader_counts[target]) {
+        target = uuid;
+      }
+    }
+
+    if (target.empty()) {
+      resp->add_tablets_without_target(tablet->tablet_id());
+      continue;
+    }
+    ++leader_counts[target];
+    --leader_counts[drained_uuid];
+    SendLeaderStepDownRequest(tablet, cstate, drained_uuid, false /* should_remove */, target);
+    ++num_transfers;
+  }
+
+  LOG(INFO) << "Draining leaders of " << drained_uuid << ": started " << num_transfers
+            << " leader transfers, " << resp->tablets_without_target_size()
+            << " tablets have no eligible new leader";
+  resp->set_num_transfers(num_transfers);
+  return Status::OK();
+}
+
 void BlacklistState::Reset() {
   tservers_.clear();
   initial_load_ = 0;
@@ -5198,7 +5650,7 @@ std::string BlacklistState::ToString() {
 int64_t CatalogManager::GetNumBlacklistReplicas() {
   int64_t blacklist_replicas = 0;
   std::lock_guard <LockType> tablet_map_lock(lock_);
-  for (const TabletInfoMap::value_type& entry : tablet_map_) {
+  for (const TabletInfoMap::value_type& entry : *tablet_map_) {
     scoped_refptr<TabletInfo> tablet = entry.second;
     auto l = tablet->LockForRead();
     // Not checking being created on purpose as we do not want initial load to be under accounted.
@@ -5225,7 +5677,7 @@ int64_t CatalogManager::GetNumBlacklistReplicas() {
 
 Status CatalogManager::GetLoadMoveCompletionPercent(GetLoadMovePercentResponsePB* resp) {
   int64_t blacklist_replicas = GetNumBlacklistReplicas();
-  LOG(INFO) << "Blacklisted count " << blacklist_replicas << " in " << tablet_map_.size()
+  LOG(INFO) << "Blacklisted count " << blacklist_replicas << " in " << tablet_map_.Snapshot()->size()
             << " tablets, across " << blacklistState.tservers_.size()
             << " servers, with initial load " << blacklistState.initial_load_;
 
@@ -5313,12 +5765,19 @@ CatalogManager::ScopedLeaderSharedLock::ScopedLeaderSharedLock(CatalogManager* c
 // TabletInfo
 ////////////////////////////////////////////////////////////
 
+namespace {
+
+std::atomic<uint64_t> tablet_locations_version{0};
+
+} // namespace
+
 TabletInfo::TabletInfo(const scoped_refptr<TableInfo>& table,
                        TabletId tablet_id)
     : tablet_id_(std::move(tablet_id)),
       table_(table),
       last_update_time_(MonoTime::Now()),
-      reported_schema_version_(0) {}
+      reported_schema_version_(0),
+      locations_version_(NextLocationsVersion()) {}
 
 TabletInfo::~TabletInfo() {
 }
@@ -5327,6 +5786,8 @@ void TabletInfo::SetReplicaLocations(ReplicaMap replica_locations) {
   std::lock_guard<simple_spinlock> l(lock_);
   last_update_time_ = MonoTime::Now();
   replica_locations_ = std::move(replica_locations);
+  locations_version_ = NextLocationsVersion();
+  cached_locations_.reset();
 }
 
 void TabletInfo::GetReplicaLocations(ReplicaMap* replica_locations) const {
@@ -5336,7 +5797,51 @@ void TabletInfo::GetReplicaLocations(ReplicaMap* replica_locations) const {
 
 bool TabletInfo::AddToReplicaLocations(const TabletReplica& replica) {
   std::lock_guard<simple_spinlock> l(lock_);
-  return InsertIfNotPresent(&replica_locations_, replica.ts_desc->permanent_uuid(), replica);
+  if (!InsertIfNotPresent(&replica_locations_, replica.ts_desc->permanent_uuid(), replica)) {
+    return false;
+  }
+  locations_version_ = NextLocationsVersion();
+  cached_locations_.reset();
+  return true;
+}
+
+uint64_t TabletInfo::locations_version() const {
+  std::lock_guard<simple_spinlock> l(lock_);
+  return locations_version_;
+}
+
+void TabletInfo::InvalidateLocations() {
+  std::lock_guard<simple_spinlock> l(lock_);
+  locations_version_ = NextLocationsVersion();
+  cached_locations_.reset();
+}
+
+std::shared_ptr<const TabletLocationsPB> TabletInfo::cached_locations() const {
+  std::lock_guard<simple_spinlock> l(lock_);
+  return cached_locations_;
+}
+
+void TabletInfo::SetCachedLocations(
+    uint64_t version, std::shared_ptr<const TabletLocationsPB> locations) {
+  std::lock_guard<simple_spinlock> l(lock_);
+  if (version == locations_version_) {
+    cached_locations_ = std::move(locations);
+  }
+}
+
+uint64_t TabletInfo::NextLocationsVersion() {
+  return tablet_locations_version.fetch_add(1, std::memory_order_acq_rel) + 1;
+}
+
+uint64_t TabletInfo::CurrentLocationsVersion() {
+  return tablet_locations_version.load(std::memory_order_acquire);
+}
+
+void TabletInfo::AdvanceLocationsVersion(uint64_t min_version) {
+  auto current = tablet_locations_version.load(std::memory_order_acquire);
+  while (current < min_version &&
+         !tablet_locations_version.compare_exchange_weak(current, min_version)) {
+  }
 }
 
 void TabletInfo::set_last_update_time(const MonoTime& ts) {
@@ -5363,6 +5868,16 @@ uint32_t TabletInfo::reported_schema_version() const {
   return reported_schema_version_;
 }
 
+void TabletInfo::set_leader_metrics(const TabletMetricsPB& metrics) {
+  std::lock_guard<simple_spinlock> l(lock_);
+  leader_metrics_ = metrics;
+}
+
+TabletMetricsPB TabletInfo::leader_metrics() const {
+  std::lock_guard<simple_spinlock> l(lock_);
+  return leader_metrics_;
+}
+
 bool TabletInfo::IsSupportedSystemTable(const SystemTableSet& supported_system_tables) const {
   return table_->IsSupportedSystemTable(supported_system_tables);
 }
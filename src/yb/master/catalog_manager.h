@@ -231,6 +231,30 @@ class TabletInfo : public RefCountedThreadSafe<TabletInfo>,
   // Returns true iff the replica was inserted.
   bool AddToReplicaLocations(const TabletReplica& replica);
 
+  // Version of the locations of this tablet, it is increased every time replica locations or
+  // committed metadata of the tablet change. Versions of all tablets are taken from the same
+  // counter, see NextLocationsVersion.
+  uint64_t locations_version() const;
+
+  // Increases the locations version and drops cached locations.
+  void InvalidateLocations();
+
+  // Locations built for the current locations version, or null if they were not built yet.
+  std::shared_ptr<const TabletLocationsPB> cached_locations() const;
+
+  // Caches locations built for the specified version, unless the locations have changed since then.
+  void SetCachedLocations(uint64_t version, std::shared_ptr<const TabletLocationsPB> locations);
+
+  // Returns a new locations version, greater than any version returned before.
+  static uint64_t NextLocationsVersion();
+
+  // Returns the latest returned locations version.
+  static uint64_t CurrentLocationsVersion();
+
+  // Makes sure that new locations versions are greater than min_version. Used to keep versions
+  // increasing across master leader changes.
+  static void AdvanceLocationsVersion(uint64_t min_version);
+
   // Accessors for the last time the replica locations were updated.
   void set_last_update_time(const MonoTime& ts);
   MonoTime last_update_time() const;
@@ -239,6 +263,10 @@ class TabletInfo : public RefCountedThreadSafe<TabletInfo>,
   bool set_reported_schema_version(uint32_t version);
   uint32_t reported_schema_version() const;
 
+  // Accessors for the metrics last reported by the tablet leader (in-memory only).
+  void set_leader_metrics(const TabletMetricsPB& metrics);
+  TabletMetricsPB leader_metrics() const;
+
   // No synchronization needed.
   std::string ToString() const override;
 
@@ -278,6 +306,12 @@ class TabletInfo : public RefCountedThreadSafe<TabletInfo>,
   // Reported schema version (in-memory only).
   uint32_t reported_schema_version_ = 0;
 
+  // Metrics reported by the tablet leader (in-memory only).
+  TabletMetricsPB leader_metrics_;
+
+  uint64_t locations_version_;
+  std::shared_ptr<const TabletLocationsPB> cached_locations_;
+
   LeaderStepDownFailureTimes leader_stepdown_failure_times_;
 
   DISALLOW_COPY_AND_ASSIGN(TabletInfo);
@@ -811,6 +845,17 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
                                      TabletReportUpdatesPB *report_update,
                                      rpc::RpcContext* rpc);
 
+  // Stores per tablet metrics reported by the leaders of those tablets in the heartbeat.
+  void ProcessTabletMetrics(const TServerMetricsPB& metrics);
+
+  // Drops cached locations of tablets that have replicas on the specified tablet server, since
+  // they contain its registration, e.g. RPC addresses.
+  void InvalidateTabletLocations(const TabletServerId& ts_uuid);
+
+  // Returns the key that splits the hash range of the tablet in half, or empty string if the
+  // tablet could not be split on a hash midpoint.
+  static std::string HashMidpointSplitKey(const PartitionPB& partition);
+
   // Create a new Namespace with the specified attributes.
   //
   // The RPC context is provided for logging/tracing purposes,
@@ -991,6 +1036,10 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   CHECKED_STATUS IsLoadBalanced(const IsLoadBalancedRequestPB* req,
                                 IsLoadBalancedResponsePB* resp);
 
+  // Start leader step downs for all tablets led by the given tablet server, concurrently, each
+  // to the least loaded eligible follower.
+  CHECKED_STATUS DrainLeaders(const DrainLeadersRequestPB* req, DrainLeadersResponsePB* resp);
+
   // Clears out the existing metadata ('table_names_map_', 'table_ids_map_',
   // and 'tablet_map_'), loads tables metadata into memory and if successful
   // loads the tablets metadata.
@@ -1140,11 +1189,27 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   CHECKED_STATUS FindTable(const TableIdentifierPB& table_identifier,
                            scoped_refptr<TableInfo>* table_info);
 
+  // Reported tablet, whose sys catalog update and follow up actions are batched with other
+  // tablets of the same tablet report.
+  struct ReportedTabletUpdate {
+    scoped_refptr<TabletInfo> tablet;
+    // Write lock of the modified tablet, nullptr if the report did not change the tablet.
+    std::unique_ptr<TabletInfo::lock_type> tablet_lock;
+    bool needs_alter = false;
+    boost::optional<uint32_t> schema_version;
+  };
+
   // Handle one of the tablets in a tablet reported.
   // Requires that the lock is already held.
+  // Tablets to update are added to 'updates', to be applied by ApplyReportedTabletUpdates().
   CHECKED_STATUS HandleReportedTablet(TSDescriptor* ts_desc,
                               const ReportedTabletPB& report,
-                              ReportedTabletUpdatesPB *report_updates);
+                              ReportedTabletUpdatesPB *report_updates,
+                              std::vector<ReportedTabletUpdate>* updates);
+
+  // Writes modified tablets to sys catalog in one batch, commits them and sends alter requests
+  // or processes schema versions reported for them.
+  CHECKED_STATUS ApplyReportedTabletUpdates(std::vector<ReportedTabletUpdate>* updates);
 
   CHECKED_STATUS ResetTabletReplicasFromReportedConfig(const ReportedTabletPB& report,
                                                const scoped_refptr<TabletInfo>& tablet,
@@ -1260,6 +1325,13 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   // to the tablet servers to delete them.
   void DeleteTabletsAndSendRequests(const scoped_refptr<TableInfo>& table);
 
+  // Send the "delete tablets request" for the specified tablets of the table to the specified TS.
+  // The specified 'reason' will be logged on the TS.
+  void SendDeleteTabletsRequest(const std::vector<TabletId>& tablet_ids,
+                                const scoped_refptr<TableInfo>& table,
+                                TSDescriptor* ts_desc,
+                                const std::string& reason);
+
   // Send the "delete tablet request" to the specified TS/tablet.
   // The specified 'reason' will be logged on the TS.
   void SendDeleteTabletRequest(const TabletId& tablet_id,
@@ -1315,6 +1387,9 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   // Report metrics.
   void ReportMetrics();
 
+  // Finds tablets whose leader reported SST size or write rate above the split thresholds.
+  void FindTabletSplitCandidates();
+
   // Conventional "T xxx P yyy: " prefix for logging.
   std::string LogPrefix() const;
 
@@ -1359,14 +1434,17 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   typedef rw_spinlock LockType;
   mutable LockType lock_;
 
-  TableInfoMap table_ids_map_;         // Table map: table-id -> TableInfo
+  // Table id and tablet maps are modified under lock_ held exclusively. Since they are copied on
+  // modification, lookups by id, e.g. for table and tablet locations, use snapshots without
+  // taking lock_, so they never wait behind DDL or tablet report processing.
+  CowSnapshot<TableInfoMap> table_ids_map_;  // Table map: table-id -> TableInfo
   TableInfoByNameMap table_names_map_; // Table map: [namespace-id, table-name] -> TableInfo
 
   DeletedTabletMap deleted_tablet_map_; // Deleted Tablets map:
                                         // [tserver-id, tablet-id] -> DeletedTableInfo
 
   // Tablet maps: tablet-id -> TabletInfo
-  TabletInfoMap tablet_map_;
+  CowSnapshot<TabletInfoMap> tablet_map_;
 
   // Namespace maps: namespace-id -> NamespaceInfo and namespace-name -> NamespaceInfo
   typedef std::unordered_map<NamespaceName, scoped_refptr<NamespaceInfo> > NamespaceInfoMap;
@@ -1450,10 +1528,14 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   // Async operations are accessing some private methods
   // (TODO: this stuff should be deferred and done in the background thread)
   friend class AsyncAlterTable;
+  friend class AsyncAlterTablets;
 
   // Number of live tservers metric.
   scoped_refptr<AtomicGauge<uint32_t>> metric_num_tablet_servers_live_;
 
+  // Last time split candidates were looked for, accessed only by the background tasks thread.
+  MonoTime last_split_candidates_check_;
+
   friend class ClusterLoadBalancer;
 
   // Policy for load balancing tablets on tablet servers.
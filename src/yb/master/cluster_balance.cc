@@ -14,12 +14,14 @@
 #include "yb/master/cluster_balance.h"
 
 #include <algorithm>
+#include <cmath>
 #include <memory>
 
 #include <boost/thread/locks.hpp>
 
 #include "yb/consensus/quorum_util.h"
 #include "yb/master/master.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/random_util.h"
 
 DEFINE_bool(enable_load_balancing,
@@ -60,6 +62,28 @@ DEFINE_int32(load_balancer_max_concurrent_moves,
              "Maximum number of tablet leaders on tablet servers to move in any one run of the "
              "load balancer.");
 
+DEFINE_bool(load_balancer_weighted_load,
+            false,
+            "Balance tablet replicas and leaders by their weighted load, derived from the SST size "
+            "and request rate reported by tablet leaders, instead of by their count.");
+TAG_FLAG(load_balancer_weighted_load, experimental);
+
+DEFINE_double(load_balancer_sst_size_weight,
+              1.0,
+              "Weight of the relative SST size of a tablet in its weighted load.");
+TAG_FLAG(load_balancer_sst_size_weight, experimental);
+
+DEFINE_double(load_balancer_ops_weight,
+              1.0,
+              "Weight of the relative read and write rate of a tablet in its weighted load.");
+TAG_FLAG(load_balancer_ops_weight, experimental);
+
+DEFINE_double(load_balancer_max_cpu_utilization,
+              0.9,
+              "With weighted load, tablet servers using more than this fraction of their CPUs do "
+              "not receive moved replicas or leaders. 0 disables the check.");
+TAG_FLAG(load_balancer_max_cpu_utilization, experimental);
+
 DECLARE_int32(min_leader_stepdown_retry_interval_ms);
 
 namespace yb {
@@ -227,6 +251,33 @@ bool ClusterLoadBalancer::AnalyzeTablets(const TableId& table_uuid) {
   // Set the blacklist so we can also mark the tablet servers as we add them up.
   state_->SetBlacklist(GetServerBlacklist());
 
+  // Set the affinitized zones, so leader load is only tracked for tablet servers in them. A custom
+  // per-table setting takes precedence over the cluster one.
+  AffinitizedZonesSet affinitized_zones;
+  const auto table = GetTableInfo(table_uuid);
+  if (table) {
+    auto l = table->LockForRead();
+    for (const auto& ci : l->data().pb.replication_info().affinitized_leaders()) {
+      affinitized_zones.insert(ci);
+    }
+  }
+  if (affinitized_zones.empty()) {
+    GetAllAffinitizedZones(&affinitized_zones);
+  }
+  state_->SetAffinitizedZones(affinitized_zones);
+
+  // Set the read replica placement, so servers in it only get read replicas. The table setting
+  // takes precedence here as well.
+  PlacementInfoPB read_replica_placement;
+  if (table) {
+    auto l = table->LockForRead();
+    read_replica_placement = l->data().pb.replication_info().async_replicas();
+  }
+  if (read_replica_placement.placement_blocks().empty()) {
+    read_replica_placement = GetClusterReadReplicaPlacementInfo();
+  }
+  state_->SetReadReplicaPlacement(read_replica_placement);
+
   // Loop over live tablet servers to set empty defaults, so we can also have info on those
   // servers that have yet to receive load (have heartbeated to the master, but have not been
   // assigned any tablets yet).
@@ -235,6 +286,7 @@ bool ClusterLoadBalancer::AnalyzeTablets(const TableId& table_uuid) {
   for (const auto ts_desc : ts_descs) {
     state_->UpdateTabletServer(ts_desc);
   }
+  state_->FallBackIfNoAffinitizedServers();
 
   vector<scoped_refptr<TabletInfo>> tablets;
   Status s = GetTabletsForTable(table_uuid, &tablets);
@@ -277,6 +329,10 @@ bool ClusterLoadBalancer::AnalyzeTablets(const TableId& table_uuid) {
   // low for the given configuration.
   state_->AdjustLeaderBalanceThreshold();
 
+  // Tablet weights are relative to the average tablet of the table, so they could only be computed
+  // once all tablets are known.
+  state_->ComputeTabletWeights();
+
   // Once we've analyzed both the tablet server information as well as the tablets, we can sort the
   // load and are ready to apply the load balancing rules.
   state_->SortLoad();
@@ -371,6 +427,21 @@ bool ClusterLoadBalancer::HandleAddIfWrongPlacement(
   return false;
 }
 
+bool ClusterLoadBalancer::HandleAddReadReplicas(
+    TabletId* out_tablet_id, TabletServerId* out_to_ts) {
+  for (const auto& entry : state_->per_tablet_meta_) {
+    const auto& tablet_id = entry.first;
+    if (state_->GetMissingReadReplica(tablet_id, out_to_ts)) {
+      *out_tablet_id = tablet_id;
+      LOG(INFO) << Substitute("Adding read replica of tablet $0 to $1", tablet_id, *out_to_ts);
+      SendAddReadReplicaRequest(GetTabletMap().at(tablet_id), *out_to_ts);
+      state_->AddReadReplica(tablet_id, *out_to_ts);
+      return true;
+    }
+  }
+  return false;
+}
+
 bool ClusterLoadBalancer::HandleAddReplicas(
     TabletId* out_tablet_id, TabletServerId* out_from_ts, TabletServerId* out_to_ts) {
   if (options_.kAllowLimitStartingTablets &&
@@ -402,6 +473,11 @@ bool ClusterLoadBalancer::HandleAddReplicas(
     return true;
   }
 
+  // Read replicas do not affect the live replicas, so they are added once those are placed.
+  if (HandleAddReadReplicas(out_tablet_id, out_to_ts)) {
+    return true;
+  }
+
   // Finally, handle normal load balancing.
   if (!GetLoadToMove(out_tablet_id, out_from_ts, out_to_ts)) {
     VLOG(1) << "Cannot find any more tablets to move, under current constraints.";
@@ -420,7 +496,7 @@ void ClusterLoadBalancer::DumpSortedLoad() const {
   out << "Table load: ";
   for (int left = 0; left <= last_pos; ++left) {
     const TabletServerId& uuid = state_->sorted_load_[left];
-    int load = state_->GetLoad(uuid);
+    double load = state_->GetLoad(uuid);
     out << uuid << ":" << load << " ";
   }
   VLOG(1) << out.str();
@@ -457,7 +533,7 @@ bool ClusterLoadBalancer::GetLoadToMove(
     for (int right = last_pos; right >= 0; --right) {
       const TabletServerId& low_load_uuid = state_->sorted_load_[left];
       const TabletServerId& high_load_uuid = state_->sorted_load_[right];
-      int load_variance = state_->GetLoad(high_load_uuid) - state_->GetLoad(low_load_uuid);
+      double load_variance = state_->GetLoad(high_load_uuid) - state_->GetLoad(low_load_uuid);
 
       // Check for state change or end conditions.
       if (left == right || load_variance < options_.kMinLoadVarianceToBalance) {
@@ -470,8 +546,13 @@ bool ClusterLoadBalancer::GetLoadToMove(
         }
       }
 
+      // Busy servers do not receive load, even if their weighted load is low.
+      if (state_->IsOverloaded(low_load_uuid)) {
+        break;
+      }
+
       // If we don't find a tablet_id to move between these two TSs, advance the state.
-      if (GetTabletToMove(high_load_uuid, low_load_uuid, moving_tablet_id)) {
+      if (GetTabletToMove(high_load_uuid, low_load_uuid, load_variance, moving_tablet_id)) {
         // If we got this far, we have the candidate we want, so fill in the output params and
         // return. The tablet_id is filled in from GetTabletToMove.
         *from_ts = high_load_uuid;
@@ -510,7 +591,8 @@ bool ClusterLoadBalancer::SkipLeaderAsVictim(const TabletId& tablet_id) const {
 }
 
 bool ClusterLoadBalancer::GetTabletToMove(
-    const TabletServerId& from_ts, const TabletServerId& to_ts, TabletId* moving_tablet_id) {
+    const TabletServerId& from_ts, const TabletServerId& to_ts, double load_variance,
+    TabletId* moving_tablet_id) {
   const auto& from_ts_meta = state_->per_ts_meta_[from_ts];
   set<TabletId> non_over_replicated_tablets;
   set<TabletId> all_tablets;
@@ -534,6 +616,11 @@ bool ClusterLoadBalancer::GetTabletToMove(
 
   bool same_placement = state_->per_ts_meta_[from_ts].descriptor->placement_id() ==
                         state_->per_ts_meta_[to_ts].descriptor->placement_id();
+  // With weighted load, moving a tablet of weight w changes the load difference between the two
+  // servers to |load_variance - 2w|. So pick the tablet that leaves the smallest difference, and
+  // only if it is smaller than the current one.
+  bool found = false;
+  double best_variance = load_variance;
   for (const auto& tablet_id : non_over_replicated_tablets) {
     const auto& placement_info = GetPlacementByTablet(tablet_id);
     // TODO(bogdan): this should be augmented as well to allow dropping by one replica, if still
@@ -544,6 +631,10 @@ bool ClusterLoadBalancer::GetTabletToMove(
     if (!placement_info.placement_blocks().empty() && !same_placement) {
       continue;
     }
+    // The replacement of a log-only replica would be a full replica, so do not move it.
+    if (state_->per_tablet_meta_[tablet_id].log_only_tablet_servers.count(from_ts)) {
+      continue;
+    }
     // Skip this tablet if we are trying to move away from the leader, as we would like to avoid
     // extra leader stepdowns. If table is in RF > 1 universe only, we skip leader as victim here.
     if (state_->per_tablet_meta_[tablet_id].leader_uuid == from_ts &&
@@ -553,11 +644,20 @@ bool ClusterLoadBalancer::GetTabletToMove(
     // If we got here, it means we either have no placement, in which case we can pick any TS, or
     // we have placement and it's valid to move across these two tablet servers, so set the tablet
     // and leave.
-    *moving_tablet_id = tablet_id;
-    return true;
+    if (!FLAGS_load_balancer_weighted_load) {
+      *moving_tablet_id = tablet_id;
+      return true;
+    }
+    const double variance_after_move =
+        std::abs(load_variance - 2 * state_->GetTabletWeight(tablet_id));
+    if (variance_after_move < best_variance) {
+      *moving_tablet_id = tablet_id;
+      best_variance = variance_after_move;
+      found = true;
+    }
   }
   // If we couldn't select a tablet above, we have to return failure.
-  return false;
+  return found;
 }
 
 bool ClusterLoadBalancer::GetLeaderToMove(
@@ -594,7 +694,7 @@ bool ClusterLoadBalancer::GetLeaderToMove(
     for (int right = last_pos; right >= 0; --right) {
       const TabletServerId& low_load_uuid = state_->sorted_leader_load_[left];
       const TabletServerId& high_load_uuid = state_->sorted_leader_load_[right];
-      int load_variance =
+      double load_variance =
           state_->GetLeaderLoad(high_load_uuid) - state_->GetLeaderLoad(low_load_uuid);
 
       // Check for state change or end conditions.
@@ -616,7 +716,20 @@ bool ClusterLoadBalancer::GetLeaderToMove(
       const auto& itr = std::inserter(intersection, intersection.begin());
       std::set_intersection(leaders.begin(), leaders.end(), peers.begin(), peers.end(), itr);
 
+      if (state_->IsOverloaded(low_load_uuid)) {
+        break;
+      }
+
       for (const auto& tablet_id : intersection) {
+        // Moving the leader should reduce the weighted load difference between the two servers.
+        if (FLAGS_load_balancer_weighted_load &&
+            state_->GetTabletLeaderWeight(tablet_id) >= load_variance) {
+          continue;
+        }
+        // A log-only replica could not become leader.
+        if (state_->per_tablet_meta_[tablet_id].log_only_tablet_servers.count(low_load_uuid)) {
+          continue;
+        }
         *moving_tablet_id = tablet_id;
         *from_ts = high_load_uuid;
         *to_ts = low_load_uuid;
@@ -723,9 +836,46 @@ bool ClusterLoadBalancer::HandleRemoveIfWrongPlacement(
   return false;
 }
 
+bool ClusterLoadBalancer::GetLeaderToMoveIfNonAffinitized(
+    TabletId* moving_tablet_id, TabletServerId* from_ts, TabletServerId* to_ts) {
+  // Similar to normal leader balancing, we go from the most loaded non-affinitized server and try
+  // the affinitized servers from the least loaded one, until we find a leader that has a running
+  // replica on the affinitized server. There is no load variance to respect here, since all
+  // leaders should leave the non-affinitized servers.
+  const auto& non_affinitized = state_->sorted_non_affinitized_leader_load_;
+  for (auto it = non_affinitized.rbegin(); it != non_affinitized.rend(); ++it) {
+    const TabletServerId& non_affinitized_uuid = *it;
+    const set<TabletId>& leaders = state_->per_ts_meta_[non_affinitized_uuid].leaders;
+    if (leaders.empty()) {
+      // All remaining non-affinitized servers have no leaders.
+      return false;
+    }
+    for (const auto& affinitized_uuid : state_->sorted_leader_load_) {
+      if (state_->IsOverloaded(affinitized_uuid)) {
+        continue;
+      }
+      const set<TabletId>& peers = state_->per_ts_meta_[affinitized_uuid].running_tablets;
+      for (const auto& tablet_id : leaders) {
+        const auto& tablet_meta = state_->per_tablet_meta_[tablet_id];
+        if (!peers.count(tablet_id) ||
+            tablet_meta.log_only_tablet_servers.count(affinitized_uuid) ||
+            tablet_meta.leader_stepdown_failures.count(affinitized_uuid)) {
+          continue;
+        }
+        *moving_tablet_id = tablet_id;
+        *from_ts = non_affinitized_uuid;
+        *to_ts = affinitized_uuid;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 bool ClusterLoadBalancer::HandleLeaderMoves(
     TabletId* out_tablet_id, TabletServerId* out_from_ts, TabletServerId* out_to_ts) {
-  if (GetLeaderToMove(out_tablet_id, out_from_ts, out_to_ts)) {
+  if (GetLeaderToMoveIfNonAffinitized(out_tablet_id, out_from_ts, out_to_ts) ||
+      GetLeaderToMove(out_tablet_id, out_from_ts, out_to_ts)) {
     MoveLeader(*out_tablet_id, *out_from_ts, *out_to_ts);
     return true;
   }
@@ -752,8 +902,17 @@ void ClusterLoadBalancer::AddReplica(const TabletId& tablet_id, const TabletServ
 void ClusterLoadBalancer::RemoveReplica(
     const TabletId& tablet_id, const TabletServerId& ts_uuid, const bool stepdown_if_leader) {
   LOG(INFO) << Substitute("Removing replica $0 from tablet $1", ts_uuid, tablet_id);
+  // If the leader is removed, hand the leadership over to an affinitized zone right away, instead
+  // of to a random follower, that would have to be moved again.
+  TabletServerId new_leader_uuid;
+  if (state_->per_tablet_meta_[tablet_id].leader_uuid == ts_uuid) {
+    new_leader_uuid = state_->GetAffinitizedLeaderCandidate(tablet_id, ts_uuid);
+  }
   SendReplicaChanges(GetTabletMap().at(tablet_id), ts_uuid, false /* is_add */,
-                     true /* should_remove_leader */);
+                     true /* should_remove_leader */, new_leader_uuid);
+  if (!new_leader_uuid.empty()) {
+    state_->MoveLeader(tablet_id, ts_uuid, new_leader_uuid);
+  }
   state_->RemoveReplica(tablet_id, ts_uuid);
 }
 
@@ -772,7 +931,7 @@ void ClusterLoadBalancer::GetAllReportedDescriptors(TSDescriptorVector* ts_descs
 }
 
 const TabletInfoMap& ClusterLoadBalancer::GetTabletMap() const {
-  return catalog_manager_->tablet_map_;
+  return *catalog_manager_->tablet_map_;
 }
 
 const scoped_refptr<TableInfo> ClusterLoadBalancer::GetTableInfo(const TableId& table_uuid) const {
@@ -795,21 +954,32 @@ const Status ClusterLoadBalancer::GetTabletsForTable(
 }
 
 const TableInfoMap& ClusterLoadBalancer::GetTableMap() const {
-  return catalog_manager_->table_ids_map_;
+  return *catalog_manager_->table_ids_map_;
 }
 
 const PlacementInfoPB& ClusterLoadBalancer::GetClusterPlacementInfo() const {
   auto l = catalog_manager_->cluster_config_->LockForRead();
-  // TODO: this is now hardcoded to just the live replicas; this will need to change when we add
-  // support for async replication.
+  // Read replicas are balanced separately, see GetClusterReadReplicaPlacementInfo.
   return l->data().pb.replication_info().live_replicas();
 }
 
+const PlacementInfoPB& ClusterLoadBalancer::GetClusterReadReplicaPlacementInfo() const {
+  auto l = catalog_manager_->cluster_config_->LockForRead();
+  return l->data().pb.replication_info().async_replicas();
+}
+
 const BlacklistPB& ClusterLoadBalancer::GetServerBlacklist() const {
   auto l = catalog_manager_->cluster_config_->LockForRead();
   return l->data().pb.server_blacklist();
 }
 
+void ClusterLoadBalancer::GetAllAffinitizedZones(AffinitizedZonesSet* affinitized_zones) const {
+  auto l = catalog_manager_->cluster_config_->LockForRead();
+  for (const auto& ci : l->data().pb.replication_info().affinitized_leaders()) {
+    affinitized_zones->insert(ci);
+  }
+}
+
 bool ClusterLoadBalancer::SkipLoadBalancing(const TableInfo& table) const {
   // Skip load-balancing of system tables. They are virtual tables not hosted by tservers.
   return catalog_manager_->IsSystemTable(table);
@@ -870,6 +1040,14 @@ void ClusterLoadBalancer::SendReplicaChanges(
   }
 }
 
+void ClusterLoadBalancer::SendAddReadReplicaRequest(
+    scoped_refptr<TabletInfo> tablet, const TabletServerId& ts_uuid) {
+  auto l = tablet->LockForRead();
+  CHECK_EQ(state_->pending_add_replica_tasks_[tablet->table()->id()].count(tablet->tablet_id()), 0);
+  catalog_manager_->SendAddServerRequest(tablet, consensus::RaftPeerPB::PRE_OBSERVER,
+      l->data().pb.committed_consensus_state(), ts_uuid);
+}
+
 bool ClusterLoadBalancer::ConfigMemberInTransitionMode(const TabletId &tablet_id) const {
   auto tablet = GetTabletMap().at(tablet_id);
   auto l = tablet->LockForRead();
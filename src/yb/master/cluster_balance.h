@@ -142,9 +142,15 @@ class ClusterLoadBalancer {
   // Get the placement information from the cluster configuration.
   virtual const PlacementInfoPB& GetClusterPlacementInfo() const;
 
+  // Get the placement information of read replicas from the cluster configuration.
+  virtual const PlacementInfoPB& GetClusterReadReplicaPlacementInfo() const;
+
   // Get the blacklist information.
   virtual const BlacklistPB& GetServerBlacklist() const;
 
+  // Get the zones that leaders should be placed in from the cluster configuration.
+  virtual void GetAllAffinitizedZones(AffinitizedZonesSet* affinitized_zones) const;
+
   // Should skip load-balancing of this table?
   virtual bool SkipLoadBalancing(const TableInfo& table) const;
 
@@ -170,6 +176,11 @@ class ClusterLoadBalancer {
       scoped_refptr<TabletInfo> tablet, const TabletServerId& ts_uuid, const bool is_add,
       const bool should_remove_leader, const TabletServerId& new_leader_ts_uuid = "");
 
+  // Issue the call to CatalogManager to add a read replica of this tablet at ts_uuid, as a
+  // non-voting observer.
+  virtual void SendAddReadReplicaRequest(
+      scoped_refptr<TabletInfo> tablet, const TabletServerId& ts_uuid);
+
   //
   // Higher level methods and members.
   //
@@ -224,6 +235,19 @@ class ClusterLoadBalancer {
   // Returns true if a move was actually made.
   bool HandleRemoveIfWrongPlacement(TabletId* out_tablet_id, TabletServerId* out_from_ts);
 
+  // If a tablet has less than the minimum number of read replicas in a placement block of read
+  // replicas, we add an observer replica to a tablet server in that block.
+  //
+  // Returns true if a move was actually made.
+  bool HandleAddReadReplicas(TabletId* out_tablet_id, TabletServerId* out_to_ts);
+
+  // Processes any tablet leaders that are outside of the affinitized zones and need to be moved
+  // into them, before leaders are balanced within the zones.
+  //
+  // Returns true if we could find a leader to move and sets the three output parameters.
+  bool GetLeaderToMoveIfNonAffinitized(
+      TabletId* moving_tablet_id, TabletServerId* from_ts, TabletServerId* to_ts);
+
   // Processes any tablet leaders that are on a highly loaded tablet server and need to be moved.
   //
   // Returns true if a move was actually made.
@@ -237,8 +261,10 @@ class ClusterLoadBalancer {
   // Returns false otherwise.
   bool GetLoadToMove(TabletId* moving_tablet_id, TabletServerId* from_ts, TabletServerId* to_ts);
 
+  // Picks a tablet to move from from_ts to to_ts, whose load differs by load_variance.
   bool GetTabletToMove(
-      const TabletServerId& from_ts, const TabletServerId& to_ts, TabletId* moving_tablet_id);
+      const TabletServerId& from_ts, const TabletServerId& to_ts, double load_variance,
+      TabletId* moving_tablet_id);
 
   // Go through sorted_leader_load_ and figure out which leader to rebalance and from which TS
   // that is serving it to which other TS.
@@ -32,14 +32,27 @@ class ClusterLoadBalancerMocked : public ClusterLoadBalancer {
 
   const PlacementInfoPB& GetClusterPlacementInfo() const override { return cluster_placement_; }
 
+  const PlacementInfoPB& GetClusterReadReplicaPlacementInfo() const override {
+    return read_replica_placement_;
+  }
+
   const BlacklistPB& GetServerBlacklist() const override { return blacklist_; }
 
+  void GetAllAffinitizedZones(AffinitizedZonesSet* affinitized_zones) const override {
+    *affinitized_zones = affinitized_zones_;
+  }
+
   void SendReplicaChanges(scoped_refptr<TabletInfo> tablet, const TabletServerId& ts_uuid,
                           const bool is_add, const bool should_remove,
                           const TabletServerId& new_leader_uuid) override {
     // Do nothing.
   }
 
+  void SendAddReadReplicaRequest(scoped_refptr<TabletInfo> tablet,
+                                 const TabletServerId& ts_uuid) override {
+    // Do nothing.
+  }
+
   void GetPendingTasks(const TableId& table_uuid,
                        TabletToTabletServerMap* pending_add_replica_tasks,
                        TabletToTabletServerMap* pending_remove_replica_tasks,
@@ -60,6 +73,7 @@ class ClusterLoadBalancerMocked : public ClusterLoadBalancer {
   TabletInfoMap tablet_map_;
   TableInfoMap table_map_;
   PlacementInfoPB cluster_placement_;
+  PlacementInfoPB read_replica_placement_;
   BlacklistPB blacklist_;
   vector<TabletId> pending_add_replica_tasks_;
   vector<TabletId> pending_remove_replica_tasks_;
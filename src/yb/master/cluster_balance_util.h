@@ -36,6 +36,14 @@ DECLARE_int32(leader_balance_threshold);
 
 DECLARE_int32(leader_balance_unresponsive_timeout_ms);
 
+DECLARE_bool(load_balancer_weighted_load);
+
+DECLARE_double(load_balancer_sst_size_weight);
+
+DECLARE_double(load_balancer_ops_weight);
+
+DECLARE_double(load_balancer_max_cpu_utilization);
+
 namespace yb {
 namespace master {
 
@@ -98,12 +106,28 @@ struct CBTabletMetadata {
   // assigned to them and should be prioritized for removing load.
   std::set<TabletServerId> blacklisted_tablet_servers;
 
+  // Set of tablet server ids that host log-only replicas of this tablet. Such replicas could not
+  // take the leadership, and are not moved, since a replacement would be a full replica.
+  std::set<TabletServerId> log_only_tablet_servers;
+
+  // Set of tablet server ids that host read replicas (OBSERVER or PRE_OBSERVER peers) of this
+  // tablet. They are not counted as live replicas, and are balanced in the read replica placement.
+  std::set<TabletServerId> read_replica_tablet_servers;
+
   // The tablet server id of the leader in this tablet's peer group.
   TabletServerId leader_uuid;
 
   // Leader stepdown failures. We use this to prevent retrying the same leader stepdown too soon.
   LeaderStepDownFailureTimes leader_stepdown_failures;
 
+  // SST size and read plus write rate reported by the tablet leader.
+  int64_t sst_file_size = 0;
+  double ops_per_sec = 0;
+
+  // Contribution of a replica, and of the leader, of this tablet to the load of its tablet server,
+  // when weighted load is used. Weights are normalized, so the average tablet weighs 1.
+  double weight = 1.0;
+  double leader_weight = 1.0;
 };
 
 struct CBTabletServerMetadata {
@@ -129,8 +153,8 @@ class ClusterLoadState {
 
   // Comparators used for sorting by load.
   bool CompareByUuid(const TabletServerId& a, const TabletServerId& b) {
-    int load_a = GetLoad(a);
-    int load_b = GetLoad(b);
+    double load_a = GetLoad(a);
+    double load_b = GetLoad(b);
     if (load_a == load_b) {
       return a < b;
     } else {
@@ -167,18 +191,139 @@ class ClusterLoadState {
   };
 
   // Get the load for a certain TS.
-  int GetLoad(const TabletServerId& ts_uuid) const {
+  double GetLoad(const TabletServerId& ts_uuid) const {
     const auto& ts_meta = per_ts_meta_.at(ts_uuid);
-    return ts_meta.starting_tablets.size() + ts_meta.running_tablets.size();
+    if (!FLAGS_load_balancer_weighted_load) {
+      return ts_meta.starting_tablets.size() + ts_meta.running_tablets.size();
+    }
+    double load = 0;
+    for (const auto* tablets : {&ts_meta.starting_tablets, &ts_meta.running_tablets}) {
+      for (const auto& tablet_id : *tablets) {
+        load += GetTabletWeight(tablet_id);
+      }
+    }
+    return load;
   }
 
   // Get the load for a certain TS.
-  int GetLeaderLoad(const TabletServerId& ts_uuid) const {
-    return per_ts_meta_.at(ts_uuid).leaders.size();
+  double GetLeaderLoad(const TabletServerId& ts_uuid) const {
+    const auto& ts_meta = per_ts_meta_.at(ts_uuid);
+    if (!FLAGS_load_balancer_weighted_load) {
+      return ts_meta.leaders.size();
+    }
+    double load = 0;
+    for (const auto& tablet_id : ts_meta.leaders) {
+      load += GetTabletLeaderWeight(tablet_id);
+    }
+    return load;
+  }
+
+  double GetTabletWeight(const TabletId& tablet_id) const {
+    auto it = per_tablet_meta_.find(tablet_id);
+    return it != per_tablet_meta_.end() ? it->second.weight : 1.0;
+  }
+
+  double GetTabletLeaderWeight(const TabletId& tablet_id) const {
+    auto it = per_tablet_meta_.find(tablet_id);
+    return it != per_tablet_meta_.end() ? it->second.leader_weight : 1.0;
+  }
+
+  // Whether the TS is too busy to take more load in weighted load mode.
+  bool IsOverloaded(const TabletServerId& ts_uuid) const {
+    return FLAGS_load_balancer_weighted_load && FLAGS_load_balancer_max_cpu_utilization > 0 &&
+           per_ts_meta_.at(ts_uuid).descriptor->cpu_utilization() >
+               FLAGS_load_balancer_max_cpu_utilization;
+  }
+
+  // Computes tablet weights from the reported tablet metrics, relative to the average tablet.
+  void ComputeTabletWeights() {
+    if (!FLAGS_load_balancer_weighted_load || per_tablet_meta_.empty()) {
+      return;
+    }
+    double total_sst_file_size = 0;
+    double total_ops_per_sec = 0;
+    for (const auto& entry : per_tablet_meta_) {
+      total_sst_file_size += entry.second.sst_file_size;
+      total_ops_per_sec += entry.second.ops_per_sec;
+    }
+    const double avg_sst_file_size = total_sst_file_size / per_tablet_meta_.size();
+    const double avg_ops_per_sec = total_ops_per_sec / per_tablet_meta_.size();
+    const double sst_size_weight = avg_sst_file_size > 0 ? FLAGS_load_balancer_sst_size_weight : 0;
+    const double ops_weight = avg_ops_per_sec > 0 ? FLAGS_load_balancer_ops_weight : 0;
+    for (auto& entry : per_tablet_meta_) {
+      auto& tablet_meta = entry.second;
+      const double relative_sst_file_size =
+          sst_size_weight > 0 ? tablet_meta.sst_file_size / avg_sst_file_size : 0;
+      const double relative_ops = ops_weight > 0 ? tablet_meta.ops_per_sec / avg_ops_per_sec : 0;
+      // Leaders serve all reads and writes, so only the request rate matters for them.
+      tablet_meta.weight = (1 + sst_size_weight * relative_sst_file_size +
+                            ops_weight * relative_ops) / (1 + sst_size_weight + ops_weight);
+      tablet_meta.leader_weight = (1 + ops_weight * relative_ops) / (1 + ops_weight);
+    }
   }
 
   void SetBlacklist(const BlacklistPB& blacklist) { blacklist_ = blacklist; }
 
+  void SetReadReplicaPlacement(const PlacementInfoPB& placement) {
+    read_replica_placement_ = placement;
+  }
+
+  // Whether the TS is in one of the placement blocks of read replicas. Such servers only host read
+  // replicas, so they do not take live replicas or leaders.
+  bool IsInReadReplicaPlacement(const TSDescriptor& ts_desc) const {
+    for (const auto& pb : read_replica_placement_.placement_blocks()) {
+      if (ts_desc.MatchesCloudInfo(pb.cloud_info())) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Finds the least loaded server that should get a new read replica of the tablet, to reach the
+  // minimum number of read replicas in one of the read replica placement blocks.
+  bool GetMissingReadReplica(const TabletId& tablet_id, TabletServerId* out_to_ts) {
+    const auto& tablet_meta = per_tablet_meta_[tablet_id];
+    for (const auto& pb : read_replica_placement_.placement_blocks()) {
+      int num_replicas = 0;
+      for (const auto& ts_uuid : tablet_meta.read_replica_tablet_servers) {
+        if (per_ts_meta_[ts_uuid].descriptor->MatchesCloudInfo(pb.cloud_info())) {
+          ++num_replicas;
+        }
+      }
+      if (num_replicas >= pb.min_num_replicas()) {
+        continue;
+      }
+      out_to_ts->clear();
+      for (const auto& ts_uuid : read_replica_servers_) {
+        if (per_ts_meta_[ts_uuid].descriptor->MatchesCloudInfo(pb.cloud_info()) &&
+            CanAddTabletToTabletServer(tablet_id, ts_uuid) &&
+            (out_to_ts->empty() || GetLoad(ts_uuid) < GetLoad(*out_to_ts))) {
+          *out_to_ts = ts_uuid;
+        }
+      }
+      if (!out_to_ts->empty()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void SetAffinitizedZones(const AffinitizedZonesSet& zones) { affinitized_zones_ = zones; }
+
+  // Whether leaders should be placed on the TS, i.e. there are no affinitized zones or the TS is
+  // in one of them.
+  bool IsInAffinitizedZone(const TSDescriptor& ts_desc) const {
+    if (affinitized_zones_.empty()) {
+      return true;
+    }
+    for (const auto& zone : affinitized_zones_) {
+      if (ts_desc.MatchesCloudInfo(zone)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
   // Update the per-tablet information for this tablet.
   bool UpdateTablet(TabletInfo* tablet) {
     const auto& tablet_id = tablet->id();
@@ -188,6 +333,25 @@ class ClusterLoadState {
     // Get the placement for this tablet.
     const auto& placement = placement_by_table_[tablet->table()->id()];
 
+    if (FLAGS_load_balancer_weighted_load) {
+      const auto metrics = tablet->leader_metrics();
+      tablet_meta.sst_file_size = metrics.sst_file_size();
+      tablet_meta.ops_per_sec = metrics.read_ops_per_sec() + metrics.write_ops_per_sec();
+    }
+
+    {
+      auto l = tablet->LockForRead();
+      for (const auto& peer : l->data().pb.committed_consensus_state().config().peers()) {
+        if (peer.log_only()) {
+          tablet_meta.log_only_tablet_servers.insert(peer.permanent_uuid());
+        }
+        if (peer.member_type() == consensus::RaftPeerPB::OBSERVER ||
+            peer.member_type() == consensus::RaftPeerPB::PRE_OBSERVER) {
+          tablet_meta.read_replica_tablet_servers.insert(peer.permanent_uuid());
+        }
+      }
+    }
+
     // Get replicas for this tablet.
     TabletInfo::ReplicaMap replica_map;
     tablet->GetReplicaLocations(&replica_map);
@@ -215,6 +379,16 @@ class ClusterLoadState {
       }
 
       const tablet::TabletStatePB& tablet_state = replica.second.state;
+      // Read replicas only take load of their server, so no more replicas are added to it.
+      if (tablet_meta.read_replica_tablet_servers.count(ts_uuid)) {
+        if (tablet_state == tablet::RUNNING) {
+          ts_meta_it->second.running_tablets.insert(tablet_id);
+        } else if (tablet_state == tablet::BOOTSTRAPPING || tablet_state == tablet::NOT_STARTED) {
+          ts_meta_it->second.starting_tablets.insert(tablet_id);
+        }
+        continue;
+      }
+
       if (tablet_state == tablet::RUNNING) {
         ts_meta_it->second.running_tablets.insert(tablet_id);
         ++tablet_meta.running;
@@ -233,6 +407,11 @@ class ClusterLoadState {
       }
     }
 
+    // Replication of the live placement is computed without read replicas.
+    for (const auto& ts_uuid : tablet_meta.read_replica_tablet_servers) {
+      replica_map.erase(ts_uuid);
+    }
+
     // Only set the over-replication section if we need to.
     tablet_meta.is_over_replicated = placement.num_replicas() < replica_map.size();
     tablet_meta.is_under_replicated = placement.num_replicas() > replica_map.size();
@@ -315,7 +494,12 @@ class ClusterLoadState {
     auto& ts_meta = per_ts_meta_[ts_uuid];
     ts_meta.descriptor = ts_desc;
 
-    sorted_load_.push_back(ts_uuid);
+    const bool is_read_replica_server = IsInReadReplicaPlacement(*ts_desc);
+    if (is_read_replica_server) {
+      read_replica_servers_.push_back(ts_uuid);
+    } else {
+      sorted_load_.push_back(ts_uuid);
+    }
 
     // Mark as blacklisted if it matches.
     bool is_blacklisted = false;
@@ -329,10 +513,14 @@ class ClusterLoadState {
 
     // Add this tablet server for leader load-balancing only if it is not blacklisted and it has
     // heartbeated recently enough to be considered responsive for leader balancing.
-    if (!is_blacklisted &&
+    if (!is_blacklisted && !is_read_replica_server &&
         ts_desc->TimeSinceHeartbeat().ToMilliseconds() <
         FLAGS_leader_balance_unresponsive_timeout_ms) {
-      sorted_leader_load_.push_back(ts_uuid);
+      if (IsInAffinitizedZone(*ts_desc)) {
+        sorted_leader_load_.push_back(ts_uuid);
+      } else {
+        sorted_non_affinitized_leader_load_.push_back(ts_uuid);
+      }
     }
 
     if (ts_desc->HasTabletDeletePending()) {
@@ -460,6 +648,12 @@ class ClusterLoadState {
     SortLoad();
   }
 
+  void AddReadReplica(const TabletId& tablet_id, const TabletServerId& to_ts) {
+    per_ts_meta_[to_ts].starting_tablets.insert(tablet_id);
+    per_tablet_meta_[tablet_id].read_replica_tablet_servers.insert(to_ts);
+    tablets_added_.insert(tablet_id);
+  }
+
   void RemoveReplica(const TabletId& tablet_id, const TabletServerId& from_ts) {
     if (per_ts_meta_[from_ts].running_tablets.count(tablet_id)) {
       per_ts_meta_[from_ts].running_tablets.erase(tablet_id);
@@ -504,11 +698,42 @@ class ClusterLoadState {
   virtual void SortLeaderLoad() {
     auto leader_count_comparator = LeaderLoadComparator(this);
     sort(sorted_leader_load_.begin(), sorted_leader_load_.end(), leader_count_comparator);
+    sort(sorted_non_affinitized_leader_load_.begin(), sorted_non_affinitized_leader_load_.end(),
+         leader_count_comparator);
+  }
+
+  // Balances leaders across all servers when none of the servers in affinitized zones could take
+  // leaders, e.g. all of them are down, instead of leaving leaders where they are.
+  void FallBackIfNoAffinitizedServers() {
+    if (sorted_leader_load_.empty() && !sorted_non_affinitized_leader_load_.empty()) {
+      LOG(WARNING) << "No responsive tablet servers in affinitized leader zones, balancing leaders "
+                   << "across all tablet servers";
+      sorted_leader_load_.swap(sorted_non_affinitized_leader_load_);
+    }
+  }
+
+  // Picks the least leader loaded server in affinitized zones, that runs a replica of the tablet,
+  // to take over the leadership from from_ts. Returns empty id if there is none, or if no zones are
+  // affinitized, so a random follower is picked as before.
+  TabletServerId GetAffinitizedLeaderCandidate(
+      const TabletId& tablet_id, const TabletServerId& from_ts) const {
+    if (affinitized_zones_.empty()) {
+      return TabletServerId();
+    }
+    const auto& tablet_meta = per_tablet_meta_.at(tablet_id);
+    for (const auto& ts_uuid : sorted_leader_load_) {
+      if (ts_uuid != from_ts && per_ts_meta_.at(ts_uuid).running_tablets.count(tablet_id) &&
+          !tablet_meta.log_only_tablet_servers.count(ts_uuid)) {
+        return ts_uuid;
+      }
+    }
+    return TabletServerId();
   }
 
   inline bool IsLeaderLoadBelowThreshold(const TabletServerId& ts_uuid) {
+    // The threshold is a number of leaders, so it is checked against count even with weights.
     return ((leader_balance_threshold_ > 0) &&
-            (GetLeaderLoad(ts_uuid) <= leader_balance_threshold_));
+            (static_cast<int>(per_ts_meta_.at(ts_uuid).leaders.size()) <= leader_balance_threshold_));
   }
 
   void AdjustLeaderBalanceThreshold() {
@@ -582,6 +807,17 @@ class ClusterLoadState {
   // If affinitized leaders is enabled, stores leader load for affinitized nodes.
   vector<TabletServerId> sorted_leader_load_;
 
+  // Zones that leaders of the table should be placed in, empty if leaders could be anywhere.
+  AffinitizedZonesSet affinitized_zones_;
+
+  // List of responsive tablet server ids outside of affinitized zones, sorted by their leader load.
+  // Leaders are moved from them to the servers of sorted_leader_load_.
+  vector<TabletServerId> sorted_non_affinitized_leader_load_;
+
+  // Placement of read replicas of the table, and the tablet servers in it.
+  PlacementInfoPB read_replica_placement_;
+  vector<TabletServerId> read_replica_servers_;
+
   unordered_map<TableId, TabletToTabletServerMap> pending_add_replica_tasks_;
   unordered_map<TableId, TabletToTabletServerMap> pending_remove_replica_tasks_;
   unordered_map<TableId, TabletToTabletServerMap> pending_stepdown_leader_tasks_;
@@ -40,6 +40,7 @@
 #include "yb/common/partition.h"
 #include "yb/common/schema.h"
 #include "yb/consensus/consensus.pb.h"
+#include "yb/docdb/doc_key.h"
 #include "yb/gutil/map-util.h"
 #include "yb/gutil/stringprintf.h"
 #include "yb/gutil/strings/join.h"
@@ -350,7 +351,7 @@ void MasterPathHandlers::HandleTablePage(const Webserver::WebRequest& req,
 
   *output << "<table class='table table-striped'>\n";
   *output << "  <tr><th>Tablet ID</th><th>Partition</th><th>State</th>"
-      "<th>Message</th><th>RaftConfig</th></tr>\n";
+      "<th>Message</th><th>RaftConfig</th><th>Hottest key</th></tr>\n";
   for (const scoped_refptr<TabletInfo>& tablet : tablets) {
     TabletInfo::ReplicaMap locations;
     tablet->GetReplicaLocations(&locations);
@@ -365,13 +366,21 @@ void MasterPathHandlers::HandleTablePage(const Webserver::WebRequest& req,
 
     string state = SysTabletsEntryPB_State_Name(l->data().pb.state());
     Capitalize(&state);
+    const auto metrics = tablet->leader_metrics();
+    string hottest_key;
+    if (metrics.has_hottest_key()) {
+      hottest_key = Substitute(
+          "$0 ($1%)", docdb::BestEffortDocDBKeyToStr(Slice(metrics.hottest_key())),
+          StringPrintf("%.1f", metrics.hottest_key_share() * 100));
+    }
     *output << Substitute(
-        "<tr><th>$0</th><td>$1</td><td>$2</td><td>$3</td><td>$4</td></tr>\n",
+        "<tr><th>$0</th><td>$1</td><td>$2</td><td>$3</td><td>$4</td><td>$5</td></tr>\n",
         tablet->tablet_id(),
         EscapeForHtmlToString(partition_schema.PartitionDebugString(partition, schema)),
         state,
         EscapeForHtmlToString(l->data().pb.state_msg()),
-        RaftConfigToHtml(sorted_locations, tablet->tablet_id()));
+        RaftConfigToHtml(sorted_locations, tablet->tablet_id()),
+        EscapeForHtmlToString(hottest_key));
   }
   *output << "</table>\n";
 
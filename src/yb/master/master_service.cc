@@ -123,6 +123,7 @@ void MasterServiceImpl::TSHeartbeat(const TSHeartbeatRequestPB* req,
       rpc.RespondFailure(s);
       return;
     }
+    server_->catalog_manager()->InvalidateTabletLocations(ts_desc->permanent_uuid());
     SysClusterConfigEntryPB cluster_config;
     s = server_->catalog_manager()->GetClusterConfig(&cluster_config);
     if (!s.ok()) {
@@ -166,6 +167,8 @@ void MasterServiceImpl::TSHeartbeat(const TSHeartbeatRequestPB* req,
     ts_desc->set_total_sst_file_size(req->metrics().total_sst_file_size());
     ts_desc->set_write_ops_per_sec(req->metrics().write_ops_per_sec());
     ts_desc->set_read_ops_per_sec(req->metrics().read_ops_per_sec());
+    ts_desc->set_cpu_utilization(req->metrics().cpu_utilization());
+    server_->catalog_manager()->ProcessTabletMetrics(req->metrics());
   }
 
   if (req->has_tablet_report()) {
@@ -517,6 +520,12 @@ void MasterServiceImpl::GetLoadMoveCompletion(
   HandleIn(req, resp, &rpc, &CatalogManager::GetLoadMoveCompletionPercent);
 }
 
+void MasterServiceImpl::DrainLeaders(
+    const DrainLeadersRequestPB* req, DrainLeadersResponsePB* resp,
+    RpcContext rpc) {
+  HandleIn(req, resp, &rpc, &CatalogManager::DrainLeaders);
+}
+
 void MasterServiceImpl::IsMasterLeaderServiceReady(
     const IsMasterLeaderReadyRequestPB* req, IsMasterLeaderReadyResponsePB* resp,
     RpcContext rpc) {
@@ -171,6 +171,10 @@ class MasterServiceImpl : public MasterServiceIf,
       const IsMasterLeaderReadyRequestPB* req, IsMasterLeaderReadyResponsePB* resp,
       rpc::RpcContext rpc) override;
 
+  virtual void DrainLeaders(
+      const DrainLeadersRequestPB* req, DrainLeadersResponsePB* resp,
+      rpc::RpcContext rpc) override;
+
   virtual void IsLoadBalanced(
       const IsLoadBalancedRequestPB* req, IsLoadBalancedResponsePB* resp,
       rpc::RpcContext rpc) override;
@@ -14,6 +14,10 @@
 #ifndef YB_MASTER_SYS_CATALOG_INTERNAL_H_
 #define YB_MASTER_SYS_CATALOG_INTERNAL_H_
 
+#include <functional>
+#include <string>
+#include <vector>
+
 #include "yb/gutil/strings/substitute.h"
 #include "yb/master/catalog_manager.h"
 #include "yb/tserver/tserver.pb.h"
@@ -23,6 +27,17 @@
 namespace yb {
 namespace master {
 
+// Id and encoded metadata of a sys catalog entry.
+struct SysCatalogEntry {
+  std::string id;
+  std::string data;
+};
+
+// Calls 'decode' for ranges of entries in [0, count), on 'pool' when it is specified and there are
+// enough entries. Returns the first failure.
+CHECKED_STATUS DecodeInParallel(
+    size_t count, ThreadPool* pool, const std::function<Status(size_t, size_t)>& decode);
+
 class VisitorBase {
  public:
   VisitorBase() {}
@@ -32,6 +47,15 @@ class VisitorBase {
 
   virtual CHECKED_STATUS Visit(Slice id, Slice data) = 0;
 
+  // Visits the entries in order. Their metadata could be decoded on 'pool' in parallel, but they
+  // are visited on the calling thread.
+  virtual CHECKED_STATUS VisitBatch(const std::vector<SysCatalogEntry>& entries, ThreadPool* pool) {
+    for (const auto& entry : entries) {
+      RETURN_NOT_OK(Visit(entry.id, entry.data));
+    }
+    return Status::OK();
+  }
+
  protected:
 };
 
@@ -50,6 +74,26 @@ class Visitor : public VisitorBase {
     return Visit(id.ToBuffer(), metadata);
   }
 
+  CHECKED_STATUS VisitBatch(
+      const std::vector<SysCatalogEntry>& entries, ThreadPool* pool) override {
+    std::vector<typename PersistentDataEntryClass::data_type> metadata(entries.size());
+    RETURN_NOT_OK(DecodeInParallel(
+        entries.size(), pool, [&entries, &metadata](size_t begin, size_t end) -> Status {
+      for (auto i = begin; i != end; ++i) {
+        const Slice data(entries[i].data);
+        RETURN_NOT_OK_PREPEND(
+            pb_util::ParseFromArray(&metadata[i], data.data(), data.size()),
+            "Unable to parse metadata field for item id: " + entries[i].id);
+      }
+      return Status::OK();
+    }));
+
+    for (size_t i = 0; i != entries.size(); ++i) {
+      RETURN_NOT_OK(Visit(entries[i].id, metadata[i]));
+    }
+    return Status::OK();
+  }
+
   int entry_type() const { return PersistentDataEntryClass::type(); }
 
  protected:
@@ -405,6 +405,70 @@ TEST_F(SysCatalogTest, TestSysCatalogTabletsOperations) {
   }
 }
 
+// Tablet loader that checks that tables of tablets were loaded before them.
+class TestOrderedTabletLoader : public TestTabletLoader {
+ public:
+  explicit TestOrderedTabletLoader(const TestTableLoader* table_loader)
+      : table_loader_(table_loader) {}
+
+  Status Visit(const std::string& tablet_id, const SysTabletsEntryPB& metadata) override {
+    if (!ContainsKey(table_loader_->tables, metadata.table_id())) {
+      return STATUS_FORMAT(IllegalState, "Tablet $0 visited before its table", tablet_id);
+    }
+    return TestTabletLoader::Visit(tablet_id, metadata);
+  }
+
+ private:
+  const TestTableLoader* table_loader_;
+};
+
+// Test that entries of multiple types are visited in one scan, with enough entries for their
+// metadata to be decoded in parallel.
+TEST_F(SysCatalogTest, TestVisitMultipleTypes) {
+  SysCatalogTable* sys_catalog = master_->catalog_manager()->sys_catalog();
+
+  scoped_refptr<TableInfo> table(new TableInfo("abc"));
+  {
+    auto l = table->LockForWrite();
+    l->mutable_data()->pb.set_name("testtb");
+    l->mutable_data()->pb.set_version(0);
+    l->mutable_data()->pb.mutable_replication_info()->mutable_live_replicas()->set_num_replicas(1);
+    l->mutable_data()->pb.set_state(SysTablesEntryPB::RUNNING);
+    ASSERT_OK(SchemaToPB(Schema(), l->mutable_data()->pb.mutable_schema()));
+    ASSERT_OK(sys_catalog->AddItem(table.get()));
+    l->Commit();
+  }
+
+  const int kNumTablets = 1000;
+  std::vector<scoped_refptr<TabletInfo>> tablets;
+  std::vector<TabletInfo*> tablet_ptrs;
+  for (int i = 0; i != kNumTablets; ++i) {
+    tablets.emplace_back(CreateTablet(
+        table.get(), Format("tablet-$0", i), Format("$0", i), Format("$0", i + 1)));
+    tablet_ptrs.push_back(tablets.back().get());
+  }
+  {
+    std::vector<std::unique_ptr<TabletInfo::lock_type>> locks;
+    for (const auto& tablet : tablets) {
+      locks.push_back(tablet->LockForWrite());
+    }
+    ASSERT_OK(sys_catalog->AddItems(tablet_ptrs));
+    for (auto& lock : locks) {
+      lock->Commit();
+    }
+  }
+
+  TestTableLoader table_loader;
+  TestOrderedTabletLoader tablet_loader(&table_loader);
+  // Visitors are passed in the reverse order of their entry types.
+  ASSERT_OK(sys_catalog->Visit({&tablet_loader, &table_loader}));
+  ASSERT_EQ(1 + master_->NumSystemTables(), table_loader.tables.size());
+  ASSERT_EQ(kNumTablets + master_->NumSystemTables(), tablet_loader.tablets.size());
+  for (const auto& tablet : tablets) {
+    ASSERT_TRUE(MetadatasEqual(tablet.get(), tablet_loader.tablets[tablet->id()]));
+  }
+}
+
 // Verify that data mutations are not available from metadata() until commit.
 TEST_F(SysCatalogTest, TestTabletInfoCommit) {
   scoped_refptr<TabletInfo> tablet(new TabletInfo(nullptr, "123"));
@@ -64,6 +64,7 @@
 
 #include "yb/tserver/ts_tablet_manager.h"
 
+#include "yb/util/countdown_latch.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
 #include "yb/util/size_literals.h"
@@ -101,6 +102,11 @@ DEFINE_int32(master_discovery_timeout_ms, 3600000,
              "Timeout for masters to discover each other during cluster creation/startup");
 TAG_FLAG(master_discovery_timeout_ms, hidden);
 
+DEFINE_int32(sys_catalog_load_threads, 4,
+             "Number of threads decoding sys catalog entries, e.g. when the catalog is loaded by "
+             "a new master leader. 0 to decode them on the loading thread.");
+TAG_FLAG(sys_catalog_load_threads, advanced);
+
 
 namespace yb {
 namespace master {
@@ -119,6 +125,11 @@ SysCatalogTable::SysCatalogTable(Master* master, MetricRegistry* metrics,
   CHECK_OK(ThreadPoolBuilder("apply").Build(&apply_pool_));
   CHECK_OK(ThreadPoolBuilder("raft").Build(&raft_pool_));
   CHECK_OK(ThreadPoolBuilder("prepare").set_min_threads(1).Build(&tablet_prepare_pool_));
+  if (FLAGS_sys_catalog_load_threads > 0) {
+    CHECK_OK(ThreadPoolBuilder("catalog-load")
+                 .set_max_threads(FLAGS_sys_catalog_load_threads)
+                 .Build(&load_pool_));
+  }
 }
 
 SysCatalogTable::~SysCatalogTable() {
@@ -131,6 +142,9 @@ void SysCatalogTable::Shutdown() {
   apply_pool_->Shutdown();
   raft_pool_->Shutdown();
   tablet_prepare_pool_->Shutdown();
+  if (load_pool_) {
+    load_pool_->Shutdown();
+  }
 }
 
 Status SysCatalogTable::ConvertConfigToMasterAddresses(
@@ -588,10 +602,54 @@ void SysCatalogTable::InitLocalRaftPeerPB() {
   CHECK_OK(HostPortToPB(hp, local_peer_pb_.mutable_last_known_addr()));
 }
 
+Status DecodeInParallel(
+    size_t count, ThreadPool* pool, const std::function<Status(size_t, size_t)>& decode) {
+  const size_t kEntriesPerTask = 256;
+  if (pool == nullptr || count <= kEntriesPerTask) {
+    return decode(0, count);
+  }
+
+  const size_t num_tasks = (count + kEntriesPerTask - 1) / kEntriesPerTask;
+  std::vector<Status> statuses(num_tasks);
+  CountDownLatch latch(num_tasks);
+  for (size_t task = 0; task != num_tasks; ++task) {
+    const size_t begin = task * kEntriesPerTask;
+    const size_t end = std::min(count, begin + kEntriesPerTask);
+    auto decode_range = [&decode, &statuses, &latch, task, begin, end] {
+      statuses[task] = decode(begin, end);
+      latch.CountDown();
+    };
+    if (!pool->SubmitFunc(decode_range).ok()) {
+      decode_range();
+    }
+  }
+  latch.Wait();
+
+  for (const auto& status : statuses) {
+    RETURN_NOT_OK(status);
+  }
+  return Status::OK();
+}
+
 Status SysCatalogTable::Visit(VisitorBase* visitor) {
+  return Visit(std::vector<VisitorBase*>{visitor});
+}
+
+Status SysCatalogTable::Visit(const std::vector<VisitorBase*>& visitors) {
   TRACE_EVENT0("master", "Visitor::VisitAll");
 
-  const int8_t tables_entry = visitor->entry_type();
+  // Large enough for decoding to be worth parallelizing, bounds the memory of encoded entries.
+  const size_t kMaxBatchSize = 4096;
+
+  std::unordered_map<int, VisitorBase*> visitor_by_type;
+  for (auto* visitor : visitors) {
+    auto inserted = visitor_by_type.emplace(visitor->entry_type(), visitor).second;
+    if (!inserted) {
+      return STATUS_FORMAT(
+          InvalidArgument, "Multiple visitors of sys catalog entry type $0", visitor->entry_type());
+    }
+  }
+
   const int type_col_idx = schema_.find_column(kSysCatalogTableColType);
   const int entry_id_col_idx = schema_.find_column(kSysCatalogTableColId);
   const int metadata_col_idx = schema_.find_column(kSysCatalogTableColMetadata);
@@ -600,20 +658,36 @@ Status SysCatalogTable::Visit(VisitorBase* visitor) {
   auto iter = tablet_peer_->tablet()->NewRowIterator(schema_, boost::none);
   RETURN_NOT_OK(iter);
 
-  Arena arena(32_KB, 256_KB);
+  // Entries are sorted by type, so a batch is visited when all entries of its type were read.
+  std::vector<SysCatalogEntry> batch;
+  VisitorBase* batch_visitor = nullptr;
+  auto visit_batch = [this, &batch, &batch_visitor]() -> Status {
+    if (batch.empty()) {
+      return Status::OK();
+    }
+    RETURN_NOT_OK(batch_visitor->VisitBatch(batch, load_pool_.get()));
+    batch.clear();
+    return Status::OK();
+  };
+
   QLTableRow value_map;
   QLValue entry_type, entry_id, metadata;
   while ((**iter).HasNext()) {
     RETURN_NOT_OK((**iter).NextRow(&value_map));
     RETURN_NOT_OK(value_map.GetValue(schema_with_ids_.column_id(type_col_idx), &entry_type));
-    if (entry_type.int8_value() != tables_entry) {
+    auto it = visitor_by_type.find(entry_type.int8_value());
+    if (it == visitor_by_type.end()) {
       continue;
     }
+    if (it->second != batch_visitor || batch.size() >= kMaxBatchSize) {
+      RETURN_NOT_OK(visit_batch());
+      batch_visitor = it->second;
+    }
     RETURN_NOT_OK(value_map.GetValue(schema_with_ids_.column_id(entry_id_col_idx), &entry_id));
     RETURN_NOT_OK(value_map.GetValue(schema_with_ids_.column_id(metadata_col_idx), &metadata));
-    RETURN_NOT_OK(visitor->Visit(entry_id.binary_value(), metadata.binary_value()));
+    batch.push_back(SysCatalogEntry{entry_id.binary_value(), metadata.binary_value()});
   }
-  return Status::OK();
+  return visit_batch();
 }
 
 } // namespace master
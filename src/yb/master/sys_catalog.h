@@ -157,6 +157,11 @@ class SysCatalogTable {
 
   CHECKED_STATUS Visit(VisitorBase* visitor);
 
+  // Visits entries of all visitors in one scan of the sys catalog. Entries are visited in the order
+  // of their keys, so all entries of a type are visited before entries of types with greater
+  // values. Metadata of entries is decoded in parallel on load_pool_.
+  CHECKED_STATUS Visit(const std::vector<VisitorBase*>& visitors);
+
  private:
   friend class CatalogManager;
 
@@ -222,6 +227,9 @@ class SysCatalogTable {
   // Thread pool for preparing transactions, shared between all tablets.
   gscoped_ptr<ThreadPool> tablet_prepare_pool_;
 
+  // Thread pool for decoding entries loaded by visitors.
+  gscoped_ptr<ThreadPool> load_pool_;
+
   scoped_refptr<tablet::TabletPeer> tablet_peer_;
 
   Master* master_;
@@ -60,6 +60,13 @@ CHECKED_STATUS SystemTablet::HandleRedisReadRequest(
   return STATUS(NotSupported, "RedisReadRequest is not supported for system tablets!");
 }
 
+CHECKED_STATUS SystemTablet::HandleRedisReadRequests(
+    const ReadHybridTime& read_time,
+    const google::protobuf::RepeatedPtrField<RedisReadRequestPB>& redis_read_requests,
+    google::protobuf::RepeatedPtrField<RedisResponsePB>* responses) {
+  return STATUS(NotSupported, "RedisReadRequest is not supported for system tablets!");
+}
+
 CHECKED_STATUS SystemTablet::HandleQLReadRequest(
     const ReadHybridTime& read_time, const QLReadRequestPB& ql_read_request,
     const TransactionMetadataPB& transaction_metadata, tablet::QLReadRequestResult* result) {
@@ -45,6 +45,11 @@ class SystemTablet : public tablet::AbstractTablet {
       const RedisReadRequestPB& redis_read_request,
       RedisResponsePB* response) override;
 
+  CHECKED_STATUS HandleRedisReadRequests(
+      const ReadHybridTime& read_time,
+      const google::protobuf::RepeatedPtrField<RedisReadRequestPB>& redis_read_requests,
+      google::protobuf::RepeatedPtrField<RedisResponsePB>* responses) override;
+
   CHECKED_STATUS HandleQLReadRequest(
       const ReadHybridTime& read_time,
       const QLReadRequestPB& ql_read_request,
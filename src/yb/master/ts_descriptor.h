@@ -187,6 +187,16 @@ class TSDescriptor {
     return tsMetrics_.write_ops_per_sec;
   }
 
+  void set_cpu_utilization(double cpu_utilization) {
+    std::lock_guard<simple_spinlock> l(lock_);
+    tsMetrics_.cpu_utilization = cpu_utilization;
+  }
+
+  double cpu_utilization() {
+    std::lock_guard<simple_spinlock> l(lock_);
+    return tsMetrics_.cpu_utilization;
+  }
+
   void ClearMetrics() {
     tsMetrics_.ClearMetrics();
   }
@@ -239,11 +249,15 @@ class TSDescriptor {
 
     double write_ops_per_sec = 0;
 
+    // Fraction of all CPUs used by the tserver process.
+    double cpu_utilization = 0;
+
     void ClearMetrics() {
       total_memory_usage = 0;
       total_sst_file_size = 0;
       read_ops_per_sec = 0;
       write_ops_per_sec = 0;
+      cpu_utilization = 0;
     }
   };
 
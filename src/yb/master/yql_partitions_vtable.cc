@@ -25,11 +25,40 @@ YQLPartitionsVTable::YQLPartitionsVTable(const Master* const master)
 
 Status YQLPartitionsVTable::RetrieveData(const QLReadRequestPB& request,
                                          std::unique_ptr<QLRowBlock>* vtable) const {
-  vtable->reset(new QLRowBlock(schema_));
+  // Read the version before the tables, so concurrent changes are picked up by the next read.
+  const uint64_t locations_version = TabletInfo::CurrentLocationsVersion();
   std::vector<scoped_refptr<TableInfo> > tables;
+  master_->catalog_manager()->GetAllTables(&tables, true /* includeOnlyRunningTables */);
+  TableList table_list;
+  table_list.reserve(tables.size());
+  for (const scoped_refptr<TableInfo>& table : tables) {
+    table_list.emplace_back(table->id(), table->name());
+  }
+
+  vtable->reset(new QLRowBlock(schema_));
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!cached_rows_ || cached_locations_version_ != locations_version ||
+      cached_tables_ != table_list) {
+    auto rows = std::make_shared<QLRowBlock>(schema_);
+    RETURN_NOT_OK(BuildRows(tables, rows.get()));
+    cached_rows_ = std::move(rows);
+    cached_locations_version_ = locations_version;
+    cached_tables_ = std::move(table_list);
+  }
+  (*vtable)->rows() = cached_rows_->rows();
+  return Status::OK();
+}
+
+Status YQLPartitionsVTable::BuildRows(const std::vector<scoped_refptr<TableInfo>>& tables,
+                                      QLRowBlock* vtable) const {
   CatalogManager* catalog_manager = master_->catalog_manager();
-  catalog_manager->GetAllTables(&tables, true /* includeOnlyRunningTables */);
+  std::unordered_map<TableId, std::unique_ptr<TableRows>> table_rows;
   for (const scoped_refptr<TableInfo>& table : tables) {
+    auto it = cached_table_rows_.find(table->id());
+    if (it != cached_table_rows_.end() && it->second && TableRowsValid(*table, *it->second)) {
+      table_rows.emplace(table->id(), std::move(it->second));
+      continue;
+    }
 
     // Get namespace for table.
     NamespaceIdentifierPB nsId;
@@ -37,54 +66,95 @@ Status YQLPartitionsVTable::RetrieveData(const QLReadRequestPB& request,
     scoped_refptr<NamespaceInfo> nsInfo;
     RETURN_NOT_OK(catalog_manager->FindNamespace(nsId, &nsInfo));
 
+    auto rows = std::make_unique<TableRows>();
     // Hide redis table from YQL.
-    if (nsInfo->name() == common::kRedisKeyspaceName && table->name() == common::kRedisTableName) {
-      continue;
+    if (nsInfo->name() != common::kRedisKeyspaceName || table->name() != common::kRedisTableName) {
+      RETURN_NOT_OK(BuildTableRows(*table, nsInfo->name(), rows.get()));
+    } else {
+      rows->table_name = table->name();
+      rows->rows.reset(new QLRowBlock(schema_));
     }
+    table_rows.emplace(table->id(), std::move(rows));
+  }
+
+  for (const scoped_refptr<TableInfo>& table : tables) {
+    const auto& rows = table_rows[table->id()]->rows->rows();
+    vtable->rows().insert(vtable->rows().end(), rows.begin(), rows.end());
+  }
+  // Rows of tables that are gone are dropped here.
+  cached_table_rows_ = std::move(table_rows);
+  return Status::OK();
+}
 
-    // Get tablets for table.
-    std::vector<scoped_refptr<TabletInfo> > tablets;
-    table->GetAllTablets(&tablets);
-    for (const scoped_refptr<TabletInfo>& tablet : tablets) {
-      TabletLocationsPB tabletLocationsPB;
-      Status s = catalog_manager->GetTabletLocations(tablet->id(), &tabletLocationsPB);
-      // Skip not-found tablets: they might not be running yet or have been deleted.
-      if (!s.ok()) {
-        continue;
-      }
-
-      QLRow& row = (*vtable)->Extend();
-      RETURN_NOT_OK(SetColumnValue(kKeyspaceName, nsInfo->name(), &row));
-      RETURN_NOT_OK(SetColumnValue(kTableName, table->name(), &row));
-
-      const PartitionPB& partition = tabletLocationsPB.partition();
-      RETURN_NOT_OK(SetColumnValue(kStartKey, partition.partition_key_start(), &row));
-      RETURN_NOT_OK(SetColumnValue(kEndKey, partition.partition_key_end(), &row));
-
-      // Note: tablet id is in host byte order.
-      Uuid uuid;
-      RETURN_NOT_OK(uuid.FromHexString(tablet->id()));
-      RETURN_NOT_OK(SetColumnValue(kId, uuid, &row));
-
-      // Get replicas for tablet.
-      QLValuePB replica_addresses;
-      QLMapValuePB *map_value = replica_addresses.mutable_map_value();
-      for (const auto replica : tabletLocationsPB.replicas()) {
-        InetAddress addr;
-        RETURN_NOT_OK(addr.FromString(replica.ts_info().rpc_addresses(0).host()));
-        QLValue elem_key;
-        elem_key.set_inetaddress_value(addr);
-        *map_value->add_keys() = elem_key.value();
-
-        const string& role = consensus::RaftPeerPB::Role_Name(replica.role());
-        QLValue elem_value;
-        elem_value.set_string_value(role);
-        *map_value->add_values() = elem_value.value();
-      }
-      RETURN_NOT_OK(SetColumnValue(kReplicaAddresses, replica_addresses, &row));
+bool YQLPartitionsVTable::TableRowsValid(const TableInfo& table, const TableRows& rows) const {
+  if (table.name() != rows.table_name) {
+    return false;
+  }
+  std::vector<scoped_refptr<TabletInfo> > tablets;
+  table.GetAllTablets(&tablets);
+  if (tablets.size() != rows.tablet_versions.size()) {
+    return false;
+  }
+  for (size_t i = 0; i != tablets.size(); ++i) {
+    if (tablets[i]->id() != rows.tablet_versions[i].first ||
+        tablets[i]->locations_version() != rows.tablet_versions[i].second) {
+      return false;
     }
   }
+  return true;
+}
+
+Status YQLPartitionsVTable::BuildTableRows(const TableInfo& table,
+                                           const NamespaceName& namespace_name,
+                                           TableRows* table_rows) const {
+  CatalogManager* catalog_manager = master_->catalog_manager();
+  table_rows->table_name = table.name();
+  table_rows->rows.reset(new QLRowBlock(schema_));
+
+  // Get tablets for table.
+  std::vector<scoped_refptr<TabletInfo> > tablets;
+  table.GetAllTablets(&tablets);
+  table_rows->tablet_versions.reserve(tablets.size());
+  for (const scoped_refptr<TabletInfo>& tablet : tablets) {
+    // The version is taken before the locations, so a concurrent change invalidates these rows.
+    table_rows->tablet_versions.emplace_back(tablet->id(), tablet->locations_version());
+    TabletLocationsPB tabletLocationsPB;
+    Status s = catalog_manager->GetTabletLocations(tablet->id(), &tabletLocationsPB);
+    // Skip not-found tablets: they might not be running yet or have been deleted.
+    if (!s.ok()) {
+      continue;
+    }
+
+    QLRow& row = table_rows->rows->Extend();
+    RETURN_NOT_OK(SetColumnValue(kKeyspaceName, namespace_name, &row));
+    RETURN_NOT_OK(SetColumnValue(kTableName, table.name(), &row));
+
+    const PartitionPB& partition = tabletLocationsPB.partition();
+    RETURN_NOT_OK(SetColumnValue(kStartKey, partition.partition_key_start(), &row));
+    RETURN_NOT_OK(SetColumnValue(kEndKey, partition.partition_key_end(), &row));
 
+    // Note: tablet id is in host byte order.
+    Uuid uuid;
+    RETURN_NOT_OK(uuid.FromHexString(tablet->id()));
+    RETURN_NOT_OK(SetColumnValue(kId, uuid, &row));
+
+    // Get replicas for tablet.
+    QLValuePB replica_addresses;
+    QLMapValuePB *map_value = replica_addresses.mutable_map_value();
+    for (const auto replica : tabletLocationsPB.replicas()) {
+      InetAddress addr;
+      RETURN_NOT_OK(addr.FromString(replica.ts_info().rpc_addresses(0).host()));
+      QLValue elem_key;
+      elem_key.set_inetaddress_value(addr);
+      *map_value->add_keys() = elem_key.value();
+
+      const string& role = consensus::RaftPeerPB::Role_Name(replica.role());
+      QLValue elem_value;
+      elem_value.set_string_value(role);
+      *map_value->add_values() = elem_value.value();
+    }
+    RETURN_NOT_OK(SetColumnValue(kReplicaAddresses, replica_addresses, &row));
+  }
   return Status::OK();
 }
 
@@ -14,6 +14,9 @@
 #ifndef YB_MASTER_YQL_PARTITIONS_VTABLE_H
 #define YB_MASTER_YQL_PARTITIONS_VTABLE_H
 
+#include <mutex>
+#include <unordered_map>
+
 #include "yb/master/master.h"
 #include "yb/master/yql_virtual_table.h"
 
@@ -21,6 +24,10 @@ namespace yb {
 namespace master {
 
 // VTable implementation of system.partitions.
+//
+// Drivers read this table on every connection and topology refresh, so the rows are cached.
+// While the tablet locations version and the set of tables are unchanged, readers copy the last
+// built row block. Otherwise only the tables whose tablets or names changed are rebuilt.
 class YQLPartitionsVTable : public YQLVirtualTable {
  public:
   explicit YQLPartitionsVTable(const Master* const master);
@@ -29,6 +36,32 @@ class YQLPartitionsVTable : public YQLVirtualTable {
  protected:
   Schema CreateSchema() const;
  private:
+  // Rows of a single table, valid while the table name and its tablets' locations versions match.
+  struct TableRows {
+    TableName table_name;
+    std::vector<std::pair<TabletId, uint64_t>> tablet_versions;
+    std::unique_ptr<QLRowBlock> rows;
+  };
+
+  typedef std::vector<std::pair<TableId, TableName>> TableList;
+
+  bool TableRowsValid(const TableInfo& table, const TableRows& rows) const;
+
+  CHECKED_STATUS BuildTableRows(const TableInfo& table, const NamespaceName& namespace_name,
+                                TableRows* rows) const;
+
+  // Builds the row block for the given tables, reusing cached rows of unchanged tables.
+  CHECKED_STATUS BuildRows(const std::vector<scoped_refptr<TableInfo>>& tables,
+                           QLRowBlock* vtable) const;
+
+  mutable std::mutex mutex_;
+
+  // The row block built for cached_locations_version_ and cached_tables_, protected by mutex_.
+  mutable std::shared_ptr<const QLRowBlock> cached_rows_;
+  mutable uint64_t cached_locations_version_ = 0;
+  mutable TableList cached_tables_;
+  mutable std::unordered_map<TableId, std::unique_ptr<TableRows>> cached_table_rows_;
+
   static constexpr const char* const kKeyspaceName = "keyspace_name";
   static constexpr const char* const kTableName = "table_name";
   static constexpr const char* const kStartKey = "start_key";
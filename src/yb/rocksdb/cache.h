@@ -43,6 +43,12 @@
 #include "yb/util/cache_metrics.h"
 #include "yb/rocksdb/statistics.h"
 
+namespace yb {
+
+class Cache;
+
+} // namespace yb
+
 namespace rocksdb {
 
 using std::shared_ptr;
@@ -73,6 +79,10 @@ constexpr QueryId kDefaultQueryId = 0;
 constexpr QueryId kInMultiTouchId = -1;
 // Query ids to represent values that should not be in any cache.
 constexpr QueryId kNoCacheQueryId = -2;
+// Query ids to represent values added by low priority reads, like full table scans. Such values are
+// placed to the cold end of single touch cache, so they are evicted first, and touches by low
+// priority reads never move values to multi touch cache.
+constexpr QueryId kLowPriorityQueryId = -3;
 
 class Cache {
  public:
@@ -200,6 +210,30 @@ class Cache {
   void operator=(const Cache&);
 };
 
+// Second tier of the block cache, that keeps uncompressed contents of blocks in larger but slower
+// memory, e.g. NVM. Block lookups fall through the block cache, the secondary block cache and the
+// table file.
+class SecondaryBlockCache {
+ public:
+  virtual ~SecondaryBlockCache() {}
+
+  // If the cache contains block with the specified key, copies its contents to *data and *size
+  // and returns true.
+  virtual bool Lookup(const Slice& key, std::unique_ptr<char[]>* data, size_t* size) = 0;
+
+  // Offers block that was read from the table file, after it missed both block caches.
+  // The cache decides whether the block should be admitted and could admit it asynchronously.
+  virtual void Offer(const Slice& key, const Slice& contents) = 0;
+};
+
+// Creates secondary block cache that keeps blocks in the specified cache, e.g. created with
+// yb::NewLRUCache(yb::NVM_CACHE, ...). A block is admitted only when it is offered for the second
+// time, i.e. when it was read from the file again after eviction from the block cache, so blocks
+// read once by scans do not pollute the cache. admission_filter_size is the number of recently
+// offered blocks remembered by the admission policy.
+std::shared_ptr<SecondaryBlockCache> NewSecondaryBlockCache(
+    std::unique_ptr<yb::Cache> cache, size_t admission_filter_size);
+
 }  // namespace rocksdb
 
 #endif  // STORAGE_ROCKSDB_UTIL_CACHE_H_
@@ -33,6 +33,7 @@
 namespace rocksdb {
 
 class SliceTransform;
+struct FileBoundaryValuesBase;
 
 // Context information of a compaction run
 struct CompactionFilterContext {
@@ -57,6 +58,11 @@ class CompactionFilter {
     bool is_manual_compaction;
     // Which column family this compaction is for.
     uint32_t column_family_id;
+    // Is this compaction picked to remove garbage of its input files, see
+    // CompactionOptionsUniversal::garbage_ratio_threshold. Such compaction usually does not
+    // include all data files, but the filter is expected to remove garbage counted by
+    // GetGarbageKeys.
+    bool is_garbage_collection = false;
   };
 
   virtual ~CompactionFilter() {}
@@ -144,6 +150,16 @@ class CompactionFilterFactory {
   virtual std::unique_ptr<CompactionFilter> CreateCompactionFilter(
       const CompactionFilter::Context& context) = 0;
 
+  // Returns the key that should be used as a sub-compaction boundary instead of the specified user
+  // key, so entries that a compaction filter should see together are never split between
+  // sub-compactions. The result could point into user_key. An empty result means that the key
+  // could not be used as a boundary.
+  virtual Slice SubcompactionBoundary(const Slice& user_key) const { return user_key; }
+
+  // Returns whether compaction filter created now would remove garbage of the file with the
+  // specified largest boundary values, see CompactionOptionsUniversal::garbage_ratio_threshold.
+  virtual bool IsGarbageCollectable(const FileBoundaryValuesBase& largest) const { return true; }
+
   // Returns a name that identifies this compaction filter factory.
   virtual const char* Name() const = 0;
 };
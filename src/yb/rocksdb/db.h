@@ -869,6 +869,24 @@ class DB {
     return STATUS(NotSupported, "");
   }
 
+  // Imports SST files of the RocksDB instance in 'source_dir', that was built separately while this
+  // DB accepted writes, e.g. by bulk load. Unlike Import, sequence numbers of the imported files
+  // could overlap with the ones of this DB, so it should be used only when user keys are unique
+  // across both DBs, like DocDB keys that contain hybrid time. The last sequence number of this DB
+  // is advanced past the imported files, so their keys are visible to reads. 'flushed_frontier', if
+  // specified, is set atomically with adding the files.
+  // Should not be invoked concurrently with writes.
+  virtual CHECKED_STATUS Ingest(const std::string& source_dir, UserFrontierPtr flushed_frontier) {
+    return STATUS(NotSupported, "");
+  }
+
+  // Opens table readers of all SST files of the DB that are not yet in the table cache, so the
+  // first reads do not pay for opening files and loading their indexes. Files that do not fit the
+  // table cache are opened and evicted again.
+  virtual CHECKED_STATUS WarmUpTableReaders() {
+    return STATUS(NotSupported, "");
+  }
+
   // Used in testing to make the old memtable immutable and start writing to a new one.
   virtual void TEST_SwitchMemtable() {}
 
@@ -489,6 +489,7 @@ std::unique_ptr<CompactionFilter> Compaction::CreateCompactionFilter() const {
   context.is_full_compaction = is_full_compaction_;
   context.is_manual_compaction = is_manual_compaction_;
   context.column_family_id = cfd_->GetID();
+  context.is_garbage_collection = compaction_reason_ == CompactionReason::kUniversalGarbageRatio;
   return cfd_->ioptions()->compaction_filter_factory->CreateCompactionFilter(
       context);
 }
@@ -504,7 +505,9 @@ bool Compaction::ShouldFormSubcompactions() const {
   if (cfd_->ioptions()->compaction_style == kCompactionStyleLevel) {
     return start_level_ == 0 && !IsOutputLevelEmpty();
   } else if (cfd_->ioptions()->compaction_style == kCompactionStyleUniversal) {
-    return number_levels_ > 1 && output_level_ > 0;
+    // With a single level all sorted runs are level 0 files, so output could be split into files
+    // with disjoint key ranges, like it is done for max_file_size_for_compaction.
+    return number_levels_ == 1 || output_level_ > 0;
   } else {
     return false;
   }
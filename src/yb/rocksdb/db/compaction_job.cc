@@ -60,6 +60,7 @@
 #include "yb/rocksdb/table/block_based_table_factory.h"
 #include "yb/rocksdb/table/merger.h"
 #include "yb/rocksdb/table/table_builder.h"
+#include "yb/rocksdb/table/table_reader.h"
 #include "yb/rocksdb/util/coding.h"
 #include "yb/rocksdb/util/file_reader_writer.h"
 #include "yb/rocksdb/util/iostats_context_imp.h"
@@ -75,6 +76,10 @@
 
 namespace rocksdb {
 
+// Number of keys sampled from each level 0 input file per subcompaction, when generating
+// subcompaction boundaries.
+constexpr size_t kSampledKeysPerSubcompaction = 8;
+
 // Maintains state for each sub-compaction
 struct CompactionJob::SubcompactionState {
   Compaction* compaction;
@@ -367,6 +372,9 @@ void CompactionJob::GenSubcompactionBoundaries() {
   auto* c = compact_->compaction;
   auto* cfd = c->column_family_data();
   const Comparator* cfd_comparator = cfd->user_comparator();
+  CompactionFilterFactory* compaction_filter_factory =
+      cfd->ioptions()->compaction_filter == nullptr
+          ? cfd->ioptions()->compaction_filter_factory : nullptr;
   std::vector<Slice> bounds;
   int start_lvl = c->start_level();
   int out_lvl = c->output_level();
@@ -385,10 +393,13 @@ void CompactionJob::GenSubcompactionBoundaries() {
 
       if (lvl == 0) {
         // For level 0 add the starting and ending key of each file since the
-        // files may have greatly differing key ranges (not range-partitioned)
+        // files may have greatly differing key ranges (not range-partitioned).
+        // Also sample keys inside each file, since with universal compaction all
+        // files are in level 0, and could cover the whole key range.
         for (size_t i = 0; i < num_files; i++) {
           bounds.emplace_back(flevel->files[i].smallest.key);
           bounds.emplace_back(flevel->files[i].largest.key);
+          SampleKeys(flevel->files[i]);
         }
       } else {
         // For all other levels add the smallest/largest key in the level to
@@ -408,6 +419,11 @@ void CompactionJob::GenSubcompactionBoundaries() {
     }
   }
 
+  // sampled_keys_ is not modified after this point, so slices remain valid.
+  for (const auto& key : sampled_keys_) {
+    bounds.emplace_back(key);
+  }
+
   std::sort(bounds.begin(), bounds.end(),
     [cfd_comparator] (const Slice& a, const Slice& b) -> bool {
       return cfd_comparator->Compare(ExtractUserKey(a), ExtractUserKey(b)) < 0;
@@ -462,7 +478,17 @@ void CompactionJob::GenSubcompactionBoundaries() {
         continue;
       }
       if (sum >= mean) {
-        boundaries_.emplace_back(ExtractUserKey(ranges[i].range.limit));
+        Slice boundary = ExtractUserKey(ranges[i].range.limit);
+        if (compaction_filter_factory != nullptr) {
+          boundary = compaction_filter_factory->SubcompactionBoundary(boundary);
+          // Adjusted boundary could be unusable or coincide with the previous one, in this
+          // case the range is added to the next subcompaction.
+          if (boundary.empty() || (!boundaries_.empty() &&
+              cfd_comparator->Compare(boundary, boundaries_.back()) <= 0)) {
+            continue;
+          }
+        }
+        boundaries_.emplace_back(boundary);
         sizes_.emplace_back(sum);
         subcompactions--;
         sum = 0;
@@ -475,6 +501,17 @@ void CompactionJob::GenSubcompactionBoundaries() {
   }
 }
 
+void CompactionJob::SampleKeys(const FdWithBoundaries& file) {
+  auto* cfd = compact_->compaction->column_family_data();
+  TableReader* table_reader = nullptr;
+  std::unique_ptr<InternalIterator> iter(cfd->table_cache()->NewIterator(
+      ReadOptions(), env_options_, cfd->internal_comparator(), file.fd, &table_reader));
+  if (table_reader != nullptr) {
+    table_reader->SampleKeys(db_options_.max_subcompactions * kSampledKeysPerSubcompaction,
+                             &sampled_keys_);
+  }
+}
+
 Status CompactionJob::Run() {
   AutoThreadOperationStageUpdater stage_updater(
       ThreadStatus::STAGE_COMPACTION_RUN);
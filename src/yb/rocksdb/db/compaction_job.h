@@ -63,6 +63,7 @@ class Version;
 class VersionEdit;
 class VersionSet;
 class Arena;
+struct FdWithBoundaries;
 
 class CompactionJob {
  public:
@@ -99,6 +100,8 @@ class CompactionJob {
 
   void AggregateStatistics();
   void GenSubcompactionBoundaries();
+  // Samples keys of the input file to sampled_keys_.
+  void SampleKeys(const FdWithBoundaries& file);
 
   // update the thread status for starting a compaction.
   void ReportStartedCompaction(Compaction* compaction);
@@ -168,6 +171,8 @@ class CompactionJob {
   bool bottommost_level_;
   bool paranoid_file_checks_;
   bool measure_io_stats_;
+  // Keys sampled from input files as potential subcompaction boundaries.
+  std::vector<std::string> sampled_keys_;
   // Stores the Slices that designate the boundaries for each subcompaction
   std::vector<Slice> boundaries_;
   // Stores the approx size of keys covered in the range of each subcompaction
@@ -35,6 +35,7 @@
 
 #include <gflags/gflags.h>
 
+#include "yb/rocksdb/compaction_filter.h"
 #include "yb/rocksdb/db/column_family.h"
 #include "yb/rocksdb/db/filename.h"
 #include "yb/rocksdb/util/log_buffer.h"
@@ -1148,7 +1149,28 @@ bool LevelCompactionPicker::PickCompactionBySize(VersionStorageInfo* vstorage,
 bool UniversalCompactionPicker::NeedsCompaction(
     const VersionStorageInfo* vstorage) const {
   const int kLevel0 = 0;
-  return vstorage->CompactionScore(kLevel0) >= 1;
+  if (vstorage->CompactionScore(kLevel0) >= 1) {
+    return true;
+  }
+  if (ioptions_.compaction_options_universal.garbage_ratio_threshold <= 0) {
+    return false;
+  }
+  for (const auto* f : vstorage->LevelFiles(kLevel0)) {
+    if (IsGarbageCompactionCandidate(*f)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool UniversalCompactionPicker::IsGarbageCompactionCandidate(const FileMetaData& file) const {
+  const double threshold = ioptions_.compaction_options_universal.garbage_ratio_threshold;
+  if (threshold <= 0 || file.being_compacted || file.num_entries == 0 ||
+      file.num_garbage_entries < threshold * file.num_entries) {
+    return false;
+  }
+  return !ioptions_.compaction_filter_factory ||
+         ioptions_.compaction_filter_factory->IsGarbageCollectable(file.largest);
 }
 
 struct UniversalCompactionPicker::SortedRun {
@@ -1223,14 +1245,14 @@ void UniversalCompactionPicker::SortedRun::DumpSizeInfo(
 std::vector<std::vector<UniversalCompactionPicker::SortedRun>>
     UniversalCompactionPicker::CalculateSortedRuns(const VersionStorageInfo& vstorage,
                                                    const ImmutableCFOptions& ioptions,
-                                                   uint64_t max_file_size) {
+                                                   const MutableCFOptions& mutable_cf_options) {
   std::vector<std::vector<SortedRun>> ret(1);
   for (FileMetaData* f : vstorage.LevelFiles(0)) {
-    if (f->fd.GetTotalFileSize() <= max_file_size) {
+    if (!mutable_cf_options.ExcludeFileFromCompaction(*f)) {
       ret.back().emplace_back(0, f, f->fd.GetTotalFileSize(), f->compensated_file_size,
           f->being_compacted);
-    // If last sequence is empty it means that there are multiple too-large-to-compact files in
-    // a row. So we just don't start new sequence in this case.
+    // If last sequence is empty it means that there are multiple excluded files in a row.
+    // So we just don't start new sequence in this case.
     } else if (!ret.back().empty()) {
       ret.emplace_back();
     }
@@ -1266,7 +1288,7 @@ std::vector<std::vector<UniversalCompactionPicker::SortedRun>>
     }
   }
 
-  // If last sequence is empty, it means that we don't have files after too-large-to-compact file.
+  // If last sequence is empty, it means that we don't have files after excluded file.
   // So just drop this sequence.
   if (ret.back().empty())
     ret.pop_back();
@@ -1356,7 +1378,7 @@ Compaction* UniversalCompactionPicker::PickCompaction(
   std::vector<std::vector<SortedRun>> sorted_runs = CalculateSortedRuns(
       *vstorage,
       ioptions_,
-      mutable_cf_options.max_file_size_for_compaction);
+      mutable_cf_options);
 
   for (const auto& block : sorted_runs) {
     Compaction* result = DoPickCompaction(cf_name, mutable_cf_options, vstorage, log_buffer, block);
@@ -1364,7 +1386,48 @@ Compaction* UniversalCompactionPicker::PickCompaction(
       return result;
     }
   }
-  return nullptr;
+  return PickCompactionUniversalGarbage(cf_name, mutable_cf_options, vstorage, log_buffer);
+}
+
+Compaction* UniversalCompactionPicker::PickCompactionUniversalGarbage(
+    const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+    VersionStorageInfo* vstorage, LogBuffer* log_buffer) {
+  const int kLevel0 = 0;
+  FileMetaData* best = nullptr;
+  double best_ratio = 0;
+  for (auto* f : vstorage->LevelFiles(kLevel0)) {
+    if (mutable_cf_options.ExcludeFileFromCompaction(*f) || !IsGarbageCompactionCandidate(*f)) {
+      continue;
+    }
+    const double ratio = static_cast<double>(f->num_garbage_entries) / f->num_entries;
+    if (ratio > best_ratio) {
+      best = f;
+      best_ratio = ratio;
+    }
+  }
+  if (best == nullptr) {
+    return nullptr;
+  }
+
+  LOG_TO_BUFFER(log_buffer,
+                "[%s] Universal: compacting for garbage, file %" PRIu64 " has %" PRIu64
+                " garbage entries of %" PRIu64 "\n",
+                cf_name.c_str(), best->fd.GetNumber(), best->num_garbage_entries,
+                best->num_entries);
+
+  // The file is replaced by its compacted version, so it stays at the same position in time order.
+  std::vector<CompactionInputFiles> inputs(1);
+  inputs[0].level = kLevel0;
+  inputs[0].files.push_back(best);
+  auto c = new Compaction(
+      vstorage, mutable_cf_options, std::move(inputs), kLevel0,
+      mutable_cf_options.MaxFileSizeForLevel(kLevel0), LLONG_MAX, best->fd.GetPathId(),
+      GetCompressionType(ioptions_, kLevel0, 1), /* grandparents */ {}, /* is manual */ false,
+      best_ratio, false /* deletion_compaction */, CompactionReason::kUniversalGarbageRatio);
+
+  MeasureTime(ioptions_.statistics, NUM_FILES_IN_SINGLE_COMPACTION, 1);
+  level0_compactions_in_progress_.insert(c);
+  return c;
 }
 
 Compaction* UniversalCompactionPicker::DoPickCompaction(
@@ -279,8 +279,18 @@ class UniversalCompactionPicker : public CompactionPicker {
       VersionStorageInfo* vstorage, double score,
       const std::vector<SortedRun>& sorted_runs, LogBuffer* log_buffer);
 
+  // Pick Universal compaction of the level 0 file with the highest garbage ratio, see
+  // CompactionOptionsUniversal::garbage_ratio_threshold.
+  Compaction* PickCompactionUniversalGarbage(
+      const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+      VersionStorageInfo* vstorage, LogBuffer* log_buffer);
+
+  // Returns whether garbage of the file should be collected by a separate compaction.
+  bool IsGarbageCompactionCandidate(const FileMetaData& file) const;
+
   // At level 0 we could compact only continuous sequence of files.
-  // Since there could be too-large-to-compact files, we could get several such sequences.
+  // Since there could be files excluded from compaction (too large ones, or ones rejected by
+  // exclude_file_from_compaction), we could get several such sequences.
   // Files from one sequence are compacted together, and files from different sequences are not
   // compacted.
   // One sequence is std::vector<SortedRun>.
@@ -288,7 +298,7 @@ class UniversalCompactionPicker : public CompactionPicker {
   static std::vector<std::vector<SortedRun>> CalculateSortedRuns(
       const VersionStorageInfo& vstorage,
       const ImmutableCFOptions& ioptions,
-      uint64_t max_file_size);
+      const MutableCFOptions& mutable_cf_options);
 
   // Pick a path ID to place a newly generated file, with its estimated file
   // size.
@@ -474,6 +474,33 @@ TEST_F(CompactionPickerTest, AllowsTrivialMoveUniversal) {
   ASSERT_TRUE(compaction->is_trivial_move());
 }
 
+TEST_F(CompactionPickerTest, ExcludeFileFromCompactionUniversal) {
+  const uint64_t kFileSize = 100000;
+
+  // Files 1 and 2 hold the oldest data and should never be picked.
+  mutable_cf_options_.exclude_file_from_compaction =
+      std::make_shared<std::function<bool(const FileMetaData&)>>(
+          [](const FileMetaData& file) { return file.fd.GetNumber() <= 2; });
+  UniversalCompactionPicker universal_compaction_picker(ioptions_, icmp_.get());
+
+  NewVersionStorage(1, kCompactionStyleUniversal);
+  for (uint32_t i = 7; i != 0; --i) {
+    Add(0, i, ToString(i * 100).c_str(), ToString(i * 100 + 99).c_str(), kFileSize, 0, i * 100,
+        i * 100 + 99);
+  }
+  UpdateVersionStorageInfo();
+  ASSERT_EQ(5, vstorage_->l0_delay_trigger_count());
+
+  std::unique_ptr<Compaction> compaction(
+      universal_compaction_picker.PickCompaction(
+          cf_name_, mutable_cf_options_, vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction);
+  ASSERT_GT(compaction->num_input_files(0), 0U);
+  for (size_t i = 0; i != compaction->num_input_files(0); ++i) {
+    ASSERT_GT(compaction->input(0, i)->fd.GetNumber(), 2U);
+  }
+}
+
 TEST_F(CompactionPickerTest, NeedsCompactionFIFO) {
   NewVersionStorage(1, kCompactionStyleFIFO);
   const int kFileCount =
@@ -24,6 +24,9 @@
 #include <gflags/gflags.h>
 #include "yb/rocksdb/db/db_test_util.h"
 #include "yb/rocksdb/port/stack_trace.h"
+#include "yb/rocksdb/util/secondary_block_cache.h"
+
+#include "yb/util/cache.h"
 
 DECLARE_double(cache_single_touch_ratio);
 
@@ -185,6 +188,46 @@ TEST_F(DBBlockCacheTest, TestWithoutCompressedBlockCache) {
   }
 }
 
+TEST_F(DBBlockCacheTest, TestWithSecondaryBlockCache) {
+  ReadOptions read_options;
+  auto table_options = GetTableOptions();
+  auto options = GetOptions(table_options);
+  options.compression = CompressionType::kNoCompression;
+  InitTable(options);
+
+  // Block cache without capacity, so blocks are evicted as soon as they are released.
+  std::shared_ptr<Cache> cache = NewLRUCache(0, 0, false);
+  auto secondary_block_cache = NewSecondaryBlockCache(
+      std::unique_ptr<yb::Cache>(yb::NewLRUCache(yb::DRAM_CACHE, 1_MB, "secondary_test")),
+      1024);
+  table_options.block_cache = cache;
+  table_options.secondary_block_cache = secondary_block_cache;
+  options.table_factory.reset(new BlockBasedTableFactory(table_options));
+  Reopen(options);
+
+  auto read_all_blocks = [this, &read_options] {
+    for (size_t i = 0; i < kNumBlocks; i++) {
+      std::unique_ptr<Iterator> iter(db_->NewIterator(read_options));
+      iter->Seek(ToString(i));
+      ASSERT_OK(iter->status());
+      ASSERT_TRUE(iter->Valid());
+    }
+  };
+
+  // Blocks are admitted to the secondary cache only when they are read from file twice.
+  read_all_blocks();
+  down_cast<YBSecondaryBlockCache*>(secondary_block_cache.get())->TEST_WaitForAdmissions();
+  read_all_blocks();
+  ASSERT_EQ(0, TestGetTickerCount(options, BLOCK_CACHE_SECONDARY_HIT));
+  down_cast<YBSecondaryBlockCache*>(secondary_block_cache.get())->TEST_WaitForAdmissions();
+
+  auto misses = TestGetTickerCount(options, BLOCK_CACHE_MISS);
+  read_all_blocks();
+  // Block cache misses are served by the secondary cache now.
+  ASSERT_EQ(misses + kNumBlocks, TestGetTickerCount(options, BLOCK_CACHE_MISS));
+  ASSERT_EQ(kNumBlocks, TestGetTickerCount(options, BLOCK_CACHE_SECONDARY_HIT));
+}
+
 #ifdef SNAPPY
 TEST_F(DBBlockCacheTest, TestWithCompressedBlockCache) {
   ReadOptions read_options;
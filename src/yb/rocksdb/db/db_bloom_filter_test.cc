@@ -430,6 +430,49 @@ TEST_F(DBBloomFilterTest, BloomFilterIndex) {
   } while (ChangeCompactOptions());
 }
 
+// Fixed-size filter with multi-level data index should have multi-level filter index, that is
+// read through block cache.
+TEST_F(DBBloomFilterTest, MultiLevelFilterIndex) {
+  Options options = CurrentOptions();
+  options.statistics = rocksdb::CreateDBStatistics();
+  BlockBasedTableOptions table_options;
+  // Small filter and index blocks, so we have a lot of filter blocks and several filter index
+  // levels.
+  table_options.filter_policy.reset(NewFixedSizeFilterPolicy(
+      2048, FilterPolicy::kDefaultFixedSizeFilterErrorRate, nullptr));
+  table_options.index_type = IndexType::kMultiLevelBinarySearch;
+  table_options.index_block_size = 128;
+  table_options.min_keys_per_index_block = 2;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  Reopen(options);
+
+  constexpr int kNumKeys = 10000;
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_OK(Put(Key(i * 2), Key(i * 2)));
+  }
+  ASSERT_OK(Flush());
+
+  TablePropertiesCollection props;
+  ASSERT_OK(db_->GetPropertiesOfAllTables(&props));
+  ASSERT_EQ(1, props.size());
+  const auto& table_props = *props.begin()->second;
+  const auto& user_props = table_props.user_collected_properties;
+  auto it = user_props.find(BlockBasedTablePropertyNames::kNumFilterIndexLevels);
+  ASSERT_NE(it, user_props.end());
+  ASSERT_GT(DecodeFixed32(it->second.c_str()), 1);
+  ASSERT_GT(table_props.num_filter_blocks, 10);
+
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_EQ(Key(i * 2), Get(Key(i * 2)));
+  }
+  ASSERT_EQ(TestGetTickerCount(options, BLOOM_FILTER_USEFUL), 0);
+
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_EQ("NOT_FOUND", Get(Key(i * 2 + 1)));
+  }
+  ASSERT_GE(TestGetTickerCount(options, BLOOM_FILTER_USEFUL), kNumKeys * 0.95);
+}
+
 TEST_F(DBBloomFilterTest, BloomFilterRate) {
   while (ChangeFilterOptions()) {
     Options options = CurrentOptions();
@@ -128,6 +128,9 @@ namespace rocksdb {
 
 const char kDefaultColumnFamilyName[] = "default";
 
+// Compaction readahead used with direct I/O when compaction_readahead_size is not set.
+constexpr size_t kDefaultDirectIOCompactionReadaheadSize = 2 * 1024 * 1024;
+
 void DumpRocksDBBuildVersion(Logger* log);
 
 struct DBImpl::WriteContext {
@@ -208,6 +211,15 @@ DBOptions SanitizeOptions(const std::string& dbname, const DBOptions& src) {
     result.db_paths.emplace_back(dbname, std::numeric_limits<uint64_t>::max());
   }
 
+  if (result.use_direct_io_for_compaction) {
+    // Compaction inputs are opened with direct I/O separately from the table readers of user
+    // reads, and read ahead in big chunks since direct reads are not served from the page cache.
+    result.new_table_reader_for_compaction_inputs = true;
+    if (result.compaction_readahead_size == 0) {
+      result.compaction_readahead_size = kDefaultDirectIOCompactionReadaheadSize;
+    }
+  }
+
   if (result.compaction_readahead_size > 0) {
     result.new_table_reader_for_compaction_inputs = true;
   }
@@ -307,6 +319,8 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname)
       next_job_id_(1),
       has_unpersisted_data_(false),
       env_options_(db_options_),
+      env_options_for_compaction_(
+          db_options_.env->OptimizeForCompactionTableWrite(env_options_, db_options_)),
 #ifndef ROCKSDB_LITE
       wal_manager_(db_options_, env_options_),
 #endif  // ROCKSDB_LITE
@@ -329,6 +343,7 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname)
                                  &write_controller_));
   column_family_memtables_.reset(
       new ColumnFamilyMemTablesImpl(versions_->GetColumnFamilySet()));
+  iterator_pool_.reset(new IteratorPool(db_options_.iterator_pool_size));
 
   if (FLAGS_dump_dbimpl_info) {
     DumpRocksDBBuildVersion(db_options_.info_log.get());
@@ -355,6 +370,8 @@ void DBImpl::CancelAllBackgroundWork(bool wait) {
 DBImpl::~DBImpl() {
   RLOG(InfoLogLevel::INFO_LEVEL, db_options_.info_log, "Shutting down RocksDB at: %s\n",
        dbname_.c_str());
+  // Pooled iterators unref their super versions, that requires mutex_.
+  iterator_pool_->Clear();
   mutex_.Lock();
 
   if (!shutting_down_.load(std::memory_order_acquire) &&
@@ -1954,7 +1971,7 @@ Status DBImpl::CompactFilesImpl(
 
   assert(is_snapshot_supported_ || snapshots_.empty());
   CompactionJob compaction_job(
-      job_context->job_id, c.get(), db_options_, env_options_, versions_.get(),
+      job_context->job_id, c.get(), db_options_, env_options_for_compaction_, versions_.get(),
       &shutting_down_, log_buffer, directories_.GetDbDir(),
       directories_.GetDataDir(c->output_path_id()), stats_, &mutex_, &bg_error_,
       snapshot_seqs, earliest_write_conflict_snapshot, table_cache_,
@@ -2640,6 +2657,10 @@ void DBImpl::MaybeScheduleFlushOrCompaction() {
     return;
   }
 
+  if (bg_compaction_scheduled_ >= bg_compactions_allowed || unscheduled_compactions_ <= 0) {
+    return;
+  }
+  const double score = MaxCompactionScore();
   while (bg_compaction_scheduled_ < bg_compactions_allowed &&
          unscheduled_compactions_ > 0) {
     CompactionArg* ca = new CompactionArg;
@@ -2647,8 +2668,8 @@ void DBImpl::MaybeScheduleFlushOrCompaction() {
     ca->m = nullptr;
     bg_compaction_scheduled_++;
     unscheduled_compactions_--;
-    env_->Schedule(&DBImpl::BGWorkCompaction, ca, Env::Priority::LOW, this,
-                   &DBImpl::UnscheduleCallback);
+    env_->ScheduleWithScore(&DBImpl::BGWorkCompaction, ca, Env::Priority::LOW, this,
+                            &DBImpl::UnscheduleCallback, score);
   }
 }
 
@@ -2660,6 +2681,20 @@ int DBImpl::BGCompactionsAllowed() const {
   }
 }
 
+double DBImpl::MaxCompactionScore() {
+  mutex_.AssertHeld();
+  double result = 0;
+  for (auto cfd : *versions_->GetColumnFamilySet()) {
+    if (cfd->IsDropped() || cfd->current() == nullptr) {
+      continue;
+    }
+    // Scores are sorted, the first one is the highest. For universal compaction it is the number
+    // of sorted runs relative to level0_file_num_compaction_trigger.
+    result = std::max(result, cfd->current()->storage_info()->CompactionScore(0));
+  }
+  return result;
+}
+
 bool DBImpl::IsEmptyCompactionQueue() {
   return small_compaction_queue_.empty() && large_compaction_queue_.empty();
 }
@@ -2822,6 +2857,17 @@ Status DBImpl::BackgroundFlush(bool* made_progress, JobContext* job_context,
   return status;
 }
 
+void DBImpl::ReleaseStalePooledIterators() {
+  if (!iterator_pool_->enabled()) {
+    return;
+  }
+  // Dropped iterators could unref their super versions, that requires mutex_.
+  const uint64_t sv_number = default_cf_handle_->cfd()->GetSuperVersionNumber();
+  mutex_.Unlock();
+  iterator_pool_->ReleaseStale(sv_number);
+  mutex_.Lock();
+}
+
 void DBImpl::BackgroundCallFlush() {
   bool made_progress = false;
   JobContext job_context(next_job_id_.fetch_add(1), true);
@@ -2857,6 +2903,10 @@ void DBImpl::BackgroundCallFlush() {
 
     ReleaseFileNumberFromPendingOutputs(pending_outputs_inserted_elem);
 
+    if (made_progress) {
+      ReleaseStalePooledIterators();
+    }
+
     // If flush failed, we want to delete all temporary files that we might have
     // created. Thus, we force full scan in FindObsoleteFiles()
     FindObsoleteFiles(&job_context, !s.ok() && !s.IsShutdownInProgress());
@@ -2928,6 +2978,10 @@ void DBImpl::BackgroundCallCompaction(void* arg) {
 
     ReleaseFileNumberFromPendingOutputs(pending_outputs_inserted_elem);
 
+    if (made_progress) {
+      ReleaseStalePooledIterators();
+    }
+
     // If compaction failed, we want to delete all temporary files that we might
     // have created (they might not be all recorded in job_context in case of a
     // failure). Thus, we force full scan in FindObsoleteFiles()
@@ -3188,7 +3242,7 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
 
     assert(is_snapshot_supported_ || snapshots_.empty());
     CompactionJob compaction_job(
-        job_context->job_id, c.get(), db_options_, env_options_,
+        job_context->job_id, c.get(), db_options_, env_options_for_compaction_,
         versions_.get(), &shutting_down_, log_buffer, directories_.GetDbDir(),
         directories_.GetDataDir(c->output_path_id()), stats_, &mutex_,
         &bg_error_, snapshot_seqs, earliest_write_conflict_snapshot,
@@ -4162,7 +4216,20 @@ Iterator* DBImpl::NewIterator(const ReadOptions& read_options,
         read_options.prefix_same_as_start, read_options.pin_data);
 #endif
   } else {
+    // The latest sequence number is read before the super version number, so all writes visible
+    // at this sequence number are present in the super version of a reused iterator.
     SequenceNumber latest_snapshot = versions_->LastSequence();
+    const bool use_pool = iterator_pool_->enabled() && cfd == default_cf_handle_->cfd() &&
+                          IteratorPool::Poolable(read_options);
+    if (use_pool) {
+      const uint64_t sv_number = cfd->GetSuperVersionNumber();
+      auto pooled = iterator_pool_->Take(read_options, sv_number);
+      if (pooled) {
+        pooled->Reseat(latest_snapshot);
+        return new PooledIterator(
+            iterator_pool_.get(), std::move(pooled), read_options, sv_number);
+      }
+    }
     SuperVersion* sv = cfd->GetReferencedSuperVersion(&mutex_);
 
     auto snapshot =
@@ -4223,6 +4290,11 @@ Iterator* DBImpl::NewIterator(const ReadOptions& read_options,
         NewInternalIterator(read_options, cfd, sv, db_iter->GetArena());
     db_iter->SetIterUnderDBIter(internal_iter);
 
+    if (use_pool) {
+      return new PooledIterator(
+          iterator_pool_.get(), std::unique_ptr<ArenaWrappedDBIter>(db_iter), read_options,
+          sv->version_number);
+    }
     return db_iter;
   }
   // To stop compiler from complaining
@@ -4409,6 +4481,12 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
 
   StopWatch write_sw(env_, db_options_.statistics.get(), DB_WRITE);
 
+  // Invoked by the write thread in order of pipelined groups, see CompletePipelinedWorker.
+  auto publish_sequence = [this](SequenceNumber last_sequence) {
+    SetTickerCount(stats_, SEQUENCE_NUMBER, last_sequence);
+    versions_->SetLastSequence(last_sequence);
+  };
+
   write_thread_.JoinBatchGroup(&w);
   if (w.state == WriteThread::STATE_PARALLEL_FOLLOWER) {
     // we are a non-leader in a parallel group
@@ -4424,7 +4502,9 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
           true /*dont_filter_deletes*/, true /*concurrent_memtable_writes*/);
     }
 
-    if (write_thread_.CompleteParallelWorker(&w)) {
+    if (w.parallel_group->pipelined) {
+      write_thread_.CompletePipelinedWorker(&w, publish_sequence);
+    } else if (write_thread_.CompleteParallelWorker(&w)) {
       // we're responsible for early exit
       auto last_sequence = w.parallel_group->last_sequence;
       SetTickerCount(stats_, SEQUENCE_NUMBER, last_sequence);
@@ -4469,6 +4549,8 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
                total_log_size() > max_total_wal_size)) {
     uint64_t flush_column_family_if_log_file = alive_log_files_.begin()->number;
     alive_log_files_.begin()->getting_flushed = true;
+    // Memtables could not be switched while previous groups are inserting into them.
+    write_thread_.WaitForPipelinedGroups();
     RLOG(InfoLogLevel::INFO_LEVEL, db_options_.info_log,
         "Flushing all column families with data in WAL number %" PRIu64
         ". Total log size is %" PRIu64 " while max_total_wal_size is %" PRIu64,
@@ -4514,6 +4596,7 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
       }
     }
     if (largest_cfd != nullptr) {
+      write_thread_.WaitForPipelinedGroups();
       status = SwitchMemtable(largest_cfd, &context);
       if (status.ok()) {
         largest_cfd->imm()->FlushRequested();
@@ -4528,6 +4611,7 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
   }
 
   if (UNLIKELY(status.ok() && !flush_scheduler_.Empty())) {
+    write_thread_.WaitForPipelinedGroups();
     status = ScheduleFlushes(&context);
   }
 
@@ -4581,8 +4665,8 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
     // 3. Deletes or SingleDeletes are not okay if filtering deletes
     //    (controlled by both batch and memtable setting)
     // 4. Merges are not okay
-    // 5. YugaByte-specific user-specified sequence numbers are currently not compatible with
-    //    parallel memtable writes.
+    // 5. YugaByte-specific user frontiers are merged under a lock in MemTable::UpdateFrontiers,
+    //    so they are compatible with parallel memtable writes.
     //
     // Rules 1..3 are enforced by checking the options
     // during startup (CheckConcurrentWritesSupported), so if
@@ -4592,6 +4676,10 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
     // more than once to a particular key.
     bool parallel =
         db_options_.allow_concurrent_memtable_write && write_group.size() > 1;
+    // Pipelined groups use the parallel memtable insert, even when the group has single writer,
+    // see DBOptions::enable_pipelined_write.
+    bool pipelined = db_options_.enable_pipelined_write &&
+                     db_options_.allow_concurrent_memtable_write && !need_log_sync;
     size_t total_count = 0;
     uint64_t total_byte_size = 0;
     for (auto writer : write_group) {
@@ -4600,9 +4688,20 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
         total_byte_size = WriteBatchInternal::AppendedByteSize(
             total_byte_size, WriteBatchInternal::ByteSize(writer->batch));
         parallel = parallel && !writer->batch->HasMerge();
+        pipelined = pipelined && !writer->batch->HasMerge();
       }
     }
 
+    if (pipelined) {
+      parallel = true;
+      last_sequence = std::max(last_sequence, last_allocated_sequence_);
+    } else if (db_options_.enable_pipelined_write) {
+      // Sequence of this group is published by the leader, so previous groups should be published
+      // before.
+      write_thread_.WaitForPipelinedGroups();
+      last_sequence = versions_->LastSequence();
+    }
+
     const SequenceNumber current_sequence = last_sequence + 1;
 
 #ifndef NDEBUG
@@ -4615,6 +4714,9 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
 
     // Reserve sequence numbers for all individual updates in this batch group.
     last_sequence += total_count;
+    if (pipelined) {
+      last_allocated_sequence_ = last_sequence;
+    }
 
     // Record statistics
     RecordTick(stats_, NUMBER_KEYS_WRITTEN, total_count);
@@ -4737,7 +4839,12 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
         pg.early_exit_allowed = !need_log_sync;
         pg.running.store(static_cast<uint32_t>(write_group.size()),
                          std::memory_order_relaxed);
-        write_thread_.LaunchParallelFollowers(&pg, current_sequence);
+        if (pipelined) {
+          // The next group could be formed while this one is inserting into memtable.
+          write_thread_.LaunchPipelinedGroup(&pg, current_sequence);
+        } else {
+          write_thread_.LaunchParallelFollowers(&pg, current_sequence);
+        }
 
         if (!w.CallbackFailed()) {
           // do leader write
@@ -4752,9 +4859,15 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
               true /*concurrent_memtable_writes*/);
         }
 
-        // CompleteParallelWorker returns true if this thread should
-        // handle exit, false means somebody else did
-        exit_completed_early = !write_thread_.CompleteParallelWorker(&w);
+        if (pipelined) {
+          // Sequence is published and the group is exited by the write thread.
+          write_thread_.CompletePipelinedWorker(&w, publish_sequence);
+          exit_completed_early = true;
+        } else {
+          // CompleteParallelWorker returns true if this thread should
+          // handle exit, false means somebody else did
+          exit_completed_early = !write_thread_.CompleteParallelWorker(&w);
+        }
         status = w.FinalStatus();
       }
 
@@ -4775,8 +4888,16 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
       //
       // Is setting bg_error_ enough here?  This will at least stop
       // compaction and fail any further writes.
-      if (!status.ok() && bg_error_.ok() && !w.CallbackFailed()) {
-        bg_error_ = status;
+      if (!status.ok() && !w.CallbackFailed()) {
+        if (pipelined) {
+          // Leader of pipelined group is not exclusive anymore, so it needs the db mutex.
+          InstrumentedMutexLock l(&mutex_);
+          if (bg_error_.ok()) {
+            bg_error_ = status;
+          }
+        } else if (bg_error_.ok()) {
+          bg_error_ = status;
+        }
       }
     }
   }
@@ -5216,6 +5337,71 @@ Status DBImpl::Import(const std::string& source_dir) {
   return ApplyVersionEdit(&edit);
 }
 
+Status DBImpl::Ingest(const std::string& source_dir, UserFrontierPtr flushed_frontier) {
+  // Flush first, so 'flushed_frontier' does not cover entries that are only in the memtable.
+  FlushOptions options;
+  RETURN_NOT_OK(Flush(options));
+  VersionEdit edit;
+  SequenceNumber max_imported_seqno = 0;
+  RETURN_NOT_OK(versions_->Import(source_dir, kMaxSequenceNumber, &edit, &max_imported_seqno));
+  if (flushed_frontier) {
+    edit.SetFlushedFrontier(std::move(flushed_frontier));
+  }
+  {
+    InstrumentedMutexLock lock(&mutex_);
+    if (max_imported_seqno > versions_->LastSequence()) {
+      versions_->SetLastSequence(max_imported_seqno);
+    }
+  }
+  return ApplyVersionEdit(&edit);
+}
+
+Status DBImpl::WarmUpTableReaders() {
+  std::vector<ColumnFamilyData*> cfds;
+  {
+    InstrumentedMutexLock lock(&mutex_);
+    for (auto cfd : *versions_->GetColumnFamilySet()) {
+      if (!cfd->IsDropped()) {
+        cfd->Ref();
+        cfds.push_back(cfd);
+      }
+    }
+  }
+
+  Status result;
+  for (auto cfd : cfds) {
+    SuperVersion* sv = GetAndRefSuperVersion(cfd);
+    auto* vstorage = sv->current->storage_info();
+    for (int level = 0; level < vstorage->num_levels(); ++level) {
+      for (auto* file : vstorage->LevelFiles(level)) {
+        if (shutting_down_.load(std::memory_order_acquire)) {
+          result = STATUS(ShutdownInProgress, "");
+          break;
+        }
+        Cache::Handle* handle = nullptr;
+        auto status = cfd->table_cache()->FindTable(
+            env_options_, vstorage->InternalComparator(), file->fd, &handle, kDefaultQueryId,
+            false /* no_io */, true /* record_read_stats */,
+            cfd->internal_stats()->GetFileReadHist(level));
+        if (status.ok()) {
+          cfd->table_cache()->ReleaseHandle(handle);
+        } else if (result.ok()) {
+          result = status;
+        }
+      }
+    }
+    ReturnAndCleanupSuperVersion(cfd, sv);
+  }
+
+  InstrumentedMutexLock lock(&mutex_);
+  for (auto cfd : cfds) {
+    if (cfd->Unref()) {
+      delete cfd;
+    }
+  }
+  return result;
+}
+
 void DBImpl::TEST_SwitchMemtable() {
   std::lock_guard<InstrumentedMutex> lock(mutex_);
   WriteContext context;
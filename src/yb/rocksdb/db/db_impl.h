@@ -41,6 +41,7 @@
 #include "yb/rocksdb/db/flush_job.h"
 #include "yb/rocksdb/db/flush_scheduler.h"
 #include "yb/rocksdb/db/internal_stats.h"
+#include "yb/rocksdb/db/iterator_pool.h"
 #include "yb/rocksdb/db/log_writer.h"
 #include "yb/rocksdb/db/memtable_list.h"
 #include "yb/rocksdb/db/snapshot_impl.h"
@@ -374,6 +375,11 @@ class DBImpl : public DB {
   // compaction status.
   int BGCompactionsAllowed() const;
 
+  // Returns the highest compaction score of the column families, used to order the compactions
+  // of all DBs that share the Env, so that the DBs that need a compaction the most go first.
+  // REQUIRES: mutex held.
+  double MaxCompactionScore();
+
   // Returns the list of live files in 'live' and the list
   // of all files in the filesystem in 'candidate_files'.
   // If force == false and the last call was less than
@@ -455,6 +461,10 @@ class DBImpl : public DB {
   // And max seqno of imported database is less that active seqno of destination db.
   CHECKED_STATUS Import(const std::string& source_dir) override;
 
+  CHECKED_STATUS Ingest(const std::string& source_dir, UserFrontierPtr flushed_frontier) override;
+
+  CHECKED_STATUS WarmUpTableReaders() override;
+
   // Used in testing to make the old memtable immutable and start writing to a new one.
   void TEST_SwitchMemtable() override;
 
@@ -602,6 +612,9 @@ class DBImpl : public DB {
   static void UnscheduleCallback(void* arg);
   void BackgroundCallCompaction(void* arg);
   void BackgroundCallFlush();
+  // Drops pooled iterators created for obsolete super versions. Requires that mutex_ is held,
+  // releases it while iterators are destroyed.
+  void ReleaseStalePooledIterators();
   Status BackgroundCompaction(bool* madeProgress, JobContext* job_context,
                               LogBuffer* log_buffer, void* m = 0);
   Status BackgroundFlush(bool* madeProgress, JobContext* job_context,
@@ -678,6 +691,9 @@ class DBImpl : public DB {
   ColumnFamilyHandleImpl* default_cf_handle_;
   InternalStats* default_cf_internal_stats_;
   unique_ptr<ColumnFamilyMemTablesImpl> column_family_memtables_;
+  // Iterators over the default column family reused by short reads, see
+  // DBOptions::iterator_pool_size.
+  std::unique_ptr<IteratorPool> iterator_pool_;
   struct LogFileNumberSize {
     explicit LogFileNumberSize(uint64_t _number)
         : number(_number) {}
@@ -784,6 +800,11 @@ class DBImpl : public DB {
   // sleep if it uses up the quota.
   uint64_t last_batch_group_size_;
 
+  // The last sequence assigned to a pipelined write batch group. It could be greater than
+  // the last published sequence while memtable inserts of that group are running.
+  // Accessed only by the write batch group leader.
+  SequenceNumber last_allocated_sequence_ = 0;
+
   FlushScheduler flush_scheduler_;
 
   SnapshotList snapshots_;
@@ -903,6 +924,9 @@ class DBImpl : public DB {
   // The options to access storage files
   const EnvOptions env_options_;
 
+  // The options to write table files by compaction
+  const EnvOptions env_options_for_compaction_;
+
 #ifndef ROCKSDB_LITE
   WalManager wal_manager_;
 #endif  // ROCKSDB_LITE
@@ -106,6 +106,17 @@ class DBIter: public Iterator {
       iter_->~InternalIterator();
     }
   }
+  void Reseat(SequenceNumber sequence) {
+    sequence_ = sequence;
+    status_ = Status::OK();
+    saved_key_.Clear();
+    ClearSavedValue();
+    prefix_start_.Clear();
+    merge_operands_.clear();
+    direction_ = kForward;
+    valid_ = false;
+    current_entry_is_merged_ = false;
+  }
   virtual void SetIter(InternalIterator* iter) {
     assert(iter_ == nullptr);
     iter_ = iter;
@@ -210,7 +221,7 @@ class DBIter: public Iterator {
   const Comparator* const user_comparator_;
   const MergeOperator* const user_merge_operator_;
   InternalIterator* iter_;
-  SequenceNumber const sequence_;
+  SequenceNumber sequence_;
 
   Status status_;
   IterKey saved_key_;
@@ -874,6 +885,10 @@ void ArenaWrappedDBIter::SetIterUnderDBIter(InternalIterator* iter) {
   static_cast<DBIter*>(db_iter_)->SetIter(iter);
 }
 
+void ArenaWrappedDBIter::Reseat(SequenceNumber sequence) {
+  db_iter_->Reseat(sequence);
+}
+
 inline bool ArenaWrappedDBIter::Valid() const { return db_iter_->Valid(); }
 inline void ArenaWrappedDBIter::SeekToFirst() { db_iter_->SeekToFirst(); }
 inline void ArenaWrappedDBIter::SeekToLast() { db_iter_->SeekToLast(); }
@@ -77,6 +77,12 @@ class ArenaWrappedDBIter : public Iterator {
   virtual Status status() const override;
 
   void RegisterCleanup(CleanupFunction function, void* arg1, void* arg2);
+
+  // Makes iterator see all entries up to specified sequence number and invalidates its position,
+  // so it could be reused by another read. Memtables and files of the iterator are not changed,
+  // so it should only be used while the super version it was created for is current.
+  void Reseat(SequenceNumber sequence);
+
   virtual Status PinData();
   virtual Status ReleasePinnedData();
   virtual Status GetProperty(std::string prop_name, std::string* prop) override;
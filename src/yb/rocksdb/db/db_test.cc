@@ -5538,6 +5538,125 @@ TEST_F(DBTest, WriteSingleThreadEntry) {
   }
 }
 
+TEST_F(DBTest, PipelinedWrite) {
+  Options options = CurrentOptions();
+  options.allow_concurrent_memtable_write = true;
+  options.enable_pipelined_write = true;
+  options.write_buffer_size = 64 * 1024;
+  DestroyAndReopen(options);
+
+  constexpr int kNumThreads = 8;
+  constexpr int kNumWrites = 2000;
+  WriteOptions write_options;
+  write_options.disableWAL = true;
+  std::vector<std::thread> threads;
+  for (int t = 0; t != kNumThreads; ++t) {
+    threads.emplace_back([this, t, &write_options] {
+      for (int i = 0; i != kNumWrites; ++i) {
+        const std::string key = Key(t * kNumWrites + i);
+        ASSERT_OK(db_->Put(write_options, key, key));
+        // Write is visible as soon as it completes.
+        ASSERT_EQ(key, Get(key));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_EQ(static_cast<SequenceNumber>(kNumThreads * kNumWrites),
+            db_->GetLatestSequenceNumber() - options.initial_seqno);
+  for (int i = 0; i != kNumThreads * kNumWrites; ++i) {
+    ASSERT_EQ(Key(i), Get(Key(i)));
+  }
+}
+
+TEST_F(DBTest, IteratorPool) {
+  Options options = CurrentOptions();
+  options.iterator_pool_size = 2;
+  DestroyAndReopen(options);
+
+  auto read_key = [this](const std::string& key) -> std::string {
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+    iter->Seek(key);
+    if (!iter->Valid() || iter->key() != key) {
+      return "NOT_FOUND";
+    }
+    return iter->value().ToString();
+  };
+
+  for (int i = 0; i != 100; ++i) {
+    ASSERT_OK(Put(Key(i), "v1"));
+    // Reused iterator should see writes made after it was created.
+    ASSERT_EQ("v1", read_key(Key(i)));
+  }
+
+  {
+    // Pooled iterator should not be shared by iterators that are alive at the same time.
+    std::unique_ptr<Iterator> first(db_->NewIterator(ReadOptions()));
+    std::unique_ptr<Iterator> second(db_->NewIterator(ReadOptions()));
+    first->Seek(Key(10));
+    second->Seek(Key(20));
+    ASSERT_TRUE(first->Valid());
+    ASSERT_TRUE(second->Valid());
+    ASSERT_EQ(Key(10), first->key());
+    ASSERT_EQ(Key(20), second->key());
+  }
+
+  // Iterators with snapshot are not pooled and still read at the snapshot.
+  const Snapshot* snapshot = db_->GetSnapshot();
+  ASSERT_OK(Put(Key(0), "v2"));
+  {
+    ReadOptions read_options;
+    read_options.snapshot = snapshot;
+    std::unique_ptr<Iterator> iter(db_->NewIterator(read_options));
+    iter->Seek(Key(0));
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ("v1", iter->value().ToString());
+  }
+  db_->ReleaseSnapshot(snapshot);
+  ASSERT_EQ("v2", read_key(Key(0)));
+
+  // Flush replaces the super version, so pooled iterators are dropped, and reads see flushed data
+  // together with new writes.
+  ASSERT_OK(Flush());
+  ASSERT_OK(Put(Key(1), "v2"));
+  ASSERT_EQ("v2", read_key(Key(0)));
+  ASSERT_EQ("v2", read_key(Key(1)));
+  ASSERT_OK(Delete(Key(2)));
+  ASSERT_EQ("NOT_FOUND", read_key(Key(2)));
+  ASSERT_EQ("v1", read_key(Key(3)));
+}
+
+TEST_F(DBTest, WarmUpTableReaders) {
+  Options options = CurrentOptions();
+  options.statistics = rocksdb::CreateDBStatistics();
+  options.disable_auto_compactions = true;
+  options.max_open_files = 100;
+  options.skip_stats_update_on_db_open = true;
+  DestroyAndReopen(options);
+
+  constexpr int kNumFiles = 3;
+  for (int i = 0; i != kNumFiles; ++i) {
+    ASSERT_OK(Put(Key(i), "value"));
+    ASSERT_OK(Flush());
+  }
+  Reopen(options);
+  ASSERT_EQ(kNumFiles, NumTableFilesAtLevel(0));
+
+  const uint64_t opens_before = TestGetTickerCount(options, NO_FILE_OPENS);
+  ASSERT_OK(db_->WarmUpTableReaders());
+  const uint64_t opens_after = TestGetTickerCount(options, NO_FILE_OPENS);
+  ASSERT_LE(opens_after, opens_before + kNumFiles);
+
+  // Reads and repeated warm up do not open files again.
+  for (int i = 0; i != kNumFiles; ++i) {
+    ASSERT_EQ("value", Get(Key(i)));
+  }
+  ASSERT_OK(db_->WarmUpTableReaders());
+  ASSERT_EQ(opens_after, TestGetTickerCount(options, NO_FILE_OPENS));
+}
+
 TEST_F(DBTest, DisableDataSyncTest) {
   env_->sync_counter_.store(0);
   // iter 0 -- no sync
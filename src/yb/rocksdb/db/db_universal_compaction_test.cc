@@ -128,6 +128,133 @@ class DelayFilterFactory : public CompactionFilterFactory {
  private:
   DBTestBase* db_test;
 };
+
+// Uses key prefix of the specified length as subcompaction boundary, and checks that all keys
+// with the same prefix are processed by the same compaction filter.
+class PrefixGroupFilterFactory : public CompactionFilterFactory {
+ public:
+  explicit PrefixGroupFilterFactory(size_t prefix_size) : prefix_size_(prefix_size) {}
+
+  std::unique_ptr<CompactionFilter> CreateCompactionFilter(
+      const CompactionFilter::Context& context) override {
+    return std::unique_ptr<CompactionFilter>(new GroupFilter(this));
+  }
+
+  Slice SubcompactionBoundary(const Slice& user_key) const override {
+    return Slice(user_key.data(), std::min(user_key.size(), prefix_size_));
+  }
+
+  const char* Name() const override { return "PrefixGroupFilterFactory"; }
+
+  size_t num_filters() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return num_filters_;
+  }
+
+ private:
+  class GroupFilter : public CompactionFilter {
+   public:
+    explicit GroupFilter(PrefixGroupFilterFactory* factory) : factory_(factory) {}
+
+    ~GroupFilter() {
+      std::lock_guard<std::mutex> lock(factory_->mutex_);
+      ++factory_->num_filters_;
+      for (const auto& prefix : prefixes_) {
+        EXPECT_TRUE(factory_->prefixes_.insert(prefix).second) << prefix;
+      }
+    }
+
+    bool Filter(int level, const Slice& key, const Slice& value, std::string* new_value,
+                bool* value_changed) const override {
+      prefixes_.insert(key.ToBuffer().substr(0, factory_->prefix_size_));
+      return false;
+    }
+
+    const char* Name() const override { return "PrefixGroupFilter"; }
+
+   private:
+    PrefixGroupFilterFactory* factory_;
+    mutable std::set<std::string> prefixes_;
+  };
+
+  const size_t prefix_size_;
+  std::mutex mutex_;
+  size_t num_filters_ = 0;
+  std::set<std::string> prefixes_;
+};
+
+// Keys starting with 'g' are garbage, that is removed only by garbage collection compactions,
+// once the factory is told that garbage is collectable.
+class GarbageFilterFactory : public CompactionFilterFactory {
+ public:
+  std::unique_ptr<CompactionFilter> CreateCompactionFilter(
+      const CompactionFilter::Context& context) override {
+    if (context.is_garbage_collection) {
+      ++num_garbage_compactions_;
+    }
+    return std::unique_ptr<CompactionFilter>(new GarbageFilter(context.is_garbage_collection));
+  }
+
+  bool IsGarbageCollectable(const FileBoundaryValuesBase& largest) const override {
+    return collectable_.load();
+  }
+
+  const char* Name() const override { return "GarbageFilterFactory"; }
+
+  std::atomic<bool> collectable_{false};
+  std::atomic<int> num_garbage_compactions_{0};
+
+ private:
+  class GarbageFilter : public CompactionFilter {
+   public:
+    explicit GarbageFilter(bool remove_garbage) : remove_garbage_(remove_garbage) {}
+
+    bool Filter(int level, const Slice& key, const Slice& value, std::string* new_value,
+                bool* value_changed) const override {
+      return remove_garbage_ && key.starts_with("g");
+    }
+
+    const char* Name() const override { return "GarbageFilter"; }
+
+   private:
+    const bool remove_garbage_;
+  };
+};
+
+class GarbageCollector : public TablePropertiesCollector {
+ public:
+  Status AddUserKey(const Slice& key, const Slice& value, EntryType type, SequenceNumber seq,
+                    uint64_t file_size) override {
+    if (key.starts_with("g")) {
+      ++garbage_keys_;
+    }
+    return Status::OK();
+  }
+
+  Status Finish(UserCollectedProperties* properties) override {
+    std::string value;
+    PutVarint64(&value, garbage_keys_);
+    properties->emplace(kGarbageKeysPropertyName, value);
+    return Status::OK();
+  }
+
+  UserCollectedProperties GetReadableProperties() const override { return {}; }
+
+  const char* Name() const override { return "GarbageCollector"; }
+
+ private:
+  uint64_t garbage_keys_ = 0;
+};
+
+class GarbageCollectorFactory : public TablePropertiesCollectorFactory {
+ public:
+  TablePropertiesCollector* CreateTablePropertiesCollector(
+      TablePropertiesCollectorFactory::Context context) override {
+    return new GarbageCollector();
+  }
+
+  const char* Name() const override { return "GarbageCollectorFactory"; }
+};
 }  // namespace
 
 // Make sure we don't trigger a problem if the trigger conditon is given
@@ -660,6 +787,76 @@ INSTANTIATE_TEST_CASE_P(DBTestUniversalCompactionParallel,
                         ::testing::Combine(::testing::Values(1, 10),
                                            ::testing::Bool()));
 
+TEST_P(DBTestUniversalCompaction, UniversalCompactionSubcompactions) {
+  Options options;
+  options.compaction_style = kCompactionStyleUniversal;
+  options.num_levels = num_levels_;
+  options.disable_auto_compactions = true;
+  options.max_subcompactions = 4;
+  options.target_file_size_base = 32 << 10;  // 32KB
+  // Keys are generated by Key(i), so there are 10 keys with each prefix of size 8.
+  auto* filter_factory = new PrefixGroupFilterFactory(8);
+  options.compaction_filter_factory.reset(filter_factory);
+  options = CurrentOptions(options);
+  DestroyAndReopen(options);
+
+  // Each file covers the whole key range, so boundaries are sampled from files.
+  constexpr int kNumKeys = 3000;
+  constexpr int kNumFiles = 3;
+  for (int file = 0; file < kNumFiles; ++file) {
+    for (int i = file; i < kNumKeys; i += kNumFiles) {
+      ASSERT_OK(Put(Key(i), Key(i) + std::string(100, 'v')));
+    }
+    ASSERT_OK(Flush());
+  }
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+
+  ASSERT_GT(filter_factory->num_filters(), 1);
+  for (int i = 0; i < kNumKeys; ++i) {
+    ASSERT_EQ(Key(i) + std::string(100, 'v'), Get(Key(i)));
+  }
+}
+
+TEST_P(DBTestUniversalCompaction, UniversalCompactionGarbageRatio) {
+  Options options;
+  options.compaction_style = kCompactionStyleUniversal;
+  options.num_levels = num_levels_;
+  options.level0_file_num_compaction_trigger = 10;
+  options.compaction_options_universal.garbage_ratio_threshold = 0.5;
+  auto* filter_factory = new GarbageFilterFactory();
+  options.compaction_filter_factory.reset(filter_factory);
+  options.table_properties_collector_factories.push_back(
+      std::make_shared<GarbageCollectorFactory>());
+  options = CurrentOptions(options);
+  DestroyAndReopen(options);
+
+  // 6 of 8 entries of the first file are garbage.
+  for (int i = 0; i != 6; ++i) {
+    ASSERT_OK(Put("g" + ToString(i), "garbage"));
+  }
+  ASSERT_OK(Put("k0", "value"));
+  ASSERT_OK(Put("k1", "value"));
+  ASSERT_OK(Flush());
+  dbfull()->TEST_WaitForCompact();
+
+  // Garbage is not collectable yet, so the file is not compacted.
+  ASSERT_EQ(0, filter_factory->num_garbage_compactions_.load());
+  ASSERT_EQ("garbage", Get("g0"));
+
+  // Next flush lets the picker look at the files again.
+  filter_factory->collectable_.store(true);
+  ASSERT_OK(Put("k2", "value"));
+  ASSERT_OK(Flush());
+  dbfull()->TEST_WaitForCompact();
+
+  // Only the first file is compacted, and its output has no garbage, so it is not picked again.
+  ASSERT_EQ(1, filter_factory->num_garbage_compactions_.load());
+  ASSERT_EQ(2, NumSortedRuns(0));
+  ASSERT_EQ("NOT_FOUND", Get("g0"));
+  ASSERT_EQ("value", Get("k0"));
+  ASSERT_EQ("value", Get("k2"));
+}
+
 TEST_P(DBTestUniversalCompaction, UniversalCompactionOptions) {
   Options options;
   options.compaction_style = kCompactionStyleUniversal;
@@ -375,6 +375,44 @@ class IterKey {
     key_size_ = total_size;
   }
 
+  // Replaces the key with: key[0, shared_len) + non_shared_data +
+  // key[suffix_pos, suffix_pos + suffix_len) + tail.
+  // This function is used in Block::Iter::ParseNextKey for kKeyDeltaEncodingThreeSharedParts.
+  // REQUIRES: shared_len <= suffix_pos && suffix_pos + suffix_len <= Size()
+  void TrimAppendWithSuffix(const size_t shared_len, const char* non_shared_data,
+                            const size_t non_shared_len, const size_t suffix_pos,
+                            const size_t suffix_len, const char* tail, const size_t tail_len) {
+    assert(shared_len <= suffix_pos);
+    assert(suffix_pos + suffix_len <= key_size_);
+    const size_t suffix_dest = shared_len + non_shared_len;
+    const size_t total_size = suffix_dest + suffix_len + tail_len;
+
+    if (IsKeyPinned() /* key is not in buf_ */) {
+      EnlargeBufferIfNeeded(total_size);
+      memcpy(buf_, key_, shared_len);
+      memcpy(buf_ + suffix_dest, key_ + suffix_pos, suffix_len);
+    } else if (total_size > buf_size_) {
+      char* p = new char[total_size];
+      memcpy(p, key_, shared_len);
+      memcpy(p + suffix_dest, key_ + suffix_pos, suffix_len);
+
+      if (buf_ != space_) {
+        delete[] buf_;
+      }
+
+      buf_ = p;
+      buf_size_ = total_size;
+    } else {
+      // Suffix should be moved before non shared data is copied, since they could overlap.
+      memmove(buf_ + suffix_dest, buf_ + suffix_pos, suffix_len);
+    }
+
+    memcpy(buf_ + shared_len, non_shared_data, non_shared_len);
+    memcpy(buf_ + suffix_dest + suffix_len, tail, tail_len);
+    key_ = buf_;
+    key_size_ = total_size;
+  }
+
   Slice SetKey(const Slice& key, bool copy = true) {
     size_t size = key.size();
     if (copy) {
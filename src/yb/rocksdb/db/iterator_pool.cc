@@ -0,0 +1,114 @@
+//
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+//
+
+#include "yb/rocksdb/db/iterator_pool.h"
+
+namespace rocksdb {
+
+IteratorPool::Key::Key(const ReadOptions& read_options)
+    : verify_checksums(read_options.verify_checksums),
+      fill_cache(read_options.fill_cache),
+      read_tier(read_options.read_tier),
+      total_order_seek(read_options.total_order_seek),
+      prefix_same_as_start(read_options.prefix_same_as_start),
+      query_id(read_options.query_id) {
+}
+
+bool IteratorPool::Key::operator==(const Key& rhs) const {
+  return verify_checksums == rhs.verify_checksums && fill_cache == rhs.fill_cache &&
+         read_tier == rhs.read_tier && total_order_seek == rhs.total_order_seek &&
+         prefix_same_as_start == rhs.prefix_same_as_start && query_id == rhs.query_id;
+}
+
+bool IteratorPool::Poolable(const ReadOptions& read_options) {
+  return read_options.snapshot == nullptr && read_options.iterate_upper_bound == nullptr &&
+         !read_options.tailing && !read_options.managed && !read_options.pin_data &&
+         read_options.table_aware_file_filter == nullptr && read_options.file_filter == nullptr;
+}
+
+std::unique_ptr<ArenaWrappedDBIter> IteratorPool::Take(
+    const ReadOptions& read_options, uint64_t sv_number) {
+  const Key key(read_options);
+  std::unique_ptr<ArenaWrappedDBIter> result;
+  Iterators stale;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    TakeStaleUnlocked(sv_number, &stale);
+    for (auto it = entries_.rbegin(); it != entries_.rend(); ++it) {
+      if (it->sv_number == sv_number && it->key == key) {
+        result = std::move(it->iter);
+        entries_.erase(std::next(it).base());
+        break;
+      }
+    }
+  }
+  // Stale iterators are destroyed outside of the lock, because that releases their super version.
+  return result;
+}
+
+void IteratorPool::Put(std::unique_ptr<ArenaWrappedDBIter> iter, const ReadOptions& read_options,
+                       uint64_t sv_number) {
+  Iterators stale;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    TakeStaleUnlocked(sv_number, &stale);
+    // Iterator of an obsolete super version is dropped, together with stale ones.
+    if (sv_number == current_sv_number_ && entries_.size() < capacity_) {
+      entries_.push_back(Entry{Key(read_options), sv_number, std::move(iter)});
+    }
+  }
+}
+
+void IteratorPool::ReleaseStale(uint64_t sv_number) {
+  Iterators stale;
+  std::lock_guard<std::mutex> lock(mutex_);
+  TakeStaleUnlocked(sv_number, &stale);
+}
+
+void IteratorPool::Clear() {
+  Iterators all;
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& entry : entries_) {
+    all.push_back(std::move(entry.iter));
+  }
+  entries_.clear();
+}
+
+void IteratorPool::TakeStaleUnlocked(uint64_t sv_number, Iterators* out) {
+  // Super version numbers only grow, so a lower number belongs to a super version that is
+  // already obsolete.
+  if (sv_number < current_sv_number_) {
+    return;
+  }
+  current_sv_number_ = sv_number;
+  auto it = entries_.begin();
+  while (it != entries_.end()) {
+    if (it->sv_number != current_sv_number_) {
+      out->push_back(std::move(it->iter));
+      it = entries_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+PooledIterator::~PooledIterator() {
+  // Iterator that failed could have broken internal state, so it is not reused.
+  if (iter_->status().ok()) {
+    pool_->Put(std::move(iter_), read_options_, sv_number_);
+  }
+}
+
+}  // namespace rocksdb
@@ -0,0 +1,129 @@
+//
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+//
+
+#ifndef YB_ROCKSDB_DB_ITERATOR_POOL_H
+#define YB_ROCKSDB_DB_ITERATOR_POOL_H
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "yb/rocksdb/db/db_iter.h"
+#include "yb/rocksdb/options.h"
+
+namespace rocksdb {
+
+// Pool of iterators over the default column family of a DB, reused by reads with the same read
+// options, see DBOptions::iterator_pool_size. Creating an iterator references the current super
+// version and builds a merging iterator over all its memtables and SST files, which is a large
+// share of the cost of a short read. A pooled iterator is only reused while the super version it
+// was created for is current, and is reseated to the latest sequence number before reuse.
+class IteratorPool {
+ public:
+  explicit IteratorPool(size_t capacity) : capacity_(capacity) {}
+
+  IteratorPool(const IteratorPool&) = delete;
+  void operator=(const IteratorPool&) = delete;
+
+  // Returns whether iterator created with read_options could be reused by another read with the
+  // same options. Options that capture state of a particular read, i.e. snapshot, bounds and file
+  // filters, prevent pooling.
+  static bool Poolable(const ReadOptions& read_options);
+
+  bool enabled() const { return capacity_ != 0; }
+
+  // Takes iterator created with the same read options for the super version with specified
+  // number. Returns nullptr if there is no such iterator.
+  std::unique_ptr<ArenaWrappedDBIter> Take(const ReadOptions& read_options, uint64_t sv_number);
+
+  // Puts iterator created with read_options for the super version with specified number to the
+  // pool. The iterator is dropped if the pool is full.
+  void Put(std::unique_ptr<ArenaWrappedDBIter> iter, const ReadOptions& read_options,
+           uint64_t sv_number);
+
+  // Drops iterators created for super versions other than the specified current one, so pooled
+  // iterators do not keep obsolete memtables and files alive.
+  void ReleaseStale(uint64_t sv_number);
+
+  // Drops all iterators. Should be invoked before the DB is closed.
+  void Clear();
+
+ private:
+  struct Key {
+    bool verify_checksums;
+    bool fill_cache;
+    ReadTier read_tier;
+    bool total_order_seek;
+    bool prefix_same_as_start;
+    QueryId query_id;
+
+    explicit Key(const ReadOptions& read_options);
+
+    bool operator==(const Key& rhs) const;
+  };
+
+  struct Entry {
+    Key key;
+    uint64_t sv_number;
+    std::unique_ptr<ArenaWrappedDBIter> iter;
+  };
+
+  typedef std::vector<std::unique_ptr<ArenaWrappedDBIter>> Iterators;
+
+  // Updates the current super version number if sv_number is newer and moves iterators created
+  // for other super versions to out. Requires that mutex_ is held.
+  void TakeStaleUnlocked(uint64_t sv_number, Iterators* out);
+
+  const size_t capacity_;
+  std::mutex mutex_;
+  // The newest super version number seen by the pool.
+  uint64_t current_sv_number_ = 0;
+  std::vector<Entry> entries_;
+};
+
+// Iterator returned to the user for a pooled ArenaWrappedDBIter, puts it back to the pool when
+// destroyed.
+class PooledIterator : public Iterator {
+ public:
+  PooledIterator(IteratorPool* pool, std::unique_ptr<ArenaWrappedDBIter> iter,
+                 const ReadOptions& read_options, uint64_t sv_number)
+      : pool_(pool), iter_(std::move(iter)), read_options_(read_options),
+        sv_number_(sv_number) {}
+
+  ~PooledIterator();
+
+  bool Valid() const override { return iter_->Valid(); }
+  void SeekToFirst() override { iter_->SeekToFirst(); }
+  void SeekToLast() override { iter_->SeekToLast(); }
+  void Seek(const Slice& target) override { iter_->Seek(target); }
+  void Next() override { iter_->Next(); }
+  void Prev() override { iter_->Prev(); }
+  Slice key() const override { return iter_->key(); }
+  Slice value() const override { return iter_->value(); }
+  Status status() const override { return iter_->status(); }
+  Status GetProperty(std::string prop_name, std::string* prop) override {
+    return iter_->GetProperty(std::move(prop_name), prop);
+  }
+
+ private:
+  IteratorPool* const pool_;
+  std::unique_ptr<ArenaWrappedDBIter> iter_;
+  const ReadOptions read_options_;
+  const uint64_t sv_number_;
+};
+
+}  // namespace rocksdb
+
+#endif // YB_ROCKSDB_DB_ITERATOR_POOL_H
@@ -62,6 +62,7 @@ MemTableOptions::MemTableOptions(
         mutable_cf_options.memtable_prefix_bloom_probes),
     memtable_prefix_bloom_huge_page_tlb_size(
         mutable_cf_options.memtable_prefix_bloom_huge_page_tlb_size),
+    memtable_huge_page_size(mutable_cf_options.memtable_huge_page_size),
     inplace_update_support(ioptions.inplace_update_support),
     inplace_update_num_locks(mutable_cf_options.inplace_update_num_locks),
     inplace_callback(ioptions.inplace_callback),
@@ -79,10 +80,12 @@ MemTable::MemTable(const InternalKeyComparator& cmp,
       moptions_(ioptions, mutable_cf_options),
       refs_(0),
       kArenaBlockSize(OptimizeBlockSize(moptions_.arena_block_size)),
-      arena_(moptions_.arena_block_size, 0),
+      arena_(moptions_.arena_block_size, moptions_.memtable_huge_page_size),
       allocator_(&arena_, write_buffer),
+      memtable_prefix_extractor_(ioptions.memtable_factory->PrefixExtractor()),
       table_(ioptions.memtable_factory->CreateMemTableRep(
-          comparator_, &allocator_, ioptions.prefix_extractor,
+          comparator_, &allocator_,
+          memtable_prefix_extractor_ ? memtable_prefix_extractor_ : ioptions.prefix_extractor,
           ioptions.info_log)),
       data_size_(0),
       num_entries_(0),
@@ -96,7 +99,8 @@ MemTable::MemTable(const InternalKeyComparator& cmp,
       locks_(moptions_.inplace_update_support
                  ? moptions_.inplace_update_num_locks
                  : 0),
-      prefix_extractor_(ioptions.prefix_extractor),
+      prefix_extractor_(
+          memtable_prefix_extractor_ ? memtable_prefix_extractor_ : ioptions.prefix_extractor),
       flush_state_(FlushState::kNotRequested),
       env_(ioptions.env) {
   UpdateFlushState();
@@ -241,7 +245,11 @@ class MemTableIterator : public InternalIterator {
         prefix_extractor_(mem.prefix_extractor_),
         valid_(false),
         arena_mode_(arena != nullptr) {
-    if (prefix_extractor_ != nullptr && !read_options.total_order_seek) {
+    // Memtable specific prefix extractor does not affect reads that did not request to stay within
+    // the prefix of the seek key.
+    const bool prefix_mode = mem.memtable_prefix_extractor_ != nullptr
+        ? read_options.prefix_same_as_start : !read_options.total_order_seek;
+    if (prefix_extractor_ != nullptr && prefix_mode) {
       bloom_ = mem.prefix_bloom_.get();
       iter_ = mem.table_->GetDynamicPrefixIterator(arena);
     } else {
@@ -464,7 +472,7 @@ void MemTable::Add(SequenceNumber s, ValueType type,
         earliest_seqno_.load(std::memory_order_relaxed);
     while (
         (cur_earliest_seqno == kMaxSequenceNumber || s < cur_earliest_seqno) &&
-        !first_seqno_.compare_exchange_weak(cur_earliest_seqno, s)) {
+        !earliest_seqno_.compare_exchange_weak(cur_earliest_seqno, s)) {
     }
   }
 
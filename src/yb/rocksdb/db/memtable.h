@@ -44,6 +44,7 @@
 #include "yb/rocksdb/util/concurrent_arena.h"
 #include "yb/rocksdb/util/dynamic_bloom.h"
 #include "yb/rocksdb/util/instrumented_mutex.h"
+#include "yb/rocksdb/util/mutexlock.h"
 #include "yb/rocksdb/util/mutable_cf_options.h"
 
 namespace rocksdb {
@@ -63,6 +64,7 @@ struct MemTableOptions {
   uint32_t memtable_prefix_bloom_bits;
   uint32_t memtable_prefix_bloom_probes;
   size_t memtable_prefix_bloom_huge_page_tlb_size;
+  size_t memtable_huge_page_size;
   bool inplace_update_support;
   size_t inplace_update_num_locks;
   UpdateStatus (*inplace_callback)(char* existing_value,
@@ -325,7 +327,10 @@ class MemTable {
 
   const MemTableOptions* GetMemTableOptions() const { return &moptions_; }
 
+  // Could be called by concurrent memtable writers. Frontiers() could be used only after all writes
+  // to this memtable are completed, e.g. when memtable is immutable.
   void UpdateFrontiers(const UserFrontiers& value) {
+    std::lock_guard<SpinMutex> lock(frontiers_mutex_);
     if (frontiers_) {
       frontiers_->Merge(value);
     } else {
@@ -348,6 +353,8 @@ class MemTable {
   const size_t kArenaBlockSize;
   ConcurrentArena arena_;
   MemTableAllocator allocator_;
+  // Prefix extractor provided by memtable factory, see MemTableRepFactory::PrefixExtractor.
+  const SliceTransform* const memtable_prefix_extractor_;
   unique_ptr<MemTableRep> table_;
 
   // Total data size of all data inserted
@@ -384,6 +391,7 @@ class MemTable {
 
   Env* env_;
 
+  SpinMutex frontiers_mutex_;
   std::unique_ptr<UserFrontiers> frontiers_;
 
   // Returns a heuristic flush decision
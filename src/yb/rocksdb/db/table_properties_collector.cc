@@ -119,4 +119,16 @@ uint64_t GetDeletedKeys(
   return GetVarint64(&raw, &val) ? val : 0;
 }
 
+const std::string kGarbageKeysPropertyName = "rocksdb.garbage.keys";
+
+uint64_t GetGarbageKeys(const UserCollectedProperties& props) {
+  auto pos = props.find(kGarbageKeysPropertyName);
+  if (pos == props.end()) {
+    return 0;
+  }
+  Slice raw = pos->second;
+  uint64_t val = 0;
+  return GetVarint64(&raw, &val) ? val : 0;
+}
+
 }  // namespace rocksdb
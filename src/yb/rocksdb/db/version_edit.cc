@@ -46,6 +46,7 @@ FileMetaData::FileMetaData()
     compensated_file_size(0),
     num_entries(0),
     num_deletions(0),
+    num_garbage_entries(0),
     raw_key_size(0),
     raw_value_size(0),
     init_stats_from_file(false),
@@ -116,6 +116,7 @@ struct FileMetaData {
   // single-threaded LogAndApply thread
   uint64_t num_entries;            // the number of entries.
   uint64_t num_deletions;          // the number of deletion entries.
+  uint64_t num_garbage_entries;    // the number of entries reported by GetGarbageKeys.
   uint64_t raw_key_size;           // total uncompressed key size.
   uint64_t raw_value_size;         // total uncompressed value size.
   bool init_stats_from_file;   // true if the data-entry stats of this file
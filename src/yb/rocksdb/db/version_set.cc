@@ -1046,6 +1046,7 @@ bool Version::MaybeInitializeFileMetaData(FileMetaData* file_meta) {
   if (tp.get() == nullptr) return false;
   file_meta->num_entries = tp->num_entries;
   file_meta->num_deletions = GetDeletedKeys(tp->user_collected_properties);
+  file_meta->num_garbage_entries = GetGarbageKeys(tp->user_collected_properties);
   file_meta->raw_value_size = tp->raw_value_size;
   file_meta->raw_key_size = tp->raw_key_size;
 
@@ -1873,11 +1874,12 @@ void VersionStorageInfo::CalculateBaseBytes(const ImmutableCFOptions& ioptions,
   // Special logic to set number of sorted runs.
   // It is to match the previous behavior when all files are in L0.
   int num_l0_count = 0;
-  if (options.max_file_size_for_compaction == std::numeric_limits<uint64_t>::max()) {
+  if (options.max_file_size_for_compaction == std::numeric_limits<uint64_t>::max() &&
+      !options.exclude_file_from_compaction) {
     num_l0_count = static_cast<int>(files_[0].size());
   } else {
     for (const auto& file : files_[0]) {
-      if (file->fd.GetTotalFileSize() <= options.max_file_size_for_compaction) {
+      if (!options.ExcludeFileFromCompaction(*file)) {
         ++num_l0_count;
       }
     }
@@ -2090,7 +2092,8 @@ VersionSet::VersionSet(const std::string& dbname, const DBOptions* db_options,
       dbname_(dbname),
       db_options_(db_options),
       env_options_(storage_options),
-      env_options_compactions_(env_options_) {}
+      env_options_compactions_(
+          db_options->env->OptimizeForCompactionTableRead(env_options_, *db_options)) {}
 
 VersionSet::~VersionSet() {
   // we need to delete column_family_set_ because its destructor depends on
@@ -2782,7 +2785,8 @@ Status VersionSet::Recover(
 
 Status VersionSet::Import(const std::string& source_dir,
                           SequenceNumber seqno,
-                          VersionEdit* edit) {
+                          VersionEdit* edit,
+                          SequenceNumber* max_imported_seqno) {
   ManifestReader manifest_reader(env_, env_options_, db_options_->boundary_extractor.get(),
                                  source_dir);
   auto status = manifest_reader.OpenManifest();
@@ -2805,7 +2809,9 @@ Status VersionSet::Import(const std::string& source_dir,
       filemeta.largest.user_frontier.reset();
       filemeta.smallest.user_frontier.reset();
       filemeta.imported = true;
-      if (filemeta.largest.seqno >= seqno) {
+      if (max_imported_seqno) {
+        *max_imported_seqno = std::max(*max_imported_seqno, filemeta.largest.seqno);
+      } else if (filemeta.largest.seqno >= seqno) {
         return STATUS_FORMAT(InvalidArgument,
                              "Imported DB contains seqno ($0) greater than active seqno ($1)",
                              filemeta.largest.seqno,
@@ -2823,27 +2829,29 @@ Status VersionSet::Import(const std::string& source_dir,
     return STATUS_FORMAT(NotFound, "Imported DB is empty: $0", source_dir);
   }
 
-  std::vector<LiveFileMetaData> live_files;
-  GetLiveFilesMetaData(&live_files);
-  for (const auto& file : live_files) {
-    segments.emplace_back(file.smallest.seqno, file.largest.seqno);
-  }
+  if (!max_imported_seqno) {
+    std::vector<LiveFileMetaData> live_files;
+    GetLiveFilesMetaData(&live_files);
+    for (const auto& file : live_files) {
+      segments.emplace_back(file.smallest.seqno, file.largest.seqno);
+    }
 
-  std::sort(segments.begin(), segments.end(), [](const auto& lhs, const auto& rhs) {
-    return lhs.first < rhs.first;
-  });
-  auto prev = segments.front();
-  for (size_t i = 1; i != segments.size(); ++i) {
-    const auto& segment = segments[i];
-    if (segment.first <= prev.second) {
-      return STATUS_FORMAT(Corruption,
-                           "Overlapping seqno ranges: [$0, $1] and [$2, $3]",
-                           prev.first,
-                           prev.second,
-                           segment.first,
-                           segment.second);
+    std::sort(segments.begin(), segments.end(), [](const auto& lhs, const auto& rhs) {
+      return lhs.first < rhs.first;
+    });
+    auto prev = segments.front();
+    for (size_t i = 1; i != segments.size(); ++i) {
+      const auto& segment = segments[i];
+      if (segment.first <= prev.second) {
+        return STATUS_FORMAT(Corruption,
+                             "Overlapping seqno ranges: [$0, $1] and [$2, $3]",
+                             prev.first,
+                             prev.second,
+                             segment.first,
+                             segment.second);
+      }
+      prev = segment;
     }
-    prev = segment;
   }
 
   std::vector<std::string> revert_list;
@@ -3482,7 +3490,7 @@ InternalIterator* VersionSet::MakeInputIterator(Compaction* c) {
         // Create concatenating iterator for the files from this level
         list[num++] = NewTwoLevelIterator(
             new LevelFileIteratorState(
-                cfd->table_cache(), read_options, env_options_,
+                cfd->table_cache(), read_options, env_options_compactions_,
                 cfd->internal_comparator(),
                 nullptr /* no per level latency histogram */,
                 true /* for_compaction */, false /* prefix enabled */,
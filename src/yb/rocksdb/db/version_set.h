@@ -746,7 +746,10 @@ class VersionSet {
   ColumnFamilySet* GetColumnFamilySet() { return column_family_set_.get(); }
   const EnvOptions& env_options() { return env_options_; }
 
-  CHECKED_STATUS Import(const std::string& source_dir, SequenceNumber seqno, VersionEdit* edit);
+  // When 'max_imported_seqno' is specified, sequence numbers of the imported files are not checked
+  // against 'seqno' and the live files, and the largest of them is stored there instead.
+  CHECKED_STATUS Import(const std::string& source_dir, SequenceNumber seqno, VersionEdit* edit,
+                        SequenceNumber* max_imported_seqno = nullptr);
 
   static uint64_t GetNumLiveVersions(Version* dummy_versions);
 
@@ -389,6 +389,21 @@ void WriteThread::ExitAsBatchGroupLeader(Writer* leader, Writer* last_writer,
                                          Status status) {
   assert(leader->link_older == nullptr);
 
+  HandOffLeadership(last_writer);
+
+  while (last_writer != leader) {
+    last_writer->status = status;
+    // we need to read link_older before calling SetState, because as soon
+    // as it is marked committed the other thread's Await may return and
+    // deallocate the Writer.
+    auto next = last_writer->link_older;
+    SetState(last_writer, STATE_COMPLETED);
+
+    last_writer = next;
+  }
+}
+
+void WriteThread::HandOffLeadership(Writer* last_writer) {
   Writer* head = newest_writer_.load(std::memory_order_acquire);
   if (head != last_writer ||
       !newest_writer_.compare_exchange_strong(head, nullptr)) {
@@ -420,17 +435,6 @@ void WriteThread::ExitAsBatchGroupLeader(Writer* leader, Writer* last_writer,
   }
   // else nobody else was waiting, although there might already be a new
   // leader now
-
-  while (last_writer != leader) {
-    last_writer->status = status;
-    // we need to read link_older before calling SetState, because as soon
-    // as it is marked committed the other thread's Await may return and
-    // deallocate the Writer.
-    auto next = last_writer->link_older;
-    SetState(last_writer, STATE_COMPLETED);
-
-    last_writer = next;
-  }
 }
 
 void WriteThread::EnterUnbatched(Writer* w, InstrumentedMutex* mu) {
@@ -445,6 +449,8 @@ void WriteThread::EnterUnbatched(Writer* w, InstrumentedMutex* mu) {
     AwaitState(w, STATE_GROUP_LEADER, &ctx);
     mu->Lock();
   }
+  // Unbatched writer expects that nobody else is writing to memtable.
+  WaitForPipelinedGroups();
 }
 
 void WriteThread::ExitUnbatched(Writer* w) {
@@ -452,4 +458,69 @@ void WriteThread::ExitUnbatched(Writer* w) {
   ExitAsBatchGroupLeader(w, w, dummy_status);
 }
 
+void WriteThread::LaunchPipelinedGroup(ParallelGroup* pg, SequenceNumber sequence) {
+  assert(pg->leader->link_older == nullptr);
+  pg->pipelined = true;
+  pg->pipelined_done = false;
+  {
+    std::lock_guard<std::mutex> lock(pipelined_mutex_);
+    pipelined_groups_.push_back(pg);
+  }
+  LaunchParallelFollowers(pg, sequence);
+  // Members of the group are not linked to newer writers after that, so their links are only
+  // used to wake them up in CompletePipelinedGroup.
+  HandOffLeadership(pg->last_writer);
+}
+
+void WriteThread::CompletePipelinedWorker(
+    Writer* w, const std::function<void(SequenceNumber)>& publish_sequence) {
+  static AdaptationContext ctx("CompletePipelinedWorker");
+
+  auto* pg = w->parallel_group;
+  assert(pg->pipelined);
+  if (!w->status.ok()) {
+    std::lock_guard<std::mutex> lock(pipelined_mutex_);
+    if (pg->status.ok()) {
+      pg->status = w->status;
+    }
+  }
+
+  if (pg->running.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    // We're the last worker of the group, pg could be destroyed as soon as its leader is woken up.
+    std::lock_guard<std::mutex> lock(pipelined_mutex_);
+    pg->pipelined_done = true;
+    while (!pipelined_groups_.empty() && pipelined_groups_.front()->pipelined_done) {
+      auto* group = pipelined_groups_.front();
+      pipelined_groups_.pop_front();
+      publish_sequence(group->last_sequence);
+      CompletePipelinedGroup(group);
+    }
+    if (pipelined_groups_.empty()) {
+      pipelined_cv_.notify_all();
+    }
+  }
+
+  AwaitState(w, STATE_COMPLETED, &ctx);
+}
+
+void WriteThread::CompletePipelinedGroup(ParallelGroup* pg) {
+  Writer* leader = pg->leader;
+  Writer* w = pg->last_writer;
+  Status status = pg->status;
+  while (w != leader) {
+    w->status = status;
+    // Read link_older before SetState, the Writer could be deallocated right after it.
+    auto next = w->link_older;
+    SetState(w, STATE_COMPLETED);
+    w = next;
+  }
+  leader->status = status;
+  SetState(leader, STATE_COMPLETED);
+}
+
+void WriteThread::WaitForPipelinedGroups() {
+  std::unique_lock<std::mutex> lock(pipelined_mutex_);
+  pipelined_cv_.wait(lock, [this] { return pipelined_groups_.empty(); });
+}
+
 }  // namespace rocksdb
@@ -28,6 +28,8 @@
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <deque>
+#include <functional>
 #include <mutex>
 #include <vector>
 #include <type_traits>
@@ -90,6 +92,12 @@ class WriteThread {
     // before running goes to zero, status needs leader->StateMutex()
     Status status;
     std::atomic<uint32_t> running;
+    // The group was launched with LaunchPipelinedGroup, so its leader does not wait for it
+    // before handing off leadership, see DBOptions::enable_pipelined_write.
+    bool pipelined = false;
+    // All workers of pipelined group have completed their memtable inserts, protected by
+    // pipelined_mutex_.
+    bool pipelined_done = false;
   };
 
   // Information kept for every waiting writer.
@@ -259,6 +267,26 @@ class WriteThread {
   // writers.
   void ExitUnbatched(Writer* w);
 
+  // Same as LaunchParallelFollowers, but also hands off leadership to the next writer, so the
+  // next write batch group could be formed while this group is inserting into memtable.
+  // Workers of the group, including the leader, should call CompletePipelinedWorker after their
+  // memtable insert. Groups are completed in the order they were launched.
+  //
+  // REQUIRES: pg->last_sequence is the last sequence allocated to the group, and all earlier
+  // allocated sequences belong to groups that were launched before.
+  void LaunchPipelinedGroup(ParallelGroup* pg, SequenceNumber sequence);
+
+  // Reports the completion of w's batch and waits until its group and all groups launched
+  // before it are complete. The last worker to complete a group publishes the last sequence of
+  // every group that became complete, invoking publish_sequence in order of launch.
+  void CompletePipelinedWorker(
+      Writer* w, const std::function<void(SequenceNumber)>& publish_sequence);
+
+  // Waits until all pipelined groups are complete. Should be invoked by the leader before it
+  // modifies state that the memtable inserts of previous groups rely on, i.e. switches memtable.
+  // EnterUnbatched does it automatically.
+  void WaitForPipelinedGroups();
+
   struct AdaptationContext {
     const char* name;
     std::atomic<int32_t> value;
@@ -274,6 +302,17 @@ class WriteThread {
   // elements, adding can be done lock-free by anybody
   std::atomic<Writer*> newest_writer_;
 
+  // Pipelined groups that are not complete yet, in order of launch.
+  std::mutex pipelined_mutex_;
+  std::condition_variable pipelined_cv_;
+  std::deque<ParallelGroup*> pipelined_groups_;
+
+  // Unlinks the Writer-s up to last_writer from the list and wakes up the next leader (if any).
+  void HandOffLeadership(Writer* last_writer);
+
+  // Wakes up all Writer-s of the completed pipelined group, the leader is woken up last.
+  void CompletePipelinedGroup(ParallelGroup* pg);
+
   // Waits for w->state & goal_mask using w->StateMutex().  Returns
   // the state that satisfies goal_mask.
   uint8_t BlockingAwaitState(Writer* w, uint8_t goal_mask);
@@ -104,6 +104,15 @@ struct EnvOptions {
   // If true, then use mmap to write data
   bool use_mmap_writes = true;
 
+  // If true, then read data with direct I/O, bypassing the OS page cache.
+  // Reads of any offset and size are done through an aligned buffer.
+  bool use_direct_reads = false;
+
+  // If true, then write data with direct I/O, bypassing the OS page cache.
+  // The file is written through WritableFileWriter, which only writes whole
+  // aligned pages with PositionedAppend().
+  bool use_direct_writes = false;
+
   // If false, fallocate() calls are bypassed
   bool allow_fallocate = true;
 
@@ -303,6 +312,14 @@ class Env {
                         Priority pri = LOW, void* tag = nullptr,
                         void (*unschedFunction)(void* arg) = 0) = 0;
 
+  // Same as Schedule(), but queued work with a higher score runs first, and work with the same
+  // score runs in the order it was scheduled. Schedule() uses zero score. Environments that do
+  // not support scores just Schedule() the work.
+  virtual void ScheduleWithScore(void (*function)(void* arg), void* arg, Priority pri,
+                                 void* tag, void (*unschedFunction)(void* arg), double score) {
+    Schedule(function, arg, pri, tag, unschedFunction);
+  }
+
   // Arrange to remove jobs for given arg from the queue_ if they are not
   // already scheduled. Caller is expected to have exclusive lock on arg.
   virtual int UnSchedule(void* arg, Priority pri) { return 0; }
@@ -385,6 +402,18 @@ class Env {
   virtual EnvOptions OptimizeForManifestWrite(const EnvOptions& env_options)
       const;
 
+  // OptimizeForCompactionTableWrite will create a new EnvOptions object that
+  // is a copy of the EnvOptions in the parameters, but is optimized for
+  // writing table files by compaction.
+  virtual EnvOptions OptimizeForCompactionTableWrite(
+      const EnvOptions& env_options, const DBOptions& db_options) const;
+
+  // OptimizeForCompactionTableRead will create a new EnvOptions object that
+  // is a copy of the EnvOptions in the parameters, but is optimized for
+  // reading table files by compaction.
+  virtual EnvOptions OptimizeForCompactionTableRead(
+      const EnvOptions& env_options, const DBOptions& db_options) const;
+
   // Returns the status of all threads that belong to the current Env.
   virtual Status GetThreadList(std::vector<ThreadStatus>* thread_list) {
     return STATUS(NotSupported, "Not supported.");
@@ -487,6 +516,12 @@ class RandomAccessFile : public File {
 
   virtual void Hint(AccessPattern pattern) {}
 
+  // Asynchronously read "n" bytes of the file starting at "offset" ahead of time, so that later
+  // reads of the range do not wait for the disk. Returns NotSupported if the file cannot prefetch.
+  virtual Status Prefetch(uint64_t offset, size_t n) {
+    return STATUS(NotSupported, "Prefetch not supported.");
+  }
+
   // Remove any kind of caching of data from the offset to offset+length
   // of this file. If the length is 0, then it refers to the end of file.
   // If the system is not caching the file contents, then this is a noop.
@@ -929,6 +964,11 @@ class EnvWrapper : public Env {
     return target_->Schedule(f, a, pri, tag, u);
   }
 
+  void ScheduleWithScore(void (*f)(void* arg), void* a, Priority pri, void* tag,
+                         void (*u)(void* arg), double score) override {
+    return target_->ScheduleWithScore(f, a, pri, tag, u, score);
+  }
+
   int UnSchedule(void* tag, Priority pri) override {
     return target_->UnSchedule(tag, pri);
   }
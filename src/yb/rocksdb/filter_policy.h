@@ -42,6 +42,17 @@
 
 namespace rocksdb {
 
+// Format of bits produced by builtin full and fixed size filter builders. Builtin readers detect
+// format from the filter contents, so the format could be changed without changing policy name.
+enum class FilterBitsFormat {
+  // Cache line blocked Bloom filter.
+  kBloom,
+
+  // Ribbon filter, takes ~25% less space than Bloom filter with the same false positive rate,
+  // but is slower to build.
+  kRibbon,
+};
+
 // A class that takes a bunch of keys, then generates filter
 class FilterBitsBuilder {
  public:
@@ -201,9 +212,18 @@ extern const FilterPolicy* NewBloomFilterPolicy(int bits_per_key,
 //
 // Callers must delete the result after any database that is using the filter policy has been
 // closed.
+//
+// format: format of filter blocks built by this policy, filter blocks of any format could be read.
 extern const FilterPolicy* NewFixedSizeFilterPolicy(uint32_t total_bits,
                                                     double error_rate,
-                                                    Logger* logger);
+                                                    Logger* logger,
+                                                    FilterBitsFormat format =
+                                                        FilterBitsFormat::kBloom);
+
+// Return a new filter policy that uses a full ribbon filter with false positive rate of bloom
+// filter with the specified number of bits per key. Uses the same name as the full filter created
+// by NewBloomFilterPolicy, so tables built with any of those policies are readable by both.
+extern const FilterPolicy* NewRibbonFilterPolicy(int bits_per_key);
 }  // namespace rocksdb
 
 #endif  // YB_ROCKSDB_FILTER_POLICY_H
@@ -74,6 +74,8 @@ enum class CompactionReason {
   kManualCompaction,
   // DB::SuggestCompactRange() marked files for compaction
   kFilesMarkedForCompaction,
+  // [Universal] Garbage ratio of a file >= garbage_ratio_threshold
+  kUniversalGarbageRatio,
 };
 
 #ifndef ROCKSDB_LITE
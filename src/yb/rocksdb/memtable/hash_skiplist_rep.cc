@@ -352,5 +352,13 @@ MemTableRepFactory* NewHashSkipListRepFactory(
       skiplist_branching_factor);
 }
 
+MemTableRepFactory* NewHashSkipListRepFactory(
+    std::shared_ptr<const SliceTransform> prefix_extractor,
+    size_t bucket_count, int32_t skiplist_height,
+    int32_t skiplist_branching_factor) {
+  return new HashSkipListRepFactory(bucket_count, skiplist_height,
+      skiplist_branching_factor, std::move(prefix_extractor));
+}
+
 } // namespace rocksdb
 #endif  // ROCKSDB_LITE
@@ -33,10 +33,12 @@ class HashSkipListRepFactory : public MemTableRepFactory {
   explicit HashSkipListRepFactory(
     size_t bucket_count,
     int32_t skiplist_height,
-    int32_t skiplist_branching_factor)
+    int32_t skiplist_branching_factor,
+    std::shared_ptr<const SliceTransform> prefix_extractor = nullptr)
       : bucket_count_(bucket_count),
         skiplist_height_(skiplist_height),
-        skiplist_branching_factor_(skiplist_branching_factor) { }
+        skiplist_branching_factor_(skiplist_branching_factor),
+        prefix_extractor_(std::move(prefix_extractor)) { }
 
   virtual ~HashSkipListRepFactory() {}
 
@@ -48,10 +50,15 @@ class HashSkipListRepFactory : public MemTableRepFactory {
     return "HashSkipListRepFactory";
   }
 
+  const SliceTransform* PrefixExtractor() const override {
+    return prefix_extractor_.get();
+  }
+
  private:
   const size_t bucket_count_;
   const int32_t skiplist_height_;
   const int32_t skiplist_branching_factor_;
+  const std::shared_ptr<const SliceTransform> prefix_extractor_;
 };
 
 }
@@ -228,6 +228,13 @@ class MemTableRepFactory {
   // Return true if the current MemTableRep supports concurrent inserts
   // Default: false
   virtual bool IsInsertConcurrentlySupported() const { return false; }
+
+  // Prefix extractor used by memtables created by this factory instead of
+  // options.prefix_extractor, so memtable could be hash indexed without prefix
+  // semantics for reads from SST files. Such memtable is iterated in prefix mode
+  // only when ReadOptions::prefix_same_as_start is set.
+  // Default: nullptr, i.e. options.prefix_extractor is used.
+  virtual const SliceTransform* PrefixExtractor() const { return nullptr; }
 };
 
 // This uses a skip list to store keys. It is the default.
@@ -287,6 +294,15 @@ extern MemTableRepFactory* NewHashSkipListRepFactory(
     int32_t skiplist_branching_factor = 4
 );
 
+// The same as above, but memtables are hashed by prefixes produced by
+// prefix_extractor instead of options.prefix_extractor,
+// see MemTableRepFactory::PrefixExtractor.
+extern MemTableRepFactory* NewHashSkipListRepFactory(
+    std::shared_ptr<const SliceTransform> prefix_extractor,
+    size_t bucket_count, int32_t skiplist_height = 4,
+    int32_t skiplist_branching_factor = 4
+);
+
 // The factory is to create memtables based on a hash table:
 // it contains a fixed array of buckets, each pointing to either a linked list
 // or a skip list if number of entries inside the bucket exceeds
@@ -26,6 +26,7 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <functional>
 #include <string>
 #include <memory>
 #include <vector>
@@ -67,6 +68,7 @@ class Statistics;
 class InternalKeyComparator;
 class WalFilter;
 class MemoryMonitor;
+struct FileMetaData;
 
 typedef std::shared_ptr<const InternalKeyComparator> InternalKeyComparatorPtr;
 
@@ -158,9 +160,21 @@ struct CompressionOptions {
   int window_bits;
   int level;
   int strategy;
-  CompressionOptions() : window_bits(-14), level(-1), strategy(0) {}
-  CompressionOptions(int wbits, int _lev, int _strategy)
-      : window_bits(wbits), level(_lev), strategy(_strategy) {}
+  // Maximum size of the dictionary that is shared by data blocks of an SST file. Every table
+  // builder collects its first data blocks as samples, builds the dictionary from them and stores
+  // it in a meta block, so it is loaded once with the table reader. Supported by zlib, LZ4 and
+  // ZSTD compression, 0 disables dictionaries.
+  uint32_t max_dict_bytes;
+  // Size of samples the dictionary is built from. With ZSTD the dictionary is trained on them,
+  // for other compression types samples are used as a raw dictionary. 0 means 100 times
+  // max_dict_bytes, as recommended for ZSTD dictionary training.
+  uint32_t max_train_bytes;
+  CompressionOptions()
+      : window_bits(-14), level(-1), strategy(0), max_dict_bytes(0), max_train_bytes(0) {}
+  CompressionOptions(int wbits, int _lev, int _strategy, uint32_t _max_dict_bytes = 0,
+                     uint32_t _max_train_bytes = 0)
+      : window_bits(wbits), level(_lev), strategy(_strategy), max_dict_bytes(_max_dict_bytes),
+        max_train_bytes(_max_train_bytes) {}
 };
 
 enum UpdateStatus {    // Return status For inplace update callback
@@ -754,6 +768,13 @@ struct ColumnFamilyOptions {
   // Dynamically changeable through SetOptions() API
   size_t memtable_prefix_bloom_huge_page_tlb_size;
 
+  // Page size for huge page TLB for memtable arena blocks. If 0, arena blocks are allocated
+  // through malloc. When huge pages could not be allocated, e.g. not enough of them are reserved,
+  // arena falls back to malloc.
+  //
+  // Dynamically changeable through SetOptions() API
+  size_t memtable_huge_page_size;
+
   // Control locality of bloom filter probes to improve cache miss rate.
   // This option only applies to memtable prefix bloom and plaintable
   // prefix bloom. It essentially limits every bloom checking to one cache line.
@@ -1153,6 +1174,18 @@ struct DBOptions {
   // Default: 0
   size_t compaction_readahead_size;
 
+  // If true, compaction reads its input files and writes its output files
+  // with direct I/O, bypassing the OS page cache, so that compactions do not
+  // evict the pages of the files that user reads rely on. User reads keep
+  // using buffered I/O.
+  //
+  // When true, we also force new_table_reader_for_compaction_inputs to true,
+  // and compaction_readahead_size to be non-zero, because each direct read
+  // goes to the storage device.
+  //
+  // Default: false
+  bool use_direct_io_for_compaction;
+
   // This is a maximum buffer size that is used by WinMmapReadableFile in
   // unbuffered disk I/O mode. We need to maintain an aligned buffer for
   // reads. We allow the buffer to grow until the specified value and then
@@ -1251,6 +1284,27 @@ struct DBOptions {
   // Default: false
   bool enable_write_thread_adaptive_yield;
 
+  // If true, the leader of a write batch group hands off leadership to the next writer as soon
+  // as the group is written to WAL and sequence numbers are assigned, so the next group could be
+  // formed while memtable inserts of this group are still running. Writers of the group insert
+  // their batches into memtable in parallel, and a write completes when all groups up to its own
+  // are inserted, so sequence numbers become visible in order.
+  //
+  // Requires allow_concurrent_memtable_write, ignored otherwise. Groups that sync WAL or contain
+  // merges are not pipelined.
+  //
+  // Default: false
+  bool enable_pipelined_write;
+
+  // Maximum number of iterators over the default column family kept by the DB for reuse. Iterators
+  // created without snapshot, upper bound and file filters are put back to the pool when deleted,
+  // and reused by the next iterator with the same read options while no flush or compaction
+  // changed the set of memtables and files they read. It saves referencing the super version and
+  // building the merging iterator for short reads.
+  //
+  // Default: 0, i.e. iterators are not pooled
+  size_t iterator_pool_size;
+
   // The maximum number of microseconds that a write operation will use
   // a yielding spin loop to coordinate with other write threads before
   // blocking on a mutex.  (Assuming write_thread_slow_yield_usec is
@@ -1314,6 +1368,12 @@ struct DBOptions {
   // Max file size for compaction. Supported only for level0 of universal style compactions.
   uint64_t max_file_size_for_compaction = std::numeric_limits<uint64_t>::max();
 
+  // Returns true for files that should not be picked by automatic compactions, e.g. files that
+  // hold only immutable history. Such files split level0 into separately compacted sequences, in
+  // the same way as files larger than max_file_size_for_compaction.
+  // Supported only for level0 of universal style compactions.
+  std::shared_ptr<std::function<bool(const FileMetaData&)>> exclude_file_from_compaction;
+
   // Invoked after memtable switched.
   std::shared_ptr<std::function<MemTableFilter()>> mem_table_flush_filter_factory;
 };
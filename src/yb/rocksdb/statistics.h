@@ -70,6 +70,8 @@ enum Tickers : uint32_t {
   BLOOM_FILTER_USEFUL,
   // # of times bloom filter has been checked.
   BLOOM_FILTER_CHECKED,
+  // # of times bloom filter has been checked, but has not avoided file reads.
+  BLOOM_FILTER_USELESS,
 
   // # of memtable hits.
   MEMTABLE_HIT,
@@ -205,6 +207,10 @@ enum Tickers : uint32_t {
   BLOCK_CACHE_MULTI_TOUCH_BYTES_READ,
   BLOCK_CACHE_MULTI_TOUCH_BYTES_WRITE,
 
+  // Secondary block cache statistics.
+  BLOCK_CACHE_SECONDARY_MISS,
+  BLOCK_CACHE_SECONDARY_HIT,
+
   // End of ticker enum.
   TICKER_ENUM_MAX,
 };
@@ -226,6 +232,7 @@ const std::vector<std::pair<Tickers, std::string>> TickersNameMap = {
     {BLOCK_CACHE_BYTES_WRITE, "rocksdb_block_cache_bytes_write"},
     {BLOOM_FILTER_USEFUL, "rocksdb_bloom_filter_useful"},
     {BLOOM_FILTER_CHECKED, "rocksdb_bloom_filter_checked"},
+    {BLOOM_FILTER_USELESS, "rocksdb_bloom_filter_useless"},
     {MEMTABLE_HIT, "rocksdb_memtable_hit"},
     {MEMTABLE_MISS, "rocksdb_memtable_miss"},
     {GET_HIT_L0, "rocksdb_l0_hit"},
@@ -298,7 +305,9 @@ const std::vector<std::pair<Tickers, std::string>> TickersNameMap = {
     {BLOCK_CACHE_MULTI_TOUCH_HIT, "rocksdb_block_cache_multi_touch_hit"},
     {BLOCK_CACHE_MULTI_TOUCH_ADD, "rocksdb_block_cache_multi_touch_add"},
     {BLOCK_CACHE_MULTI_TOUCH_BYTES_READ, "rocksdb_block_cache_multi_touch_bytes_read"},
-    {BLOCK_CACHE_MULTI_TOUCH_BYTES_WRITE, "rocksdb_block_cache_multi_touch_bytes_write"}
+    {BLOCK_CACHE_MULTI_TOUCH_BYTES_WRITE, "rocksdb_block_cache_multi_touch_bytes_write"},
+    {BLOCK_CACHE_SECONDARY_MISS, "rocksdb_block_cache_secondary_miss"},
+    {BLOCK_CACHE_SECONDARY_HIT, "rocksdb_block_cache_secondary_hit"}
 };
 
 /**
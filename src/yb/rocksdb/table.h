@@ -35,6 +35,7 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "yb/rocksdb/env.h"
 #include "yb/rocksdb/iterator.h"
@@ -79,6 +80,20 @@ YB_DEFINE_ENUM(IndexType,
   (kMultiLevelBinarySearch)
 );
 
+// Format of keys in data blocks. Index blocks always use kKeyDeltaEncodingSharedPrefix.
+YB_DEFINE_ENUM(KeyValueEncodingFormat,
+  // Key is stored as the number of bytes shared with the previous key and the remaining bytes.
+  (kKeyDeltaEncodingSharedPrefix)
+
+  // Key is stored as the shared prefix, non shared middle part and the suffix of the user key
+  // shared with the previous key. When both keys are long enough, the last 8 bytes (the internal
+  // key trailer) are stored as a varint delta to the trailer of the previous key.
+  // DocDB keys repeat the encoded DocKey and often the DocHybridTime of the previous key, while
+  // sequence numbers of neighbour keys are close to each other, so such keys are mostly reduced
+  // to the subkey that differs.
+  (kKeyDeltaEncodingThreeSharedParts)
+);
+
 // For advanced user only
 struct BlockBasedTableOptions {
   // @flush_block_policy_factory creates the instances of flush block policy.
@@ -97,6 +112,11 @@ struct BlockBasedTableOptions {
   // Note: Fixed-size bloom filter data blocks are never pre-loaded.
   bool cache_index_and_filter_blocks = false;
 
+  // If cache_index_and_filter_blocks is enabled, index and filter blocks are inserted directly
+  // into the multi touch part of the block cache, so single touch scan data does not evict them.
+  // Fixed-size filter blocks and blocks of multi-level index are also inserted this way.
+  bool cache_index_and_filter_blocks_with_high_priority = false;
+
   IndexType index_type = IndexType::kMultiLevelBinarySearch;
 
   // Influence the behavior when kHashSearch is used.
@@ -123,6 +143,10 @@ struct BlockBasedTableOptions {
   // If NULL, rocksdb will not use a compressed block cache.
   std::shared_ptr<Cache> block_cache_compressed = nullptr;
 
+  // If non-NULL and block_cache is set, use the specified cache as a second tier of block_cache.
+  // Uncompressed blocks that miss block_cache are looked up there before reading them from file.
+  std::shared_ptr<SecondaryBlockCache> secondary_block_cache = nullptr;
+
   // Approximate size of user data packed per block, in bytes. Note that the
   // block size specified here corresponds to uncompressed data.  The
   // actual size of the unit read from disk may be smaller if
@@ -163,6 +187,11 @@ struct BlockBasedTableOptions {
   // Default: true
   bool use_delta_encoding = true;
 
+  // Format of keys in data blocks, stored in table properties, so the reader does not depend on
+  // this option.
+  KeyValueEncodingFormat data_block_key_value_encoding_format =
+      KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix;
+
   // If non-nullptr, use the specified filter policy to reduce disk reads.
   // Many applications will benefit from passing the result of
   // NewBloomFilterPolicy() here.
@@ -209,10 +238,14 @@ struct BlockBasedTablePropertyNames {
   static const char kIndexType[];
   // number of index levels for multi-level index, int32.
   static const char kNumIndexLevels[];
+  // number of levels for multi-level fixed-size filter index, int32.
+  static const char kNumFilterIndexLevels[];
   // value is "1" for true and "0" for false.
   static const char kWholeKeyFiltering[];
   // value is "1" for true and "0" for false.
   static const char kPrefixFiltering[];
+  // format of keys in data blocks, fixed int32 number.
+  static const char kDataBlockKeyValueEncodingFormat[];
 };
 
 // Create default block based table factory.
@@ -481,6 +514,13 @@ class TableFactory {
   // DocDbAwareFilterPolicy and HashedComponentsExtractor.
   virtual std::shared_ptr<TableAwareReadFileFilter> NewTableAwareReadFileFilter(
       const ReadOptions &read_options, const Slice &user_key) const { return nullptr; }
+
+  // Same as above for a batch of point reads: prunes out files which don't contain some part of
+  // any of user_keys.
+  virtual std::shared_ptr<TableAwareReadFileFilter> NewTableAwareReadFileFilter(
+      const ReadOptions &read_options, const std::vector<Slice>& user_keys) const {
+    return nullptr;
+  }
 };
 
 #ifndef ROCKSDB_LITE
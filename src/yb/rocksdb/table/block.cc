@@ -70,6 +70,38 @@ static inline const char* DecodeEntry(const char* p, const char* limit,
   return p;
 }
 
+// Same as DecodeEntry, but for kKeyDeltaEncodingThreeSharedParts, also decodes "*suffix_info"
+// and "*trailer_delta" (when it is present).
+static inline const char* DecodeEntryThreeSharedParts(const char* p, const char* limit,
+                                                      uint32_t* shared_prefix,
+                                                      uint32_t* non_shared,
+                                                      uint32_t* value_length,
+                                                      uint32_t* suffix_info,
+                                                      uint64_t* trailer_delta) {
+  if (limit - p < 4) return nullptr;
+  *shared_prefix = reinterpret_cast<const unsigned char*>(p)[0];
+  *non_shared = reinterpret_cast<const unsigned char*>(p)[1];
+  *value_length = reinterpret_cast<const unsigned char*>(p)[2];
+  *suffix_info = reinterpret_cast<const unsigned char*>(p)[3];
+  if ((*shared_prefix | *non_shared | *value_length | *suffix_info) < 128) {
+    // Fast path: all four values are encoded in one byte each
+    p += 4;
+  } else {
+    if ((p = GetVarint32Ptr(p, limit, shared_prefix)) == nullptr) return nullptr;
+    if ((p = GetVarint32Ptr(p, limit, non_shared)) == nullptr) return nullptr;
+    if ((p = GetVarint32Ptr(p, limit, value_length)) == nullptr) return nullptr;
+    if ((p = GetVarint32Ptr(p, limit, suffix_info)) == nullptr) return nullptr;
+  }
+  if (*suffix_info & 1) {
+    if ((p = GetVarint64Ptr(p, limit, trailer_delta)) == nullptr) return nullptr;
+  }
+
+  if (static_cast<uint32_t>(limit - p) < (*non_shared + *value_length)) {
+    return nullptr;
+  }
+  return p;
+}
+
 void BlockIter::Next() {
   assert(Valid());
   ParseNextKey();
@@ -98,11 +130,13 @@ void BlockIter::Prev() {
 
 void BlockIter::Initialize(const Comparator* comparator, const char* data,
                            uint32_t restarts, uint32_t num_restarts, BlockHashIndex* hash_index,
-                           BlockPrefixIndex* prefix_index) {
+                           BlockPrefixIndex* prefix_index,
+                           KeyValueEncodingFormat key_value_encoding_format) {
   DCHECK(data_ == nullptr); // Ensure it is called only once
   DCHECK_GT(num_restarts, 0); // Ensure the param is valid
 
   comparator_ = comparator;
+  key_value_encoding_format_ = key_value_encoding_format;
   data_ = data;
   restarts_ = restarts;
   num_restarts_ = num_restarts;
@@ -178,27 +212,95 @@ bool BlockIter::ParseNextKey() {
   }
 
   // Decode next entry
+  bool ok = false;
+  switch (key_value_encoding_format_) {
+    case KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix:
+      ok = ParseSharedPrefixEntry(p, limit);
+      break;
+    case KeyValueEncodingFormat::kKeyDeltaEncodingThreeSharedParts:
+      ok = ParseThreeSharedPartsEntry(p, limit);
+      break;
+  }
+  if (!ok) {
+    CorruptionError();
+    return false;
+  }
+  while (restart_index_ + 1 < num_restarts_ &&
+         GetRestartPoint(restart_index_ + 1) < current_) {
+    ++restart_index_;
+  }
+  return true;
+}
+
+bool BlockIter::ParseSharedPrefixEntry(const char* p, const char* limit) {
   uint32_t shared, non_shared, value_length;
   p = DecodeEntry(p, limit, &shared, &non_shared, &value_length);
   if (p == nullptr || key_.Size() < shared) {
-    CorruptionError();
     return false;
+  }
+  if (shared == 0) {
+    // If this key dont share any bytes with prev key then we dont need
+    // to decode it and can use it's address in the block directly.
+    key_.SetKey(Slice(p, non_shared), false /* copy */);
   } else {
-    if (shared == 0) {
-      // If this key dont share any bytes with prev key then we dont need
-      // to decode it and can use it's address in the block directly.
-      key_.SetKey(Slice(p, non_shared), false /* copy */);
-    } else {
-      // This key share `shared` bytes with prev key, we need to decode it
-      key_.TrimAppend(shared, p, non_shared);
+    // This key share `shared` bytes with prev key, we need to decode it
+    key_.TrimAppend(shared, p, non_shared);
+  }
+  value_ = Slice(p + non_shared, value_length);
+  return true;
+}
+
+bool BlockIter::ParseThreeSharedPartsEntry(const char* p, const char* limit) {
+  uint32_t shared_prefix, non_shared, value_length, suffix_info;
+  uint64_t trailer_delta = 0;
+  p = DecodeEntryThreeSharedParts(
+      p, limit, &shared_prefix, &non_shared, &value_length, &suffix_info, &trailer_delta);
+  if (p == nullptr) {
+    return false;
+  }
+  if (shared_prefix == 0 && suffix_info == 0) {
+    // Key does not depend on the previous key, so use its address in the block directly.
+    key_.SetKey(Slice(p, non_shared), false /* copy */);
+  } else {
+    const size_t trailer_size = (suffix_info & 1) ? sizeof(uint64_t) : 0;
+    const size_t shared_suffix = suffix_info >> 1;
+    const size_t last_key_size = key_.Size();
+    if (last_key_size < trailer_size ||
+        last_key_size - trailer_size < shared_prefix + shared_suffix) {
+      return false;
     }
-    value_ = Slice(p + non_shared, value_length);
-    while (restart_index_ + 1 < num_restarts_ &&
-           GetRestartPoint(restart_index_ + 1) < current_) {
-      ++restart_index_;
+    const size_t last_user_key_size = last_key_size - trailer_size;
+    // Trailer is restored before the key is updated, since it depends on the previous trailer.
+    char trailer[sizeof(uint64_t)];
+    if (trailer_size) {
+      const uint64_t last_trailer = DecodeFixed64(key_.GetKey().cdata() + last_user_key_size);
+      EncodeFixed64(trailer, last_trailer + static_cast<uint64_t>(ZigZagDecode64(trailer_delta)));
+    }
+    key_.TrimAppendWithSuffix(
+        shared_prefix, p, non_shared, last_user_key_size - shared_suffix, shared_suffix,
+        trailer, trailer_size);
+  }
+  value_ = Slice(p + non_shared, value_length);
+  return true;
+}
+
+const char* BlockIter::DecodeRestartKey(uint32_t restart_index, uint32_t* key_size) const {
+  const char* p = data_ + GetRestartPoint(restart_index);
+  const char* limit = data_ + restarts_;
+  uint32_t shared, value_length;
+  switch (key_value_encoding_format_) {
+    case KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix:
+      p = DecodeEntry(p, limit, &shared, key_size, &value_length);
+      return p == nullptr || shared != 0 ? nullptr : p;
+    case KeyValueEncodingFormat::kKeyDeltaEncodingThreeSharedParts: {
+      uint32_t suffix_info;
+      uint64_t trailer_delta;
+      p = DecodeEntryThreeSharedParts(
+          p, limit, &shared, key_size, &value_length, &suffix_info, &trailer_delta);
+      return p == nullptr || shared != 0 || suffix_info != 0 ? nullptr : p;
     }
-    return true;
   }
+  FATAL_INVALID_ENUM_VALUE(KeyValueEncodingFormat, key_value_encoding_format_);
 }
 
 // Binary search in restart array to find the first restart point
@@ -209,16 +311,13 @@ bool BlockIter::BinarySeek(const Slice& target, uint32_t left, uint32_t right,
 
   while (left < right) {
     uint32_t mid = (left + right + 1) / 2;
-    uint32_t region_offset = GetRestartPoint(mid);
-    uint32_t shared, non_shared, value_length;
-    const char* key_ptr =
-        DecodeEntry(data_ + region_offset, data_ + restarts_, &shared,
-                    &non_shared, &value_length);
-    if (key_ptr == nullptr || (shared != 0)) {
+    uint32_t key_size;
+    const char* key_ptr = DecodeRestartKey(mid, &key_size);
+    if (key_ptr == nullptr) {
       CorruptionError();
       return false;
     }
-    Slice mid_key(key_ptr, non_shared);
+    Slice mid_key(key_ptr, key_size);
     int cmp = Compare(mid_key, target);
     if (cmp < 0) {
       // Key at "mid" is smaller than "target". Therefore all
@@ -240,15 +339,13 @@ bool BlockIter::BinarySeek(const Slice& target, uint32_t left, uint32_t right,
 // Compare target key and the block key of the block of `block_index`.
 // Return -1 if error.
 int BlockIter::CompareBlockKey(uint32_t block_index, const Slice& target) {
-  uint32_t region_offset = GetRestartPoint(block_index);
-  uint32_t shared, non_shared, value_length;
-  const char* key_ptr = DecodeEntry(data_ + region_offset, data_ + restarts_,
-                                    &shared, &non_shared, &value_length);
-  if (key_ptr == nullptr || (shared != 0)) {
+  uint32_t key_size;
+  const char* key_ptr = DecodeRestartKey(block_index, &key_size);
+  if (key_ptr == nullptr) {
     CorruptionError();
     return 1;  // Return target is smaller
   }
-  Slice block_key(key_ptr, non_shared);
+  Slice block_key(key_ptr, key_size);
   return Compare(block_key, target);
 }
 
@@ -355,7 +452,8 @@ Block::Block(BlockContents&& contents)
 }
 
 InternalIterator* Block::NewIterator(const Comparator* cmp, BlockIter* iter,
-                                     bool total_order_seek) {
+                                     bool total_order_seek,
+                                     KeyValueEncodingFormat key_value_encoding_format) {
   if (size_ < 2*sizeof(uint32_t)) {
     if (iter != nullptr) {
       iter->SetStatus(STATUS(Corruption, "bad block contents"));
@@ -380,10 +478,10 @@ InternalIterator* Block::NewIterator(const Comparator* cmp, BlockIter* iter,
 
     if (iter != nullptr) {
       iter->Initialize(cmp, data_, restart_offset_, num_restarts,
-                    hash_index_ptr, prefix_index_ptr);
+                    hash_index_ptr, prefix_index_ptr, key_value_encoding_format);
     } else {
       iter = new BlockIter(cmp, data_, restart_offset_, num_restarts,
-                           hash_index_ptr, prefix_index_ptr);
+                           hash_index_ptr, prefix_index_ptr, key_value_encoding_format);
     }
   }
 
@@ -32,6 +32,7 @@
 
 #include "yb/rocksdb/iterator.h"
 #include "yb/rocksdb/options.h"
+#include "yb/rocksdb/table.h"
 #include "yb/rocksdb/db/dbformat.h"
 #include "yb/rocksdb/table/block_prefix_index.h"
 #include "yb/rocksdb/table/block_hash_index.h"
@@ -82,9 +83,13 @@ class Block {
   // If total_order_seek is true, hash_index_ and prefix_index_ are ignored.
   // This option only applies for index block. For data block, hash_index_
   // and prefix_index_ are null, so this option does not matter.
+  //
+  // key_value_encoding_format should match the format used by BlockBuilder for this block.
   InternalIterator* NewIterator(const Comparator* comparator,
                                 BlockIter* iter = nullptr,
-                                bool total_order_seek = true);
+                                bool total_order_seek = true,
+                                KeyValueEncodingFormat key_value_encoding_format =
+                                    KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix);
   void SetBlockHashIndex(BlockHashIndex* hash_index);
   void SetBlockPrefixIndex(BlockPrefixIndex* prefix_index);
 
@@ -108,6 +113,7 @@ class BlockIter : public InternalIterator {
  public:
   BlockIter()
       : comparator_(nullptr),
+        key_value_encoding_format_(KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix),
         data_(nullptr),
         restarts_(0),
         num_restarts_(0),
@@ -119,15 +125,15 @@ class BlockIter : public InternalIterator {
 
   BlockIter(const Comparator* comparator, const char* data, uint32_t restarts,
        uint32_t num_restarts, BlockHashIndex* hash_index,
-       BlockPrefixIndex* prefix_index)
+       BlockPrefixIndex* prefix_index, KeyValueEncodingFormat key_value_encoding_format)
       : BlockIter() {
     Initialize(comparator, data, restarts, num_restarts,
-        hash_index, prefix_index);
+        hash_index, prefix_index, key_value_encoding_format);
   }
 
   void Initialize(const Comparator* comparator, const char* data,
       uint32_t restarts, uint32_t num_restarts, BlockHashIndex* hash_index,
-      BlockPrefixIndex* prefix_index);
+      BlockPrefixIndex* prefix_index, KeyValueEncodingFormat key_value_encoding_format);
 
   void SetStatus(Status s) {
     status_ = s;
@@ -168,6 +174,7 @@ class BlockIter : public InternalIterator {
 
  private:
   const Comparator* comparator_;
+  KeyValueEncodingFormat key_value_encoding_format_;
   const char* data_;       // underlying block contents
   uint32_t restarts_;      // Offset of restart array (list of fixed32)
   uint32_t num_restarts_;  // Number of uint32_t entries in restart array
@@ -191,7 +198,7 @@ class BlockIter : public InternalIterator {
     return static_cast<uint32_t>((value_.cdata() + value_.size()) - data_);
   }
 
-  uint32_t GetRestartPoint(uint32_t index) {
+  uint32_t GetRestartPoint(uint32_t index) const {
     assert(index < num_restarts_);
     return DecodeFixed32(data_ + restarts_ + index * sizeof(uint32_t));
   }
@@ -210,6 +217,13 @@ class BlockIter : public InternalIterator {
 
   bool ParseNextKey();
 
+  // Decode entry at p, update key_ and value_ accordingly. Return false in case of corruption.
+  bool ParseSharedPrefixEntry(const char* p, const char* limit);
+  bool ParseThreeSharedPartsEntry(const char* p, const char* limit);
+
+  // Returns key of the entry at the specified restart point, or nullptr in case of corruption.
+  const char* DecodeRestartKey(uint32_t restart_index, uint32_t* key_size) const;
+
   bool BinarySeek(const Slice& target, uint32_t left, uint32_t right,
                   uint32_t* index);
 
@@ -27,6 +27,7 @@
 #include <inttypes.h>
 #include <stdio.h>
 
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <string>
@@ -108,7 +109,8 @@ bool GoodCompressionRatio(size_t compressed_size, size_t raw_size) {
 Slice CompressBlock(const Slice& raw,
                     const CompressionOptions& compression_options,
                     CompressionType* type, uint32_t format_version,
-                    std::string* compressed_output) {
+                    std::string* compressed_output,
+                    const Slice& compression_dict = Slice()) {
   if (*type == kNoCompression) {
     return raw;
   }
@@ -127,7 +129,7 @@ Slice CompressBlock(const Slice& raw,
       if (Zlib_Compress(
               compression_options,
               GetCompressFormatForVersion(kZlibCompression, format_version),
-              raw.cdata(), raw.size(), compressed_output) &&
+              raw.cdata(), raw.size(), compressed_output, compression_dict) &&
           GoodCompressionRatio(compressed_output->size(), raw.size())) {
         return *compressed_output;
       }
@@ -145,7 +147,7 @@ Slice CompressBlock(const Slice& raw,
       if (LZ4_Compress(
               compression_options,
               GetCompressFormatForVersion(kLZ4Compression, format_version),
-              raw.cdata(), raw.size(), compressed_output) &&
+              raw.cdata(), raw.size(), compressed_output, compression_dict) &&
           GoodCompressionRatio(compressed_output->size(), raw.size())) {
         return *compressed_output;
       }
@@ -154,14 +156,14 @@ Slice CompressBlock(const Slice& raw,
       if (LZ4HC_Compress(
               compression_options,
               GetCompressFormatForVersion(kLZ4HCCompression, format_version),
-              raw.cdata(), raw.size(), compressed_output) &&
+              raw.cdata(), raw.size(), compressed_output, compression_dict) &&
           GoodCompressionRatio(compressed_output->size(), raw.size())) {
         return *compressed_output;
       }
       break;     // fall back to no compression.
     case kZSTDNotFinalCompression:
       if (ZSTD_Compress(compression_options, raw.cdata(), raw.size(),
-                        compressed_output) &&
+                        compressed_output, compression_dict) &&
           GoodCompressionRatio(compressed_output->size(), raw.size())) {
         return *compressed_output;
       }
@@ -281,7 +283,12 @@ struct BlockBasedTableBuilder::Rep {
   std::unique_ptr<IndexBuilder> data_index_builder;
   IndexBuilder::IndexBlocks data_index_blocks;
   BlockHandle last_index_block_handle;
+  // Fixed-size filter index is multi-level when data index is multi-level, so only its top level
+  // has to be kept in memory by table reader.
+  const bool multi_level_filter_index;
   std::unique_ptr<IndexBuilder> filter_index_builder;
+  IndexBuilder::IndexBlocks filter_index_blocks;
+  BlockHandle last_filter_index_block_handle;
 
   std::string last_key;
   std::string last_filter_key;
@@ -299,6 +306,18 @@ struct BlockBasedTableBuilder::Rep {
 
   std::vector<std::unique_ptr<IntTblPropCollector>> table_properties_collectors;
 
+  // Data blocks are buffered until enough of them are collected to build the compression
+  // dictionary, see CompressionOptions::max_dict_bytes.
+  struct BufferedDataBlock {
+    std::string contents;
+    std::string last_key;
+    std::string next_block_first_key;
+  };
+  bool buffer_data_blocks = false;
+  std::vector<BufferedDataBlock> buffered_data_blocks;
+  size_t buffered_data_size = 0;
+  std::string compression_dict;
+
   Rep(const ImmutableCFOptions& _ioptions,
       const BlockBasedTableOptions& table_opt,
       const InternalKeyComparatorPtr& icomparator,
@@ -327,6 +346,15 @@ Status BlockBasedTableBuilder::BlockBasedTablePropertiesCollector::Finish(
   val.clear();
   PutFixed32(&val, rep_->data_index_builder->NumLevels());
   properties->emplace(BlockBasedTablePropertyNames::kNumIndexLevels, val);
+  if (rep_->multi_level_filter_index) {
+    val.clear();
+    PutFixed32(&val, rep_->filter_index_builder->NumLevels());
+    properties->emplace(BlockBasedTablePropertyNames::kNumFilterIndexLevels, val);
+  }
+  val.clear();
+  PutFixed32(&val, static_cast<uint32_t>(
+      rep_->table_options.data_block_key_value_encoding_format));
+  properties->emplace(BlockBasedTablePropertyNames::kDataBlockKeyValueEncodingFormat, val);
   return Status::OK();
 }
 
@@ -348,7 +376,8 @@ BlockBasedTableBuilder::Rep::Rep(
       filter_block_builder(skip_filters ? nullptr : CreateFilterBlockBuilder(
           _ioptions, table_options, filter_type)),
       data_block_builder(table_options.block_restart_interval,
-                 table_options.use_delta_encoding),
+                 table_options.use_delta_encoding,
+                 table_options.data_block_key_value_encoding_format),
       internal_prefix_transform(_ioptions.prefix_extractor),
       filter_key_transformer(table_opt.filter_policy ?
           table_opt.filter_policy->GetKeyTransformer() : nullptr),
@@ -356,12 +385,16 @@ BlockBasedTableBuilder::Rep::Rep(
           IndexBuilder::CreateIndexBuilder(
               table_options.index_type, internal_comparator.get(), &internal_prefix_transform,
               table_options)),
+      multi_level_filter_index(
+          filter_type == FilterType::kFixedSizeFilter &&
+          table_options.index_type == IndexType::kMultiLevelBinarySearch),
       filter_index_builder(
-          // Prefix_extractor is not used by binary search index which we use for bloom filter
+          // Prefix_extractor is not used by binary search indexes which we use for bloom filter
           // blocks indexing.
           IndexBuilder::CreateIndexBuilder(
-              IndexType::kBinarySearch, BytewiseComparator(),
-              nullptr /* prefix_extractor */, table_options)),
+              multi_level_filter_index ? IndexType::kMultiLevelBinarySearch
+                                       : IndexType::kBinarySearch,
+              BytewiseComparator(), nullptr /* prefix_extractor */, table_options)),
       compression_type(_compression_type),
       compression_opts(_compression_opts),
       flush_block_policy(
@@ -383,6 +416,12 @@ BlockBasedTableBuilder::Rep::Rep(
       new BlockBasedTablePropertiesCollector(
           this, table_options.index_type, table_options.whole_key_filtering,
           _ioptions.prefix_extractor != nullptr));
+  // Hash index and block-based filter are built from offsets of data blocks as keys are added, so
+  // data blocks could not be delayed for them.
+  buffer_data_blocks = compression_opts.max_dict_bytes > 0 &&
+                       CompressionDictSupported(compression_type) &&
+                       table_options.index_type != IndexType::kHashSearch &&
+                       filter_type != FilterType::kBlockBasedFilter;
 }
 
 BlockBasedTableBuilder::BlockBasedTableBuilder(
@@ -477,11 +516,70 @@ void BlockBasedTableBuilder::FlushDataBlock(const Slice& next_block_first_key) {
   Rep* const r = rep_;
   assert(!r->closed);
   if (!ok()) return;
+
+  const Slice block_contents =
+      r->data_block_builder.empty() ? Slice() : r->data_block_builder.Finish();
+  if (!r->buffer_data_blocks) {
+    WriteDataBlock(block_contents, &r->last_key, next_block_first_key);
+    r->data_block_builder.Reset();
+    return;
+  }
+
+  r->buffered_data_blocks.push_back(Rep::BufferedDataBlock{
+      block_contents.ToBuffer(), r->last_key, next_block_first_key.ToBuffer()});
+  r->buffered_data_size += block_contents.size();
+  r->data_block_builder.Reset();
+  const size_t max_train_bytes = r->compression_opts.max_train_bytes > 0
+      ? r->compression_opts.max_train_bytes : 100 * r->compression_opts.max_dict_bytes;
+  if (r->buffered_data_size >= max_train_bytes) {
+    FinishCompressionDict();
+  }
+}
+
+void BlockBasedTableBuilder::FinishCompressionDict() {
+  Rep* const r = rep_;
+  r->buffer_data_blocks = false;
+  const size_t max_dict_bytes = r->compression_opts.max_dict_bytes;
+
+  if (r->compression_type == kZSTDNotFinalCompression) {
+    std::string samples;
+    samples.reserve(r->buffered_data_size);
+    std::vector<size_t> sample_lens;
+    for (const auto& block : r->buffered_data_blocks) {
+      samples.append(block.contents);
+      sample_lens.push_back(block.contents.size());
+    }
+    r->compression_dict = ZSTD_TrainDictionary(samples, sample_lens, max_dict_bytes);
+  }
+
+  if (r->compression_dict.empty()) {
+    // Raw content dictionary: whole data blocks evenly spread over the buffered ones, so it covers
+    // their entire key range and keeps long matches that LZ77 compressors benefit from.
+    const size_t step = std::max<size_t>(r->buffered_data_size / max_dict_bytes, 1);
+    for (size_t i = 0; i < r->buffered_data_blocks.size() &&
+                       r->compression_dict.size() < max_dict_bytes; i += step) {
+      const auto& contents = r->buffered_data_blocks[i].contents;
+      r->compression_dict.append(
+          contents, 0, std::min(contents.size(), max_dict_bytes - r->compression_dict.size()));
+    }
+  }
+
+  for (auto& block : r->buffered_data_blocks) {
+    WriteDataBlock(block.contents, &block.last_key, block.next_block_first_key);
+    if (!ok()) break;
+  }
+  r->buffered_data_blocks.clear();
+  r->buffered_data_size = 0;
+}
+
+void BlockBasedTableBuilder::WriteDataBlock(
+    const Slice& block_contents, std::string* last_key, const Slice& next_block_first_key) {
+  Rep* const r = rep_;
   size_t data_block_size = 0;
 
-  if (!r->data_block_builder.empty()) {
-    data_block_size = WriteBlock(&r->data_block_builder, &r->data_pending_handle,
-        r->data_writer.get());
+  if (!block_contents.empty()) {
+    data_block_size = WriteBlock(block_contents, &r->data_pending_handle, r->data_writer.get(),
+        r->compression_dict);
   }
   if (!ok()) return;
 
@@ -505,7 +603,7 @@ void BlockBasedTableBuilder::FlushDataBlock(const Slice& next_block_first_key) {
   // "the r" as the key for the index block entry since it is >= all
   // entries in the first block and < all entries in subsequent
   // blocks.
-  r->data_index_builder->AddIndexEntry(&r->last_key,
+  r->data_index_builder->AddIndexEntry(last_key,
       next_block_first_key.empty() ? nullptr : &next_block_first_key,
       r->data_pending_handle);
   while (r->data_index_builder->ShouldFlush()) {
@@ -550,6 +648,19 @@ void BlockBasedTableBuilder::FlushFilterBlock(const Slice& next_block_first_key)
   // See explanation in BlockBasedTableBuilder::FlushDataBlock.
   r->filter_index_builder->AddIndexEntry(&r->last_filter_key,
       is_last_flush ? nullptr : &next_block_first_key,  r->filter_pending_handle);
+  while (r->filter_index_builder->ShouldFlush()) {
+    auto result = r->filter_index_builder->FlushNextBlock(
+        &r->filter_index_blocks, r->last_filter_index_block_handle);
+    if (!result.ok()) {
+      r->status = result.status();
+      return;
+    }
+    DCHECK(result.get());
+    WriteBlock(
+        r->filter_index_blocks.index_block_contents, &r->last_filter_index_block_handle,
+        r->metadata_writer.get());
+    if (!ok()) return;
+  }
 }
 
 size_t BlockBasedTableBuilder::WriteBlock(BlockBuilder* block,
@@ -562,7 +673,8 @@ size_t BlockBasedTableBuilder::WriteBlock(BlockBuilder* block,
 
 size_t BlockBasedTableBuilder::WriteBlock(const Slice& raw_block_contents,
                                           BlockHandle* handle,
-                                          FileWriterWithOffsetAndCachePrefix* writer_info) {
+                                          FileWriterWithOffsetAndCachePrefix* writer_info,
+                                          const Slice& compression_dict) {
   // File format contains a sequence of blocks where each block has:
   //    block_data: uint8[n]
   //    type: uint8
@@ -575,7 +687,7 @@ size_t BlockBasedTableBuilder::WriteBlock(const Slice& raw_block_contents,
   if (raw_block_contents.size() < kCompressionSizeLimit) {
     block_contents =
         CompressBlock(raw_block_contents, r->compression_opts, &type,
-                      r->table_options.format_version, &r->compressed_output);
+                      r->table_options.format_version, &r->compressed_output, compression_dict);
   } else {
     RecordTick(r->ioptions.statistics, NUMBER_BLOCK_NOT_COMPRESSED);
     type = kNoCompression;
@@ -692,6 +804,9 @@ Status BlockBasedTableBuilder::Finish() {
   if (!r->data_block_builder.empty()) {
     FlushDataBlock(end_slice);  // no more data block
   }
+  if (r->buffer_data_blocks) {
+    FinishCompressionDict();
+  }
   if (r->filter_block_builder != nullptr) {
     FlushFilterBlock(end_slice);  // no more filter block
   }
@@ -718,6 +833,13 @@ Status BlockBasedTableBuilder::Finish() {
     meta_index_builder.Add(item.first, block_handle);
   }
 
+  if (ok() && !r->compression_dict.empty()) {
+    BlockHandle compression_dict_block_handle;
+    WriteRawBlock(r->compression_dict, kNoCompression, &compression_dict_block_handle,
+        r->metadata_writer.get());
+    meta_index_builder.Add(kCompressionDictBlock, compression_dict_block_handle);
+  }
+
   if (ok()) {
     if (r->filter_block_builder != nullptr) {
       // Add mapping from "<filter_block_prefix>.Name" to location of either filter block or
@@ -733,7 +855,11 @@ Status BlockBasedTableBuilder::Finish() {
           key = block_based_table::kFilterBlockPrefix;
           break;
         case FilterType::kFixedSizeFilter:
-          key = block_based_table::kFixedSizeFilterBlockPrefix;
+          // Multi-level filter index uses separate prefix, so readers that don't support it
+          // just don't use the filter.
+          key = r->multi_level_filter_index
+              ? block_based_table::kMultiLevelFixedSizeFilterBlockPrefix
+              : block_based_table::kFixedSizeFilterBlockPrefix;
           break;
         case FilterType::kNoFilter:
           RLOG(InfoLogLevel::FATAL_LEVEL, r->ioptions.info_log,
@@ -742,14 +868,16 @@ Status BlockBasedTableBuilder::Finish() {
       }
       key.append(r->table_options.filter_policy->Name());
       if (r->filter_type == FilterType::kFixedSizeFilter) {
-        // Flush the fixed-size bloom filter index and add its offset under the corresponding
-        // key to meta index.
-        IndexBuilder::IndexBlocks filter_index_blocks;
-        RETURN_NOT_OK(r->filter_index_builder->Finish(&filter_index_blocks));
-        BlockHandle filter_index_block_handle;
-        WriteBlock(filter_index_blocks.index_block_contents, &filter_index_block_handle,
-            r->metadata_writer.get());
-        meta_index_builder.Add(key, filter_index_block_handle);
+        // Flush the fixed-size bloom filter index (or its top level for multi-level index) and add
+        // its offset under the corresponding key to meta index.
+        auto filter_index_finish_result = r->filter_index_builder->FlushNextBlock(
+            &r->filter_index_blocks, r->last_filter_index_block_handle);
+        RETURN_NOT_OK(filter_index_finish_result);
+        if (filter_index_finish_result.get()) {
+          WriteBlock(r->filter_index_blocks.index_block_contents,
+              &r->last_filter_index_block_handle, r->metadata_writer.get());
+        }
+        meta_index_builder.Add(key, r->last_filter_index_block_handle);
         r->props.filter_index_size = r->filter_index_builder->EstimatedSize() + kBlockTrailerSize;
       } else {
         meta_index_builder.Add(key, r->filter_pending_handle);
@@ -840,8 +968,10 @@ uint64_t BlockBasedTableBuilder::NumEntries() const {
 }
 
 uint64_t BlockBasedTableBuilder::TotalFileSize() const {
-  return rep_->is_split_sst() ? rep_->metadata_writer->offset + rep_->data_writer->offset :
-      rep_->metadata_writer->offset;
+  // Buffered data blocks are counted, so compaction still cuts output files at the target size.
+  return rep_->buffered_data_size + (rep_->is_split_sst()
+      ? rep_->metadata_writer->offset + rep_->data_writer->offset
+      : rep_->metadata_writer->offset);
 }
 
 uint64_t BlockBasedTableBuilder::BaseFileSize() const {
@@ -112,7 +112,8 @@ class BlockBasedTableBuilder : public TableBuilder {
       FileWriterWithOffsetAndCachePrefix* writer_info);
   // Directly write block content to the file. Returns number of bytes written to file.
   size_t WriteBlock(const Slice& block_contents, BlockHandle* handle,
-      FileWriterWithOffsetAndCachePrefix* writer_info);
+      FileWriterWithOffsetAndCachePrefix* writer_info,
+      const Slice& compression_dict = Slice());
   size_t WriteRawBlock(const Slice& data, CompressionType, BlockHandle* handle,
       FileWriterWithOffsetAndCachePrefix* writer_info);
   Status InsertBlockInCache(const Slice& block_contents,
@@ -130,6 +131,13 @@ class BlockBasedTableBuilder : public TableBuilder {
   // REQUIRES: Finish(), Abandon() have not been called.
   void FlushDataBlock(const Slice& next_block_first_key);
 
+  // Write the data block with last key last_key into disk and add it to the data index.
+  void WriteDataBlock(
+      const Slice& block_contents, std::string* last_key, const Slice& next_block_first_key);
+
+  // Build the compression dictionary from buffered data blocks, then write them into disk.
+  void FinishCompressionDict();
+
   // Flush the current filter block into disk. next_block_first_key should be nullptr if this is the
   // last block written to disk.
   // REQUIRES: Finish(), Abandon() have not been called.
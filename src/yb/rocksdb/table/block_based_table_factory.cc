@@ -136,6 +136,9 @@ std::string BlockBasedTableFactory::GetPrintableTableOptions() const {
   snprintf(buffer, kBufferSize, "  cache_index_and_filter_blocks: %d\n",
            table_options_.cache_index_and_filter_blocks);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  cache_index_and_filter_blocks_with_high_priority: %d\n",
+           table_options_.cache_index_and_filter_blocks_with_high_priority);
+  ret.append(buffer);
   snprintf(buffer, kBufferSize, "  index_type: %d\n",
            yb::util::to_underlying(table_options_.index_type));
   ret.append(buffer);
@@ -165,6 +168,9 @@ std::string BlockBasedTableFactory::GetPrintableTableOptions() const {
              table_options_.block_cache_compressed->GetCapacity());
     ret.append(buffer);
   }
+  snprintf(buffer, kBufferSize, "  secondary_block_cache: %p\n",
+           table_options_.secondary_block_cache.get());
+  ret.append(buffer);
   snprintf(buffer, kBufferSize, "  block_size: %" ROCKSDB_PRIszt "\n",
            table_options_.block_size);
   ret.append(buffer);
@@ -190,6 +196,9 @@ std::string BlockBasedTableFactory::GetPrintableTableOptions() const {
   snprintf(buffer, kBufferSize, "  format_version: %d\n",
            table_options_.format_version);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  data_block_key_value_encoding_format: %s\n",
+           ToString(table_options_.data_block_key_value_encoding_format).c_str());
+  ret.append(buffer);
   return ret;
 }
 
@@ -201,6 +210,11 @@ std::shared_ptr<TableAwareReadFileFilter> BlockBasedTableFactory::NewTableAwareR
   return std::make_shared<BloomFilterAwareFileFilter>(read_options, user_key);
 }
 
+std::shared_ptr<TableAwareReadFileFilter> BlockBasedTableFactory::NewTableAwareReadFileFilter(
+    const ReadOptions &read_options, const std::vector<Slice>& user_keys) const {
+  return std::make_shared<BloomFilterAwareFileFilter>(read_options, user_keys);
+}
+
 TableFactory* NewBlockBasedTableFactory(
     const BlockBasedTableOptions& _table_options) {
   return new BlockBasedTableFactory(_table_options);
@@ -210,10 +224,14 @@ const char BlockBasedTablePropertyNames::kIndexType[] =
     "rocksdb.block.based.table.index.type";
 const char BlockBasedTablePropertyNames::kNumIndexLevels[] =
     "rocksdb.block.based.table.index.num.levels";
+const char BlockBasedTablePropertyNames::kNumFilterIndexLevels[] =
+    "rocksdb.block.based.table.filter.index.num.levels";
 const char BlockBasedTablePropertyNames::kWholeKeyFiltering[] =
     "rocksdb.block.based.table.whole.key.filtering";
 const char BlockBasedTablePropertyNames::kPrefixFiltering[] =
     "rocksdb.block.based.table.prefix.filtering";
+const char BlockBasedTablePropertyNames::kDataBlockKeyValueEncodingFormat[] =
+    "rocksdb.block.based.table.data.block.key.value.encoding.format";
 const char kHashIndexPrefixesBlock[] = "rocksdb.hashindex.prefixes";
 const char kHashIndexPrefixesMetadataBlock[] =
     "rocksdb.hashindex.metadata";
@@ -86,6 +86,9 @@ class BlockBasedTableFactory : public TableFactory {
   std::shared_ptr<TableAwareReadFileFilter> NewTableAwareReadFileFilter(
       const ReadOptions &read_options, const Slice &user_key) const override;
 
+  std::shared_ptr<TableAwareReadFileFilter> NewTableAwareReadFileFilter(
+      const ReadOptions &read_options, const std::vector<Slice>& user_keys) const override;
+
  private:
   BlockBasedTableOptions table_options_;
 };
@@ -27,6 +27,8 @@
 #include <utility>
 #include <cinttypes>
 
+#include <gflags/gflags.h>
+
 #include "yb/rocksdb/db/dbformat.h"
 
 #include "yb/rocksdb/cache.h"
@@ -62,9 +64,16 @@
 #include "yb/util/string_util.h"
 
 #include "yb/gutil/macros.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
 #include "yb/util/atomic.h"
 
+DEFINE_int32(rocksdb_max_auto_readahead_size, 256 * 1024,
+             "Max number of bytes that an iterator reading consecutive data blocks of an SST file "
+             "asks the OS to read ahead asynchronously. 0 disables the readahead.");
+TAG_FLAG(rocksdb_max_auto_readahead_size, advanced);
+TAG_FLAG(rocksdb_max_auto_readahead_size, runtime);
+
 namespace rocksdb {
 
 extern const uint64_t kBlockBasedTableMagicNumber;
@@ -216,9 +225,14 @@ struct BlockBasedTable::Rep {
   // Handle of fixed-size bloom filter index block or simply filter block for filters of other
   // types.
   BlockHandle filter_handle;
+  // Whether fixed-size bloom filter index is multi-level, filter_handle points to its top level
+  // in this case.
+  bool multi_level_filter_index = false;
 
   std::shared_ptr<const TableProperties> table_properties;
   IndexType index_type;
+  KeyValueEncodingFormat data_block_key_value_encoding_format =
+      KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix;
   bool hash_index_allow_collision;
   bool whole_key_filtering;
   bool prefix_filtering;
@@ -228,6 +242,8 @@ struct BlockBasedTable::Rep {
   // block to extract prefix without knowing if a key is internal or not.
   unique_ptr<SliceTransform> internal_prefix_transform;
   DataIndexLoadMode data_index_load_mode;
+  // Dictionary data blocks were compressed with, empty if they were compressed without one.
+  std::string compression_dict;
 };
 
 class BlockBasedTable::IndexIteratorHolder {
@@ -268,7 +284,8 @@ BlockBasedTable::FileReaderWithCachePrefix* BlockBasedTable::GetBlockReader(Bloc
   switch (block_type) {
     case BlockType::kData:
       return rep_->data_reader_with_cache_prefix.get();
-    case BlockType::kIndex:
+    case BlockType::kIndex: FALLTHROUGH_INTENDED;
+    case BlockType::kFilterIndex:
       return rep_->base_reader_with_cache_prefix.get();
   }
   FATAL_INVALID_ENUM_VALUE(BlockType, block_type);
@@ -276,22 +293,37 @@ BlockBasedTable::FileReaderWithCachePrefix* BlockBasedTable::GetBlockReader(Bloc
 
 BloomFilterAwareFileFilter::BloomFilterAwareFileFilter(
     const ReadOptions& read_options, const Slice& user_key)
-    : read_options_(read_options), user_key_(user_key.ToBuffer()) {}
+    : read_options_(read_options), user_keys_{user_key.ToBuffer()} {}
+
+BloomFilterAwareFileFilter::BloomFilterAwareFileFilter(
+    const ReadOptions& read_options, const std::vector<Slice>& user_keys)
+    : read_options_(read_options) {
+  user_keys_.reserve(user_keys.size());
+  for (const auto& user_key : user_keys) {
+    user_keys_.push_back(user_key.ToBuffer());
+  }
+}
 
 bool BloomFilterAwareFileFilter::Filter(TableReader* reader) const {
   auto table = down_cast<BlockBasedTable*>(reader);
   if (table->rep_->filter_type == FilterType::kFixedSizeFilter) {
-    const auto filter_key = table->GetFilterKeyFromUserKey(user_key_);
-    auto filter_entry = table->GetFilter(read_options_.query_id,
-        read_options_.read_tier == kBlockCacheTier /* no_io */, &filter_key);
-    FilterBlockReader* filter = filter_entry.value;
-    // If bloom filter was not useful, then take this file into account.
-    const bool use_file = table->NonBlockBasedFilterKeyMayMatch(filter, filter_key);
+    bool use_file = false;
+    for (const auto& user_key : user_keys_) {
+      const auto filter_key = table->GetFilterKeyFromUserKey(user_key);
+      auto filter_entry = table->GetFilter(read_options_.query_id,
+          read_options_.read_tier == kBlockCacheTier /* no_io */, &filter_key);
+      FilterBlockReader* filter = filter_entry.value;
+      // If bloom filter was not useful, then take this file into account.
+      use_file = table->NonBlockBasedFilterKeyMayMatch(filter, filter_key);
+      filter_entry.Release(table->rep_->table_options.block_cache.get());
+      if (use_file) {
+        break;
+      }
+    }
     if (!use_file) {
       // Record that the bloom filter was useful.
       RecordTick(table->rep_->ioptions.statistics, BLOOM_FILTER_USEFUL);
     }
-    filter_entry.Release(table->rep_->table_options.block_cache.get());
     return use_file;
   } else {
     // For non fixed-size filters - take file into account. We are only using fixed-size bloom
@@ -370,7 +402,8 @@ Status BlockBasedTable::Open(const ImmutableCFOptions& ioptions,
   if (rep->filter_policy) {
     for (const auto& prefix : {block_based_table::kFullFilterBlockPrefix,
                                block_based_table::kFilterBlockPrefix,
-                               block_based_table::kFixedSizeFilterBlockPrefix}) {
+                               block_based_table::kFixedSizeFilterBlockPrefix,
+                               block_based_table::kMultiLevelFixedSizeFilterBlockPrefix}) {
       // Unsuccessful read implies we should not use filter.
       std::string filter_block_key = prefix;
       filter_block_key.append(rep->filter_policy->Name());
@@ -381,6 +414,9 @@ Status BlockBasedTable::Open(const ImmutableCFOptions& ioptions,
           rep->filter_type = FilterType::kBlockBasedFilter;
         } else if (prefix == block_based_table::kFixedSizeFilterBlockPrefix) {
           rep->filter_type = FilterType::kFixedSizeFilter;
+        } else if (prefix == block_based_table::kMultiLevelFixedSizeFilterBlockPrefix) {
+          rep->filter_type = FilterType::kFixedSizeFilter;
+          rep->multi_level_filter_index = true;
         } else {
           // That means we have memory corruption, so we should fail.
           RLOG(InfoLogLevel::FATAL_LEVEL, rep->ioptions.info_log, "Invalid filter block prefix: %s",
@@ -393,6 +429,22 @@ Status BlockBasedTable::Open(const ImmutableCFOptions& ioptions,
     }
   }
 
+  // Read the compression dictionary.
+  {
+    BlockHandle compression_dict_handle;
+    if (FindMetaBlock(meta_iter.get(), kCompressionDictBlock, &compression_dict_handle).ok()) {
+      BlockContents compression_dict_contents;
+      s = ReadBlockContents(
+          rep->base_reader_with_cache_prefix->reader.get(), rep->footer, ReadOptions::kDefault,
+          compression_dict_handle, &compression_dict_contents, rep->ioptions.env,
+          false /* do_uncompress */);
+      if (!s.ok()) {
+        return s;
+      }
+      rep->compression_dict = compression_dict_contents.data.ToBuffer();
+    }
+  }
+
   // Read the properties
   bool found_properties_block = true;
   s = SeekToPropertiesBlock(meta_iter.get(), &found_properties_block);
@@ -430,6 +482,20 @@ Status BlockBasedTable::Open(const ImmutableCFOptions& ioptions,
     rep->prefix_filtering &= IsFeatureSupported(
         *(rep->table_properties),
         BlockBasedTablePropertyNames::kPrefixFiltering, rep->ioptions.info_log);
+
+    // Tables written before the format property was introduced use the shared prefix encoding.
+    auto& props = rep->table_properties->user_collected_properties;
+    auto pos = props.find(BlockBasedTablePropertyNames::kDataBlockKeyValueEncodingFormat);
+    if (pos != props.end()) {
+      const uint32_t format = pos->second.size() == sizeof(uint32_t)
+          ? DecodeFixed32(pos->second.c_str()) : std::numeric_limits<uint32_t>::max();
+      if (format > yb::util::to_underlying(
+              KeyValueEncodingFormat::kKeyDeltaEncodingThreeSharedParts)) {
+        return STATUS_SUBSTITUTE(
+            Corruption, "Invalid data block key value encoding format: $0", format);
+      }
+      rep->data_block_key_value_encoding_format = static_cast<KeyValueEncodingFormat>(format);
+    }
   }
 
   if (data_index_load_mode == DataIndexLoadMode::PRELOAD_ON_OPEN) {
@@ -613,17 +679,33 @@ Tickers GetBlockCacheMissTicker(BlockType block_type) {
   switch (block_type) {
     case BlockType::kData:
       return BLOCK_CACHE_DATA_MISS;
-    case BlockType::kIndex:
+    case BlockType::kIndex: FALLTHROUGH_INTENDED;
+    case BlockType::kFilterIndex:
       return BLOCK_CACHE_INDEX_MISS;
   }
   FATAL_INVALID_ENUM_VALUE(BlockType, block_type);
 }
 
+// Returns block from the secondary block cache or nullptr when it is not there.
+std::unique_ptr<Block> GetBlockFromSecondaryCache(
+    SecondaryBlockCache* secondary_block_cache, const Slice& key, Statistics* statistics) {
+  std::unique_ptr<char[]> data;
+  size_t size = 0;
+  if (!secondary_block_cache->Lookup(key, &data, &size)) {
+    RecordTick(statistics, BLOCK_CACHE_SECONDARY_MISS);
+    return nullptr;
+  }
+  RecordTick(statistics, BLOCK_CACHE_SECONDARY_HIT);
+  return std::make_unique<Block>(
+      BlockContents(std::move(data), size, true /* cachable */, kNoCompression));
+}
+
 Tickers GetBlockCacheHitTicker(BlockType block_type) {
   switch (block_type) {
     case BlockType::kData:
       return BLOCK_CACHE_DATA_HIT;
-    case BlockType::kIndex:
+    case BlockType::kIndex: FALLTHROUGH_INTENDED;
+    case BlockType::kFilterIndex:
       return BLOCK_CACHE_INDEX_HIT;
   }
   FATAL_INVALID_ENUM_VALUE(BlockType, block_type);
@@ -634,8 +716,8 @@ Tickers GetBlockCacheHitTicker(BlockType block_type) {
 Status BlockBasedTable::GetDataBlockFromCache(
     const Slice& block_cache_key, const Slice& compressed_block_cache_key,
     Cache* block_cache, Cache* block_cache_compressed, Statistics* statistics,
-    const ReadOptions& read_options, BlockBasedTable::CachableEntry<Block>* block,
-    uint32_t format_version, BlockType block_type) {
+    QueryId query_id, bool fill_cache, BlockBasedTable::CachableEntry<Block>* block,
+    uint32_t format_version, BlockType block_type, const Slice& compression_dict) {
   Status s;
   Block* compressed_block = nullptr;
   Cache::Handle* block_cache_compressed_handle = nullptr;
@@ -645,7 +727,7 @@ Status BlockBasedTable::GetDataBlockFromCache(
     block->cache_handle =
         GetEntryFromCache(
             block_cache, block_cache_key, GetBlockCacheMissTicker(block_type),
-            GetBlockCacheHitTicker(block_type), statistics, read_options.query_id);
+            GetBlockCacheHitTicker(block_type), statistics, query_id);
     if (block->cache_handle != nullptr) {
       block->value =
           static_cast<Block*>(block_cache->Value(block->cache_handle));
@@ -662,7 +744,7 @@ Status BlockBasedTable::GetDataBlockFromCache(
 
   assert(!compressed_block_cache_key.empty());
   block_cache_compressed_handle =
-      block_cache_compressed->Lookup(compressed_block_cache_key, read_options.query_id);
+      block_cache_compressed->Lookup(compressed_block_cache_key, query_id);
   // if we found in the compressed cache, then uncompress and insert into
   // uncompressed cache
   if (block_cache_compressed_handle == nullptr) {
@@ -680,15 +762,14 @@ Status BlockBasedTable::GetDataBlockFromCache(
   BlockContents contents;
   s = UncompressBlockContents(compressed_block->data(),
                               compressed_block->size(), &contents,
-                              format_version);
+                              format_version, compression_dict);
 
   // Insert uncompressed block into block cache
   if (s.ok()) {
     block->value = new Block(std::move(contents));  // uncompressed block
     assert(block->value->compression_type() == kNoCompression);
-    if (block_cache != nullptr && block->value->cachable() &&
-        read_options.fill_cache) {
-      s = block_cache->Insert(block_cache_key, read_options.query_id, block->value,
+    if (block_cache != nullptr && block->value->cachable() && fill_cache) {
+      s = block_cache->Insert(block_cache_key, query_id, block->value,
                               block->value->usable_size(), &DeleteCachedEntry<Block>,
                               &block->cache_handle, statistics);
       if (!s.ok()) {
@@ -706,8 +787,9 @@ Status BlockBasedTable::GetDataBlockFromCache(
 Status BlockBasedTable::PutDataBlockToCache(
     const Slice& block_cache_key, const Slice& compressed_block_cache_key,
     Cache* block_cache, Cache* block_cache_compressed,
-    const ReadOptions& read_options, Statistics* statistics,
-    CachableEntry<Block>* block, Block* raw_block, uint32_t format_version) {
+    QueryId query_id, Statistics* statistics,
+    CachableEntry<Block>* block, Block* raw_block, uint32_t format_version,
+    const Slice& compression_dict) {
   assert(raw_block->compression_type() == kNoCompression ||
          block_cache_compressed != nullptr);
 
@@ -716,7 +798,7 @@ Status BlockBasedTable::PutDataBlockToCache(
   BlockContents contents;
   if (raw_block->compression_type() != kNoCompression) {
     s = UncompressBlockContents(raw_block->data(), raw_block->size(), &contents,
-                                format_version);
+                                format_version, compression_dict);
   }
   if (!s.ok()) {
     delete raw_block;
@@ -734,7 +816,7 @@ Status BlockBasedTable::PutDataBlockToCache(
   // Release the hold on the compressed cache entry immediately.
   if (block_cache_compressed != nullptr && raw_block != nullptr &&
       raw_block->cachable()) {
-    s = block_cache_compressed->Insert(compressed_block_cache_key, read_options.query_id, raw_block,
+    s = block_cache_compressed->Insert(compressed_block_cache_key, query_id, raw_block,
                                        raw_block->usable_size(), &DeleteCachedEntry<Block>);
     if (s.ok()) {
       // Avoid the following code to delete this cached block.
@@ -749,7 +831,7 @@ Status BlockBasedTable::PutDataBlockToCache(
   // insert into uncompressed block cache
   assert((block->value->compression_type() == kNoCompression));
   if (block_cache != nullptr && block->value->cachable()) {
-    s = block_cache->Insert(block_cache_key, read_options.query_id, block->value,
+    s = block_cache->Insert(block_cache_key, query_id, block->value,
                             block->value->usable_size(),
                             &DeleteCachedEntry<Block>, &block->cache_handle, statistics);
     if (!s.ok()) {
@@ -761,14 +843,6 @@ Status BlockBasedTable::PutDataBlockToCache(
   return s;
 }
 
-Status BlockBasedTable::CreateFilterIndexReader(std::unique_ptr<IndexReader>* filter_index_reader) {
-  auto base_file_reader = rep_->base_reader_with_cache_prefix->reader.get();
-  auto env = rep_->ioptions.env;
-  auto footer = rep_->footer;
-  return BinarySearchIndexReader::Create(base_file_reader, footer, rep_->filter_handle, env,
-      SharedBytewiseComparator(), filter_index_reader);
-}
-
 FilterBlockReader* BlockBasedTable::ReadFilterBlock(const BlockHandle& filter_handle, Rep* rep,
     size_t* filter_size) {
   // TODO: We might want to unify with ReadBlockFromFile() if we start
@@ -820,12 +894,17 @@ Status BlockBasedTable::GetFixedSizeFilterBlockHandle(const Slice& filter_key,
     BlockHandle* filter_block_handle) const {
   // Determine block of fixed-size bloom filter using filter index.
   BlockIter fiter;
-  rep_->filter_index_reader->NewIterator(&fiter,
-      true /* ignored by BinarySearchIndexReader which we use as filter_index_reader */);
-  fiter.Seek(filter_key);
-  if (fiter.Valid()) {
-    Slice filter_block_handle_encoded = fiter.value();
+  InternalIterator* iter = rep_->filter_index_reader->NewIterator(&fiter,
+      true /* ignored by binary search index readers which we use as filter_index_reader */);
+  // Multi-level index reader uses fiter only for the top level and returns its own iterator.
+  std::unique_ptr<InternalIterator> iter_holder(iter != &fiter ? iter : nullptr);
+  iter->Seek(filter_key);
+  if (iter->Valid()) {
+    Slice filter_block_handle_encoded = iter->value();
     return filter_block_handle->DecodeFrom(&filter_block_handle_encoded);
+  } else if (!iter->status().ok()) {
+    // Failed to read lower level of multi-level filter index.
+    return iter->status();
   } else {
     // We are beyond the index, that means key is absent in filter, we use null block handle
     // stub to indicate that.
@@ -844,6 +923,11 @@ Slice BlockBasedTable::GetFilterKeyFromUserKey(const Slice &user_key) const {
       rep_->filter_key_transformer->Transform(user_key) : user_key;
 }
 
+QueryId BlockBasedTable::IndexQueryId(QueryId query_id) const {
+  return rep_->table_options.cache_index_and_filter_blocks_with_high_priority ? kInMultiTouchId
+                                                                              : query_id;
+}
+
 BlockBasedTable::CachableEntry<FilterBlockReader> BlockBasedTable::GetFilter(
     const QueryId query_id,
     bool no_io,
@@ -906,8 +990,9 @@ BlockBasedTable::CachableEntry<FilterBlockReader> BlockBasedTable::GetFilter(
       *filter_block_handle, cache_key_buffer);
 
   Statistics* statistics = rep_->ioptions.statistics;
+  const QueryId filter_query_id = IndexQueryId(query_id);
   auto cache_handle = GetEntryFromCache(block_cache, filter_block_cache_key,
-      BLOCK_CACHE_FILTER_MISS, BLOCK_CACHE_FILTER_HIT, statistics, query_id);
+      BLOCK_CACHE_FILTER_MISS, BLOCK_CACHE_FILTER_HIT, statistics, filter_query_id);
 
   FilterBlockReader* filter = nullptr;
   if (cache_handle != nullptr) {
@@ -922,7 +1007,7 @@ BlockBasedTable::CachableEntry<FilterBlockReader> BlockBasedTable::GetFilter(
     filter = ReadFilterBlock(*filter_block_handle, rep_, &filter_size);
     if (filter != nullptr) {
       assert(filter_size > 0);
-      Status s = block_cache->Insert(filter_block_cache_key, query_id,
+      Status s = block_cache->Insert(filter_block_cache_key, filter_query_id,
                                      filter, filter_size,
                                      &DeleteCachedEntry<FilterBlockReader>, &cache_handle,
                                      statistics);
@@ -971,9 +1056,10 @@ InternalIterator* BlockBasedTable::NewIndexIterator(
     auto key = GetCacheKey(rep_->base_reader_with_cache_prefix->cache_key_prefix,
         rep_->footer.index_handle(), cache_key);
     Statistics* statistics = rep_->ioptions.statistics;
+    const QueryId query_id = IndexQueryId(read_options.query_id);
     auto cache_handle =
         GetEntryFromCache(block_cache, key, BLOCK_CACHE_INDEX_MISS,
-            BLOCK_CACHE_INDEX_HIT, statistics, read_options.query_id);
+            BLOCK_CACHE_INDEX_HIT, statistics, query_id);
 
     if (cache_handle == nullptr && no_io) {
       return ReturnNoIOErrorIterator(input_iter);
@@ -986,7 +1072,7 @@ InternalIterator* BlockBasedTable::NewIndexIterator(
     std::unique_ptr<IndexReader> index_reader_unique;
     Status s = CreateDataBlockIndexReader(&index_reader_unique);
     if (s.ok()) {
-      s = block_cache->Insert(key, read_options.query_id, index_reader_unique.get(),
+      s = block_cache->Insert(key, query_id, index_reader_unique.get(),
                               index_reader_unique->usable_size(),
                               &DeleteCachedEntry<IndexReader>, &cache_handle, statistics);
     }
@@ -1047,6 +1133,9 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
   Cache* block_cache_compressed =
       rep_->table_options.block_cache_compressed.get();
   CachableEntry<Block> block;
+  // Only data blocks are compressed with the dictionary.
+  const Slice compression_dict =
+      block_type == BlockType::kData ? Slice(rep_->compression_dict) : Slice();
 
   BlockHandle handle;
   Slice input = index_value;
@@ -1082,23 +1171,39 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
       ckey = GetCacheKey(reader->compressed_cache_key_prefix, handle, compressed_cache_key);
     }
 
+    // Index blocks are required by all reads, so they are cached even when the read asked not to
+    // fill the cache.
+    const bool is_data_block = block_type == BlockType::kData;
+    const QueryId query_id = is_data_block ? ro.query_id : IndexQueryId(ro.query_id);
+    const bool fill_cache = ro.fill_cache || !is_data_block;
     s = GetDataBlockFromCache(
-        key, ckey, block_cache, block_cache_compressed, statistics, ro, &block,
-        rep_->table_options.format_version, block_type);
+        key, ckey, block_cache, block_cache_compressed, statistics, query_id, fill_cache, &block,
+        rep_->table_options.format_version, block_type, compression_dict);
 
-    if (block.value == nullptr && !no_io && ro.fill_cache) {
+    if (block.value == nullptr && !no_io && fill_cache) {
       std::unique_ptr<Block> raw_block;
-      {
-        StopWatch sw(rep_->ioptions.env, statistics, READ_BLOCK_GET_MICROS);
-        s = block_based_table::ReadBlockFromFile(
-            reader->reader.get(), rep_->footer, ro, handle, &raw_block, rep_->ioptions.env,
-            block_cache_compressed == nullptr);
+      SecondaryBlockCache* secondary_block_cache =
+          block_cache != nullptr ? rep_->table_options.secondary_block_cache.get() : nullptr;
+      if (secondary_block_cache != nullptr) {
+        raw_block = GetBlockFromSecondaryCache(secondary_block_cache, key, statistics);
+      }
+      if (!raw_block) {
+        {
+          StopWatch sw(rep_->ioptions.env, statistics, READ_BLOCK_GET_MICROS);
+          s = block_based_table::ReadBlockFromFile(
+              reader->reader.get(), rep_->footer, ro, handle, &raw_block, rep_->ioptions.env,
+              block_cache_compressed == nullptr, compression_dict);
+        }
+        if (s.ok() && secondary_block_cache != nullptr && raw_block->cachable() &&
+            raw_block->compression_type() == kNoCompression) {
+          secondary_block_cache->Offer(key, Slice(raw_block->data(), raw_block->size()));
+        }
       }
 
       if (s.ok()) {
         s = PutDataBlockToCache(key, ckey, block_cache, block_cache_compressed,
-                                ro, statistics, &block, raw_block.release(),
-                                rep_->table_options.format_version);
+                                query_id, statistics, &block, raw_block.release(),
+                                rep_->table_options.format_version, compression_dict);
       }
     }
   }
@@ -1116,7 +1221,8 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
     }
     std::unique_ptr<Block> block_value;
     s = block_based_table::ReadBlockFromFile(
-        reader->reader.get(), rep_->footer, ro, handle, &block_value, rep_->ioptions.env);
+        reader->reader.get(), rep_->footer, ro, handle, &block_value, rep_->ioptions.env,
+        true /* do_uncompress */, compression_dict);
     if (s.ok()) {
       block.value = block_value.release();
     }
@@ -1124,7 +1230,12 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
 
   InternalIterator* iter;
   if (s.ok() && block.value != nullptr) {
-    iter = block.value->NewIterator(rep_->comparator.get(), input_iter);
+    // Filter index uses bytewise comparator for filter keys instead of internal key comparator.
+    iter = block.value->NewIterator(
+        block_type == BlockType::kFilterIndex ? BytewiseComparator() : rep_->comparator.get(),
+        input_iter, true /* total_order_seek */,
+        block_type == BlockType::kData ? rep_->data_block_key_value_encoding_format
+                                       : KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix);
     if (block.cache_handle != nullptr) {
       iter->RegisterCleanup(&ReleaseCachedEntry, block_cache,
           block.cache_handle);
@@ -1151,9 +1262,15 @@ class BlockBasedTable::BlockEntryIteratorState : public TwoLevelIteratorState {
         table_(table),
         read_options_(read_options),
         skip_filters_(skip_filters),
-        block_type_(block_type) {}
+        block_type_(block_type),
+        readahead_enabled_(block_type == BlockType::kData &&
+                           read_options.read_tier != kBlockCacheTier &&
+                           FLAGS_rocksdb_max_auto_readahead_size > 0) {}
 
   InternalIterator* NewSecondaryIterator(const Slice& index_value) override {
+    if (readahead_enabled_) {
+      MaybeReadahead(index_value);
+    }
     return table_->NewDataBlockIterator(read_options_, index_value, block_type_);
   }
 
@@ -1165,11 +1282,58 @@ class BlockBasedTable::BlockEntryIteratorState : public TwoLevelIteratorState {
   }
 
  private:
+  // Detects that the iterator reads consecutive data blocks and then prefetches the blocks that
+  // follow, doubling the readahead on every window up to --rocksdb_max_auto_readahead_size.
+  // A read that is not adjacent to the previous one, e.g. after a seek, starts over.
+  void MaybeReadahead(const Slice& index_value) {
+    BlockHandle handle;
+    Slice input = index_value;
+    if (!handle.DecodeFrom(&input).ok()) {
+      return;
+    }
+    const uint64_t block_end = handle.offset() + handle.size() + kBlockTrailerSize;
+    if (handle.offset() == next_block_offset_) {
+      ++num_sequential_reads_;
+    } else {
+      num_sequential_reads_ = 0;
+      readahead_size_ = kInitReadaheadSize;
+      readahead_limit_ = 0;
+    }
+    next_block_offset_ = block_end;
+
+    if (num_sequential_reads_ < kMinSequentialReadsForReadahead || block_end <= readahead_limit_) {
+      return;
+    }
+    const size_t max_readahead_size = FLAGS_rocksdb_max_auto_readahead_size;
+    readahead_size_ = std::min(readahead_size_, max_readahead_size);
+    const size_t size = std::max<size_t>(readahead_size_, block_end - handle.offset());
+    const Status s = table_->GetBlockReader(block_type_)->reader->Prefetch(handle.offset(), size);
+    if (!s.ok()) {
+      // The file cannot prefetch, so do not try again.
+      readahead_enabled_ = false;
+      return;
+    }
+    PERF_COUNTER_ADD(block_prefetch_count, 1);
+    readahead_limit_ = handle.offset() + size;
+    readahead_size_ = std::min(readahead_size_ * 2, max_readahead_size);
+  }
+
+  static constexpr size_t kInitReadaheadSize = 8_KB;
+  static constexpr int kMinSequentialReadsForReadahead = 2;
+
   // Don't own table_
   BlockBasedTable* const table_;
   const ReadOptions read_options_;
   const bool skip_filters_;
   const BlockType block_type_;
+
+  bool readahead_enabled_;
+  // Offset of the block following the last block read.
+  uint64_t next_block_offset_ = std::numeric_limits<uint64_t>::max();
+  int num_sequential_reads_ = 0;
+  size_t readahead_size_ = kInitReadaheadSize;
+  // End of the range prefetched so far.
+  uint64_t readahead_limit_ = 0;
 };
 
 // This will be broken if the user specifies an unusual implementation
@@ -1300,6 +1464,7 @@ bool BlockBasedTable::NonBlockBasedFilterKeyMayMatch(FilterBlockReader* filter,
           rep_->ioptions.prefix_extractor->Transform(filter_key))) {
     return false;
   }
+  RecordTick(rep_->ioptions.statistics, BLOOM_FILTER_USELESS);
   return true;
 }
 
@@ -1452,8 +1617,9 @@ bool BlockBasedTable::TEST_KeyInCache(const ReadOptions& options,
       GetCacheKey(rep_->data_reader_with_cache_prefix->cache_key_prefix, handle, cache_key_storage);
   Slice ckey;
 
-  s = GetDataBlockFromCache(cache_key, ckey, block_cache, nullptr, nullptr, options, &block,
-      rep_->table_options.format_version, BlockType::kData);
+  s = GetDataBlockFromCache(cache_key, ckey, block_cache, nullptr, nullptr, options.query_id,
+      options.fill_cache, &block, rep_->table_options.format_version, BlockType::kData,
+      rep_->compression_dict);
   assert(s.ok());
   bool in_cache = block.value != nullptr;
   if (in_cache) {
@@ -1462,6 +1628,35 @@ bool BlockBasedTable::TEST_KeyInCache(const ReadOptions& options,
   return in_cache;
 }
 
+Status BlockBasedTable::CreateFilterIndexReader(std::unique_ptr<IndexReader>* filter_index_reader) {
+  auto base_file_reader = rep_->base_reader_with_cache_prefix->reader.get();
+  auto env = rep_->ioptions.env;
+  auto footer = rep_->footer;
+  if (!rep_->multi_level_filter_index) {
+    return BinarySearchIndexReader::Create(base_file_reader, footer, rep_->filter_handle, env,
+        SharedBytewiseComparator(), filter_index_reader);
+  }
+
+  // Only top level of multi-level filter index is kept in memory, lower levels are read through
+  // block cache, the same way as for multi-level data index.
+  auto& props = DCHECK_NOTNULL(rep_->table_properties.get())->user_collected_properties;
+  auto pos = props.find(BlockBasedTablePropertyNames::kNumFilterIndexLevels);
+  if (pos == props.end()) {
+    return STATUS_FORMAT(
+        NotFound, "Missed table property $0 for multi-level filter index",
+        BlockBasedTablePropertyNames::kNumFilterIndexLevels);
+  }
+  const int num_levels = DecodeFixed32(pos->second.c_str());
+  auto state = std::make_unique<BlockEntryIteratorState>(
+      this, ReadOptions::kDefault, true /* skip_filters */, BlockType::kFilterIndex);
+  auto result = MultiLevelIndexReader::Create(
+      this, base_file_reader, footer, num_levels, rep_->filter_handle, env,
+      SharedBytewiseComparator(), std::move(state));
+  RETURN_NOT_OK(result);
+  *filter_index_reader = std::move(*result);
+  return Status::OK();
+}
+
 // REQUIRES: The following fields of rep_ should have already been populated:
 //  1. file
 //  2. index_handle,
@@ -1588,6 +1783,30 @@ uint64_t BlockBasedTable::ApproximateOffsetOf(const Slice& key) {
   return result;
 }
 
+void BlockBasedTable::SampleKeys(size_t max_keys, std::vector<std::string>* keys) {
+  const uint64_t num_data_blocks =
+      rep_->table_properties ? rep_->table_properties->num_data_blocks : 0;
+  if (max_keys == 0 || num_data_blocks <= 1) {
+    return;
+  }
+  const uint64_t step = std::max<uint64_t>(num_data_blocks / (max_keys + 1), 1);
+
+  ReadOptions read_options;
+  read_options.fill_cache = false;
+  IndexIteratorHolder index_iter_holder(this, read_options);
+  auto* index_iter = index_iter_holder.iter();
+  size_t num_sampled_keys = 0;
+  uint64_t block_idx = 0;
+  for (index_iter->SeekToFirst(); index_iter->Valid() && num_sampled_keys < max_keys;
+       index_iter->Next()) {
+    // Index key is the upper bound of the block, so key of the last block is not used.
+    if (++block_idx % step == 0 && block_idx < num_data_blocks) {
+      keys->push_back(index_iter->key().ToString());
+      ++num_sampled_keys;
+    }
+  }
+}
+
 bool BlockBasedTable::TEST_filter_block_preloaded() const {
   return rep_->filter != nullptr;
 }
@@ -28,6 +28,7 @@
 #include <memory>
 #include <utility>
 #include <string>
+#include <vector>
 
 #include "yb/rocksdb/options.h"
 #include "yb/rocksdb/statistics.h"
@@ -80,7 +81,7 @@ enum class PrefetchFilter {
   NO
 };
 
-YB_DEFINE_ENUM(BlockType, (kData)(kIndex));
+YB_DEFINE_ENUM(BlockType, (kData)(kIndex)(kFilterIndex));
 
 // BloomFilterAwareFileFilter should only be used when scanning within the same hashed components of
 // the key and it should be used together with DocDbAwareFilterPolicy which only takes into account
@@ -91,11 +92,14 @@ class BloomFilterAwareFileFilter : public TableAwareReadFileFilter {
  public:
   BloomFilterAwareFileFilter(const ReadOptions& read_options, const Slice& user_key);
 
+  // Takes the file into account if the bloom filter may match any of user_keys.
+  BloomFilterAwareFileFilter(const ReadOptions& read_options, const std::vector<Slice>& user_keys);
+
   bool Filter(TableReader* reader) const override;
 
  private:
   const ReadOptions read_options_;
-  const std::string user_key_;
+  std::vector<std::string> user_keys_;
 };
 
 // A Table is a sorted map from strings to strings.  Tables are
@@ -164,6 +168,9 @@ class BlockBasedTable : public TableReader {
   // be close to the file length.
   uint64_t ApproximateOffsetOf(const Slice& key) override;
 
+  // Samples keys from the data index, so each part contains about the same number of data blocks.
+  void SampleKeys(size_t max_keys, std::vector<std::string>* keys) override;
+
   // Returns true if the block for the specified key is in cache.
   // REQUIRES: key is in this table && block cache enabled
   bool TEST_KeyInCache(const ReadOptions& options, const Slice& key);
@@ -213,6 +220,10 @@ class BlockBasedTable : public TableReader {
   // Returns key to be added to filter or verified against filter based on user_key.
   Slice GetFilterKeyFromUserKey(const Slice& user_key) const;
 
+  // Returns query id to be used for block cache lookups and inserts of index and filter blocks
+  // by the query with specified query_id.
+  QueryId IndexQueryId(QueryId query_id) const;
+
   // If `no_io == true`, we will not try to read filter/index from sst file (except fixed-size
   // filter blocks) were they not present in cache yet.
   // filter_key is only required when using fixed-size bloom filter in order to use the filter index
@@ -243,11 +254,14 @@ class BlockBasedTable : public TableReader {
   // block_cache_compressed.
   // On success, Status::OK with be returned and @block will be populated with
   // pointer to the block as well as its block handle.
+  // query_id is used for block cache lookups and inserts, fill_cache specifies whether block found
+  // in compressed block cache should be inserted into uncompressed block cache.
+  // compression_dict is the dictionary data blocks of the table were compressed with.
   static Status GetDataBlockFromCache(
       const Slice& block_cache_key, const Slice& compressed_block_cache_key,
       Cache* block_cache, Cache* block_cache_compressed, Statistics* statistics,
-      const ReadOptions& read_options, BlockBasedTable::CachableEntry<Block>* block,
-      uint32_t format_version, BlockType block_type);
+      QueryId query_id, bool fill_cache, BlockBasedTable::CachableEntry<Block>* block,
+      uint32_t format_version, BlockType block_type, const Slice& compression_dict = Slice());
 
   // Put a raw block (maybe compressed) to the corresponding block caches.
   // This method will perform decompression against raw_block if needed and then
@@ -260,8 +274,9 @@ class BlockBasedTable : public TableReader {
   static Status PutDataBlockToCache(
       const Slice& block_cache_key, const Slice& compressed_block_cache_key,
       Cache* block_cache, Cache* block_cache_compressed,
-      const ReadOptions& read_options, Statistics* statistics,
-      CachableEntry<Block>* block, Block* raw_block, uint32_t format_version);
+      QueryId query_id, Statistics* statistics,
+      CachableEntry<Block>* block, Block* raw_block, uint32_t format_version,
+      const Slice& compression_dict = Slice());
 
   // Calls (*handle_result)(arg, ...) repeatedly, starting with the entry found
   // after a call to Seek(key), until handle_result returns false.
@@ -40,6 +40,21 @@
 //     value: char[value_length]
 // shared_bytes == 0 for restart points.
 //
+// With kKeyDeltaEncodingThreeSharedParts an entry has the form:
+//     shared_prefix_bytes: varint32
+//     non_shared_bytes: varint32
+//     value_length: varint32
+//     suffix_info: varint32 = (shared_suffix_bytes << 1) | has_trailer_delta
+//     trailer_delta: varint64, only present when has_trailer_delta is set
+//     key_delta: char[non_shared_bytes]
+//     value: char[value_length]
+// When has_trailer_delta is set, the key consists of the user key and the 8 bytes trailer, that is
+// restored by adding the zigzag decoded trailer_delta to the trailer of the previous key.
+// The user key is the first shared_prefix_bytes of the previous user key, followed by key_delta
+// and the last shared_suffix_bytes of the previous user key.
+// When has_trailer_delta is not set, the whole key is treated as the user key.
+// shared_prefix_bytes == 0 and suffix_info == 0 for restart points.
+//
 // The trailer of the block has the form:
 //     restarts: uint32[num_restarts]
 //     num_restarts: uint32
@@ -57,9 +72,12 @@
 
 namespace rocksdb {
 
-BlockBuilder::BlockBuilder(int block_restart_interval, bool use_delta_encoding)
+BlockBuilder::BlockBuilder(
+    int block_restart_interval, bool use_delta_encoding,
+    KeyValueEncodingFormat key_value_encoding_format)
     : block_restart_interval_(block_restart_interval),
       use_delta_encoding_(use_delta_encoding),
+      key_value_encoding_format_(key_value_encoding_format),
       restarts_(),
       counter_(0),
       finished_(false) {
@@ -97,6 +115,9 @@ size_t BlockBuilder::EstimateSizeAfterKV(const Slice& key, const Slice& value)
   estimate += sizeof(int32_t); // varint for shared prefix length.
   estimate += VarintLength(key.size()); // varint for key length.
   estimate += VarintLength(value.size()); // varint for value length.
+  if (key_value_encoding_format_ == KeyValueEncodingFormat::kKeyDeltaEncodingThreeSharedParts) {
+    estimate += sizeof(int32_t); // varint for shared suffix info.
+  }
 
   return estimate;
 }
@@ -116,15 +137,34 @@ Slice BlockBuilder::Finish() {
 }
 
 void BlockBuilder::Add(const Slice& key, const Slice& value) {
-  Slice last_key_piece(last_key_);
   assert(!finished_);
   assert(counter_ <= block_restart_interval_);
-  size_t shared = 0;  // number of bytes shared with prev key
+  bool use_delta_encoding = use_delta_encoding_;
   if (counter_ >= block_restart_interval_) {
     // Restart compression
     restarts_.push_back(static_cast<uint32_t>(buffer_.size()));
     counter_ = 0;
-  } else if (use_delta_encoding_) {
+    use_delta_encoding = false;
+  }
+
+  switch (key_value_encoding_format_) {
+    case KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix:
+      AddWithSharedPrefix(key, value, use_delta_encoding);
+      break;
+    case KeyValueEncodingFormat::kKeyDeltaEncodingThreeSharedParts:
+      AddWithThreeSharedParts(key, value, use_delta_encoding);
+      break;
+  }
+
+  last_key_.assign(key.cdata(), key.size());
+  counter_++;
+}
+
+void BlockBuilder::AddWithSharedPrefix(
+    const Slice& key, const Slice& value, bool use_delta_encoding) {
+  Slice last_key_piece(last_key_);
+  size_t shared = 0;  // number of bytes shared with prev key
+  if (use_delta_encoding) {
     // See how much sharing to do with previous string
     const size_t min_length = std::min(last_key_piece.size(), key.size());
     while ((shared < min_length) && (last_key_piece[shared] == key[shared])) {
@@ -141,12 +181,49 @@ void BlockBuilder::Add(const Slice& key, const Slice& value) {
   // Add string delta to buffer_ followed by value
   buffer_.append(key.cdata() + shared, non_shared);
   buffer_.append(value.cdata(), value.size());
+}
 
-  // Update state
-  last_key_.resize(shared);
-  last_key_.append(key.cdata() + shared, non_shared);
-  assert(Slice(last_key_) == key);
-  counter_++;
+void BlockBuilder::AddWithThreeSharedParts(
+    const Slice& key, const Slice& value, bool use_delta_encoding) {
+  constexpr size_t kTrailerSize = sizeof(uint64_t);
+
+  Slice last_user_key(last_key_);
+  Slice user_key(key);
+  size_t shared_prefix = 0;
+  size_t shared_suffix = 0;
+  bool has_trailer_delta = false;
+  if (use_delta_encoding) {
+    if (last_user_key.size() >= kTrailerSize && user_key.size() >= kTrailerSize) {
+      has_trailer_delta = true;
+      last_user_key.remove_suffix(kTrailerSize);
+      user_key.remove_suffix(kTrailerSize);
+    }
+    const size_t min_length = std::min(last_user_key.size(), user_key.size());
+    while (shared_prefix < min_length && last_user_key[shared_prefix] == user_key[shared_prefix]) {
+      shared_prefix++;
+    }
+    // Shared suffix should not overlap with shared prefix in both keys.
+    const size_t max_suffix = min_length - shared_prefix;
+    const char* last_end = last_user_key.cend();
+    const char* end = user_key.cend();
+    while (shared_suffix < max_suffix && last_end[-1 - shared_suffix] == end[-1 - shared_suffix]) {
+      shared_suffix++;
+    }
+  }
+  const size_t non_shared = user_key.size() - shared_prefix - shared_suffix;
+
+  PutVarint32(&buffer_, static_cast<uint32_t>(shared_prefix));
+  PutVarint32(&buffer_, static_cast<uint32_t>(non_shared));
+  PutVarint32(&buffer_, static_cast<uint32_t>(value.size()));
+  PutVarint32(&buffer_, static_cast<uint32_t>((shared_suffix << 1) | has_trailer_delta));
+  if (has_trailer_delta) {
+    const uint64_t last_trailer = DecodeFixed64(last_user_key.cend());
+    const uint64_t trailer = DecodeFixed64(user_key.cend());
+    PutVarint64(&buffer_, ZigZagEncode64(static_cast<int64_t>(trailer - last_trailer)));
+  }
+
+  buffer_.append(user_key.cdata() + shared_prefix, non_shared);
+  buffer_.append(value.cdata(), value.size());
 }
 
 }  // namespace rocksdb
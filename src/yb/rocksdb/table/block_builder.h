@@ -26,6 +26,8 @@
 
 #include <stdint.h>
 #include <vector>
+#include "yb/rocksdb/table.h"
+
 #include "yb/util/slice.h"
 
 namespace rocksdb {
@@ -36,7 +38,9 @@ class BlockBuilder {
   void operator=(const BlockBuilder&) = delete;
 
   explicit BlockBuilder(int block_restart_interval,
-                        bool use_delta_encoding = true);
+                        bool use_delta_encoding = true,
+                        KeyValueEncodingFormat key_value_encoding_format =
+                            KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix);
 
   // Reset the contents as if the BlockBuilder was just constructed.
   void Reset();
@@ -65,8 +69,13 @@ class BlockBuilder {
   }
 
  private:
+  void AddWithSharedPrefix(const Slice& key, const Slice& value, bool use_delta_encoding);
+
+  void AddWithThreeSharedParts(const Slice& key, const Slice& value, bool use_delta_encoding);
+
   const int          block_restart_interval_;
   const bool         use_delta_encoding_;
+  const KeyValueEncodingFormat key_value_encoding_format_;
 
   std::string           buffer_;    // Destination buffer
   std::vector<uint32_t> restarts_;  // Restart points
@@ -18,6 +18,8 @@
 // under the License.
 //
 #include <stdio.h>
+
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -135,6 +137,90 @@ TEST_F(BlockTest, SimpleTest) {
   delete iter;
 }
 
+namespace {
+
+// Generates sorted internal keys, that look like DocDB keys of wide rows: the same row prefix
+// is repeated for multiple columns, columns of the same row share the hybrid time suffix and
+// sequence numbers of neighbour keys are close.
+std::vector<std::string> GenerateWideRowKeys(int num_rows, int num_columns, Random* rnd) {
+  std::vector<std::string> keys;
+  SequenceNumber seq = 1000;
+  for (int row = 0; row < num_rows; ++row) {
+    const std::string row_key = "row_key_" + RandomString(rnd, 16) + std::to_string(row);
+    const std::string hybrid_time = RandomString(rnd, 12);
+    for (int column = 0; column < num_columns; ++column) {
+      char column_key[10];
+      snprintf(column_key, sizeof(column_key), "c%04d", column);
+      InternalKey key(row_key + column_key + hybrid_time, ++seq, kTypeValue);
+      keys.push_back(key.Encode().ToString());
+    }
+  }
+  std::sort(keys.begin(), keys.end());
+  return keys;
+}
+
+size_t CheckEncodingFormat(
+    const std::vector<std::string>& keys, const std::vector<std::string>& values,
+    KeyValueEncodingFormat format, Random* rnd) {
+  BlockBuilder builder(16, true /* use_delta_encoding */, format);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    builder.Add(keys[i], values[i]);
+  }
+  Slice rawblock = builder.Finish();
+  const size_t block_size = rawblock.size();
+
+  BlockContents contents;
+  contents.data = rawblock;
+  contents.cachable = false;
+  Block reader(std::move(contents));
+
+  std::unique_ptr<InternalIterator> iter(
+      reader.NewIterator(BytewiseComparator(), nullptr, true, format));
+  size_t count = 0;
+  for (iter->SeekToFirst(); iter->Valid(); ++count, iter->Next()) {
+    EXPECT_EQ(keys[count], iter->key().ToString());
+    EXPECT_EQ(values[count], iter->value().ToString());
+  }
+  EXPECT_EQ(keys.size(), count);
+
+  for (iter->SeekToLast(); iter->Valid(); iter->Prev()) {
+    --count;
+    EXPECT_EQ(keys[count], iter->key().ToString());
+  }
+  EXPECT_EQ(0, count);
+
+  for (int i = 0; i < 1000; ++i) {
+    const size_t index = rnd->Uniform(static_cast<int>(keys.size()));
+    iter->Seek(keys[index]);
+    EXPECT_TRUE(iter->Valid());
+    EXPECT_EQ(keys[index], iter->key().ToString());
+    EXPECT_EQ(values[index], iter->value().ToString());
+  }
+  return block_size;
+}
+
+} // namespace
+
+TEST_F(BlockTest, KeyValueEncodingFormats) {
+  Random rnd(301);
+  const auto keys = GenerateWideRowKeys(100, 50, &rnd);
+  std::vector<std::string> values;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    values.push_back(RandomString(&rnd, rnd.Uniform(10)));
+  }
+  const auto shared_prefix_size = CheckEncodingFormat(
+      keys, values, KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix, &rnd);
+  const auto three_shared_parts_size = CheckEncodingFormat(
+      keys, values, KeyValueEncodingFormat::kKeyDeltaEncodingThreeSharedParts, &rnd);
+  ASSERT_LT(three_shared_parts_size, shared_prefix_size);
+
+  // Short keys and keys without common parts.
+  std::vector<std::string> short_keys = { "", "a", "ab", "abcdefgh", "abcdefghi", "b", "bcdefghi" };
+  std::vector<std::string> short_values(short_keys.size(), "v");
+  CheckEncodingFormat(
+      short_keys, short_values, KeyValueEncodingFormat::kKeyDeltaEncodingThreeSharedParts, &rnd);
+}
+
 // return the block contents
 BlockContents GetBlockContents(std::unique_ptr<BlockBuilder> *builder,
                                const std::vector<std::string> &keys,
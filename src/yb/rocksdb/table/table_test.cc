@@ -65,6 +65,7 @@
 #include "yb/util/enums.h"
 
 DECLARE_double(cache_single_touch_ratio);
+DECLARE_int32(rocksdb_max_auto_readahead_size);
 
 namespace rocksdb {
 
@@ -298,7 +299,7 @@ class TableConstructor: public Constructor {
                             internal_comparator,
                             int_tbl_prop_collector_factories,
                             options.compression,
-                            CompressionOptions(),
+                            options.compression_opts,
                             /* skip_filters */ false),
         TablePropertiesCollectorFactory::Context::kUnknownColumnFamily,
         file_writer_.get()));
@@ -1570,6 +1571,63 @@ TEST_F(BlockBasedTableTest, NumBlockStat) {
             c.GetTableReader()->GetTableProperties()->num_data_blocks);
 }
 
+TEST_F(BlockBasedTableTest, AutoReadahead) {
+  Random rnd(test::RandomSeed());
+  TableConstructor c(BytewiseComparator());
+  Options options;
+  options.compression = kNoCompression;
+  BlockBasedTableOptions table_options;
+  table_options.block_restart_interval = 1;
+  table_options.block_size = 1000;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+
+  // Roughly one key/value pair per block.
+  for (int i = 0; i < 200; ++i) {
+    c.Add(RandomString(&rnd, 900), "val");
+  }
+
+  std::vector<std::string> keys;
+  stl_wrappers::KVMap kvmap;
+  const ImmutableCFOptions ioptions(options);
+  c.Finish(options, ioptions, table_options,
+           GetPlainInternalComparator(options.comparator), &keys, &kvmap);
+
+  const auto scan = [&c]() {
+    perf_context.Reset();
+    std::unique_ptr<InternalIterator> iter(c.NewIterator());
+    size_t count = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      ++count;
+    }
+    EXPECT_OK(iter->status());
+    return count;
+  };
+
+  // The readahead starts after a few consecutive blocks and the window doubles, so a scan
+  // prefetches much less often than it reads blocks.
+  ASSERT_EQ(keys.size(), scan());
+  ASSERT_GT(perf_context.block_prefetch_count, 0U);
+  ASSERT_LT(perf_context.block_prefetch_count, keys.size() / 10);
+
+  // Seeks that jump backwards do not read ahead.
+  perf_context.Reset();
+  {
+    std::unique_ptr<InternalIterator> iter(c.NewIterator());
+    for (auto it = keys.rbegin(); it != keys.rend(); ++it) {
+      iter->Seek(*it);
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(*it, iter->key().ToString());
+    }
+  }
+  ASSERT_EQ(0U, perf_context.block_prefetch_count);
+
+  const auto saved_max_auto_readahead_size = FLAGS_rocksdb_max_auto_readahead_size;
+  FLAGS_rocksdb_max_auto_readahead_size = 0;
+  ASSERT_EQ(keys.size(), scan());
+  ASSERT_EQ(0U, perf_context.block_prefetch_count);
+  FLAGS_rocksdb_max_auto_readahead_size = saved_max_auto_readahead_size;
+}
+
 // A simple tool that takes the snapshot of block cache statistics.
 class BlockCachePropertiesSnapshot {
  public:
@@ -2169,6 +2227,64 @@ TEST_F(GeneralTableTest, ApproximateOffsetOfCompressed) {
   }
 }
 
+TEST_F(GeneralTableTest, CompressionDict) {
+  std::vector<CompressionType> compression_types;
+  for (auto type : {kZlibCompression, kLZ4Compression, kLZ4HCCompression,
+                    kZSTDNotFinalCompression}) {
+    if (CompressionTypeSupported(type) && CompressionDictSupported(type)) {
+      compression_types.push_back(type);
+    }
+  }
+  if (compression_types.empty()) {
+    fprintf(stderr, "skipping compression dictionary tests\n");
+    return;
+  }
+
+  // Values repeat across blocks but not within a block, so only a shared dictionary helps.
+  Random rnd(301);
+  std::vector<std::string> values;
+  for (int i = 0; i != 4; ++i) {
+    values.push_back(RandomString(&rnd, 800));
+  }
+  std::vector<size_t> value_indexes;
+  for (int i = 0; i != 200; ++i) {
+    value_indexes.push_back(rnd.Uniform(static_cast<int>(values.size())));
+  }
+
+  for (auto type : compression_types) {
+    uint64_t data_size[2];
+    for (int use_dict = 0; use_dict != 2; ++use_dict) {
+      TableConstructor c(BytewiseComparator());
+      for (size_t i = 0; i != value_indexes.size(); ++i) {
+        c.Add("k" + std::to_string(1000 + i), values[value_indexes[i]]);
+      }
+      std::vector<std::string> keys;
+      stl_wrappers::KVMap kvmap;
+      Options options;
+      options.compression = type;
+      options.compression_opts.max_dict_bytes = use_dict ? 12000 : 0;
+      BlockBasedTableOptions table_options;
+      table_options.block_size = 1024;
+      const ImmutableCFOptions ioptions(options);
+      c.Finish(options, ioptions, table_options, GetPlainInternalComparator(options.comparator),
+               &keys, &kvmap);
+      data_size[use_dict] = c.GetTableReader()->GetTableProperties()->data_size;
+
+      std::unique_ptr<InternalIterator> iter(c.NewIterator());
+      iter->SeekToFirst();
+      for (const auto& entry : kvmap) {
+        ASSERT_TRUE(iter->Valid());
+        ASSERT_EQ(entry.first, iter->key().ToString());
+        ASSERT_EQ(entry.second, iter->value().ToString());
+        iter->Next();
+      }
+      ASSERT_FALSE(iter->Valid());
+      ASSERT_OK(iter->status());
+    }
+    ASSERT_LT(data_size[1], data_size[0] / 2) << CompressionTypeToString(type);
+  }
+}
+
 TEST_F(HarnessTest, Randomized) {
 #if defined(ROCKSDB_TSAN_RUN) || defined(THREAD_SANITIZER)
   static constexpr int kMaxNumEntries = 200;
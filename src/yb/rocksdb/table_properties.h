@@ -111,6 +111,8 @@ struct TablePropertiesNames {
 };
 
 extern const std::string kPropertiesBlock;
+// Meta block that contains the dictionary data blocks were compressed with.
+extern const std::string kCompressionDictBlock;
 
 enum EntryType {
   kEntryPut,
@@ -191,6 +193,13 @@ class TablePropertiesCollectorFactory {
 // is unknown to `table`).
 extern uint64_t GetDeletedKeys(const UserCollectedProperties& props);
 
+// Name of the user collected property with the number of table entries that a compaction filter
+// could remove without seeing other tables, e.g. entries overwritten by newer entries of the same
+// table. Written by user collectors as varint64.
+extern const std::string kGarbageKeysPropertyName;
+
+extern uint64_t GetGarbageKeys(const UserCollectedProperties& props);
+
 }  // namespace rocksdb
 
 #endif // YB_ROCKSDB_TABLE_PROPERTIES_H
@@ -89,6 +89,13 @@ class CompactionOptionsUniversal {
   // Default: false
   bool allow_trivial_move;
 
+  // If positive, a file whose fraction of garbage entries (see GetGarbageKeys) is at least this
+  // value is compacted alone, when size amplification and size ratios do not trigger a
+  // compaction. The file is only picked once the compaction filter factory reports that its
+  // garbage could be removed, see CompactionFilterFactory::IsGarbageCollectable.
+  // Default: 0, i.e. garbage is not taken into account.
+  double garbage_ratio_threshold;
+
   // Default set of parameters
   CompactionOptionsUniversal()
       : size_ratio(1),
@@ -97,7 +104,8 @@ class CompactionOptionsUniversal {
         max_size_amplification_percent(200),
         compression_size_percent(-1),
         stop_style(kCompactionStopStyleTotalSize),
-        allow_trivial_move(false) {}
+        allow_trivial_move(false),
+        garbage_ratio_threshold(0) {}
 };
 
 }  // namespace rocksdb
@@ -32,6 +32,8 @@
 #include <algorithm>
 #include "yb/rocksdb/env.h"
 
+#include "yb/util/memory/huge_pages.h"
+
 namespace rocksdb {
 
 // MSVC complains that it is already defined since it is static in the header.
@@ -79,10 +81,7 @@ Arena::~Arena() {
 
 #ifdef MAP_HUGETLB
   for (const auto& mmap_info : huge_blocks_) {
-    auto ret = munmap(mmap_info.addr_, mmap_info.length_);
-    if (ret != 0) {
-      // TODO(sdong): Better handling
-    }
+    yb::FreeHugePages(mmap_info.addr_, mmap_info.length_);
   }
 #endif
 }
@@ -132,10 +131,8 @@ char* Arena::AllocateFromHugePage(size_t bytes) {
   // won't leak either
   huge_blocks_.reserve(huge_blocks_.size() + 1);
 
-  void* addr = mmap(nullptr, bytes, (PROT_READ | PROT_WRITE),
-                    (MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB), 0, 0);
-
-  if (addr == MAP_FAILED) {
+  void* addr = yb::AllocateHugePages(bytes);
+  if (addr == nullptr) {
     return nullptr;
   }
   // the following shouldn't throw because of the above reserve()
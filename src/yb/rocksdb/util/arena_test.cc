@@ -25,6 +25,8 @@
 #include "yb/rocksdb/util/random.h"
 #include "yb/rocksdb/util/testharness.h"
 
+#include "yb/util/memory/huge_pages.h"
+
 namespace rocksdb {
 
 namespace {
@@ -203,6 +205,24 @@ TEST_F(ArenaTest, Simple) {
   SimpleTest(0);
   SimpleTest(kHugePageSize);
 }
+
+TEST_F(ArenaTest, HugePagesAccounting) {
+  const auto allocated_before = yb::HugePagesAllocatedBytes();
+  const auto failures_before = yb::HugePagesAllocationFailures();
+  {
+    Arena arena(Arena::kMinBlockSize, kHugePageSize);
+    // Small allocations exceed the inline block, so the first regular block is allocated.
+    for (size_t allocated = 0; allocated <= Arena::kInlineSize; allocated += 100) {
+      memset(arena.Allocate(100), 1, 100);
+    }
+    // Block is either mapped with huge pages or allocated with malloc after a failure.
+    ASSERT_EQ(
+        allocated_before + (yb::HugePagesAllocationFailures() == failures_before
+            ? kHugePageSize : 0),
+        yb::HugePagesAllocatedBytes());
+  }
+  ASSERT_EQ(allocated_before, yb::HugePagesAllocatedBytes());
+}
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
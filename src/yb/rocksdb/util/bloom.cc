@@ -30,6 +30,7 @@
 #include "yb/rocksdb/table/fixed_size_filter_block.h"
 #include "yb/rocksdb/util/hash.h"
 #include "yb/rocksdb/util/coding.h"
+#include "yb/rocksdb/util/ribbon_filter.h"
 #include "yb/util/slice.h"
 #include "yb/util/math_util.h"
 
@@ -268,16 +269,18 @@ inline bool FullFilterBitsReader::HashMayMatch(const uint32_t hash, const Slice&
   // The reason may be to support deserialization of filters which are already persisted in case we
   // change CACHE_LINE_SIZE or if machine architecture is changed.
   uint32_t cache_line_size = (len - FullFilterBitsBuilder::kMetaDataSize) / num_lines;
+  const uint32_t line_bits = cache_line_size * 8;
+  // Line size is power of 2 for all filters built by this code, so avoid division in the probe
+  // loop in this case.
+  const uint32_t line_bits_mask = (line_bits & (line_bits - 1)) == 0 ? line_bits - 1 : 0;
   const char* data = filter.cdata();
 
   uint32_t h = hash;
   const uint32_t delta = (h >> 17) | (h << 15);  // Rotate right 17 bits
-  uint32_t b = (h % num_lines) * (cache_line_size * 8);
+  uint32_t b = (h % num_lines) * line_bits;
 
   for (uint32_t i = 0; i < num_probes; ++i) {
-    // Since CACHE_LINE_SIZE is defined as 2^n, this line will be optimized
-    //  to a simple and operation by compiler.
-    const uint32_t bitpos = b + (h % (cache_line_size * 8));
+    const uint32_t bitpos = b + (line_bits_mask ? h & line_bits_mask : h % line_bits);
     if (((data[bitpos / 8]) & (1 << (bitpos % 8))) == 0) {
       return false;
     }
@@ -291,9 +294,10 @@ inline bool FullFilterBitsReader::HashMayMatch(const uint32_t hash, const Slice&
 // An implementation of filter policy
 class BloomFilterPolicy : public FilterPolicy {
  public:
-  explicit BloomFilterPolicy(int bits_per_key, bool use_block_based_builder)
+  explicit BloomFilterPolicy(int bits_per_key, bool use_block_based_builder,
+                             FilterBitsFormat format = FilterBitsFormat::kBloom)
       : bits_per_key_(bits_per_key), hash_func_(BloomHash),
-        use_block_based_builder_(use_block_based_builder) {
+        use_block_based_builder_(use_block_based_builder), format_(format) {
     initialize();
   }
 
@@ -369,11 +373,17 @@ class BloomFilterPolicy : public FilterPolicy {
       return nullptr;
     }
 
+    if (format_ == FilterBitsFormat::kRibbon) {
+      return new RibbonFilterBitsBuilder(bits_per_key_);
+    }
     return new FullFilterBitsBuilder(bits_per_key_, num_probes_);
   }
 
   FilterBitsReader* GetFilterBitsReader(const Slice& contents)
       const override {
+    if (IsRibbonFilter(contents)) {
+      return new RibbonFilterBitsReader(contents);
+    }
     return new FullFilterBitsReader(contents, nullptr);
   }
 
@@ -386,6 +396,7 @@ class BloomFilterPolicy : public FilterPolicy {
   uint32_t (*hash_func_)(const Slice& key);
 
   const bool use_block_based_builder_;
+  const FilterBitsFormat format_;
 
   void initialize() {
     // We intentionally round down to reduce probing cost a little bit
@@ -492,10 +503,12 @@ class FixedSizeFilterBitsReader : public FullFilterBitsReader {
 
 class FixedSizeFilterPolicy : public FilterPolicy {
  public:
-  explicit FixedSizeFilterPolicy(uint32_t total_bits, double error_rate, Logger* logger)
+  explicit FixedSizeFilterPolicy(uint32_t total_bits, double error_rate, Logger* logger,
+                                 FilterBitsFormat format)
       : total_bits_(total_bits),
         error_rate_(error_rate),
-        logger_(logger) {
+        logger_(logger),
+        format_(format) {
     DCHECK_GT(error_rate, 0);
     // Make sure num_probes > 0.
     DCHECK_GT(static_cast<int64_t> (-log(error_rate) / LOG2), 0);
@@ -519,10 +532,16 @@ class FixedSizeFilterPolicy : public FilterPolicy {
   }
 
   virtual FilterBitsBuilder* GetFilterBitsBuilder() const override {
+    if (format_ == FilterBitsFormat::kRibbon) {
+      return new FixedSizeRibbonFilterBitsBuilder(total_bits_, error_rate_);
+    }
     return new FixedSizeFilterBitsBuilder(total_bits_, error_rate_);
   }
 
   virtual FilterBitsReader* GetFilterBitsReader(const Slice& contents) const override {
+    if (IsRibbonFilter(contents)) {
+      return new RibbonFilterBitsReader(contents);
+    }
     return new FixedSizeFilterBitsReader(contents, logger_);
   }
 
@@ -532,6 +551,7 @@ class FixedSizeFilterPolicy : public FilterPolicy {
   uint32_t total_bits_;
   double error_rate_;
   Logger* logger_;
+  FilterBitsFormat format_;
 };
 
 }  // namespace
@@ -544,8 +564,14 @@ const FilterPolicy* NewBloomFilterPolicy(int bits_per_key,
 
 const FilterPolicy* NewFixedSizeFilterPolicy(uint32_t total_bits,
                                              double error_rate,
-                                             Logger* logger) {
-  return new FixedSizeFilterPolicy(total_bits, error_rate, logger);
+                                             Logger* logger,
+                                             FilterBitsFormat format) {
+  return new FixedSizeFilterPolicy(total_bits, error_rate, logger, format);
+}
+
+const FilterPolicy* NewRibbonFilterPolicy(int bits_per_key) {
+  return new BloomFilterPolicy(bits_per_key, /* use_block_based_builder= */ false,
+                               FilterBitsFormat::kRibbon);
 }
 
 }  // namespace rocksdb
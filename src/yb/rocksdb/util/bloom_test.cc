@@ -202,6 +202,11 @@ class BloomTestContext {
 
 class FullFilterBloomTestContext : public BloomTestContext {
  public:
+  FullFilterBloomTestContext() : filter_policy_(NewBloomFilterPolicy(FLAGS_bits_per_key, false)) {}
+
+  explicit FullFilterBloomTestContext(const FilterPolicy* filter_policy)
+      : filter_policy_(filter_policy) {}
+
   const FilterPolicy& filter_policy() const override { return *filter_policy_.get(); }
 
   size_t max_keys() const override { return 10000; }
@@ -211,12 +216,16 @@ class FullFilterBloomTestContext : public BloomTestContext {
   }
 
  private:
-  std::unique_ptr<const FilterPolicy> filter_policy_{
-      NewBloomFilterPolicy(FLAGS_bits_per_key, false)};
+  std::unique_ptr<const FilterPolicy> filter_policy_;
 };
 
 class FixedSizeFilterBloomTestContext : public BloomTestContext {
  public:
+  explicit FixedSizeFilterBloomTestContext(FilterBitsFormat format = FilterBitsFormat::kBloom)
+      : filter_policy_(NewFixedSizeFilterPolicy(
+            FilterPolicy::kDefaultFixedSizeFilterBits,
+            FilterPolicy::kDefaultFixedSizeFilterErrorRate, nullptr, format)) {}
+
   const FilterPolicy& filter_policy() const override { return *filter_policy_.get(); }
 
   // For fixed-size filter we limit maximum number of keys depending on total bits in test itself
@@ -228,13 +237,11 @@ class FixedSizeFilterBloomTestContext : public BloomTestContext {
   }
 
  private:
-  std::unique_ptr<const FilterPolicy> filter_policy_{
-      NewFixedSizeFilterPolicy(
-          FilterPolicy::kDefaultFixedSizeFilterBits, FilterPolicy::kDefaultFixedSizeFilterErrorRate,
-          nullptr)};
+  std::unique_ptr<const FilterPolicy> filter_policy_;
 };
 
-YB_DEFINE_ENUM(BuilderReaderBloomTestType, (kFullFilter)(kFixedSizeFilter));
+YB_DEFINE_ENUM(BuilderReaderBloomTestType,
+               (kFullFilter)(kFixedSizeFilter)(kRibbonFullFilter)(kRibbonFixedSizeFilter));
 
 namespace {
 
@@ -244,6 +251,11 @@ std::unique_ptr<const BloomTestContext> CreateContext(BuilderReaderBloomTestType
       return std::make_unique<FullFilterBloomTestContext>();
     case BuilderReaderBloomTestType::kFixedSizeFilter:
       return std::make_unique<FixedSizeFilterBloomTestContext>();
+    case BuilderReaderBloomTestType::kRibbonFullFilter:
+      return std::make_unique<FullFilterBloomTestContext>(
+          NewRibbonFilterPolicy(FLAGS_bits_per_key));
+    case BuilderReaderBloomTestType::kRibbonFixedSizeFilter:
+      return std::make_unique<FixedSizeFilterBloomTestContext>(FilterBitsFormat::kRibbon);
   }
   FATAL_INVALID_ENUM_VALUE(BuilderReaderBloomTestType, type);
 }
@@ -372,7 +384,88 @@ TEST_P(BuilderReaderBloomTest, FullVaryingLengths) {
 
 INSTANTIATE_TEST_CASE_P(, BuilderReaderBloomTest, ::testing::Values(
     BuilderReaderBloomTestType::kFullFilter,
-    BuilderReaderBloomTestType::kFixedSizeFilter));
+    BuilderReaderBloomTestType::kFixedSizeFilter,
+    BuilderReaderBloomTestType::kRibbonFullFilter,
+    BuilderReaderBloomTestType::kRibbonFixedSizeFilter));
+
+namespace {
+
+// Fills filter built by the specified policy until it is full, returns number of added keys.
+size_t FillFixedSizeFilter(
+    const FilterPolicy& policy, std::unique_ptr<const char[]>* buf, Slice* filter) {
+  std::unique_ptr<FilterBitsBuilder> builder(policy.GetFilterBitsBuilder());
+  char buffer[sizeof(size_t)];
+  size_t num_keys = 0;
+  while (!builder->IsFull()) {
+    builder->AddKey(Key(num_keys, buffer));
+    ++num_keys;
+  }
+  *filter = builder->Finish(buf);
+  return num_keys;
+}
+
+} // namespace
+
+// Filters of both formats should be readable by policies of both formats, and ribbon filter
+// should fit more keys into the fixed size filter block.
+TEST(RibbonFilterTest, FixedSizeFormatCompatibility) {
+  std::unique_ptr<const FilterPolicy> bloom_policy(NewFixedSizeFilterPolicy(
+      FilterPolicy::kDefaultFixedSizeFilterBits, FilterPolicy::kDefaultFixedSizeFilterErrorRate,
+      nullptr, FilterBitsFormat::kBloom));
+  std::unique_ptr<const FilterPolicy> ribbon_policy(NewFixedSizeFilterPolicy(
+      FilterPolicy::kDefaultFixedSizeFilterBits, FilterPolicy::kDefaultFixedSizeFilterErrorRate,
+      nullptr, FilterBitsFormat::kRibbon));
+
+  std::unique_ptr<const char[]> bloom_buf, ribbon_buf;
+  Slice bloom_filter, ribbon_filter;
+  const size_t bloom_keys = FillFixedSizeFilter(*bloom_policy, &bloom_buf, &bloom_filter);
+  const size_t ribbon_keys = FillFixedSizeFilter(*ribbon_policy, &ribbon_buf, &ribbon_filter);
+  LOG(INFO) << "Bloom filter: " << bloom_keys << " keys in " << bloom_filter.size()
+            << " bytes, ribbon filter: " << ribbon_keys << " keys in " << ribbon_filter.size()
+            << " bytes";
+  ASSERT_LE(ribbon_filter.size(), FilterPolicy::kDefaultFixedSizeFilterBits / 8 + 64 + 5);
+  ASSERT_GT(ribbon_keys, bloom_keys * 6 / 5);
+
+  char buffer[sizeof(size_t)];
+  for (const auto* policy : {bloom_policy.get(), ribbon_policy.get()}) {
+    std::unique_ptr<FilterBitsReader> bloom_reader(policy->GetFilterBitsReader(bloom_filter));
+    std::unique_ptr<FilterBitsReader> ribbon_reader(policy->GetFilterBitsReader(ribbon_filter));
+    for (size_t i = 0; i != ribbon_keys; ++i) {
+      const Slice key = Key(i, buffer);
+      if (i < bloom_keys) {
+        ASSERT_TRUE(bloom_reader->MayMatch(key)) << i;
+      }
+      ASSERT_TRUE(ribbon_reader->MayMatch(key)) << i;
+    }
+    size_t false_positives = 0;
+    for (size_t i = 0; i != 10000; ++i) {
+      false_positives += ribbon_reader->MayMatch(Key(i + 1000000000, buffer));
+    }
+    ASSERT_LE(false_positives, 10000 * FilterPolicy::kDefaultFixedSizeFilterErrorRate);
+  }
+}
+
+TEST(RibbonFilterTest, FullFormatCompatibility) {
+  std::unique_ptr<const FilterPolicy> bloom_policy(NewBloomFilterPolicy(FLAGS_bits_per_key, false));
+  std::unique_ptr<const FilterPolicy> ribbon_policy(NewRibbonFilterPolicy(FLAGS_bits_per_key));
+  ASSERT_STREQ(bloom_policy->Name(), ribbon_policy->Name());
+
+  constexpr size_t kNumKeys = 10000;
+  std::unique_ptr<FilterBitsBuilder> builder(ribbon_policy->GetFilterBitsBuilder());
+  char buffer[sizeof(size_t)];
+  for (size_t i = 0; i != kNumKeys; ++i) {
+    builder->AddKey(Key(i, buffer));
+  }
+  std::unique_ptr<const char[]> buf;
+  const Slice filter = builder->Finish(&buf);
+  // Bloom filter takes FLAGS_bits_per_key bits per key.
+  ASSERT_LT(filter.size(), kNumKeys * FLAGS_bits_per_key / 8 * 4 / 5);
+
+  std::unique_ptr<FilterBitsReader> reader(bloom_policy->GetFilterBitsReader(filter));
+  for (size_t i = 0; i != kNumKeys; ++i) {
+    ASSERT_TRUE(reader->MayMatch(Key(i, buffer))) << i;
+  }
+}
 
 }  // namespace rocksdb
 
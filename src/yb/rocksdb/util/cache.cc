@@ -78,6 +78,10 @@ namespace {
 // that are accessed multiple times by different queries.
 // query_id == kNoCacheQueryId means that this Handle is not going to be added
 // into the cache.
+// query_id == kLowPriorityQueryId means that the handle was added by low priority read, and was
+// not touched by other queries yet. Such handle is placed to the oldest end of the single touch LRU
+// list, i.e. midpoint between two caches, so it is evicted before regular single touch values.
+// The first touch by a regular query makes it a regular single touch value.
 
 struct LRUHandle {
   void* value;
@@ -169,8 +173,14 @@ class HandleTable {
       return MULTI_TOUCH;
     }
 
+    if (h->query_id == kLowPriorityQueryId) {
+      return SINGLE_TOUCH;
+    }
+
     LRUHandle* val = Lookup(h->key(), h->hash);
-    if (val != nullptr && (val->GetSubCacheType() == MULTI_TOUCH || val->query_id != h->query_id)) {
+    if (val != nullptr &&
+        (val->GetSubCacheType() == MULTI_TOUCH ||
+         (val->query_id != h->query_id && val->query_id != kLowPriorityQueryId))) {
       h->query_id = kInMultiTouchId;
       return MULTI_TOUCH;
     }
@@ -305,6 +315,7 @@ class LRUSubCache {
 
   void LRU_Remove(LRUHandle* e);
   void LRU_Append(LRUHandle *e);
+  void LRU_Prepend(LRUHandle *e);
 
  private:
   // Dummy heads of single-touch and multi-touch LRU list.
@@ -352,6 +363,17 @@ void LRUSubCache::LRU_Append(LRUHandle *e) {
   lru_usage_ += e->charge;
 }
 
+// Prepend to the LRU header of the sub cache, so the handle is the next one to be evicted.
+void LRUSubCache::LRU_Prepend(LRUHandle *e) {
+  assert(e->next == nullptr);
+  assert(e->prev == nullptr);
+  e->prev = &lru_;
+  e->next = lru_.next;
+  e->prev->next = e;
+  e->next->prev = e;
+  lru_usage_ += e->charge;
+}
+
 // A single shard of sharded cache.
 class LRUCache {
  public:
@@ -477,8 +499,14 @@ void LRUCache::LRU_Remove(LRUHandle* e) {
 }
 
 void LRUCache::LRU_Append(LRUHandle* e) {
-  // Make "e" newest entry by inserting just before lru_
-  GetSubCache(e->GetSubCacheType())->LRU_Append(e);
+  LRUSubCache* sub_cache = GetSubCache(e->GetSubCacheType());
+  if (e->query_id == kLowPriorityQueryId) {
+    // Make "e" oldest entry by inserting just after lru_
+    sub_cache->LRU_Prepend(e);
+  } else {
+    // Make "e" newest entry by inserting just before lru_
+    sub_cache->LRU_Append(e);
+  }
 }
 
 
@@ -533,9 +561,14 @@ Cache::Handle* LRUCache::Lookup(const Slice& key, uint32_t hash, const QueryId q
     // Increase the number of references and move to state 1. (in cache and not in LRU)
     e->refs++;
 
-    // Now the handle will be added to the multi touch pool only if it exists.
-    if (FLAGS_cache_single_touch_ratio < 1 && e->GetSubCacheType() != MULTI_TOUCH &&
-        e->query_id != query_id) {
+    // Low priority reads never move the handle to the multi touch pool. The first touch by a
+    // regular query makes the handle added by low priority read a regular single touch handle.
+    if (e->query_id == kLowPriorityQueryId && query_id >= 0) {
+      e->query_id = query_id;
+    } else if (FLAGS_cache_single_touch_ratio < 1 && e->GetSubCacheType() != MULTI_TOUCH &&
+        e->query_id != query_id && e->query_id != kLowPriorityQueryId &&
+        query_id != kLowPriorityQueryId) {
+      // Now the handle will be added to the multi touch pool only if it exists.
       autovector<LRUHandle*> multi_touch_eviction_list;
       EvictFromLRU(e->charge, &multi_touch_eviction_list, MULTI_TOUCH);
       for (auto entry : multi_touch_eviction_list) {
@@ -663,6 +696,9 @@ Status LRUCache::Insert(const Slice& key, uint32_t hash, const QueryId query_id,
       subcache_type = MULTI_TOUCH;
     } else if (FLAGS_cache_single_touch_ratio == 1) {
       // If there is no multi touch cache, default to single cache.
+      if (e->query_id == kInMultiTouchId) {
+        e->query_id = kDefaultQueryId;
+      }
       subcache_type = SINGLE_TOUCH;
     } else {
       subcache_type = table_.GetSubCacheTypeCandidate(e);
@@ -785,7 +821,8 @@ class ShardedLRUCache : public Cache {
   }
 
   bool IsValidQueryId(const QueryId query_id) {
-    return query_id >= 0 || query_id == kInMultiTouchId || query_id == kNoCacheQueryId;
+    return query_id >= 0 || query_id == kInMultiTouchId || query_id == kNoCacheQueryId ||
+           query_id == kLowPriorityQueryId;
   }
 
  public:
@@ -463,6 +463,58 @@ TEST_F(CacheTest, EvictionPolicyMultiTouch) {
   ASSERT_LT(kCacheSize * FLAGS_cache_single_touch_ratio, cache_->GetUsage());
 }
 
+TEST_F(CacheTest, EvictionPolicyLowPriority) {
+  const int kCapacity = 100;
+  const int kSingleTouchCapacity = kCapacity * FLAGS_cache_single_touch_ratio;
+  const int kNumRegular = kSingleTouchCapacity / 2;
+  auto cache = NewLRUCache(kCapacity, 0);
+  for (int i = 0; i < kNumRegular; i++) {
+    ASSERT_OK(Insert(cache, i, i + 1, 1, kTestQueryId));
+  }
+
+  // Values added by low priority reads are evicted before regular single touch values.
+  for (int i = 0; i < kCapacity; i++) {
+    ASSERT_OK(Insert(cache, 1000 + i, 2000 + i, 1, kLowPriorityQueryId));
+  }
+  for (int i = 0; i < kNumRegular; i++) {
+    ASSERT_EQ(i + 1, Lookup(cache, i, kTestQueryId));
+  }
+  int num_low_priority = 0;
+  for (int i = 0; i < kCapacity; i++) {
+    if (Lookup(cache, 1000 + i, kLowPriorityQueryId) != -1) {
+      ++num_low_priority;
+    }
+  }
+  ASSERT_EQ(kSingleTouchCapacity - kNumRegular, num_low_priority);
+  ASSERT_EQ(kSingleTouchCapacity, cache->GetUsage());
+}
+
+TEST_F(CacheTest, LowPriorityMultiTouch) {
+  const int kCapacity = 100;
+  auto cache = NewLRUCache(kCapacity, 0);
+  QueryId qid1 = 1000;
+  QueryId qid2 = 1001;
+
+  // Low priority reads do not move regular value to multi touch cache.
+  ASSERT_OK(Insert(cache, 100, 101, 1, qid1));
+  ASSERT_FALSE(LookupAndCheckInMultiTouch(cache, 100, 101, kLowPriorityQueryId));
+  ASSERT_TRUE(LookupAndCheckInMultiTouch(cache, 100, 101, qid2));
+
+  // Value added by low priority read becomes regular single touch value after the first touch by
+  // regular query, and is moved to multi touch cache by the second query.
+  ASSERT_OK(Insert(cache, 200, 201, 1, kLowPriorityQueryId));
+  ASSERT_FALSE(LookupAndCheckInMultiTouch(cache, 200, 201, qid1));
+  for (int i = 0; i < kCapacity; i++) {
+    ASSERT_OK(Insert(cache, 1000 + i, 2000 + i, 1, kLowPriorityQueryId));
+  }
+  ASSERT_FALSE(LookupAndCheckInMultiTouch(cache, 200, 201, qid1));
+  ASSERT_TRUE(LookupAndCheckInMultiTouch(cache, 200, 201, qid2));
+
+  // Values inserted with kInMultiTouchId are placed directly to multi touch cache.
+  ASSERT_OK(Insert(cache, 300, 301, 1, kInMultiTouchId));
+  ASSERT_TRUE(LookupAndCheckInMultiTouch(cache, 300, 301, qid1));
+}
+
 TEST_F(CacheTest, HeavyEntries) {
   // Add a bunch of light and heavy entries and then count the combined
   // size of items still in the cache, which must be approximately the
@@ -228,6 +228,16 @@ inline int VarintLength(uint64_t v) {
   return len;
 }
 
+// Maps signed values to unsigned ones, so values with small absolute value have short varint
+// encoding.
+inline uint64_t ZigZagEncode64(int64_t v) {
+  return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+inline int64_t ZigZagDecode64(uint64_t v) {
+  return static_cast<int64_t>((v >> 1) ^ (~(v & 1) + 1));
+}
+
 inline bool GetFixed64(Slice* input, uint64_t* value) {
   if (input->size() < sizeof(uint64_t)) {
     return false;
@@ -49,6 +49,9 @@
 
 #if defined(ZSTD)
 #include <zstd.h>
+#if ZSTD_VERSION_NUMBER >= 10103  // v1.1.3+
+#include <zdict.h>
+#endif
 #endif
 
 namespace rocksdb {
@@ -110,6 +113,30 @@ inline bool CompressionTypeSupported(CompressionType compression_type) {
   }
 }
 
+// Whether data blocks compressed with compression_type could share a dictionary, see
+// CompressionOptions::max_dict_bytes.
+inline bool CompressionDictSupported(CompressionType compression_type) {
+  switch (compression_type) {
+    case kZlibCompression:
+      return Zlib_Supported();
+    case kLZ4Compression: FALLTHROUGH_INTENDED;
+    case kLZ4HCCompression:
+#if defined(LZ4) && LZ4_VERSION_NUMBER >= 10400  // r124+
+      return true;
+#else
+      return false;
+#endif
+    case kZSTDNotFinalCompression:
+#if defined(ZSTD) && ZSTD_VERSION_NUMBER >= 500  // v0.5.0+
+      return true;
+#else
+      return false;
+#endif
+    default:
+      return false;
+  }
+}
+
 inline std::string CompressionTypeToString(CompressionType compression_type) {
   switch (compression_type) {
     case kNoCompression:
@@ -198,7 +225,8 @@ inline bool GetDecompressedSizeInfo(const char** input_data,
 inline bool Zlib_Compress(const CompressionOptions& opts,
                           uint32_t compress_format_version,
                           const char* input, size_t length,
-                          ::std::string* output) {
+                          ::std::string* output,
+                          const Slice& compression_dict = Slice()) {
 #ifdef ZLIB
   if (length > std::numeric_limits<uint32_t>::max()) {
     // Can't compress more than 4GB
@@ -228,6 +256,16 @@ inline bool Zlib_Compress(const CompressionOptions& opts,
     return false;
   }
 
+  if (!compression_dict.empty()) {
+    st = deflateSetDictionary(
+        &_stream, reinterpret_cast<const Bytef*>(compression_dict.data()),
+        static_cast<unsigned int>(compression_dict.size()));
+    if (st != Z_OK) {
+      deflateEnd(&_stream);
+      return false;
+    }
+  }
+
   // Compress the input, and put compressed data in output.
   _stream.next_in = (Bytef *)input;
   _stream.avail_in = static_cast<unsigned int>(length);
@@ -268,6 +306,7 @@ inline bool Zlib_Compress(const CompressionOptions& opts,
 inline char* Zlib_Uncompress(const char* input_data, size_t input_length,
                              int* decompress_size,
                              uint32_t compress_format_version,
+                             const Slice& compression_dict = Slice(),
                              int windowBits = -14) {
 #ifdef ZLIB
   uint32_t output_len = 0;
@@ -297,6 +336,17 @@ inline char* Zlib_Uncompress(const char* input_data, size_t input_length,
     return nullptr;
   }
 
+  // Raw inflate accepts the dictionary right away, before any input is processed.
+  if (!compression_dict.empty()) {
+    st = inflateSetDictionary(
+        &_stream, reinterpret_cast<const Bytef*>(compression_dict.data()),
+        static_cast<unsigned int>(compression_dict.size()));
+    if (st != Z_OK) {
+      inflateEnd(&_stream);
+      return nullptr;
+    }
+  }
+
   _stream.next_in = (Bytef *)input_data;
   _stream.avail_in = static_cast<unsigned int>(input_length);
 
@@ -498,7 +548,8 @@ inline char* BZip2_Uncompress(const char* input_data, size_t input_length,
 // header in varint32 format
 inline bool LZ4_Compress(const CompressionOptions& opts,
                          uint32_t compress_format_version, const char* input,
-                         size_t length, ::std::string* output) {
+                         size_t length, ::std::string* output,
+                         const Slice& compression_dict = Slice()) {
 #ifdef LZ4
   if (length > std::numeric_limits<uint32_t>::max()) {
     // Can't compress more than 4GB
@@ -521,9 +572,23 @@ inline bool LZ4_Compress(const CompressionOptions& opts,
 
   int compressBound = LZ4_compressBound(static_cast<int>(length));
   output->resize(static_cast<size_t>(output_header_len + compressBound));
-  int outlen =
-      LZ4_compress_limitedOutput(input, &(*output)[output_header_len],
-                                 static_cast<int>(length), compressBound);
+  int outlen;
+#if LZ4_VERSION_NUMBER >= 10400  // r124+
+  if (!compression_dict.empty()) {
+    LZ4_stream_t* stream = LZ4_createStream();
+    LZ4_loadDict(stream, compression_dict.cdata(), static_cast<int>(compression_dict.size()));
+    outlen = LZ4_compress_fast_continue(
+        stream, input, &(*output)[output_header_len], static_cast<int>(length), compressBound,
+        1 /* acceleration */);
+    LZ4_freeStream(stream);
+  } else {
+    outlen = LZ4_compress_limitedOutput(input, &(*output)[output_header_len],
+                                        static_cast<int>(length), compressBound);
+  }
+#else
+  outlen = LZ4_compress_limitedOutput(input, &(*output)[output_header_len],
+                                      static_cast<int>(length), compressBound);
+#endif
   if (outlen == 0) {
     return false;
   }
@@ -539,7 +604,8 @@ inline bool LZ4_Compress(const CompressionOptions& opts,
 // header in varint32 format
 inline char* LZ4_Uncompress(const char* input_data, size_t input_length,
                             int* decompress_size,
-                            uint32_t compress_format_version) {
+                            uint32_t compress_format_version,
+                            const Slice& compression_dict = Slice()) {
 #ifdef LZ4
   uint32_t output_len = 0;
   if (compress_format_version == 2) {
@@ -559,9 +625,24 @@ inline char* LZ4_Uncompress(const char* input_data, size_t input_length,
     input_data += 8;
   }
   char* output = new char[output_len];
+#if LZ4_VERSION_NUMBER >= 10400  // r124+
+  if (!compression_dict.empty()) {
+    LZ4_streamDecode_t* stream = LZ4_createStreamDecode();
+    LZ4_setStreamDecode(
+        stream, compression_dict.cdata(), static_cast<int>(compression_dict.size()));
+    *decompress_size = LZ4_decompress_safe_continue(
+        stream, input_data, output, static_cast<int>(input_length), static_cast<int>(output_len));
+    LZ4_freeStreamDecode(stream);
+  } else {
+    *decompress_size =
+        LZ4_decompress_safe(input_data, output, static_cast<int>(input_length),
+                            static_cast<int>(output_len));
+  }
+#else
   *decompress_size =
       LZ4_decompress_safe(input_data, output, static_cast<int>(input_length),
                           static_cast<int>(output_len));
+#endif
   if (*decompress_size < 0) {
     delete[] output;
     return nullptr;
@@ -578,7 +659,8 @@ inline char* LZ4_Uncompress(const char* input_data, size_t input_length,
 // header in varint32 format
 inline bool LZ4HC_Compress(const CompressionOptions& opts,
                            uint32_t compress_format_version, const char* input,
-                           size_t length, ::std::string* output) {
+                           size_t length, ::std::string* output,
+                           const Slice& compression_dict = Slice()) {
 #ifdef LZ4
   if (length > std::numeric_limits<uint32_t>::max()) {
     // Can't compress more than 4GB
@@ -602,7 +684,20 @@ inline bool LZ4HC_Compress(const CompressionOptions& opts,
   int compressBound = LZ4_compressBound(static_cast<int>(length));
   output->resize(static_cast<size_t>(output_header_len + compressBound));
   int outlen;
-#ifdef LZ4_VERSION_MAJOR  // they only started defining this since r113
+#if LZ4_VERSION_NUMBER >= 10400  // r124+
+  if (!compression_dict.empty()) {
+    LZ4_streamHC_t* stream = LZ4_createStreamHC();
+    LZ4_resetStreamHC(stream, opts.level);
+    LZ4_loadDictHC(stream, compression_dict.cdata(), static_cast<int>(compression_dict.size()));
+    outlen = LZ4_compress_HC_continue(
+        stream, input, &(*output)[output_header_len], static_cast<int>(length), compressBound);
+    LZ4_freeStreamHC(stream);
+  } else {
+    outlen = LZ4_compressHC2_limitedOutput(input, &(*output)[output_header_len],
+                                           static_cast<int>(length),
+                                           compressBound, opts.level);
+  }
+#elif defined(LZ4_VERSION_MAJOR)  // they only started defining this since r113
   outlen = LZ4_compressHC2_limitedOutput(input, &(*output)[output_header_len],
                                          static_cast<int>(length),
                                          compressBound, opts.level);
@@ -621,7 +716,8 @@ inline bool LZ4HC_Compress(const CompressionOptions& opts,
 }
 
 inline bool ZSTD_Compress(const CompressionOptions& opts, const char* input,
-                          size_t length, ::std::string* output) {
+                          size_t length, ::std::string* output,
+                          const Slice& compression_dict = Slice()) {
 #ifdef ZSTD
   if (length > std::numeric_limits<uint32_t>::max()) {
     // Can't compress more than 4GB
@@ -633,8 +729,16 @@ inline bool ZSTD_Compress(const CompressionOptions& opts, const char* input,
 
   size_t compressBound = ZSTD_compressBound(length);
   output->resize(static_cast<size_t>(output_header_len + compressBound));
-  size_t outlen = ZSTD_compress(&(*output)[output_header_len], compressBound,
-                                input, length, opts.level);
+  size_t outlen;
+#if ZSTD_VERSION_NUMBER >= 500  // v0.5.0+
+  ZSTD_CCtx* context = ZSTD_createCCtx();
+  outlen = ZSTD_compress_usingDict(
+      context, &(*output)[output_header_len], compressBound, input, length,
+      compression_dict.data(), compression_dict.size(), opts.level);
+  ZSTD_freeCCtx(context);
+#else
+  outlen = ZSTD_compress(&(*output)[output_header_len], compressBound, input, length, opts.level);
+#endif
   if (outlen == 0) {
     return false;
   }
@@ -645,7 +749,8 @@ inline bool ZSTD_Compress(const CompressionOptions& opts, const char* input,
 }
 
 inline char* ZSTD_Uncompress(const char* input_data, size_t input_length,
-                             int* decompress_size) {
+                             int* decompress_size,
+                             const Slice& compression_dict = Slice()) {
 #ifdef ZSTD
   uint32_t output_len = 0;
   if (!compression::GetDecompressedSizeInfo(&input_data, &input_length,
@@ -654,8 +759,16 @@ inline char* ZSTD_Uncompress(const char* input_data, size_t input_length,
   }
 
   char* output = new char[output_len];
+#if ZSTD_VERSION_NUMBER >= 500  // v0.5.0+
+  ZSTD_DCtx* context = ZSTD_createDCtx();
+  size_t actual_output_length = ZSTD_decompress_usingDict(
+      context, output, output_len, input_data, input_length, compression_dict.data(),
+      compression_dict.size());
+  ZSTD_freeDCtx(context);
+#else
   size_t actual_output_length =
       ZSTD_decompress(output, output_len, input_data, input_length);
+#endif
   assert(actual_output_length == output_len);
   *decompress_size = static_cast<int>(actual_output_length);
   return output;
@@ -663,4 +776,25 @@ inline char* ZSTD_Uncompress(const char* input_data, size_t input_length,
   return nullptr;
 }
 
+// Trains a ZSTD dictionary of at most max_dict_bytes on samples, which are concatenated in
+// samples and have sizes sample_lens. Returns an empty dictionary if training is not supported or
+// failed, so callers could fall back to raw samples.
+inline std::string ZSTD_TrainDictionary(const std::string& samples,
+                                        const std::vector<size_t>& sample_lens,
+                                        size_t max_dict_bytes) {
+#if defined(ZSTD) && ZSTD_VERSION_NUMBER >= 10103  // v1.1.3+
+  std::string dict(max_dict_bytes, '\0');
+  size_t dict_len = ZDICT_trainFromBuffer(
+      &dict[0], max_dict_bytes, samples.data(), sample_lens.data(),
+      static_cast<unsigned>(sample_lens.size()));
+  if (ZDICT_isError(dict_len)) {
+    return std::string();
+  }
+  dict.resize(dict_len);
+  return dict;
+#else
+  return std::string();
+#endif
+}
+
 }  // namespace rocksdb
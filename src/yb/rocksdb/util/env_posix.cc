@@ -180,9 +180,18 @@ class PosixEnv : public Env {
     result->reset();
     Status s;
     int fd;
+    int flags = O_RDONLY;
+    // Direct I/O is only used on Linux, other platforms read through the page cache.
+    bool direct_reads = false;
+#ifdef OS_LINUX
+    if (options.use_direct_reads && !options.use_mmap_reads) {
+      flags |= O_DIRECT;
+      direct_reads = true;
+    }
+#endif
     {
       IOSTATS_TIMER_GUARD(open_nanos);
-      fd = open(fname.c_str(), O_RDONLY);
+      fd = open(fname.c_str(), flags);
     }
     SetFD_CLOEXEC(fd, &options);
     if (fd < 0) {
@@ -204,7 +213,9 @@ class PosixEnv : public Env {
       }
       close(fd);
     } else {
-      result->reset(new PosixRandomAccessFile(fname, fd, options));
+      EnvOptions random_access_options = options;
+      random_access_options.use_direct_reads = direct_reads;
+      result->reset(new PosixRandomAccessFile(fname, fd, random_access_options));
     }
     return s;
   }
@@ -215,12 +226,26 @@ class PosixEnv : public Env {
     result->reset();
     Status s;
     int fd = -1;
+    int flags = O_CREAT | O_RDWR | O_TRUNC;
+    // Direct I/O is only used on Linux, other platforms write through the page cache.
+    bool direct_writes = false;
+#ifdef OS_LINUX
+    if (options.use_direct_writes) {
+      flags |= O_DIRECT;
+      direct_writes = true;
+    }
+#endif
     do {
       IOSTATS_TIMER_GUARD(open_nanos);
-      fd = open(fname.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0644);
+      fd = open(fname.c_str(), flags, 0644);
     } while (fd < 0 && errno == EINTR);
     if (fd < 0) {
       s = IOError(fname, errno);
+    } else if (direct_writes) {
+      SetFD_CLOEXEC(fd, &options);
+      EnvOptions direct_options = options;
+      direct_options.use_mmap_writes = false;
+      result->reset(new PosixWritableFile(fname, fd, direct_options));
     } else {
       SetFD_CLOEXEC(fd, &options);
       if (options.use_mmap_writes) {
@@ -239,6 +264,7 @@ class PosixEnv : public Env {
         // disable mmap writes
         EnvOptions no_mmap_writes_options = options;
         no_mmap_writes_options.use_mmap_writes = false;
+        no_mmap_writes_options.use_direct_writes = false;
 
         result->reset(new PosixWritableFile(fname, fd, no_mmap_writes_options));
       }
@@ -283,6 +309,7 @@ class PosixEnv : public Env {
         // disable mmap writes
         EnvOptions no_mmap_writes_options = options;
         no_mmap_writes_options.use_mmap_writes = false;
+        no_mmap_writes_options.use_direct_writes = false;
 
         result->reset(new PosixWritableFile(fname, fd, no_mmap_writes_options));
       }
@@ -460,6 +487,9 @@ class PosixEnv : public Env {
                         Priority pri = LOW, void* tag = nullptr,
                         void (*unschedFunction)(void* arg) = 0) override;
 
+  void ScheduleWithScore(void (*function)(void* arg), void* arg, Priority pri, void* tag,
+                         void (*unschedFunction)(void* arg), double score) override;
+
   int UnSchedule(void* arg, Priority pri) override;
 
   void StartThread(void (*function)(void* arg), void* arg) override;
@@ -709,6 +739,12 @@ void PosixEnv::Schedule(void (*function)(void* arg1), void* arg, Priority pri,
   thread_pools_[pri].Schedule(function, arg, tag, unschedFunction);
 }
 
+void PosixEnv::ScheduleWithScore(void (*function)(void* arg1), void* arg, Priority pri,
+                                 void* tag, void (*unschedFunction)(void* arg), double score) {
+  assert(pri >= Priority::LOW && pri <= Priority::HIGH);
+  thread_pools_[pri].Schedule(function, arg, tag, unschedFunction, score);
+}
+
 int PosixEnv::UnSchedule(void* arg, Priority pri) {
   return thread_pools_[pri].UnSchedule(arg);
 }
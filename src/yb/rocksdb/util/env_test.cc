@@ -46,6 +46,7 @@
 #include "yb/rocksdb/env.h"
 #include "yb/rocksdb/port/port.h"
 #include "yb/rocksdb/util/coding.h"
+#include "yb/rocksdb/util/file_reader_writer.h"
 #include "yb/rocksdb/util/log_buffer.h"
 #include "yb/rocksdb/util/mutexlock.h"
 #include "yb/util/string_util.h"
@@ -156,6 +157,59 @@ TEST_F(EnvPosixTest, RunMany) {
   ASSERT_EQ(4, cur);
 }
 
+TEST_F(EnvPosixTest, ScheduleWithScore) {
+  env_->SetBackgroundThreads(1, Env::LOW);
+
+  // Block the low priority queue, so that the work below is queued.
+  test::SleepingBackgroundTask sleeping_task;
+  env_->Schedule(&test::SleepingBackgroundTask::DoSleepTask, &sleeping_task, Env::Priority::LOW);
+  sleeping_task.WaitUntilSleeping();
+
+  struct CB {
+    port::Mutex* mutex;
+    std::vector<int>* order;
+    int id;
+
+    static void Run(void* v) {
+      CB* cb = reinterpret_cast<CB*>(v);
+      MutexLock lock(cb->mutex);
+      cb->order->push_back(cb->id);
+    }
+  };
+
+  port::Mutex mutex;
+  std::vector<int> order;
+  const std::vector<double> scores = {1, 3, 0, 2, 3};
+  std::vector<CB> callbacks;
+  for (size_t i = 0; i != scores.size(); ++i) {
+    callbacks.push_back(CB{&mutex, &order, static_cast<int>(i)});
+  }
+  for (size_t i = 0; i != scores.size(); ++i) {
+    if (scores[i] == 0) {
+      env_->Schedule(&CB::Run, &callbacks[i], Env::Priority::LOW);
+    } else {
+      env_->ScheduleWithScore(
+          &CB::Run, &callbacks[i], Env::Priority::LOW, nullptr, nullptr, scores[i]);
+    }
+  }
+
+  sleeping_task.WakeUp();
+  sleeping_task.WaitUntilDone();
+  for (int i = 0; i < kDelayMicros; i++) {
+    {
+      MutexLock lock(&mutex);
+      if (order.size() == scores.size()) {
+        break;
+      }
+    }
+    Env::Default()->SleepForMicroseconds(1);
+  }
+
+  // Higher scores first, same scores in the order of scheduling.
+  MutexLock lock(&mutex);
+  ASSERT_EQ(std::vector<int>({1, 4, 3, 0, 2}), order);
+}
+
 struct State {
   port::Mutex mu;
   int val;
@@ -808,6 +862,57 @@ TEST_F(EnvPosixTest, InvalidateCache) {
   // Delete the file
   ASSERT_OK(env_->DeleteFile(fname));
 }
+
+TEST_F(EnvPosixTest, DirectIO) {
+  EnvOptions soptions;
+  soptions.use_direct_writes = true;
+  soptions.use_direct_reads = true;
+  std::string fname = test::TmpDir() + "/" + "testfile";
+
+  // Unaligned contents, so that the last page is partial.
+  std::string data;
+  Random rnd(301);
+  for (int i = 0; i != 3 * 4096 + 100; ++i) {
+    data.push_back(static_cast<char>(rnd.Uniform(256)));
+  }
+
+  {
+    unique_ptr<WritableFile> wfile;
+    Status s = env_->NewWritableFile(fname, &wfile, soptions);
+    if (!s.ok()) {
+      // Some file systems, e.g. tmpfs, do not support O_DIRECT.
+      LOG(INFO) << "Direct I/O is not supported in " << test::TmpDir() << ": " << s.ToString();
+      return;
+    }
+    ASSERT_TRUE(wfile->UseDirectIO());
+    WritableFileWriter writer(std::move(wfile), soptions);
+    // Appends of odd sizes, padded and rewritten by the writer.
+    ASSERT_OK(writer.Append(Slice(data.data(), 1000)));
+    ASSERT_OK(writer.Flush());
+    ASSERT_OK(writer.Append(Slice(data.data() + 1000, data.size() - 1000)));
+    ASSERT_OK(writer.Sync(false));
+    ASSERT_OK(writer.Close());
+  }
+
+  uint64_t file_size = 0;
+  ASSERT_OK(env_->GetFileSize(fname, &file_size));
+  ASSERT_EQ(data.size(), file_size);
+
+  {
+    unique_ptr<RandomAccessFile> file;
+    ASSERT_OK(env_->NewRandomAccessFile(fname, &file, soptions));
+    std::string scratch(data.size() + 100, 0);
+    Slice result;
+    // Unaligned read across pages.
+    ASSERT_OK(file->Read(10, 5000, &result, &scratch[0]));
+    ASSERT_EQ(Slice(data.data() + 10, 5000), result);
+    // Read past the end of the file.
+    ASSERT_OK(file->Read(4000, data.size(), &result, &scratch[0]));
+    ASSERT_EQ(Slice(data.data() + 4000, data.size() - 4000), result);
+  }
+
+  ASSERT_OK(env_->DeleteFile(fname));
+}
 #endif  // not TRAVIS
 #endif  // OS_LINUX
 
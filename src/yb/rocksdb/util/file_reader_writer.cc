@@ -224,7 +224,9 @@ Status WritableFileWriter::Sync(bool use_fsync) {
     return s;
   }
   TEST_KILL_RANDOM("WritableFileWriter::Sync:0", rocksdb_kill_odds);
-  if (!direct_io_ && pending_sync_) {
+  // Direct writes still need a sync: O_DIRECT neither persists the file size nor flushes the
+  // device cache.
+  if (pending_sync_) {
     s = SyncInternal(use_fsync);
     if (!s.ok()) {
       return s;
@@ -464,6 +466,10 @@ class ReadaheadRandomAccessFile : public RandomAccessFile {
 
   void Hint(AccessPattern pattern) override { file_->Hint(pattern); }
 
+  Status Prefetch(uint64_t offset, size_t n) override {
+    return file_->Prefetch(offset, n);
+  }
+
   Status InvalidateCache(size_t offset, size_t length) override {
     return file_->InvalidateCache(offset, length);
   }
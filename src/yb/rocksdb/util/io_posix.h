@@ -43,6 +43,9 @@ static Status IOError(const std::string& context, int err_number) {
   return STATUS(IOError, context, strerror(err_number));
 }
 
+// Alignment of offsets, sizes and buffers of direct I/O.
+constexpr size_t kDirectIOAlignment = 4096;
+
 class PosixSequentialFile : public SequentialFile {
  private:
   std::string filename_;
@@ -65,6 +68,12 @@ class PosixRandomAccessFile : public RandomAccessFile {
   std::string filename_;
   int fd_;
   bool use_os_buffer_;
+  // Whether the file is opened with O_DIRECT.
+  bool use_direct_io_;
+
+  // Reads the aligned range of the file that covers the requested one into an aligned buffer,
+  // and copies the requested range from it.
+  Status DirectRead(uint64_t offset, size_t n, Slice* result, char* scratch) const;
 
  public:
   PosixRandomAccessFile(const std::string& fname, int fd,
@@ -77,6 +86,7 @@ class PosixRandomAccessFile : public RandomAccessFile {
   virtual size_t GetUniqueId(char* id, size_t max_size) const override;
 #endif
   virtual void Hint(AccessPattern pattern) override;
+  virtual Status Prefetch(uint64_t offset, size_t n) override;
   virtual Status InvalidateCache(size_t offset, size_t length) override;
 };
 
@@ -85,6 +95,8 @@ class PosixWritableFile : public WritableFile {
   const std::string filename_;
   int fd_;
   uint64_t filesize_;
+  // Whether the file is opened with O_DIRECT.
+  bool use_direct_io_;
 #ifdef ROCKSDB_FALLOCATE_PRESENT
   bool allow_fallocate_;
   bool fallocate_with_keep_size_;
@@ -95,9 +107,16 @@ class PosixWritableFile : public WritableFile {
                     const EnvOptions& options);
   ~PosixWritableFile();
 
-  // Means Close() will properly take care of truncate
-  // and it does not need any additional information
-  virtual Status Truncate(uint64_t size) override { return Status::OK(); }
+  // With direct I/O the last page is written padded, so the file is truncated to the size of the
+  // data. Otherwise Close() will properly take care of truncate and it does not need any
+  // additional information.
+  virtual Status Truncate(uint64_t size) override;
+  virtual bool UseOSBuffer() const override { return !use_direct_io_; }
+  virtual bool UseDirectIO() const override { return use_direct_io_; }
+  virtual size_t GetRequiredBufferAlignment() const override {
+    return use_direct_io_ ? kDirectIOAlignment : WritableFile::GetRequiredBufferAlignment();
+  }
+  virtual Status PositionedAppend(const Slice& data, uint64_t offset) override;
   virtual Status Close() override;
   virtual Status Append(const Slice& data) override;
   virtual Status Flush() override;
@@ -32,6 +32,7 @@
 #include "yb/rocksdb/env.h"
 #include "yb/rocksdb/options.h"
 #include "yb/rocksdb/immutable_options.h"
+#include "yb/rocksdb/db/version_edit.h"
 
 namespace rocksdb {
 
@@ -70,6 +71,10 @@ uint64_t MutableCFOptions::MaxFileSizeForLevel(int level) const {
   assert(level < (int)max_file_size.size());
   return max_file_size[level];
 }
+bool MutableCFOptions::ExcludeFileFromCompaction(const FileMetaData& file) const {
+  return file.fd.GetTotalFileSize() > max_file_size_for_compaction ||
+         (exclude_file_from_compaction && (*exclude_file_from_compaction)(file));
+}
 uint64_t MutableCFOptions::MaxGrandParentOverlapBytes(int level) const {
   return MaxFileSizeForLevel(level) * max_grandparent_overlap_factor;
 }
@@ -91,6 +96,8 @@ void MutableCFOptions::Dump(Logger* log) const {
       memtable_prefix_bloom_probes);
   RLOG(log, " memtable_prefix_bloom_huge_page_tlb_size: %" ROCKSDB_PRIszt,
       memtable_prefix_bloom_huge_page_tlb_size);
+  RLOG(log, "                  memtable_huge_page_size: %" ROCKSDB_PRIszt,
+      memtable_huge_page_size);
   RLOG(log, "                    max_successive_merges: %" ROCKSDB_PRIszt,
       max_successive_merges);
   RLOG(log, "                           filter_deletes: %d",
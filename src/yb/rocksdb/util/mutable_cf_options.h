@@ -38,6 +38,7 @@ struct MutableCFOptions {
         memtable_prefix_bloom_probes(options.memtable_prefix_bloom_probes),
         memtable_prefix_bloom_huge_page_tlb_size(
             options.memtable_prefix_bloom_huge_page_tlb_size),
+        memtable_huge_page_size(options.memtable_huge_page_size),
         max_successive_merges(options.max_successive_merges),
         filter_deletes(options.filter_deletes),
         inplace_update_num_locks(options.inplace_update_num_locks),
@@ -66,7 +67,8 @@ struct MutableCFOptions {
             options.max_sequential_skip_in_iterations),
         paranoid_file_checks(options.paranoid_file_checks),
         compaction_measure_io_stats(options.compaction_measure_io_stats),
-        max_file_size_for_compaction(options.max_file_size_for_compaction) {
+        max_file_size_for_compaction(options.max_file_size_for_compaction),
+        exclude_file_from_compaction(options.exclude_file_from_compaction) {
     RefreshDerivedOptions(ioptions);
   }
 
@@ -77,6 +79,7 @@ struct MutableCFOptions {
         memtable_prefix_bloom_bits(0),
         memtable_prefix_bloom_probes(0),
         memtable_prefix_bloom_huge_page_tlb_size(0),
+        memtable_huge_page_size(0),
         max_successive_merges(0),
         filter_deletes(false),
         inplace_update_num_locks(0),
@@ -110,6 +113,8 @@ struct MutableCFOptions {
   // file in level->level+1 compaction.
   uint64_t MaxGrandParentOverlapBytes(int level) const;
   uint64_t ExpandedCompactionByteSizeLimit(int level) const;
+  // Whether the level0 file should be left out of automatic compactions.
+  bool ExcludeFileFromCompaction(const FileMetaData& file) const;
   int MaxBytesMultiplerAdditional(int level) const {
     if (level >=
         static_cast<int>(max_bytes_for_level_multiplier_additional.size())) {
@@ -127,6 +132,7 @@ struct MutableCFOptions {
   uint32_t memtable_prefix_bloom_bits;
   uint32_t memtable_prefix_bloom_probes;
   size_t memtable_prefix_bloom_huge_page_tlb_size;
+  size_t memtable_huge_page_size;
   size_t max_successive_merges;
   bool filter_deletes;
   size_t inplace_update_num_locks;
@@ -155,6 +161,7 @@ struct MutableCFOptions {
   bool paranoid_file_checks;
   bool compaction_measure_io_stats;
   uint64_t max_file_size_for_compaction;
+  std::shared_ptr<std::function<bool(const FileMetaData&)>> exclude_file_from_compaction;
 
   // Derived options
   // Per-level target file size.
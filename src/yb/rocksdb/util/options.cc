@@ -143,6 +143,7 @@ ColumnFamilyOptions::ColumnFamilyOptions()
       memtable_prefix_bloom_bits(0),
       memtable_prefix_bloom_probes(6),
       memtable_prefix_bloom_huge_page_tlb_size(0),
+      memtable_huge_page_size(0),
       bloom_locality(0),
       max_successive_merges(0),
       min_partial_merge_operands(2),
@@ -212,6 +213,7 @@ ColumnFamilyOptions::ColumnFamilyOptions(const Options& options)
       memtable_prefix_bloom_probes(options.memtable_prefix_bloom_probes),
       memtable_prefix_bloom_huge_page_tlb_size(
           options.memtable_prefix_bloom_huge_page_tlb_size),
+      memtable_huge_page_size(options.memtable_huge_page_size),
       bloom_locality(options.bloom_locality),
       max_successive_merges(options.max_successive_merges),
       min_partial_merge_operands(options.min_partial_merge_operands),
@@ -275,6 +277,7 @@ DBOptions::DBOptions()
       access_hint_on_compaction_start(NORMAL),
       new_table_reader_for_compaction_inputs(false),
       compaction_readahead_size(0),
+      use_direct_io_for_compaction(false),
       random_access_max_buffer_size(1024 * 1024),
       writable_file_max_buffer_size(1024 * 1024),
       use_adaptive_mutex(false),
@@ -285,6 +288,8 @@ DBOptions::DBOptions()
       delayed_write_rate(2 * 1024U * 1024U),
       allow_concurrent_memtable_write(false),
       enable_write_thread_adaptive_yield(false),
+      enable_pipelined_write(false),
+      iterator_pool_size(0),
       write_thread_max_yield_usec(100),
       write_thread_slow_yield_usec(3),
       skip_stats_update_on_db_open(false),
@@ -376,6 +381,8 @@ void DBOptions::Dump(Logger* log) const {
       "               Options.compaction_readahead_size: %" ROCKSDB_PRIszt
          "d",
          compaction_readahead_size);
+  RHEADER(log, "            Options.use_direct_io_for_compaction: %d",
+      use_direct_io_for_compaction);
   RHEADER(
       log,
       "               Options.random_access_max_buffer_size: %" ROCKSDB_PRIszt
@@ -404,6 +411,10 @@ void DBOptions::Dump(Logger* log) const {
       allow_concurrent_memtable_write);
   RHEADER(log, "      Options.enable_write_thread_adaptive_yield: %d",
       enable_write_thread_adaptive_yield);
+  RHEADER(log, "                  Options.enable_pipelined_write: %d",
+      enable_pipelined_write);
+  RHEADER(log, "                      Options.iterator_pool_size: %" ROCKSDB_PRIszt,
+      iterator_pool_size);
   RHEADER(log, "             Options.write_thread_max_yield_usec: %" PRIu64,
       write_thread_max_yield_usec);
   RHEADER(log, "            Options.write_thread_slow_yield_usec: %" PRIu64,
@@ -458,6 +469,8 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
       compression_opts.level);
   RHEADER(log, "              Options.compression_opts.strategy: %d",
       compression_opts.strategy);
+  RHEADER(log, "        Options.compression_opts.max_dict_bytes: %" PRIu32,
+      compression_opts.max_dict_bytes);
   RHEADER(log, "     Options.level0_file_num_compaction_trigger: %d",
       level0_file_num_compaction_trigger);
   RHEADER(log, "         Options.level0_slowdown_writes_trigger: %d",
@@ -521,6 +534,9 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
   RHEADER(log,
       "Options.compaction_options_universal.compression_size_percent: %d",
       compaction_options_universal.compression_size_percent);
+  RHEADER(log,
+      "Options.compaction_options_universal.garbage_ratio_threshold: %f",
+      compaction_options_universal.garbage_ratio_threshold);
   RHEADER(log,
       "Options.compaction_options_fifo.max_table_files_size: %" PRIu64,
       compaction_options_fifo.max_table_files_size);
@@ -547,6 +563,8 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
   RHEADER(log,
       "  Options.memtable_prefix_bloom_huge_page_tlb_size: %" ROCKSDB_PRIszt,
          memtable_prefix_bloom_huge_page_tlb_size);
+  RHEADER(log, "                 Options.memtable_huge_page_size: %" ROCKSDB_PRIszt,
+      memtable_huge_page_size);
   RHEADER(log, "                          Options.bloom_locality: %d",
       bloom_locality);
 
@@ -224,6 +224,9 @@ static std::unordered_map<std::string, OptionTypeInfo> db_options_type_info = {
     {"compaction_readahead_size",
      {offsetof(struct DBOptions, compaction_readahead_size), OptionType::kSizeT,
       OptionVerificationType::kNormal}},
+    {"use_direct_io_for_compaction",
+     {offsetof(struct DBOptions, use_direct_io_for_compaction),
+      OptionType::kBoolean, OptionVerificationType::kNormal}},
     {"random_access_max_buffer_size",
      {offsetof(struct DBOptions, random_access_max_buffer_size),
       OptionType::kSizeT, OptionVerificationType::kNormal}},
@@ -326,6 +329,12 @@ static std::unordered_map<std::string, OptionTypeInfo> db_options_type_info = {
     {"enable_write_thread_adaptive_yield",
      {offsetof(struct DBOptions, enable_write_thread_adaptive_yield),
       OptionType::kBoolean, OptionVerificationType::kNormal}},
+    {"enable_pipelined_write",
+     {offsetof(struct DBOptions, enable_pipelined_write),
+      OptionType::kBoolean, OptionVerificationType::kNormal}},
+    {"iterator_pool_size",
+     {offsetof(struct DBOptions, iterator_pool_size),
+      OptionType::kSizeT, OptionVerificationType::kNormal}},
     {"write_thread_slow_yield_usec",
      {offsetof(struct DBOptions, write_thread_slow_yield_usec),
       OptionType::kUInt64T, OptionVerificationType::kNormal}},
@@ -452,6 +461,9 @@ static std::unordered_map<std::string, OptionTypeInfo> cf_options_type_info = {
      {offsetof(struct ColumnFamilyOptions,
                memtable_prefix_bloom_huge_page_tlb_size),
       OptionType::kSizeT, OptionVerificationType::kNormal}},
+    {"memtable_huge_page_size",
+     {offsetof(struct ColumnFamilyOptions, memtable_huge_page_size),
+      OptionType::kSizeT, OptionVerificationType::kNormal}},
     {"write_buffer_size",
      {offsetof(struct ColumnFamilyOptions, write_buffer_size),
       OptionType::kSizeT, OptionVerificationType::kNormal}},
@@ -522,6 +534,9 @@ static std::unordered_map<std::string,
     {"cache_index_and_filter_blocks",
      {offsetof(struct BlockBasedTableOptions, cache_index_and_filter_blocks),
       OptionType::kBoolean, OptionVerificationType::kNormal}},
+    {"cache_index_and_filter_blocks_with_high_priority",
+     {offsetof(struct BlockBasedTableOptions, cache_index_and_filter_blocks_with_high_priority),
+      OptionType::kBoolean, OptionVerificationType::kNormal}},
     {"index_type",
      {offsetof(struct BlockBasedTableOptions, index_type),
       OptionType::kBlockBasedTableIndexType, OptionVerificationType::kNormal}},
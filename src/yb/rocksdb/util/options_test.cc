@@ -1617,7 +1617,8 @@ void InitDefault(BlockBasedTableOptions*) {}
 
 Status GetFromString(BlockBasedTableOptions* source, BlockBasedTableOptions* destination) {
   const char* const kOptionsString =
-      "cache_index_and_filter_blocks=1;index_type=kHashSearch;"
+      "cache_index_and_filter_blocks=1;cache_index_and_filter_blocks_with_high_priority=1;"
+      "index_type=kHashSearch;"
       "checksum=kxxHash;hash_index_allow_collision=1;no_block_cache=1;"
       "block_cache=1M;block_cache_compressed=1k;block_size=1024;filter_block_size=16384;"
       "block_size_deviation=8;block_restart_interval=4; "
@@ -1691,6 +1692,8 @@ Status GetFromString(DBOptions* source, DBOptions* destination) {
       "allow_concurrent_memtable_write=true;"
       "wal_recovery_mode=kPointInTimeRecovery;"
       "enable_write_thread_adaptive_yield=true;"
+      "enable_pipelined_write=true;"
+      "iterator_pool_size=4;"
       "write_thread_slow_yield_usec=5;"
       "write_thread_max_yield_usec=1000;"
       "access_hint_on_compaction_start=NONE;"
@@ -1889,6 +1892,7 @@ TEST_F(OptionsParserTest, BlockBasedTableOptionsAllFieldsSettable) {
       BLACKLIST_ENTRY(BlockBasedTableOptions, flush_block_policy_factory),
       BLACKLIST_ENTRY(BlockBasedTableOptions, block_cache),
       BLACKLIST_ENTRY(BlockBasedTableOptions, block_cache_compressed),
+      BLACKLIST_ENTRY(BlockBasedTableOptions, secondary_block_cache),
       BLACKLIST_ENTRY(BlockBasedTableOptions, filter_policy),
   };
 
@@ -37,6 +37,7 @@ void PerfContext::Reset() {
   block_cache_hit_count = 0;
   block_read_count = 0;
   block_read_byte = 0;
+  block_prefetch_count = 0;
   block_read_time = 0;
   block_checksum_time = 0;
   block_decompress_time = 0;
@@ -89,6 +90,7 @@ std::string PerfContext::ToString(bool exclude_zero_counters) const {
   PERF_CONTEXT_OUTPUT(block_cache_hit_count);
   PERF_CONTEXT_OUTPUT(block_read_count);
   PERF_CONTEXT_OUTPUT(block_read_byte);
+  PERF_CONTEXT_OUTPUT(block_prefetch_count);
   PERF_CONTEXT_OUTPUT(block_read_time);
   PERF_CONTEXT_OUTPUT(block_checksum_time);
   PERF_CONTEXT_OUTPUT(block_decompress_time);
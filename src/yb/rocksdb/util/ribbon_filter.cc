@@ -0,0 +1,326 @@
+//
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+//
+
+#include "yb/rocksdb/util/ribbon_filter.h"
+
+#include <math.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include <glog/logging.h>
+
+#include "yb/rocksdb/util/coding.h"
+
+#include "yb/util/hash_util.h"
+
+namespace rocksdb {
+
+namespace {
+
+constexpr size_t kSlotsPerBlock = 64;
+constexpr size_t kWordSize = sizeof(uint64_t);
+constexpr size_t kMaxResultBits = 16;
+
+// num_blocks: 4, result_bits: 1, seed: 1, tag: 1, followed by zero num_probes: 1 and
+// num_lines: 4 of full filter metadata.
+constexpr size_t kTrailerSize = 12;
+constexpr char kRibbonFilterTag = 1;
+
+// Number of seeds tried for the same filter size before growing it or giving up.
+constexpr size_t kMaxSeedsPerSize = 4;
+constexpr size_t kMaxSeedsFixedSize = 64;
+
+constexpr uint64_t kKeyHashSeed = 0x5d7a8ac0c1d2e3f4ULL;
+constexpr uint64_t kSeedMultiplier = 0x9e3779b97f4a7c15ULL;
+constexpr uint64_t kCoeffSalt = 0x2545f4914f6cdd1dULL;
+
+// Finalizer of 64 bit MurmurHash3.
+inline uint64_t Mix(uint64_t x) {
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ULL;
+  x ^= x >> 33;
+  return x;
+}
+
+inline uint64_t RibbonHash(const Slice& key) {
+  return yb::HashUtil::MurmurHash2_64(key.data(), static_cast<int>(key.size()), kKeyHashSeed);
+}
+
+struct Equation {
+  size_t start;
+  // Bit i corresponds to slot start + i, lowest bit is always set.
+  uint64_t coeff;
+  uint32_t result;
+};
+
+inline Equation MakeEquation(
+    uint64_t hash, uint8_t seed, size_t num_starts, size_t result_bits) {
+  const uint64_t h = Mix(hash + seed * kSeedMultiplier);
+  return Equation {
+    static_cast<size_t>((static_cast<unsigned __int128>(h) * num_starts) >> 64),
+    Mix(h ^ kCoeffSalt) | 1,
+    static_cast<uint32_t>(h) & ((1U << result_bits) - 1)
+  };
+}
+
+inline uint32_t Parity(uint64_t value) {
+  return __builtin_popcountll(value) & 1;
+}
+
+// Returns 64 bits of the specified solution column, starting at the specified slot.
+template <class Load>
+inline uint64_t SolutionWindow(
+    const Load& load, size_t result_bits, size_t start, size_t column) {
+  const size_t block = start / kSlotsPerBlock;
+  const size_t offset = start % kSlotsPerBlock;
+  uint64_t result = load(block * result_bits + column) >> offset;
+  // Equation starts at most at the first slot of the last block, so the next block always exists
+  // for non zero offset.
+  if (offset != 0) {
+    result |= load((block + 1) * result_bits + column) << (kSlotsPerBlock - offset);
+  }
+  return result;
+}
+
+// Keeps system of equations in upper triangular form, i.e. row stored in slot i has lowest set
+// bit at i. Equations are added using on the fly Gaussian elimination.
+class Banding {
+ public:
+  explicit Banding(size_t num_slots) : coeffs_(num_slots), results_(num_slots) {}
+
+  // Returns false when equation contradicts already added equations.
+  bool Add(Equation equation) {
+    size_t i = equation.start;
+    uint64_t coeff = equation.coeff;
+    uint32_t result = equation.result;
+    for (;;) {
+      DCHECK_LT(i, coeffs_.size());
+      auto& row_coeff = coeffs_[i];
+      if (row_coeff == 0) {
+        row_coeff = coeff;
+        results_[i] = result;
+        return true;
+      }
+      coeff ^= row_coeff;
+      result ^= results_[i];
+      if (coeff == 0) {
+        // Equation is linear combination of already added equations, for instance duplicate key.
+        return result == 0;
+      }
+      const int shift = __builtin_ctzll(coeff);
+      i += shift;
+      coeff >>= shift;
+    }
+  }
+
+  // Solves the system and returns solution in interleaved column major layout.
+  std::vector<uint64_t> BackSubstitute(size_t result_bits, uint8_t seed) const {
+    const size_t num_slots = coeffs_.size();
+    std::vector<uint64_t> words(num_slots / kSlotsPerBlock * result_bits);
+    auto load = [&words](size_t index) { return words[index]; };
+    const uint32_t result_mask = (1U << result_bits) - 1;
+    for (size_t i = num_slots; i-- > 0;) {
+      const uint64_t coeff = coeffs_[i];
+      uint32_t value;
+      if (coeff == 0) {
+        // Free variable, pseudo random value keeps false positive rate for keys that hit it.
+        value = static_cast<uint32_t>(Mix(i + seed * kSeedMultiplier)) & result_mask;
+      } else {
+        value = results_[i];
+        for (size_t column = 0; column != result_bits; ++column) {
+          value ^= Parity(SolutionWindow(load, result_bits, i, column) & coeff) << column;
+        }
+      }
+      uint64_t* block_words = words.data() + i / kSlotsPerBlock * result_bits;
+      const size_t offset = i % kSlotsPerBlock;
+      for (size_t column = 0; column != result_bits; ++column) {
+        block_words[column] |= static_cast<uint64_t>((value >> column) & 1) << offset;
+      }
+    }
+    return words;
+  }
+
+ private:
+  std::vector<uint64_t> coeffs_;
+  std::vector<uint32_t> results_;
+};
+
+Slice SerializeFilter(
+    const std::vector<uint64_t>& words, size_t num_blocks, size_t result_bits, uint8_t seed,
+    std::unique_ptr<const char[]>* buf) {
+  const size_t size = words.size() * kWordSize + kTrailerSize;
+  char* data = new char[size];
+  buf->reset(data);
+  for (const auto word : words) {
+    EncodeFixed64(data, word);
+    data += kWordSize;
+  }
+  EncodeFixed32(data, static_cast<uint32_t>(num_blocks));
+  data[4] = static_cast<char>(result_bits);
+  data[5] = static_cast<char>(seed);
+  data[6] = kRibbonFilterTag;
+  data[7] = 0;
+  EncodeFixed32(data + 8, 0);
+  return Slice(buf->get(), size);
+}
+
+size_t ClampResultBits(double bits) {
+  return std::max<size_t>(1, std::min<size_t>(kMaxResultBits, static_cast<size_t>(bits)));
+}
+
+} // namespace
+
+bool IsRibbonFilter(const Slice& contents) {
+  const size_t len = contents.size();
+  if (len < kTrailerSize) {
+    return false;
+  }
+  // Bloom filter always has non zero num_probes, so filter with zero num_probes and num_lines
+  // is never produced by FullFilterBitsBuilder.
+  const char* trailer = contents.cdata() + len - kTrailerSize;
+  return trailer[6] == kRibbonFilterTag && trailer[7] == 0 && DecodeFixed32(trailer + 8) == 0;
+}
+
+RibbonFilterBuilderBase::RibbonFilterBuilderBase(size_t result_bits)
+    : result_bits_(result_bits) {
+  DCHECK_GE(result_bits, 1);
+  DCHECK_LE(result_bits, kMaxResultBits);
+}
+
+size_t RibbonFilterBuilderBase::ResultBitsForBitsPerKey(size_t bits_per_key) {
+  // False positive rate of Bloom filter with optimal number of probes is (1/2)^(bits_per_key*ln2).
+  return ClampResultBits(round(bits_per_key * log(2)));
+}
+
+size_t RibbonFilterBuilderBase::ResultBitsForErrorRate(double error_rate) {
+  DCHECK_GT(error_rate, 0);
+  return ClampResultBits(ceil(-log2(error_rate)));
+}
+
+Slice RibbonFilterBuilderBase::Build(
+    size_t num_blocks, bool grow, std::unique_ptr<const char[]>* buf) {
+  DCHECK_GT(num_blocks, 0);
+  const size_t max_seeds = grow ? kMaxSeedsPerSize : kMaxSeedsFixedSize;
+  uint8_t seed = 0;
+  for (;;) {
+    const size_t num_slots = num_blocks * kSlotsPerBlock;
+    const size_t num_starts = num_slots - kSlotsPerBlock + 1;
+    for (size_t attempt = 0; attempt != max_seeds; ++attempt, ++seed) {
+      Banding banding(num_slots);
+      bool solved = true;
+      for (const auto hash : hashes_) {
+        if (!banding.Add(MakeEquation(hash, seed, num_starts, result_bits_))) {
+          solved = false;
+          break;
+        }
+      }
+      if (solved) {
+        hashes_.clear();
+        return SerializeFilter(
+            banding.BackSubstitute(result_bits_, seed), num_blocks, result_bits_, seed, buf);
+      }
+    }
+    if (!grow) {
+      break;
+    }
+    num_blocks += num_blocks / 16 + 1;
+  }
+
+  LOG(DFATAL) << "Failed to build ribbon filter for " << hashes_.size() << " keys in "
+              << num_blocks << " blocks";
+  hashes_.clear();
+  // Filter without blocks matches all keys.
+  return SerializeFilter({}, 0, result_bits_, 0, buf);
+}
+
+RibbonFilterBitsBuilder::RibbonFilterBitsBuilder(size_t bits_per_key)
+    : RibbonFilterBuilderBase(ResultBitsForBitsPerKey(bits_per_key)) {
+}
+
+void RibbonFilterBitsBuilder::AddKey(const Slice& key) {
+  const uint64_t hash = RibbonHash(key);
+  // Keys are sorted, so skip sequential duplicates the same way as FullFilterBitsBuilder does.
+  if (num_hashes() == 0 || hash != last_hash_) {
+    AddHash(hash);
+    last_hash_ = hash;
+  }
+}
+
+Slice RibbonFilterBitsBuilder::Finish(std::unique_ptr<const char[]>* buf) {
+  if (num_hashes() == 0) {
+    // The same format as empty FullFilterBitsBuilder filter, i.e. metadata only.
+    constexpr size_t kEmptyFilterSize = 5;
+    char* data = new char[kEmptyFilterSize]();
+    buf->reset(data);
+    return Slice(data, kEmptyFilterSize);
+  }
+  const size_t num_slots = static_cast<size_t>(ceil(num_hashes() * kSlotsPerKey));
+  return Build((num_slots + kSlotsPerBlock - 1) / kSlotsPerBlock, /* grow= */ true, buf);
+}
+
+FixedSizeRibbonFilterBitsBuilder::FixedSizeRibbonFilterBitsBuilder(
+    uint32_t total_bits, double error_rate)
+    : RibbonFilterBuilderBase(ResultBitsForErrorRate(error_rate)) {
+  DCHECK_GT(total_bits, 0);
+  num_blocks_ = std::max<size_t>(total_bits / (kSlotsPerBlock * result_bits()), 1);
+  max_keys_ = static_cast<size_t>(num_blocks_ * kSlotsPerBlock / kSlotsPerKey);
+}
+
+void FixedSizeRibbonFilterBitsBuilder::AddKey(const Slice& key) {
+  ++keys_added_;
+  AddHash(RibbonHash(key));
+}
+
+Slice FixedSizeRibbonFilterBitsBuilder::Finish(std::unique_ptr<const char[]>* buf) {
+  return Build(num_blocks_, /* grow= */ false, buf);
+}
+
+RibbonFilterBitsReader::RibbonFilterBitsReader(const Slice& contents)
+    : data_(contents.cdata()) {
+  DCHECK(IsRibbonFilter(contents));
+  const char* trailer = contents.cdata() + contents.size() - kTrailerSize;
+  const size_t num_blocks = DecodeFixed32(trailer);
+  const size_t result_bits = static_cast<uint8_t>(trailer[4]);
+  if (result_bits >= 1 && result_bits <= kMaxResultBits &&
+      contents.size() == num_blocks * result_bits * kWordSize + kTrailerSize) {
+    num_blocks_ = num_blocks;
+    result_bits_ = result_bits;
+    seed_ = static_cast<uint8_t>(trailer[5]);
+  } else {
+    LOG(DFATAL) << "Ribbon filter data is broken, won't be used";
+  }
+}
+
+bool RibbonFilterBitsReader::MayMatch(const Slice& entry) {
+  if (num_blocks_ == 0) {
+    return true;
+  }
+  const auto equation = MakeEquation(
+      RibbonHash(entry), seed_, num_blocks_ * kSlotsPerBlock - kSlotsPerBlock + 1, result_bits_);
+  auto load = [data = data_](size_t index) { return DecodeFixed64(data + index * kWordSize); };
+  for (size_t column = 0; column != result_bits_; ++column) {
+    const uint32_t bit =
+        Parity(SolutionWindow(load, result_bits_, equation.start, column) & equation.coeff);
+    if (bit != ((equation.result >> column) & 1)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace rocksdb
@@ -0,0 +1,139 @@
+//
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+//
+
+#ifndef YB_ROCKSDB_UTIL_RIBBON_FILTER_H
+#define YB_ROCKSDB_UTIL_RIBBON_FILTER_H
+
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "yb/rocksdb/filter_policy.h"
+
+#include "yb/util/slice.h"
+
+namespace rocksdb {
+
+// Standard Ribbon filter with 64 bit wide coefficient rows, see
+// [Dillinger, Walzer 2021 "Ribbon filter: practically smaller than Bloom and Xor"].
+//
+// Each key is mapped to an equation over GF(2): a 64 bit coefficient row starting at some slot
+// and an r bit result. Filter stores solution of all equations, r bits per slot, and key may
+// match only when its equation holds for the stored solution. So false positive rate is 2^-r,
+// while filter takes about r * (1 + overhead) bits per key, instead of 1.44 * r for Bloom filter.
+//
+// Solution is stored in interleaved column major layout: for each block of 64 slots there are r
+// 64 bit words, j-th word contains j-th result bit of each slot of the block. So query reads at
+// most two cache lines and computes each result bit with a single popcount.
+//
+// Serialized filter has the following format, compatible with FullFilterBitsReader that returns
+// true for filters with zero num_probes and num_lines:
+// +--------------------------------------------------------------------------------------------+
+// |                           solution: num_blocks * r 64 bit words                            |
+// +--------------------------------------------------------------------------------------------+
+// | num_blocks: 4 | r: 1 | seed: 1 | kRibbonFilterTag: 1 | num_probes = 0: 1 | num_lines = 0: 4 |
+// +--------------------------------------------------------------------------------------------+
+// Filter with zero blocks matches all keys, it is produced when the system could not be solved.
+
+// Returns true if contents contains a filter produced by ribbon filter builders.
+bool IsRibbonFilter(const Slice& contents);
+
+// Helper used by ribbon filter builders, keeps key hashes and builds filter from them.
+class RibbonFilterBuilderBase {
+ public:
+  explicit RibbonFilterBuilderBase(size_t result_bits);
+
+  // Result bits used for false positive rate of the specified bloom filter bits per key.
+  static size_t ResultBitsForBitsPerKey(size_t bits_per_key);
+
+  // Result bits required to provide the specified false positive rate.
+  static size_t ResultBitsForErrorRate(double error_rate);
+
+  // Number of slots per key, required to solve the system with high probability.
+  static constexpr double kSlotsPerKey = 1.08;
+
+ protected:
+  void AddHash(uint64_t hash) { hashes_.push_back(hash); }
+
+  // Tries to build filter with specified number of slot blocks, when `grow` is true and system
+  // could not be solved, the number of blocks is increased, otherwise filter that matches all
+  // keys is produced.
+  Slice Build(size_t num_blocks, bool grow, std::unique_ptr<const char[]>* buf);
+
+  size_t result_bits() const { return result_bits_; }
+  size_t num_hashes() const { return hashes_.size(); }
+
+ private:
+  const size_t result_bits_;
+  std::vector<uint64_t> hashes_;
+};
+
+// Ribbon filter builder for full filter block, the filter is sized by the number of added keys.
+class RibbonFilterBitsBuilder : public RibbonFilterBuilderBase, public FilterBitsBuilder {
+ public:
+  explicit RibbonFilterBitsBuilder(size_t bits_per_key);
+
+  RibbonFilterBitsBuilder(const RibbonFilterBitsBuilder&) = delete;
+  void operator=(const RibbonFilterBitsBuilder&) = delete;
+
+  void AddKey(const Slice& key) override;
+  Slice Finish(std::unique_ptr<const char[]>* buf) override;
+  bool IsFull() const override { return false; }
+
+ private:
+  uint64_t last_hash_ = 0;
+};
+
+// Ribbon filter builder for fixed size filter block, filter size is fixed and builder reports that
+// it is full when it contains the maximal number of keys that could be placed into the filter.
+class FixedSizeRibbonFilterBitsBuilder : public RibbonFilterBuilderBase, public FilterBitsBuilder {
+ public:
+  FixedSizeRibbonFilterBitsBuilder(uint32_t total_bits, double error_rate);
+
+  FixedSizeRibbonFilterBitsBuilder(const FixedSizeRibbonFilterBitsBuilder&) = delete;
+  void operator=(const FixedSizeRibbonFilterBitsBuilder&) = delete;
+
+  void AddKey(const Slice& key) override;
+  Slice Finish(std::unique_ptr<const char[]>* buf) override;
+  bool IsFull() const override { return keys_added_ >= max_keys_; }
+
+ private:
+  size_t num_blocks_;
+  size_t max_keys_;
+  size_t keys_added_ = 0;
+};
+
+// Reader for filters produced by ribbon filter builders.
+class RibbonFilterBitsReader : public FilterBitsReader {
+ public:
+  // Requires: IsRibbonFilter(contents).
+  explicit RibbonFilterBitsReader(const Slice& contents);
+
+  RibbonFilterBitsReader(const RibbonFilterBitsReader&) = delete;
+  void operator=(const RibbonFilterBitsReader&) = delete;
+
+  bool MayMatch(const Slice& entry) override;
+
+ private:
+  const char* data_;
+  size_t num_blocks_ = 0;
+  size_t result_bits_ = 0;
+  uint8_t seed_ = 0;
+};
+
+} // namespace rocksdb
+
+#endif // YB_ROCKSDB_UTIL_RIBBON_FILTER_H
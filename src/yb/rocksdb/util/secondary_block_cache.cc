@@ -0,0 +1,142 @@
+//
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+//
+
+#include "yb/rocksdb/util/secondary_block_cache.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include <glog/logging.h>
+
+#include "yb/gutil/bits.h"
+#include "yb/gutil/hash/city.h"
+
+namespace rocksdb {
+
+namespace {
+
+// Number of admissions that could wait for the background thread, further admissions are dropped.
+constexpr int kMaxPendingAdmissions = 256;
+
+constexpr size_t kMinAdmissionFilterSize = 1024;
+
+// Block is stored in the cache as its size followed by its contents.
+struct CachedBlock {
+  size_t size;
+  char data[1];
+
+  static size_t AllocationSize(size_t size) {
+    return offsetof(CachedBlock, data) + size;
+  }
+};
+
+} // namespace
+
+SecondTouchAdmissionFilter::SecondTouchAdmissionFilter(size_t size) {
+  size = std::max(size, kMinAdmissionFilterSize);
+  // Round up to power of 2, so index is computed by mask.
+  size = 1ULL << (Bits::Log2FloorNonZero64(size - 1) + 1);
+  mask_ = size - 1;
+  fingerprints_.reset(new std::atomic<uint32_t>[size]);
+  for (size_t i = 0; i != size; ++i) {
+    fingerprints_[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+bool SecondTouchAdmissionFilter::Admit(uint64_t hash) {
+  auto& slot = fingerprints_[hash & mask_];
+  // Fingerprint is never zero, so empty slot does not match any key.
+  const uint32_t fingerprint = static_cast<uint32_t>(hash >> 32) | 1;
+  if (slot.load(std::memory_order_relaxed) == fingerprint) {
+    slot.store(0, std::memory_order_relaxed);
+    return true;
+  }
+  slot.store(fingerprint, std::memory_order_relaxed);
+  return false;
+}
+
+YBSecondaryBlockCache::YBSecondaryBlockCache(
+    std::unique_ptr<yb::Cache> cache, size_t admission_filter_size)
+    : cache_(std::move(cache)), admission_filter_(admission_filter_size) {
+  CHECK_OK(yb::ThreadPoolBuilder("secondary_block_cache")
+               .set_min_threads(0)
+               .set_max_threads(1)
+               .set_max_queue_size(kMaxPendingAdmissions)
+               .Build(&admission_pool_));
+}
+
+YBSecondaryBlockCache::~YBSecondaryBlockCache() {
+  admission_pool_->Shutdown();
+}
+
+bool YBSecondaryBlockCache::Lookup(
+    const Slice& key, std::unique_ptr<char[]>* data, size_t* size) {
+  auto* handle = cache_->Lookup(key, yb::Cache::EXPECT_IN_CACHE);
+  if (handle == nullptr) {
+    return false;
+  }
+  const auto* block = static_cast<const CachedBlock*>(cache_->Value(handle));
+  *size = block->size;
+  data->reset(new char[block->size]);
+  memcpy(data->get(), block->data, block->size);
+  cache_->Release(handle);
+  return true;
+}
+
+void YBSecondaryBlockCache::Offer(const Slice& key, const Slice& contents) {
+  if (!admission_filter_.Admit(util_hash::CityHash64(key.cdata(), key.size()))) {
+    return;
+  }
+  // Admission is dropped when too many admissions are pending, since the block is just a cache
+  // entry.
+  auto status = admission_pool_->SubmitFunc(
+      [this, key = key.ToBuffer(), contents = contents.ToBuffer()] {
+    Insert(key, contents);
+  });
+  VLOG_IF(3, !status.ok()) << "Dropped secondary block cache admission: " << status;
+}
+
+void YBSecondaryBlockCache::Insert(const Slice& key, const Slice& contents) {
+  const size_t allocation_size = CachedBlock::AllocationSize(contents.size());
+  auto* block = reinterpret_cast<CachedBlock*>(cache_->Allocate(allocation_size));
+  if (block == nullptr) {
+    return;
+  }
+  block->size = contents.size();
+  memcpy(block->data, contents.data(), contents.size());
+  auto* handle = cache_->Insert(key, block, allocation_size, this);
+  if (handle == nullptr) {
+    cache_->Free(reinterpret_cast<uint8_t*>(block));
+    return;
+  }
+  cache_->Release(handle);
+}
+
+void YBSecondaryBlockCache::Delete(const Slice& key, void* value) {
+  cache_->Free(static_cast<uint8_t*>(value));
+}
+
+void YBSecondaryBlockCache::TEST_WaitForAdmissions() {
+  admission_pool_->Wait();
+}
+
+std::shared_ptr<SecondaryBlockCache> NewSecondaryBlockCache(
+    std::unique_ptr<yb::Cache> cache, size_t admission_filter_size) {
+  return std::make_shared<YBSecondaryBlockCache>(std::move(cache), admission_filter_size);
+}
+
+} // namespace rocksdb
@@ -0,0 +1,74 @@
+//
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+//
+
+#ifndef YB_ROCKSDB_UTIL_SECONDARY_BLOCK_CACHE_H
+#define YB_ROCKSDB_UTIL_SECONDARY_BLOCK_CACHE_H
+
+#include <atomic>
+#include <memory>
+
+#include "yb/rocksdb/cache.h"
+
+#include "yb/util/cache.h"
+#include "yb/util/threadpool.h"
+
+namespace rocksdb {
+
+// Remembers fingerprints of recently offered keys in a direct mapped table, so only keys that are
+// offered for the second time are admitted. Collisions could only forget keys or, rarely, admit
+// a key offered once, so no locking is required.
+class SecondTouchAdmissionFilter {
+ public:
+  explicit SecondTouchAdmissionFilter(size_t size);
+
+  // Returns true if key with specified hash should be admitted, i.e. it was offered recently.
+  bool Admit(uint64_t hash);
+
+ private:
+  size_t mask_;
+  std::unique_ptr<std::atomic<uint32_t>[]> fingerprints_;
+};
+
+// Secondary block cache, that stores block contents in yb::Cache, e.g. NVM cache.
+// Blocks are copied into the cache by a background thread, blocks are dropped when too many
+// admissions are pending.
+class YBSecondaryBlockCache : public SecondaryBlockCache, public yb::CacheDeleter {
+ public:
+  YBSecondaryBlockCache(std::unique_ptr<yb::Cache> cache, size_t admission_filter_size);
+  ~YBSecondaryBlockCache();
+
+  YBSecondaryBlockCache(const YBSecondaryBlockCache&) = delete;
+  void operator=(const YBSecondaryBlockCache&) = delete;
+
+  bool Lookup(const Slice& key, std::unique_ptr<char[]>* data, size_t* size) override;
+  void Offer(const Slice& key, const Slice& contents) override;
+
+  // yb::CacheDeleter implementation.
+  void Delete(const Slice& key, void* value) override;
+
+  // Waits until all pending admissions are processed.
+  void TEST_WaitForAdmissions();
+
+ private:
+  void Insert(const Slice& key, const Slice& contents);
+
+  std::unique_ptr<yb::Cache> cache_;
+  SecondTouchAdmissionFilter admission_filter_;
+  std::unique_ptr<yb::ThreadPool> admission_pool_;
+};
+
+} // namespace rocksdb
+
+#endif // YB_ROCKSDB_UTIL_SECONDARY_BLOCK_CACHE_H
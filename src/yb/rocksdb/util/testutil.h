@@ -274,6 +274,14 @@ class StringSource: public RandomAccessFile {
     return static_cast<size_t>(rid-id);
   }
 
+  // The contents are in memory, so prefetch just checks the range.
+  virtual Status Prefetch(uint64_t offset, size_t n) override {
+    if (offset > contents_.size()) {
+      return STATUS(InvalidArgument, "invalid Prefetch offset");
+    }
+    return Status::OK();
+  }
+
   int total_reads() const { return total_reads_; }
 
   void set_total_reads(int tr) { total_reads_ = tr; }
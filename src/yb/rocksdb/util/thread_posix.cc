@@ -24,6 +24,7 @@
 #include "yb/rocksdb/util/thread_posix.h"
 #include <unistd.h>
 #include <atomic>
+#include <iterator>
 #ifdef OS_LINUX
 #include <sys/syscall.h>
 #endif
@@ -212,7 +213,7 @@ void ThreadPool::StartBGThreads() {
 }
 
 void ThreadPool::Schedule(void (*function)(void* arg1), void* arg, void* tag,
-                          void (*unschedFunction)(void* arg)) {
+                          void (*unschedFunction)(void* arg), double score) {
   PthreadCall("lock", pthread_mutex_lock(&mu_));
 
   if (exit_all_threads_) {
@@ -222,12 +223,18 @@ void ThreadPool::Schedule(void (*function)(void* arg1), void* arg, void* tag,
 
   StartBGThreads();
 
-  // Add to priority queue
-  queue_.push_back(BGItem());
-  queue_.back().function = function;
-  queue_.back().arg = arg;
-  queue_.back().tag = tag;
-  queue_.back().unschedFunction = unschedFunction;
+  // Add to priority queue, after the items with the same or higher score. Most of the items have
+  // zero score, so look for the position from the back.
+  auto it = queue_.end();
+  while (it != queue_.begin() && std::prev(it)->score < score) {
+    --it;
+  }
+  it = queue_.insert(it, BGItem());
+  it->function = function;
+  it->arg = arg;
+  it->tag = tag;
+  it->unschedFunction = unschedFunction;
+  it->score = score;
   queue_len_.store(static_cast<unsigned int>(queue_.size()),
                    std::memory_order_relaxed);
 
@@ -38,8 +38,9 @@ class ThreadPool {
   void IncBackgroundThreadsIfNeeded(int num);
   void SetBackgroundThreads(int num);
   void StartBGThreads();
+  // Queued work with a higher score runs first, work with the same score runs in FIFO order.
   void Schedule(void (*function)(void* arg1), void* arg, void* tag,
-                void (*unschedFunction)(void* arg));
+                void (*unschedFunction)(void* arg), double score = 0);
   int UnSchedule(void* arg);
 
   unsigned int GetQueueLen() const {
@@ -82,6 +83,7 @@ class ThreadPool {
     void (*function)(void*);
     void* tag;
     void (*unschedFunction)(void*);
+    double score;
   };
   typedef std::deque<BGItem> BGQueue;
 
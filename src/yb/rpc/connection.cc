@@ -48,15 +48,30 @@
 #include "yb/rpc/growable_buffer.h"
 #include "yb/rpc/rpc_controller.h"
 
+#include "yb/util/flag_tags.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/trace.h"
 
 using namespace std::literals;
+using yb::operator"" _MB;
 using std::shared_ptr;
 using std::vector;
 using strings::Substitute;
 
 DEFINE_uint64(rpc_initial_buffer_size, 4096, "Initial buffer size used for RPC calls");
 DEFINE_uint64(rpc_connection_timeout_ms, 15000, "Timeout for RPC connection operations");
+DEFINE_int32(rpc_max_iov_per_write, 64,
+             "Max number of outbound data chunks gathered into a single write syscall");
+TAG_FLAG(rpc_max_iov_per_write, advanced);
+DEFINE_int64(rpc_max_bytes_per_write, 4_MB,
+             "Max number of bytes gathered into a single write syscall, the first chunk is always "
+             "written whole");
+TAG_FLAG(rpc_max_bytes_per_write, advanced);
+DEFINE_bool(rpc_cork_reactor_writes, false,
+            "Postpone writes of data queued from reactor thread till the end of event loop "
+            "iteration, so data queued during one iteration is sent with one syscall");
+TAG_FLAG(rpc_cork_reactor_writes, advanced);
+TAG_FLAG(rpc_cork_reactor_writes, runtime);
 
 METRIC_DEFINE_histogram(
     server, handler_latency_outbound_transfer, "Time taken to transfer the response ",
@@ -79,7 +94,7 @@ Connection::Connection(Reactor* reactor,
       remote_(remote),
       direction_(direction),
       last_activity_time_(CoarseMonoClock::Now()),
-      read_buffer_(FLAGS_rpc_initial_buffer_size, context->BufferLimit()),
+      read_buffer_(&reactor->messenger()->read_buffer_allocator(), context->BufferLimit()),
       context_(std::move(context)) {
   const auto metric_entity = reactor->messenger()->metric_entity();
   handler_latency_outbound_transfer_ = metric_entity ?
@@ -154,6 +169,22 @@ void Connection::ClearSending(const Status& status) {
   }
   sending_outbound_datas_.clear();
   sending_.clear();
+  sending_files_.clear();
+}
+
+void Connection::AppendSending(const OutboundDataPtr& outbound_data) {
+  outbound_data->Serialize(&sending_);
+  sending_files_.resize(sending_.size());
+
+  std::vector<FileSidecarPtr> files;
+  outbound_data->SerializeFileSidecars(&files);
+  for (auto& file : files) {
+    sending_.emplace_back();
+    sending_files_.push_back(std::move(file));
+  }
+
+  sending_outbound_datas_.resize(sending_.size());
+  sending_outbound_datas_.back() = outbound_data;
 }
 
 void Connection::Shutdown(const Status& status) {
@@ -172,6 +203,7 @@ void Connection::Shutdown(const Status& status) {
                  << HumanReadableElapsedTime::ToShortString(secs_since_active)
                  << " ago, status=" << status.ToString() << ")";
   }
+  read_buffer_.Reset();
 
   // Clear any calls which have been sent and were awaiting a response.
   for (auto& v : awaiting_response_) {
@@ -272,10 +304,7 @@ void Connection::QueueOutboundCall(const OutboundCallPtr& call) {
   }
 
   // Serialize the actual bytes to be put on the wire.
-  call->Serialize(&sending_);
-
-  sending_outbound_datas_.resize(sending_.size());
-  sending_outbound_datas_.back() = call;
+  AppendSending(call);
   call->SetQueued();
 }
 
@@ -318,7 +347,8 @@ Status Connection::ReadHandler() {
   last_activity_time_ = reactor_->cur_time();
 
   for (;;) {
-    auto received = Receive();
+    bool drained = false;
+    auto received = Receive(&drained);
     if (PREDICT_FALSE(!received.ok())) {
       if (received.status().error_code() == ESHUTDOWN) {
         VLOG(1) << ToString() << " shut down by remote end.";
@@ -337,13 +367,15 @@ Status Connection::ReadHandler() {
     if (!continue_receiving.ok()) {
       return continue_receiving.status();
     }
-    if (!continue_receiving.get()) {
+    // Socket does not have more data, so don't waste read syscall that would return EAGAIN.
+    // Since event loop is level triggered, we will be notified when more data arrives.
+    if (!continue_receiving.get() || drained) {
       return Status::OK();
     }
   }
 }
 
-Result<bool> Connection::Receive() {
+Result<bool> Connection::Receive(bool* drained) {
   RETURN_NOT_OK(read_buffer_.PrepareRead());
 
   size_t max_receive = context_->MaxReceive(Slice(read_buffer_.begin(), read_buffer_.size()));
@@ -369,6 +401,7 @@ Result<bool> Connection::Receive() {
   }
 
   read_buffer_.DataAppended(nread);
+  *drained = nread < remaining_buf_capacity;
   return nread != 0;
 }
 
@@ -433,21 +466,37 @@ Status Connection::DoWrite() {
   if (!is_epoll_registered_) {
     return Status::OK();
   }
+  // Upper bound for rpc_max_iov_per_write, so iov could be allocated on stack.
+  constexpr size_t kMaxIov = 256;
+  const size_t max_iov = std::min<size_t>(std::max(FLAGS_rpc_max_iov_per_write, 1), kMaxIov);
+  const size_t max_bytes = std::max<int64_t>(FLAGS_rpc_max_bytes_per_write, 1);
   while (!sending_.empty()) {
-    const size_t kMaxIov = 16;
-    iovec iov[kMaxIov];
-    const int iov_len = static_cast<int>(std::min(kMaxIov, sending_.size()));
-    size_t offset = send_position_;
-    for (auto i = 0; i != iov_len; ++i) {
-      iov[i].iov_base = sending_[i].data() + offset;
-      iov[i].iov_len = sending_[i].size() - offset;
-      offset = 0;
-    }
-
     last_activity_time_ = reactor_->cur_time();
     int32_t written = 0;
+    Status status;
+
+    if (sending_files_.front()) {
+      const auto& file = *sending_files_.front();
+      status = socket_.SendFile(file.fd(), file.offset() + send_position_,
+                                std::min(file.size() - send_position_, max_bytes), &written);
+    } else {
+      iovec iov[kMaxIov];
+      const size_t iov_limit = std::min(max_iov, sending_.size());
+      size_t iov_len = 0;
+      size_t offset = send_position_;
+      size_t total_bytes = 0;
+      while (iov_len != iov_limit && !sending_files_[iov_len] &&
+             (iov_len == 0 || total_bytes < max_bytes)) {
+        auto& chunk = sending_[iov_len];
+        iov[iov_len].iov_base = chunk.data() + offset;
+        iov[iov_len].iov_len = chunk.size() - offset;
+        total_bytes += iov[iov_len].iov_len;
+        offset = 0;
+        ++iov_len;
+      }
 
-    auto status = socket_.Writev(iov, iov_len, &written);
+      status = socket_.Writev(iov, static_cast<int>(iov_len), &written);
+    }
     if (PREDICT_FALSE(!status.ok())) {
       if (!Socket::IsTemporarySocketError(status)) {
         LOG(WARNING) << ToString() << " send error: " << status.ToString();
@@ -460,10 +509,11 @@ Status Connection::DoWrite() {
     }
 
     send_position_ += written;
-    while (!sending_.empty() && send_position_ >= sending_.front().size()) {
+    while (!sending_.empty() && send_position_ >= SendingSize(0)) {
       auto call = sending_outbound_datas_.front();
-      send_position_ -= sending_.front().size();
+      send_position_ -= SendingSize(0);
       sending_.pop_front();
+      sending_files_.pop_front();
       sending_outbound_datas_.pop_front();
       if (call) {
         call->Transferred(Status::OK(), this);
@@ -611,16 +661,26 @@ void Connection::DoQueueOutboundData(OutboundDataPtr outbound_data, bool batch)
   // eventually runs in the reactor thread will take care of calling
   // ResponseTransferCallbacks::NotifyTransferAborted.
 
-  outbound_data->Serialize(&sending_);
-
-  sending_outbound_datas_.resize(sending_.size());
-  sending_outbound_datas_.back() = outbound_data;
+  AppendSending(outbound_data);
 
   if (!batch) {
-    OutboundQueued();
+    if (FLAGS_rpc_cork_reactor_writes) {
+      if (!corked_) {
+        corked_ = true;
+        reactor_->CorkConnection(shared_from_this());
+      }
+    } else {
+      OutboundQueued();
+    }
   }
 }
 
+void Connection::Uncork() {
+  DCHECK(reactor_->IsCurrentThread());
+  corked_ = false;
+  OutboundQueued();
+}
+
 Status Connection::Start(ev::loop_ref* loop) {
   DCHECK(reactor_->IsCurrentThread());
 
@@ -178,6 +178,9 @@ class Connection final : public std::enable_shared_from_this<Connection> {
   // Do appropriate actions after adding outbound call.
   void OutboundQueued();
 
+  // Writes data that was postponed by corking, see Reactor::CorkConnection.
+  void Uncork();
+
   // An incoming packet has completed on the client side. This parses the
   // call response, looks up the CallAwaitingResponse, and calls the
   // client callback.
@@ -199,7 +202,18 @@ class Connection final : public std::enable_shared_from_this<Connection> {
 
   void ClearSending(const Status& status);
 
-  Result<bool> Receive();
+  // Appends serialized outbound data to sending_.
+  void AppendSending(const OutboundDataPtr& outbound_data);
+
+  // Size of the i-th element of sending_.
+  size_t SendingSize(size_t i) const {
+    return sending_files_[i] ? sending_files_[i]->size() : sending_[i].size();
+  }
+
+  // Reads available data from socket to read_buffer_, returns false if nothing was read.
+  // drained is set to true if socket had less data than we tried to read, so there is no reason
+  // to read it again till the next read event.
+  Result<bool> Receive(bool* drained);
 
   // Try to parse received data into calls and process them.
   Result<bool> TryProcessCalls();
@@ -263,12 +277,17 @@ class Connection final : public std::enable_shared_from_this<Connection> {
   // Data received on this connection that has not been processed yet.
   GrowableBuffer read_buffer_;
 
-  // sending_* contain bytes and calls we are currently sending to socket
+  // sending_* contain bytes and calls we are currently sending to socket.
+  // For file sidecars, sending_files_ contains the file range and sending_ contains a null buffer.
   std::deque<RefCntBuffer> sending_;
+  std::deque<FileSidecarPtr> sending_files_;
   std::deque<OutboundDataPtr> sending_outbound_datas_;
   size_t send_position_ = 0;
   bool waiting_write_ready_ = false;
 
+  // Whether write of queued data is postponed till the end of event loop iteration.
+  bool corked_ = false;
+
   simple_spinlock outbound_data_queue_lock_;
 
   // Responses we are going to process.
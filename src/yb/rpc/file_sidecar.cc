@@ -0,0 +1,94 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/rpc/file_sidecar.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <glog/logging.h>
+
+#include "yb/util/errno.h"
+#include "yb/util/format.h"
+#include "yb/util/status.h"
+
+namespace yb {
+namespace rpc {
+
+Result<FileSidecarPtr> FileSidecar::Open(const std::string& path, uint64_t offset, size_t size) {
+  int fd;
+  do {
+    fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  } while (fd < 0 && errno == EINTR);
+  if (fd < 0) {
+    return STATUS_FORMAT(IOError, "Unable to open $0: $1", path, ErrnoToString(errno));
+  }
+  return std::make_shared<FileSidecar>(fd, offset, size);
+}
+
+FileSidecar::FileSidecar(int fd, uint64_t offset, size_t size)
+    : fd_(fd), offset_(offset), size_(size) {
+}
+
+FileSidecar::~FileSidecar() {
+  if (::close(fd_) != 0) {
+    PLOG(WARNING) << "Failed to close file sidecar " << ToString();
+  }
+}
+
+Status FileSidecar::Map(const std::function<void(const Slice&)>& callback) const {
+  if (size_ == 0) {
+    callback(Slice());
+    return Status::OK();
+  }
+  // mmap() requires the offset to be a multiple of the page size.
+  static const uint64_t kPageSize = sysconf(_SC_PAGESIZE);
+  const uint64_t map_offset = offset_ / kPageSize * kPageSize;
+  const size_t map_size = size_ + (offset_ - map_offset);
+  void* addr = mmap(nullptr, map_size, PROT_READ, MAP_SHARED, fd_, map_offset);
+  if (addr == MAP_FAILED) {
+    return STATUS_FORMAT(IOError, "Unable to map $0: $1", ToString(), ErrnoToString(errno));
+  }
+  callback(Slice(static_cast<const uint8_t*>(addr) + (offset_ - map_offset), size_));
+  if (munmap(addr, map_size) != 0) {
+    PLOG(WARNING) << "Failed to unmap " << ToString();
+  }
+  return Status::OK();
+}
+
+Result<RefCntBuffer> FileSidecar::Read() const {
+  RefCntBuffer result(size_);
+  size_t done = 0;
+  while (done != size_) {
+    ssize_t res = ::pread(fd_, result.data() + done, size_ - done, offset_ + done);
+    if (res < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return STATUS_FORMAT(IOError, "Unable to read $0: $1", ToString(), ErrnoToString(errno));
+    }
+    if (res == 0) {
+      return STATUS_FORMAT(IOError, "Unexpected end of file reading $0", ToString());
+    }
+    done += res;
+  }
+  return result;
+}
+
+std::string FileSidecar::ToString() const {
+  return Format("{ fd: $0 offset: $1 size: $2 }", fd_, offset_, size_);
+}
+
+} // namespace rpc
+} // namespace yb
@@ -0,0 +1,67 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_RPC_FILE_SIDECAR_H
+#define YB_RPC_FILE_SIDECAR_H
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "yb/util/ref_cnt_buffer.h"
+#include "yb/util/result.h"
+#include "yb/util/slice.h"
+
+namespace yb {
+namespace rpc {
+
+class FileSidecar;
+typedef std::shared_ptr<FileSidecar> FileSidecarPtr;
+
+// Range of a file that is sent as a sidecar of an RPC response. The connection sends it with
+// Socket::SendFile, i.e. straight from the page cache to the socket, without copying it into a
+// user space buffer. The file should not be modified while the sidecar exists.
+class FileSidecar {
+ public:
+  // Opens 'path' to send 'size' bytes of it starting from 'offset'.
+  static Result<FileSidecarPtr> Open(const std::string& path, uint64_t offset, size_t size);
+
+  FileSidecar(int fd, uint64_t offset, size_t size);
+  ~FileSidecar();
+
+  FileSidecar(const FileSidecar&) = delete;
+  void operator=(const FileSidecar&) = delete;
+
+  int fd() const { return fd_; }
+  uint64_t offset() const { return offset_; }
+  size_t size() const { return size_; }
+
+  // Maps the range to memory and invokes 'callback' with it, so the data could be inspected,
+  // e.g. checksummed, without copying it.
+  CHECKED_STATUS Map(const std::function<void(const Slice&)>& callback) const;
+
+  // Reads the range into a buffer, used for calls that do not go through a socket.
+  Result<RefCntBuffer> Read() const;
+
+  std::string ToString() const;
+
+ private:
+  const int fd_;
+  const uint64_t offset_;
+  const size_t size_;
+};
+
+} // namespace rpc
+} // namespace yb
+
+#endif // YB_RPC_FILE_SIDECAR_H
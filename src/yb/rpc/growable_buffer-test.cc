@@ -17,6 +17,7 @@
 
 #include "yb/rpc/growable_buffer.h"
 
+#include "yb/util/mem_tracker.h"
 #include "yb/util/test_util.h"
 
 namespace yb {
@@ -83,5 +84,45 @@ TEST_F(GrowableBufferTest, TestConsume) {
   }
 }
 
+TEST_F(GrowableBufferTest, TestAllocator) {
+  const size_t kMaxPooledBlocks = 2;
+  auto mem_tracker = MemTracker::CreateTracker(-1, "test");
+  GrowableBufferAllocator allocator(kInitialSize, kMaxPooledBlocks, mem_tracker);
+
+  std::vector<std::unique_ptr<GrowableBuffer>> buffers;
+  for (int i = 0; i != 3; ++i) {
+    buffers.emplace_back(new GrowableBuffer(&allocator, kSizeLimit));
+    // Buffer does not allocate memory till the first read.
+    ASSERT_EQ(0, buffers.back()->capacity());
+    ASSERT_OK(buffers.back()->PrepareRead());
+    ASSERT_EQ(kInitialSize, buffers.back()->capacity_left());
+    buffers.back()->DataAppended(1);
+  }
+  ASSERT_EQ(3 * kInitialSize, mem_tracker->consumption());
+
+  // Grow buffer over block size.
+  ASSERT_OK(buffers[0]->EnsureFreeSpace(kInitialSize * 2));
+  ASSERT_EQ(kInitialSize * 4, buffers[0]->capacity());
+  // Block that was used by this buffer is pooled now, so it is still accounted.
+  ASSERT_EQ(kInitialSize * 7, mem_tracker->consumption());
+  ASSERT_EQ(1, allocator.pooled_blocks());
+
+  // Consumed buffers return memory to the allocator.
+  for (auto& buffer : buffers) {
+    buffer->Consume(1);
+    ASSERT_EQ(0, buffer->capacity());
+  }
+  ASSERT_EQ(kMaxPooledBlocks, allocator.pooled_blocks());
+  ASSERT_EQ(kMaxPooledBlocks * kInitialSize, mem_tracker->consumption());
+
+  // Active buffers reuse pooled blocks.
+  ASSERT_OK(buffers[0]->PrepareRead());
+  ASSERT_EQ(kMaxPooledBlocks - 1, allocator.pooled_blocks());
+  ASSERT_EQ(kMaxPooledBlocks * kInitialSize, mem_tracker->consumption());
+
+  buffers.clear();
+  ASSERT_EQ(kMaxPooledBlocks, allocator.pooled_blocks());
+}
+
 } // namespace rpc
 } // namespace yb
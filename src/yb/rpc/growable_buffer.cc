@@ -19,18 +19,107 @@
 
 #include "yb/gutil/strings/substitute.h"
 
+#include "yb/util/mem_tracker.h"
+
 using strings::Substitute;
 
 namespace yb {
 namespace rpc {
 
+GrowableBufferAllocator::GrowableBufferAllocator(
+    size_t block_size, size_t max_pooled_blocks, const std::shared_ptr<MemTracker>& mem_tracker)
+    : block_size_(block_size),
+      max_pooled_blocks_(max_pooled_blocks),
+      mem_tracker_(mem_tracker) {
+  pool_.reserve(max_pooled_blocks_);
+}
+
+GrowableBufferAllocator::~GrowableBufferAllocator() {
+  for (auto* block : pool_) {
+    free(block);
+  }
+  Release(pool_.size() * block_size_);
+}
+
+uint8_t* GrowableBufferAllocator::Allocate() {
+  {
+    std::lock_guard<simple_spinlock> lock(mutex_);
+    if (!pool_.empty()) {
+      auto result = pool_.back();
+      pool_.pop_back();
+      return result;
+    }
+  }
+  auto result = static_cast<uint8_t*>(malloc(block_size_));
+  if (result) {
+    Consume(block_size_);
+  }
+  return result;
+}
+
+void GrowableBufferAllocator::Free(uint8_t* block) {
+  {
+    std::lock_guard<simple_spinlock> lock(mutex_);
+    if (pool_.size() < max_pooled_blocks_) {
+      pool_.push_back(block);
+      return;
+    }
+  }
+  free(block);
+  Release(block_size_);
+}
+
+void GrowableBufferAllocator::Consume(int64_t bytes) {
+  if (mem_tracker_) {
+    mem_tracker_->Consume(bytes);
+  }
+}
+
+void GrowableBufferAllocator::Release(int64_t bytes) {
+  if (mem_tracker_ && bytes) {
+    mem_tracker_->Release(bytes);
+  }
+}
+
+size_t GrowableBufferAllocator::pooled_blocks() const {
+  std::lock_guard<simple_spinlock> lock(mutex_);
+  return pool_.size();
+}
+
 GrowableBuffer::GrowableBuffer(size_t initial, size_t limit)
-    : buffer_(static_cast<uint8_t*>(malloc(initial))),
+    : initial_(initial),
+      buffer_(static_cast<uint8_t*>(malloc(initial))),
       limit_(limit),
       capacity_(initial),
       size_(0) {
 }
 
+GrowableBuffer::GrowableBuffer(GrowableBufferAllocator* allocator, size_t limit)
+    : allocator_(allocator),
+      initial_(std::min(allocator->block_size(), limit)),
+      limit_(limit),
+      capacity_(0),
+      size_(0) {
+}
+
+GrowableBuffer::~GrowableBuffer() {
+  Reset();
+}
+
+void GrowableBuffer::Reset() {
+  size_ = 0;
+  if (!allocator_ || !buffer_) {
+    return;
+  }
+  if (IsPooledBlock()) {
+    allocator_->Free(buffer_.release());
+  } else {
+    buffer_.reset();
+    allocator_->Release(capacity_);
+  }
+  capacity_ = 0;
+}
+
 void GrowableBuffer::DumpTo(std::ostream& out) const {
   out << "size: " << size_ << ", capacity: " << capacity_ << ", limit: " << limit_;
 }
@@ -45,11 +134,15 @@ void GrowableBuffer::Consume(size_t count) {
       memmove(buffer_.get(), buffer_.get() + count, left);
     }
     size_ = left;
+    if (left == 0) {
+      Reset();
+    }
   }
 }
 
 void GrowableBuffer::Swap(GrowableBuffer* rhs) {
   DCHECK_EQ(limit_, rhs->limit_);
+  DCHECK_EQ(allocator_, rhs->allocator_);
 
   buffer_.swap(rhs->buffer_);
   std::swap(capacity_, rhs->capacity_);
@@ -58,20 +151,53 @@ void GrowableBuffer::Swap(GrowableBuffer* rhs) {
 
 Status GrowableBuffer::Reshape(size_t new_capacity) {
   DCHECK_LE(new_capacity, limit_);
-  if (new_capacity != capacity_) {
-    auto new_buffer = static_cast<uint8_t *>(realloc(buffer_.get(), new_capacity));
+  if (new_capacity == capacity_) {
+    return Status::OK();
+  }
+  if (allocator_) {
+    uint8_t* new_buffer;
+    if (new_capacity == allocator_->block_size()) {
+      DCHECK(!buffer_);
+      new_buffer = allocator_->Allocate();
+    } else if (IsPooledBlock()) {
+      // Pooled block should be returned to the pool, so we could not realloc it.
+      new_buffer = static_cast<uint8_t *>(malloc(new_capacity));
+      if (new_buffer) {
+        memcpy(new_buffer, buffer_.get(), size_);
+        allocator_->Free(buffer_.release());
+        allocator_->Consume(new_capacity);
+      }
+    } else {
+      new_buffer = static_cast<uint8_t *>(realloc(buffer_.get(), new_capacity));
+      if (new_buffer) {
+        buffer_.release();
+        allocator_->Consume(static_cast<int64_t>(new_capacity) - static_cast<int64_t>(capacity_));
+      }
+    }
     if (!new_buffer) {
       return STATUS(RuntimeError,
           Substitute("Failed to change buffer size from $0 to $1 bytes", capacity_, new_capacity));
     }
-    buffer_.release();
     buffer_.reset(new_buffer);
     capacity_ = new_capacity;
+    return Status::OK();
   }
+
+  auto new_buffer = static_cast<uint8_t *>(realloc(buffer_.get(), new_capacity));
+  if (!new_buffer) {
+    return STATUS(RuntimeError,
+        Substitute("Failed to change buffer size from $0 to $1 bytes", capacity_, new_capacity));
+  }
+  buffer_.release();
+  buffer_.reset(new_buffer);
+  capacity_ = new_capacity;
   return Status::OK();
 }
 
 Status GrowableBuffer::PrepareRead() {
+  if (capacity_ == 0) {
+    return Reshape(initial_);
+  }
   if (size_ * 2 > capacity_) {
     const size_t new_capacity = std::min(limit_, capacity_ * 2);
     if (size_ == new_capacity) {
@@ -94,7 +220,7 @@ Status GrowableBuffer::EnsureFreeSpace(size_t len) {
             limit_));
   }
   if (expected > capacity_) {
-    size_t new_capacity = capacity_ * 2;
+    size_t new_capacity = std::max(capacity_ * 2, initial_);
     while (new_capacity < expected) {
       new_capacity *= 2;
     }
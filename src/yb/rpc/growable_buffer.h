@@ -17,24 +17,72 @@
 
 #include <iosfwd>
 #include <memory>
+#include <vector>
 
 #include "yb/gutil/gscoped_ptr.h"
 
+#include "yb/util/locks.h"
 #include "yb/util/status.h"
 
 #include "yb/util/net/socket.h"
 
 namespace yb {
+
+class MemTracker;
+
 namespace rpc {
 
+// Allocates fixed size blocks for growable buffers of multiple connections.
+// Freed blocks are kept for reuse, up to the specified number of blocks.
+// All memory allocated by the buffers that use this allocator, including buffers that were grown
+// above the block size, is accounted in the mem tracker.
+class GrowableBufferAllocator {
+ public:
+  GrowableBufferAllocator(size_t block_size, size_t max_pooled_blocks,
+                          const std::shared_ptr<MemTracker>& mem_tracker);
+  ~GrowableBufferAllocator();
+
+  size_t block_size() const { return block_size_; }
+
+  const std::shared_ptr<MemTracker>& mem_tracker() const { return mem_tracker_; }
+
+  // Returns block of block_size() bytes, or nullptr if we failed to allocate it.
+  uint8_t* Allocate();
+
+  // Returns block, that was previously allocated, to the pool.
+  void Free(uint8_t* block);
+
+  // Accounts memory of buffers that are bigger than block size.
+  void Consume(int64_t bytes);
+  void Release(int64_t bytes);
+
+  size_t pooled_blocks() const;
+
+ private:
+  const size_t block_size_;
+  const size_t max_pooled_blocks_;
+  std::shared_ptr<MemTracker> mem_tracker_;
+
+  mutable simple_spinlock mutex_;
+  std::vector<uint8_t*> pool_;
+
+  DISALLOW_COPY_AND_ASSIGN(GrowableBufferAllocator);
+};
+
 // Convenience buffer for receiving bytes.
 // Major features:
 //   Limit allocated bytes.
 //   Resize depending on used size.
 //   Consume read data.
+//
+// When buffer is created with allocator, memory is not allocated till the first read, and buffer
+// returns its memory to the allocator as soon as all data is consumed. So idle connections don't
+// hold any memory for their read buffers.
 class GrowableBuffer {
  public:
   explicit GrowableBuffer(size_t initial, size_t limit);
+  GrowableBuffer(GrowableBufferAllocator* allocator, size_t limit);
+  ~GrowableBuffer();
 
   inline bool empty() const { return size_ == 0; }
   inline size_t size() const { return size_; }
@@ -43,10 +91,13 @@ class GrowableBuffer {
   inline size_t capacity_left() const { return capacity_ - size_; }
   inline uint8_t* write_position() { return buffer_.get() + size_; }
   inline size_t limit() const { return limit_; }
+  inline size_t capacity() const { return capacity_; }
 
   void Swap(GrowableBuffer* rhs);
   // Reset buffer size to zero. Like with std::vector Clean does not deallocate any memory.
   void Clear() { size_ = 0; }
+  // Drops contained data and releases allocated memory, if buffer was created with allocator.
+  void Reset();
   void DumpTo(std::ostream& out) const;
 
   // Removes first `count` bytes from buffer, moves remaining bytes to the beginning of the buffer.
@@ -79,6 +130,15 @@ class GrowableBuffer {
  private:
   CHECKED_STATUS Reshape(size_t new_capacity);
 
+  bool IsPooledBlock() const {
+    return allocator_ != nullptr && capacity_ == allocator_->block_size();
+  }
+
+  GrowableBufferAllocator* const allocator_ = nullptr;
+
+  // Capacity that is allocated when buffer does not have memory yet.
+  const size_t initial_;
+
   // Contained data
   std::unique_ptr<uint8_t, FreeDeleter> buffer_;
 
@@ -38,6 +38,8 @@
 
 #include "yb/rpc/connection.h"
 #include "yb/rpc/connection_context.h"
+#include "yb/rpc/messenger.h"
+#include "yb/rpc/reactor.h"
 #include "yb/rpc/rpc_introspection.pb.h"
 #include "yb/rpc/serialization.h"
 #include "yb/rpc/service_pool.h"
@@ -76,11 +78,18 @@ DEFINE_int32(rpc_slow_query_threshold_ms, 10000,
 TAG_FLAG(rpc_slow_query_threshold_ms, advanced);
 TAG_FLAG(rpc_slow_query_threshold_ms, runtime);
 
+DEFINE_bool(rpc_request_timeline, true,
+            "Whether to record the timeline of hot path phases of inbound calls, that is exported "
+            "as per phase histograms and timelines of slow calls in /rpcz.");
+TAG_FLAG(rpc_request_timeline, advanced);
+TAG_FLAG(rpc_request_timeline, runtime);
+
 namespace yb {
 namespace rpc {
 
 InboundCall::InboundCall(ConnectionPtr conn, CallProcessedListener call_processed_listener)
     : trace_(new Trace),
+      timeline_(FLAGS_rpc_request_timeline ? new RequestTimeline : nullptr),
       conn_(std::move(conn)),
       call_processed_listener_(std::move(call_processed_listener)) {
   TRACE_TO(trace_, "Created InboundCall");
@@ -127,12 +136,18 @@ void InboundCall::RecordCallReceived() {
   TRACE_EVENT_ASYNC_BEGIN0("rpc", "InboundCall", this);
   DCHECK(!timing_.time_received.Initialized());  // Protect against multiple calls.
   timing_.time_received = MonoTime::Now();
+  if (timeline_) {
+    timeline_->Record(RequestPhase::kReceived);
+  }
 }
 
 void InboundCall::RecordHandlingStarted(scoped_refptr<Histogram> incoming_queue_time) {
   DCHECK(incoming_queue_time != nullptr);
   DCHECK(!timing_.time_handled.Initialized());  // Protect against multiple calls.
   timing_.time_handled = MonoTime::Now();
+  if (timeline_) {
+    timeline_->Record(RequestPhase::kHandlingStarted);
+  }
   incoming_queue_time->Increment(
       timing_.time_handled.GetDeltaSince(timing_.time_received).ToMicroseconds());
 }
@@ -158,6 +173,11 @@ bool InboundCall::ClientTimedOut() const {
 void InboundCall::QueueResponse(bool is_success) {
   TRACE_TO(trace_, is_success ? "Queueing success response" : "Queueing failure response");
   LogTrace();
+  if (timeline_) {
+    timeline_->Record(RequestPhase::kResponded);
+    connection()->reactor()->messenger()->request_timeline_tracker().CallCompleted(
+        service_name(), method_name(), *timeline_);
+  }
   connection()->context().QueueResponse(connection(), shared_from(this));
 }
 
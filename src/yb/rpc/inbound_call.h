@@ -54,6 +54,7 @@
 #include "yb/util/faststring.h"
 #include "yb/util/monotime.h"
 #include "yb/util/ref_cnt_buffer.h"
+#include "yb/util/request_timeline.h"
 #include "yb/util/slice.h"
 #include "yb/util/status.h"
 
@@ -101,6 +102,8 @@ class InboundCall : public RpcCall {
 
   Trace* trace();
 
+  RequestTimeline* timeline() { return timeline_.get(); }
+
   // When this InboundCall was received (instantiated).
   // Should only be called once on a given instance.
   // Not thread-safe. Should only be called by the current "owner" thread.
@@ -153,6 +156,9 @@ class InboundCall : public RpcCall {
   // The trace buffer.
   scoped_refptr<Trace> trace_;
 
+  // Always-on timeline of hot path phases, null when --rpc_request_timeline is false.
+  RequestTimelinePtr timeline_;
+
   // Timing information related to this RPC call.
   InboundCallTiming timing_;
 
@@ -17,6 +17,7 @@
 
 #include "yb/rpc/rpc_controller.h"
 #include "yb/util/memory/memory.h"
+#include "yb/util/object_pool.h"
 
 namespace yb {
 namespace rpc {
@@ -34,7 +35,21 @@ LocalOutboundCall::LocalOutboundCall(
 }
 
 Status LocalOutboundCall::SetRequestParam(const google::protobuf::Message& req) {
-  req_ = &req;
+  const auto& serialized_fields = controller()->serialized_request_fields();
+  if (serialized_fields.empty()) {
+    req_ = &req;
+    return Status::OK();
+  }
+  // The local inbound call uses the request message directly, so pre-serialized fields should be
+  // merged into a copy of it.
+  owned_req_.reset(req.New());
+  owned_req_->CopyFrom(req);
+  for (const auto& fields : serialized_fields) {
+    if (!owned_req_->MergeFromString(fields.ToBuffer())) {
+      return STATUS(InvalidArgument, "Failed to merge serialized request fields");
+    }
+  }
+  req_ = owned_req_.get();
   return Status::OK();
 }
 
@@ -47,7 +62,8 @@ const std::shared_ptr<LocalYBInboundCall>& LocalOutboundCall::CreateLocalInbound
   const MonoDelta timeout = controller()->timeout();
   const MonoTime deadline = timeout.Initialized() ? start_ + timeout : MonoTime::Max();
   auto outbound_call = std::static_pointer_cast<LocalOutboundCall>(shared_from(this));
-  inbound_call_ = std::make_shared<LocalYBInboundCall>(remote_method(), outbound_call, deadline);
+  inbound_call_ = std::allocate_shared<LocalYBInboundCall>(
+      PooledAllocator<LocalYBInboundCall>(), remote_method(), outbound_call, deadline);
   return inbound_call_;
 }
 
@@ -86,6 +102,10 @@ void LocalYBInboundCall::Respond(const google::protobuf::MessageLite& response,
   }
 }
 
+Status LocalYBInboundCall::AddRpcFileSidecar(FileSidecarPtr file, int* idx) {
+  return AddRpcSidecar(VERIFY_RESULT(file->Read()), idx);
+}
+
 Status LocalYBInboundCall::ParseParam(google::protobuf::Message* message) {
   LOG(FATAL) << "local call should not require parsing";
 }
@@ -46,6 +46,9 @@ class LocalOutboundCall : public OutboundCall {
 
   const google::protobuf::Message* req_ = nullptr;
 
+  // Copy of the request, when serialized request fields should be merged into it.
+  std::unique_ptr<google::protobuf::Message> owned_req_;
+
   std::shared_ptr<LocalYBInboundCall> inbound_call_;
 };
 
@@ -64,6 +67,9 @@ class LocalYBInboundCall : public YBInboundCall {
 
   CHECKED_STATUS ParseParam(google::protobuf::Message* message) override;
 
+  // Local calls are not sent through a socket, so file sidecars are read into buffer sidecars.
+  CHECKED_STATUS AddRpcFileSidecar(FileSidecarPtr file, int* idx) override;
+
   const google::protobuf::Message* request() const { return outbound_call()->req_; }
   google::protobuf::Message* response() const { return outbound_call()->response(); }
 
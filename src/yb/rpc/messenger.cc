@@ -63,9 +63,11 @@
 #include "yb/util/errno.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
+#include "yb/util/mem_tracker.h"
 #include "yb/util/metrics.h"
 #include "yb/util/monotime.h"
 #include "yb/util/net/socket.h"
+#include "yb/util/numa.h"
 #include "yb/util/status.h"
 #include "yb/util/threadpool.h"
 #include "yb/util/trace.h"
@@ -81,6 +83,11 @@ DEFINE_int32(rpc_default_keepalive_time_ms, 65000,
              "will disconnect the client. Setting flag to 0 disables this clean up.");
 TAG_FLAG(rpc_default_keepalive_time_ms, advanced);
 DEFINE_uint64(io_thread_pool_size, 4, "Size of allocated IO Thread Pool.");
+DECLARE_uint64(rpc_initial_buffer_size);
+DEFINE_uint64(rpc_read_buffer_pool_max_blocks, 1024,
+              "Max number of free blocks of rpc_initial_buffer_size bytes that are kept by "
+              "messenger for reuse by connection read buffers");
+TAG_FLAG(rpc_read_buffer_pool_max_blocks, advanced);
 
 namespace yb {
 namespace rpc {
@@ -308,7 +315,7 @@ Status Messenger::UnregisterService(const string& service_name) {
 
 void Messenger::QueueOutboundCall(OutboundCallPtr call) {
   const auto& remote = call->conn_id().remote();
-  Reactor *reactor = RemoteToReactor(remote, call->conn_id().idx());
+  Reactor *reactor = RemoteToReactor(remote, call->conn_id().idx(), true /* numa_local */);
 
   if (IsArtificiallyDisconnectedFrom(remote.address())) {
     LOG(INFO) << "TEST: Rejected connection to " << remote;
@@ -369,6 +376,10 @@ Messenger::Messenger(const MessengerBuilder &bld)
     : name_(bld.name_),
       connection_context_factory_(bld.connection_context_factory_),
       metric_entity_(bld.metric_entity_),
+      request_timeline_tracker_(bld.metric_entity_),
+      read_buffer_allocator_(
+          FLAGS_rpc_initial_buffer_size, FLAGS_rpc_read_buffer_pool_max_blocks,
+          MemTracker::FindOrCreateTracker(-1, "Read Buffer")),
       retain_self_(this),
       io_thread_pool_(FLAGS_io_thread_pool_size),
       scheduler_(&io_thread_pool_.io_service()) {
@@ -399,13 +410,32 @@ size_t Messenger::max_concurrent_requests() const {
   return FLAGS_num_connections_to_server;
 }
 
-Reactor* Messenger::RemoteToReactor(const Endpoint& remote, uint32_t idx) {
+std::vector<int64_t> Messenger::ReactorThreadIds() const {
+  std::vector<int64_t> result;
+  result.reserve(reactors_.size());
+  for (const auto* reactor : reactors_) {
+    result.push_back(reactor->thread_id());
+  }
+  return result;
+}
+
+Reactor* Messenger::RemoteToReactor(const Endpoint& remote, uint32_t idx, bool numa_local) {
   uint32_t hashCode = hash_value(remote);
-  int reactor_idx = (hashCode + idx) % reactors_.size();
+  size_t reactor_idx = (hashCode + idx) % reactors_.size();
   // This is just a static partitioning; where each connection
   // to a remote is assigned to a particular reactor. We could
   // get a lot fancier with assigning Sockaddrs to Reactors,
   // but this should be good enough.
+  if (numa_local && NumaAwarePlacementEnabled()) {
+    // Reactor with index i is bound to NUMA node i % NumaNodeCount(), so the same partitioning is
+    // applied to reactors of the current node only.
+    const size_t num_nodes = NumaNodeCount();
+    const size_t node = CurrentNumaNode();
+    if (node < reactors_.size()) {
+      const size_t num_node_reactors = (reactors_.size() - node + num_nodes - 1) / num_nodes;
+      reactor_idx = node + num_nodes * ((hashCode + idx) % num_node_reactors);
+    }
+  }
   return reactors_[reactor_idx];
 }
 
@@ -424,6 +454,9 @@ Status Messenger::DumpRunningRpcs(const DumpRunningRpcsRequestPB& req,
   for (Reactor* reactor : reactors_) {
     RETURN_NOT_OK(reactor->DumpRunningRpcs(req, resp));
   }
+  if (req.include_slow_calls()) {
+    request_timeline_tracker_.DumpSlowCalls(resp);
+  }
   return Status::OK();
 }
 
@@ -47,8 +47,10 @@
 #include "yb/gutil/gscoped_ptr.h"
 #include "yb/gutil/ref_counted.h"
 
+#include "yb/rpc/growable_buffer.h"
 #include "yb/rpc/io_thread_pool.h"
 #include "yb/rpc/reactor.h"
+#include "yb/rpc/request_timeline_tracker.h"
 #include "yb/rpc/response_callback.h"
 #include "yb/rpc/scheduler.h"
 
@@ -199,10 +201,15 @@ class Messenger {
 
   scoped_refptr<MetricEntity> metric_entity() const { return metric_entity_; }
 
+  GrowableBufferAllocator& read_buffer_allocator() { return read_buffer_allocator_; }
+
   scoped_refptr<RpcService> rpc_service(const std::string& service_name) const;
 
   size_t max_concurrent_requests() const;
 
+  // System thread ids of the reactor threads, e.g. to account CPU usage per reactor.
+  std::vector<int64_t> ReactorThreadIds() const;
+
   const IpAddress& outbound_address_v4() const { return outbound_address_v4_; }
   const IpAddress& outbound_address_v6() const { return outbound_address_v6_; }
 
@@ -213,13 +220,19 @@ class Messenger {
     return scheduler_;
   }
 
+  RequestTimelineTracker& request_timeline_tracker() {
+    return request_timeline_tracker_;
+  }
+
  private:
   FRIEND_TEST(TestRpc, TestConnectionKeepalive);
   friend class DelayedTask;
 
   explicit Messenger(const MessengerBuilder &bld);
 
-  Reactor* RemoteToReactor(const Endpoint& remote, uint32_t idx = 0);
+  // When numa_local is true and NUMA aware placement is enabled, the reactor is picked among
+  // reactors of the NUMA node of the current thread.
+  Reactor* RemoteToReactor(const Endpoint& remote, uint32_t idx = 0, bool numa_local = false);
   CHECKED_STATUS Init();
   void UpdateServicesCache(std::lock_guard<percpu_rwlock>* guard);
 
@@ -247,6 +260,12 @@ class Messenger {
   const scoped_refptr<MetricEntity> metric_entity_;
   const scoped_refptr<Histogram> outgoing_queue_time_;
 
+  // Collects timelines of inbound calls handled by this messenger.
+  RequestTimelineTracker request_timeline_tracker_;
+
+  // Shared by read buffers of all connections of this messenger.
+  GrowableBufferAllocator read_buffer_allocator_;
+
   // Acceptor which is listening on behalf of this messenger.
   std::unique_ptr<Acceptor> acceptor_;
   IpAddress outbound_address_v4_;
@@ -225,16 +225,26 @@ void OutboundCall::NotifyTransferred(const Status& status, Connection* conn) {
 
 void OutboundCall::Serialize(std::deque<RefCntBuffer>* output) const {
   output->push_back(buffer_);
+  output->insert(output->end(),
+                 serialized_request_fields_.begin(), serialized_request_fields_.end());
 }
 
 Status OutboundCall::SetRequestParam(const Message& message) {
   using serialization::SerializeHeader;
   using serialization::SerializeMessage;
 
+  // Pre-serialized fields are sent as separate buffers after the message, but they are accounted
+  // in the message length, so the receiver parses them as a part of the message.
+  serialized_request_fields_ = controller_->serialized_request_fields();
+  size_t fields_size = 0;
+  for (const auto& fields : serialized_request_fields_) {
+    fields_size += fields.size();
+  }
+
   size_t message_size = 0;
   auto status = SerializeMessage(message,
                                  /* param_buf */ nullptr,
-                                 /* additional_size */ 0,
+                                 fields_size,
                                  /* use_cached_size */ false,
                                  /* offset */ 0,
                                  &message_size);
@@ -245,14 +255,15 @@ Status OutboundCall::SetRequestParam(const Message& message) {
 
   RequestHeader header;
   InitHeader(&header);
-  status = SerializeHeader(header, message_size, &buffer_, message_size, &header_size);
+  status = SerializeHeader(
+      header, message_size + fields_size, &buffer_, message_size, &header_size);
   remote_method_pool_->Release(header.release_remote_method());
   if (!status.ok()) {
     return status;
   }
   return SerializeMessage(message,
                           &buffer_,
-                          /* additional_size */ 0,
+                          fields_size,
                           /* use_cached_size */ true,
                           header_size);
 }
@@ -391,6 +402,7 @@ void OutboundCall::SetQueued() {
 void OutboundCall::SetSent() {
   auto end_time = MonoTime::Now();
   buffer_ = RefCntBuffer();
+  serialized_request_fields_.clear();
   // Track time taken to be sent
   if (outbound_call_metrics_) {
     outbound_call_metrics_->send_time->Increment(end_time.GetDeltaSince(start_).ToMicroseconds());
@@ -325,6 +325,9 @@ class OutboundCall : public RpcCall {
   // Buffers for storing segments of the wire-format request.
   RefCntBuffer buffer_;
 
+  // Pre-serialized request fields, that are sent after buffer_.
+  std::vector<RefCntBuffer> serialized_request_fields_;
+
   // Once a response has been received for this call, contains that response.
   CallResponse call_response_;
 
@@ -16,6 +16,9 @@
 
 #include <deque>
 #include <memory>
+#include <vector>
+
+#include "yb/rpc/file_sidecar.h"
 
 #include "yb/util/ref_cnt_buffer.h"
 
@@ -42,6 +45,9 @@ class OutboundData : public std::enable_shared_from_this<OutboundData> {
   // Serializes the data to be sent out via the RPC framework.
   virtual void Serialize(std::deque<RefCntBuffer> *output) const = 0;
 
+  // Appends file ranges that should be sent right after the buffers appended by Serialize().
+  virtual void SerializeFileSidecars(std::vector<FileSidecarPtr>* output) const {}
+
   virtual std::string ToString() const {
     return "<ToStringNotImplemented>";
   }
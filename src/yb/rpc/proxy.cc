@@ -52,6 +52,7 @@
 #include "yb/util/net/sockaddr.h"
 #include "yb/util/net/socket.h"
 #include "yb/util/countdown_latch.h"
+#include "yb/util/object_pool.h"
 #include "yb/util/status.h"
 #include "yb/util/user.h"
 
@@ -96,18 +97,20 @@ void Proxy::AsyncRequest(const RemoteMethod* method,
 
   controller->call_ =
       call_local_service_ ?
-      std::make_shared<LocalOutboundCall>(conn_ids_[idx],
-                                          method,
-                                          outbound_call_metrics_,
-                                          resp,
-                                          controller,
-                                          std::move(callback)) :
-      std::make_shared<OutboundCall>(conn_ids_[idx],
-                                     method,
-                                     outbound_call_metrics_,
-                                     resp,
-                                     controller,
-                                     std::move(callback));
+      std::allocate_shared<LocalOutboundCall>(PooledAllocator<LocalOutboundCall>(),
+                                              conn_ids_[idx],
+                                              method,
+                                              outbound_call_metrics_,
+                                              resp,
+                                              controller,
+                                              std::move(callback)) :
+      std::allocate_shared<OutboundCall>(PooledAllocator<OutboundCall>(),
+                                         conn_ids_[idx],
+                                         method,
+                                         outbound_call_metrics_,
+                                         resp,
+                                         controller,
+                                         std::move(callback));
   auto call = controller->call_.get();
   Status s = call->SetRequestParam(req);
   if (PREDICT_FALSE(!s.ok())) {
@@ -62,6 +62,7 @@
 #include "yb/util/flag_tags.h"
 #include "yb/util/memory/memory.h"
 #include "yb/util/monotime.h"
+#include "yb/util/numa.h"
 #include "yb/util/thread.h"
 #include "yb/util/threadpool.h"
 #include "yb/util/thread_restrictions.h"
@@ -117,6 +118,7 @@ Reactor::Reactor(const shared_ptr<Messenger>& messenger,
                  int index,
                  const MessengerBuilder &bld)
   : messenger_(messenger),
+    index_(index),
     name_(StringPrintf("%s_R%03d", messenger->name().c_str(), index)),
     loop_(kDefaultLibEvFlags),
     cur_time_(CoarseMonoClock::Now()),
@@ -149,6 +151,10 @@ Status Reactor::Init() {
   timer_.start(ToSeconds(coarse_timer_granularity_),
                ToSeconds(coarse_timer_granularity_));
 
+  prepare_.set(loop_);
+  prepare_.set<Reactor, &Reactor::PrepareHandler>(this);
+  prepare_.start();
+
   // Create Reactor thread.
   const std::string group_name = messenger_->name() + "_reactor";
   return yb::Thread::Create(group_name, group_name, &Reactor::RunThread, this, &thread_);
@@ -231,6 +237,25 @@ void Reactor::ShutdownInternal() {
     call->Transferred(aborted, nullptr);
   }
   processing_outbound_queue_.clear();
+
+  corked_connections_.clear();
+}
+
+void Reactor::CorkConnection(ConnectionPtr conn) {
+  DCHECK(IsCurrentThread());
+  corked_connections_.push_back(std::move(conn));
+}
+
+void Reactor::PrepareHandler(ev::prepare& watcher, int revents) {  // NOLINT
+  DCHECK(IsCurrentThread());
+  if (corked_connections_.empty()) {
+    return;
+  }
+  flushing_connections_.swap(corked_connections_);
+  for (auto& conn : flushing_connections_) {
+    conn->Uncork();
+  }
+  flushing_connections_.clear();
 }
 
 ReactorTask::ReactorTask() {
@@ -425,6 +450,7 @@ bool Reactor::closing() const {
 void Reactor::RunThread() {
   ThreadRestrictions::SetWaitAllowed(false);
   ThreadRestrictions::SetIOAllowed(false);
+  MaybeBindCurrentThreadToNumaNode(index_);
   DVLOG(6) << "Calling Reactor::RunThread()...";
   loop_.run(0);
   VLOG(1) << name() << " thread exiting.";
@@ -271,9 +271,20 @@ class Reactor {
   // libev callback for handling timer events in our epoll thread.
   void TimerHandler(ev::timer &watcher, int revents); // NOLINT
 
+  // libev callback invoked before event loop waits for new events, flushes corked connections.
+  void PrepareHandler(ev::prepare &watcher, int revents); // NOLINT
+
+  // Write of connection's outbound data is postponed till all events of the current event loop
+  // iteration are processed, so data queued during this iteration is sent with a single syscall.
+  // Should be invoked in reactor thread.
+  void CorkConnection(ConnectionPtr conn);
+
   // This may be called from another thread.
   const std::string &name() const { return name_; }
 
+  // System thread id of the reactor thread.
+  int64_t thread_id() const { return thread_->tid(); }
+
   Messenger *messenger() const { return messenger_.get(); }
 
   CoarseMonoClock::TimePoint cur_time() const { return cur_time_; }
@@ -373,6 +384,7 @@ class Reactor {
   // parent messenger
   std::shared_ptr<Messenger> messenger_;
 
+  const int index_;
   const std::string name_;
 
   mutable simple_spinlock pending_tasks_lock_;
@@ -396,6 +408,13 @@ class Reactor {
   // Handles the periodic timer.
   ev::timer timer_;
 
+  // Flushes corked connections before loop waits for new events.
+  ev::prepare prepare_;
+
+  // Connections with postponed writes, accessed only from reactor thread.
+  std::vector<ConnectionPtr> corked_connections_;
+  std::vector<ConnectionPtr> flushing_connections_;
+
   // Scheduled (but not yet run) delayed tasks.
   std::set<std::shared_ptr<DelayedTask>> scheduled_tasks_;
 
@@ -0,0 +1,158 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/rpc/request_timeline_tracker.h"
+
+#include <gflags/gflags.h>
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/metrics.h"
+
+DEFINE_int32(rpc_slow_call_timeline_threshold_ms, 1000,
+             "Timelines of inbound calls that take longer than this threshold are kept to be "
+             "exported by /rpcz?include_slow_calls=true.");
+TAG_FLAG(rpc_slow_call_timeline_threshold_ms, advanced);
+TAG_FLAG(rpc_slow_call_timeline_threshold_ms, runtime);
+
+DEFINE_int32(rpc_max_slow_call_timelines, 64,
+             "Max number of slow call timelines kept by each messenger.");
+TAG_FLAG(rpc_max_slow_call_timelines, advanced);
+TAG_FLAG(rpc_max_slow_call_timelines, runtime);
+
+METRIC_DEFINE_histogram(server, rpc_phase_service_queue_time,
+                        "RPC Service Queue Phase Time",
+                        yb::MetricUnit::kMicroseconds,
+                        "Microseconds between receiving an inbound call and the start of its "
+                        "handling",
+                        60000000LU, 2);
+
+METRIC_DEFINE_histogram(server, rpc_phase_handler_time,
+                        "RPC Handler Phase Time",
+                        yb::MetricUnit::kMicroseconds,
+                        "Microseconds between the start of handling an inbound call and "
+                        "submitting its operation to the tablet preparer",
+                        60000000LU, 2);
+
+METRIC_DEFINE_histogram(server, rpc_phase_preparer_time,
+                        "RPC Preparer Phase Time",
+                        yb::MetricUnit::kMicroseconds,
+                        "Microseconds that operations of inbound calls spend in the tablet "
+                        "preparer",
+                        60000000LU, 2);
+
+METRIC_DEFINE_histogram(server, rpc_phase_replicate_time,
+                        "RPC Replicate Phase Time",
+                        yb::MetricUnit::kMicroseconds,
+                        "Microseconds between preparing an operation of an inbound call and its "
+                        "Raft replication to the majority",
+                        60000000LU, 2);
+
+METRIC_DEFINE_histogram(server, rpc_phase_apply_time,
+                        "RPC Apply Phase Time",
+                        yb::MetricUnit::kMicroseconds,
+                        "Microseconds between replication of an operation of an inbound call and "
+                        "its apply to the tablet",
+                        60000000LU, 2);
+
+METRIC_DEFINE_histogram(server, rpc_phase_respond_time,
+                        "RPC Respond Phase Time",
+                        yb::MetricUnit::kMicroseconds,
+                        "Microseconds between the previous phase of an inbound call and queueing "
+                        "its response",
+                        60000000LU, 2);
+
+namespace yb {
+namespace rpc {
+
+namespace {
+
+const HistogramPrototype* PhaseHistogramPrototype(RequestPhase phase) {
+  switch (phase) {
+    case RequestPhase::kReceived:
+      return nullptr;
+    case RequestPhase::kHandlingStarted:
+      return &METRIC_rpc_phase_service_queue_time;
+    case RequestPhase::kSubmittedToPreparer:
+      return &METRIC_rpc_phase_handler_time;
+    case RequestPhase::kPrepared:
+      return &METRIC_rpc_phase_preparer_time;
+    case RequestPhase::kReplicated:
+      return &METRIC_rpc_phase_replicate_time;
+    case RequestPhase::kApplied:
+      return &METRIC_rpc_phase_apply_time;
+    case RequestPhase::kResponded:
+      return &METRIC_rpc_phase_respond_time;
+  }
+  FATAL_INVALID_ENUM_VALUE(RequestPhase, phase);
+}
+
+} // namespace
+
+RequestTimelineTracker::RequestTimelineTracker(const scoped_refptr<MetricEntity>& entity) {
+  if (!entity) {
+    return;
+  }
+  for (auto phase : kRequestPhaseList) {
+    const auto* prototype = PhaseHistogramPrototype(phase);
+    if (prototype) {
+      phase_histograms_[static_cast<size_t>(phase)] = prototype->Instantiate(entity);
+    }
+  }
+}
+
+RequestTimelineTracker::~RequestTimelineTracker() {
+}
+
+void RequestTimelineTracker::CallCompleted(const std::string& service_name,
+                                           const std::string& method_name,
+                                           const RequestTimeline& timeline) {
+  const size_t size = timeline.size();
+  for (size_t i = 1; i < size; ++i) {
+    const auto& histogram = phase_histograms_[static_cast<size_t>(timeline.entry(i).phase)];
+    if (histogram) {
+      histogram->Increment(timeline.MicrosSincePrevious(i));
+    }
+  }
+
+  const int64_t total_micros = timeline.TotalMicros();
+  if (total_micros < FLAGS_rpc_slow_call_timeline_threshold_ms * 1000LL) {
+    return;
+  }
+
+  RpcCallTimelinePB slow_call;
+  slow_call.set_service_name(service_name);
+  slow_call.set_method_name(method_name);
+  slow_call.set_total_micros(total_micros);
+  for (size_t i = 0; i != size; ++i) {
+    auto* phase = slow_call.add_phases();
+    phase->set_phase(ToString(timeline.entry(i).phase));
+    phase->set_micros_since_received(timeline.MicrosSinceStart(i));
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  slow_calls_.push_front(std::move(slow_call));
+  const size_t max_slow_calls = std::max(FLAGS_rpc_max_slow_call_timelines, 0);
+  while (slow_calls_.size() > max_slow_calls) {
+    slow_calls_.pop_back();
+  }
+}
+
+void RequestTimelineTracker::DumpSlowCalls(DumpRunningRpcsResponsePB* resp) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& slow_call : slow_calls_) {
+    *resp->add_slow_calls() = slow_call;
+  }
+}
+
+} // namespace rpc
+} // namespace yb
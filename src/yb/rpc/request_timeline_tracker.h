@@ -0,0 +1,64 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_RPC_REQUEST_TIMELINE_TRACKER_H
+#define YB_RPC_REQUEST_TIMELINE_TRACKER_H
+
+#include <array>
+#include <deque>
+#include <mutex>
+#include <string>
+
+#include "yb/gutil/ref_counted.h"
+
+#include "yb/rpc/rpc_introspection.pb.h"
+
+#include "yb/util/request_timeline.h"
+
+namespace yb {
+
+class Histogram;
+class MetricEntity;
+
+namespace rpc {
+
+// Collects timelines of completed inbound calls of a messenger. For every phase the time since the
+// previous recorded phase is added to the histogram of this phase, and timelines of calls that took
+// longer than --rpc_slow_call_timeline_threshold_ms are kept to be exported by /rpcz.
+class RequestTimelineTracker {
+ public:
+  // 'entity' could be null, in this case only slow calls are collected.
+  explicit RequestTimelineTracker(const scoped_refptr<MetricEntity>& entity);
+  ~RequestTimelineTracker();
+
+  RequestTimelineTracker(const RequestTimelineTracker&) = delete;
+  void operator=(const RequestTimelineTracker&) = delete;
+
+  void CallCompleted(const std::string& service_name,
+                     const std::string& method_name,
+                     const RequestTimeline& timeline);
+
+  // Appends timelines of recent slow calls, the most recent first.
+  void DumpSlowCalls(DumpRunningRpcsResponsePB* resp) const;
+
+ private:
+  std::array<scoped_refptr<Histogram>, kRequestPhaseMapSize> phase_histograms_;
+
+  mutable std::mutex mutex_;
+  std::deque<RpcCallTimelinePB> slow_calls_;
+};
+
+} // namespace rpc
+} // namespace yb
+
+#endif // YB_RPC_REQUEST_TIMELINE_TRACKER_H
@@ -30,18 +30,46 @@
 // under the License.
 //
 
+#include <mutex>
 #include <string>
 #include <thread>
 
 #include <gtest/gtest.h>
 
+#include "yb/gutil/strings/split.h"
 #include "yb/rpc/rpc-test-base.h"
 #include "yb/rpc/rtest.proxy.h"
 #include "yb/util/countdown_latch.h"
+#include "yb/util/hdr_histogram.h"
+#include "yb/util/os-util.h"
 #include "yb/util/test_util.h"
 
 using namespace std::literals; // NOLINT
 
+METRIC_DECLARE_counter(rpc_thread_pool_steals);
+
+DECLARE_int32(num_connections_to_server);
+
+DEFINE_int32(rpc_bench_client_messengers, 8,
+             "Number of client messengers used by the latency under load benchmark.");
+DEFINE_int32(rpc_bench_connections_per_messenger, 16,
+             "Number of connections from every client messenger to the server, at most 256.");
+DEFINE_string(rpc_bench_request_sizes, "16,1024,65536",
+              "Comma separated request payload sizes, picked uniformly for every call.");
+DEFINE_string(rpc_bench_response_sidecar_sizes, "0,4096,262144",
+              "Comma separated response sidecar sizes, picked uniformly for every call.");
+DEFINE_int32(rpc_bench_target_calls_per_sec, 20000,
+             "Open loop arrival rate of calls, split evenly between client messengers.");
+DEFINE_int32(rpc_bench_max_outstanding_calls, 10000,
+             "Maximum number of outstanding calls per client messenger. Calls that arrive when "
+             "the limit is reached are counted as missed.");
+DEFINE_string(rpc_bench_server_reactors, "1,4",
+              "Comma separated numbers of server reactors to compare.");
+DEFINE_string(rpc_bench_service_threads, "3,16",
+              "Comma separated numbers of service pool threads to compare.");
+DEFINE_int32(rpc_bench_run_seconds, 5,
+             "Duration of every latency under load run.");
+
 using std::string;
 using std::shared_ptr;
 
@@ -54,7 +82,12 @@ class RpcBench : public RpcTestBase {
   {}
 
  protected:
+  void RunBenchmark(const TestServerOptions& options);
+
+  void RunLatencyUnderLoad(size_t server_reactors, size_t service_threads);
+
   friend class ClientThread;
+  friend class OpenLoopClient;
 
   Endpoint server_endpoint_;
   shared_ptr<Messenger> client_messenger_;
@@ -100,13 +133,194 @@ class ClientThread {
 };
 
 
-// Test making successful RPC calls.
-TEST_F(RpcBench, BenchmarkCalls) {
+std::vector<size_t> ParseSizes(const std::string& list) {
+  const std::vector<std::string> values = strings::Split(list, ",", strings::SkipEmpty());
+  std::vector<size_t> result;
+  for (const auto& value : values) {
+    result.push_back(std::stoul(value));
+  }
+  CHECK(!result.empty()) << "Empty list: " << list;
+  return result;
+}
+
+// Issues Echo calls at a fixed rate, regardless of how fast they complete. Latency is measured
+// from the time a call was scheduled to be sent, so a server that falls behind is not hidden by
+// the client slowing down.
+class OpenLoopClient {
+ public:
+  OpenLoopClient(RpcBench* bench, int index, double calls_per_sec, HdrHistogram* latency_us)
+      : bench_(bench), index_(index), calls_per_sec_(calls_per_sec), latency_us_(latency_us) {
+    for (auto size : ParseSizes(FLAGS_rpc_bench_request_sizes)) {
+      payloads_.emplace_back(size, 'x');
+    }
+    sidecar_sizes_ = ParseSizes(FLAGS_rpc_bench_response_sidecar_sizes);
+  }
+
+  void Start() {
+    thread_ = std::thread(&OpenLoopClient::Run, this);
+  }
+
+  void Join() {
+    thread_.join();
+  }
+
+  int64_t completed() const { return completed_; }
+  int64_t failed() const { return failed_; }
+  int64_t missed() const { return missed_; }
+
+ private:
+  struct Call {
+    rpc_test::EchoRequestPB req;
+    rpc_test::EchoResponsePB resp;
+    RpcController controller;
+    MonoTime scheduled;
+  };
+
+  void Run() {
+    // Every client uses its own messenger, so it has its own connections to the server.
+    auto messenger = bench_->CreateMessenger(Format("Client$0", index_));
+    rpc_test::CalculatorServiceProxy proxy(messenger, bench_->server_endpoint_);
+    std::mt19937_64 random(index_);
+
+    const MonoDelta interval = MonoDelta::FromSeconds(1 / calls_per_sec_);
+    MonoTime scheduled = MonoTime::Now();
+    while (bench_->should_run_.load(std::memory_order_acquire)) {
+      const MonoDelta wait = scheduled.GetDeltaSince(MonoTime::Now());
+      if (wait.ToNanoseconds() > 0) {
+        SleepFor(wait);
+      }
+      scheduled.AddDelta(interval);
+      DeleteFinishedCalls();
+      if (outstanding_.load(std::memory_order_acquire) >= FLAGS_rpc_bench_max_outstanding_calls) {
+        ++missed_;
+        continue;
+      }
+
+      auto* call = new Call;
+      call->req.set_data(payloads_[random() % payloads_.size()]);
+      call->req.set_response_sidecar_size(sidecar_sizes_[random() % sidecar_sizes_.size()]);
+      call->controller.set_timeout(MonoDelta::FromSeconds(60));
+      call->scheduled = scheduled;
+      ++outstanding_;
+      proxy.EchoAsync(call->req, &call->resp, &call->controller, [this, call] {
+        CallDone(call);
+      });
+    }
+
+    while (outstanding_.load(std::memory_order_acquire) != 0) {
+      SleepFor(MonoDelta::FromMilliseconds(1));
+    }
+    DeleteFinishedCalls();
+    messenger->Shutdown();
+  }
+
+  // Invoked on a reactor thread. The call is deleted later by the client thread, since the
+  // controller must stay alive until the callback returns.
+  void CallDone(Call* call) {
+    if (call->controller.status().ok()) {
+      latency_us_->Increment(MonoTime::Now().GetDeltaSince(call->scheduled).ToMicroseconds());
+      ++completed_;
+    } else {
+      YB_LOG_EVERY_N(WARNING, 1000) << "Call failed: " << call->controller.status();
+      ++failed_;
+    }
+    {
+      std::lock_guard<std::mutex> lock(finished_mutex_);
+      finished_.push_back(call);
+    }
+    --outstanding_;
+  }
+
+  void DeleteFinishedCalls() {
+    std::vector<Call*> finished;
+    {
+      std::lock_guard<std::mutex> lock(finished_mutex_);
+      finished.swap(finished_);
+    }
+    for (auto* call : finished) {
+      delete call;
+    }
+  }
+
+  RpcBench* const bench_;
+  const int index_;
+  const double calls_per_sec_;
+  HdrHistogram* const latency_us_;
+  std::vector<std::string> payloads_;
+  std::vector<size_t> sidecar_sizes_;
+  std::thread thread_;
+  std::atomic<int64_t> outstanding_{0};
+  std::atomic<int64_t> completed_{0};
+  std::atomic<int64_t> failed_{0};
+  int64_t missed_ = 0;
+  std::mutex finished_mutex_;
+  std::vector<Call*> finished_;
+};
+
+void RpcBench::RunLatencyUnderLoad(size_t server_reactors, size_t service_threads) {
   TestServerOptions options;
-  options.n_worker_threads = 1;
+  options.messenger_options.n_reactors = server_reactors;
+  options.n_worker_threads = service_threads;
+  options.queue_length = FLAGS_rpc_bench_client_messengers * FLAGS_rpc_bench_max_outstanding_calls;
+  StartTestServerWithGeneratedCode(&server_endpoint_, options);
+
+  FLAGS_num_connections_to_server = FLAGS_rpc_bench_connections_per_messenger;
+  should_run_.store(true, std::memory_order_release);
+
+  const auto reactor_tids = server_messenger().ReactorThreadIds();
+  std::vector<ThreadStats> start_stats(reactor_tids.size());
+  for (size_t i = 0; i != reactor_tids.size(); ++i) {
+    ASSERT_OK(GetThreadStats(reactor_tids[i], &start_stats[i]));
+  }
+
+  HdrHistogram latency_us(60 * MonoTime::kMicrosecondsPerSecond, 3);
+  const double calls_per_sec_per_client =
+      static_cast<double>(FLAGS_rpc_bench_target_calls_per_sec) /
+      FLAGS_rpc_bench_client_messengers;
+  std::vector<std::unique_ptr<OpenLoopClient>> clients;
+  for (int i = 0; i != FLAGS_rpc_bench_client_messengers; ++i) {
+    clients.push_back(
+        std::make_unique<OpenLoopClient>(this, i, calls_per_sec_per_client, &latency_us));
+  }
+  const MonoTime start = MonoTime::Now();
+  for (auto& client : clients) {
+    client->Start();
+  }
+
+  std::this_thread::sleep_for(std::chrono::seconds(FLAGS_rpc_bench_run_seconds));
+  should_run_.store(false, std::memory_order_release);
+  int64_t completed = 0, failed = 0, missed = 0;
+  for (auto& client : clients) {
+    client->Join();
+    completed += client->completed();
+    failed += client->failed();
+    missed += client->missed();
+  }
+  const MonoDelta elapsed = MonoTime::Now().GetDeltaSince(start);
+
+  LOG(INFO) << "Server reactors: " << server_reactors << ", service threads: " << service_threads
+            << ", connections: "
+            << FLAGS_rpc_bench_client_messengers * FLAGS_rpc_bench_connections_per_messenger;
+  LOG(INFO) << "Calls/sec:        " << completed / elapsed.ToSeconds()
+            << " (target " << FLAGS_rpc_bench_target_calls_per_sec << ")";
+  LOG(INFO) << "Failed calls:     " << failed << ", missed arrivals: " << missed;
+  LOG(INFO) << "Latency p50/p99/p99.9: " << latency_us.ValueAtPercentile(50) << "/"
+            << latency_us.ValueAtPercentile(99) << "/" << latency_us.ValueAtPercentile(99.9)
+            << "us, max: " << latency_us.MaxValue() << "us";
+  for (size_t i = 0; i != reactor_tids.size(); ++i) {
+    ThreadStats stats;
+    ASSERT_OK(GetThreadStats(reactor_tids[i], &stats));
+    const int64_t cpu_ns = stats.user_ns - start_stats[i].user_ns +
+                           stats.kernel_ns - start_stats[i].kernel_ns;
+    LOG(INFO) << "Server reactor " << i << " CPU: "
+              << cpu_ns * 100.0 / elapsed.ToNanoseconds() << "%, "
+              << cpu_ns / 1000.0 / std::max<int64_t>(completed, 1) << "us per call";
+  }
+}
 
+void RpcBench::RunBenchmark(const TestServerOptions& options) {
   // Set up server.
-  StartTestServerWithGeneratedCode(&server_endpoint_);
+  StartTestServerWithGeneratedCode(&server_endpoint_, options);
 
   // Set up client.
   LOG(INFO) << "Connecting to " << server_endpoint_;
@@ -147,6 +361,31 @@ TEST_F(RpcBench, BenchmarkCalls) {
   LOG(INFO) << "Reqs/sec:         " << reqs_per_second;
   LOG(INFO) << "User CPU per req: " << user_cpu_micros_per_req << "us";
   LOG(INFO) << "Sys CPU per req:  " << sys_cpu_micros_per_req << "us";
+  if (options.work_stealing) {
+    LOG(INFO) << "Steals:           "
+              << METRIC_rpc_thread_pool_steals.Instantiate(metric_entity())->value();
+  }
+}
+
+// Test making successful RPC calls.
+TEST_F(RpcBench, BenchmarkCalls) {
+  RunBenchmark(TestServerOptions());
+}
+
+TEST_F(RpcBench, BenchmarkCallsWorkStealing) {
+  TestServerOptions options;
+  options.work_stealing = true;
+  RunBenchmark(options);
+}
+
+// Latency of many connections issuing mixed size calls at a fixed rate, for every combination of
+// server reactors and service threads. Configured with rpc_bench_* flags.
+TEST_F(RpcBench, BenchmarkLatencyUnderLoad) {
+  for (auto server_reactors : ParseSizes(FLAGS_rpc_bench_server_reactors)) {
+    for (auto service_threads : ParseSizes(FLAGS_rpc_bench_service_threads)) {
+      ASSERT_NO_FATALS(RunLatencyUnderLoad(server_reactors, service_threads));
+    }
+  }
 }
 
 } // namespace rpc
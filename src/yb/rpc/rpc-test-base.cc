@@ -50,8 +50,6 @@ using yb::rpc_test_diff_package::RespDiffPackagePB;
 
 namespace {
 
-constexpr size_t kQueueLength = 50;
-
 Slice GetSidecarPointer(const RpcController& controller, int idx, int expected_size) {
   Slice sidecar;
   CHECK_OK(controller.GetSidecar(idx, &sidecar));
@@ -220,6 +218,17 @@ class CalculatorService: public CalculatorServiceIf {
 
   void Echo(const EchoRequestPB* req, EchoResponsePB* resp, RpcContext context) override {
     resp->set_data(req->data());
+    if (req->response_sidecar_size()) {
+      auto sidecar = RefCntBuffer(req->response_sidecar_size());
+      memset(sidecar.udata(), 'x', sidecar.size());
+      int idx = 0;
+      auto status = context.AddRpcSidecar(sidecar, &idx);
+      if (!status.ok()) {
+        context.RespondFailure(status);
+        return;
+      }
+      resp->set_sidecar(idx);
+    }
     context.RespondSuccess();
   }
 
@@ -302,7 +311,8 @@ TestServer::TestServer(std::unique_ptr<ServiceIf> service,
       messenger_(CreateMessenger("TestServer",
                                  metric_entity,
                                  options.messenger_options)),
-      thread_pool_("rpc-test", kQueueLength, options.n_worker_threads) {
+      thread_pool_("rpc-test", options.queue_length, options.n_worker_threads,
+                   options.work_stealing, metric_entity) {
 
   // If it is CalculatorService then we should set messenger for it.
   CalculatorService* calculator_service = dynamic_cast<CalculatorService*>(service.get());
@@ -310,7 +320,7 @@ TestServer::TestServer(std::unique_ptr<ServiceIf> service,
     calculator_service->SetMessenger(messenger_);
   }
 
-  service_pool_.reset(new ServicePool(kQueueLength,
+  service_pool_.reset(new ServicePool(options.queue_length,
                                       &thread_pool_,
                                       std::move(service),
                                       messenger_->metric_entity()));
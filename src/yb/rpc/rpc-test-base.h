@@ -124,6 +124,8 @@ extern const MessengerOptions kDefaultServerMessengerOptions;
 struct TestServerOptions {
   MessengerOptions messenger_options = kDefaultServerMessengerOptions;
   size_t n_worker_threads = 3;
+  size_t queue_length = 50;
+  bool work_stealing = false;
   Endpoint endpoint;
 };
 
@@ -52,6 +52,10 @@
 METRIC_DECLARE_histogram(handler_latency_yb_rpc_test_CalculatorService_Sleep);
 METRIC_DECLARE_histogram(rpc_incoming_queue_time);
 
+DECLARE_bool(rpc_cork_reactor_writes);
+DECLARE_int32(rpc_max_iov_per_write);
+DECLARE_int64(rpc_max_bytes_per_write);
+
 DEFINE_int32(rpc_test_connection_keepalive_num_iterations, 1,
   "Number of iterations in TestRpc.TestConnectionKeepalive");
 
@@ -336,6 +340,24 @@ TEST_F(TestRpc, TestRpcSidecar) {
   DoTestSidecar(p, sizes, Status::kRemoteError);
 }
 
+// Test that writes are correct when outbound data is split between several syscalls because of
+// write limits, and when writes are corked.
+TEST_F(TestRpc, TestWriteLimits) {
+  FLAGS_rpc_cork_reactor_writes = true;
+  FLAGS_rpc_max_iov_per_write = 3;
+  FLAGS_rpc_max_bytes_per_write = 1024;
+
+  Endpoint server_addr;
+  StartTestServer(&server_addr);
+
+  shared_ptr<Messenger> client_messenger(CreateMessenger("Client"));
+  Proxy p(client_messenger, server_addr, GenericCalculatorService::static_service_name());
+
+  DoTestSidecar(p, {123, 456});
+  DoTestSidecar(p, {3000, 20, 2000 * 1024, 1});
+  ASSERT_OK(DoTestSyncCall(p, GenericCalculatorService::AddMethod()));
+}
+
 // Test that timeouts are properly handled.
 TEST_F(TestRpc, TestCallTimeout) {
   Endpoint server_addr;
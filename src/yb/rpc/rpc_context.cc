@@ -103,6 +103,7 @@ RpcContext::RpcContext(std::shared_ptr<YBInboundCall> call,
                        RpcMethodMetrics metrics)
     : call_(std::move(call)),
       request_pb_(request_pb),
+      movable_request_pb_(request_pb.get()),
       response_pb_(std::move(response_pb)),
       metrics_(metrics) {
   const Status s = call_->ParseParam(request_pb.get());
@@ -127,7 +128,9 @@ RpcContext::RpcContext(std::shared_ptr<LocalYBInboundCall> call,
 }
 
 void RpcContext::RespondSuccess() {
-  if (response_pb_->ByteSize() > FLAGS_rpc_max_message_size) {
+  // Responses to local calls are passed to the caller as is, so their size is not limited and is
+  // not computed.
+  if (!call_->IsLocalCall() && response_pb_->ByteSize() > FLAGS_rpc_max_message_size) {
     RespondFailure(STATUS(InvalidArgument, "RPC message too long"));
     return;
   }
@@ -171,6 +174,10 @@ Status RpcContext::AddRpcSidecar(RefCntBuffer car, int* idx) {
   return call_->AddRpcSidecar(car, idx);
 }
 
+Status RpcContext::AddRpcFileSidecar(FileSidecarPtr file, int* idx) {
+  return call_->AddRpcFileSidecar(std::move(file), idx);
+}
+
 void RpcContext::ResetRpcSidecars() {
   call_->ResetRpcSidecars();
 }
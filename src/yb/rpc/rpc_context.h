@@ -35,6 +35,7 @@
 #include <string>
 
 #include "yb/gutil/gscoped_ptr.h"
+#include "yb/rpc/file_sidecar.h"
 #include "yb/rpc/local_call.h"
 #include "yb/rpc/rpc_header.pb.h"
 #include "yb/rpc/service_if.h"
@@ -81,6 +82,7 @@ class RpcContext {
   RpcContext(RpcContext&& rhs)
       : call_(std::move(rhs.call_)),
         request_pb_(std::move(rhs.request_pb_)),
+        movable_request_pb_(rhs.movable_request_pb_),
         response_pb_(std::move(rhs.response_pb_)),
         metrics_(std::move(rhs.metrics_)),
         responded_(rhs.responded_) {
@@ -173,6 +175,11 @@ class RpcContext {
   // by the RPC response.
   CHECKED_STATUS AddRpcSidecar(RefCntBuffer car, int* idx);
 
+  // Adds a range of a file to the response as a sidecar. The range is sent straight from the page
+  // cache to the socket, so it is never copied into memory of this process. File sidecars should
+  // be added after all buffer sidecars, their indexes follow indexes of buffer sidecars.
+  CHECKED_STATUS AddRpcFileSidecar(FileSidecarPtr file, int* idx);
+
   // Removes all RpcSidecars.
   void ResetRpcSidecars();
 
@@ -186,6 +193,11 @@ class RpcContext {
   std::string requestor_string() const;
 
   const google::protobuf::Message *request_pb() const { return request_pb_.get(); }
+
+  // Returns the request parsed from the network, that is owned by this context, so the handler
+  // could move its contents instead of copying them. Returns nullptr for local calls, whose
+  // requests are owned by the caller and could be sent again on retry.
+  google::protobuf::Message *movable_request_pb() const { return movable_request_pb_; }
   google::protobuf::Message *response_pb() const { return response_pb_.get(); }
 
   // Return an upper bound on the client timeout deadline. This does not
@@ -209,6 +221,7 @@ class RpcContext {
  private:
   std::shared_ptr<YBInboundCall> call_;
   std::shared_ptr<const google::protobuf::Message> request_pb_;
+  google::protobuf::Message* movable_request_pb_ = nullptr;
   std::shared_ptr<google::protobuf::Message> response_pb_;
   RpcMethodMetrics metrics_;
   bool responded_ = false;
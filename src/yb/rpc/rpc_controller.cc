@@ -69,6 +69,7 @@ void RpcController::Swap(RpcController* other) {
   std::swap(timeout_, other->timeout_);
   std::swap(allow_local_calls_in_curr_thread_, other->allow_local_calls_in_curr_thread_);
   std::swap(call_, other->call_);
+  serialized_request_fields_.swap(other->serialized_request_fields_);
 }
 
 void RpcController::Reset() {
@@ -77,6 +78,12 @@ void RpcController::Reset() {
     CHECK(finished());
   }
   call_.reset();
+  serialized_request_fields_.clear();
+}
+
+void RpcController::AddSerializedRequestFields(RefCntBuffer fields) {
+  DCHECK(!call_) << "Fields should be added before the call is started";
+  serialized_request_fields_.push_back(std::move(fields));
 }
 
 bool RpcController::finished() const {
@@ -33,6 +33,7 @@
 #define YB_RPC_RPC_CONTROLLER_H
 
 #include <memory>
+#include <vector>
 
 #include <glog/logging.h>
 
@@ -40,6 +41,7 @@
 #include "yb/rpc/rpc_fwd.h"
 #include "yb/util/locks.h"
 #include "yb/util/monotime.h"
+#include "yb/util/ref_cnt_buffer.h"
 #include "yb/util/status.h"
 
 namespace yb {
@@ -136,6 +138,17 @@ class RpcController {
   // May fail if index is invalid.
   CHECKED_STATUS GetSidecar(int idx, Slice* sidecar) const;
 
+  // Adds wire-format protobuf fields, that are sent right after the serialized request of the
+  // next call. The receiver parses them as a part of the request message, so the same serialized
+  // data could be sent to multiple destinations without serializing it for each of them.
+  //
+  // Should be called after Reset(), since Reset() clears the added fields.
+  void AddSerializedRequestFields(RefCntBuffer fields);
+
+  const std::vector<RefCntBuffer>& serialized_request_fields() const {
+    return serialized_request_fields_;
+  }
+
  private:
   friend class OutboundCall;
   friend class Proxy;
@@ -148,6 +161,8 @@ class RpcController {
   OutboundCallPtr call_;
   bool allow_local_calls_in_curr_thread_ = false;
 
+  std::vector<RefCntBuffer> serialized_request_fields_;
+
   DISALLOW_COPY_AND_ASSIGN(RpcController);
 };
 
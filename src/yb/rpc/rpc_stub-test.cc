@@ -55,6 +55,7 @@
 DEFINE_bool(is_panic_test_child, false, "Used by TestRpcPanic");
 DECLARE_bool(socket_inject_short_recvs);
 DECLARE_int32(rpc_slow_query_threshold_ms);
+DECLARE_int32(rpc_slow_call_timeline_threshold_ms);
 
 using namespace std::chrono_literals;
 
@@ -135,6 +136,27 @@ TEST_F(RpcStubTest, TestSimpleCall) {
   SendSimpleCall();
 }
 
+// Test that pre-serialized request fields are parsed by the server as a part of the request.
+TEST_F(RpcStubTest, TestSerializedRequestFields) {
+  CalculatorServiceProxy p(client_messenger_, server_endpoint_);
+
+  AddRequestPB fields;
+  fields.set_y(20);
+  RefCntBuffer serialized_fields(fields.SerializePartialAsString());
+
+  for (int i = 0; i != 2; ++i) {
+    RpcController controller;
+    controller.AddSerializedRequestFields(serialized_fields);
+    AddRequestPB req;
+    req.set_x(10 + i);
+    // Overridden by the serialized field, since the last value wins for non repeated fields.
+    req.set_y(0);
+    AddResponsePB resp;
+    ASSERT_OK(p.Add(req, &resp, &controller));
+    ASSERT_EQ(30 + i, resp.result());
+  }
+}
+
 // Regression test for a bug in which we would not properly parse a call
 // response when recv() returned a 'short read'. This injects such short
 // reads and then makes a number of calls.
@@ -500,6 +522,41 @@ TEST_F(RpcStubTest, TestDumpCallsInFlight) {
   latch.Wait();
 }
 
+TEST_F(RpcStubTest, TestDumpSlowCalls) {
+  FLAGS_rpc_slow_call_timeline_threshold_ms = 50;
+  CalculatorServiceProxy p(client_messenger_, server_endpoint_);
+
+  SleepRequestPB req;
+  SleepResponsePB resp;
+  RpcController controller;
+  req.set_sleep_micros(100 * 1000); // 100ms
+  ASSERT_OK(p.Sleep(req, &resp, &controller));
+
+  // Timeline is collected before the response is queued, so it is available right away.
+  DumpRunningRpcsRequestPB dump_req;
+  DumpRunningRpcsResponsePB dump_resp;
+  dump_req.set_include_slow_calls(true);
+  ASSERT_OK(server_messenger().DumpRunningRpcs(dump_req, &dump_resp));
+  LOG(INFO) << "server messenger: " << dump_resp.DebugString();
+  ASSERT_EQ(1, dump_resp.slow_calls_size());
+  const auto& slow_call = dump_resp.slow_calls(0);
+  ASSERT_EQ("Sleep", slow_call.method_name());
+  ASSERT_GE(slow_call.total_micros(), 100 * 1000);
+  ASSERT_EQ(3, slow_call.phases_size());
+  ASSERT_EQ(ToString(RequestPhase::kReceived), slow_call.phases(0).phase());
+  ASSERT_EQ(ToString(RequestPhase::kHandlingStarted), slow_call.phases(1).phase());
+  ASSERT_EQ(ToString(RequestPhase::kResponded), slow_call.phases(2).phase());
+  ASSERT_EQ(slow_call.total_micros(), slow_call.phases(2).micros_since_received());
+
+  // Fast calls are not kept.
+  req.set_sleep_micros(0);
+  controller.Reset();
+  ASSERT_OK(p.Sleep(req, &resp, &controller));
+  dump_resp.Clear();
+  ASSERT_OK(server_messenger().DumpRunningRpcs(dump_req, &dump_resp));
+  ASSERT_EQ(1, dump_resp.slow_calls_size());
+}
+
 namespace {
 struct RefCountedTest : public RefCountedThreadSafe<RefCountedTest> {
 };
@@ -15,30 +15,36 @@
 
 #include "yb/rpc/scheduler.h"
 
+#include <unordered_map>
+
 #include <boost/asio/steady_timer.hpp>
 #include <boost/asio/strand.hpp>
 
-#include <boost/multi_index_container.hpp>
-#include <boost/multi_index/hashed_index.hpp>
-#include <boost/multi_index/mem_fun.hpp>
-#include <boost/multi_index/ordered_index.hpp>
-
 #include <glog/logging.h>
 
+#include "yb/rpc/timer_wheel.h"
+
 #include "yb/util/status.h"
 
 using namespace std::placeholders;
-using boost::multi_index::const_mem_fun;
-using boost::multi_index::hashed_unique;
-using boost::multi_index::ordered_non_unique;
+using namespace std::literals;
 
 namespace yb {
 namespace rpc {
 
+namespace {
+
+// Granularity of scheduled task times. Task is never run earlier than scheduled, but could be
+// run up to one tick later.
+constexpr auto kTickDuration = 1ms;
+
+} // namespace
+
 class Scheduler::Impl {
  public:
   explicit Impl(IoService* io_service)
-      : io_service_(*io_service), strand_(*io_service), timer_(*io_service) {}
+      : io_service_(*io_service), strand_(*io_service), timer_(*io_service),
+        start_time_(std::chrono::steady_clock::now()) {}
 
   ~Impl() {
     Shutdown();
@@ -47,11 +53,13 @@ class Scheduler::Impl {
 
   void Abort(ScheduledTaskId task_id) {
     strand_.dispatch([this, task_id] {
-      auto& index = tasks_.get<IdTag>();
-      auto it = index.find(task_id);
-      if (it != index.end()) {
-        io_service_.post([task = *it] { task->Run(STATUS(Aborted, "Task aborted")); });
-        index.erase(it);
+      auto it = tasks_.find(task_id);
+      if (it != tasks_.end()) {
+        wheel_.Erase(&it->second);
+        io_service_.post([task = std::move(it->second.task)] {
+          task->Run(STATUS(Aborted, "Task aborted"));
+        });
+        tasks_.erase(it);
       }
     });
   }
@@ -67,8 +75,11 @@ class Scheduler::Impl {
         auto status = STATUS(ServiceUnavailable, "Scheduler is shutting down", "", ESHUTDOWN);
         // Abort all scheduled tasks. It is ok to run task earlier than it was scheduled because
         // we pass error status to it.
-        for (auto task : tasks_) {
-          io_service_.post([task, status] { task->Run(status); });
+        for (auto& id_and_entry : tasks_) {
+          wheel_.Erase(&id_and_entry.second);
+          io_service_.post([task = std::move(id_and_entry.second.task), status] {
+            task->Run(status);
+          });
         }
         tasks_.clear();
       });
@@ -84,10 +95,15 @@ class Scheduler::Impl {
         return;
       }
 
-      auto pair = tasks_.insert(task);
+      auto tick = TimeToTick(task->time());
+      auto id = task->id();
+      auto pair = tasks_.emplace(std::piecewise_construct,
+                                 std::forward_as_tuple(id),
+                                 std::forward_as_tuple(std::move(task)));
       CHECK(pair.second);
-      if (pair.first == tasks_.begin()) {
-        StartTimer();
+      wheel_.Insert(&pair.first->second, tick);
+      if (tick < timer_tick_) {
+        StartTimer(tick);
       }
     });
   }
@@ -97,12 +113,30 @@ class Scheduler::Impl {
   }
 
  private:
-  void StartTimer() {
+  struct TaskEntry : public TimerWheelEntry {
+    explicit TaskEntry(std::shared_ptr<ScheduledTaskBase> task_) : task(std::move(task_)) {}
+
+    std::shared_ptr<ScheduledTaskBase> task;
+  };
+
+  // Returns the first tick that starts not earlier than the specified time.
+  uint64_t TimeToTick(SteadyTimePoint time) const {
+    if (time <= start_time_) {
+      return 0;
+    }
+    return (time - start_time_ + kTickDuration - 1ns) / kTickDuration;
+  }
+
+  SteadyTimePoint TickToTime(uint64_t tick) const {
+    return start_time_ + tick * kTickDuration;
+  }
+
+  void StartTimer(uint64_t tick) {
     DCHECK(strand_.running_in_this_thread());
-    DCHECK(!tasks_.empty());
 
+    timer_tick_ = tick;
     boost::system::error_code ec;
-    timer_.expires_at((*tasks_.begin())->time(), ec);
+    timer_.expires_at(TickToTime(tick), ec);
     LOG_IF(ERROR, ec) << "Reschedule timer failed: " << ec.message();
     timer_.async_wait(strand_.wrap(std::bind(&Impl::HandleTimer, this, _1)));
   }
@@ -118,38 +152,37 @@ class Scheduler::Impl {
       return;
     }
 
+    timer_tick_ = TimerWheel::kNever;
     auto now = std::chrono::steady_clock::now();
-    while (!tasks_.empty() && (*tasks_.begin())->time() <= now) {
-      io_service_.post([task = *tasks_.begin()] { task->Run(Status::OK()); });
-      tasks_.erase(tasks_.begin());
+    // Timer could fire a bit earlier than requested, so we process only completely passed ticks.
+    auto now_tick = now < start_time_ ? 0 : (now - start_time_) / kTickDuration;
+    while (auto* entry = wheel_.PopExpired(now_tick)) {
+      auto it = tasks_.find(static_cast<TaskEntry*>(entry)->task->id());
+      DCHECK(it != tasks_.end());
+      io_service_.post([task = std::move(it->second.task)] { task->Run(Status::OK()); });
+      tasks_.erase(it);
     }
 
-    if (!tasks_.empty()) {
-      StartTimer();
+    auto next_tick = wheel_.NextEventTick();
+    if (next_tick != TimerWheel::kNever) {
+      StartTimer(next_tick);
     }
   }
 
-  class IdTag;
-
-  typedef boost::multi_index_container<
-      std::shared_ptr<ScheduledTaskBase>,
-      boost::multi_index::indexed_by<
-          ordered_non_unique<
-              const_mem_fun<ScheduledTaskBase, SteadyTimePoint, &ScheduledTaskBase::time>
-          >,
-          hashed_unique<
-              boost::multi_index::tag<IdTag>,
-              const_mem_fun<ScheduledTaskBase, ScheduledTaskId, &ScheduledTaskBase::id>
-          >
-      >
-  > Tasks;
+  typedef std::unordered_map<ScheduledTaskId, TaskEntry> Tasks;
 
   IoService& io_service_;
   std::atomic<ScheduledTaskId> id_ = {0};
+  // Tasks are linked into wheel_, so unordered_map is used, because it does not move its
+  // elements.
   Tasks tasks_;
-  // Strand that protects tasks_ and timer_ fields.
+  TimerWheel wheel_;
+  // Tick that timer_ is waiting for, kNever when timer is not started.
+  uint64_t timer_tick_ = TimerWheel::kNever;
+  // Strand that protects tasks_, wheel_ and timer_ fields.
   boost::asio::io_service::strand strand_;
   boost::asio::steady_timer timer_;
+  const SteadyTimePoint start_time_;
   std::atomic<bool> closing_ = {false};
 };
 
@@ -172,6 +172,7 @@ class ServicePoolImpl {
   void Handle(InboundCallPtr incoming) {
     incoming->RecordHandlingStarted(incoming_queue_time_);
     ADOPT_TRACE(incoming->trace());
+    ADOPT_REQUEST_TIMELINE(incoming->timeline());
 
     if (PREDICT_FALSE(incoming->ClientTimedOut())) {
       TRACE_TO(incoming->trace(), "Skipping call since client already timed out");
@@ -23,6 +23,9 @@
 #include "yb/util/test_util.h"
 #include "yb/util/countdown_latch.h"
 
+METRIC_DECLARE_entity(server);
+METRIC_DECLARE_counter(rpc_thread_pool_steals);
+
 namespace yb {
 namespace rpc {
 
@@ -178,6 +181,68 @@ TEST_F(ThreadPoolTest, TestQueueOverflow) {
   }
 }
 
+TEST_F(ThreadPoolTest, TestWorkStealing) {
+  constexpr size_t kTotalTasks = 10000;
+  constexpr size_t kTotalWorkers = 4;
+  constexpr size_t kProducers = 4;
+  MetricRegistry metric_registry;
+  auto metric_entity = METRIC_ENTITY_server.Instantiate(&metric_registry, "test");
+  ThreadPool pool("test", kTotalTasks, kTotalWorkers, true /* work_stealing */, metric_entity);
+
+  CountDownLatch latch(kTotalTasks);
+  std::vector<TestTask> tasks(kTotalTasks);
+  std::vector<std::thread> threads;
+  size_t begin = 0;
+  for (size_t i = 0; i != kProducers; ++i) {
+    size_t end = kTotalTasks * (i + 1) / kProducers;
+    threads.emplace_back([&pool, &latch, &tasks, begin, end] {
+      for (size_t i = begin; i != end; ++i) {
+        tasks[i].SetLatch(&latch);
+        ASSERT_TRUE(pool.Enqueue(&tasks[i]));
+      }
+    });
+    begin = end;
+  }
+  latch.Wait();
+  for (auto& task : tasks) {
+    ASSERT_TRUE(task.IsCompleted());
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  LOG(INFO) << "Steals: " << METRIC_rpc_thread_pool_steals.Instantiate(metric_entity)->value();
+}
+
+TEST_F(ThreadPoolTest, TestWorkStealingShutdown) {
+  constexpr size_t kTotalTasks = 10000;
+  constexpr size_t kTotalWorkers = 4;
+  constexpr size_t kProducers = 4;
+  ThreadPool pool("test", kTotalTasks, kTotalWorkers, true /* work_stealing */);
+
+  CountDownLatch latch(kTotalTasks);
+  std::vector<TestTask> tasks(kTotalTasks);
+  std::vector<std::thread> threads;
+  size_t begin = 0;
+  for (size_t i = 0; i != kProducers; ++i) {
+    size_t end = kTotalTasks * (i + 1) / kProducers;
+    threads.emplace_back([&pool, &latch, &tasks, begin, end] {
+      for (size_t i = begin; i != end; ++i) {
+        tasks[i].SetLatch(&latch);
+        pool.Enqueue(&tasks[i]);
+      }
+    });
+    begin = end;
+  }
+  pool.Shutdown();
+  latch.Wait();
+  for (auto& task : tasks) {
+    ASSERT_TRUE(task.IsDone());
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
 TEST_F(ThreadPoolTest, TestShutdown) {
   constexpr size_t kTotalTasks = 10000;
   constexpr size_t kTotalWorkers = 4;
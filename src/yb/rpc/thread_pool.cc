@@ -16,14 +16,31 @@
 #include "yb/rpc/thread_pool.h"
 
 #include <condition_variable>
+#include <deque>
 #include <mutex>
+#include <random>
 #include <thread>
 
 #include <boost/lockfree/queue.hpp>
 #include <boost/scope_exit.hpp>
 
+#include "yb/util/locks.h"
+#include "yb/util/numa.h"
 #include "yb/util/thread.h"
 
+METRIC_DEFINE_counter(server, rpc_thread_pool_steals,
+                      "RPC Thread Pool Steals",
+                      yb::MetricUnit::kTasks,
+                      "Number of tasks that RPC thread pool workers took from queues of other "
+                      "workers.");
+
+METRIC_DEFINE_histogram(server, rpc_thread_pool_worker_queue_depth,
+                        "RPC Thread Pool Worker Queue Depth",
+                        yb::MetricUnit::kTasks,
+                        "Number of tasks in the queue of RPC thread pool worker, sampled when "
+                        "a task is added to it.",
+                        100000, 2);
+
 namespace yb {
 namespace rpc {
 
@@ -39,13 +56,36 @@ struct ThreadPoolShare {
   TaskQueue task_queue;
   WaitingWorkers waiting_workers;
 
+  // Fields below are used only in work stealing mode.
+  // Workers that own local queues, indexed by worker index, null for not yet created workers.
+  std::unique_ptr<std::atomic<Worker*>[]> workers;
+  std::atomic<size_t> next_worker{0};
+  // Number of tasks in shared and local queues, limited by queue_limit.
+  std::atomic<size_t> queued_tasks{0};
+  scoped_refptr<Counter> steals;
+  scoped_refptr<Histogram> worker_queue_depth;
+
   explicit ThreadPoolShare(ThreadPoolOptions o)
       : options(std::move(o)),
         task_queue(options.queue_limit),
         waiting_workers(options.max_workers) {
+    if (options.work_stealing) {
+      workers.reset(new std::atomic<Worker*>[options.max_workers]);
+      for (size_t i = 0; i != options.max_workers; ++i) {
+        workers[i].store(nullptr, std::memory_order_relaxed);
+      }
+      if (options.metric_entity) {
+        steals = METRIC_rpc_thread_pool_steals.Instantiate(options.metric_entity);
+        worker_queue_depth =
+            METRIC_rpc_thread_pool_worker_queue_depth.Instantiate(options.metric_entity);
+      }
+    }
   }
 };
 
+// Worker that runs in the current thread, null if current thread is not a rpc thread pool worker.
+thread_local Worker* current_worker = nullptr;
+
 namespace {
 const std::string kRpcThreadCategory = "rpc_thread_pool";
 } // namespace
@@ -53,13 +93,37 @@ const std::string kRpcThreadCategory = "rpc_thread_pool";
 class Worker {
  public:
   explicit Worker(ThreadPoolShare* share, size_t index)
-      : share_(share) {
+      : share_(share), index_(index), rng_(index) {
     auto name = strings::Substitute("rpc_tp_$0_$1", share_->options.name, index);
     CHECK_OK(yb::Thread::Create(kRpcThreadCategory, name, &Worker::Execute, this, &thread_));
   }
 
   ~Worker() {
-    thread_->Join();
+    Join();
+  }
+
+  void Join() {
+    if (thread_) {
+      thread_->Join();
+      thread_ = nullptr;
+    }
+  }
+
+  ThreadPoolShare* share() const {
+    return share_;
+  }
+
+  // Adds task to the local queue of this worker, used in work stealing mode.
+  void PushLocal(ThreadPoolTask* task) {
+    size_t depth;
+    {
+      std::lock_guard<simple_spinlock> lock(local_lock_);
+      local_tasks_.push_back(task);
+      depth = local_tasks_.size();
+    }
+    if (share_->worker_queue_depth) {
+      share_->worker_queue_depth->Increment(depth);
+    }
   }
 
   Worker(const Worker& worker) = delete;
@@ -92,6 +156,8 @@ class Worker {
   // Meaning that we does not have work (task queue empty) or
   // does not have free hands (worker queue empty)
   void Execute() {
+    current_worker = this;
+    MaybeBindCurrentThreadToNumaNode(index_);
     while (!stop_requested_) {
       ThreadPoolTask* task = nullptr;
       if (PopTask(&task)) {
@@ -99,12 +165,56 @@ class Worker {
         task->Done(Status::OK());
       }
     }
+    if (share_->options.work_stealing) {
+      // Move the rest of local tasks to the shared queue, so they are aborted during shutdown.
+      ThreadPoolTask* task = nullptr;
+      while (PopLocal(&task)) {
+        share_->task_queue.push(task);
+      }
+    }
+  }
+
+  bool PopLocal(ThreadPoolTask** task) {
+    std::lock_guard<simple_spinlock> lock(local_lock_);
+    if (local_tasks_.empty()) {
+      return false;
+    }
+    *task = local_tasks_.front();
+    local_tasks_.pop_front();
+    return true;
+  }
+
+  // Takes task from the local queue of randomly chosen other worker.
+  bool Steal(ThreadPoolTask** task) {
+    const size_t max_workers = share_->options.max_workers;
+    const size_t start = std::uniform_int_distribution<size_t>(0, max_workers - 1)(rng_);
+    for (size_t i = 0; i != max_workers; ++i) {
+      auto* victim = share_->workers[(start + i) % max_workers].load(std::memory_order_acquire);
+      if (victim != nullptr && victim != this && victim->PopLocal(task)) {
+        if (share_->steals) {
+          share_->steals->Increment();
+        }
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool TryGetTask(ThreadPoolTask** task) {
+    if (!share_->options.work_stealing) {
+      return share_->task_queue.pop(*task);
+    }
+    if (PopLocal(task) || share_->task_queue.pop(*task) || Steal(task)) {
+      share_->queued_tasks.fetch_sub(1, std::memory_order_acq_rel);
+      return true;
+    }
+    return false;
   }
 
   bool PopTask(ThreadPoolTask** task) {
     // First of all we try to get already queued task, w/o locking.
     // If there is no task, so we could go to waiting state.
-    if (share_->task_queue.pop(*task)) {
+    if (TryGetTask(task)) {
       return true;
     }
     std::unique_lock<std::mutex> lock(mutex_);
@@ -120,7 +230,7 @@ class Worker {
       // the worker queue. So worker queue could be empty in this case, and nobody was notified
       // about new task. So we check there for this case. This technique is similar to
       // double check.
-      if (share_->task_queue.pop(*task)) {
+      if (TryGetTask(task)) {
         return true;
       }
 
@@ -128,7 +238,7 @@ class Worker {
 
       // Sometimes another worker could steal task before we wake up. In this case we will
       // just enqueue ourselves back.
-      if (share_->task_queue.pop(*task)) {
+      if (TryGetTask(task)) {
         return true;
       }
     }
@@ -144,7 +254,11 @@ class Worker {
   }
 
   ThreadPoolShare* share_;
+  const size_t index_;
+  std::minstd_rand rng_;
   scoped_refptr<yb::Thread> thread_;
+  simple_spinlock local_lock_;
+  std::deque<ThreadPoolTask*> local_tasks_;
   std::mutex mutex_;
   std::condition_variable cond_;
   std::atomic<bool> stop_requested_ = {false};
@@ -178,7 +292,8 @@ class ThreadPool::Impl {
       task->Done(shutdown_status_);
       return false;
     }
-    bool added = share_.task_queue.bounded_push(task);
+    bool added = share_.options.work_stealing ? PushToWorker(task)
+                                              : share_.task_queue.bounded_push(task);
     --adding_;
     if (!added) {
       task->Done(queue_full_status_);
@@ -199,6 +314,9 @@ class ThreadPool::Impl {
       std::lock_guard<std::mutex> lock(mutex_);
       if (!closing_) {
         workers_[index].reset(new Worker(&share_, index));
+        if (share_.options.work_stealing) {
+          share_.workers[index].store(workers_[index].get(), std::memory_order_release);
+        }
       }
     } else {
       --created_workers_;
@@ -218,18 +336,31 @@ class ThreadPool::Impl {
       }
       closing_ = true;
     }
-    for (auto& worker : workers_) {
-      if (worker) {
-        worker->Stop();
-      }
-    }
-    workers_.clear();
     // Shutdown is quite rare situation otherwise enqueue is quite frequent.
     // Because of this we use "atomic lock" in enqueue and busy wait in shutdown.
     // So we could process enqueue quickly, and stuck in shutdown for sometime.
+    // Wait for it before stopping workers, so no task is added to the local queue of
+    // stopped worker.
     while(adding_ != 0) {
       std::this_thread::sleep_for(std::chrono::milliseconds(10));
     }
+    for (auto& worker : workers_) {
+      if (worker) {
+        worker->Stop();
+      }
+    }
+    // Workers could steal from each other, so all of them should be stopped before destroying.
+    for (auto& worker : workers_) {
+      if (worker) {
+        worker->Join();
+      }
+    }
+    if (share_.options.work_stealing) {
+      for (size_t i = 0; i != share_.options.max_workers; ++i) {
+        share_.workers[i].store(nullptr, std::memory_order_release);
+      }
+    }
+    workers_.clear();
     ThreadPoolTask* task = nullptr;
     while (share_.task_queue.pop(task)) {
       task->Done(shutdown_status_);
@@ -237,6 +368,28 @@ class ThreadPool::Impl {
   }
 
  private:
+  // Puts task to the local queue of the current worker, when invoked from a worker of this pool.
+  // Otherwise distributes tasks between local queues of workers in round robin order.
+  bool PushToWorker(ThreadPoolTask* task) {
+    if (share_.queued_tasks.fetch_add(1, std::memory_order_acq_rel) >= share_.options.queue_limit) {
+      share_.queued_tasks.fetch_sub(1, std::memory_order_acq_rel);
+      return false;
+    }
+    Worker* worker = current_worker;
+    if (worker == nullptr || worker->share() != &share_) {
+      auto index = share_.next_worker.fetch_add(1, std::memory_order_relaxed) %
+                   share_.options.max_workers;
+      worker = share_.workers[index].load(std::memory_order_acquire);
+    }
+    if (worker != nullptr) {
+      worker->PushLocal(task);
+    } else {
+      // Worker is not created yet, so use shared queue, that is checked by all workers.
+      share_.task_queue.push(task);
+    }
+    return true;
+  }
+
   ThreadPoolShare share_;
   std::vector<std::unique_ptr<Worker>> workers_;
   std::atomic<size_t> created_workers_ = {0};
@@ -19,6 +19,8 @@
 #include <memory>
 #include <string>
 
+#include "yb/util/metrics.h"
+
 namespace yb {
 
 class Status;
@@ -40,6 +42,11 @@ struct ThreadPoolOptions {
   std::string name;
   size_t queue_limit;
   size_t max_workers;
+  // Each worker has own task queue, tasks are distributed between them and idle workers steal
+  // tasks from queues of others. So producers and workers do not contend on the single queue.
+  bool work_stealing = false;
+  // Used to export work stealing metrics, could be null.
+  scoped_refptr<MetricEntity> metric_entity;
 };
 
 class ThreadPool {
@@ -0,0 +1,157 @@
+//
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+//
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "yb/rpc/timer_wheel.h"
+
+#include "yb/util/random.h"
+#include "yb/util/stopwatch.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+namespace rpc {
+
+class TimerWheelTest : public YBTest {
+};
+
+struct TestEntry : public TimerWheelEntry {
+  bool expired = false;
+};
+
+TEST_F(TimerWheelTest, Simple) {
+  TimerWheel wheel;
+  ASSERT_EQ(TimerWheel::kNever, wheel.NextEventTick());
+
+  TestEntry near, far, erased;
+  wheel.Insert(&near, 10);
+  wheel.Insert(&far, 100000);
+  wheel.Insert(&erased, 20);
+  ASSERT_EQ(3, wheel.size());
+  ASSERT_EQ(10, wheel.NextEventTick());
+
+  ASSERT_EQ(nullptr, wheel.PopExpired(9));
+  ASSERT_EQ(&near, wheel.PopExpired(10));
+  ASSERT_EQ(nullptr, wheel.PopExpired(10));
+
+  wheel.Erase(&erased);
+  ASSERT_FALSE(erased.scheduled());
+  ASSERT_EQ(1, wheel.size());
+  ASSERT_EQ(nullptr, wheel.PopExpired(99999));
+  ASSERT_EQ(&far, wheel.PopExpired(1000000));
+  ASSERT_TRUE(wheel.empty());
+
+  // Entry that has already expired is returned by the next call.
+  wheel.Insert(&near, 5);
+  ASSERT_EQ(&near, wheel.PopExpired(wheel.current_tick()));
+}
+
+// Checks that entries are returned exactly when they expire, against a random workload with
+// inserts, erases and advances of various lengths.
+TEST_F(TimerWheelTest, Random) {
+  constexpr size_t kEntries = 10000;
+  constexpr int kIterations = 200000;
+
+  Random rng(SeedRandom());
+  const uint64_t start_tick = rng.Next64() >> 2;
+  TimerWheel wheel(start_tick);
+  std::vector<TestEntry> entries(kEntries);
+  uint64_t now = start_tick;
+  size_t scheduled = 0;
+  for (int i = 0; i != kIterations; ++i) {
+    auto& entry = entries[rng.Uniform(kEntries)];
+    switch (rng.Uniform(3)) {
+      case 0:
+        if (!entry.scheduled()) {
+          // Mix near and far timeouts.
+          uint64_t delay = rng.Next64() >> (2 + rng.Uniform(62));
+          wheel.Insert(&entry, now + 1 + delay);
+          entry.expired = false;
+          ++scheduled;
+        }
+        break;
+      case 1:
+        if (entry.scheduled()) {
+          wheel.Erase(&entry);
+          --scheduled;
+        }
+        break;
+      case 2: {
+        auto next_event = wheel.NextEventTick();
+        ASSERT_GE(next_event, wheel.current_tick());
+        now += rng.Next64() >> (40 + rng.Uniform(24));
+        while (auto* popped = wheel.PopExpired(now)) {
+          auto* test_entry = static_cast<TestEntry*>(popped);
+          ASSERT_FALSE(test_entry->expired);
+          ASSERT_LE(test_entry->expiration_tick(), now);
+          ASSERT_GE(test_entry->expiration_tick(), next_event);
+          test_entry->expired = true;
+          --scheduled;
+        }
+        break;
+      }
+    }
+    ASSERT_EQ(scheduled, wheel.size());
+  }
+
+  // All remaining entries should expire later than now.
+  for (auto& entry : entries) {
+    if (entry.scheduled()) {
+      ASSERT_GT(entry.expiration_tick(), now);
+    }
+  }
+
+  while (!wheel.empty()) {
+    auto next_event = wheel.NextEventTick();
+    auto* popped = wheel.PopExpired(next_event);
+    if (popped) {
+      ASSERT_EQ(next_event, popped->expiration_tick());
+    }
+  }
+}
+
+TEST_F(TimerWheelTest, Benchmark) {
+  constexpr size_t kEntries = 1000000;
+  constexpr uint64_t kMaxDelay = 60000;
+
+  Random rng(SeedRandom());
+  TimerWheel wheel;
+  std::vector<TestEntry> entries(kEntries);
+  Stopwatch sw;
+  sw.start();
+  for (auto& entry : entries) {
+    wheel.Insert(&entry, rng.Uniform64(kMaxDelay));
+  }
+  // Most entries are cancelled before they expire.
+  for (size_t i = 0; i != kEntries; ++i) {
+    if (i % 10 != 0) {
+      wheel.Erase(&entries[i]);
+    }
+  }
+  size_t expired = 0;
+  for (uint64_t tick = 0; tick != kMaxDelay; ++tick) {
+    while (wheel.PopExpired(tick)) {
+      ++expired;
+    }
+  }
+  sw.stop();
+  ASSERT_EQ(kEntries / 10, expired);
+  LOG(INFO) << "Processed " << kEntries << " entries in " << sw.elapsed().ToString();
+}
+
+} // namespace rpc
+} // namespace yb
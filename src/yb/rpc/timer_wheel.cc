@@ -0,0 +1,136 @@
+//
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+//
+
+#include "yb/rpc/timer_wheel.h"
+
+#include <algorithm>
+
+#include <glog/logging.h>
+
+#include "yb/gutil/bits.h"
+
+namespace yb {
+namespace rpc {
+
+constexpr uint64_t TimerWheel::kNever;
+
+TimerWheel::~TimerWheel() {
+  for (auto& level : levels_) {
+    for (auto& slot : level.slots) {
+      slot.clear();
+    }
+  }
+}
+
+void TimerWheel::Insert(TimerWheelEntry* entry, uint64_t expiration_tick) {
+  DCHECK(!entry->scheduled());
+  entry->expiration_tick_ = expiration_tick;
+  Place(entry);
+  ++size_;
+}
+
+void TimerWheel::Erase(TimerWheelEntry* entry) {
+  if (entry->scheduled()) {
+    entry->hook_.unlink();
+    --size_;
+  }
+}
+
+void TimerWheel::Place(TimerWheelEntry* entry) {
+  // Entry that already expired is placed to the current slot, so it is returned by the next
+  // PopExpired call.
+  const uint64_t tick = std::max(entry->expiration_tick_, current_tick_);
+  const uint64_t diff = tick ^ current_tick_;
+  // Level is determined by the highest bit that differs between expiration tick and current tick.
+  const size_t level = diff == 0 ? 0 : Bits::Log2FloorNonZero64(diff) / kSlotBits;
+  const size_t index = SlotIndex(level, tick);
+  levels_[level].slots[index].push_back(*entry);
+  levels_[level].non_empty |= 1ULL << index;
+}
+
+uint64_t TimerWheel::NextEventTick() {
+  if (size_ == 0) {
+    return kNever;
+  }
+  // Events of lower level always happen before events of upper level, so the first found event
+  // is the earliest one.
+  for (size_t level = 0; level != kNumLevels; ++level) {
+    auto& current_level = levels_[level];
+    const size_t shift = level * kSlotBits;
+    const size_t current_index = SlotIndex(level, current_tick_);
+    // Slot with current index at upper level is moved to lower levels as soon as we reach it.
+    // So only subsequent slots could contain entries.
+    const size_t first_index = level == 0 ? current_index : current_index + 1;
+    if (first_index == kNumSlots) {
+      continue;
+    }
+    uint64_t candidates = current_level.non_empty & (~0ULL << first_index);
+    while (candidates) {
+      const size_t index = Bits::FindLSBSetNonZero64(candidates);
+      const uint64_t bit = 1ULL << index;
+      if (current_level.slots[index].empty()) {
+        current_level.non_empty &= ~bit;
+        candidates &= ~bit;
+        continue;
+      }
+      const size_t upper_shift = shift + kSlotBits;
+      const uint64_t base = upper_shift >= 64 ? 0 : (current_tick_ >> upper_shift) << upper_shift;
+      return base | (static_cast<uint64_t>(index) << shift);
+    }
+  }
+  LOG(DFATAL) << "Non empty timer wheel without events, size: " << size_;
+  return kNever;
+}
+
+void TimerWheel::MoveTo(uint64_t new_tick) {
+  DCHECK_GE(new_tick, current_tick_);
+  current_tick_ = new_tick;
+  // Upper levels are processed first, since their entries could be moved to the slots of lower
+  // levels that start at the same tick.
+  for (size_t level = kNumLevels; --level > 0;) {
+    const uint64_t lower_ticks_mask = (1ULL << (level * kSlotBits)) - 1;
+    if (new_tick & lower_ticks_mask) {
+      continue;
+    }
+    auto& slot = levels_[level].slots[SlotIndex(level, new_tick)];
+    while (!slot.empty()) {
+      auto& entry = slot.front();
+      slot.pop_front();
+      Place(&entry);
+    }
+  }
+}
+
+TimerWheelEntry* TimerWheel::PopExpired(uint64_t now_tick) {
+  if (size_ == 0) {
+    current_tick_ = std::max(current_tick_, now_tick + 1);
+    return nullptr;
+  }
+  while (current_tick_ <= now_tick) {
+    auto& slot = levels_[0].slots[SlotIndex(0, current_tick_)];
+    if (!slot.empty()) {
+      auto& entry = slot.front();
+      slot.pop_front();
+      --size_;
+      return &entry;
+    }
+    // Nothing could happen between current tick and next event, so we could jump directly to it.
+    MoveTo(std::min(NextEventTick(), now_tick + 1));
+  }
+  return nullptr;
+}
+
+} // namespace rpc
+} // namespace yb
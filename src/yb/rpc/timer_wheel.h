@@ -0,0 +1,129 @@
+//
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+//
+
+#ifndef YB_RPC_TIMER_WHEEL_H
+#define YB_RPC_TIMER_WHEEL_H
+
+#include <stdint.h>
+
+#include <array>
+#include <limits>
+
+#include <boost/intrusive/list.hpp>
+
+#include "yb/gutil/macros.h"
+
+namespace yb {
+namespace rpc {
+
+typedef boost::intrusive::list_member_hook<
+    boost::intrusive::link_mode<boost::intrusive::auto_unlink>> TimerWheelHook;
+
+// Base class for entries stored in TimerWheel.
+class TimerWheelEntry {
+ public:
+  TimerWheelEntry() = default;
+  TimerWheelEntry(const TimerWheelEntry&) = delete;
+  void operator=(const TimerWheelEntry&) = delete;
+
+  uint64_t expiration_tick() const { return expiration_tick_; }
+
+  bool scheduled() const { return hook_.is_linked(); }
+
+ private:
+  friend class TimerWheel;
+
+  TimerWheelHook hook_;
+  uint64_t expiration_tick_ = 0;
+};
+
+// Hierarchical timing wheel, that is used to keep timeouts.
+// Time is measured in ticks, and the wheel consists of several levels. Each level has kNumSlots
+// slots, and one slot of level L covers kNumSlots^L ticks. Entry is placed to the lowest level
+// whose slot contains only entries that expire within the same range as this entry.
+// When wheel reaches a slot of upper level, entries of this slot are moved to lower levels.
+//
+// Insert and Erase take O(1), each entry is moved between levels at most kNumLevels times.
+//
+// This class is not thread safe.
+class TimerWheel {
+ public:
+  static constexpr uint64_t kNever = std::numeric_limits<uint64_t>::max();
+
+  // Creates wheel whose current tick is start_tick.
+  explicit TimerWheel(uint64_t start_tick = 0) : current_tick_(start_tick) {}
+  ~TimerWheel();
+
+  // Adds entry that expires at the specified tick. If this tick already passed, the entry would
+  // be returned by the next PopExpired call.
+  void Insert(TimerWheelEntry* entry, uint64_t expiration_tick);
+
+  // Removes entry from the wheel, does nothing if the entry is not scheduled.
+  void Erase(TimerWheelEntry* entry);
+
+  // Advances wheel to now_tick and returns an entry that expires not later than now_tick.
+  // Returns nullptr if there are no such entries.
+  TimerWheelEntry* PopExpired(uint64_t now_tick);
+
+  // Returns tick, at which the wheel should be advanced next, i.e. the earliest tick when an entry
+  // expires or entries of an upper level slot should be moved to lower levels.
+  // Returns kNever when the wheel is empty.
+  uint64_t NextEventTick();
+
+  uint64_t current_tick() const { return current_tick_; }
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+ private:
+  static constexpr size_t kSlotBits = 6;
+  static constexpr size_t kNumSlots = 1ULL << kSlotBits;
+  static constexpr uint64_t kSlotMask = kNumSlots - 1;
+  static constexpr size_t kNumLevels = (64 + kSlotBits - 1) / kSlotBits;
+
+  typedef boost::intrusive::list<
+      TimerWheelEntry,
+      boost::intrusive::member_hook<TimerWheelEntry, TimerWheelHook, &TimerWheelEntry::hook_>,
+      boost::intrusive::constant_time_size<false>> Slot;
+
+  struct Level {
+    // Bit is set when the appropriate slot could be non empty.
+    // Bits are cleared lazily, because erased entries are unlinked without knowing their slot.
+    uint64_t non_empty = 0;
+    std::array<Slot, kNumSlots> slots;
+  };
+
+  static size_t SlotIndex(size_t level, uint64_t tick) {
+    return (tick >> (level * kSlotBits)) & kSlotMask;
+  }
+
+  // Put entry to the appropriate slot, relative to the current tick.
+  void Place(TimerWheelEntry* entry);
+
+  // Sets current tick to the new value and moves entries of upper level slots, that start at
+  // this tick, to lower levels.
+  void MoveTo(uint64_t new_tick);
+
+  // All ticks before current_tick_ are already processed.
+  uint64_t current_tick_;
+  size_t size_ = 0;
+  std::array<Level, kNumLevels> levels_;
+
+  DISALLOW_COPY_AND_ASSIGN(TimerWheel);
+};
+
+} // namespace rpc
+} // namespace yb
+
+#endif // YB_RPC_TIMER_WHEEL_H
@@ -29,6 +29,7 @@
 #include "yb/util/size_literals.h"
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/memory/memory.h"
+#include "yb/util/object_pool.h"
 
 using google::protobuf::io::CodedInputStream;
 using yb::operator"" _MB;
@@ -174,7 +175,8 @@ Status YBConnectionContext::HandleInboundCall(const ConnectionPtr& connection, S
   auto reactor = connection->reactor();
   DCHECK(reactor->IsCurrentThread());
 
-  auto call = std::make_shared<YBInboundCall>(connection, call_processed_listener());
+  auto call = std::allocate_shared<YBInboundCall>(
+      PooledAllocator<YBInboundCall>(), connection, call_processed_listener());
 
   Status s = call->ParseFrom(call_data);
   if (!s.ok()) {
@@ -250,16 +252,29 @@ Status YBInboundCall::ParseFrom(Slice source) {
 Status YBInboundCall::AddRpcSidecar(RefCntBuffer car, int* idx) {
   // Check that the number of sidecars does not exceed the number of payload
   // slices that are free.
-  if (sidecars_.size() >= CallResponse::kMaxSidecarSlices) {
+  if (sidecars_.size() + file_sidecars_.size() >= CallResponse::kMaxSidecarSlices) {
     return STATUS(ServiceUnavailable, "All available sidecars already used");
   }
+  if (!file_sidecars_.empty()) {
+    return STATUS(IllegalState, "Buffer sidecars should be added before file sidecars");
+  }
   *idx = static_cast<int>(sidecars_.size());
   sidecars_.push_back(std::move(car));
   return Status::OK();
 }
 
+Status YBInboundCall::AddRpcFileSidecar(FileSidecarPtr file, int* idx) {
+  if (sidecars_.size() + file_sidecars_.size() >= CallResponse::kMaxSidecarSlices) {
+    return STATUS(ServiceUnavailable, "All available sidecars already used");
+  }
+  *idx = static_cast<int>(sidecars_.size() + file_sidecars_.size());
+  file_sidecars_.push_back(std::move(file));
+  return Status::OK();
+}
+
 void YBInboundCall::ResetRpcSidecars() {
   sidecars_.clear();
+  file_sidecars_.clear();
 }
 
 Status YBInboundCall::SerializeResponseBuffer(const google::protobuf::MessageLite& response,
@@ -277,6 +292,10 @@ Status YBInboundCall::SerializeResponseBuffer(const google::protobuf::MessageLit
     resp_hdr.add_sidecar_offsets(absolute_sidecar_offset);
     absolute_sidecar_offset += car.size();
   }
+  for (auto& file : file_sidecars_) {
+    resp_hdr.add_sidecar_offsets(absolute_sidecar_offset);
+    absolute_sidecar_offset += file->size();
+  }
 
   int additional_size = absolute_sidecar_offset - protobuf_msg_size;
 
@@ -361,6 +380,10 @@ void YBInboundCall::Serialize(std::deque<RefCntBuffer>* output) const {
   }
 }
 
+void YBInboundCall::SerializeFileSidecars(std::vector<FileSidecarPtr>* output) const {
+  output->insert(output->end(), file_sidecars_.begin(), file_sidecars_.end());
+}
+
 Status YBInboundCall::ParseParam(google::protobuf::Message *message) {
   Slice param(serialized_request());
   CodedInputStream in(param.data(), param.size());
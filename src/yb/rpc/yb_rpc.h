@@ -76,6 +76,9 @@ class YBInboundCall : public InboundCall {
   // See RpcContext::AddRpcSidecar()
   CHECKED_STATUS AddRpcSidecar(RefCntBuffer car, int* idx);
 
+  // See RpcContext::AddRpcFileSidecar()
+  virtual CHECKED_STATUS AddRpcFileSidecar(FileSidecarPtr file, int* idx);
+
   // See RpcContext::ResetRpcSidecars()
   void ResetRpcSidecars();
 
@@ -109,6 +112,8 @@ class YBInboundCall : public InboundCall {
   // The resulting slices refer to memory in this object.
   void Serialize(std::deque<RefCntBuffer>* output) const override;
 
+  void SerializeFileSidecars(std::vector<FileSidecarPtr>* output) const override;
+
   void LogTrace() const override;
   std::string ToString() const override;
   bool DumpPB(const DumpRunningRpcsRequestPB& req, RpcCallInProgressPB* resp) override;
@@ -132,6 +137,9 @@ class YBInboundCall : public InboundCall {
   // after serialization of the protobuf. See rpc/rpc_sidecar.h for more info.
   std::vector<RefCntBuffer> sidecars_;
 
+  // File sidecars, that follow sidecars_ in the response.
+  std::vector<FileSidecarPtr> file_sidecars_;
+
   // Serialize and queue the response.
   virtual void Respond(const google::protobuf::MessageLite& response, bool is_success);
 
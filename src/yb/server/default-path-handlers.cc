@@ -60,6 +60,7 @@
 
 #include "yb/gutil/map-util.h"
 #include "yb/gutil/strings/human_readable.h"
+#include "yb/gutil/strings/numbers.h"
 #include "yb/gutil/strings/split.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/server/pprof-path-handlers.h"
@@ -202,7 +203,7 @@ void AddDefaultPathHandlers(Webserver* webserver) {
 
 
 static void WriteMetricsAsJson(const MetricRegistry* const metrics,
-                               const Webserver::WebRequest& req, std::stringstream* output) {
+                               const Webserver::WebRequest& req, std::ostream* output) {
   const string* requested_metrics_param = FindOrNull(req.parsed_args, "metrics");
   vector<string> requested_metrics;
   MetricJsonOptions opts;
@@ -215,6 +216,20 @@ static void WriteMetricsAsJson(const MetricRegistry* const metrics,
     string arg = FindWithDefault(req.parsed_args, "include_schema", "false");
     opts.include_schema_info = ParseLeadingBoolValue(arg.c_str(), false);
   }
+  {
+    string arg = FindWithDefault(req.parsed_args, "level", "tablet");
+    if (arg == "table") {
+      opts.level = MetricAggregationLevel::kTable;
+    } else if (arg == "server") {
+      opts.level = MetricAggregationLevel::kServer;
+    }
+  }
+  {
+    string arg = FindWithDefault(req.parsed_args, "hot_tablets", "0");
+    if (!safe_strto32(arg.c_str(), &opts.max_hot_tablets)) {
+      opts.max_hot_tablets = 0;
+    }
+  }
   JsonWriter::Mode json_mode;
   {
     string arg = FindWithDefault(req.parsed_args, "compact", "false");
@@ -236,25 +251,32 @@ static void WriteMetricsAsJson(const MetricRegistry* const metrics,
 }
 
 static void WriteForPrometheus(const MetricRegistry* const metrics,
-                               const Webserver::WebRequest& req, std::stringstream* output) {
+                               const Webserver::WebRequest& req, std::ostream* output) {
+  vector<string> requested_metrics;
+  const string* requested_metrics_param = FindOrNull(req.parsed_args, "metrics");
+  if (requested_metrics_param != nullptr) {
+    SplitStringUsing(*requested_metrics_param, ",", &requested_metrics);
+  }
+
   PrometheusWriter writer(output);
-  WARN_NOT_OK(metrics->WriteForPrometheus(&writer), "Couldn't write text metrics for Prometheus");
+  WARN_NOT_OK(metrics->WriteForPrometheus(&writer, requested_metrics),
+              "Couldn't write text metrics for Prometheus");
 }
 
 void RegisterMetricsJsonHandler(Webserver* webserver, const MetricRegistry* const metrics) {
-  Webserver::PathHandlerCallback callback = std::bind(WriteMetricsAsJson, metrics, _1, _2);
-  Webserver::PathHandlerCallback prometheus_callback = std::bind(
+  // Metrics pages are big on servers with many tablets, so they are streamed to the client
+  // instead of being rendered into a buffer first.
+  Webserver::StreamingPathHandlerCallback callback = std::bind(
+      WriteMetricsAsJson, metrics, _1, _2);
+  Webserver::StreamingPathHandlerCallback prometheus_callback = std::bind(
       WriteForPrometheus, metrics, _1, _2);
-  bool not_styled = false;
-  bool not_on_nav_bar = false;
-  webserver->RegisterPathHandler("/metrics", "Metrics", callback, not_styled, not_on_nav_bar);
+  webserver->RegisterStreamingPathHandler("/metrics", "Metrics", callback);
 
   // The old name -- this is preserved for compatibility with older releases of
   // monitoring software which expects the old name.
-  webserver->RegisterPathHandler("/jsonmetricz", "Metrics", callback, not_styled, not_on_nav_bar);
+  webserver->RegisterStreamingPathHandler("/jsonmetricz", "Metrics", callback);
 
-  webserver->RegisterPathHandler(
-      "/prometheus-metrics", "Metrics", prometheus_callback, not_styled, not_on_nav_bar);
+  webserver->RegisterStreamingPathHandler("/prometheus-metrics", "Metrics", prometheus_callback);
 }
 
 } // namespace yb
@@ -34,6 +34,7 @@
 #include <glog/logging.h>
 #include <gtest/gtest.h>
 
+#include "yb/gutil/walltime.h"
 #include "yb/server/hybrid_clock.h"
 #include "yb/server/mock_hybrid_clock.h"
 #include "yb/util/monotime.h"
@@ -44,6 +45,8 @@
 DECLARE_bool(use_mock_wall_clock);
 DECLARE_uint64(max_clock_sync_error_usec);
 DECLARE_bool(disable_clock_sync_error);
+DECLARE_uint64(clock_error_refresh_interval_usec);
+DECLARE_string(time_source);
 
 namespace yb {
 namespace server {
@@ -322,6 +325,38 @@ TEST_F(HybridClockTest, TestCheckClockSyncError) {
   EXPECT_OK(HybridClock::CheckClockSyncError(std::numeric_limits<uint64_t>::min()));
 }
 
+class FixedErrorPhysicalClock : public PhysicalClock {
+ public:
+  static constexpr uint64_t kErrorUsec = 7;
+
+  Status Now(uint64_t* now_usec, uint64_t* error_usec) override {
+    *now_usec = GetCurrentTimeMicros();
+    *error_usec = kErrorUsec;
+    return Status::OK();
+  }
+};
+
+constexpr uint64_t FixedErrorPhysicalClock::kErrorUsec;
+
+TEST_F(HybridClockTest, TestPhysicalClock) {
+  RegisterPhysicalClock("fixed_error", [] {
+    return Result<std::unique_ptr<PhysicalClock>>(std::make_unique<FixedErrorPhysicalClock>());
+  });
+
+  FLAGS_time_source = "unknown";
+  scoped_refptr<HybridClock> unknown_clock(new HybridClock());
+  ASSERT_NOK(unknown_clock->Init());
+
+  FLAGS_time_source = "fixed_error";
+  scoped_refptr<HybridClock> clock(new HybridClock());
+  ASSERT_OK(clock->Init());
+  HybridTime now;
+  uint64_t error_usec = 0;
+  clock->NowWithError(&now, &error_usec);
+  ASSERT_EQ(FixedErrorPhysicalClock::kErrorUsec, error_usec);
+  ASSERT_GT(clock->Now(), now);
+}
+
 #if !defined(__APPLE__)
 TEST_F(HybridClockTest, TestNtpErrorsNotIgnored) {
   using ::testing::Return;
@@ -358,6 +393,41 @@ TEST_F(HybridClockTest, TestNtpErrorsIgnored) {
   timex timex;
   EXPECT_OK(mock_clock->GetClockModes(&timex));
 }
+
+class CountingHybridClock : public HybridClock {
+ public:
+  int NtpGettime(ntptimeval* timeval) override {
+    ++ntp_gettime_calls_;
+    return HybridClock::NtpGettime(timeval);
+  }
+
+  int ntp_gettime_calls() const { return ntp_gettime_calls_.load(); }
+
+ private:
+  std::atomic<int> ntp_gettime_calls_{0};
+};
+
+TEST_F(HybridClockTest, TestCachedClockError) {
+  FLAGS_clock_error_refresh_interval_usec = 60 * 1000 * 1000;
+  scoped_refptr<CountingHybridClock> clock(new CountingHybridClock());
+  ASSERT_OK(clock->Init());
+  ASSERT_EQ(1, clock->ntp_gettime_calls());
+
+  HybridTime prev = HybridTime::kMin;
+  for (int i = 0; i != 1000; ++i) {
+    HybridTime now;
+    uint64_t error_usec;
+    clock->NowWithError(&now, &error_usec);
+    ASSERT_GT(now, prev);
+    prev = now;
+  }
+  // All reads were served from the sample taken during Init().
+  ASSERT_EQ(1, clock->ntp_gettime_calls());
+
+  FLAGS_clock_error_refresh_interval_usec = 0;
+  ASSERT_GT(clock->Now(), prev);
+  ASSERT_EQ(2, clock->ntp_gettime_calls());
+}
 #endif // !defined(__APPLE__)
 
 }  // namespace server
@@ -56,6 +56,20 @@ TAG_FLAG(disable_clock_sync_error, advanced);
 TAG_FLAG(max_clock_sync_error_usec, advanced);
 TAG_FLAG(max_clock_sync_error_usec, runtime);
 
+DEFINE_uint64(clock_error_refresh_interval_usec, 0,
+              "If positive, the NTP clock error bound is sampled with ntp_gettime() at most once "
+              "per this many microseconds. In between, the wall clock is read with "
+              "clock_gettime(CLOCK_REALTIME) and the cached error bound is widened by the maximum "
+              "kernel clock drift since the sample. Zero reads the NTP state on every clock "
+              "read.");
+TAG_FLAG(clock_error_refresh_interval_usec, advanced);
+TAG_FLAG(clock_error_refresh_interval_usec, runtime);
+
+DEFINE_string(time_source, "",
+              "Physical clock used by HybridClock instead of NTP, e.g. 'ptp' to read a PTP hardware "
+              "clock. Empty means NTP.");
+TAG_FLAG(time_source, advanced);
+
 DEFINE_bool(use_hybrid_clock, true,
             "Whether HybridClock should be used as the default clock"
             " implementation. This should be disabled for testing purposes only.");
@@ -175,6 +189,16 @@ Status HybridClock::Init() {
     state_ = kInitialized;
     return Status::OK();
   }
+  if (!FLAGS_time_source.empty()) {
+    physical_clock_ = VERIFY_RESULT(CreatePhysicalClock(FLAGS_time_source));
+    uint64_t now_usec;
+    uint64_t error_usec;
+    RETURN_NOT_OK(WalltimeWithError(&now_usec, &error_usec));
+    LOG(INFO) << "HybridClock initialized with time source " << FLAGS_time_source
+              << ". Current error (microseconds): " << error_usec;
+    state_ = kInitialized;
+    return Status::OK();
+  }
 #if defined(__APPLE__)
   LOG(WARNING) << "HybridClock initialized in local mode (OS X only). "
                << "Not suitable for distributed clusters.";
@@ -410,6 +434,10 @@ yb::Status HybridClock::CheckClockSyncError(uint64_t error_usec) {
 }
 
 yb::Status HybridClock::WalltimeWithError(uint64_t* now_usec, uint64_t* error_usec) {
+  if (physical_clock_ && PREDICT_TRUE(!FLAGS_use_mock_wall_clock)) {
+    RETURN_NOT_OK(physical_clock_->Now(now_usec, error_usec));
+    return CheckClockSyncError(*error_usec);
+  }
   if (PREDICT_FALSE(FLAGS_use_mock_wall_clock)) {
     auto mock_clock_time_usec = mock_clock_time_usec_.load(std::memory_order_acquire);
     auto mock_clock_max_error_usec = mock_clock_max_error_usec_.load(std::memory_order_acquire);
@@ -425,11 +453,20 @@ yb::Status HybridClock::WalltimeWithError(uint64_t* now_usec, uint64_t* error_us
     *error_usec = 1000;
   }
 #else
+    const uint64_t refresh_interval_usec = FLAGS_clock_error_refresh_interval_usec;
+    if (refresh_interval_usec > 0 && state_ == kInitialized &&
+        CachedWalltimeWithError(refresh_interval_usec, now_usec, error_usec)) {
+      return CheckClockSyncError(*error_usec);
+    }
+
     // Read the time. This will return an error if the clock is not synchronized.
     ntptimeval timeval;
     RETURN_NOT_OK(GetClockTime(&timeval));
     *now_usec = timeval.time.tv_sec * kNanosPerSec + timeval.time.tv_usec / divisor_;
     *error_usec = timeval.maxerror;
+    if (refresh_interval_usec > 0) {
+      clock_error_sample_.store({*now_usec, *error_usec}, std::memory_order_release);
+    }
   }
 
   // If the clock is synchronized but has max_error beyond max_clock_sync_error_usec
@@ -439,6 +476,26 @@ yb::Status HybridClock::WalltimeWithError(uint64_t* now_usec, uint64_t* error_us
   return yb::Status::OK();
 }
 
+#if !defined(__APPLE__)
+bool HybridClock::CachedWalltimeWithError(
+    uint64_t refresh_interval_usec, uint64_t* now_usec, uint64_t* error_usec) {
+  const ClockErrorSample sample = clock_error_sample_.load(std::memory_order_acquire);
+  if (sample.time_usec == 0) {
+    return false;
+  }
+  const uint64_t now = GetCurrentTimeMicros();
+  // Fall back to ntp_gettime() when the sample is stale or the clock has been stepped back.
+  if (now < sample.time_usec || now - sample.time_usec >= refresh_interval_usec) {
+    return false;
+  }
+  *now_usec = now;
+  // The kernel grows the reported maximum error by MAXFREQ (500 ppm) of the elapsed time, so the
+  // sampled bound widened by that much still bounds the error of the current reading.
+  *error_usec = sample.error_usec + (now - sample.time_usec) / 2000 + 1;
+  return true;
+}
+#endif // !defined(__APPLE__)
+
 void HybridClock::SetMockClockWallTimeForTests(uint64_t now_usec) {
   CHECK(FLAGS_use_mock_wall_clock);
   CHECK_GE(now_usec, mock_clock_time_usec_);
@@ -34,6 +34,7 @@
 #define YB_SERVER_HYBRID_CLOCK_H_
 
 #include <atomic>
+#include <memory>
 #include <string>
 #if !defined(__APPLE__)
 #include <sys/timex.h>
@@ -41,6 +42,7 @@
 
 #include "yb/gutil/ref_counted.h"
 #include "yb/server/clock.h"
+#include "yb/server/physical_clock.h"
 #include "yb/util/locks.h"
 #include "yb/util/metrics.h"
 #include "yb/util/status.h"
@@ -203,6 +205,14 @@ class HybridClock : public Clock {
   // On OS X, the error will always be 0.
   CHECKED_STATUS WalltimeWithError(uint64_t* now_usec, uint64_t* error_usec);
 
+#if !defined(__APPLE__)
+  // Reads the wall clock without calling ntp_gettime(), deriving the error from the last sample
+  // taken by WalltimeWithError. Returns false if that sample is missing or older than
+  // refresh_interval_usec.
+  bool CachedWalltimeWithError(
+      uint64_t refresh_interval_usec, uint64_t* now_usec, uint64_t* error_usec);
+#endif // !defined(__APPLE__)
+
   // Returns Status::OK if the clock error_usec provided is within acceptable limits, otherwise
   // it returns a not OK status if disable_clock_sync_error is not true.
   static CHECKED_STATUS CheckClockSyncError(uint64_t error_usec);
@@ -223,10 +233,21 @@ class HybridClock : public Clock {
 
 #if !defined(__APPLE__)
   uint64_t divisor_;
+
+  // Last wall clock time and maximum error read with ntp_gettime(), used when
+  // --clock_error_refresh_interval_usec is set.
+  struct ClockErrorSample {
+    uint64_t time_usec;
+    uint64_t error_usec;
+  };
+  std::atomic<ClockErrorSample> clock_error_sample_{ClockErrorSample{0, 0}};
 #endif
 
   double tolerance_adjustment_;
 
+  // Set when --time_source selects a clock other than NTP.
+  std::unique_ptr<PhysicalClock> physical_clock_;
+
   struct HybridClockComponents {
     // the last clock read/update, in microseconds.
     uint64_t last_usec;
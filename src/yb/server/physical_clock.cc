@@ -0,0 +1,135 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/server/physical_clock.h"
+
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <mutex>
+#include <unordered_map>
+
+#include <gflags/gflags.h>
+
+#include "yb/util/errno.h"
+#include "yb/util/flag_tags.h"
+
+DEFINE_string(ptp_clock_device, "/dev/ptp0",
+              "PTP hardware clock device read by the 'ptp' time source.");
+TAG_FLAG(ptp_clock_device, advanced);
+
+DEFINE_uint64(ptp_clock_max_error_usec, 100,
+              "Maximum error of the PTP hardware clock reported by the 'ptp' time source. Should "
+              "cover the synchronization accuracy of the PTP daemon disciplining the clock.");
+TAG_FLAG(ptp_clock_max_error_usec, advanced);
+TAG_FLAG(ptp_clock_max_error_usec, runtime);
+
+namespace yb {
+namespace server {
+
+namespace {
+
+class PhysicalClockRegistry {
+ public:
+  static PhysicalClockRegistry& Instance() {
+    static PhysicalClockRegistry instance;
+    return instance;
+  }
+
+  void Register(const std::string& name, PhysicalClockFactory factory) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    factories_[name] = std::move(factory);
+  }
+
+  Result<std::unique_ptr<PhysicalClock>> Create(const std::string& name) {
+    PhysicalClockFactory factory;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = factories_.find(name);
+      if (it == factories_.end()) {
+        return STATUS_FORMAT(NotFound, "Unknown time source: $0", name);
+      }
+      factory = it->second;
+    }
+    return factory();
+  }
+
+ private:
+  std::mutex mutex_;
+  std::unordered_map<std::string, PhysicalClockFactory> factories_;
+};
+
+#if defined(__linux__)
+
+// Reads a PTP hardware clock through its dynamic POSIX clock id. The error bound is configured,
+// since the kernel does not know how well the daemon disciplining the clock keeps it in sync.
+class PtpClock : public PhysicalClock {
+ public:
+  explicit PtpClock(int fd) : fd_(fd) {}
+
+  ~PtpClock() {
+    close(fd_);
+  }
+
+  Status Now(uint64_t* now_usec, uint64_t* error_usec) override {
+    timespec ts;
+    if (clock_gettime(ClockId(), &ts) != 0) {
+      return STATUS(ServiceUnavailable, "Error reading PTP clock", ErrnoToString(errno));
+    }
+    *now_usec = ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+    *error_usec = FLAGS_ptp_clock_max_error_usec;
+    return Status::OK();
+  }
+
+ private:
+  // Same as FD_TO_CLOCKID from linux/posix-timers.h.
+  clockid_t ClockId() const {
+    return (~static_cast<clockid_t>(fd_) << 3) | 3;
+  }
+
+  const int fd_;
+};
+
+Result<std::unique_ptr<PhysicalClock>> CreatePtpClock() {
+  const int fd = open(FLAGS_ptp_clock_device.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return STATUS_FORMAT(IOError, "Failed to open PTP clock $0: $1",
+                         FLAGS_ptp_clock_device, ErrnoToString(errno));
+  }
+  std::unique_ptr<PhysicalClock> result = std::make_unique<PtpClock>(fd);
+  uint64_t now_usec, error_usec;
+  RETURN_NOT_OK(result->Now(&now_usec, &error_usec));
+  return std::move(result);
+}
+
+#endif // defined(__linux__)
+
+} // namespace
+
+void RegisterPhysicalClock(const std::string& name, PhysicalClockFactory factory) {
+  PhysicalClockRegistry::Instance().Register(name, std::move(factory));
+}
+
+Result<std::unique_ptr<PhysicalClock>> CreatePhysicalClock(const std::string& name) {
+#if defined(__linux__)
+  static std::once_flag builtin_clocks_registered;
+  std::call_once(builtin_clocks_registered, [] {
+    RegisterPhysicalClock("ptp", &CreatePtpClock);
+  });
+#endif // defined(__linux__)
+  return PhysicalClockRegistry::Instance().Create(name);
+}
+
+} // namespace server
+} // namespace yb
@@ -0,0 +1,51 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_SERVER_PHYSICAL_CLOCK_H
+#define YB_SERVER_PHYSICAL_CLOCK_H
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "yb/util/result.h"
+#include "yb/util/status.h"
+
+namespace yb {
+namespace server {
+
+// Source of wall clock time together with a bound on its error. HybridClock reads the time from
+// NTP by default, and uses a PhysicalClock instead when --time_source names one. Clocks with
+// tighter error bounds than NTP, e.g. PTP hardware clocks, shrink the uncertainty window used by
+// commit wait, leader leases and safe time.
+class PhysicalClock {
+ public:
+  virtual ~PhysicalClock() {}
+
+  // Reads the current time and its maximum error, both in microseconds.
+  virtual CHECKED_STATUS Now(uint64_t* now_usec, uint64_t* error_usec) = 0;
+};
+
+typedef std::function<Result<std::unique_ptr<PhysicalClock>>()> PhysicalClockFactory;
+
+// Makes a physical clock available under the given name for --time_source. Should be called
+// before any HybridClock is initialized, e.g. from a static initializer.
+void RegisterPhysicalClock(const std::string& name, PhysicalClockFactory factory);
+
+// Creates the physical clock registered under the given name.
+Result<std::unique_ptr<PhysicalClock>> CreatePhysicalClock(const std::string& name);
+
+} // namespace server
+} // namespace yb
+
+#endif // YB_SERVER_PHYSICAL_CLOCK_H
@@ -51,6 +51,7 @@
 #include <sys/stat.h>
 
 #include <fstream>
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -62,6 +63,7 @@
 #include "yb/gutil/strings/substitute.h"
 #include "yb/gutil/sysinfo.h"
 #include "yb/server/webserver.h"
+#include "yb/util/continuous_profiler.h"
 #include "yb/util/env.h"
 #include "yb/util/logging.h"
 #include "yb/util/monotime.h"
@@ -206,6 +208,36 @@ static void PprofContentionHandler(const Webserver::WebRequest& req, stringstrea
 #endif // defined(__linux__)
 }
 
+// Profile collected by the continuous profiler, in the folded stacks format.
+// Arguments:
+//   type - cpu (default), lock or threadpool.
+//   seconds - only windows that ended during the last 'seconds' are included, all kept windows by
+//             default.
+static void PprofContinuousHandler(const Webserver::WebRequest& req, stringstream* output) {
+  string type_str = FindWithDefault(req.parsed_args, "type", "cpu");
+  ProfileSampleType type;
+  if (type_str == "cpu") {
+    type = ProfileSampleType::kCpu;
+  } else if (type_str == "lock") {
+    type = ProfileSampleType::kLockWait;
+  } else if (type_str == "threadpool") {
+    type = ProfileSampleType::kThreadPoolQueue;
+  } else {
+    *output << "Unknown profile type: " << type_str << ", expected cpu, lock or threadpool"
+            << endl;
+    return;
+  }
+  string secs_str = FindWithDefault(req.parsed_args, "seconds", "");
+  int32_t seconds = ParseLeadingInt32Value(secs_str.c_str(), std::numeric_limits<int32_t>::max());
+
+  auto start_pos = output->tellp();
+  DumpContinuousProfile(type, seconds, output);
+  if (output->tellp() == start_pos && !ContinuousProfilingEnabled()) {
+    *output << "No samples, continuous profiling is disabled. "
+            << "Set --enable_continuous_profiling to enable it." << endl;
+  }
+}
+
 
 // pprof asks for the url /pprof/symbol to map from hex addresses to variable names.
 // When the server receives a GET request for /pprof/symbol, it should return a line
@@ -269,6 +301,7 @@ void AddPprofPathHandlers(Webserver* webserver) {
   webserver->RegisterPathHandler("/pprof/profile", "", PprofCpuProfileHandler, false, false);
   webserver->RegisterPathHandler("/pprof/symbol", "", PprofSymbolHandler, false, false);
   webserver->RegisterPathHandler("/pprof/contention", "", PprofContentionHandler, false, false);
+  webserver->RegisterPathHandler("/pprof/continuous", "", PprofContinuousHandler, false, false);
 }
 
 } // namespace yb
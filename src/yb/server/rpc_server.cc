@@ -67,6 +67,10 @@ TAG_FLAG(rpc_server_allow_ephemeral_ports, unsafe);
 
 DEFINE_int32(rpc_queue_limit, 5000, "Queue limit for rpc server");
 DEFINE_int32(rpc_workers_limit, 128, "Workers limit for rpc server");
+DEFINE_bool(rpc_thread_pool_work_stealing, false,
+            "Use per worker task queues with work stealing in rpc server thread pool, instead "
+            "of the single queue shared by all workers");
+TAG_FLAG(rpc_thread_pool_work_stealing, advanced);
 DECLARE_int32(rpc_default_keepalive_time_ms);
 
 namespace yb {
@@ -76,13 +80,14 @@ RpcServerOptions::RpcServerOptions()
     default_port(0),
     queue_limit(FLAGS_rpc_queue_limit),
     workers_limit(FLAGS_rpc_workers_limit),
+    work_stealing(FLAGS_rpc_thread_pool_work_stealing),
     connection_keepalive_time_ms(FLAGS_rpc_default_keepalive_time_ms) {
 }
 
 RpcServer::RpcServer(const std::string& name, RpcServerOptions opts)
-    : server_state_(UNINITIALIZED),
-      options_(std::move(opts)),
-      thread_pool_(new rpc::ThreadPool(name, options_.queue_limit, options_.workers_limit)) {}
+    : name_(name),
+      server_state_(UNINITIALIZED),
+      options_(std::move(opts)) {}
 
 RpcServer::~RpcServer() {
   Shutdown();
@@ -96,6 +101,9 @@ string RpcServer::ToString() const {
 Status RpcServer::Init(const shared_ptr<Messenger>& messenger) {
   CHECK_EQ(server_state_, UNINITIALIZED);
   messenger_ = messenger;
+  // Thread pool is created here, since metric entity is known only after messenger is set.
+  thread_pool_.reset(new rpc::ThreadPool(name_, options_.queue_limit, options_.workers_limit,
+                                         options_.work_stealing, messenger_->metric_entity()));
 
   RETURN_NOT_OK(HostPort::ParseStrings(options_.rpc_bind_addresses,
                                        options_.default_port,
@@ -164,7 +172,9 @@ Status RpcServer::Start() {
 }
 
 void RpcServer::Shutdown() {
-  thread_pool_->Shutdown();
+  if (thread_pool_) {
+    thread_pool_->Shutdown();
+  }
 
   if (messenger_) {
     messenger_->ShutdownAcceptor();
@@ -53,6 +53,7 @@ struct RpcServerOptions {
   uint16_t default_port;
   size_t queue_limit;
   size_t workers_limit;
+  bool work_stealing;
   int32_t connection_keepalive_time_ms;
 };
 
@@ -92,6 +93,7 @@ class RpcServer {
     // State after Start() was called.
     STARTED
   };
+  const std::string name_;
   ServerState server_state_;
 
   const RpcServerOptions options_;
@@ -59,6 +59,7 @@
 #include "yb/server/tracing-path-handlers.h"
 #include "yb/server/webserver.h"
 #include "yb/util/atomic.h"
+#include "yb/util/continuous_profiler.h"
 #include "yb/util/env.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/jsonwriter.h"
@@ -165,6 +166,7 @@ Status RpcServerBase::Init() {
   RegisterSpinLockContentionMetrics(metric_entity_);
 
   InitSpinLockContentionProfiling();
+  InitContinuousProfiling();
 
   SetStackTraceSignal(SIGUSR2);
 
@@ -37,6 +37,7 @@
 #include <gperftools/malloc_extension.h>
 #endif
 
+#include "yb/util/memory/huge_pages.h"
 #include "yb/util/metrics.h"
 
 #ifndef TCMALLOC_ENABLED
@@ -84,6 +85,14 @@ METRIC_DEFINE_gauge_uint64(server, tcmalloc_current_total_thread_cache_bytes,
 
 #undef TCM_ASAN_MSG
 
+METRIC_DEFINE_gauge_uint64(server, huge_pages_allocated_bytes,
+    "Huge Pages Memory Usage", yb::MetricUnit::kBytes,
+    "Number of bytes mapped with huge pages, for instance by memtable arenas.");
+
+METRIC_DEFINE_gauge_uint64(server, huge_pages_allocation_failures,
+    "Huge Pages Allocation Failures", yb::MetricUnit::kOperations,
+    "Number of huge page allocations that failed and fell back to regular pages.");
+
 namespace yb {
 namespace tcmalloc {
 
@@ -117,6 +126,12 @@ void RegisterMetrics(const scoped_refptr<MetricEntity>& entity) {
       METRIC_tcmalloc_current_total_thread_cache_bytes.InstantiateFunctionGauge(
           entity, Bind(GetTCMallocPropValue,
                        Unretained("tcmalloc.current_total_thread_cache_bytes"))));
+  entity->NeverRetire(
+      METRIC_huge_pages_allocated_bytes.InstantiateFunctionGauge(
+          entity, Bind(&HugePagesAllocatedBytes)));
+  entity->NeverRetire(
+      METRIC_huge_pages_allocation_failures.InstantiateFunctionGauge(
+          entity, Bind(&HugePagesAllocationFailures)));
 }
 
 } // namespace tcmalloc
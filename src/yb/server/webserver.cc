@@ -84,6 +84,11 @@ DEFINE_int32(webserver_max_post_length_bytes, 1024 * 1024,
 TAG_FLAG(webserver_max_post_length_bytes, advanced);
 TAG_FLAG(webserver_max_post_length_bytes, runtime);
 
+DEFINE_int32(webserver_stream_chunk_size_bytes, 64 * 1024,
+             "Size of the chunks in which the embedded web server sends the output of streaming "
+             "pages, e.g. metrics.");
+TAG_FLAG(webserver_stream_chunk_size_bytes, advanced);
+
 namespace yb {
 
 using std::string;
@@ -93,6 +98,56 @@ using std::make_pair;
 
 using namespace std::placeholders;
 
+namespace {
+
+// Buffers output written to it and sends it to the connection as HTTP/1.1 chunks once
+// --webserver_stream_chunk_size_bytes have been accumulated.
+class ChunkedStreamBuffer : public std::streambuf {
+ public:
+  explicit ChunkedStreamBuffer(struct sq_connection* connection)
+      : connection_(connection),
+        buffer_(std::max(FLAGS_webserver_stream_chunk_size_bytes, 1)) {
+    setp(buffer_.data(), buffer_.data() + buffer_.size());
+  }
+
+  // Sends buffered output and the terminating zero length chunk.
+  void Finish() {
+    sync();
+    sq_printf(connection_, "0\r\n\r\n");
+  }
+
+ protected:
+  int_type overflow(int_type ch) override {
+    SendChunk();
+    if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+      *pptr() = traits_type::to_char_type(ch);
+      pbump(1);
+    }
+    return traits_type::not_eof(ch);
+  }
+
+  int sync() override {
+    SendChunk();
+    return 0;
+  }
+
+ private:
+  void SendChunk() {
+    size_t size = pptr() - pbase();
+    if (size != 0) {
+      sq_printf(connection_, "%zx\r\n", size);
+      sq_write(connection_, pbase(), size);
+      sq_printf(connection_, "\r\n");
+    }
+    setp(buffer_.data(), buffer_.data() + buffer_.size());
+  }
+
+  struct sq_connection* connection_;
+  std::vector<char> buffer_;
+};
+
+} // namespace
+
 Webserver::Webserver(const WebserverOptions& opts, const std::string& server_name)
   : opts_(opts),
     context_(nullptr),
@@ -358,6 +413,11 @@ int Webserver::RunPathHandler(const PathHandler& handler,
     }
   }
 
+  if (handler.streaming_callback()) {
+    RunStreamingPathHandler(handler, req, connection, request_info);
+    return 1;
+  }
+
   if (!handler.is_styled() || ContainsKey(req.parsed_args, "raw")) {
     use_style = false;
   }
@@ -388,6 +448,33 @@ int Webserver::RunPathHandler(const PathHandler& handler,
   return 1;
 }
 
+void Webserver::RunStreamingPathHandler(const PathHandler& handler,
+                                        const WebRequest& req,
+                                        struct sq_connection* connection,
+                                        struct sq_request_info* request_info) {
+  if (request_info->http_version == nullptr || strcmp(request_info->http_version, "1.1") != 0) {
+    // Chunked transfer encoding is not available, so the length has to be known upfront.
+    stringstream output;
+    handler.streaming_callback()(req, &output);
+    string str = output.str();
+    sq_printf(connection, "HTTP/1.1 200 OK\r\n"
+              "Content-Type: text/plain\r\n"
+              "Content-Length: %zd\r\n"
+              "\r\n", str.length());
+    sq_write(connection, str.c_str(), str.length());
+    return;
+  }
+
+  sq_printf(connection, "HTTP/1.1 200 OK\r\n"
+            "Content-Type: text/plain\r\n"
+            "Transfer-Encoding: chunked\r\n"
+            "\r\n");
+  ChunkedStreamBuffer buffer(connection);
+  std::ostream output(&buffer);
+  handler.streaming_callback()(req, &output);
+  buffer.Finish();
+}
+
 void Webserver::RegisterPathHandler(const string& path,
                                     const string& alias,
                                     const PathHandlerCallback& callback,
@@ -403,6 +490,18 @@ void Webserver::RegisterPathHandler(const string& path,
   it->second->AddCallback(callback);
 }
 
+void Webserver::RegisterStreamingPathHandler(const string& path,
+                                             const string& alias,
+                                             const StreamingPathHandlerCallback& callback) {
+  std::lock_guard<boost::shared_mutex> lock(lock_);
+  auto it = path_handlers_.find(path);
+  if (it == path_handlers_.end()) {
+    it = path_handlers_.insert(make_pair(
+        path, new PathHandler(false /* is_styled */, false /* is_on_nav_bar */, alias, ""))).first;
+  }
+  it->second->SetStreamingCallback(callback);
+}
+
 const char* const PAGE_HEADER = "<!DOCTYPE html>"
 "<html>"
 "  <head>"
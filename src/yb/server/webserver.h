@@ -43,6 +43,7 @@
 #ifndef YB_SERVER_WEBSERVER_H
 #define YB_SERVER_WEBSERVER_H
 
+#include <iosfwd>
 #include <map>
 #include <string>
 #include <vector>
@@ -86,6 +87,18 @@ class Webserver : public WebCallbackRegistry {
                                    bool is_on_nav_bar = true,
                                    const std::string icon = "") override;
 
+  // Callback that writes the page directly to the connection, so large output, e.g. metrics,
+  // does not have to be buffered in memory before it is sent.
+  typedef std::function<void(const WebRequest& args, std::ostream* output)>
+      StreamingPathHandlerCallback;
+
+  // Registers a callback for a URL path whose output is sent to the client while it is produced.
+  // Such pages are never styled nor on the nav bar, and a path has at most one streaming callback.
+  // Output is sent with chunked transfer encoding, clients that only speak HTTP/1.0 get it
+  // buffered.
+  void RegisterStreamingPathHandler(const std::string& path, const std::string& alias,
+                                    const StreamingPathHandlerCallback& callback);
+
   // Change the footer HTML to be displayed at the bottom of all styled web pages.
   void set_footer_html(const std::string& html);
 
@@ -105,11 +118,18 @@ class Webserver : public WebCallbackRegistry {
       callbacks_.push_back(callback);
     }
 
+    void SetStreamingCallback(const StreamingPathHandlerCallback& callback) {
+      streaming_callback_ = callback;
+    }
+
     bool is_styled() const { return is_styled_; }
     bool is_on_nav_bar() const { return is_on_nav_bar_; }
     const std::string& alias() const { return alias_; }
     const std::string& icon() const { return icon_; }
     const std::vector<PathHandlerCallback>& callbacks() const { return callbacks_; }
+    const StreamingPathHandlerCallback& streaming_callback() const {
+      return streaming_callback_;
+    }
 
    private:
     // If true, the page appears is rendered styled.
@@ -126,6 +146,9 @@ class Webserver : public WebCallbackRegistry {
 
     // List of callbacks to render output for this page, called in order.
     std::vector<PathHandlerCallback> callbacks_;
+
+    // If set, renders this page instead of callbacks_.
+    StreamingPathHandlerCallback streaming_callback_;
   };
 
   bool static_pages_available() const;
@@ -150,6 +173,11 @@ class Webserver : public WebCallbackRegistry {
                      struct sq_connection* connection,
                      struct sq_request_info* request_info);
 
+  void RunStreamingPathHandler(const PathHandler& handler,
+                               const WebRequest& req,
+                               struct sq_connection* connection,
+                               struct sq_request_info* request_info);
+
   // Callback to funnel mongoose logs through glog.
   static int LogMessageCallbackStatic(const struct sq_connection* connection,
                                       const char* message);
@@ -13,6 +13,9 @@
 
 #include "yb/docdb/doc_operation.h"
 #include "yb/tablet/abstract_tablet.h"
+
+#include "yb/rocksdb/perf_context.h"
+
 #include "yb/util/trace.h"
 
 namespace yb {
@@ -22,30 +25,36 @@ CHECKED_STATUS AbstractTablet::HandleQLReadRequest(
     const ReadHybridTime& read_time,
     const QLReadRequestPB& ql_read_request,
     const TransactionOperationContextOpt& txn_op_context,
-    QLReadRequestResult* result) {
+    QLReadRequestResult* result,
+    docdb::QLRowCache* row_cache) {
 
   // TODO(Robert): verify that all key column values are provided
-  docdb::QLReadOperation doc_op(ql_read_request, txn_op_context);
+  docdb::QLReadOperation doc_op(ql_read_request, txn_op_context, row_cache);
 
-  // Form a schema of columns that are referenced by this query.
+  // Get the schemas of columns that are referenced by this query.
   const Schema &schema = SchemaRef();
-  Schema query_schema;
-  const QLReferencedColumnsPB& column_pbs = ql_read_request.column_refs();
-  vector<ColumnId> column_refs;
-  for (int32_t id : column_pbs.static_ids()) {
-    column_refs.emplace_back(id);
-  }
-  for (int32_t id : column_pbs.ids()) {
-    column_refs.emplace_back(id);
-  }
-  RETURN_NOT_OK(schema.CreateProjectionByIdsIgnoreMissing(column_refs, &query_schema));
+  auto projections = VERIFY_RESULT(ql_read_projections_.Get(schema, ql_read_request.column_refs()));
 
   QLRSRowDesc rsrow_desc(ql_read_request.rsrow_desc());
   QLResultSet resultset;
+  // RocksDB perf context is thread local, so its delta over Execute is the work of this request.
+  const rocksdb::PerfContext perf_before = rocksdb::perf_context;
   TRACE("Start Execute");
   const Status s = doc_op.Execute(
-      QLStorage(), read_time, schema, query_schema, &resultset, &result->restart_read_ht);
+      QLStorage(), read_time, schema, *projections, &resultset, &result->restart_read_ht);
   TRACE("Done Execute");
+  const rocksdb::PerfContext& perf_after = rocksdb::perf_context;
+  auto* read_stats = doc_op.response().mutable_read_stats();
+  read_stats->set_internal_keys_skipped(
+      perf_after.internal_key_skipped_count - perf_before.internal_key_skipped_count);
+  read_stats->set_block_cache_hits(
+      perf_after.block_cache_hit_count - perf_before.block_cache_hit_count);
+  read_stats->set_blocks_read(perf_after.block_read_count - perf_before.block_read_count);
+  read_stats->set_bloom_filter_useful(
+      perf_after.bloom_sst_miss_count - perf_before.bloom_sst_miss_count);
+  read_stats->set_bloom_filter_checked(
+      perf_after.bloom_sst_hit_count + perf_after.bloom_sst_miss_count -
+      perf_before.bloom_sst_hit_count - perf_before.bloom_sst_miss_count);
   if (!s.ok()) {
     result->response.set_status(QLResponsePB::YQL_STATUS_RUNTIME_ERROR);
     result->response.set_error_message(s.message().cdata(), s.message().size());
@@ -61,9 +70,14 @@ CHECKED_STATUS AbstractTablet::HandleQLReadRequest(
   // encoding. For now, we'll call CQLSerialize() without checking encoding method.
   result->response.set_status(QLResponsePB::YQL_STATUS_OK);
   TRACE("Start Serialize");
-  RETURN_NOT_OK(resultset.CQLSerialize(ql_read_request.client(),
-                                       rsrow_desc,
-                                       &result->rows_data));
+  if (ql_read_request.rows_data_format() == YQL_ROWS_DATA_COLUMNAR) {
+    resultset.ColumnarSerialize(rsrow_desc, &result->rows_data);
+    result->response.set_rows_data_format(YQL_ROWS_DATA_COLUMNAR);
+  } else {
+    RETURN_NOT_OK(resultset.CQLSerialize(ql_read_request.client(),
+                                         rsrow_desc,
+                                         &result->rows_data));
+  }
   TRACE("Done Serialize");
   return Status::OK();
 }
@@ -18,6 +18,8 @@
 #include "yb/common/schema.h"
 #include "yb/common/ql_storage_interface.h"
 
+#include "yb/docdb/doc_operation.h"
+
 #include "yb/tablet/tablet_fwd.h"
 
 namespace yb {
@@ -46,6 +48,13 @@ class AbstractTablet {
       const RedisReadRequestPB& redis_read_request,
       RedisResponsePB* response) = 0;
 
+  // Executes a batch of Redis reads with one iterator, in key order. Adds the responses in the
+  // order of the requests.
+  virtual CHECKED_STATUS HandleRedisReadRequests(
+      const ReadHybridTime& read_time,
+      const google::protobuf::RepeatedPtrField<RedisReadRequestPB>& redis_read_requests,
+      google::protobuf::RepeatedPtrField<RedisResponsePB>* responses) = 0;
+
   virtual CHECKED_STATUS HandleQLReadRequest(
       const ReadHybridTime& read_time,
       const QLReadRequestPB& ql_read_request,
@@ -78,11 +87,14 @@ class AbstractTablet {
       const ReadHybridTime& read_time,
       const QLReadRequestPB& ql_read_request,
       const TransactionOperationContextOpt& txn_op_context,
-      QLReadRequestResult* result);
+      QLReadRequestResult* result,
+      docdb::QLRowCache* row_cache = nullptr);
 
  private:
   virtual HybridTime DoGetSafeTime(
       RequireLease require_lease, HybridTime min_allowed, MonoTime deadline) const = 0;
+
+  docdb::QLReadProjectionCache ql_read_projections_;
 };
 
 }  // namespace tablet
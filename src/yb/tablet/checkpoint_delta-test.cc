@@ -0,0 +1,88 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <algorithm>
+
+#include <gtest/gtest.h>
+
+#include "yb/tablet/checkpoint_delta.h"
+
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+namespace tablet {
+
+namespace {
+
+void AddFile(const std::string& name, uint64_t size, FilePBs* files) {
+  auto* file = files->Add();
+  file->set_name(name);
+  file->set_size_bytes(size);
+}
+
+std::vector<std::string> Names(const FilePBs& files) {
+  std::vector<std::string> result;
+  for (const auto& file : files) {
+    result.push_back(file.name());
+  }
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+} // namespace
+
+class CheckpointDeltaTest : public YBTest {
+};
+
+TEST_F(CheckpointDeltaTest, DiffAndApply) {
+  FilePBs base;
+  AddFile("000010.sst", 100, &base);
+  AddFile("000010.sst.sblock.0", 1000, &base);
+  AddFile("000011.sst", 200, &base);
+  AddFile("000011.sst.sblock.0", 2000, &base);
+  AddFile("MANIFEST-000005", 50, &base);
+  AddFile("CURRENT", 16, &base);
+
+  // 000011 was compacted into 000012, manifest was rewritten. Sizes of unchanged files are kept.
+  FilePBs current;
+  AddFile("000010.sst", 100, &current);
+  AddFile("000010.sst.sblock.0", 1000, &current);
+  AddFile("000012.sst", 300, &current);
+  AddFile("000012.sst.sblock.0", 3000, &current);
+  AddFile("MANIFEST-000005", 80, &current);
+  AddFile("CURRENT", 16, &current);
+
+  CheckpointDeltaPB delta;
+  DiffCheckpointFiles(base, current, &delta);
+  ASSERT_EQ((std::vector<std::string>{
+                "000012.sst", "000012.sst.sblock.0", "CURRENT", "MANIFEST-000005"}),
+            Names(delta.added_files()));
+  ASSERT_EQ((std::vector<std::string>{"000011.sst", "000011.sst.sblock.0"}),
+            std::vector<std::string>(delta.removed_files().begin(), delta.removed_files().end()));
+
+  FilePBs restored = base;
+  ASSERT_OK(ApplyCheckpointDelta(delta, &restored));
+  ASSERT_EQ(Names(current), Names(restored));
+  for (const auto& file : restored) {
+    if (file.name() == "MANIFEST-000005") {
+      ASSERT_EQ(80U, file.size_bytes());
+    }
+  }
+
+  // Delta is not applicable to a checkpoint that does not have the removed files.
+  ASSERT_NOK(ApplyCheckpointDelta(delta, &current));
+}
+
+} // namespace tablet
+} // namespace yb
@@ -0,0 +1,98 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tablet/checkpoint_delta.h"
+
+#include <map>
+#include <unordered_map>
+
+#include "yb/rocksdb/db/filename.h"
+
+#include "yb/util/env.h"
+#include "yb/util/env_util.h"
+#include "yb/util/path_util.h"
+
+namespace yb {
+namespace tablet {
+
+namespace {
+
+bool IsSSTFile(const std::string& name) {
+  uint64_t number;
+  rocksdb::FileType type;
+  return rocksdb::ParseFileName(BaseName(name), &number, &type) &&
+         (type == rocksdb::kTableFile || type == rocksdb::kTableSBlockFile);
+}
+
+} // namespace
+
+void DiffCheckpointFiles(const FilePBs& base, const FilePBs& current, CheckpointDeltaPB* delta) {
+  delta->Clear();
+
+  std::unordered_map<std::string, const FilePB*> base_files;
+  for (const auto& file : base) {
+    base_files.emplace(file.name(), &file);
+  }
+
+  for (const auto& file : current) {
+    auto it = base_files.find(file.name());
+    if (it != base_files.end()) {
+      const bool unchanged = IsSSTFile(file.name()) &&
+                             it->second->size_bytes() == file.size_bytes();
+      base_files.erase(it);
+      if (unchanged) {
+        continue;
+      }
+    }
+    auto* added = delta->add_added_files();
+    added->set_name(file.name());
+    added->set_size_bytes(file.size_bytes());
+  }
+
+  for (const auto& file : base) {
+    if (base_files.count(file.name())) {
+      delta->add_removed_files(file.name());
+    }
+  }
+}
+
+Status ChecksumCheckpointDelta(Env* env, const std::string& dir, CheckpointDeltaPB* delta) {
+  for (auto& file : *delta->mutable_added_files()) {
+    file.set_crc32c(VERIFY_RESULT(env_util::Crc32cFile(env, JoinPathSegments(dir, file.name()))));
+  }
+  return Status::OK();
+}
+
+Status ApplyCheckpointDelta(const CheckpointDeltaPB& delta, FilePBs* files) {
+  std::map<std::string, FilePB> result;
+  for (const auto& file : *files) {
+    result.emplace(file.name(), file);
+  }
+  for (const auto& name : delta.removed_files()) {
+    if (result.erase(name) == 0) {
+      return STATUS_FORMAT(NotFound, "Checkpoint delta removes unknown file $0", name);
+    }
+  }
+  for (const auto& file : delta.added_files()) {
+    result[file.name()] = file;
+  }
+
+  files->Clear();
+  for (auto& entry : result) {
+    *files->Add() = std::move(entry.second);
+  }
+  return Status::OK();
+}
+
+} // namespace tablet
+} // namespace yb
@@ -0,0 +1,49 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_TABLET_CHECKPOINT_DELTA_H
+#define YB_TABLET_CHECKPOINT_DELTA_H
+
+#include <string>
+
+#include <google/protobuf/repeated_field.h>
+
+#include "yb/tablet/metadata.pb.h"
+
+#include "yb/util/status.h"
+
+namespace yb {
+
+class Env;
+
+namespace tablet {
+
+typedef google::protobuf::RepeatedPtrField<FilePB> FilePBs;
+
+// Fills delta with the difference between the files of the current checkpoint and the files of
+// the base checkpoint. SST files with the same name and size are considered the same, since
+// RocksDB never rewrites SST files nor reuses their numbers. Other files are always added.
+void DiffCheckpointFiles(const FilePBs& base, const FilePBs& current, CheckpointDeltaPB* delta);
+
+// Sets the crc32c of the files added by delta, reading them from the checkpoint directory dir.
+CHECKED_STATUS ChecksumCheckpointDelta(Env* env, const std::string& dir, CheckpointDeltaPB* delta);
+
+// Replaces files, the files of a base checkpoint, with the files of the checkpoint that delta
+// was created for. Fails if delta removes a file that files do not have, i.e. it was created for
+// another base checkpoint.
+CHECKED_STATUS ApplyCheckpointDelta(const CheckpointDeltaPB& delta, FilePBs* files);
+
+} // namespace tablet
+} // namespace yb
+
+#endif // YB_TABLET_CHECKPOINT_DELTA_H
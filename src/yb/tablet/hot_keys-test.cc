@@ -0,0 +1,50 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <gtest/gtest.h>
+
+#include "yb/tablet/hot_keys.h"
+
+#include "yb/util/test_util.h"
+
+DECLARE_int32(tablet_hot_keys_capacity);
+
+namespace yb {
+namespace tablet {
+
+class HotKeysTest : public YBTest {
+};
+
+TEST_F(HotKeysTest, FindsHotKey) {
+  FLAGS_tablet_hot_keys_capacity = 8;
+  HotKeySampler sampler;
+  // Every other access goes to the hot key, the rest are spread over many more keys than the
+  // sampler can track.
+  for (int i = 0; i != 1000; ++i) {
+    sampler.Record(i % 2 == 0 ? Slice("hot") : Slice(std::to_string(i)));
+  }
+
+  auto top = sampler.TopKeys(3);
+  ASSERT_FALSE(top.empty());
+  ASSERT_LE(top.size(), 3U);
+  ASSERT_EQ("hot", top[0].key);
+  ASSERT_GT(top[0].share, 0.3);
+  ASSERT_LE(top[0].share, 1.0);
+  for (size_t i = 1; i < top.size(); ++i) {
+    ASSERT_GE(top[i - 1].count, top[i].count);
+    ASSERT_LT(top[i].share, top[0].share);
+  }
+}
+
+} // namespace tablet
+} // namespace yb
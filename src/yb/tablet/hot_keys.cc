@@ -0,0 +1,122 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tablet/hot_keys.h"
+
+#include <algorithm>
+
+#include <gflags/gflags.h>
+
+#include "yb/util/flag_tags.h"
+
+DEFINE_int32(tablet_hot_keys_sample_period, 128,
+             "One in this number of reads and writes is sampled to find the hot keys of tablets. "
+             "0 disables hot key sampling.");
+TAG_FLAG(tablet_hot_keys_sample_period, advanced);
+TAG_FLAG(tablet_hot_keys_sample_period, runtime);
+
+DEFINE_int32(tablet_hot_keys_capacity, 64,
+             "Number of keys tracked by the hot key sampler of a tablet.");
+TAG_FLAG(tablet_hot_keys_capacity, advanced);
+
+namespace yb {
+namespace tablet {
+
+namespace {
+
+// Counts are halved after this number of samples per tracked key.
+constexpr uint64_t kSamplesPerKeyBeforeDecay = 16;
+
+} // namespace
+
+HotKeySampler::HotKeySampler() {
+}
+
+bool HotKeySampler::ShouldSample() {
+  const int32_t period = FLAGS_tablet_hot_keys_sample_period;
+  if (period <= 0) {
+    return false;
+  }
+  static thread_local int32_t countdown = 0;
+  if (--countdown > 0) {
+    return false;
+  }
+  countdown = period;
+  return true;
+}
+
+void HotKeySampler::Record(Slice key) {
+  const size_t capacity = std::max(FLAGS_tablet_hot_keys_capacity, 1);
+  std::string key_str = key.ToBuffer();
+
+  std::lock_guard<simple_spinlock> lock(lock_);
+  auto it = index_.find(key_str);
+  if (it != index_.end()) {
+    ++entries_[it->second].count;
+  } else if (entries_.size() < capacity) {
+    index_.emplace(key_str, entries_.size());
+    entries_.push_back(Entry{std::move(key_str), 1, 0});
+  } else {
+    // Replace the least frequent key, the new key inherits its count as error.
+    auto min_it = std::min_element(
+        entries_.begin(), entries_.end(),
+        [](const Entry& lhs, const Entry& rhs) { return lhs.count < rhs.count; });
+    index_.erase(min_it->key);
+    index_.emplace(key_str, min_it - entries_.begin());
+    min_it->key = std::move(key_str);
+    min_it->error = min_it->count;
+    ++min_it->count;
+  }
+
+  if (++total_samples_ >= capacity * kSamplesPerKeyBeforeDecay) {
+    DecayUnlocked();
+  }
+}
+
+void HotKeySampler::DecayUnlocked() {
+  total_samples_ /= 2;
+  std::vector<Entry> entries;
+  entries.reserve(entries_.size());
+  index_.clear();
+  for (auto& entry : entries_) {
+    entry.count /= 2;
+    entry.error /= 2;
+    if (entry.count != 0) {
+      index_.emplace(entry.key, entries.size());
+      entries.push_back(std::move(entry));
+    }
+  }
+  entries_.swap(entries);
+}
+
+std::vector<HotKey> HotKeySampler::TopKeys(size_t max_keys) const {
+  std::vector<HotKey> result;
+  {
+    std::lock_guard<simple_spinlock> lock(lock_);
+    result.reserve(entries_.size());
+    for (const auto& entry : entries_) {
+      result.push_back(HotKey{
+          entry.key, entry.count, entry.error,
+          total_samples_ ? static_cast<double>(entry.count) / total_samples_ : 0.0});
+    }
+  }
+  const size_t size = std::min(max_keys, result.size());
+  std::partial_sort(
+      result.begin(), result.begin() + size, result.end(),
+      [](const HotKey& lhs, const HotKey& rhs) { return lhs.count > rhs.count; });
+  result.resize(size);
+  return result;
+}
+
+} // namespace tablet
+} // namespace yb
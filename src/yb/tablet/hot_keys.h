@@ -0,0 +1,77 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_TABLET_HOT_KEYS_H
+#define YB_TABLET_HOT_KEYS_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "yb/util/locks.h"
+#include "yb/util/slice.h"
+
+namespace yb {
+namespace tablet {
+
+struct HotKey {
+  // Encoded DocKey.
+  std::string key;
+  // Number of sampled accesses attributed to the key, overestimated by at most error.
+  uint64_t count;
+  uint64_t error;
+  // Fraction of all sampled accesses to the tablet attributed to the key.
+  double share;
+};
+
+// Finds the most frequently accessed keys of a tablet with the Space-Saving algorithm, run over a
+// sample of the accesses. For all but one in --tablet_hot_keys_sample_period accesses the cost is
+// a decrement of a thread local counter in ShouldSample().
+//
+// Counts are halved once enough accesses were sampled, so keys that stopped being hot fade out.
+class HotKeySampler {
+ public:
+  HotKeySampler();
+
+  HotKeySampler(const HotKeySampler&) = delete;
+  void operator=(const HotKeySampler&) = delete;
+
+  // Returns true if the current access should be passed to Record().
+  static bool ShouldSample();
+
+  void Record(Slice key);
+
+  // Returns up to max_keys hot keys, the most frequent first.
+  std::vector<HotKey> TopKeys(size_t max_keys) const;
+
+ private:
+  struct Entry {
+    std::string key;
+    uint64_t count;
+    uint64_t error;
+  };
+
+  // Halves all counts. Requires that lock_ is held.
+  void DecayUnlocked();
+
+  mutable simple_spinlock lock_;
+  std::vector<Entry> entries_;
+  // Index of the entry for key in entries_.
+  std::unordered_map<std::string, size_t> index_;
+  uint64_t total_samples_ = 0;
+};
+
+} // namespace tablet
+} // namespace yb
+
+#endif // YB_TABLET_HOT_KEYS_H
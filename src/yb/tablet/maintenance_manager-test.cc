@@ -45,6 +45,8 @@
 #include "yb/util/test_util.h"
 #include "yb/util/thread.h"
 
+DECLARE_int32(maintenance_manager_max_concurrent_high_io_ops);
+
 using yb::tablet::MaintenanceManagerStatusPB;
 using std::shared_ptr;
 using std::vector;
@@ -279,6 +281,35 @@ TEST_F(MaintenanceManagerTest, TestLogRetentionPrioritization) {
   manager_->UnregisterOp(&op2);
 }
 
+// Test that HIGH_IO_USAGE ops are skipped while the limit of them is running.
+TEST_F(MaintenanceManagerTest, TestHighIoOpsLimit) {
+  manager_->Shutdown();
+  google::FlagSaver flag_saver;
+  FLAGS_maintenance_manager_max_concurrent_high_io_ops = 1;
+
+  TestMaintenanceOp op1("op1", MaintenanceOp::HIGH_IO_USAGE, OP_RUNNABLE, test_tracker_);
+  op1.set_ram_anchored(0);
+  op1.set_perf_improvement(10);
+
+  TestMaintenanceOp op2("op2", MaintenanceOp::LOW_IO_USAGE, OP_RUNNABLE, test_tracker_);
+  op2.set_ram_anchored(0);
+  op2.set_perf_improvement(1);
+
+  manager_->RegisterOp(&op1);
+  manager_->RegisterOp(&op2);
+
+  ASSERT_EQ(&op1, manager_->FindBestOp());
+
+  // Pretend that a HIGH_IO_USAGE op is running, so only the low IO op could be picked.
+  manager_->running_high_io_ops_ = 1;
+  ASSERT_EQ(&op2, manager_->FindBestOp());
+  ASSERT_STR_CONTAINS(manager_->last_decision_, "op2");
+  manager_->running_high_io_ops_ = 0;
+
+  manager_->UnregisterOp(&op1);
+  manager_->UnregisterOp(&op2);
+}
+
 // Test adding operations and make sure that the history of recently completed operations
 // is correct in that it wraps around and doesn't grow.
 TEST_F(MaintenanceManagerTest, TestCompletedOpsHistory) {
@@ -34,6 +34,7 @@
 
 #include <stdint.h>
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <utility>
@@ -69,6 +70,18 @@ DEFINE_int32(maintenance_manager_history_size, 8,
        "Number of completed operations the manager is keeping track of.");
 TAG_FLAG(maintenance_manager_history_size, hidden);
 
+DEFINE_int32(maintenance_manager_max_concurrent_high_io_ops, 0,
+       "Maximum number of HIGH_IO_USAGE maintenance operations running at the same time, the "
+       "rest of the maintenance threads is left to LOW_IO_USAGE operations. 0 means that it is "
+       "only limited by the number of maintenance threads.");
+TAG_FLAG(maintenance_manager_max_concurrent_high_io_ops, advanced);
+TAG_FLAG(maintenance_manager_max_concurrent_high_io_ops, runtime);
+
+DEFINE_double(maintenance_manager_duration_decay, 0.3,
+       "Weight of the latest run of a maintenance operation in the average duration used as "
+       "its cost by the maintenance manager scheduler.");
+TAG_FLAG(maintenance_manager_duration_decay, advanced);
+
 DEFINE_bool(enable_maintenance_manager, true,
        "Enable the maintenance manager, runs compaction and tablet cleaning tasks.");
 TAG_FLAG(enable_maintenance_manager, unsafe);
@@ -204,9 +217,13 @@ void MaintenanceManager::RunSchedulerThread() {
   MonoDelta polling_interval = MonoDelta::FromMilliseconds(polling_interval_ms_);
 
   std::unique_lock<Mutex> guard(lock_);
+  bool wait = true;
   while (true) {
     // Loop until we are shutting down or it is time to run another op.
-    cond_.TimedWait(polling_interval);
+    if (wait) {
+      cond_.TimedWait(polling_interval);
+    }
+    wait = true;
     if (shutdown_) {
       VLOG_AND_TRACE("maintenance", 1) << "Shutting down maintenance manager.";
       return;
@@ -222,6 +239,10 @@ void MaintenanceManager::RunSchedulerThread() {
     // Prepare the maintenance operation.
     op->running_++;
     running_ops_++;
+    const bool high_io = op->io_usage_ == MaintenanceOp::HIGH_IO_USAGE;
+    if (high_io) {
+      running_high_io_ops_++;
+    }
     guard.unlock();
     bool ready = op->Prepare();
     guard.lock();
@@ -229,6 +250,10 @@ void MaintenanceManager::RunSchedulerThread() {
       LOG(INFO) << "Prepare failed for " << op->name()
                 << ".  Re-running scheduler.";
       op->running_--;
+      running_ops_--;
+      if (high_io) {
+        running_high_io_ops_--;
+      }
       op->cond_->Signal();
       continue;
     }
@@ -236,6 +261,10 @@ void MaintenanceManager::RunSchedulerThread() {
     // Run the maintenance operation.
     Status s = thread_pool_->SubmitFunc(std::bind(&MaintenanceManager::LaunchOp, this, op));
     CHECK(s.ok());
+
+    // Several ops could run concurrently, so look for the next one right away while there are
+    // free threads.
+    wait = running_ops_ >= static_cast<uint64_t>(num_threads_);
   }
 }
 
@@ -243,11 +272,15 @@ void MaintenanceManager::RunSchedulerThread() {
 // - If there's an Op that we can run quickly that frees log retention, we run it.
 // - If we've hit the overall process memory limit (note: this includes memory that the Ops cannot
 //   free), we run the Op with the highest RAM usage.
-// - If there are Ops that retain logs, we run the one that has the highest retention (and if many
-//   qualify, then we run the one that also frees up the most RAM).
+// - If there are Ops that retain logs, we run the one that has the highest retention per
+//   millisecond of its measured duration (and if many qualify, then we run the one that also frees
+//   up the most RAM).
 // - Finally, if there's nothing else that we really need to do, we run the Op that will improve
 //   performance the most.
 //
+// HIGH_IO_USAGE Ops are skipped while --maintenance_manager_max_concurrent_high_io_ops of them are
+// running, so the remaining threads are left to the cheap Ops.
+//
 // The reason it's done this way is that we want to prioritize limiting the amount of resources we
 // hold on to. Low IO Ops go first since we can quickly run them, then we can look at memory usage.
 // Reversing those can starve the low IO Ops when the system is under intense memory pressure.
@@ -262,13 +295,18 @@ MaintenanceOp* MaintenanceManager::FindBestOp() {
   TRACE_EVENT0("maintenance", "MaintenanceManager::FindBestOp");
   if (!FLAGS_enable_maintenance_manager) {
     VLOG_AND_TRACE("maintenance", 1) << "Maintenance manager is disabled. Doing nothing";
+    last_decision_ = "Maintenance manager is disabled";
     return nullptr;
   }
   size_t free_threads = num_threads_ - running_ops_;
   if (free_threads == 0) {
     VLOG_AND_TRACE("maintenance", 1) << "there are no free threads, so we can't run anything.";
+    last_decision_ = "No free threads";
     return nullptr;
   }
+  const auto max_high_io_ops = FLAGS_maintenance_manager_max_concurrent_high_io_ops;
+  const bool high_io_allowed =
+      max_high_io_ops <= 0 || running_high_io_ops_ < static_cast<uint64_t>(max_high_io_ops);
 
   int64_t low_io_most_logs_retained_bytes = 0;
   MaintenanceOp* low_io_most_logs_retained_bytes_op = nullptr;
@@ -277,6 +315,7 @@ MaintenanceOp* MaintenanceManager::FindBestOp() {
   MaintenanceOp* most_mem_anchored_op = nullptr;
 
   int64_t most_logs_retained_bytes = 0;
+  double most_logs_retained_per_ms = 0;
   int64_t most_logs_retained_bytes_ram_anchored = 0;
   MaintenanceOp* most_logs_retained_bytes_op = nullptr;
 
@@ -291,6 +330,9 @@ MaintenanceOp* MaintenanceManager::FindBestOp() {
     if (!stats.valid() || !stats.runnable()) {
       continue;
     }
+    if (!high_io_allowed && op->io_usage_ == MaintenanceOp::HIGH_IO_USAGE) {
+      continue;
+    }
     if (stats.logs_retained_bytes() > low_io_most_logs_retained_bytes &&
         op->io_usage_ == MaintenanceOp::LOW_IO_USAGE) {
       low_io_most_logs_retained_bytes_op = op;
@@ -301,15 +343,18 @@ MaintenanceOp* MaintenanceManager::FindBestOp() {
       most_mem_anchored_op = op;
       most_mem_anchored = stats.ram_anchored();
     }
-    // We prioritize ops that can free more logs, but when it's the same we pick the one that
-    // also frees up the most memory.
-    if (stats.logs_retained_bytes() > 0 &&
-        (stats.logs_retained_bytes() > most_logs_retained_bytes ||
-            (stats.logs_retained_bytes() == most_logs_retained_bytes &&
-                stats.ram_anchored() > most_logs_retained_bytes_ram_anchored))) {
-      most_logs_retained_bytes_op = op;
-      most_logs_retained_bytes = stats.logs_retained_bytes();
-      most_logs_retained_bytes_ram_anchored = stats.ram_anchored();
+    // We prioritize ops that can free more logs per unit of their cost, but when it's the same we
+    // pick the one that also frees up the most memory.
+    if (stats.logs_retained_bytes() > 0) {
+      const double logs_retained_per_ms = stats.logs_retained_bytes() / EstimatedCostMs(*op);
+      if (logs_retained_per_ms > most_logs_retained_per_ms ||
+          (logs_retained_per_ms == most_logs_retained_per_ms &&
+              stats.ram_anchored() > most_logs_retained_bytes_ram_anchored)) {
+        most_logs_retained_bytes_op = op;
+        most_logs_retained_bytes = stats.logs_retained_bytes();
+        most_logs_retained_per_ms = logs_retained_per_ms;
+        most_logs_retained_bytes_ram_anchored = stats.ram_anchored();
+      }
     }
     if ((!best_perf_improvement_op) ||
         (stats.perf_improvement() > best_perf_improvement)) {
@@ -326,6 +371,9 @@ MaintenanceOp* MaintenanceManager::FindBestOp() {
                     << "because it can free up more logs "
                     << "at " << low_io_most_logs_retained_bytes
                     << " bytes with a low IO cost";
+      last_decision_ = Substitute(
+          "$0 frees $1 bytes of logs with a low IO cost",
+          low_io_most_logs_retained_bytes_op->name(), low_io_most_logs_retained_bytes);
       return low_io_most_logs_retained_bytes_op;
     }
   }
@@ -339,11 +387,15 @@ MaintenanceOp* MaintenanceManager::FindBestOp() {
           "(current capacity is %.2f%%).  However, there are no ops currently "
           "runnable which would free memory.", capacity_pct);
       LOG(INFO) << msg;
+      last_decision_ = msg;
       return nullptr;
     }
     VLOG_AND_TRACE("maintenance", 1) << "we have exceeded our soft memory limit "
             << "(current capacity is " << capacity_pct << "%).  Running the op "
             << "which anchors the most memory: " << most_mem_anchored_op->name();
+    last_decision_ = Substitute(
+        "Soft memory limit exceeded (at $0% of capacity), $1 anchors the most memory: $2 bytes",
+        capacity_pct, most_mem_anchored_op->name(), most_mem_anchored);
     return most_mem_anchored_op;
   }
 
@@ -352,6 +404,10 @@ MaintenanceOp* MaintenanceManager::FindBestOp() {
             << "Performing " << most_logs_retained_bytes_op->name() << ", "
             << "because it can free up more logs " << "at " << most_logs_retained_bytes
             << " bytes";
+    last_decision_ = Substitute(
+        "$0 frees the most logs per ms of its cost: $1 bytes in $2 ms",
+        most_logs_retained_bytes_op->name(), most_logs_retained_bytes,
+        EstimatedCostMs(*most_logs_retained_bytes_op));
     return most_logs_retained_bytes_op;
   }
 
@@ -360,12 +416,22 @@ MaintenanceOp* MaintenanceManager::FindBestOp() {
       VLOG_AND_TRACE("maintenance", 1) << "Performing " << best_perf_improvement_op->name() << ", "
                  << "because it had the best perf_improvement score, "
                  << "at " << best_perf_improvement;
+      last_decision_ = Substitute(
+          "$0 has the best perf improvement: $1", best_perf_improvement_op->name(),
+          best_perf_improvement);
       return best_perf_improvement_op;
     }
   }
+  last_decision_ = "No maintenance operations look worth doing";
   return nullptr;
 }
 
+double MaintenanceManager::EstimatedCostMs(const MaintenanceOp& op) const {
+  // Ops that have not finished yet are expected to be cheap, so they get a chance to be measured.
+  // The cost is never below 1ms, so instant ops do not get an infinite score.
+  return std::max(op.average_duration_ms_, 1.0);
+}
+
 void MaintenanceManager::LaunchOp(MaintenanceOp* op) {
   MonoTime start_time(MonoTime::Now());
   op->RunningGauge()->Increment();
@@ -386,7 +452,17 @@ void MaintenanceManager::LaunchOp(MaintenanceOp* op) {
   completed_ops_count_++;
 
   op->DurationHistogram()->Increment(delta.ToMilliseconds());
+  const double duration_ms = delta.ToSeconds() * 1000;
+  if (op->average_duration_ms_ < 0) {
+    op->average_duration_ms_ = duration_ms;
+  } else {
+    op->average_duration_ms_ += FLAGS_maintenance_manager_duration_decay *
+                                (duration_ms - op->average_duration_ms_);
+  }
 
+  if (op->io_usage_ == MaintenanceOp::HIGH_IO_USAGE) {
+    running_high_io_ops_--;
+  }
   running_ops_--;
   op->running_--;
   op->cond_->Signal();
@@ -396,6 +472,7 @@ void MaintenanceManager::GetMaintenanceManagerStatusDump(MaintenanceManagerStatu
   DCHECK(out_pb != nullptr);
   std::lock_guard<Mutex> guard(lock_);
   MaintenanceOp* best_op = FindBestOp();
+  out_pb->set_last_decision(last_decision_);
   for (MaintenanceManager::OpMapTy::value_type& val : ops_) {
     MaintenanceManagerStatusPB_MaintenanceOpPB* op_pb = out_pb->add_registered_operations();
     MaintenanceOp* op(val.first);
@@ -413,6 +490,9 @@ void MaintenanceManager::GetMaintenanceManagerStatusDump(MaintenanceManagerStatu
       op_pb->set_logs_retained_bytes(0);
       op_pb->set_perf_improvement(0);
     }
+    if (op->average_duration_ms_ >= 0) {
+      op_pb->set_average_duration_millis(op->average_duration_ms_);
+    }
 
     if (best_op == op) {
       out_pb->mutable_best_op()->CopyFrom(*op_pb);
@@ -192,6 +192,10 @@ class MaintenanceOp {
 
   IOUsage io_usage() const { return io_usage_; }
 
+  // Average duration of the finished runs of this op, used by the scheduler as its cost.
+  // Negative until the op has finished at least once.
+  double average_duration_ms() const { return average_duration_ms_; }
+
  private:
   // The name of the operation.  Op names must be unique.
   const std::string name_;
@@ -211,6 +215,9 @@ class MaintenanceOp {
 
   IOUsage io_usage_;
 
+  // Exponentially weighted average of the op durations, protected by the MaintenanceManager lock.
+  double average_duration_ms_ = -1;
+
   DISALLOW_COPY_AND_ASSIGN(MaintenanceOp);
 };
 
@@ -261,6 +268,7 @@ class MaintenanceManager : public std::enable_shared_from_this<MaintenanceManage
 
  private:
   FRIEND_TEST(MaintenanceManagerTest, TestLogRetentionPrioritization);
+  FRIEND_TEST(MaintenanceManagerTest, TestHighIoOpsLimit);
   typedef std::map<MaintenanceOp*, MaintenanceOpStats,
           MaintenanceOpComparator> OpMapTy;
 
@@ -269,6 +277,10 @@ class MaintenanceManager : public std::enable_shared_from_this<MaintenanceManage
   // find the best op, or null if there is nothing we want to run
   MaintenanceOp* FindBestOp();
 
+  // Cost of running op used to compare its benefit with the other ops, i.e. its measured average
+  // duration.
+  double EstimatedCostMs(const MaintenanceOp& op) const;
+
   void LaunchOp(MaintenanceOp* op);
 
   const int32_t num_threads_;
@@ -279,6 +291,11 @@ class MaintenanceManager : public std::enable_shared_from_this<MaintenanceManage
   ConditionVariable cond_;
   bool shutdown_;
   uint64_t running_ops_;
+  // Number of running HIGH_IO_USAGE ops, limited by
+  // --maintenance_manager_max_concurrent_high_io_ops.
+  uint64_t running_high_io_ops_ = 0;
+  // Why FindBestOp picked its last op, or why it picked nothing.
+  std::string last_decision_;
   int32_t polling_interval_ms_;
   // Vector used as a circular buffer for recently completed ops. Elements need to be added at
   // the completed_ops_count_ % the vector's size and then the count needs to be incremented.
@@ -30,6 +30,9 @@
 // under the License.
 //
 
+#include <atomic>
+#include <deque>
+#include <thread>
 #include <vector>
 
 #include <boost/scope_exit.hpp>
@@ -321,5 +324,48 @@ TEST_F(MvccTest, WaitForSafeTime) {
   ASSERT_FALSE(manager_.SafeTime(ht3, MonoTime::Now() + 100ms, HybridTime::kMax));
 }
 
+// Safe time returned to concurrent readers, partially without locking, should never exceed hybrid
+// time of operations that are added later, and should not go back for any reader.
+TEST_F(MvccTest, ConcurrentSafeTime) {
+  constexpr int kNumReaders = 4;
+  constexpr int kNumOps = 10000;
+
+  std::atomic<bool> stop(false);
+  std::atomic<uint64_t> max_safe_time(HybridTime::kMin.ToUint64());
+  std::vector<std::thread> readers;
+  for (int i = 0; i != kNumReaders; ++i) {
+    readers.emplace_back([this, &stop, &max_safe_time] {
+      HybridTime last_safe_time = HybridTime::kMin;
+      while (!stop.load(std::memory_order_acquire)) {
+        auto safe_time = manager_.SafeTime();
+        ASSERT_GE(safe_time, last_safe_time);
+        last_safe_time = safe_time;
+        auto max_value = max_safe_time.load(std::memory_order_acquire);
+        while (max_value < safe_time.ToUint64() &&
+               !max_safe_time.compare_exchange_weak(max_value, safe_time.ToUint64())) {
+        }
+      }
+    });
+  }
+
+  std::deque<HybridTime> pending;
+  for (int i = 0; i != kNumOps; ++i) {
+    const HybridTime safe_time_before(max_safe_time.load(std::memory_order_acquire));
+    HybridTime ht;
+    manager_.AddPending(&ht);
+    ASSERT_GT(ht, safe_time_before);
+    pending.push_back(ht);
+    // Keep several operations in flight, so readers use published safe time.
+    while (pending.size() > 3 || (!pending.empty() && RandomUniformInt(0, 3) == 0)) {
+      manager_.Replicated(pending.front());
+      pending.pop_front();
+    }
+  }
+  stop.store(true, std::memory_order_release);
+  for (auto& reader : readers) {
+    reader.join();
+  }
+}
+
 } // namespace tablet
 } // namespace yb
@@ -32,6 +32,7 @@
 
 #include "yb/tablet/mvcc.h"
 
+#include "yb/util/continuous_profiler.h"
 #include "yb/util/logging.h"
 
 namespace yb {
@@ -39,7 +40,9 @@ namespace tablet {
 
 MvccManager::MvccManager(std::string prefix, server::ClockPtr clock)
     : prefix_(std::move(prefix)),
-      clock_(std::move(clock)) {}
+      clock_(std::move(clock)),
+      max_ht_lease_seen_(HybridTime::kMin.ToUint64()),
+      published_safe_time_(HybridTime::kInvalid.ToUint64()) {}
 
 void MvccManager::Replicated(HybridTime ht) {
   VLOG_WITH_PREFIX(1) << __func__ << "(" << ht << ")";
@@ -81,6 +84,12 @@ void MvccManager::PopFront(std::lock_guard<std::mutex>* lock) {
     queue_.pop_front();
     aborted_.pop();
   }
+  PublishSafeTime();
+}
+
+void MvccManager::PublishSafeTime() {
+  const auto safe_time = queue_.empty() ? HybridTime::kInvalid : queue_.front().Decremented();
+  published_safe_time_.store(safe_time.ToUint64(), std::memory_order_release);
 }
 
 void MvccManager::AddPending(HybridTime* ht) {
@@ -102,6 +111,9 @@ void MvccManager::AddPending(HybridTime* ht) {
   }
   CHECK_GT(*ht, last_replicated_) << LogPrefix();
   queue_.push_back(*ht);
+  if (queue_.size() == 1) {
+    PublishSafeTime();
+  }
 }
 
 void MvccManager::SetLastReplicated(HybridTime ht) {
@@ -155,10 +167,13 @@ HybridTime MvccManager::SafeTimeForFollower(
     result = std::max(propagated_safe_time_, last_replicated_);
     return result >= min_allowed;
   };
-  if (deadline == MonoTime::kMax) {
-    cond_.wait(lock, predicate);
-  } else if (!cond_.wait_until(lock, deadline.ToSteadyTimePoint(), predicate)) {
-    return HybridTime::kInvalid;
+  {
+    LockWaitRecorder wait_recorder;
+    if (deadline == MonoTime::kMax) {
+      cond_.wait(lock, predicate);
+    } else if (!cond_.wait_until(lock, deadline.ToSteadyTimePoint(), predicate)) {
+      return HybridTime::kInvalid;
+    }
   }
   VLOG_WITH_PREFIX(1) << "SafeTimeForFollower(" << min_allowed
                       << "), result = " << result;
@@ -170,10 +185,40 @@ HybridTime MvccManager::SafeTimeForFollower(
 HybridTime MvccManager::SafeTime(HybridTime min_allowed,
                                  MonoTime deadline,
                                  HybridTime ht_lease) const {
+  auto result = TryGetPublishedSafeTime(min_allowed, ht_lease);
+  if (result.is_valid()) {
+    return result;
+  }
   std::unique_lock<std::mutex> lock(mutex_);
   return DoGetSafeTime(min_allowed, deadline, ht_lease, &lock);
 }
 
+HybridTime MvccManager::TryGetPublishedSafeTime(HybridTime min_allowed,
+                                                HybridTime ht_lease) const {
+  const HybridTime result(published_safe_time_.load(std::memory_order_acquire));
+  // Published safe time is not greater than the result of DoGetSafeTime at the same moment, and
+  // it is at least last_replicated_. So it is enough to check the same requirements.
+  if (!result.is_valid() || result < min_allowed || result > ht_lease) {
+    return HybridTime::kInvalid;
+  }
+  // Lease is recorded, so later results limited by max_ht_lease_seen_ are not less than this one.
+  if (ht_lease.GetPhysicalValueMicros() < kMaxHybridTimePhysicalMicros) {
+    UpdateMaxHtLeaseSeen(ht_lease);
+  }
+  VLOG_WITH_PREFIX(2) << "SafeTime(" << min_allowed << ", " << ht_lease
+                      << "), published: " << result;
+  return result;
+}
+
+HybridTime MvccManager::UpdateMaxHtLeaseSeen(HybridTime ht_lease) const {
+  auto max_seen = max_ht_lease_seen_.load(std::memory_order_acquire);
+  const auto value = ht_lease.ToUint64();
+  while (max_seen < value &&
+         !max_ht_lease_seen_.compare_exchange_weak(max_seen, value, std::memory_order_acq_rel)) {
+  }
+  return HybridTime(std::max(max_seen, value));
+}
+
 HybridTime MvccManager::DoGetSafeTime(const HybridTime min_allowed,
                                       const MonoTime deadline,
                                       const HybridTime ht_lease,
@@ -183,13 +228,14 @@ HybridTime MvccManager::DoGetSafeTime(const HybridTime min_allowed,
   CHECK_LE(min_allowed, ht_lease) << LogPrefix();
 
   bool has_lease = false;
+  HybridTime max_ht_lease_seen = HybridTime::kMax;
   if (ht_lease.GetPhysicalValueMicros() < kMaxHybridTimePhysicalMicros) {
-    max_ht_lease_seen_ = std::max(ht_lease, max_ht_lease_seen_);
+    max_ht_lease_seen = UpdateMaxHtLeaseSeen(ht_lease);
     has_lease = true;
   }
 
   HybridTime result;
-  auto predicate = [this, &result, min_allowed, has_lease] {
+  auto predicate = [this, &result, min_allowed, has_lease, &max_ht_lease_seen] {
     if (queue_.empty()) {
       result = clock_->Now();
       CHECK_GE(result, min_allowed) << LogPrefix();
@@ -200,7 +246,8 @@ HybridTime MvccManager::DoGetSafeTime(const HybridTime min_allowed,
     }
 
     if (has_lease) {
-      result = std::min(result, max_ht_lease_seen_);
+      max_ht_lease_seen = HybridTime(max_ht_lease_seen_.load(std::memory_order_acquire));
+      result = std::min(result, max_ht_lease_seen);
     }
 
     // This function could be invoked at a follower, so it has a very old ht_lease. In this case it
@@ -212,10 +259,13 @@ HybridTime MvccManager::DoGetSafeTime(const HybridTime min_allowed,
 
   // In the case of an empty queue, the safe hybrid time to read at is only limited by hybrid time
   // ht_lease, which is by definition higher than min_allowed, so we would not get blocked.
-  if (deadline == MonoTime::kMax) {
-    cond_.wait(*lock, predicate);
-  } else if (!cond_.wait_until(*lock, deadline.ToSteadyTimePoint(), predicate)) {
-    return HybridTime::kInvalid;
+  {
+    LockWaitRecorder wait_recorder;
+    if (deadline == MonoTime::kMax) {
+      cond_.wait(*lock, predicate);
+    } else if (!cond_.wait_until(*lock, deadline.ToSteadyTimePoint(), predicate)) {
+      return HybridTime::kInvalid;
+    }
   }
   VLOG_WITH_PREFIX(1) << "DoGetSafeTime(" << min_allowed << ", "
                       << ht_lease << "), result = " << result;
@@ -224,7 +274,7 @@ HybridTime MvccManager::DoGetSafeTime(const HybridTime min_allowed,
                              : max_safe_time_returned_without_lease_) << LogPrefix()
       << "has_lease=" << has_lease
       << ", ht_lease=" << ht_lease
-      << ", max_ht_lease_seen_=" << max_ht_lease_seen_
+      << ", max_ht_lease_seen_=" << max_ht_lease_seen
       << ", last_replicated=" << last_replicated_
       << ", clock_->Now()=" << clock_->Now();
   if (has_lease) {
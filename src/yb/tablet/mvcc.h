@@ -32,6 +32,7 @@
 #ifndef YB_TABLET_MVCC_H_
 #define YB_TABLET_MVCC_H_
 
+#include <atomic>
 #include <condition_variable>
 #include <mutex>
 #include <deque>
@@ -97,6 +98,9 @@ class MvccManager {
   //
   // Returns invalid hybrid time in case it cannot satisfy provided requirements, for instance
   // because of timeout.
+  //
+  // While there are pending operations, the result is usually taken from the published safe time
+  // without locking the mutex, so reads don't contend with writes.
   HybridTime SafeTime(
       HybridTime min_allowed, MonoTime deadline, HybridTime ht_lease) const;
 
@@ -119,6 +123,16 @@ class MvccManager {
                            HybridTime ht_lease,
                            std::unique_lock<std::mutex>* lock) const;
 
+  // Returns safe time using the published safe time, or invalid hybrid time if it does not satisfy
+  // provided requirements, so the caller should fall back to DoGetSafeTime.
+  HybridTime TryGetPublishedSafeTime(HybridTime min_allowed, HybridTime ht_lease) const;
+
+  // Updates max_ht_lease_seen_ and returns its new value.
+  HybridTime UpdateMaxHtLeaseSeen(HybridTime ht_lease) const;
+
+  // Publishes safe time derived from the front of the queue. Should be called when it changes.
+  void PublishSafeTime();
+
   const std::string& LogPrefix() const { return prefix_; }
   void PopFront(std::lock_guard<std::mutex>* lock);
 
@@ -144,7 +158,13 @@ class MvccManager {
   // Because different calls that have current hybrid time leader lease as an argument can come to
   // us out of order, we might see an older value of hybrid time leader lease expiration after a
   // newer value. We mitigate this by always using the highest value we've seen.
-  mutable HybridTime max_ht_lease_seen_ = HybridTime::kMin;
+  // Atomic because it is also updated by lock free reads of the published safe time.
+  mutable std::atomic<uint64_t> max_ht_lease_seen_;
+
+  // Queue front decremented, or invalid hybrid time when the queue is empty. Updated under the
+  // mutex, but read without it. It is safe to read at this time, because all operations added
+  // later receive greater hybrid times.
+  std::atomic<uint64_t> published_safe_time_;
 
   mutable HybridTime max_safe_time_returned_with_lease_ = HybridTime::kMin;
   mutable HybridTime max_safe_time_returned_without_lease_ = HybridTime::kMin;
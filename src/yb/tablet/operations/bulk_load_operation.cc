@@ -0,0 +1,79 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#include "yb/tablet/operations/bulk_load_operation.h"
+
+#include <glog/logging.h>
+
+#include "yb/server/hybrid_clock.h"
+#include "yb/tablet/tablet.h"
+#include "yb/tserver/tserver.pb.h"
+#include "yb/util/trace.h"
+
+namespace yb {
+namespace tablet {
+
+using consensus::ReplicateMsg;
+using consensus::BULK_LOAD_OP;
+using consensus::DriverType;
+using strings::Substitute;
+
+string BulkLoadOperationState::ToString() const {
+  return Format("BulkLoadOperationState [hybrid_time=$0, load_id=$1]",
+                hybrid_time_even_if_unset(), request_ ? request_->load_id() : "<NULL>");
+}
+
+BulkLoadOperation::BulkLoadOperation(std::unique_ptr<BulkLoadOperationState> state,
+                                     DriverType type)
+    : Operation(std::move(state), type, OperationType::kBulkLoad) {
+}
+
+consensus::ReplicateMsgPtr BulkLoadOperation::NewReplicateMsg() {
+  auto result = std::make_shared<ReplicateMsg>();
+  result->set_op_type(BULK_LOAD_OP);
+  result->mutable_bulk_load_request()->CopyFrom(*state()->request());
+  return result;
+}
+
+Status BulkLoadOperation::Prepare() {
+  // Followers that miss the files fail to apply the operation, so at least the leader should not
+  // replicate a load that it does not have.
+  if (type() == consensus::LEADER) {
+    return state()->tablet()->CheckBulkLoadUploaded(state()->request()->load_id());
+  }
+  return Status::OK();
+}
+
+void BulkLoadOperation::DoStart() {
+  state()->TrySetHybridTimeFromClock();
+
+  TRACE("START BULK LOAD: hybrid time: $0",
+        server::HybridClock::GetPhysicalValueMicros(state()->hybrid_time()));
+}
+
+Status BulkLoadOperation::Apply() {
+  TRACE("APPLY BULK LOAD: started");
+
+  RETURN_NOT_OK(state()->tablet()->IngestBulkLoad(state()));
+
+  TRACE("APPLY BULK LOAD: finished");
+  return Status::OK();
+}
+
+string BulkLoadOperation::ToString() const {
+  return Substitute("BulkLoadOperation [state=$0]", state()->ToString());
+}
+
+}  // namespace tablet
+}  // namespace yb
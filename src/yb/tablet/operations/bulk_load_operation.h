@@ -0,0 +1,83 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#ifndef YB_TABLET_OPERATIONS_BULK_LOAD_OPERATION_H
+#define YB_TABLET_OPERATIONS_BULK_LOAD_OPERATION_H
+
+#include <string>
+
+#include "yb/gutil/macros.h"
+#include "yb/tablet/operations/operation.h"
+
+namespace yb {
+namespace tablet {
+
+class BulkLoadOperationState : public OperationState {
+ public:
+  explicit BulkLoadOperationState(Tablet* tablet,
+                                  const tserver::IngestBulkLoadRequestPB* request = nullptr)
+      : OperationState(tablet), request_(request) {}
+  ~BulkLoadOperationState() {}
+
+  const tserver::IngestBulkLoadRequestPB* request() const override { return request_; }
+
+  void UpdateRequestFromConsensusRound() override {
+    request_ = consensus_round()->replicate_msg()->mutable_bulk_load_request();
+  }
+
+  virtual std::string ToString() const override;
+
+ private:
+  // The original RPC request.
+  const tserver::IngestBulkLoadRequestPB *request_;
+
+  DISALLOW_COPY_AND_ASSIGN(BulkLoadOperationState);
+};
+
+// Ingests files of a bulk load, that were uploaded to each replica of the tablet beforehand. Only
+// the request is replicated, so the log record is small regardless of the size of the load.
+class BulkLoadOperation : public Operation {
+ public:
+  BulkLoadOperation(std::unique_ptr<BulkLoadOperationState> operation_state,
+                    consensus::DriverType type);
+
+  BulkLoadOperationState* state() override {
+    return down_cast<BulkLoadOperationState*>(Operation::state());
+  }
+
+  const BulkLoadOperationState* state() const override {
+    return down_cast<const BulkLoadOperationState*>(Operation::state());
+  }
+
+  consensus::ReplicateMsgPtr NewReplicateMsg() override;
+
+  // Checks that files of the load were uploaded to this replica.
+  CHECKED_STATUS Prepare() override;
+
+  // Executes an Apply for the bulk load transaction.
+  CHECKED_STATUS Apply() override;
+
+  std::string ToString() const override;
+
+ private:
+  // Starts the BulkLoadOperation by assigning it a timestamp.
+  void DoStart() override;
+
+  DISALLOW_COPY_AND_ASSIGN(BulkLoadOperation);
+};
+
+}  // namespace tablet
+}  // namespace yb
+
+#endif  // YB_TABLET_OPERATIONS_BULK_LOAD_OPERATION_H
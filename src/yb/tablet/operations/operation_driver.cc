@@ -40,6 +40,7 @@
 #include "yb/tablet/tablet.h"
 #include "yb/tablet/tablet_peer.h"
 #include "yb/tablet/operations/operation_tracker.h"
+#include "yb/tablet/operations/write_operation.h"
 #include "yb/util/debug-util.h"
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/logging.h"
@@ -97,6 +98,7 @@ Status OperationDriver::Init(std::unique_ptr<Operation> operation, DriverType ty
     replication_state_ = REPLICATING;
   } else {
     DCHECK_EQ(type, consensus::LEADER);
+    timeline_ = RequestTimeline::Current();
     if (consensus_) {  // sometimes NULL in tests
       // Unretained is required to avoid a refcount cycle.
       consensus::ReplicateMsgPtr replicate_msg = operation_->NewReplicateMsg();
@@ -158,6 +160,7 @@ void OperationDriver::ExecuteAsync() {
   }
 
   if (s.ok()) {
+    RecordPhase(RequestPhase::kSubmittedToPreparer);
     s = preparer_->Submit(this);
   }
 
@@ -209,6 +212,7 @@ Status OperationDriver::PrepareAndStart() {
   if (operation_) {
     RETURN_NOT_OK(operation_->Prepare());
   }
+  RecordPhase(RequestPhase::kPrepared);
 
   // Only take the lock long enough to take a local copy of the
   // replication state and set our prepare state. This ensures that
@@ -322,6 +326,20 @@ void OperationDriver::HandleFailure(const Status& s) {
 }
 
 void OperationDriver::ReplicationFinished(const Status& status) {
+  auto* apply_batch = OperationApplyBatch::Current();
+  if (apply_batch) {
+    bool prepared;
+    {
+      std::lock_guard<simple_spinlock> lock(lock_);
+      prepared = prepare_state_ == PREPARED;
+    }
+    // This operation will be applied by the prepare thread as soon as it is marked replicated, so
+    // batched operations preceding it should be written first.
+    if (!prepared) {
+      apply_batch->Flush();
+    }
+  }
+
   consensus::OpId op_id_local;
   {
     std::lock_guard<simple_spinlock> op_id_lock(opid_lock_);
@@ -343,6 +361,7 @@ void OperationDriver::ReplicationFinished(const Status& status) {
     CHECK_EQ(replication_state_, REPLICATING);
     if (status.ok()) {
       replication_state_ = REPLICATED;
+      RecordPhase(RequestPhase::kReplicated);
     } else {
       replication_state_ = REPLICATION_FAILED;
       operation_status_ = status;
@@ -417,17 +436,25 @@ void OperationDriver::ApplyTask() {
   }
 #endif
 
+  auto* apply_batch = OperationApplyBatch::Current();
+  if (apply_batch && apply_batch->Add(this)) {
+    return;
+  }
+
   // We need to ref-count ourself, since Commit() may run very quickly
   // and end up calling Finalize() while we're still in this code.
   scoped_refptr<OperationDriver> ref(this);
 
-  {
-    CHECK_OK(operation_->Apply());
+  CHECK_OK(operation_->Apply());
+  FinishApply();
+}
 
-    operation_->PreCommit();
+void OperationDriver::FinishApply() {
+  RecordPhase(RequestPhase::kApplied);
 
-    Finalize();
-  }
+  operation_->PreCommit();
+
+  Finalize();
 }
 
 void OperationDriver::Finalize() {
@@ -442,6 +469,69 @@ void OperationDriver::Finalize() {
 }
 
 
+////////////////////////////////////////////////////////////
+// OperationApplyBatch
+////////////////////////////////////////////////////////////
+
+namespace {
+
+thread_local OperationApplyBatch* current_apply_batch = nullptr;
+
+} // namespace
+
+OperationApplyBatch::OperationApplyBatch(size_t max_operations)
+    : max_operations_(max_operations) {
+  DCHECK(current_apply_batch == nullptr);
+  current_apply_batch = this;
+}
+
+OperationApplyBatch::~OperationApplyBatch() {
+  Flush();
+  current_apply_batch = nullptr;
+}
+
+OperationApplyBatch* OperationApplyBatch::Current() {
+  return current_apply_batch;
+}
+
+bool OperationApplyBatch::Add(OperationDriver* driver) {
+  const auto* operation = driver->operation_.get();
+  const bool batchable =
+      operation->type() == consensus::REPLICA &&
+      operation->operation_type() == OperationType::kWrite &&
+      !down_cast<const WriteOperationState*>(operation->state())->request()->write_batch()
+          .has_transaction();
+  if (!batchable) {
+    Flush();
+    return false;
+  }
+  drivers_.emplace_back(driver);
+  if (drivers_.size() >= max_operations_) {
+    Flush();
+  }
+  return true;
+}
+
+void OperationApplyBatch::Flush() {
+  if (drivers_.empty()) {
+    return;
+  }
+
+  std::vector<WriteOperationState*> states;
+  states.reserve(drivers_.size());
+  for (const auto& driver : drivers_) {
+    states.push_back(down_cast<WriteOperationState*>(driver->mutable_state()));
+  }
+  states.front()->tablet()->ApplyRowOperations(states);
+
+  // Drivers are released while being completed, so they are moved out of the batch first.
+  auto drivers = std::move(drivers_);
+  drivers_.clear();
+  for (const auto& driver : drivers) {
+    driver->FinishApply();
+  }
+}
+
 std::string OperationDriver::StateString(ReplicationState repl_state,
                                            PrepareState prep_state) {
   string state_str;
@@ -34,12 +34,14 @@
 #define YB_TABLET_OPERATIONS_OPERATION_DRIVER_H
 
 #include <string>
+#include <vector>
 
 #include "yb/consensus/consensus.h"
 #include "yb/gutil/ref_counted.h"
 #include "yb/gutil/walltime.h"
 #include "yb/tablet/operations/operation.h"
 #include "yb/util/status.h"
+#include "yb/util/request_timeline.h"
 #include "yb/util/trace.h"
 
 namespace yb {
@@ -211,6 +213,8 @@ class OperationDriver : public RefCountedThreadSafe<OperationDriver>,
 
  private:
   friend class RefCountedThreadSafe<OperationDriver>;
+  friend class OperationApplyBatch;
+
   enum ReplicationState {
     // The operation has not yet been sent to consensus for replication
     NOT_REPLICATING,
@@ -235,6 +239,12 @@ class OperationDriver : public RefCountedThreadSafe<OperationDriver>,
 
   ~OperationDriver() override {}
 
+  void RecordPhase(RequestPhase phase) {
+    if (timeline_) {
+      timeline_->Record(phase);
+    }
+  }
+
   // Starts operation, returns false is we should NOT continue processing the operation.
   bool StartOperation();
 
@@ -245,6 +255,9 @@ class OperationDriver : public RefCountedThreadSafe<OperationDriver>,
   // results from the Apply().
   void ApplyTask();
 
+  // Makes the applied operation visible and completes it.
+  void FinishApply();
+
   // Called on Operation::Apply() after the CommitMsg has been successfully
   // appended to the WAL.
   void Finalize();
@@ -288,6 +301,9 @@ class OperationDriver : public RefCountedThreadSafe<OperationDriver>,
   // Trace object for tracing any operations started by this driver.
   scoped_refptr<Trace> trace_;
 
+  // Timeline of the request that issued this leader operation, if any.
+  RequestTimelinePtr timeline_;
+
   const MonoTime start_time_;
 
   ReplicationState replication_state_;
@@ -305,6 +321,34 @@ class OperationDriver : public RefCountedThreadSafe<OperationDriver>,
   DISALLOW_COPY_AND_ASSIGN(OperationDriver);
 };
 
+// Collects non-transactional follower writes that are applied by the current thread, while a
+// single consensus update advances the committed index, so they are written to RocksDB with one
+// write batch. Operations are completed in order after the write, so MVCC and the safe time only
+// move past them once their data is in RocksDB. Any other operation flushes the batch before it is
+// applied.
+//
+// Only one batch per thread could exist, it is flushed and uninstalled by the destructor.
+class OperationApplyBatch {
+ public:
+  explicit OperationApplyBatch(size_t max_operations);
+  ~OperationApplyBatch();
+
+  // Returns the batch of the current thread, or nullptr if there is none.
+  static OperationApplyBatch* Current();
+
+  // Adds the operation that is ready to be applied, returns false if the operation could not be
+  // batched. In this case the batch is flushed, and the caller should apply it.
+  bool Add(OperationDriver* driver);
+
+  void Flush();
+
+ private:
+  const size_t max_operations_;
+  std::vector<scoped_refptr<OperationDriver>> drivers_;
+
+  DISALLOW_COPY_AND_ASSIGN(OperationApplyBatch);
+};
+
 }  // namespace tablet
 }  // namespace yb
 
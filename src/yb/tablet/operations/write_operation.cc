@@ -90,6 +90,7 @@ Status WriteOperation::Prepare() {
 void WriteOperation::DoStart() {
   TRACE("Start()");
   state()->tablet()->StartOperation(state());
+  state()->tablet()->PrepareWriteBatch(state());
 }
 
 // FIXME: Since this is called as a void in a thread-pool callback,
@@ -160,6 +161,14 @@ WriteOperationState::WriteOperationState(Tablet* tablet,
       response_(response) {
 }
 
+WriteOperationState::WriteOperationState(Tablet* tablet,
+                                         std::unique_ptr<tserver::WriteRequestPB> request,
+                                         tserver::WriteResponsePB *response)
+    : OperationState(tablet),
+      request_(request.release()),
+      response_(response) {
+}
+
 void WriteOperationState::Abort() {
   if (hybrid_time_.is_valid()) {
     tablet()->mvcc_manager()->Aborted(hybrid_time_);
@@ -92,6 +92,11 @@ class WriteOperationState : public OperationState {
   WriteOperationState(Tablet* tablet = nullptr,
                       const tserver::WriteRequestPB *request = nullptr,
                       tserver::WriteResponsePB *response = nullptr);
+
+  // Takes the ownership of the request instead of copying it.
+  WriteOperationState(Tablet* tablet,
+                      std::unique_ptr<tserver::WriteRequestPB> request,
+                      tserver::WriteResponsePB *response);
   virtual ~WriteOperationState();
 
   // Returns the original client request for this transaction, if there was
@@ -141,6 +146,15 @@ class WriteOperationState : public OperationState {
   // Releases all the DocDB locks acquired by this transaction.
   void ReleaseDocDbLocks(Tablet* tablet);
 
+  // RocksDB write batch encoded before the operation is applied, see Tablet::PrepareWriteBatch.
+  void set_prepared_write_batch(std::unique_ptr<rocksdb::WriteBatch> write_batch) {
+    prepared_write_batch_ = std::move(write_batch);
+  }
+
+  std::unique_ptr<rocksdb::WriteBatch> release_prepared_write_batch() {
+    return std::move(prepared_write_batch_);
+  }
+
   // Resets this OperationState, releasing all locks, destroying all prepared
   // writes, clearing the transaction result _and_ committing the current Mvcc
   // transaction.
@@ -169,6 +183,8 @@ class WriteOperationState : public OperationState {
   // or if an error happens.
   LockBatch docdb_locks_;
 
+  std::unique_ptr<rocksdb::WriteBatch> prepared_write_batch_;
+
   DISALLOW_COPY_AND_ASSIGN(WriteOperationState);
 };
 
@@ -30,6 +30,16 @@
 DEFINE_int32(max_group_replicate_batch_size, 16,
              "Maximum number of operations to submit to consensus for replication in a batch.");
 
+DEFINE_int32(max_group_replicate_small_write_batch_size, 0,
+             "When positive, consecutive small leader-side write operations are submitted to "
+             "consensus in batches of up to this many operations instead of "
+             "max_group_replicate_batch_size, so that many tiny independent writes share one "
+             "replication round. Zero disables write coalescing.");
+
+DEFINE_int32(small_write_max_bytes, 1024,
+             "Maximum size of a write request that is considered small for the purpose of "
+             "max_group_replicate_small_write_batch_size.");
+
 // We have to make the queue length really long. Otherwise we risk crashes on followers when they
 // fail to append entries to the queue, as we try to cancel the operation in that case, and it
 // is not possible to cancel an already-replicated operation. The proper way to handle that would
@@ -52,6 +62,19 @@ namespace tablet {
 // ------------------------------------------------------------------------------------------------
 // PreparerImpl
 
+namespace {
+
+bool IsSmallWrite(OperationDriver* item) {
+  if (FLAGS_max_group_replicate_small_write_batch_size <= 0 ||
+      item->operation_type() != OperationType::kWrite) {
+    return false;
+  }
+  const auto* request = item->state()->request();
+  return request != nullptr && request->ByteSize() <= FLAGS_small_write_max_bytes;
+}
+
+} // namespace
+
 class PreparerImpl {
  public:
   explicit PreparerImpl(consensus::Consensus* consensus, ThreadPool* tablet_prepare_pool);
@@ -90,6 +113,10 @@ class PreparerImpl {
 
   OperationDrivers leader_side_batch_;
 
+  // True if all operations in leader_side_batch_ are small writes, which lets the batch grow up to
+  // FLAGS_max_group_replicate_small_write_batch_size operations.
+  bool leader_side_batch_small_writes_ = true;
+
   std::unique_ptr<ThreadPoolToken> tablet_prepare_pool_token_;
 
   // A temporary buffer of rounds to replicate, used to reduce reallocation.
@@ -199,14 +226,24 @@ void PreparerImpl::ProcessItem(OperationDriver* item) {
                                   operation_type == OperationType::kEmpty;
     const int64_t bound_term = apply_separately ? -1 : item->consensus_round()->bound_term();
 
+    // Small writes are allowed to form larger batches, as long as the batch contains nothing else.
+    const bool small_write = !apply_separately && IsSmallWrite(item);
+    const size_t max_batch_size =
+        small_write && leader_side_batch_small_writes_
+            ? std::max(FLAGS_max_group_replicate_small_write_batch_size,
+                       FLAGS_max_group_replicate_batch_size)
+            : FLAGS_max_group_replicate_batch_size;
+
     // Don't add more than the max number of operations to a batch, and also don't add
     // operations bound to different terms, so as not to fail unrelated operations
     // unnecessarily in case of a bound term mismatch.
-    if (leader_side_batch_.size() >= FLAGS_max_group_replicate_batch_size ||
+    if (leader_side_batch_.size() >= max_batch_size ||
         !leader_side_batch_.empty() &&
             bound_term != leader_side_batch_.back()->consensus_round()->bound_term()) {
       ProcessAndClearLeaderSideBatch();
     }
+    leader_side_batch_small_writes_ =
+        (leader_side_batch_.empty() || leader_side_batch_small_writes_) && small_write;
     leader_side_batch_.push_back(item);
     if (apply_separately) {
       ProcessAndClearLeaderSideBatch();
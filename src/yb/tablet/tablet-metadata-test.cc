@@ -30,6 +30,8 @@
 // under the License.
 //
 
+#include <thread>
+
 #include <glog/logging.h>
 
 #include "yb/common/schema.h"
@@ -108,6 +110,32 @@ TEST_F(TestTabletMetadata, TestLoadFromSuperBlock) {
             << superblock_pb_1.DebugString();
 }
 
+// Concurrent flushes go through the group superblock writer and leave the latest superblock on
+// disk.
+TEST_F(TestTabletMetadata, TestConcurrentFlush) {
+  constexpr int kNumThreads = 8;
+  constexpr int kFlushesPerThread = 20;
+
+  TabletMetadata* meta = harness_->tablet()->metadata();
+  std::vector<std::thread> threads;
+  for (int i = 0; i != kNumThreads; ++i) {
+    threads.emplace_back([meta] {
+      for (int j = 0; j != kFlushesPerThread; ++j) {
+        ASSERT_OK(meta->Flush());
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  TabletSuperBlockPB in_memory;
+  ASSERT_OK(meta->ToSuperBlock(&in_memory));
+  TabletSuperBlockPB on_disk;
+  ASSERT_OK(meta->ReadSuperBlockFromDisk(&on_disk));
+  ASSERT_EQ(in_memory.SerializeAsString(), on_disk.SerializeAsString());
+}
+
 
 } // namespace tablet
 } // namespace yb
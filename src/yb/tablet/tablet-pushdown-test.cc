@@ -96,6 +96,9 @@ class TabletPushdownTest : public YBTabletTest {
 
     ASSERT_EQ(QLResponsePB::YQL_STATUS_OK, result.response.status())
         << "Error: " << result.response.error_message();
+    const auto& read_stats = result.response.read_stats();
+    ASSERT_EQ(11, read_stats.rows_returned());
+    ASSERT_GE(read_stats.rows_scanned(), read_stats.rows_returned());
 
     auto row_block = CreateRowBlock(QLClient::YQL_CLIENT_CQL, schema_, result.rows_data);
     std::vector<std::string> results;
@@ -45,6 +45,7 @@
 #include <boost/scope_exit.hpp>
 
 #include "yb/rocksdb/db.h"
+#include "yb/rocksdb/db/write_batch_internal.h"
 #include "yb/rocksdb/options.h"
 #include "yb/rocksdb/statistics.h"
 #include "yb/rocksdb/utilities/checkpoint.h"
@@ -58,6 +59,7 @@
 #include "yb/consensus/log_anchor_registry.h"
 #include "yb/consensus/opid_util.h"
 
+#include "yb/docdb/blob_storage.h"
 #include "yb/docdb/conflict_resolution.h"
 #include "yb/docdb/consensus_frontier.h"
 #include "yb/docdb/doc_rowwise_iterator.h"
@@ -65,6 +67,7 @@
 #include "yb/docdb/docdb.pb.h"
 #include "yb/docdb/docdb_compaction_filter.h"
 #include "yb/docdb/docdb_rocksdb_util.h"
+#include "yb/docdb/docdb_util.h"
 #include "yb/docdb/intent.h"
 #include "yb/docdb/primitive_value.h"
 #include "yb/docdb/lock_batch.h"
@@ -78,12 +81,14 @@
 #include "yb/rocksutil/yb_rocksdb_logger.h"
 #include "yb/server/hybrid_clock.h"
 
+#include "yb/tablet/checkpoint_delta.h"
 #include "yb/tablet/maintenance_manager.h"
 #include "yb/tablet/tablet_metrics.h"
 #include "yb/tablet/tablet_retention_policy.h"
 #include "yb/tablet/transaction_coordinator.h"
 #include "yb/tablet/transaction_participant.h"
 #include "yb/tablet/operations/alter_schema_operation.h"
+#include "yb/tablet/operations/bulk_load_operation.h"
 #include "yb/tablet/operations/truncate_operation.h"
 #include "yb/tablet/operations/write_operation.h"
 #include "yb/tablet/tablet_options.h"
@@ -91,13 +96,16 @@
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/enums.h"
 #include "yb/util/env.h"
+#include "yb/util/env_util.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/jsonwriter.h"
 #include "yb/util/locks.h"
 #include "yb/util/mem_tracker.h"
 #include "yb/util/metrics.h"
+#include "yb/util/path_util.h"
 #include "yb/util/slice.h"
 #include "yb/util/stopwatch.h"
+#include "yb/util/threadpool.h"
 #include "yb/util/trace.h"
 #include "yb/util/url-coding.h"
 
@@ -117,6 +125,72 @@ DEFINE_double(tablet_bloom_target_fp_rate, 0.01f,
               "required for bloom filters.");
 TAG_FLAG(tablet_bloom_target_fp_rate, advanced);
 
+DEFINE_bool(redis_use_hash_indexed_memtable, false,
+            "Whether Redis tables should use memtables hash indexed by the hashed part of "
+            "document key. Point reads of freshly written keys are faster, while scans have to "
+            "sort the memtable.");
+TAG_FLAG(redis_use_hash_indexed_memtable, advanced);
+
+DEFINE_int64(redis_history_compaction_exclusion_sec, 0,
+             "If positive, SST files of Redis tables whose newest record is older than this many "
+             "seconds are left out of automatic compactions, so immutable time series history is "
+             "not rewritten. Overwrites and deletes of such history are only reclaimed by full "
+             "compactions. Applied when the tablet is opened.");
+TAG_FLAG(redis_history_compaction_exclusion_sec, advanced);
+
+DEFINE_bool(tablet_prepare_write_batch_before_apply, false,
+            "Encode the RocksDB write batch of non-transactional writes in the prepare thread, "
+            "right after the hybrid time is picked, so that applying a committed write only "
+            "inserts the batch into the memtable. This pipelines write encoding with the serial "
+            "apply of earlier operations.");
+TAG_FLAG(tablet_prepare_write_batch_before_apply, advanced);
+
+DEFINE_bool(async_intents_cleanup, true,
+            "Delete intents of applied transactions in background, merging deletes of many "
+            "transactions into a single RocksDB write batch.");
+TAG_FLAG(async_intents_cleanup, advanced);
+
+DEFINE_int32(intents_cleanup_max_batch_transactions, 256,
+             "Max number of applied transactions whose intents are deleted by one background "
+             "write batch.");
+TAG_FLAG(intents_cleanup_max_batch_transactions, advanced);
+
+DEFINE_int32(intents_cleanup_max_pending_transactions, 10000,
+             "Max number of applied transactions per tablet that could wait for background "
+             "intents cleanup. When this limit is reached, intents are deleted by the apply "
+             "itself.");
+TAG_FLAG(intents_cleanup_max_pending_transactions, advanced);
+
+DEFINE_int32(import_rewrite_batch_size_bytes, 4 * 1024 * 1024,
+             "Size of write batches used to rewrite imported data that does not match the "
+             "partition of the tablet.");
+TAG_FLAG(import_rewrite_batch_size_bytes, advanced);
+
+DEFINE_int32(cache_hints_max_keys, 32,
+             "Maximum number of hot keys that the leader sends to followers in one cache hint, "
+             "and that a follower reads in the background to warm its block cache.");
+TAG_FLAG(cache_hints_max_keys, advanced);
+
+DEFINE_int32(docdb_recent_writes_cache_size, 1024,
+             "Number of key prefixes written by recently applied operations, whose generation "
+             "hybrid times are cached per tablet, so write operations updating the same documents "
+             "don't have to read them from RocksDB. 0 to disable. Applied when tablet is opened.");
+TAG_FLAG(docdb_recent_writes_cache_size, advanced);
+
+DEFINE_int64(ql_row_cache_size_bytes, 0,
+             "Size of the per tablet cache of rows read by point reads of non-transactional tables "
+             "without range key columns, so reads of hot rows don't have to read them from "
+             "RocksDB. 0 to disable. Applied when tablet is opened.");
+TAG_FLAG(ql_row_cache_size_bytes, advanced);
+
+DEFINE_bool(ql_accept_previous_schema_version, true,
+            "Whether QL reads and writes planned with the schema version before the last alter of "
+            "the tablet are executed with the current schema, when all columns they reference "
+            "exist in it. Otherwise requests that are in flight during ALTER TABLE fail with a "
+            "schema version mismatch and are retried by the client.");
+TAG_FLAG(ql_accept_previous_schema_version, advanced);
+TAG_FLAG(ql_accept_previous_schema_version, runtime);
+
 METRIC_DEFINE_entity(tablet);
 
 using namespace std::placeholders;
@@ -151,6 +225,18 @@ using yb::docdb::InitMarkerBehavior;
 namespace yb {
 namespace tablet {
 
+namespace {
+
+// Intents DB is stored in a subdirectory of regular RocksDB, so it is copied by remote bootstrap
+// and removed together with tablet data.
+const char* const kIntentsDBSubdir = "intents";
+
+string IntentsDBDir(const string& regular_db_dir) {
+  return JoinPathSegments(regular_db_dir, kIntentsDBSubdir);
+}
+
+} // namespace
+
 using yb::MaintenanceManager;
 using consensus::OpId;
 using consensus::MaximumOpId;
@@ -334,6 +420,11 @@ Tablet::Tablet(
 
   flush_stats_ = make_shared<TabletFlushStats>();
   tablet_options_.listeners.emplace_back(flush_stats_);
+
+  if (tablet_options_.intents_cleanup_pool) {
+    intents_cleanup_token_ = tablet_options_.intents_cleanup_pool->NewToken(
+        ThreadPool::ExecutionMode::SERIAL);
+  }
 }
 
 Tablet::~Tablet() {
@@ -364,12 +455,42 @@ Status Tablet::Open() {
 
 Status Tablet::OpenKeyValueTablet() {
   rocksdb::Options rocksdb_options;
-  docdb::InitRocksDBOptions(&rocksdb_options, tablet_id(), rocksdb_statistics_, tablet_options_);
+  // Bloom filter cannot cover more range components than keys of this table have. The number of
+  // range components is fixed when RocksDB is opened, so altered value is applied on reopen.
+  const size_t bloom_filter_range_components = std::min<size_t>(
+      schema()->table_properties().bloom_filter_range_components(),
+      schema()->num_range_key_columns());
+  docdb::InitRocksDBOptions(&rocksdb_options, tablet_id(), rocksdb_statistics_, tablet_options_,
+                            bloom_filter_range_components);
+  // Redis commands access a single key, so there is no need for an ordered memtable.
+  if (table_type_ == TableType::REDIS_TABLE_TYPE && FLAGS_redis_use_hash_indexed_memtable) {
+    docdb::UseHashIndexedMemTable(&rocksdb_options);
+  }
+  if (table_type_ == TableType::REDIS_TABLE_TYPE &&
+      FLAGS_redis_history_compaction_exclusion_sec > 0) {
+    docdb::ExcludeHistoryFromCompaction(
+        &rocksdb_options, MonoDelta::FromSeconds(FLAGS_redis_history_compaction_exclusion_sec));
+  }
 
   // Install the history cleanup handler. Note that TabletRetentionPolicy is going to hold a raw ptr
   // to this tablet. So, we ensure that rocksdb_ is reset before this tablet gets destroyed.
-  rocksdb_options.compaction_filter_factory = make_shared<DocDBCompactionFilterFactory>(
+  auto compaction_filter_factory = make_shared<DocDBCompactionFilterFactory>(
       make_shared<TabletRetentionPolicy>(this));
+  rocksdb_options.compaction_filter_factory = compaction_filter_factory;
+  // Counts history garbage of every SST file, so universal compaction could pick files with a lot
+  // of it, see --rocksdb_universal_compaction_garbage_ratio.
+  rocksdb_options.table_properties_collector_factories.push_back(
+      make_shared<docdb::DocDBTablePropertiesCollectorFactory>());
+
+  // Blob storage is also opened when new writes keep values inline, since existing records could
+  // still reference blob files.
+  const string blobs_dir = JoinPathSegments(metadata()->rocksdb_dir(), docdb::kBlobsSubdir);
+  if (docdb::BlobValuesEnabled() || metadata()->fs_manager()->env()->FileExists(blobs_dir)) {
+    blob_storage_ = make_shared<docdb::BlobStorage>(metadata()->fs_manager()->env(), blobs_dir);
+    rocksdb_options.listeners.push_back(blob_storage_);
+    rocksdb_options.table_properties_collector_factories.push_back(
+        make_shared<docdb::BlobRefsTablePropertiesCollectorFactory>(blob_storage_));
+  }
 
   auto mem_table_flush_filter_factory = [this] {
     if (mem_table_flush_filter_factory_) {
@@ -386,6 +507,18 @@ Status Tablet::OpenKeyValueTablet() {
   const string db_dir = metadata()->rocksdb_dir();
   LOG(INFO) << "Creating RocksDB database in dir " << db_dir;
 
+  recent_writes_ = FLAGS_docdb_recent_writes_cache_size > 0
+      ? std::make_unique<docdb::RecentWritesCache>(FLAGS_docdb_recent_writes_cache_size)
+      : nullptr;
+
+  row_cache_.reset();
+  if (table_type_ == TableType::YQL_TABLE_TYPE && FLAGS_ql_row_cache_size_bytes > 0) {
+    row_cache_ = std::make_unique<docdb::QLRowCache>(
+        FLAGS_ql_row_cache_size_bytes, mem_tracker_,
+        metrics_ ? metrics_->ql_row_cache_hits : nullptr,
+        metrics_ ? metrics_->ql_row_cache_misses : nullptr);
+  }
+
   // Create the directory table-uuid first.
   RETURN_NOT_OK_PREPEND(metadata()->fs_manager()->CreateDirIfMissing(DirName(db_dir)),
                         Substitute("Failed to create RocksDB table directory $0",
@@ -395,6 +528,10 @@ Status Tablet::OpenKeyValueTablet() {
                         Substitute("Failed to create RocksDB tablet directory $0",
                                    db_dir));
 
+  if (blob_storage_) {
+    RETURN_NOT_OK(blob_storage_->Open());
+  }
+
   LOG(INFO) << "Opening RocksDB at: " << db_dir;
   rocksdb::DB* db = nullptr;
   rocksdb::Status rocksdb_open_status = rocksdb::DB::Open(rocksdb_options, db_dir, &db);
@@ -407,11 +544,51 @@ Status Tablet::OpenKeyValueTablet() {
     return STATUS(IllegalState, rocksdb_open_status.ToString());
   }
   rocksdb_.reset(db);
+  compaction_filter_factory->SetDB(db);
   ql_storage_.reset(new docdb::QLRocksDBStorage(rocksdb_.get()));
+  LOG(INFO) << "Successfully opened a RocksDB database at " << db_dir << ", obj: " << db;
+
+  if (metadata_->schema().table_properties().is_transactional()) {
+    RETURN_NOT_OK(OpenIntentsDB(rocksdb_options));
+  }
   if (transaction_participant_) {
-    transaction_participant_->SetDB(db);
+    transaction_participant_->SetDB(intents_db());
+    // Until the index is rebuilt, conflict resolution reads intents from intents DB.
+    WARN_NOT_OK(transaction_participant_->intents_index()->Rebuild(intents_db()),
+                "Failed to rebuild intents index");
   }
-  LOG(INFO) << "Successfully opened a RocksDB database at " << db_dir << ", obj: " << db;
+  return Status::OK();
+}
+
+Status Tablet::OpenIntentsDB(rocksdb::Options options) {
+  // Intents are not versioned records, so history cleanup does not apply to them. Intents are
+  // deleted with SingleDelete right after apply, so most of them are dropped together with the
+  // original record in the memtable flush or first compactions.
+  options.compaction_filter_factory = nullptr;
+  options.table_properties_collector_factories.clear();
+  // Flush stats track both instances, because both are flushed by Tablet::Flush, but only flushes
+  // of regular RocksDB are counted.
+  options.listeners.erase(
+      std::remove(options.listeners.begin(), options.listeners.end(), flush_stats_),
+      options.listeners.end());
+  // Intents are small and transient, so they are always stored inline.
+  if (blob_storage_) {
+    options.listeners.erase(
+        std::remove(options.listeners.begin(), options.listeners.end(), blob_storage_),
+        options.listeners.end());
+  }
+
+  const string db_dir = IntentsDBDir(metadata()->rocksdb_dir());
+  LOG(INFO) << "Opening intents RocksDB at: " << db_dir;
+  rocksdb::DB* db = nullptr;
+  rocksdb::Status open_status = rocksdb::DB::Open(options, db_dir, &db);
+  if (!open_status.ok()) {
+    LOG(ERROR) << "Failed to open intents RocksDB in directory " << db_dir << ": "
+               << open_status.ToString();
+    delete db;
+    return STATUS(IllegalState, open_status.ToString());
+  }
+  intents_db_.reset(db);
   return Status::OK();
 }
 
@@ -437,14 +614,45 @@ void Tablet::Shutdown() {
     transaction_coordinator_->Shutdown();
   }
 
+  if (intents_cleanup_token_) {
+    intents_cleanup_token_->Shutdown();
+    // Queued cleanup task could be dropped by shutdown, so write the rest of the backlog here.
+    std::deque<IntentsCleanup> pending;
+    {
+      std::lock_guard<std::mutex> cleanup_lock(intents_cleanup_mutex_);
+      pending.swap(pending_intents_cleanup_);
+    }
+    if (rocksdb_ && !pending.empty()) {
+      WriteIntentsCleanup(pending.begin(), pending.end());
+    }
+  }
+
   std::lock_guard<rw_spinlock> lock(component_lock_);
   // Shutdown the RocksDB instance for this table, if present.
+  intents_db_.reset();
   rocksdb_.reset();
   state_ = kShutdown;
 }
 
 Result<std::unique_ptr<common::QLRowwiseIteratorIf>> Tablet::NewRowIterator(
-    const Schema &projection, const boost::optional<TransactionId>& transaction_id) const {
+    const Schema &projection, const boost::optional<TransactionId>& transaction_id,
+    const ReadHybridTime& read_time) const {
+  auto result = VERIFY_RESULT(CreateRowIterator(projection, transaction_id, read_time));
+  RETURN_NOT_OK(result->Init());
+  return std::unique_ptr<common::QLRowwiseIteratorIf>(std::move(result));
+}
+
+Result<std::unique_ptr<DocRowwiseIterator>> Tablet::NewRangeRowIterator(
+    const Schema& projection, const ReadHybridTime& read_time,
+    const DocKey& lower_bound, const DocKey& upper_bound) const {
+  auto result = VERIFY_RESULT(CreateRowIterator(projection, boost::none, read_time));
+  RETURN_NOT_OK(result->Init(lower_bound, upper_bound));
+  return std::move(result);
+}
+
+Result<std::unique_ptr<DocRowwiseIterator>> Tablet::CreateRowIterator(
+    const Schema &projection, const boost::optional<TransactionId>& transaction_id,
+    const ReadHybridTime& read_time) const {
   if (state_ != kOpen) {
     return STATUS_FORMAT(IllegalState, "Tablet in wrong state: $0", state_);
   }
@@ -462,11 +670,9 @@ Result<std::unique_ptr<common::QLRowwiseIteratorIf>> Tablet::NewRowIterator(
   RETURN_NOT_OK(schema()->GetMappedReadProjection(projection, mapped_projection.get()));
 
   auto txn_op_ctx = CreateTransactionOperationContext(transaction_id);
-  auto read_time = ReadHybridTime::SingleTime(HybridTime::kMax);
   auto result = std::make_unique<DocRowwiseIterator>(
       std::move(mapped_projection), *schema(), txn_op_ctx, rocksdb_.get(), read_time,
       &pending_op_counter_);
-  RETURN_NOT_OK(result->Init());
   return std::move(result);
 }
 
@@ -481,8 +687,40 @@ void Tablet::StartOperation(WriteOperationState* operation_state) {
   }
 }
 
+void Tablet::PrepareWriteBatch(WriteOperationState* operation_state) {
+  if (!FLAGS_tablet_prepare_write_batch_before_apply || log_only() ||
+      operation_state->request() == nullptr) {
+    return;
+  }
+  const auto& put_batch = operation_state->request()->write_batch();
+  // Values are moved to blob storage at apply, when the Raft index of the operation is known.
+  if (put_batch.has_transaction() || put_batch.kv_pairs_size() == 0 || blob_storage_) {
+    return;
+  }
+  auto write_batch = std::make_unique<WriteBatch>();
+  PrepareNonTransactionWriteBatch(put_batch, operation_state->hybrid_time(), write_batch.get());
+  operation_state->set_prepared_write_batch(std::move(write_batch));
+}
+
 void Tablet::ApplyRowOperations(WriteOperationState* operation_state) {
   last_committed_write_index_.store(operation_state->op_id().index(), std::memory_order_release);
+  auto prepared_write_batch = operation_state->release_prepared_write_batch();
+  if (prepared_write_batch) {
+    docdb::ConsensusFrontiers frontiers;
+    set_op_id({operation_state->op_id().term(), operation_state->op_id().index()}, &frontiers);
+    set_hybrid_time(operation_state->hybrid_time(), &frontiers);
+    prepared_write_batch->SetFrontiers(&frontiers);
+    WriteToRocksDB(prepared_write_batch.get(), operation_state->hybrid_time(), rocksdb_.get());
+    if (recent_writes_) {
+      recent_writes_->Applied(
+          operation_state->request()->write_batch(), operation_state->hybrid_time());
+    }
+    if (row_cache_) {
+      row_cache_->Applied(
+          operation_state->request()->write_batch(), operation_state->hybrid_time());
+    }
+    return;
+  }
   const KeyValueWriteBatchPB& put_batch =
       operation_state->consensus_round() && operation_state->consensus_round()->replicate_msg()
           // Online case.
@@ -496,6 +734,78 @@ void Tablet::ApplyRowOperations(WriteOperationState* operation_state) {
   ApplyKeyValueRowOperations(put_batch, &frontiers, operation_state->hybrid_time());
 }
 
+void Tablet::ApplyRowOperations(const std::vector<WriteOperationState*>& operation_states) {
+  DCHECK(!operation_states.empty());
+  const auto& first_state = *operation_states.front();
+  const auto& last_state = *operation_states.back();
+  last_committed_write_index_.store(last_state.op_id().index(), std::memory_order_release);
+  if (log_only()) {
+    return;
+  }
+
+  docdb::ConsensusFrontiers frontiers;
+  frontiers.Smallest().set_op_id(first_state.op_id());
+  frontiers.Smallest().set_hybrid_time(first_state.hybrid_time());
+  frontiers.Largest().set_op_id(last_state.op_id());
+  frontiers.Largest().set_hybrid_time(last_state.hybrid_time());
+
+  WriteBatch write_batch;
+  write_batch.SetFrontiers(&frontiers);
+  for (auto* operation_state : operation_states) {
+    auto prepared_write_batch = operation_state->release_prepared_write_batch();
+    if (prepared_write_batch) {
+      rocksdb::WriteBatchInternal::Append(&write_batch, prepared_write_batch.get());
+      continue;
+    }
+    const auto& put_batch = operation_state->request()->write_batch();
+    DCHECK(!put_batch.has_transaction());
+    PrepareNonTransactionWriteBatch(
+        put_batch, operation_state->hybrid_time(), &write_batch, blob_storage_.get(),
+        operation_state->op_id().index());
+  }
+  if (write_batch.Count() != 0) {
+    WriteToRocksDB(&write_batch, last_state.hybrid_time(), rocksdb_.get());
+  }
+  if (recent_writes_) {
+    for (auto* operation_state : operation_states) {
+      recent_writes_->Applied(
+          operation_state->request()->write_batch(), operation_state->hybrid_time());
+    }
+  }
+  if (row_cache_) {
+    for (auto* operation_state : operation_states) {
+      row_cache_->Applied(
+          operation_state->request()->write_batch(), operation_state->hybrid_time());
+    }
+  }
+}
+
+Status Tablet::AddCheckpointFiles(
+    const std::string& dir, const std::string& subdir,
+    google::protobuf::RepeatedPtrField<FilePB>* rocksdb_files) {
+  vector<rocksdb::Env::FileAttributes> files_attrs;
+  auto status = rocksdb_->GetEnv()->GetChildrenFileAttributes(dir, &files_attrs);
+  if (!status.ok()) {
+    return STATUS(IllegalState, Substitute("Unable to get RocksDB files in dir $0: $1", dir,
+                                           status.ToString()));
+  }
+
+  for (const auto& file_attrs : files_attrs) {
+    if (file_attrs.name == "." || file_attrs.name == ".." ||
+        (subdir.empty() &&
+            (file_attrs.name == kIntentsDBSubdir || file_attrs.name == docdb::kBlobsSubdir))) {
+      continue;
+    }
+    auto rocksdb_file_pb = rocksdb_files->Add();
+    rocksdb_file_pb->set_name(
+        subdir.empty() ? file_attrs.name : JoinPathSegments(subdir, file_attrs.name));
+    rocksdb_file_pb->set_size_bytes(file_attrs.size_bytes);
+    rocksdb_file_pb->set_inode(VERIFY_RESULT(
+        metadata_->fs_manager()->env()->GetFileINode(JoinPathSegments(dir, file_attrs.name))));
+  }
+  return Status::OK();
+}
+
 Status Tablet::CreateCheckpoint(const std::string& dir,
                                 google::protobuf::RepeatedPtrField<FilePB>* rocksdb_files) {
   ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
@@ -503,7 +813,20 @@ Status Tablet::CreateCheckpoint(const std::string& dir,
 
   std::lock_guard<std::mutex> lock(create_checkpoint_lock_);
 
+  // Blob files referenced by the checkpoint of regular RocksDB should not be deleted before they
+  // are linked to the checkpoint.
+  std::unique_lock<std::mutex> blob_gc_lock;
+  if (blob_storage_) {
+    blob_gc_lock = blob_storage_->PauseGarbageCollection();
+  }
+
   rocksdb::Status status = rocksdb::checkpoint::CreateCheckpoint(rocksdb_.get(), dir);
+  if (status.ok() && intents_db_) {
+    status = rocksdb::checkpoint::CreateCheckpoint(intents_db_.get(), IntentsDBDir(dir));
+  }
+  if (status.ok() && blob_storage_) {
+    status = blob_storage_->Checkpoint(JoinPathSegments(dir, docdb::kBlobsSubdir));
+  }
 
   if (!status.ok()) {
     LOG(WARNING) << "Create checkpoint status: " << status.ToString();
@@ -512,22 +835,13 @@ Status Tablet::CreateCheckpoint(const std::string& dir,
   LOG(INFO) << "Checkpoint created in " << dir;
 
   if (rocksdb_files != nullptr) {
-    vector<rocksdb::Env::FileAttributes> files_attrs;
-    status = rocksdb_->GetEnv()->GetChildrenFileAttributes(dir, &files_attrs);
-    if (!status.ok()) {
-      return STATUS(IllegalState, Substitute("Unable to get RocksDB files in dir $0: $1", dir,
-                                             status.ToString()));
+    RETURN_NOT_OK(AddCheckpointFiles(dir, std::string(), rocksdb_files));
+    if (intents_db_) {
+      RETURN_NOT_OK(AddCheckpointFiles(IntentsDBDir(dir), kIntentsDBSubdir, rocksdb_files));
     }
-
-    for (const auto& file_attrs : files_attrs) {
-      if (file_attrs.name == "." || file_attrs.name == "..") {
-        continue;
-      }
-      auto rocksdb_file_pb = rocksdb_files->Add();
-      rocksdb_file_pb->set_name(file_attrs.name);
-      rocksdb_file_pb->set_size_bytes(file_attrs.size_bytes);
-      rocksdb_file_pb->set_inode(VERIFY_RESULT(
-          metadata_->fs_manager()->env()->GetFileINode(JoinPathSegments(dir, file_attrs.name))));
+    if (blob_storage_) {
+      RETURN_NOT_OK(AddCheckpointFiles(
+          JoinPathSegments(dir, docdb::kBlobsSubdir), docdb::kBlobsSubdir, rocksdb_files));
     }
   }
 
@@ -536,6 +850,20 @@ Status Tablet::CreateCheckpoint(const std::string& dir,
   return Status::OK();
 }
 
+Status Tablet::CreateIncrementalCheckpoint(
+    const std::string& dir,
+    const google::protobuf::RepeatedPtrField<FilePB>& base_files,
+    CheckpointDeltaPB* delta,
+    google::protobuf::RepeatedPtrField<FilePB>* rocksdb_files) {
+  RETURN_NOT_OK(CreateCheckpoint(dir, rocksdb_files));
+  DiffCheckpointFiles(base_files, *rocksdb_files, delta);
+  RETURN_NOT_OK(ChecksumCheckpointDelta(metadata_->fs_manager()->env(), dir, delta));
+  LOG(INFO) << "Incremental checkpoint created in " << dir << ", "
+            << delta->added_files_size() << " added and " << delta->removed_files_size()
+            << " removed out of " << rocksdb_files->size() << " files";
+  return Status::OK();
+}
+
 void Tablet::PrepareTransactionWriteBatch(
     const KeyValueWriteBatchPB& put_batch,
     HybridTime hybrid_time,
@@ -551,7 +879,8 @@ void Tablet::PrepareTransactionWriteBatch(
 
   auto isolation_level = metadata->isolation;
   yb::docdb::PrepareTransactionWriteBatch(
-      put_batch, hybrid_time, rocksdb_write_batch, *transaction_id, isolation_level);
+      put_batch, hybrid_time, rocksdb_write_batch, *transaction_id, isolation_level,
+      transaction_participant()->intents_index());
 }
 
 void Tablet::ApplyKeyValueRowOperations(const KeyValueWriteBatchPB& put_batch,
@@ -565,27 +894,46 @@ void Tablet::ApplyKeyValueRowOperations(const KeyValueWriteBatchPB& put_batch,
     return;
   }
 
-  if (put_batch.kv_pairs_size() == 0 && rocksdb_write_batch->Count() == 0) {
+  if ((put_batch.kv_pairs_size() == 0 && rocksdb_write_batch->Count() == 0) || log_only()) {
     return;
   }
 
   rocksdb_write_batch->SetFrontiers(frontiers);
 
   if (put_batch.has_transaction()) {
+    // Transactional write batch contains only intents and transaction metadata.
     PrepareTransactionWriteBatch(put_batch, hybrid_time, rocksdb_write_batch);
+    WriteToRocksDB(rocksdb_write_batch, hybrid_time, intents_db());
   } else {
-    PrepareNonTransactionWriteBatch(put_batch, hybrid_time, rocksdb_write_batch);
+    // A blob file is kept until the flushed frontier passes the operations that wrote to it, so
+    // values are moved to blob storage only when the op id of the batch is known.
+    docdb::BlobStorage* blob_storage = frontiers ? blob_storage_.get() : nullptr;
+    const int64_t op_index = frontiers
+        ? down_cast<const docdb::ConsensusFrontier&>(frontiers->Largest()).op_id().index
+        : 0;
+    PrepareNonTransactionWriteBatch(
+        put_batch, hybrid_time, rocksdb_write_batch, blob_storage, op_index);
+    WriteToRocksDB(rocksdb_write_batch, hybrid_time, rocksdb_.get());
+    if (recent_writes_) {
+      recent_writes_->Applied(put_batch, hybrid_time);
+    }
+    if (row_cache_) {
+      row_cache_->Applied(put_batch, hybrid_time);
+    }
   }
+}
 
+void Tablet::WriteToRocksDB(
+    rocksdb::WriteBatch* write_batch, HybridTime hybrid_time, rocksdb::DB* dest_db) {
   // We are using Raft replication index for the RocksDB sequence number for
   // all members of this write batch.
   rocksdb::WriteOptions write_options;
   InitRocksDBWriteOptions(&write_options);
 
   flush_stats_->AboutToWriteToDb(hybrid_time);
-  auto rocksdb_write_status = rocksdb_->Write(write_options, rocksdb_write_batch);
+  auto rocksdb_write_status = dest_db->Write(write_options, write_batch);
   if (!rocksdb_write_status.ok()) {
-    LOG(FATAL) << "Failed to write a batch with " << rocksdb_write_batch->Count() << " operations"
+    LOG(FATAL) << "Failed to write a batch with " << write_batch->Count() << " operations"
                << " into RocksDB: " << rocksdb_write_status.ToString();
   }
 }
@@ -607,6 +955,30 @@ void SetupKeyValueBatch(WriteRequestPB* write_request, WriteRequestPB* batch_req
   }
 }
 
+bool HasColumn(const Schema& schema, int32_t column_id) {
+  return schema.find_column_by_id(ColumnId(column_id)) != Schema::kColumnNotFound;
+}
+
+bool HasReferencedColumns(const Schema& schema, const QLReferencedColumnsPB& column_refs) {
+  for (const auto* ids : {&column_refs.ids(), &column_refs.static_ids()}) {
+    for (int32_t column_id : *ids) {
+      if (!HasColumn(schema, column_id)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool HasWrittenColumns(const Schema& schema, const QLWriteRequestPB& req) {
+  for (const auto& column_value : req.column_values()) {
+    if (!HasColumn(schema, column_value.column_id())) {
+      return false;
+    }
+  }
+  return HasReferencedColumns(schema, req.column_refs());
+}
+
 } // namespace
 
 Status Tablet::KeyValueBatchFromRedisWriteBatch(const WriteOperationData& data) {
@@ -649,6 +1021,49 @@ Status Tablet::HandleRedisReadRequest(const ReadHybridTime& read_time,
   return Status::OK();
 }
 
+Status Tablet::HandleRedisReadRequests(
+    const ReadHybridTime& read_time,
+    const google::protobuf::RepeatedPtrField<RedisReadRequestPB>& redis_read_requests,
+    google::protobuf::RepeatedPtrField<RedisResponsePB>* responses) {
+  ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
+  RETURN_NOT_OK(scoped_read_operation);
+
+  ScopedTabletMetricsTracker metrics_tracker(metrics_->redis_read_latency);
+
+  const int count = redis_read_requests.size();
+  std::vector<docdb::KeyBytes> keys;
+  keys.reserve(count);
+  for (const auto& request : redis_read_requests) {
+    keys.push_back(docdb::DocKey::FromRedisKey(
+        request.key_value().hash_code(), request.key_value().key()).Encode());
+  }
+  std::vector<Slice> keys_for_filter;
+  keys_for_filter.reserve(count);
+  std::vector<int> order(count);
+  for (int i = 0; i < count; ++i) {
+    keys_for_filter.push_back(keys[i].AsSlice());
+    order[i] = i;
+  }
+  // Reading the keys in order lets consecutive reads share the blocks the iterator is positioned
+  // at instead of seeking back and forth.
+  std::sort(order.begin(), order.end(), [&keys](int lhs, int rhs) {
+    return keys[lhs].CompareTo(keys[rhs]) < 0;
+  });
+
+  auto iter = docdb::CreateIntentAwareIteratorForKeys(
+      rocksdb_.get(), keys_for_filter, reinterpret_cast<rocksdb::QueryId>(&redis_read_requests),
+      boost::none /* transaction_context */, read_time);
+  for (int i = 0; i < count; ++i) {
+    responses->Add();
+  }
+  for (const int idx : order) {
+    docdb::RedisReadOperation doc_op(redis_read_requests.Get(idx), rocksdb_.get(), read_time);
+    RETURN_NOT_OK(doc_op.Execute(iter.get()));
+    *responses->Mutable(idx) = std::move(doc_op.response());
+  }
+  return Status::OK();
+}
+
 Status Tablet::HandleQLReadRequest(
     const ReadHybridTime& read_time,
     const QLReadRequestPB& ql_read_request,
@@ -658,16 +1073,30 @@ Status Tablet::HandleQLReadRequest(
   RETURN_NOT_OK(scoped_read_operation);
   ScopedTabletMetricsTracker metrics_tracker(metrics_->ql_read_latency);
 
-  if (metadata()->schema_version() != ql_read_request.schema_version()) {
+  // Columns are stored by their ids, so a read planned with the previous schema version gets the
+  // same result with the current schema, unless it references a dropped column.
+  if (metadata_->schema_version() != ql_read_request.schema_version() &&
+      !(AcceptsPreviousSchemaVersion(ql_read_request.schema_version(), /* is_write */ false) &&
+        HasReferencedColumns(metadata_->schema(), ql_read_request.column_refs()))) {
     result->response.set_status(QLResponsePB::YQL_STATUS_SCHEMA_VERSION_MISMATCH);
     return Status::OK();
   }
 
+  // Range scans without the hash key are not attributed to any key.
+  if (ql_read_request.hashed_column_values_size() > 0 && HotKeySampler::ShouldSample()) {
+    vector<PrimitiveValue> hashed_components;
+    if (docdb::QLKeyColumnValuesToPrimitiveValues(
+            ql_read_request.hashed_column_values(), metadata_->schema(), 0,
+            metadata_->schema().num_hash_key_columns(), &hashed_components).ok()) {
+      RecordHotKey(docdb::DocKey(ql_read_request.hash_code(), hashed_components).Encode());
+    }
+  }
+
   Result<TransactionOperationContextOpt> txn_op_ctx =
       CreateTransactionOperationContext(transaction_metadata);
   RETURN_NOT_OK(txn_op_ctx);
   return AbstractTablet::HandleQLReadRequest(
-      read_time, ql_read_request, *txn_op_ctx, result);
+      read_time, ql_read_request, *txn_op_ctx, result, row_cache_.get());
 }
 
 CHECKED_STATUS Tablet::CreatePagingStateForRead(const QLReadRequestPB& ql_read_request,
@@ -730,10 +1159,12 @@ Status Tablet::KeyValueBatchFromQLWriteBatch(const WriteOperationData& data) {
   for (size_t i = 0; i < ql_write_batch->size(); i++) {
     QLWriteRequestPB* req = ql_write_batch->Mutable(i);
     QLResponsePB* resp = data.operation_state->response()->add_ql_response_batch();
-    if (metadata_->schema_version() != req->schema_version()) {
+    const auto& schema = metadata_->schema();
+    if (metadata_->schema_version() != req->schema_version() &&
+        !(AcceptsPreviousSchemaVersion(req->schema_version(), /* is_write */ true) &&
+          HasWrittenColumns(schema, *req))) {
       resp->set_status(QLResponsePB::YQL_STATUS_SCHEMA_VERSION_MISMATCH);
     } else {
-      const auto& schema = metadata_->schema();
       auto write_op = std::make_unique<QLWriteOperation>(schema, *txn_op_ctx);
       RETURN_NOT_OK(write_op->Init(req, resp));
       doc_ops.emplace_back(std::move(write_op));
@@ -807,11 +1238,264 @@ Status Tablet::Flush(FlushMode mode) {
   rocksdb::FlushOptions options;
   options.wait = mode == FlushMode::kSync;
   rocksdb_->Flush(options);
+  if (intents_db_) {
+    intents_db_->Flush(options);
+    MaybeAdvanceIntentsFlushedFrontier();
+  }
+  return Status::OK();
+}
+
+Status Tablet::WarmUpTableReaders() {
+  TRACE_EVENT0("tablet", "Tablet::WarmUpTableReaders");
+  ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
+  RETURN_NOT_OK(scoped_read_operation);
+
+  RETURN_NOT_OK(rocksdb_->WarmUpTableReaders());
+  if (intents_db_) {
+    RETURN_NOT_OK(intents_db_->WarmUpTableReaders());
+  }
   return Status::OK();
 }
 
+uint64_t Tablet::ActiveMemTablesSize() const {
+  uint64_t result = 0;
+  for (auto* db : {rocksdb_.get(), intents_db_.get()}) {
+    uint64_t size = 0;
+    if (db && db->GetIntProperty(rocksdb::DB::Properties::kCurSizeActiveMemTable, &size)) {
+      result += size;
+    }
+  }
+  return result;
+}
+
+void Tablet::MaybeAdvanceIntentsFlushedFrontier() {
+  // Regular frontier is taken first. Operations up to it were applied before, so if there are no
+  // intents in memtables after that, all intents of those operations are in SSTables.
+  auto regular_frontier = rocksdb_->GetFlushedFrontier();
+  if (!regular_frontier) {
+    return;
+  }
+  uint64_t active_entries = 0, immutable_memtables = 0;
+  if (!intents_db_->GetIntProperty(
+          rocksdb::DB::Properties::kNumEntriesActiveMemTable, &active_entries) ||
+      !intents_db_->GetIntProperty(
+          rocksdb::DB::Properties::kNumImmutableMemTable, &immutable_memtables) ||
+      active_entries != 0 || immutable_memtables != 0) {
+    return;
+  }
+  const auto& regular_op_id =
+      down_cast<docdb::ConsensusFrontier*>(regular_frontier.get())->op_id();
+  auto intents_frontier = intents_db_->GetFlushedFrontier();
+  if (intents_frontier &&
+      down_cast<docdb::ConsensusFrontier*>(intents_frontier.get())->op_id().index >=
+          regular_op_id.index) {
+    return;
+  }
+  auto status = intents_db_->SetFlushedFrontier(regular_frontier->Clone());
+  LOG_IF(WARNING, !status.ok()) << "Failed to advance intents flushed frontier: " << status;
+}
+
 Status Tablet::ImportData(const std::string& source_dir) {
-  return rocksdb_->Import(source_dir);
+  // Imported records are not tracked by the recent writes cache.
+  if (recent_writes_) {
+    recent_writes_->Clear();
+  }
+  if (row_cache_) {
+    row_cache_->InvalidateAll(clock_->Now());
+  }
+  const auto& partition = metadata_->partition();
+  if (partition.partition_key_start().empty() && partition.partition_key_end().empty()) {
+    return rocksdb_->Import(source_dir);
+  }
+
+  // Hash partition keys are the encoded 16 bit hash, that follows kUInt16Hash in DocKeys.
+  const char hash_prefix = static_cast<char>(docdb::ValueType::kUInt16Hash);
+  const std::string lower_bound = partition.partition_key_start().empty()
+      ? std::string() : hash_prefix + partition.partition_key_start();
+  const std::string upper_bound = partition.partition_key_end().empty()
+      ? std::string() : hash_prefix + partition.partition_key_end();
+
+  rocksdb::Options options;
+  docdb::InitRocksDBOptions(&options, tablet_id(), nullptr /* statistics */, tablet_options_);
+  rocksdb::DB* db = nullptr;
+  RETURN_NOT_OK_PREPEND(rocksdb::DB::OpenForReadOnly(options, source_dir, &db),
+                        Format("Failed to open imported RocksDB at $0", source_dir));
+  std::unique_ptr<rocksdb::DB> source(db);
+
+  bool fits_partition = true;
+  {
+    std::unique_ptr<rocksdb::Iterator> iter(source->NewIterator(rocksdb::ReadOptions()));
+    iter->SeekToFirst();
+    if (iter->Valid() && iter->key().compare(lower_bound) < 0) {
+      fits_partition = false;
+    }
+    iter->SeekToLast();
+    if (iter->Valid() && !upper_bound.empty() && iter->key().compare(upper_bound) >= 0) {
+      fits_partition = false;
+    }
+    RETURN_NOT_OK(iter->status());
+  }
+  if (fits_partition) {
+    source.reset();
+    return rocksdb_->Import(source_dir);
+  }
+
+  auto* env = metadata_->fs_manager()->env();
+  RETURN_NOT_OK(env_util::CreateDirIfMissing(env, metadata_->bulk_load_dir()));
+  const auto dest_dir = BulkLoadDir(Format("import-$0", GetCurrentTimeMicros()));
+  const auto num_keys = RewriteImportedData(source.get(), lower_bound, upper_bound, dest_dir);
+  source.reset();
+
+  // Sequence numbers of rewritten files start from scratch, so they are ingested like a bulk load.
+  Status status = !num_keys.ok() ? num_keys.status()
+      : *num_keys == 0 ? Status::OK()
+      : rocksdb_->Ingest(dest_dir, nullptr /* flushed_frontier */);
+  WARN_NOT_OK(env->DeleteRecursively(dest_dir), "Failed to delete rewritten imported files");
+  return status;
+}
+
+Result<size_t> Tablet::RewriteImportedData(
+    rocksdb::DB* source, const std::string& lower_bound, const std::string& upper_bound,
+    const std::string& dest_dir) {
+  rocksdb::Options options;
+  docdb::InitRocksDBOptions(&options, tablet_id(), nullptr /* statistics */, tablet_options_);
+  options.create_if_missing = true;
+  options.error_if_exists = true;
+  // Import expects the manifest to only add files.
+  options.disable_auto_compactions = true;
+  rocksdb::DB* db = nullptr;
+  RETURN_NOT_OK_PREPEND(rocksdb::DB::Open(options, dest_dir, &db),
+                        Format("Failed to create RocksDB for rewritten import at $0", dest_dir));
+  std::unique_ptr<rocksdb::DB> dest(db);
+
+  rocksdb::WriteOptions write_options;
+  write_options.disableWAL = true;
+  rocksdb::WriteBatch batch;
+  size_t num_keys = 0;
+  std::unique_ptr<rocksdb::Iterator> iter(source->NewIterator(rocksdb::ReadOptions()));
+  for (iter->Seek(lower_bound); iter->Valid(); iter->Next()) {
+    if (!upper_bound.empty() && iter->key().compare(upper_bound) >= 0) {
+      break;
+    }
+    batch.Put(iter->key(), iter->value());
+    ++num_keys;
+    if (batch.GetDataSize() >= FLAGS_import_rewrite_batch_size_bytes) {
+      RETURN_NOT_OK(dest->Write(write_options, &batch));
+      batch.Clear();
+    }
+  }
+  RETURN_NOT_OK(iter->status());
+  if (batch.Count() != 0) {
+    RETURN_NOT_OK(dest->Write(write_options, &batch));
+  }
+  RETURN_NOT_OK(dest->Flush(rocksdb::FlushOptions()));
+
+  LOG(INFO) << "Tablet " << tablet_id() << ": rewrote " << num_keys << " imported keys in ["
+            << Slice(lower_bound).ToDebugHexString() << ", "
+            << Slice(upper_bound).ToDebugHexString() << ") to " << dest_dir;
+  return num_keys;
+}
+
+namespace {
+
+// Names come from the client, so they should not escape the bulk load directory.
+Status CheckBulkLoadName(const std::string& name, const char* what) {
+  if (name.empty() || name == "." || name == ".." || name.find('/') != std::string::npos) {
+    return STATUS_FORMAT(InvalidArgument, "Bad bulk load $0: $1", what, name);
+  }
+  return Status::OK();
+}
+
+} // namespace
+
+std::string Tablet::BulkLoadDir(const std::string& load_id) const {
+  return JoinPathSegments(metadata_->bulk_load_dir(), load_id);
+}
+
+Status Tablet::UploadBulkLoadFile(const std::string& load_id,
+                                  const std::string& file_name,
+                                  uint64_t offset,
+                                  const Slice& data) {
+  RETURN_NOT_OK(CheckBulkLoadName(load_id, "load id"));
+  RETURN_NOT_OK(CheckBulkLoadName(file_name, "file name"));
+  auto* env = metadata_->fs_manager()->env();
+  const auto dir = BulkLoadDir(load_id);
+  RETURN_NOT_OK(env_util::CreateDirIfMissing(env, metadata_->bulk_load_dir()));
+  RETURN_NOT_OK(env_util::CreateDirIfMissing(env, dir));
+
+  const auto path = JoinPathSegments(dir, file_name);
+  WritableFileOptions options;
+  if (offset != 0) {
+    // Chunks are appended, so a chunk that was lost or resent is detected here, and the client
+    // restarts the upload of the file.
+    const auto size = env->FileExists(path) ? VERIFY_RESULT(env->GetFileSize(path)) : 0;
+    if (size != offset) {
+      return STATUS_FORMAT(IllegalState, "Chunk of $0 at offset $1, while $2 bytes uploaded",
+                           file_name, offset, size);
+    }
+    options.mode = Env::OPEN_EXISTING;
+  }
+  gscoped_ptr<WritableFile> file;
+  RETURN_NOT_OK(env->NewWritableFile(options, path, &file));
+  RETURN_NOT_OK(file->Append(data));
+  return file->Close();
+}
+
+Status Tablet::CheckBulkLoadUploaded(const std::string& load_id) {
+  RETURN_NOT_OK(CheckBulkLoadName(load_id, "load id"));
+  const auto dir = BulkLoadDir(load_id);
+  if (!metadata_->fs_manager()->env()->FileExists(dir)) {
+    return STATUS_FORMAT(NotFound, "Files of bulk load $0 were not uploaded to $1",
+                         load_id, dir);
+  }
+  return Status::OK();
+}
+
+Status Tablet::IngestBulkLoad(BulkLoadOperationState* state) {
+  const auto& request = *state->request();
+  // Both hybrid times are replicated, so all replicas make the same decision here.
+  const HybridTime load_hybrid_time(request.load_hybrid_time());
+  if (!load_hybrid_time.is_valid() || load_hybrid_time >= state->hybrid_time()) {
+    return STATUS_FORMAT(InvalidArgument, "Bulk load $0 written at $1 ingested at $2",
+                         request.load_id(), load_hybrid_time, state->hybrid_time());
+  }
+  RETURN_NOT_OK(CheckBulkLoadUploaded(request.load_id()));
+
+  auto op_pause = PauseReadWriteOperations();
+  RETURN_NOT_OK(op_pause);
+
+  // Check if tablet is in shutdown mode.
+  if (IsShutdownRequested()) {
+    return STATUS(IllegalState, "Tablet was shut down");
+  }
+
+  // Uploaded files are linked to RocksDB, so make them durable before it refers to them.
+  auto* env = metadata_->fs_manager()->env();
+  const auto dir = BulkLoadDir(request.load_id());
+  std::vector<std::string> files;
+  RETURN_NOT_OK(env->GetChildren(dir, ExcludeDots::kTrue, &files));
+  for (const auto& file_name : files) {
+    WritableFileOptions options;
+    options.mode = Env::OPEN_EXISTING;
+    gscoped_ptr<WritableFile> file;
+    RETURN_NOT_OK(env->NewWritableFile(options, JoinPathSegments(dir, file_name), &file));
+    RETURN_NOT_OK(file->Sync());
+    RETURN_NOT_OK(file->Close());
+  }
+
+  // The operation becomes flushed together with the files, so it is not replayed by bootstrap.
+  docdb::ConsensusFrontier frontier;
+  frontier.set_op_id({state->op_id().term(), state->op_id().index()});
+  frontier.set_hybrid_time(state->hybrid_time());
+  RETURN_NOT_OK(rocksdb_->Ingest(dir, frontier.Clone()));
+  if (row_cache_) {
+    row_cache_->InvalidateAll(state->hybrid_time());
+  }
+
+  LOG(INFO) << "Tablet " << tablet_id() << ": ingested bulk load " << request.load_id() << " of "
+            << files.size() << " files, written at " << load_hybrid_time;
+  WARN_NOT_OK(env->DeleteRecursively(dir), "Failed to delete ingested bulk load files");
+  return Status::OK();
 }
 
 #define INTENT_VALUE_SCHECK(lhs, op, rhs, msg) \
@@ -826,16 +1510,26 @@ Status Tablet::ImportData(const std::string& source_dir) {
 // We apply intents using by iterating over whole transaction reverse index.
 // Using value of reverse index record we find original intent record and apply it.
 // After that we delete both intent record and reverse index record.
-// TODO(dtxn) use separate thread for applying intents.
+// Deletes are usually postponed to the background cleanup, that merges deletes of many
+// transactions into one write batch. Intents and reverse index records are written exactly once,
+// so they are removed with SingleDelete, that is dropped together with the original record during
+// flush or compaction instead of leaving a tombstone.
+// Committed intents that are not deleted yet are still resolved by readers using local commit
+// time, so postponing the cleanup does not affect visible data.
 // TODO(dtxn) use multiple batches when applying really big transaction.
 Status Tablet::ApplyIntents(const TransactionApplyData& data) {
+  if (log_only()) {
+    // Intents are not written on a log-only replica, so there is nothing to apply.
+    return Status::OK();
+  }
+
   auto reverse_index_iter = docdb::CreateRocksDBIterator(
-      rocksdb_.get(),
+      intents_db(),
       docdb::BloomFilterMode::DONT_USE_BLOOM_FILTER,
       boost::none,
       rocksdb::kDefaultQueryId);
 
-  auto intent_iter = docdb::CreateRocksDBIterator(rocksdb_.get(),
+  auto intent_iter = docdb::CreateRocksDBIterator(intents_db(),
                                                   docdb::BloomFilterMode::DONT_USE_BLOOM_FILTER,
                                                   boost::none,
                                                   rocksdb::kDefaultQueryId);
@@ -847,6 +1541,11 @@ Status Tablet::ApplyIntents(const TransactionApplyData& data) {
   reverse_index_iter->Seek(txn_reverse_index_prefix.data());
 
   WriteBatch rocksdb_write_batch;
+  IntentsCleanup cleanup;
+  cleanup.transaction_id = data.transaction_id;
+  cleanup.op_term = data.op_id.term();
+  cleanup.op_index = data.op_id.index();
+  cleanup.log_ht = data.log_ht;
 
   docdb::DocHybridTimeBuffer doc_ht_buffer;
 
@@ -892,13 +1591,21 @@ Status Tablet::ApplyIntents(const TransactionApplyData& data) {
         }};
         rocksdb_write_batch.Put(key_parts, value_parts);
         ++write_id;
+        // Applied values are only known as intents here, so their cached states are dropped.
+        if (recent_writes_) {
+          recent_writes_->Invalidate(intent->doc_path);
+        }
+        if (row_cache_) {
+          row_cache_->Invalidate(intent->doc_path, data.commit_ht);
+        }
       }
 
-      rocksdb_write_batch.Delete(intent_iter->key());
+      cleanup.single_delete_keys.push_back(intent_iter->key().ToString());
+      cleanup.single_delete_keys.push_back(key_slice.ToString());
+    } else {
+      cleanup.metadata_key = key_slice.ToString();
     }
 
-    rocksdb_write_batch.Delete(reverse_index_iter->key());
-
     reverse_index_iter->Next();
   }
 
@@ -907,11 +1614,113 @@ Status Tablet::ApplyIntents(const TransactionApplyData& data) {
   docdb::ConsensusFrontiers frontiers;
   set_op_id({data.op_id.term(), data.op_id.index()}, &frontiers);
   set_hybrid_time(data.log_ht, &frontiers);
+  // Deletes should be written after the applied values, so regular records are visible as soon
+  // as intents are removed.
   ApplyKeyValueRowOperations(
       KeyValueWriteBatchPB(), &frontiers, data.commit_ht, &rocksdb_write_batch);
+
+  if (!EnqueueIntentsCleanup(&cleanup)) {
+    WriteIntentsCleanup(&cleanup, &cleanup + 1);
+  }
   return Status::OK();
 }
 
+bool Tablet::EnqueueIntentsCleanup(IntentsCleanup* cleanup) {
+  if (!intents_cleanup_token_ || !FLAGS_async_intents_cleanup ||
+      (cleanup->single_delete_keys.empty() && cleanup->metadata_key.empty())) {
+    return false;
+  }
+
+  size_t pending_transactions;
+  {
+    std::lock_guard<std::mutex> lock(intents_cleanup_mutex_);
+    if (pending_intents_cleanup_.size() >=
+            implicit_cast<size_t>(FLAGS_intents_cleanup_max_pending_transactions)) {
+      return false;
+    }
+    if (!intents_cleanup_scheduled_) {
+      auto status = intents_cleanup_token_->SubmitFunc(
+          std::bind(&Tablet::CleanupIntentsTask, this));
+      if (!status.ok()) {
+        VLOG(2) << "Failed to schedule intents cleanup: " << status;
+        return false;
+      }
+      intents_cleanup_scheduled_ = true;
+    }
+    pending_intents_cleanup_.push_back(std::move(*cleanup));
+    pending_transactions = pending_intents_cleanup_.size();
+  }
+
+  if (metrics_) {
+    metrics_->intents_cleanup_pending_transactions->set_value(pending_transactions);
+  }
+  return true;
+}
+
+void Tablet::CleanupIntentsTask() {
+  std::vector<IntentsCleanup> batch;
+  size_t pending_transactions;
+  {
+    std::lock_guard<std::mutex> lock(intents_cleanup_mutex_);
+    const size_t batch_size = std::min<size_t>(
+        pending_intents_cleanup_.size(), std::max(FLAGS_intents_cleanup_max_batch_transactions, 1));
+    batch.reserve(batch_size);
+    std::move(pending_intents_cleanup_.begin(), pending_intents_cleanup_.begin() + batch_size,
+              std::back_inserter(batch));
+    pending_intents_cleanup_.erase(
+        pending_intents_cleanup_.begin(), pending_intents_cleanup_.begin() + batch_size);
+    pending_transactions = pending_intents_cleanup_.size();
+  }
+
+  if (!batch.empty()) {
+    WriteIntentsCleanup(batch.begin(), batch.end());
+  }
+
+  if (metrics_) {
+    metrics_->intents_cleanup_pending_transactions->set_value(pending_transactions);
+    metrics_->intents_cleanup_batch_transactions->Increment(batch.size());
+  }
+
+  std::lock_guard<std::mutex> lock(intents_cleanup_mutex_);
+  // Resubmit instead of looping, so cleanups of tablets sharing the pool are interleaved and
+  // the background cleanup does not monopolize the pool under heavy write load.
+  if (!pending_intents_cleanup_.empty() &&
+      intents_cleanup_token_->SubmitFunc(std::bind(&Tablet::CleanupIntentsTask, this)).ok()) {
+    return;
+  }
+  intents_cleanup_scheduled_ = false;
+}
+
+template <class Iterator>
+void Tablet::WriteIntentsCleanup(Iterator begin, Iterator end) {
+  WriteBatch rocksdb_write_batch;
+  HybridTime log_ht = HybridTime::kMin;
+  yb::OpId op_id;
+  for (auto it = begin; it != end; ++it) {
+    for (const auto& key : it->single_delete_keys) {
+      rocksdb_write_batch.SingleDelete(key);
+    }
+    if (!it->metadata_key.empty()) {
+      rocksdb_write_batch.Delete(it->metadata_key);
+    }
+    log_ht = std::max(log_ht, it->log_ht);
+    op_id.MakeAtLeast(yb::OpId(it->op_term, it->op_index));
+  }
+
+  // Cleanup is written after its operations were applied, so frontiers of already applied
+  // operations do not move flushed op id beyond anything that is not in RocksDB yet.
+  docdb::ConsensusFrontiers frontiers;
+  set_op_id(op_id, &frontiers);
+  set_hybrid_time(log_ht, &frontiers);
+  rocksdb_write_batch.SetFrontiers(&frontiers);
+  WriteToRocksDB(&rocksdb_write_batch, log_ht, intents_db());
+
+  // Intents are gone from intents DB, so conflict resolution should not see them anymore.
+  for (auto it = begin; it != end; ++it) {
+    transaction_participant_->intents_index()->Remove(it->transaction_id);
+  }
+}
+
 Status Tablet::CreatePreparedAlterSchema(AlterSchemaOperationState *operation_state,
                                          const Schema* schema) {
   if (!key_schema_.KeyEquals(*schema)) {
@@ -961,7 +1770,21 @@ Status Tablet::AlterSchema(AlterSchemaOperationState *operation_state) {
       }
     }
 
+    PreviousSchemaVersion previous_version = {metadata_->schema_version(), true};
+    for (size_t i = 0; i < operation_state->schema()->num_columns(); ++i) {
+      const ColumnSchema& column = operation_state->schema()->column(i);
+      if (!column.is_nullable() &&
+          schema()->find_column_by_id(operation_state->schema()->column_id(i)) ==
+              Schema::kColumnNotFound) {
+        previous_version.writable = false;
+      }
+    }
+
     metadata_->SetSchema(*operation_state->schema(), operation_state->schema_version());
+    {
+      std::lock_guard<simple_spinlock> lock(previous_schema_version_lock_);
+      previous_schema_version_ = previous_version;
+    }
     if (operation_state->has_new_table_name()) {
       metadata_->SetTableName(operation_state->new_table_name());
       if (metric_entity_) {
@@ -981,6 +1804,15 @@ Status Tablet::AlterSchema(AlterSchemaOperationState *operation_state) {
   return Status::OK();
 }
 
+bool Tablet::AcceptsPreviousSchemaVersion(uint32_t schema_version, bool is_write) const {
+  if (!FLAGS_ql_accept_previous_schema_version) {
+    return false;
+  }
+  std::lock_guard<simple_spinlock> lock(previous_schema_version_lock_);
+  return previous_schema_version_ && previous_schema_version_->version == schema_version &&
+         (!is_write || previous_schema_version_->writable);
+}
+
 Result<ScopedPendingOperationPause> Tablet::PauseReadWriteOperations() {
   LOG_SLOW_EXECUTION(WARNING, 1000,
                      Substitute("Tablet $0: Waiting for pending ops to complete", tablet_id())) {
@@ -990,13 +1822,18 @@ Result<ScopedPendingOperationPause> Tablet::PauseReadWriteOperations() {
 }
 
 Status Tablet::SetFlushedFrontier(const docdb::ConsensusFrontier& frontier) {
-  const Status s = rocksdb_->SetFlushedFrontier(frontier.Clone());
-  if (PREDICT_FALSE(!s.ok())) {
-    auto status = STATUS(IllegalState, "Failed to set flushed frontier", s.ToString());
-    LOG(WARNING) << status;
-    return status;
+  for (auto* db : {rocksdb_.get(), intents_db_.get()}) {
+    if (!db) {
+      continue;
+    }
+    const Status s = db->SetFlushedFrontier(frontier.Clone());
+    if (PREDICT_FALSE(!s.ok())) {
+      auto status = STATUS(IllegalState, "Failed to set flushed frontier", s.ToString());
+      LOG(WARNING) << status;
+      return status;
+    }
+    DCHECK_EQ(frontier, *db->GetFlushedFrontier());
   }
-  DCHECK_EQ(frontier, *rocksdb_->GetFlushedFrontier());
   return Flush(FlushMode::kAsync);
 }
 
@@ -1012,18 +1849,22 @@ Status Tablet::Truncate(TruncateOperationState *state) {
   const rocksdb::SequenceNumber sequence_number = rocksdb_->GetLatestSequenceNumber();
   const string db_dir = rocksdb_->GetName();
 
+  intents_db_ = nullptr;
   rocksdb_ = nullptr;
   rocksdb::Options rocksdb_options;
   docdb::InitRocksDBOptions(&rocksdb_options, tablet_id(), rocksdb_statistics_, tablet_options_);
-  Status s = rocksdb::DestroyDB(db_dir, rocksdb_options);
-  if (PREDICT_FALSE(!s.ok())) {
-    LOG(WARNING) << "Failed to clean up db dir " << db_dir << ": " << s;
-    return STATUS(IllegalState, "Failed to clean up db dir", s.ToString());
+  // Intents DB is stored in a subdirectory of regular RocksDB, so it is destroyed first.
+  for (const auto& dir : {IntentsDBDir(db_dir), db_dir}) {
+    Status s = rocksdb::DestroyDB(dir, rocksdb_options);
+    if (PREDICT_FALSE(!s.ok())) {
+      LOG(WARNING) << "Failed to clean up db dir " << dir << ": " << s;
+      return STATUS(IllegalState, "Failed to clean up db dir", s.ToString());
+    }
   }
 
   // Creata a new database.
   // Note: db_dir == metadata()->rocksdb_dir() is still valid db dir.
-  s = OpenKeyValueTablet();
+  Status s = OpenKeyValueTablet();
   if (PREDICT_FALSE(!s.ok())) {
     LOG(WARNING) << "Failed to create a new db: " << s;
     return s;
@@ -1065,15 +1906,37 @@ Result<bool> Tablet::HasSSTables() const {
   return !live_files_metadata.empty();
 }
 
+namespace {
+
+yb::OpId FlushedOpId(rocksdb::DB* db) {
+  auto frontier = db->GetFlushedFrontier();
+  if (!frontier) {
+    return yb::OpId();
+  }
+  return down_cast<docdb::ConsensusFrontier*>(frontier.get())->op_id();
+}
+
+} // namespace
+
 Result<yb::OpId> Tablet::MaxPersistentOpId() const {
   ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
   RETURN_NOT_OK(scoped_read_operation);
 
-  auto temp = rocksdb_->GetFlushedFrontier();
-  if (!temp) {
-    return yb::OpId();
+  auto result = FlushedOpId(rocksdb_.get());
+  if (intents_db_) {
+    auto intents_op_id = FlushedOpId(intents_db_.get());
+    if (intents_op_id.index < result.index) {
+      result = intents_op_id;
+    }
   }
-  return down_cast<docdb::ConsensusFrontier*>(temp.get())->op_id();
+  return result;
+}
+
+Result<yb::OpId> Tablet::MaxPersistentRegularOpId() const {
+  ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
+  RETURN_NOT_OK(scoped_read_operation);
+
+  return FlushedOpId(rocksdb_.get());
 }
 
 Status Tablet::DebugDump(vector<string> *lines) {
@@ -1121,6 +1984,41 @@ Status Tablet::TEST_SwitchMemtable() {
   return Status::OK();
 }
 
+std::vector<std::string> Tablet::CacheHintKeys() const {
+  std::vector<std::string> result;
+  for (auto& hot_key : hot_keys_.TopKeys(std::max(FLAGS_cache_hints_max_keys, 0))) {
+    result.push_back(std::move(hot_key.key));
+  }
+  return result;
+}
+
+void Tablet::WarmBlockCache(const std::vector<std::string>& keys) {
+  ScopedPendingOperation scoped_operation(&pending_op_counter_);
+  if (!scoped_operation.ok()) {
+    return;
+  }
+  for (const auto& key : keys) {
+    // Bloom filters let us skip SST files that do not contain the hashed part of the key.
+    auto iter = docdb::CreateRocksDBIterator(
+        rocksdb_.get(), docdb::BloomFilterMode::USE_BLOOM_FILTER, Slice(key),
+        rocksdb::kDefaultQueryId);
+    iter->Seek(key);
+  }
+}
+
+void Tablet::RecordHotKey(const docdb::KeyBytes& encoded_doc_key) {
+  // Rows are sampled by their hashed part, which is what the tablet splits on. Keys of range only
+  // tables are sampled whole.
+  docdb::DocKey doc_key;
+  Slice slice = encoded_doc_key.AsSlice();
+  if (!doc_key.DecodeFrom(&slice).ok() || doc_key.hashed_group().empty()) {
+    hot_keys_.Record(encoded_doc_key.AsSlice());
+    return;
+  }
+  doc_key.ClearRangeComponents();
+  hot_keys_.Record(doc_key.Encode().AsSlice());
+}
+
 Status Tablet::StartDocWriteOperation(const docdb::DocOperations &doc_ops,
                                       const WriteOperationData& data) {
   auto write_batch = data.write_request()->mutable_write_batch();
@@ -1131,6 +2029,17 @@ Status Tablet::StartDocWriteOperation(const docdb::DocOperations &doc_ops,
       doc_ops, metrics_->write_lock_latency, *isolation_level, &shared_lock_manager_,
       data.keys_locked, &need_read_snapshot);
 
+  if (HotKeySampler::ShouldSample()) {
+    boost::container::small_vector<docdb::DocPath, 4> doc_paths;
+    IsolationLevel ignored_level;
+    for (const auto& doc_op : doc_ops) {
+      doc_op->GetDocPathsToLock(&doc_paths, &ignored_level);
+    }
+    for (const auto& doc_path : doc_paths) {
+      RecordHotKey(doc_path.encoded_doc_key());
+    }
+  }
+
   auto read_op = need_read_snapshot
       ? ScopedReadOperation(this, RequireLease::kTrue, data.read_time())
       : ScopedReadOperation();
@@ -1141,7 +2050,8 @@ Status Tablet::StartDocWriteOperation(const docdb::DocOperations &doc_ops,
       metadata_->schema().table_properties().is_transactional()) {
     auto now = clock_->Now();
     auto result = docdb::ResolveOperationConflicts(
-        doc_ops, now, rocksdb_.get(), transaction_participant_.get());
+        doc_ops, now, rocksdb_.get(), intents_db(), transaction_participant_->intents_index(),
+        transaction_participant_.get());
     RETURN_NOT_OK(result);
     if (now != *result) {
       clock_->Update(*result);
@@ -1155,7 +2065,10 @@ Status Tablet::StartDocWriteOperation(const docdb::DocOperations &doc_ops,
       table_type_ == TableType::REDIS_TABLE_TYPE ? InitMarkerBehavior::kRequired
                                                  : InitMarkerBehavior::kOptional,
       &monotonic_counter_,
-      data.restart_read_ht));
+      data.restart_read_ht,
+      // Cached entries don't track expiration by the table TTL.
+      metadata_->schema().table_properties().HasDefaultTimeToLive() ? nullptr
+                                                                     : recent_writes_.get()));
 
   if (data.restart_read_ht->is_valid()) {
     return Status::OK();
@@ -1165,6 +2078,8 @@ Status Tablet::StartDocWriteOperation(const docdb::DocOperations &doc_ops,
     auto result = docdb::ResolveTransactionConflicts(*write_batch,
                                                      clock_->Now(),
                                                      rocksdb_.get(),
+                                                     intents_db(),
+                                                     transaction_participant_->intents_index(),
                                                      transaction_participant_.get());
     if (!result.ok()) {
       *data.keys_locked = LockBatch();  // Unlock the keys.
@@ -1177,6 +2092,10 @@ Status Tablet::StartDocWriteOperation(const docdb::DocOperations &doc_ops,
 
 HybridTime Tablet::DoGetSafeTime(
     tablet::RequireLease require_lease, HybridTime min_allowed, MonoTime deadline) const {
+  boost::optional<ScopedTabletMetricsTracker> metrics_tracker;
+  if (metrics_) {
+    metrics_tracker.emplace(metrics_->safe_time_wait_duration);
+  }
   HybridTime ht_lease;
   if (!require_lease) {
     return mvcc_.SafeTimeForFollower(min_allowed, deadline);
@@ -1275,12 +2194,13 @@ Result<TransactionOperationContextOpt> Tablet::CreateTransactionOperationContext
           transaction_metadata.transaction_id());
       RETURN_NOT_OK(txn_id);
       return Result<TransactionOperationContextOpt>(boost::make_optional(
-          TransactionOperationContext(*txn_id, transaction_participant())));
+          TransactionOperationContext(*txn_id, transaction_participant(), intents_db())));
     } else {
       // We still need context with transaction participant in order to resolve intents during
       // possible reads.
       return Result<TransactionOperationContextOpt>(boost::make_optional(
-          TransactionOperationContext(GenerateTransactionId(), transaction_participant())));
+          TransactionOperationContext(
+              GenerateTransactionId(), transaction_participant(), intents_db())));
     }
   } else {
     return Result<TransactionOperationContextOpt>(boost::none);
@@ -1291,11 +2211,13 @@ TransactionOperationContextOpt Tablet::CreateTransactionOperationContext(
     const boost::optional<TransactionId>& transaction_id) const {
   if (metadata_->schema().table_properties().is_transactional()) {
     if (transaction_id.is_initialized()) {
-      return TransactionOperationContext(transaction_id.get(), transaction_participant());
+      return TransactionOperationContext(
+          transaction_id.get(), transaction_participant(), intents_db());
     } else {
       // We still need context with transaction participant in order to resolve intents during
       // possible reads.
-      return TransactionOperationContext(GenerateTransactionId(), transaction_participant());
+      return TransactionOperationContext(
+          GenerateTransactionId(), transaction_participant(), intents_db());
     }
   } else {
     return boost::none;
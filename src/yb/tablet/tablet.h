@@ -32,6 +32,7 @@
 #ifndef YB_TABLET_TABLET_H_
 #define YB_TABLET_TABLET_H_
 
+#include <deque>
 #include <iosfwd>
 #include <map>
 #include <memory>
@@ -55,6 +56,8 @@
 #include "yb/docdb/docdb.pb.h"
 #include "yb/docdb/docdb_compaction_filter.h"
 #include "yb/docdb/doc_operation.h"
+#include "yb/docdb/doc_write_batch_cache.h"
+#include "yb/docdb/ql_row_cache.h"
 #include "yb/docdb/ql_rocksdb_storage.h"
 #include "yb/docdb/shared_lock_manager.h"
 
@@ -63,6 +66,7 @@
 #include "yb/gutil/macros.h"
 
 #include "yb/tablet/abstract_tablet.h"
+#include "yb/tablet/hot_keys.h"
 #include "yb/tablet/lock_manager.h"
 #include "yb/tablet/tablet_options.h"
 #include "yb/tablet/mvcc.h"
@@ -87,9 +91,13 @@ namespace yb {
 class MemTracker;
 class MetricEntity;
 class RowChangeList;
+class ThreadPoolToken;
 
 namespace docdb {
+class BlobStorage;
 class ConsensusFrontier;
+class DocKey;
+class DocRowwiseIterator;
 }
 
 namespace log {
@@ -107,6 +115,7 @@ class MaintenanceOpStats;
 namespace tablet {
 
 class AlterSchemaOperationState;
+class BulkLoadOperationState;
 class ScopedReadOperation;
 struct TabletMetrics;
 struct TransactionApplyData;
@@ -199,8 +208,26 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   void Shutdown();
 
+  // Imports the RocksDB instance in source_dir, e.g. a tablet checkpoint of a backup. SST files are
+  // linked as is when all keys of source_dir belong to the partition of this tablet. Otherwise,
+  // e.g. when the backup was taken with different partitioning, keys of this partition are
+  // rewritten into new SST files first, instead of being inserted as rows.
   CHECKED_STATUS ImportData(const std::string& source_dir);
 
+  // Appends a chunk of the specified file of the bulk load 'load_id' to the files kept until the
+  // load is ingested.
+  CHECKED_STATUS UploadBulkLoadFile(const std::string& load_id,
+                                    const std::string& file_name,
+                                    uint64_t offset,
+                                    const Slice& data);
+
+  // Returns an error if files of the bulk load 'load_id' were not uploaded to this replica.
+  CHECKED_STATUS CheckBulkLoadUploaded(const std::string& load_id);
+
+  // Adds SST files uploaded by the bulk load to RocksDB, and removes them from the upload
+  // directory. Records are visible to reads at the hybrid time of the operation.
+  CHECKED_STATUS IngestBulkLoad(BulkLoadOperationState* state);
+
   CHECKED_STATUS ApplyIntents(const TransactionApplyData& data) override;
 
   // Finish the Prepare phase of a write transaction.
@@ -231,9 +258,19 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // it's not the first thing in a transaction!
   void StartOperation(WriteOperationState* operation_state);
 
+  // Encodes the RocksDB write batch of a non-transactional write ahead of its apply, if enabled
+  // by --tablet_prepare_write_batch_before_apply. Must be called after StartOperation, once the
+  // hybrid time of the operation is known.
+  void PrepareWriteBatch(WriteOperationState* operation_state);
+
   // Apply all of the row operations associated with this transaction.
   void ApplyRowOperations(WriteOperationState* operation_state);
 
+  // Apply row operations of several consecutive non transactional operations, ordered by op id,
+  // using a single RocksDB write. Used during bootstrap, where all replayed operations are known to
+  // be committed, and by followers applying operations committed by a single consensus update.
+  void ApplyRowOperations(const std::vector<WriteOperationState*>& operation_states);
+
   // Apply a set of RocksDB row operations.
   // If rocksdb_write_batch is specified it could contain preencoded RocksDB operations.
   void ApplyKeyValueRowOperations(
@@ -257,6 +294,11 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
       const RedisReadRequestPB& redis_read_request,
       RedisResponsePB* response) override;
 
+  CHECKED_STATUS HandleRedisReadRequests(
+      const ReadHybridTime& read_time,
+      const google::protobuf::RepeatedPtrField<RedisReadRequestPB>& redis_read_requests,
+      google::protobuf::RepeatedPtrField<RedisResponsePB>* responses) override;
+
   CHECKED_STATUS HandleQLReadRequest(
       const ReadHybridTime& read_time,
       const QLReadRequestPB& ql_read_request,
@@ -275,16 +317,36 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   CHECKED_STATUS CreateCheckpoint(const std::string& dir,
       google::protobuf::RepeatedPtrField<FilePB>* rocksdb_files = nullptr);
 
+  // Creates a RocksDB checkpoint in the provided directory like CreateCheckpoint, and fills delta
+  // with the files that have to be exported on top of a backup of the checkpoint with base_files.
+  // Checksums of the added files are set. rocksdb_files receives all files of the checkpoint, to
+  // be used as base_files of the next incremental checkpoint.
+  CHECKED_STATUS CreateIncrementalCheckpoint(
+      const std::string& dir,
+      const google::protobuf::RepeatedPtrField<FilePB>& base_files,
+      CheckpointDeltaPB* delta,
+      google::protobuf::RepeatedPtrField<FilePB>* rocksdb_files);
+
   // Create a new row iterator which yields the rows as of the current MVCC
   // state of this tablet.
   // The returned iterator is not initialized.
   Result<std::unique_ptr<common::QLRowwiseIteratorIf>> NewRowIterator(
       const Schema &projection,
-      const boost::optional<TransactionId>& transaction_id) const;
+      const boost::optional<TransactionId>& transaction_id,
+      const ReadHybridTime& read_time = ReadHybridTime::Max()) const;
+
+  // Create a new initialized iterator over rows with keys in [lower_bound, upper_bound) as of
+  // read_time. Empty bound does not limit the scan from its side.
+  Result<std::unique_ptr<docdb::DocRowwiseIterator>> NewRangeRowIterator(
+      const Schema& projection, const ReadHybridTime& read_time,
+      const docdb::DocKey& lower_bound, const docdb::DocKey& upper_bound) const;
 
   // Makes RocksDB Flush.
   CHECKED_STATUS Flush(FlushMode mode);
 
+  // Opens table readers of all SST files of the tablet, see rocksdb::DB::WarmUpTableReaders.
+  CHECKED_STATUS WarmUpTableReaders();
+
   // Prepares the transaction context for the alter schema operation.
   // An error will be returned if the specified schema is invalid (e.g.
   // key mismatch, or missing IDs)
@@ -329,6 +391,16 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // May be NULL in unit tests, etc.
   TabletMetrics* metrics() { return metrics_.get(); }
 
+  // Returns the sampler of the keys that are read and written most frequently in this tablet.
+  const HotKeySampler& hot_keys() const { return hot_keys_; }
+
+  // Returns up to --cache_hints_max_keys hot keys, that the leader sends to followers as cache
+  // hints.
+  std::vector<std::string> CacheHintKeys() const;
+
+  // Seeks to each of the keys, so blocks that contain them are loaded into the block cache.
+  void WarmBlockCache(const std::vector<std::string>& keys);
+
   // Return handle to the metric entity of this tablet.
   const scoped_refptr<MetricEntity>& GetMetricEntity() const { return metric_entity_; }
 
@@ -340,9 +412,14 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // Returns true if a RocksDB-backed tablet has any SSTables.
   Result<bool> HasSSTables() const;
 
-  // Returns the maximum persistent op id from all SSTables in RocksDB.
+  // Returns the maximum op id, such that all operations up to it are persistent in SSTables of
+  // both regular and intents RocksDB. Log entries after it should be replayed on bootstrap.
   Result<yb::OpId> MaxPersistentOpId() const;
 
+  // Returns the maximum persistent op id from all SSTables in regular RocksDB. Could be ahead of
+  // MaxPersistentOpId, when intents of recent operations are not flushed yet.
+  Result<yb::OpId> MaxPersistentRegularOpId() const;
+
   // Returns the location of the last rocksdb checkpoint. Used for tests only.
   std::string GetLastRocksDBCheckpointDirForTest() { return last_rocksdb_checkpoint_dir_; }
 
@@ -361,6 +438,10 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // The HybridTime of the oldest write that is still not scheduled to be flushed in RocksDB.
   TabletFlushStats* flush_stats() const { return flush_stats_.get(); }
 
+  // Total size of the active (not yet scheduled for flush) memtables of the regular and intents
+  // RocksDB instances.
+  uint64_t ActiveMemTablesSize() const;
+
   const scoped_refptr<server::Clock> &clock() const {
     return clock_;
   }
@@ -409,10 +490,24 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
     mem_table_flush_filter_factory_ = std::move(factory);
   }
 
+  // A log-only replica keeps only the WAL of the tablet: committed writes are not applied to
+  // RocksDB, and the tablet could not serve reads.
+  void SetLogOnly(bool log_only) {
+    log_only_.store(log_only, std::memory_order_release);
+  }
+
+  bool log_only() const {
+    return log_only_.load(std::memory_order_acquire);
+  }
+
   rocksdb::DB* TEST_db() const {
     return rocksdb_.get();
   }
 
+  rocksdb::DB* TEST_intents_db() const {
+    return intents_db();
+  }
+
   CHECKED_STATUS TEST_SwitchMemtable();
 
  protected:
@@ -425,6 +520,8 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
       const docdb::DocOperations &doc_ops,
       const WriteOperationData& data);
 
+  void RecordHotKey(const docdb::KeyBytes& encoded_doc_key);
+
   CHECKED_STATUS OpenKeyValueTablet();
 
   void DocDBDebugDump(std::vector<std::string> *lines);
@@ -439,6 +536,52 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
       HybridTime hybrid_time,
       rocksdb::WriteBatch* rocksdb_write_batch);
 
+  // Writes prepared batch to dest_db, hybrid_time is the latest hybrid time of the batch.
+  void WriteToRocksDB(
+      rocksdb::WriteBatch* write_batch, HybridTime hybrid_time, rocksdb::DB* dest_db);
+
+  // Returns RocksDB that stores transaction intents. For transactional tables it is a separate
+  // instance, so short lived intents are not compacted together with regular records.
+  rocksdb::DB* intents_db() const {
+    return intents_db_ ? intents_db_.get() : rocksdb_.get();
+  }
+
+  CHECKED_STATUS OpenIntentsDB(rocksdb::Options options);
+
+  // Adds files of checkpoint dir to rocksdb_files, name of each file is prefixed by subdir.
+  CHECKED_STATUS AddCheckpointFiles(
+      const std::string& dir, const std::string& subdir,
+      google::protobuf::RepeatedPtrField<FilePB>* rocksdb_files);
+
+  // When all intents are flushed, moves flushed frontier of intents DB to the flushed frontier of
+  // regular RocksDB, so idle intents DB does not hold back log GC and bootstrap.
+  void MaybeAdvanceIntentsFlushedFrontier();
+
+  // Keys that should be deleted after intents of transaction were applied.
+  struct IntentsCleanup {
+    TransactionId transaction_id;
+    int64_t op_term;
+    int64_t op_index;
+    HybridTime log_ht;
+    // Keys of intents and reverse index records, that are written exactly once.
+    std::vector<std::string> single_delete_keys;
+    // Transaction metadata key, could be written several times, e.g. after restart.
+    std::string metadata_key;
+  };
+
+  // Queues cleanup to be written by the background cleanup task together with cleanups of other
+  // transactions. Returns false if cleanup should be written by caller, i.e. background cleanup is
+  // not available or its backlog is full.
+  bool EnqueueIntentsCleanup(IntentsCleanup* cleanup);
+
+  // Background task that writes a batch of pending cleanups and reschedules itself if more
+  // cleanups are pending.
+  void CleanupIntentsTask();
+
+  // Writes cleanups in [begin, end) to RocksDB as a single write batch.
+  template <class Iterator>
+  void WriteIntentsCleanup(Iterator begin, Iterator end);
+
   Result<TransactionOperationContextOpt> CreateTransactionOperationContext(
       const TransactionMetadataPB& transaction_metadata) const;
 
@@ -448,6 +591,11 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // Pause any new read/write operations and wait for all pending read/write operations to finish.
   Result<util::ScopedPendingOperationPause> PauseReadWriteOperations();
 
+  // Returns whether QL requests planned with schema_version, the version before the last alter of
+  // the tablet, could be executed with the current schema, when all columns they reference exist
+  // in it.
+  bool AcceptsPreviousSchemaVersion(uint32_t schema_version, bool is_write) const;
+
   // Initialize RocksDB's max persistent op id and hybrid time to that of the operation state.
   // Necessary for cases like truncate or restore snapshot when RocksDB is reset.
   CHECKED_STATUS SetFlushedFrontier(const docdb::ConsensusFrontier& value);
@@ -465,6 +613,19 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // released after the schema change has been applied.
   mutable rw_semaphore schema_lock_;
 
+  struct PreviousSchemaVersion {
+    uint32_t version;
+    // Whether all columns added by the alter are nullable, so writes planned with the previous
+    // version don't miss values of required columns.
+    bool writable;
+  };
+
+  // Schema version before the last alter applied since the tablet was opened. QL requests that
+  // were planned with this version while the table was altered are not rejected, see
+  // AcceptsPreviousSchemaVersion.
+  mutable simple_spinlock previous_schema_version_lock_;
+  boost::optional<PreviousSchemaVersion> previous_schema_version_;
+
   const Schema key_schema_;
 
   scoped_refptr<TabletMetadata> metadata_;
@@ -497,6 +658,7 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   MetricEntityPtr metric_entity_;
   gscoped_ptr<TabletMetrics> metrics_;
+  HotKeySampler hot_keys_;
   FunctionGaugeDetacher metric_detacher_;
 
   int64_t next_mrs_id_ = 0;
@@ -543,6 +705,9 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // RocksDB database for key-value tables.
   std::unique_ptr<rocksdb::DB> rocksdb_;
 
+  // RocksDB database for intents of transactional tables, null for non transactional tables.
+  std::unique_ptr<rocksdb::DB> intents_db_;
+
   std::unique_ptr<common::QLStorageIf> ql_storage_;
 
   // This is for docdb fine-grained locking.
@@ -578,18 +743,53 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   std::atomic<int64_t> last_committed_write_index_{0};
 
+  std::atomic<bool> log_only_{false};
+
   // Remembers he HybridTime of the oldest write that is still not scheduled to
   // be flushed in RocksDB.
   std::shared_ptr<TabletFlushStats> flush_stats_;
 
+  // Stores large values of regular RocksDB, nullptr when key-value separation was never enabled
+  // for this tablet.
+  std::shared_ptr<docdb::BlobStorage> blob_storage_;
+
+  // States of documents written by recently applied operations, used by write operations instead of
+  // reading them from RocksDB. nullptr when disabled by --docdb_recent_writes_cache_size.
+  std::unique_ptr<docdb::RecentWritesCache> recent_writes_;
+
+  // Rows recently read by point reads, used by read operations instead of reading them from
+  // RocksDB. nullptr when disabled by --ql_row_cache_size_bytes.
+  std::unique_ptr<docdb::QLRowCache> row_cache_;
+
   HybridTimeLeaseProvider ht_lease_provider_;
 
  private:
   HybridTime DoGetSafeTime(
       RequireLease require_lease, HybridTime min_allowed, MonoTime deadline) const override;
 
+  // Creates row iterator that is not initialized yet.
+  Result<std::unique_ptr<docdb::DocRowwiseIterator>> CreateRowIterator(
+      const Schema &projection, const boost::optional<TransactionId>& transaction_id,
+      const ReadHybridTime& read_time) const;
+
+  // Directory with files uploaded by the specified bulk load.
+  std::string BulkLoadDir(const std::string& load_id) const;
+
+  // Writes the keys of source that are in [lower_bound, upper_bound) to a new RocksDB instance in
+  // dest_dir. Empty upper_bound means no upper bound. Returns the number of written keys.
+  Result<size_t> RewriteImportedData(
+      rocksdb::DB* source, const std::string& lower_bound, const std::string& upper_bound,
+      const std::string& dest_dir);
+
   std::function<rocksdb::MemTableFilter()> mem_table_flush_filter_factory_;
 
+  // Serializes cleanup tasks of this tablet on the shared intents cleanup pool.
+  std::unique_ptr<ThreadPoolToken> intents_cleanup_token_;
+
+  std::mutex intents_cleanup_mutex_;
+  std::deque<IntentsCleanup> pending_intents_cleanup_;
+  bool intents_cleanup_scheduled_ = false;
+
   DISALLOW_COPY_AND_ASSIGN(Tablet);
 };
 
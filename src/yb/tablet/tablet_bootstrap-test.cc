@@ -46,6 +46,8 @@
 #include "yb/util/tostring.h"
 #include "yb/tablet/tablet_options.h"
 
+DECLARE_int32(tablet_bootstrap_max_write_batch_ops);
+
 using std::shared_ptr;
 using std::string;
 using std::vector;
@@ -333,5 +335,35 @@ TEST_F(BootstrapTest, TestConsensusOnlyOperationOutOfOrderHybridTime) {
   ASSERT_EQ(1, results.size());
 }
 
+// Test that contiguous committed writes from several log segments are applied in batches.
+TEST_F(BootstrapTest, TestBatchedWrites) {
+  FLAGS_tablet_bootstrap_max_write_batch_ops = 4;
+  BuildLog();
+
+  constexpr int kNumSegments = 3;
+  constexpr int kWritesPerSegment = 10;
+  int index = 0;
+  for (int segment = 0; segment != kNumSegments; ++segment) {
+    for (int i = 0; i != kWritesPerSegment; ++i) {
+      ++index;
+      AppendReplicateBatch(MakeOpId(1, index), MakeOpId(1, index),
+                           {TupleForAppend(index, index, "this is a test insert")},
+                           true /* sync */);
+    }
+    ASSERT_OK(RollLog());
+  }
+
+  ConsensusBootstrapInfo boot_info;
+  shared_ptr<TabletClass> tablet;
+  ASSERT_OK(BootstrapTestTablet(-1, -1, &tablet, &boot_info));
+  ASSERT_EQ(boot_info.orphaned_replicates.size(), 0);
+  ASSERT_OPID_EQ(boot_info.last_committed_id, MakeOpId(1, index));
+
+  // Confirm that all writes were applied.
+  vector<string> results;
+  IterateTabletRows(tablet.get(), &results);
+  ASSERT_EQ(kNumSegments * kWritesPerSegment, results.size());
+}
+
 } // namespace tablet
 } // namespace yb
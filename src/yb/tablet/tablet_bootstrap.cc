@@ -31,13 +31,17 @@
 //
 #include "yb/tablet/tablet_bootstrap.h"
 
+#include <future>
+
 #include "yb/consensus/consensus.h"
 #include "yb/consensus/log_anchor_registry.h"
 #include "yb/consensus/log_reader.h"
+#include "yb/consensus/quorum_util.h"
 #include "yb/server/hybrid_clock.h"
 #include "yb/tablet/tablet.h"
 #include "yb/tablet/tablet_peer.h"
 #include "yb/tablet/operations/alter_schema_operation.h"
+#include "yb/tablet/operations/bulk_load_operation.h"
 #include "yb/tablet/operations/truncate_operation.h"
 #include "yb/tablet/operations/update_txn_operation.h"
 #include "yb/tablet/operations/write_operation.h"
@@ -45,6 +49,8 @@
 #include "yb/util/flag_tags.h"
 #include "yb/util/opid.h"
 #include "yb/util/logging.h"
+#include "yb/util/metrics.h"
+#include "yb/util/path_util.h"
 #include "yb/util/stopwatch.h"
 
 DEFINE_bool(skip_remove_old_recovery_dir, false,
@@ -55,6 +61,30 @@ DEFINE_test_flag(double, fault_crash_during_log_replay, 0.0,
                  "Fraction of the time when the tablet will crash immediately "
                  "after processing a log entry during log replay.");
 
+DEFINE_int32(tablet_bootstrap_max_write_batch_ops, 256,
+             "Maximal number of contiguous committed non transactional write operations that are "
+             "applied to RocksDB as a single batch during tablet bootstrap. Values less than 2 "
+             "disable batching.");
+TAG_FLAG(tablet_bootstrap_max_write_batch_ops, advanced);
+
+DEFINE_bool(skip_flushed_log_segments_on_bootstrap, true,
+            "Log segments that contain only operations flushed to RocksDB are linked into the "
+            "new log during tablet bootstrap, instead of being read and replayed.");
+TAG_FLAG(skip_flushed_log_segments_on_bootstrap, advanced);
+
+METRIC_DEFINE_gauge_uint64(tablet, bootstrap_open_tablet_time_ms,
+                           "Bootstrap Open Tablet Time",
+                           yb::MetricUnit::kMilliseconds,
+                           "Time spent opening the tablet and its RocksDB during bootstrap.");
+METRIC_DEFINE_gauge_uint64(tablet, bootstrap_read_log_segments_time_ms,
+                           "Bootstrap Read Log Segments Time",
+                           yb::MetricUnit::kMilliseconds,
+                           "Time spent reading and decoding log segments during bootstrap.");
+METRIC_DEFINE_gauge_uint64(tablet, bootstrap_replay_time_ms,
+                           "Bootstrap Replay Time",
+                           yb::MetricUnit::kMilliseconds,
+                           "Time spent replaying log entries during bootstrap.");
+
 DECLARE_uint64(max_clock_sync_error_usec);
 
 namespace yb {
@@ -124,15 +154,17 @@ struct ReplayState {
 
   bool CanApply(log::LogEntryPB* entry);
 
+  // Handler could take ownership of the entry.
   template<class Handler>
-  void ApplyCommittedPendingReplicates(const Handler& handler) {
+  CHECKED_STATUS ApplyCommittedPendingReplicates(const Handler& handler) {
     auto iter = pending_replicates.begin();
     while (iter != pending_replicates.end() && CanApply(iter->second.get())) {
       std::unique_ptr<log::LogEntryPB> entry = std::move(iter->second);
-      handler(entry.get());
+      RETURN_NOT_OK(handler(&entry));
       iter = pending_replicates.erase(iter);  // erase and advance the iterator (C++11)
       ++num_entries_applied_to_rocksdb;
     }
+    return Status::OK();
   }
 
   // The last replicate message's ID.
@@ -289,7 +321,16 @@ Status TabletBootstrap::Bootstrap(shared_ptr<TabletClass>* rebuilt_tablet,
   }
 
   bool has_blocks;
+  const auto open_tablet_start = MonoTime::Now();
   RETURN_NOT_OK(OpenTablet(&has_blocks));
+  stats_.open_tablet_time = MonoTime::Now() - open_tablet_start;
+
+  // Writes replayed on a log-only replica are not applied, like the ones it receives later.
+  if (consensus::IsRaftConfigLogOnlyMember(meta_->fs_manager()->uuid(),
+                                           cmeta_->committed_config())) {
+    LOG_WITH_PREFIX(INFO) << "Tablet is a log-only replica";
+    tablet_->SetLogOnly(true);
+  }
 
   bool needs_recovery;
   RETURN_NOT_OK(PrepareRecoveryDir(&needs_recovery));
@@ -323,6 +364,20 @@ Status TabletBootstrap::Bootstrap(shared_ptr<TabletClass>* rebuilt_tablet,
   // Flush the consensus metadata once at the end to persist our changes, if any.
   RETURN_NOT_OK(cmeta_->Flush());
 
+  LOG_WITH_PREFIX(INFO) << "Bootstrap times: open tablet: " << stats_.open_tablet_time
+                        << ", read log segments: " << stats_.read_segments_time
+                        << ", replay: " << stats_.replay_time
+                        << ", skipped flushed log segments: " << stats_.segments_skipped;
+  const auto& metric_entity = tablet_->GetMetricEntity();
+  if (metric_entity) {
+    METRIC_bootstrap_open_tablet_time_ms.Instantiate(metric_entity, 0)->set_value(
+        stats_.open_tablet_time.ToMilliseconds());
+    METRIC_bootstrap_read_log_segments_time_ms.Instantiate(metric_entity, 0)->set_value(
+        stats_.read_segments_time.ToMilliseconds());
+    METRIC_bootstrap_replay_time_ms.Instantiate(metric_entity, 0)->set_value(
+        stats_.replay_time.ToMilliseconds());
+  }
+
   RETURN_NOT_OK(RemoveRecoveryDir());
   RETURN_NOT_OK(FinishBootstrap("Bootstrap complete.", rebuilt_log, rebuilt_tablet));
 
@@ -481,6 +536,7 @@ Status TabletBootstrap::OpenNewLog() {
                           *tablet_->schema(),
                           tablet_->metadata()->schema_version(),
                           tablet_->GetMetricEntity(),
+                          data_.append_pool,
                           &log_));
   // Disable sync temporarily in order to speed up appends during the bootstrap process.
   log_->DisableSync();
@@ -591,9 +647,8 @@ Status TabletBootstrap::HandleReplicateMessage(ReplayState* state,
   // that entry. This allows us to decide when we can replay a REPLICATE entry during bootstrap.
   state->UpdateCommittedOpId(replicate.committed_op_id());
 
-  state->ApplyCommittedPendingReplicates(std::bind(&TabletBootstrap::HandleEntryPair, this, _1));
-
-  return Status::OK();
+  return state->ApplyCommittedPendingReplicates(
+      std::bind(&TabletBootstrap::HandleEntryPair, this, _1));
 }
 
 Status TabletBootstrap::HandleOperation(consensus::OperationType op_type,
@@ -612,6 +667,9 @@ Status TabletBootstrap::HandleOperation(consensus::OperationType op_type,
     case consensus::TRUNCATE_OP:
       return PlayTruncateRequest(replicate);
 
+    case consensus::BULK_LOAD_OP:
+      return PlayBulkLoadRequest(replicate);
+
     case consensus::NO_OP:
       return PlayNoOpRequest(replicate);
 
@@ -630,10 +688,32 @@ Status TabletBootstrap::HandleOperation(consensus::OperationType op_type,
   FATAL_INVALID_ENUM_VALUE(consensus::OperationType, op_type);
 }
 
-// Never deletes 'replicate_entry' or 'commit_entry'.
-Status TabletBootstrap::HandleEntryPair(LogEntryPB* replicate_entry) {
-  ReplicateMsg* replicate = replicate_entry->mutable_replicate();
-  const auto op_type = replicate_entry->replicate().op_type();
+// Takes ownership of 'replicate_entry' when it is added to the pending write batch.
+Status TabletBootstrap::HandleEntryPair(std::unique_ptr<LogEntryPB>* replicate_entry) {
+  ReplicateMsg* replicate = (*replicate_entry)->mutable_replicate();
+  const auto op_type = replicate->op_type();
+
+  // Regular records of this operation are already persistent, but its intents could be lost.
+  if (replicate->id().index() <= regular_flushed_index_ &&
+      op_type != consensus::UPDATE_TRANSACTION_OP &&
+      !(op_type == consensus::WRITE_OP &&
+        replicate->write_request().write_batch().has_transaction())) {
+    return Status::OK();
+  }
+
+  // Committed non transactional writes only add entries to RocksDB, so contiguous writes are
+  // applied as a single batch. Any other operation could depend on previous writes, so pending
+  // writes are applied before it.
+  const int max_write_batch_ops = FLAGS_tablet_bootstrap_max_write_batch_ops;
+  if (op_type == consensus::WRITE_OP && max_write_batch_ops > 1 &&
+      !replicate->write_request().write_batch().has_transaction()) {
+    pending_writes_.push_back(std::move(*replicate_entry));
+    if (pending_writes_.size() >= static_cast<size_t>(max_write_batch_ops)) {
+      return ApplyPendingWrites();
+    }
+    return Status::OK();
+  }
+  RETURN_NOT_OK(ApplyPendingWrites());
 
   {
     const auto status = HandleOperation(op_type, replicate);
@@ -647,6 +727,39 @@ Status TabletBootstrap::HandleEntryPair(LogEntryPB* replicate_entry) {
   return Status::OK();
 }
 
+Status TabletBootstrap::ApplyPendingWrites() {
+  if (pending_writes_.empty()) {
+    return Status::OK();
+  }
+
+  std::vector<std::unique_ptr<WriteOperationState>> operation_states;
+  std::vector<WriteOperationState*> operation_state_ptrs;
+  operation_states.reserve(pending_writes_.size());
+  operation_state_ptrs.reserve(pending_writes_.size());
+  for (const auto& entry : pending_writes_) {
+    ReplicateMsg* replicate_msg = entry->mutable_replicate();
+    DCHECK(replicate_msg->has_hybrid_time());
+    DCHECK(replicate_msg->write_request().has_write_batch());
+
+    operation_states.push_back(std::make_unique<WriteOperationState>(
+        nullptr, replicate_msg->mutable_write_request(), nullptr));
+    auto* operation_state = operation_states.back().get();
+    operation_state->mutable_op_id()->CopyFrom(replicate_msg->id());
+    operation_state->set_hybrid_time(HybridTime(replicate_msg->hybrid_time()));
+    tablet_->StartOperation(operation_state);
+    operation_state_ptrs.push_back(operation_state);
+  }
+
+  tablet_->ApplyRowOperations(operation_state_ptrs);
+
+  for (const auto* operation_state : operation_state_ptrs) {
+    tablet_->mvcc_manager()->Replicated(operation_state->hybrid_time());
+  }
+  stats_.write_batches_applied++;
+  pending_writes_.clear();
+  return Status::OK();
+}
+
 void TabletBootstrap::DumpReplayStateToLog(const ReplayState& state) {
   // Dump the replay state, this will log the pending replicates, which might be useful for
   // debugging.
@@ -671,6 +784,42 @@ void TabletBootstrap::DumpReplayStateToLog(const ReplayState& state) {
   }
 }
 
+Status TabletBootstrap::LinkFlushedSegments(int64_t flushed_index,
+                                            log::SegmentSequence* segments) {
+  if (flushed_index <= 0) {
+    return Status::OK();
+  }
+
+  log::SegmentSequence flushed_segments;
+  RETURN_NOT_OK(log_reader_->GetSegmentPrefixNotIncluding(flushed_index, &flushed_segments));
+  // At least one segment is replayed, so the last op id in the log is known.
+  if (!flushed_segments.empty() && flushed_segments.size() == segments->size()) {
+    flushed_segments.pop_back();
+  }
+  if (flushed_segments.empty()) {
+    return Status::OK();
+  }
+
+  // Segments are linked, so the recovery dir still contains all segments in case bootstrap is
+  // retried. The new log picks them up and continues their sequence numbers, while log index
+  // entries for them are added on demand by the log reader.
+  Env* env = meta_->fs_manager()->env();
+  const string& log_dir = tablet_->metadata()->wal_dir();
+  for (const auto& segment : flushed_segments) {
+    const string dest_path = JoinPathSegments(log_dir, BaseName(segment->path()));
+    RETURN_NOT_OK_PREPEND(env->LinkFile(segment->path(), dest_path),
+                          Substitute("Failed to link log segment $0 to $1",
+                                     segment->path(), dest_path));
+  }
+  LOG_WITH_PREFIX(INFO) << "Skipped replay of " << flushed_segments.size() << " log segments, "
+                        << "containing only operations flushed to RocksDB, up to "
+                        << flushed_segments.back()->path();
+
+  stats_.segments_skipped = flushed_segments.size();
+  segments->erase(segments->begin(), segments->begin() + flushed_segments.size());
+  return Status::OK();
+}
+
 Status TabletBootstrap::PlaySegments(ConsensusBootstrapInfo* consensus_info) {
   auto persistent_op_id = MinimumOpId();
   Result<yb::OpId> flushed_op_id = tablet_->MaxPersistentOpId();
@@ -680,21 +829,57 @@ Status TabletBootstrap::PlaySegments(ConsensusBootstrapInfo* consensus_info) {
   persistent_op_id.set_index(flushed_op_id.get_ptr()->index);
   ReplayState state(persistent_op_id);
 
+  Result<yb::OpId> regular_flushed_op_id = tablet_->MaxPersistentRegularOpId();
+  RETURN_NOT_OK(regular_flushed_op_id);
+  regular_flushed_index_ = regular_flushed_op_id->index;
+
   LOG_WITH_PREFIX(INFO) << "Max persistent index in RocksDB's SSTables before bootstrap: "
-                        << state.last_stored_op_id.ShortDebugString();
+                        << state.last_stored_op_id.ShortDebugString()
+                        << ", regular RocksDB: " << regular_flushed_index_;
 
   log::SegmentSequence segments;
   RETURN_NOT_OK(log_reader_->GetSegmentsSnapshot(&segments));
 
+  if (FLAGS_skip_flushed_log_segments_on_bootstrap) {
+    RETURN_NOT_OK(LinkFlushedSegments(state.last_stored_op_id.index(), &segments));
+  }
+
   // We defer opening the log until here, so that we properly reproduce the point-in-time schema
   // from the log we're reading into the log we're writing.
   RETURN_NOT_OK_PREPEND(OpenNewLog(), "Failed to open new log");
 
-  int segment_count = 0;
-  for (const scoped_refptr<ReadableLogSegment>& segment : segments) {
+  // Segments are read and decoded by a separate thread, so the next segment is decoded while
+  // entries of the current one are applied.
+  struct SegmentEntries {
     log::LogEntries entries;
+    Status read_status;
+    MonoDelta read_time;
+  };
+  auto read_segment = [](const scoped_refptr<ReadableLogSegment>& segment) {
+    SegmentEntries result;
+    const auto start = MonoTime::Now();
     // TODO: Optimize this to not read the whole thing into memory?
-    Status read_status = segment->ReadEntries(&entries);
+    result.read_status = segment->ReadEntries(&result.entries);
+    result.read_time = MonoTime::Now() - start;
+    return result;
+  };
+  std::future<SegmentEntries> next_segment_entries;
+  if (!segments.empty()) {
+    next_segment_entries = std::async(std::launch::async, read_segment, segments.front());
+  }
+
+  int segment_count = 0;
+  for (const scoped_refptr<ReadableLogSegment>& segment : segments) {
+    auto segment_entries = next_segment_entries.get();
+    const size_t next_segment_idx = segment_count + 1;
+    if (next_segment_idx < segments.size()) {
+      next_segment_entries = std::async(
+          std::launch::async, read_segment, segments[next_segment_idx]);
+    }
+    auto& entries = segment_entries.entries;
+    const Status& read_status = segment_entries.read_status;
+    stats_.read_segments_time += segment_entries.read_time;
+    const auto replay_start = MonoTime::Now();
     for (int entry_idx = 0; entry_idx < entries.size(); ++entry_idx) {
       Status s = HandleEntry(&state, &entries[entry_idx]);
       if (!s.ok()) {
@@ -706,6 +891,7 @@ Status TabletBootstrap::PlaySegments(ConsensusBootstrapInfo* consensus_info) {
                                            *entries[entry_idx]));
       }
     }
+    stats_.replay_time += MonoTime::Now() - replay_start;
 
     // If the LogReader failed to read for some reason, we'll still try to replay as many entries as
     // possible, and then fail with Corruption.
@@ -725,12 +911,16 @@ Status TabletBootstrap::PlaySegments(ConsensusBootstrapInfo* consensus_info) {
     // number of MB processed, but this is better than nothing.
     listener_->StatusMessage(Substitute("Bootstrap replayed $0/$1 log segments. "
                                         "Stats: $2. Pending: $3 replicates",
-                                        segment_count + 1, log_reader_->num_segments(),
+                                        segment_count + 1, segments.size(),
                                         stats_.ToString(),
                                         state.pending_replicates.size()));
     segment_count++;
   }
 
+  const auto apply_start = MonoTime::Now();
+  RETURN_NOT_OK_PREPEND(ApplyPendingWrites(), "Failed to apply pending writes");
+  stats_.replay_time += MonoTime::Now() - apply_start;
+
   LOG(INFO) << "Dumping replay state to log at the end of " << __FUNCTION__;
   DumpReplayStateToLog(state);
 
@@ -840,6 +1030,19 @@ Status TabletBootstrap::PlayTruncateRequest(ReplicateMsg* replicate_msg) {
   return Status::OK();
 }
 
+Status TabletBootstrap::PlayBulkLoadRequest(ReplicateMsg* replicate_msg) {
+  DCHECK(replicate_msg->has_hybrid_time());
+
+  // Ingested loads are not replayed, since their operation is flushed together with the files.
+  BulkLoadOperationState operation_state(nullptr, replicate_msg->mutable_bulk_load_request());
+  operation_state.mutable_op_id()->CopyFrom(replicate_msg->id());
+  operation_state.set_hybrid_time(HybridTime(replicate_msg->hybrid_time()));
+
+  RETURN_NOT_OK_PREPEND(tablet_->IngestBulkLoad(&operation_state), "Failed to ingest bulk load:");
+
+  return Status::OK();
+}
+
 Status TabletBootstrap::PlayUpdateTransactionRequest(ReplicateMsg* replicate_msg) {
   DCHECK(replicate_msg->has_hybrid_time());
 
@@ -876,10 +1079,12 @@ string TabletBootstrap::LogPrefix() const {
 string TabletBootstrap::Stats::ToString() const {
   return Substitute("ops{read=$0 overwritten=$1} "
                     "inserts{seen=$2 ignored=$3} "
-                    "mutations{seen=$4 ignored=$5}",
+                    "mutations{seen=$4 ignored=$5} "
+                    "write_batches{applied=$6}",
                     ops_read, ops_overwritten,
                     inserts_seen, inserts_ignored,
-                    mutations_seen, mutations_ignored);
+                    mutations_seen, mutations_ignored,
+                    write_batches_applied);
 }
 
 } // namespace tablet
@@ -108,8 +108,16 @@ class TabletBootstrap {
   // accepting writes from clients.
   CHECKED_STATUS PlaySegments(consensus::ConsensusBootstrapInfo* results);
 
+  // Links leading log segments that contain only operations flushed to RocksDB, i.e. with indexes
+  // less than 'flushed_index', into the tablet's log directory, and removes them from 'segments',
+  // so they are not replayed.
+  CHECKED_STATUS LinkFlushedSegments(int64_t flushed_index, log::SegmentSequence* segments);
+
   void PlayWriteRequest(consensus::ReplicateMsg* replicate_msg);
 
+  // Applies pending_writes_ to the tablet as a single RocksDB write batch.
+  CHECKED_STATUS ApplyPendingWrites();
+
   CHECKED_STATUS PlayUpdateTransactionRequest(consensus::ReplicateMsg* replicate_msg);
 
   CHECKED_STATUS PlayAlterSchemaRequest(consensus::ReplicateMsg* replicate_msg);
@@ -120,13 +128,15 @@ class TabletBootstrap {
 
   CHECKED_STATUS PlayTruncateRequest(consensus::ReplicateMsg* replicate_msg);
 
+  CHECKED_STATUS PlayBulkLoadRequest(consensus::ReplicateMsg* replicate_msg);
+
   void DumpReplayStateToLog(const ReplayState& state);
 
   // Handlers for each type of message seen in the log during replay.
   CHECKED_STATUS HandleEntry(ReplayState* state, std::unique_ptr<log::LogEntryPB>* entry);
   CHECKED_STATUS HandleReplicateMessage(
       ReplayState* state, std::unique_ptr<log::LogEntryPB>* replicate_entry);
-  CHECKED_STATUS HandleEntryPair(log::LogEntryPB* replicate_entry);
+  CHECKED_STATUS HandleEntryPair(std::unique_ptr<log::LogEntryPB>* replicate_entry);
   virtual CHECKED_STATUS HandleOperation(consensus::OperationType op_type,
                                          consensus::ReplicateMsg* replicate);
 
@@ -161,7 +171,9 @@ class TabletBootstrap {
         inserts_seen(0),
         inserts_ignored(0),
         mutations_seen(0),
-        mutations_ignored(0) {
+        mutations_ignored(0),
+        write_batches_applied(0),
+        segments_skipped(0) {
     }
 
     std::string ToString() const;
@@ -175,8 +187,26 @@ class TabletBootstrap {
     // Number inserts/mutations seen and ignored.
     int inserts_seen, inserts_ignored;
     int mutations_seen, mutations_ignored;
+
+    // Number of RocksDB write batches applied for pending writes.
+    int write_batches_applied;
+
+    // Number of log segments that were not replayed, because they contain only flushed operations.
+    int segments_skipped;
+
+    // Time spent in each phase of bootstrap.
+    MonoDelta open_tablet_time;
+    MonoDelta read_segments_time;
+    MonoDelta replay_time;
   } stats_;
 
+  // Committed non transactional write operations, that were not applied to RocksDB yet.
+  std::vector<std::unique_ptr<log::LogEntryPB>> pending_writes_;
+
+  // Index of the last operation persistent in regular RocksDB. Operations up to it are replayed
+  // only when they write intents, that are stored in separate RocksDB and flushed independently.
+  int64_t regular_flushed_index_ = -1;
+
   HybridTime rocksdb_last_entry_hybrid_time_ = HybridTime::kMin;
 
  private:
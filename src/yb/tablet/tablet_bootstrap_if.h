@@ -53,6 +53,7 @@
 namespace yb {
 
 class MetricRegistry;
+class ThreadPool;
 class Partition;
 class PartitionSchema;
 
@@ -118,6 +119,8 @@ struct BootstrapTabletData {
   TabletOptions tablet_options;
   TransactionParticipantContext* transaction_participant_context;
   TransactionCoordinatorContext* transaction_coordinator_context;
+  // Pool used by the tablet's log to append entries. Null means a dedicated append thread.
+  ThreadPool* append_pool;
 };
 
 // Bootstraps a tablet, initializing it with the provided metadata. If the tablet
@@ -33,7 +33,9 @@
 #include "yb/tablet/tablet_metadata.h"
 
 #include <algorithm>
+#include <condition_variable>
 #include <mutex>
+#include <set>
 #include <string>
 
 #include <gflags/gflags.h>
@@ -49,13 +51,16 @@
 #include "yb/gutil/map-util.h"
 #include "yb/gutil/stl_util.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/gutil/strings/util.h"
 #include "yb/rocksutil/yb_rocksdb.h"
 #include "yb/rocksutil/yb_rocksdb_logger.h"
 #include "yb/server/metadata.h"
 #include "yb/tablet/tablet_options.h"
 #include "yb/util/debug/trace_event.h"
+#include "yb/util/env_util.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
+#include "yb/util/path_util.h"
 #include "yb/util/pb_util.h"
 #include "yb/util/random.h"
 #include "yb/util/status.h"
@@ -68,6 +73,18 @@ TAG_FLAG(enable_tablet_orphaned_block_deletion, advanced);
 TAG_FLAG(enable_tablet_orphaned_block_deletion, hidden);
 TAG_FLAG(enable_tablet_orphaned_block_deletion, runtime);
 
+DEFINE_bool(keep_tombstoned_tablet_sst_files, true,
+            "Keep SST files of tombstoned tablets, so that a later remote bootstrap of the tablet "
+            "downloads only the files, that the remote replica does not have in common.");
+TAG_FLAG(keep_tombstoned_tablet_sst_files, advanced);
+TAG_FLAG(keep_tombstoned_tablet_sst_files, runtime);
+
+DEFINE_bool(tablet_metadata_group_flush, true,
+            "Merge concurrent tablet superblock writes into groups that share a single fsync of "
+            "the tablet metadata directory.");
+TAG_FLAG(tablet_metadata_group_flush, advanced);
+TAG_FLAG(tablet_metadata_group_flush, runtime);
+
 using std::shared_ptr;
 
 using base::subtle::Barrier_AtomicIncrement;
@@ -81,6 +98,120 @@ namespace tablet {
 
 const int64 kNoDurableMemStore = -1;
 
+namespace {
+
+// Writes tablet superblocks of all tablets in the process, merging concurrent writes into groups.
+// A writer that finds no group in progress becomes the group leader: it writes and syncs every
+// queued superblock file, then syncs each affected directory once and wakes up the rest of the
+// group. Write returns only after its superblock is durable, same as a standalone synced write.
+class SuperBlockWriter {
+ public:
+  static SuperBlockWriter& Instance() {
+    static SuperBlockWriter instance;
+    return instance;
+  }
+
+  CHECKED_STATUS Write(Env* env, const std::string& path, const TabletSuperBlockPB& pb) {
+    Request request{env, &path, &pb};
+    std::unique_lock<std::mutex> lock(mutex_);
+    queue_.push_back(&request);
+    while (!request.done && leader_active_) {
+      cond_.wait(lock);
+    }
+    if (request.done) {
+      return request.status;
+    }
+
+    // Our request is still queued, so it is a part of the group we lead.
+    leader_active_ = true;
+    std::vector<Request*> group;
+    group.swap(queue_);
+    lock.unlock();
+
+    WriteGroup(group);
+
+    lock.lock();
+    leader_active_ = false;
+    for (auto* member : group) {
+      member->done = true;
+    }
+    cond_.notify_all();
+    return request.status;
+  }
+
+ private:
+  struct Request {
+    Env* env;
+    const std::string* path;
+    const TabletSuperBlockPB* pb;
+    Status status;
+    bool done = false;
+  };
+
+  void WriteGroup(const std::vector<Request*>& group) {
+    std::set<std::pair<Env*, std::string>> dirs;
+    for (auto* request : group) {
+      request->status = pb_util::WritePBContainerToPath(
+          request->env, *request->path, *request->pb, pb_util::OVERWRITE,
+          pb_util::SYNC_FILE_ONLY);
+      if (request->status.ok()) {
+        dirs.emplace(request->env, DirName(*request->path));
+      }
+    }
+    for (const auto& dir : dirs) {
+      Status status = dir.first->SyncDir(dir.second);
+      if (status.ok()) {
+        continue;
+      }
+      status = status.CloneAndPrepend("Failed to SyncDir() " + dir.second);
+      for (auto* request : group) {
+        if (request->status.ok() && request->env == dir.first &&
+            DirName(*request->path) == dir.second) {
+          request->status = status;
+        }
+      }
+    }
+    VLOG(2) << "Wrote " << group.size() << " superblocks with " << dirs.size()
+            << " directory syncs";
+  }
+
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::vector<Request*> queue_;
+  bool leader_active_ = false;
+};
+
+bool IsSSTFileName(const std::string& name) {
+  return HasSuffixString(name, ".sst") || name.find(".sst.sblock.") != std::string::npos;
+}
+
+// Hard links SST files from 'source_dir' and its subdirectories, except checkpoints, to 'dest_dir'.
+// Files that already exist in 'dest_dir' are replaced.
+Status LinkSSTFiles(Env* env, const string& source_dir, const string& dest_dir) {
+  vector<string> children;
+  RETURN_NOT_OK(env->GetChildren(source_dir, ExcludeDots::kTrue, &children));
+  for (const auto& child : children) {
+    const auto source_path = JoinPathSegments(source_dir, child);
+    const auto dest_path = JoinPathSegments(dest_dir, child);
+    bool is_dir = false;
+    RETURN_NOT_OK(env->IsDirectory(source_path, &is_dir));
+    if (is_dir) {
+      if (child != "checkpoints") {
+        RETURN_NOT_OK(env_util::CreateDirIfMissing(env, dest_path));
+        RETURN_NOT_OK(LinkSSTFiles(env, source_path, dest_path));
+      }
+    } else if (IsSSTFileName(child)) {
+      if (env->FileExists(dest_path)) {
+        RETURN_NOT_OK(env->DeleteFile(dest_path));
+      }
+      RETURN_NOT_OK(env->LinkFile(source_path, dest_path));
+    }
+  }
+  return Status::OK();
+}
+
+} // namespace
+
 // ============================================================================
 //  Tablet Metadata
 // ============================================================================
@@ -203,6 +334,24 @@ Status TabletMetadata::DeleteTabletData(TabletDataState delete_type,
   TabletOptions tablet_options;
   docdb::InitRocksDBOptions(
       &rocksdb_options, tablet_id_, nullptr /* statistics */, tablet_options);
+  auto* env = fs_manager_->env();
+
+  // SST files are immutable, so keep links to them before destroying RocksDB. The files that are
+  // also present on the remote bootstrap source, are not downloaded again.
+  if (delete_type == TABLET_DATA_TOMBSTONED && FLAGS_keep_tombstoned_tablet_sst_files) {
+    Status s = KeepRocksDBFilesForReuse();
+    if (!s.ok()) {
+      LOG(WARNING) << "Failed to keep SST files of tablet " << tablet_id_ << " for reuse: " << s;
+      WARN_NOT_OK(DeleteReusableRocksDBFiles(), "Failed to delete SST files kept for reuse");
+    }
+  } else {
+    WARN_NOT_OK(DeleteReusableRocksDBFiles(), "Failed to delete SST files kept for reuse");
+  }
+
+  // Files of bulk loads that were not ingested are useless without the tablet.
+  if (env->FileExists(bulk_load_dir())) {
+    WARN_NOT_OK(env->DeleteRecursively(bulk_load_dir()), "Failed to delete bulk load files");
+  }
 
   LOG(INFO) << "Destroying RocksDB at: " << rocksdb_dir_;
   rocksdb::Status status = rocksdb::DestroyDB(rocksdb_dir_, rocksdb_options);
@@ -225,6 +374,29 @@ Status TabletMetadata::DeleteTabletData(TabletDataState delete_type,
   return Flush();
 }
 
+Status TabletMetadata::KeepRocksDBFilesForReuse() {
+  auto* env = fs_manager_->env();
+  const auto reuse_dir = reusable_rocksdb_files_dir();
+  if (!env->FileExists(rocksdb_dir_)) {
+    return Status::OK();
+  }
+  // Files kept by previous tombstoning are preserved, since a failed remote bootstrap could have
+  // tombstoned the tablet before all of them were linked back to RocksDB.
+  RETURN_NOT_OK(env_util::CreateDirIfMissing(env, reuse_dir));
+  RETURN_NOT_OK(LinkSSTFiles(env, rocksdb_dir_, reuse_dir));
+  LOG(INFO) << "Kept SST files of tablet " << tablet_id_ << " for reuse in " << reuse_dir;
+  return Status::OK();
+}
+
+Status TabletMetadata::DeleteReusableRocksDBFiles() {
+  auto* env = fs_manager_->env();
+  const auto reuse_dir = reusable_rocksdb_files_dir();
+  if (!env->FileExists(reuse_dir)) {
+    return Status::OK();
+  }
+  return env->DeleteRecursively(reuse_dir);
+}
+
 Status TabletMetadata::DeleteSuperBlock() {
   std::lock_guard<LockType> l(data_lock_);
   if (!orphaned_blocks_.empty()) {
@@ -488,10 +660,15 @@ Status TabletMetadata::ReplaceSuperBlockUnlocked(const TabletSuperBlockPB &pb) {
   flush_lock_.AssertAcquired();
 
   string path = fs_manager_->GetTabletMetadataPath(tablet_id_);
-  RETURN_NOT_OK_PREPEND(pb_util::WritePBContainerToPath(
-                            fs_manager_->env(), path, pb,
-                            pb_util::OVERWRITE, pb_util::SYNC),
-                        Substitute("Failed to write tablet metadata $0", tablet_id_));
+  if (FLAGS_tablet_metadata_group_flush) {
+    RETURN_NOT_OK_PREPEND(SuperBlockWriter::Instance().Write(fs_manager_->env(), path, pb),
+                          Substitute("Failed to write tablet metadata $0", tablet_id_));
+  } else {
+    RETURN_NOT_OK_PREPEND(pb_util::WritePBContainerToPath(
+                              fs_manager_->env(), path, pb,
+                              pb_util::OVERWRITE, pb_util::SYNC),
+                          Substitute("Failed to write tablet metadata $0", tablet_id_));
+  }
 
   return Status::OK();
 }
@@ -627,6 +804,14 @@ string TabletMetadata::wal_root_dir() const {
   }
 }
 
+void TabletMetadata::SetDataRootDir(const string& new_data_root_dir) {
+  std::lock_guard<LockType> l(data_lock_);
+  const auto old_data_root_dir = data_root_dir();
+  CHECK(HasPrefixString(rocksdb_dir_, old_data_root_dir + "/")) << rocksdb_dir_;
+  rocksdb_dir_ = JoinPathSegments(new_data_root_dir,
+                                  rocksdb_dir_.substr(old_data_root_dir.size() + 1));
+}
+
 void TabletMetadata::set_tablet_data_state(TabletDataState state) {
   std::lock_guard<LockType> l(data_lock_);
   tablet_data_state_ = state;
@@ -135,6 +135,14 @@ class TabletMetadata : public RefCountedThreadSafe<TabletMetadata> {
 
   std::string rocksdb_dir() const { return rocksdb_dir_; }
 
+  // Directory where SST files of the tombstoned tablet are kept, so that a later remote bootstrap
+  // of the tablet could reuse them instead of downloading.
+  std::string reusable_rocksdb_files_dir() const { return rocksdb_dir_ + ".reuse"; }
+
+  // Directory where files uploaded by bulk loads are kept until they are ingested, each load in its
+  // own subdirectory.
+  std::string bulk_load_dir() const { return rocksdb_dir_ + ".bulk_load"; }
+
   std::string wal_dir() const { return wal_dir_; }
 
   // Given the data directory of a tablet, returns the data root dir for that tablet.
@@ -149,6 +157,11 @@ class TabletMetadata : public RefCountedThreadSafe<TabletMetadata> {
   //  Returns /mnt/d0/tserver/wal1/wals
   std::string wal_root_dir() const;
 
+  // Switches the tablet to a copy of its RocksDB directory under new_data_root_dir, keeping the
+  // path relative to the data root dir. Only used before the tablet is opened, since rocksdb_dir()
+  // is read without locking. The caller should copy the data and flush the metadata.
+  void SetDataRootDir(const std::string& new_data_root_dir);
+
   uint32_t schema_version() const;
 
   void SetSchema(const Schema& schema, uint32_t version);
@@ -216,6 +229,9 @@ class TabletMetadata : public RefCountedThreadSafe<TabletMetadata> {
   // in such a case, 'was_deleted' will be set to FALSE.
   CHECKED_STATUS DeleteTabletData(TabletDataState delete_type, const yb::OpId& last_logged_opid);
 
+  // Removes the directory with SST files kept for reuse, if any.
+  CHECKED_STATUS DeleteReusableRocksDBFiles();
+
   // Permanently deletes the superblock from the disk.
   // DeleteTabletData() must first be called and the tablet data state must be
   // TABLET_DATA_DELETED.
@@ -278,6 +294,9 @@ class TabletMetadata : public RefCountedThreadSafe<TabletMetadata> {
 
   CHECKED_STATUS LoadFromDisk();
 
+  // Hard links SST files of the tablet to reusable_rocksdb_files_dir().
+  CHECKED_STATUS KeepRocksDBFilesForReuse();
+
   // Update state of metadata to that of the given superblock PB.
   CHECKED_STATUS LoadFromSuperBlock(const TabletSuperBlockPB& superblock);
 
@@ -62,6 +62,13 @@ METRIC_DEFINE_histogram(tablet, snapshot_read_inflight_wait_duration,
   "Time spent waiting for in-flight writes to complete for READ_AT_SNAPSHOT scans.",
   60000000LU, 2);
 
+METRIC_DEFINE_histogram(tablet, safe_time_wait_duration,
+  "Time Waiting For Safe Time",
+  yb::MetricUnit::kMicroseconds,
+  "Time spent by reads waiting for the leader lease and the safe time to read at, including "
+  "waiting for in-flight writes.",
+  60000000LU, 2);
+
 METRIC_DEFINE_histogram(
     tablet, redis_read_latency, "HandleRedisReadRequest latency", yb::MetricUnit::kMicroseconds,
     "Time taken to handle a RedisReadRequest", 60000000LU, 2);
@@ -109,6 +116,27 @@ METRIC_DEFINE_counter(tablet, leader_memory_pressure_rejections,
   yb::MetricUnit::kRequests,
   "Number of RPC requests rejected due to memory pressure while LEADER.");
 
+METRIC_DEFINE_counter(tablet, ql_row_cache_hits,
+  "QL Row Cache Hits",
+  yb::MetricUnit::kRequests,
+  "Number of point reads served from the row cache of the tablet.");
+
+METRIC_DEFINE_counter(tablet, ql_row_cache_misses,
+  "QL Row Cache Misses",
+  yb::MetricUnit::kRequests,
+  "Number of point reads eligible for the row cache of the tablet, that were not found in it.");
+
+METRIC_DEFINE_gauge_uint64(tablet, intents_cleanup_pending_transactions,
+  "Intents Cleanup Pending Transactions",
+  yb::MetricUnit::kTransactions,
+  "Number of applied transactions whose intents are waiting for background cleanup.");
+
+METRIC_DEFINE_histogram(tablet, intents_cleanup_batch_transactions,
+  "Intents Cleanup Batch Transactions",
+  yb::MetricUnit::kTransactions,
+  "Number of applied transactions whose intents were deleted by a single write batch.",
+  100000LU, 2);
+
 using strings::Substitute;
 
 namespace yb {
@@ -117,11 +145,17 @@ namespace tablet {
 #define MINIT(x) x(METRIC_##x.Instantiate(entity))
 TabletMetrics::TabletMetrics(const scoped_refptr<MetricEntity>& entity)
   : MINIT(snapshot_read_inflight_wait_duration),
+    MINIT(safe_time_wait_duration),
     MINIT(redis_read_latency),
     MINIT(ql_read_latency),
     MINIT(write_lock_latency),
     MINIT(write_op_duration_client_propagated_consistency),
-    MINIT(leader_memory_pressure_rejections) {
+    MINIT(leader_memory_pressure_rejections),
+    MINIT(ql_row_cache_hits),
+    MINIT(ql_row_cache_misses),
+    MINIT(intents_cleanup_batch_transactions) {
+  intents_cleanup_pending_transactions =
+      METRIC_intents_cleanup_pending_transactions.Instantiate(entity, 0);
 }
 #undef MINIT
 
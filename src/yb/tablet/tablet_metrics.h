@@ -54,6 +54,7 @@ struct TabletMetrics {
   // Probe stats
   scoped_refptr<Histogram> commit_wait_duration;
   scoped_refptr<Histogram> snapshot_read_inflight_wait_duration;
+  scoped_refptr<Histogram> safe_time_wait_duration;
   scoped_refptr<Histogram> redis_read_latency;
   scoped_refptr<Histogram> ql_read_latency;
   scoped_refptr<Histogram> write_lock_latency;
@@ -61,6 +62,11 @@ struct TabletMetrics {
   scoped_refptr<Histogram> write_op_duration_commit_wait_consistency;
 
   scoped_refptr<Counter> leader_memory_pressure_rejections;
+  scoped_refptr<Counter> ql_row_cache_hits;
+  scoped_refptr<Counter> ql_row_cache_misses;
+
+  scoped_refptr<AtomicGauge<uint64_t>> intents_cleanup_pending_transactions;
+  scoped_refptr<Histogram> intents_cleanup_batch_transactions;
 };
 
 class ScopedTabletMetricsTracker {
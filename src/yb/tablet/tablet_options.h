@@ -17,15 +17,25 @@ namespace rocksdb {
 class Cache;
 class EventListener;
 class MemoryMonitor;
+class RateLimiter;
+class SecondaryBlockCache;
 }
 
 namespace yb {
+
+class ThreadPool;
+
 namespace tablet {
 
 struct TabletOptions {
   std::shared_ptr<rocksdb::Cache> block_cache;
+  std::shared_ptr<rocksdb::SecondaryBlockCache> secondary_block_cache;
   std::shared_ptr<rocksdb::MemoryMonitor> memory_monitor;
+  // Rate limiter of flushes and compactions shared by all tablets, if not null.
+  std::shared_ptr<rocksdb::RateLimiter> rate_limiter;
   std::vector<std::shared_ptr<rocksdb::EventListener>> listeners;
+  // Pool used to delete intents of applied transactions in background, if not null.
+  ThreadPool* intents_cleanup_pool = nullptr;
 };
 
 } // namespace tablet
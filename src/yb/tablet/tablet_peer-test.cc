@@ -64,6 +64,7 @@
 METRIC_DECLARE_entity(tablet);
 
 DECLARE_int32(log_min_seconds_to_retain);
+DECLARE_bool(tablet_prepare_write_batch_before_apply);
 
 namespace yb {
 namespace tablet {
@@ -154,7 +155,9 @@ class TabletPeerTest : public YBTabletTest,
     scoped_refptr<Log> log;
     ASSERT_OK(Log::Open(LogOptions(), fs_manager(), tablet()->tablet_id(),
                         tablet()->metadata()->wal_dir(), *tablet()->schema(),
-                        tablet()->metadata()->schema_version(), metric_entity_.get(), &log));
+                        tablet()->metadata()->schema_version(), metric_entity_.get(),
+                        nullptr /* append_thread_pool */,
+                        &log));
 
     tablet_peer_->SetBootstrapping();
     ASSERT_OK(tablet_peer_->InitTabletPeer(tablet(),
@@ -440,6 +443,24 @@ TEST_P(TabletPeerTest, TestActiveOperationPreventsLogGC) {
   ASSERT_EQ(5, segments.size());
 }
 
+// Ensure that writes encoded before apply end up in the tablet.
+TEST_P(TabletPeerTest, TestPrepareWriteBatchBeforeApply) {
+  FLAGS_tablet_prepare_write_batch_before_apply = true;
+  ConsensusBootstrapInfo info;
+  ASSERT_OK(StartPeer(info));
+
+  constexpr int kNumInserts = 5;
+  ASSERT_OK(ExecuteInsertsAndRollLogs(kNumInserts));
+  std::vector<std::string> rows;
+  ASSERT_OK(DumpTablet(*tablet_peer_->tablet(), *tablet_peer_->tablet()->schema(), &rows));
+  ASSERT_EQ(kNumInserts, rows.size());
+
+  ASSERT_OK(ExecuteDeletesAndRollLogs(kNumInserts));
+  rows.clear();
+  ASSERT_OK(DumpTablet(*tablet_peer_->tablet(), *tablet_peer_->tablet()->schema(), &rows));
+  ASSERT_EQ(0, rows.size());
+}
+
 TEST_P(TabletPeerTest, TestGCEmptyLog) {
   ConsensusBootstrapInfo info;
   ASSERT_OK(tablet_peer_->Start(info));
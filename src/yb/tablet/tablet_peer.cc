@@ -67,11 +67,13 @@
 #include "yb/tablet/tablet_peer_mm_ops.h"
 
 #include "yb/tablet/operations/alter_schema_operation.h"
+#include "yb/tablet/operations/bulk_load_operation.h"
 #include "yb/tablet/operations/operation_driver.h"
 #include "yb/tablet/operations/truncate_operation.h"
 #include "yb/tablet/operations/write_operation.h"
 #include "yb/tablet/operations/update_txn_operation.h"
 
+#include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
 #include "yb/util/metrics.h"
 #include "yb/util/stopwatch.h"
@@ -81,6 +83,14 @@
 using std::shared_ptr;
 using std::string;
 
+DEFINE_int32(follower_apply_batch_max_ops, 128,
+             "Maximum number of non-transactional write operations committed by a single "
+             "consensus update that a follower applies to RocksDB with one write batch. Values "
+             "less than 2 disable batching.");
+TAG_FLAG(follower_apply_batch_max_ops, advanced);
+
+DECLARE_int32(cache_hints_max_keys);
+
 namespace yb {
 namespace tablet {
 
@@ -240,6 +250,11 @@ Status TabletPeer::InitTabletPeer(const shared_ptr<TabletClass> &tablet,
       return mvcc_manager->SafeTime(ht_lease);
     });
 
+    auto* tablet = tablet_.get();
+    consensus_->SetCacheHintsProvider([tablet] {
+      return tablet->CacheHintKeys();
+    });
+
     consensus_->SetMajorityReplicatedListener([mvcc_manager, ht_lease_provider] {
       auto ht_lease = ht_lease_provider(0, MonoTime::kMax);
       if (ht_lease) {
@@ -542,6 +557,9 @@ consensus::OperationType MapOperationTypeToPB(OperationType operation_type) {
     case OperationType::kTruncate:
       return consensus::TRUNCATE_OP;
 
+    case OperationType::kBulkLoad:
+      return consensus::BULK_LOAD_OP;
+
     case OperationType::kEmpty:
       LOG(FATAL) << "OperationType::kEmpty cannot be converted to consensus::OperationType";
   }
@@ -622,7 +640,8 @@ Status TabletPeer::GetEarliestNeededLogIndex(int64_t* min_index) const {
   // Check whether we had writes after last persistent entry.
   // Note that last_committed_write_index could be zero if logs were cleaned before restart.
   // So correct check is 'less', and NOT 'not equals to'.
-  if (max_persistent_index < last_committed_write_index) {
+  // A log-only replica does not persist writes anywhere but in the log, so it does not wait for it.
+  if (max_persistent_index < last_committed_write_index && !tablet_->log_only()) {
     *min_index = std::min(*min_index, max_persistent_index);
   }
 
@@ -683,6 +702,12 @@ std::unique_ptr<Operation> TabletPeer::CreateOperation(consensus::ReplicateMsg*
       return std::make_unique<TruncateOperation>(
           std::make_unique<TruncateOperationState>(tablet()), consensus::REPLICA);
 
+    case consensus::BULK_LOAD_OP:
+      DCHECK(replicate_msg->has_bulk_load_request()) << "BULK_LOAD_OP replica"
+          " operation must receive an IngestBulkLoadRequestPB";
+      return std::make_unique<BulkLoadOperation>(
+          std::make_unique<BulkLoadOperationState>(tablet()), consensus::REPLICA);
+
     case consensus::SNAPSHOT_OP: FALLTHROUGH_INTENDED;
     case consensus::UNKNOWN_OP: FALLTHROUGH_INTENDED;
     case consensus::NO_OP: FALLTHROUGH_INTENDED;
@@ -740,6 +765,33 @@ void TabletPeer::SetPropagatedSafeTime(HybridTime ht) {
   (**driver).ExecuteAsync();
 }
 
+void TabletPeer::StartApplyBatch() {
+  if (FLAGS_follower_apply_batch_max_ops > 1) {
+    apply_batch_ = std::make_unique<OperationApplyBatch>(FLAGS_follower_apply_batch_max_ops);
+  }
+}
+
+void TabletPeer::FinishApplyBatch() {
+  apply_batch_.reset();
+}
+
+void TabletPeer::WarmCache(const google::protobuf::RepeatedPtrField<std::string>& keys) {
+  auto tablet = shared_tablet();
+  if (!tablet || cache_warming_running_.exchange(true)) {
+    return;
+  }
+  const auto max_keys = std::min<size_t>(keys.size(), std::max(FLAGS_cache_hints_max_keys, 0));
+  std::vector<std::string> hinted_keys(keys.begin(), keys.begin() + max_keys);
+  scoped_refptr<TabletPeer> self(this);
+  auto status = apply_pool_->SubmitFunc([self, tablet, hinted_keys] {
+    tablet->WarmBlockCache(hinted_keys);
+    self->cache_warming_running_ = false;
+  });
+  if (!status.ok()) {
+    cache_warming_running_ = false;
+  }
+}
+
 const std::string& TabletPeer::permanent_uuid() const {
   if (cached_permanent_uuid_initialized_.load(std::memory_order_acquire)) {
     return cached_permanent_uuid_;
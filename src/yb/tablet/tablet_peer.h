@@ -33,6 +33,7 @@
 #ifndef YB_TABLET_TABLET_PEER_H_
 #define YB_TABLET_TABLET_PEER_H_
 
+#include <atomic>
 #include <future>
 #include <map>
 #include <memory>
@@ -81,6 +82,8 @@ class ThreadPool;
 
 namespace tablet {
 
+class OperationApplyBatch;
+
 // A peer in a tablet consensus configuration, which coordinates writes to tablets.
 // Each time Write() is called this class appends a new entry to a replicated
 // state machine through a consensus algorithm, which makes sure that other
@@ -156,6 +159,12 @@ class TabletPeer : public RefCountedThreadSafe<TabletPeer>,
   // UpdateReplica -> EnqueuePreparesUnlocked on Raft heartbeats.
   void SetPropagatedSafeTime(HybridTime ht) override;
 
+  void StartApplyBatch() override;
+  void FinishApplyBatch() override;
+
+  // Reads the hinted keys on the apply pool, unless the previous hint is still being handled.
+  void WarmCache(const google::protobuf::RepeatedPtrField<std::string>& keys) override;
+
   consensus::Consensus* consensus() const;
 
   scoped_refptr<consensus::Consensus> shared_consensus() const;
@@ -341,6 +350,13 @@ class TabletPeer : public RefCountedThreadSafe<TabletPeer>,
 
   std::unique_ptr<Preparer> prepare_thread_;
 
+  // Follower writes committed by the current consensus update, only accessed by consensus while it
+  // holds the replica state lock.
+  std::unique_ptr<OperationApplyBatch> apply_batch_;
+
+  // Whether a task warming the block cache with keys hinted by the leader is running.
+  std::atomic<bool> cache_warming_running_{false};
+
   // Pool that executes apply tasks for transactions. This is a multi-threaded
   // pool, constructor-injected by either the Master (for system tables) or
   // the Tablet server.
@@ -57,6 +57,11 @@
 DECLARE_uint64(transaction_heartbeat_usec);
 DEFINE_uint64(transaction_timeout_usec, 1500000, "Transaction expiration timeout in usec.");
 DEFINE_uint64(transaction_check_interval_usec, 500000, "Transaction check interval in usec.");
+DEFINE_uint64(transaction_heartbeat_replication_interval_usec, 10000000,
+              "Heartbeats of a running transaction only extend its lease in memory of the status "
+              "tablet leader. One heartbeat per this interval is replicated through Raft, so the "
+              "transaction does not keep old log segments from being GCed. 0 means that every "
+              "heartbeat is replicated.");
 DEFINE_double(transaction_ignore_applying_probability_in_tests, 0,
               "Probability to ignore APPLYING update in tests.");
 
@@ -153,6 +158,14 @@ class TransactionState {
     return passed > FLAGS_transaction_timeout_usec;
   }
 
+  // Gives transaction a full timeout to send the next heartbeat, used when this tablet becomes
+  // leader, because heartbeats received by the previous leader may not have been replicated.
+  void ExtendLease(HybridTime now) {
+    if (status_ == TransactionStatus::PENDING) {
+      last_touch_ = std::max(last_touch_, now);
+    }
+  }
+
   // Whether this transaction has completed.
   bool Completed() const {
     return status_ == TransactionStatus::ABORTED ||
@@ -209,13 +222,14 @@ class TransactionState {
 
   CHECKED_STATUS GetStatus(tserver::GetTransactionStatusResponsePB* response) const {
     if (status_ == TransactionStatus::COMMITTED) {
-      response->set_status(TransactionStatus::COMMITTED);
-      response->set_status_hybrid_time(commit_time_.ToUint64());
+      response->add_status(TransactionStatus::COMMITTED);
+      response->add_status_hybrid_time(commit_time_.ToUint64());
     } else if (status_ == TransactionStatus::ABORTED) {
-      response->set_status(TransactionStatus::ABORTED);
+      response->add_status(TransactionStatus::ABORTED);
+      response->add_status_hybrid_time(HybridTime::kMax.ToUint64());
     } else {
       CHECK_EQ(TransactionStatus::PENDING, status_);
-      response->set_status(TransactionStatus::PENDING);
+      response->add_status(TransactionStatus::PENDING);
       HybridTime status_ht = context_.coordinator_context().clock().Now();
       if (replicating_) {
         auto replicating_status = replicating_->request()->status();
@@ -228,7 +242,7 @@ class TransactionState {
         }
       }
       status_ht = std::min(status_ht, context_.coordinator_context().HtLeaseExpiration());
-      response->set_status_hybrid_time(status_ht.Decremented().ToUint64());
+      response->add_status_hybrid_time(status_ht.Decremented().ToUint64());
     }
     return Status::OK();
   }
@@ -356,6 +370,13 @@ class TransactionState {
             "Transaction in wrong state during heartbeat: $0",
             TransactionStatus_Name(status_));
       } else {
+        auto now = context_.coordinator_context().clock().Now();
+        if (!HeartbeatShouldBeReplicated(now)) {
+          // Heartbeat just extends lease of the transaction, so it does not go through Raft.
+          last_touch_ = std::max(last_touch_, now);
+          request->completion_callback()->CompleteWithStatus(Status::OK());
+          return;
+        }
         status = Status::OK();
       }
     } else {
@@ -372,6 +393,12 @@ class TransactionState {
     CHECK(submitted);
   }
 
+  bool HeartbeatShouldBeReplicated(HybridTime now) const {
+    return !replicated_touch_.is_valid() ||
+           now.GetPhysicalValueMicros() - replicated_touch_.GetPhysicalValueMicros() >=
+               FLAGS_transaction_heartbeat_replication_interval_usec;
+  }
+
   CHECKED_STATUS HandleCommit() {
     auto hybrid_time = context_.coordinator_context().clock().Now();
     if (ExpiredAt(hybrid_time)) {
@@ -462,7 +489,8 @@ class TransactionState {
       return Status::OK();
     }
     CHECK_EQ(status_, TransactionStatus::PENDING) << "Transaction id: " << id_;
-    last_touch_ = data.hybrid_time;
+    last_touch_ = std::max(last_touch_, data.hybrid_time);
+    replicated_touch_ = data.hybrid_time;
     first_entry_raft_index_ = data.op_id.index();
     return Status::OK();
   }
@@ -481,7 +509,10 @@ class TransactionState {
   const TransactionId id_;
   const std::string log_prefix_;
   TransactionStatus status_ = TransactionStatus::PENDING;
+  // Could be ahead of the last replicated record, because heartbeats are mostly kept in memory.
   HybridTime last_touch_;
+  // Hybrid time of the last replicated PENDING or CREATED record.
+  HybridTime replicated_touch_;
   // It should match last_touch_, but it is possible that because of some code errors it
   // would not be so. To add stability we introduce a separate field for it.
   HybridTime commit_time_;
@@ -547,20 +578,24 @@ class TransactionCoordinator::Impl : public TransactionStateContext {
     rpcs_.Shutdown();
   }
 
-  CHECKED_STATUS GetStatus(const std::string& transaction_id,
+  CHECKED_STATUS GetStatus(const google::protobuf::RepeatedPtrField<std::string>& transaction_ids,
                            tserver::GetTransactionStatusResponsePB* response) {
-    auto id = FullyDecodeTransactionId(transaction_id);
-    if (!id.ok()) {
-      return std::move(id.status());
-    }
-
     std::lock_guard<std::mutex> lock(managed_mutex_);
-    auto it = managed_transactions_.find(*id);
-    if (it == managed_transactions_.end()) {
-      response->set_status(TransactionStatus::ABORTED);
-      return Status::OK();
+    for (const auto& transaction_id : transaction_ids) {
+      auto id = FullyDecodeTransactionId(transaction_id);
+      if (!id.ok()) {
+        return std::move(id.status());
+      }
+
+      auto it = managed_transactions_.find(*id);
+      if (it == managed_transactions_.end()) {
+        response->add_status(TransactionStatus::ABORTED);
+        response->add_status_hybrid_time(HybridTime::kMax.ToUint64());
+        continue;
+      }
+      RETURN_NOT_OK(it->GetStatus(response));
     }
-    return it->GetStatus(response);
+    return Status::OK();
   }
 
   void Abort(const std::string& transaction_id, TransactionAbortCallback callback) {
@@ -863,6 +898,16 @@ class TransactionCoordinator::Impl : public TransactionStateContext {
       }
       postponed_leader_actions_.leader = leader;
 
+      if (leader && !was_leader_) {
+        // Iterate by id, so reordering of last touch index does not affect iteration.
+        for (auto it = managed_transactions_.begin(); it != managed_transactions_.end(); ++it) {
+          managed_transactions_.modify(it, [now](TransactionState& state) {
+            state.ExtendLease(now);
+          });
+        }
+      }
+      was_leader_ = leader;
+
       auto& index = managed_transactions_.get<LastTouchTag>();
 
       for (auto it = index.begin(); it != index.end() && it->ExpiredAt(now);) {
@@ -897,6 +942,8 @@ class TransactionCoordinator::Impl : public TransactionStateContext {
   PostponedLeaderActions postponed_leader_actions_;
 
   bool closing_ = false;
+  // Whether this tablet was leader during the previous poll.
+  bool was_leader_ = false;
   rpc::ScheduledTaskId poll_task_id_ = rpc::kUninitializedScheduledTaskId;
   std::atomic<int64_t> running_polls_{0};
   std::condition_variable cond_;
@@ -945,9 +992,10 @@ void TransactionCoordinator::Shutdown() {
   impl_->Shutdown();
 }
 
-Status TransactionCoordinator::GetStatus(const std::string& transaction_id,
-                                         tserver::GetTransactionStatusResponsePB* response) {
-  return impl_->GetStatus(transaction_id, response);
+Status TransactionCoordinator::GetStatus(
+    const google::protobuf::RepeatedPtrField<std::string>& transaction_ids,
+    tserver::GetTransactionStatusResponsePB* response) {
+  return impl_->GetStatus(transaction_ids, response);
 }
 
 void TransactionCoordinator::Abort(const std::string& transaction_id,
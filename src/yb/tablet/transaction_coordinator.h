@@ -19,6 +19,8 @@
 #include <future>
 #include <memory>
 
+#include <google/protobuf/repeated_field.h>
+
 #include "yb/client/client_fwd.h"
 
 #include "yb/common/hybrid_time.h"
@@ -129,7 +131,8 @@ class TransactionCoordinator {
   // And like most of other Shutdowns in our codebase it wait until shutdown completes.
   void Shutdown();
 
-  CHECKED_STATUS GetStatus(const std::string& transaction_id,
+  // Fills status and status hybrid time of each transaction in the same order as transaction_ids.
+  CHECKED_STATUS GetStatus(const google::protobuf::RepeatedPtrField<std::string>& transaction_ids,
                            tserver::GetTransactionStatusResponsePB* response);
 
   void Abort(const std::string& transaction_id, TransactionAbortCallback callback);
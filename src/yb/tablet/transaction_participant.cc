@@ -15,7 +15,9 @@
 
 #include "yb/tablet/transaction_participant.h"
 
+#include <condition_variable>
 #include <mutex>
+#include <unordered_map>
 
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/hashed_index.hpp>
@@ -116,22 +118,35 @@ class Delayer {
   std::deque<std::pair<MonoTime, std::function<void()>>> queue_;
 };
 
+// Sends status requests of running transactions to their status tablets.
+class StatusRequestSender {
+ public:
+  // Requests status of transaction with specified id from status tablet. Response is delivered
+  // to RunningTransaction::StatusReceived with the same serial_no.
+  virtual void SendStatusRequest(
+      const TabletId& status_tablet, const TransactionId& id, int64_t serial_no) = 0;
+
+ protected:
+  ~StatusRequestSender() {}
+};
+
 class RunningTransaction {
  public:
   RunningTransaction(TransactionMetadata metadata,
                      rpc::Rpcs* rpcs,
                      TransactionParticipantContext* context,
+                     StatusRequestSender* status_request_sender,
                      std::atomic<int64_t>* request_serial)
       : metadata_(std::move(metadata)),
         rpcs_(*rpcs),
         context_(*context),
+        status_request_sender_(*status_request_sender),
         request_serial_(request_serial),
-        get_status_handle_(rpcs->InvalidHandle()),
         abort_handle_(rpcs->InvalidHandle()) {
   }
 
   ~RunningTransaction() {
-    rpcs_.Abort({&get_status_handle_, &abort_handle_});
+    rpcs_.Abort({&abort_handle_});
   }
 
   const TransactionId& id() const {
@@ -150,8 +165,7 @@ class RunningTransaction {
     local_commit_time_ = time;
   }
 
-  void RequestStatusAt(client::YBClient* client,
-                       const StatusRequest& request,
+  void RequestStatusAt(const StatusRequest& request,
                        std::unique_lock<std::mutex>* lock) const {
     if (last_known_status_hybrid_time_ > HybridTime::kMin) {
       auto transaction_status =
@@ -170,7 +184,7 @@ class RunningTransaction {
       return;
     }
     lock->unlock();
-    SendStatusRequest(client, lock->mutex());
+    SendStatusRequest();
   }
 
   void Abort(client::YBClient* client,
@@ -196,6 +210,24 @@ class RunningTransaction {
         &abort_handle_);
   }
 
+  // Invoked when status of this transaction was received. 'status_time' is status hybrid time
+  // from the response, or HybridTime::kMax for aborted transaction.
+  void StatusReceived(const Status& status,
+                      TransactionStatus response_status,
+                      HybridTime status_time,
+                      int64_t serial_no,
+                      std::mutex* mutex) const {
+    auto delay_usec = FLAGS_transaction_delay_status_reply_usec_in_tests;
+    if (delay_usec > 0) {
+      delayer_.Delay(
+          MonoTime::Now() + MonoDelta::FromMicroseconds(delay_usec),
+          std::bind(&RunningTransaction::DoStatusReceived, this, status, response_status,
+                    status_time, serial_no, mutex));
+    } else {
+      DoStatusReceived(status, response_status, status_time, serial_no, mutex);
+    }
+  }
+
  private:
   static boost::optional<TransactionStatus> GetStatusAt(
       HybridTime time,
@@ -218,48 +250,16 @@ class RunningTransaction {
     }
   }
 
-  void SendStatusRequest(client::YBClient* client, std::mutex* mutex) const {
-    tserver::GetTransactionStatusRequestPB req;
-    req.set_tablet_id(metadata_.status_tablet);
-    req.set_transaction_id(metadata_.transaction_id.begin(), metadata_.transaction_id.size());
-    req.set_propagated_hybrid_time(context_.Now().ToUint64());
-    int64_t serial_no = ++*request_serial_;
-    rpcs_.RegisterAndStart(
-        client::GetTransactionStatus(
-            TransactionRpcDeadline(),
-            nullptr /* tablet */,
-            client,
-            &req,
-            std::bind(&RunningTransaction::StatusReceived, this, client, _1, _2, serial_no, mutex)),
-        &get_status_handle_);
-  }
-
-  void StatusReceived(client::YBClient* client,
-                      const Status& status,
-                      const tserver::GetTransactionStatusResponsePB& response,
-                      int64_t serial_no,
-                      std::mutex* mutex) const {
-    auto delay_usec = FLAGS_transaction_delay_status_reply_usec_in_tests;
-    if (delay_usec > 0) {
-      delayer_.Delay(
-          MonoTime::Now() + MonoDelta::FromMicroseconds(delay_usec),
-          std::bind(&RunningTransaction::DoStatusReceived, this, client, status, response,
-                    serial_no, mutex));
-    } else {
-      DoStatusReceived(client, status, response, serial_no, mutex);
-    }
+  void SendStatusRequest() const {
+    status_request_sender_.SendStatusRequest(
+        metadata_.status_tablet, metadata_.transaction_id, ++*request_serial_);
   }
 
-  void DoStatusReceived(client::YBClient* client,
-                        const Status& status,
-                        const tserver::GetTransactionStatusResponsePB& response,
+  void DoStatusReceived(const Status& status,
+                        TransactionStatus response_status,
+                        HybridTime status_time,
                         int64_t serial_no,
                         std::mutex* mutex) const {
-    if (response.has_propagated_hybrid_time()) {
-      context_.UpdateClock(HybridTime(response.propagated_hybrid_time()));
-    }
-
-    rpcs_.Unregister(&get_status_handle_);
     decltype(status_waiters_) status_waiters;
     HybridTime time;
     TransactionStatus transaction_status;
@@ -268,14 +268,11 @@ class RunningTransaction {
     {
       std::unique_lock<std::mutex> lock(*mutex);
       if (ok) {
-        DCHECK(response.has_status_hybrid_time() ||
-               response.status() == TransactionStatus::ABORTED);
-        time = response.has_status_hybrid_time()
-            ? HybridTime(response.status_hybrid_time())
-            : HybridTime::kMax;
+        DCHECK(status_time != HybridTime::kMax || response_status == TransactionStatus::ABORTED);
+        time = status_time;
         if (last_known_status_hybrid_time_ <= time) {
           last_known_status_hybrid_time_ = time;
-          last_known_status_ = response.status();
+          last_known_status_ = response_status;
         }
         time = last_known_status_hybrid_time_;
         transaction_status = last_known_status_;
@@ -301,7 +298,7 @@ class RunningTransaction {
       send_new_request = !status_waiters_.empty();
     }
     if (send_new_request) {
-      SendStatusRequest(client, mutex);
+      SendStatusRequest();
     }
     if (!ok) {
       for (const auto& waiter : status_waiters) {
@@ -368,13 +365,13 @@ class RunningTransaction {
   TransactionMetadata metadata_;
   rpc::Rpcs& rpcs_;
   TransactionParticipantContext& context_;
+  StatusRequestSender& status_request_sender_;
   std::atomic<int64_t>* request_serial_;
   HybridTime local_commit_time_ = HybridTime::kInvalid;
 
   mutable TransactionStatus last_known_status_;
   mutable HybridTime last_known_status_hybrid_time_ = HybridTime::kMin;
   mutable std::vector<StatusRequest> status_waiters_;
-  mutable rpc::Rpcs::Handle get_status_handle_;
   mutable rpc::Rpcs::Handle abort_handle_;
   mutable std::vector<TransactionStatusCallback> abort_waiters_;
 
@@ -384,14 +381,15 @@ class RunningTransaction {
 
 } // namespace
 
-class TransactionParticipant::Impl {
+class TransactionParticipant::Impl : public StatusRequestSender {
  public:
   explicit Impl(TransactionParticipantContext* context)
       : context_(*context), log_prefix_(context->tablet_id() + ": ") {}
 
   ~Impl() {
-    transactions_.clear();
+    // Status responses refer to transactions, so rpcs are shut down first.
     rpcs_.Shutdown();
+    transactions_.clear();
   }
 
   // Adds new running transaction.
@@ -406,7 +404,7 @@ class TransactionParticipant::Impl {
       std::lock_guard<std::mutex> lock(mutex_);
       auto it = transactions_.find(metadata->transaction_id);
       if (it == transactions_.end()) {
-        transactions_.emplace(*metadata, &rpcs_, &context_, &request_serial_);
+        transactions_.emplace(*metadata, &rpcs_, &context_, this, &request_serial_);
         store = true;
       } else {
         DCHECK_EQ(it->metadata(), *metadata);
@@ -447,7 +445,7 @@ class TransactionParticipant::Impl {
           STATUS_FORMAT(NotFound, "Request status of unknown transaction: $0", *request.id));
       return;
     }
-    return it->RequestStatusAt(client(), request, &lock);
+    return it->RequestStatusAt(request, &lock);
   }
 
   int64_t RegisterRequest() {
@@ -489,6 +487,7 @@ class TransactionParticipant::Impl {
         transactions_.modify(it, [&data](RunningTransaction& transaction) {
           transaction.SetLocalCommitTime(data.commit_ht);
         });
+        transactions_changed_.notify_all();
         // TODO(dtxn) cleanup
       }
       if (data.mode == ProcessingMode::LEADER) {
@@ -522,7 +521,126 @@ class TransactionParticipant::Impl {
     db_ = db;
   }
 
+  void WaitForTransactionsChange(MonoTime deadline) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    transactions_changed_.wait_until(lock, deadline.ToSteadyTimePoint());
+  }
+
+  // While status request to a status tablet is in flight, further requests to this tablet are
+  // queued and then sent in a single batch, so status tablet is not flooded with tiny requests.
+  void SendStatusRequest(
+      const TabletId& status_tablet, const TransactionId& id, int64_t serial_no) override {
+    StatusRequestBatch batch;
+    {
+      std::lock_guard<std::mutex> lock(status_requests_mutex_);
+      auto& requests = status_requests_[status_tablet];
+      requests.queued.push_back({id, serial_no});
+      if (requests.in_flight) {
+        return;
+      }
+      requests.in_flight = true;
+      batch.swap(requests.queued);
+    }
+    DoSendStatusRequests(status_tablet, std::move(batch));
+  }
+
  private:
+  struct QueuedStatusRequest {
+    TransactionId id;
+    int64_t serial_no;
+  };
+
+  typedef std::vector<QueuedStatusRequest> StatusRequestBatch;
+
+  struct StatusTabletRequests {
+    // Whether there is status request to this tablet in flight.
+    bool in_flight = false;
+
+    // Requests that will be sent after the request in flight completes.
+    StatusRequestBatch queued;
+  };
+
+  void DoSendStatusRequests(const TabletId& status_tablet, StatusRequestBatch batch) {
+    tserver::GetTransactionStatusRequestPB req;
+    req.set_tablet_id(status_tablet);
+    for (const auto& request : batch) {
+      req.add_transaction_id(request.id.begin(), request.id.size());
+    }
+    req.set_propagated_hybrid_time(context_.Now().ToUint64());
+
+    auto handle = rpcs_.Prepare();
+    if (handle == rpcs_.InvalidHandle()) {
+      // Shutting down.
+      return;
+    }
+    *handle = client::GetTransactionStatus(
+        TransactionRpcDeadline(),
+        nullptr /* tablet */,
+        client(),
+        &req,
+        [this, handle, status_tablet, batch = std::move(batch)](
+            const Status& status, const tserver::GetTransactionStatusResponsePB& response) {
+          rpcs_.Unregister(handle);
+          StatusReceived(status_tablet, batch, status, response);
+        });
+    (**handle).SendRpc();
+  }
+
+  void StatusReceived(const TabletId& status_tablet,
+                      const StatusRequestBatch& batch,
+                      Status status,
+                      const tserver::GetTransactionStatusResponsePB& response) {
+    if (response.has_propagated_hybrid_time()) {
+      context_.UpdateClock(HybridTime(response.propagated_hybrid_time()));
+    }
+
+    const int batch_size = static_cast<int>(batch.size());
+    if (status.ok() && (response.status_size() != batch_size ||
+                        response.status_hybrid_time_size() != batch_size)) {
+      status = STATUS_FORMAT(
+          IllegalState, "Wrong number of statuses in response: $0, expected: $1",
+          response.status_size(), batch_size);
+    }
+    for (int i = 0; i != batch_size; ++i) {
+      const RunningTransaction* transaction;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = transactions_.find(batch[i].id);
+        if (it == transactions_.end()) {
+          continue;
+        }
+        transaction = &*it;
+      }
+      if (status.ok()) {
+        transaction->StatusReceived(
+            status, response.status(i), HybridTime(response.status_hybrid_time(i)),
+            batch[i].serial_no, &mutex_);
+      } else {
+        transaction->StatusReceived(
+            status, TransactionStatus::PENDING, HybridTime::kInvalid, batch[i].serial_no,
+            &mutex_);
+      }
+    }
+
+    {
+      // Conflict resolution waiting for conflicting transactions should recheck their statuses.
+      std::lock_guard<std::mutex> lock(mutex_);
+      transactions_changed_.notify_all();
+    }
+
+    StatusRequestBatch next_batch;
+    {
+      std::lock_guard<std::mutex> lock(status_requests_mutex_);
+      auto& requests = status_requests_[status_tablet];
+      if (requests.queued.empty()) {
+        requests.in_flight = false;
+        return;
+      }
+      next_batch.swap(requests.queued);
+    }
+    DoSendStatusRequests(status_tablet, std::move(next_batch));
+  }
+
   typedef boost::multi_index_container<RunningTransaction,
       boost::multi_index::indexed_by <
           boost::multi_index::hashed_unique <
@@ -565,7 +683,8 @@ class TransactionParticipant::Impl {
       return it;
     }
 
-    it = transactions_.emplace(std::move(*metadata), &rpcs_, &context_, &request_serial_).first;
+    it = transactions_.emplace(
+        std::move(*metadata), &rpcs_, &context_, this, &request_serial_).first;
 
     return it;
   }
@@ -583,9 +702,14 @@ class TransactionParticipant::Impl {
 
   rocksdb::DB* db_ = nullptr;
   std::mutex mutex_;
+  // Notified under mutex_ when transaction is applied or its status is received.
+  std::condition_variable transactions_changed_;
   rpc::Rpcs rpcs_;
   Transactions transactions_;
   std::atomic<int64_t> request_serial_{0};
+
+  std::mutex status_requests_mutex_;
+  std::unordered_map<TabletId, StatusTabletRequests> status_requests_;
 };
 
 TransactionParticipant::TransactionParticipant(TransactionParticipantContext* context)
@@ -625,6 +749,10 @@ CHECKED_STATUS TransactionParticipant::ProcessApply(const TransactionApplyData&
   return impl_->ProcessApply(data);
 }
 
+void TransactionParticipant::WaitForTransactionsChange(MonoTime deadline) {
+  impl_->WaitForTransactionsChange(deadline);
+}
+
 void TransactionParticipant::SetDB(rocksdb::DB* db) {
   impl_->SetDB(db);
 }
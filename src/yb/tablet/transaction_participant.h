@@ -29,6 +29,8 @@
 
 #include "yb/consensus/opid_util.h"
 
+#include "yb/docdb/intents_index.h"
+
 #include "yb/util/opid.pb.h"
 #include "yb/util/result.h"
 
@@ -102,11 +104,19 @@ class TransactionParticipant : public TransactionStatusManager {
 
   CHECKED_STATUS ProcessApply(const TransactionApplyData& data);
 
+  void WaitForTransactionsChange(MonoTime deadline) override;
+
   void SetDB(rocksdb::DB* db);
 
+  // In-memory index of intents of this tablet, used for conflict resolution.
+  docdb::IntentsIndex* intents_index() {
+    return &intents_index_;
+  }
+
  private:
   class Impl;
   std::unique_ptr<Impl> impl_;
+  docdb::IntentsIndex intents_index_;
 };
 
 } // namespace tablet
@@ -126,7 +126,7 @@ void ClusterAdminCli::RegisterCommandHandlers(ClusterAdminClientClass* client) {
 
   Register(
       "change_config",
-      " <tablet_id> <ADD_SERVER|REMOVE_SERVER> <peer_uuid> [PRE_VOTER|PRE_OBSERVER]",
+      " <tablet_id> <ADD_SERVER|REMOVE_SERVER> <peer_uuid> [PRE_VOTER|PRE_OBSERVER|LOG_ONLY]",
       [client](const CLIArguments& args) -> Status {
         if (args.size() < 5) {
           UsageAndExit(args[0]);
@@ -279,6 +279,17 @@ void ClusterAdminCli::RegisterCommandHandlers(ClusterAdminClientClass* client) {
         return Status::OK();
       });
 
+  Register(
+      "drain_leaders", " <tserver_uuid>",
+      [client](const CLIArguments& args) -> Status {
+        if (args.size() != 3) {
+          UsageAndExit(args[0]);
+        }
+        RETURN_NOT_OK_PREPEND(client->DrainLeaders(args[2]),
+                              Substitute("Unable to drain leaders of $0", args[2]));
+        return Status::OK();
+      });
+
   Register(
       "list_leader_counts", " <keyspace> <table_name>",
       [client](const CLIArguments& args) -> Status {
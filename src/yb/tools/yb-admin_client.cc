@@ -234,6 +234,11 @@ Status ClusterAdminClient::ChangeConfig(
     RaftPeerPB::MemberType member_type_val;
     string uppercase_member_type;
     ToUpperCase(*member_type, &uppercase_member_type);
+    // A log-only replica is added as a PRE_VOTER, that stays log-only after it is promoted.
+    if (uppercase_member_type == "LOG_ONLY") {
+      uppercase_member_type = RaftPeerPB::MemberType_Name(RaftPeerPB::PRE_VOTER);
+      peer_pb.set_log_only(true);
+    }
     if (!RaftPeerPB::MemberType_Parse(uppercase_member_type, &member_type_val)) {
       return STATUS(InvalidArgument, "Unrecognized member_type", *member_type);
     }
@@ -348,6 +353,26 @@ Status ClusterAdminClient::GetLoadMoveCompletion() {
   return Status::OK();
 }
 
+Status ClusterAdminClient::DrainLeaders(const std::string& ts_uuid) {
+  CHECK(initted_);
+  master::DrainLeadersRequestPB req;
+  master::DrainLeadersResponsePB resp;
+  req.set_ts_uuid(ts_uuid);
+
+  RpcController rpc;
+  rpc.set_timeout(timeout_);
+  RETURN_NOT_OK(master_proxy_->DrainLeaders(req, &resp, &rpc));
+
+  if (resp.has_error()) {
+    return StatusFromPB(resp.error().status());
+  }
+  std::cout << "Started " << resp.num_transfers() << " leader transfers" << std::endl;
+  for (const auto& tablet_id : resp.tablets_without_target()) {
+    std::cout << "No eligible new leader for tablet " << tablet_id << std::endl;
+  }
+  return Status::OK();
+}
+
 Status ClusterAdminClient::ListLeaderCounts(const YBTableName& table_name) {
   vector<string> tablet_ids, ranges;
   RETURN_NOT_OK(yb_client_->GetTablets(table_name, 0, &tablet_ids, &ranges));
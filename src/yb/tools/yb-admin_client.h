@@ -126,6 +126,9 @@ class ClusterAdminClient {
 
   CHECKED_STATUS GetLoadMoveCompletion();
 
+  // Move all tablet leaders off the given tablet server.
+  CHECKED_STATUS DrainLeaders(const std::string& ts_uuid);
+
   CHECKED_STATUS ListLeaderCounts(const client::YBTableName& table_name);
 
   CHECKED_STATUS SetupRedisTable();
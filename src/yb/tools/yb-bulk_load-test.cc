@@ -16,6 +16,7 @@
 #include <gtest/gtest.h>
 #include <boost/algorithm/string.hpp>
 
+#include "yb/client/bulk_load.h"
 #include "yb/client/client.h"
 #include "yb/client/schema.h"
 #include "yb/client/table_handle.h"
@@ -368,12 +369,17 @@ class YBBulkLoadTest : public YBMiniClusterTestBase<MiniCluster> {
   Random random_;
 };
 
+YB_STRONGLY_TYPED_BOOL(IngestViaRaft);
+
 class YBBulkLoadTestWithoutRebalancing : public YBBulkLoadTest {
  public:
   void SetUp() override {
     FLAGS_enable_load_balancing = false;
     YBBulkLoadTest::SetUp();
   }
+
+ protected:
+  void TestCLITool(IngestViaRaft ingest_via_raft);
 };
 
 
@@ -406,7 +412,7 @@ TEST_F(YBBulkLoadTest, InvalidLines) {
   ASSERT_NOK(partition_generator_->LookupTabletId("123,123.2", &tablet_id, &partition_key));
 }
 
-TEST_F_EX(YBBulkLoadTest, TestCLITool, YBBulkLoadTestWithoutRebalancing) {
+void YBBulkLoadTestWithoutRebalancing::TestCLITool(IngestViaRaft ingest_via_raft) {
   string exe_path = GetToolPath(kPartitionToolName);
   vector<string> argv = {kPartitionToolName, "-master_addresses", master_addresses_comma_separated_,
       "-table_name", kTableName, "-namespace_name", kNamespace};
@@ -540,14 +546,21 @@ TEST_F_EX(YBBulkLoadTest, TestCLITool, YBBulkLoadTestWithoutRebalancing) {
     // Wait for load generator to generate some traffic.
     SleepFor(MonoDelta::FromSeconds(5));
 
-    // Import the data into the tserver.
-    tserver::ImportDataRequestPB import_req;
-    import_req.set_tablet_id(tablet_id);
-    import_req.set_source_dir(tablet_path);
-    tserver::ImportDataResponsePB import_resp;
-    rpc::RpcController controller;
-    ASSERT_OK(tserver_proxy->ImportData(import_req, &import_resp, &controller));
-    ASSERT_FALSE(import_resp.has_error()) << import_resp.DebugString();
+    if (ingest_via_raft) {
+      // Upload the data to all replicas and ingest it through Raft.
+      ASSERT_OK(client::BulkLoadTablet(
+          client_.get(), tablet_id, "test_load", tablet_path,
+          HybridTime::FromMicros(kYugaByteMicrosecondEpoch), MonoDelta::FromSeconds(60)));
+    } else {
+      // Import the data into the tserver.
+      tserver::ImportDataRequestPB import_req;
+      import_req.set_tablet_id(tablet_id);
+      import_req.set_source_dir(tablet_path);
+      tserver::ImportDataResponsePB import_resp;
+      rpc::RpcController controller;
+      ASSERT_OK(tserver_proxy->ImportData(import_req, &import_resp, &controller));
+      ASSERT_FALSE(import_resp.has_error()) << import_resp.DebugString();
+    }
 
     for (const string& row : tabletid_to_line[tablet_id]) {
       // Build read request.
@@ -601,5 +614,13 @@ TEST_F_EX(YBBulkLoadTest, TestCLITool, YBBulkLoadTestWithoutRebalancing) {
   }
 }
 
+TEST_F_EX(YBBulkLoadTest, TestCLITool, YBBulkLoadTestWithoutRebalancing) {
+  TestCLITool(IngestViaRaft::kFalse);
+}
+
+TEST_F_EX(YBBulkLoadTest, TestCLIToolIngestViaRaft, YBBulkLoadTestWithoutRebalancing) {
+  TestCLITool(IngestViaRaft::kTrue);
+}
+
 } // namespace tools
 } // namespace yb
@@ -21,6 +21,7 @@
 
 #include "yb/rocksdb/db.h"
 #include "yb/rocksdb/options.h"
+#include "yb/client/bulk_load.h"
 #include "yb/client/client.h"
 #include "yb/common/entity_ids.h"
 #include "yb/common/hybrid_time.h"
@@ -43,6 +44,7 @@
 #include "yb/util/threadpool.h"
 #include "yb/util/flags.h"
 #include "yb/util/logging.h"
+#include "yb/util/oid_generator.h"
 #include "yb/util/path_util.h"
 #include "yb/util/subprocess.h"
 
@@ -74,6 +76,11 @@ DEFINE_string(bulk_load_cleanup_script, "./bulk_load_cleanup.sh", "Relative path
 DEFINE_string(ssh_key_file, "", "SSH key to push SSTable files to production cluster");
 DEFINE_bool(export_files, false, "Whether or not the files should be exported to a production "
             "cluster.");
+DEFINE_bool(ingest_via_raft, false, "Whether exported files should be uploaded to tablet replicas "
+            "over RPC and ingested atomically through Raft, instead of copying them with the "
+            "helper scripts.");
+DEFINE_int32(ingest_timeout_sec, 3600, "Timeout for uploading and ingesting files of a tablet "
+             "with --ingest_via_raft.");
 DEFINE_int32(bulk_load_num_threads, 16, "Number of threads to use for bulk load");
 DEFINE_int32(bulk_load_threadpool_queue_size, 10000,
              "Maximum number of entries to queue in the threadpool");
@@ -379,6 +386,15 @@ Status BulkLoad::FinishTabletProcessing(const TabletId &tablet_id,
     return Status::OK();
   }
 
+  if (FLAGS_ingest_via_raft) {
+    // Records were written at the epoch, see BulkLoadTask::Run.
+    RETURN_NOT_OK(client::BulkLoadTablet(
+        client_.get(), tablet_id, ObjectIdGenerator().Next(), db_fixture_->rocksdb_dir(),
+        HybridTime::FromMicros(kYugaByteMicrosecondEpoch),
+        MonoDelta::FromSeconds(FLAGS_ingest_timeout_sec)));
+    return yb::Env::Default()->DeleteRecursively(db_fixture_->rocksdb_dir());
+  }
+
   // Find replicas for the tablet.
   master::TabletLocationsPB tablet_locations;
   RETURN_NOT_OK(client_->GetTabletLocation(tablet_id, &tablet_locations));
@@ -532,7 +548,7 @@ int main(int argc, char** argv) {
         "--base_dir";
   }
 
-  if (FLAGS_export_files && FLAGS_ssh_key_file.empty()) {
+  if (FLAGS_export_files && !FLAGS_ingest_via_raft && FLAGS_ssh_key_file.empty()) {
     LOG(FATAL) << "Need to specify --ssh_key_file with --export_files";
   }
 
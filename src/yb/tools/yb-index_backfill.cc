@@ -0,0 +1,433 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+// Backfills a secondary index of a table with existing data without going through the write path:
+// 1) Every tablet of the indexed table is scanned in parallel at a fixed backfill hybrid time.
+// 2) Index rows are built from the scanned rows and written to a local RocksDB per index tablet,
+//    so the produced SST files are sorted per index tablet.
+// 3) Files of each index tablet are ingested at the backfill hybrid time with BulkLoadTablet, so
+//    they become visible atomically on all replicas of the tablet.
+// Writes made to the indexed table after the backfill hybrid time are not read by the scan, the
+// backfill hybrid time is logged, so the index could be caught up from it.
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <map>
+
+#include <boost/algorithm/string.hpp>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "yb/client/bulk_load.h"
+#include "yb/client/client.h"
+#include "yb/client/table_handle.h"
+#include "yb/client/yb_op.h"
+#include "yb/common/entity_ids.h"
+#include "yb/common/hybrid_time.h"
+#include "yb/common/index.h"
+#include "yb/common/partition.h"
+#include "yb/common/ql_protocol.pb.h"
+#include "yb/common/ql_rowblock.h"
+#include "yb/docdb/doc_operation.h"
+#include "yb/docdb/doc_write_batch.h"
+#include "yb/gutil/walltime.h"
+#include "yb/master/master.pb.h"
+#include "yb/rocksdb/db.h"
+#include "yb/tools/bulk_load_docdb_util.h"
+#include "yb/util/env.h"
+#include "yb/util/flags.h"
+#include "yb/util/logging.h"
+#include "yb/util/oid_generator.h"
+#include "yb/util/size_literals.h"
+#include "yb/util/status.h"
+#include "yb/util/stopwatch.h"
+#include "yb/util/threadpool.h"
+
+using std::string;
+using std::unique_ptr;
+using std::vector;
+using yb::client::TableHandle;
+using yb::client::YBClient;
+using yb::client::YBClientBuilder;
+using yb::client::YBTableName;
+using yb::docdb::DocWriteBatch;
+using yb::docdb::InitMarkerBehavior;
+using yb::operator"" _MB;
+
+DEFINE_string(master_addresses, "", "Comma-separated list of YB Master server addresses");
+DEFINE_string(namespace_name, "", "Namespace of the indexed table and the index");
+DEFINE_string(table_name, "", "Name of the indexed table");
+DEFINE_string(index_name, "", "Name of the index table to backfill");
+DEFINE_string(base_dir, "", "Base directory where we will store the SSTable files of the index");
+DEFINE_uint64(backfill_hybrid_time, 0, "Hybrid time, as returned by HybridTime::ToUint64, to "
+              "scan the indexed table at. Current time is used when not specified.");
+DEFINE_int32(index_backfill_num_threads, 16,
+             "Number of indexed table tablets that are scanned in parallel");
+DEFINE_int32(index_backfill_page_size, 10000,
+             "Number of rows of the indexed table to read in each scan request");
+DEFINE_int32(index_backfill_timeout_sec, 600, "Timeout for each scan request");
+DEFINE_int64(index_backfill_memtable_size_bytes, 128_MB,
+             "Amount of bytes to use for the rocksdb memtable of each index tablet");
+DEFINE_int32(index_backfill_num_memtables, 2, "Number of memtables to use for each rocksdb");
+DEFINE_int32(index_backfill_max_background_flushes, 2,
+             "Number of flushes to perform in the background");
+DEFINE_int32(ingest_timeout_sec, 3600, "Timeout for uploading and ingesting files of a tablet");
+
+namespace yb {
+namespace tools {
+
+namespace {
+
+struct IndexTablet {
+  TabletId tablet_id;
+  string partition_key_start;
+  unique_ptr<BulkLoadDocDBUtil> db_fixture;
+};
+
+class IndexBackfill {
+ public:
+  CHECKED_STATUS Run();
+
+ private:
+  CHECKED_STATUS Init();
+  CHECKED_STATUS InitIndexTablets();
+
+  // Scans the tablet of the indexed table and writes index rows for it.
+  CHECKED_STATUS BackfillTablet(const master::TabletLocationsPB& tablet);
+
+  // Fills the index write request for the row of the indexed table, returns false if the row has
+  // no index entry.
+  Result<bool> PrepareIndexRow(const QLRow& row, QLWriteRequestPB* req) const;
+
+  // Finds the tablet of the index that contains the partition key.
+  IndexTablet* FindIndexTablet(const string& partition_key);
+
+  CHECKED_STATUS IngestIndexTablet(IndexTablet* index_tablet);
+
+  // Runs 'task' for each element of 'items' on the thread pool, returns the first failure.
+  template <class Items, class Task>
+  CHECKED_STATUS RunInParallel(Items* items, const Task& task);
+
+  std::shared_ptr<YBClient> client_;
+  TableHandle table_;
+  TableHandle index_;
+  const IndexInfo* index_info_ = nullptr;
+  HybridTime backfill_hybrid_time_;
+
+  // Columns of the indexed table that are read by the scan.
+  vector<string> read_columns_;
+  // Index of the column in read_columns_ for each column of the index table, or -1 if the column
+  // is not filled from the indexed table.
+  vector<int> index_column_source_;
+
+  vector<IndexTablet> index_tablets_;
+  gscoped_ptr<ThreadPool> thread_pool_;
+
+  std::atomic<size_t> rows_read_{0};
+  std::atomic<size_t> rows_indexed_{0};
+};
+
+Status IndexBackfill::Init() {
+  YBClientBuilder builder;
+  builder.add_master_server_addr(FLAGS_master_addresses);
+  RETURN_NOT_OK(builder.Build(&client_));
+
+  // Convert table names to lowercase since we store table names in lowercase.
+  RETURN_NOT_OK(table_.Open(
+      YBTableName(FLAGS_namespace_name, boost::to_lower_copy(FLAGS_table_name)), client_.get()));
+  RETURN_NOT_OK(index_.Open(
+      YBTableName(FLAGS_namespace_name, boost::to_lower_copy(FLAGS_index_name)), client_.get()));
+
+  const auto it = table_->index_map().find(index_->id());
+  if (it == table_->index_map().end()) {
+    return STATUS_FORMAT(InvalidArgument, "$0 is not an index of $1", index_->name(),
+                         table_->name());
+  }
+  index_info_ = &it->second;
+  if (index_info_->is_local()) {
+    return STATUS_FORMAT(NotSupported, "Backfill of local index $0 is not supported",
+                         index_->name());
+  }
+
+  const Schema& table_schema = table_->InternalSchema();
+  const Schema& index_schema = index_->InternalSchema();
+  index_column_source_.assign(index_schema.num_columns(), -1);
+  for (const auto& column : index_info_->columns()) {
+    const int index_idx = index_schema.find_column_by_id(column.column_id);
+    if (index_idx == Schema::kColumnNotFound) {
+      return STATUS_FORMAT(IllegalState, "Column $0 is missing in index $1", column.column_id,
+                           index_->name());
+    }
+    const auto& indexed_column = VERIFY_RESULT(
+        table_schema.column_by_id(column.indexed_column_id));
+    index_column_source_[index_idx] = read_columns_.size();
+    read_columns_.push_back(indexed_column.name());
+  }
+  for (size_t idx = 0; idx != index_schema.num_key_columns(); ++idx) {
+    if (index_column_source_[idx] == -1) {
+      return STATUS_FORMAT(IllegalState, "Key column $0 of index $1 is not indexed",
+                           index_schema.column(idx).name(), index_->name());
+    }
+  }
+
+  if (FLAGS_backfill_hybrid_time != 0) {
+    backfill_hybrid_time_ = HybridTime(FLAGS_backfill_hybrid_time);
+  } else {
+    backfill_hybrid_time_ = HybridTime::FromMicros(GetCurrentTimeMicros());
+  }
+  LOG(INFO) << "Backfilling index " << index_->name().ToString() << " of "
+            << table_->name().ToString() << " at " << backfill_hybrid_time_
+            << " (" << backfill_hybrid_time_.ToUint64() << ")";
+
+  return ThreadPoolBuilder("index_backfill")
+      .set_min_threads(FLAGS_index_backfill_num_threads)
+      .set_max_threads(FLAGS_index_backfill_num_threads)
+      .Build(&thread_pool_);
+}
+
+Status IndexBackfill::InitIndexTablets() {
+  google::protobuf::RepeatedPtrField<master::TabletLocationsPB> tablets;
+  RETURN_NOT_OK(client_->GetTablets(index_->name(), 0, &tablets));
+  for (const auto& tablet : tablets) {
+    IndexTablet index_tablet;
+    index_tablet.tablet_id = tablet.tablet_id();
+    index_tablet.partition_key_start = tablet.partition().partition_key_start();
+    index_tablet.db_fixture.reset(new BulkLoadDocDBUtil(
+        tablet.tablet_id(), FLAGS_base_dir, FLAGS_index_backfill_memtable_size_bytes,
+        FLAGS_index_backfill_num_memtables, FLAGS_index_backfill_max_background_flushes));
+    RETURN_NOT_OK(index_tablet.db_fixture->InitRocksDBOptions());
+    RETURN_NOT_OK(index_tablet.db_fixture->DisableCompactions()); // This opens rocksdb.
+    index_tablets_.push_back(std::move(index_tablet));
+  }
+  if (index_tablets_.empty()) {
+    return STATUS_FORMAT(IllegalState, "Index $0 has no tablets", index_->name());
+  }
+  std::sort(index_tablets_.begin(), index_tablets_.end(),
+            [](const IndexTablet& lhs, const IndexTablet& rhs) {
+    return lhs.partition_key_start < rhs.partition_key_start;
+  });
+  return Status::OK();
+}
+
+IndexTablet* IndexBackfill::FindIndexTablet(const string& partition_key) {
+  auto it = std::upper_bound(
+      index_tablets_.begin(), index_tablets_.end(), partition_key,
+      [](const string& key, const IndexTablet& tablet) {
+    return key < tablet.partition_key_start;
+  });
+  DCHECK(it != index_tablets_.begin());
+  return &*--it;
+}
+
+Result<bool> IndexBackfill::PrepareIndexRow(const QLRow& row, QLWriteRequestPB* req) const {
+  const Schema& index_schema = index_->InternalSchema();
+  req->set_type(QLWriteRequestPB_QLStmtType_QL_STMT_INSERT);
+  req->set_client(YQL_CLIENT_CQL);
+  req->set_schema_version(index_info_->schema_version());
+  for (size_t idx = 0; idx != index_schema.num_columns(); ++idx) {
+    const int source = index_column_source_[idx];
+    if (source == -1) {
+      continue;
+    }
+    const QLValue& value = row.column(source);
+    if (idx < index_schema.num_key_columns()) {
+      // Rows with null indexed values have no entry in the index.
+      if (value.IsNull()) {
+        return false;
+      }
+      QLExpressionPB* column_value = index_schema.is_hash_key_column(idx)
+          ? req->add_hashed_column_values() : req->add_range_column_values();
+      *column_value->mutable_value() = value.value();
+    } else if (!value.IsNull()) {
+      QLColumnValuePB* column_value = req->add_column_values();
+      column_value->set_column_id(index_schema.column_id(idx));
+      *column_value->mutable_expr()->mutable_value() = value.value();
+    }
+  }
+  return true;
+}
+
+Status IndexBackfill::BackfillTablet(const master::TabletLocationsPB& tablet) {
+  const auto& partition = tablet.partition();
+  auto session = client_->NewSession();
+  RETURN_NOT_OK(session->SetFlushMode(client::YBSession::MANUAL_FLUSH));
+  session->SetTimeout(MonoDelta::FromSeconds(FLAGS_index_backfill_timeout_sec));
+
+  const Schema& index_schema = index_->InternalSchema();
+  const auto read_time = ReadHybridTime::SingleTime(backfill_hybrid_time_);
+  QLPagingStatePB paging_state;
+  size_t rows_read = 0;
+  size_t rows_indexed = 0;
+  Stopwatch stopwatch;
+  stopwatch.start();
+  for (;;) {
+    auto op = table_.NewReadOp();
+    auto* req = op->mutable_request();
+    if (!partition.partition_key_start().empty()) {
+      req->set_hash_code(
+          PartitionSchema::DecodeMultiColumnHashValue(partition.partition_key_start()));
+    }
+    // Limit the scan to this tablet, other tablets are scanned by other tasks.
+    if (!partition.partition_key_end().empty()) {
+      req->set_max_hash_code(
+          PartitionSchema::DecodeMultiColumnHashValue(partition.partition_key_end()) - 1);
+    }
+    req->set_limit(FLAGS_index_backfill_page_size);
+    req->set_return_paging_state(true);
+    if (paging_state.has_next_row_key()) {
+      *req->mutable_paging_state() = paging_state;
+    }
+    table_.AddColumns(read_columns_, req);
+    op->SetReadTime(read_time);
+    RETURN_NOT_OK(session->Apply(op));
+    RETURN_NOT_OK(session->Flush());
+    if (op->response().status() != QLResponsePB::YQL_STATUS_OK) {
+      return STATUS_FORMAT(RuntimeError, "Error reading tablet $0: $1", tablet.tablet_id(),
+                           op->response().error_message());
+    }
+
+    auto rows = VERIFY_RESULT(op->MakeRowBlock());
+    std::map<IndexTablet*, unique_ptr<DocWriteBatch>> write_batches;
+    for (const auto& row : rows.rows()) {
+      QLWriteRequestPB index_req;
+      auto has_entry = PrepareIndexRow(row, &index_req);
+      RETURN_NOT_OK(has_entry);
+      if (!has_entry.get()) {
+        continue;
+      }
+      string partition_key;
+      RETURN_NOT_OK(index_->partition_schema().EncodeKey(
+          index_req.hashed_column_values(), &partition_key));
+      index_req.set_hash_code(PartitionSchema::DecodeMultiColumnHashValue(partition_key));
+
+      auto* index_tablet = FindIndexTablet(partition_key);
+      auto& write_batch = write_batches[index_tablet];
+      if (!write_batch) {
+        write_batch.reset(new DocWriteBatch(
+            index_tablet->db_fixture->rocksdb(), InitMarkerBehavior::kOptional));
+      }
+      QLResponsePB index_resp;
+      docdb::QLWriteOperation write_op(index_schema, boost::none);
+      RETURN_NOT_OK(write_op.Init(&index_req, &index_resp));
+      RETURN_NOT_OK(write_op.Apply({write_batch.get(), read_time}));
+      ++rows_indexed;
+    }
+    rows_read += rows.rows().size();
+
+    // All index records are written at the backfill hybrid time, so they are ingested at it.
+    for (const auto& entry : write_batches) {
+      RETURN_NOT_OK(entry.first->db_fixture->WriteToRocksDB(
+          *entry.second, backfill_hybrid_time_, /* decode_dockey */ false,
+          /* increment_write_id */ false));
+    }
+
+    // Paging state without the next row key points to the next tablet, so this tablet is done.
+    if (!op->response().has_paging_state() ||
+        op->response().paging_state().next_row_key().empty()) {
+      break;
+    }
+    paging_state = op->response().paging_state();
+  }
+  stopwatch.stop();
+
+  rows_read_ += rows_read;
+  rows_indexed_ += rows_indexed;
+  LOG(INFO) << "Backfilled tablet " << tablet.tablet_id() << ": " << rows_read << " rows read, "
+            << rows_indexed << " rows indexed, took " << stopwatch.elapsed().wall_seconds() << "s";
+  return Status::OK();
+}
+
+Status IndexBackfill::IngestIndexTablet(IndexTablet* index_tablet) {
+  auto* db_fixture = index_tablet->db_fixture.get();
+  RETURN_NOT_OK(db_fixture->FlushRocksDB());
+
+  std::vector<rocksdb::LiveFileMetaData> live_files_metadata;
+  db_fixture->rocksdb()->GetLiveFilesMetaData(&live_files_metadata);
+  if (live_files_metadata.empty()) {
+    LOG(INFO) << "No index rows for tablet " << index_tablet->tablet_id;
+  } else {
+    RETURN_NOT_OK(client::BulkLoadTablet(
+        client_.get(), index_tablet->tablet_id, ObjectIdGenerator().Next(),
+        db_fixture->rocksdb_dir(), backfill_hybrid_time_,
+        MonoDelta::FromSeconds(FLAGS_ingest_timeout_sec)));
+  }
+  const string dir = db_fixture->rocksdb_dir();
+  index_tablet->db_fixture.reset();
+  return yb::Env::Default()->DeleteRecursively(dir);
+}
+
+template <class Items, class Task>
+Status IndexBackfill::RunInParallel(Items* items, const Task& task) {
+  std::mutex mutex;
+  Status result;
+  for (auto& item : *items) {
+    RETURN_NOT_OK(thread_pool_->SubmitFunc([this, &item, &task, &mutex, &result] {
+      auto status = task(&item);
+      if (!status.ok()) {
+        LOG(WARNING) << "Index backfill task failed: " << status;
+        std::lock_guard<std::mutex> lock(mutex);
+        if (result.ok()) {
+          result = status;
+        }
+      }
+    }));
+  }
+  thread_pool_->Wait();
+  return result;
+}
+
+Status IndexBackfill::Run() {
+  RETURN_NOT_OK(Init());
+  RETURN_NOT_OK(InitIndexTablets());
+
+  google::protobuf::RepeatedPtrField<master::TabletLocationsPB> tablets;
+  RETURN_NOT_OK(client_->GetTablets(table_->name(), 0, &tablets));
+  RETURN_NOT_OK(RunInParallel(&tablets, [this](const master::TabletLocationsPB* tablet) {
+    return BackfillTablet(*tablet);
+  }));
+  LOG(INFO) << "Scanned " << tablets.size() << " tablets: " << rows_read_ << " rows read, "
+            << rows_indexed_ << " rows indexed";
+
+  RETURN_NOT_OK(RunInParallel(&index_tablets_, [this](IndexTablet* index_tablet) {
+    return IngestIndexTablet(index_tablet);
+  }));
+  LOG(INFO) << "Ingested index " << index_->name().ToString() << " at " << backfill_hybrid_time_;
+  return Status::OK();
+}
+
+} // namespace
+
+} // namespace tools
+} // namespace yb
+
+int main(int argc, char** argv) {
+  yb::ParseCommandLineFlags(&argc, &argv, true);
+  yb::InitGoogleLoggingSafe(argv[0]);
+  if (FLAGS_master_addresses.empty() || FLAGS_table_name.empty() || FLAGS_index_name.empty() ||
+      FLAGS_namespace_name.empty() || FLAGS_base_dir.empty()) {
+    LOG(FATAL) << "Need to specify --master_addresses, --namespace_name, --table_name, "
+        "--index_name and --base_dir";
+  }
+
+  if (!yb::Env::Default()->FileExists(FLAGS_base_dir)) {
+    LOG(FATAL) << "Index backfill directory doesn't exist: " << FLAGS_base_dir;
+  }
+
+  yb::tools::IndexBackfill index_backfill;
+  yb::Status status = index_backfill.Run();
+  if (!status.ok()) {
+    LOG(FATAL) << "Index backfill failed: " << status;
+  }
+  return 0;
+}
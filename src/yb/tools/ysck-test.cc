@@ -50,6 +50,8 @@ using std::unordered_map;
 using std::vector;
 using client::YBTableName;
 
+constexpr uint64_t kMockCurrentHybridTime = 12345;
+
 class MockYsckTabletServer : public YsckTabletServer {
  public:
   explicit MockYsckTabletServer(const string& uuid)
@@ -67,20 +69,24 @@ class MockYsckTabletServer : public YsckTabletServer {
       const Schema& schema,
       const ChecksumOptions& options,
       const ReportResultCallback& callback) override {
+    scanned_hybrid_times_.push_back(options.snapshot_hybrid_time);
     callback.Run(Status::OK(), 0);
   }
 
   Status CurrentHybridTime(uint64_t* hybrid_time) const override {
-    *hybrid_time = 0;
+    *hybrid_time = kMockCurrentHybridTime;
     return Status::OK();
   }
 
+
   const std::string& address() const override {
     return address_;
   }
 
   // Public because the unit tests mutate this variable directly.
   Status connect_status_;
+  // Snapshot hybrid times of the checksum scans run on this server.
+  vector<uint64_t> scanned_hybrid_times_;
 
  private:
   const string address_;
@@ -273,5 +279,26 @@ TEST_F(YsckTest, TestOneOneTabletBrokenTable) {
   ASSERT_TRUE(ysck_->CheckTablesConsistency().IsCorruption());
 }
 
+TEST_F(YsckTest, TestChecksumSnapshot) {
+  CreateOneSmallReplicatedTable();
+  ASSERT_OK(ysck_->FetchTableAndTabletInfo());
+  ASSERT_OK(ysck_->CheckTabletServersRunning());
+  ChecksumOptions options(MonoDelta::FromSeconds(10), 2);
+  options.use_snapshot = true;
+  options.snapshot_hybrid_time = 0;
+  ASSERT_OK(ysck_->ChecksumData(vector<string>(), vector<string>(), options));
+
+  // All replicas should be scanned at the hybrid time picked from one of the tablet servers.
+  size_t num_scans = 0;
+  for (const auto& entry : master_->tablet_servers_) {
+    for (uint64_t hybrid_time :
+             static_pointer_cast<MockYsckTabletServer>(entry.second)->scanned_hybrid_times_) {
+      ASSERT_EQ(kMockCurrentHybridTime, hybrid_time);
+      ++num_scans;
+    }
+  }
+  ASSERT_EQ(9U, num_scans);
+}
+
 } // namespace tools
 } // namespace yb
@@ -44,6 +44,7 @@
 #include "yb/util/blocking_queue.h"
 #include "yb/util/locks.h"
 #include "yb/util/monotime.h"
+#include "yb/util/threadpool.h"
 
 namespace yb {
 namespace tools {
@@ -59,14 +60,57 @@ DEFINE_int32(checksum_timeout_sec, 120,
              "before timing out.");
 DEFINE_int32(checksum_scan_concurrency, 4,
              "Number of concurrent checksum scans to execute per tablet server.");
+DEFINE_bool(checksum_snapshot, true,
+            "Should the checksum scan read all replicas at the same hybrid time, so that they can "
+            "be compared while the cluster takes writes.");
+DEFINE_uint64(checksum_snapshot_hybrid_time, 0,
+              "Hybrid time to use for the snapshot checksum scan. 0 uses the current hybrid time "
+              "of a tablet server.");
+DEFINE_int32(checksum_progress_interval_sec, 10,
+             "Interval between progress reports of the checksum scan.");
+DEFINE_int32(ysck_rpc_concurrency, 32,
+             "Maximum number of concurrent RPCs used to fetch tablet locations from the master "
+             "and to check that tablet servers are running.");
 
 ChecksumOptions::ChecksumOptions()
-    : timeout(MonoDelta::FromSeconds(FLAGS_checksum_timeout_sec)),
-      scan_concurrency(FLAGS_checksum_scan_concurrency) {}
+    : ChecksumOptions(MonoDelta::FromSeconds(FLAGS_checksum_timeout_sec),
+                      FLAGS_checksum_scan_concurrency) {}
 
 ChecksumOptions::ChecksumOptions(MonoDelta timeout, int scan_concurrency)
     : timeout(std::move(timeout)),
-      scan_concurrency(scan_concurrency) {}
+      scan_concurrency(scan_concurrency),
+      use_snapshot(FLAGS_checksum_snapshot),
+      snapshot_hybrid_time(FLAGS_checksum_snapshot_hybrid_time) {}
+
+namespace {
+
+// Invokes func for each of items on up to --ysck_rpc_concurrency threads. Returns the statuses
+// returned by func in the order of items.
+template <class Items, class Func>
+std::vector<Status> ParallelForEach(const Items& items, const Func& func) {
+  std::vector<Status> statuses(items.size());
+  std::unique_ptr<ThreadPool> pool;
+  Status s = ThreadPoolBuilder("ysck")
+      .set_max_threads(std::max(FLAGS_ysck_rpc_concurrency, 1))
+      .Build(&pool);
+  if (!s.ok()) {
+    LOG(WARNING) << "Unable to create thread pool, running serially: " << s.ToString();
+  }
+  size_t idx = 0;
+  for (const auto& item : items) {
+    Status* status = &statuses[idx++];
+    auto task = [&func, &item, status] { *status = func(item); };
+    if (!s.ok() || !pool->SubmitFunc(task).ok()) {
+      task();
+    }
+  }
+  if (pool) {
+    pool->Wait();
+  }
+  return statuses;
+}
+
+} // namespace
 
 YsckCluster::~YsckCluster() {
 }
@@ -75,8 +119,11 @@ Status YsckCluster::FetchTableAndTabletInfo() {
   RETURN_NOT_OK(master_->Connect());
   RETURN_NOT_OK(RetrieveTablesList());
   RETURN_NOT_OK(RetrieveTabletServers());
-  for (const shared_ptr<YsckTable>& table : tables()) {
-    RETURN_NOT_OK(RetrieveTabletsList(table));
+  auto statuses = ParallelForEach(tables(), [this](const shared_ptr<YsckTable>& table) {
+    return RetrieveTabletsList(table);
+  });
+  for (const auto& status : statuses) {
+    RETURN_NOT_OK(status);
   }
   return Status::OK();
 }
@@ -117,11 +164,14 @@ Status Ysck::CheckTabletServersRunning() {
     return STATUS(NotFound, "No tablet servers found");
   }
 
-  int bad_servers = 0;
   VLOG(1) << "Connecting to all the Tablet Servers";
-  for (const YsckMaster::TSMap::value_type& entry : cluster_->tablet_servers()) {
-    Status s = ConnectToTabletServer(entry.second);
-    if (!s.ok()) {
+  auto statuses = ParallelForEach(
+      cluster_->tablet_servers(), [this](const YsckMaster::TSMap::value_type& entry) {
+        return ConnectToTabletServer(entry.second);
+      });
+  int bad_servers = 0;
+  for (const auto& status : statuses) {
+    if (!status.ok()) {
       bad_servers++;
     }
   }
@@ -185,7 +235,8 @@ class ChecksumResultReporter : public RefCountedThreadSafe<ChecksumResultReporte
 
   // Initialize reporter with the number of replicas being queried.
   explicit ChecksumResultReporter(int num_tablet_replicas)
-      : responses_(num_tablet_replicas) {
+      : num_tablet_replicas_(num_tablet_replicas),
+        responses_(num_tablet_replicas) {
   }
 
   // Write an entry to the result map indicating a response from the remote.
@@ -215,6 +266,9 @@ class ChecksumResultReporter : public RefCountedThreadSafe<ChecksumResultReporte
   // Returns true iff all replicas have reported in.
   bool AllReported() const { return responses_.count() == 0; }
 
+  // Returns the number of replicas that have reported in.
+  uint64_t num_reported() const { return num_tablet_replicas_ - responses_.count(); }
+
   // Get reported results.
   TabletResultMap checksums() const {
     std::lock_guard<simple_spinlock> guard(lock_);
@@ -229,6 +283,7 @@ class ChecksumResultReporter : public RefCountedThreadSafe<ChecksumResultReporte
   void HandleResponse(const std::string& tablet_id, const std::string& replica_uuid,
                       const Status& status, uint64_t checksum);
 
+  const uint64_t num_tablet_replicas_;
   CountDownLatch responses_;
   mutable simple_spinlock lock_; // Protects 'checksums_'.
   // checksums_ is an unordered_map of { tablet_id : { replica_uuid : checksum } }.
@@ -336,6 +391,15 @@ Status Ysck::ChecksumData(const vector<string>& tables,
     }
   }
 
+  if (options.use_snapshot && options.snapshot_hybrid_time == 0 &&
+      !tablet_server_queues.empty()) {
+    const shared_ptr<YsckTabletServer>& tablet_server = tablet_server_queues.begin()->first;
+    RETURN_NOT_OK_PREPEND(
+        tablet_server->CurrentHybridTime(&options.snapshot_hybrid_time),
+        Substitute("Unable to get the current hybrid time of $0", tablet_server->address()));
+    LOG(INFO) << "Using snapshot hybrid time " << options.snapshot_hybrid_time;
+  }
+
   // Kick off checksum scans in parallel. For each tablet server, we start
   // scan_concurrency scans. Each callback then initiates one additional
   // scan when it returns if the queue for that TS is not empty.
@@ -360,8 +424,16 @@ Status Ysck::ChecksumData(const vector<string>& tables,
   }
 
   bool timed_out = false;
-  if (!reporter->WaitFor(options.timeout)) {
-    timed_out = true;
+  const MonoTime deadline = MonoTime::Now() + options.timeout;
+  const MonoDelta progress_interval =
+      MonoDelta::FromSeconds(std::max(FLAGS_checksum_progress_interval_sec, 1));
+  while (!reporter->WaitFor(std::min(progress_interval, deadline - MonoTime::Now()))) {
+    if (MonoTime::Now() >= deadline) {
+      timed_out = true;
+      break;
+    }
+    LOG(INFO) << Substitute("Checksummed $0 out of $1 tablet replicas",
+                            reporter->num_reported(), num_tablet_replicas);
   }
   ChecksumResultReporter::TabletResultMap checksums = reporter->checksums();
 
@@ -63,6 +63,14 @@ struct ChecksumOptions {
 
   // The maximum number of concurrent checksum scans to run per tablet server.
   int scan_concurrency;
+
+  // Whether all replicas should be scanned at the same hybrid time, so that they can be compared
+  // while writes continue.
+  bool use_snapshot;
+
+  // The hybrid time to scan at when use_snapshot is set. 0 means the current hybrid time of one
+  // of the tablet servers, picked when the scan starts.
+  uint64_t snapshot_hybrid_time;
 };
 
 // Representation of a tablet replica on a tablet server.
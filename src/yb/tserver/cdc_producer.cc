@@ -0,0 +1,232 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tserver/cdc_producer.h"
+
+#include <gflags/gflags.h>
+
+#include "yb/common/schema.h"
+
+#include "yb/consensus/consensus.h"
+#include "yb/consensus/opid_util.h"
+
+#include "yb/docdb/doc_key.h"
+#include "yb/docdb/value.h"
+
+#include "yb/tablet/tablet.h"
+#include "yb/tablet/tablet_peer.h"
+
+#include "yb/util/flag_tags.h"
+
+DEFINE_int32(cdc_max_records, 1000,
+             "Max number of change data capture records returned by a single GetChanges call, "
+             "when the request does not specify a lower limit. All records of the last operation "
+             "are returned, so the limit could be exceeded.");
+TAG_FLAG(cdc_max_records, advanced);
+TAG_FLAG(cdc_max_records, runtime);
+
+DEFINE_int32(cdc_max_batch_size_bytes, 4 * 1024 * 1024,
+             "Max size of log operations read by a single GetChanges call, when the request does "
+             "not specify a lower limit.");
+TAG_FLAG(cdc_max_batch_size_bytes, advanced);
+TAG_FLAG(cdc_max_batch_size_bytes, runtime);
+
+DEFINE_int32(cdc_consumer_idle_timeout_sec, 600,
+             "Change data capture consumers that did not request changes for this time are "
+             "removed, so their checkpoints no longer retain the log.");
+TAG_FLAG(cdc_consumer_idle_timeout_sec, advanced);
+TAG_FLAG(cdc_consumer_idle_timeout_sec, runtime);
+
+namespace yb {
+namespace tserver {
+
+using docdb::PrimitiveValue;
+using docdb::ValueType;
+
+namespace {
+
+std::string AnchorOwner(const std::string& consumer_id) {
+  return "CDC consumer " + consumer_id;
+}
+
+} // namespace
+
+CDCProducer::CDCProducer() : next_cleanup_(MonoTime::Now()) {
+}
+
+CDCProducer::~CDCProducer() {
+  Shutdown();
+}
+
+void CDCProducer::Shutdown() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& entry : streams_) {
+    UnregisterStream(entry.second.get());
+  }
+  streams_.clear();
+}
+
+void CDCProducer::UnregisterStream(Stream* stream) {
+  WARN_NOT_OK(stream->log_anchor_registry->Unregister(&stream->anchor),
+              "Failed to unregister change data capture log anchor");
+}
+
+void CDCProducer::CleanupIdleStreamsUnlocked(MonoTime now) {
+  if (now < next_cleanup_) {
+    return;
+  }
+  const auto idle_timeout = MonoDelta::FromSeconds(FLAGS_cdc_consumer_idle_timeout_sec);
+  next_cleanup_ = now + MonoDelta::FromSeconds(FLAGS_cdc_consumer_idle_timeout_sec / 10 + 1);
+  for (auto it = streams_.begin(); it != streams_.end();) {
+    if (it->second->last_access + idle_timeout < now) {
+      LOG(INFO) << "Removing idle change data capture consumer " << it->first.second
+                << " of tablet " << it->first.first;
+      UnregisterStream(it->second.get());
+      it = streams_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+Status CDCProducer::GetChanges(const tablet::TabletPeer& tablet_peer,
+                               const GetChangesRequestPB& req,
+                               GetChangesResponsePB* resp) {
+  if (req.consumer_id().empty()) {
+    return STATUS(InvalidArgument, "Change data capture consumer id is not specified");
+  }
+
+  const StreamKey key(tablet_peer.tablet_id(), req.consumer_id());
+  OpIdPB from_op_id = req.has_from_op_id() ? req.from_op_id() : consensus::MinimumOpId();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto now = MonoTime::Now();
+    CleanupIdleStreamsUnlocked(now);
+
+    auto it = streams_.find(key);
+    if (req.stop()) {
+      if (it != streams_.end()) {
+        UnregisterStream(it->second.get());
+        streams_.erase(it);
+      }
+      return Status::OK();
+    }
+
+    // Operations after from_op_id are anchored, since the consumer could request them again.
+    if (it == streams_.end()) {
+      auto stream = std::make_unique<Stream>();
+      stream->log_anchor_registry = tablet_peer.log_anchor_registry();
+      stream->log_anchor_registry->Register(
+          from_op_id.index() + 1, AnchorOwner(req.consumer_id()), &stream->anchor);
+      it = streams_.emplace(key, std::move(stream)).first;
+    } else {
+      RETURN_NOT_OK(it->second->log_anchor_registry->UpdateRegistration(
+          from_op_id.index() + 1, AnchorOwner(req.consumer_id()), &it->second->anchor));
+    }
+    it->second->last_access = now;
+  }
+
+  const int max_size_bytes = req.max_batch_size_bytes() != 0
+      ? std::min<uint64_t>(req.max_batch_size_bytes(), FLAGS_cdc_max_batch_size_bytes)
+      : FLAGS_cdc_max_batch_size_bytes;
+  const size_t max_records = req.max_records() != 0
+      ? std::min<size_t>(req.max_records(), FLAGS_cdc_max_records)
+      : FLAGS_cdc_max_records;
+
+  consensus::ReplicateMsgs msgs;
+  consensus::OpId committed_op_id;
+  RETURN_NOT_OK(tablet_peer.consensus()->ReadCommittedMessages(
+      from_op_id.index(), max_size_bytes, &msgs, &committed_op_id));
+  resp->mutable_committed_op_id()->CopyFrom(committed_op_id);
+
+  const Schema& schema = *tablet_peer.tablet()->schema();
+  size_t num_records = 0;
+  for (const auto& msg : msgs) {
+    num_records += VERIFY_RESULT(DecodeOperation(schema, *msg, resp));
+    from_op_id = msg->id();
+    if (num_records >= max_records) {
+      break;
+    }
+  }
+  resp->mutable_checkpoint()->CopyFrom(from_op_id);
+  return Status::OK();
+}
+
+Result<size_t> CDCProducer::DecodeOperation(const Schema& schema,
+                                            const consensus::ReplicateMsg& msg,
+                                            GetChangesResponsePB* resp) {
+  // Writes of distributed transactions are written as intents, and applied later.
+  if (msg.op_type() != consensus::WRITE_OP || !msg.write_request().has_write_batch() ||
+      msg.write_request().write_batch().has_transaction()) {
+    return 0;
+  }
+
+  // Records of a single document are written one after another, so the changes of each row are
+  // grouped into one record.
+  const size_t old_size = resp->records_size();
+  CDCRecordPB* record = nullptr;
+  docdb::SubDocKey sub_doc_key;
+  docdb::Value value;
+  for (const auto& kv : msg.write_request().write_batch().kv_pairs()) {
+    RETURN_NOT_OK(sub_doc_key.FullyDecodeFrom(kv.key(), docdb::HybridTimeRequired::kFalse));
+    RETURN_NOT_OK(value.Decode(kv.value()));
+
+    const auto doc_key = sub_doc_key.doc_key().Encode();
+    if (record == nullptr || record->key() != doc_key.AsStringRef()) {
+      record = resp->add_records();
+      record->mutable_op_id()->CopyFrom(msg.id());
+      record->set_hybrid_time(msg.hybrid_time());
+      record->set_operation(CDCRecordPB::WRITE);
+      record->set_key(doc_key.AsStringRef());
+      size_t column_idx = 0;
+      for (const auto& key_value : sub_doc_key.doc_key().hashed_group()) {
+        PrimitiveValue::ToQLValuePB(
+            key_value, schema.column(column_idx++).type(), record->add_hashed_key_values());
+      }
+      for (const auto& key_value : sub_doc_key.doc_key().range_group()) {
+        PrimitiveValue::ToQLValuePB(
+            key_value, schema.column(column_idx++).type(), record->add_range_key_values());
+      }
+    }
+
+    const bool is_tombstone = value.primitive_value().value_type() == ValueType::kTombstone;
+    const auto& subkeys = sub_doc_key.subkeys();
+    if (subkeys.empty()) {
+      if (is_tombstone) {
+        record->set_operation(CDCRecordPB::DELETE);
+        record->clear_changes();
+      }
+      continue;
+    }
+    // The liveness column only marks that the row exists.
+    if (subkeys[0].value_type() != ValueType::kColumnId) {
+      continue;
+    }
+    const auto column_id = subkeys[0].GetColumnId();
+    const ColumnSchema& column = VERIFY_RESULT(schema.column_by_id(column_id));
+    auto* change = record->add_changes();
+    change->set_column_id(column_id);
+    if (value.has_ttl()) {
+      change->set_ttl_msec(value.ttl().ToMilliseconds());
+    }
+    // Elements of collections are reported as changes of the column without the value.
+    if (is_tombstone || subkeys.size() > 1 || !value.primitive_value().IsPrimitive()) {
+      continue;
+    }
+    PrimitiveValue::ToQLValuePB(value.primitive_value(), column.type(), change->mutable_value());
+  }
+  return resp->records_size() - old_size;
+}
+
+} // namespace tserver
+} // namespace yb
@@ -0,0 +1,94 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_TSERVER_CDC_PRODUCER_H
+#define YB_TSERVER_CDC_PRODUCER_H
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "yb/consensus/log_anchor_registry.h"
+
+#include "yb/tablet/tablet_fwd.h"
+
+#include "yb/tserver/tserver.pb.h"
+
+#include "yb/util/monotime.h"
+#include "yb/util/result.h"
+#include "yb/util/status.h"
+
+namespace yb {
+
+class Schema;
+
+namespace consensus {
+class ReplicateMsg;
+}
+
+namespace tserver {
+
+// Produces change data capture records of tablets from their logs, see GetChangesRequestPB.
+//
+// Each consumer of a tablet has a stream, that anchors the log of the tablet replica at the
+// checkpoint of the consumer, so operations that were not consumed yet are not garbage collected.
+// The stream is removed when the consumer stops, or does not request changes for
+// --cdc_consumer_idle_timeout_sec.
+//
+// Only single shard writes are decoded, records of distributed transactions are applied from
+// intents and are not present in write operations.
+//
+// This class is thread-safe.
+class CDCProducer {
+ public:
+  CDCProducer();
+  ~CDCProducer();
+
+  CHECKED_STATUS GetChanges(const tablet::TabletPeer& tablet_peer,
+                            const GetChangesRequestPB& req,
+                            GetChangesResponsePB* resp);
+
+  // Removes all streams, so they no longer retain logs.
+  void Shutdown();
+
+  // Appends records of the rows changed by the operation to resp, returns the number of appended
+  // records.
+  static Result<size_t> DecodeOperation(const Schema& schema,
+                                        const consensus::ReplicateMsg& msg,
+                                        GetChangesResponsePB* resp);
+
+ private:
+  struct Stream {
+    scoped_refptr<log::LogAnchorRegistry> log_anchor_registry;
+    log::LogAnchor anchor;
+    MonoTime last_access;
+  };
+
+  typedef std::pair<std::string, std::string> StreamKey;
+
+  // Removes streams that were not accessed for a long time.
+  void CleanupIdleStreamsUnlocked(MonoTime now);
+
+  void UnregisterStream(Stream* stream);
+
+  std::mutex mutex_;
+  std::map<StreamKey, std::unique_ptr<Stream>> streams_;
+  MonoTime next_cleanup_;
+};
+
+} // namespace tserver
+} // namespace yb
+
+#endif // YB_TSERVER_CDC_PRODUCER_H
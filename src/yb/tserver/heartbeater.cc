@@ -35,6 +35,7 @@
 #include <memory>
 #include <vector>
 #include <mutex>
+#include <unordered_map>
 
 #include <gflags/gflags.h>
 #include <glog/logging.h>
@@ -42,12 +43,14 @@
 #include "yb/common/wire_protocol.h"
 #include "yb/gutil/ref_counted.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/gutil/sysinfo.h"
 #include "yb/master/master.h"
 #include "yb/master/master.proxy.h"
 #include "yb/master/master_rpc.h"
 #include "yb/server/server_base.proxy.h"
 #include "yb/server/webserver.h"
 #include "yb/tablet/tablet.h"
+#include "yb/tablet/tablet_metrics.h"
 #include "yb/tserver/tablet_server.h"
 #include "yb/tserver/tablet_server_options.h"
 #include "yb/tserver/ts_tablet_manager.h"
@@ -55,6 +58,7 @@
 #include "yb/util/monotime.h"
 #include "yb/util/net/net_util.h"
 #include "yb/util/status.h"
+#include "yb/util/stopwatch.h"
 #include "yb/util/thread.h"
 #include "yb/util/mem_tracker.h"
 DEFINE_int32(heartbeat_rpc_timeout_ms, 15000,
@@ -197,6 +201,17 @@ class Heartbeater::Thread {
   uint64_t prev_reads_;
   uint64_t prev_writes_;
 
+  struct TabletCounters {
+    int64_t committed_index = 0;
+    uint64_t reads = 0;
+  };
+
+  // Counters of each led tablet, for computing per tablet read and write rates.
+  std::unordered_map<TabletId, TabletCounters> prev_tablet_counters_;
+
+  // Measures CPU time used by the process between metrics submissions.
+  Stopwatch cpu_stopwatch_;
+
   DISALLOW_COPY_AND_ASSIGN(Thread);
 };
 
@@ -234,7 +249,9 @@ Heartbeater::Thread::Thread(const TabletServerOptions& opts, TabletServer* serve
     tserver_metrics_interval_sec_(5),
     prev_tserver_metrics_submission_(MonoTime::Now()),
     prev_reads_(0),
-    prev_writes_(0) {
+    prev_writes_(0),
+    cpu_stopwatch_(Stopwatch::ALL_THREADS) {
+  cpu_stopwatch_.start();
   CHECK_NOTNULL(master_addresses_.get());
   CHECK(!master_addresses_->empty());
   VLOG(1) << "Initializing heartbeater thread with master addresses: "
@@ -404,12 +421,34 @@ Status Heartbeater::Thread::TryHeartbeat() {
     // Get the Total SST file sizes and set it in the proto buf
     std::vector<scoped_refptr<yb::tablet::TabletPeer> > tablet_peers;
     uint64_t total_file_sizes = 0;
+    // Counters of each tablet led by this server, in the order of tablet_metrics.
+    std::vector<TabletCounters> tablet_counters;
     server_->tablet_manager()->GetTabletPeers(&tablet_peers);
     for (auto it = tablet_peers.begin(); it != tablet_peers.end(); it++) {
       scoped_refptr<yb::tablet::TabletPeer> tablet_peer = *it;
       if (tablet_peer) {
         shared_ptr<yb::tablet::TabletClass> tablet_class = tablet_peer->shared_tablet();
-        total_file_sizes += (tablet_class) ? tablet_class->GetTotalSSTFileSizes() : 0;
+        const uint64_t file_sizes = (tablet_class) ? tablet_class->GetTotalSSTFileSizes() : 0;
+        total_file_sizes += file_sizes;
+        consensus::OpId committed_op_id;
+        if (tablet_class &&
+            tablet_peer->LeaderStatus() == consensus::Consensus::LeaderStatus::LEADER_AND_READY &&
+            tablet_peer->consensus()->GetLastOpId(
+                consensus::COMMITTED_OPID, &committed_op_id).ok()) {
+          auto* tablet_metrics = req.mutable_metrics()->add_tablet_metrics();
+          tablet_metrics->set_tablet_id(tablet_peer->tablet_id());
+          tablet_metrics->set_sst_file_size(file_sizes);
+          const auto hot_keys = tablet_class->hot_keys().TopKeys(1);
+          if (!hot_keys.empty()) {
+            tablet_metrics->set_hottest_key(hot_keys[0].key);
+            tablet_metrics->set_hottest_key_share(hot_keys[0].share);
+          }
+          auto* metrics = tablet_class->metrics();
+          tablet_counters.push_back(TabletCounters {
+              committed_op_id.index(),
+              metrics->ql_read_latency->TotalCount() + metrics->redis_read_latency->TotalCount()
+          });
+        }
       }
     }
     req.mutable_metrics()->set_total_sst_file_size(total_file_sizes);
@@ -437,6 +476,38 @@ Status Heartbeater::Thread::TryHeartbeat() {
     prev_writes_ = num_writes;
     req.mutable_metrics()->set_read_ops_per_sec(rops_per_sec);
     req.mutable_metrics()->set_write_ops_per_sec(wops_per_sec);
+
+    // Every committed Raft operation of a tablet is a write, so the rate of committed index
+    // growth is its write rate. Tablets that are not led anymore are forgotten.
+    std::unordered_map<TabletId, TabletCounters> tablet_counters_map;
+    for (int i = 0; i != req.metrics().tablet_metrics_size(); ++i) {
+      auto* tablet_metrics = req.mutable_metrics()->mutable_tablet_metrics(i);
+      const auto& counters = tablet_counters[i];
+      auto prev = prev_tablet_counters_.find(tablet_metrics->tablet_id());
+      double tablet_wops_per_sec = 0;
+      double tablet_rops_per_sec = 0;
+      if (div > 0 && prev != prev_tablet_counters_.end()) {
+        if (counters.committed_index > prev->second.committed_index) {
+          tablet_wops_per_sec =
+              static_cast<double>(counters.committed_index - prev->second.committed_index) / div;
+        }
+        if (counters.reads > prev->second.reads) {
+          tablet_rops_per_sec = static_cast<double>(counters.reads - prev->second.reads) / div;
+        }
+      }
+      tablet_metrics->set_write_ops_per_sec(tablet_wops_per_sec);
+      tablet_metrics->set_read_ops_per_sec(tablet_rops_per_sec);
+      tablet_counters_map.emplace(tablet_metrics->tablet_id(), counters);
+    }
+    prev_tablet_counters_.swap(tablet_counters_map);
+
+    const auto cpu_times = cpu_stopwatch_.elapsed();
+    if (cpu_times.wall > 0) {
+      req.mutable_metrics()->set_cpu_utilization(
+          (cpu_times.user_cpu_seconds() + cpu_times.system_cpu_seconds()) /
+          cpu_times.wall_seconds() / base::NumCPUs());
+    }
+    cpu_stopwatch_.start();
     prev_tserver_metrics_submission_ = MonoTime::Now();
 
     VLOG(4) << "Read Ops per second: " << rops_per_sec;
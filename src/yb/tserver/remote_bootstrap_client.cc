@@ -32,6 +32,15 @@
 
 #include "yb/tserver/remote_bootstrap_client.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+
 #include <gflags/gflags.h>
 #include <glog/logging.h>
 
@@ -84,6 +93,35 @@ DEFINE_int32(committed_config_change_role_timeout_sec, 30,
              "timing out. ");
 TAG_FLAG(committed_config_change_role_timeout_sec, hidden);
 
+DEFINE_int32(remote_bootstrap_max_concurrent_file_downloads, 4,
+             "Max number of files that a single remote bootstrap downloads at the same time.");
+TAG_FLAG(remote_bootstrap_max_concurrent_file_downloads, advanced);
+TAG_FLAG(remote_bootstrap_max_concurrent_file_downloads, runtime);
+
+DEFINE_int32(remote_bootstrap_max_chunks_in_flight_per_file, 2,
+             "Max number of FetchData RPCs for different chunks of the same file that a remote "
+             "bootstrap keeps in flight at the same time.");
+TAG_FLAG(remote_bootstrap_max_chunks_in_flight_per_file, advanced);
+TAG_FLAG(remote_bootstrap_max_chunks_in_flight_per_file, runtime);
+
+DEFINE_int32(remote_bootstrap_max_chunk_size, 0,
+             "Max number of bytes requested by a single FetchData RPC. 0 means the max allowed by "
+             "--rpc_max_message_size.");
+TAG_FLAG(remote_bootstrap_max_chunk_size, advanced);
+TAG_FLAG(remote_bootstrap_max_chunk_size, runtime);
+
+DEFINE_int64(remote_bootstrap_rate_limit_bytes_per_sec, 0,
+             "Max total rate at which all remote bootstraps on this server download data. "
+             "0 means unlimited.");
+TAG_FLAG(remote_bootstrap_rate_limit_bytes_per_sec, advanced);
+TAG_FLAG(remote_bootstrap_rate_limit_bytes_per_sec, runtime);
+
+DEFINE_bool(remote_bootstrap_use_direct_io, false,
+            "Write RocksDB files downloaded by remote bootstrap with direct I/O, so that a large "
+            "bootstrap does not evict the page cache of the tablets being served.");
+TAG_FLAG(remote_bootstrap_use_direct_io, advanced);
+TAG_FLAG(remote_bootstrap_use_direct_io, runtime);
+
 DECLARE_int32(rpc_max_message_size);
 
 DEFINE_test_flag(double, fault_crash_bootstrap_client_before_changing_role, 0.0,
@@ -117,6 +155,115 @@ using tablet::TabletMetadata;
 using tablet::TabletStatusListener;
 using tablet::TabletSuperBlockPB;
 
+namespace {
+
+// Shared by all remote bootstrap clients of the process, so concurrent bootstraps together do not
+// download faster than --remote_bootstrap_rate_limit_bytes_per_sec.
+class RemoteBootstrapRateLimiter {
+ public:
+  // Accounts 'bytes' that were just received and blocks the caller until the time when receiving
+  // them would fit into the limit.
+  void Received(size_t bytes) {
+    const int64_t rate = FLAGS_remote_bootstrap_rate_limit_bytes_per_sec;
+    if (rate <= 0) {
+      return;
+    }
+    const auto now = MonoTime::Now();
+    MonoTime wait_until;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      // Idle time is not accumulated, otherwise it would allow a burst above the limit.
+      if (!next_free_ || next_free_ < now) {
+        next_free_ = now;
+      }
+      next_free_ += MonoDelta::FromMicroseconds(bytes * MonoTime::kMicrosecondsPerSecond / rate);
+      wait_until = next_free_;
+    }
+    if (now < wait_until) {
+      SleepFor(wait_until - now);
+    }
+  }
+
+ private:
+  std::mutex mutex_;
+  MonoTime next_free_;
+};
+
+RemoteBootstrapRateLimiter& RateLimiter() {
+  static RemoteBootstrapRateLimiter rate_limiter;
+  return rate_limiter;
+}
+
+struct PendingChunk {
+  FetchDataRequestPB request;
+  FetchDataResponsePB response;
+  rpc::RpcController controller;
+  // Received data, points either into the response or into its sidecar held by the controller.
+  Slice data;
+};
+
+// FetchData RPCs for chunks of a single file that are in flight at the same time.
+// Responses are returned in the order they arrive, which is not necessarily the order of requests.
+class ChunkWindow {
+ public:
+  ChunkWindow(RemoteBootstrapServiceProxy* proxy, MonoDelta timeout)
+      : proxy_(proxy), timeout_(timeout) {}
+
+  ChunkWindow(const ChunkWindow&) = delete;
+  void operator=(const ChunkWindow&) = delete;
+
+  // Waits for RPCs that are still in flight, since they reference the chunks.
+  ~ChunkWindow() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cond_.wait(lock, [this] { return in_flight_ == 0; });
+  }
+
+  void Send(const FetchDataRequestPB& request) {
+    auto* chunk = new PendingChunk;
+    chunk->request = request;
+    chunk->controller.set_timeout(timeout_);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++in_flight_;
+    }
+    proxy_->FetchDataAsync(
+        chunk->request, &chunk->response, &chunk->controller, [this, chunk] {
+      std::lock_guard<std::mutex> lock(mutex_);
+      --in_flight_;
+      done_.emplace_back(chunk);
+      cond_.notify_all();
+    });
+  }
+
+  // Number of sent chunks that were not returned by Next() yet.
+  size_t outstanding() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return in_flight_ + done_.size();
+  }
+
+  // Blocks until some RPC completes and returns its chunk. At least one chunk should be
+  // outstanding.
+  std::unique_ptr<PendingChunk> Next() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    DCHECK(in_flight_ != 0 || !done_.empty());
+    cond_.wait(lock, [this] { return !done_.empty(); });
+    auto result = std::move(done_.front());
+    done_.pop_front();
+    return result;
+  }
+
+ private:
+  RemoteBootstrapServiceProxy* const proxy_;
+  const MonoDelta timeout_;
+
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  size_t in_flight_ = 0;
+  std::deque<std::unique_ptr<PendingChunk>> done_;
+};
+
+} // namespace
+
 RemoteBootstrapClient::RemoteBootstrapClient(std::string tablet_id,
                                              FsManager* fs_manager,
                                              shared_ptr<Messenger> messenger,
@@ -207,6 +354,14 @@ Status RemoteBootstrapClient::Start(const string& bootstrap_peer_uuid,
   BeginRemoteBootstrapSessionRequestPB req;
   req.set_requestor_uuid(permanent_uuid_);
   req.set_tablet_id(tablet_id_);
+  if (replace_tombstoned_tablet_ &&
+      fs_manager_->env()->FileExists(meta_->reusable_rocksdb_files_dir())) {
+    Status s = AddReusableRocksDBFiles(meta_->reusable_rocksdb_files_dir(), std::string(), &req);
+    if (!s.ok()) {
+      LOG_WITH_PREFIX(WARNING) << "Failed to list RocksDB files kept for reuse: " << s;
+      req.clear_reusable_rocksdb_files();
+    }
+  }
 
   rpc::RpcController controller;
   controller.set_timeout(MonoDelta::FromMilliseconds(
@@ -233,6 +388,14 @@ Status RemoteBootstrapClient::Start(const string& bootstrap_peer_uuid,
   session_id_ = resp.session_id();
   LOG(INFO) << "Began remote bootstrap session " << session_id_;
 
+  reused_rocksdb_files_.clear();
+  reused_rocksdb_files_.insert(
+      resp.reused_rocksdb_files().begin(), resp.reused_rocksdb_files().end());
+  if (req.reusable_rocksdb_files_size() > 0) {
+    LOG_WITH_PREFIX(INFO) << "Reusing " << reused_rocksdb_files_.size() << " of "
+                          << req.reusable_rocksdb_files_size() << " kept RocksDB files";
+  }
+
   session_idle_timeout_millis_ = resp.session_idle_timeout_millis();
   superblock_.reset(resp.release_superblock());
 
@@ -380,6 +543,9 @@ Status RemoteBootstrapClient::Finish() {
 
   RETURN_NOT_OK_PREPEND(EndRemoteSession(), "Error closing remote bootstrap session " +
                         session_id_);
+
+  // Files that were needed are linked to RocksDB by now.
+  WARN_NOT_OK(meta_->DeleteReusableRocksDBFiles(), "Failed to delete RocksDB files kept for reuse");
   return Status::OK();
 }
 
@@ -511,38 +677,90 @@ Status RemoteBootstrapClient::DownloadWALs() {
   // Download the WAL segments.
   int num_segments = wal_seqnos_.size();
   LOG_WITH_PREFIX(INFO) << "Starting download of " << num_segments << " WAL segments...";
-  uint64_t counter = 0;
-  for (uint64_t seg_seqno : wal_seqnos_) {
+  RETURN_NOT_OK(DownloadInParallel(num_segments, [this, num_segments](size_t index) {
+    const uint64_t seg_seqno = wal_seqnos_[index];
     UpdateStatusMessage(Substitute("Downloading WAL segment with seq. number $0 ($1/$2)",
-                                   seg_seqno, counter + 1, num_segments));
-    RETURN_NOT_OK(DownloadWAL(seg_seqno));
-    ++counter;
-  }
+                                   seg_seqno, index + 1, num_segments));
+    return DownloadWAL(seg_seqno);
+  }));
 
   downloaded_wal_ = true;
   return Status::OK();
 }
 
+Status RemoteBootstrapClient::AddReusableRocksDBFiles(
+    const std::string& dir, const std::string& prefix, BeginRemoteBootstrapSessionRequestPB* req) {
+  auto* env = fs_manager_->env();
+  std::vector<std::string> children;
+  RETURN_NOT_OK(env->GetChildren(dir, ExcludeDots::kTrue, &children));
+  for (const auto& child : children) {
+    const auto path = JoinPathSegments(dir, child);
+    const auto name = prefix.empty() ? child : JoinPathSegments(prefix, child);
+    bool is_dir = false;
+    RETURN_NOT_OK(env->IsDirectory(path, &is_dir));
+    if (is_dir) {
+      RETURN_NOT_OK(AddReusableRocksDBFiles(path, name, req));
+      continue;
+    }
+    auto* file = req->add_reusable_rocksdb_files();
+    file->set_name(name);
+    file->set_size_bytes(VERIFY_RESULT(env->GetFileSize(path)));
+    file->set_crc32(VERIFY_RESULT(env_util::Crc32cFile(env, path)));
+  }
+  return Status::OK();
+}
+
+bool RemoteBootstrapClient::LinkReusedRocksDBFile(
+    const tablet::FilePB& file_pb, const std::string& file_path) {
+  if (reused_rocksdb_files_.count(file_pb.name()) == 0) {
+    return false;
+  }
+  const auto kept_path = JoinPathSegments(meta_->reusable_rocksdb_files_dir(), file_pb.name());
+  auto link_status = fs_manager_->env()->LinkFile(kept_path, file_path);
+  if (!link_status.ok()) {
+    LOG_WITH_PREFIX(WARNING) << "Failed to link kept file " << kept_path << " => " << file_path
+                             << ", downloading it: " << link_status;
+    return false;
+  }
+  VLOG_WITH_PREFIX(2) << "Reused kept file " << kept_path << " => " << file_path;
+  return true;
+}
+
 Status RemoteBootstrapClient::DownloadFile(
     const tablet::FilePB& file_pb, const std::string& dir, DataIdPB *data_id) {
   auto file_path = JoinPathSegments(dir, file_pb.name());
+  if (LinkReusedRocksDBFile(file_pb, file_path)) {
+    if (file_pb.inode() != 0) {
+      std::lock_guard<std::mutex> lock(inode2file_mutex_);
+      inode2file_.emplace(file_pb.inode(), file_path);
+    }
+    return Status::OK();
+  }
   if (file_pb.inode() != 0) {
-    auto it = inode2file_.find(file_pb.inode());
-    if (it != inode2file_.end()) {
+    string linked_path;
+    {
+      std::lock_guard<std::mutex> lock(inode2file_mutex_);
+      auto it = inode2file_.find(file_pb.inode());
+      if (it != inode2file_.end()) {
+        linked_path = it->second;
+      }
+    }
+    if (!linked_path.empty()) {
       VLOG(2) << "File with the same inode already found: " << file_path
-              << " => " << it->second;
-      auto link_status = fs_manager_->env()->LinkFile(it->second, file_path);
+              << " => " << linked_path;
+      auto link_status = fs_manager_->env()->LinkFile(linked_path, file_path);
       if (link_status.ok()) {
         return Status::OK();
       }
       // TODO fallback to copy.
-      LOG(ERROR) << "Failed to link file: " << file_path << " => " << it->second
+      LOG(ERROR) << "Failed to link file: " << file_path << " => " << linked_path
                  << ": " << link_status;
     }
   }
 
   WritableFileOptions opts;
   opts.sync_on_close = true;
+  opts.o_direct = FLAGS_remote_bootstrap_use_direct_io;
   gscoped_ptr<WritableFile> file;
   RETURN_NOT_OK(fs_manager_->env()->NewWritableFile(opts, file_path, &file));
 
@@ -553,6 +771,7 @@ Status RemoteBootstrapClient::DownloadFile(
   VLOG(2) << "Downloaded file " << file_path;
 
   if (file_pb.inode() != 0) {
+    std::lock_guard<std::mutex> lock(inode2file_mutex_);
     inode2file_.emplace(file_pb.inode(), file_path);
   }
 
@@ -575,10 +794,35 @@ Status RemoteBootstrapClient::DownloadRocksDBFiles() {
                         Substitute("Failed to create RocksDB tablet directory $0",
                                    rocksdb_dir));
 
-  DataIdPB data_id;
-  data_id.set_type(DataIdPB::ROCKSDB_FILE);
+  // Files that share an inode are hard links to the same data, so only the first of them is
+  // downloaded, concurrently with other files, and the rest are linked to it afterwards.
+  std::vector<const tablet::FilePB*> files;
+  std::vector<const tablet::FilePB*> links;
+  std::unordered_set<uint64_t> inodes;
   for (auto const& file_pb : new_sb->rocksdb_files()) {
-    RETURN_NOT_OK(DownloadFile(file_pb, rocksdb_dir, &data_id));
+    // Files of intents RocksDB are stored in a subdirectory.
+    const auto file_dir = DirName(JoinPathSegments(rocksdb_dir, file_pb.name()));
+    if (file_dir != rocksdb_dir) {
+      RETURN_NOT_OK_PREPEND(meta_->fs_manager()->CreateDirIfMissing(file_dir),
+                            Substitute("Failed to create RocksDB subdirectory $0", file_dir));
+    }
+    if (file_pb.inode() != 0 && !inodes.insert(file_pb.inode()).second) {
+      links.push_back(&file_pb);
+    } else {
+      files.push_back(&file_pb);
+    }
+  }
+
+  auto download = [this, &rocksdb_dir](const tablet::FilePB& file_pb) {
+    DataIdPB data_id;
+    data_id.set_type(DataIdPB::ROCKSDB_FILE);
+    return DownloadFile(file_pb, rocksdb_dir, &data_id);
+  };
+  RETURN_NOT_OK(DownloadInParallel(files.size(), [&files, &download](size_t index) {
+    return download(*files[index]);
+  }));
+  for (const auto* file_pb : links) {
+    RETURN_NOT_OK(download(*file_pb));
   }
   new_superblock_.swap(new_sb);
   downloaded_rocksdb_files_ = true;
@@ -649,45 +893,131 @@ Status RemoteBootstrapClient::DownloadBlock(const BlockId& old_block_id,
   return Status::OK();
 }
 
+Status RemoteBootstrapClient::DownloadInParallel(
+    size_t count, const std::function<Status(size_t)>& download) {
+  const size_t num_threads = std::min<size_t>(
+      count, std::max(FLAGS_remote_bootstrap_max_concurrent_file_downloads, 1));
+  std::atomic<size_t> next_index(0);
+  std::atomic<bool> failed(false);
+  std::mutex status_mutex;
+  Status result;
+
+  auto worker = [&] {
+    while (!failed.load(std::memory_order_acquire)) {
+      const size_t index = next_index++;
+      if (index >= count) {
+        return;
+      }
+      auto status = download(index);
+      if (!status.ok()) {
+        std::lock_guard<std::mutex> lock(status_mutex);
+        if (result.ok()) {
+          result = status;
+        }
+        failed.store(true, std::memory_order_release);
+      }
+    }
+  };
+
+  // The calling thread is one of the workers.
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < num_threads; ++i) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  return result;
+}
+
 template<class Appendable>
 Status RemoteBootstrapClient::DownloadFile(const DataIdPB& data_id,
                                            Appendable* appendable) {
-  uint64_t offset = 0;
   int32_t max_length = FLAGS_rpc_max_message_size - 1024; // Leave 1K for message headers.
+  if (FLAGS_remote_bootstrap_max_chunk_size > 0) {
+    max_length = std::min(max_length, FLAGS_remote_bootstrap_max_chunk_size);
+  }
+  const size_t window_size = std::max(FLAGS_remote_bootstrap_max_chunks_in_flight_per_file, 1);
 
-  rpc::RpcController controller;
-  controller.set_timeout(MonoDelta::FromMilliseconds(session_idle_timeout_millis_));
   FetchDataRequestPB req;
-
-  bool done = false;
-  while (!done) {
-    controller.Reset();
-    req.set_session_id(session_id_);
-    req.mutable_data_id()->CopyFrom(data_id);
+  req.set_session_id(session_id_);
+  req.mutable_data_id()->CopyFrom(data_id);
+  req.set_accept_sidecar(true);
+  ChunkWindow window(proxy_.get(), MonoDelta::FromMilliseconds(session_idle_timeout_millis_));
+  auto send = [&req, &window](uint64_t offset, uint64_t length) {
     req.set_offset(offset);
-    req.set_max_length(max_length);
-
-    FetchDataResponsePB resp;
-    RETURN_NOT_OK_UNWIND_PREPEND(proxy_->FetchData(req, &resp, &controller),
-                                controller,
-                                "Unable to fetch data from remote");
+    req.set_max_length(length);
+    window.Send(req);
+  };
+
+  // The total length of the data and the size of the chunks that the remote returns are not
+  // known until the first response arrives, so the window is only opened after it.
+  uint64_t total_length = 0;
+  uint64_t chunk_length = 0;
+  // Offset of the first byte that was not requested yet.
+  uint64_t fetch_offset = 0;
+  // Offset of the first byte that was not written yet, chunks received ahead of it are kept in
+  // 'received' by their offsets.
+  uint64_t write_offset = 0;
+  std::map<uint64_t, std::unique_ptr<PendingChunk>> received;
+
+  send(0, max_length);
+  for (;;) {
+    auto chunk = window.Next();
+    RETURN_NOT_OK_UNWIND_PREPEND(chunk->controller.status(),
+                                 chunk->controller,
+                                 "Unable to fetch data from remote");
+    const auto& resp_chunk = chunk->response.chunk();
+    if (resp_chunk.has_sidecar_idx()) {
+      RETURN_NOT_OK_PREPEND(chunk->controller.GetSidecar(resp_chunk.sidecar_idx(), &chunk->data),
+                            "Unable to get data sidecar");
+    } else {
+      chunk->data = resp_chunk.data();
+    }
     // Sanity-check for corruption.
-    RETURN_NOT_OK_PREPEND(VerifyData(offset, resp.chunk()),
+    RETURN_NOT_OK_PREPEND(VerifyData(chunk->request.offset(), resp_chunk, chunk->data),
                           Substitute("Error validating data item $0", data_id.ShortDebugString()));
+    const uint64_t offset = resp_chunk.offset();
+    const uint64_t size = chunk->data.size();
+    if (size == 0 && offset < resp_chunk.total_data_length()) {
+      return STATUS(IllegalState, "Received empty chunk",
+                    Substitute("$0 at offset $1", data_id.ShortDebugString(), offset));
+    }
+    RateLimiter().Received(size);
+
+    if (chunk_length == 0) {
+      total_length = resp_chunk.total_data_length();
+      chunk_length = size;
+      fetch_offset = size;
+    } else if (size < chunk->request.max_length() && offset + size < total_length) {
+      // The remote returned less than requested, so fetch the rest of the range separately.
+      send(offset + size, chunk->request.max_length() - size);
+    }
+    received.emplace(offset, std::move(chunk));
 
     // Write the data.
-    RETURN_NOT_OK(appendable->Append(resp.chunk().data()));
+    for (auto it = received.begin(); it != received.end() && it->first == write_offset;) {
+      RETURN_NOT_OK(appendable->Append(it->second->data));
+      write_offset += it->second->data.size();
+      it = received.erase(it);
+    }
+    if (write_offset >= total_length) {
+      break;
+    }
 
-    if (offset + resp.chunk().data().size() == resp.chunk().total_data_length()) {
-      done = true;
+    while (fetch_offset < total_length && window.outstanding() < window_size) {
+      const uint64_t length = std::min(chunk_length, total_length - fetch_offset);
+      send(fetch_offset, length);
+      fetch_offset += length;
     }
-    offset += resp.chunk().data().size();
   }
 
   return Status::OK();
 }
 
-Status RemoteBootstrapClient::VerifyData(uint64_t offset, const DataChunkPB& chunk) {
+Status RemoteBootstrapClient::VerifyData(uint64_t offset, const DataChunkPB& chunk,
+                                         const Slice& data) {
   // Verify the offset is what we expected.
   if (offset != chunk.offset()) {
     return STATUS(InvalidArgument, "Offset did not match what was asked for",
@@ -695,11 +1025,11 @@ Status RemoteBootstrapClient::VerifyData(uint64_t offset, const DataChunkPB& chu
   }
 
   // Verify the checksum.
-  uint32_t crc32 = crc::Crc32c(chunk.data().data(), chunk.data().length());
+  uint32_t crc32 = crc::Crc32c(data.data(), data.size());
   if (PREDICT_FALSE(crc32 != chunk.crc32())) {
     return STATUS(Corruption,
         Substitute("CRC32 does not match at offset $0 size $1: $2 vs $3",
-          offset, chunk.data().size(), crc32, chunk.crc32()));
+          offset, data.size(), crc32, chunk.crc32()));
   }
   return Status::OK();
 }
@@ -32,10 +32,13 @@
 #ifndef YB_TSERVER_REMOTE_BOOTSTRAP_CLIENT_H
 #define YB_TSERVER_REMOTE_BOOTSTRAP_CLIENT_H
 
+#include <functional>
 #include <string>
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 
 #include <gtest/gtest_prod.h>
 
@@ -77,8 +80,11 @@ class TSTabletManager;
 // Client class for using remote bootstrap to copy a tablet from another host.
 // This class is not thread-safe.
 //
-// TODO:
-// * Parallelize download of blocks and WAL segments.
+// Up to --remote_bootstrap_max_concurrent_file_downloads RocksDB files or WAL segments are
+// downloaded at the same time, each of them with up to
+// --remote_bootstrap_max_chunks_in_flight_per_file FetchData RPCs in flight.
+// The total download rate of all clients in the process is limited by
+// --remote_bootstrap_rate_limit_bytes_per_sec.
 //
 class RemoteBootstrapClient {
  public:
@@ -134,6 +140,7 @@ class RemoteBootstrapClient {
  protected:
   FRIEND_TEST(RemoteBootstrapRocksDBClientTest, TestBeginEndSession);
   FRIEND_TEST(RemoteBootstrapRocksDBClientTest, TestDownloadRocksDBFiles);
+  friend class RemoteBootstrapRocksDBClientTest;
 
   // Extract the embedded Status message from the given ErrorStatusPB.
   // The given ErrorStatusPB must extend RemoteBootstrapErrorPB.
@@ -149,7 +156,7 @@ class RemoteBootstrapClient {
   // End the remote bootstrap session.
   CHECKED_STATUS EndRemoteSession();
 
-  // Download all WAL files sequentially.
+  // Download all WAL files.
   CHECKED_STATUS DownloadWALs();
 
   // Download a single WAL file.
@@ -179,11 +186,29 @@ class RemoteBootstrapClient {
 
   CHECKED_STATUS DownloadRocksDBFiles();
 
-  CHECKED_STATUS VerifyData(uint64_t offset, const DataChunkPB& resp);
+  // Adds files, that were kept in 'dir' when the replaced tablet was tombstoned, to 'req', so the
+  // remote peer could tell which of them are not needed to be downloaded. 'prefix' is the path of
+  // 'dir' relative to the kept RocksDB directory.
+  CHECKED_STATUS AddReusableRocksDBFiles(const std::string& dir, const std::string& prefix,
+                                         BeginRemoteBootstrapSessionRequestPB* req);
+
+  // Links the file from the directory with files kept for reuse, if the remote peer reported that
+  // it has the same file. Returns true when the file was linked.
+  bool LinkReusedRocksDBFile(const tablet::FilePB& file_pb, const std::string& file_path);
+
+  // Verifies the chunk received at 'offset', 'data' is the data of the chunk, that is either
+  // contained in it or received in a sidecar.
+  CHECKED_STATUS VerifyData(uint64_t offset, const DataChunkPB& chunk, const Slice& data);
 
   CHECKED_STATUS DownloadFile(
       const tablet::FilePB& file_pb, const std::string& dir, DataIdPB* data_id);
 
+  // Invokes 'download' for each index in [0, count) using up to
+  // --remote_bootstrap_max_concurrent_file_downloads threads. Stops at the first failure and
+  // returns its status.
+  CHECKED_STATUS DownloadInParallel(size_t count,
+                                    const std::function<Status(size_t)>& download);
+
   // Return standard log prefix.
   std::string LogPrefix();
 
@@ -218,6 +243,9 @@ class RemoteBootstrapClient {
   gscoped_ptr<consensus::ConsensusStatePB> remote_committed_cstate_;
   std::vector<uint64_t> wal_seqnos_;
 
+  // Names of RocksDB files that the remote peer has in common with the files kept for reuse.
+  std::unordered_set<std::string> reused_rocksdb_files_;
+
   int64_t start_time_micros_;
 
   // We track whether this session succeeded and send this information as part of the
@@ -225,6 +253,7 @@ class RemoteBootstrapClient {
   bool succeeded_;
 
  private:
+  std::mutex inode2file_mutex_;
   std::unordered_map<uint64_t, std::string> inode2file_;
 
   DISALLOW_COPY_AND_ASSIGN(RemoteBootstrapClient);
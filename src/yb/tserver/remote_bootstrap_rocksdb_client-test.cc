@@ -15,9 +15,16 @@
 
 #include "yb/tserver/remote_bootstrap_client-test.h"
 
+#include "yb/util/size_literals.h"
+
 
 using std::shared_ptr;
 
+DECLARE_int32(remote_bootstrap_max_concurrent_file_downloads);
+DECLARE_int32(remote_bootstrap_max_chunks_in_flight_per_file);
+DECLARE_int32(remote_bootstrap_max_chunk_size);
+DECLARE_int64(remote_bootstrap_rate_limit_bytes_per_sec);
+
 namespace yb {
 namespace tserver {
 
@@ -33,6 +40,9 @@ class RemoteBootstrapRocksDBClientTest : public RemoteBootstrapClientTest {
   void SetUp() override {
     RemoteBootstrapClientTest::SetUp();
   }
+
+ protected:
+  void TestDownloadRocksDBFiles();
 };
 
 // Basic begin / end remote bootstrap session.
@@ -42,8 +52,7 @@ TEST_F(RemoteBootstrapRocksDBClientTest, TestBeginEndSession) {
   ASSERT_OK(client_->Finish());
 }
 
-// Basic RocksDB files download unit test.
-TEST_F(RemoteBootstrapRocksDBClientTest, TestDownloadRocksDBFiles) {
+void RemoteBootstrapRocksDBClientTest::TestDownloadRocksDBFiles() {
   TabletStatusListener listener(meta_);
   ASSERT_OK(client_->DownloadRocksDBFiles());
   auto tablet_peer_checkpoint_dir = tablet_peer_->tablet()->GetLastRocksDBCheckpointDirForTest();
@@ -78,5 +87,20 @@ TEST_F(RemoteBootstrapRocksDBClientTest, TestDownloadRocksDBFiles) {
   }
 }
 
+// Basic RocksDB files download unit test.
+TEST_F(RemoteBootstrapRocksDBClientTest, TestDownloadRocksDBFiles) {
+  TestDownloadRocksDBFiles();
+}
+
+// Downloads files concurrently with small chunks, so several chunks of the same file are in flight
+// and could arrive out of order.
+TEST_F(RemoteBootstrapRocksDBClientTest, TestDownloadRocksDBFilesInParallel) {
+  FLAGS_remote_bootstrap_max_concurrent_file_downloads = 4;
+  FLAGS_remote_bootstrap_max_chunks_in_flight_per_file = 8;
+  FLAGS_remote_bootstrap_max_chunk_size = 4096;
+  FLAGS_remote_bootstrap_rate_limit_bytes_per_sec = 100_MB;
+  TestDownloadRocksDBFiles();
+}
+
 } // namespace tserver
 } // namespace yb
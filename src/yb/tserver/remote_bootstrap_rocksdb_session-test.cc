@@ -13,6 +13,8 @@
 
 #include "yb/tserver/remote_bootstrap_session-test.h"
 
+#include "yb/util/env_util.h"
+
 namespace yb {
 namespace tserver {
 
@@ -82,5 +84,32 @@ TEST_F(RemoteBootstrapRocksDBTest, TestNonExistentRocksDBFile) {
   ASSERT_TRUE(status.IsNotFound());
 }
 
+TEST_F(RemoteBootstrapRocksDBTest, TestFindReusableRocksDBFiles) {
+  const auto& superblock = session_->tablet_superblock();
+  ASSERT_GT(superblock.rocksdb_files_size(), 1);
+
+  // The first file matches, the second one has a wrong checksum, and the last one is unknown to the
+  // session.
+  google::protobuf::RepeatedPtrField<ReusableFilePB> client_files;
+  for (int i = 0; i != 2; ++i) {
+    const auto& file_pb = superblock.rocksdb_files(i);
+    auto* file = client_files.Add();
+    file->set_name(file_pb.name());
+    file->set_size_bytes(file_pb.size_bytes());
+    const auto crc32 = ASSERT_RESULT(env_util::Crc32cFile(
+        env_.get(), JoinPathSegments(session_->checkpoint_dir_, file_pb.name())));
+    file->set_crc32(i == 0 ? crc32 : crc32 + 1);
+  }
+  auto* unknown_file = client_files.Add();
+  unknown_file->set_name("999999.sst");
+  unknown_file->set_size_bytes(1);
+  unknown_file->set_crc32(0);
+
+  google::protobuf::RepeatedPtrField<std::string> reused_files;
+  ASSERT_OK(session_->FindReusableRocksDBFiles(client_files, &reused_files));
+  ASSERT_EQ(1, reused_files.size());
+  ASSERT_EQ(superblock.rocksdb_files(0).name(), reused_files.Get(0));
+}
+
 }  // namespace tserver
 }  // namespace yb
@@ -129,11 +129,13 @@ class RemoteBootstrapServiceTest : public RemoteBootstrapTest {
   Status DoFetchData(const string& session_id, const DataIdPB& data_id,
                      uint64_t* offset, int64_t* max_length,
                      FetchDataResponsePB* resp,
-                     RpcController* controller) {
+                     RpcController* controller,
+                     bool accept_sidecar = false) {
     controller->set_timeout(MonoDelta::FromSeconds(1.0));
     FetchDataRequestPB req;
     req.set_session_id(session_id);
     req.mutable_data_id()->CopyFrom(data_id);
+    req.set_accept_sidecar(accept_sidecar);
     if (offset) {
       req.set_offset(*offset);
     }
@@ -409,6 +411,44 @@ TEST_F(RemoteBootstrapServiceTest, TestFetchLog) {
   AssertDataEqual(slice.data(), slice.size(), resp.chunk());
 }
 
+// Test that a log segment is properly sent as a file sidecar when the client accepts it.
+TEST_F(RemoteBootstrapServiceTest, TestFetchLogAsSidecar) {
+  string session_id;
+  tablet::TabletSuperBlockPB superblock;
+  uint64_t idle_timeout_millis;
+  vector<uint64_t> segment_seqnos;
+  ASSERT_OK(DoBeginValidRemoteBootstrapSession(&session_id,
+                                               &superblock,
+                                               &idle_timeout_millis,
+                                               &segment_seqnos));
+  uint64_t seg_seqno = *segment_seqnos.begin();
+
+  FetchDataResponsePB resp;
+  RpcController controller;
+  DataIdPB data_id;
+  data_id.set_type(DataIdPB::LOG_SEGMENT);
+  data_id.set_wal_segment_seqno(seg_seqno);
+  ASSERT_OK(DoFetchData(session_id, data_id, nullptr, nullptr, &resp, &controller,
+                        true /* accept_sidecar */));
+  ASSERT_TRUE(resp.chunk().has_sidecar_idx());
+  ASSERT_TRUE(resp.chunk().data().empty());
+  Slice sidecar;
+  ASSERT_OK(controller.GetSidecar(resp.chunk().sidecar_idx(), &sidecar));
+
+  log::SegmentSequence local_segments;
+  ASSERT_OK(tablet_peer_->log()->GetLogReader()->GetSegmentsSnapshot(&local_segments));
+  const scoped_refptr<ReadableLogSegment>& segment = local_segments[0];
+  faststring scratch;
+  int64_t size = segment->file_size();
+  scratch.resize(size);
+  Slice slice;
+  ASSERT_OK(ReadFully(segment->readable_file().get(), 0, size, &slice, scratch.data()));
+
+  ASSERT_EQ(slice.ToBuffer(), sidecar.ToBuffer());
+  ASSERT_EQ(crc::Crc32c(slice.data(), slice.size()), resp.chunk().crc32());
+  ASSERT_EQ(size, resp.chunk().total_data_length());
+}
+
 // Test that the remote bootstrap session timeout works properly.
 TEST_F(RemoteBootstrapServiceTest, TestSessionTimeout) {
   // This flag should be seen by the service due to TSO.
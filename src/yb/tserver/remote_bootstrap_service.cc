@@ -51,6 +51,7 @@
 #include "yb/util/crc.h"
 #include "yb/util/fault_injection.h"
 #include "yb/util/flag_tags.h"
+#include "yb/util/mem_tracker.h"
 
 // Note, this macro assumes the existence of a local var named 'context'.
 #define RPC_RETURN_APP_ERROR(app_err, message, s) \
@@ -77,6 +78,19 @@ DEFINE_uint64(remote_bootstrap_timeout_poll_period_ms, 10000,
               "remote bootstrap sessions, in millis");
 TAG_FLAG(remote_bootstrap_timeout_poll_period_ms, hidden);
 
+DEFINE_bool(remote_bootstrap_use_file_sidecars, true,
+            "Send RocksDB files and WAL segments to remote bootstrap clients, that support it, as "
+            "RPC sidecars straight from the page cache, instead of copying them into responses.");
+TAG_FLAG(remote_bootstrap_use_file_sidecars, advanced);
+TAG_FLAG(remote_bootstrap_use_file_sidecars, runtime);
+
+DEFINE_bool(remote_bootstrap_reject_over_soft_memory_limit, false,
+            "Reject new remote bootstrap sessions while the tablet server is over its soft memory "
+            "limit, so memory is left to foreground writes. The peer retries remote bootstrap "
+            "later.");
+TAG_FLAG(remote_bootstrap_reject_over_soft_memory_limit, advanced);
+TAG_FLAG(remote_bootstrap_reject_over_soft_memory_limit, runtime);
+
 DEFINE_test_flag(double, fault_crash_on_handle_rb_fetch_data, 0.0,
                  "Fraction of the time when the tablet will crash while "
                  "servicing a RemoteBootstrapService FetchData() RPC call.");
@@ -155,6 +169,13 @@ void RemoteBootstrapServiceImpl::BeginRemoteBootstrapSession(
   {
     boost::lock_guard<simple_spinlock> l(sessions_lock_);
     if (!FindCopy(sessions_, session_id, &session)) {
+      if (FLAGS_remote_bootstrap_reject_over_soft_memory_limit &&
+          MemTracker::GetRootTracker()->AnySoftLimitOverage() > 0) {
+        RPC_RETURN_NOT_OK(STATUS(ServiceUnavailable, "Soft memory limit exceeded"),
+                          RemoteBootstrapErrorPB::UNKNOWN_ERROR,
+                          Substitute("Not starting remote bootstrap session for tablet $0",
+                                     tablet_id));
+      }
       LOG(INFO) << "Beginning new remote bootstrap session on tablet " << tablet_id
                 << " from peer " << requestor_uuid << " at " << context.requestor_string()
                 << ": session id = " << session_id;
@@ -186,6 +207,17 @@ void RemoteBootstrapServiceImpl::BeginRemoteBootstrapSession(
     resp->add_wal_segment_seqnos(segment->header().sequence_number());
   }
 
+  if (req->reusable_rocksdb_files_size() > 0) {
+    Status s = session->FindReusableRocksDBFiles(req->reusable_rocksdb_files(),
+                                                 resp->mutable_reused_rocksdb_files());
+    if (!s.ok()) {
+      // Reuse is only an optimization, so the client downloads all files in this case.
+      LOG(WARNING) << "Failed to find reusable RocksDB files for session " << session_id << ": "
+                   << s;
+      resp->clear_reused_rocksdb_files();
+    }
+  }
+
   context.RespondSuccess();
 }
 
@@ -286,19 +318,34 @@ void RemoteBootstrapServiceImpl::FetchData(const FetchDataRequestPB* req,
                     error_code, "Invalid DataId");
 
   DataChunkPB* data_chunk = resp->mutable_chunk();
-  string* data = data_chunk->mutable_data();
   int64_t total_data_length = 0;
-  RPC_RETURN_NOT_OK(GetDataFilePiece(data_id, session, offset, client_maxlen, data,
-                                     &total_data_length, &error_code),
-                    error_code, "Unable to get piece of data file");
+  if (req->accept_sidecar() && FLAGS_remote_bootstrap_use_file_sidecars &&
+      (data_id.type() == DataIdPB::ROCKSDB_FILE || data_id.type() == DataIdPB::LOG_SEGMENT)) {
+    rpc::FileSidecarPtr sidecar;
+    uint32_t crc32 = 0;
+    RPC_RETURN_NOT_OK(session->GetFilePieceSidecar(data_id, offset, client_maxlen, &sidecar,
+                                                   &crc32, &total_data_length, &error_code),
+                      error_code, "Unable to get piece of data file");
+    int sidecar_idx = 0;
+    RPC_RETURN_NOT_OK(context.AddRpcFileSidecar(std::move(sidecar), &sidecar_idx),
+                      RemoteBootstrapErrorPB::UNKNOWN_ERROR, "Unable to add file sidecar");
+    data_chunk->set_data("");
+    data_chunk->set_sidecar_idx(sidecar_idx);
+    data_chunk->set_crc32(crc32);
+  } else {
+    string* data = data_chunk->mutable_data();
+    RPC_RETURN_NOT_OK(GetDataFilePiece(data_id, session, offset, client_maxlen, data,
+                                       &total_data_length, &error_code),
+                      error_code, "Unable to get piece of data file");
+
+    // Calculate checksum.
+    uint32_t crc32 = Crc32c(data->data(), data->length());
+    data_chunk->set_crc32(crc32);
+  }
 
   data_chunk->set_total_data_length(total_data_length);
   data_chunk->set_offset(offset);
 
-  // Calculate checksum.
-  uint32_t crc32 = Crc32c(data->data(), data->length());
-  data_chunk->set_crc32(crc32);
-
   context.RespondSuccess();
 }
 
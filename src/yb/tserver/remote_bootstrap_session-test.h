@@ -116,7 +116,9 @@ class RemoteBootstrapTest : public YBTabletTest {
                                                                tablet()->tablet_id()),
                        *tablet()->schema(),
                        0,  // schema_version
-                       NULL, &log));
+                       NULL,
+                       nullptr /* append_thread_pool */,
+                       &log));
 
     scoped_refptr<MetricEntity> metric_entity =
       METRIC_ENTITY_tablet.Instantiate(&metric_registry_, CURRENT_TEST_NAME());
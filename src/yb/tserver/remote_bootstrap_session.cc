@@ -43,6 +43,8 @@
 #include "yb/server/metadata.h"
 #include "yb/tablet/tablet.h"
 #include "yb/tablet/tablet_peer.h"
+#include "yb/util/crc.h"
+#include "yb/util/env_util.h"
 #include "yb/util/stopwatch.h"
 #include "yb/util/trace.h"
 
@@ -424,6 +426,82 @@ Status RemoteBootstrapSession::GetFilePiece(const std::string path,
   return Status::OK();
 }
 
+Status RemoteBootstrapSession::GetFilePieceSidecar(
+    const DataIdPB& data_id, uint64_t offset, int64_t client_maxlen,
+    rpc::FileSidecarPtr* sidecar, uint32_t* crc32, int64_t* file_size,
+    RemoteBootstrapErrorPB::Code* error_code) {
+  string file_path;
+  switch (data_id.type()) {
+    case DataIdPB::LOG_SEGMENT: {
+      const uint64_t segment_seqno = data_id.wal_segment_seqno();
+      ImmutableRandomAccessFileInfo* file_info;
+      RETURN_NOT_OK(FindLogSegment(segment_seqno, &file_info, error_code));
+      *file_size = file_info->size;
+      // log_segments_ is not modified after Init(), so it could be accessed without the lock.
+      const auto first_seqno = log_segments_[0]->header().sequence_number();
+      file_path = log_segments_[segment_seqno - first_seqno]->path();
+      break;
+    }
+    case DataIdPB::ROCKSDB_FILE: {
+      file_path = JoinPathSegments(checkpoint_dir_, data_id.file_name());
+      if (!fs_manager_->env()->FileExists(file_path)) {
+        *error_code = RemoteBootstrapErrorPB::ROCKSDB_FILE_NOT_FOUND;
+        return STATUS(NotFound, Substitute("Unable to find RocksDB file $0 in directory $1",
+                                           data_id.file_name(), checkpoint_dir_));
+      }
+      *file_size = VERIFY_RESULT(fs_manager_->env()->GetFileSize(file_path));
+      break;
+    }
+    default:
+      *error_code = RemoteBootstrapErrorPB::INVALID_REMOTE_BOOTSTRAP_REQUEST;
+      return STATUS_FORMAT(InvalidArgument, "Data type $0 could not be sent as a file sidecar",
+                           DataIdPB::IdType_Name(data_id.type()));
+  }
+
+  int64_t response_data_size = 0;
+  RETURN_NOT_OK_PREPEND(GetResponseDataSize(*file_size, offset, client_maxlen, error_code,
+                                            &response_data_size),
+                        Substitute("Error reading $0", file_path));
+
+  auto result = rpc::FileSidecar::Open(file_path, offset, response_data_size);
+  if (!result.ok()) {
+    *error_code = RemoteBootstrapErrorPB::IO_ERROR;
+    return result.status();
+  }
+  Status s = (*result)->Map([crc32](const Slice& data) {
+    *crc32 = crc::Crc32c(data.data(), data.size());
+  });
+  if (!s.ok()) {
+    *error_code = RemoteBootstrapErrorPB::IO_ERROR;
+    return s;
+  }
+  *sidecar = std::move(*result);
+  return Status::OK();
+}
+
+Status RemoteBootstrapSession::FindReusableRocksDBFiles(
+    const google::protobuf::RepeatedPtrField<ReusableFilePB>& client_files,
+    google::protobuf::RepeatedPtrField<std::string>* reused_files) {
+  std::unordered_map<std::string, const ReusableFilePB*> client_files_by_name;
+  for (const auto& file : client_files) {
+    client_files_by_name.emplace(file.name(), &file);
+  }
+  for (const auto& file : tablet_superblock_.rocksdb_files()) {
+    auto it = client_files_by_name.find(file.name());
+    if (it == client_files_by_name.end() || it->second->size_bytes() != file.size_bytes()) {
+      continue;
+    }
+    // Checksum is calculated only for candidates, so files that the client does not have are not
+    // read twice.
+    const auto crc32 = VERIFY_RESULT(env_util::Crc32cFile(
+        fs_manager_->env(), JoinPathSegments(checkpoint_dir_, file.name())));
+    if (crc32 == it->second->crc32()) {
+      reused_files->Add()->assign(file.name());
+    }
+  }
+  return Status::OK();
+}
+
 bool RemoteBootstrapSession::IsBlockOpenForTests(const BlockId& block_id) const {
   boost::lock_guard<simple_spinlock> l(session_lock_);
   return ContainsKey(blocks_, block_id);
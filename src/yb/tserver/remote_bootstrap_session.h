@@ -46,6 +46,7 @@
 #include "yb/gutil/macros.h"
 #include "yb/gutil/ref_counted.h"
 #include "yb/gutil/stl_util.h"
+#include "yb/rpc/file_sidecar.h"
 #include "yb/tserver/remote_bootstrap.pb.h"
 #include "yb/util/env_util.h"
 #include "yb/util/locks.h"
@@ -150,6 +151,21 @@ class RemoteBootstrapSession : public RefCountedThreadSafe<RemoteBootstrapSessio
       const std::string path, const std::string file_name, uint64_t offset, int64_t client_maxlen,
       std::string* data, int64_t* log_file_size, RemoteBootstrapErrorPB::Code* error_code);
 
+  // Get a piece of a RocksDB checkpoint file or a log segment as a file sidecar, that is sent to
+  // the socket without copying the data. '*crc32' is set to the checksum of the piece, that is
+  // calculated over the memory mapped file.
+  // The other params are similar to GetBlockPiece().
+  CHECKED_STATUS GetFilePieceSidecar(
+      const DataIdPB& data_id, uint64_t offset, int64_t client_maxlen,
+      rpc::FileSidecarPtr* sidecar, uint32_t* crc32, int64_t* file_size,
+      RemoteBootstrapErrorPB::Code* error_code);
+
+  // Adds to 'reused_files' names of RocksDB checkpoint files, that the client already has, i.e.
+  // 'client_files' has a file with the same name, size and CRC32C checksum.
+  CHECKED_STATUS FindReusableRocksDBFiles(
+      const google::protobuf::RepeatedPtrField<ReusableFilePB>& client_files,
+      google::protobuf::RepeatedPtrField<std::string>* reused_files);
+
   const tablet::TabletSuperBlockPB& tablet_superblock() const { return tablet_superblock_; }
 
   const consensus::ConsensusStatePB& initial_committed_cstate() const {
@@ -174,6 +190,7 @@ class RemoteBootstrapSession : public RefCountedThreadSafe<RemoteBootstrapSessio
   FRIEND_TEST(RemoteBootstrapRocksDBTest, TestCheckpointDirectory);
   FRIEND_TEST(RemoteBootstrapRocksDBTest, CheckSuperBlockHasRocksDBFields);
   FRIEND_TEST(RemoteBootstrapRocksDBTest, CheckSuperBlockHasSnapshotFields);
+  FRIEND_TEST(RemoteBootstrapRocksDBTest, TestFindReusableRocksDBFiles);
 
   typedef std::unordered_map<BlockId, ImmutableReadableBlockInfo*, BlockIdHash> BlockMap;
   typedef std::unordered_map<uint64_t, ImmutableRandomAccessFileInfo*> LogMap;
@@ -33,6 +33,13 @@ void SetupErrorAndRespond(TabletServerErrorPB* error,
                           TabletServerErrorPB::Code code,
                           rpc::RpcContext* context);
 
+// Looks up the given tablet, ensuring that it both exists and is RUNNING. On failure sets
+// error_code to the code that should be reported with the returned status.
+CHECKED_STATUS LookupTabletPeer(TabletPeerLookupIf* tablet_manager,
+                                const string& tablet_id,
+                                scoped_refptr<tablet::TabletPeer>* peer,
+                                TabletServerErrorPB::Code* error_code);
+
 // Template helpers.
 
 template<class ReqClass, class RespClass>
@@ -102,27 +109,12 @@ bool LookupTabletPeerOrRespond(TabletPeerLookupIf* tablet_manager,
                                RespClass* resp,
                                rpc::RpcContext* context,
                                scoped_refptr<tablet::TabletPeer>* peer) {
-  Status status = tablet_manager->GetTabletPeer(tablet_id, peer);
+  TabletServerErrorPB::Code code = TabletServerErrorPB::UNKNOWN_ERROR;
+  Status status = LookupTabletPeer(tablet_manager, tablet_id, peer, &code);
   if (PREDICT_FALSE(!status.ok())) {
-    TabletServerErrorPB::Code code = status.IsServiceUnavailable() ?
-                                     TabletServerErrorPB::UNKNOWN_ERROR :
-                                     TabletServerErrorPB::TABLET_NOT_FOUND;
     SetupErrorAndRespond(resp->mutable_error(), status, code, context);
     return false;
   }
-
-  // Check RUNNING state.
-  tablet::TabletStatePB state = (*peer)->state();
-  if (PREDICT_FALSE(state != tablet::RUNNING)) {
-    Status s = STATUS(IllegalState, "Tablet not RUNNING",
-                      tablet::TabletStatePB_Name(state));
-    if (state == tablet::FAILED) {
-      s = s.CloneAndAppend((*peer)->error().ToString());
-    }
-    SetupErrorAndRespond(resp->mutable_error(), s,
-                         TabletServerErrorPB::TABLET_NOT_RUNNING, context);
-    return false;
-  }
   return true;
 }
 
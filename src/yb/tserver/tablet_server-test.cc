@@ -30,6 +30,11 @@
 // under the License.
 //
 
+#include <algorithm>
+
+#include "yb/common/ql_rowblock.h"
+
+#include "yb/consensus/consensus.proxy.h"
 #include "yb/consensus/log-test-base.h"
 
 #include "yb/gutil/strings/escaping.h"
@@ -510,6 +515,47 @@ TEST_F(TabletServerTest, TestInvalidWriteRequest_BadSchema) {
   }
 }
 
+// Test that writes planned with the schema version before the alter of the tablet are executed
+// with the new schema, unless they write a column that does not exist in it.
+TEST_F(TabletServerTest, TestWriteRequest_PreviousSchemaVersion) {
+  {
+    SchemaBuilder schema_builder(*tablet_peer_->tablet()->schema());
+    ASSERT_OK(schema_builder.AddNullableColumn("new_col", INT32));
+
+    AlterSchemaRequestPB req;
+    AlterSchemaResponsePB resp;
+    RpcController controller;
+
+    req.set_dest_uuid(mini_server_->server()->fs_manager()->uuid());
+    req.set_tablet_id(kTabletId);
+    req.set_schema_version(1);
+    ASSERT_OK(SchemaToPB(schema_builder.Build(), req.mutable_schema()));
+
+    SCOPED_TRACE(req.DebugString());
+    ASSERT_OK(admin_proxy_->AlterSchema(req, &resp, &controller));
+    SCOPED_TRACE(resp.DebugString());
+    ASSERT_FALSE(resp.has_error());
+  }
+
+  WriteRequestPB req;
+  WriteResponsePB resp;
+  RpcController controller;
+
+  req.set_tablet_id(kTabletId);
+  AddTestRowInsert(1234, 5678, "hello world via RPC", &req);
+  // The column does not exist in the tablet schema.
+  AddTestRowInsert(4321, 8765, &req);
+  req.mutable_ql_write_batch(1)->mutable_column_values(0)->set_column_id(kFirstColumnId + 10);
+
+  SCOPED_TRACE(req.DebugString());
+  ASSERT_OK(proxy_->Write(req, &resp, &controller));
+  SCOPED_TRACE(resp.DebugString());
+  ASSERT_FALSE(resp.has_error());
+  ASSERT_EQ(2, resp.ql_response_batch_size());
+  ASSERT_EQ(QLResponsePB::YQL_STATUS_OK, resp.ql_response_batch(0).status());
+  ASSERT_EQ(QLResponsePB::YQL_STATUS_SCHEMA_VERSION_MISMATCH, resp.ql_response_batch(1).status());
+}
+
 TEST_F(TabletServerTest, TestClientGetsErrorBackWhenRecoveryFailed) {
   ASSERT_NO_FATALS(InsertTestRowsRemote(0, 1, 7));
 
@@ -565,6 +611,69 @@ TEST_F(TabletServerTest, TestCreateTablet_TabletExists) {
   }
 }
 
+TEST_F(TabletServerTest, TestCreateTablets) {
+  constexpr int kNumNewTablets = 5;
+
+  CreateTabletsRequestPB req;
+  CreateTabletsResponsePB resp;
+  RpcController rpc;
+
+  req.set_dest_uuid(mini_server_->server()->fs_manager()->uuid());
+  Schema schema = SchemaBuilder(schema_).Build();
+  // The existing tablet is requested along with new tablets, only it should fail.
+  for (int i = 0; i <= kNumNewTablets; ++i) {
+    auto* tablet_req = req.add_tablets();
+    tablet_req->set_table_id("testtb");
+    tablet_req->set_tablet_id(i == 0 ? kTabletId : Format("new-tablet-$0", i));
+    tablet_req->set_table_name("testtb");
+    tablet_req->mutable_config()->CopyFrom(mini_server_->CreateLocalConfig());
+    tablet_req->set_initial_leader_uuid(mini_server_->server()->fs_manager()->uuid());
+    ASSERT_OK(SchemaToPB(schema, tablet_req->mutable_schema()));
+  }
+
+  {
+    SCOPED_TRACE(req.DebugString());
+    ASSERT_OK(admin_proxy_->CreateTablets(req, &resp, &rpc));
+    SCOPED_TRACE(resp.DebugString());
+    ASSERT_FALSE(resp.has_error());
+    ASSERT_EQ(1, resp.tablet_errors_size());
+    ASSERT_EQ(kTabletId, resp.tablet_errors(0).tablet_id());
+    ASSERT_EQ(TabletServerErrorPB::TABLET_ALREADY_EXISTS, resp.tablet_errors(0).error().code());
+  }
+
+  for (int i = 1; i <= kNumNewTablets; ++i) {
+    scoped_refptr<TabletPeer> tablet;
+    ASSERT_TRUE(mini_server_->server()->tablet_manager()->LookupTablet(
+        Format("new-tablet-$0", i), &tablet));
+  }
+}
+
+TEST_F(TabletServerTest, TestMultiRaftUpdateConsensus) {
+  consensus::MultiRaftConsensusRequestPB req;
+  consensus::MultiRaftConsensusResponsePB resp;
+  RpcController rpc;
+
+  // Each request fails on its own, without failing the whole RPC.
+  const std::string kMissingTabletId = "missing-tablet";
+  for (const auto& dest_uuid : { mini_server_->server()->fs_manager()->uuid(),
+                                 std::string("wrong-uuid") }) {
+    auto* consensus_req = req.add_consensus_request();
+    consensus_req->set_dest_uuid(dest_uuid);
+    consensus_req->set_tablet_id(kMissingTabletId);
+    consensus_req->set_caller_uuid("leader-uuid");
+    consensus_req->set_caller_term(1);
+    consensus_req->mutable_committed_index()->set_term(0);
+    consensus_req->mutable_committed_index()->set_index(0);
+  }
+
+  SCOPED_TRACE(req.DebugString());
+  ASSERT_OK(consensus_proxy_->MultiRaftUpdateConsensus(req, &resp, &rpc));
+  SCOPED_TRACE(resp.DebugString());
+  ASSERT_EQ(2, resp.consensus_response_size());
+  ASSERT_EQ(TabletServerErrorPB::TABLET_NOT_FOUND, resp.consensus_response(0).error().code());
+  ASSERT_EQ(TabletServerErrorPB::WRONG_SERVER_UUID, resp.consensus_response(1).error().code());
+}
+
 TEST_F(TabletServerTest, TestDeleteTablet) {
   scoped_refptr<TabletPeer> tablet;
 
@@ -635,6 +744,35 @@ TEST_F(TabletServerTest, TestDeleteTablet_TabletNotCreated) {
   }
 }
 
+TEST_F(TabletServerTest, TestDeleteTablets) {
+  tablet_peer_.reset();
+
+  DeleteTabletsRequestPB req;
+  DeleteTabletsResponsePB resp;
+  RpcController rpc;
+
+  req.set_dest_uuid(mini_server_->server()->fs_manager()->uuid());
+  // The missing tablet is requested along with the existing tablet, only it should fail.
+  for (const auto& tablet_id : {kTabletId, "NotPresentTabletId"}) {
+    auto* tablet_req = req.add_tablets();
+    tablet_req->set_tablet_id(tablet_id);
+    tablet_req->set_delete_type(tablet::TABLET_DATA_DELETED);
+  }
+
+  {
+    SCOPED_TRACE(req.DebugString());
+    ASSERT_OK(admin_proxy_->DeleteTablets(req, &resp, &rpc));
+    SCOPED_TRACE(resp.DebugString());
+    ASSERT_FALSE(resp.has_error());
+    ASSERT_EQ(1, resp.tablet_errors_size());
+    ASSERT_EQ("NotPresentTabletId", resp.tablet_errors(0).tablet_id());
+    ASSERT_EQ(TabletServerErrorPB::TABLET_NOT_FOUND, resp.tablet_errors(0).error().code());
+  }
+
+  scoped_refptr<TabletPeer> tablet;
+  ASSERT_FALSE(mini_server_->server()->tablet_manager()->LookupTablet(kTabletId, &tablet));
+}
+
 // Test that with concurrent requests to delete the same tablet, one wins and
 // the other fails, with no assertion failures. Regression test for KUDU-345.
 TEST_F(TabletServerTest, TestConcurrentDeleteTablet) {
@@ -674,6 +812,56 @@ TEST_F(TabletServerTest, TestConcurrentDeleteTablet) {
   ASSERT_EQ(1, num_success);
 }
 
+TEST_F(TabletServerTest, TestGetChanges) {
+  constexpr int kNumRows = 3;
+  ASSERT_NO_FATALS(InsertTestRowsRemote(0, 1, kNumRows, kNumRows));
+
+  GetChangesRequestPB req;
+  req.set_tablet_id(kTabletId);
+  req.set_consumer_id("test_consumer");
+  req.set_max_records(1);
+
+  // Pull changes in batches until the consumer is caught up.
+  std::vector<CDCRecordPB> records;
+  for (;;) {
+    GetChangesResponsePB resp;
+    RpcController rpc;
+    ASSERT_OK(proxy_->GetChanges(req, &resp, &rpc));
+    ASSERT_FALSE(resp.has_error()) << resp.error().ShortDebugString();
+    ASSERT_LE(resp.records_size(), 1);
+    records.insert(records.end(), resp.records().begin(), resp.records().end());
+    if (resp.checkpoint().index() >= resp.committed_op_id().index()) {
+      break;
+    }
+    if (req.has_from_op_id()) {
+      ASSERT_GT(resp.checkpoint().index(), req.from_op_id().index());
+    }
+    *req.mutable_from_op_id() = resp.checkpoint();
+  }
+
+  ASSERT_EQ(kNumRows, records.size());
+  for (int i = 0; i != kNumRows; ++i) {
+    SCOPED_TRACE(records[i].ShortDebugString());
+    ASSERT_EQ(CDCRecordPB::WRITE, records[i].operation());
+    const auto& key_values = records[i].hashed_key_values_size() != 0
+        ? records[i].hashed_key_values() : records[i].range_key_values();
+    ASSERT_EQ(1, key_values.size());
+    ASSERT_EQ(i + 1, key_values.Get(0).int32_value());
+    ASSERT_GT(records[i].changes_size(), 0);
+    if (i > 0) {
+      ASSERT_LT(records[i - 1].op_id().index(), records[i].op_id().index());
+    }
+  }
+
+  // The stopped consumer no longer retains the log.
+  req.set_stop(true);
+  GetChangesResponsePB resp;
+  RpcController rpc;
+  ASSERT_OK(proxy_->GetChanges(req, &resp, &rpc));
+  ASSERT_FALSE(resp.has_error()) << resp.error().ShortDebugString();
+  ASSERT_EQ(0, resp.records_size());
+}
+
 TEST_F(TabletServerTest, TestInsertLatencyMicroBenchmark) {
   METRIC_DEFINE_entity(test);
   METRIC_DEFINE_histogram(test, insert_latency,
@@ -885,6 +1073,50 @@ TEST_F(TabletServerTest, TestChecksumScan) {
   ASSERT_EQ(first_crc, resp.checksum());
 }
 
+// Scan all rows in small batches, following batches read at the time picked by the first one.
+TEST_F(TabletServerTest, TestBulkScan) {
+  InsertTestRowsRemote(0, 0, 10);
+
+  ScanRequestPB req;
+  req.set_tablet_id(kTabletId);
+  req.set_max_rows(3);
+  std::vector<int32_t> keys;
+  int batches = 0;
+  for (;;) {
+    ScanResponsePB resp;
+    RpcController controller;
+    ASSERT_OK(proxy_->Scan(req, &resp, &controller));
+    ASSERT_FALSE(resp.has_error()) << resp.error().DebugString();
+    ASSERT_TRUE(resp.has_partition());
+    ++batches;
+
+    Slice rows_data;
+    ASSERT_OK(controller.GetSidecar(resp.rows_data_sidecar(), &rows_data));
+    QLRowBlock rows(schema_);
+    ASSERT_OK(rows.Deserialize(YQL_CLIENT_CQL, &rows_data));
+    ASSERT_EQ(resp.row_count(), rows.row_count());
+    ASSERT_LE(rows.row_count(), 3U);
+    for (const auto& row : rows.rows()) {
+      keys.push_back(row.column(0).int32_value());
+    }
+
+    if (!resp.has_next_key()) {
+      break;
+    }
+    if (!req.has_read_hybrid_time()) {
+      req.set_read_hybrid_time(resp.read_hybrid_time());
+      // Written after the read time, so should not be visible to the scan.
+      InsertTestRowsRemote(0, 100, 1);
+    }
+    ASSERT_EQ(req.read_hybrid_time(), resp.read_hybrid_time());
+    req.set_start_key(resp.next_key());
+  }
+
+  ASSERT_EQ(4, batches);
+  std::sort(keys.begin(), keys.end());
+  ASSERT_EQ((std::vector<int32_t>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}), keys);
+}
+
 class DelayFsyncLogHook : public log::Log::LogFaultHooks {
  public:
   DelayFsyncLogHook() : log_latch1_(1), test_latch1_(1) {}
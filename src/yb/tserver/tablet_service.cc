@@ -34,11 +34,13 @@
 
 #include <algorithm>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
 #include <boost/scope_exit.hpp>
 
+#include "yb/common/ql_rowblock.h"
 #include "yb/common/schema.h"
 #include "yb/common/wire_protocol.h"
 #include "yb/consensus/consensus.h"
@@ -52,6 +54,7 @@
 #include "yb/gutil/stl_util.h"
 #include "yb/gutil/stringprintf.h"
 #include "yb/gutil/strings/escaping.h"
+#include "yb/rocksdb/rate_limiter.h"
 #include "yb/server/hybrid_clock.h"
 #include "yb/tablet/tablet_bootstrap_if.h"
 #include "yb/tserver/remote_bootstrap_service.h"
@@ -62,6 +65,7 @@
 #include "yb/tablet/tablet_metrics.h"
 
 #include "yb/tablet/operations/alter_schema_operation.h"
+#include "yb/tablet/operations/bulk_load_operation.h"
 #include "yb/tablet/operations/truncate_operation.h"
 #include "yb/tablet/operations/update_txn_operation.h"
 #include "yb/tablet/operations/write_operation.h"
@@ -106,6 +110,13 @@ DEFINE_bool(parallelize_read_ops, true,
 TAG_FLAG(parallelize_read_ops, advanced);
 TAG_FLAG(parallelize_read_ops, runtime);
 
+DEFINE_bool(batch_redis_read_ops, false,
+            "Execute the Redis read ops of an operation, e.g. the keys of an MGET that belong to "
+            "the same tablet, one after another in key order with a single shared iterator "
+            "instead of one iterator per op. Takes precedence over --parallelize_read_ops.");
+TAG_FLAG(batch_redis_read_ops, advanced);
+TAG_FLAG(batch_redis_read_ops, runtime);
+
 // Fault injection flags.
 DEFINE_int32(scanner_inject_latency_on_each_batch_ms, 0,
              "If set, the scanner will pause the specified number of milliesconds "
@@ -113,12 +124,26 @@ DEFINE_int32(scanner_inject_latency_on_each_batch_ms, 0,
              "Used for tests.");
 TAG_FLAG(scanner_inject_latency_on_each_batch_ms, unsafe);
 
+DEFINE_int32(memory_pressure_max_write_delay_ms, 0,
+             "When positive, writes to a tablet server over its soft memory limit are delayed "
+             "instead of being randomly rejected. The delay grows linearly with the memory usage "
+             "from 0 at the soft limit to this value at the hard limit, writes are still rejected "
+             "when the hard limit is exceeded. 0 disables the delay.");
+TAG_FLAG(memory_pressure_max_write_delay_ms, advanced);
+TAG_FLAG(memory_pressure_max_write_delay_ms, runtime);
+
 DECLARE_int32(memory_limit_warn_threshold_percentage);
 
 DEFINE_int32(max_wait_for_safe_time_ms, 5000,
              "Maximum time in milliseconds to wait for the safe time to advance when trying to "
              "scan at the given hybrid_time.");
 
+DEFINE_int64(tablet_scan_rate_limit_bytes_per_sec, 0,
+             "Maximum rate of reading rows by bulk scans of all tablets of the tablet server, so "
+             "analytics exports do not compete with production reads. 0 means no limit.");
+TAG_FLAG(tablet_scan_rate_limit_bytes_per_sec, advanced);
+TAG_FLAG(tablet_scan_rate_limit_bytes_per_sec, runtime);
+
 DEFINE_bool(tserver_noop_read_write, false, "Respond NOOP to read/write.");
 TAG_FLAG(tserver_noop_read_write, unsafe);
 TAG_FLAG(tserver_noop_read_write, hidden);
@@ -221,7 +246,26 @@ bool TabletServiceImpl::PrepareModify(
   // Check for memory pressure; don't bother doing any additional work if we've
   // exceeded the limit.
   double capacity_pct;
-  if ((*tablet)->mem_tracker()->AnySoftLimitExceeded(&capacity_pct)) {
+  bool reject;
+  const auto max_write_delay_ms = FLAGS_memory_pressure_max_write_delay_ms;
+  if (max_write_delay_ms > 0) {
+    // Slow down writers while memory is between the soft and the hard limit, so flushes have
+    // a chance to catch up, and reject them only at the hard limit.
+    const double overage = (*tablet)->mem_tracker()->AnySoftLimitOverage();
+    if (overage > 0 && overage < 1) {
+      const auto delay = MonoDelta::FromMicroseconds(
+          static_cast<int64_t>(overage * max_write_delay_ms * 1000));
+      TRACE("Delaying write by $0 because of memory pressure", delay.ToString());
+      SleepFor(delay);
+    }
+    reject = (*tablet)->mem_tracker()->AnyLimitExceeded();
+    if (reject) {
+      capacity_pct = 100;
+    }
+  } else {
+    reject = (*tablet)->mem_tracker()->AnySoftLimitExceeded(&capacity_pct);
+  }
+  if (reject) {
     (*tablet)->metrics()->leader_memory_pressure_rejections->Increment();
     string msg = StringPrintf(
         "Soft memory limit exceeded (at %.2f%% of capacity)",
@@ -260,6 +304,31 @@ void SetupErrorAndRespond(TabletServerErrorPB* error,
   context->RespondSuccess();
 }
 
+Status LookupTabletPeer(TabletPeerLookupIf* tablet_manager,
+                        const string& tablet_id,
+                        scoped_refptr<tablet::TabletPeer>* peer,
+                        TabletServerErrorPB::Code* error_code) {
+  Status status = tablet_manager->GetTabletPeer(tablet_id, peer);
+  if (PREDICT_FALSE(!status.ok())) {
+    *error_code = status.IsServiceUnavailable() ? TabletServerErrorPB::UNKNOWN_ERROR
+                                                : TabletServerErrorPB::TABLET_NOT_FOUND;
+    return status;
+  }
+
+  // Check RUNNING state.
+  tablet::TabletStatePB state = (*peer)->state();
+  if (PREDICT_FALSE(state != tablet::RUNNING)) {
+    Status s = STATUS(IllegalState, "Tablet not RUNNING",
+                      tablet::TabletStatePB_Name(state));
+    if (state == tablet::FAILED) {
+      s = s.CloneAndAppend((*peer)->error().ToString());
+    }
+    *error_code = TabletServerErrorPB::TABLET_NOT_RUNNING;
+    return s;
+  }
+  return Status::OK();
+}
+
 class WriteOperationCompletionCallback : public OperationCompletionCallback {
  public:
   WriteOperationCompletionCallback(
@@ -360,6 +429,75 @@ TabletServiceAdminImpl::TabletServiceAdminImpl(TabletServer* server)
       server_(server) {
 }
 
+namespace {
+
+template <class Response>
+void SetPropagatedHybridTime(const server::ClockPtr& clock, Response* resp) {}
+
+void SetPropagatedHybridTime(const server::ClockPtr& clock, AlterSchemasResponsePB* resp) {
+  resp->set_propagated_hybrid_time(clock->Now().ToUint64());
+}
+
+// Collects results of tablets of a batch request, like CreateTablets, the response is sent when
+// the last tablet is done.
+template <class Response>
+class TabletsBatchState {
+ public:
+  TabletsBatchState(Response* resp, rpc::RpcContext context, int num_tablets,
+                    server::ClockPtr clock = nullptr)
+      : resp_(resp), context_(std::move(context)), clock_(std::move(clock)),
+        pending_(num_tablets) {}
+
+  void TabletDone(const TabletId& tablet_id, const Status& status,
+                  TabletServerErrorPB::Code code) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!status.ok()) {
+      auto* tablet_error = resp_->add_tablet_errors();
+      tablet_error->set_tablet_id(tablet_id);
+      StatusToPB(status, tablet_error->mutable_error()->mutable_status());
+      tablet_error->mutable_error()->set_code(code);
+    }
+    if (--pending_ == 0) {
+      if (clock_) {
+        SetPropagatedHybridTime(clock_, resp_);
+      }
+      lock.unlock();
+      context_.RespondSuccess();
+    }
+  }
+
+ private:
+  Response* resp_;
+  rpc::RpcContext context_;
+  server::ClockPtr clock_;
+  std::mutex mutex_;
+  int pending_;
+};
+
+// Reports the result of the operation of one tablet of a batch request.
+template <class Response>
+class TabletsBatchOperationCompletionCallback : public tablet::OperationCompletionCallback {
+ public:
+  TabletsBatchOperationCompletionCallback(
+      std::shared_ptr<TabletsBatchState<Response>> state, TabletId tablet_id)
+      : state_(std::move(state)), tablet_id_(std::move(tablet_id)) {}
+
+  void OperationCompleted() override {
+    bool expected = false;
+    if (!completed_.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+      return;
+    }
+    state_->TabletDone(tablet_id_, status_, code_);
+  }
+
+ private:
+  std::shared_ptr<TabletsBatchState<Response>> state_;
+  const TabletId tablet_id_;
+  std::atomic<bool> completed_{false};
+};
+
+} // namespace
+
 void TabletServiceAdminImpl::AlterSchema(const AlterSchemaRequestPB* req,
                                          AlterSchemaResponsePB* resp,
                                          rpc::RpcContext context) {
@@ -370,65 +508,114 @@ void TabletServiceAdminImpl::AlterSchema(const AlterSchemaRequestPB* req,
 
   server::UpdateClock(*req, server_->Clock());
 
+  // The RPC will be responded to asynchronously.
+  DoAlterSchema(*req, MakeRpcOperationCompletionCallback(std::move(context), resp,
+                                                         server_->Clock()));
+}
+
+void TabletServiceAdminImpl::DoAlterSchema(
+    const AlterSchemaRequestPB& req,
+    std::unique_ptr<tablet::OperationCompletionCallback> callback) {
+  auto fail = [&callback](const Status& status, TabletServerErrorPB::Code code) {
+    callback->set_error(status, code);
+    callback->OperationCompleted();
+  };
+
   scoped_refptr<TabletPeer> tablet_peer;
-  if (!LookupTabletPeerOrRespond(server_->tablet_manager(), req->tablet_id(), resp, &context,
-                                 &tablet_peer)) {
+  TabletServerErrorPB::Code code = TabletServerErrorPB::UNKNOWN_ERROR;
+  Status s = LookupTabletPeer(server_->tablet_manager(), req.tablet_id(), &tablet_peer, &code);
+  if (!s.ok()) {
+    fail(s, code);
     return;
   }
 
   uint32_t schema_version = tablet_peer->tablet_metadata()->schema_version();
 
   // If the schema was already applied, respond as succeeded
-  if (schema_version == req->schema_version()) {
+  if (schema_version == req.schema_version()) {
     // Sanity check, to verify that the tablet should have the same schema
     // specified in the request.
     Schema req_schema;
-    Status s = SchemaFromPB(req->schema(), &req_schema);
+    Status s = SchemaFromPB(req.schema(), &req_schema);
     if (!s.ok()) {
-      SetupErrorAndRespond(resp->mutable_error(), s,
-                           TabletServerErrorPB::INVALID_SCHEMA, &context);
+      fail(s, TabletServerErrorPB::INVALID_SCHEMA);
       return;
     }
 
     Schema tablet_schema = tablet_peer->tablet_metadata()->schema();
     if (req_schema.Equals(tablet_schema)) {
-      context.RespondSuccess();
+      callback->OperationCompleted();
       return;
     }
 
     schema_version = tablet_peer->tablet_metadata()->schema_version();
-    if (schema_version == req->schema_version()) {
+    if (schema_version == req.schema_version()) {
       LOG(ERROR) << "The current schema does not match the request schema."
                  << " version=" << schema_version
                  << " current-schema=" << tablet_schema.ToString()
                  << " request-schema=" << req_schema.ToString()
                  << " (corruption)";
-      SetupErrorAndRespond(resp->mutable_error(),
-                           STATUS(Corruption, "got a different schema for the same version number"),
-                           TabletServerErrorPB::MISMATCHED_SCHEMA, &context);
+      fail(STATUS(Corruption, "got a different schema for the same version number"),
+           TabletServerErrorPB::MISMATCHED_SCHEMA);
       return;
     }
   }
 
   // If the current schema is newer than the one in the request reject the request.
-  if (schema_version > req->schema_version()) {
-    SetupErrorAndRespond(resp->mutable_error(),
-                         STATUS(InvalidArgument, "Tablet has a newer schema"),
-                         TabletServerErrorPB::TABLET_HAS_A_NEWER_SCHEMA, &context);
+  if (schema_version > req.schema_version()) {
+    fail(STATUS(InvalidArgument, "Tablet has a newer schema"),
+         TabletServerErrorPB::TABLET_HAS_A_NEWER_SCHEMA);
     return;
   }
 
   auto operation_state = std::make_unique<AlterSchemaOperationState>(
-      tablet_peer->tablet(), tablet_peer->log(), req);
+      tablet_peer->tablet(), tablet_peer->log(), &req);
 
-  operation_state->set_completion_callback(
-      MakeRpcOperationCompletionCallback(std::move(context), resp, server_->Clock()));
+  operation_state->set_completion_callback(std::move(callback));
 
-  // Submit the alter schema op. The RPC will be responded to asynchronously.
+  // Submit the alter schema op.
   tablet_peer->Submit(std::make_unique<tablet::AlterSchemaOperation>(
       std::move(operation_state), consensus::LEADER));
 }
 
+void TabletServiceAdminImpl::AlterSchemas(const AlterSchemasRequestPB* req,
+                                          AlterSchemasResponsePB* resp,
+                                          rpc::RpcContext context) {
+  if (!CheckUuidMatchOrRespond(server_->tablet_manager(), "AlterSchemas", req, resp, &context)) {
+    return;
+  }
+  TRACE_EVENT1("tserver", "AlterSchemas",
+               "num_tablets", req->tablets_size());
+  DVLOG(3) << "Received Alter Schemas RPC: " << req->DebugString();
+
+  server::UpdateClock(*req, server_->Clock());
+
+  if (req->tablets().empty()) {
+    resp->set_propagated_hybrid_time(server_->Clock()->Now().ToUint64());
+    context.RespondSuccess();
+    return;
+  }
+
+  // Alter schema operations of all tablets are replicated at the same time.
+  auto state = std::make_shared<TabletsBatchState<AlterSchemasResponsePB>>(
+      resp, std::move(context), req->tablets_size(), server_->Clock());
+  for (const auto& tablet_req : req->tablets()) {
+    auto callback = std::make_unique<TabletsBatchOperationCompletionCallback<
+        AlterSchemasResponsePB>>(state, tablet_req.tablet_id());
+    // Followers could not replicate the operation, so the master should send it to the new leader.
+    scoped_refptr<TabletPeer> tablet_peer;
+    if (server_->tablet_manager()->GetTabletPeer(tablet_req.tablet_id(), &tablet_peer).ok() &&
+        tablet_peer->state() == tablet::RUNNING &&
+        tablet_peer->LeaderStatus() == consensus::Consensus::LeaderStatus::NOT_LEADER) {
+      callback->set_error(STATUS(IllegalState, "Not the leader"),
+                          TabletServerErrorPB::NOT_THE_LEADER);
+      callback->OperationCompleted();
+      continue;
+    }
+    DoAlterSchema(tablet_req, std::move(callback));
+  }
+}
+
 void TabletServiceImpl::UpdateTransaction(const UpdateTransactionRequestPB* req,
                                           UpdateTransactionResponsePB* resp,
                                           rpc::RpcContext context) {
@@ -555,47 +742,83 @@ void TabletServiceAdminImpl::CreateTablet(const CreateTabletRequestPB* req,
   TRACE_EVENT1("tserver", "CreateTablet",
                "tablet_id", req->tablet_id());
 
+  TabletServerErrorPB::Code code;
+  Status s = DoCreateTablet(*req, &code);
+  if (PREDICT_FALSE(!s.ok())) {
+    SetupErrorAndRespond(resp->mutable_error(), s, code, &context);
+    return;
+  }
+  context.RespondSuccess();
+}
+
+Status TabletServiceAdminImpl::DoCreateTablet(const CreateTabletRequestPB& req,
+                                              TabletServerErrorPB::Code* error_code) {
   Schema schema;
-  Status s = SchemaFromPB(req->schema(), &schema);
+  Status s = SchemaFromPB(req.schema(), &schema);
   DCHECK(schema.has_column_ids());
   if (!s.ok()) {
-    SetupErrorAndRespond(resp->mutable_error(),
-                         STATUS(InvalidArgument, "Invalid Schema."),
-                         TabletServerErrorPB::INVALID_SCHEMA, &context);
-    return;
+    *error_code = TabletServerErrorPB::INVALID_SCHEMA;
+    return STATUS(InvalidArgument, "Invalid Schema.");
   }
 
   PartitionSchema partition_schema;
-  s = PartitionSchema::FromPB(req->partition_schema(), schema, &partition_schema);
+  s = PartitionSchema::FromPB(req.partition_schema(), schema, &partition_schema);
   if (!s.ok()) {
-    SetupErrorAndRespond(resp->mutable_error(),
-                         STATUS(InvalidArgument, "Invalid PartitionSchema."),
-                         TabletServerErrorPB::INVALID_SCHEMA, &context);
-    return;
+    *error_code = TabletServerErrorPB::INVALID_SCHEMA;
+    return STATUS(InvalidArgument, "Invalid PartitionSchema.");
   }
 
   Partition partition;
-  Partition::FromPB(req->partition(), &partition);
+  Partition::FromPB(req.partition(), &partition);
 
-  LOG(INFO) << "Processing CreateTablet for tablet " << req->tablet_id()
-            << " (table=" << req->table_name()
-            << " [id=" << req->table_id() << "]), partition="
+  LOG(INFO) << "Processing CreateTablet for tablet " << req.tablet_id()
+            << " (table=" << req.table_name()
+            << " [id=" << req.table_id() << "]), partition="
             << partition_schema.PartitionDebugString(partition, schema);
-  VLOG(1) << "Full request: " << req->DebugString();
+  VLOG(1) << "Full request: " << req.DebugString();
 
-  s = server_->tablet_manager()->CreateNewTablet(req->table_id(), req->tablet_id(), partition,
-      req->table_name(), req->table_type(), schema, partition_schema, req->config(), nullptr);
+  s = server_->tablet_manager()->CreateNewTablet(req.table_id(), req.tablet_id(), partition,
+      req.table_name(), req.table_type(), schema, partition_schema, req.config(), nullptr,
+      req.initial_leader_uuid());
   if (PREDICT_FALSE(!s.ok())) {
-    TabletServerErrorPB::Code code;
     if (s.IsAlreadyPresent()) {
-      code = TabletServerErrorPB::TABLET_ALREADY_EXISTS;
+      *error_code = TabletServerErrorPB::TABLET_ALREADY_EXISTS;
     } else {
-      code = TabletServerErrorPB::UNKNOWN_ERROR;
+      *error_code = TabletServerErrorPB::UNKNOWN_ERROR;
     }
-    SetupErrorAndRespond(resp->mutable_error(), s, code, &context);
+  }
+  return s;
+}
+
+void TabletServiceAdminImpl::CreateTablets(const CreateTabletsRequestPB* req,
+                                           CreateTabletsResponsePB* resp,
+                                           rpc::RpcContext context) {
+  if (!CheckUuidMatchOrRespond(server_->tablet_manager(), "CreateTablets", req, resp, &context)) {
     return;
   }
-  context.RespondSuccess();
+  TRACE_EVENT1("tserver", "CreateTablets",
+               "num_tablets", req->tablets_size());
+
+  if (req->tablets().empty()) {
+    context.RespondSuccess();
+    return;
+  }
+
+  // Tablets are created on the pool that opens tablets, so metadata of tablets is written in
+  // parallel and tablets are opened in the order they were created.
+  auto state = std::make_shared<TabletsBatchState<CreateTabletsResponsePB>>(
+      resp, std::move(context), req->tablets_size());
+  for (const auto& tablet_req : req->tablets()) {
+    auto create_tablet = [this, state, &tablet_req] {
+      TabletServerErrorPB::Code code = TabletServerErrorPB::UNKNOWN_ERROR;
+      Status s = DoCreateTablet(tablet_req, &code);
+      state->TabletDone(tablet_req.tablet_id(), s, code);
+    };
+    Status s = server_->tablet_manager()->open_tablet_pool()->SubmitFunc(create_tablet);
+    if (!s.ok()) {
+      create_tablet();
+    }
+  }
 }
 
 void TabletServiceAdminImpl::DeleteTablet(const DeleteTabletRequestPB* req,
@@ -608,30 +831,70 @@ void TabletServiceAdminImpl::DeleteTablet(const DeleteTabletRequestPB* req,
                "tablet_id", req->tablet_id(),
                "reason", req->reason());
 
+  boost::optional<TabletServerErrorPB::Code> error_code;
+  Status s = DoDeleteTablet(*req, context.requestor_string(), &error_code);
+  if (PREDICT_FALSE(!s.ok())) {
+    HandleErrorResponse(resp, &context, s, error_code);
+    return;
+  }
+  context.RespondSuccess();
+}
+
+Status TabletServiceAdminImpl::DoDeleteTablet(
+    const DeleteTabletRequestPB& req,
+    const std::string& requestor,
+    boost::optional<TabletServerErrorPB::Code>* error_code) {
   tablet::TabletDataState delete_type = tablet::TABLET_DATA_UNKNOWN;
-  if (req->has_delete_type()) {
-    delete_type = req->delete_type();
+  if (req.has_delete_type()) {
+    delete_type = req.delete_type();
   }
-  LOG(INFO) << "Processing DeleteTablet for tablet " << req->tablet_id()
+  LOG(INFO) << "Processing DeleteTablet for tablet " << req.tablet_id()
             << " with delete_type " << TabletDataState_Name(delete_type)
-            << (req->has_reason() ? (" (" + req->reason() + ")") : "")
-            << " from " << context.requestor_string();
-  VLOG(1) << "Full request: " << req->DebugString();
+            << (req.has_reason() ? (" (" + req.reason() + ")") : "")
+            << " from " << requestor;
+  VLOG(1) << "Full request: " << req.DebugString();
 
   boost::optional<int64_t> cas_config_opid_index_less_or_equal;
-  if (req->has_cas_config_opid_index_less_or_equal()) {
-    cas_config_opid_index_less_or_equal = req->cas_config_opid_index_less_or_equal();
+  if (req.has_cas_config_opid_index_less_or_equal()) {
+    cas_config_opid_index_less_or_equal = req.cas_config_opid_index_less_or_equal();
   }
-  boost::optional<TabletServerErrorPB::Code> error_code;
-  Status s = server_->tablet_manager()->DeleteTablet(req->tablet_id(),
-                                                     delete_type,
-                                                     cas_config_opid_index_less_or_equal,
-                                                     &error_code);
-  if (PREDICT_FALSE(!s.ok())) {
-    HandleErrorResponse(resp, &context, s, error_code);
+  return server_->tablet_manager()->DeleteTablet(req.tablet_id(),
+                                                 delete_type,
+                                                 cas_config_opid_index_less_or_equal,
+                                                 error_code);
+}
+
+void TabletServiceAdminImpl::DeleteTablets(const DeleteTabletsRequestPB* req,
+                                           DeleteTabletsResponsePB* resp,
+                                           rpc::RpcContext context) {
+  if (!CheckUuidMatchOrRespond(server_->tablet_manager(), "DeleteTablets", req, resp, &context)) {
     return;
   }
-  context.RespondSuccess();
+  TRACE_EVENT1("tserver", "DeleteTablets",
+               "num_tablets", req->tablets_size());
+
+  if (req->tablets().empty()) {
+    context.RespondSuccess();
+    return;
+  }
+
+  // Tablets are deleted in parallel on the pool that opens tablets, so their data is removed from
+  // disk concurrently.
+  const std::string requestor = context.requestor_string();
+  auto state = std::make_shared<TabletsBatchState<DeleteTabletsResponsePB>>(
+      resp, std::move(context), req->tablets_size());
+  for (const auto& tablet_req : req->tablets()) {
+    auto delete_tablet = [this, state, &tablet_req, requestor] {
+      boost::optional<TabletServerErrorPB::Code> error_code;
+      Status s = DoDeleteTablet(tablet_req, requestor, &error_code);
+      state->TabletDone(tablet_req.tablet_id(), s,
+                        error_code.get_value_or(TabletServerErrorPB::UNKNOWN_ERROR));
+    };
+    Status s = server_->tablet_manager()->open_tablet_pool()->SubmitFunc(delete_tablet);
+    if (!s.ok()) {
+      delete_tablet();
+    }
+  }
 }
 
 // TODO(sagnik): Modify this to actually create a copartitioned table
@@ -687,12 +950,24 @@ void TabletServiceImpl::Write(const WriteRequestPB* req,
     return;
   }
 
-  auto operation_state = std::make_unique<WriteOperationState>(tablet_peer->tablet(), req, resp);
+  // The tablet layer modifies the request, so it is moved to the operation when this call owns it,
+  // and copied otherwise.
+  std::unique_ptr<WriteOperationState> operation_state;
+  auto* movable_req = static_cast<WriteRequestPB*>(context.movable_request_pb());
+  if (movable_req != nullptr) {
+    auto moved_req = std::make_unique<WriteRequestPB>();
+    moved_req->Swap(movable_req);
+    operation_state = std::make_unique<WriteOperationState>(
+        tablet_peer->tablet(), std::move(moved_req), resp);
+  } else {
+    operation_state = std::make_unique<WriteOperationState>(tablet_peer->tablet(), req, resp);
+  }
+  const bool include_trace = operation_state->request()->include_trace();
 
   auto context_ptr = std::make_shared<RpcContext>(std::move(context));
   operation_state->set_completion_callback(
       std::make_unique<WriteOperationCompletionCallback>(
-          context_ptr, resp, operation_state.get(), server_->Clock(), req->include_trace()));
+          context_ptr, resp, operation_state.get(), server_->Clock(), include_trace));
 
   auto status = tablet_peer->SubmitWrite(std::move(operation_state));
 
@@ -787,6 +1062,14 @@ bool TabletServiceImpl::DoGetTabletOrRespond(const Req* req, Resp* resp, rpc::Rp
     SetupErrorAndRespond(resp->mutable_error(), s, error_code, context);
     return false;
   }
+
+  // A log-only replica does not have the data, so the client should read from another replica.
+  if (PREDICT_FALSE(ptr->log_only())) {
+    SetupErrorAndRespond(
+        resp->mutable_error(), STATUS(ServiceUnavailable, "Log-only replica does not serve reads"),
+        TabletServerErrorPB::REPLICA_TOO_STALE, context);
+    return false;
+  }
   *tablet = ptr;
   return true;
 }
@@ -815,8 +1098,30 @@ void TabletServiceImpl::Read(const ReadRequestPB* req,
   bool allow_retry = !read_time;
   tablet::RequireLease require_lease(req->consistency_level() == YBConsistencyLevel::STRONG);
   bool transactional = tablet->SchemaRef().table_properties().is_transactional();
+  const MonoTime safe_time_wait_start = MonoTime::Now();
   if (!read_time) {
     safe_ht_to_read = tablet->SafeTime(require_lease);
+    if (req->consistency_level() == YBConsistencyLevel::CONSISTENT_PREFIX &&
+        req->has_max_staleness_ms()) {
+      // Bounded staleness read is served by follower only when its propagated safe time is recent
+      // enough, so there is no need to contact the leader. Leader always serves it, since it is
+      // the replica that client falls back to.
+      const auto now = server_->Clock()->Now();
+      const auto staleness_us = now.GetPhysicalValueMicros() -
+                                std::min(now.GetPhysicalValueMicros(),
+                                         safe_ht_to_read.GetPhysicalValueMicros());
+      scoped_refptr<TabletPeer> tablet_peer;
+      if (staleness_us > req->max_staleness_ms() * 1000 &&
+          (!server_->tablet_manager()->LookupTablet(req->tablet_id(), &tablet_peer) ||
+           tablet_peer->LeaderStatus() != consensus::Consensus::LeaderStatus::LEADER_AND_READY)) {
+        SetupErrorAndRespond(
+            resp->mutable_error(),
+            STATUS_FORMAT(ServiceUnavailable, "Replica is $0ms stale, while $1ms is allowed",
+                          staleness_us / 1000, req->max_staleness_ms()),
+            TabletServerErrorPB::REPLICA_TOO_STALE, &context);
+        return;
+      }
+    }
     // If the read time is not specified, then it is non transactional read.
     // So we should restart it in server in case of failure.
     read_time.read = safe_ht_to_read;
@@ -838,6 +1143,9 @@ void TabletServiceImpl::Read(const ReadRequestPB* req,
     }
   }
 
+  const uint64_t safe_time_wait_us =
+      MonoTime::Now().GetDeltaSince(safe_time_wait_start).ToMicroseconds();
+
   if (transactional) {
     // Serial number is used for check whether this operation was initiated before
     // transaction status request. So we should initialize it as soon as possible.
@@ -876,6 +1184,9 @@ void TabletServiceImpl::Read(const ReadRequestPB* req,
       break;
     }
   }
+  for (auto& ql_resp : *resp->mutable_ql_batch()) {
+    ql_resp.mutable_read_stats()->set_safe_time_wait_us(safe_time_wait_us);
+  }
   if (req->include_trace() && Trace::CurrentTrace() != nullptr) {
     resp->set_trace_buffer(Trace::CurrentTrace()->DumpToString(true));
   }
@@ -906,6 +1217,12 @@ Result<ReadHybridTime> TabletServiceImpl::DoRead(tablet::AbstractTablet* tablet,
   tablet::ScopedReadOperation read_tx(tablet, require_lease, read_time);
   switch (tablet->table_type()) {
     case TableType::REDIS_TABLE_TYPE: {
+      if (FLAGS_batch_redis_read_ops && req->redis_batch_size() > 1) {
+        RETURN_NOT_OK(tablet->HandleRedisReadRequests(
+            read_tx.read_time(), req->redis_batch(), resp->mutable_redis_batch()));
+        // TODO(dtxn) implement read restart for Redis.
+        return ReadHybridTime();
+      }
       size_t count = req->redis_batch_size();
       std::vector<Status> rets(count);
       CountDownLatch latch(count);
@@ -1025,6 +1342,68 @@ void ConsensusServiceImpl::UpdateConsensus(const ConsensusRequestPB* req,
   context.RespondSuccess();
 }
 
+void ConsensusServiceImpl::MultiRaftUpdateConsensus(
+    const consensus::MultiRaftConsensusRequestPB* req,
+    consensus::MultiRaftConsensusResponsePB* resp,
+    rpc::RpcContext context) {
+  DVLOG(3) << "Received Multi Raft Consensus Update RPC with " << req->consensus_request_size()
+           << " requests from " << context.requestor_string();
+  // Requests of different tablets are independent, so a failure of one of them is reported in its
+  // own response and does not fail the whole RPC.
+  for (const auto& consensus_req : req->consensus_request()) {
+    auto* consensus_resp = resp->add_consensus_response();
+    TabletServerErrorPB::Code code = TabletServerErrorPB::UNKNOWN_ERROR;
+    Status s = DoUpdateConsensus(
+        const_cast<ConsensusRequestPB*>(&consensus_req), consensus_resp, &code);
+    if (PREDICT_FALSE(!s.ok())) {
+      // Clear the response first, see UpdateConsensus.
+      consensus_resp->Clear();
+      StatusToPB(s, consensus_resp->mutable_error()->mutable_status());
+      consensus_resp->mutable_error()->set_code(code);
+    }
+  }
+  context.RespondSuccess();
+}
+
+Status ConsensusServiceImpl::DoUpdateConsensus(ConsensusRequestPB* req,
+                                               ConsensusResponsePB* resp,
+                                               TabletServerErrorPB::Code* error_code) {
+  const string& local_uuid = tablet_manager_->NodeInstance().permanent_uuid();
+  if (PREDICT_FALSE(req->dest_uuid() != local_uuid)) {
+    *error_code = TabletServerErrorPB::WRONG_SERVER_UUID;
+    return STATUS_SUBSTITUTE(InvalidArgument,
+        "MultiRaftUpdateConsensus: Wrong destination UUID requested. Local UUID: $0. "
+        "Requested UUID: $1", local_uuid, req->dest_uuid());
+  }
+
+  scoped_refptr<TabletPeer> tablet_peer;
+  Status s = tablet_manager_->GetTabletPeer(req->tablet_id(), &tablet_peer);
+  if (PREDICT_FALSE(!s.ok())) {
+    *error_code = s.IsServiceUnavailable() ? TabletServerErrorPB::UNKNOWN_ERROR
+                                           : TabletServerErrorPB::TABLET_NOT_FOUND;
+    return s;
+  }
+
+  tablet::TabletStatePB state = tablet_peer->state();
+  if (PREDICT_FALSE(state != tablet::RUNNING)) {
+    *error_code = TabletServerErrorPB::TABLET_NOT_RUNNING;
+    s = STATUS(IllegalState, "Tablet not RUNNING", tablet::TabletStatePB_Name(state));
+    if (state == tablet::FAILED) {
+      s = s.CloneAndAppend(tablet_peer->error().ToString());
+    }
+    return s;
+  }
+
+  scoped_refptr<Consensus> consensus = tablet_peer->shared_consensus();
+  if (PREDICT_FALSE(!consensus)) {
+    *error_code = TabletServerErrorPB::TABLET_NOT_RUNNING;
+    return STATUS(ServiceUnavailable, "Consensus unavailable. Tablet not running");
+  }
+
+  *error_code = TabletServerErrorPB::UNKNOWN_ERROR;
+  return consensus->Update(req, resp);
+}
+
 void ConsensusServiceImpl::RequestConsensusVote(const VoteRequestPB* req,
                                                 VoteResponsePB* resp,
                                                 rpc::RpcContext context) {
@@ -1305,10 +1684,10 @@ void TabletServiceImpl::ListTabletsForTabletServer(const ListTabletsForTabletSer
 
 namespace {
 
-Result<uint64_t> CalcChecksum(tablet::Tablet* tablet) {
+Result<uint64_t> CalcChecksum(tablet::Tablet* tablet, const ReadHybridTime& read_time) {
   const Schema& schema = tablet->metadata()->schema();
   auto client_schema = schema.CopyWithoutColumnIds();
-  auto iter = tablet->NewRowIterator(client_schema, boost::none);
+  auto iter = tablet->NewRowIterator(client_schema, boost::none, read_time);
   RETURN_NOT_OK(iter);
 
   QLTableRow value_map;
@@ -1322,6 +1701,92 @@ Result<uint64_t> CalcChecksum(tablet::Tablet* tablet) {
   return collector.agg_checksum();
 }
 
+// Blocks the caller until reading 'bytes' by bulk scans fits into
+// --tablet_scan_rate_limit_bytes_per_sec. The limiter is shared by all scans of the process.
+void ThrottleScan(size_t bytes) {
+  static std::mutex mutex;
+  static std::unique_ptr<rocksdb::RateLimiter> rate_limiter;
+  static int64_t current_rate = 0;
+
+  const int64_t rate = FLAGS_tablet_scan_rate_limit_bytes_per_sec;
+  if (rate <= 0) {
+    return;
+  }
+  rocksdb::RateLimiter* limiter;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!rate_limiter) {
+      rate_limiter.reset(rocksdb::NewGenericRateLimiter(rate));
+    } else if (current_rate != rate) {
+      rate_limiter->SetBytesPerSecond(rate);
+    }
+    current_rate = rate;
+    limiter = rate_limiter.get();
+  }
+  // Single request could not be larger than a burst.
+  const int64_t burst = limiter->GetSingleBurstBytes();
+  for (int64_t left = bytes; left > 0; left -= burst) {
+    limiter->Request(std::min(left, burst), rocksdb::Env::IO_LOW);
+  }
+}
+
+// Reads the next batch of rows for the bulk scan request to rows_data.
+Status ScanTablet(tablet::Tablet* tablet, const ScanRequestPB& req,
+                  const ReadHybridTime& read_time, faststring* rows_data, ScanResponsePB* resp) {
+  const Schema& schema = tablet->metadata()->schema();
+  std::vector<ColumnId> column_ids;
+  if (req.column_ids().empty()) {
+    column_ids = schema.column_ids();
+  } else {
+    for (const auto id : req.column_ids()) {
+      column_ids.emplace_back(id);
+    }
+  }
+  QLRowBlock rows(schema, column_ids);
+  if (rows.schema().num_columns() != column_ids.size()) {
+    return STATUS(InvalidArgument, "Unknown column requested");
+  }
+
+  docdb::DocKey start_key;
+  docdb::DocKey end_key;
+  if (!req.start_key().empty()) {
+    RETURN_NOT_OK(start_key.FullyDecodeFrom(req.start_key()));
+  }
+  if (!req.end_key().empty()) {
+    RETURN_NOT_OK(end_key.FullyDecodeFrom(req.end_key()));
+  }
+  auto iter = VERIFY_RESULT(tablet->NewRangeRowIterator(
+      rows.schema().CopyWithoutColumnIds(), read_time, start_key, end_key));
+
+  const size_t max_rows = req.max_rows() ? req.max_rows() : FLAGS_scanner_batch_size_rows;
+  const size_t max_bytes = std::min<size_t>(
+      req.max_bytes() ? req.max_bytes() : FLAGS_scanner_default_batch_size_bytes,
+      FLAGS_scanner_max_batch_size_bytes);
+  // Size of the batch is estimated by the size of values, to avoid serializing rows twice.
+  size_t bytes = 0;
+  QLTableRow table_row;
+  while (iter->HasNext()) {
+    if (rows.row_count() >= max_rows || bytes >= max_bytes) {
+      resp->set_next_key(iter->row_key().Encode().data());
+      break;
+    }
+    table_row.Clear();
+    RETURN_NOT_OK(iter->NextRow(&table_row));
+    auto& row = rows.Extend();
+    for (size_t i = 0; i != column_ids.size(); ++i) {
+      auto* value = row.mutable_column(i);
+      RETURN_NOT_OK(table_row.GetValue(column_ids[i], value));
+      bytes += value->value().ByteSize();
+    }
+  }
+
+  rows.Serialize(YQL_CLIENT_CQL, rows_data);
+  resp->set_row_count(rows.row_count());
+  tablet->metadata()->partition().ToPB(resp->mutable_partition());
+  ThrottleScan(rows_data->size());
+  return Status::OK();
+}
+
 } // namespace
 
 void TabletServiceImpl::Checksum(const ChecksumRequestPB* req,
@@ -1333,7 +1798,20 @@ void TabletServiceImpl::Checksum(const ChecksumRequestPB* req,
   if (!DoGetTabletOrRespond(req, resp, &context, &abstract_tablet)) {
     return;
   }
-  auto checksum = CalcChecksum(down_cast<tablet::Tablet*>(abstract_tablet.get()));
+  auto read_time = ReadHybridTime::Max();
+  if (req->has_read_hybrid_time()) {
+    read_time = ReadHybridTime::FromUint64(req->read_hybrid_time());
+    const auto safe_time = abstract_tablet->SafeTime(
+        tablet::RequireLease::kFalse, read_time.read, context.GetClientDeadline());
+    if (!safe_time.is_valid()) {
+      SetupErrorAndRespond(
+          resp->mutable_error(),
+          STATUS_FORMAT(TimedOut, "Timed out waiting for safe time $0", read_time.read),
+          TabletServerErrorPB::UNKNOWN_ERROR, &context);
+      return;
+    }
+  }
+  auto checksum = CalcChecksum(down_cast<tablet::Tablet*>(abstract_tablet.get()), read_time);
   if (!checksum.ok()) {
     SetupErrorAndRespond(resp->mutable_error(), checksum.status(),
                          TabletServerErrorPB::UNKNOWN_ERROR, &context);
@@ -1345,6 +1823,56 @@ void TabletServiceImpl::Checksum(const ChecksumRequestPB* req,
   context.RespondSuccess();
 }
 
+void TabletServiceImpl::Scan(const ScanRequestPB* req,
+                             ScanResponsePB* resp,
+                             rpc::RpcContext context) {
+  VLOG(3) << "Full request: " << req->DebugString();
+
+  std::shared_ptr<tablet::AbstractTablet> abstract_tablet;
+  if (!DoGetTabletOrRespond(req, resp, &context, &abstract_tablet)) {
+    return;
+  }
+  // All batches of the scan should read at the same time, so the read time is picked by the first
+  // batch and passed back by the caller with the following ones.
+  HybridTime read_ht;
+  if (req->has_read_hybrid_time()) {
+    read_ht = HybridTime(req->read_hybrid_time());
+    const auto safe_time = abstract_tablet->SafeTime(
+        tablet::RequireLease::kFalse, read_ht, context.GetClientDeadline());
+    if (!safe_time.is_valid()) {
+      SetupErrorAndRespond(
+          resp->mutable_error(),
+          STATUS_FORMAT(TimedOut, "Timed out waiting for safe time $0", read_ht),
+          TabletServerErrorPB::UNKNOWN_ERROR, &context);
+      return;
+    }
+  } else {
+    read_ht = abstract_tablet->SafeTime(tablet::RequireLease::kFalse);
+  }
+
+  if (FLAGS_scanner_inject_latency_on_each_batch_ms > 0) {
+    SleepFor(MonoDelta::FromMilliseconds(FLAGS_scanner_inject_latency_on_each_batch_ms));
+  }
+
+  faststring rows_data;
+  auto status = ScanTablet(
+      down_cast<tablet::Tablet*>(abstract_tablet.get()), *req, ReadHybridTime::SingleTime(read_ht),
+      &rows_data, resp);
+  if (!status.ok()) {
+    SetupErrorAndRespond(resp->mutable_error(), status,
+                         TabletServerErrorPB::UNKNOWN_ERROR, &context);
+    return;
+  }
+
+  resp->set_read_hybrid_time(read_ht.ToUint64());
+  int rows_data_sidecar_idx = 0;
+  RETURN_UNKNOWN_ERROR_IF_NOT_OK(
+      context.AddRpcSidecar(RefCntBuffer(rows_data), &rows_data_sidecar_idx), resp, &context);
+  resp->set_rows_data_sidecar(rows_data_sidecar_idx);
+
+  context.RespondSuccess();
+}
+
 void TabletServiceImpl::ImportData(const ImportDataRequestPB* req,
                                    ImportDataResponsePB* resp,
                                    rpc::RpcContext context) {
@@ -1364,6 +1892,84 @@ void TabletServiceImpl::ImportData(const ImportDataRequestPB* req,
   context.RespondSuccess();
 }
 
+void TabletServiceImpl::UploadBulkLoadFile(const UploadBulkLoadFileRequestPB* req,
+                                           UploadBulkLoadFileResponsePB* resp,
+                                           rpc::RpcContext context) {
+  tablet::TabletPeerPtr peer;
+  if (!LookupTabletPeerOrRespond(server_->tablet_manager(), req->tablet_id(), resp, &context,
+                                 &peer)) {
+    return;
+  }
+  auto status = peer->tablet()->UploadBulkLoadFile(
+      req->load_id(), req->file_name(), req->offset(), req->data());
+  if (!status.ok()) {
+    SetupErrorAndRespond(resp->mutable_error(),
+                         status,
+                         TabletServerErrorPB::UNKNOWN_ERROR,
+                         &context);
+    return;
+  }
+  context.RespondSuccess();
+}
+
+void TabletServiceImpl::IngestBulkLoad(const IngestBulkLoadRequestPB* req,
+                                       IngestBulkLoadResponsePB* resp,
+                                       rpc::RpcContext context) {
+  TRACE("IngestBulkLoad");
+
+  UpdateClock(*req, server_->Clock());
+
+  scoped_refptr<tablet::TabletPeer> tablet_peer;
+  if (!LookupTabletPeerOrRespond(server_->tablet_manager(),
+                                 req->tablet_id(),
+                                 resp, &context,
+                                 &tablet_peer)) {
+    return;
+  }
+
+  // The operation gets hybrid time from the clock of this server, so it is later than the load
+  // hybrid time.
+  const HybridTime load_hybrid_time(req->load_hybrid_time());
+  if (!load_hybrid_time.is_valid() || load_hybrid_time >= server_->Clock()->Now()) {
+    SetupErrorAndRespond(resp->mutable_error(),
+                         STATUS_FORMAT(InvalidArgument, "Bad bulk load hybrid time: $0",
+                                       load_hybrid_time),
+                         TabletServerErrorPB::UNKNOWN_ERROR,
+                         &context);
+    return;
+  }
+
+  auto tx_state = std::make_unique<tablet::BulkLoadOperationState>(tablet_peer->tablet(), req);
+
+  tx_state->set_completion_callback(
+      MakeRpcOperationCompletionCallback(std::move(context), resp, server_->Clock()));
+
+  // Submit the bulk load op. The RPC will be responded to asynchronously.
+  tablet_peer->Submit(
+      std::make_unique<tablet::BulkLoadOperation>(std::move(tx_state), consensus::LEADER));
+}
+
+void TabletServiceImpl::GetChanges(const GetChangesRequestPB* req,
+                                   GetChangesResponsePB* resp,
+                                   rpc::RpcContext context) {
+  TRACE("GetChanges");
+
+  scoped_refptr<tablet::TabletPeer> tablet_peer;
+  if (!LookupTabletPeerOrRespond(server_->tablet_manager(),
+                                 req->tablet_id(),
+                                 resp, &context,
+                                 &tablet_peer)) {
+    return;
+  }
+
+  Status s = cdc_producer_.GetChanges(*tablet_peer, *req, resp);
+  if (PREDICT_FALSE(!s.ok())) {
+    SetupErrorAndRespond(resp->mutable_error(), s, TabletServerErrorPB::UNKNOWN_ERROR, &context);
+    return;
+  }
+  context.RespondSuccess();
+}
+
 void TabletServiceImpl::GetTabletStatus(const GetTabletStatusRequestPB* req,
                                         GetTabletStatusResponsePB* resp,
                                         rpc::RpcContext context) {
@@ -1380,6 +1986,7 @@ void TabletServiceImpl::GetTabletStatus(const GetTabletStatusRequestPB* req,
 }
 
 void TabletServiceImpl::Shutdown() {
+  cdc_producer_.Shutdown();
 }
 
 scoped_refptr<Histogram> TabletServer::GetMetricsHistogram(
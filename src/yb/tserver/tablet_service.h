@@ -36,6 +36,8 @@
 #include <string>
 #include <vector>
 
+#include <boost/optional.hpp>
+
 #include "yb/common/read_hybrid_time.h"
 #include "yb/consensus/consensus.service.h"
 #include "yb/gutil/ref_counted.h"
@@ -43,6 +45,7 @@
 #include "yb/tablet/tablet_fwd.h"
 #include "yb/tablet/tablet_peer.h"
 
+#include "yb/tserver/cdc_producer.h"
 #include "yb/tserver/tablet_server_interface.h"
 #include "yb/tserver/tserver_admin.service.h"
 #include "yb/tserver/tserver_service.service.h"
@@ -84,10 +87,26 @@ class TabletServiceImpl : public TabletServerServiceIf {
                 ChecksumResponsePB* resp,
                 rpc::RpcContext context) override;
 
+  void Scan(const ScanRequestPB* req,
+            ScanResponsePB* resp,
+            rpc::RpcContext context) override;
+
   void ImportData(const ImportDataRequestPB* req,
                   ImportDataResponsePB* resp,
                   rpc::RpcContext context) override;
 
+  void UploadBulkLoadFile(const UploadBulkLoadFileRequestPB* req,
+                          UploadBulkLoadFileResponsePB* resp,
+                          rpc::RpcContext context) override;
+
+  void IngestBulkLoad(const IngestBulkLoadRequestPB* req,
+                      IngestBulkLoadResponsePB* resp,
+                      rpc::RpcContext context) override;
+
+  void GetChanges(const GetChangesRequestPB* req,
+                  GetChangesResponsePB* resp,
+                  rpc::RpcContext context) override;
+
   void UpdateTransaction(const UpdateTransactionRequestPB* req,
                          UpdateTransactionResponsePB* resp,
                          rpc::RpcContext context) override;
@@ -149,6 +168,8 @@ class TabletServiceImpl : public TabletServerServiceIf {
                                 rpc::RpcContext* context);
 
   TabletServerIf *const server_;
+
+  CDCProducer cdc_producer_;
 };
 
 class TabletServiceAdminImpl : public TabletServerAdminServiceIf {
@@ -158,19 +179,47 @@ class TabletServiceAdminImpl : public TabletServerAdminServiceIf {
                             CreateTabletResponsePB* resp,
                             rpc::RpcContext context) override;
 
+  virtual void CreateTablets(const CreateTabletsRequestPB* req,
+                             CreateTabletsResponsePB* resp,
+                             rpc::RpcContext context) override;
+
   virtual void DeleteTablet(const DeleteTabletRequestPB* req,
                             DeleteTabletResponsePB* resp,
                             rpc::RpcContext context) override;
 
+  virtual void DeleteTablets(const DeleteTabletsRequestPB* req,
+                             DeleteTabletsResponsePB* resp,
+                             rpc::RpcContext context) override;
+
   virtual void AlterSchema(const AlterSchemaRequestPB* req,
                            AlterSchemaResponsePB* resp,
                            rpc::RpcContext context) override;
 
+  virtual void AlterSchemas(const AlterSchemasRequestPB* req,
+                            AlterSchemasResponsePB* resp,
+                            rpc::RpcContext context) override;
+
   virtual void CopartitionTable(const CopartitionTableRequestPB* req,
                                 CopartitionTableResponsePB* resp,
                                 rpc::RpcContext context) override;
 
  private:
+  // Creates the tablet specified by req, on failure sets error_code to the code that should be
+  // reported with the returned status.
+  CHECKED_STATUS DoCreateTablet(const CreateTabletRequestPB& req,
+                                TabletServerErrorPB::Code* error_code);
+
+  // Deletes the tablet specified by req, on failure could set error_code to the code that should
+  // be reported with the returned status.
+  CHECKED_STATUS DoDeleteTablet(const DeleteTabletRequestPB& req,
+                                const std::string& requestor,
+                                boost::optional<TabletServerErrorPB::Code>* error_code);
+
+  // Alters the schema of the tablet specified by req, callback is invoked when the alter is done.
+  // req should stay alive until then.
+  void DoAlterSchema(const AlterSchemaRequestPB& req,
+                     std::unique_ptr<tablet::OperationCompletionCallback> callback);
+
   TabletServer* server_;
 };
 
@@ -185,6 +234,10 @@ class ConsensusServiceImpl : public consensus::ConsensusServiceIf {
                                consensus::ConsensusResponsePB *resp,
                                rpc::RpcContext context) override;
 
+  virtual void MultiRaftUpdateConsensus(const consensus::MultiRaftConsensusRequestPB *req,
+                                        consensus::MultiRaftConsensusResponsePB *resp,
+                                        rpc::RpcContext context) override;
+
   virtual void RequestConsensusVote(const consensus::VoteRequestPB* req,
                                     consensus::VoteResponsePB* resp,
                                     rpc::RpcContext context) override;
@@ -222,6 +275,12 @@ class ConsensusServiceImpl : public consensus::ConsensusServiceIf {
                                     rpc::RpcContext context) override;
 
  private:
+  // Applies one of the requests of MultiRaftUpdateConsensus. On failure, 'error_code' is set to the
+  // code that should be reported in the response of this request.
+  CHECKED_STATUS DoUpdateConsensus(consensus::ConsensusRequestPB* req,
+                                   consensus::ConsensusResponsePB* resp,
+                                   TabletServerErrorPB::Code* error_code);
+
   TabletPeerLookupIf* tablet_manager_;
 };
 
@@ -32,7 +32,11 @@
 
 #include "yb/tserver/ts_tablet_manager.h"
 
+#include <atomic>
+#include <map>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include <gtest/gtest.h>
 #include <gflags/gflags.h>
@@ -49,6 +53,9 @@
 #include "yb/tserver/tablet_server.h"
 #include "yb/util/test_util.h"
 #include "yb/util/format.h"
+#include "yb/util/path_util.h"
+#include "yb/util/size_literals.h"
+#include "yb/util/stopwatch.h"
 
 #define ASSERT_REPORT_HAS_UPDATED_TABLET(report, tablet_id) \
   ASSERT_NO_FATALS(AssertReportHasUpdatedTablet(report, tablet_id))
@@ -57,6 +64,8 @@
   ASSERT_NO_FATALS(AssertMonotonicReportSeqno(report_seqno, tablet_report))
 
 DECLARE_bool(pretend_memory_exceeded_enforce_flush);
+DECLARE_bool(global_memstore_flush_largest_tablet);
+DECLARE_bool(rebalance_data_dirs_on_startup);
 
 namespace yb {
 namespace tserver {
@@ -71,6 +80,8 @@ using master::TabletReportPB;
 using tablet::TabletPeer;
 using gflags::FlagSaver;
 
+using namespace yb::size_literals;
+
 static const char* const kTabletId = "my-tablet-id";
 
 class TsTabletManagerTest : public YBTest {
@@ -83,6 +94,33 @@ class TsTabletManagerTest : public YBTest {
     auto mini_ts = MiniTabletServer::CreateMiniTabletServer(test_data_root_, 0);
     ASSERT_OK(mini_ts);
     mini_server_ = std::move(*mini_ts);
+    if (!data_paths_.empty()) {
+      mini_server_->options()->fs_opts.data_paths = data_paths_;
+    }
+  }
+
+  // Restarts the tablet server, that has no tablets yet, with the specified data directories.
+  void RestartWithDataPaths(const std::vector<std::string>& data_paths) {
+    mini_server_->Shutdown();
+    test_data_root_ = GetTestPath("TsTabletManagerTest-multidir");
+    data_paths_ = data_paths;
+    ASSERT_NO_FATALS(CreateMiniTabletServer());
+    ASSERT_OK(mini_server_->Start());
+    mini_server_->FailHeartbeats();
+    config_ = mini_server_->CreateLocalConfig();
+    tablet_manager_ = mini_server_->server()->tablet_manager();
+    fs_manager_ = mini_server_->server()->fs_manager();
+  }
+
+  // Returns the number of tablets in each data root directory.
+  std::map<std::string, int> CountTabletsPerDataDir() {
+    std::vector<scoped_refptr<TabletPeer>> peers;
+    tablet_manager_->GetTabletPeers(&peers);
+    std::map<std::string, int> result;
+    for (const auto& peer : peers) {
+      ++result[peer->tablet_metadata()->data_root_dir()];
+    }
+    return result;
   }
 
   void SetUp() override {
@@ -127,6 +165,7 @@ class TsTabletManagerTest : public YBTest {
   RaftConfigPB config_;
 
   string test_data_root_;
+  std::vector<std::string> data_paths_;
 };
 
 TEST_F(TsTabletManagerTest, TestCreateTablet) {
@@ -150,6 +189,53 @@ TEST_F(TsTabletManagerTest, TestCreateTablet) {
   ASSERT_EQ(kTabletId, peer->tablet()->tablet_id());
 }
 
+TEST_F(TsTabletManagerTest, RebalanceDataDirsOnStartup) {
+  const std::vector<std::string> data_paths = {
+      GetTestPath("data-1"), GetTestPath("data-2") };
+  ASSERT_NO_FATALS(RestartWithDataPaths(data_paths));
+
+  const int kNumTablets = 4;
+  std::vector<std::string> tablet_ids;
+  for (int i = 0; i < kNumTablets; ++i) {
+    tablet_ids.push_back(Format("tablet-$0", i));
+    ASSERT_OK(CreateNewTablet(tablet_ids.back(), schema_, nullptr));
+  }
+  auto dir_counts = CountTabletsPerDataDir();
+  ASSERT_EQ(2, dir_counts.size());
+  for (const auto& entry : dir_counts) {
+    ASSERT_EQ(kNumTablets / 2, entry.second) << entry.first;
+  }
+
+  // Make one of the tablets much larger than others, so the other tablet of its directory is
+  // moved.
+  scoped_refptr<TabletPeer> large_peer;
+  ASSERT_TRUE(tablet_manager_->LookupTablet(tablet_ids[0], &large_peer));
+  const auto large_dir = large_peer->tablet_metadata()->data_root_dir();
+  const auto padding_path = JoinPathSegments(large_peer->tablet_metadata()->rocksdb_dir(),
+                                             "padding");
+  large_peer.reset();
+  mini_server_->Shutdown();
+  ASSERT_OK(WriteStringToFile(Env::Default(), std::string(1_MB, 'x'), padding_path));
+
+  FlagSaver flag_saver;
+  FLAGS_rebalance_data_dirs_on_startup = true;
+  ASSERT_NO_FATALS(CreateMiniTabletServer());
+  ASSERT_OK(mini_server_->Start());
+  ASSERT_OK(mini_server_->WaitStarted());
+  tablet_manager_ = mini_server_->server()->tablet_manager();
+
+  dir_counts = CountTabletsPerDataDir();
+  ASSERT_EQ(2, dir_counts.size());
+  for (const auto& entry : dir_counts) {
+    ASSERT_EQ(entry.first == large_dir ? 1 : kNumTablets - 1, entry.second) << entry.first;
+  }
+  for (const auto& tablet_id : tablet_ids) {
+    scoped_refptr<TabletPeer> peer;
+    ASSERT_TRUE(tablet_manager_->LookupTablet(tablet_id, &peer)) << tablet_id;
+    ASSERT_OK(peer->WaitUntilConsensusRunning(MonoDelta::FromSeconds(10)));
+  }
+}
+
 TEST_F(TsTabletManagerTest, TestProperBackgroundFlushOnStartup) {
   FlagSaver flag_saver;
   FLAGS_pretend_memory_exceeded_enforce_flush = true;
@@ -193,6 +279,72 @@ TEST_F(TsTabletManagerTest, TestProperBackgroundFlushOnStartup) {
   }
 }
 
+TEST_F(TsTabletManagerTest, TestFlushLargestTablet) {
+  FlagSaver flag_saver;
+  FLAGS_pretend_memory_exceeded_enforce_flush = true;
+  FLAGS_global_memstore_flush_largest_tablet = true;
+
+  for (int i = 0; i < 2; ++i) {
+    scoped_refptr<TabletPeer> peer;
+    ASSERT_OK(CreateNewTablet(Format("my-tablet-$0", i + 1), schema_, &peer));
+  }
+
+  // Picks the tablet by active memtables size and flushes it asynchronously.
+  mini_server_->server()->tablet_manager()->MaybeFlushTablet();
+}
+
+TEST_F(TsTabletManagerTest, LookupTabletConcurrently) {
+  constexpr int kNumThreads = 64;
+  constexpr int kNumTablets = 3;
+  const auto kRunTime = MonoDelta::FromSeconds(1);
+
+  scoped_refptr<TabletPeer> peer;
+  ASSERT_OK(CreateNewTablet(Format("my-tablet-$0", 0), schema_, &peer));
+
+  std::atomic<bool> stop{false};
+  std::atomic<int64_t> num_lookups{0};
+  std::atomic<int64_t> num_failures{0};
+  std::vector<std::thread> threads;
+  Stopwatch sw;
+  sw.start();
+  for (int i = 0; i != kNumThreads; ++i) {
+    threads.emplace_back([this, &stop, &num_lookups, &num_failures] {
+      const std::string tablet_id = Format("my-tablet-$0", 0);
+      scoped_refptr<TabletPeer> found;
+      int64_t lookups = 0;
+      while (!stop.load(std::memory_order_acquire)) {
+        if (!tablet_manager_->LookupTablet(tablet_id, &found)) {
+          num_failures.fetch_add(1, std::memory_order_relaxed);
+        }
+        ++lookups;
+      }
+      num_lookups.fetch_add(lookups, std::memory_order_relaxed);
+    });
+  }
+
+  // Tablets registered while lookups are running should become visible right away.
+  Status create_status;
+  bool found_created = true;
+  for (int i = 1; i != kNumTablets && create_status.ok(); ++i) {
+    create_status = CreateNewTablet(Format("my-tablet-$0", i), schema_, nullptr);
+    found_created = found_created &&
+                    tablet_manager_->LookupTablet(Format("my-tablet-$0", i), &peer);
+  }
+  SleepFor(kRunTime);
+  stop.store(true, std::memory_order_release);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  sw.stop();
+
+  ASSERT_OK(create_status);
+  ASSERT_TRUE(found_created);
+  ASSERT_EQ(0, num_failures.load());
+  LOG(INFO) << num_lookups.load() << " lookups by " << kNumThreads << " threads, "
+            << sw.elapsed().wall * 1.0 * kNumThreads / std::max<int64_t>(num_lookups.load(), 1)
+            << " ns/lookup";
+}
+
 static void AssertMonotonicReportSeqno(int64_t* report_seqno,
                                        const TabletReportPB &report) {
   ASSERT_LT(*report_seqno, report.sequence_number());
@@ -52,14 +52,18 @@
 #include "yb/consensus/opid_util.h"
 #include "yb/consensus/quorum_util.h"
 
+#include "yb/docdb/docdb_rocksdb_util.h"
+
 #include "yb/fs/fs_manager.h"
 
 #include "yb/gutil/strings/substitute.h"
 #include "yb/gutil/strings/util.h"
+#include "yb/gutil/sysinfo.h"
 
 #include "yb/master/master.pb.h"
 #include "yb/master/sys_catalog.h"
 
+#include "yb/rocksdb/cache.h"
 #include "yb/rocksdb/memory_monitor.h"
 
 #include "yb/rpc/messenger.h"
@@ -77,6 +81,7 @@
 #include "yb/tserver/tablet_server.h"
 
 #include "yb/util/background_task.h"
+#include "yb/util/cache.h"
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/env.h"
 #include "yb/util/env_util.h"
@@ -94,9 +99,9 @@ using namespace std::literals; // NOLINT
 DEFINE_int32(num_tablets_to_open_simultaneously, 0,
              "Number of threads available to open tablets during startup. If this "
              "is set to 0 (the default), then the number of bootstrap threads will "
-             "be set based on the number of data directories. If the data directories "
-             "are on some very fast storage device such as SSD or a RAID array, it "
-             "may make sense to manually tune this.");
+             "be set to the maximum of the number of data directories and the number "
+             "of CPUs, since log replay is mostly CPU bound. If the data directories "
+             "are on slow storage devices, it may make sense to manually tune this.");
 TAG_FLAG(num_tablets_to_open_simultaneously, advanced);
 
 DEFINE_int32(tablet_start_warn_threshold_ms, 500,
@@ -144,6 +149,11 @@ DEFINE_int64(global_memstore_size_mb_max, 2048,
              "Global memstore size is determined as a percentage of the available "
              "memory. However, this flag limits it in absolute size. Value of 0 "
              "means no limit on the value obtained by the percentage. Default is 2048.");
+DEFINE_bool(global_memstore_flush_largest_tablet, false,
+            "When the global memstore limit is exceeded, flush the tablet with the largest "
+            "active memtables instead of the one with the oldest write in memstore.");
+TAG_FLAG(global_memstore_flush_largest_tablet, advanced);
+TAG_FLAG(global_memstore_flush_largest_tablet, runtime);
 
 DEFINE_int64(db_block_cache_size_bytes, kDbCacheSizeUsePercentage,
              "Size of cross-tablet shared RocksDB block cache (in bytes). "
@@ -155,6 +165,30 @@ DEFINE_int32(db_block_cache_size_percentage, 50,
              "Default percentage of total available memory to use as block cache size, if not "
              "asking for a raw number, through FLAGS_db_block_cache_size_bytes.");
 
+DEFINE_int64(db_block_cache_nvm_size_bytes, 0,
+             "Size of NVM cache used as a second tier of the RocksDB block cache (in bytes). "
+             "Blocks that are read from SST files again after eviction from the block cache are "
+             "admitted to this tier. NVM cache is allocated at --nvm_cache_path. "
+             "Value of 0 disables NVM tier.");
+TAG_FLAG(db_block_cache_nvm_size_bytes, experimental);
+
+DECLARE_int64(db_block_size_bytes);
+
+DEFINE_int32(intents_cleanup_pool_max_threads, 1,
+             "The maximum number of threads used to delete intents of applied transactions in "
+             "background. This pool is shared between all tablets, so it bounds the write load "
+             "caused by intents cleanup.");
+TAG_FLAG(intents_cleanup_pool_max_threads, advanced);
+
+DEFINE_bool(warm_up_table_readers, false,
+            "Open table readers of all SST files of a tablet in background after the tablet is "
+            "started, so the first reads after restart do not open files and load indexes.");
+TAG_FLAG(warm_up_table_readers, advanced);
+
+DEFINE_int32(warm_up_table_readers_max_threads, 4,
+             "The maximum number of threads used to warm up table readers of started tablets.");
+TAG_FLAG(warm_up_table_readers_max_threads, advanced);
+
 DEFINE_int32(read_pool_max_threads, 128,
              "The maximum number of threads allowed for read_pool_. This pool is used "
              "to run multiple read operations, that are part of the same tablet rpc, "
@@ -164,9 +198,21 @@ DEFINE_int32(read_pool_max_queue_size, 128,
              "is used to run multiple read operations, that are part of the same tablet rpc, "
              "in parallel.");
 
+DEFINE_int32(log_append_pool_max_threads, 0,
+             "The maximum number of threads in the pool shared by logs of all tablets to append "
+             "and sync entries, and to pre-allocate segments. 0 means that each tablet log uses "
+             "dedicated append and allocation threads.");
+TAG_FLAG(log_append_pool_max_threads, advanced);
+
 DEFINE_test_flag(int32, sleep_after_tombstoning_tablet_secs, 0,
                  "Whether we sleep in LogAndTombstone after calling DeleteTabletData.");
 
+DEFINE_bool(rebalance_data_dirs_on_startup, false,
+            "Move tablet data from the data directories with the most bytes to the ones with the "
+            "least on startup, before tablets are opened. Files are hard linked when both "
+            "directories are on the same file system, and copied otherwise.");
+TAG_FLAG(rebalance_data_dirs_on_startup, advanced);
+
 constexpr int kTServerYbClientDefaultTimeoutMs = yb::RegularBuildVsSanitizers(5, 60) * 1000;
 
 DEFINE_int32(tserver_yb_client_default_timeout_ms, kTServerYbClientDefaultTimeoutMs,
@@ -197,6 +243,30 @@ METRIC_DEFINE_histogram(server, op_apply_run_time, "Operation Apply Run Time",
                         "that operations consist of very large batches.",
                         10000000, 2);
 
+METRIC_DEFINE_histogram(server, op_prepare_queue_time, "Operation Prepare Queue Time",
+                        MetricUnit::kMicroseconds,
+                        "Time that tasks of tablet preparers spent waiting in the shared prepare "
+                        "pool before being processed.",
+                        10000000, 2);
+
+METRIC_DEFINE_histogram(server, op_prepare_run_time, "Operation Prepare Run Time",
+                        MetricUnit::kMicroseconds,
+                        "Time that tasks of tablet preparers spent running in the shared prepare "
+                        "pool.",
+                        10000000, 2);
+
+METRIC_DEFINE_histogram(server, log_append_queue_time, "Log Append Queue Time",
+                        MetricUnit::kMicroseconds,
+                        "Time that log append and segment allocation tasks spent waiting in the "
+                        "shared log append pool before being processed.",
+                        10000000, 2);
+
+METRIC_DEFINE_histogram(server, log_append_run_time, "Log Append Run Time",
+                        MetricUnit::kMicroseconds,
+                        "Time that log append and segment allocation tasks spent running in the "
+                        "shared log append pool.",
+                        10000000, 2);
+
 METRIC_DEFINE_histogram(server, op_read_queue_length, "Operation Read op Queue Length",
                         MetricUnit::kTasks,
                         "Number of operations waiting to be applied to the tablet. "
@@ -244,6 +314,59 @@ using tablet::TabletPeerClass;
 using tablet::TabletStatusListener;
 using tablet::TabletStatusPB;
 
+namespace {
+
+// Returns the total size of files under dir.
+Result<uint64_t> DirectorySize(Env* env, const std::string& dir) {
+  std::vector<std::string> children;
+  RETURN_NOT_OK(env->GetChildren(dir, ExcludeDots::kTrue, &children));
+  uint64_t result = 0;
+  for (const auto& child : children) {
+    const auto path = JoinPathSegments(dir, child);
+    bool is_dir = false;
+    RETURN_NOT_OK(env->IsDirectory(path, &is_dir));
+    result += is_dir ? VERIFY_RESULT(DirectorySize(env, path))
+                     : VERIFY_RESULT(env->GetFileSize(path));
+  }
+  return result;
+}
+
+// Copies files under source_dir to dest_dir, that should not exist. Files are hard linked when
+// possible, i.e. when both directories are on the same file system.
+Status CopyDirectory(Env* env, const std::string& source_dir, const std::string& dest_dir) {
+  RETURN_NOT_OK(env->CreateDir(dest_dir));
+  std::vector<std::string> children;
+  RETURN_NOT_OK(env->GetChildren(source_dir, ExcludeDots::kTrue, &children));
+  for (const auto& child : children) {
+    const auto source_path = JoinPathSegments(source_dir, child);
+    const auto dest_path = JoinPathSegments(dest_dir, child);
+    bool is_dir = false;
+    RETURN_NOT_OK(env->IsDirectory(source_path, &is_dir));
+    if (is_dir) {
+      RETURN_NOT_OK(CopyDirectory(env, source_path, dest_path));
+    } else if (!env->LinkFile(source_path, dest_path).ok()) {
+      WritableFileOptions options;
+      options.sync_on_close = true;
+      RETURN_NOT_OK(env_util::CopyFile(env, source_path, dest_path, options));
+    }
+  }
+  return env->SyncDir(dest_dir);
+}
+
+// Returns the number of tablets of all tables assigned to each directory of assignment_map.
+template <class AssignmentMap>
+std::unordered_map<std::string, size_t> CountTabletsPerDir(const AssignmentMap& assignment_map) {
+  std::unordered_map<std::string, size_t> result;
+  for (const auto& table_dirs : assignment_map) {
+    for (const auto& dir_tablets : table_dirs.second) {
+      result[dir_tablets.first] += dir_tablets.second.size();
+    }
+  }
+  return result;
+}
+
+} // namespace
+
 // Only called from the background task to ensure it's synchronized
 void TSTabletManager::MaybeFlushTablet() {
   int iteration = 0;
@@ -260,15 +383,27 @@ void TSTabletManager::MaybeFlushTablet() {
   }
 }
 
-// Return the tablet with the oldest write in memstore, or nullptr if all
-// tablet memstores are empty or about to flush.
+// Return the tablet with the oldest write in memstore (or the largest active memtables, if
+// FLAGS_global_memstore_flush_largest_tablet is set or the server is over its soft memory limit),
+// or nullptr if all tablet memstores are empty or about to flush.
 scoped_refptr<TabletPeer> TSTabletManager::TabletToFlush() {
+  // Flushing the largest memtables frees the most memory, that is what we need first when the
+  // whole server is running out of it.
+  const bool flush_largest = FLAGS_global_memstore_flush_largest_tablet ||
+                             server_->mem_tracker()->AnySoftLimitOverage() > 0;
   boost::shared_lock<rw_spinlock> lock(lock_); // For using the tablet map
   HybridTime oldest_write_in_memstores = HybridTime::kMax;
+  uint64_t largest_memtables_size = 0;
   scoped_refptr<TabletPeer> tablet_to_flush;
   for (const TabletMap::value_type& entry : tablet_map_) {
     const auto tablet = entry.second->shared_tablet();
-    if (tablet) {
+    if (tablet && flush_largest) {
+      const uint64_t memtables_size = tablet->ActiveMemTablesSize();
+      if (memtables_size > largest_memtables_size) {
+        largest_memtables_size = memtables_size;
+        tablet_to_flush = entry.second;
+      }
+    } else if (tablet) {
       const HybridTime oldest_write_in_memstore = tablet->flush_stats()->oldest_write_in_memstore();
       if (oldest_write_in_memstore < oldest_write_in_memstores) {
         oldest_write_in_memstores = oldest_write_in_memstore;
@@ -311,8 +446,14 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
   CHECK_OK(ThreadPoolBuilder("raft")
                .set_max_threads(std::numeric_limits<int>::max())
                .Build(&raft_pool_));
+  ThreadPoolMetrics prepare_metrics = {
+      nullptr,
+      METRIC_op_prepare_queue_time.Instantiate(server_->metric_entity()),
+      METRIC_op_prepare_run_time.Instantiate(server_->metric_entity())
+  };
   CHECK_OK(ThreadPoolBuilder("prepare")
                .set_max_threads(std::numeric_limits<int>::max())
+               .set_metrics(std::move(prepare_metrics))
                .Build(&tablet_prepare_pool_));
   ThreadPoolMetrics read_metrics = {
       METRIC_op_read_queue_length.Instantiate(server_->metric_entity()),
@@ -324,6 +465,29 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
                .set_max_queue_size(FLAGS_read_pool_max_queue_size)
                .set_metrics(std::move(read_metrics))
                .Build(&read_pool_));
+  if (FLAGS_log_append_pool_max_threads > 0) {
+    ThreadPoolMetrics append_metrics = {
+        nullptr,
+        METRIC_log_append_queue_time.Instantiate(server_->metric_entity()),
+        METRIC_log_append_run_time.Instantiate(server_->metric_entity())
+    };
+    CHECK_OK(ThreadPoolBuilder("log-append")
+                 .set_max_threads(FLAGS_log_append_pool_max_threads)
+                 .set_metrics(std::move(append_metrics))
+                 .Build(&append_pool_));
+  }
+  if (FLAGS_intents_cleanup_pool_max_threads > 0) {
+    CHECK_OK(ThreadPoolBuilder("intents-cleanup")
+                 .set_max_threads(FLAGS_intents_cleanup_pool_max_threads)
+                 .Build(&intents_cleanup_pool_));
+    tablet_options_.intents_cleanup_pool = intents_cleanup_pool_.get();
+  }
+  if (FLAGS_warm_up_table_readers) {
+    CHECK_OK(ThreadPoolBuilder("table-warm-up")
+                 .set_max_threads(std::max(FLAGS_warm_up_table_readers_max_threads, 1))
+                 .Build(&warm_up_pool_));
+  }
+  tablet_options_.rate_limiter = docdb::CreateSharedRocksDBRateLimiter();
 
   int64_t block_cache_size_bytes = FLAGS_db_block_cache_size_bytes;
   int64_t total_ram_avail = MemTracker::GetRootTracker()->limit();
@@ -341,6 +505,14 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
   if (FLAGS_db_block_cache_size_bytes != kDbCacheSizeCacheDisabled) {
     tablet_options_.block_cache = rocksdb::NewLRUCache(block_cache_size_bytes);
     tablet_options_.block_cache->SetMetrics(server_->metric_entity());
+    if (FLAGS_db_block_cache_nvm_size_bytes > 0) {
+      std::unique_ptr<Cache> nvm_cache(NewLRUCache(
+          NVM_CACHE, FLAGS_db_block_cache_nvm_size_bytes, "block_cache_nvm"));
+      nvm_cache->SetMetrics(server_->metric_entity());
+      // Admission policy remembers about as many blocks as could be stored in NVM tier.
+      tablet_options_.secondary_block_cache = rocksdb::NewSecondaryBlockCache(
+          std::move(nvm_cache), FLAGS_db_block_cache_nvm_size_bytes / FLAGS_db_block_size_bytes);
+    }
   }
 
   // Calculate memstore_size_bytes
@@ -382,8 +554,9 @@ Status TSTabletManager::Init() {
   // FsManager isn't initialized until this point.
   int max_bootstrap_threads = FLAGS_num_tablets_to_open_simultaneously;
   if (max_bootstrap_threads == 0) {
-    // Default to the number of disks.
-    max_bootstrap_threads = fs_manager_->GetDataRootDirs().size();
+    // Default to the number of disks, but use all CPUs, since each tablet is replayed by a single
+    // thread.
+    max_bootstrap_threads = std::max<int>(fs_manager_->GetDataRootDirs().size(), base::NumCPUs());
   }
   RETURN_NOT_OK(ThreadPoolBuilder("tablet-bootstrap")
                 .set_max_threads(max_bootstrap_threads)
@@ -419,6 +592,11 @@ Status TSTabletManager::Init() {
     metas.push_back(meta);
   }
 
+  auto tablet_bytes = MeasureDataDirs(metas);
+  if (FLAGS_rebalance_data_dirs_on_startup) {
+    RebalanceDataDirs(metas, &tablet_bytes);
+  }
+
   // Now submit the "Open" task for each.
   for (const scoped_refptr<TabletMetadata>& meta : metas) {
     scoped_refptr<TransitionInProgressDeleter> deleter;
@@ -429,7 +607,7 @@ Status TSTabletManager::Init() {
 
     scoped_refptr<TabletPeer> tablet_peer = CreateAndRegisterTabletPeer(meta, NEW_PEER);
     RETURN_NOT_OK(open_tablet_pool_->SubmitFunc(
-        std::bind(&TSTabletManager::OpenTablet, this, meta, deleter)));
+        std::bind(&TSTabletManager::OpenTablet, this, meta, deleter, std::string())));
   }
 
   {
@@ -472,7 +650,8 @@ Status TSTabletManager::CreateNewTablet(
     const Schema &schema,
     const PartitionSchema &partition_schema,
     RaftConfigPB config,
-    scoped_refptr<TabletPeer> *tablet_peer) {
+    scoped_refptr<TabletPeer> *tablet_peer,
+    const std::string& initial_leader_uuid) {
   CHECK_EQ(state(), MANAGER_RUNNING);
 
   for (int i = 0; i < config.peers_size(); ++i) {
@@ -540,8 +719,8 @@ Status TSTabletManager::CreateNewTablet(
   scoped_refptr<TabletPeer> new_peer = CreateAndRegisterTabletPeer(meta, NEW_PEER);
 
   // We can run this synchronously since there is nothing to bootstrap.
-  RETURN_NOT_OK(
-      open_tablet_pool_->SubmitFunc(std::bind(&TSTabletManager::OpenTablet, this, meta, deleter)));
+  RETURN_NOT_OK(open_tablet_pool_->SubmitFunc(
+      std::bind(&TSTabletManager::OpenTablet, this, meta, deleter, initial_leader_uuid)));
 
   if (tablet_peer) {
     *tablet_peer = new_peer;
@@ -699,7 +878,7 @@ Status TSTabletManager::StartRemoteBootstrap(const StartRemoteBootstrapRequestPB
                    this);
 
   LOG(INFO) << kLogPrefix << "Remote bootstrap: Opening tablet";
-  OpenTablet(meta, nullptr);
+  OpenTablet(meta, nullptr, std::string());
 
   // If OpenTablet fails, tablet_peer->error() will be set.
   SHUTDOWN_AND_TOMBSTONE_TABLET_PEER_NOT_OK(tablet_peer->error(),
@@ -823,15 +1002,19 @@ Status TSTabletManager::DeleteTablet(
 
   // We only remove DELETED tablets from the tablet map.
   if (delete_type == TABLET_DATA_DELETED) {
-    std::lock_guard<rw_spinlock> lock(lock_);
-    RETURN_NOT_OK(CheckRunningUnlocked(error_code));
-    CHECK_EQ(1, tablet_map_.erase(tablet_id)) << tablet_id;
-    UnregisterDataWalDir(meta->table_id(),
-                         tablet_id,
-                         meta->table_type(),
-                         meta->data_root_dir(),
-                         meta->wal_root_dir());
-}
+    {
+      std::lock_guard<rw_spinlock> lock(lock_);
+      RETURN_NOT_OK(CheckRunningUnlocked(error_code));
+      CHECK_EQ(1, tablet_map_.erase(tablet_id)) << tablet_id;
+      ++tablet_map_version_;
+      UnregisterDataWalDir(meta->table_id(),
+                           tablet_id,
+                           meta->table_type(),
+                           meta->data_root_dir(),
+                           meta->wal_root_dir());
+    }
+    UpdateTabletMapSnapshot();
+  }
 
   return Status::OK();
 }
@@ -879,7 +1062,8 @@ Status TSTabletManager::OpenTabletMeta(const string& tablet_id,
 }
 
 void TSTabletManager::OpenTablet(const scoped_refptr<TabletMetadata>& meta,
-                                 const scoped_refptr<TransitionInProgressDeleter>& deleter) {
+                                 const scoped_refptr<TransitionInProgressDeleter>& deleter,
+                                 const std::string& initial_leader_uuid) {
   string tablet_id = meta->tablet_id();
   TRACE_EVENT1("tserver", "TSTabletManager::OpenTablet",
                "tablet_id", tablet_id);
@@ -910,7 +1094,8 @@ void TSTabletManager::OpenTablet(const scoped_refptr<TabletMetadata>& meta,
         tablet_peer->log_anchor_registry(),
         tablet_options_,
         tablet_peer.get(),
-        tablet_peer.get()};
+        tablet_peer.get(),
+        append_pool_.get()};
     s = BootstrapTablet(data, &tablet, &log, &bootstrap_info);
     if (!s.ok()) {
       LOG(ERROR) << kLogPrefix << "Tablet failed to bootstrap: "
@@ -940,6 +1125,7 @@ void TSTabletManager::OpenTablet(const scoped_refptr<TabletMetadata>& meta,
     }
 
     TRACE("Starting tablet peer");
+    bootstrap_info.initial_leader_uuid = initial_leader_uuid;
     s = tablet_peer->Start(bootstrap_info);
     if (!s.ok()) {
       LOG(ERROR) << kLogPrefix << "Tablet failed to start: "
@@ -951,6 +1137,10 @@ void TSTabletManager::OpenTablet(const scoped_refptr<TabletMetadata>& meta,
     tablet_peer->RegisterMaintenanceOps(server_->maintenance_manager());
   }
 
+  if (warm_up_pool_) {
+    ScheduleTableReadersWarmUp(tablet_peer);
+  }
+
   int elapsed_ms = MonoTime::Now().GetDeltaSince(start).ToMilliseconds();
   if (elapsed_ms > FLAGS_tablet_start_warn_threshold_ms) {
     LOG(WARNING) << kLogPrefix << "Tablet startup took " << elapsed_ms << "ms";
@@ -961,6 +1151,47 @@ void TSTabletManager::OpenTablet(const scoped_refptr<TabletMetadata>& meta,
   }
 }
 
+void TSTabletManager::ScheduleTableReadersWarmUp(
+    const scoped_refptr<TabletPeer>& tablet_peer) {
+  {
+    std::lock_guard<std::mutex> lock(warm_up_mutex_);
+    tablets_to_warm_up_.push_back(tablet_peer);
+  }
+  // Every task warms up the best tablet queued at the time it runs, not the one that queued it.
+  WARN_NOT_OK(
+      warm_up_pool_->SubmitFunc(std::bind(&TSTabletManager::WarmUpNextTableReaders, this)),
+      "Unable to schedule table readers warm up");
+}
+
+void TSTabletManager::WarmUpNextTableReaders() {
+  scoped_refptr<TabletPeer> tablet_peer;
+  {
+    std::lock_guard<std::mutex> lock(warm_up_mutex_);
+    if (tablets_to_warm_up_.empty()) {
+      return;
+    }
+    auto it = std::find_if(
+        tablets_to_warm_up_.begin(), tablets_to_warm_up_.end(),
+        [](const scoped_refptr<TabletPeer>& peer) {
+          return peer->LeaderStatus() != consensus::Consensus::LeaderStatus::NOT_LEADER;
+        });
+    if (it == tablets_to_warm_up_.end()) {
+      it = tablets_to_warm_up_.begin();
+    }
+    tablet_peer = std::move(*it);
+    tablets_to_warm_up_.erase(it);
+  }
+
+  auto tablet = tablet_peer->shared_tablet();
+  if (!tablet) {
+    return;
+  }
+  const string kLogPrefix = LogPrefix(tablet_peer->tablet_id(), fs_manager_->uuid());
+  LOG_TIMING_PREFIX(INFO, kLogPrefix, "warming up table readers") {
+    WARN_NOT_OK(tablet->WarmUpTableReaders(), kLogPrefix + "Failed to warm up table readers");
+  }
+}
+
 void TSTabletManager::Shutdown() {
   async_client_init_.Shutdown();
 
@@ -994,6 +1225,14 @@ void TSTabletManager::Shutdown() {
   // Shut down the bootstrap pool, so new tablets are registered after this point.
   open_tablet_pool_->Shutdown();
 
+  if (warm_up_pool_) {
+    {
+      std::lock_guard<std::mutex> lock(warm_up_mutex_);
+      tablets_to_warm_up_.clear();
+    }
+    warm_up_pool_->Shutdown();
+  }
+
   // Take a snapshot of the peers list -- that way we don't have to hold
   // on to the lock while shutting them down, which might cause a lock
   // inversion. (see KUDU-308 for example).
@@ -1013,6 +1252,12 @@ void TSTabletManager::Shutdown() {
   if (tablet_prepare_pool_) {
     tablet_prepare_pool_->Shutdown();
   }
+  if (append_pool_) {
+    append_pool_->Shutdown();
+  }
+  if (intents_cleanup_pool_) {
+    intents_cleanup_pool_->Shutdown();
+  }
 
   {
     std::lock_guard<rw_spinlock> l(lock_);
@@ -1021,33 +1266,64 @@ void TSTabletManager::Shutdown() {
     CHECK_EQ(tablet_map_.size(), peers_to_shutdown.size())
       << "Map contents changed during shutdown!";
     tablet_map_.clear();
+    ++tablet_map_version_;
     table_data_assignment_map_.clear();
     table_wal_assignment_map_.clear();
+    data_root_dir_bytes_.clear();
 
     state_ = MANAGER_SHUTDOWN;
   }
+  UpdateTabletMapSnapshot();
 }
 
 void TSTabletManager::RegisterTablet(const std::string& tablet_id,
                                      const scoped_refptr<TabletPeer>& tablet_peer,
                                      RegisterTabletPeerMode mode) {
-  std::lock_guard<rw_spinlock> lock(lock_);
-  // If we are replacing a tablet peer, we delete the existing one first.
-  if (mode == REPLACEMENT_PEER && tablet_map_.erase(tablet_id) != 1) {
-    LOG(FATAL) << "Unable to remove previous tablet peer " << tablet_id << ": not registered!";
-  }
-  if (!InsertIfNotPresent(&tablet_map_, tablet_id, tablet_peer)) {
-    scoped_refptr<TabletMetadata> meta = tablet_peer->tablet_metadata();
-    LOG(FATAL) << "Unable to register tablet peer " << tablet_id << ": already registered!";
+  {
+    std::lock_guard<rw_spinlock> lock(lock_);
+    // If we are replacing a tablet peer, we delete the existing one first.
+    if (mode == REPLACEMENT_PEER && tablet_map_.erase(tablet_id) != 1) {
+      LOG(FATAL) << "Unable to remove previous tablet peer " << tablet_id << ": not registered!";
+    }
+    if (!InsertIfNotPresent(&tablet_map_, tablet_id, tablet_peer)) {
+      scoped_refptr<TabletMetadata> meta = tablet_peer->tablet_metadata();
+      LOG(FATAL) << "Unable to register tablet peer " << tablet_id << ": already registered!";
+    }
+    ++tablet_map_version_;
   }
+  UpdateTabletMapSnapshot();
 
   LOG(INFO) << "Registered tablet " << tablet_id;
 }
 
+void TSTabletManager::UpdateTabletMapSnapshot() {
+  // Snapshots are built and published in the same order, so the last published snapshot always
+  // contains changes of all writers. A writer that waited for another one to publish could find
+  // its change already published, so it does not have to copy the map again.
+  std::lock_guard<std::mutex> publish_lock(tablet_map_snapshot_mutex_);
+  TabletMap new_snapshot;
+  {
+    boost::shared_lock<rw_spinlock> lock(lock_);
+    if (tablet_map_snapshot_version_ == tablet_map_version_) {
+      return;
+    }
+    new_snapshot = tablet_map_;
+    tablet_map_snapshot_version_ = tablet_map_version_;
+  }
+  // Publishing waits for readers of the old snapshot, so it is done without holding lock_.
+  tablet_map_snapshot_.Set(std::move(new_snapshot));
+}
+
 bool TSTabletManager::LookupTablet(const string& tablet_id,
                                    scoped_refptr<TabletPeer>* tablet_peer) const {
-  boost::shared_lock<rw_spinlock> shared_lock(lock_);
-  return LookupTabletUnlocked(tablet_id, tablet_peer);
+  // Snapshot is immutable, so we don't need lock_ here.
+  auto snapshot = tablet_map_snapshot_.get();
+  const scoped_refptr<TabletPeer>* found = FindOrNull(*snapshot, tablet_id);
+  if (!found) {
+    return false;
+  }
+  *tablet_peer = *found;
+  return true;
 }
 
 bool TSTabletManager::LookupTabletUnlocked(const string& tablet_id,
@@ -1281,15 +1557,21 @@ void TSTabletManager::GetAndRegisterDataAndWalDir(FsManager* fs_manager,
       table_data_assignment_map_[table_id][data_root_iter] = tablet_id_set;
     }
   }
-  // Find the data directory with the least count of tablets for this table.
+  // Find the data directory with the least count of tablets for this table. Ties are broken by
+  // the count of tablets of all tables, and then by the bytes of tablet data measured on startup.
   table_data_assignment_iter = table_data_assignment_map_.find(table_id);
   auto data_assignment_value_map = table_data_assignment_iter->second;
+  const auto data_dir_tablets = CountTabletsPerDir(table_data_assignment_map_);
   string min_dir;
-  uint64_t min_dir_count = kuint64max;
+  auto min_dir_load = std::make_tuple(kuint64max, kuint64max, kuint64max);
   for (auto it = data_assignment_value_map.begin(); it != data_assignment_value_map.end(); ++it) {
-    if (min_dir_count > it->second.size()) {
+    const auto bytes_it = data_root_dir_bytes_.find(it->first);
+    const auto load = std::make_tuple(
+        it->second.size(), data_dir_tablets.at(it->first),
+        bytes_it != data_root_dir_bytes_.end() ? bytes_it->second : 0);
+    if (load < min_dir_load) {
       min_dir = it->first;
-      min_dir_count = it->second.size();
+      min_dir_load = load;
     }
   }
   *data_root_dir = min_dir;
@@ -1297,9 +1579,9 @@ void TSTabletManager::GetAndRegisterDataAndWalDir(FsManager* fs_manager,
   auto data_assignment_value_iter = table_data_assignment_map_[table_id].find(min_dir);
   data_assignment_value_iter->second.insert(tablet_id);
 
-  // Find the wal directory with the least count of tablets for this table.
+  // Find the wal directory with the least count of tablets for this table, and then of all tables.
   min_dir = "";
-  min_dir_count = kuint64max;
+  auto min_wal_dir_load = std::make_tuple(kuint64max, kuint64max);
   auto wal_root_dirs = fs_manager->GetWalRootDirs();
   CHECK(!wal_root_dirs.empty()) << "No wal root directories found";
   auto table_wal_assignment_iter = table_wal_assignment_map_.find(table_id);
@@ -1311,10 +1593,12 @@ void TSTabletManager::GetAndRegisterDataAndWalDir(FsManager* fs_manager,
   }
   table_wal_assignment_iter = table_wal_assignment_map_.find(table_id);
   auto wal_assignment_value_map = table_wal_assignment_iter->second;
+  const auto wal_dir_tablets = CountTabletsPerDir(table_wal_assignment_map_);
   for (auto it = wal_assignment_value_map.begin(); it != wal_assignment_value_map.end(); ++it) {
-    if (min_dir_count > it->second.size()) {
+    const auto load = std::make_tuple(it->second.size(), wal_dir_tablets.at(it->first));
+    if (load < min_wal_dir_load) {
       min_dir = it->first;
-      min_dir_count = it->second.size();
+      min_wal_dir_load = load;
     }
   }
   *wal_root_dir = min_dir;
@@ -1419,6 +1703,138 @@ void TSTabletManager::UnregisterDataWalDir(const string& table_id,
   }
 }
 
+std::unordered_map<TabletId, uint64_t> TSTabletManager::MeasureDataDirs(
+    const vector<scoped_refptr<TabletMetadata>>& metas) {
+  std::unordered_map<TabletId, uint64_t> tablet_bytes;
+  MutexLock l(dir_assignment_lock_);
+  data_root_dir_bytes_.clear();
+  for (const auto& meta : metas) {
+    if (meta->table_id() == master::kSysCatalogTableId ||
+        !fs_manager_->env()->FileExists(meta->rocksdb_dir())) {
+      continue;
+    }
+    auto bytes = DirectorySize(fs_manager_->env(), meta->rocksdb_dir());
+    if (!bytes.ok()) {
+      LOG(WARNING) << "Failed to measure data of tablet " << meta->tablet_id() << ": "
+                   << bytes.status();
+      continue;
+    }
+    tablet_bytes[meta->tablet_id()] = *bytes;
+    data_root_dir_bytes_[meta->data_root_dir()] += *bytes;
+  }
+  return tablet_bytes;
+}
+
+void TSTabletManager::RebalanceDataDirs(const vector<scoped_refptr<TabletMetadata>>& metas,
+                                        std::unordered_map<TabletId, uint64_t>* tablet_bytes) {
+  const auto data_root_dirs = fs_manager_->GetDataRootDirs();
+  if (data_root_dirs.size() < 2) {
+    return;
+  }
+  std::unordered_map<string, vector<TabletMetadata*>> dir_tablets;
+  for (const auto& meta : metas) {
+    // Data of pending bulk loads is kept next to the RocksDB directory, so it would be left behind.
+    if (tablet_bytes->count(meta->tablet_id()) &&
+        !fs_manager_->env()->FileExists(meta->bulk_load_dir())) {
+      dir_tablets[meta->data_root_dir()].push_back(meta.get());
+    }
+  }
+
+  for (;;) {
+    string fullest_dir;
+    string emptiest_dir;
+    TabletMetadata* meta = nullptr;
+    {
+      MutexLock l(dir_assignment_lock_);
+      auto dir_bytes = [this](const string& dir) {
+        auto it = data_root_dir_bytes_.find(dir);
+        return it != data_root_dir_bytes_.end() ? it->second : 0;
+      };
+      for (const auto& dir : data_root_dirs) {
+        if (fullest_dir.empty() || dir_bytes(dir) > dir_bytes(fullest_dir)) {
+          fullest_dir = dir;
+        }
+        if (emptiest_dir.empty() || dir_bytes(dir) < dir_bytes(emptiest_dir)) {
+          emptiest_dir = dir;
+        }
+      }
+      // Moving a tablet with at most half of the difference brings both directories closer, so
+      // the sum of squared directory sizes decreases with each move, and the loop terminates.
+      const uint64_t max_bytes = (dir_bytes(fullest_dir) - dir_bytes(emptiest_dir)) / 2;
+      auto& candidates = dir_tablets[fullest_dir];
+      auto best = candidates.end();
+      for (auto it = candidates.begin(); it != candidates.end(); ++it) {
+        const uint64_t bytes = (*tablet_bytes)[(**it).tablet_id()];
+        if (bytes > 0 && bytes <= max_bytes &&
+            (best == candidates.end() || bytes > (*tablet_bytes)[(**best).tablet_id()])) {
+          best = it;
+        }
+      }
+      if (best == candidates.end()) {
+        return;
+      }
+      meta = *best;
+      candidates.erase(best);
+      dir_tablets[emptiest_dir].push_back(meta);
+      const uint64_t bytes = (*tablet_bytes)[meta->tablet_id()];
+      data_root_dir_bytes_[fullest_dir] -= bytes;
+      data_root_dir_bytes_[emptiest_dir] += bytes;
+    }
+
+    LOG(INFO) << "Moving data of tablet " << meta->tablet_id() << " of "
+              << (*tablet_bytes)[meta->tablet_id()] << " bytes from " << fullest_dir << " to "
+              << emptiest_dir;
+    const Status s = MoveTabletData(meta, emptiest_dir);
+    if (!s.ok()) {
+      LOG(WARNING) << "Failed to move data of tablet " << meta->tablet_id() << ", stopping data "
+                   << "directories rebalancing: " << s;
+      return;
+    }
+  }
+}
+
+Status TSTabletManager::MoveTabletData(TabletMetadata* meta, const string& data_root_dir) {
+  Env* env = fs_manager_->env();
+  const string old_rocksdb_dir = meta->rocksdb_dir();
+  const string old_data_root_dir = meta->data_root_dir();
+  const string new_rocksdb_dir = JoinPathSegments(
+      data_root_dir, old_rocksdb_dir.substr(old_data_root_dir.size() + 1));
+  const string tmp_dir = new_rocksdb_dir + ".tmp";
+
+  // Leftovers of a move that was interrupted before the metadata was flushed.
+  for (const auto& dir : {new_rocksdb_dir, tmp_dir}) {
+    if (env->FileExists(dir)) {
+      RETURN_NOT_OK(env->DeleteRecursively(dir));
+    }
+  }
+  RETURN_NOT_OK(fs_manager_->CreateDirIfMissing(DirName(DirName(new_rocksdb_dir))));
+  RETURN_NOT_OK(fs_manager_->CreateDirIfMissing(DirName(new_rocksdb_dir)));
+  Status s = CopyDirectory(env, old_rocksdb_dir, tmp_dir);
+  if (s.ok()) {
+    s = env->RenameFile(tmp_dir, new_rocksdb_dir);
+  }
+  if (s.ok()) {
+    s = env->SyncDir(DirName(new_rocksdb_dir));
+  }
+  if (!s.ok()) {
+    WARN_NOT_OK(env->DeleteRecursively(tmp_dir), "Failed to delete partially copied tablet data");
+    return s;
+  }
+
+  // The tablet uses the new directory once the metadata is flushed.
+  meta->SetDataRootDir(data_root_dir);
+  DCHECK_EQ(new_rocksdb_dir, meta->rocksdb_dir());
+  RETURN_NOT_OK(meta->Flush());
+  WARN_NOT_OK(env->DeleteRecursively(old_rocksdb_dir),
+              "Failed to delete moved tablet data at " + old_rocksdb_dir);
+
+  UnregisterDataWalDir(meta->table_id(), meta->tablet_id(), meta->table_type(),
+                       old_data_root_dir, meta->wal_root_dir());
+  RegisterDataAndWalDir(fs_manager_, meta->table_id(), meta->tablet_id(), meta->table_type(),
+                        meta->data_root_dir(), meta->wal_root_dir());
+  return Status::OK();
+}
+
 Status DeleteTabletData(const scoped_refptr<TabletMetadata>& meta,
                         TabletDataState data_state,
                         const string& uuid,
@@ -33,6 +33,7 @@
 #define YB_TSERVER_TS_TABLET_MANAGER_H
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -54,6 +55,7 @@
 #include "yb/tserver/tablet_peer_lookup.h"
 #include "yb/tserver/tserver.pb.h"
 #include "yb/tserver/tserver_admin.pb.h"
+#include "yb/util/concurrent_value.h"
 #include "yb/util/locks.h"
 #include "yb/util/metrics.h"
 #include "yb/util/status.h"
@@ -147,12 +149,16 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
   ThreadPool* tablet_prepare_pool() const { return tablet_prepare_pool_.get(); }
   ThreadPool* raft_pool() const { return raft_pool_.get(); }
   ThreadPool* read_pool() const { return read_pool_.get(); }
+  ThreadPool* open_tablet_pool() const { return open_tablet_pool_.get(); }
 
   // Create a new tablet and register it with the tablet manager. The new tablet
   // is persisted on disk and opened before this method returns.
   //
   // If tablet_peer is non-NULL, the newly created tablet will be returned.
   //
+  // If initial_leader_uuid is not empty, only the peer with this uuid starts an election right
+  // after the tablet is opened, other peers wait for the regular election timeout.
+  //
   // If another tablet already exists with this ID, logs a DFATAL
   // and returns a bad Status.
   CHECKED_STATUS CreateNewTablet(
@@ -164,7 +170,8 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
     const Schema &schema,
     const PartitionSchema &partition_schema,
     consensus::RaftConfigPB config,
-    scoped_refptr<tablet::TabletPeer> *tablet_peer);
+    scoped_refptr<tablet::TabletPeer> *tablet_peer,
+    const std::string& initial_leader_uuid = std::string());
 
   // Delete the specified tablet.
   // 'delete_type' must be one of TABLET_DATA_DELETED or TABLET_DATA_TOMBSTONED
@@ -181,10 +188,11 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
 
   // Lookup the given tablet peer by its ID.
   // Returns true if the tablet is found successfully.
+  // Reads the published snapshot of the tablet map, so it does not acquire any lock.
   bool LookupTablet(const std::string& tablet_id,
                     scoped_refptr<tablet::TabletPeer>* tablet_peer) const;
 
-  // Same as LookupTablet but doesn't acquired the shared lock.
+  // Looks up the tablet map itself, requires lock_ to be held.
   bool LookupTabletUnlocked(const std::string& tablet_id,
                             scoped_refptr<tablet::TabletPeer>* tablet_peer) const;
 
@@ -268,6 +276,19 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
                             const std::string& data_root_dir,
                             const std::string& wal_root_dir);
 
+  // Measures bytes of tablet data in the data directories, used to place new tablets. Returns
+  // bytes of each tablet.
+  std::unordered_map<TabletId, uint64_t> MeasureDataDirs(
+      const std::vector<scoped_refptr<tablet::TabletMetadata>>& metas);
+
+  // Moves tablets from the data directories with the most bytes to the ones with the least, see
+  // --rebalance_data_dirs_on_startup. Only used on startup, before tablets are opened.
+  void RebalanceDataDirs(const std::vector<scoped_refptr<tablet::TabletMetadata>>& metas,
+                         std::unordered_map<TabletId, uint64_t>* tablet_bytes);
+
+  // Copies RocksDB data of the tablet to data_root_dir, and switches the tablet to the copy.
+  CHECKED_STATUS MoveTabletData(tablet::TabletMetadata* meta, const std::string& data_root_dir);
+
   bool IsTabletInTransition(const std::string& tablet_id) const;
 
   TabletServer* server() { return server_; }
@@ -325,8 +346,18 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
   // method. A TransitionInProgressDeleter must be passed as 'deleter' into
   // this method in order to remove that transition-in-progress entry when
   // opening the tablet is complete (in either a success or a failure case).
+  //
+  // initial_leader_uuid is passed to consensus, see CreateNewTablet.
   void OpenTablet(const scoped_refptr<tablet::TabletMetadata>& meta,
-                  const scoped_refptr<TransitionInProgressDeleter>& deleter);
+                  const scoped_refptr<TransitionInProgressDeleter>& deleter,
+                  const std::string& initial_leader_uuid);
+
+  // Queues warm up of table readers of a started tablet, see --warm_up_table_readers.
+  void ScheduleTableReadersWarmUp(const scoped_refptr<tablet::TabletPeer>& tablet_peer);
+
+  // Warms up table readers of one of the queued tablets. Tablets that are already leaders are
+  // picked first, because they get reads before followers.
+  void WarmUpNextTableReaders();
 
   // Open a tablet whose metadata has already been loaded.
   void BootstrapAndInitTablet(const scoped_refptr<tablet::TabletMetadata>& meta,
@@ -343,6 +374,11 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
                       const scoped_refptr<tablet::TabletPeer>& tablet_peer,
                       RegisterTabletPeerMode mode);
 
+  // Publishes the current content of tablet_map_ to tablet_map_snapshot_. Should be invoked
+  // without holding lock_ after every change of tablet_map_. Concurrent invocations are batched,
+  // i.e. the copy made by one of them could contain changes made by the others.
+  void UpdateTabletMapSnapshot();
+
   // Create and register a new TabletPeer, given tablet metadata.
   // Calls RegisterTablet() with the given 'mode' parameter after constructing
   // the TablerPeer object. See RegisterTablet() for details about the
@@ -367,7 +403,8 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
   // TABLET_DATA_READY state. Generally, we tombstone the replica.
   CHECKED_STATUS HandleNonReadyTabletOnStartup(const scoped_refptr<tablet::TabletMetadata>& meta);
 
-  // Return the tablet with oldest write still in its memstore
+  // Return the tablet with oldest write still in its memstore, or with the largest active
+  // memtables if FLAGS_global_memstore_flush_largest_tablet is set.
   scoped_refptr<tablet::TabletPeer> TabletToFlush();
 
   TSTabletManagerStatePB state() const {
@@ -401,9 +438,25 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
   // Map from tablet ID to tablet
   TabletMap tablet_map_;
 
+  // Incremented on every change of tablet_map_, protected by lock_.
+  uint64_t tablet_map_version_ = 0;
+
+  // Read-only copy of tablet_map_ used by LookupTablet, which is invoked for every RPC to a
+  // tablet. It is published with UpdateTabletMapSnapshot after tablet_map_ is changed.
+  mutable ConcurrentValue<TabletMap> tablet_map_snapshot_;
+
+  // Serializes publishing of tablet_map_snapshot_.
+  std::mutex tablet_map_snapshot_mutex_;
+
+  // Version of tablet_map_ contained in tablet_map_snapshot_, protected by
+  // tablet_map_snapshot_mutex_.
+  uint64_t tablet_map_snapshot_version_ = 0;
+
   // Map from table ID to count of children in data and wal directories.
   TableDiskAssignmentMap table_data_assignment_map_;
   TableDiskAssignmentMap table_wal_assignment_map_;
+  // Bytes of tablet data in data directories, measured on startup.
+  std::unordered_map<std::string, uint64_t> data_root_dir_bytes_;
   mutable Mutex dir_assignment_lock_;
 
   // Map of tablet ids -> reason strings where the keys are tablets whose
@@ -437,6 +490,21 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
   // Thread pool for read ops, that are run in parallel, shared between all tablets.
   std::unique_ptr<ThreadPool> read_pool_;
 
+  // Thread pool for appending to tablet logs, shared between all tablets. Null when each log
+  // uses a dedicated append thread.
+  std::unique_ptr<ThreadPool> append_pool_;
+
+  // Thread pool for background deletion of applied intents, shared between all tablets.
+  std::unique_ptr<ThreadPool> intents_cleanup_pool_;
+
+  // Thread pool for opening table readers of started tablets in background. Null when
+  // --warm_up_table_readers is disabled.
+  std::unique_ptr<ThreadPool> warm_up_pool_;
+
+  std::mutex warm_up_mutex_;
+  // Started tablets whose table readers were not warmed up yet.
+  std::vector<scoped_refptr<tablet::TabletPeer>> tablets_to_warm_up_;
+
   // Used for scheduling flushes
   std::unique_ptr<BackgroundTask> background_task_;
 
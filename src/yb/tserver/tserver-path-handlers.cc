@@ -41,6 +41,7 @@
 
 #include "yb/consensus/log_anchor_registry.h"
 #include "yb/consensus/quorum_util.h"
+#include "yb/docdb/doc_key.h"
 #include "yb/gutil/map-util.h"
 #include "yb/gutil/strings/human_readable.h"
 #include "yb/gutil/strings/join.h"
@@ -79,6 +80,12 @@ using strings::Substitute;
 
 using namespace std::placeholders;  // NOLINT(build/namespaces)
 
+namespace {
+
+const size_t kMaxHotKeysToDisplay = 20;
+
+} // namespace
+
 TabletServerPathHandlers::~TabletServerPathHandlers() {
 }
 
@@ -351,6 +358,21 @@ void TabletServerPathHandlers::HandleTabletPage(const Webserver::WebRequest& req
 
   // End list
   *output << "</ul>\n";
+
+  shared_ptr<Tablet> tablet = peer->shared_tablet();
+  if (!tablet) {
+    return;
+  }
+  *output << "<h2>Hot Keys</h2>\n";
+  *output << "<table class='table table-striped'>\n";
+  *output << "  <tr><th>Key</th><th>Sampled accesses</th><th>Max overcount</th>"
+          << "<th>Share</th></tr>\n";
+  for (const auto& hot_key : tablet->hot_keys().TopKeys(kMaxHotKeysToDisplay)) {
+    *output << Substitute("  <tr><td>$0</td><td>$1</td><td>$2</td><td>$3%</td></tr>\n",
+                          EscapeForHtmlToString(docdb::BestEffortDocDBKeyToStr(Slice(hot_key.key))),
+                          hot_key.count, hot_key.error, StringPrintf("%.1f", hot_key.share * 100));
+  }
+  *output << "</table>\n";
 }
 
 void TabletServerPathHandlers::HandleTabletSVGPage(const Webserver::WebRequest& req,
@@ -429,6 +451,7 @@ void TabletServerPathHandlers::HandleMaintenanceManagerPage(const Webserver::Web
   int ops_count = pb.registered_operations_size();
 
   *output << "<h1>Maintenance Manager state</h1>\n";
+  *output << "<p>Scheduler decision: " << EscapeForHtmlToString(pb.last_decision()) << "</p>\n";
   *output << "<h3>Running operations</h3>\n";
   *output << "<table class='table table-striped'>\n";
   *output << "  <tr><th>Name</th><th>Instances running</th></tr>\n";
@@ -459,16 +482,20 @@ void TabletServerPathHandlers::HandleMaintenanceManagerPage(const Webserver::Web
   *output << "<h3>Non-running operations</h3>\n";
   *output << "<table class='table table-striped'>\n";
   *output << "  <tr><th>Name</th><th>Runnable</th><th>RAM anchored</th>\n"
-          << "       <th>Logs retained</th><th>Perf</th></tr>\n";
+          << "       <th>Logs retained</th><th>Perf</th><th>Average duration</th></tr>\n";
   for (int i = 0; i < ops_count; i++) {
     MaintenanceManagerStatusPB_MaintenanceOpPB op_pb = pb.registered_operations(i);
     if (op_pb.running() == 0) {
-      *output << Substitute("<tr><td>$0</td><td>$1</td><td>$2</td><td>$3</td><td>$4</td></tr>\n",
-                            EscapeForHtmlToString(op_pb.name()),
-                            op_pb.runnable(),
-                            HumanReadableNumBytes::ToString(op_pb.ram_anchored_bytes()),
-                            HumanReadableNumBytes::ToString(op_pb.logs_retained_bytes()),
-                            op_pb.perf_improvement());
+      *output << Substitute(
+          "<tr><td>$0</td><td>$1</td><td>$2</td><td>$3</td><td>$4</td><td>$5</td></tr>\n",
+          EscapeForHtmlToString(op_pb.name()),
+          op_pb.runnable(),
+          HumanReadableNumBytes::ToString(op_pb.ram_anchored_bytes()),
+          HumanReadableNumBytes::ToString(op_pb.logs_retained_bytes()),
+          op_pb.perf_improvement(),
+          op_pb.has_average_duration_millis()
+              ? HumanReadableElapsedTime::ToShortString(op_pb.average_duration_millis() / 1000.0)
+              : "N/A");
     }
   }
   *output << "</table>\n";
@@ -143,6 +143,22 @@ class BlockingQueue {
     }
   }
 
+  // Get all elements from the queue and append them to a vector, without waiting when the queue
+  // is empty.
+  void DrainTo(std::vector<T>* out) {
+    MutexLock l(lock_);
+    if (list_.empty()) {
+      return;
+    }
+    out->reserve(out->size() + list_.size());
+    for (const T& elt : list_) {
+      out->push_back(elt);
+      decrement_size_unlocked(elt);
+    }
+    list_.clear();
+    not_full_.Signal();
+  }
+
   // Attempts to put the given value in the queue.
   // Returns:
   //   QUEUE_SUCCESS: if successfully inserted
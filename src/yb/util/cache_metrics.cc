@@ -32,6 +32,7 @@
 
 #include "yb/util/cache_metrics.h"
 
+#include "yb/util/enums.h"
 #include "yb/util/metrics.h"
 
 METRIC_DEFINE_counter(server, block_cache_inserts,
@@ -71,21 +72,65 @@ METRIC_DEFINE_gauge_uint64(server, block_cache_multi_touch_usage,
                            "Multi Cache Block Cache Memory Usage",
                            yb::MetricUnit::kBytes,
                            "Memory consumed by the multi cache block cache");
+
+METRIC_DEFINE_counter(server, nvm_block_cache_inserts,
+                      "NVM Block Cache Inserts", yb::MetricUnit::kBlocks,
+                      "Number of blocks inserted in the NVM cache");
+METRIC_DEFINE_counter(server, nvm_block_cache_lookups,
+                      "NVM Block Cache Lookups", yb::MetricUnit::kBlocks,
+                      "Number of blocks looked up from the NVM cache");
+METRIC_DEFINE_counter(server, nvm_block_cache_evictions,
+                      "NVM Block Cache Evictions", yb::MetricUnit::kBlocks,
+                      "Number of blocks evicted from the NVM cache");
+METRIC_DEFINE_counter(server, nvm_block_cache_misses,
+                      "NVM Block Cache Misses", yb::MetricUnit::kBlocks,
+                      "Number of lookups that didn't yield a block from the NVM cache");
+METRIC_DEFINE_counter(server, nvm_block_cache_misses_caching,
+                      "NVM Block Cache Misses (Caching)", yb::MetricUnit::kBlocks,
+                      "Number of lookups that were expecting a block that didn't yield one from "
+                      "the NVM cache");
+METRIC_DEFINE_counter(server, nvm_block_cache_hits,
+                      "NVM Block Cache Hits", yb::MetricUnit::kBlocks,
+                      "Number of lookups that found a block in the NVM cache");
+METRIC_DEFINE_counter(server, nvm_block_cache_hits_caching,
+                      "NVM Block Cache Hits (Caching)", yb::MetricUnit::kBlocks,
+                      "Number of lookups that were expecting a block that found one in the NVM "
+                      "cache");
+
+METRIC_DEFINE_gauge_uint64(server, nvm_block_cache_usage, "NVM Block Cache Memory Usage",
+                           yb::MetricUnit::kBytes,
+                           "Memory consumed by the NVM block cache");
+
 namespace yb {
 
-#define MINIT(member, x) member(METRIC_##x.Instantiate(entity))
-#define GINIT(member, x) member(METRIC_##x.Instantiate(entity, 0))
-CacheMetrics::CacheMetrics(const scoped_refptr<MetricEntity>& entity)
-  : MINIT(inserts, block_cache_inserts),
-    MINIT(lookups, block_cache_lookups),
-    MINIT(evictions, block_cache_evictions),
-    MINIT(cache_hits, block_cache_hits),
-    MINIT(cache_hits_caching, block_cache_hits_caching),
-    MINIT(cache_misses, block_cache_misses),
-    MINIT(cache_misses_caching, block_cache_misses_caching),
-    GINIT(cache_usage, block_cache_usage),
-    GINIT(single_touch_cache_usage, block_cache_single_touch_usage),
-    GINIT(multi_touch_cache_usage, block_cache_multi_touch_usage) {
+#define MINIT(member, x) member = METRIC_##x.Instantiate(entity)
+#define GINIT(member, x) member = METRIC_##x.Instantiate(entity, 0)
+CacheMetrics::CacheMetrics(const scoped_refptr<MetricEntity>& entity, CacheType cache_type) {
+  switch (cache_type) {
+    case DRAM_CACHE:
+      MINIT(inserts, block_cache_inserts);
+      MINIT(lookups, block_cache_lookups);
+      MINIT(evictions, block_cache_evictions);
+      MINIT(cache_hits, block_cache_hits);
+      MINIT(cache_hits_caching, block_cache_hits_caching);
+      MINIT(cache_misses, block_cache_misses);
+      MINIT(cache_misses_caching, block_cache_misses_caching);
+      GINIT(cache_usage, block_cache_usage);
+      GINIT(single_touch_cache_usage, block_cache_single_touch_usage);
+      GINIT(multi_touch_cache_usage, block_cache_multi_touch_usage);
+      return;
+    case NVM_CACHE:
+      MINIT(inserts, nvm_block_cache_inserts);
+      MINIT(lookups, nvm_block_cache_lookups);
+      MINIT(evictions, nvm_block_cache_evictions);
+      MINIT(cache_hits, nvm_block_cache_hits);
+      MINIT(cache_hits_caching, nvm_block_cache_hits_caching);
+      MINIT(cache_misses, nvm_block_cache_misses);
+      MINIT(cache_misses_caching, nvm_block_cache_misses_caching);
+      GINIT(cache_usage, nvm_block_cache_usage);
+      return;
+  }
+  FATAL_INVALID_ENUM_VALUE(CacheType, cache_type);
 }
 #undef MINIT
 #undef GINIT
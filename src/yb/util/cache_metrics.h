@@ -36,6 +36,7 @@
 
 #include "yb/gutil/macros.h"
 #include "yb/gutil/ref_counted.h"
+#include "yb/util/cache.h"
 
 namespace yb {
 
@@ -45,7 +46,9 @@ class Counter;
 class MetricEntity;
 
 struct CacheMetrics {
-  explicit CacheMetrics(const scoped_refptr<MetricEntity>& metric_entity);
+  // NVM cache has its own set of metrics, so it could be used together with DRAM cache.
+  explicit CacheMetrics(const scoped_refptr<MetricEntity>& metric_entity,
+                        CacheType cache_type = DRAM_CACHE);
 
   scoped_refptr<Counter> inserts;
   scoped_refptr<Counter> lookups;
@@ -56,6 +59,7 @@ struct CacheMetrics {
   scoped_refptr<Counter> cache_misses_caching;
 
   scoped_refptr<AtomicGauge<uint64_t> > cache_usage;
+  // Single touch and multi touch usage is only tracked by DRAM cache.
   scoped_refptr<AtomicGauge<uint64_t> > single_touch_cache_usage;
   scoped_refptr<AtomicGauge<uint64_t> > multi_touch_cache_usage;
 };
@@ -0,0 +1,97 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "yb/gutil/sysinfo.h"
+
+#include "yb/util/continuous_profiler.h"
+#include "yb/util/debug-util.h"
+#include "yb/util/test_util.h"
+
+DECLARE_bool(enable_continuous_profiling);
+DECLARE_int32(continuous_profiling_thread_pool_sample_every);
+
+namespace yb {
+
+class ContinuousProfilerTest : public YBTest {
+ protected:
+  void SetUp() override {
+    YBTest::SetUp();
+    InitContinuousProfiling();
+    FLAGS_enable_continuous_profiling = true;
+    ASSERT_OK(WaitFor([] { return ContinuousProfilingEnabled(); }, MonoDelta::FromSeconds(10),
+                      "Continuous profiling enabled"));
+  }
+
+  void TearDown() override {
+    FLAGS_enable_continuous_profiling = false;
+    YBTest::TearDown();
+  }
+
+  std::string Dump(ProfileSampleType type) {
+    std::stringstream out;
+    DumpContinuousProfile(type, 3600, &out);
+    return out.str();
+  }
+
+  // Returns the sum of values of all stacks in the folded profile.
+  int64_t TotalValue(const std::string& profile) {
+    std::istringstream in(profile);
+    std::string line;
+    int64_t result = 0;
+    while (std::getline(in, line)) {
+      result += std::stoll(line.substr(line.rfind(' ') + 1));
+    }
+    return result;
+  }
+};
+
+TEST_F(ContinuousProfilerTest, LockWait) {
+  StackTrace stack;
+  stack.Collect();
+  // One second.
+  RecordLockWait(stack, static_cast<int64_t>(base::CyclesPerSecond()));
+  auto profile = Dump(ProfileSampleType::kLockWait);
+  LOG(INFO) << "Lock wait profile: " << profile;
+  // The value is in microseconds.
+  ASSERT_GE(TotalValue(profile), 999999);
+
+  // Samples are kept in windows after being collected from the table by the previous dump.
+  ASSERT_GE(TotalValue(Dump(ProfileSampleType::kLockWait)), 999999);
+}
+
+TEST_F(ContinuousProfilerTest, ThreadPoolQueueTime) {
+  FLAGS_continuous_profiling_thread_pool_sample_every = 1;
+  RecordThreadPoolQueueTime("test_pool", 100);
+  RecordThreadPoolQueueTime("test_pool", 200);
+  ASSERT_STR_CONTAINS(Dump(ProfileSampleType::kThreadPoolQueue), "thread_pool;test_pool 300\n");
+}
+
+#if defined(__linux__)
+TEST_F(ContinuousProfilerTest, Cpu) {
+  volatile uint64_t counter = 0;
+  ASSERT_OK(WaitFor([this, &counter] {
+    // Burn some CPU, so the process CPU time timer fires.
+    for (int i = 0; i != 10000000; ++i) {
+      counter = counter + i;
+    }
+    return !Dump(ProfileSampleType::kCpu).empty();
+  }, MonoDelta::FromSeconds(30), "CPU samples collected"));
+}
+#endif
+
+} // namespace yb
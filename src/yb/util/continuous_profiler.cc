@@ -0,0 +1,407 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/continuous_profiler.h"
+
+#include <errno.h>
+#include <signal.h>
+#include <string.h>
+#include <time.h>
+
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "yb/gutil/once.h"
+#include "yb/gutil/strings/numbers.h"
+#include "yb/gutil/sysinfo.h"
+#include "yb/gutil/walltime.h"
+
+#include "yb/util/debug-util.h"
+#include "yb/util/flag_tags.h"
+#include "yb/util/locks.h"
+#include "yb/util/logging.h"
+#include "yb/util/monotime.h"
+#include "yb/util/stack_trace_table.h"
+#include "yb/util/thread.h"
+
+DEFINE_bool(enable_continuous_profiling, false,
+            "Whether the continuous profiler collects CPU samples, lock waits and thread pool "
+            "queue times. Collected profiles are available at /pprof/continuous.");
+TAG_FLAG(enable_continuous_profiling, advanced);
+TAG_FLAG(enable_continuous_profiling, runtime);
+
+DEFINE_int32(continuous_profiling_cpu_sampling_hz, 100,
+             "Number of CPU samples per second of process CPU time collected by the continuous "
+             "profiler. Applied when continuous profiling is enabled.");
+TAG_FLAG(continuous_profiling_cpu_sampling_hz, advanced);
+TAG_FLAG(continuous_profiling_cpu_sampling_hz, runtime);
+
+DEFINE_int32(continuous_profiling_window_sec, 60,
+             "Duration of a single window of the continuous profiler.");
+TAG_FLAG(continuous_profiling_window_sec, advanced);
+TAG_FLAG(continuous_profiling_window_sec, runtime);
+
+DEFINE_int32(continuous_profiling_num_windows, 10,
+             "Number of the most recent windows kept by the continuous profiler.");
+TAG_FLAG(continuous_profiling_num_windows, advanced);
+TAG_FLAG(continuous_profiling_num_windows, runtime);
+
+DEFINE_int32(continuous_profiling_lock_wait_threshold_us, 10,
+             "Lock waits shorter than this are not recorded by the continuous profiler.");
+TAG_FLAG(continuous_profiling_lock_wait_threshold_us, advanced);
+TAG_FLAG(continuous_profiling_lock_wait_threshold_us, runtime);
+
+DEFINE_int32(continuous_profiling_thread_pool_sample_every, 100,
+             "The continuous profiler records queue time of every N-th thread pool task.");
+TAG_FLAG(continuous_profiling_thread_pool_sample_every, advanced);
+TAG_FLAG(continuous_profiling_thread_pool_sample_every, runtime);
+
+// GLog already implements symbolization. Just import their hidden symbol.
+namespace google {
+// Symbolizes a program counter.  On success, returns true and write the
+// symbol name to "out".  The symbol name is demangled if possible
+// (supports symbols generated by GCC 3.x or newer).  Otherwise,
+// returns false.
+bool Symbolize(void *pc, char *out, int out_size);
+}
+
+namespace yb {
+
+namespace {
+
+const double kMicrosPerSecond = 1000000.0;
+
+int64_t CyclesToMicros(int64_t cycles) {
+  return static_cast<int64_t>(cycles / base::CyclesPerSecond() * kMicrosPerSecond);
+}
+
+struct AggregatedSample {
+  StackTrace stack;
+  int64_t value;
+};
+
+struct ProfileWindow {
+  MonoTime end;
+  std::vector<AggregatedSample> samples[kProfileSampleTypeMapSize];
+  std::unordered_map<std::string, int64_t> thread_pool_queue_us;
+};
+
+class ContinuousProfiler {
+ public:
+  ContinuousProfiler() : window_start_(MonoTime::Now()) {}
+
+  void Start();
+
+  bool enabled() const {
+    return enabled_.load(std::memory_order_acquire);
+  }
+
+  // Could be invoked from a signal handler.
+  void AddStack(ProfileSampleType type, const StackTrace& stack, int64_t value) {
+    tables_[static_cast<size_t>(type)].AddStack(stack, value);
+  }
+
+  void AddThreadPoolQueueTime(const std::string& pool_name, int64_t queue_time_us) {
+    std::lock_guard<simple_spinlock> lock(thread_pools_lock_);
+    thread_pool_queue_us_[pool_name] += queue_time_us;
+  }
+
+  void Dump(ProfileSampleType type, int seconds, std::ostream* out);
+
+ private:
+  void Run();
+
+  // Moves samples collected since the previous rotation to a new window.
+  void Rotate(const std::lock_guard<std::mutex>& lock);
+
+  void UpdateCpuTimer(bool enable);
+
+  std::atomic<bool> enabled_{false};
+  StackTraceTable tables_[kProfileSampleTypeMapSize];
+
+  simple_spinlock thread_pools_lock_;
+  std::unordered_map<std::string, int64_t> thread_pool_queue_us_;
+
+  std::mutex windows_mutex_;
+  MonoTime window_start_;
+  std::deque<ProfileWindow> windows_;
+
+  // Accessed only by the profiler thread.
+  bool cpu_timer_created_ = false;
+  bool cpu_timer_armed_ = false;
+#if defined(__linux__)
+  timer_t cpu_timer_;
+#endif
+
+  scoped_refptr<Thread> thread_;
+};
+
+std::atomic<ContinuousProfiler*> g_profiler{nullptr};
+
+ContinuousProfiler* Profiler() {
+  return g_profiler.load(std::memory_order_acquire);
+}
+
+// Real time signal, so it does not conflict with SIGPROF used by gperftools for on-demand CPU
+// profiles, and with SIGUSR2 used for stack traces.
+int CpuProfilingSignal() {
+  return SIGRTMIN + 3;
+}
+
+void HandleCpuProfilingSignal(int signum) {
+  int saved_errno = errno;
+  auto* profiler = Profiler();
+  if (profiler && profiler->enabled()) {
+    StackTrace stack;
+    // Skip this handler and the signal trampoline.
+    stack.Collect(2);
+    profiler->AddStack(ProfileSampleType::kCpu, stack, 1);
+  }
+  errno = saved_errno;
+}
+
+void ContinuousProfiler::Start() {
+  WARN_NOT_OK(Thread::Create("profiler", "continuous_profiler", &ContinuousProfiler::Run, this,
+                             &thread_),
+              "Failed to start continuous profiler");
+}
+
+void ContinuousProfiler::Run() {
+  for (;;) {
+    const bool enable = FLAGS_enable_continuous_profiling;
+    enabled_.store(enable, std::memory_order_release);
+    UpdateCpuTimer(enable);
+    // Windows are not rotated while profiling is disabled, so samples collected before disabling
+    // it are kept to be investigated.
+    if (enable) {
+      std::lock_guard<std::mutex> lock(windows_mutex_);
+      if (MonoTime::Now() - window_start_ >=
+              MonoDelta::FromSeconds(FLAGS_continuous_profiling_window_sec)) {
+        Rotate(lock);
+      }
+    }
+    SleepFor(MonoDelta::FromSeconds(1));
+  }
+}
+
+void ContinuousProfiler::Rotate(const std::lock_guard<std::mutex>& lock) {
+  ProfileWindow window;
+  window.end = MonoTime::Now();
+  for (auto type : {ProfileSampleType::kCpu, ProfileSampleType::kLockWait}) {
+    auto& table = tables_[static_cast<size_t>(type)];
+    auto& samples = window.samples[static_cast<size_t>(type)];
+    uint64_t iterator = 0;
+    AggregatedSample sample;
+    int64_t trip_count;
+    while (table.CollectSample(&iterator, &sample.stack, &trip_count, &sample.value)) {
+      samples.push_back(sample);
+    }
+    auto dropped = table.TakeDroppedSamples();
+    YB_LOG_IF_EVERY_N(INFO, dropped != 0, 100)
+        << "Continuous profiler dropped " << dropped << " " << ToString(type) << " samples";
+  }
+  {
+    std::lock_guard<simple_spinlock> thread_pools_lock(thread_pools_lock_);
+    window.thread_pool_queue_us.swap(thread_pool_queue_us_);
+  }
+  windows_.push_back(std::move(window));
+  while (windows_.size() > std::max<size_t>(FLAGS_continuous_profiling_num_windows, 1)) {
+    windows_.pop_front();
+  }
+  window_start_ = windows_.back().end;
+}
+
+void ContinuousProfiler::UpdateCpuTimer(bool enable) {
+#if defined(__linux__)
+  if (enable == cpu_timer_armed_) {
+    return;
+  }
+  if (enable && !cpu_timer_created_) {
+    struct sigaction act;
+    memset(&act, 0, sizeof(act));
+    act.sa_handler = &HandleCpuProfilingSignal;
+    act.sa_flags = SA_RESTART;
+    sigemptyset(&act.sa_mask);
+    PCHECK(sigaction(CpuProfilingSignal(), &act, nullptr) == 0);
+
+    struct sigevent event;
+    memset(&event, 0, sizeof(event));
+    event.sigev_notify = SIGEV_SIGNAL;
+    event.sigev_signo = CpuProfilingSignal();
+    if (timer_create(CLOCK_PROCESS_CPUTIME_ID, &event, &cpu_timer_) != 0) {
+      PLOG(WARNING) << "Failed to create CPU profiling timer";
+      return;
+    }
+    cpu_timer_created_ = true;
+  }
+  if (!cpu_timer_created_) {
+    return;
+  }
+
+  struct itimerspec spec;
+  memset(&spec, 0, sizeof(spec));
+  if (enable) {
+    const int64_t interval_ns =
+        1000000000LL / std::max(FLAGS_continuous_profiling_cpu_sampling_hz, 1);
+    spec.it_interval.tv_sec = interval_ns / 1000000000LL;
+    spec.it_interval.tv_nsec = interval_ns % 1000000000LL;
+    spec.it_value = spec.it_interval;
+  }
+  if (timer_settime(cpu_timer_, 0, &spec, nullptr) != 0) {
+    PLOG(WARNING) << "Failed to " << (enable ? "arm" : "disarm") << " CPU profiling timer";
+    return;
+  }
+  LOG(INFO) << "Continuous CPU profiling " << (enable ? "started" : "stopped");
+  cpu_timer_armed_ = enable;
+#endif
+}
+
+std::string FoldedStack(const StackTrace& stack,
+                        std::unordered_map<void*, std::string>* symbol_cache) {
+  std::string result;
+  for (int i = stack.num_frames(); i-- > 0;) {
+    // Frames contain return addresses, so subtract 1 to point into the call instruction.
+    void* pc = reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(stack.frame(i)) - 1);
+    auto it = symbol_cache->find(pc);
+    if (it == symbol_cache->end()) {
+      char buffer[1024];
+      std::string symbol;
+      if (google::Symbolize(pc, buffer, sizeof(buffer))) {
+        symbol = buffer;
+        // ';' separates frames in the folded format.
+        std::replace(symbol.begin(), symbol.end(), ';', ',');
+      } else {
+        char hex[kFastToBufferSize];
+        symbol = FastHex64ToBuffer(reinterpret_cast<uintptr_t>(pc), hex);
+      }
+      it = symbol_cache->emplace(pc, std::move(symbol)).first;
+    }
+    if (!result.empty()) {
+      result += ';';
+    }
+    result += it->second;
+  }
+  return result;
+}
+
+void ContinuousProfiler::Dump(ProfileSampleType type, int seconds, std::ostream* out) {
+  std::vector<AggregatedSample> samples;
+  std::map<std::string, int64_t> folded;
+  {
+    std::lock_guard<std::mutex> lock(windows_mutex_);
+    // Samples of the current window are also included.
+    Rotate(lock);
+    const MonoTime now = MonoTime::Now();
+    for (const auto& window : windows_) {
+      if ((now - window.end).ToSeconds() > seconds) {
+        continue;
+      }
+      if (type == ProfileSampleType::kThreadPoolQueue) {
+        for (const auto& pool_and_time : window.thread_pool_queue_us) {
+          folded["thread_pool;" + pool_and_time.first] += pool_and_time.second;
+        }
+      } else {
+        const auto& window_samples = window.samples[static_cast<size_t>(type)];
+        samples.insert(samples.end(), window_samples.begin(), window_samples.end());
+      }
+    }
+  }
+
+  // Symbolization is slow, so it is done without holding the lock.
+  std::unordered_map<void*, std::string> symbol_cache;
+  for (const auto& sample : samples) {
+    folded[FoldedStack(sample.stack, &symbol_cache)] += sample.value;
+  }
+  for (const auto& stack_and_value : folded) {
+    *out << stack_and_value.first << " " << stack_and_value.second << "\n";
+  }
+}
+
+void DoInitContinuousProfiling() {
+  auto* profiler = new ContinuousProfiler;
+  g_profiler.store(profiler, std::memory_order_release);
+  profiler->Start();
+}
+
+} // namespace
+
+void InitContinuousProfiling() {
+  static GoogleOnceType once = GOOGLE_ONCE_INIT;
+  GoogleOnceInit(&once, DoInitContinuousProfiling);
+}
+
+bool ContinuousProfilingEnabled() {
+  auto* profiler = Profiler();
+  return profiler && profiler->enabled();
+}
+
+void RecordLockWait(const StackTrace& stack, int64_t wait_cycles) {
+  auto* profiler = Profiler();
+  if (!profiler || !profiler->enabled()) {
+    return;
+  }
+  const int64_t wait_us = CyclesToMicros(wait_cycles);
+  if (wait_us >= FLAGS_continuous_profiling_lock_wait_threshold_us) {
+    profiler->AddStack(ProfileSampleType::kLockWait, stack, wait_us);
+  }
+}
+
+void RecordLockWait(int64_t wait_cycles) {
+  if (!ContinuousProfilingEnabled() ||
+      CyclesToMicros(wait_cycles) < FLAGS_continuous_profiling_lock_wait_threshold_us) {
+    return;
+  }
+  StackTrace stack;
+  stack.Collect(2);
+  RecordLockWait(stack, wait_cycles);
+}
+
+void RecordThreadPoolQueueTime(const std::string& pool_name, int64_t queue_time_us) {
+  auto* profiler = Profiler();
+  if (!profiler || !profiler->enabled()) {
+    return;
+  }
+  const int sample_every = std::max(FLAGS_continuous_profiling_thread_pool_sample_every, 1);
+  static __thread int counter = 0;
+  if (++counter < sample_every) {
+    return;
+  }
+  counter = 0;
+  // Scale the sample, so the aggregated value approximates the total queue time.
+  profiler->AddThreadPoolQueueTime(pool_name, queue_time_us * sample_every);
+}
+
+void DumpContinuousProfile(ProfileSampleType type, int seconds, std::ostream* out) {
+  InitContinuousProfiling();
+  Profiler()->Dump(type, seconds, out);
+}
+
+LockWaitRecorder::LockWaitRecorder()
+    : start_cycles_(ContinuousProfilingEnabled() ? CycleClock::Now() : 0) {
+}
+
+LockWaitRecorder::~LockWaitRecorder() {
+  if (start_cycles_ != 0) {
+    RecordLockWait(CycleClock::Now() - start_cycles_);
+  }
+}
+
+} // namespace yb
@@ -0,0 +1,79 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_CONTINUOUS_PROFILER_H
+#define YB_UTIL_CONTINUOUS_PROFILER_H
+
+#include <atomic>
+#include <iosfwd>
+#include <string>
+
+#include "yb/util/enums.h"
+
+namespace yb {
+
+class StackTrace;
+
+// Continuous profiler keeps samples aggregated by stack for the last
+// --continuous_profiling_num_windows windows of --continuous_profiling_window_sec each, so hot spots
+// could be investigated after the fact. It is enabled by the runtime flag
+// --enable_continuous_profiling, so it could be turned on without restarting the process.
+//
+// Collected sample types:
+// kCpu - stacks sampled by a process CPU time timer, value is the number of samples.
+// kLockWait - stacks of threads that waited for a lock, including contended spinlocks and waits
+//             instrumented with LockWaitRecorder, value is the wait time in microseconds.
+// kThreadPoolQueue - sampled time that tasks spent in thread pool queues, value is the queue time
+//                    in microseconds, aggregated by thread pool name.
+YB_DEFINE_ENUM(ProfileSampleType, (kCpu)(kLockWait)(kThreadPoolQueue));
+
+// Starts the background thread of the continuous profiler, which follows
+// --enable_continuous_profiling. Could be called multiple times, only the first call has effect.
+void InitContinuousProfiling();
+
+// Whether continuous profiling is currently enabled.
+bool ContinuousProfilingEnabled();
+
+// Records the stack of a thread that waited for a lock for 'wait_cycles'.
+void RecordLockWait(const StackTrace& stack, int64_t wait_cycles);
+
+// Same as above, but collects the stack of the current thread.
+void RecordLockWait(int64_t wait_cycles);
+
+// Records the time a task spent in the queue of the thread pool. Only every
+// --continuous_profiling_thread_pool_sample_every task is actually recorded.
+void RecordThreadPoolQueueTime(const std::string& pool_name, int64_t queue_time_us);
+
+// Writes samples of the specified type collected during the last 'seconds' in the folded stacks
+// format, i.e. one line per stack: frames from the outermost one separated by ';', followed by a
+// space and the aggregated value. This format is an input of flamegraph.pl and similar tools.
+void DumpContinuousProfile(ProfileSampleType type, int seconds, std::ostream* out);
+
+// Measures the time between its construction and destruction, and records it as a lock wait of
+// the current thread. Intended to wrap slow paths that block, e.g. waits on condition variables.
+class LockWaitRecorder {
+ public:
+  LockWaitRecorder();
+  ~LockWaitRecorder();
+
+  LockWaitRecorder(const LockWaitRecorder&) = delete;
+  void operator=(const LockWaitRecorder&) = delete;
+
+ private:
+  // 0 when profiling was not enabled at construction.
+  int64_t start_cycles_;
+};
+
+} // namespace yb
+
+#endif // YB_UTIL_CONTINUOUS_PROFILER_H
@@ -33,6 +33,7 @@
 #define YB_UTIL_COW_OBJECT_H
 
 #include <algorithm>
+#include <memory>
 
 #include <glog/logging.h>
 
@@ -240,5 +241,72 @@ class CowLock {
   DISALLOW_COPY_AND_ASSIGN(CowLock);
 };
 
+// A value, usually a container, that is replaced by a modified copy on every mutation, so readers
+// could take a consistent snapshot of it without any locking.
+//
+// Mutations should be serialized by the caller, e.g. by an exclusive lock. Readers that hold the
+// same lock in shared mode could access the current value directly, other readers should use
+// Snapshot().
+//
+// Example usage:
+//
+//   CowSnapshot<std::map<int, int>> map;
+//   {
+//     auto mutation = map.Mutate();
+//     (*mutation)[1] = 2;
+//   } // The modified copy is published here.
+//   auto snapshot = map.Snapshot();
+//   ... = snapshot->find(1);
+template<class T>
+class CowSnapshot {
+ public:
+  class Mutation {
+   public:
+    explicit Mutation(CowSnapshot<T>* owner)
+        : owner_(owner), value_(std::make_shared<T>(*owner->value_)) {}
+
+    Mutation(Mutation&& rhs) : owner_(rhs.owner_), value_(std::move(rhs.value_)) {
+      rhs.owner_ = nullptr;
+    }
+
+    ~Mutation() {
+      if (owner_) {
+        std::atomic_store(&owner_->value_, std::shared_ptr<const T>(std::move(value_)));
+      }
+    }
+
+    T& operator*() const { return *value_; }
+    T* operator->() const { return value_.get(); }
+
+   private:
+    CowSnapshot<T>* owner_;
+    std::shared_ptr<T> value_;
+
+    DISALLOW_COPY_AND_ASSIGN(Mutation);
+  };
+
+  CowSnapshot() : value_(std::make_shared<T>()) {}
+
+  // Access to the current value, could only be used while mutations are excluded.
+  const T& operator*() const { return *value_; }
+  const T* operator->() const { return value_.get(); }
+
+  // Returns the current value, that is not affected by later mutations.
+  std::shared_ptr<const T> Snapshot() const {
+    return std::atomic_load(&value_);
+  }
+
+  // Starts a mutation of a copy of the current value. The copy replaces the current value when
+  // the returned object is destroyed.
+  Mutation Mutate() {
+    return Mutation(this);
+  }
+
+ private:
+  std::shared_ptr<const T> value_;
+
+  DISALLOW_COPY_AND_ASSIGN(CowSnapshot);
+};
+
 } // namespace yb
 #endif /* YB_UTIL_COW_OBJECT_H */
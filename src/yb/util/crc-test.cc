@@ -33,6 +33,7 @@
 #include "yb/gutil/gscoped_ptr.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/util/crc.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/stopwatch.h"
 #include "yb/util/test_util.h"
 
@@ -40,6 +41,7 @@ namespace yb {
 namespace crc {
 
 using strings::Substitute;
+using namespace yb::size_literals; // NOLINT.
 
 class CrcTest : public YBTest {
  protected:
@@ -73,6 +75,47 @@ TEST_F(CrcTest, TestCRC32C) {
   ASSERT_EQ(0xa9421b7, data_crc); // Known value from crcutil usage test program.
 }
 
+// Crc32cExtend() should match crcutil for any length, alignment and split of the data.
+TEST_F(CrcTest, TestCrc32cExtend) {
+  ASSERT_EQ(0xe3069283, Crc32c("123456789", 9)); // Standard CRC32C check value.
+
+  std::string data(100000, 0);
+  for (size_t i = 0; i != data.size(); ++i) {
+    data[i] = static_cast<char>(i * 7 + (i >> 8));
+  }
+  Crc* crc32c = GetCrc32cInstance();
+  for (size_t offset = 0; offset != 9; ++offset) {
+    for (size_t length : {0, 1, 7, 8, 255, 767, 768, 769, 5000, 24575, 24576, 24577, 99000}) {
+      uint64_t expected = 0x1234;
+      crc32c->Compute(data.data() + offset, length, &expected);
+      ASSERT_EQ(expected, Crc32cExtend(0x1234, data.data() + offset, length))
+          << "offset: " << offset << ", length: " << length;
+      const size_t split = length / 3;
+      const uint32_t first = Crc32cExtend(0x1234, data.data() + offset, split);
+      ASSERT_EQ(expected, Crc32cExtend(first, data.data() + offset + split, length - split))
+          << "offset: " << offset << ", length: " << length;
+    }
+  }
+}
+
+// Throughput of Crc32c() for different buffer sizes.
+TEST_F(CrcTest, BenchmarkCrc32cSizes) {
+  LOG(INFO) << "Hardware CRC32C supported: " << IsHardwareCrc32cSupported();
+  const size_t kTotalBytes = AllowSlowTests() ? 16ULL << 30 : 1ULL << 30;
+  std::string data(1_MB, 'x');
+  for (size_t size : {size_t{64}, 4_KB, 64_KB, 1_MB}) {
+    uint32_t crc = 0;
+    Stopwatch sw;
+    sw.start();
+    for (size_t processed = 0; processed < kTotalBytes; processed += size) {
+      crc = Crc32cExtend(crc, data.data(), size);
+    }
+    sw.stop();
+    LOG(INFO) << Substitute("CRC32C of $0 bytes buffers: $1 MB/s (crc: $2)",
+                            size, kTotalBytes / 1_MB / sw.elapsed().wall_seconds(), crc);
+  }
+}
+
 // Simple benchmark of CRC32C throughput.
 // We should expect about 8 bytes per cycle in throughput on a single core.
 TEST_F(CrcTest, BenchmarkCRC32C) {
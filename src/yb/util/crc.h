@@ -48,6 +48,13 @@ Crc* GetCrc32cInstance();
 // Helper function to simply calculate a CRC32C of the given data.
 uint32_t Crc32c(const void* data, size_t length);
 
+// Returns the CRC32C of concat(A, data), where crc is the CRC32C of A. Uses the SSE4.2 or ARMv8
+// CRC32C instructions when the CPU has them, and crcutil otherwise.
+uint32_t Crc32cExtend(uint32_t crc, const void* data, size_t length);
+
+// Whether Crc32c() and Crc32cExtend() use CPU CRC32C instructions.
+bool IsHardwareCrc32cSupported();
+
 } // namespace crc
 } // namespace yb
 
@@ -167,6 +167,15 @@ class StackTrace {
 
   uint64_t HashCode() const;
 
+  int num_frames() const {
+    return num_frames_;
+  }
+
+  // Returns the i-th frame, frames are ordered from the innermost one.
+  void* frame(int i) const {
+    return frames_[i];
+  }
+
  private:
   enum {
     // The maximum number of stack frames to collect.
@@ -216,6 +216,27 @@ TEST_F(DecimalTest, TestVarIntConversions) {
   EXPECT_EQ("-8.71233726138962103701973e+23", Decimal(varint).ToString());
 }
 
+TEST_F(DecimalTest, TestArithmetic) {
+  EXPECT_EQ(Decimal("3.75"), Decimal("1.5") + Decimal("2.25"));
+  EXPECT_EQ(Decimal("-0.75"), Decimal("1.5") - Decimal("2.25"));
+  EXPECT_EQ(Decimal("0"), Decimal("1.5") - Decimal("1.5"));
+  EXPECT_EQ(Decimal("1.5"), Decimal("1.5") + Decimal("0"));
+  EXPECT_EQ(Decimal("-1.5"), Decimal("0") - Decimal("1.5"));
+  EXPECT_EQ(Decimal("1000.001"), Decimal("1e3") + Decimal("1e-3"));
+  EXPECT_EQ("[ + 10^+2 * 0.1 ]", (Decimal("9.5") + Decimal("0.5")).ToDebugString());
+
+  // Operands that overflow the int64 coefficients are added digit by digit.
+  EXPECT_EQ(Decimal("18446744073709551614"),
+            Decimal("9223372036854775807") + Decimal("9223372036854775807"));
+  EXPECT_EQ(Decimal("1e30"), Decimal("999999999999999999999999999999") + Decimal("1"));
+  EXPECT_EQ(Decimal("1e40"), Decimal("1e40") + Decimal("1e-40") - Decimal("1e-40"));
+  EXPECT_EQ(Decimal("1.0000000000000000000000000000000000000001e40"),
+            Decimal("1e40") + Decimal("1"));
+  EXPECT_EQ(Decimal("-2638.2e+3624"), Decimal("2638.2e+3624") - Decimal("5276.4e+3624"));
+  EXPECT_EQ(Decimal("1.2e-36546632732954564789"),
+            Decimal("1e-36546632732954564789") + Decimal("2e-36546632732954564790"));
+}
+
 TEST_F(DecimalTest, TestComparableEncoding) {
   std::vector<Decimal> test_decimals;
   std::vector<std::string> encoded_strings;
@@ -258,6 +258,103 @@ int Decimal::CompareTo(const Decimal &other) const {
   return is_positive_ ? comp : -comp;
 }
 
+namespace {
+
+constexpr size_t kMaxInt64Digits = 18;
+
+constexpr int64_t kPowersOf10[kMaxInt64Digits + 1] = {
+    1LL, 10LL, 100LL, 1000LL, 10000LL, 100000LL, 1000000LL, 10000000LL, 100000000LL,
+    1000000000LL, 10000000000LL, 100000000000LL, 1000000000000LL, 10000000000000LL,
+    100000000000000LL, 1000000000000000LL, 10000000000000000LL, 100000000000000000LL,
+    1000000000000000000LL };
+
+}  // namespace
+
+bool Decimal::AddInt64(const Decimal& other, Decimal* result) const {
+  if (digits_.size() > kMaxInt64Digits || other.digits_.size() > kMaxInt64Digits) {
+    return false;
+  }
+  // The value is coefficient * 10^scale, where scale = exponent - number of digits.
+  int64_t scale, other_scale;
+  if (!exponent_.ToInt64(&scale).ok() || !other.exponent_.ToInt64(&other_scale).ok()) {
+    return false;
+  }
+  scale -= digits_.size();
+  other_scale -= other.digits_.size();
+  int64_t shift;
+  if (__builtin_sub_overflow(scale, other_scale, &shift) ||
+      shift > static_cast<int64_t>(kMaxInt64Digits) ||
+      shift < -static_cast<int64_t>(kMaxInt64Digits)) {
+    return false;
+  }
+  auto coefficient = [](const Decimal& decimal) {
+    int64_t value = 0;
+    for (uint8_t digit : decimal.digits_) {
+      value = value * 10 + digit;
+    }
+    return decimal.is_positive_ ? value : -value;
+  };
+  int64_t lhs = coefficient(*this);
+  int64_t rhs = coefficient(other);
+  // Align the operand with the larger scale to the smaller one.
+  if (shift > 0 && __builtin_mul_overflow(lhs, kPowersOf10[shift], &lhs)) {
+    return false;
+  }
+  if (shift < 0 && __builtin_mul_overflow(rhs, kPowersOf10[-shift], &rhs)) {
+    return false;
+  }
+  int64_t sum;
+  if (__builtin_add_overflow(lhs, rhs, &sum)) {
+    return false;
+  }
+  if (sum == 0) {
+    result->clear();
+    return true;
+  }
+  uint64_t magnitude = sum < 0 ? ~static_cast<uint64_t>(sum) + 1 : sum;
+  std::vector<uint8_t> digits;
+  for (; magnitude != 0; magnitude /= 10) {
+    digits.push_back(magnitude % 10);
+  }
+  std::reverse(digits.begin(), digits.end());
+  const int64_t exponent = std::min(scale, other_scale) + static_cast<int64_t>(digits.size());
+  *result = Decimal(digits, VarInt(exponent), sum > 0);
+  return true;
+}
+
+VarInt Decimal::Coefficient(size_t shift) const {
+  std::vector<uint8_t> digits(shift, 0);
+  digits.insert(digits.end(), digits_.rbegin(), digits_.rend());
+  return VarInt(digits, 10, is_positive_);
+}
+
+Decimal Decimal::operator+(const Decimal& other) const {
+  if (digits_.empty()) {
+    return other;
+  }
+  if (other.digits_.empty()) {
+    return *this;
+  }
+  Decimal result;
+  if (AddInt64(other, &result)) {
+    return result;
+  }
+  const VarInt scale = exponent_ - VarInt(digits_.size());
+  const VarInt other_scale = other.exponent_ - VarInt(other.digits_.size());
+  // Exponents that far apart would need more aligned digits than fit in memory anyway.
+  int64_t shift = 0;
+  CHECK_OK((scale - other_scale).ToInt64(&shift));
+  const VarInt sum = VarInt::add(
+      {Coefficient(shift > 0 ? shift : 0), other.Coefficient(shift < 0 ? -shift : 0)});
+  if (sum.digits_.empty()) {
+    result.clear();
+    return result;
+  }
+  std::vector<uint8_t> digits(sum.digits_.rbegin(), sum.digits_.rend());
+  const VarInt exponent = (shift > 0 ? other_scale : scale) + VarInt(digits.size());
+  return Decimal(digits, exponent, sum.is_positive_);
+}
+
 string Decimal::EncodeToComparable() const {
   // Zero is encoded to the special value 128.
   if (digits_.empty()) {
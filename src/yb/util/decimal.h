@@ -134,6 +134,11 @@ class Decimal {
   Decimal operator-() const { return Decimal(digits_, exponent_, !is_positive_); }
   Decimal operator+() const { return Decimal(digits_, exponent_, is_positive_); }
 
+  // Exact sum and difference. When the operands have at most 18 digits and close exponents they are
+  // added as int64 coefficients, otherwise digit by digit.
+  Decimal operator+(const Decimal& other) const;
+  Decimal operator-(const Decimal& other) const { return *this + (-other); }
+
   // Encodes the decimal by using comparable encoding, as described above.
   std::string EncodeToComparable() const;
 
@@ -164,6 +169,13 @@ class Decimal {
   bool is_canonical() const;
   void make_canonical();
 
+  // Sets *result to this + other computed in int64 arithmetic. Returns false, leaving *result
+  // unchanged, if the aligned coefficients or their sum do not fit in int64.
+  bool AddInt64(const Decimal& other, Decimal* result) const;
+
+  // Returns the digits of this decimal as an integer in radix 10, with shift zeros appended.
+  VarInt Coefficient(size_t shift) const;
+
   std::vector<uint8_t> digits_;
   VarInt exponent_;
   bool is_positive_;
@@ -62,10 +62,16 @@ class Env {
   // CREATE_IF_NON_EXISTING_TRUNCATE | opens + truncates | creates
   // CREATE_NON_EXISTING             | fails             | creates
   // OPEN_EXISTING                   | opens             | fails
+  // REUSE_EXISTING                  | opens (*)         | fails
+  //
+  // (*) A writable file opened with REUSE_EXISTING is written from the start, over the existing
+  // data, which is treated as preallocated space. So the file is truncated to the written size
+  // when it is closed.
   enum CreateMode {
     CREATE_IF_NON_EXISTING_TRUNCATE,
     CREATE_NON_EXISTING,
-    OPEN_EXISTING
+    OPEN_EXISTING,
+    REUSE_EXISTING
   };
 
   Env() { }
@@ -228,6 +228,7 @@ static Status DoOpen(const string& filename, Env::CreateMode mode, int* fd, int
       flags |= O_CREAT | O_EXCL;
       break;
     case Env::OPEN_EXISTING:
+    case Env::REUSE_EXISTING:
       break;
     default:
       return STATUS(NotSupported, Substitute("Unknown create mode $0", mode));
@@ -337,12 +338,12 @@ class PosixRandomAccessFile: public RandomAccessFile {
 class PosixWritableFile : public WritableFile {
  public:
   PosixWritableFile(std::string fname, int fd, uint64_t file_size,
-                    bool sync_on_close)
+                    bool sync_on_close, uint64_t pre_allocated_size = 0)
       : filename_(std::move(fname)),
         fd_(fd),
         sync_on_close_(sync_on_close),
         filesize_(file_size),
-        pre_allocated_size_(0),
+        pre_allocated_size_(pre_allocated_size),
         pending_sync_(false) {}
 
   ~PosixWritableFile() {
@@ -528,8 +529,8 @@ class PosixWritableFile : public WritableFile {
 class PosixDirectIOWritableFile : public PosixWritableFile {
  public:
   PosixDirectIOWritableFile(const std::string &fname, int fd, uint64_t file_size,
-                            bool sync_on_close)
-      : PosixWritableFile(fname, fd, file_size, false /* sync_on_close */) {
+                            bool sync_on_close, uint64_t pre_allocated_size = 0)
+      : PosixWritableFile(fname, fd, file_size, false /* sync_on_close */, pre_allocated_size) {
 
     if (file_size != 0) {
       // For now, we don't support appending to an already existing file (of non-zero size).
@@ -1439,16 +1440,21 @@ class PosixEnv : public Env {
                                     const WritableFileOptions& opts,
                                     gscoped_ptr<WritableFile>* result) {
     uint64_t file_size = 0;
+    uint64_t pre_allocated_size = 0;
     if (opts.mode == OPEN_EXISTING) {
       file_size = VERIFY_RESULT(GetFileSize(fname));
+    } else if (opts.mode == REUSE_EXISTING) {
+      pre_allocated_size = VERIFY_RESULT(GetFileSize(fname));
     }
     PosixWritableFile *posix_writable_file;
 #if defined(__linux)
     if (opts.o_direct)
-      posix_writable_file = new PosixDirectIOWritableFile(fname, fd, file_size, opts.sync_on_close);
+      posix_writable_file = new PosixDirectIOWritableFile(
+          fname, fd, file_size, opts.sync_on_close, pre_allocated_size);
     else
 #endif
-      posix_writable_file = new PosixWritableFile(fname, fd, file_size, opts.sync_on_close);
+      posix_writable_file = new PosixWritableFile(
+          fname, fd, file_size, opts.sync_on_close, pre_allocated_size);
     result->reset(posix_writable_file);
     return Status::OK();
   }
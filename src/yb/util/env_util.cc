@@ -39,6 +39,7 @@
 #include <boost/container/small_vector.hpp>
 
 #include "yb/gutil/strings/substitute.h"
+#include "yb/util/crc.h"
 #include "yb/util/env.h"
 #include "yb/util/env_util.h"
 #include "yb/util/path_util.h"
@@ -207,6 +208,29 @@ Status CopyFile(Env* env, const string& source_path, const string& dest_path,
   return Status::OK();
 }
 
+Result<uint32_t> Crc32cFile(Env* env, const string& path) {
+  gscoped_ptr<SequentialFile> file;
+  RETURN_NOT_OK(env->NewSequentialFile(path, &file));
+  uint64_t size = VERIFY_RESULT(env->GetFileSize(path));
+
+  const int32_t kBufferSize = 1024 * 1024;
+  gscoped_ptr<uint8_t[]> scratch(new uint8_t[kBufferSize]);
+
+  uint64_t crc32 = 0;
+  uint64_t bytes_read = 0;
+  while (bytes_read < size) {
+    uint64_t max_bytes_to_read = std::min<uint64_t>(size - bytes_read, kBufferSize);
+    Slice data;
+    RETURN_NOT_OK(file->Read(max_bytes_to_read, &data, scratch.get()));
+    if (data.empty()) {
+      return STATUS_FORMAT(IOError, "Unexpected end of file $0 at $1", path, bytes_read);
+    }
+    crc::GetCrc32cInstance()->Compute(data.data(), data.size(), &crc32);
+    bytes_read += data.size();
+  }
+  return static_cast<uint32_t>(crc32);
+}
+
 ScopedFileDeleter::ScopedFileDeleter(Env* env, std::string path)
     : env_(DCHECK_NOTNULL(env)), path_(std::move(path)), should_delete_(true) {}
 
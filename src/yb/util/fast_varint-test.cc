@@ -11,6 +11,7 @@
 // under the License.
 //
 
+#include <algorithm>
 #include <iostream>
 
 #include "yb/gutil/strings/substitute.h"
@@ -388,6 +389,91 @@ TEST(FastVarIntTest, DecodeUnsignedIncorrect) {
   }
 }
 
+TEST(FastVarIntTest, DecodeBatch) {
+  std::mt19937_64 rng(123456);
+  std::vector<int64_t> values;
+  for (int i = 0; i <= 62; ++i) {
+    values.push_back(1LL << i);
+    values.push_back((1LL << i) - 1);
+    values.push_back(-(1LL << i));
+    values.push_back(-(1LL << i) + 1);
+  }
+  values.push_back(numeric_limits<int64_t>::max());
+  values.push_back(numeric_limits<int64_t>::min());
+  for (int i = 0; i != 10000; ++i) {
+    const int bits = std::uniform_int_distribution<int>(0, 63)(rng);
+    values.push_back(static_cast<int64_t>(rng()) >> bits);
+  }
+  std::shuffle(values.begin(), values.end(), rng);
+
+  std::string encoded;
+  for (auto value : values) {
+    FastAppendSignedVarIntToStr(value, &encoded);
+  }
+  // The tail is decoded by the scalar path, since less than 8 bytes are left there.
+  Slice slice(encoded);
+  std::vector<int64_t> decoded(values.size());
+  ASSERT_OK(FastDecodeSignedVarInts(&slice, decoded.data(), decoded.size()));
+  ASSERT_EQ(0, slice.size());
+  ASSERT_EQ(values, decoded);
+
+  std::string descending;
+  for (auto value : values) {
+    if (value != numeric_limits<int64_t>::min()) {
+      FastEncodeDescendingSignedVarInt(value, &descending);
+    }
+  }
+  slice = descending;
+  decoded.resize(values.size() - 1);
+  ASSERT_OK(FastDecodeDescendingSignedVarInts(&slice, decoded.data(), decoded.size()));
+  ASSERT_EQ(0, slice.size());
+  values.erase(std::remove(values.begin(), values.end(), numeric_limits<int64_t>::min()),
+               values.end());
+  ASSERT_EQ(values, decoded);
+
+  for (const auto& value : IncorrectValues()) {
+    slice = value;
+    int64_t v;
+    ASSERT_NOK(FastDecodeSignedVarInts(&slice, &v, 1))
+        << "Input: " << Slice(value).ToDebugHexString();
+  }
+  // Value that is split by the end of the buffer.
+  encoded = FastEncodeSignedVarIntToStr(1LL << 40) + FastEncodeSignedVarIntToStr(1LL << 50);
+  slice = Slice(encoded.data(), encoded.size() - 1);
+  int64_t two_values[2];
+  ASSERT_NOK(FastDecodeSignedVarInts(&slice, two_values, 2));
+}
+
+TEST(FastVarIntTest, DecodeBatchPerformance) {
+  const std::vector<int64_t> values = GenerateRandomValues<int64_t>();
+  std::string encoded;
+  for (auto value : values) {
+    FastAppendSignedVarIntToStr(value, &encoded);
+  }
+  std::vector<int64_t> decoded(values.size());
+
+  std::clock_t start_time = std::clock();
+  Slice slice(encoded);
+  for (auto& value : decoded) {
+    int decoded_size = 0;
+    ASSERT_OK(FastDecodeSignedVarInt(slice.data(), slice.size(), &value, &decoded_size));
+    slice.remove_prefix(decoded_size);
+  }
+  std::clock_t end_time = std::clock();
+  ASSERT_EQ(values, decoded);
+  LOG(INFO) << std::fixed << std::setprecision(2) << "Scalar decode CPU time used: "
+            << 1000.0 * (end_time - start_time) / CLOCKS_PER_SEC << " ms\n";
+
+  std::fill(decoded.begin(), decoded.end(), 0);
+  start_time = std::clock();
+  slice = encoded;
+  ASSERT_OK(FastDecodeSignedVarInts(&slice, decoded.data(), decoded.size()));
+  end_time = std::clock();
+  ASSERT_EQ(values, decoded);
+  LOG(INFO) << std::fixed << std::setprecision(2) << "Batch decode CPU time used: "
+            << 1000.0 * (end_time - start_time) / CLOCKS_PER_SEC << " ms\n";
+}
+
 TEST(FastVarIntTest, EncodeUnsignedPerformance) {
   const std::vector<uint64_t> values = GenerateRandomValues<uint64_t>();
 
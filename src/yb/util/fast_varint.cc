@@ -13,6 +13,8 @@
 
 #include "yb/util/fast_varint.h"
 
+#include "yb/gutil/endian.h"
+
 #include "yb/util/bytes_formatter.h"
 #include "yb/util/cast.h"
 #include "yb/util/debug-util.h"
@@ -264,6 +266,42 @@ Status FastDecodeDescendingSignedVarInt(yb::Slice *slice, int64_t *dest) {
   return Status::OK();
 }
 
+Status FastDecodeSignedVarInts(yb::Slice* slice, int64_t* dest, size_t count) {
+  const uint8_t* src = slice->data();
+  const uint8_t* const end = slice->end();
+  for (int64_t* const dest_end = dest + count; dest != dest_end; ++dest) {
+    if (end - src >= 8) {
+      // Complementing the whole word turns a negative VarInt into the positive encoding of its
+      // absolute value, so both cases share the same extraction.
+      const uint64_t mask = (*src & 0x80) ? 0 : ~0ULL;
+      const uint64_t word = BigEndian::Load64(src) ^ mask;
+      const int n_bytes = kVarIntSizeTable.varint_size[word >> 56];
+      // 9 and 10 byte VarInts also start with 0xff, they are distinguished by the second byte.
+      if (n_bytes < 8 || (word & 0x0080000000000000ULL) == 0) {
+        // A VarInt of n_bytes bytes has n_bytes + 1 prefix bits, so 7 * n_bytes - 1 value bits.
+        const uint64_t value =
+            (word >> (64 - 8 * n_bytes)) & ((1ULL << (7 * n_bytes - 1)) - 1);
+        *dest = mask ? -static_cast<int64_t>(value) : static_cast<int64_t>(value);
+        src += n_bytes;
+        continue;
+      }
+    }
+    int decoded_size = 0;
+    RETURN_NOT_OK(FastDecodeSignedVarInt(src, end - src, dest, &decoded_size));
+    src += decoded_size;
+  }
+  slice->remove_prefix(src - slice->data());
+  return Status::OK();
+}
+
+Status FastDecodeDescendingSignedVarInts(yb::Slice* slice, int64_t* dest, size_t count) {
+  RETURN_NOT_OK(FastDecodeSignedVarInts(slice, dest, count));
+  for (int64_t* const dest_end = dest + count; dest != dest_end; ++dest) {
+    *dest = -*dest;
+  }
+  return Status::OK();
+}
+
 size_t UnsignedVarIntLength(uint64_t v) {
   size_t result = 1;
   v >>= 7;
@@ -125,4 +125,24 @@ TEST_F(HdrHistogramTest, PercentileAndCopyTest) {
   ASSERT_EQ(hist.TotalSum(), copy.TotalSum());
 }
 
+TEST_F(HdrHistogramTest, MergeTest) {
+  HdrHistogram first(10000, kSigDigits);
+  HdrHistogram second(10000, kSigDigits);
+  HdrHistogram empty(10000, kSigDigits);
+  first.IncrementBy(10, 2);
+  first.Increment(500);
+  ASSERT_FALSE(second.IncrementByDetectingContention(5, 3));
+  second.Increment(1000);
+
+  HdrHistogram merged(first);
+  merged.MergeFrom(second);
+  merged.MergeFrom(empty);
+  ASSERT_EQ(7, merged.TotalCount());
+  ASSERT_EQ(10 * 2 + 500 + 5 * 3 + 1000, merged.TotalSum());
+  ASSERT_EQ(2, merged.CountInBucketForValue(10));
+  ASSERT_EQ(3, merged.CountInBucketForValue(5));
+  ASSERT_EQ(5, merged.MinValue());
+  ASSERT_EQ(1000, merged.MaxValue());
+}
+
 } // namespace yb
@@ -173,11 +173,61 @@ void HdrHistogram::IncrementBy(int64_t value, int64_t count) {
   NoBarrier_AtomicIncrement(&total_count_, count);
   NoBarrier_AtomicIncrement(&total_sum_, value * count);
 
+  UpdateMinMax(value, value);
+}
+
+bool HdrHistogram::IncrementByDetectingContention(int64_t value, int64_t count) {
+  DCHECK_GE(value, 0);
+  DCHECK_GE(count, 0);
+
+  int bucket_index = BucketIndex(value);
+  int sub_bucket_index = SubBucketIndex(value, bucket_index);
+  int counts_index = CountsArrayIndex(bucket_index, sub_bucket_index);
+
+  NoBarrier_AtomicIncrement(&counts_[counts_index], count);
+  // Uncontended CAS costs the same as atomic increment, while its failure means that another thread
+  // has updated the total in between.
+  bool contended = false;
+  Atomic64 old_total = NoBarrier_Load(&total_count_);
+  if (NoBarrier_CompareAndSwap(&total_count_, old_total, old_total + count) != old_total) {
+    NoBarrier_AtomicIncrement(&total_count_, count);
+    contended = true;
+  }
+  NoBarrier_AtomicIncrement(&total_sum_, value * count);
+
+  UpdateMinMax(value, value);
+  return contended;
+}
+
+void HdrHistogram::MergeFrom(const HdrHistogram& other) {
+  DCHECK_EQ(highest_trackable_value_, other.highest_trackable_value_);
+  DCHECK_EQ(num_significant_digits_, other.num_significant_digits_);
+
+  NoBarrier_AtomicIncrement(&total_sum_, NoBarrier_Load(&other.total_sum_));
+  Atomic64 other_min = NoBarrier_Load(&other.min_value_);
+
+  uint64_t total_copied_count = 0;
+  for (int i = 0; i < counts_array_length_; i++) {
+    uint64_t count = NoBarrier_Load(&other.counts_[i]);
+    if (count != 0) {
+      NoBarrier_AtomicIncrement(&counts_[i], count);
+      total_copied_count += count;
+    }
+  }
+  Atomic64 other_max = NoBarrier_Load(&other.max_value_);
+  NoBarrier_AtomicIncrement(&total_count_, total_copied_count);
+
+  if (total_copied_count != 0) {
+    UpdateMinMax(other_min, other_max);
+  }
+}
+
+void HdrHistogram::UpdateMinMax(int64_t min, int64_t max) {
   // Update min, if needed.
   {
     Atomic64 min_val;
-    while (PREDICT_FALSE(value < (min_val = MinValue()))) {
-      Atomic64 old_val = NoBarrier_CompareAndSwap(&min_value_, min_val, value);
+    while (PREDICT_FALSE(min < (min_val = MinValue()))) {
+      Atomic64 old_val = NoBarrier_CompareAndSwap(&min_value_, min_val, min);
       if (PREDICT_TRUE(old_val == min_val)) break; // CAS success.
     }
   }
@@ -185,8 +235,8 @@ void HdrHistogram::IncrementBy(int64_t value, int64_t count) {
   // Update max, if needed.
   {
     Atomic64 max_val;
-    while (PREDICT_FALSE(value > (max_val = MaxValue()))) {
-      Atomic64 old_val = NoBarrier_CompareAndSwap(&max_value_, max_val, value);
+    while (PREDICT_FALSE(max > (max_val = MaxValue()))) {
+      Atomic64 old_val = NoBarrier_CompareAndSwap(&max_value_, max_val, max);
       if (PREDICT_TRUE(old_val == max_val)) break; // CAS success.
     }
   }
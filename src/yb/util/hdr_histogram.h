@@ -97,6 +97,14 @@ class HdrHistogram {
   void Increment(int64_t value);
   void IncrementBy(int64_t value, int64_t count);
 
+  // Same as IncrementBy, but returns true if a concurrent update of this histogram by another
+  // thread was detected, i.e. the histogram is contended.
+  bool IncrementByDetectingContention(int64_t value, int64_t count);
+
+  // Adds all values recorded in other to this histogram. Both histograms should have the same
+  // configuration. Like the copy constructor, takes a non-consistent snapshot of other.
+  void MergeFrom(const HdrHistogram& other);
+
   // Record new data, correcting for "coordinated omission".
   //
   // See https://groups.google.com/d/msg/mechanical-sympathy/icNZJejUHfE/BfDekfBEs_sJ
@@ -185,6 +193,7 @@ class HdrHistogram {
 
   void Init();
   int CountsArrayIndex(int bucket_index, int sub_bucket_index) const;
+  void UpdateMinMax(int64_t min, int64_t max);
 
   uint64_t highest_trackable_value_;
   int num_significant_digits_;
@@ -50,18 +50,20 @@ using std::vector;
 
 namespace yb {
 
-// Adapter to allow RapidJSON to write directly to a stringstream.
+// Adapter to allow RapidJSON to write directly to an output stream.
 // Since Squeasel exposes a stringstream as its interface, this is needed to avoid overcopying.
+// Characters are put straight into the stream buffer, bypassing the per-character sentry of
+// std::ostream::put.
 class UTF8StringStreamBuffer {
  public:
   typedef typename rapidjson::UTF8<>::Ch Ch;
-  explicit UTF8StringStreamBuffer(std::stringstream* out);
+  explicit UTF8StringStreamBuffer(std::ostream* out);
   void Put(Ch c);
 
   void PutUnsafe(Ch c) { Put(c); }
   void Flush() {}
  private:
-  std::stringstream* out_;
+  std::streambuf* out_;
 };
 
 // rapidjson doesn't provide any common interface between the PrettyWriter and
@@ -94,7 +96,7 @@ class JsonWriterIf {
 template<class T>
 class JsonWriterImpl : public JsonWriterIf {
  public:
-  explicit JsonWriterImpl(stringstream* out);
+  explicit JsonWriterImpl(std::ostream* out);
 
   void Null() override;
   void Bool(bool b) override;
@@ -125,7 +127,7 @@ class JsonWriterImpl : public JsonWriterIf {
 typedef rapidjson::PrettyWriter<UTF8StringStreamBuffer> PrettyWriterClass;
 typedef rapidjson::Writer<UTF8StringStreamBuffer> CompactWriterClass;
 
-JsonWriter::JsonWriter(stringstream* out, Mode m) {
+JsonWriter::JsonWriter(std::ostream* out, Mode m) {
   switch (m) {
     case PRETTY:
       impl_.reset(new JsonWriterImpl<PrettyWriterClass>(DCHECK_NOTNULL(out)));
@@ -289,12 +291,12 @@ string JsonWriter::ToJson(const Message& pb, Mode mode) {
 // UTF8StringStreamBuffer
 //
 
-UTF8StringStreamBuffer::UTF8StringStreamBuffer(std::stringstream* out)
-  : out_(DCHECK_NOTNULL(out)) {
+UTF8StringStreamBuffer::UTF8StringStreamBuffer(std::ostream* out)
+  : out_(DCHECK_NOTNULL(out)->rdbuf()) {
 }
 
 void UTF8StringStreamBuffer::Put(rapidjson::UTF8<>::Ch c) {
-  out_->put(c);
+  out_->sputc(c);
 }
 
 //
@@ -302,7 +304,7 @@ void UTF8StringStreamBuffer::Put(rapidjson::UTF8<>::Ch c) {
 //
 
 template<class T>
-JsonWriterImpl<T>::JsonWriterImpl(stringstream* out)
+JsonWriterImpl<T>::JsonWriterImpl(std::ostream* out)
   : stream_(DCHECK_NOTNULL(out)),
     writer_(stream_) {
 }
@@ -34,6 +34,7 @@
 
 #include <inttypes.h>
 
+#include <iosfwd>
 #include <string>
 
 #include "yb/gutil/gscoped_ptr.h"
@@ -56,8 +57,9 @@ class JsonWriterIf;
 // This class implements all the methods of rapidjson::JsonWriter, plus an
 // additional convenience method for String(std::string).
 //
-// We take an instance of std::stringstream in the constructor because Mongoose / Squeasel
-// uses std::stringstream for output buffering.
+// We take an output stream in the constructor, so the JSON could be written to the
+// std::stringstream used by Mongoose / Squeasel for output buffering, as well as streamed
+// to an HTTP response.
 class JsonWriter {
  public:
   enum Mode {
@@ -67,7 +69,7 @@ class JsonWriter {
     COMPACT
   };
 
-  JsonWriter(std::stringstream* out, Mode mode);
+  JsonWriter(std::ostream* out, Mode mode);
   ~JsonWriter();
 
   void Null();
@@ -296,6 +296,27 @@ TEST(MemTrackerTest, SoftLimitExceeded) {
   }
 }
 
+TEST(MemTrackerTest, SoftLimitOverage) {
+  const int kMemLimit = 1000;
+  google::FlagSaver saver;
+  FLAGS_memory_limit_soft_percentage = 50;
+  shared_ptr<MemTracker> parent = MemTracker::CreateTracker(kMemLimit, "parent");
+  shared_ptr<MemTracker> child = MemTracker::CreateTracker(-1, "child", parent);
+
+  // Under the soft limit.
+  ScopedTrackedConsumption consumption(child, kMemLimit / 4);
+  ASSERT_EQ(0, child->AnySoftLimitOverage());
+
+  // Half way between the soft and the hard limit of the parent.
+  consumption.Reset(kMemLimit * 3 / 4);
+  ASSERT_NEAR(0.5, child->AnySoftLimitOverage(), 0.001);
+  ASSERT_NEAR(0.5, parent->AnySoftLimitOverage(), 0.001);
+
+  // Over the hard limit.
+  consumption.Reset(kMemLimit + 1);
+  ASSERT_EQ(1, child->AnySoftLimitOverage());
+}
+
 #ifdef TCMALLOC_ENABLED
 TEST(MemTrackerTest, TcMallocRootTracker) {
   shared_ptr<MemTracker> root = MemTracker::GetRootTracker();
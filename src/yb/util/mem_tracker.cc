@@ -470,6 +470,22 @@ bool MemTracker::AnySoftLimitExceeded(double* current_capacity_pct) {
   return false;
 }
 
+double MemTracker::AnySoftLimitOverage() const {
+  double result = 0;
+  for (const MemTracker* t : limit_trackers_) {
+    const int64_t usage = t->consumption();
+    if (usage < t->soft_limit_) {
+      continue;
+    }
+    if (usage >= t->limit_) {
+      return 1;
+    }
+    result = std::max(
+        result, static_cast<double>(usage - t->soft_limit_) / (t->limit_ - t->soft_limit_));
+  }
+  return result;
+}
+
 int64_t MemTracker::SpareCapacity() const {
   int64_t result = std::numeric_limits<int64_t>::max();
   for (const auto& tracker : limit_trackers_) {
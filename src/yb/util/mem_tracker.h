@@ -236,6 +236,13 @@ class MemTracker : public std::enable_shared_from_this<MemTracker> {
   // independent event).
   bool AnySoftLimitExceeded(double* current_capacity_pct);
 
+  // Returns how far the consumption of this tracker or one of its ancestors is over its soft
+  // limit, as a fraction of the range between the soft and the hard limit: 0 when no soft limit
+  // is exceeded, 1 when a hard limit is reached. The largest value over the trackers is returned.
+  // Unlike SoftLimitExceeded(), it is deterministic and does not call GC functions, so callers
+  // can scale their backpressure with it.
+  double AnySoftLimitOverage() const;
+
   // Returns the maximum consumption that can be made without exceeding the limit on
   // this tracker or any of its parents. Returns int64_t::max() if there are no
   // limits and a negative value if any limit is already exceeded.
@@ -602,7 +602,9 @@ class InMemoryEnv : public EnvWrapper {
     MutexLock lock(mutex_);
     if (ContainsKey(file_map_, fname)) {
       switch (mode) {
+        // There is no preallocated space in memory, so reused files are truncated.
         case CREATE_IF_NON_EXISTING_TRUNCATE:
+        case REUSE_EXISTING:
           DeleteFileInternal(fname);
           break; // creates a new file below
         case CREATE_NON_EXISTING:
@@ -614,7 +616,7 @@ class InMemoryEnv : public EnvWrapper {
           return STATUS(NotSupported, Substitute("Unknown create mode $0",
                                                  mode));
       }
-    } else if (mode == OPEN_EXISTING) {
+    } else if (mode == OPEN_EXISTING || mode == REUSE_EXISTING) {
       return STATUS(IOError, fname, "File not found");
     }
 
@@ -0,0 +1,63 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/memory/huge_pages.h"
+
+#include <sys/mman.h>
+
+#include <atomic>
+
+#include <glog/logging.h>
+
+namespace yb {
+
+namespace {
+
+std::atomic<uint64_t> huge_pages_allocated_bytes{0};
+std::atomic<uint64_t> huge_pages_allocation_failures{0};
+
+} // namespace
+
+void* AllocateHugePages(size_t bytes) {
+#ifdef MAP_HUGETLB
+  void* addr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+  if (addr != MAP_FAILED) {
+    huge_pages_allocated_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    return addr;
+  }
+#endif
+  if (huge_pages_allocation_failures.fetch_add(1, std::memory_order_relaxed) == 0) {
+    PLOG(WARNING) << "Failed to allocate " << bytes << " bytes of huge pages, falling back to "
+                  << "regular pages";
+  }
+  return nullptr;
+}
+
+void FreeHugePages(void* addr, size_t bytes) {
+  if (munmap(addr, bytes) != 0) {
+    PLOG(DFATAL) << "Failed to unmap " << bytes << " bytes of huge pages at " << addr;
+    return;
+  }
+  huge_pages_allocated_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+uint64_t HugePagesAllocatedBytes() {
+  return huge_pages_allocated_bytes.load(std::memory_order_relaxed);
+}
+
+uint64_t HugePagesAllocationFailures() {
+  return huge_pages_allocation_failures.load(std::memory_order_relaxed);
+}
+
+} // namespace yb
@@ -0,0 +1,38 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_MEMORY_HUGE_PAGES_H
+#define YB_UTIL_MEMORY_HUGE_PAGES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace yb {
+
+// Maps bytes of anonymous memory backed by huge pages, bytes should be a multiple of the huge page
+// size. Returns nullptr when huge pages are not available, for instance when not enough of them
+// are reserved with vm.nr_hugepages, so callers should fall back to regular allocation.
+void* AllocateHugePages(size_t bytes);
+
+// Unmaps memory returned by AllocateHugePages.
+void FreeHugePages(void* addr, size_t bytes);
+
+// Bytes currently mapped by AllocateHugePages.
+uint64_t HugePagesAllocatedBytes();
+
+// Number of AllocateHugePages calls that failed to map huge pages.
+uint64_t HugePagesAllocationFailures();
+
+} // namespace yb
+
+#endif // YB_UTIL_MEMORY_HUGE_PAGES_H
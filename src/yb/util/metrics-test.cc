@@ -50,10 +50,12 @@ using std::unordered_set;
 using std::vector;
 
 DECLARE_int32(metrics_retirement_age_ms);
+DECLARE_string(metrics_hot_tablet_metrics);
 
 namespace yb {
 
 METRIC_DEFINE_entity(test_entity);
+METRIC_DEFINE_entity(tablet);
 
 class MetricsTest : public YBTest {
  public:
@@ -217,6 +219,98 @@ TEST_F(MetricsTest, JsonPrintTest) {
   ASSERT_EQ("", out.str());
 }
 
+METRIC_DEFINE_counter(server, test_prometheus_reads, "Test Reads", MetricUnit::kRequests,
+                      "Number of test reads");
+METRIC_DEFINE_counter(server, test_prometheus_writes, "Test Writes", MetricUnit::kRequests,
+                      "Number of test writes");
+
+TEST_F(MetricsTest, PrometheusPrintTest) {
+  auto server = METRIC_ENTITY_server.Instantiate(&registry_, "my-server");
+  METRIC_test_prometheus_reads.Instantiate(server)->IncrementBy(3);
+  METRIC_test_prometheus_writes.Instantiate(server)->Increment();
+  // Entities of other types are not exported.
+  METRIC_reqs_pending.Instantiate(entity_)->Increment();
+
+  std::stringstream out;
+  {
+    PrometheusWriter writer(&out);
+    ASSERT_OK(registry_.WriteForPrometheus(&writer, {}));
+  }
+  ASSERT_STR_CONTAINS(out.str(), "test_prometheus_reads{metric_id=\"my-server\"} 3 ");
+  ASSERT_STR_CONTAINS(out.str(), "test_prometheus_writes");
+  ASSERT_EQ(string::npos, out.str().find("reqs_pending"));
+
+  out.str("");
+  {
+    PrometheusWriter writer(&out);
+    ASSERT_OK(registry_.WriteForPrometheus(&writer, { "test_prometheus_reads" }));
+  }
+  ASSERT_STR_CONTAINS(out.str(), "test_prometheus_reads");
+  ASSERT_EQ(string::npos, out.str().find("test_prometheus_writes"));
+}
+
+METRIC_DEFINE_counter(tablet, test_tablet_rows, "Test Rows", MetricUnit::kRows,
+                      "Number of test rows");
+METRIC_DEFINE_histogram(tablet, test_tablet_latency, "Test Latency",
+                        MetricUnit::kMicroseconds, "Test latency", 1000000, 2);
+
+TEST_F(MetricsTest, TabletRollupTest) {
+  FLAGS_metrics_hot_tablet_metrics = "test_tablet_rows";
+  std::vector<scoped_refptr<MetricEntity>> tablets;
+  for (int i = 0; i != 3; ++i) {
+    MetricEntity::AttributeMap attrs;
+    attrs["table_id"] = i < 2 ? "table-1" : "table-2";
+    attrs["table_name"] = i < 2 ? "t1" : "t2";
+    tablets.push_back(METRIC_ENTITY_tablet.Instantiate(
+        &registry_, "tablet-" + std::to_string(i), attrs));
+    METRIC_test_tablet_rows.Instantiate(tablets.back())->IncrementBy(i + 1);
+    METRIC_test_tablet_latency.Instantiate(tablets.back())->Increment(100 * (i + 1));
+  }
+
+  MetricJsonOptions opts;
+  opts.level = MetricAggregationLevel::kTable;
+  opts.max_hot_tablets = 1;
+  std::stringstream out;
+  JsonWriter writer(&out, JsonWriter::COMPACT);
+  ASSERT_OK(registry_.WriteAsJson(&writer, { "*" }, opts));
+
+  JsonReader reader(out.str());
+  ASSERT_OK(reader.Init());
+  const rapidjson::Value& entities = *reader.root();
+  ASSERT_TRUE(entities.IsArray());
+  // test_entity, two tables and the most active tablet.
+  ASSERT_EQ(4, entities.Size());
+  int num_tables = 0;
+  for (rapidjson::SizeType i = 0; i != entities.Size(); ++i) {
+    string type, id;
+    ASSERT_OK(reader.ExtractString(&entities[i], "type", &type));
+    ASSERT_OK(reader.ExtractString(&entities[i], "id", &id));
+    if (type == "tablet") {
+      ASSERT_EQ("tablet-2", id);
+      continue;
+    }
+    if (type != "table") {
+      continue;
+    }
+    ++num_tables;
+    vector<const rapidjson::Value*> metrics;
+    ASSERT_OK(reader.ExtractObjectArray(&entities[i], "metrics", &metrics));
+    ASSERT_EQ(2, metrics.size());
+    int64_t count, rows;
+    ASSERT_OK(reader.ExtractInt64(metrics[0], "total_count", &count));
+    ASSERT_OK(reader.ExtractInt64(metrics[1], "value", &rows));
+    if (id == "table-1") {
+      ASSERT_EQ(2, count);
+      ASSERT_EQ(3, rows);
+    } else {
+      ASSERT_EQ("table-2", id);
+      ASSERT_EQ(1, count);
+      ASSERT_EQ(3, rows);
+    }
+  }
+  ASSERT_EQ(2, num_tables);
+}
+
 // Test that metrics are retired when they are no longer referenced.
 TEST_F(MetricsTest, RetirementTest) {
   FLAGS_metrics_retirement_age_ms = 100;
@@ -42,7 +42,9 @@
 #include "yb/gutil/map-util.h"
 #include "yb/gutil/singleton.h"
 #include "yb/gutil/stl_util.h"
+#include "yb/gutil/strings/split.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/gutil/sysinfo.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/hdr_histogram.h"
 #include "yb/util/histogram.pb.h"
@@ -62,6 +64,20 @@ DEFINE_string(metric_node_name, "DEFAULT_NODE_NAME",
 
 // Process/server-wide metrics should go into the 'server' entity.
 // More complex applications will define other entities.
+DEFINE_int32(histogram_max_stripes, 16,
+             "Max number of stripes allocated by a histogram once concurrent increments of it "
+             "are detected, limited by the number of CPUs. Each stripe costs the memory of a "
+             "separate histogram. 0 or 1 disables striping.");
+TAG_FLAG(histogram_max_stripes, advanced);
+
+DEFINE_string(metrics_hot_tablet_metrics,
+              "rows_inserted,rows_updated,rows_deleted,ql_read_latency,redis_read_latency",
+              "Comma separated names of tablet metrics whose sum ranks tablets by activity, when "
+              "tablet metrics are rolled up and only the most active tablets are exported "
+              "individually. Histograms contribute their total count.");
+TAG_FLAG(metrics_hot_tablet_metrics, advanced);
+TAG_FLAG(metrics_hot_tablet_metrics, runtime);
+
 METRIC_DEFINE_entity(server);
 
 namespace yb {
@@ -275,7 +291,17 @@ Status MetricEntity::WriteAsJson(JsonWriter* writer,
   return Status::OK();
 }
 
-CHECKED_STATUS MetricEntity::WriteForPrometheus(PrometheusWriter* writer) const {
+CHECKED_STATUS MetricEntity::WriteForPrometheus(
+    PrometheusWriter* writer, const vector<string>& requested_metrics) const {
+  const bool is_tablet = strcmp(prototype_->name(), "tablet") == 0;
+  if (!is_tablet && strcmp(prototype_->name(), "server") != 0 &&
+      strcmp(prototype_->name(), "cluster") != 0) {
+    // Other entities are not exported, so don't bother to snapshot them.
+    return Status::OK();
+  }
+  const bool select_all = requested_metrics.empty() ||
+                          MatchMetricInList(id(), requested_metrics);
+
   // We want the keys to be in alphabetical order when printing, so we use an ordered map here.
   typedef std::map<const char*, scoped_refptr<Metric> > OrderedMetricMap;
   OrderedMetricMap metrics;
@@ -291,22 +317,28 @@ CHECKED_STATUS MetricEntity::WriteForPrometheus(PrometheusWriter* writer) const
       const MetricPrototype* prototype = val.first;
       const scoped_refptr<Metric>& metric = val.second;
 
-      InsertOrDie(&metrics, prototype->name(), metric);
+      if (select_all || MatchMetricInList(prototype->name(), requested_metrics)) {
+        InsertOrDie(&metrics, prototype->name(), metric);
+      }
     }
   }
+
+  // If we had a filter, and we didn't either match this entity or any metrics inside
+  // it, don't print the entity at all.
+  if (!select_all && metrics.empty()) {
+    return Status::OK();
+  }
+
   AttributeMap prometheus_attr;
   // Per tablet metrics come with tablet_id, as well as table_id and table_name attributes.
   // We ignore the tablet part to squash at the table level.
-  if (strcmp(prototype_->name(), "tablet") == 0)  {
+  if (is_tablet)  {
     prometheus_attr["table_id"] = attrs["table_id"];
     prometheus_attr["table_name"] = attrs["table_name"];
-  } else if (strcmp(prototype_->name(), "server") == 0 ||
-      strcmp(prototype_->name(), "cluster") == 0) {
+  } else {
     prometheus_attr = attrs;
     // This is tablet_id in the case of tablet, but otherwise names the server type, eg: yb.master
     prometheus_attr["metric_id"] = id_;
-  } else {
-    return Status::OK();
   }
   // This is currently tablet / server / cluster.
   prometheus_attr["metric_type"] = prototype_->name();
@@ -386,6 +418,29 @@ void MetricEntity::SetAttribute(const string& key, const string& val) {
   attributes_[key] = val;
 }
 
+MetricEntity::AttributeMap MetricEntity::attributes() const {
+  std::lock_guard<simple_spinlock> l(lock_);
+  return attributes_;
+}
+
+void MetricEntity::AddToRollup(const vector<string>& requested_metrics,
+                               MetricRollup* rollup) const {
+  bool select_all = MatchMetricInList(id(), requested_metrics);
+  std::vector<scoped_refptr<Metric>> metrics;
+  {
+    std::lock_guard<simple_spinlock> l(lock_);
+    metrics.reserve(metric_map_.size());
+    for (const MetricMap::value_type& val : metric_map_) {
+      if (select_all || MatchMetricInList(val.first->name(), requested_metrics)) {
+        metrics.push_back(val.second);
+      }
+    }
+  }
+  for (const auto& metric : metrics) {
+    metric->AddToRollup(rollup);
+  }
+}
+
 //
 // MetricRegistry
 //
@@ -405,11 +460,76 @@ Status MetricRegistry::WriteAsJson(JsonWriter* writer,
     entities = entities_;
   }
 
+  // Tablets rolled up by table id, or all of them under an empty key, with attributes of the
+  // rollup.
+  std::map<string, std::pair<MetricEntity::AttributeMap, MetricRollup>> rollups;
+  std::vector<std::pair<double, const MetricEntity*>> hot_tablets;
+  std::vector<string> hot_tablet_metrics;
+  if (opts.max_hot_tablets > 0) {
+    SplitStringUsing(FLAGS_metrics_hot_tablet_metrics, ",", &hot_tablet_metrics);
+  }
+
   writer->StartArray();
-  for (const EntityMap::value_type e : entities) {
-    WARN_NOT_OK(e.second->WriteAsJson(writer, requested_metrics, opts),
-                Substitute("Failed to write entity $0 as JSON", e.second->id()));
+  for (const EntityMap::value_type& e : entities) {
+    if (opts.level == MetricAggregationLevel::kTablet ||
+        strcmp(e.second->prototype_->name(), "tablet") != 0) {
+      WARN_NOT_OK(e.second->WriteAsJson(writer, requested_metrics, opts),
+                  Substitute("Failed to write entity $0 as JSON", e.second->id()));
+      continue;
+    }
+
+    MetricRollup tablet_rollup;
+    e.second->AddToRollup(requested_metrics, &tablet_rollup);
+    if (tablet_rollup.empty()) {
+      continue;
+    }
+    if (!hot_tablet_metrics.empty()) {
+      double activity = tablet_rollup.Sum(hot_tablet_metrics);
+      if (activity > 0) {
+        hot_tablets.emplace_back(activity, e.second.get());
+      }
+    }
+    auto attrs = e.second->attributes();
+    auto& rollup = opts.level == MetricAggregationLevel::kTable ? rollups[attrs["table_id"]]
+                                                                : rollups[string()];
+    if (rollup.second.empty() && opts.level == MetricAggregationLevel::kTable) {
+      rollup.first["table_id"] = attrs["table_id"];
+      rollup.first["table_name"] = attrs["table_name"];
+    }
+    rollup.second.MergeFrom(tablet_rollup);
+  }
+
+  for (const auto& rollup : rollups) {
+    writer->StartObject();
+    writer->String("type");
+    writer->String(opts.level == MetricAggregationLevel::kTable ? "table" : "tablets");
+    writer->String("id");
+    writer->String(opts.level == MetricAggregationLevel::kTable ? rollup.first : "all");
+    writer->String("attributes");
+    writer->StartObject();
+    for (const auto& attr : rollup.second.first) {
+      writer->String(attr.first);
+      writer->String(attr.second);
+    }
+    writer->EndObject();
+    writer->String("metrics");
+    writer->StartArray();
+    WARN_NOT_OK(rollup.second.second.WriteAsJson(writer, opts),
+                Substitute("Failed to write rollup $0 as JSON", rollup.first));
+    writer->EndArray();
+    writer->EndObject();
+  }
+
+  // Most active tablets first.
+  size_t num_hot_tablets = std::min<size_t>(hot_tablets.size(), opts.max_hot_tablets);
+  std::partial_sort(
+      hot_tablets.begin(), hot_tablets.begin() + num_hot_tablets, hot_tablets.end(),
+      [](const auto& lhs, const auto& rhs) { return lhs.first > rhs.first; });
+  for (size_t i = 0; i != num_hot_tablets; ++i) {
+    WARN_NOT_OK(hot_tablets[i].second->WriteAsJson(writer, requested_metrics, opts),
+                Substitute("Failed to write entity $0 as JSON", hot_tablets[i].second->id()));
   }
+  hot_tablets.clear();
   writer->EndArray();
 
   // Rather than having a thread poll metrics periodically to retire old ones,
@@ -422,7 +542,8 @@ Status MetricRegistry::WriteAsJson(JsonWriter* writer,
   return Status::OK();
 }
 
-CHECKED_STATUS MetricRegistry::WriteForPrometheus(PrometheusWriter* writer) const {
+CHECKED_STATUS MetricRegistry::WriteForPrometheus(
+    PrometheusWriter* writer, const vector<string>& requested_metrics) const {
   EntityMap entities;
   {
     std::lock_guard<simple_spinlock> l(lock_);
@@ -430,7 +551,7 @@ CHECKED_STATUS MetricRegistry::WriteForPrometheus(PrometheusWriter* writer) cons
   }
 
   for (const EntityMap::value_type e : entities) {
-    WARN_NOT_OK(e.second->WriteForPrometheus(writer),
+    WARN_NOT_OK(e.second->WriteForPrometheus(writer, requested_metrics),
                 Substitute("Failed to write entity $0 as Prometheus", e.second->id()));
   }
   RETURN_NOT_OK(writer->FlushAggregatedValues());
@@ -677,6 +798,10 @@ CHECKED_STATUS Counter::WriteForPrometheus(
   return writer->WriteSingleEntry(attr, prototype_->name(), value());
 }
 
+void Counter::AddToRollup(MetricRollup* rollup) const {
+  rollup->AddValue(prototype_, value());
+}
+
 
 /////////////////////////////////////////////////
 // HistogramPrototype
@@ -705,17 +830,77 @@ scoped_refptr<Histogram> HistogramPrototype::Instantiate(
 // Histogram
 /////////////////////////////////////////////////
 
+namespace {
+
+// Each thread gets its own index, so threads are evenly spread over the stripes.
+size_t ThreadStripeIndex() {
+  static std::atomic<size_t> next_index{0};
+  static thread_local const size_t index = next_index.fetch_add(1, std::memory_order_relaxed);
+  return index;
+}
+
+} // namespace
+
+struct Histogram::Stripes {
+  // Separately allocated, so hot fields of different stripes do not share cache lines.
+  std::vector<std::unique_ptr<HdrHistogram>> histograms;
+};
+
 Histogram::Histogram(const HistogramPrototype* proto)
   : Metric(proto),
     histogram_(new HdrHistogram(proto->max_trackable_value(), proto->num_sig_digits())) {
 }
 
+Histogram::~Histogram() {
+  delete stripes_.load(std::memory_order_acquire);
+}
+
 void Histogram::Increment(int64_t value) {
-  histogram_->Increment(value);
+  IncrementBy(value, 1);
 }
 
 void Histogram::IncrementBy(int64_t value, int64_t amount) {
-  histogram_->IncrementBy(value, amount);
+  auto* stripes = stripes_.load(std::memory_order_acquire);
+  if (PREDICT_TRUE(stripes == nullptr)) {
+    if (FLAGS_histogram_max_stripes <= 1) {
+      histogram_->IncrementBy(value, amount);
+    } else if (PREDICT_FALSE(histogram_->IncrementByDetectingContention(value, amount))) {
+      AllocateStripes();
+    }
+    return;
+  }
+  const auto& histograms = stripes->histograms;
+  histograms[ThreadStripeIndex() % histograms.size()]->IncrementBy(value, amount);
+}
+
+void Histogram::AllocateStripes() {
+  size_t num_stripes = std::min(FLAGS_histogram_max_stripes, base::NumCPUs());
+  if (num_stripes <= 1) {
+    return;
+  }
+  std::unique_ptr<Stripes> stripes(new Stripes);
+  stripes->histograms.reserve(num_stripes);
+  for (size_t i = 0; i != num_stripes; ++i) {
+    stripes->histograms.emplace_back(new HdrHistogram(
+        histogram_->highest_trackable_value(), histogram_->num_significant_digits()));
+  }
+  Stripes* expected = nullptr;
+  // Several threads could detect contention at the same time, only one of them installs stripes.
+  if (stripes_.compare_exchange_strong(expected, stripes.get(), std::memory_order_acq_rel)) {
+    LOG(INFO) << "Striping contended histogram " << prototype_->name() << " into " << num_stripes
+              << " stripes";
+    stripes.release();
+  }
+}
+
+void Histogram::MergeStripes(HdrHistogram* snapshot) const {
+  auto* stripes = stripes_.load(std::memory_order_acquire);
+  if (stripes == nullptr) {
+    return;
+  }
+  for (const auto& histogram : stripes->histograms) {
+    snapshot->MergeFrom(*histogram);
+  }
 }
 
 Status Histogram::WriteAsJson(JsonWriter* writer,
@@ -730,6 +915,7 @@ Status Histogram::WriteAsJson(JsonWriter* writer,
 CHECKED_STATUS Histogram::WriteForPrometheus(
     PrometheusWriter* writer, const MetricEntity::AttributeMap& attr) const {
   HdrHistogram snapshot(*histogram_);
+  MergeStripes(&snapshot);
 
   // Representing the sum and count require suffixed names.
   std::string hist_name = prototype_->name();
@@ -760,15 +946,24 @@ CHECKED_STATUS Histogram::WriteForPrometheus(
   return Status::OK();
 }
 
-Status Histogram::GetHistogramSnapshotPB(HistogramSnapshotPB* snapshot_pb,
-                                         const MetricJsonOptions& opts) const {
+void Histogram::AddToRollup(MetricRollup* rollup) const {
   HdrHistogram snapshot(*histogram_);
-  snapshot_pb->set_name(prototype_->name());
+  MergeStripes(&snapshot);
+  rollup->AddHistogram(prototype_, snapshot);
+}
+
+namespace {
+
+Status FillHistogramSnapshotPB(const MetricPrototype* prototype,
+                               const HdrHistogram& snapshot,
+                               const MetricJsonOptions& opts,
+                               HistogramSnapshotPB* snapshot_pb) {
+  snapshot_pb->set_name(prototype->name());
   if (opts.include_schema_info) {
-    snapshot_pb->set_type(MetricType::Name(prototype_->type()));
-    snapshot_pb->set_label(prototype_->label());
-    snapshot_pb->set_unit(MetricUnit::Name(prototype_->unit()));
-    snapshot_pb->set_description(prototype_->description());
+    snapshot_pb->set_type(MetricType::Name(prototype->type()));
+    snapshot_pb->set_label(prototype->label());
+    snapshot_pb->set_unit(MetricUnit::Name(prototype->unit()));
+    snapshot_pb->set_description(prototype->description());
     snapshot_pb->set_max_trackable_value(snapshot.highest_trackable_value());
     snapshot_pb->set_num_significant_digits(snapshot.num_significant_digits());
   }
@@ -795,23 +990,137 @@ Status Histogram::GetHistogramSnapshotPB(HistogramSnapshotPB* snapshot_pb,
   return Status::OK();
 }
 
+} // namespace
+
+Status Histogram::GetHistogramSnapshotPB(HistogramSnapshotPB* snapshot_pb,
+                                         const MetricJsonOptions& opts) const {
+  HdrHistogram snapshot(*histogram_);
+  MergeStripes(&snapshot);
+  return FillHistogramSnapshotPB(prototype_, snapshot, opts, snapshot_pb);
+}
+
 uint64_t Histogram::CountInBucketForValueForTests(uint64_t value) const {
-  return histogram_->CountInBucketForValue(value);
+  HdrHistogram snapshot(*histogram_);
+  MergeStripes(&snapshot);
+  return snapshot.CountInBucketForValue(value);
 }
 
 uint64_t Histogram::TotalCount() const {
-  return histogram_->TotalCount();
+  uint64_t result = histogram_->TotalCount();
+  auto* stripes = stripes_.load(std::memory_order_acquire);
+  if (stripes != nullptr) {
+    for (const auto& histogram : stripes->histograms) {
+      result += histogram->TotalCount();
+    }
+  }
+  return result;
 }
 
 uint64_t Histogram::MinValueForTests() const {
-  return histogram_->MinValue();
+  HdrHistogram snapshot(*histogram_);
+  MergeStripes(&snapshot);
+  return snapshot.MinValue();
 }
 
 uint64_t Histogram::MaxValueForTests() const {
-  return histogram_->MaxValue();
+  HdrHistogram snapshot(*histogram_);
+  MergeStripes(&snapshot);
+  return snapshot.MaxValue();
 }
+
 double Histogram::MeanValueForTests() const {
-  return histogram_->MeanValue();
+  HdrHistogram snapshot(*histogram_);
+  MergeStripes(&snapshot);
+  return snapshot.MeanValue();
+}
+
+//
+// MetricRollup
+//
+
+MetricRollup::MetricRollup() {
+}
+
+MetricRollup::MetricRollup(MetricRollup&& rhs) = default;
+
+MetricRollup::~MetricRollup() {
+}
+
+MetricRollup::Entry& MetricRollup::GetEntry(const MetricPrototype* prototype) {
+  auto& entry = entries_[prototype->name()];
+  entry.prototype = prototype;
+  return entry;
+}
+
+void MetricRollup::AddInt64(const MetricPrototype* prototype, int64_t value) {
+  GetEntry(prototype).int64_value += value;
+}
+
+void MetricRollup::AddDouble(const MetricPrototype* prototype, double value) {
+  auto& entry = GetEntry(prototype);
+  entry.is_double = true;
+  entry.double_value += value;
+}
+
+void MetricRollup::AddHistogram(const MetricPrototype* prototype, const HdrHistogram& histogram) {
+  auto& entry = GetEntry(prototype);
+  if (entry.histogram) {
+    entry.histogram->MergeFrom(histogram);
+  } else {
+    entry.histogram.reset(new HdrHistogram(histogram));
+  }
+}
+
+void MetricRollup::MergeFrom(const MetricRollup& other) {
+  for (const auto& other_entry : other.entries_) {
+    const auto& source = other_entry.second;
+    if (source.histogram) {
+      AddHistogram(source.prototype, *source.histogram);
+    } else if (source.is_double) {
+      AddDouble(source.prototype, source.double_value);
+    } else {
+      AddInt64(source.prototype, source.int64_value);
+    }
+  }
+}
+
+double MetricRollup::Sum(const vector<string>& names) const {
+  double result = 0;
+  for (const auto& name : names) {
+    auto it = entries_.find(name);
+    if (it == entries_.end()) {
+      continue;
+    }
+    const auto& entry = it->second;
+    if (entry.histogram) {
+      result += entry.histogram->TotalCount();
+    } else {
+      result += entry.is_double ? entry.double_value : entry.int64_value;
+    }
+  }
+  return result;
+}
+
+Status MetricRollup::WriteAsJson(JsonWriter* writer, const MetricJsonOptions& opts) const {
+  for (const auto& name_and_entry : entries_) {
+    const auto& entry = name_and_entry.second;
+    if (entry.histogram) {
+      HistogramSnapshotPB snapshot;
+      RETURN_NOT_OK(FillHistogramSnapshotPB(entry.prototype, *entry.histogram, opts, &snapshot));
+      writer->Protobuf(snapshot);
+      continue;
+    }
+    writer->StartObject();
+    entry.prototype->WriteFields(writer, opts);
+    writer->String("value");
+    if (entry.is_double) {
+      writer->Double(entry.double_value);
+    } else {
+      writer->Int64(entry.int64_value);
+    }
+    writer->EndObject();
+  }
+  return Status::OK();
 }
 
 ScopedLatencyMetric::ScopedLatencyMetric(Histogram* latency_hist)
@@ -239,9 +239,13 @@
 /////////////////////////////////////////////////////
 
 #include <algorithm>
+#include <atomic>
+#include <map>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <sstream>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
@@ -363,6 +367,7 @@ class Metric;
 class MetricEntityPrototype;
 class MetricPrototype;
 class MetricRegistry;
+class MetricRollup;
 
 class HdrHistogram;
 class Histogram;
@@ -421,10 +426,22 @@ class MetricType {
   static const char* const kHistogramType;
 };
 
+// Level at which metrics of tablet entities are exported.
+enum class MetricAggregationLevel {
+  // Every tablet is exported as is.
+  kTablet,
+  // Tablets are rolled up into a single "table" entity per table.
+  kTable,
+  // All tablets of the server are rolled up into a single "tablets" entity.
+  kServer,
+};
+
 struct MetricJsonOptions {
   MetricJsonOptions() :
     include_raw_histograms(false),
-    include_schema_info(false) {
+    include_schema_info(false),
+    level(MetricAggregationLevel::kTablet),
+    max_hot_tablets(0) {
   }
 
   // Include the raw histogram values and counts in the JSON output.
@@ -437,6 +454,16 @@ struct MetricJsonOptions {
   // unit, etc).
   // Default: false
   bool include_schema_info;
+
+  // Rollup level of tablet metrics. Counters and gauges are summed, histograms are merged.
+  // External metrics of tablets, i.e. RocksDB statistics, are not rolled up.
+  // Default: kTablet
+  MetricAggregationLevel level;
+
+  // When tablets are rolled up, the number of tablets with the most activity, as measured by
+  // --metrics_hot_tablet_metrics, that are also exported individually.
+  // Default: 0
+  int max_hot_tablets;
 };
 
 class MetricEntityPrototype {
@@ -492,12 +519,21 @@ class MetricEntity : public RefCountedThreadSafe<MetricEntity> {
 
   const std::string& id() const { return id_; }
 
+  // Returns a copy of the attributes of this entity.
+  AttributeMap attributes() const;
+
   // See MetricRegistry::WriteAsJson()
   CHECKED_STATUS WriteAsJson(JsonWriter* writer,
                      const std::vector<std::string>& requested_metrics,
                      const MetricJsonOptions& opts) const;
 
-  CHECKED_STATUS WriteForPrometheus(PrometheusWriter* writer) const;
+  // See MetricRegistry::WriteForPrometheus()
+  CHECKED_STATUS WriteForPrometheus(PrometheusWriter* writer,
+                                    const std::vector<std::string>& requested_metrics) const;
+
+  // Adds metrics of this entity that match requested_metrics to rollup.
+  void AddToRollup(const std::vector<std::string>& requested_metrics,
+                   MetricRollup* rollup) const;
 
   const MetricMap& UnsafeMetricsMapForTests() const { return metric_map_; }
 
@@ -573,7 +609,7 @@ typedef scoped_refptr<MetricEntity> MetricEntityPtr;
 
 class PrometheusWriter {
  public:
-  explicit PrometheusWriter(std::stringstream* output)
+  explicit PrometheusWriter(std::ostream* output)
     : output_(output),
       timestamp_(std::chrono::duration_cast<std::chrono::milliseconds>(
           std::chrono::system_clock::now().time_since_epoch()).count()) {}
@@ -587,10 +623,8 @@ class PrometheusWriter {
       if (per_table_attributes_.find(it->second) == per_table_attributes_.end()) {
         // If it's the first time we see this table, create the aggregate structures.
         per_table_attributes_[it->second] = attr;
-        per_table_values_[it->second];
-      } else {
-        per_table_values_[it->second][name] += value;
       }
+      per_table_values_[it->second][name] += value;
     } else {
       // For non-tablet level metrics, export them directly.
       RETURN_NOT_OK(FlushSingleEntry(attr, name, value));
@@ -626,7 +660,8 @@ class PrometheusWriter {
     }
     *output_ << " " << value;
     *output_ << " " << timestamp_;
-    *output_ << std::endl;
+    // Don't use std::endl, that would flush the output after every entry.
+    *output_ << '\n';
     return Status::OK();
   }
 
@@ -635,7 +670,7 @@ class PrometheusWriter {
   // Map from table_id to map of metric_name to value
   std::map<std::string, std::map<std::string, double>> per_table_values_;
   // Output stream
-  std::stringstream* output_;
+  std::ostream* output_;
   // Timestamp for all metrics belonging to this writer instance.
   int64_t timestamp_;
 };
@@ -653,6 +688,10 @@ class Metric : public RefCountedThreadSafe<Metric> {
   virtual CHECKED_STATUS WriteForPrometheus(
       PrometheusWriter* writer, const MetricEntity::AttributeMap& attr) const = 0;
 
+  // Adds current value of this metric to rollup. Metrics that could not be summed, e.g. string
+  // gauges, are not rolled up.
+  virtual void AddToRollup(MetricRollup* rollup) const {}
+
   const MetricPrototype* prototype() const { return prototype_; }
 
  protected:
@@ -673,6 +712,54 @@ class Metric : public RefCountedThreadSafe<Metric> {
   DISALLOW_COPY_AND_ASSIGN(Metric);
 };
 
+// Sum of the metrics of several entities, e.g. of all tablets of a table, exported as a single
+// entity. Histograms are merged, so percentiles of a rollup are as precise as of its parts.
+class MetricRollup {
+ public:
+  MetricRollup();
+  MetricRollup(MetricRollup&& rhs);
+  ~MetricRollup();
+
+  template <class T>
+  void AddValue(const MetricPrototype* prototype, T value) {
+    if (std::is_floating_point<T>::value) {
+      AddDouble(prototype, static_cast<double>(value));
+    } else {
+      AddInt64(prototype, static_cast<int64_t>(value));
+    }
+  }
+
+  void AddHistogram(const MetricPrototype* prototype, const HdrHistogram& histogram);
+
+  void MergeFrom(const MetricRollup& other);
+
+  // Returns sum of the metrics with the specified names. Histograms contribute their total count.
+  double Sum(const std::vector<std::string>& names) const;
+
+  // Writes rolled up metrics as elements of a JSON array.
+  CHECKED_STATUS WriteAsJson(JsonWriter* writer, const MetricJsonOptions& opts) const;
+
+  bool empty() const { return entries_.empty(); }
+
+ private:
+  struct Entry {
+    const MetricPrototype* prototype = nullptr;
+    bool is_double = false;
+    int64_t int64_value = 0;
+    double double_value = 0;
+    std::unique_ptr<HdrHistogram> histogram;
+  };
+
+  void AddInt64(const MetricPrototype* prototype, int64_t value);
+  void AddDouble(const MetricPrototype* prototype, double value);
+  Entry& GetEntry(const MetricPrototype* prototype);
+
+  // Ordered by name, so output is sorted like the one of MetricEntity.
+  std::map<std::string, Entry> entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(MetricRollup);
+};
+
 // Registry of all the metrics for a server.
 //
 // This aggregates the MetricEntity objects associated with the server.
@@ -693,13 +780,20 @@ class MetricRegistry {
   // The string matching can either match an entity ID or a metric name.
   // If it matches an entity ID, then all metrics for that entity will be printed.
   //
+  // When opts.level rolls tablets up, "table" or "tablets" entities are printed instead of
+  // the tablets, followed by the opts.max_hot_tablets most active tablets.
+  //
   // See the MetricJsonOptions struct definition above for options changing the
   // output of this function.
   CHECKED_STATUS WriteAsJson(JsonWriter* writer,
                      const std::vector<std::string>& requested_metrics,
                      const MetricJsonOptions& opts) const;
 
-  CHECKED_STATUS WriteForPrometheus(PrometheusWriter* writer) const;
+  // Writes metrics of the entities matching requested_metrics for Prometheus. Matching is the
+  // same as in WriteAsJson(), an empty list selects all metrics. Filtering is done before
+  // formatting, so unselected metrics cost nothing.
+  CHECKED_STATUS WriteForPrometheus(PrometheusWriter* writer,
+                                    const std::vector<std::string>& requested_metrics) const;
 
   // For each registered entity, retires orphaned metrics. If an entity has no more
   // metrics and there are no external references, entities are removed as well.
@@ -918,6 +1012,10 @@ class AtomicGauge : public Gauge {
     return writer->WriteSingleEntry(attr, prototype_->name(), value());
   }
 
+  void AddToRollup(MetricRollup* rollup) const override {
+    rollup->AddValue(prototype_, value());
+  }
+
  protected:
   virtual void WriteValue(JsonWriter* writer) const override {
     writer->Value(value());
@@ -1038,6 +1136,10 @@ class FunctionGauge : public Gauge {
     return writer->WriteSingleEntry(attr, prototype_->name(), value());
   }
 
+  void AddToRollup(MetricRollup* rollup) const override {
+    rollup->AddValue(prototype_, value());
+  }
+
  private:
   friend class MetricEntity;
 
@@ -1084,6 +1186,8 @@ class Counter : public Metric {
   CHECKED_STATUS WriteForPrometheus(
       PrometheusWriter* writer, const MetricEntity::AttributeMap& attr) const override;
 
+  void AddToRollup(MetricRollup* rollup) const override;
+
  private:
   FRIEND_TEST(MetricsTest, SimpleCounterTest);
   FRIEND_TEST(MultiThreadedMetricsTest, CounterIncrementTest);
@@ -1111,8 +1215,15 @@ class HistogramPrototype : public MetricPrototype {
   DISALLOW_COPY_AND_ASSIGN(HistogramPrototype);
 };
 
+// Histogram starts with a single HdrHistogram. Once concurrent increments of it by different
+// threads are detected, it allocates up to --histogram_max_stripes extra HdrHistograms, and each
+// thread increments its own stripe from then on. So hot histograms do not bounce the same cache
+// lines between CPUs, while the majority of histograms, e.g. per tablet ones, keep the memory
+// footprint of a single HdrHistogram. Stripes are merged only when the histogram is read.
 class Histogram : public Metric {
  public:
+  ~Histogram();
+
   // Increment the histogram for the given value.
   // 'value' must be non-negative.
   void Increment(int64_t value);
@@ -1131,6 +1242,8 @@ class Histogram : public Metric {
   CHECKED_STATUS WriteForPrometheus(
       PrometheusWriter* writer, const MetricEntity::AttributeMap& attr) const override;
 
+  void AddToRollup(MetricRollup* rollup) const override;
+
   // Returns a snapshot of this histogram including the bucketed values and counts.
   CHECKED_STATUS GetHistogramSnapshotPB(HistogramSnapshotPB* snapshot,
                                 const MetricJsonOptions& opts) const;
@@ -1145,7 +1258,17 @@ class Histogram : public Metric {
   friend class MetricEntity;
   explicit Histogram(const HistogramPrototype* proto);
 
+  struct Stripes;
+
+  void AllocateStripes();
+
+  // Merges values of all stripes into snapshot, that should be created as a copy of histogram_.
+  void MergeStripes(HdrHistogram* snapshot) const;
+
   const gscoped_ptr<HdrHistogram> histogram_;
+
+  // Set once, when contention on histogram_ is detected. Owned by this histogram.
+  std::atomic<Stripes*> stripes_{nullptr};
   DISALLOW_COPY_AND_ASSIGN(Histogram);
 };
 
@@ -40,6 +40,7 @@
 #include "yb/gutil/ref_counted.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/util/debug/leakcheck_disabler.h"
+#include "yb/util/histogram.pb.h"
 #include "yb/util/jsonwriter.h"
 #include "yb/util/metrics.h"
 #include "yb/util/monotime.h"
@@ -48,6 +49,13 @@
 
 DEFINE_int32(mt_metrics_test_num_threads, 4,
              "Number of threads to spawn in mt metrics tests");
+DEFINE_int32(mt_metrics_test_histogram_threads, 64,
+             "Number of threads that concurrently increment the histogram in "
+             "HistogramIncrementBenchmark");
+DEFINE_int32(mt_metrics_test_histogram_increments, 100000,
+             "Number of increments done by each thread in HistogramIncrementBenchmark");
+
+DECLARE_int32(histogram_max_stripes);
 
 METRIC_DEFINE_entity(test_entity);
 
@@ -98,6 +106,44 @@ TEST_F(MultiThreadedMetricsTest, CounterIncrementTest) {
   ASSERT_EQ(num_threads * num_increments, counter->value());
 }
 
+METRIC_DEFINE_histogram(test_entity, test_histogram, "Test Histogram",
+                        MetricUnit::kMicroseconds, "Test histogram", 60000000LU, 2);
+
+static void IncrementHistogram(scoped_refptr<Histogram> histogram, int num_increments) {
+  for (int i = 0; i < num_increments; i++) {
+    histogram->Increment(i % 10000);
+  }
+}
+
+// Compares recording overhead of a histogram incremented by many threads with and without
+// striping.
+TEST_F(MultiThreadedMetricsTest, HistogramIncrementBenchmark) {
+  const int num_threads = FLAGS_mt_metrics_test_histogram_threads;
+  const int num_increments = FLAGS_mt_metrics_test_histogram_increments;
+  for (int max_stripes : {1, 16}) {
+    FLAGS_histogram_max_stripes = max_stripes;
+    scoped_refptr<MetricEntity> entity = METRIC_ENTITY_test_entity.Instantiate(
+        &registry_, strings::Substitute("histogram-$0", max_stripes));
+    scoped_refptr<Histogram> histogram = METRIC_test_histogram.Instantiate(entity);
+    std::function<void()> f = std::bind(IncrementHistogram, histogram, num_increments);
+    MonoTime start = MonoTime::Now();
+    RunWithManyThreads(&f, num_threads);
+    MonoDelta elapsed = MonoTime::Now().GetDeltaSince(start);
+    LOG(INFO) << "Max stripes: " << max_stripes << ", threads: " << num_threads
+              << ", time per increment in each thread: "
+              << elapsed.ToNanoseconds() / num_increments << "ns"
+              << ", total time: " << elapsed;
+
+    const uint64_t expected_count = static_cast<uint64_t>(num_threads) * num_increments;
+    ASSERT_EQ(expected_count, histogram->TotalCount());
+    HistogramSnapshotPB snapshot;
+    ASSERT_OK(histogram->GetHistogramSnapshotPB(&snapshot, MetricJsonOptions()));
+    ASSERT_EQ(expected_count, snapshot.total_count());
+    ASSERT_EQ(0, snapshot.min());
+    ASSERT_EQ(std::min(num_increments - 1, 9999), snapshot.max());
+  }
+}
+
 // Helper function to register a bunch of counters in a loop.
 void MultiThreadedMetricsTest::RegisterCounters(
     const scoped_refptr<MetricEntity>& metric_entity,
@@ -38,6 +38,9 @@
 #include <netinet/tcp.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#if defined(__linux__)
+#include <sys/sendfile.h>
+#endif
 #include <unistd.h>
 
 #include <limits>
@@ -457,6 +460,39 @@ Status Socket::Writev(const struct ::iovec *iov, int iov_len,
   return Status::OK();
 }
 
+Status Socket::SendFile(int file_fd, uint64_t offset, size_t count, int32_t *nwritten) {
+  DCHECK_GE(fd_, 0);
+  count = std::min<size_t>(count, std::numeric_limits<int32_t>::max());
+#if defined(__linux__)
+  off_t file_offset = offset;
+  ssize_t res = ::sendfile(fd_, file_fd, &file_offset, count);
+  if (PREDICT_FALSE(res < 0)) {
+    int err = errno;
+    return STATUS(NetworkError, std::string("sendfile error: ") + ErrnoToString(err), Slice(), err);
+  }
+  if (res == 0 && count != 0) {
+    return STATUS(IOError, "Unexpected end of file");
+  }
+#else
+  // No zero-copy path here, so read the data with pread() and write it as usual.
+  constexpr size_t kBufferSize = 64 * 1024;
+  uint8_t buffer[kBufferSize];
+  ssize_t res = ::pread(file_fd, buffer, std::min(count, kBufferSize), offset);
+  if (PREDICT_FALSE(res < 0)) {
+    int err = errno;
+    return STATUS(IOError, std::string("pread error: ") + ErrnoToString(err), Slice(), err);
+  }
+  if (res == 0 && count != 0) {
+    return STATUS(IOError, "Unexpected end of file");
+  }
+  int32_t written = 0;
+  RETURN_NOT_OK(Write(buffer, static_cast<int32_t>(res), &written));
+  res = written;
+#endif
+  *nwritten = static_cast<int32_t>(res);
+  return Status::OK();
+}
+
 // Mostly follows writen() from Stevens (2004) or Kerrisk (2010).
 Status Socket::BlockingWrite(const uint8_t *buf, size_t buflen, size_t *nwritten,
     const MonoTime& deadline) {
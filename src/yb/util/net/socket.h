@@ -133,6 +133,10 @@ class Socket {
 
   CHECKED_STATUS Writev(const struct ::iovec *iov, int iov_len, int32_t *nwritten);
 
+  // Sends up to 'count' bytes of the file 'file_fd' starting at 'offset'. On Linux the data goes
+  // from the page cache to the socket with sendfile(2), without being copied to user space.
+  CHECKED_STATUS SendFile(int file_fd, uint64_t offset, size_t count, int32_t *nwritten);
+
   // Blocking Write call, returns IOError unless full buffer is sent.
   // Underlying Socket expected to be in blocking mode. Fails if any Write() sends 0 bytes.
   // Returns OK if buflen bytes were sent, otherwise IOError.
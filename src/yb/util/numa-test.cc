@@ -0,0 +1,37 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <gtest/gtest.h>
+
+#include "yb/util/numa.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+
+class NumaTest : public YBTest {
+};
+
+TEST_F(NumaTest, ParseCpuList) {
+  ASSERT_EQ(std::vector<int>(), ASSERT_RESULT(ParseCpuList("\n")));
+  ASSERT_EQ(std::vector<int>({0, 1, 2, 3, 8, 10, 11}),
+            ASSERT_RESULT(ParseCpuList("0-3,8,10-11\n")));
+  ASSERT_NOK(ParseCpuList("3-1"));
+  ASSERT_NOK(ParseCpuList("1-2-3"));
+  ASSERT_NOK(ParseCpuList("x"));
+
+  ASSERT_GE(NumaNodeCount(), 1U);
+  ASSERT_LT(CurrentNumaNode(), NumaNodeCount());
+}
+
+} // namespace yb
@@ -0,0 +1,146 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/numa.h"
+
+#include <sched.h>
+
+#include <fstream>
+
+#include <boost/algorithm/string/trim.hpp>
+
+#include "yb/gutil/strings/split.h"
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/logging.h"
+#include "yb/util/stol_utils.h"
+
+DEFINE_bool(numa_aware_placement, false,
+            "Whether reactor and RPC worker threads are spread over NUMA nodes and bound to their "
+            "CPUs, and outbound calls are sent through a reactor on the NUMA node of the caller, "
+            "so request processing does not cross sockets.");
+TAG_FLAG(numa_aware_placement, advanced);
+
+namespace yb {
+
+namespace {
+
+class NumaTopology {
+ public:
+  NumaTopology() {
+#if defined(__linux__)
+    for (size_t node = 0;; ++node) {
+      std::ifstream input("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+      std::string line;
+      if (!input || !std::getline(input, line)) {
+        break;
+      }
+      auto cpus = ParseCpuList(line);
+      if (!cpus.ok()) {
+        LOG(WARNING) << "Failed to parse CPUs of NUMA node " << node << ": " << cpus.status();
+        node_cpus_.clear();
+        cpu_nodes_.clear();
+        break;
+      }
+      for (auto cpu : *cpus) {
+        if (cpu_nodes_.size() <= static_cast<size_t>(cpu)) {
+          cpu_nodes_.resize(cpu + 1);
+        }
+        cpu_nodes_[cpu] = node;
+      }
+      node_cpus_.push_back(std::move(*cpus));
+    }
+#endif
+  }
+
+  size_t NodeCount() const {
+    return std::max<size_t>(node_cpus_.size(), 1);
+  }
+
+  size_t NodeOfCpu(int cpu) const {
+    return cpu >= 0 && static_cast<size_t>(cpu) < cpu_nodes_.size() ? cpu_nodes_[cpu] : 0;
+  }
+
+  const std::vector<int>& CpusOfNode(size_t node) const {
+    return node_cpus_[node];
+  }
+
+ private:
+  std::vector<std::vector<int>> node_cpus_;
+  std::vector<size_t> cpu_nodes_;
+};
+
+const NumaTopology& Topology() {
+  static const NumaTopology topology;
+  return topology;
+}
+
+} // namespace
+
+Result<std::vector<int>> ParseCpuList(const std::string& cpu_list) {
+  std::vector<int> result;
+  const auto trimmed = boost::algorithm::trim_copy(cpu_list);
+  if (trimmed.empty()) {
+    return result;
+  }
+  for (const auto& range : strings::Split(trimmed, ",")) {
+    std::vector<std::string> bounds = strings::Split(range, "-");
+    if (bounds.size() > 2) {
+      return STATUS_FORMAT(InvalidArgument, "Bad CPU range $0 in $1", range.ToString(), cpu_list);
+    }
+    const auto first = VERIFY_RESULT(util::CheckedStoi(bounds[0]));
+    const auto last = bounds.size() == 2 ? VERIFY_RESULT(util::CheckedStoi(bounds[1])) : first;
+    if (first < 0 || last < first) {
+      return STATUS_FORMAT(InvalidArgument, "Bad CPU range $0 in $1", range.ToString(), cpu_list);
+    }
+    for (auto cpu = first; cpu <= last; ++cpu) {
+      result.push_back(cpu);
+    }
+  }
+  return result;
+}
+
+size_t NumaNodeCount() {
+  return Topology().NodeCount();
+}
+
+bool NumaAwarePlacementEnabled() {
+  return FLAGS_numa_aware_placement && NumaNodeCount() > 1;
+}
+
+size_t CurrentNumaNode() {
+#if defined(__linux__)
+  return Topology().NodeOfCpu(sched_getcpu());
+#else
+  return 0;
+#endif
+}
+
+void MaybeBindCurrentThreadToNumaNode(size_t index) {
+  if (!NumaAwarePlacementEnabled()) {
+    return;
+  }
+#if defined(__linux__)
+  const auto node = index % NumaNodeCount();
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (auto cpu : Topology().CpusOfNode(node)) {
+    CPU_SET(cpu, &cpu_set);
+  }
+  if (sched_setaffinity(0, sizeof(cpu_set), &cpu_set) != 0) {
+    PLOG(WARNING) << "Failed to bind thread to NUMA node " << node;
+  }
+#endif
+}
+
+} // namespace yb
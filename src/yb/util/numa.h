@@ -0,0 +1,42 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_NUMA_H
+#define YB_UTIL_NUMA_H
+
+#include <string>
+#include <vector>
+
+#include "yb/util/result.h"
+
+namespace yb {
+
+// Parses CPU list in the format used by sysfs, for instance "0-3,8,10-11".
+Result<std::vector<int>> ParseCpuList(const std::string& cpu_list);
+
+// Number of NUMA nodes of this host, 1 when the topology is not available. Topology is read once.
+size_t NumaNodeCount();
+
+// Returns true if --numa_aware_placement is set and the host has more than one NUMA node.
+bool NumaAwarePlacementEnabled();
+
+// NUMA node of the CPU that the current thread runs on, 0 when it is not known.
+size_t CurrentNumaNode();
+
+// Restricts the current thread to CPUs of NUMA node index % NumaNodeCount() when NUMA aware
+// placement is enabled. Memory first touched by the thread is then allocated on that node.
+void MaybeBindCurrentThreadToNumaNode(size_t index);
+
+} // namespace yb
+
+#endif // YB_UTIL_NUMA_H
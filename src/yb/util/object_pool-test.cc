@@ -96,4 +96,23 @@ TEST(TestObjectPool, TestScopedPtr) {
   ASSERT_EQ(0, MyClass::instance_count());
 }
 
+TEST(TestObjectPool, TestPooledAllocator) {
+  MyClass::ResetCount();
+  const int kIterations = 100;
+  PooledAllocator<MyClass> allocator;
+  void* last_address = nullptr;
+  int num_reused = 0;
+  for (int i = 0; i != kIterations; ++i) {
+    auto object = std::allocate_shared<MyClass>(allocator);
+    ASSERT_EQ(1, MyClass::instance_count());
+    // The thread could move to another CPU between iterations, so not every object is reused.
+    if (object.get() == last_address) {
+      ++num_reused;
+    }
+    last_address = object.get();
+  }
+  ASSERT_EQ(0, MyClass::instance_count());
+  ASSERT_GT(num_reused, kIterations / 2);
+}
+
 } // namespace yb
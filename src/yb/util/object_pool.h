@@ -35,7 +35,11 @@
 #define YB_UTIL_OBJECT_POOL_H
 
 #include <stdint.h>
+
+#include <functional>
+#include <memory>
 #include <thread>
+#include <type_traits>
 
 #include <boost/container/stable_vector.hpp>
 #include <boost/lockfree/stack.hpp>
@@ -241,6 +245,56 @@ class ThreadSafeObjectPool {
   boost::container::stable_vector<Pool> pools_;
 };
 
+// Allocator that keeps memory of freed objects in per-CPU free lists of the allocated type, so
+// objects that are frequently created and destroyed don't go through malloc. Used with
+// std::allocate_shared, that allocates the object together with its control block.
+template <class T>
+class PooledAllocator {
+ public:
+  typedef T value_type;
+
+  PooledAllocator() = default;
+
+  template <class U>
+  PooledAllocator(const PooledAllocator<U>& rhs) {} // NOLINT
+
+  T* allocate(size_t n) {
+    if (n != 1) {
+      return std::allocator<T>().allocate(n);
+    }
+    return static_cast<T*>(static_cast<void*>(Pool().Take()));
+  }
+
+  void deallocate(T* p, size_t n) {
+    if (n != 1) {
+      std::allocator<T>().deallocate(p, n);
+      return;
+    }
+    Pool().Release(static_cast<Storage*>(static_cast<void*>(p)));
+  }
+
+  template <class U>
+  bool operator==(const PooledAllocator<U>& rhs) const {
+    return true;
+  }
+
+  template <class U>
+  bool operator!=(const PooledAllocator<U>& rhs) const {
+    return false;
+  }
+
+ private:
+  typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type Storage;
+
+  // The pool is never destroyed, since pooled objects could be freed during process shutdown.
+  static ThreadSafeObjectPool<Storage>& Pool() {
+    static ThreadSafeObjectPool<Storage>* pool = new ThreadSafeObjectPool<Storage>([] {
+      return new Storage;
+    });
+    return *pool;
+  }
+};
+
 } // namespace yb
 
 #endif // YB_UTIL_OBJECT_POOL_H
@@ -662,7 +662,7 @@ Status WritePBContainerToPath(Env* env, const std::string& path,
   WritablePBContainerFile pb_file(file.Pass());
   RETURN_NOT_OK(pb_file.Init(msg));
   RETURN_NOT_OK(pb_file.Append(msg));
-  if (sync == pb_util::SYNC) {
+  if (sync == pb_util::SYNC || sync == pb_util::SYNC_FILE_ONLY) {
     RETURN_NOT_OK(pb_file.Sync());
   }
   RETURN_NOT_OK(pb_file.Close());
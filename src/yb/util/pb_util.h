@@ -66,7 +66,10 @@ using google::protobuf::MessageLite;
 
 enum SyncMode {
   SYNC,
-  NO_SYNC
+  NO_SYNC,
+  // Sync the file, but not its parent directory. The caller is responsible for syncing the
+  // directory, e.g. once for a group of files.
+  SYNC_FILE_ONLY
 };
 
 enum CreateMode {
@@ -313,6 +316,7 @@ Status ReadPBContainerFromPath(Env* env, const std::string& path,
 //
 // If create == NO_OVERWRITE and 'path' already exists, the function will fail.
 // If sync == SYNC, the newly created file will be fsynced before returning.
+// If sync == SYNC_FILE_ONLY, the file is fsynced, but its parent directory is not.
 Status WritePBContainerToPath(Env* env, const std::string& path,
                               const google::protobuf::Message& msg,
                               CreateMode create,
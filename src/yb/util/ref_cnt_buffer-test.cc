@@ -22,6 +22,7 @@
 #include <gtest/gtest.h>
 
 #include "yb/util/ref_cnt_buffer.h"
+#include "yb/util/slice.h"
 
 #include "yb/util/test_util.h"
 
@@ -51,6 +52,16 @@ TEST_F(RefCntBufferTest, TestSize) {
   }
 }
 
+// Test that a buffer without data is empty.
+TEST_F(RefCntBufferTest, TestNull) {
+  RefCntBuffer buffer;
+  ASSERT_FALSE(buffer);
+  ASSERT_EQ(0, buffer.size());
+  ASSERT_TRUE(buffer.empty());
+  Slice slice(buffer);
+  ASSERT_TRUE(slice.empty());
+}
+
 // Test buffer allocation by data block.
 TEST_F(RefCntBufferTest, TestFromData) {
   unsigned int seed = SeedRandom();
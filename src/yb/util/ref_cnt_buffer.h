@@ -53,7 +53,7 @@ class RefCntBuffer {
   ~RefCntBuffer();
 
   size_t size() const {
-    return size_reference();
+    return data_ ? size_reference() : 0;
   }
 
   bool empty() const {
@@ -0,0 +1,72 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <gtest/gtest.h>
+
+#include "yb/util/request_timeline.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+
+class RequestTimelineTest : public YBTest {
+};
+
+TEST_F(RequestTimelineTest, Record) {
+  RequestTimelinePtr timeline(new RequestTimeline);
+  ASSERT_EQ(0, timeline->size());
+  ASSERT_EQ(0, timeline->TotalMicros());
+
+  timeline->Record(RequestPhase::kReceived);
+  SleepFor(MonoDelta::FromMilliseconds(10));
+  timeline->Record(RequestPhase::kHandlingStarted);
+  timeline->Record(RequestPhase::kResponded);
+
+  ASSERT_EQ(3, timeline->size());
+  ASSERT_EQ(RequestPhase::kReceived, timeline->entry(0).phase);
+  ASSERT_EQ(RequestPhase::kHandlingStarted, timeline->entry(1).phase);
+  ASSERT_EQ(RequestPhase::kResponded, timeline->entry(2).phase);
+  ASSERT_EQ(0, timeline->MicrosSincePrevious(0));
+  ASSERT_GE(timeline->MicrosSincePrevious(1), 10000);
+  ASSERT_EQ(timeline->TotalMicros(),
+            timeline->MicrosSincePrevious(1) + timeline->MicrosSincePrevious(2));
+  LOG(INFO) << "Timeline: " << timeline->ToString();
+}
+
+TEST_F(RequestTimelineTest, Wraparound) {
+  RequestTimelinePtr timeline(new RequestTimeline);
+  for (size_t i = 0; i != RequestTimeline::kCapacity; ++i) {
+    timeline->Record(RequestPhase::kApplied);
+  }
+  timeline->Record(RequestPhase::kResponded);
+
+  // Only the last kCapacity entries are kept.
+  ASSERT_EQ(RequestTimeline::kCapacity, timeline->size());
+  ASSERT_EQ(RequestPhase::kApplied, timeline->entry(0).phase);
+  ASSERT_EQ(RequestPhase::kResponded, timeline->entry(RequestTimeline::kCapacity - 1).phase);
+}
+
+TEST_F(RequestTimelineTest, Adopt) {
+  ASSERT_EQ(nullptr, RequestTimeline::Current());
+  RequestTimelinePtr timeline(new RequestTimeline);
+  {
+    ADOPT_REQUEST_TIMELINE(timeline.get());
+    ASSERT_EQ(timeline.get(), RequestTimeline::Current());
+    REQUEST_TIMELINE_RECORD(RequestPhase::kHandlingStarted);
+  }
+  ASSERT_EQ(nullptr, RequestTimeline::Current());
+  // Does nothing without adopted timeline.
+  REQUEST_TIMELINE_RECORD(RequestPhase::kResponded);
+  ASSERT_EQ(1, timeline->size());
+}
+
+} // namespace yb
@@ -0,0 +1,83 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/request_timeline.h"
+
+#include <algorithm>
+
+#include <glog/logging.h>
+
+#include "yb/gutil/strings/substitute.h"
+#include "yb/gutil/sysinfo.h"
+#include "yb/gutil/walltime.h"
+
+namespace yb {
+
+namespace {
+
+const double kMicrosPerSecond = 1000000.0;
+
+} // namespace
+
+__thread RequestTimeline* RequestTimeline::threadlocal_timeline_;
+
+void RequestTimeline::Record(RequestPhase phase) {
+  auto& entry = entries_[num_recorded_.fetch_add(1, std::memory_order_acq_rel) % kCapacity];
+  entry.phase = phase;
+  entry.cycles = CycleClock::Now();
+}
+
+size_t RequestTimeline::size() const {
+  return std::min(num_recorded_.load(std::memory_order_acquire), kCapacity);
+}
+
+size_t RequestTimeline::first_index() const {
+  auto num_recorded = num_recorded_.load(std::memory_order_acquire);
+  return num_recorded > kCapacity ? num_recorded - kCapacity : 0;
+}
+
+const RequestTimeline::Entry& RequestTimeline::entry(size_t i) const {
+  DCHECK_LT(i, size());
+  return entries_[(first_index() + i) % kCapacity];
+}
+
+int64_t RequestTimeline::MicrosSinceStart(size_t i) const {
+  return CyclesToMicros(entry(i).cycles - entry(0).cycles);
+}
+
+int64_t RequestTimeline::MicrosSincePrevious(size_t i) const {
+  return i == 0 ? 0 : CyclesToMicros(entry(i).cycles - entry(i - 1).cycles);
+}
+
+int64_t RequestTimeline::TotalMicros() const {
+  auto count = size();
+  return count == 0 ? 0 : MicrosSinceStart(count - 1);
+}
+
+std::string RequestTimeline::ToString() const {
+  std::string result = "[";
+  for (size_t i = 0, count = size(); i != count; ++i) {
+    if (i != 0) {
+      result += ", ";
+    }
+    result += strings::Substitute("$0: +$1us", ::yb::ToString(entry(i).phase), MicrosSinceStart(i));
+  }
+  result += "]";
+  return result;
+}
+
+int64_t RequestTimeline::CyclesToMicros(int64_t cycles) {
+  return static_cast<int64_t>(cycles / base::CyclesPerSecond() * kMicrosPerSecond);
+}
+
+} // namespace yb
@@ -0,0 +1,138 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_REQUEST_TIMELINE_H
+#define YB_UTIL_REQUEST_TIMELINE_H
+
+#include <atomic>
+#include <string>
+
+#include "yb/gutil/ref_counted.h"
+
+#include "yb/util/enums.h"
+
+// Records the specified phase in the timeline adopted by the current thread, if any.
+#define REQUEST_TIMELINE_RECORD(phase) \
+  do { \
+    yb::RequestTimeline* _timeline = yb::RequestTimeline::Current(); \
+    if (_timeline) { \
+      _timeline->Record(phase); \
+    } \
+  } while (0)
+
+// Adopts the timeline on the current thread for the duration of the current scope.
+#define ADOPT_REQUEST_TIMELINE(t) yb::ScopedAdoptRequestTimeline _adopt_request_timeline(t);
+
+namespace yb {
+
+// Points on the hot path of a request, in the order they are normally passed. Requests that do not
+// replicate anything, e.g. reads, go from kHandlingStarted directly to kResponded.
+YB_DEFINE_ENUM(RequestPhase,
+    // The call was parsed by the reactor thread.
+    (kReceived)
+    // The call was taken from the service queue by the worker thread.
+    (kHandlingStarted)
+    // The operation of the call was submitted to the tablet preparer.
+    (kSubmittedToPreparer)
+    // The operation was prepared, i.e. locks acquired and hybrid time assigned.
+    (kPrepared)
+    // The operation was replicated by Raft to the majority.
+    (kReplicated)
+    // The operation was applied to the tablet.
+    (kApplied)
+    // The response was queued to the connection.
+    (kResponded));
+
+// Compact timeline of request processing, that is cheap enough to be always on. Consists of a
+// fixed-size ring of (phase, CPU cycle counter) pairs, so recording a phase does not allocate,
+// lock or format anything. Phases could be recorded by different threads, while the timeline
+// should be read only after the request is completed, i.e. after the last phase is recorded.
+class RequestTimeline : public RefCountedThreadSafe<RequestTimeline> {
+ public:
+  static constexpr size_t kCapacity = 16;
+
+  struct Entry {
+    RequestPhase phase;
+    int64_t cycles;
+  };
+
+  RequestTimeline() = default;
+
+  RequestTimeline(const RequestTimeline&) = delete;
+  void operator=(const RequestTimeline&) = delete;
+
+  void Record(RequestPhase phase);
+
+  // Number of entries available, i.e. the last kCapacity recorded entries are kept.
+  size_t size() const;
+
+  // Returns i-th available entry, in the order of recording.
+  const Entry& entry(size_t i) const;
+
+  // Returns the time elapsed between the first available entry and the i-th one.
+  int64_t MicrosSinceStart(size_t i) const;
+
+  // Returns the time elapsed between the entry preceding the i-th one and the i-th one. Returns 0
+  // for the first entry.
+  int64_t MicrosSincePrevious(size_t i) const;
+
+  // Total time between the first and the last available entries.
+  int64_t TotalMicros() const;
+
+  std::string ToString() const;
+
+  // Return the timeline adopted by the current thread, if there is one.
+  static RequestTimeline* Current() {
+    return threadlocal_timeline_;
+  }
+
+  static int64_t CyclesToMicros(int64_t cycles);
+
+ private:
+  friend class ScopedAdoptRequestTimeline;
+  friend class RefCountedThreadSafe<RequestTimeline>;
+  ~RequestTimeline() = default;
+
+  size_t first_index() const;
+
+  static __thread RequestTimeline* threadlocal_timeline_;
+
+  std::atomic<size_t> num_recorded_{0};
+  Entry entries_[kCapacity];
+};
+
+typedef scoped_refptr<RequestTimeline> RequestTimelinePtr;
+
+// Adopts a timeline into the current thread for the duration of this object. This should only be
+// used on the stack.
+class ScopedAdoptRequestTimeline {
+ public:
+  explicit ScopedAdoptRequestTimeline(RequestTimeline* timeline)
+      : old_timeline_(RequestTimeline::threadlocal_timeline_) {
+    RequestTimeline::threadlocal_timeline_ = timeline;
+  }
+
+  ~ScopedAdoptRequestTimeline() {
+    RequestTimeline::threadlocal_timeline_ = old_timeline_;
+  }
+
+  ScopedAdoptRequestTimeline(const ScopedAdoptRequestTimeline&) = delete;
+  void operator=(const ScopedAdoptRequestTimeline&) = delete;
+
+ private:
+  RequestTimeline* old_timeline_;
+};
+
+} // namespace yb
+
+#endif // YB_UTIL_REQUEST_TIMELINE_H
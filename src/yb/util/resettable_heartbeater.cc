@@ -55,6 +55,7 @@ class ResettableHeartbeaterThread {
   Status Start();
   Status Stop();
   void Reset();
+  void SetPeriod(MonoDelta period);
 
  private:
   void RunThread();
@@ -63,7 +64,7 @@ class ResettableHeartbeaterThread {
   const string name_;
 
   // The heartbeat period.
-  const MonoDelta period_;
+  MonoDelta period_;
 
   // The function to call to perform the heartbeat
   const HeartbeatFunction function_;
@@ -76,7 +77,7 @@ class ResettableHeartbeaterThread {
   // Whether the heartbeater should shutdown.
   bool shutdown_;
 
-  // lock that protects access to 'shutdown_' and to 'run_latch_'
+  // lock that protects access to 'shutdown_', 'period_' and to 'run_latch_'
   // Reset() method.
   mutable simple_spinlock lock_;
   DISALLOW_COPY_AND_ASSIGN(ResettableHeartbeaterThread);
@@ -99,6 +100,10 @@ void ResettableHeartbeater::Reset() {
   thread_->Reset();
 }
 
+void ResettableHeartbeater::SetPeriod(MonoDelta period) {
+  thread_->SetPeriod(period);
+}
+
 ResettableHeartbeater::~ResettableHeartbeater() {
   WARN_NOT_OK(Stop(), "Unable to stop heartbeater thread");
 }
@@ -118,12 +123,16 @@ void ResettableHeartbeaterThread::RunThread() {
   bool prev_reset_was_manual = false;
   Random rng(random());
   while (true) {
-    MonoDelta wait_period = period_;
+    MonoDelta wait_period;
+    {
+      std::lock_guard<simple_spinlock> lock(lock_);
+      wait_period = period_;
+    }
     if (prev_reset_was_manual) {
       // When the caller does a manual reset, we randomize the subsequent wait
       // timeout between period_/2 and period_. This builds in some jitter so
       // multiple tablets on the same TS don't end up heartbeating in lockstep.
-      int64_t half_period_ms = period_.ToMilliseconds() / 2;
+      int64_t half_period_ms = wait_period.ToMilliseconds() / 2;
       wait_period = MonoDelta::FromMilliseconds(
           half_period_ms +
           rng.NextDoubleFraction() * half_period_ms);
@@ -167,6 +176,11 @@ Status ResettableHeartbeaterThread::Start() {
                               this, &thread_);
 }
 
+void ResettableHeartbeaterThread::SetPeriod(MonoDelta period) {
+  std::lock_guard<simple_spinlock> lock(lock_);
+  period_ = period;
+}
+
 void ResettableHeartbeaterThread::Reset() {
   if (!thread_) {
     return;
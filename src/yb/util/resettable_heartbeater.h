@@ -82,6 +82,10 @@ class ResettableHeartbeater {
   // may trigger before a full period (as specified to the constructor).
   void Reset();
 
+  // Changes the heartbeat period, starting from the next heartbeat. Call Reset() to apply it to
+  // the current wait.
+  void SetPeriod(MonoDelta period);
+
   ~ResettableHeartbeater();
  private:
   gscoped_ptr<ResettableHeartbeaterThread> thread_;
@@ -48,6 +48,7 @@
 #include "yb/gutil/strings/fastmem.h"
 #include "yb/gutil/strings/stringpiece.h"
 #include "yb/util/faststring.h"
+#include "yb/util/ref_cnt_buffer.h"
 #endif
 #include "yb/util/cast.h"
 
@@ -102,6 +103,13 @@ class Slice {
     : data_(reinterpret_cast<const uint8_t*>(s.data())),
       size_(s.size()) {
   }
+
+  // Create a slice that refers to the contents of the buffer.
+  // The buffer should be kept alive while this slice is used.
+  Slice(const RefCntBuffer& buffer) // NOLINT(runtime/explicit)
+    : data_(buffer ? buffer.udata() : reinterpret_cast<const uint8_t*>("")),
+      size_(buffer.size()) {
+  }
 #endif
 
   // Create a single slice from SliceParts using buf as storage.
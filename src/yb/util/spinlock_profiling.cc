@@ -41,9 +41,11 @@
 #include "yb/gutil/spinlock.h"
 #include "yb/gutil/strings/human_readable.h"
 #include "yb/gutil/sysinfo.h"
+#include "yb/util/continuous_profiler.h"
 #include "yb/util/debug-util.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/metrics.h"
+#include "yb/util/stack_trace_table.h"
 #include "yb/util/striped64.h"
 #include "yb/util/trace.h"
 
@@ -61,8 +63,6 @@ METRIC_DEFINE_gauge_uint64(server, spinlock_contention_time,
     "internals triggered by a particular workload and warrant investigation.",
     yb::EXPOSE_AS_COUNTER);
 
-using base::SpinLockHolder;
-
 namespace yb {
 
 static const double kMicrosPerSecond = 1000000.0;
@@ -71,153 +71,8 @@ static LongAdder* g_contended_cycles = nullptr;
 
 namespace {
 
-// Implements a very simple linear-probing hashtable of stack traces with
-// a fixed number of entries.
-//
-// Threads experiencing contention record their stacks into this hashtable,
-// or increment an already-existing entry. Each entry has its own lock,
-// but we can "skip" an entry under contention, and spread out a single stack
-// into multiple buckets if necessary.
-//
-// A thread collecting a profile collects stack traces out of the hash table
-// and resets the counts to 0 as they are collected.
-class ContentionStacks {
- public:
-  ContentionStacks()
-    : dropped_samples_(0) {
-  }
-
-  // Add a stack trace to the table.
-  void AddStack(const StackTrace& s, int64_t cycles);
-
-  // Flush stacks from the buffer to 'out'. See the docs for FlushSynchronizationProfile()
-  // in spinlock_profiling.h for details on format.
-  //
-  // On return, guarantees that any stack traces that were present at the beginning of
-  // the call have been flushed. However, new stacks can be added concurrently with this call.
-  void Flush(std::stringstream* out, int64_t* dropped);
-
- private:
-
-  // Collect the next sample from the underlying buffer, and set it back to 0 count
-  // (thus marking it as "empty").
-  //
-  // 'iterator' serves as a way to keep track of the current position in the buffer.
-  // Callers should initially set it to 0, and then pass the same pointer to each
-  // call to CollectSample. This serves to loop through the collected samples.
-  bool CollectSample(uint64_t* iterator, StackTrace* s, int64_t* trip_count, int64_t* cycles);
-
-  // Hashtable entry.
-  struct Entry {
-    Entry() : trip_count(0),
-              cycle_count(0) {
-    }
-
-    // Protects all other entries.
-    base::SpinLock lock;
-
-    // The number of times we've experienced contention with a stack trace equal
-    // to 'trace'.
-    //
-    // If this is 0, then the entry is "unclaimed" and the other fields are not
-    // considered valid.
-    int64_t trip_count;
-
-    // The total number of cycles spent waiting at this stack trace.
-    int64_t cycle_count;
-
-    // A cached hashcode of the trace.
-    uint64_t hash;
-
-    // The actual stack trace.
-    StackTrace trace;
-  };
-
-  enum {
-    kNumEntries = 1024,
-    kNumLinearProbeAttempts = 4
-  };
-  Entry entries_[kNumEntries];
-
-  // The number of samples which were dropped due to contention on this structure or
-  // due to the hashtable being too full.
-  AtomicInt<int64_t> dropped_samples_;
-};
-
 Atomic32 g_profiling_enabled = 0;
-ContentionStacks* g_contention_stacks = nullptr;
-
-void ContentionStacks::AddStack(const StackTrace& s, int64_t cycles) {
-  uint64_t hash = s.HashCode();
-
-  // Linear probe up to 4 attempts before giving up
-  for (int i = 0; i < kNumLinearProbeAttempts; i++) {
-    Entry* e = &entries_[(hash + i) % kNumEntries];
-    if (!e->lock.TryLock()) {
-      // If we fail to lock it, we can safely just use a different slot.
-      // It's OK if a single stack shows up multiple times, because pprof
-      // aggregates them in the end anyway.
-      continue;
-    }
-
-    if (e->trip_count == 0) {
-      // It's an un-claimed slot. Claim it.
-      e->hash = hash;
-      e->trace.CopyFrom(s);
-    } else if (e->hash != hash || !e->trace.Equals(s)) {
-      // It's claimed by a different stack trace.
-      e->lock.Unlock();
-      continue;
-    }
-
-    // Contribute to the stats for this stack.
-    e->cycle_count += cycles;
-    e->trip_count++;
-    e->lock.Unlock();
-    return;
-  }
-
-  // If we failed to find a matching hashtable slot, or we hit lock contention
-  // trying to record our sample, add it to the dropped sample count.
-  dropped_samples_.Increment();
-}
-
-void ContentionStacks::Flush(std::stringstream* out, int64_t* dropped) {
-  uint64_t iterator = 0;
-  StackTrace t;
-  int64_t cycles;
-  int64_t count;
-  *out << "Format: Cycles\tCount @ Call Stack" << std::endl;
-  while (g_contention_stacks->CollectSample(&iterator, &t, &count, &cycles)) {
-    *out << cycles << "\t" << count
-         << " @ " << t.ToHexString(StackTrace::NO_FIX_CALLER_ADDRESSES)
-         << "\n" << t.Symbolize()
-         << "\n-----------"
-         << std::endl;
-  }
-
-  *dropped += dropped_samples_.Exchange(0);
-}
-
-bool ContentionStacks::CollectSample(uint64_t* iterator, StackTrace* s, int64_t* trip_count,
-                                     int64_t* cycles) {
-  while (*iterator < kNumEntries) {
-    Entry* e = &entries_[(*iterator)++];
-    SpinLockHolder l(&e->lock);
-    if (e->trip_count == 0) continue;
-
-    *trip_count = e->trip_count;
-    *cycles = e->cycle_count;
-    s->CopyFrom(e->trace);
-
-    e->trip_count = 0;
-    e->cycle_count = 0;
-    return true;
-  }
-
-  // Looped through the whole array and found nothing.
-  return false;
-}
+StackTraceTable* g_contention_stacks = nullptr;
 
 // Disable TSAN on this function.
 // https://yugabyte.atlassian.net/browse/ENG-354
@@ -225,8 +80,9 @@ ATTRIBUTE_NO_SANITIZE_THREAD
 void SubmitSpinLockProfileData(const void *contendedlock, int64 wait_cycles) {
   bool profiling_enabled = base::subtle::Acquire_Load(&g_profiling_enabled);
   bool long_wait_time = wait_cycles > FLAGS_lock_contention_trace_threshold_cycles;
+  bool continuous_profiling = ContinuousProfilingEnabled();
   // Short circuit this function quickly in the common case.
-  if (PREDICT_TRUE(!profiling_enabled && !long_wait_time)) {
+  if (PREDICT_TRUE(!profiling_enabled && !long_wait_time && !continuous_profiling)) {
     return;
   }
 
@@ -241,6 +97,10 @@ void SubmitSpinLockProfileData(const void *contendedlock, int64 wait_cycles) {
     DCHECK_NOTNULL(g_contention_stacks)->AddStack(stack, wait_cycles);
   }
 
+  if (continuous_profiling) {
+    RecordLockWait(stack, wait_cycles);
+  }
+
   if (PREDICT_FALSE(long_wait_time)) {
     Trace* t = Trace::CurrentTrace();
     if (t) {
@@ -264,7 +124,7 @@ void SubmitSpinLockProfileData(const void *contendedlock, int64 wait_cycles) {
 
 void DoInit() {
   base::subtle::Release_Store(reinterpret_cast<AtomicWord*>(&g_contention_stacks),
-                              reinterpret_cast<uintptr_t>(new ContentionStacks()));
+                              reinterpret_cast<uintptr_t>(new StackTraceTable()));
   base::subtle::Release_Store(reinterpret_cast<AtomicWord*>(&g_contended_cycles),
                               reinterpret_cast<uintptr_t>(new LongAdder()));
 }
@@ -299,7 +159,21 @@ void StartSynchronizationProfiling() {
 
 void FlushSynchronizationProfile(std::stringstream* out,
                                  int64_t* drop_count) {
-  CHECK_NOTNULL(g_contention_stacks)->Flush(out, drop_count);
+  auto* stacks = CHECK_NOTNULL(g_contention_stacks);
+  uint64_t iterator = 0;
+  StackTrace t;
+  int64_t cycles;
+  int64_t count;
+  *out << "Format: Cycles\tCount @ Call Stack" << std::endl;
+  while (stacks->CollectSample(&iterator, &t, &count, &cycles)) {
+    *out << cycles << "\t" << count
+         << " @ " << t.ToHexString(StackTrace::NO_FIX_CALLER_ADDRESSES)
+         << "\n" << t.Symbolize()
+         << "\n-----------"
+         << std::endl;
+  }
+
+  *drop_count += stacks->TakeDroppedSamples();
 }
 
 void StopSynchronizationProfiling() {
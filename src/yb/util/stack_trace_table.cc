@@ -0,0 +1,75 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/stack_trace_table.h"
+
+using base::SpinLockHolder;
+
+namespace yb {
+
+void StackTraceTable::AddStack(const StackTrace& s, int64_t value) {
+  uint64_t hash = s.HashCode();
+
+  // Linear probe up to 4 attempts before giving up
+  for (int i = 0; i < kNumLinearProbeAttempts; i++) {
+    Entry* e = &entries_[(hash + i) % kNumEntries];
+    if (!e->lock.TryLock()) {
+      // If we fail to lock it, we can safely just use a different slot.
+      // It's OK if a single stack shows up multiple times, because pprof
+      // aggregates them in the end anyway.
+      continue;
+    }
+
+    if (e->trip_count == 0) {
+      // It's an un-claimed slot. Claim it.
+      e->hash = hash;
+      e->trace.CopyFrom(s);
+    } else if (e->hash != hash || !e->trace.Equals(s)) {
+      // It's claimed by a different stack trace.
+      e->lock.Unlock();
+      continue;
+    }
+
+    // Contribute to the stats for this stack.
+    e->value += value;
+    e->trip_count++;
+    e->lock.Unlock();
+    return;
+  }
+
+  // If we failed to find a matching hashtable slot, or we hit lock contention
+  // trying to record our sample, add it to the dropped sample count.
+  dropped_samples_.Increment();
+}
+
+bool StackTraceTable::CollectSample(uint64_t* iterator, StackTrace* s, int64_t* trip_count,
+                                    int64_t* value) {
+  while (*iterator < kNumEntries) {
+    Entry* e = &entries_[(*iterator)++];
+    SpinLockHolder l(&e->lock);
+    if (e->trip_count == 0) continue;
+
+    *trip_count = e->trip_count;
+    *value = e->value;
+    s->CopyFrom(e->trace);
+
+    e->trip_count = 0;
+    e->value = 0;
+    return true;
+  }
+
+  // Looped through the whole array and found nothing.
+  return false;
+}
+
+} // namespace yb
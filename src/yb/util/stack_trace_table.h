@@ -0,0 +1,94 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_STACK_TRACE_TABLE_H
+#define YB_UTIL_STACK_TRACE_TABLE_H
+
+#include "yb/gutil/spinlock.h"
+
+#include "yb/util/atomic.h"
+#include "yb/util/debug-util.h"
+
+namespace yb {
+
+// Implements a very simple linear-probing hashtable of stack traces with
+// a fixed number of entries.
+//
+// Threads record their stacks into this hashtable, or increment an already-existing entry. Each
+// entry has its own lock, but we can "skip" an entry under contention, and spread out a single
+// stack into multiple buckets if necessary. So adding a stack never blocks, and could be done from
+// a signal handler.
+//
+// A thread collecting a profile collects stack traces out of the hash table
+// and resets the counts to 0 as they are collected.
+class StackTraceTable {
+ public:
+  StackTraceTable() = default;
+
+  StackTraceTable(const StackTraceTable&) = delete;
+  void operator=(const StackTraceTable&) = delete;
+
+  // Add a stack trace to the table, 'value' is added to the value of its entry.
+  void AddStack(const StackTrace& s, int64_t value);
+
+  // Collect the next sample from the underlying buffer, and set it back to 0 count
+  // (thus marking it as "empty").
+  //
+  // 'iterator' serves as a way to keep track of the current position in the buffer.
+  // Callers should initially set it to 0, and then pass the same pointer to each
+  // call to CollectSample. This serves to loop through the collected samples.
+  //
+  // Once the iteration is complete, guarantees that any stack traces that were present at the
+  // beginning of it have been collected. However, new stacks can be added concurrently.
+  bool CollectSample(uint64_t* iterator, StackTrace* s, int64_t* trip_count, int64_t* value);
+
+  // Returns the number of samples which were dropped due to contention on this structure or
+  // due to the hashtable being too full since the previous call.
+  int64_t TakeDroppedSamples() {
+    return dropped_samples_.Exchange(0);
+  }
+
+ private:
+  // Hashtable entry.
+  struct Entry {
+    // Protects all other entries.
+    base::SpinLock lock;
+
+    // The number of times we've recorded a stack trace equal to 'trace'.
+    //
+    // If this is 0, then the entry is "unclaimed" and the other fields are not
+    // considered valid.
+    int64_t trip_count = 0;
+
+    // The total value recorded with this stack trace.
+    int64_t value = 0;
+
+    // A cached hashcode of the trace.
+    uint64_t hash;
+
+    // The actual stack trace.
+    StackTrace trace;
+  };
+
+  enum {
+    kNumEntries = 1024,
+    kNumLinearProbeAttempts = 4
+  };
+  Entry entries_[kNumEntries];
+
+  AtomicInt<int64_t> dropped_samples_{0};
+};
+
+} // namespace yb
+
+#endif // YB_UTIL_STACK_TRACE_TABLE_H
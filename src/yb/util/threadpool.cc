@@ -45,6 +45,7 @@
 #include "yb/gutil/stl_util.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/gutil/sysinfo.h"
+#include "yb/util/continuous_profiler.h"
 #include "yb/util/metrics.h"
 #include "yb/util/stopwatch.h"
 #include "yb/util/thread.h"
@@ -608,6 +609,7 @@ void ThreadPool::DispatchThread(bool permanent) {
     if (token->metrics_.queue_time_us_histogram) {
       token->metrics_.queue_time_us_histogram->Increment(queue_time_us);
     }
+    RecordThreadPoolQueueTime(name_, queue_time_us);
 
     // Execute the task
     {
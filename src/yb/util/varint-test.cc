@@ -31,6 +31,12 @@ class VarIntTest : public YBTest {
     return v.EncodeToTwosComplementBytes(is_out_of_range, num_bytes).ToDebugStringFromBase256();
   }
 
+  // Signed comparable encoding computed through the binary representation, bypassing the int64
+  // shortcut of VarInt::EncodeToComparable().
+  std::string GenericEncodeToComparable(const VarInt& v) {
+    return v.EncodeToComparableBytes(true).ToStringFromBase256();
+  }
+
   std::string EncodeToDigitPairs(const VarInt& v) {
     return v.EncodeToDigitPairsBytes().ToDebugStringFromBase256();
   }
@@ -208,6 +214,41 @@ TEST_F(VarIntTest, TestComparableEncoding) {
   EXPECT_EQ(positive_big, decoded);
 }
 
+TEST_F(VarIntTest, TestInt64FastPaths) {
+  const int64_t kMax = std::numeric_limits<int64_t>::max();
+  const int64_t kMin = std::numeric_limits<int64_t>::min();
+  const std::vector<int64_t> int64_values = {
+      0, 1, -1, 63, 64, -64, (1LL << 55) - 1, 1LL << 55, (1LL << 62) - 1, 1LL << 62, -(1LL << 62),
+      kMax, kMin, kMin + 1};
+  std::vector<VarInt> values;
+  for (int64_t v : int64_values) {
+    values.emplace_back(v);
+  }
+  values.emplace_back("9223372036854775808");
+  values.emplace_back("-9223372036854775809");
+  values.emplace_back("37618632178637216379216387");
+
+  for (const auto& value : values) {
+    for (int radix : {2, 10, 256}) {
+      const VarInt converted = value.ConvertToBase(radix);
+      const std::string encoded = converted.EncodeToComparable();
+      ASSERT_EQ(GenericEncodeToComparable(converted), encoded) << value;
+      VarInt decoded;
+      size_t size = 0;
+      ASSERT_OK(decoded.DecodeFromComparable(encoded + "suffix", &size));
+      ASSERT_EQ(encoded.size(), size) << value;
+      ASSERT_EQ(value, decoded);
+    }
+    for (const auto& other : values) {
+      ASSERT_EQ(VarInt::add({value, other}), value + other) << value << " + " << other;
+      ASSERT_EQ(VarInt::add({value, -other}), value - other) << value << " - " << other;
+    }
+  }
+  ASSERT_EQ(VarInt("18446744073709551614"), VarInt(kMax) + VarInt(kMax));
+  ASSERT_EQ(VarInt("-18446744073709551616"), VarInt(kMin) + VarInt(kMin));
+  ASSERT_EQ(VarInt("-18446744073709551615"), VarInt(kMin) - VarInt(kMax));
+}
+
 TEST_F(VarIntTest, TestEncodingComparison) {
   std::string negative_big = VarInt("-37618632178637216379216387").EncodeToComparable();
   std::string negative_small = VarInt("-23").EncodeToComparable();
@@ -17,6 +17,7 @@
 #include <glog/logging.h>
 
 #include "yb/gutil/strings/substitute.h"
+#include "yb/util/fast_varint.h"
 #include "yb/util/varint.h"
 
 using std::vector;
@@ -200,6 +201,24 @@ VarInt VarInt::add(const vector<VarInt> &inputs) {
   return output;
 }
 
+VarInt VarInt::operator+(const VarInt& other) const {
+  int64_t lhs, rhs, result;
+  if (ToInt64(&lhs).ok() && other.ToInt64(&rhs).ok() &&
+      !__builtin_add_overflow(lhs, rhs, &result)) {
+    return VarInt(result);
+  }
+  return add({*this, other});
+}
+
+VarInt VarInt::operator-(const VarInt& other) const {
+  int64_t lhs, rhs, result;
+  if (ToInt64(&lhs).ok() && other.ToInt64(&rhs).ok() &&
+      !__builtin_sub_overflow(lhs, rhs, &result)) {
+    return VarInt(result);
+  }
+  return add({*this, -other});
+}
+
 VarInt VarInt::ConvertToBase(int radix) const {
   DCHECK(radix > 1) << "Cannot convert to radix <= 1";
   DCHECK(radix_ > 1) << "Cannot convert from radix <= 1";
@@ -301,6 +320,34 @@ static Status get_bit(size_t idx, const Slice& slice, bool complement, bool* val
   return Status::OK();
 }
 
+namespace {
+
+// Returns true if the signed comparable encoding at the start of slice is at most 9 bytes long, so
+// its magnitude is below 2^62 and FastDecodeSignedVarInt() decodes it exactly. Longer encodings
+// are left to the generic decoder.
+bool IsShortSignedComparable(const Slice& slice) {
+  if (slice.empty()) {
+    return false;
+  }
+  // Negative values have all their bits complemented, including the size prefix.
+  const uint8_t mask = slice[0] & 0x80 ? 0 : 0xff;
+  if ((slice[0] ^ mask) != 0xff) {
+    return true;
+  }
+  // The size prefix continues into the second byte: '0' means 8 bytes, '10' means 9 bytes.
+  return slice.size() > 1 && ((slice[1] ^ mask) & 0xc0) != 0xc0;
+}
+
+}  // namespace
+
+string VarInt::EncodeToComparable(bool is_signed, size_t num_reserved_bits) const {
+  int64_t int64_value;
+  if (is_signed && num_reserved_bits == 0 && ToInt64(&int64_value).ok()) {
+    return FastEncodeSignedVarIntToStr(int64_value);
+  }
+  return EncodeToComparableBytes(is_signed, num_reserved_bits).ToStringFromBase256();
+}
+
 VarInt VarInt::EncodeToComparableBytes(bool is_signed, size_t num_reserved_bits) const {
   DCHECK(radix_ > 0) << "Radix of VarInt found to be non-positive";
   VarInt binary = ConvertToBase(2);
@@ -349,6 +396,15 @@ VarInt VarInt::EncodeToComparableBytes(bool is_signed, size_t num_reserved_bits)
 
 Status VarInt::DecodeFromComparable(
     const Slice &slice, size_t *num_decoded_bytes, bool is_signed, size_t num_reserved_bits) {
+  if (is_signed && num_reserved_bits == 0 && IsShortSignedComparable(slice)) {
+    int64_t int64_value = 0;
+    int decoded_size = 0;
+    RETURN_NOT_OK(FastDecodeSignedVarInt(
+        slice.data(), static_cast<int>(slice.size()), &int64_value, &decoded_size));
+    FromInt64(int64_value);
+    *num_decoded_bytes = decoded_size;
+    return Status::OK();
+  }
   digits_ = {};
   radix_ = 2;
   // i is the current index. We go from left to right parsing parts of the encoding,
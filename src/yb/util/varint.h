@@ -113,8 +113,10 @@ class VarInt {
   VarInt operator+() const { return VarInt(digits_, radix_, is_positive_); }
   VarInt operator-() const { return VarInt(digits_, radix_, !is_positive_); }
 
-  VarInt operator+(const VarInt& other) const { return add({*this, other}); }
-  VarInt operator-(const VarInt& other) const { return add({*this, -other}); }
+  // Both operators take an int64 shortcut when the operands and the result fit in int64, and fall
+  // back to the digit by digit add() otherwise.
+  VarInt operator+(const VarInt& other) const;
+  VarInt operator-(const VarInt& other) const;
 
   /**
    * (1) Encoding algorithm for unsigned varint (with no reserved bits):
@@ -194,9 +196,11 @@ class VarInt {
   // is_Signed = true, num_reserved_bits = 0, and section 3 addresses the general case with
   // num_reserved_bits > 0.
   // Note that the first <num_reserved_bits> bits of the encoding is guaranteed to be zero.
-  std::string EncodeToComparable(bool is_signed = true, size_t num_reserved_bits = 0) const {
-    return EncodeToComparableBytes(is_signed, num_reserved_bits).ToStringFromBase256();
-  }
+  //
+  // Signed values without reserved bits that fit in int64 are encoded (and decoded, when the
+  // encoding is at most 9 bytes long) with the equivalent FastEncodeSignedVarInt() format, without
+  // going through the binary representation.
+  std::string EncodeToComparable(bool is_signed = true, size_t num_reserved_bits = 0) const;
 
   // Convert the number to base 256 and encode each digit as a byte from high order to low order.
   // If negative x, encode 2^(8t) + x for the smallest value of t that ensures first bit is one.
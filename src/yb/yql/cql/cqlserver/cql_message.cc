@@ -16,6 +16,9 @@
 
 #include <regex>
 
+#include <boost/scope_exit.hpp>
+#include <gflags/gflags.h>
+
 #include "yb/client/client.h"
 #include "yb/common/ql_protocol.pb.h"
 #include "yb/yql/cql/cqlserver/cql_message.h"
@@ -24,6 +27,14 @@
 #include "yb/gutil/endian.h"
 #include "yb/gutil/strings/substitute.h"
 
+#include "yb/util/flag_tags.h"
+
+DEFINE_int32(cql_compression_buffer_max_retained_bytes, 1024 * 1024,
+             "Per thread buffers used to compress and decompress CQL message bodies are reused "
+             "between messages, unless they grew larger than this size.");
+TAG_FLAG(cql_compression_buffer_max_retained_bytes, advanced);
+TAG_FLAG(cql_compression_buffer_max_retained_bytes, runtime);
+
 namespace yb {
 namespace cqlserver {
 
@@ -41,6 +52,55 @@ using snappy::MaxCompressedLength;
 using snappy::RawUncompress;
 using snappy::RawCompress;
 
+namespace {
+
+// Buffer and LZ4 state of the current thread, reused between CQL messages so compressing or
+// decompressing a message body does not allocate.
+class CompressionContext {
+ public:
+  static CompressionContext& Current() {
+    static thread_local CompressionContext context;
+    return context;
+  }
+
+  // Buffer for the uncompressed body of a message. Only one message is compressed or
+  // decompressed at a time by a thread, and ReleaseBodyBuffer() should be called when done.
+  faststring* AcquireBodyBuffer() {
+    DCHECK(!body_buffer_acquired_);
+    body_buffer_acquired_ = true;
+    body_buffer_.clear();
+    return &body_buffer_;
+  }
+
+  void ReleaseBodyBuffer() {
+    DCHECK(body_buffer_acquired_);
+    body_buffer_acquired_ = false;
+    // Do not keep memory of a rare large message.
+    if (body_buffer_.capacity() > FLAGS_cql_compression_buffer_max_retained_bytes) {
+      body_buffer_.clear();
+      delete[] body_buffer_.release();
+    }
+  }
+
+  // State used by LZ4_compress_fast_extState(), so it is not set up on the stack for every
+  // message.
+  void* lz4_state() {
+    if (!lz4_state_) {
+      lz4_state_.reset(new char[LZ4_sizeofState()]);
+    }
+    return lz4_state_.get();
+  }
+
+ private:
+  CompressionContext() = default;
+
+  faststring body_buffer_;
+  bool body_buffer_acquired_ = false;
+  std::unique_ptr<char[]> lz4_state_;
+};
+
+} // namespace
+
 #define RETURN_NOT_ENOUGH(sz)                               \
   do {                                                      \
     if (body_.size() < (sz)) {                              \
@@ -224,9 +284,15 @@ bool CQLRequest::ParseRequest(
 
   size_t body_size = mesg.size() - kMessageHeaderLength;
   const uint8_t* body_data = (body_size > 0) ? &mesg[kMessageHeaderLength] : to_uchar_ptr("");
-  unique_ptr<uint8_t[]> buffer;
 
-  // If the message body is compressed, uncompress it.
+  // If the message body is compressed, uncompress it. The uncompressed body is only referenced
+  // while the request is parsed, so it is kept in the reused buffer of the thread.
+  faststring* buffer = nullptr;
+  BOOST_SCOPE_EXIT(&buffer) {
+    if (buffer != nullptr) {
+      CompressionContext::Current().ReleaseBodyBuffer();
+    }
+  } BOOST_SCOPE_EXIT_END;
   if (body_size > 0 && (header.flags & kCompressionFlag)) {
     if (header.opcode == Opcode::STARTUP) {
       error_response->reset(
@@ -246,10 +312,11 @@ bool CQLRequest::ParseRequest(
         }
 
         const uint32_t uncomp_size = static_cast<uint32_t>(NetworkByteOrder::Load32(body_data));
-        buffer = std::make_unique<uint8_t[]>(uncomp_size);
+        buffer = CompressionContext::Current().AcquireBodyBuffer();
+        buffer->resize(uncomp_size);
         body_data += sizeof(uncomp_size);
         body_size -= sizeof(uncomp_size);
-        const int size = LZ4_decompress_safe(to_char_ptr(body_data), to_char_ptr(buffer.get()),
+        const int size = LZ4_decompress_safe(to_char_ptr(body_data), to_char_ptr(buffer->data()),
                                              body_size, uncomp_size);
         if (size < 0 || size != uncomp_size) {
           error_response->reset(
@@ -258,16 +325,17 @@ bool CQLRequest::ParseRequest(
                   "Error occurred when uncompressing CQL message"));
           return false;
         }
-        body_data = buffer.get();
+        body_data = buffer->data();
         body_size = uncomp_size;
         break;
       }
       case CompressionScheme::SNAPPY: {
         size_t uncomp_size = 0;
         if (GetUncompressedLength(to_char_ptr(body_data), body_size, &uncomp_size)) {
-          buffer = std::make_unique<uint8_t[]>(uncomp_size);
-          if (RawUncompress(to_char_ptr(body_data), body_size, to_char_ptr(buffer.get()))) {
-            body_data = buffer.get();
+          buffer = CompressionContext::Current().AcquireBodyBuffer();
+          buffer->resize(uncomp_size);
+          if (RawUncompress(to_char_ptr(body_data), body_size, to_char_ptr(buffer->data()))) {
+            body_data = buffer->data();
             body_size = uncomp_size;
             break;
           }
@@ -276,7 +344,7 @@ bool CQLRequest::ParseRequest(
             new ErrorResponse(
                 header.stream_id, ErrorResponse::Code::PROTOCOL_ERROR,
                 "Error occurred when uncompressing CQL message"));
-        break;
+        return false;
       }
       case CompressionScheme::NONE:
         error_response->reset(
@@ -526,9 +594,8 @@ Status CQLRequest::ParseQueryParameters(QueryParameters* params) {
     params->set_page_size(page_size);
   }
   if (params->flags & CQLMessage::QueryParameters::kWithPagingStateFlag) {
-    string paging_state;
-    RETURN_NOT_OK(ParseBytes(&paging_state));
-    RETURN_NOT_OK(params->set_paging_state(paging_state));
+    RETURN_NOT_OK(ParseBytes(&params->raw_paging_state));
+    RETURN_NOT_OK(params->set_paging_state(params->raw_paging_state));
   }
   if (params->flags & CQLMessage::QueryParameters::kWithSerialConsistencyFlag) {
     RETURN_NOT_OK(ParseConsistency(&params->serial_consistency));
@@ -914,7 +981,8 @@ void CQLResponse::Serialize(const CompressionScheme compression_scheme, faststri
   const bool compress = (compression_scheme != CQLMessage::CompressionScheme::NONE);
   SerializeHeader(compress, mesg);
   if (compress) {
-    faststring body;
+    auto& context = CompressionContext::Current();
+    faststring& body = *context.AcquireBodyBuffer();
     SerializeBody(&body);
     switch (compression_scheme) {
       case CQLMessage::CompressionScheme::LZ4: {
@@ -922,10 +990,12 @@ void CQLResponse::Serialize(const CompressionScheme compression_scheme, faststri
         const size_t curr_size = mesg->size();
         const int max_comp_size = LZ4_compressBound(body.size());
         mesg->resize(curr_size + max_comp_size);
-        const int comp_size = LZ4_compress_default(to_char_ptr(body.data()),
-                                                   to_char_ptr(mesg->data() + curr_size),
-                                                   body.size(),
-                                                   max_comp_size);
+        const int comp_size = LZ4_compress_fast_extState(context.lz4_state(),
+                                                         to_char_ptr(body.data()),
+                                                         to_char_ptr(mesg->data() + curr_size),
+                                                         body.size(),
+                                                         max_comp_size,
+                                                         1 /* acceleration */);
         CHECK_NE(comp_size, 0) << "LZ4 compression failed";
         mesg->resize(curr_size + comp_size);
         break;
@@ -944,6 +1014,7 @@ void CQLResponse::Serialize(const CompressionScheme compression_scheme, faststri
         LOG(FATAL) << "No compression scheme";
         break;
     }
+    context.ReleaseBodyBuffer();
   } else {
     SerializeBody(mesg);
   }
@@ -951,6 +1022,13 @@ void CQLResponse::Serialize(const CompressionScheme compression_scheme, faststri
       mesg->data(), start_pos + kHeaderPosLength, mesg->size() - start_pos - kMessageHeaderLength);
 }
 
+void CQLResponse::SerializeToBuffers(const CompressionScheme compression_scheme,
+                                     std::vector<RefCntBuffer>* output) const {
+  faststring mesg;
+  Serialize(compression_scheme, &mesg);
+  output->emplace_back(mesg);
+}
+
 void CQLResponse::SerializeHeader(const bool compress, faststring* mesg) const {
   uint8_t buffer[kMessageHeaderLength];
   SERIALIZE_BYTE(buffer, kHeaderPosVersion, version());
@@ -1482,11 +1560,36 @@ RowsResultResponse::RowsResultResponse(
 RowsResultResponse::~RowsResultResponse() {
 }
 
+void RowsResultResponse::SerializeToBuffers(const CompressionScheme compression_scheme,
+                                            std::vector<RefCntBuffer>* output) const {
+  const RefCntBuffer& rows_data = result_->rows_data();
+  if (compression_scheme != CQLMessage::CompressionScheme::NONE || rows_data.empty()) {
+    // The compressed body has to be built in a single buffer.
+    ResultResponse::SerializeToBuffers(compression_scheme, output);
+    return;
+  }
+
+  faststring mesg;
+  SerializeHeader(false /* compress */, &mesg);
+  SerializeInt(static_cast<int32_t>(Kind::ROWS), &mesg);
+  SerializeMetadata(&mesg);
+  // The body length includes the rows data that follows in the separate buffer.
+  NetworkByteOrder::Store32(&mesg.data()[kHeaderPosLength],
+                            static_cast<int32_t>(mesg.size() - kMessageHeaderLength +
+                                                 rows_data.size()));
+  output->emplace_back(mesg);
+  output->push_back(rows_data);
+}
+
 void RowsResultResponse::SerializeResultBody(faststring* mesg) const {
+  SerializeMetadata(mesg);
+  mesg->append(result_->rows_data().data(), result_->rows_data().size());
+}
+
+void RowsResultResponse::SerializeMetadata(faststring* mesg) const {
   SerializeRowsMetadata(
       RowsMetadata(result_->table_name(), result_->column_schemas(),
                    result_->paging_state(), skip_metadata_), mesg);
-  mesg->append(result_->rows_data());
 }
 
 //----------------------------------------------------------------------------------------
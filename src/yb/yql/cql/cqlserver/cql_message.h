@@ -24,6 +24,7 @@
 #include <memory>
 #include <set>
 #include <unordered_map>
+#include <vector>
 
 #include "yb/common/wire_protocol.h"
 #include "yb/rpc/server_event.h"
@@ -32,6 +33,7 @@
 #include "yb/util/slice.h"
 #include "yb/util/status.h"
 #include "yb/util/net/sockaddr.h"
+#include "yb/util/ref_cnt_buffer.h"
 
 namespace yb {
 namespace cqlserver {
@@ -193,6 +195,8 @@ class CQLMessage {
     std::unordered_map<std::string, std::vector<Value>::size_type> value_map;
     Consistency serial_consistency = Consistency::ANY;
     int64_t default_timestamp = 0;
+    // Paging state as sent by the client, empty when there is none.
+    std::string raw_paging_state;
 
     QueryParameters() : ql::StatementParameters() { }
 
@@ -465,6 +469,11 @@ class CQLResponse : public CQLMessage {
   virtual ~CQLResponse();
   virtual void Serialize(CompressionScheme compression_scheme, faststring* mesg) const;
 
+  // Serializes the response to one or more buffers appended to 'output', which are sent in order.
+  // Responses that carry data already in the wire format could reference it instead of copying.
+  virtual void SerializeToBuffers(CompressionScheme compression_scheme,
+                                  std::vector<RefCntBuffer>* output) const;
+
  protected:
   CQLResponse(const CQLRequest& request, Opcode opcode);
   CQLResponse(StreamId stream_id, Opcode opcode);
@@ -726,10 +735,17 @@ class RowsResultResponse : public ResultResponse {
   RowsResultResponse(const ExecuteRequest& request, const ql::RowsResult::SharedPtr& result);
   virtual ~RowsResultResponse() override;
 
+  // Without compression, rows data received from the tablet servers is sent as a separate buffer
+  // after the header and the rows metadata, without copying.
+  void SerializeToBuffers(CompressionScheme compression_scheme,
+                          std::vector<RefCntBuffer>* output) const override;
+
  protected:
   virtual void SerializeResultBody(faststring* mesg) const override;
 
  private:
+  void SerializeMetadata(faststring* mesg) const;
+
   const ql::RowsResult::SharedPtr result_;
   const bool skip_metadata_;
 };
@@ -21,6 +21,7 @@
 #include "yb/rpc/rpc_context.h"
 
 #include "yb/util/crypt.h"
+#include "yb/util/flag_tags.h"
 
 #include "yb/yql/cql/cqlserver/cql_service.h"
 
@@ -50,6 +51,13 @@ METRIC_DEFINE_histogram(
 METRIC_DEFINE_counter(
     server, yb_cqlserver_CQLServerService_ParsingErrors, "Errors encountered when parsing ",
     yb::MetricUnit::kRequests, "Errors encountered when parsing ");
+METRIC_DEFINE_counter(
+    server, cql_processors_created, "CQL processors created",
+    yb::MetricUnit::kUnits, "Number of CQL processors created, because none was available in "
+    "the processor pool");
+METRIC_DEFINE_gauge_int64(
+    server, cql_processors_in_use, "CQL processors in use",
+    yb::MetricUnit::kUnits, "Number of CQL processors currently processing calls");
 METRIC_DEFINE_histogram(
     server, handler_latency_yb_cqlserver_CQLServerService_Any,
     "yb.cqlserver.CQLServerService.AnyMethod RPC Time", yb::MetricUnit::kMicroseconds,
@@ -58,6 +66,20 @@ METRIC_DEFINE_histogram(
     "RPC requests",
     60000000LU, 2);
 
+DEFINE_bool(cql_cache_unprepared_statements, false,
+            "Cache the analyzed parse trees of unprepared QUERY statements in the prepared "
+            "statements cache, keyed by the keyspace and the statement text, so that clients "
+            "that do not use PREPARE / EXECUTE skip parsing and analyzing repeated statements.");
+TAG_FLAG(cql_cache_unprepared_statements, advanced);
+TAG_FLAG(cql_cache_unprepared_statements, runtime);
+
+DEFINE_bool(cql_prefetch_next_page, false,
+            "When a page of results of a prepared statement is returned and more results remain, "
+            "fetch the next page in the background and keep it in the buffer of the connection "
+            "until the client asks for it.");
+TAG_FLAG(cql_prefetch_next_page, advanced);
+TAG_FLAG(cql_prefetch_next_page, runtime);
+
 DECLARE_bool(use_cassandra_authentication);
 
 namespace yb {
@@ -68,6 +90,28 @@ const unordered_map<string, vector<string>> kSupportedOptions = {
   {CQLMessage::kCompressionOption, {CQLMessage::kLZ4Compression, CQLMessage::kSnappyCompression} }
 };
 
+namespace {
+
+// Key of the page of a prepared statement fetched with the parameters and paging state.
+string PrefetchKey(const CQLMessage::QueryId& query_id,
+                   const CQLMessage::QueryParameters& params,
+                   const string& paging_state) {
+  string key = query_id;
+  key += paging_state;
+  key.append(reinterpret_cast<const char*>(&params.consistency), sizeof(params.consistency));
+  const uint64_t page_size = params.page_size();
+  key.append(reinterpret_cast<const char*>(&page_size), sizeof(page_size));
+  for (const auto& value : params.values) {
+    key.append(reinterpret_cast<const char*>(&value.kind), sizeof(value.kind));
+    key += value.name;
+    key.push_back('\0');
+    key += value.value;
+  }
+  return key;
+}
+
+} // namespace
+
 constexpr const char* const kCassandraPasswordAuthenticator =
     "org.apache.cassandra.auth.PasswordAuthenticator";
 
@@ -111,16 +155,17 @@ CQLMetrics::CQLMetrics(const scoped_refptr<yb::MetricEntity>& metric_entity)
       METRIC_handler_latency_yb_cqlserver_CQLServerService_Any.Instantiate(metric_entity);
   num_errors_parsing_cql_ =
       METRIC_yb_cqlserver_CQLServerService_ParsingErrors.Instantiate(metric_entity);
+  cql_processors_created_ = METRIC_cql_processors_created.Instantiate(metric_entity);
+  cql_processors_in_use_ = METRIC_cql_processors_in_use.Instantiate(metric_entity, 0);
 }
 
 //------------------------------------------------------------------------------------------------
-CQLProcessor::CQLProcessor(CQLServiceImpl* service_impl, const CQLProcessorListPos& pos)
+CQLProcessor::CQLProcessor(CQLServiceImpl* service_impl)
     : QLProcessor(
           service_impl->messenger(), service_impl->client(), service_impl->metadata_cache(),
           service_impl->cql_metrics().get(), service_impl->cql_rpc_env()),
       service_impl_(service_impl),
       cql_metrics_(service_impl->cql_metrics()),
-      pos_(pos),
       statement_executed_cb_(Bind(&CQLProcessor::StatementExecuted, Unretained(this))) {
 }
 
@@ -128,7 +173,7 @@ CQLProcessor::~CQLProcessor() {
 }
 
 void CQLProcessor::Return() {
-  service_impl_->ReturnProcessor(pos_);
+  service_impl_->ReturnProcessor(this);
 }
 
 void CQLProcessor::ProcessCall(rpc::InboundCallPtr call) {
@@ -143,8 +188,8 @@ void CQLProcessor::ProcessCall(rpc::InboundCallPtr call) {
   if (!CQLRequest::ParseRequest(call_->serialized_request(), compression_scheme,
                                 &request, &response)) {
     cql_metrics_->num_errors_parsing_cql_->Increment();
+    // SendResponse() returns the processor to the service.
     SendResponse(*response);
-    service_impl_->ReturnProcessor(pos_);
     return;
   }
 
@@ -170,9 +215,9 @@ void CQLProcessor::SendResponse(const CQLResponse& response) {
   MonoTime response_begin = MonoTime::Now();
   const auto& context = static_cast<const CQLConnectionContext&>(call_->connection()->context());
   const auto compression_scheme = context.compression_scheme();
-  faststring msg;
-  response.Serialize(compression_scheme, &msg);
-  call_->RespondSuccess(RefCntBuffer(msg), cql_metrics_->rpc_method_metrics_);
+  std::vector<RefCntBuffer> buffers;
+  response.SerializeToBuffers(compression_scheme, &buffers);
+  call_->RespondSuccess(std::move(buffers), cql_metrics_->rpc_method_metrics_);
 
   MonoTime response_done = MonoTime::Now();
   cql_metrics_->time_to_process_request_->Increment(
@@ -188,6 +233,7 @@ void CQLProcessor::SendResponse(const CQLResponse& response) {
   call_ = nullptr;
   request_ = nullptr;
   stmts_.clear();
+  query_stmt_ = nullptr;
   parse_trees_.clear();
   SetCurrentCall(nullptr);
   Return();
@@ -292,6 +338,15 @@ CQLResponse* CQLProcessor::ProcessRequest(const ExecuteRequest& req) {
     unprepared_id_ = req.query_id();
     StatementExecuted(ErrorStatus(ErrorCode::UNPREPARED_STATEMENT));
   } else {
+    if (FLAGS_cql_prefetch_next_page && !req.params().raw_paging_state.empty()) {
+      auto& context = static_cast<CQLConnectionContext&>(call_->connection()->context());
+      auto result = context.prefetched_pages().Take(
+          PrefetchKey(req.query_id(), req.params(), req.params().raw_paging_state));
+      if (result != nullptr) {
+        VLOG(2) << "Using prefetched page for " << b2a_hex(req.query_id());
+        return ProcessResult(Status::OK(), result);
+      }
+    }
     Status s = stmt->ExecuteAsync(this, req.params(), statement_executed_cb_);
     if (PREDICT_FALSE(!s.ok())) {
       StatementExecuted(s);
@@ -300,12 +355,101 @@ CQLResponse* CQLProcessor::ProcessRequest(const ExecuteRequest& req) {
   return nullptr;
 }
 
+void CQLProcessor::PrefetchNextPage(const ExecuteRequest& req, const RowsResult& result) {
+  if (stmts_.size() != 1) {
+    return;
+  }
+  std::unique_ptr<CQLMessage::QueryParameters> params(
+      new CQLMessage::QueryParameters(req.params()));
+  params->flags |= CQLMessage::QueryParameters::kWithPagingStateFlag;
+  params->raw_paging_state = result.paging_state();
+  Status s = params->set_paging_state(params->raw_paging_state);
+  if (!s.ok()) {
+    LOG(DFATAL) << "Failed to set paging state for prefetch: " << s;
+    return;
+  }
+  string key = PrefetchKey(req.query_id(), *params, params->raw_paging_state);
+  service_impl_->GetProcessor()->PrefetchPage(
+      call_->connection(), *stmts_.begin(), std::move(params), std::move(key));
+}
+
+void CQLProcessor::PrefetchPage(rpc::ConnectionPtr connection,
+                                std::shared_ptr<const CQLStatement> stmt,
+                                std::unique_ptr<CQLMessage::QueryParameters> params,
+                                std::string key) {
+  prefetch_connection_ = std::move(connection);
+  prefetch_stmt_ = std::move(stmt);
+  prefetch_params_ = std::move(params);
+  prefetch_key_ = std::move(key);
+  // There is no current call, so the statement is executed on behalf of no client and the
+  // execution completes in the thread that receives the response.
+  Status s = prefetch_stmt_->ExecuteAsync(
+      this, *prefetch_params_, Bind(&CQLProcessor::PagePrefetched, Unretained(this)));
+  if (PREDICT_FALSE(!s.ok())) {
+    PagePrefetched(s, nullptr);
+  }
+}
+
+void CQLProcessor::PagePrefetched(const Status& s, const ExecutedResult::SharedPtr& result) {
+  if (s.ok() && result != nullptr && result->type() == ExecutedResult::Type::ROWS) {
+    auto& context = static_cast<CQLConnectionContext&>(prefetch_connection_->context());
+    if (!context.prefetched_pages().Add(
+            prefetch_key_, std::static_pointer_cast<RowsResult>(result),
+            service_impl_->prefetched_pages_mem_tracker())) {
+      VLOG(2) << "No room for prefetched page";
+    }
+  } else if (!s.ok()) {
+    VLOG(2) << "Failed to prefetch page: " << s;
+  }
+  prefetch_connection_ = nullptr;
+  prefetch_stmt_ = nullptr;
+  prefetch_params_ = nullptr;
+  prefetch_key_.clear();
+  Return();
+}
+
 CQLResponse* CQLProcessor::ProcessRequest(const QueryRequest& req) {
   VLOG(1) << "QUERY " << req.query();
+  if (FLAGS_cql_cache_unprepared_statements) {
+    return ProcessCachedQuery(req);
+  }
   RunAsync(req.query(), req.params(), statement_executed_cb_);
   return nullptr;
 }
 
+CQLResponse* CQLProcessor::ProcessCachedQuery(const QueryRequest& req) {
+  const CQLMessage::QueryId query_id = CQLStatement::GetQueryId(
+      ql_env_.CurrentKeyspace(), req.query());
+  query_stmt_ = service_impl_->GetPreparedStatement(query_id);
+  if (query_stmt_ == nullptr) {
+    // Prepare the statement the same way PREPARE does, so that concurrent clients sending the same
+    // new query contend on one placeholder statement instead of analyzing it in parallel.
+    shared_ptr<CQLStatement> stmt = service_impl_->AllocatePreparedStatement(
+        query_id, ql_env_.CurrentKeyspace(), req.query());
+    PreparedResult::UniPtr result;
+    const Status s = stmt->Prepare(this, service_impl_->prepared_stmts_mem_tracker(), &result);
+    if (!s.ok()) {
+      service_impl_->DeletePreparedStatement(stmt);
+      return ProcessResult(s);
+    }
+    // Only DML statements are worth keeping. Other statements, like DDLs, are typically executed
+    // once, so they are removed from the cache and just executed from the parse tree at hand.
+    if (result == nullptr) {
+      service_impl_->DeletePreparedStatement(stmt);
+    }
+    query_stmt_ = std::move(stmt);
+  }
+
+  // The statement is executed with the parameters of the QUERY request. Should the cached parse
+  // tree turn out to be stale, ProcessResult() removes it from the cache and retries the query,
+  // which then prepares the statement again with the up-to-date metadata.
+  Status s = query_stmt_->ExecuteAsync(this, req.params(), statement_executed_cb_);
+  if (PREDICT_FALSE(!s.ok())) {
+    StatementExecuted(s);
+  }
+  return nullptr;
+}
+
 CQLResponse* CQLProcessor::ProcessRequest(const BatchRequest& req) {
   VLOG(1) << "BATCH " << req.queries().size();
 
@@ -412,6 +556,14 @@ CQLResponse* CQLProcessor::ProcessResult(Status s, const ExecutedResult::SharedP
             unprepared_id_ = stmt->query_id();
           }
         }
+        // A statement cached for an unprepared query is not known to the client, so it is never
+        // reported as unprepared. It is just removed from the cache before the query is retried.
+        if (query_stmt_ != nullptr) {
+          if (query_stmt_->stale()) {
+            service_impl_->DeletePreparedStatement(query_stmt_);
+          }
+          query_stmt_ = nullptr;
+        }
         if (!unprepared_id_.empty()) {
           return new UnpreparedErrorResponse(*request_, unprepared_id_);
         }
@@ -454,8 +606,13 @@ CQLResponse* CQLProcessor::ProcessResult(Status s, const ExecutedResult::SharedP
         cql_metrics_->ql_response_size_bytes_->Increment(rows_result->rows_data().size());
       }
       switch (request_->opcode()) {
-        case CQLMessage::Opcode::EXECUTE:
-          return new RowsResultResponse(down_cast<const ExecuteRequest&>(*request_), rows_result);
+        case CQLMessage::Opcode::EXECUTE: {
+          const auto& req = down_cast<const ExecuteRequest&>(*request_);
+          if (FLAGS_cql_prefetch_next_page && !rows_result->paging_state().empty()) {
+            PrefetchNextPage(req, *rows_result);
+          }
+          return new RowsResultResponse(req, rows_result);
+        }
         case CQLMessage::Opcode::QUERY:
           return new RowsResultResponse(down_cast<const QueryRequest&>(*request_), rows_result);
         case CQLMessage::Opcode::AUTH_RESPONSE:
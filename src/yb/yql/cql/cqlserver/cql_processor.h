@@ -45,25 +45,30 @@ class CQLMetrics : public ql::QLMetrics {
 
   scoped_refptr<yb::Histogram> time_to_queue_cql_response_;
   scoped_refptr<yb::Counter> num_errors_parsing_cql_;
+
+  // CQL processor pool metrics.
+  scoped_refptr<yb::Counter> cql_processors_created_;
+  scoped_refptr<yb::AtomicGauge<int64_t>> cql_processors_in_use_;
   // Rpc level metrics
   yb::rpc::RpcMethodMetrics rpc_method_metrics_;
 };
 
 
-// A list of CQL processors and position in the list.
-class CQLProcessor;
-using CQLProcessorList = std::list<std::unique_ptr<CQLProcessor>>;
-using CQLProcessorListPos = CQLProcessorList::iterator;
-
 class CQLProcessor : public ql::QLProcessor {
  public:
   // Constructor and destructor.
-  explicit CQLProcessor(CQLServiceImpl* service_impl, const CQLProcessorListPos& pos);
+  explicit CQLProcessor(CQLServiceImpl* service_impl);
   ~CQLProcessor();
 
   // Processing an inbound call.
   void ProcessCall(rpc::InboundCallPtr call);
 
+  // Execute the prepared statement in the background to fetch the page of results for the
+  // parameters, and keep it in the prefetched pages of the connection under the key. The processor
+  // returns itself to the service when done.
+  void PrefetchPage(rpc::ConnectionPtr connection, std::shared_ptr<const CQLStatement> stmt,
+                    std::unique_ptr<CQLMessage::QueryParameters> params, std::string key);
+
  private:
   // Process a CQL request.
   CQLResponse* ProcessRequest(const CQLRequest& req);
@@ -78,9 +83,19 @@ class CQLProcessor : public ql::QLProcessor {
   CQLResponse* ProcessRequest(const AuthResponseRequest& req);
   CQLResponse* ProcessRequest(const RegisterRequest& req);
 
+  // Process a QUERY request using the analyzed statement cached for its text, preparing and
+  // caching the statement on a miss. Used when --cql_cache_unprepared_statements is set.
+  CQLResponse* ProcessCachedQuery(const QueryRequest& req);
+
   // Get a prepared statement and adds it to the set of statements currently being executed.
   std::shared_ptr<const CQLStatement> GetPreparedStatement(const CQLMessage::QueryId& id);
 
+  // Start prefetching the page that follows the result of the EXECUTE request, with another processor.
+  void PrefetchNextPage(const ExecuteRequest& req, const ql::RowsResult& result);
+
+  // Callback of the statement executed by PrefetchPage().
+  void PagePrefetched(const Status& s, const ql::ExecutedResult::SharedPtr& result);
+
   // Statement executed callback.
   void StatementExecuted(const Status& s, const ql::ExecutedResult::SharedPtr& result = nullptr);
 
@@ -99,9 +114,6 @@ class CQLProcessor : public ql::QLProcessor {
   // CQL metrics.
   std::shared_ptr<CQLMetrics> cql_metrics_;
 
-  // Position in the CQL processor list.
-  const CQLProcessorListPos pos_;
-
   //----------------------------- StatementExecuted callback and state ---------------------------
 
   // Current call, request, prepared statements and parse trees being processed.
@@ -110,6 +122,15 @@ class CQLProcessor : public ql::QLProcessor {
   std::unordered_set<std::shared_ptr<const CQLStatement>> stmts_;
   std::unordered_set<ql::ParseTree::UniPtr> parse_trees_;
 
+  // Statement cached for the unprepared query being executed.
+  std::shared_ptr<const CQLStatement> query_stmt_;
+
+  // Connection, statement, parameters and buffer key of the page being prefetched.
+  rpc::ConnectionPtr prefetch_connection_;
+  std::shared_ptr<const CQLStatement> prefetch_stmt_;
+  std::unique_ptr<CQLMessage::QueryParameters> prefetch_params_;
+  std::string prefetch_key_;
+
   // Current retry count.
   int retry_count_ = 0;
 
@@ -24,6 +24,7 @@
 #include "yb/rpc/rpc_introspection.pb.h"
 
 #include "yb/util/debug/trace_event.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/size_literals.h"
 
 using yb::cqlserver::CQLMessage;
@@ -49,10 +50,80 @@ DECLARE_int32(rpc_max_message_size);
 DEFINE_int32(max_message_length, 254_MB,
              "The maximum message length of the cql message.");
 
+DEFINE_int64(cql_prefetch_buffer_max_bytes_per_connection, 4_MB,
+             "Max size of the pages of results prefetched for a CQL connection, see "
+             "--cql_prefetch_next_page.");
+TAG_FLAG(cql_prefetch_buffer_max_bytes_per_connection, advanced);
+TAG_FLAG(cql_prefetch_buffer_max_bytes_per_connection, runtime);
+
+DEFINE_int32(cql_prefetched_page_ttl_ms, 10000,
+             "Prefetched pages of results that the CQL client did not ask for during this time "
+             "are discarded.");
+TAG_FLAG(cql_prefetched_page_ttl_ms, advanced);
+TAG_FLAG(cql_prefetched_page_ttl_ms, runtime);
 
 namespace yb {
 namespace cqlserver {
 
+namespace {
+
+size_t PageSize(const ql::RowsResult& result) {
+  return result.rows_data().size() + result.paging_state().size();
+}
+
+} // namespace
+
+bool CQLPrefetchedPages::Add(const std::string& key, ql::RowsResult::SharedPtr result,
+                             const std::shared_ptr<MemTracker>& mem_tracker) {
+  const size_t size = PageSize(*result);
+  const auto now = MonoTime::Now();
+  std::lock_guard<std::mutex> lock(mutex_);
+  RemoveExpiredUnlocked(now);
+  auto it = pages_.find(key);
+  if (it != pages_.end()) {
+    bytes_ -= PageSize(*it->second.result);
+    pages_.erase(it);
+  }
+  if (static_cast<int64_t>(bytes_ + size) > FLAGS_cql_prefetch_buffer_max_bytes_per_connection) {
+    return false;
+  }
+  bytes_ += size;
+  auto& page = pages_[key];
+  page.result = std::move(result);
+  page.added = now;
+  page.consumption = std::make_unique<ScopedTrackedConsumption>(mem_tracker, size);
+  return true;
+}
+
+ql::RowsResult::SharedPtr CQLPrefetchedPages::Take(const std::string& key) {
+  const auto now = MonoTime::Now();
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (pages_.empty()) {
+    return nullptr;
+  }
+  RemoveExpiredUnlocked(now);
+  auto it = pages_.find(key);
+  if (it == pages_.end()) {
+    return nullptr;
+  }
+  auto result = std::move(it->second.result);
+  bytes_ -= PageSize(*result);
+  pages_.erase(it);
+  return result;
+}
+
+void CQLPrefetchedPages::RemoveExpiredUnlocked(MonoTime now) {
+  const auto ttl = MonoDelta::FromMilliseconds(FLAGS_cql_prefetched_page_ttl_ms);
+  for (auto it = pages_.begin(); it != pages_.end();) {
+    if (now - it->second.added > ttl) {
+      bytes_ -= PageSize(*it->second.result);
+      it = pages_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
 CQLConnectionContext::CQLConnectionContext()
     : ql_session_(new ql::QLSession()) {
 }
@@ -164,9 +235,9 @@ const std::string& CQLInboundCall::method_name() const {
 
 void CQLInboundCall::Serialize(std::deque<RefCntBuffer>* output) const {
   TRACE_EVENT0("rpc", "CQLInboundCall::Serialize");
-  CHECK_GT(response_msg_buf_.size(), 0);
+  CHECK(!response_msg_bufs_.empty());
 
-  output->push_back(response_msg_buf_);
+  output->insert(output->end(), response_msg_bufs_.begin(), response_msg_bufs_.end());
 }
 
 void CQLInboundCall::RespondFailure(rpc::ErrorStatusPB::RpcErrorCodePB error_code,
@@ -197,15 +268,16 @@ void CQLInboundCall::RespondFailure(rpc::ErrorStatusPB::RpcErrorCodePB error_cod
       break;
     }
   }
-  response_msg_buf_ = RefCntBuffer(msg);
+  response_msg_bufs_.clear();
+  response_msg_bufs_.emplace_back(msg);
 
   QueueResponse(/* is_success */ false);
 }
 
-void CQLInboundCall::RespondSuccess(const RefCntBuffer& buffer,
+void CQLInboundCall::RespondSuccess(std::vector<RefCntBuffer> buffers,
                                     const yb::rpc::RpcMethodMetrics& metrics) {
   RecordHandlingCompleted(metrics.handler_latency);
-  response_msg_buf_ = buffer;
+  response_msg_bufs_ = std::move(buffers);
 
   QueueResponse(/* is_success */ true);
 }
@@ -16,6 +16,9 @@
 #define YB_YQL_CQL_CQLSERVER_CQL_RPC_H
 
 #include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 #include "yb/yql/cql/cqlserver/cql_message.h"
 
@@ -24,12 +27,43 @@
 
 #include "yb/yql/cql/ql/ql_session.h"
 
+#include "yb/util/mem_tracker.h"
+#include "yb/util/monotime.h"
+
 namespace yb {
 namespace cqlserver {
 
 class CQLStatement;
 class CQLServiceImpl;
 
+// Pages of results prefetched for the clients of a connection, keyed by the statement, parameters
+// and paging state of the request that would fetch them. The buffer is bounded by
+// --cql_prefetch_buffer_max_bytes_per_connection and its memory is tracked by the given tracker.
+// Pages older than --cql_prefetched_page_ttl_ms are not returned.
+class CQLPrefetchedPages {
+ public:
+  // Keep a prefetched page. Returns false when the page does not fit into the buffer.
+  bool Add(const std::string& key, ql::RowsResult::SharedPtr result,
+           const std::shared_ptr<MemTracker>& mem_tracker);
+
+  // Take the page prefetched for the key out of the buffer, nullptr if there is none.
+  ql::RowsResult::SharedPtr Take(const std::string& key);
+
+ private:
+  struct Page {
+    ql::RowsResult::SharedPtr result;
+    MonoTime added;
+    std::unique_ptr<ScopedTrackedConsumption> consumption;
+  };
+
+  // Remove the pages that expired. The mutex has to be held.
+  void RemoveExpiredUnlocked(MonoTime now);
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, Page> pages_;
+  size_t bytes_ = 0;
+};
+
 class CQLConnectionContext : public rpc::ConnectionContextWithCallId {
  public:
   CQLConnectionContext();
@@ -44,6 +78,11 @@ class CQLConnectionContext : public rpc::ConnectionContextWithCallId {
     compression_scheme_ = compression_scheme;
   }
 
+  // Pages prefetched for this connection.
+  CQLPrefetchedPages& prefetched_pages() {
+    return prefetched_pages_;
+  }
+
  private:
   void Connected(const rpc::ConnectionPtr& connection) override {}
 
@@ -64,6 +103,8 @@ class CQLConnectionContext : public rpc::ConnectionContextWithCallId {
 
   // CQL message compression scheme to use.
   CQLMessage::CompressionScheme compression_scheme_ = CQLMessage::CompressionScheme::NONE;
+
+  CQLPrefetchedPages prefetched_pages_;
 };
 
 class CQLInboundCall : public rpc::InboundCall {
@@ -84,9 +125,9 @@ class CQLInboundCall : public rpc::InboundCall {
 
   MonoTime GetClientDeadline() const override;
 
-  // Return the response message buffer.
-  RefCntBuffer& response_msg_buf() {
-    return response_msg_buf_;
+  // Return the buffers of the response message.
+  std::vector<RefCntBuffer>& response_msg_bufs() {
+    return response_msg_bufs_;
   }
 
   // Return the SQL session of this CQL call.
@@ -105,7 +146,7 @@ class CQLInboundCall : public rpc::InboundCall {
   const std::string& service_name() const override;
   const std::string& method_name() const override;
   void RespondFailure(rpc::ErrorStatusPB::RpcErrorCodePB error_code, const Status& status) override;
-  void RespondSuccess(const RefCntBuffer& buffer, const yb::rpc::RpcMethodMetrics& metrics);
+  void RespondSuccess(std::vector<RefCntBuffer> buffers, const yb::rpc::RpcMethodMetrics& metrics);
   void GetCallDetails(rpc::RpcCallInProgressPB *call_in_progress_pb);
   void SetRequest(std::shared_ptr<const CQLRequest> request, CQLServiceImpl* service_impl) {
     service_impl_ = service_impl;
@@ -120,7 +161,7 @@ class CQLInboundCall : public rpc::InboundCall {
   void RecordHandlingStarted(scoped_refptr<Histogram> incoming_queue_time) override;
 
   Callback<void(void)>* resume_from_ = nullptr;
-  RefCntBuffer response_msg_buf_;
+  std::vector<RefCntBuffer> response_msg_bufs_;
   ql::QLSession::SharedPtr ql_session_;
   uint16_t stream_id_;
   std::shared_ptr<const CQLRequest> request_;
@@ -59,7 +59,10 @@ CQLServiceImpl::CQLServiceImpl(CQLServer* server, const CQLServerOptions& opts)
           "cql_ybclient", FLAGS_cql_ybclient_reactor_threads, kRpcTimeoutSec,
           server->tserver() ? server->tserver()->permanent_uuid() : "",
           &opts, server->metric_entity()),
-      next_available_processor_(processors_.end()),
+      processors_([this] {
+        cql_metrics_->cql_processors_created_->Increment();
+        return new CQLProcessor(this);
+      }),
       messenger_(server->messenger()),
       cql_rpcserver_env_(new CQLRpcServerEnv(server->first_rpc_address().address().to_string(),
                                              opts.broadcast_rpc_address)) {
@@ -74,6 +77,8 @@ CQLServiceImpl::CQLServiceImpl(CQLServer* server, const CQLServerOptions& opts)
       "CQL prepared statements' memory usage", server->mem_tracker());
   prepared_stmts_mem_tracker_->AddGcFunction(
       std::bind(&CQLServiceImpl::DeleteLruPreparedStatement, this));
+  prefetched_pages_mem_tracker_ = MemTracker::CreateTracker(
+      -1, "CQL prefetched pages' memory usage", server->mem_tracker());
 
   auth_prepared_stmt_ = std::make_shared<ql::Statement>(
       "",
@@ -131,51 +136,48 @@ void CQLServiceImpl::Handle(yb::rpc::InboundCallPtr inbound_call) {
 }
 
 CQLProcessor *CQLServiceImpl::GetProcessor() {
-  CQLProcessorListPos pos;
-  {
-    // Retrieve the next available processor. If none is available, allocate a new slot in the list.
-    // Then create the processor outside the mutex below.
-    std::lock_guard<std::mutex> guard(processors_mutex_);
-    pos = (next_available_processor_ != processors_.end() ?
-           next_available_processor_++ : processors_.emplace(processors_.end()));
-  }
+  // Take an available processor from the pool, or create a new one if none is available.
+  CQLProcessor* processor = processors_.Take();
+  cql_metrics_->cql_processors_in_use_->Increment();
+  return processor;
+}
 
-  if (pos->get() == nullptr) {
-    pos->reset(new CQLProcessor(this, pos));
-  }
-  return pos->get();
+void CQLServiceImpl::ReturnProcessor(CQLProcessor* processor) {
+  cql_metrics_->cql_processors_in_use_->Decrement();
+  processors_.Release(processor);
 }
 
-void CQLServiceImpl::ReturnProcessor(const CQLProcessorListPos& pos) {
-  // Put the processor back before the next available one.
-  std::lock_guard<std::mutex> guard(processors_mutex_);
-  processors_.splice(next_available_processor_, processors_, pos);
-  next_available_processor_ = pos;
+CQLServiceImpl::PreparedStatementShard* CQLServiceImpl::prepared_stmts_shard(
+    const CQLMessage::QueryId& query_id) {
+  return &prepared_stmts_shards_[std::hash<CQLMessage::QueryId>()(query_id) %
+                                 kNumPreparedStmtShards];
 }
 
 shared_ptr<CQLStatement> CQLServiceImpl::AllocatePreparedStatement(
     const CQLMessage::QueryId& query_id, const string& keyspace, const string& ql_stmt) {
-  // Get exclusive lock before allocating a prepared statement and updating the LRU list.
-  std::lock_guard<std::mutex> guard(prepared_stmts_mutex_);
+  PreparedStatementShard* shard = prepared_stmts_shard(query_id);
+
+  // Get exclusive lock before allocating a prepared statement and updating the CLOCK list.
+  std::lock_guard<rw_spinlock> guard(shard->lock);
 
   shared_ptr<CQLStatement> stmt;
-  const auto itr = prepared_stmts_map_.find(query_id);
-  if (itr == prepared_stmts_map_.end()) {
+  const auto itr = shard->map.find(query_id);
+  if (itr == shard->map.end()) {
     // Allocate the prepared statement placeholder that multiple clients trying to prepare the same
     // statement to contend on. The statement will then be prepared by one client while the rest
     // wait for the results.
-    stmt = prepared_stmts_map_.emplace(
+    stmt = shard->map.emplace(
         query_id, std::make_shared<CQLStatement>(
-            keyspace, ql_stmt, prepared_stmts_list_.end())).first->second;
-    InsertLruPreparedStatementUnlocked(stmt);
+            keyspace, ql_stmt, shard->list.end())).first->second;
+    InsertLruPreparedStatementUnlocked(shard, stmt);
   } else {
     // Return existing statement if found.
     stmt = itr->second;
-    MoveLruPreparedStatementUnlocked(stmt);
   }
+  stmt->set_referenced();
 
-  VLOG(1) << "InsertPreparedStatement: CQL prepared statement cache count = "
-          << prepared_stmts_map_.size() << "/" << prepared_stmts_list_.size()
+  VLOG(1) << "InsertPreparedStatement: CQL prepared statement cache shard count = "
+          << shard->map.size() << "/" << shard->list.size()
           << ", memory usage = " << prepared_stmts_mem_tracker_->consumption();
 
   return stmt;
@@ -183,15 +185,20 @@ shared_ptr<CQLStatement> CQLServiceImpl::AllocatePreparedStatement(
 
 shared_ptr<const CQLStatement> CQLServiceImpl::GetPreparedStatement(
     const CQLMessage::QueryId& query_id) {
-  // Get exclusive lock before looking up a prepared statement and updating the LRU list.
-  std::lock_guard<std::mutex> guard(prepared_stmts_mutex_);
+  PreparedStatementShard* shard = prepared_stmts_shard(query_id);
 
-  const auto itr = prepared_stmts_map_.find(query_id);
-  if (itr == prepared_stmts_map_.end()) {
-    return nullptr;
-  }
+  shared_ptr<CQLStatement> stmt;
+  {
+    // A shared lock is enough to look up a prepared statement, as the CLOCK list is not updated.
+    boost::shared_lock<rw_spinlock> guard(shard->lock);
 
-  shared_ptr<CQLStatement> stmt = itr->second;
+    const auto itr = shard->map.find(query_id);
+    if (itr == shard->map.end()) {
+      return nullptr;
+    }
+
+    stmt = itr->second;
+  }
 
   // If the statement has not finished preparing, do not return it.
   if (stmt->unprepared()) {
@@ -199,64 +206,85 @@ shared_ptr<const CQLStatement> CQLServiceImpl::GetPreparedStatement(
   }
   // If the statement is stale, delete it.
   if (stmt->stale()) {
-    DeletePreparedStatementUnlocked(stmt);
+    std::lock_guard<rw_spinlock> guard(shard->lock);
+    DeletePreparedStatementUnlocked(shard, stmt);
     return nullptr;
   }
 
-  MoveLruPreparedStatementUnlocked(stmt);
+  stmt->set_referenced();
   return stmt;
 }
 
 void CQLServiceImpl::DeletePreparedStatement(const shared_ptr<const CQLStatement>& stmt) {
+  PreparedStatementShard* shard = prepared_stmts_shard(stmt->query_id());
+
   // Get exclusive lock before deleting the prepared statement.
-  std::lock_guard<std::mutex> guard(prepared_stmts_mutex_);
+  std::lock_guard<rw_spinlock> guard(shard->lock);
 
-  DeletePreparedStatementUnlocked(stmt);
+  DeletePreparedStatementUnlocked(shard, stmt);
 
-  VLOG(1) << "DeletePreparedStatement: CQL prepared statement cache count = "
-          << prepared_stmts_map_.size() << "/" << prepared_stmts_list_.size()
+  VLOG(1) << "DeletePreparedStatement: CQL prepared statement cache shard count = "
+          << shard->map.size() << "/" << shard->list.size()
           << ", memory usage = " << prepared_stmts_mem_tracker_->consumption();
 }
 
-void CQLServiceImpl::InsertLruPreparedStatementUnlocked(const shared_ptr<CQLStatement>& stmt) {
-  // Insert the statement at the front of the LRU list.
-  stmt->set_pos(prepared_stmts_list_.insert(prepared_stmts_list_.begin(), stmt));
-}
-
-void CQLServiceImpl::MoveLruPreparedStatementUnlocked(const shared_ptr<CQLStatement>& stmt) {
-  // Move the statement to the front of the LRU list.
-  prepared_stmts_list_.splice(prepared_stmts_list_.begin(), prepared_stmts_list_, stmt->pos());
+void CQLServiceImpl::InsertLruPreparedStatementUnlocked(PreparedStatementShard* shard,
+                                                        const shared_ptr<CQLStatement>& stmt) {
+  // Insert the statement right behind the CLOCK hand so that it is considered for eviction last.
+  stmt->set_pos(shard->list.insert(shard->hand, stmt));
 }
 
 void CQLServiceImpl::DeletePreparedStatementUnlocked(
-    const std::shared_ptr<const CQLStatement> stmt) {
+    PreparedStatementShard* shard, const std::shared_ptr<const CQLStatement> stmt) {
   // Remove statement from cache by looking it up by query ID and only when it is same statement
   // object. Note that the "stmt" parameter above is not a ref ("&") intentionally so that we have
-  // a separate copy of the shared_ptr and not the very shared_ptr in prepared_stmts_map_ or
-  // prepared_stmt_list_ we are deleting.
-  const auto itr = prepared_stmts_map_.find(stmt->query_id());
-  if (itr != prepared_stmts_map_.end() && itr->second == stmt) {
-    prepared_stmts_map_.erase(itr);
+  // a separate copy of the shared_ptr and not the very shared_ptr in the shard's map or list we
+  // are deleting.
+  const auto itr = shard->map.find(stmt->query_id());
+  if (itr != shard->map.end() && itr->second == stmt) {
+    shard->map.erase(itr);
   }
-  // Remove statement from LRU list only when it is in the list, i.e. pos() != end().
-  if (stmt->pos() != prepared_stmts_list_.end()) {
-    prepared_stmts_list_.erase(stmt->pos());
-    stmt->set_pos(prepared_stmts_list_.end());
+  // Remove statement from CLOCK list only when it is in the list, i.e. pos() != end().
+  if (stmt->pos() != shard->list.end()) {
+    if (shard->hand == stmt->pos()) {
+      ++shard->hand;
+    }
+    shard->list.erase(stmt->pos());
+    stmt->set_pos(shard->list.end());
   }
 }
 
 void CQLServiceImpl::DeleteLruPreparedStatement() {
-  // Get exclusive lock before deleting the least recently used statement at the end of the LRU
-  // list from the cache.
-  std::lock_guard<std::mutex> guard(prepared_stmts_mutex_);
+  // Evict from the shards in turn, skipping empty ones.
+  for (size_t i = 0; i < kNumPreparedStmtShards; ++i) {
+    PreparedStatementShard* shard =
+        &prepared_stmts_shards_[next_evict_shard_.fetch_add(1, std::memory_order_relaxed) %
+                                kNumPreparedStmtShards];
+
+    // Get exclusive lock before moving the CLOCK hand and deleting the statement it stops at.
+    std::lock_guard<rw_spinlock> guard(shard->lock);
+    if (shard->list.empty()) {
+      continue;
+    }
 
-  if (!prepared_stmts_list_.empty()) {
-    DeletePreparedStatementUnlocked(prepared_stmts_list_.back());
-  }
+    // Advance the hand past referenced statements, clearing their flags, until it reaches one that
+    // has not been used since the last pass. This takes at most one full turn.
+    while (true) {
+      if (shard->hand == shard->list.end()) {
+        shard->hand = shard->list.begin();
+      }
+      if (!(*shard->hand)->TestAndClearReferenced()) {
+        break;
+      }
+      ++shard->hand;
+    }
+    DeletePreparedStatementUnlocked(shard, *shard->hand);
 
-  VLOG(1) << "DeleteLruPreparedStatement: CQL prepared statement cache count = "
-          << prepared_stmts_map_.size() << "/" << prepared_stmts_list_.size()
-          << ", memory usage = " << prepared_stmts_mem_tracker_->consumption();
+    VLOG(1) << "DeleteLruPreparedStatement: CQL prepared statement cache shard count = "
+            << shard->map.size() << "/" << shard->list.size()
+            << ", memory usage = " << prepared_stmts_mem_tracker_->consumption();
+    return;
+  }
 }
 
 }  // namespace cqlserver
@@ -17,6 +17,7 @@
 #ifndef YB_YQL_CQL_CQLSERVER_CQL_SERVICE_H_
 #define YB_YQL_CQL_CQLSERVER_CQL_SERVICE_H_
 
+#include <array>
 #include <vector>
 
 #include "yb/yql/cql/cqlserver/cql_message.h"
@@ -27,6 +28,8 @@
 #include "yb/yql/cql/cqlserver/cql_server_options.h"
 #include "yb/yql/cql/ql/statement.h"
 
+#include "yb/util/locks.h"
+#include "yb/util/object_pool.h"
 #include "yb/util/string_case.h"
 
 #include "yb/client/async_initializer.h"
@@ -57,8 +60,11 @@ class CQLServiceImpl : public CQLServerServiceIf {
   // Processing all incoming request from RPC and sending response back.
   void Handle(yb::rpc::InboundCallPtr call) override;
 
-  // Return CQL processor at pos as available.
-  void ReturnProcessor(const CQLProcessorListPos& pos);
+  // Either gets an available processor or creates a new one.
+  CQLProcessor *GetProcessor();
+
+  // Return CQL processor to the pool of available processors.
+  void ReturnProcessor(CQLProcessor* processor);
 
   // Allocate a prepared statement. If the statement already exists, return it instead.
   std::shared_ptr<CQLStatement> AllocatePreparedStatement(
@@ -77,6 +83,11 @@ class CQLServiceImpl : public CQLServerServiceIf {
     return prepared_stmts_mem_tracker_;
   }
 
+  // Return the memory tracker for pages prefetched for CQL connections.
+  std::shared_ptr<MemTracker> prefetched_pages_mem_tracker() const {
+    return prefetched_pages_mem_tracker_;
+  }
+
   // Return the YBClient to communicate with either master or tserver.
   const std::shared_ptr<client::YBClient>& client() const;
 
@@ -95,22 +106,40 @@ class CQLServiceImpl : public CQLServerServiceIf {
  private:
   constexpr static int kRpcTimeoutSec = 5;
 
-  // Either gets an available processor or creates a new one.
-  CQLProcessor *GetProcessor();
+  // A shard of the prepared statements cache. Lookups take the shard lock in shared mode only and
+  // mark the statement as referenced. Eviction approximates LRU with a CLOCK hand over the list,
+  // which skips (and clears) referenced statements.
+  struct PreparedStatementShard {
+    // Prepared statements by query id.
+    CQLStatementMap map;
+
+    // Prepared statements in CLOCK order. New statements are inserted right behind the hand.
+    CQLStatementList list;
 
-  // Insert a prepared statement at the front of the LRU list. "prepared_stmts_mutex_" needs to be
-  // locked before this call.
-  void InsertLruPreparedStatementUnlocked(const std::shared_ptr<CQLStatement>& stmt);
+    // CLOCK hand: the next statement to consider for eviction.
+    CQLStatementListPos hand = list.end();
 
-  // Move a prepared statement to the front of the LRU list. "prepared_stmts_mutex_" needs to be
-  // locked before this call.
-  void MoveLruPreparedStatementUnlocked(const std::shared_ptr<CQLStatement>& stmt);
+    // Lock that protects the map, the list and the hand.
+    rw_spinlock lock;
+  };
 
-  // Delete a prepared statement from the cache and the LRU list. "prepared_stmts_mutex_" needs to
-  // be locked before this call.
-  void DeletePreparedStatementUnlocked(const std::shared_ptr<const CQLStatement> stmt);
+  static constexpr size_t kNumPreparedStmtShards = 16;
 
-  // Delete the least recently used prepared statement from the cache to free up memory.
+  // Return the shard of the prepared statements cache that the query id belongs to.
+  PreparedStatementShard* prepared_stmts_shard(const CQLMessage::QueryId& query_id);
+
+  // Insert a prepared statement into the CLOCK list right behind the hand. The shard lock needs to
+  // be held in exclusive mode.
+  void InsertLruPreparedStatementUnlocked(PreparedStatementShard* shard,
+                                          const std::shared_ptr<CQLStatement>& stmt);
+
+  // Delete a prepared statement from the cache shard and its CLOCK list. The shard lock needs to
+  // be held in exclusive mode.
+  void DeletePreparedStatementUnlocked(PreparedStatementShard* shard,
+                                       const std::shared_ptr<const CQLStatement> stmt);
+
+  // Delete an approximately least recently used prepared statement from the cache to free up
+  // memory.
   void DeleteLruPreparedStatement();
 
   // CQLServer of this service.
@@ -124,30 +153,25 @@ class CQLServiceImpl : public CQLServerServiceIf {
   mutable std::atomic<bool> is_metadata_initialized_ = { false };
   mutable std::mutex metadata_init_mutex_;
 
-  // List of CQL processors (in-use and available). In-use ones are at the beginning and available
-  // ones at the end.
-  CQLProcessorList processors_;
-
-  // Next available CQL processor.
-  CQLProcessorListPos next_available_processor_;
+  // Available CQL processors. The pool keeps a bounded lock-free free list per CPU, so getting and
+  // returning a processor does not contend on a lock, and processors returned to a full free list
+  // are deleted, which shrinks the pool after a burst of concurrent calls.
+  ThreadSafeObjectPool<CQLProcessor> processors_;
 
-  // Mutex that protects access to processors_.
-  std::mutex processors_mutex_;
+  // Prepared statements cache, sharded by query id.
+  std::array<PreparedStatementShard, kNumPreparedStmtShards> prepared_stmts_shards_;
 
-  // Prepared statements cache.
-  CQLStatementMap prepared_stmts_map_;
-
-  // Prepared statements LRU list (least recently used one at the end).
-  CQLStatementList prepared_stmts_list_;
-
-  // Mutex that protects the prepared statements and the LRU list.
-  std::mutex prepared_stmts_mutex_;
+  // Shard to evict the next prepared statement from, to spread eviction over the shards.
+  std::atomic<size_t> next_evict_shard_ = { 0 };
 
   std::shared_ptr<ql::Statement> auth_prepared_stmt_;
 
   // Tracker to measure and limit memory usage of prepared statements.
   std::shared_ptr<MemTracker> prepared_stmts_mem_tracker_;
 
+  // Tracker to measure memory usage of prefetched pages.
+  std::shared_ptr<MemTracker> prefetched_pages_mem_tracker_;
+
   // Metrics to be collected and reported.
   yb::rpc::RpcMethodMetrics metrics_;
 
@@ -19,6 +19,7 @@
 #ifndef YB_YQL_CQL_CQLSERVER_CQL_STATEMENT_H_
 #define YB_YQL_CQL_CQLSERVER_CQL_STATEMENT_H_
 
+#include <atomic>
 #include <list>
 
 #include "yb/yql/cql/cqlserver/cql_message.h"
@@ -47,16 +48,32 @@ class CQLStatement : public ql::Statement {
   // Return the query id.
   CQLMessage::QueryId query_id() const { return GetQueryId(keyspace_, text_); }
 
-  // Get/set position of the statement in the LRU.
+  // Get/set position of the statement in the CLOCK list of its prepared statements cache shard.
   CQLStatementListPos pos() const { return pos_; }
   void set_pos(CQLStatementListPos pos) const { pos_ = pos; }
 
+  // Mark the statement as used since the CLOCK hand last passed it. The flag is only written when
+  // it is not set yet, so that lookups of a hot statement do not contend on its cache line.
+  void set_referenced() const {
+    if (!referenced_.load(std::memory_order_relaxed)) {
+      referenced_.store(true, std::memory_order_relaxed);
+    }
+  }
+
+  // Clear the referenced flag and return whether it was set.
+  bool TestAndClearReferenced() const {
+    return referenced_.exchange(false, std::memory_order_relaxed);
+  }
+
   // Return the query id of a statement.
   static CQLMessage::QueryId GetQueryId(const std::string& keyspace, const std::string& ql_stmt);
 
  private:
-  // Position of the statement in the LRU.
+  // Position of the statement in the CLOCK list.
   mutable CQLStatementListPos pos_;
+
+  // Whether the statement has been used since the CLOCK hand last passed it.
+  mutable std::atomic<bool> referenced_ = { false };
 };
 
 }  // namespace cqlserver
@@ -11,6 +11,9 @@
 // under the License.
 //
 
+#include <lz4.h>
+#include <snappy.h>
+
 #include <memory>
 #include <string>
 #include <vector>
@@ -21,6 +24,7 @@
 #include "yb/yql/cql/cqlserver/cql_message.h"
 #include "yb/yql/cql/cqlserver/cql_server.h"
 
+#include "yb/gutil/endian.h"
 #include "yb/gutil/strings/join.h"
 #include "yb/util/cast.h"
 #include "yb/util/net/net_util.h"
@@ -250,5 +254,96 @@ TEST_F(TestCQLService, TestCQLServerEventConst) {
   ASSERT_EQ(0, memcmp(buffer, ptr, kSize));
 }
 
+namespace {
+
+// Compresses the body of the frame the way CQL drivers do and sets the compression flag.
+string CompressFrame(const string& frame, CQLMessage::CompressionScheme compression_scheme) {
+  const char* body = frame.data() + CQLMessage::kMessageHeaderLength;
+  const size_t body_size = frame.size() - CQLMessage::kMessageHeaderLength;
+  string result = frame.substr(0, CQLMessage::kMessageHeaderLength);
+  result[CQLMessage::kHeaderPosFlags] |= CQLMessage::kCompressionFlag;
+  string compressed;
+  switch (compression_scheme) {
+    case CQLMessage::CompressionScheme::LZ4: {
+      compressed.resize(sizeof(uint32_t) + LZ4_compressBound(body_size));
+      NetworkByteOrder::Store32(&compressed[0], body_size);
+      const int size = LZ4_compress_default(
+          body, &compressed[sizeof(uint32_t)], body_size, compressed.size() - sizeof(uint32_t));
+      CHECK_GT(size, 0);
+      compressed.resize(sizeof(uint32_t) + size);
+      break;
+    }
+    case CQLMessage::CompressionScheme::SNAPPY:
+      snappy::Compress(body, body_size, &compressed);
+      break;
+    case CQLMessage::CompressionScheme::NONE:
+      return frame;
+  }
+  NetworkByteOrder::Store32(&result[CQLMessage::kHeaderPosLength], compressed.size());
+  return result + compressed;
+}
+
+string BuildQueryFrame(const string& query) {
+  string frame = BINARY_STRING("\x04\x00\x00\x01\x07" "\x00\x00\x00\x00");
+  string long_string(sizeof(uint32_t), 0);
+  NetworkByteOrder::Store32(&long_string[0], query.size());
+  // Query, ONE consistency and no flags.
+  frame += long_string + query + BINARY_STRING("\x00\x01" "\x00");
+  NetworkByteOrder::Store32(
+      &frame[CQLMessage::kHeaderPosLength], frame.size() - CQLMessage::kMessageHeaderLength);
+  return frame;
+}
+
+} // namespace
+
+// Measures frames per second of parsing requests and serializing responses with each compression
+// scheme.
+TEST(CQLMessageTest, CompressionBenchmark) {
+  string query = "SELECT * FROM test_table WHERE h = 1 AND r IN (";
+  for (int i = 0; i != 100; ++i) {
+    query += Substitute("$0$1", i == 0 ? "" : ", ", i);
+  }
+  query += ")";
+  const string frame = BuildQueryFrame(query);
+
+  // Rows data is opaque to the serializer, so just make it compressible.
+  string rows_data(sizeof(int32_t), 0);
+  NetworkByteOrder::Store32(&rows_data[0], 100);
+  for (int i = 0; i != 100; ++i) {
+    rows_data += Substitute("row $0: the quick brown fox jumps over the lazy dog. ", i);
+  }
+  auto rows_result = std::make_shared<ql::RowsResult>(
+      client::YBTableName("test_keyspace", "test_table"),
+      std::make_shared<vector<ColumnSchema>>(), rows_data);
+
+  constexpr int kNumFrames = 20000;
+  for (auto compression_scheme : {CQLMessage::CompressionScheme::NONE,
+                                  CQLMessage::CompressionScheme::LZ4,
+                                  CQLMessage::CompressionScheme::SNAPPY}) {
+    const string request_frame = CompressFrame(frame, compression_scheme);
+    size_t response_bytes = 0;
+    const MonoTime start = MonoTime::Now();
+    for (int i = 0; i != kNumFrames; ++i) {
+      unique_ptr<CQLRequest> request;
+      unique_ptr<CQLResponse> error_response;
+      ASSERT_TRUE(CQLRequest::ParseRequest(
+          request_frame, compression_scheme, &request, &error_response));
+      const auto& query_request = static_cast<const QueryRequest&>(*request);
+      ASSERT_EQ(query, query_request.query());
+
+      std::vector<RefCntBuffer> buffers;
+      RowsResultResponse(query_request, rows_result).SerializeToBuffers(
+          compression_scheme, &buffers);
+      for (const auto& buffer : buffers) {
+        response_bytes += buffer.size();
+      }
+    }
+    const MonoDelta elapsed = MonoTime::Now() - start;
+    LOG(INFO) << "Compression " << static_cast<int>(compression_scheme) << ": "
+              << kNumFrames / elapsed.ToSeconds() << " frames/s, request size "
+              << request_frame.size() << ", response size " << response_bytes / kNumFrames;
+  }
+}
+
 }  // namespace cqlserver
 }  // namespace yb
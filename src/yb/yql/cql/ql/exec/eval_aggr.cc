@@ -15,6 +15,8 @@
 
 #include "yb/yql/cql/ql/exec/executor.h"
 
+#include "yb/util/decimal.h"
+
 namespace yb {
 namespace ql {
 
@@ -137,6 +139,12 @@ CHECKED_STATUS Executor::EvalSum(const shared_ptr<QLRowBlock>& row_block,
         ql_value->set_varint_value(ql_value->varint_value() +
                                    row.column(column_index).varint_value());
         break;
+      case DataType::DECIMAL:
+        ql_value->set_decimal_value(
+            (util::DecimalFromComparable(ql_value->decimal_value()) +
+             util::DecimalFromComparable(row.column(column_index).decimal_value()))
+                .EncodeToComparable());
+        break;
       case DataType::FLOAT:
         ql_value->set_float_value(ql_value->float_value() + row.column(column_index).float_value());
         break;
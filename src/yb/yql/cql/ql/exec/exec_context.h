@@ -206,6 +206,18 @@ class ExecContext : public ProcessContextBase {
     return ql_env_->Apply(op);
   }
 
+  // Used for selects that scan the whole table. The scan is split into hash-code ranges that are
+  // read in parallel. For aggregates each range returns partial aggregates that the executor
+  // merges, otherwise the executor returns the rows of the ranges in order.
+  // Called from Executor::FanOutAggregate, Executor::FanOutScan and their continuations.
+  CHECKED_STATUS ApplyFanout(const std::shared_ptr<client::YBqlReadOp>& op) {
+    return ql_env_->Apply(op);
+  }
+
+  std::vector<std::shared_ptr<client::YBqlReadOp>>& fanout_ops() {
+    return fanout_ops_;
+  }
+
   bool SelectingAggregate();
 
   // Variants of ProcessContextBase::Error() that report location of statement tnode as the error
@@ -228,6 +240,11 @@ class ExecContext : public ProcessContextBase {
   // Read/write operation to execute.
   std::shared_ptr<client::YBqlOp> op_;
 
+  // Read operations of a select that is fanned out over hash-code ranges, in range order. They
+  // are processed in place of op_. For aggregates, ranges that have been read to the end are
+  // removed as the select progresses.
+  std::vector<std::shared_ptr<client::YBqlReadOp>> fanout_ops_;
+
   // Execution start time.
   const MonoTime start_time_;
 
@@ -20,8 +20,34 @@
 #include "yb/client/yb_op.h"
 #include "yb/yql/cql/ql/ql_processor.h"
 #include "yb/util/decimal.h"
+#include "yb/util/enums.h"
+#include "yb/util/flag_tags.h"
+#include "yb/util/trace.h"
+#include "yb/util/yb_partition.h"
 #include "yb/common/common.pb.h"
 
+DEFINE_int32(cql_aggregate_fanout_ranges, 32,
+             "Number of hash-code ranges that an aggregate select over a whole table is split into "
+             "and read in parallel. Partial aggregates of the ranges are merged by the executor. "
+             "A value of 1 or less scans the tablets one after another.");
+TAG_FLAG(cql_aggregate_fanout_ranges, advanced);
+TAG_FLAG(cql_aggregate_fanout_ranges, runtime);
+
+DEFINE_int32(cql_parallel_scan_degree, 4,
+             "Number of hash-code ranges that a select over a whole table reads in parallel once "
+             "it has crossed a tablet boundary without filling the page. A value of 1 or less "
+             "reads the tablets one after another. Can be overridden per statement with "
+             "StatementParameters::set_parallel_scan_degree.");
+TAG_FLAG(cql_parallel_scan_degree, advanced);
+TAG_FLAG(cql_parallel_scan_degree, runtime);
+
+DEFINE_int32(cql_consistency_one_max_staleness_ms, 0,
+             "Max staleness in milliseconds of selects with consistency level ONE, which are "
+             "served by the closest replica. Replicas whose safe time is older are skipped. "
+             "A value of 0 or less means unbounded staleness.");
+TAG_FLAG(cql_consistency_one_max_staleness_ms, advanced);
+TAG_FLAG(cql_consistency_one_max_staleness_ms, runtime);
+
 namespace yb {
 namespace ql {
 
@@ -547,8 +573,63 @@ Status Executor::ExecPTNode(const PTGrantPermission *tnode) {
 
 //--------------------------------------------------------------------------------------------------
 
+namespace {
+
+int32_t IndexColumnId(const MCUnorderedMap<int32, int32>& index_column_ids, int32_t column_id) {
+  const auto iter = index_column_ids.find(column_id);
+  DCHECK(iter != index_column_ids.end()) << "Column " << column_id << " is not in the index";
+  return iter != index_column_ids.end() ? iter->second : column_id;
+}
+
+// Replace the column ids of the indexed table in the expression with the ids of the same columns
+// in the covering index the select reads from.
+void ToIndexColumnIds(const MCUnorderedMap<int32, int32>& index_column_ids,
+                      QLExpressionPB* expr_pb) {
+  switch (expr_pb->expr_case()) {
+    case QLExpressionPB::ExprCase::kColumnId:
+      expr_pb->set_column_id(IndexColumnId(index_column_ids, expr_pb->column_id()));
+      return;
+    case QLExpressionPB::ExprCase::kSubscriptedCol: {
+      auto* col_pb = expr_pb->mutable_subscripted_col();
+      col_pb->set_column_id(IndexColumnId(index_column_ids, col_pb->column_id()));
+      for (auto& arg : *col_pb->mutable_subscript_args()) {
+        ToIndexColumnIds(index_column_ids, &arg);
+      }
+      return;
+    }
+    case QLExpressionPB::ExprCase::kCondition:
+      for (auto& operand : *expr_pb->mutable_condition()->mutable_operands()) {
+        ToIndexColumnIds(index_column_ids, &operand);
+      }
+      return;
+    case QLExpressionPB::ExprCase::kBfcall:
+      for (auto& operand : *expr_pb->mutable_bfcall()->mutable_operands()) {
+        ToIndexColumnIds(index_column_ids, &operand);
+      }
+      return;
+    case QLExpressionPB::ExprCase::kTscall:
+      for (auto& operand : *expr_pb->mutable_tscall()->mutable_operands()) {
+        ToIndexColumnIds(index_column_ids, &operand);
+      }
+      return;
+    case QLExpressionPB::ExprCase::kBocall:
+      for (auto& operand : *expr_pb->mutable_bocall()->mutable_operands()) {
+        ToIndexColumnIds(index_column_ids, &operand);
+      }
+      return;
+    case QLExpressionPB::ExprCase::kValue: FALLTHROUGH_INTENDED;
+    case QLExpressionPB::ExprCase::kBindId: FALLTHROUGH_INTENDED;
+    case QLExpressionPB::ExprCase::EXPR_NOT_SET:
+      return;
+  }
+  FATAL_INVALID_ENUM_VALUE(QLExpressionPB::ExprCase, expr_pb->expr_case());
+}
+
+} // namespace
+
 Status Executor::ExecPTNode(const PTSelectStmt *tnode) {
-  const shared_ptr<client::YBTable>& table = tnode->table();
+  // A select on the columns of a covering index reads the index alone.
+  const shared_ptr<client::YBTable>& table = tnode->read_table();
   if (table == nullptr) {
     // If this is a system table but the table does not exist, it is okay. Just return OK with void
     // result.
@@ -570,19 +651,23 @@ Status Executor::ExecPTNode(const PTSelectStmt *tnode) {
 
   bool no_results = false;
   req->set_is_aggregate(tnode->is_aggregate());
-  Status st = WhereClauseToPB(req, tnode->key_where_ops(), tnode->where_ops(),
-                              tnode->subscripted_col_where_ops(), tnode->partition_key_ops(),
-                              tnode->func_ops(), &no_results);
+  Status st = tnode->read_from_index()
+      ? WhereClauseToPB(req, tnode->index_key_where_ops(), tnode->index_where_ops(),
+                        tnode->subscripted_col_where_ops(), tnode->partition_key_ops(),
+                        tnode->func_ops(), &no_results)
+      : WhereClauseToPB(req, tnode->key_where_ops(), tnode->where_ops(),
+                        tnode->subscripted_col_where_ops(), tnode->partition_key_ops(),
+                        tnode->func_ops(), &no_results);
   if (PREDICT_FALSE(!st.ok())) {
     return exec_context_->Error(st, ErrorCode::INVALID_ARGUMENTS);
   }
 
   // If where clause restrictions guarantee no rows could match, return empty result immediately.
   if (no_results && !tnode->is_aggregate()) {
-    QLRowBlock empty_row_block(tnode->table()->InternalSchema(), {});
+    QLRowBlock empty_row_block(table->InternalSchema(), {});
     faststring buffer;
     empty_row_block.Serialize(select_op->request().client(), &buffer);
-    *select_op->mutable_rows_data() = buffer.ToString();
+    *select_op->mutable_rows_data() = RefCntBuffer(buffer);
     result_ = std::make_shared<RowsResult>(select_op.get());
     return Status::OK();
   }
@@ -613,6 +698,17 @@ Status Executor::ExecPTNode(const PTSelectStmt *tnode) {
     return exec_context_->Error(st, ErrorCode::INVALID_ARGUMENTS);
   }
 
+  // The selected expressions and column references are on the indexed table's columns.
+  if (tnode->read_from_index()) {
+    const auto& index_column_ids = tnode->index_column_ids();
+    for (auto& expr_pb : *req->mutable_selected_exprs()) {
+      ToIndexColumnIds(index_column_ids, &expr_pb);
+    }
+    for (auto& column_id : *req->mutable_column_refs()->mutable_ids()) {
+      column_id = IndexColumnId(index_column_ids, column_id);
+    }
+  }
+
   // Specify distinct columns or non.
   req->set_distinct(tnode->distinct());
 
@@ -671,6 +767,19 @@ Status Executor::ExecPTNode(const PTSelectStmt *tnode) {
     select_op->set_yb_consistency_level(YBConsistencyLevel::STRONG);
   } else {
     select_op->set_yb_consistency_level(params.yb_consistency_level());
+    if (params.yb_consistency_level() == YBConsistencyLevel::CONSISTENT_PREFIX &&
+        FLAGS_cql_consistency_one_max_staleness_ms > 0) {
+      select_op->set_max_staleness(
+          MonoDelta::FromMilliseconds(FLAGS_cql_consistency_one_max_staleness_ms));
+    }
+  }
+
+  // An aggregate over the whole table returns one partial aggregate per tablet, so read it as
+  // several hash-code ranges in parallel rather than one tablet after another.
+  if (tnode->is_aggregate() && !no_results && !continue_select && !tnode->has_limit() &&
+      tnode->is_forward_scan() && req->hashed_column_values().empty() &&
+      exec_context_->UnreadPartitionsRemaining() == 0 && FLAGS_cql_aggregate_fanout_ranges > 1) {
+    return FanOutAggregate(tnode, select_op);
   }
 
   // If we have several hash partitions (i.e. IN condition on hash columns) we initialize the
@@ -689,7 +798,179 @@ Status Executor::ExecPTNode(const PTSelectStmt *tnode) {
   return exec_context_->Apply(select_op);
 }
 
+Status Executor::FanOutAggregate(const PTSelectStmt *tnode,
+                                 const shared_ptr<YBqlReadOp>& select_op) {
+  const QLReadRequestPB& req = select_op->request();
+  const uint64_t min_hash_code = req.has_hash_code() ? req.hash_code() : YBPartition::kMinHashCode;
+  const uint64_t max_hash_code =
+      req.has_max_hash_code() ? req.max_hash_code() : YBPartition::kMaxHashCode;
+  if (min_hash_code > max_hash_code) {
+    return exec_context_->Apply(select_op);
+  }
+
+  const uint64_t hash_code_count = max_hash_code - min_hash_code + 1;
+  const uint64_t range_count =
+      std::min<uint64_t>(FLAGS_cql_aggregate_fanout_ranges, hash_code_count);
+  auto& ops = exec_context_->fanout_ops();
+  ops.reserve(range_count);
+  for (uint64_t i = 0; i < range_count; i++) {
+    shared_ptr<YBqlReadOp> op(tnode->read_table()->NewQLSelect());
+    op->mutable_request()->CopyFrom(req);
+    op->mutable_request()->set_hash_code(min_hash_code + hash_code_count * i / range_count);
+    op->mutable_request()->set_max_hash_code(
+        min_hash_code + hash_code_count * (i + 1) / range_count - 1);
+    op->set_yb_consistency_level(select_op->yb_consistency_level());
+    op->set_max_staleness(select_op->max_staleness());
+    ops.push_back(op);
+  }
+  for (const auto& op : ops) {
+    RETURN_NOT_OK(exec_context_->ApplyFanout(op));
+  }
+  return Status::OK();
+}
+
+Status Executor::FetchMoreFanoutRows() {
+  // Drop the ranges that have been read to the end and continue the others from the next tablet.
+  auto& ops = exec_context_->fanout_ops();
+  ops.erase(std::remove_if(ops.begin(), ops.end(), [](const shared_ptr<YBqlReadOp>& op) {
+              return !op->response().has_paging_state() ||
+                     op->response().paging_state().next_partition_key().empty();
+            }), ops.end());
+
+  if (ops.empty()) {
+    // The paging state of the last partial result does not apply to the merged aggregate.
+    if (result_ != nullptr) {
+      std::static_pointer_cast<RowsResult>(result_)->clear_paging_state();
+    }
+    return Status::OK();
+  }
+
+  for (const auto& op : ops) {
+    op->mutable_request()->mutable_paging_state()->CopyFrom(op->response().paging_state());
+    RETURN_NOT_OK(exec_context_->ApplyFanout(op));
+  }
+  return Status::OK();
+}
+
+namespace {
+
+uint32_t ParallelScanDegree(const StatementParameters& params) {
+  return params.parallel_scan_degree() > 0 ? params.parallel_scan_degree()
+                                           : std::max(FLAGS_cql_parallel_scan_degree, 1);
+}
+
+} // namespace
+
+bool Executor::CanFanOutScan(const PTSelectStmt *tnode, const QLReadRequestPB& req) {
+  return ParallelScanDegree(*exec_context_->params()) > 1 && !tnode->is_aggregate() && tnode->is_forward_scan() &&
+         req.hashed_column_values().empty() && req.return_paging_state() &&
+         exec_context_->UnreadPartitionsRemaining() == 0;
+}
+
+Status Executor::FanOutScan(const PTSelectStmt *tnode, const shared_ptr<YBqlReadOp>& op) {
+  const QLReadRequestPB& req = op->request();
+  const uint64_t min_hash_code =
+      PartitionSchema::DecodeMultiColumnHashValue(req.paging_state().next_partition_key());
+  const uint64_t max_hash_code =
+      req.has_max_hash_code() ? req.max_hash_code() : YBPartition::kMaxHashCode;
+  if (min_hash_code > max_hash_code) {
+    return exec_context_->Apply(op);
+  }
+
+  const uint32_t degree = ParallelScanDegree(*exec_context_->params());
+  const uint64_t hash_code_count = max_hash_code - min_hash_code + 1;
+  const uint64_t range_count = std::min<uint64_t>(degree, hash_code_count);
+  auto& ops = exec_context_->fanout_ops();
+  ops.reserve(range_count);
+  for (uint64_t i = 0; i < range_count; i++) {
+    // Every range is read with the whole remaining page limit, since it is not known in advance
+    // how many rows the ranges before it will return.
+    shared_ptr<YBqlReadOp> range_op(tnode->read_table()->NewQLSelect());
+    QLReadRequestPB* range_req = range_op->mutable_request();
+    range_req->CopyFrom(req);
+    range_req->set_hash_code(min_hash_code + hash_code_count * i / range_count);
+    range_req->set_max_hash_code(min_hash_code + hash_code_count * (i + 1) / range_count - 1);
+    range_req->clear_paging_state();
+    range_req->mutable_paging_state()->set_total_num_rows_read(
+        req.paging_state().total_num_rows_read());
+    range_op->set_yb_consistency_level(op->yb_consistency_level());
+    range_op->set_max_staleness(op->max_staleness());
+    ops.push_back(range_op);
+  }
+  for (const auto& range_op : ops) {
+    RETURN_NOT_OK(exec_context_->ApplyFanout(range_op));
+  }
+  return Status::OK();
+}
+
+Status Executor::MergeFanoutScanRows() {
+  const PTSelectStmt *tnode = static_cast<const PTSelectStmt *>(exec_context_->tnode());
+  std::vector<shared_ptr<YBqlReadOp>> ops;
+  ops.swap(exec_context_->fanout_ops());
+
+  // Take the rows of the ranges in order until a range is not read to its end, or its rows do not
+  // fit in the page any more. The scan resumes from there.
+  size_t remaining = ops.front()->request().limit();
+  QLPagingStatePB resume_paging_state;
+  for (const auto& op : ops) {
+    size_t row_count = 0;
+    if (!op->rows_data().empty()) {
+      RETURN_NOT_OK(QLRowBlock::GetRowCount(op->request().client(), op->rows_data(), &row_count));
+    }
+    if (row_count > remaining) {
+      resume_paging_state.set_next_partition_key(
+          PartitionSchema::EncodeMultiColumnHashValue(op->request().hash_code()));
+      break;
+    }
+    if (!op->rows_data().empty()) {
+      RETURN_NOT_OK(AppendResult(std::make_shared<RowsResult>(op.get())));
+    }
+    remaining -= row_count;
+    const QLPagingStatePB& paging_state = op->response().paging_state();
+    if (!paging_state.next_partition_key().empty() || !paging_state.next_row_key().empty()) {
+      resume_paging_state.set_next_partition_key(paging_state.next_partition_key());
+      resume_paging_state.set_next_row_key(paging_state.next_row_key());
+      break;
+    }
+  }
+
+  // All ranges were read to the end, which is the end of the scan.
+  RowsResult::SharedPtr current_result = std::static_pointer_cast<RowsResult>(result_);
+  if (resume_paging_state.next_partition_key().empty() &&
+      resume_paging_state.next_row_key().empty()) {
+    if (current_result != nullptr) {
+      current_result->clear_paging_state();
+    }
+    return Status::OK();
+  }
+
+  size_t current_fetch_row_count = 0;
+  if (current_result != nullptr) {
+    RETURN_NOT_OK(QLRowBlock::GetRowCount(current_result->client(),
+                                          current_result->rows_data(),
+                                          &current_fetch_row_count));
+  }
+  resume_paging_state.set_total_num_rows_read(
+      exec_context_->params()->total_num_rows_read() + current_fetch_row_count);
+
+  // Continue with the original read op if the page is not full yet.
+  std::shared_ptr<YBqlReadOp> op = std::static_pointer_cast<YBqlReadOp>(exec_context_->op());
+  if (remaining > 0) {
+    op->mutable_request()->set_limit(remaining);
+    op->mutable_request()->mutable_paging_state()->CopyFrom(resume_paging_state);
+    return exec_context_->Apply(op);
+  }
+
+  resume_paging_state.set_table_id(tnode->read_table()->id());
+  current_result->set_paging_state(resume_paging_state);
+  return Status::OK();
+}
+
 Status Executor::FetchMoreRowsIfNeeded() {
+  if (exec_context_ != nullptr && !exec_context_->fanout_ops().empty()) {
+    return exec_context_->SelectingAggregate() ? FetchMoreFanoutRows() : MergeFanoutScanRows();
+  }
+
   if (result_ == nullptr) {
     return Status::OK();
   }
@@ -752,7 +1033,7 @@ Status Executor::FetchMoreRowsIfNeeded() {
     if (finished_current_read_partition && op->request().return_paging_state()) {
       QLPagingStatePB paging_state;
       paging_state.set_total_num_rows_read(total_row_count);
-      paging_state.set_table_id(tnode->table()->id());
+      paging_state.set_table_id(tnode->read_table()->id());
       paging_state.set_next_partition_index(exec_context_->current_partition_index());
       current_result->set_paging_state(paging_state);
     }
@@ -770,6 +1051,13 @@ Status Executor::FetchMoreRowsIfNeeded() {
   paging_state->set_next_row_key(current_params.next_row_key());
   paging_state->set_total_num_rows_read(total_row_count);
 
+  // If a table scan has moved on to the next tablet without filling the page, the tablets are
+  // likely small, so read the next ranges of the table in parallel.
+  if (current_params.next_row_key().empty() && !current_params.next_partition_key().empty() &&
+      CanFanOutScan(tnode, op->request())) {
+    return FanOutScan(tnode, op);
+  }
+
   // Apply the request.
   return exec_context_->Apply(op);
 }
@@ -975,6 +1263,12 @@ Status Executor::ExecPTNode(const PTUseKeyspace *tnode) {
 
 bool Executor::FlushAsync() {
   batched_write_ops_.clear();
+  // Transaction block is flushed at once and committed right after the flush, so its writes
+  // could bypass the distributed transaction when they go to a single tablet.
+  if (exec_context_ != nullptr && exec_context_->tnode() != nullptr &&
+      exec_context_->tnode()->opcode() == TreeNodeOpcode::kPTCommit) {
+    ql_env_->MarkLastTransactionBatch();
+  }
   return ql_env_->FlushAsync(&flush_async_cb_);
 }
 
@@ -1080,33 +1374,61 @@ Status Executor::ProcessStatementStatus(const ParseTree &parse_tree, const Statu
   return s;
 }
 
-Status Executor::ProcessOpResponse(client::YBqlOp* op, ExecContext* exec_context) {
+Status Executor::CheckOpResponse(client::YBqlOp* op, ExecContext* exec_context) {
   const QLResponsePB &resp = op->response();
   CHECK(resp.has_status()) << "QLResponsePB status missing";
   if (resp.status() != QLResponsePB::YQL_STATUS_OK) {
     return exec_context->Error(resp.error_message().c_str(), QLStatusToErrorCode(resp.status()));
   }
+  if (resp.has_read_stats()) {
+    // Shows up in the trace dumped for slow queries.
+    TRACE("Read stats: $0", resp.read_stats().ShortDebugString());
+    if (ql_metrics_ != nullptr) {
+      ql_metrics_->RecordReadStats(resp.read_stats());
+    }
+  }
+  return Status::OK();
+}
+
+Status Executor::ProcessOpResponse(client::YBqlOp* op, ExecContext* exec_context) {
+  RETURN_NOT_OK(CheckOpResponse(op, exec_context));
   return op->rows_data().empty() ? Status::OK() : AppendResult(std::make_shared<RowsResult>(op));
 }
 
+Status Executor::ProcessAsyncResult(client::YBqlOp* op, ExecContext* exec_context,
+                                    bool append_result) {
+  Status s = ql_env_->GetOpError(op);
+  if (PREDICT_FALSE(!s.ok())) {
+    // YBOperation returns not-found error when the tablet is not found.
+    const auto error_code =
+        s.IsNotFound() ? ErrorCode::TABLET_NOT_FOUND : ErrorCode::SQL_STATEMENT_INVALID;
+    s = exec_context->Error(s, error_code);
+  }
+  if (s.ok()) {
+    s = append_result ? ProcessOpResponse(op, exec_context) : CheckOpResponse(op, exec_context);
+  }
+  return ProcessStatementStatus(*exec_context->parse_tree(), s);
+}
+
 Status Executor::ProcessAsyncResults() {
   Status s, ss;
   for (auto& exec_context : exec_contexts_) {
+    if (!exec_context.fanout_ops().empty()) {
+      // Rows of a fanned-out scan are merged in range order in MergeFanoutScanRows.
+      const bool append_result = exec_context.SelectingAggregate();
+      for (const auto& op : exec_context.fanout_ops()) {
+        ss = ProcessAsyncResult(op.get(), &exec_context, append_result);
+        if (PREDICT_FALSE(!ss.ok())) {
+          s = ss;
+        }
+      }
+      continue;
+    }
     client::YBqlOp* op = exec_context.op().get();
     if (op == nullptr) {
       continue; // Skip empty op.
     }
-    ss = ql_env_->GetOpError(op);
-    if (PREDICT_FALSE(!ss.ok())) {
-      // YBOperation returns not-found error when the tablet is not found.
-      const auto error_code =
-          ss.IsNotFound() ? ErrorCode::TABLET_NOT_FOUND : ErrorCode::SQL_STATEMENT_INVALID;
-      ss = exec_context.Error(ss, error_code);
-    }
-    if (ss.ok()) {
-      ss = ProcessOpResponse(op, &exec_context);
-    }
-    ss = ProcessStatementStatus(*exec_context.parse_tree(), ss);
+    ss = ProcessAsyncResult(op, &exec_context);
     if (PREDICT_FALSE(!ss.ok())) {
       s = ss;
     }
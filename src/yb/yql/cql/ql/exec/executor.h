@@ -155,6 +155,14 @@ class Executor : public QLExprExecutor {
   // Process the read/write op response.
   CHECKED_STATUS ProcessOpResponse(client::YBqlOp* op, ExecContext* exec_context);
 
+  // Check the status in the read/write op response.
+  CHECKED_STATUS CheckOpResponse(client::YBqlOp* op, ExecContext* exec_context);
+
+  // Process the error and response of one op after FlushAsyncDone. The rows returned are appended
+  // to the execution result if append_result is set.
+  CHECKED_STATUS ProcessAsyncResult(client::YBqlOp* op, ExecContext* exec_context,
+                                    bool append_result = true);
+
   // Process result of FlushAsyncDone.
   CHECKED_STATUS ProcessAsyncResults();
 
@@ -164,6 +172,19 @@ class Executor : public QLExprExecutor {
   // Continue a multi-partition select (e.g. table scan or query with 'IN' condition on hash cols).
   CHECKED_STATUS FetchMoreRowsIfNeeded();
 
+  // Read a whole-table aggregate select as several hash-code ranges in parallel, and continue the
+  // ranges that span more than one tablet.
+  CHECKED_STATUS FanOutAggregate(const PTSelectStmt *tnode,
+                                 const std::shared_ptr<client::YBqlReadOp>& select_op);
+  CHECKED_STATUS FetchMoreFanoutRows();
+
+  // Read the next hash-code ranges of a table scan in parallel once it has crossed a tablet
+  // boundary, and merge their rows in range order while keeping the paging semantics.
+  bool CanFanOutScan(const PTSelectStmt *tnode, const QLReadRequestPB& req);
+  CHECKED_STATUS FanOutScan(const PTSelectStmt *tnode,
+                            const std::shared_ptr<client::YBqlReadOp>& op);
+  CHECKED_STATUS MergeFanoutScanRows();
+
   // Aggregate all result sets from all tablet servers to form the requested resultset.
   CHECKED_STATUS AggregateResultSets();
   CHECKED_STATUS EvalCount(const std::shared_ptr<QLRowBlock>& row_block,
@@ -31,11 +31,27 @@ using std::string;
 // ParseContext
 //--------------------------------------------------------------------------------------------------
 
+namespace {
+
+ParseTree::UniPtr ReuseOrCreateParseTree(
+    ParseTree::UniPtr parse_tree, const bool reparsed, shared_ptr<MemTracker> mem_tracker) {
+  if (parse_tree != nullptr) {
+    DCHECK(mem_tracker == nullptr) << "Reused parse trees are not tracked";
+    parse_tree->Reset(reparsed);
+    return parse_tree;
+  }
+  return ParseTree::UniPtr(new ParseTree(reparsed, std::move(mem_tracker)));
+}
+
+} // namespace
+
 ParseContext::ParseContext(const char *stmt,
                            size_t stmt_len,
                            const bool reparsed,
-                           shared_ptr<MemTracker> mem_tracker)
-    : ProcessContext(stmt, stmt_len, ParseTree::UniPtr(new ParseTree(reparsed, mem_tracker))),
+                           shared_ptr<MemTracker> mem_tracker,
+                           ParseTree::UniPtr parse_tree)
+    : ProcessContext(stmt, stmt_len, ReuseOrCreateParseTree(std::move(parse_tree), reparsed,
+                                                            std::move(mem_tracker))),
       bind_variables_(PTreeMem()),
       stmt_offset_(0),
       trace_scanning_(false),
@@ -38,7 +38,8 @@ class ParseContext : public ProcessContext {
   ParseContext(const char *stmt = "",
                size_t stmt_len = 0,
                bool reparsed = false,
-               std::shared_ptr<MemTracker> mem_tracker = nullptr);
+               std::shared_ptr<MemTracker> mem_tracker = nullptr,
+               ParseTree::UniPtr parse_tree = nullptr);
   virtual ~ParseContext();
 
   // Read a maximum of 'max_size' bytes from SQL statement of this parsing context into the
@@ -41,11 +41,13 @@ Parser::~Parser() {
 
 CHECKED_STATUS Parser::Parse(const string& ql_stmt,
                              const bool reparsed,
-                             shared_ptr<MemTracker> mem_tracker) {
+                             shared_ptr<MemTracker> mem_tracker,
+                             ParseTree::UniPtr parse_tree) {
   parse_context_ = ParseContext::UniPtr(new ParseContext(ql_stmt.c_str(),
                                                          ql_stmt.length(),
                                                          reparsed,
-                                                         mem_tracker));
+                                                         std::move(mem_tracker),
+                                                         std::move(parse_tree)));
   lex_processor_.ScanInit(parse_context());
   gram_processor_.set_debug_level(parse_context_->trace_parsing());
 
@@ -43,9 +43,13 @@ class Parser {
   // Returns 0 if Bison successfully parses SQL statements, and the compiler can continue on to
   // semantic analysis. Otherwise, it returns one of the errcodes that are defined in file
   // "yb/yql/cql/ql/errcodes.h", and the caller (QL API) should stop the compiling process.
+  //
+  // When 'parse_tree' is given, it is reset and the statement is parsed into it instead of a new
+  // parse tree.
   CHECKED_STATUS Parse(const std::string& ql_stmt,
                        bool reparsed = false,
-                       std::shared_ptr<MemTracker> mem_tracker = nullptr);
+                       std::shared_ptr<MemTracker> mem_tracker = nullptr,
+                       ParseTree::UniPtr parse_tree = nullptr);
 
   // Returns the generated parse tree.
   ParseTree::UniPtr Done();
@@ -51,6 +51,17 @@ ParseTree::~ParseTree() {
   root_ = nullptr;
 }
 
+void ParseTree::Reset(const bool reparsed) {
+  // Delete the tree first as its nodes live in the memory pools being reset.
+  root_ = nullptr;
+  analyzed_tables_.clear();
+  analyzed_types_.clear();
+  psem_mem_.Reset();
+  ptree_mem_.Reset();
+  reparsed_ = reparsed;
+  stale_ = false;
+}
+
 CHECKED_STATUS ParseTree::Analyze(SemContext *sem_context) {
   if (root_ == nullptr) {
     LOG(INFO) << "Parse tree is NULL";
@@ -41,6 +41,16 @@ class ParseTree {
   explicit ParseTree(bool reparsed = false, std::shared_ptr<MemTracker> mem_tracker = nullptr);
   ~ParseTree();
 
+  // Release the tree and the results of its analysis so that the parse tree could be reused to
+  // parse another statement. The memory pools keep their last buffer, so parsing a statement of a
+  // similar size does not allocate from the heap again.
+  void Reset(bool reparsed = false);
+
+  // Whether the memory of this parse tree is tracked by a memory tracker.
+  bool tracks_memory() const {
+    return buffer_allocator_ != nullptr;
+  }
+
   // Run semantics analysis.
   CHECKED_STATUS Analyze(SemContext *sem_context);
 
@@ -19,14 +19,27 @@
 
 #include <functional>
 
+#include <gflags/gflags.h>
+
 #include "yb/client/client.h"
 
 #include "yb/yql/cql/ql/ptree/sem_context.h"
 
+#include "yb/util/flag_tags.h"
+
+DEFINE_bool(cql_read_from_covering_index, false,
+            "Whether to answer a select that references only the columns of a secondary index by "
+            "reading the index alone, without reading the indexed table.");
+TAG_FLAG(cql_read_from_covering_index, advanced);
+TAG_FLAG(cql_read_from_covering_index, runtime);
+
 namespace yb {
 namespace ql {
 
 using std::make_shared;
+using std::shared_ptr;
+using client::YBColumnSchema;
+using client::YBSchema;
 
 //--------------------------------------------------------------------------------------------------
 
@@ -82,7 +95,11 @@ PTSelectStmt::PTSelectStmt(MemoryContext *memctx,
       group_by_clause_(group_by_clause),
       having_clause_(having_clause),
       order_by_clause_(order_by_clause),
-      limit_clause_(limit_clause) {
+      limit_clause_(limit_clause),
+      index_columns_(memctx),
+      index_key_where_ops_(memctx),
+      index_where_ops_(memctx),
+      index_column_ids_(memctx) {
 }
 
 PTSelectStmt::~PTSelectStmt() {
@@ -190,6 +207,103 @@ CHECKED_STATUS PTSelectStmt::AnalyzeIndexes(SemContext *sem_context) {
     read_just_index_ = false;
   }
 
+  if (read_just_index_ && FLAGS_cql_read_from_covering_index) {
+    RETURN_NOT_OK(AnalyzeIndexRead(sem_context));
+  }
+
+  return Status::OK();
+}
+
+// Translate the where clause and the referenced columns to the columns of the covering index, so
+// that the select can be executed against the index instead of the indexed table. The index has
+// the same column names as the indexed table, but its own column ids and primary key. Selects
+// that cannot be translated keep reading from the indexed table.
+CHECKED_STATUS PTSelectStmt::AnalyzeIndexRead(SemContext *sem_context) {
+  // Token, subscripted column and function conditions, and orderings, refer to the indexed table.
+  if (distinct_ || order_by_clause_ != nullptr || !partition_key_ops_.empty() ||
+      !subscripted_col_where_ops_.empty() || !func_ops_.empty() || !static_column_refs_.empty()) {
+    return Status::OK();
+  }
+
+  const auto index_info = table_->index_map().find(index_id_);
+  if (index_info == table_->index_map().end()) {
+    return Status::OK();
+  }
+  const shared_ptr<client::YBTable> index_table = sem_context->GetTableDesc(index_id_);
+  if (index_table == nullptr) {
+    return Status::OK();
+  }
+
+  const YBSchema& schema = index_table->schema();
+  const int num_columns = schema.num_columns();
+  const int num_key_columns = schema.num_key_columns();
+  const int num_hash_key_columns = schema.num_hash_key_columns();
+  MCUnorderedMap<int32, const ColumnDesc*> index_descs(sem_context->PTempMem());
+  index_columns_.resize(num_columns);
+  for (int idx = 0; idx < num_columns; idx++) {
+    const YBColumnSchema col = schema.Column(idx);
+    index_columns_[idx].Init(idx,
+                             schema.ColumnId(idx),
+                             col.name(),
+                             idx < num_hash_key_columns,
+                             idx < num_key_columns,
+                             col.is_static(),
+                             col.is_counter(),
+                             col.type(),
+                             YBColumnSchema::ToInternalDataType(col.type()));
+    index_descs[schema.ColumnId(idx)] = &index_columns_[idx];
+  }
+
+  for (const IndexInfo::IndexColumn& column : index_info->second.columns()) {
+    index_column_ids_[column.indexed_column_id] = column.column_id;
+  }
+
+  // Conditions on the hash columns of the index become its key conditions, all others are
+  // conditions on the rows of the index.
+  index_key_where_ops_.resize(num_hash_key_columns);
+  bool translated = true;
+  const auto translate_op = [this, &index_descs, &translated](const ColumnOp& op) {
+    if (!op.IsInitialized()) {
+      return;
+    }
+    const auto id = index_column_ids_.find(op.desc()->id());
+    const auto desc = id != index_column_ids_.end() ? index_descs.find(id->second)
+                                                    : index_descs.end();
+    if (desc == index_descs.end()) {
+      translated = false;
+      return;
+    }
+    const ColumnDesc* index_desc = desc->second;
+    if (index_desc->is_hash() && (op.yb_op() == QL_OP_EQUAL || op.yb_op() == QL_OP_IN) &&
+        !index_key_where_ops_[index_desc->index()].IsInitialized()) {
+      index_key_where_ops_[index_desc->index()].Init(index_desc, op.expr(), op.yb_op());
+    } else {
+      index_where_ops_.emplace_back(index_desc, op.expr(), op.yb_op());
+    }
+  };
+  for (const ColumnOp& op : key_where_ops_) {
+    translate_op(op);
+  }
+  for (const ColumnOp& op : where_ops_) {
+    translate_op(op);
+  }
+  for (const ColumnOp& op : index_key_where_ops_) {
+    translated = translated && op.IsInitialized();
+  }
+  for (const int32 column_ref : column_refs_) {
+    translated = translated &&
+                 index_column_ids_.find(column_ref) != index_column_ids_.end();
+  }
+
+  if (!translated) {
+    index_columns_.clear();
+    index_key_where_ops_.clear();
+    index_where_ops_.clear();
+    index_column_ids_.clear();
+    return Status::OK();
+  }
+
+  index_table_ = index_table;
   return Status::OK();
 }
 
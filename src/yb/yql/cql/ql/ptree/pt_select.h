@@ -258,9 +258,34 @@ class PTSelectStmt : public PTDmlStmt {
     return index_id_;
   }
 
+  // Whether the rows are read from the covering index alone, without the indexed table.
+  bool read_from_index() const {
+    return index_table_ != nullptr;
+  }
+
+  // The table the rows are read from: the covering index when reading from it.
+  const std::shared_ptr<client::YBTable>& read_table() const {
+    return read_from_index() ? index_table_ : table_;
+  }
+
+  // The where clause of the read from the covering index, on the columns of the index.
+  const MCVector<ColumnOp>& index_key_where_ops() const {
+    return index_key_where_ops_;
+  }
+
+  const MCList<ColumnOp>& index_where_ops() const {
+    return index_where_ops_;
+  }
+
+  // Ids of the columns in the covering index by the ids of the columns in the indexed table.
+  const MCUnorderedMap<int32, int32>& index_column_ids() const {
+    return index_column_ids_;
+  }
+
  private:
 
   CHECKED_STATUS AnalyzeIndexes(SemContext *sem_context);
+  CHECKED_STATUS AnalyzeIndexRead(SemContext *sem_context);
   CHECKED_STATUS AnalyzeDistinctClause(SemContext *sem_context);
   CHECKED_STATUS AnalyzeOrderByClause(SemContext *sem_context);
   CHECKED_STATUS AnalyzeLimitClause(SemContext *sem_context);
@@ -287,6 +312,14 @@ class PTSelectStmt : public PTDmlStmt {
   bool use_index_ = false;
   bool read_just_index_ = false;
   TableId index_id_;
+
+  // The covering index to read from instead of the indexed table, and the where clause and column
+  // ids of the select translated to the columns of the index.
+  std::shared_ptr<client::YBTable> index_table_;
+  MCVector<ColumnDesc> index_columns_;
+  MCVector<ColumnOp> index_key_where_ops_;
+  MCList<ColumnOp> index_where_ops_;
+  MCUnorderedMap<int32, int32> index_column_ids_;
 };
 
 }  // namespace ql
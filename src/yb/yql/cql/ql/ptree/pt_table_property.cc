@@ -11,6 +11,7 @@
 // under the License.
 //
 
+#include <limits>
 #include <set>
 #include "yb/client/schema.h"
 #include "yb/yql/cql/ql/ptree/pt_table_property.h"
@@ -29,6 +30,7 @@ using client::YBColumnSchema;
 const std::map<std::string, PTTableProperty::KVProperty> PTTableProperty::kPropertyDataTypes
     = {
     {"bloom_filter_fp_chance", KVProperty::kBloomFilterFpChance},
+    {"bloom_filter_range_components", KVProperty::kBloomFilterRangeComponents},
     {"caching", KVProperty::kCaching},
     {"comment", KVProperty::kComment},
     {"compaction", KVProperty::kCompaction},
@@ -188,6 +190,7 @@ CHECKED_STATUS PTTableProperty::Analyze(SemContext *sem_context) {
                                   ErrorCode::INVALID_ARGUMENTS);
       }
       break;
+    case KVProperty::kBloomFilterRangeComponents: FALLTHROUGH_INTENDED;
     case KVProperty::kGcGraceSeconds: FALLTHROUGH_INTENDED;
     case KVProperty::kMemtableFlushPeriodInMs:
       RETURN_SEM_CONTEXT_ERROR_NOT_OK(GetIntValueFromExpr(rhs_, table_property_name, &int_val));
@@ -366,6 +369,17 @@ Status PTTableProperty::SetTableProperty(yb::TableProperties *table_property) co
       table_property->SetDefaultTimeToLive(val * MonoTime::kMillisecondsPerSecond);
       break;
     }
+    case KVProperty::kBloomFilterRangeComponents: {
+      // Values larger than the number of range columns are limited by the tablet.
+      int64_t val;
+      if (!GetIntValueFromExpr(rhs_, table_property_name, &val).ok() || val < 0) {
+        return STATUS(InvalidArgument,
+                      Substitute("Invalid value for bloom_filter_range_components"));
+      }
+      table_property->SetBloomFilterRangeComponents(
+          static_cast<uint32_t>(std::min<int64_t>(val, std::numeric_limits<uint32_t>::max())));
+      break;
+    }
     case KVProperty::kBloomFilterFpChance: FALLTHROUGH_INTENDED;
     case KVProperty::kComment: FALLTHROUGH_INTENDED;
     case KVProperty::kCrcCheckChance: FALLTHROUGH_INTENDED;
@@ -64,6 +64,38 @@ METRIC_DEFINE_histogram(
     server, handler_latency_yb_cqlserver_SQLProcessor_ResponseSize,
     "Size of the returned response blob (in bytes)", yb::MetricUnit::kBytes,
     "Size of the returned response blob (in bytes)", 60000000LU, 2);
+METRIC_DEFINE_counter(
+    server, cql_read_rows_scanned, "Rows scanned by CQL reads", yb::MetricUnit::kRows,
+    "Number of rows read by tablet servers to execute CQL reads");
+METRIC_DEFINE_counter(
+    server, cql_read_rows_returned, "Rows returned by CQL reads", yb::MetricUnit::kRows,
+    "Number of rows that matched the conditions of CQL reads on tablet servers");
+METRIC_DEFINE_counter(
+    server, cql_read_intents_processed, "Intents processed by CQL reads",
+    yb::MetricUnit::kEntries,
+    "Number of provisional records of transactions resolved by tablet servers to execute CQL "
+    "reads");
+METRIC_DEFINE_counter(
+    server, cql_read_internal_keys_skipped, "RocksDB keys skipped by CQL reads",
+    yb::MetricUnit::kEntries,
+    "Number of overwritten or deleted RocksDB entries skipped by tablet servers to execute CQL "
+    "reads");
+METRIC_DEFINE_counter(
+    server, cql_read_blocks_read, "SST blocks read by CQL reads", yb::MetricUnit::kBlocks,
+    "Number of SST blocks read from disk by tablet servers to execute CQL reads");
+METRIC_DEFINE_counter(
+    server, cql_read_block_cache_hits, "Block cache hits of CQL reads",
+    yb::MetricUnit::kCacheHits,
+    "Number of SST blocks found in block cache by tablet servers to execute CQL reads");
+METRIC_DEFINE_counter(
+    server, cql_read_bloom_filter_useful, "Useful bloom filter checks of CQL reads",
+    yb::MetricUnit::kProbes,
+    "Number of SST files skipped thanks to bloom filters by tablet servers to execute CQL reads");
+METRIC_DEFINE_histogram(
+    server, cql_read_safe_time_wait, "Safe time wait of CQL reads",
+    yb::MetricUnit::kMicroseconds,
+    "Time spent by tablet servers waiting for the safe time to execute CQL reads",
+    60000000LU, 2);
 
 namespace yb {
 namespace ql {
@@ -110,6 +142,27 @@ QLMetrics::QLMetrics(const scoped_refptr<yb::MetricEntity> &metric_entity) {
 
   ql_response_size_bytes_ =
       METRIC_handler_latency_yb_cqlserver_SQLProcessor_ResponseSize.Instantiate(metric_entity);
+
+  ql_read_rows_scanned_ = METRIC_cql_read_rows_scanned.Instantiate(metric_entity);
+  ql_read_rows_returned_ = METRIC_cql_read_rows_returned.Instantiate(metric_entity);
+  ql_read_intents_processed_ = METRIC_cql_read_intents_processed.Instantiate(metric_entity);
+  ql_read_internal_keys_skipped_ =
+      METRIC_cql_read_internal_keys_skipped.Instantiate(metric_entity);
+  ql_read_blocks_read_ = METRIC_cql_read_blocks_read.Instantiate(metric_entity);
+  ql_read_block_cache_hits_ = METRIC_cql_read_block_cache_hits.Instantiate(metric_entity);
+  ql_read_bloom_filter_useful_ = METRIC_cql_read_bloom_filter_useful.Instantiate(metric_entity);
+  ql_read_safe_time_wait_ = METRIC_cql_read_safe_time_wait.Instantiate(metric_entity);
+}
+
+void QLMetrics::RecordReadStats(const QLReadStatsPB& stats) const {
+  ql_read_rows_scanned_->IncrementBy(stats.rows_scanned());
+  ql_read_rows_returned_->IncrementBy(stats.rows_returned());
+  ql_read_intents_processed_->IncrementBy(stats.intents_processed());
+  ql_read_internal_keys_skipped_->IncrementBy(stats.internal_keys_skipped());
+  ql_read_blocks_read_->IncrementBy(stats.blocks_read());
+  ql_read_block_cache_hits_->IncrementBy(stats.block_cache_hits());
+  ql_read_bloom_filter_useful_->IncrementBy(stats.bloom_filter_useful());
+  ql_read_safe_time_wait_->Increment(stats.safe_time_wait_us());
 }
 
 QLProcessor::QLProcessor(std::weak_ptr<rpc::Messenger> messenger, shared_ptr<YBClient> client,
@@ -128,7 +181,8 @@ Status QLProcessor::Parse(const string& ql_stmt, ParseTree::UniPtr* parse_tree,
                            const bool reparsed, shared_ptr<MemTracker> mem_tracker) {
   // Parse the statement and get the generated parse tree.
   const MonoTime begin_time = MonoTime::Now();
-  RETURN_NOT_OK(parser_.Parse(ql_stmt, reparsed, mem_tracker));
+  RETURN_NOT_OK(parser_.Parse(ql_stmt, reparsed, mem_tracker,
+                              mem_tracker == nullptr ? std::move(free_parse_tree_) : nullptr));
   const MonoTime end_time = MonoTime::Now();
   if (ql_metrics_ != nullptr) {
     const MonoDelta elapsed_time = end_time.GetDeltaSince(begin_time);
@@ -179,9 +233,10 @@ void QLProcessor::RunAsync(const string& ql_stmt, const StatementParameters& par
     return cb.Run(s, nullptr /* result */);
   }
   const ParseTree* ptree = parse_tree.release();
+  // The executor always runs the callback, so RunAsyncDone takes over the parse tree from here.
   ExecuteAsync(ql_stmt, *ptree, params,
                Bind(&QLProcessor::RunAsyncDone, Unretained(this), ql_stmt, Unretained(&params),
-                    Owned(ptree), cb));
+                    Unretained(ptree), cb));
 }
 
 // RunAsync callback added to keep the parse tree in-scope while it is being run asynchronously.
@@ -189,7 +244,12 @@ void QLProcessor::RunAsync(const string& ql_stmt, const StatementParameters& par
 void QLProcessor::RunAsyncDone(const string& ql_stmt, const StatementParameters* params,
                                 const ParseTree *parse_tree, StatementExecutedCallback cb,
                                 const Status& s, const ExecutedResult::SharedPtr& result) {
-  if (s.IsQLError() && GetErrorCode(s) == ErrorCode::STALE_METADATA && !parse_tree->reparsed()) {
+  // The executor is done with the parse tree and the result does not refer to it, so the tree is
+  // released for the next statement before the callback, which may hand this processor over to
+  // another call.
+  const bool reparsed = parse_tree->reparsed();
+  ReleaseParseTree(ParseTree::UniPtr(const_cast<ParseTree*>(parse_tree)));
+  if (s.IsQLError() && GetErrorCode(s) == ErrorCode::STALE_METADATA && !reparsed) {
     return RunAsync(ql_stmt, *params, cb, true /* reparsed */);
   }
   cb.Run(s, result);
@@ -221,6 +281,12 @@ void QLProcessor::AbortBatch() {
   executor_.AbortBatch();
 }
 
+void QLProcessor::ReleaseParseTree(ParseTree::UniPtr parse_tree) {
+  if (parse_tree != nullptr && !parse_tree->tracks_memory()) {
+    free_parse_tree_ = std::move(parse_tree);
+  }
+}
+
 void QLProcessor::SetCurrentCall(rpc::InboundCallPtr call) {
   ql_env_.SetCurrentCall(std::move(call));
 }
@@ -37,6 +37,9 @@ class QLMetrics {
  public:
   explicit QLMetrics(const scoped_refptr<yb::MetricEntity>& metric_entity);
 
+  // Adds statistics of a read executed by a tablet server.
+  void RecordReadStats(const QLReadStatsPB& stats) const;
+
   scoped_refptr<yb::Histogram> time_to_parse_ql_query_;
   scoped_refptr<yb::Histogram> time_to_analyze_ql_query_;
   scoped_refptr<yb::Histogram> time_to_execute_ql_query_;
@@ -50,6 +53,15 @@ class QLMetrics {
   scoped_refptr<yb::Histogram> ql_transaction_;
 
   scoped_refptr<yb::Histogram> ql_response_size_bytes_;
+
+  scoped_refptr<yb::Counter> ql_read_rows_scanned_;
+  scoped_refptr<yb::Counter> ql_read_rows_returned_;
+  scoped_refptr<yb::Counter> ql_read_intents_processed_;
+  scoped_refptr<yb::Counter> ql_read_internal_keys_skipped_;
+  scoped_refptr<yb::Counter> ql_read_blocks_read_;
+  scoped_refptr<yb::Counter> ql_read_block_cache_hits_;
+  scoped_refptr<yb::Counter> ql_read_bloom_filter_useful_;
+  scoped_refptr<yb::Histogram> ql_read_safe_time_wait_;
 };
 
 class QLProcessor {
@@ -87,6 +99,10 @@ class QLProcessor {
   void ApplyBatch();
   void AbortBatch();
 
+  // Return a parse tree that is no longer used, so that its memory is reused to parse the next
+  // statement without a memory tracker. Parse trees with tracked memory are just deleted.
+  void ReleaseParseTree(ParseTree::UniPtr parse_tree);
+
  protected:
   void SetCurrentCall(rpc::InboundCallPtr call);
   //------------------------------------------------------------------------------------------------
@@ -105,6 +121,9 @@ class QLProcessor {
   // SQL metrics.
   QLMetrics* const ql_metrics_;
 
+  // Parse tree released by the last statement, to be reused by the next one.
+  ParseTree::UniPtr free_parse_tree_;
+
  private:
   friend class QLTestBase;
 
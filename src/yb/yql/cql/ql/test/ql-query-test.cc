@@ -1244,6 +1244,52 @@ TEST_F(TestQLQuery, TestPagination) {
   EXPECT_EQ(55, sum);
 }
 
+TEST_F(TestQLQuery, TestParallelScanPaging) {
+  // Init the simulated cluster.
+  ASSERT_NO_FATALS(CreateSimulatedCluster());
+
+  // Get a processor.
+  TestQLProcessor *processor = GetQLProcessor();
+  CHECK_OK(processor->Run("CREATE TABLE scan_test (h int, r int, v int, PRIMARY KEY ((h), r));"));
+  for (int i = 0; i < 100; i++) {
+    CHECK_OK(processor->Run(Substitute("INSERT INTO scan_test (h, r, v) VALUES ($0, $1, $2);",
+                                       i, i % 4, i * 3)));
+  }
+
+  // Read all pages of the scan with the given parallel scan degree.
+  auto scan = [processor](int page_size, uint32_t degree) {
+    StatementParameters params;
+    params.set_page_size(page_size);
+    params.set_parallel_scan_degree(degree);
+    string rows;
+    int row_count = 0;
+    while (true) {
+      CHECK_OK(processor->Run("SELECT * FROM scan_test;", params));
+      std::shared_ptr<QLRowBlock> row_block = processor->row_block();
+      CHECK_LE(row_block->row_count(), page_size);
+      row_count += row_block->row_count();
+      for (const auto& row : row_block->rows()) {
+        rows.append(row.ToString());
+      }
+      if (processor->rows_result()->paging_state().empty()) {
+        break;
+      }
+      CHECK_OK(params.set_paging_state(processor->rows_result()->paging_state()));
+    }
+    CHECK_EQ(100, row_count);
+    return rows;
+  };
+
+  // Rows and their order must not depend on how many ranges are read in parallel.
+  const string expected_rows = scan(1000, 1);
+  for (uint32_t degree : {1, 2, 3, 8}) {
+    for (int page_size : {1, 7, 30, 1000}) {
+      EXPECT_EQ(expected_rows, scan(page_size, degree))
+          << "degree: " << degree << ", page size: " << page_size;
+    }
+  }
+}
+
 TEST_F(TestQLQuery, TestTokenBcall) {
   //------------------------------------------------------------------------------------------------
   // Setting up cluster
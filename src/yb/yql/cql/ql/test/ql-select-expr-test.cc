@@ -7,6 +7,9 @@
 
 #include "yb/yql/cql/ql/test/ql-test-base.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/util/decimal.h"
+
+DECLARE_int32(cql_aggregate_fanout_ranges);
 
 using std::string;
 using std::unique_ptr;
@@ -304,6 +307,77 @@ TEST_F(QLTestSelectedExpr, TestAggregateExpr) {
   }
 }
 
+TEST_F(QLTestSelectedExpr, TestAggregateFanout) {
+  // Init the simulated cluster.
+  ASSERT_NO_FATALS(CreateSimulatedCluster());
+
+  // Get a processor.
+  TestQLProcessor *processor = GetQLProcessor();
+  CHECK_VALID_STMT("CREATE TABLE test_aggr_fanout(h int, r int, v bigint, primary key(h, r));");
+
+  int64_t v_total = 0;
+  for (int i = 0; i < 200; i++) {
+    CHECK_VALID_STMT(Substitute("INSERT INTO test_aggr_fanout(h, r, v) VALUES($0, $1, $2);",
+                                i, i % 3, i * 7));
+    v_total += i * 7;
+  }
+
+  // Scan one tablet after another, with ranges not aligned to tablet boundaries, and with more
+  // ranges than hash codes left by a token condition.
+  int64_t token_count = -1;
+  for (int ranges : {1, 7, 32, 1000}) {
+    FLAGS_cql_aggregate_fanout_ranges = ranges;
+    CHECK_VALID_STMT("SELECT count(*), sum(v), min(v), max(v) FROM test_aggr_fanout;");
+    std::shared_ptr<QLRowBlock> row_block = processor->row_block();
+    ASSERT_EQ(row_block->row_count(), 1) << ranges;
+    const QLRow& row = row_block->row(0);
+    ASSERT_EQ(row.column(0).int64_value(), 200) << ranges;
+    ASSERT_EQ(row.column(1).int64_value(), v_total) << ranges;
+    ASSERT_EQ(row.column(2).int64_value(), 0) << ranges;
+    ASSERT_EQ(row.column(3).int64_value(), 199 * 7) << ranges;
+
+    CHECK_VALID_STMT("SELECT count(*) FROM test_aggr_fanout "
+                     "  WHERE token(h) >= 0 AND token(h) <= 100;");
+    row_block = processor->row_block();
+    ASSERT_EQ(row_block->row_count(), 1) << ranges;
+    if (token_count < 0) {
+      token_count = row_block->row(0).column(0).int64_value();
+    }
+    ASSERT_EQ(row_block->row(0).column(0).int64_value(), token_count) << ranges;
+  }
+}
+
+TEST_F(QLTestSelectedExpr, TestSumVarIntDecimal) {
+  // Init the simulated cluster.
+  ASSERT_NO_FATALS(CreateSimulatedCluster());
+
+  // Get a processor.
+  TestQLProcessor *processor = GetQLProcessor();
+  CHECK_VALID_STMT("CREATE TABLE test_aggr_sum(h int, r int, v varint, d decimal,"
+                   "                           primary key(h, r));");
+
+  // The sums cross the int64 range, so both the int64 and the generic arithmetic are used.
+  util::VarInt v_total(0);
+  util::Decimal d_total("0");
+  for (int i = 0; i < 20; i++) {
+    const string v =
+        Substitute("$0$1", i % 5 == 4 ? "-" : "", 922337203685477580LL * (i % 10 + 1));
+    const string d = Substitute("$0.$1e$2", i * 37, i, i % 3 ? 17 : -3);
+    CHECK_VALID_STMT(Substitute("INSERT INTO test_aggr_sum(h, r, v, d) VALUES($0, $1, $2, $3);",
+                                i, i % 3, v, d));
+    v_total = v_total + util::VarInt(v);
+    d_total = d_total + util::Decimal(d);
+  }
+
+  CHECK_VALID_STMT("SELECT sum(v), sum(d) FROM test_aggr_sum;");
+  std::shared_ptr<QLRowBlock> row_block = processor->row_block();
+  ASSERT_EQ(row_block->row_count(), 1);
+  const QLRow& row = row_block->row(0);
+  ASSERT_EQ(v_total.ToString(), row.column(0).varint_value().ToString());
+  ASSERT_EQ(d_total.ToString(),
+            util::DecimalFromComparable(row.column(1).decimal_value()).ToString());
+}
+
 TEST_F(QLTestSelectedExpr, TestQLSelectNumericExpr) {
   // Init the simulated cluster.
   ASSERT_NO_FATALS(CreateSimulatedCluster());
@@ -15,6 +15,8 @@
 #include "yb/yql/cql/ql/test/ql-test-base.h"
 #include "yb/util/varint.h"
 
+DECLARE_bool(cql_read_from_covering_index);
+
 namespace yb {
 namespace ql {
 
@@ -370,6 +372,50 @@ TEST_F(QLTestAnalyzer, TestSelectLocalIndex) {
 
 }
 
+TEST_F(QLTestAnalyzer, TestSelectCoveringIndexRead) {
+  FLAGS_cql_read_from_covering_index = true;
+  CreateSimulatedCluster();
+  TestQLProcessor *processor = GetQLProcessor();
+  EXPECT_OK(processor->Run("CREATE TABLE t (h1 int, h2 int, r1 int, c1 int, c2 int, c3 int, "
+                              "PRIMARY KEY ((h1, h2), r1)) "
+                              "with transactions = {'enabled':true};"));
+  EXPECT_OK(processor->Run("CREATE INDEX i ON t (c1, r1) COVERING (c2);"));
+
+  client::YBTableName table_name(kDefaultKeyspaceName, "t");
+  processor->RemoveCachedTableDesc(table_name);
+
+  ParseTree::UniPtr select_parse_tree;
+  EXPECT_OK(TestAnalyzer("SELECT h1, c2 FROM t WHERE c1 = 1 AND c2 > 2", &select_parse_tree));
+  EXPECT_OK(AnalyzeSelectTree(select_parse_tree, true, true));
+  auto select = std::static_pointer_cast<PTSelectStmt>(select_parse_tree->root());
+  ASSERT_TRUE(select->read_from_index());
+  EXPECT_EQ(select->index_id(), select->read_table()->id());
+
+  // The condition on the hash column of the index is its key condition, the other one a condition
+  // on the columns of the index.
+  ASSERT_EQ(1, select->index_key_where_ops().size());
+  const ColumnOp& key_op = select->index_key_where_ops().front();
+  EXPECT_EQ("c1", key_op.desc()->name());
+  EXPECT_TRUE(key_op.desc()->is_hash());
+  EXPECT_EQ(select->read_table()->schema().ColumnId(0), key_op.desc()->id());
+  ASSERT_EQ(1, select->index_where_ops().size());
+  EXPECT_EQ("c2", select->index_where_ops().front().desc()->name());
+  for (const int32 column_ref : select->column_refs()) {
+    EXPECT_EQ(1, select->index_column_ids().count(column_ref));
+  }
+
+  // Reads of columns not in the index go to the indexed table.
+  EXPECT_OK(TestAnalyzer("SELECT c3 FROM t WHERE c1 = 1", &select_parse_tree));
+  select = std::static_pointer_cast<PTSelectStmt>(select_parse_tree->root());
+  EXPECT_FALSE(select->read_from_index());
+  EXPECT_EQ(select->table()->id(), select->read_table()->id());
+
+  FLAGS_cql_read_from_covering_index = false;
+  EXPECT_OK(TestAnalyzer("SELECT h1, c2 FROM t WHERE c1 = 1", &select_parse_tree));
+  select = std::static_pointer_cast<PTSelectStmt>(select_parse_tree->root());
+  EXPECT_FALSE(select->read_from_index());
+}
+
 TEST_F(QLTestAnalyzer, TestTruncate) {
   CreateSimulatedCluster();
   TestQLProcessor *processor = GetQLProcessor();
@@ -408,5 +454,38 @@ TEST_F(QLTestAnalyzer, TestMisc) {
   ANALYZE_INVALID_STMT("SELECT * FROM t; SELECT C FROM t;", &parse_tree);
 }
 
+// Measures the parse + analyze throughput of typical DML statements, with and without reusing
+// the memory of the released parse tree for the next statement.
+TEST_F(QLTestAnalyzer, ParseAnalyzeBenchmark) {
+  CreateSimulatedCluster();
+  TestQLProcessor *processor = GetQLProcessor();
+  CHECK_OK(processor->Run("CREATE TABLE t (h1 INT, h2 TEXT, r1 INT, r2 TEXT, c1 INT, c2 TEXT, "
+                          "PRIMARY KEY ((h1, h2), r1, r2));"));
+
+  const std::vector<string> stmts = {
+      "INSERT INTO t (h1, h2, r1, r2, c1, c2) VALUES (1, 'a', 2, 'b', 3, 'c');",
+      "SELECT c1, c2 FROM t WHERE h1 = 1 AND h2 = 'a' AND r1 = 2 AND r2 = 'b';",
+      "SELECT * FROM t WHERE h1 = 1 AND h2 = 'a' AND r1 > 2 LIMIT 10;",
+      "UPDATE t SET c1 = 4, c2 = 'd' WHERE h1 = 1 AND h2 = 'a' AND r1 = 2 AND r2 = 'b';"
+  };
+  constexpr int kIterations = 10000;
+
+  for (const bool reuse : {false, true}) {
+    MonoTime start = MonoTime::Now();
+    for (int i = 0; i < kIterations; ++i) {
+      for (const auto& stmt : stmts) {
+        ParseTree::UniPtr parse_tree;
+        ASSERT_OK(TestAnalyzer(stmt, &parse_tree));
+        if (reuse) {
+          processor->ReleaseParseTree(std::move(parse_tree));
+        }
+      }
+    }
+    const MonoDelta elapsed = MonoTime::Now().GetDeltaSince(start);
+    LOG(INFO) << (reuse ? "Reused" : "New") << " parse trees: "
+              << kIterations * stmts.size() / elapsed.ToSeconds() << " statements/s";
+  }
+}
+
 }  // namespace ql
 }  // namespace yb
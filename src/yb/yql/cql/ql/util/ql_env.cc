@@ -116,6 +116,12 @@ void QLEnv::StartTransaction(const IsolationLevel isolation_level) {
   session_->SetTransaction(transaction_);
 }
 
+void QLEnv::MarkLastTransactionBatch() {
+  if (transaction_) {
+    transaction_->MarkLastBatch();
+  }
+}
+
 void QLEnv::CommitTransaction(CommitCallback callback) {
   if (!transaction_) {
     LOG(DFATAL) << "No transaction to commit";
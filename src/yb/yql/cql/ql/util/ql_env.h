@@ -82,6 +82,10 @@ class QLEnv {
   // Start a distributed transaction.
   void StartTransaction(IsolationLevel isolation_level);
 
+  // Notifies the current distributed transaction, if any, that the next flush is the last one
+  // before commit.
+  void MarkLastTransactionBatch();
+
   // Commit the current distributed transaction.
   void CommitTransaction(client::CommitCallback callback);
 
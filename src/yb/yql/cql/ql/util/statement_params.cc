@@ -31,7 +31,8 @@ StatementParameters::StatementParameters(const StatementParameters& other)
   : page_size_(other.page_size_),
     paging_state_(
       other.paging_state_ != nullptr ? new QLPagingStatePB(*other.paging_state_) : nullptr),
-    yb_consistency_level_(YBConsistencyLevel::STRONG) {
+    yb_consistency_level_(YBConsistencyLevel::STRONG),
+    parallel_scan_degree_(other.parallel_scan_degree_) {
 }
 
 StatementParameters::~StatementParameters() {
@@ -77,6 +77,10 @@ class StatementParameters {
     return yb_consistency_level_;
   }
 
+  // Accessor functions for parallel_scan_degree. Zero means the cql_parallel_scan_degree default.
+  uint32_t parallel_scan_degree() const { return parallel_scan_degree_; }
+  void set_parallel_scan_degree(const uint32_t degree) { parallel_scan_degree_ = degree; }
+
  protected:
   void set_yb_consistency_level(const YBConsistencyLevel yb_consistency_level) {
     yb_consistency_level_ = yb_consistency_level;
@@ -95,6 +99,9 @@ class StatementParameters {
 
   // Consistency level for YB.
   YBConsistencyLevel yb_consistency_level_;
+
+  // Number of hash-code ranges a table scan reads in parallel after crossing a tablet boundary.
+  uint32_t parallel_scan_degree_ = 0;
 };
 
 } // namespace ql
@@ -174,7 +174,7 @@ RowsResult::RowsResult(const client::YBTableName& table_name,
     : table_name_(table_name),
       column_schemas_(column_schemas),
       client_(QLClient::YQL_CLIENT_CQL),
-      rows_data_(rows_data) {
+      rows_data_(rows_data.data(), rows_data.size()) {
 }
 
 RowsResult::~RowsResult() {
@@ -133,8 +133,10 @@ class RowsResult : public ExecutedResult {
   // Accessor functions.
   const client::YBTableName& table_name() const { return table_name_; }
   const std::vector<ColumnSchema>& column_schemas() const { return *column_schemas_; }
-  const std::string& rows_data() const { return rows_data_; }
-  void set_rows_data(const char *str, size_t size) { rows_data_.assign(str, size); }
+  // Rows in the CQL wire format. The buffer is shared with the operation the result was built from
+  // and with CQL responses, so it is never modified in place.
+  const RefCntBuffer& rows_data() const { return rows_data_; }
+  void set_rows_data(const char *str, size_t size) { rows_data_ = RefCntBuffer(str, size); }
   const std::string& paging_state() const { return paging_state_; }
   QLClient client() const { return client_; }
 
@@ -152,7 +154,7 @@ class RowsResult : public ExecutedResult {
   const client::YBTableName table_name_;
   std::shared_ptr<std::vector<ColumnSchema>> column_schemas_;
   const QLClient client_;
-  std::string rows_data_;
+  RefCntBuffer rows_data_;
   std::string paging_state_;
 };
 
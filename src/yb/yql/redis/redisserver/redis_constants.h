@@ -26,6 +26,12 @@ static constexpr const char* const kNX = "NX";
 static constexpr const char* const kXX = "XX";
 static constexpr const char* const kINCR = "INCR";
 static constexpr const char* const kCH = "CH";
+static constexpr const char* const kCount = "COUNT";
+// HSCAN and SSCAN start from and end with this cursor. Other cursors are kScanCursorPrefix followed
+// by the hex encoded continuation key of the scan.
+static constexpr const char* const kScanStartCursor = "0";
+static constexpr char kScanCursorPrefix = 'c';
+static constexpr int64_t kDefaultScanCount = 10;
 static constexpr int64_t kRedisMaxTtlSeconds = std::numeric_limits<int64_t>::max() /
     yb::MonoTime::kNanosecondsPerSecond;
 // Note that this deviates from vanilla Redis, since vanilla Redis allows negative TTLs. We
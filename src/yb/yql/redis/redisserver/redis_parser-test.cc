@@ -0,0 +1,174 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <string>
+#include <vector>
+
+#include "yb/gutil/strings/substitute.h"
+
+#include "yb/client/meta_cache.h"
+
+#include "yb/yql/redis/redisserver/redis_parser.h"
+
+#include "yb/util/random.h"
+#include "yb/util/random_util.h"
+#include "yb/util/stopwatch.h"
+#include "yb/util/test_util.h"
+
+using std::string;
+using std::vector;
+using strings::Substitute;
+
+namespace yb {
+namespace redisserver {
+
+class RedisParserTest : public YBTest {
+ protected:
+  // Parses all commands from source, returns arguments of parsed commands.
+  Result<vector<vector<string>>> ParseAll(const string& source) {
+    vector<vector<string>> result;
+    RedisParser parser(Slice(source.data(), source.size()));
+    RedisClientCommand args;
+    parser.SetArgs(&args);
+    for (;;) {
+      const uint8_t* end_of_command = nullptr;
+      RETURN_NOT_OK(parser.NextCommand(&end_of_command));
+      if (end_of_command == nullptr) {
+        break;
+      }
+      result.emplace_back();
+      for (const auto& arg : args) {
+        result.back().push_back(arg.ToBuffer());
+      }
+    }
+    return result;
+  }
+
+  static string BulkCommand(const vector<string>& args) {
+    string result = Substitute("*$0\r\n", args.size());
+    for (const auto& arg : args) {
+      result += Substitute("$$$0\r\n", arg.size());
+      result += arg;
+      result += "\r\n";
+    }
+    return result;
+  }
+};
+
+TEST_F(RedisParserTest, Bulk) {
+  vector<string> command = { "SET", "key", string(100, 'v') };
+  auto parsed = ParseAll(BulkCommand(command) + BulkCommand({ "GET", "key" }));
+  ASSERT_OK(parsed);
+  ASSERT_EQ(2, parsed->size());
+  ASSERT_EQ(command, (*parsed)[0]);
+  ASSERT_EQ((vector<string>{ "GET", "key" }), (*parsed)[1]);
+}
+
+TEST_F(RedisParserTest, Inline) {
+  auto parsed = ParseAll("SET key value\r\nGET key\r\n");
+  ASSERT_OK(parsed);
+  ASSERT_EQ(2, parsed->size());
+  ASSERT_EQ((vector<string>{ "SET", "key", "value" }), (*parsed)[0]);
+  ASSERT_EQ((vector<string>{ "GET", "key" }), (*parsed)[1]);
+}
+
+TEST_F(RedisParserTest, Incremental) {
+  // Long inline command checks that end of line is found after the short line scan.
+  const string inline_command = "SET key " + string(100, 'x') + "\r\n";
+  const string source = BulkCommand({ "HMSET", "hash", "f1", "v1", "f2", string(20, 'v') }) +
+                        inline_command;
+  RedisParser parser(Slice(source.data(), static_cast<size_t>(0)));
+  RedisClientCommand args;
+  parser.SetArgs(&args);
+  vector<size_t> command_ends;
+  for (size_t i = 1; i <= source.size(); ++i) {
+    parser.Update(Slice(source.data(), i));
+    const uint8_t* end_of_command = nullptr;
+    ASSERT_OK(parser.NextCommand(&end_of_command));
+    if (end_of_command != nullptr) {
+      command_ends.push_back(end_of_command - pointer_cast<const uint8_t*>(source.data()));
+    }
+  }
+  ASSERT_EQ((vector<size_t>{ source.size() - inline_command.size(), source.size() }),
+            command_ends);
+  ASSERT_EQ(3, args.size());
+  ASSERT_EQ(string(100, 'x'), args[2].ToBuffer());
+}
+
+TEST_F(RedisParserTest, Numbers) {
+  // Numbers with sign are handled by generic parsing routine.
+  ASSERT_OK(ParseAll("*+1\r\n$+3\r\nGET\r\n"));
+  ASSERT_OK(ParseAll("*1\r\n$0003\r\nGET\r\n"));
+  ASSERT_NOK(ParseAll("*1\r\n$-1\r\n"));
+  ASSERT_NOK(ParseAll("*0\r\n"));
+  ASSERT_NOK(ParseAll("*1\r\n$3a\r\nGET\r\n"));
+  ASSERT_NOK(ParseAll("*1\r\n$\r\nGET\r\n"));
+  ASSERT_NOK(ParseAll("*1\r\n$ 3\r\nGET\r\n"));
+  ASSERT_NOK(ParseAll("*1\r\n$9223372036854775808\r\nGET\r\n"));
+  ASSERT_NOK(ParseAll("*1\r\n$1000000000000000000\r\nGET\r\n"));
+  ASSERT_NOK(ParseAll("*1\r\n$3\nGET\r\n"));
+}
+
+// Measures parser throughput on pipelined MSET and HMSET commands, that are typical for bulk
+// loads.
+TEST_F(RedisParserTest, BenchmarkParse) {
+  constexpr int kCommands = 1000;
+  constexpr int kPairsPerCommand = 10;
+  const int num_runs = AllowSlowTests() ? 1000 : 50;
+
+  Random rng(SeedRandom());
+  string source;
+  for (int i = 0; i != kCommands; ++i) {
+    vector<string> command;
+    if (i % 2 == 0) {
+      command.push_back("MSET");
+    } else {
+      command.push_back("HMSET");
+      command.push_back(Substitute("hash_$0", i));
+    }
+    for (int j = 0; j != kPairsPerCommand; ++j) {
+      command.push_back(Substitute("key_$0_$1", i, j));
+      command.push_back(RandomHumanReadableString(1 + rng.Uniform(200), &rng));
+    }
+    source += BulkCommand(command);
+  }
+
+  RedisClientCommand args;
+  Stopwatch sw;
+  sw.start();
+  for (int run = 0; run != num_runs; ++run) {
+    RedisParser parser(Slice(source.data(), source.size()));
+    parser.SetArgs(&args);
+    int parsed = 0;
+    for (;;) {
+      const uint8_t* end_of_command = nullptr;
+      ASSERT_OK(parser.NextCommand(&end_of_command));
+      if (end_of_command == nullptr) {
+        break;
+      }
+      ++parsed;
+    }
+    ASSERT_EQ(kCommands, parsed);
+  }
+  sw.stop();
+  auto elapsed = sw.elapsed();
+  const uint64_t total_commands = static_cast<uint64_t>(num_runs) * kCommands;
+  LOG(INFO) << Substitute("Parsed $0 commands ($1 bytes) in $2 seconds: $3 commands per second, "
+                          "$4 MB per second",
+                          total_commands, num_runs * source.size(), elapsed.wall_seconds(),
+                          total_commands / elapsed.wall_seconds(),
+                          num_runs * source.size() / elapsed.wall_seconds() / 1_MB);
+}
+
+}  // namespace redisserver
+}  // namespace yb
@@ -11,6 +11,7 @@
 // under the License.
 //
 
+#include <algorithm>
 #include <memory>
 #include <string>
 
@@ -23,6 +24,7 @@
 
 #include "yb/common/redis_protocol.pb.h"
 
+#include "yb/gutil/strings/escaping.h"
 #include "yb/gutil/strings/substitute.h"
 
 #include "yb/yql/redis/redisserver/redis_constants.h"
@@ -139,13 +141,20 @@ CHECKED_STATUS ParseSet(YBRedisWriteOp *op, const RedisClientCommand& args) {
   return Status::OK();
 }
 
-// TODO: support MSET
+// MSET is split by the service into single key operations, so args are: MSET <KEY> <VALUE>.
 CHECKED_STATUS ParseMSet(YBRedisWriteOp *op, const RedisClientCommand& args) {
-  if (args.size() < 3 || args.size() % 2 == 0) {
+  DCHECK_EQ(3, args.size());
+  const auto& key = args[1];
+  const auto& value = args[2];
+  if (key.empty()) {
     return STATUS_SUBSTITUTE(InvalidCommand,
-        "An MSET request must have at least 3, odd number of arguments, found $0", args.size());
+        "An MSET request must have non empty key fields");
   }
-  return STATUS(InvalidCommand, "MSET command not yet supported");
+  op->mutable_request()->set_allocated_set_request(new RedisSetRequestPB());
+  op->mutable_request()->mutable_key_value()->set_key(key.cdata(), key.size());
+  op->mutable_request()->mutable_key_value()->add_value(value.cdata(), value.size());
+  op->mutable_request()->mutable_key_value()->set_type(REDIS_TYPE_STRING);
+  return Status::OK();
 }
 
 CHECKED_STATUS ParseHSet(YBRedisWriteOp *op, const RedisClientCommand& args) {
@@ -456,9 +465,14 @@ CHECKED_STATUS ParseHGetLikeCommands(YBRedisReadOp* op, const RedisClientCommand
   return ParseCollection(op, args, boost::none, add_string_subkey, remove_duplicates);
 }
 
-// TODO: Support MGET
+// MGET is split by the service into single key operations, so args are: MGET <KEY>.
 CHECKED_STATUS ParseMGet(YBRedisReadOp* op, const RedisClientCommand& args) {
-  return STATUS(InvalidCommand, "MGET command not yet supported");
+  DCHECK_EQ(2, args.size());
+  if (args[1].empty()) {
+    return STATUS_SUBSTITUTE(InvalidCommand,
+        "An MGET request must have non empty key fields");
+  }
+  return ParseGet(op, args);
 }
 
 CHECKED_STATUS ParseHGet(YBRedisReadOp* op, const RedisClientCommand& args) {
@@ -663,6 +677,49 @@ CHECKED_STATUS ParseHLen(YBRedisReadOp* op, const RedisClientCommand& args) {
   return ParseHGetLikeCommands(op, args, RedisGetRequestPB_GetRequestType_HLEN);
 }
 
+// HSCAN and SSCAN are served by paged HGETALL and SMEMBERS reads: args are <KEY> <CURSOR>
+// [COUNT <COUNT>]. MATCH is not supported.
+CHECKED_STATUS ParseScanLikeCommands(YBRedisReadOp* op, const RedisClientCommand& args,
+                                     RedisGetRequestPB_GetRequestType request_type) {
+  op->mutable_request()->set_allocated_get_request(new RedisGetRequestPB());
+  op->mutable_request()->mutable_get_request()->set_request_type(request_type);
+  const auto& key = args[1];
+  op->mutable_request()->mutable_key_value()->set_key(key.cdata(), key.size());
+
+  const auto& cursor = args[2];
+  if (cursor != kScanStartCursor) {
+    if (cursor.empty() || cursor[0] != kScanCursorPrefix || (cursor.size() - 1) % 2 != 0 ||
+        !std::all_of(cursor.cdata() + 1, cursor.cdata() + cursor.size(), ascii_isxdigit)) {
+      return STATUS_SUBSTITUTE(InvalidArgument, "Invalid cursor $0", cursor.ToDebugString());
+    }
+    string continuation_key;
+    a2b_hex(cursor.cdata() + 1, &continuation_key, (cursor.size() - 1) / 2);
+    op->mutable_request()->set_continuation_key(continuation_key);
+  }
+
+  int64_t count = kDefaultScanCount;
+  for (size_t i = 3; i < args.size(); i += 2) {
+    if (!boost::iequals(args[i].ToBuffer(), kCount) || i + 1 == args.size()) {
+      return STATUS_SUBSTITUTE(InvalidArgument, "Unsupported scan argument $0",
+                               args[i].ToDebugString());
+    }
+    count = VERIFY_RESULT(ParseInt64(args[i + 1], "Count"));
+    if (count <= 0) {
+      return STATUS(InvalidArgument, "Count should be positive");
+    }
+  }
+  op->mutable_request()->set_max_entries(count);
+  return Status::OK();
+}
+
+CHECKED_STATUS ParseHScan(YBRedisReadOp* op, const RedisClientCommand& args) {
+  return ParseScanLikeCommands(op, args, RedisGetRequestPB_GetRequestType_HGETALL);
+}
+
+CHECKED_STATUS ParseSScan(YBRedisReadOp* op, const RedisClientCommand& args) {
+  return ParseScanLikeCommands(op, args, RedisGetRequestPB_GetRequestType_SMEMBERS);
+}
+
 CHECKED_STATUS ParseSMembers(YBRedisReadOp* op, const RedisClientCommand& args) {
   return ParseHGetLikeCommands(op, args, RedisGetRequestPB_GetRequestType_SMEMBERS);
 }
@@ -854,8 +911,51 @@ CHECKED_STATUS RedisParser::BulkArgumentBody() {
   return Status::OK();
 }
 
+namespace {
+
+// Most of lines that parser looks for are bulk headers and argument sizes, i.e. short decimal
+// numbers. So we check first bytes inline and only then fall back to memchr, that is already
+// vectorized by libc and efficient for long inline commands.
+constexpr ptrdiff_t kShortLineLength = 16;
+
+const uint8_t* FindNewLine(const uint8_t* begin, const uint8_t* end) {
+  auto short_end = end - begin > kShortLineLength ? begin + kShortLineLength : end;
+  for (auto p = begin; p != short_end; ++p) {
+    if (*p == '\n') {
+      return p;
+    }
+  }
+  if (short_end == end) {
+    return nullptr;
+  }
+  return static_cast<const uint8_t*>(memchr(short_end, '\n', end - short_end));
+}
+
+// Max number of decimal digits that could not overflow int64_t.
+constexpr ptrdiff_t kMaxSafeDecimalDigits = 18;
+
+// Parses number that consists of decimal digits only, without CheckedStoll overhead.
+// Returns false if input has other form, so it should be parsed by generic routine.
+bool ParseDecimalDigits(const uint8_t* begin, const uint8_t* end, int64_t* out) {
+  if (begin == end || end - begin > kMaxSafeDecimalDigits) {
+    return false;
+  }
+  int64_t result = 0;
+  for (auto p = begin; p != end; ++p) {
+    unsigned digit = *p - '0';
+    if (digit > 9) {
+      return false;
+    }
+    result = result * 10 + digit;
+  }
+  *out = result;
+  return true;
+}
+
+} // namespace
+
 CHECKED_STATUS RedisParser::FindEndOfLine() {
-  auto new_line = static_cast<const uint8_t *>(memchr(pos_, '\n', end_ - pos_));
+  auto new_line = FindNewLine(pos_, end_);
   incomplete_ = new_line == nullptr;
   if (!incomplete_) {
     if (new_line == token_begin_) {
@@ -885,16 +985,20 @@ CHECKED_STATUS RedisParser::ParseNumber(char prefix,
   }
   auto number_begin = token_begin_ + 1;
   auto expected_stop = pos_ - kLineEndLength;
-  auto parsed_number = util::CheckedStoll(Slice(number_begin, expected_stop));
-  RETURN_NOT_OK(parsed_number);
-  static_assert(sizeof(*parsed_number) == sizeof(*out), "Expected size");
-  SCHECK_BOUNDS(*parsed_number,
+  int64_t parsed_number;
+  if (!ParseDecimalDigits(number_begin, expected_stop, &parsed_number)) {
+    auto result = util::CheckedStoll(Slice(number_begin, expected_stop));
+    RETURN_NOT_OK(result);
+    parsed_number = *result;
+  }
+  static_assert(sizeof(parsed_number) == sizeof(*out), "Expected size");
+  SCHECK_BOUNDS(parsed_number,
                 min,
                 max,
                 Corruption,
                 yb::Format("$0 out of expected range [$1, $2] : $3",
-                           name, min, max, *parsed_number));
-  *out = static_cast<ptrdiff_t>(*parsed_number);
+                           name, min, max, parsed_number));
+  *out = static_cast<ptrdiff_t>(parsed_number);
   return Status::OK();
 }
 
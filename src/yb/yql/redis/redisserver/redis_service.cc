@@ -14,6 +14,8 @@
 #include "yb/yql/redis/redisserver/redis_service.h"
 
 #include <thread>
+#include <unordered_map>
+#include <unordered_set>
 
 #include <boost/algorithm/string/case_conv.hpp>
 
@@ -25,6 +27,8 @@
 
 #include <gflags/gflags.h>
 
+#include "yb/gutil/casts.h"
+#include "yb/gutil/strings/escaping.h"
 #include "yb/gutil/strings/join.h"
 #include "yb/gutil/strings/substitute.h"
 
@@ -47,6 +51,7 @@
 #include "yb/tserver/tablet_server.h"
 
 #include "yb/util/bytes_formatter.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
 #include "yb/util/memory/mc_types.h"
 #include "yb/util/size_literals.h"
@@ -110,10 +115,15 @@ DEFINE_int32(redis_max_value_size, 64_MB,
              "Maximum size of the value in redis");
 
 DEFINE_bool(redis_safe_batch, true, "Use safe batching with Redis service");
+DEFINE_bool(redis_flush_tablets_together, true,
+            "Flush operations of a Redis batch that go to different tablets without key conflicts "
+            "using a single session, so they are sent in one wave of per-tablet RPCs");
+TAG_FLAG(redis_flush_tablets_together, advanced);
+TAG_FLAG(redis_flush_tablets_together, runtime);
 
 #define REDIS_COMMANDS \
     ((get, Get, 2, READ)) \
-    ((mget, MGet, -2, READ)) \
+    ((mget, MGet, -2, MULTI_READ)) \
     ((hget, HGet, 3, READ)) \
     ((tsget, TsGet, 3, READ)) \
     ((hmget, HMGet, -3, READ)) \
@@ -121,17 +131,19 @@ DEFINE_bool(redis_safe_batch, true, "Use safe batching with Redis service");
     ((hkeys, HKeys, 2, READ)) \
     ((hvals, HVals, 2, READ)) \
     ((hlen, HLen, 2, READ)) \
+    ((hscan, HScan, -3, READ)) \
     ((hexists, HExists, 3, READ)) \
     ((hstrlen, HStrLen, 3, READ)) \
     ((smembers, SMembers, 2, READ)) \
     ((sismember, SIsMember, 3, READ)) \
     ((scard, SCard, 2, READ)) \
+    ((sscan, SScan, -3, READ)) \
     ((strlen, StrLen, 2, READ)) \
     ((exists, Exists, 2, READ)) \
     ((getrange, GetRange, 4, READ)) \
     ((zcard, ZCard, 2, READ)) \
     ((set, Set, -3, WRITE)) \
-    ((mset, MSet, -3, WRITE)) \
+    ((mset, MSet, -3, MULTI_WRITE)) \
     ((hset, HSet, 4, WRITE)) \
     ((hmset, HMSet, -4, WRITE)) \
     ((hincrby, HIncrBy, 4, WRITE)) \
@@ -187,6 +199,8 @@ typedef boost::container::small_vector_base<Slice> RedisKeyList;
 
 #define READ_OP YBRedisReadOp
 #define WRITE_OP YBRedisWriteOp
+#define MULTI_READ_OP YBRedisReadOp
+#define MULTI_WRITE_OP YBRedisWriteOp
 #define LOCAL_OP RedisResponsePB
 
 #define DO_PARSER_FORWARD(name, cname, arity, type) \
@@ -201,18 +215,122 @@ namespace {
 
 typedef boost::function<void(const Status&)> StatusFunctor;
 
+// HSCAN and SSCAN are served by paged reads, their reply is the cursor of the next page followed by
+// the elements of the page.
+void ConvertToScanResponse(RedisResponsePB* response) {
+  if (response->code() != RedisResponsePB::OK) {
+    return;
+  }
+  const std::string cursor = response->has_continuation_key()
+      ? kScanCursorPrefix + b2a_hex(response->continuation_key())
+      : std::string(kScanStartCursor);
+  RedisArrayPB scan_response;
+  auto encoded_cursor = EncodeAsBulkString(cursor);
+  scan_response.add_elements(encoded_cursor.data(), encoded_cursor.size());
+  auto encoded_elements = EncodeAsArray(response->array_response().elements());
+  scan_response.add_elements(encoded_elements.data(), encoded_elements.size());
+  scan_response.set_encoded(true);
+  response->mutable_array_response()->Swap(&scan_response);
+  response->clear_continuation_key();
+}
+
+// Multi key commands are split into single key operations, that are sent to the tablets owning
+// corresponding keys in parallel. This class collects responses of these operations and responds
+// to the command, in key order, when all of them are done.
+class MultiKeyResponse {
+ public:
+  MultiKeyResponse(const std::shared_ptr<RedisInboundCall>& call,
+                   size_t index,
+                   const rpc::RpcMethodMetrics& metrics,
+                   bool read,
+                   size_t num_keys)
+      : call_(call),
+        index_(index),
+        metrics_(metrics),
+        read_(read),
+        statuses_(num_keys),
+        responses_(num_keys),
+        keys_left_(num_keys) {}
+
+  // response is nullptr when status is not OK.
+  void Done(size_t key_index, const Status& status, RedisResponsePB* response) {
+    if (status.ok()) {
+      responses_[key_index].Swap(response);
+    } else {
+      statuses_[key_index] = status;
+    }
+    if (keys_left_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      Respond();
+    }
+  }
+
+ private:
+  void Respond() {
+    for (const auto& status : statuses_) {
+      if (!status.ok()) {
+        call_->RespondFailure(index_, status);
+        return;
+      }
+    }
+
+    RedisResponsePB result;
+    result.set_code(RedisResponsePB::OK);
+    auto* array = read_ ? result.mutable_array_response() : nullptr;
+    if (array) {
+      array->mutable_elements()->Reserve(responses_.size());
+    }
+    for (auto& response : responses_) {
+      if (response.code() == RedisResponsePB::OK) {
+        if (array) {
+          // Encode the value right into the element, the whole array is later copied once into
+          // the outbound buffer.
+          const auto& value = response.string_response();
+          auto* element = array->add_elements();
+          element->resize(redisserver::SerializeBulkString(value, size_t(0)));
+          auto* data = pointer_cast<uint8_t*>(&(*element)[0]);
+          auto* end = redisserver::SerializeBulkString(value, data);
+          DCHECK_EQ(data + element->size(), end);
+        }
+      } else if (array && (response.code() == RedisResponsePB::NIL ||
+                           response.code() == RedisResponsePB::WRONG_TYPE)) {
+        // As in Redis, MGET returns nil for keys that do not hold a string value.
+        array->add_elements(kNilResponse);
+      } else {
+        call_->RespondSuccess(index_, metrics_, &response);
+        return;
+      }
+    }
+    if (array) {
+      array->set_encoded(true);
+    }
+    call_->RespondSuccess(index_, metrics_, &result);
+  }
+
+  std::shared_ptr<RedisInboundCall> call_;
+  size_t index_;
+  rpc::RpcMethodMetrics metrics_;
+  bool read_;
+  std::vector<Status> statuses_;
+  std::vector<RedisResponsePB> responses_;
+  std::atomic<size_t> keys_left_;
+};
+
 class Operation {
  public:
   template <class Op>
   Operation(const std::shared_ptr<RedisInboundCall>& call,
             size_t index,
             std::shared_ptr<Op> operation,
-            const rpc::RpcMethodMetrics& metrics)
+            const rpc::RpcMethodMetrics& metrics,
+            std::shared_ptr<MultiKeyResponse> multi_key_response = nullptr,
+            size_t key_index = 0)
     : read_(std::is_same<Op, YBRedisReadOp>::value),
       call_(call),
       index_(index),
       operation_(std::move(operation)),
-      metrics_(metrics) {
+      metrics_(metrics),
+      multi_key_response_(std::move(multi_key_response)),
+      key_index_(key_index) {
     auto status = operation_->GetPartitionKey(&partition_key_);
     if (!status.ok()) {
       Respond(status);
@@ -248,6 +366,11 @@ class Operation {
     return *operation_;
   }
 
+  // Whether this operation is sent to the tablet server, i.e. it is not a local functor.
+  bool has_operation() const {
+    return operation_ != nullptr;
+  }
+
   RedisResponsePB& response() {
     if (read_) {
       return *down_cast<YBRedisReadOp*>(operation_.get())->mutable_response();
@@ -300,8 +423,15 @@ class Operation {
 
   void Respond(const Status& status) {
     responded_.store(true, std::memory_order_release);
+    if (multi_key_response_) {
+      multi_key_response_->Done(key_index_, status, status.ok() ? &response() : nullptr);
+      return;
+    }
     if (status.ok()) {
       if (operation_) {
+        if (read_ && down_cast<YBRedisReadOp*>(operation_.get())->request().has_max_entries()) {
+          ConvertToScanResponse(&response());
+        }
         call_->RespondSuccess(index_, metrics_, &response());
       } else {
         RedisResponsePB resp;
@@ -319,6 +449,8 @@ class Operation {
   std::function<bool(const StatusFunctor&)> functor_;
   std::string partition_key_;
   rpc::RpcMethodMetrics metrics_;
+  std::shared_ptr<MultiKeyResponse> multi_key_response_;
+  size_t key_index_;
   scoped_refptr<client::internal::RemoteTablet> tablet_;
   std::atomic<bool> responded_{false};
 };
@@ -409,6 +541,28 @@ class Block : public std::enable_shared_from_this<Block> {
     return result;
   }
 
+  // Whether this block could be flushed together with blocks of other tablets: nothing waits
+  // behind it and all of its operations go through the session.
+  bool CanMerge() const {
+    if (next_) {
+      return false;
+    }
+    for (auto* op : ops_) {
+      if (!op->has_operation()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Moves operations of other block to this one, the session batcher would still group them
+  // by tablet.
+  void Merge(Block* other) {
+    ops_.insert(ops_.end(), other->ops_.begin(), other->ops_.end());
+    other->ops_.clear();
+    merged_ = true;
+  }
+
  private:
   class BlockCallback {
    public:
@@ -429,16 +583,29 @@ class Block : public std::enable_shared_from_this<Block> {
     metrics_internal_.handler_latency->Increment(now.GetDeltaSince(start_).ToMicroseconds());
     VLOG(3) << "Received status from call " << status.ToString(true);
 
+    std::unordered_map<const client::YBOperation*, Status> op_errors;
     if (!status.ok()) {
       if (session_.get() != nullptr) {
         for (const auto& error : session_->GetPendingErrors()) {
           LOG(WARNING) << "Explicit error while inserting: " << error->status().ToString();
+          if (merged_) {
+            op_errors.emplace(&error->failed_op(), error->status());
+          }
         }
       }
     }
 
-    for (auto* op : ops_) {
-      op->Respond(status);
+    // When operations of several tablets were flushed together, failure of one tablet should not
+    // fail operations of other tablets.
+    if (!op_errors.empty()) {
+      for (auto* op : ops_) {
+        auto it = op_errors.find(&op->operation());
+        op->Respond(it != op_errors.end() ? it->second : Status::OK());
+      }
+    } else {
+      for (auto* op : ops_) {
+        op->Respond(status);
+      }
     }
 
     Processed();
@@ -465,6 +632,7 @@ class Block : public std::enable_shared_from_this<Block> {
   SessionPool* session_pool_;
   std::shared_ptr<client::YBSession> session_;
   std::shared_ptr<Block> next_;
+  bool merged_ = false;
 };
 
 struct BlockData {
@@ -485,6 +653,11 @@ class TabletOperations {
     return read ? read_data_ : write_data_;
   }
 
+  // Without conflicts read and write blocks do not depend on each other.
+  bool HasConflicts() const {
+    return flush_head_ != nullptr;
+  }
+
   void Done(SessionPool* session_pool, bool allow_local_calls_in_curr_thread) {
     if (flush_head_) {
       flush_head_->Launch(session_pool, allow_local_calls_in_curr_thread);
@@ -648,9 +821,46 @@ class BatchContext : public RefCountedThreadSafe<BatchContext> {
       }
     }
 
-    int idx = 0;
+    // Index is read flag.
+    std::shared_ptr<Block> merged_blocks[2];
+    if (FLAGS_redis_flush_tablets_together && tablets_.size() > 1) {
+      MergeBlocks(merged_blocks);
+    }
+    const bool has_merged = merged_blocks[false] || merged_blocks[true];
+
+    size_t idx = 0;
+    for (auto& tablet : tablets_) {
+      ++idx;
+      tablet.second.Done(session_pool_, !has_merged && idx == tablets_.size());
+    }
+    if (merged_blocks[false]) {
+      merged_blocks[false]->Launch(session_pool_, !merged_blocks[true]);
+    }
+    if (merged_blocks[true]) {
+      merged_blocks[true]->Launch(session_pool_);
+    }
+  }
+
+  // Moves read and write blocks of tablets without conflicts to merged_blocks, so they are
+  // flushed with one session per kind instead of one session per tablet.
+  void MergeBlocks(std::shared_ptr<Block>* merged_blocks) {
     for (auto& tablet : tablets_) {
-      tablet.second.Done(session_pool_, ++idx == tablets_.size());
+      if (tablet.second.HasConflicts()) {
+        continue;
+      }
+      for (bool read : {false, true}) {
+        auto& block = tablet.second.data(read).block;
+        if (!block || !block->CanMerge()) {
+          continue;
+        }
+        auto& merged = merged_blocks[read];
+        if (merged) {
+          merged->Merge(block.get());
+        } else {
+          merged = block;
+        }
+        block = nullptr;
+      }
     }
   }
 
@@ -781,6 +991,15 @@ class RedisServiceImpl::Impl {
       Parser<Op> parser,
       BatchContext* context);
 
+  // Splits multi key command into single key operations, parsed by parser, so each of them is
+  // executed by the tablet owning its key.
+  template<class Op>
+  void MultiKeyCommand(
+      const RedisCommandInfo& info,
+      size_t idx,
+      Parser<Op> parser,
+      BatchContext* context);
+
   constexpr static int kRpcTimeoutSec = 5;
 
   void PopulateHandlers();
@@ -909,6 +1128,10 @@ void HandleDebugSleep(LocalCommandData data) {
     Command<YBRedisReadOp>(info, idx, &BOOST_PP_CAT(Parse, cname), context)
 #define WRITE_COMMAND(cname) \
     Command<YBRedisWriteOp>(info, idx, &BOOST_PP_CAT(Parse, cname), context)
+#define MULTI_READ_COMMAND(cname) \
+    MultiKeyCommand<YBRedisReadOp>(info, idx, &BOOST_PP_CAT(Parse, cname), context)
+#define MULTI_WRITE_COMMAND(cname) \
+    MultiKeyCommand<YBRedisWriteOp>(info, idx, &BOOST_PP_CAT(Parse, cname), context)
 #define LOCAL_COMMAND(cname) \
     BOOST_PP_CAT(Handle, cname)({info, idx, context}); \
 
@@ -1075,6 +1298,65 @@ void RedisServiceImpl::Impl::Command(
   context->Apply(idx, std::move(op), info.metrics);
 }
 
+template<class Op>
+void RedisServiceImpl::Impl::MultiKeyCommand(
+    const RedisCommandInfo& info,
+    size_t idx,
+    Parser<Op> parser,
+    BatchContext* context) {
+  VLOG(1) << "Processing " << info.name << ".";
+
+  constexpr bool kRead = std::is_same<Op, YBRedisReadOp>::value;
+  // Multi key read commands have one argument per key, write commands have key value pairs.
+  constexpr size_t kArgsPerKey = kRead ? 1 : 2;
+  const auto& command = context->command(idx);
+  if ((command.size() - 1) % kArgsPerKey != 0) {
+    RespondWithFailure(context->call(), idx, "Wrong number of arguments.");
+    return;
+  }
+
+  // Indexes of the first argument of each key.
+  std::vector<size_t> key_args;
+  key_args.reserve((command.size() - 1) / kArgsPerKey);
+  if (kRead) {
+    for (size_t i = 1; i < command.size(); i += kArgsPerKey) {
+      key_args.push_back(i);
+    }
+  } else {
+    // Operations for different keys are not ordered, so only the last value written to a key
+    // is applied.
+    std::unordered_set<Slice, Slice::Hash> keys;
+    for (size_t i = command.size(); i > 1;) {
+      i -= kArgsPerKey;
+      if (keys.insert(command[i]).second) {
+        key_args.push_back(i);
+      }
+    }
+    std::reverse(key_args.begin(), key_args.end());
+  }
+
+  std::vector<std::shared_ptr<Op>> ops;
+  ops.reserve(key_args.size());
+  RedisClientCommand key_command;
+  for (auto key_arg : key_args) {
+    key_command.assign(1, command[0]);
+    key_command.insert(
+        key_command.end(), command.begin() + key_arg, command.begin() + key_arg + kArgsPerKey);
+    ops.push_back(std::make_shared<Op>(table_));
+    Status s = parser(ops.back().get(), key_command);
+    if (!s.ok()) {
+      RespondWithFailure(context->call(), idx, s.message().ToBuffer());
+      return;
+    }
+  }
+
+  auto response = std::make_shared<MultiKeyResponse>(
+      context->call(), idx, info.metrics, kRead, ops.size());
+  for (size_t i = 0; i != ops.size(); ++i) {
+    context->Apply(idx, std::move(ops[i]), info.metrics, response, i);
+  }
+}
+
 void RedisServiceImpl::Impl::RespondWithFailure(
     std::shared_ptr<RedisInboundCall> call,
     size_t idx,
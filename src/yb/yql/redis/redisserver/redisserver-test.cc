@@ -45,6 +45,7 @@ DECLARE_int32(redis_max_command_size);
 DECLARE_int32(rpc_max_message_size);
 DECLARE_int32(consensus_max_batch_size_bytes);
 DECLARE_int32(consensus_rpc_timeout_ms);
+DECLARE_bool(batch_redis_read_ops);
 
 DEFINE_uint64(test_redis_max_concurrent_commands, 20,
     "Value of redis_max_concurrent_commands for pipeline test");
@@ -1203,6 +1204,49 @@ TEST_F(TestRedisService, TestDummyLocal) {
   VerifyCallbacks();
 }
 
+TEST_F(TestRedisService, TestScan) {
+  DoRedisTestOk(__LINE__, {"HMSET", "map_key", "f1", "v1", "f2", "v2", "f3", "v3", "f4", "v4",
+                           "f5", "v5"});
+  DoRedisTestInt(__LINE__, {"SADD", "set_key", "m1", "m2", "m3"}, 3);
+  SyncClient();
+
+  // Scans the collection with pages of the given size, collecting the returned elements.
+  auto scan = [this](const std::string& command, const std::string& key, int count) {
+    std::vector<std::string> elements;
+    std::string cursor = "0";
+    int pages = 0;
+    do {
+      DoRedisTest(__LINE__, {command, key, cursor, "COUNT", std::to_string(count)},
+          cpp_redis::reply::type::array,
+          [&cursor, &elements, count](const RedisReply& reply) {
+            const auto& replies = reply.as_array();
+            ASSERT_EQ(2U, replies.size());
+            cursor = replies[0].as_string();
+            const auto& page = replies[1].as_array();
+            ASSERT_LE(page.size(), 2U * count);
+            for (const auto& element : page) {
+              elements.push_back(element.as_string());
+            }
+          });
+      SyncClient();
+      ++pages;
+    } while (cursor != "0" && pages < 10);
+    EXPECT_EQ("0", cursor);
+    return elements;
+  };
+
+  ASSERT_EQ((std::vector<std::string>{"f1", "v1", "f2", "v2", "f3", "v3", "f4", "v4", "f5", "v5"}),
+            scan("HSCAN", "map_key", 2));
+  ASSERT_EQ((std::vector<std::string>{"m1", "m2", "m3"}), scan("SSCAN", "set_key", 1));
+  ASSERT_EQ((std::vector<std::string>{"m1", "m2", "m3"}), scan("SSCAN", "set_key", 10));
+  ASSERT_EQ(std::vector<std::string>(), scan("SSCAN", "no_such_key", 10));
+
+  DoRedisTestExpectError(__LINE__, {"HSCAN", "map_key", "bad_cursor"});
+  DoRedisTestExpectError(__LINE__, {"HSCAN", "map_key", "0", "MATCH", "f*"});
+  SyncClient();
+  VerifyCallbacks();
+}
+
 TEST_F(TestRedisService, TestTimeSeries) {
   // The default value is true, but we explicitly set this here for clarity.
   FLAGS_emulate_redis_responses = true;
@@ -2053,6 +2097,66 @@ TEST_F(TestRedisService, TestDel) {
   VerifyCallbacks();
 }
 
+TEST_F(TestRedisService, TestMGetMSet) {
+  // Enough keys to have them spread over all tablets.
+  constexpr int kNumKeys = 50;
+  vector<string> mset = {"MSET"};
+  vector<string> mget = {"MGET"};
+  vector<string> expected;
+  for (int i = 0; i != kNumKeys; ++i) {
+    auto key = "key_" + std::to_string(i);
+    auto value = "value_" + std::to_string(i);
+    mset.push_back(key);
+    mset.push_back(value);
+    mget.push_back(key);
+    expected.push_back(value);
+  }
+  // Last value of a duplicate key should be written.
+  mset.push_back("key_0");
+  mset.push_back("last_value");
+  expected[0] = "last_value";
+  DoRedisTestOk(__LINE__, mset);
+  SyncClient();
+
+  DoRedisTestArray(__LINE__, mget, expected);
+  DoRedisTestInt(__LINE__, {"HSET", "map_key", "subkey", "42"}, 1);
+  SyncClient();
+
+  // Values are returned in key order, nil for missing keys and keys of other types.
+  DoRedisTestArray(__LINE__, {"MGET", "key_2", "non_existent", "map_key", "key_1", "key_2"},
+                   {"value_2", "", "", "value_1", "value_2"});
+  DoRedisTestExpectError(__LINE__, {"MSET", "key_1", "value_1", "key_2"});
+  SyncClient();
+  VerifyCallbacks();
+}
+
+TEST_F(TestRedisService, TestMGetBatched) {
+  FLAGS_batch_redis_read_ops = true;
+  constexpr int kNumKeys = 50;
+  vector<string> mset = {"MSET"};
+  vector<string> mget = {"MGET"};
+  vector<string> expected;
+  for (int i = 0; i != kNumKeys; ++i) {
+    auto key = "key_" + std::to_string(i);
+    auto value = "value_" + std::to_string(i);
+    mset.push_back(key);
+    mset.push_back(value);
+    // Read keys in reverse order, and every fifth of them is missing.
+    mget.insert(mget.begin() + 1, i % 5 == 0 ? "missing_" + std::to_string(i) : key);
+    expected.insert(expected.begin(), i % 5 == 0 ? "" : value);
+  }
+  DoRedisTestOk(__LINE__, mset);
+  DoRedisTestInt(__LINE__, {"HSET", "map_key", "subkey", "42"}, 1);
+  SyncClient();
+
+  DoRedisTestArray(__LINE__, mget, expected);
+  DoRedisTestArray(__LINE__, {"MGET", "key_2", "map_key", "key_1", "key_2"},
+                   {"value_2", "", "value_1", "value_2"});
+  DoRedisTestArray(__LINE__, {"HMGET", "map_key", "subkey", "missing"}, {"42", ""});
+  SyncClient();
+  VerifyCallbacks();
+}
+
 TEST_F(TestRedisService, TestHDel) {
   // The default value is true, but we explicitly set this here for clarity.
   FLAGS_emulate_redis_responses = true;